@@ -17,6 +17,7 @@
 #ifndef IGNITION_GUI_APPLICATION_HH_
 #define IGNITION_GUI_APPLICATION_HH_
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <utility>
@@ -45,6 +46,7 @@ namespace ignition
     class Dialog;
     class MainWindow;
     class Plugin;
+    class StallWatchdog;
 
     /// \brief Type of window which the application will display
     enum class WindowType : int
@@ -57,6 +59,31 @@ namespace ignition
       kDialog = 1
     };
 
+    /// \brief How windows are rendered and paced. Qt picks its render loop
+    /// and the surface format of windows as the first window is created, so
+    /// these are set before the Application is constructed.
+    /// \sa Application::SetRenderOptions
+    struct RenderOptions
+    {
+      /// \brief QtQuick render loop, "threaded" or "basic". Empty to let Qt
+      /// choose, or to keep the one given through QSG_RENDER_LOOP.
+      std::string renderLoop;
+
+      /// \brief Vertical blanks to wait for between buffer swaps, 0 to not
+      /// wait for vsync, -1 to keep the driver's default.
+      int swapInterval{-1};
+
+      /// \brief Most frames per second rendered by 3D scenes, 0 to render
+      /// as often as the window shows frames.
+      double targetFps{0.0};
+
+      /// \brief Favor latency over smoothness: windows are double instead
+      /// of triple buffered and, unless a swap interval is given, don't
+      /// wait for vsync. 3D scenes are then paced to the target FPS, or to
+      /// the screen's refresh rate.
+      bool lowLatency{false};
+    };
+
     /// \brief An Ignition GUI application loads a QML engine and
     /// provides an API to load plugins and configuration files. The application
     /// supports either running a single main window or several plugins as
@@ -79,6 +106,123 @@ namespace ignition
       /// \return Pointer to QML engine
       public: QQmlApplicationEngine *Engine() const;
 
+      /// \brief Get a component for a QML file. The file is compiled the
+      /// first time it's requested, and the component is shared by all
+      /// items created from it afterwards.
+      /// \param[in] _url URL of the QML file, such as ":qml/IgnCard.qml"
+      /// \return The component, owned by the engine. Check
+      /// QQmlComponent::isError before creating items from it.
+      public: QQmlComponent *Component(const QString &_url);
+
+      /// \brief Get the main window, without searching the object tree for
+      /// it, so it's cheap enough to call on every frame.
+      /// \return The main window, null if the application runs dialogs or
+      /// the window hasn't been created yet.
+      public: MainWindow *MainWin() const;
+
+      /// \brief Get whether the main window can be seen. It can't while
+      /// it's minimized or hidden, while the application is hidden, or
+      /// while it's covered by other windows on platforms which tell.
+      /// Plugins in the main window are suspended meanwhile.
+      /// \return True if the window can be seen, or if there's none.
+      /// \sa Plugin::Suspend
+      public: bool WindowShown() const;
+
+      /// \brief Register an object so it can be found by name without
+      /// walking the object tree, such as the main window's "background"
+      /// item. An object registered before under the same name is
+      /// replaced. Objects are forgotten when they're destroyed.
+      /// \param[in] _name Unique name
+      /// \param[in] _object Object, null to unregister the name
+      /// \sa FindObject
+      public: void RegisterObject(const QString &_name, QObject *_object);
+
+      /// \brief Find an object registered with RegisterObject.
+      /// \param[in] _name Name it was registered with
+      /// \return The object, null if there isn't one
+      public: QObject *FindObject(const QString &_name) const;
+
+      /// \brief Find an object registered with RegisterObject.
+      /// \param[in] _name Name it was registered with
+      /// \return The object, null if there isn't one or it isn't of type T
+      /// \tparam T QObject subclass, such as QQuickItem
+      public: template<class T>
+              T *FindObject(const QString &_name) const
+              {
+                return qobject_cast<T *>(this->FindObject(_name));
+              }
+
+      /// \brief Find the card of a plugin which has been added to the
+      /// window or a dialog, from the name shown on it.
+      /// \param[in] _pluginName Name shown on the card, which is the plugin's
+      /// title
+      /// \return The card item, null if there isn't one. If several
+      /// plugins have the same title, the first one added is returned.
+      public: QQuickItem *FindCard(const QString &_pluginName) const;
+
+      /// \brief Set how long QML may be created for on each frame. With a
+      /// budget, plugins added to the main window have their QML created
+      /// asynchronously, so the window keeps responding and cards show up
+      /// as they're ready.
+      /// \param[in] _budget Milliseconds per frame, 0 (the default) to
+      /// create QML synchronously.
+      /// \sa Plugin::Loading
+      public: void SetIncubationBudget(const int _budget);
+
+      /// \brief Get how long QML may be created for on each frame.
+      /// \return Milliseconds per frame, 0 if QML is created synchronously.
+      public: int IncubationBudget() const;
+
+      /// \brief Start watching the event loop from another thread and
+      /// report each time it stops processing events for longer than a
+      /// threshold, with the handler and plugin responsible. This is also
+      /// done when the IGN_GUI_STALL_THRESHOLD environment variable holds a
+      /// threshold in milliseconds, publishing on IGN_GUI_STALL_TOPIC.
+      /// \param[in] _threshold Shortest stall reported
+      /// \param[in] _topic Topic to publish reports on as msgs::StringMsg,
+      /// empty not to publish.
+      /// \sa StallWatchdog
+      public: void StartStallWatchdog(
+          const std::chrono::milliseconds &_threshold,
+          const std::string &_topic = "");
+
+      /// \brief Stop watching the event loop for stalls.
+      public: void StopStallWatchdog();
+
+      /// \brief Get the stall watchdog.
+      /// \return The watchdog, null if it isn't running.
+      public: StallWatchdog *CurrentStallWatchdog() const;
+
+      /// \brief Serve the performance counters of the GUI over HTTP, for
+      /// Prometheus and other OpenMetrics scrapers. This is also done when
+      /// the IGN_GUI_METRICS_PORT environment variable holds a port, on
+      /// the address in IGN_GUI_METRICS_ADDRESS if set.
+      /// \param[in] _port TCP port, 0 to let the system choose one
+      /// \param[in] _address IPv4 address to listen on. Only this machine
+      /// can scrape the default one, "0.0.0.0" is all network interfaces.
+      /// \return False if the address or port couldn't be listened on
+      /// \sa Metrics
+      public: bool StartMetrics(const int _port,
+                                const std::string &_address = "127.0.0.1");
+
+      /// \brief Stop serving the performance counters.
+      public: void StopMetrics();
+
+      /// \brief Deliver an event, keeping track of the handler for the stall
+      /// watchdog and accounting the time to the plugin receiving it.
+      /// \param[in] _receiver Object receiving the event
+      /// \param[in] _event Event
+      /// \return The value returned by the receiver
+      /// \sa PluginAccounting
+      public: bool notify(QObject *_receiver, QEvent *_event) override;
+
+      /// \brief Follow the main window being exposed and covered.
+      /// \param[in] _watched Main window
+      /// \param[in] _event Event
+      /// \return False, so the window gets the event too
+      protected: bool eventFilter(QObject *_watched, QEvent *_event)
+          override;
+
       /// \brief Load a plugin from a file name. The plugin file must be in the
       /// path.
       /// If a window has been initialized, the plugin is added to the window.
@@ -96,6 +240,10 @@ namespace ignition
       /// and plugins. This function doesn't instantiate the plugins, it just
       /// keeps them in memory and they can be applied later by either
       /// instantiating a window or several dialogs.
+      ///
+      /// Plugins which are already running are kept if the new configuration
+      /// has a plugin with the same configuration other than card properties
+      /// and anchors, and are only rearranged. All other plugins are removed.
       /// \param[in] _config Full path to configuration file.
       /// \return True if successful
       /// \sa InitializeMainWindow
@@ -147,6 +295,38 @@ namespace ignition
       public: std::vector<std::pair<std::string, std::vector<std::string>>>
           PluginList();
 
+      /// \brief Get the directory holding the persistent QML bytecode cache,
+      /// ~/.ignition/gui/cache/<version>, where the version combines those
+      /// of Ignition GUI and Qt so that upgrades start from a clean cache.
+      /// QtQuick's shader programs are cached by Qt in the shared
+      /// qtshadercache directory, keyed by driver and source.
+      /// \return Absolute path.
+      public: static std::string CacheDirectory();
+
+      /// \brief Set how windows are rendered and paced. This only affects
+      /// windows created afterwards, so it's called before constructing the
+      /// Application. The IGN_GUI_RENDER_LOOP, IGN_GUI_SWAP_INTERVAL,
+      /// IGN_GUI_TARGET_FPS and IGN_GUI_LOW_LATENCY environment variables,
+      /// when set, take precedence.
+      /// \param[in] _options Options
+      /// \sa CurrentRenderOptions
+      public: static void SetRenderOptions(const RenderOptions &_options);
+
+      /// \brief Get how windows are rendered and paced, including the
+      /// options given through the environment once the Application was
+      /// constructed.
+      /// \return Options
+      /// \sa SetRenderOptions
+      public: static RenderOptions CurrentRenderOptions();
+
+      /// \brief Fill the persistent caches, so that the next start doesn't
+      /// compile anything. The QML of the library and of all plugins found
+      /// in the plugin paths is compiled, and if there's a main window, it
+      /// is shown until it rendered a frame. Meant to be called at install
+      /// time through `ign gui --warm-cache`.
+      /// \return Number of QML files compiled.
+      public: int WarmCache();
+
       /// \brief Remove plugin by name. The plugin is removed from the
       /// application and its shared library unloaded if this was its last
       /// instance.
@@ -154,13 +334,34 @@ namespace ignition
       /// \return True if successful
       public: bool RemovePlugin(const std::string &_pluginName);
 
+      /// \brief Remove several plugins by name. All cards are taken out of
+      /// the window before the layout is updated, once, and the plugins are
+      /// only destroyed once control returns to the event loop.
+      /// \param[in] _pluginNames Plugin instances' unique names
+      /// \return True if all plugins were found and removed
+      /// \sa RemovePlugin
+      public: bool RemovePlugins(const std::vector<std::string> &_pluginNames);
+
       /// \brief Notify that a plugin has been added.
       /// \param[in] _objectName Plugin's object name.
       signals: void PluginAdded(const QString &_objectName);
 
+      /// \brief Notify that the paths to look for plugins changed, through
+      /// SetPluginPathEnv or AddPluginPath.
+      signals: void PluginPathsChanged();
+
+      /// \brief Notify that the main window was hidden, or shown again.
+      /// \param[in] _shown True if it can be seen
+      /// \sa WindowShown
+      signals: void WindowShownChanged(bool _shown);
+
       /// \brief Callback when user requests to close a plugin
       public slots: void OnPluginClose();
 
+      /// \brief Callback when a plugin finished loading asynchronously, to
+      /// add it to the window
+      private slots: void OnPluginLoaded();
+
       /// \brief Create a main window, populate with previously loaded plugins
       /// and apply previously loaded configuration.
       /// An empty window will be created if no plugins have been loaded.
@@ -180,6 +381,24 @@ namespace ignition
       /// \param[in] _plugin Shared pointer to plugin
       private: void RemovePlugin(std::shared_ptr<Plugin> _plugin);
 
+      /// \brief Remove plugins by pointer. They're destroyed once control
+      /// returns to the event loop.
+      /// \param[in] _plugins Shared pointers to plugins
+      private: void RemovePlugins(
+          const std::vector<std::shared_ptr<Plugin>> &_plugins);
+
+      /// \brief Configure a plugin which was just instantiated and add it
+      /// to the window or a dialog.
+      /// \param[in] _plugin Plugin
+      /// \param[in] _filename Plugin filename, as given to LoadPlugin
+      /// \param[in] _pathToLib Path to the plugin's library
+      /// \param[in] _pluginElem Plugin configuration, may be null
+      /// \return True if successful
+      private: bool AddPlugin(std::shared_ptr<Plugin> _plugin,
+                              const std::string &_filename,
+                              const std::string &_pathToLib,
+                              const tinyxml2::XMLElement *_pluginElem);
+
       /// \brief Add previously loaded plugins to the main window.
       /// \return True if successful. Will fail if the window hasn't been
       /// created yet.
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GUI_ASYNCLOG_HH_
+#define IGNITION_GUI_ASYNCLOG_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "ignition/gui/Export.hh"
+
+#ifdef _WIN32
+// Disable warning C4251 which is triggered by
+// std::unique_ptr
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+
+namespace ignition
+{
+  namespace gui
+  {
+    class AsyncLogPrivate;
+
+    /// \brief Writes log lines from a thread of its own, so threads logging
+    /// a lot, such as the GUI thread flooded with QML warnings, don't wait
+    /// on console I/O. Lines go through a lock-free queue. Beyond a number
+    /// of lines per second, or when the queue is full, lines are dropped
+    /// and counted. Consecutive repeats of a line are written once,
+    /// followed by the number of repeats.
+    class IGNITION_GUI_VISIBLE AsyncLog
+    {
+      /// \brief Severity of a line
+      public: enum class Level : int
+      {
+        /// \brief Debug
+        kDebug = 0,
+
+        /// \brief Information
+        kInfo = 1,
+
+        /// \brief Warning
+        kWarning = 2,
+
+        /// \brief Error, never dropped
+        kError = 3
+      };
+
+      /// \brief Function writing a line.
+      public: using Writer =
+          std::function<void(const Level, const std::string &)>;
+
+      /// \brief Constructor, starts the writer thread.
+      /// \param[in] _writer Writes each line, on the writer thread
+      /// \param[in] _capacity Lines the queue holds, rounded up to a power
+      /// of two
+      /// \param[in] _rate Most lines queued per second, 0 for no limit
+      public: AsyncLog(const Writer &_writer,
+                       const std::size_t _capacity = 1024u,
+                       const unsigned int _rate = 200u);
+
+      /// \brief Destructor, writes the lines left and stops the writer
+      /// thread.
+      public: ~AsyncLog();
+
+      /// \brief Get the log writing to the ignition console, used for Qt
+      /// messages.
+      /// \return Log
+      public: static AsyncLog &Instance();
+
+      /// \brief Queue a line to be written. Can be called from any thread.
+      /// Errors which can't be queued are written right away.
+      /// \param[in] _level Severity
+      /// \param[in] _line Line, without end of line
+      /// \return False if the line was dropped
+      public: bool Push(const Level _level, std::string _line);
+
+      /// \brief Wait until all lines queued so far are written.
+      public: void Flush();
+
+      /// \brief Get the number of lines dropped so far.
+      /// \return Lines dropped because of the rate limit or a full queue
+      public: std::uint64_t DroppedCount() const;
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<AsyncLogPrivate> dataPtr;
+    };
+  }
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif
@@ -21,10 +21,13 @@
 #ifdef _MSC_VER
 #pragma warning(push, 0)
 #endif
+#include <ignition/msgs/pose_v.pb.h>
 #include <ignition/msgs/time.pb.h>
 #ifdef _MSC_VER
 #pragma warning(pop)
 #endif
+#include <cstddef>
+
 #include <ignition/common/Time.hh>
 #include <ignition/math/Color.hh>
 #include <ignition/math/Vector2.hh>
@@ -78,6 +81,39 @@ namespace ignition
     IGNITION_GUI_VISIBLE
     math::Vector3d convert(const QVector3D &_vec);
 
+    /// \brief Convert many vectors at once into a packed buffer of floats,
+    /// such as a vertex buffer. Nothing is allocated.
+    /// \param[in] _vecs First of the vectors to convert
+    /// \param[in] _count Number of vectors
+    /// \param[out] _out Buffer of at least 3 * _count floats, filled with
+    /// the X, Y and Z of each vector in turn
+    IGNITION_GUI_VISIBLE
+    void convert(const math::Vector3d *_vecs, const std::size_t _count,
+        float *_out);
+
+    /// \brief Convert many vectors at once into points, such as the data of
+    /// a QVector<QPointF> of the same size. Nothing is allocated.
+    /// \param[in] _pts First of the vectors to convert
+    /// \param[in] _count Number of vectors
+    /// \param[out] _out Buffer of at least _count points
+    IGNITION_GUI_VISIBLE
+    void convert(const math::Vector2d *_pts, const std::size_t _count,
+        QPointF *_out);
+
+    /// \brief Convert the poses of a msg at once into one array of
+    /// positions and one of orientations. Nothing is allocated.
+    /// \param[in] _poses Poses to convert
+    /// \param[out] _positions Buffer of at least 3 * _capacity doubles,
+    /// filled with the X, Y and Z of each position in turn
+    /// \param[out] _orientations Buffer of at least 4 * _capacity doubles,
+    /// filled with the W, X, Y and Z of each orientation in turn
+    /// \param[in] _capacity Most poses to convert
+    /// \return Number of poses converted, the smaller of _capacity and the
+    /// number of poses in the msg
+    IGNITION_GUI_VISIBLE
+    std::size_t convert(const msgs::Pose_V &_poses, double *_positions,
+        double *_orientations, const std::size_t _capacity);
+
     /// \brief Return the equivalent ignition mouse event.
     ///
     /// Note that there isn't a 1-1 mapping between these types, so fields such
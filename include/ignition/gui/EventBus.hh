@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GUI_EVENTBUS_HH_
+#define IGNITION_GUI_EVENTBUS_HH_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <typeindex>
+
+#include "ignition/gui/qt.h"
+#include "ignition/gui/Export.hh"
+
+#ifdef _WIN32
+// Disable warning C4251 which is triggered by
+// std::unique_ptr
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+
+namespace ignition
+{
+  namespace gui
+  {
+    class EventBusPrivate;
+
+    /// \brief Typed publish / subscribe between plugins, without going
+    /// through Qt's event loop and event filters.
+    ///
+    /// Events are any copyable type, and are referred to by their C++ type.
+    /// Publishing calls the handlers subscribed to that type right away, on
+    /// the publishing thread, with a reference to the published event, so
+    /// it can live on the stack and nothing is allocated. Handlers which
+    /// must run on another thread can subscribe with a context object
+    /// instead: they get a copy of the event, delivered by the event loop of
+    /// the context's thread.
+    ///
+    /// Functions can be called from any thread. As with SubscriptionHub, a
+    /// handler which is already running may finish after Unsubscribe
+    /// returns.
+    class IGNITION_GUI_VISIBLE EventBus
+    {
+      /// \brief Handler of events of any type.
+      public: using Handler = std::function<void(const void *)>;
+
+      /// \brief Makes a copy of an event of any type.
+      public: using Copier =
+          std::function<std::shared_ptr<const void>(const void *)>;
+
+      /// \brief Constructor
+      public: EventBus();
+
+      /// \brief Destructor
+      public: ~EventBus();
+
+      /// \brief Get the bus shared by all plugins.
+      /// \return The bus.
+      public: static EventBus &Instance();
+
+      /// \brief Handle events of a type on the publishing thread.
+      /// \param[in] _handler Called with each event.
+      /// \return ID to unsubscribe with.
+      public: template<typename EventT>
+              std::size_t Subscribe(
+                  const std::function<void(const EventT &)> &_handler)
+      {
+        return this->Add(typeid(EventT),
+            [_handler](const void *_event)
+            {
+              _handler(*static_cast<const EventT *>(_event));
+            }, nullptr, Copier());
+      }
+
+      /// \brief Handle events of a type on the thread of a context object.
+      /// Events are copied into the context's mailbox when published, and
+      /// handled in the order they were published the next time its event
+      /// loop runs. Nothing is delivered once the context is destroyed.
+      /// \param[in] _context Object whose thread handles the events.
+      /// \param[in] _handler Called with each event.
+      /// \return ID to unsubscribe with, 0 if the context is null.
+      public: template<typename EventT>
+              std::size_t Subscribe(QObject *_context,
+                  const std::function<void(const EventT &)> &_handler)
+      {
+        if (nullptr == _context)
+          return 0;
+
+        return this->Add(typeid(EventT),
+            [_handler](const void *_event)
+            {
+              _handler(*static_cast<const EventT *>(_event));
+            }, _context,
+            [](const void *_event)
+            {
+              return std::shared_ptr<const void>(std::make_shared<EventT>(
+                  *static_cast<const EventT *>(_event)));
+            });
+      }
+
+      /// \brief Stop handling events.
+      /// \param[in] _id ID returned by Subscribe.
+      public: void Unsubscribe(std::size_t _id);
+
+      /// \brief Publish an event to the handlers of its type.
+      /// \param[in] _event Event, which only needs to outlive this call.
+      public: template<typename EventT>
+              void Publish(const EventT &_event)
+      {
+        this->Dispatch(typeid(EventT), &_event);
+      }
+
+      /// \brief Get the number of handlers of events of a type.
+      /// \return Number of handlers.
+      public: template<typename EventT>
+              std::size_t HandlerCount() const
+      {
+        return this->HandlerCount(typeid(EventT));
+      }
+
+      /// \brief Add a handler for a type.
+      /// \param[in] _type Event type.
+      /// \param[in] _handler Handler.
+      /// \param[in] _context Context of queued handlers, null to handle
+      /// events on the publishing thread.
+      /// \param[in] _copier Copies events for queued handlers.
+      /// \return ID to unsubscribe with.
+      private: std::size_t Add(const std::type_index &_type,
+                               const Handler &_handler, QObject *_context,
+                               const Copier &_copier);
+
+      /// \brief Call the handlers of a type.
+      /// \param[in] _type Event type.
+      /// \param[in] _event Event.
+      private: void Dispatch(const std::type_index &_type,
+                             const void *_event);
+
+      /// \brief Get the number of handlers of a type.
+      /// \param[in] _type Event type.
+      /// \return Number of handlers.
+      private: std::size_t HandlerCount(const std::type_index &_type) const;
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<EventBusPrivate> dataPtr;
+    };
+  }
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif
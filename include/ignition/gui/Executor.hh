@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GUI_EXECUTOR_HH_
+#define IGNITION_GUI_EXECUTOR_HH_
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "ignition/gui/Export.hh"
+
+#ifdef _WIN32
+// Disable warning C4251 which is triggered by
+// std::unique_ptr
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+
+class QObject;
+
+namespace ignition
+{
+  namespace gui
+  {
+    class ExecutorPrivate;
+
+    /// \brief Worker threads shared by all plugins, so heavy work such as
+    /// image conversions and mesh parsing happens off the GUI thread
+    /// without each plugin starting threads of its own.
+    ///
+    /// Each owner, usually a plugin, has its own queue. Tasks of an owner
+    /// run in the order they're posted, one at a time unless the owner
+    /// allows more with SetConcurrency. Owners with tasks waiting take
+    /// turns, so a plugin posting lots of work doesn't hold up the others.
+    ///
+    /// There is one thread per core, minus one for the GUI thread, unless
+    /// the IGN_GUI_WORKER_THREADS environment variable holds another
+    /// count. Functions can be called from any thread.
+    class IGNITION_GUI_VISIBLE Executor
+    {
+      /// \brief Work to be done
+      public: using Task = std::function<void()>;
+
+      /// \brief Constructor
+      /// \param[in] _threads Number of worker threads, 0 to pick one
+      /// according to the number of cores.
+      public: explicit Executor(unsigned int _threads = 0);
+
+      /// \brief Destructor. Tasks which didn't start are dropped, and
+      /// running ones are waited for.
+      public: ~Executor();
+
+      /// \brief Get the executor shared by the application.
+      /// \return The executor.
+      public: static Executor &Instance();
+
+      /// \brief Get the number of worker threads.
+      /// \return Thread count
+      public: unsigned int ThreadCount() const;
+
+      /// \brief Run a task on a worker thread.
+      /// \param[in] _owner Queue to add the task to, such as the plugin.
+      /// \param[in] _task Task
+      public: void Post(const void *_owner, Task _task);
+
+      /// \brief Set how many tasks of an owner may run at the same time.
+      /// \param[in] _owner Owner
+      /// \param[in] _max Number of tasks, 1 by default. It's never more
+      /// than the thread count.
+      public: void SetConcurrency(const void *_owner, unsigned int _max);
+
+      /// \brief Get the number of tasks of an owner which didn't start yet.
+      /// \param[in] _owner Owner
+      /// \return Task count
+      public: std::size_t Pending(const void *_owner) const;
+
+      /// \brief Drop the tasks of an owner which didn't start, and wait for
+      /// the running ones to finish, which makes it safe to destroy what
+      /// they use. Owners cancel their tasks before they're destroyed.
+      /// \param[in] _owner Owner
+      /// \return Number of tasks dropped
+      public: std::size_t Cancel(const void *_owner);
+
+      /// \brief Run a function on the GUI thread, once control returns to
+      /// the event loop. Functions posted with the same context and key
+      /// before the first of them runs are coalesced, and only the latest
+      /// runs, so workers can announce results as often as they come
+      /// without flooding the event loop.
+      /// \param[in] _context Object the function works on. It isn't run if
+      /// the object was destroyed by then.
+      /// \param[in] _task Function
+      /// \param[in] _key Functions are coalesced by key, empty to always
+      /// run this one.
+      public: void PostToGui(QObject *_context, Task _task,
+                             const std::string &_key = "");
+
+      /// \brief Destroy the functions posted to the GUI thread whose
+      /// context was destroyed, instead of leaving them to the next
+      /// dispatch, such as before unloading the library they come from.
+      /// Call it on the GUI thread.
+      /// \return Number of functions dropped
+      public: std::size_t DropDeadGuiTasks();
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<ExecutorPrivate> dataPtr;
+    };
+  }
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif
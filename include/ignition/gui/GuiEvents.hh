@@ -34,6 +34,9 @@ namespace ignition
 
       /// \brief Event called in the render thread of a 3D scene.
       /// It's safe to make rendering calls in this event's callback.
+      /// It's also published on the EventBus, whose handlers don't need to
+      /// filter the main window's events. See RenderHooks for an
+      /// alternative with priorities, time budgets and per hook costs.
       class Render : public QEvent
       {
         public: Render()
@@ -35,6 +35,11 @@
 #pragma warning(disable: 4251)
 #endif
 
+namespace tinyxml2
+{
+  class XMLElement;
+}
+
 namespace ignition
 {
   namespace gui
@@ -177,6 +182,14 @@ namespace ignition
         NOTIFY ShowPluginMenuChanged
       )
 
+      /// \brief Flag to draw cards without animations and shadows
+      Q_PROPERTY(
+        bool lightweight
+        READ Lightweight
+        WRITE SetLightweight
+        NOTIFY LightweightChanged
+      )
+
       /// \brief Constructor
       public: MainWindow();
 
@@ -206,7 +219,8 @@ namespace ignition
       /// \param [in] _plugin Plugin filename
       public slots: void OnAddPlugin(QString _plugin);
 
-      /// \brief Return a list of all plugin names found
+      /// \brief Return a list of all plugin names found. The list is kept
+      /// until plugin directories change or a new config is applied.
       /// \return List with plugin names
       public: Q_INVOKABLE QStringList PluginListModel() const;
 
@@ -344,6 +358,16 @@ namespace ignition
       /// \param[in] _showPluginMenu True to show.
       public: Q_INVOKABLE void SetShowPluginMenu(const bool _showPluginMenu);
 
+      /// \brief Get the flag to draw cards without animations and
+      /// shadows.
+      /// \return True if lightweight.
+      public: Q_INVOKABLE bool Lightweight() const;
+
+      /// \brief Set the flag to draw cards without animations and shadows,
+      /// for windows with many cards or software rendering.
+      /// \param[in] _lightweight True to simplify the cards.
+      public: Q_INVOKABLE void SetLightweight(const bool _lightweight);
+
       /// \brief Callback when load configuration is selected
       public slots: void OnLoadConfig(const QString &_path);
 
@@ -398,12 +422,24 @@ namespace ignition
       /// \brief Notifies when the show menu flag has changed.
       signals: void ShowPluginMenuChanged();
 
+      /// \brief Notifies when the lightweight flag has changed.
+      signals: void LightweightChanged();
+
       /// \brief Notifies when the window config has changed.
       signals: void configChanged();
 
       /// \brief Displays a message to the user
       signals: void notify(const QString &_message);
 
+      /// \brief Notifies when plugins were added to or removed from the
+      /// plugin directories, or the directories changed, so
+      /// PluginListModel should be called again.
+      signals: void PluginListChanged();
+
+      /// \brief Forget the plugin list, so it's built again when next
+      /// needed.
+      private slots: void OnPluginsChanged();
+
       /// \internal
       /// \brief Private data pointer
       private: std::unique_ptr<MainWindowPrivate> dataPtr;
@@ -419,6 +455,13 @@ namespace ignition
       /// can't be parsed into XML.
       bool MergeFromXML(const std::string &_xml);
 
+      /// \brief Update this config from a parsed <window> element. Only
+      /// fields present on the element will be overriden / appended /
+      /// created.
+      /// \param[in] _windowElem The <window> element
+      /// \return True if successful.
+      bool MergeFromXML(const tinyxml2::XMLElement *_windowElem);
+
       /// \brief Return this configuration in XML format as a string.
       /// \return String containing a complete config file.
       std::string XMLString() const;
@@ -475,6 +518,9 @@ namespace ignition
       /// \brief Plugin toolbar text color dark
       std::string pluginToolBarTextColorDark{""};
 
+      /// \brief Draw cards without animations and shadows
+      bool lightweight{false};
+
       /// \brief Show the side drawer
       bool showDrawer{true};
 
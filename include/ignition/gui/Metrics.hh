@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GUI_METRICS_HH_
+#define IGNITION_GUI_METRICS_HH_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "ignition/gui/Export.hh"
+#include "ignition/gui/PluginAccounting.hh"
+#include "ignition/gui/Trace.hh"
+
+#ifdef _WIN32
+// Disable warning C4251 which is triggered by
+// std::unique_ptr
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+
+namespace ignition
+{
+  namespace gui
+  {
+    class Plugin;
+    class MetricsPrivate;
+
+    /// \brief Events counted for the whole process
+    enum class MetricCounter : int
+    {
+      /// \brief GUI thread stalls reported by the StallWatchdog
+      kStalls = 0,
+
+      /// \brief Images received but never shown, such as because newer
+      /// ones replaced them
+      kDroppedImages = 1,
+
+      /// \brief Points added to plots
+      kPlotPoints = 2
+    };
+
+    /// \brief Performance counters of the GUI, served over HTTP in the
+    /// Prometheus text format, or OpenMetrics when the scraper asks for
+    /// it, so that many GUI instances can be watched from one place.
+    ///
+    /// Exported are the time between frames of the main window, the
+    /// counters of MetricCounter, the time plugins spend in transport
+    /// callbacks, events and render hooks, and the resident memory of the
+    /// process. Rates, such as plot points per second, are left to the
+    /// scraper, from the totals.
+    ///
+    /// Counters are atomics updated where the work happens, and the
+    /// endpoint is served from its own thread, so scraping never waits
+    /// for the GUI thread. Plugin times are only measured while the
+    /// endpoint is running, or while PluginAccounting is enabled.
+    ///
+    /// The application starts the endpoint when the IGN_GUI_METRICS_PORT
+    /// environment variable holds a port, on the address in
+    /// IGN_GUI_METRICS_ADDRESS if set. See Application::StartMetrics.
+    /// It isn't available on Windows.
+    class IGNITION_GUI_VISIBLE Metrics
+    {
+      /// \brief Constructor. Use Instance instead.
+      public: Metrics();
+
+      /// \brief Destructor, stops the endpoint
+      public: ~Metrics();
+
+      /// \brief Get the metrics shared by the whole process.
+      /// \return Metrics
+      public: static Metrics &Instance();
+
+      /// \brief Start serving the metrics at
+      /// http://<address>:<port>/metrics. Restarts the endpoint if it was
+      /// running. Only this machine can scrape it unless another address
+      /// is given.
+      /// \param[in] _port TCP port, 0 to let the system choose one
+      /// \param[in] _address IPv4 address to listen on, "0.0.0.0" for all
+      /// network interfaces
+      /// \return False if the address or port couldn't be listened on
+      public: bool Start(const int _port,
+                         const std::string &_address = "127.0.0.1");
+
+      /// \brief Stop serving the metrics. Counters keep their values.
+      public: void Stop();
+
+      /// \brief Whether the endpoint is running.
+      /// \return True between a successful Start and Stop
+      public: bool Enabled() const;
+
+      /// \brief Get the port the endpoint listens on.
+      /// \return Port, 0 if not running
+      public: int Port() const;
+
+      /// \brief Count events. Can be called from any thread.
+      /// \param[in] _counter What happened
+      /// \param[in] _count Number of times it happened
+      public: void Add(const MetricCounter _counter,
+                       const std::uint64_t _count = 1u);
+
+      /// \brief Get the number of events counted so far.
+      /// \param[in] _counter Counter
+      /// \return Total
+      public: std::uint64_t Count(const MetricCounter _counter) const;
+
+      /// \brief Record that the main window showed a frame. The time since
+      /// the previous frame is added to the frame time histogram, unless
+      /// the window was idle for longer than a second. Can be called from
+      /// any thread, such as the render thread.
+      /// \param[in] _time Time the frame was shown
+      public: void AddFrame(const Trace::Clock::time_point &_time);
+
+      /// \brief Get the number of frames recorded so far.
+      /// \return Frames
+      public: std::uint64_t FrameCount() const;
+
+      /// \brief Start exporting the times of a plugin. Called when a
+      /// plugin is loaded, again to update its name.
+      /// \param[in] _plugin Plugin
+      /// \param[in] _name Name the plugin is exported with, such as its
+      /// title
+      public: void Track(const Plugin *_plugin, const std::string &_name);
+
+      /// \brief Stop exporting the times of a plugin, before it's
+      /// destroyed.
+      /// \param[in] _plugin Plugin
+      public: void Forget(const Plugin *_plugin);
+
+      /// \brief Add time spent by a plugin. Ignored for plugins which
+      /// aren't tracked. Can be called from any thread, without locking.
+      /// \param[in] _plugin Plugin
+      /// \param[in] _kind What the time was spent on
+      /// \param[in] _duration Time spent
+      public: void AddPluginCost(const Plugin *_plugin, const CostKind _kind,
+                                 const Trace::Clock::duration &_duration);
+
+      /// \brief Get the current metrics, as served by the endpoint.
+      /// \param[in] _openMetrics True for the OpenMetrics format, false
+      /// for the Prometheus text format
+      /// \return Metrics text
+      public: std::string Text(const bool _openMetrics) const;
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<MetricsPrivate> dataPtr;
+    };
+  }
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif
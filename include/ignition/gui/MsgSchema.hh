@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GUI_MSGSCHEMA_HH_
+#define IGNITION_GUI_MSGSCHEMA_HH_
+
+#include <google/protobuf/message.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ignition/gui/Export.hh"
+
+#ifdef _WIN32
+// Disable warning C4251 which is triggered by
+// std::unique_ptr
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+
+namespace ignition
+{
+  namespace gui
+  {
+    class MsgSchemaPrivate;
+
+    /// \brief What's known about a message type, worked out once per
+    /// process and shared by all plugins.
+    ///
+    /// Schemas are immutable, so they can be used from any thread.
+    class IGNITION_GUI_VISIBLE MsgSchema
+    {
+      /// \brief Constructor. Use Find instead.
+      /// \param[in] _prototype Default instance of the type
+      private: explicit MsgSchema(
+          std::unique_ptr<google::protobuf::Message> _prototype);
+
+      /// \brief Destructor
+      public: ~MsgSchema();
+
+      /// \brief Get the schema of a message type, creating it on first use.
+      /// \param[in] _msgType Message type, such as "ignition.msgs.Pose".
+      /// \return The schema, null if the type isn't known.
+      public: static std::shared_ptr<const MsgSchema> Find(
+          const std::string &_msgType);
+
+      /// \brief Get the full name of the type.
+      /// \return Name such as "ignition.msgs.Pose".
+      public: const std::string &Name() const;
+
+      /// \brief Get the descriptor of the type.
+      /// \return The descriptor, never null.
+      public: const google::protobuf::Descriptor *Descriptor() const;
+
+      /// \brief Get a message with all fields at their default values.
+      /// \return Shared default instance.
+      public: const google::protobuf::Message &DefaultInstance() const;
+
+      /// \brief Create a new message of the type, which is cheaper than
+      /// going through the message factory.
+      /// \return New message with default values.
+      public: std::unique_ptr<google::protobuf::Message> New() const;
+
+      /// \brief Get the paths of all fields which can be plotted, such as
+      /// "pose-position-x". Repeated fields are skipped.
+      /// \return Paths, in declaration order.
+      public: const std::vector<std::string> &PlottableFields() const;
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<MsgSchemaPrivate> dataPtr;
+    };
+  }
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif
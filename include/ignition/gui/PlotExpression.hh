@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GUI_PLOTEXPRESSION_HH_
+#define IGNITION_GUI_PLOTEXPRESSION_HH_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ignition/gui/Export.hh"
+
+#ifdef _WIN32
+// Disable warning C4251 which is triggered by
+// std::unique_ptr
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+
+namespace ignition
+{
+  namespace gui
+  {
+    class PlotExpressionPrivate;
+
+    /// \brief Expression computing a derived plot series from the values
+    /// of other series, such as the speed from velocity components:
+    ///
+    ///     sqrt({/odom-twist-linear-x}^2 + {/odom-twist-linear-y}^2)
+    ///
+    /// Series are referred to by their field path or component ID between
+    /// braces. Expressions have numbers, the constants pi and e,
+    /// + - * / ^, parentheses and these functions:
+    ///
+    /// * abs, sqrt, exp, log, sin, cos, tan, atan2(y, x), min(a, b),
+    ///   max(a, b)
+    /// * ema(x, alpha): exponential moving average with a constant
+    ///   smoothing factor between 0 and 1
+    /// * derivative(x): change of x by unit of the x coordinate
+    /// * integral(x): trapezoidal integral of x over the x coordinate
+    ///
+    /// The expression is compiled once into instructions for a small stack
+    /// machine, which is then run for each sample. The filters keep their
+    /// state between samples, so samples should be evaluated in order.
+    class IGNITION_GUI_VISIBLE PlotExpression
+    {
+      /// \brief Constructor
+      public: PlotExpression();
+
+      /// \brief Copy constructor, copying the compiled expression and the
+      /// state of its filters
+      /// \param[in] _other Expression to copy
+      public: PlotExpression(const PlotExpression &_other);
+
+      /// \brief Destructor
+      public: ~PlotExpression();
+
+      /// \brief Assignment operator
+      /// \param[in] _other Expression to copy
+      /// \return Reference to this
+      public: PlotExpression &operator=(const PlotExpression &_other);
+
+      /// \brief Compile an expression, replacing the current one.
+      /// \param[in] _text Expression
+      /// \return False if the expression isn't valid, an error is printed
+      public: bool Compile(const std::string &_text);
+
+      /// \brief Get whether an expression was compiled.
+      /// \return True if Evaluate can be called
+      public: bool Valid() const;
+
+      /// \brief Get the text of the compiled expression.
+      /// \return Expression, empty if none was compiled
+      public: const std::string &Text() const;
+
+      /// \brief Get the series the expression reads.
+      /// \return Field paths or component IDs, in the order of their first
+      /// appearance, which is the order of the values given to Evaluate
+      public: const std::vector<std::string> &Inputs() const;
+
+      /// \brief Evaluate the expression for a sample.
+      /// \param[in] _x X coordinate of the sample, such as its time
+      /// \param[in] _inputs Current value of each input, see Inputs
+      /// \param[out] _y Value of the expression
+      /// \return False if there's no value, such as for the first sample of
+      /// a derivative or when the result isn't a finite number
+      public: bool Evaluate(double _x, const std::vector<double> &_inputs,
+                            double &_y);
+
+      /// \brief Forget the state of the filters, as if no sample was
+      /// evaluated yet.
+      public: void Reset();
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<PlotExpressionPrivate> dataPtr;
+    };
+  }
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif
@@ -0,0 +1,247 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GUI_PLOTITEM_HH_
+#define IGNITION_GUI_PLOTITEM_HH_
+
+#include <memory>
+
+#include "ignition/gui/qt.h"
+#include "ignition/gui/Export.hh"
+
+#ifdef _WIN32
+// Disable warning C4251 which is triggered by
+// std::unique_ptr
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+
+namespace ignition
+{
+  namespace gui
+  {
+    class PlotItemPrivate;
+
+    /// \brief Quick item drawing one series of a PlottingInterface as a
+    /// line, straight from its point store.
+    ///
+    /// The item maps the range between minX / maxX and minY / maxY to its
+    /// own rectangle. Points are read from the store while the scene graph
+    /// syncs, spanning a window of three times the range at about one point
+    /// per pixel, so zooming and scrolling within the window only change a
+    /// transform. New points at full resolution are appended to the line,
+    /// the whole window is only read again when the range leaves it or the
+    /// level of detail changes.
+    class IGNITION_GUI_VISIBLE PlotItem : public QQuickItem
+    {
+      Q_OBJECT
+
+      /// \brief PlottingInterface storing the points
+      Q_PROPERTY(
+        QObject *plotting
+        READ Plotting
+        WRITE SetPlotting
+        NOTIFY PlottingChanged
+      )
+
+      /// \brief Chart ID of the series
+      Q_PROPERTY(
+        int chartId
+        READ ChartId
+        WRITE SetChartId
+        NOTIFY ChartIdChanged
+      )
+
+      /// \brief Field path or component ID of the series
+      Q_PROPERTY(
+        QString fieldId
+        READ FieldId
+        WRITE SetFieldId
+        NOTIFY FieldIdChanged
+      )
+
+      /// \brief Line color
+      Q_PROPERTY(
+        QColor color
+        READ Color
+        WRITE SetColor
+        NOTIFY ColorChanged
+      )
+
+      /// \brief Line width in pixels
+      Q_PROPERTY(
+        qreal lineWidth
+        READ LineWidth
+        WRITE SetLineWidth
+        NOTIFY LineWidthChanged
+      )
+
+      /// \brief x coordinate at the left edge
+      Q_PROPERTY(
+        qreal minX
+        READ MinX
+        WRITE SetMinX
+        NOTIFY RangeChanged
+      )
+
+      /// \brief x coordinate at the right edge
+      Q_PROPERTY(
+        qreal maxX
+        READ MaxX
+        WRITE SetMaxX
+        NOTIFY RangeChanged
+      )
+
+      /// \brief y coordinate at the bottom edge
+      Q_PROPERTY(
+        qreal minY
+        READ MinY
+        WRITE SetMinY
+        NOTIFY RangeChanged
+      )
+
+      /// \brief y coordinate at the top edge
+      Q_PROPERTY(
+        qreal maxY
+        READ MaxY
+        WRITE SetMaxY
+        NOTIFY RangeChanged
+      )
+
+      /// \brief Constructor
+      /// \param[in] _parent Parent item
+      public: explicit PlotItem(QQuickItem *_parent = nullptr);
+
+      /// \brief Destructor
+      public: ~PlotItem() override;
+
+      /// \brief Get the PlottingInterface storing the points.
+      /// \return The interface, null if not set
+      public: QObject *Plotting() const;
+
+      /// \brief Set the PlottingInterface storing the points.
+      /// \param[in] _plotting A PlottingInterface
+      public: void SetPlotting(QObject *_plotting);
+
+      /// \brief Notify that the interface has changed
+      signals: void PlottingChanged();
+
+      /// \brief Get the chart ID of the series.
+      /// \return Chart ID
+      public: int ChartId() const;
+
+      /// \brief Set the chart ID of the series.
+      /// \param[in] _chart Chart ID
+      public: void SetChartId(int _chart);
+
+      /// \brief Notify that the chart ID has changed
+      signals: void ChartIdChanged();
+
+      /// \brief Get the field of the series.
+      /// \return Field path or component ID
+      public: QString FieldId() const;
+
+      /// \brief Set the field of the series.
+      /// \param[in] _fieldID Field path or component ID
+      public: void SetFieldId(const QString &_fieldID);
+
+      /// \brief Notify that the field has changed
+      signals: void FieldIdChanged();
+
+      /// \brief Get the line color.
+      /// \return Color
+      public: QColor Color() const;
+
+      /// \brief Set the line color.
+      /// \param[in] _color Color
+      public: void SetColor(const QColor &_color);
+
+      /// \brief Notify that the color has changed
+      signals: void ColorChanged();
+
+      /// \brief Get the line width.
+      /// \return Width in pixels
+      public: qreal LineWidth() const;
+
+      /// \brief Set the line width.
+      /// \param[in] _width Width in pixels
+      public: void SetLineWidth(qreal _width);
+
+      /// \brief Notify that the line width has changed
+      signals: void LineWidthChanged();
+
+      /// \brief Get the x coordinate at the left edge.
+      /// \return x coordinate
+      public: qreal MinX() const;
+
+      /// \brief Set the x coordinate at the left edge.
+      /// \param[in] _x x coordinate
+      public: void SetMinX(qreal _x);
+
+      /// \brief Get the x coordinate at the right edge.
+      /// \return x coordinate
+      public: qreal MaxX() const;
+
+      /// \brief Set the x coordinate at the right edge.
+      /// \param[in] _x x coordinate
+      public: void SetMaxX(qreal _x);
+
+      /// \brief Get the y coordinate at the bottom edge.
+      /// \return y coordinate
+      public: qreal MinY() const;
+
+      /// \brief Set the y coordinate at the bottom edge.
+      /// \param[in] _y y coordinate
+      public: void SetMinY(qreal _y);
+
+      /// \brief Get the y coordinate at the top edge.
+      /// \return y coordinate
+      public: qreal MaxY() const;
+
+      /// \brief Set the y coordinate at the top edge.
+      /// \param[in] _y y coordinate
+      public: void SetMaxY(qreal _y);
+
+      /// \brief Notify that the range shown has changed
+      signals: void RangeChanged();
+
+      /// \brief Find the drawn point closest to an x coordinate, with a
+      /// binary search.
+      /// \param[in] _x x coordinate
+      /// \return The point as a QPointF, invalid if nothing is drawn
+      public: Q_INVOKABLE QVariant NearestPoint(qreal _x) const;
+
+      // Documentation inherited
+      protected: QSGNode *updatePaintNode(QSGNode *_oldNode,
+          QQuickItem::UpdatePaintNodeData *_data) override;
+
+      /// \brief Called when points were stored for a series
+      /// \param[in] _chart chart ID
+      /// \param[in] _handle series handle
+      private slots: void OnSeriesChanged(int _chart, int _handle);
+
+      /// \internal
+      /// \brief Pointer to private data.
+      private: std::unique_ptr<PlotItemPrivate> dataPtr;
+    };
+  }
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GUI_PLOTSPECTRUM_HH_
+#define IGNITION_GUI_PLOTSPECTRUM_HH_
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "ignition/gui/Export.hh"
+
+#ifdef _WIN32
+// Disable warning C4251 which is triggered by
+// std::unique_ptr
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+
+namespace ignition
+{
+  namespace gui
+  {
+    class PlotSpectrumPrivate;
+
+    /// \brief Amplitude spectrum of the samples of a plotted series, for
+    /// finding vibration and oscillation frequencies.
+    ///
+    /// Samples are resampled at a uniform rate over their time span, since
+    /// plotted points aren't always evenly spaced, then the mean is
+    /// removed, a window applied and a radix-2 FFT computed. The window,
+    /// twiddle factors and buffers are kept between calls, so computing
+    /// the spectrum of a new batch of samples doesn't allocate.
+    ///
+    /// An instance isn't safe to use from several threads at once, each
+    /// worker should have its own.
+    class IGNITION_GUI_VISIBLE PlotSpectrum
+    {
+      /// \brief Windows applied to the samples before the FFT
+      public: enum class Window
+      {
+        /// \brief No window, sharpest peaks but most leakage
+        RECTANGULAR,
+
+        /// \brief Hann window, a good default
+        HANN,
+
+        /// \brief Hamming window
+        HAMMING,
+
+        /// \brief Blackman window, least leakage but widest peaks
+        BLACKMAN
+      };
+
+      /// \brief Constructor
+      /// \param[in] _size Number of samples of the FFT, rounded up to a
+      /// power of two, at least 8
+      /// \param[in] _window Window applied to the samples
+      public: explicit PlotSpectrum(const std::size_t _size = 1024,
+                                    const Window _window = Window::HANN);
+
+      /// \brief Destructor
+      public: ~PlotSpectrum();
+
+      /// \brief Get the number of samples of the FFT.
+      /// \return Power of two
+      public: std::size_t Size() const;
+
+      /// \brief Compute the spectrum of samples.
+      /// \param[in] _x Time of each sample, increasing
+      /// \param[in] _y Value of each sample
+      /// \param[out] _frequencies Frequency of each bin, from 0 to the
+      /// Nyquist frequency, in cycles per unit of time
+      /// \param[out] _amplitudes Amplitude of each bin, in the unit of the
+      /// samples
+      /// \return False if there are fewer than 8 samples, if they don't
+      /// span any time, or if _x and _y don't have the same size
+      public: bool Compute(const std::vector<double> &_x,
+                           const std::vector<double> &_y,
+                           std::vector<double> &_frequencies,
+                           std::vector<double> &_amplitudes);
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<PlotSpectrumPrivate> dataPtr;
+    };
+  }
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif
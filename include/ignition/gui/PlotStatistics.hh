@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GUI_PLOTSTATISTICS_HH_
+#define IGNITION_GUI_PLOTSTATISTICS_HH_
+
+#include <cstddef>
+#include <memory>
+
+#include "ignition/gui/Export.hh"
+
+#ifdef _WIN32
+// Disable warning C4251 which is triggered by
+// std::unique_ptr
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+
+namespace ignition
+{
+  namespace gui
+  {
+    class PlotStatisticsPrivate;
+
+    /// \brief Running statistics of the values of a plotted series, updated
+    /// as values are added without keeping them.
+    ///
+    /// The mean and the variance are computed with Welford's method, which
+    /// stays accurate over long runs. Quantiles are estimated with a
+    /// t-digest, which keeps a bounded number of clusters of values, small
+    /// ones near the tails so that percentiles like the 99th stay accurate.
+    /// Values are buffered and merged into the digest in batches, so adding
+    /// a value costs about the same however many were added.
+    class IGNITION_GUI_VISIBLE PlotStatistics
+    {
+      /// \brief Constructor
+      /// \param[in] _compression Compression of the digest: about twice
+      /// the most clusters kept, higher is more accurate
+      public: explicit PlotStatistics(const double _compression = 100.0);
+
+      /// \brief Copy constructor
+      /// \param[in] _other Statistics to copy
+      public: PlotStatistics(const PlotStatistics &_other);
+
+      /// \brief Destructor
+      public: ~PlotStatistics();
+
+      /// \brief Assignment operator
+      /// \param[in] _other Statistics to copy
+      /// \return Reference to this
+      public: PlotStatistics &operator=(const PlotStatistics &_other);
+
+      /// \brief Add a value. Values which aren't finite are ignored.
+      /// \param[in] _value Value
+      public: void Add(const double _value);
+
+      /// \brief Forget all values.
+      public: void Clear();
+
+      /// \brief Get the number of values added.
+      /// \return Value count
+      public: std::size_t Count() const;
+
+      /// \brief Get the mean of the values.
+      /// \return Mean, 0 without values
+      public: double Mean() const;
+
+      /// \brief Get the sample variance of the values.
+      /// \return Variance, 0 with fewer than 2 values
+      public: double Variance() const;
+
+      /// \brief Get the sample standard deviation of the values.
+      /// \return Standard deviation, 0 with fewer than 2 values
+      public: double StdDev() const;
+
+      /// \brief Get the lowest value.
+      /// \return Lowest value, 0 without values
+      public: double Min() const;
+
+      /// \brief Get the highest value.
+      /// \return Highest value, 0 without values
+      public: double Max() const;
+
+      /// \brief Estimate a quantile of the values.
+      /// \param[in] _q Quantile between 0 and 1, such as 0.95 for the 95th
+      /// percentile
+      /// \return Estimate, exact for 0 and 1, 0 without values
+      public: double Quantile(const double _q) const;
+
+      /// \brief Get the number of clusters kept by the digest, after
+      /// merging the buffered values.
+      /// \return Cluster count
+      public: std::size_t Clusters() const;
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<PlotStatisticsPrivate> dataPtr;
+    };
+  }
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif
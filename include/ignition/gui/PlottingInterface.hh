@@ -20,7 +20,10 @@
 #include <QObject>
 #include <QString>
 #include <QMap>
+#include <QPointF>
 #include <QVariant>
+#include <QVector>
+#include <QRectF>
 #ifdef _MSC_VER
 #pragma warning(push, 0)
 #endif
@@ -34,13 +37,24 @@
 #include <string>
 #include <memory>
 #include <limits>
+#include <unordered_map>
+#include <vector>
 
 #include "ignition/gui/Export.hh"
+#include "ignition/gui/PlotStatistics.hh"
 
 namespace ignition
 {
 namespace gui
 {
+/// \brief Points waiting to be plotted, by chart ID and then by field path
+/// ID, oldest first
+using PlotPoints = std::map<int, std::map<QString, QVector<QPointF>>>;
+
+/// \brief Points waiting to be plotted, by series handle, oldest first.
+/// See PlottingInterface::Handle.
+using PlotHandlePoints = std::unordered_map<int, QVector<QPointF>>;
+
 class PlotDataPrivate;
 
 /// \brief Plot Data containter to hold value and registered charts
@@ -89,6 +103,209 @@ class IGNITION_GUI_VISIBLE PlotData
   private: std::unique_ptr<PlotDataPrivate> dataPtr;
 };
 
+class PlotSeriesPrivate;
+struct ExportJob;
+
+/// \brief Points of one plotted series, oldest first. Points are kept in a
+/// ring buffer of fixed capacity, with x and y in separate contiguous
+/// columns. Once full, each new point replaces the oldest one.
+///
+/// Points are also summed up in levels of detail, each one keeping the
+/// lowest and highest point of every bucket of 4, 16, 64... points, for a
+/// history much longer than the capacity. Points() reads the finest
+/// level which has about the number of points asked for, so drawing costs
+/// the same whatever the time span shown. Levels expect x to grow, such as
+/// time.
+class IGNITION_GUI_VISIBLE PlotSeries
+{
+  /// \brief Constructor
+  /// \param[in] _capacity Most points kept
+  public: explicit PlotSeries(const std::size_t _capacity = 10000);
+
+  /// \brief Destructor
+  public: ~PlotSeries();
+
+  /// \brief Add a point, dropping the oldest one if full.
+  /// \param[in] _x x coordinate of the point
+  /// \param[in] _y y coordinate of the point
+  public: void Append(const double _x, const double _y);
+
+  /// \brief Remove all points.
+  public: void Clear();
+
+  /// \brief Number of points.
+  /// \return Point count, up to the capacity
+  public: std::size_t Size() const;
+
+  /// \brief Most points kept.
+  /// \return Capacity
+  public: std::size_t Capacity() const;
+
+  /// \brief Change how many points are kept, keeping the newest ones.
+  /// \param[in] _capacity Most points kept, at least 1
+  public: void SetCapacity(const std::size_t _capacity);
+
+  /// \brief Get the x coordinate of a point.
+  /// \param[in] _index Point index, 0 being the oldest
+  /// \return x coordinate
+  public: double X(const std::size_t _index) const;
+
+  /// \brief Get the y coordinate of a point.
+  /// \param[in] _index Point index, 0 being the oldest
+  /// \return y coordinate
+  public: double Y(const std::size_t _index) const;
+
+  /// \brief Find the point closest in x to a coordinate, by binary search
+  /// over the points kept at full resolution.
+  /// \param[in] _x x coordinate, such as a time
+  /// \param[out] _point Closest point, unchanged if there are none
+  /// \return False if there are no points
+  public: bool Nearest(const double _x, QPointF &_point) const;
+
+  /// \brief Get the points between two x coordinates, reduced to about a
+  /// number of points by keeping the lowest and highest point of each
+  /// bucket. The points right outside the range are included, so lines
+  /// reach the edges.
+  /// \param[in] _minX Lowest x coordinate
+  /// \param[in] _maxX Highest x coordinate
+  /// \param[in] _count Number of points wanted, such as the width of the
+  /// chart in pixels
+  /// \param[out] _full Set to whether the points are all the ones within
+  /// the range, at full resolution
+  /// \return Points, oldest first
+  public: QVector<QPointF> Points(const double _minX, const double _maxX,
+                                  const std::size_t _count,
+                                  bool *_full = nullptr) const;
+
+  /// \brief Get the bounds of all points appended since the last Clear,
+  /// not only the ones kept at full resolution.
+  /// \return Bounds, only meaningful if Size isn't 0
+  public: QRectF Bounds() const;
+
+  /// \brief Get the running statistics of the y coordinates of all points
+  /// appended since the last Clear, not only the ones kept at full
+  /// resolution.
+  /// \return Statistics
+  public: const PlotStatistics &Statistics() const;
+
+  /// \brief Record all points appended from now on to a file as well, so
+  /// Points can read them back at full resolution once they're gone from
+  /// memory. Only a chunk of points is kept in memory while recording.
+  /// An existing file at that path is replaced.
+  /// \param[in] _path File path
+  /// \return False if the file can't be written
+  public: bool StartRecording(const std::string &_path);
+
+  /// \brief Stop recording and close the file, which is kept.
+  public: void StopRecording();
+
+  /// \brief Whether points are being recorded. Turns false if writing the
+  /// file fails.
+  /// \return True if recording
+  public: bool Recording() const;
+
+  /// \brief Private data member.
+  private: std::unique_ptr<PlotSeriesPrivate> dataPtr;
+};
+
+/// \brief How the samples of a plotted field are reduced as messages come
+/// in, before they're queued for the UI.
+struct IGNITION_GUI_VISIBLE PlotSampling
+{
+  /// \brief Ways of reducing samples
+  enum class Mode
+  {
+    /// \brief Keep a sample, then drop the ones less than period after it
+    THROTTLE,
+
+    /// \brief Keep every sample
+    ALL,
+
+    /// \brief Keep one sample out of count
+    DECIMATE,
+
+    /// \brief Average the samples of each period, plotted at its last one
+    AVERAGE,
+
+    /// \brief Keep the lowest and highest samples of each period
+    MIN_MAX
+  };
+
+  /// \brief Parse a policy such as "all", "throttle 0.05", "decimate 10",
+  /// "average 0.1" or "minmax 0.1", where numbers are periods in seconds
+  /// or sample counts.
+  /// \param[in] _text Policy
+  /// \param[out] _sampling Parsed policy, untouched if it can't be parsed
+  /// \return False if the text isn't a policy
+  static bool Parse(const std::string &_text, PlotSampling &_sampling);
+
+  /// \brief How samples are reduced
+  Mode mode = Mode::THROTTLE;
+
+  /// \brief Period in seconds for THROTTLE, AVERAGE and MIN_MAX
+  double period = 1.0 / 60;
+
+  /// \brief Number of samples for DECIMATE
+  unsigned int count = 1;
+};
+
+/// \brief A component attribute plotted on a chart, such as the position
+/// of a joint. Components are plotted by the application showing the
+/// entities, such as a simulator, through the component signals and
+/// slots of PlottingInterface.
+struct IGNITION_GUI_VISIBLE PlotComponent
+{
+  /// \brief Get the series ID of the attribute, as its chart names it:
+  /// "entity,typeId,attribute".
+  /// \return ID
+  QString Id() const;
+
+  /// \brief Entity which has the component
+  uint64_t entity = 0;
+
+  /// \brief Component type ID
+  uint64_t typeId = 0;
+
+  /// \brief Data type of the component, such as "Pose3d"
+  std::string type;
+
+  /// \brief Attribute of the data, such as "x" or "roll"
+  std::string attribute;
+
+  /// \brief Chart ID
+  int chart = 0;
+};
+
+class PlotClockPrivate;
+
+/// \brief Clock giving the time of points from msgs without a header
+/// stamp. It reads a steady clock, in seconds since it was created, or
+/// the simulation time published on a world statistics topic once one is
+/// set. Time is read when a msg arrives, nothing ticks in between.
+class IGNITION_GUI_VISIBLE PlotClock
+{
+  /// \brief Constructor
+  public: PlotClock();
+
+  /// \brief Destructor
+  public: ~PlotClock();
+
+  /// \brief Get the current time.
+  /// \return Simulation time if stats were received, otherwise seconds
+  /// since the clock was created
+  public: double Now() const;
+
+  /// \brief Follow the simulation time of a world statistics topic, such
+  /// as /world/default/stats.
+  /// \param[in] _topic Topic publishing ignition::msgs::WorldStatistics,
+  /// empty to go back to the steady clock
+  /// \return False if the topic couldn't be subscribed to
+  public: bool SetStatsTopic(const std::string &_topic);
+
+  /// \brief Private data member.
+  private: std::unique_ptr<PlotClockPrivate> dataPtr;
+};
+
 class TopicPrivate;
 
 /// \brief Plotting Topic to handle published topics & their registered fields
@@ -111,6 +328,14 @@ class IGNITION_GUI_VISIBLE Topic : public QObject
   /// \param[in] _chart Chart ID
   public: void Register(const std::string &_fieldPath, int _chart);
 
+  /// \brief Register a chart to a field, with the sampling of the field.
+  /// \param[in] _fieldPath model path to the field as an ID
+  /// \param[in] _chart Chart ID
+  /// \param[in] _sampling How the field's samples are reduced, replacing
+  /// the previous policy of the field
+  public: void Register(const std::string &_fieldPath, int _chart,
+                        const PlotSampling &_sampling);
+
   /// \brief Remove field from the plot
   /// \param[in] _fieldPath model path to the field as an ID
   /// \param[in] _chart Chart ID
@@ -134,11 +359,24 @@ class IGNITION_GUI_VISIBLE Topic : public QObject
   public: bool HasHeader(const google::protobuf::Message &_msg,
                          double &_headerTime);
 
-  /// \brief update the plot
+  /// \brief queue the current value of a field to be plotted on all of its
+  /// charts. Can be called from any thread.
   /// \param[in] _field field path or ID
   public: void UpdateGui(const std::string &_field);
 
+  /// \brief Take the points queued since the last call, so they can be
+  /// plotted all at once. Can be called from any thread.
+  /// \param[in,out] _points points are appended to these
+  public: void TakePoints(PlotPoints &_points);
+
+  /// \brief Take the points queued since the last call by series handle,
+  /// which is how they're queued. Can be called from any thread.
+  /// \param[in,out] _points points are appended to these
+  public: void TakePoints(PlotHandlePoints &_points);
+
   /// \brief update the GUI and plot the topic's fields values
+  /// \deprecated Points are queued and taken with TakePoints instead, so
+  /// this isn't emitted anymore.
   /// \param[in] _chart chart ID
   /// \param[in] _fieldID field path ID
   /// \param[in] _x x coordinates of the plot point
@@ -146,9 +384,14 @@ class IGNITION_GUI_VISIBLE Topic : public QObject
   signals: void plot(int _chart, QString _fieldID, double _x, double _y);
 
   /// \brief update the current time with the default time of the plotting timer
+  /// \deprecated Use SetClock, the time is only used without a clock.
   /// \param[in] _time current time of the plotting timer
   public: void SetPlottingTimeRef(const std::shared_ptr<double> &_time);
 
+  /// \brief Set the clock giving the time of msgs without a header stamp.
+  /// \param[in] _clock Clock, read when msgs arrive
+  public: void SetClock(const std::shared_ptr<const PlotClock> &_clock);
+
   /// \brief Private data member.
   private: std::unique_ptr<TopicPrivate> dataPtr;
 };
@@ -175,13 +418,34 @@ class IGNITION_GUI_VISIBLE Transport : public QObject
                            int _chart);
 
   /// \brief Subscribe/attatch a field from a certain chart
+  /// \deprecated Use the overload with a PlotClock.
   /// \param[in] _topic topic name
   /// \param[in] _fieldPath field path ID
   /// \param[in] _chart chart ID
   /// \param[in] _time ref to current plotting time
+  /// \param[in] _sampling how the field's samples are reduced
   public: void Subscribe(const std::string &_topic,
                          const std::string &_fieldPath,
-                         int _chart, const std::shared_ptr<double> &_time);
+                         int _chart, const std::shared_ptr<double> &_time,
+                         const PlotSampling &_sampling = PlotSampling());
+
+  /// \brief Subscribe/attatch a field from a certain chart
+  /// \param[in] _topic topic name
+  /// \param[in] _fieldPath field path ID
+  /// \param[in] _chart chart ID
+  /// \param[in] _clock clock giving the time of msgs without header
+  /// \param[in] _sampling how the field's samples are reduced
+  public: void Subscribe(const std::string &_topic,
+                         const std::string &_fieldPath,
+                         int _chart,
+                         const std::shared_ptr<const PlotClock> &_clock,
+                         const PlotSampling &_sampling = PlotSampling());
+
+  /// \brief Limit the rate each topic is received at, for topics
+  /// subscribed to already and from now on.
+  /// \param[in] _msgsPerSec Most messages per second, 0 for no limit
+  /// \sa SubscriptionHub::SetMsgsPerSec
+  public: void SetMsgsPerSec(const double _msgsPerSec);
 
   /// \brief Unsubscribe from non-exist topics in the transport
   public slots: void UnsubscribeOutdatedTopics();
@@ -190,6 +454,15 @@ class IGNITION_GUI_VISIBLE Transport : public QObject
   /// \return Topics list
   public: const std::map<std::string, Topic*> &Topics();
 
+  /// \brief Take the points queued by all topics since the last call.
+  /// \param[in,out] _points points are appended to these
+  public: void TakePoints(PlotPoints &_points);
+
+  /// \brief Take the points queued by all topics since the last call, by
+  /// series handle.
+  /// \param[in,out] _points points are appended to these
+  public: void TakePoints(PlotHandlePoints &_points);
+
   /// \brief Slot for receiving topics signal at each topic callback to plot
   /// \param[in] _chart chart ID
   /// \param[in] _fieldID field path ID
@@ -240,10 +513,39 @@ class IGNITION_GUI_VISIBLE PlottingInterface : public QObject
                                  QString _fieldPath,
                                  QString _topic);
 
+  /// \brief Set how samples of fields subscribed from now on are reduced,
+  /// unless a field has its own policy.
+  /// \param[in] _sampling Sampling policy
+  public: void SetDefaultSampling(const PlotSampling &_sampling);
+
+  /// \brief Set how samples of a field are reduced, from the next time
+  /// it's subscribed to.
+  /// \param[in] _topic the topic that includes that field
+  /// \param[in] _fieldPath path to the field to reach it from the msg
+  /// \param[in] _sampling Sampling policy
+  public: void SetSampling(const std::string &_topic,
+                           const std::string &_fieldPath,
+                           const PlotSampling &_sampling);
+
+  /// \brief Limit the rate each plotted topic is received at.
+  /// \param[in] _msgsPerSec Most messages per second, 0 for no limit
+  /// \sa Plugin::MsgsPerSec
+  public: void SetMsgsPerSec(const double _msgsPerSec);
+
+  /// \brief Set whether the charts can't be seen. Points keep being
+  /// stored, but the UI is only told about them once a second.
+  /// \param[in] _suspended True while the charts can't be seen
+  public: void SetSuspended(const bool _suspended);
+
   /// \brief Get the timeout of updating the plot
-  /// \return updating plot timeout
+  /// \deprecated There's no plotting timer anymore, see Clock.
+  /// \return Zero
   public: float Timeout() const;
 
+  /// \brief Get the clock giving the time of msgs without a header stamp.
+  /// \return The clock
+  public: PlotClock &Clock();
+
   /// \brief slot to get triggered to plot a point and send its data to the UI
   /// \param[in] _chart chart ID
   /// \param[in] _fieldID field path ID
@@ -258,6 +560,173 @@ class IGNITION_GUI_VISIBLE PlottingInterface : public QObject
   /// \param[in] _y y coordinates of the plot point
   signals: void plot(int _chart, QString _fieldID, double _x, double _y);
 
+  /// \brief Start storing the points of a series. Points plotted to series
+  /// which weren't added are dropped.
+  /// \param[in] _chart chart ID
+  /// \param[in] _fieldID field path or component ID
+  /// \param[in] _capacity most points kept
+  public slots: void AddSeries(int _chart, QString _fieldID, int _capacity);
+
+  /// \brief Start storing a series derived from others of the same chart
+  /// with an expression, such as the speed from velocity components. See
+  /// PlotExpression for what expressions can do. The expression is
+  /// compiled once, then evaluated in order for each point plotted to any
+  /// of its inputs, with the latest value of each input once all of them
+  /// got one. The inputs must be plotted on the chart, though they don't
+  /// need to be added. The derived series is removed with RemoveSeries.
+  /// \param[in] _chart chart ID
+  /// \param[in] _fieldID ID of the derived series, different from the IDs
+  /// of the fields and components
+  /// \param[in] _expression expression, its inputs are field paths or
+  /// component IDs of the chart
+  /// \param[in] _capacity most points kept
+  /// \return False if the expression isn't valid, nothing is added then
+  public slots: bool AddDerivedSeries(int _chart, QString _fieldID,
+                                      QString _expression, int _capacity);
+
+  /// \brief Stop storing the points of a series and free them.
+  /// \param[in] _chart chart ID
+  /// \param[in] _fieldID field path or component ID
+  public slots: void RemoveSeries(int _chart, QString _fieldID);
+
+  /// \brief Get the stored points of a series.
+  /// \param[in] _chart chart ID
+  /// \param[in] _fieldID field path or component ID
+  /// \return Points, null if the series wasn't added
+  public: const PlotSeries *Series(int _chart, const QString &_fieldID) const;
+
+  /// \brief Get the stored points of a series by handle.
+  /// \param[in] _handle series handle
+  /// \return Points, null if the series wasn't added
+  public: const PlotSeries *Series(int _handle) const;
+
+  /// \brief Get the handle of a series, a small integer standing for a
+  /// chart and field ID pair. Points are queued, stored and notified by
+  /// handle so the ID string isn't compared or hashed along the way.
+  /// A pair keeps its handle for the life of the process, whether the
+  /// series is added or not, and handles aren't reused. Can be called from
+  /// any thread.
+  /// \param[in] _chart chart ID
+  /// \param[in] _fieldID field path or component ID
+  /// \return Handle, zero or more
+  public: static int Handle(int _chart, const QString &_fieldID);
+
+  /// \brief Get the chart and field ID a handle stands for. Can be called
+  /// from any thread.
+  /// \param[in] _handle series handle
+  /// \param[out] _chart chart ID
+  /// \param[out] _fieldID field path or component ID
+  /// \return False if the handle was never given
+  public: static bool HandleKey(int _handle, int &_chart, QString &_fieldID);
+
+  /// \brief Get the handle of a series, from QML. See Handle.
+  /// \param[in] _chart chart ID
+  /// \param[in] _fieldID field path or component ID
+  /// \return Handle
+  public: Q_INVOKABLE int SeriesHandle(int _chart, QString _fieldID) const;
+
+  /// \brief Copy the stored points of a series into a QtCharts series
+  /// all at once.
+  /// \param[in] _chart chart ID
+  /// \param[in] _fieldID field path or component ID
+  /// \param[in] _series XY series to fill, such as a QML LineSeries
+  /// \return Bounds of the points, null if there are none
+  public: Q_INVOKABLE QRectF UpdateSeries(int _chart, QString _fieldID,
+                                          QObject *_series);
+
+  /// \brief Draw the stored points of a series shown between two x
+  /// coordinates into a QtCharts series, reduced to about a number of
+  /// points.
+  /// \param[in] _chart chart ID
+  /// \param[in] _fieldID field path or component ID
+  /// \param[in] _series XY series to fill, such as a QML LineSeries
+  /// \param[in] _minX lowest x coordinate shown
+  /// \param[in] _maxX highest x coordinate shown
+  /// \param[in] _count number of points wanted, such as the width of the
+  /// chart in pixels
+  /// \return Number of points drawn
+  public: Q_INVOKABLE int UpdateSeries(int _chart, QString _fieldID,
+                                       QObject *_series, double _minX,
+                                       double _maxX, int _count);
+
+  /// \brief Get the bounds of all points stored for a series, not only the
+  /// ones drawn.
+  /// \param[in] _chart chart ID
+  /// \param[in] _fieldID field path or component ID
+  /// \return Bounds as a QRectF, invalid if there are no points
+  public: Q_INVOKABLE QVariant SeriesBounds(int _chart,
+                                            QString _fieldID) const;
+
+  /// \brief Get the bounds of all points stored for a series by handle.
+  /// \param[in] _handle series handle
+  /// \return Bounds as a QRectF, invalid if there are no points
+  public: Q_INVOKABLE QVariant HandleBounds(int _handle) const;
+
+  /// \brief Get the running statistics of the y coordinates of all points
+  /// stored for a series, see PlotSeries::Statistics.
+  /// \param[in] _handle series handle
+  /// \return Map with the count, mean, stdDev, min, max and the p50, p95
+  /// and p99 percentiles, invalid if there are no points
+  public: Q_INVOKABLE QVariant SeriesStatistics(int _handle) const;
+
+  /// \brief Get the stored points of many series closest in x to a
+  /// coordinate, such as for a time cursor across all charts. See
+  /// PlotSeries::Nearest.
+  /// \param[in] _handles series handles
+  /// \param[in] _x x coordinate
+  /// \return One QPointF per handle, in the same order, invalid for the
+  /// series which don't exist or have no points
+  public: Q_INVOKABLE QVariantList ValuesAt(const QVariantList &_handles,
+                                            double _x) const;
+
+  /// \brief Start computing the amplitude spectrum of a series from its
+  /// most recent points, see PlotSpectrum. The points are copied at the
+  /// given rate and the FFT runs on a worker thread of the Executor, then
+  /// SpectrumChanged is emitted. A refresh is skipped while the previous
+  /// one is still running. Starting it again changes the settings.
+  /// \param[in] _handle series handle
+  /// \param[in] _size number of points of the FFT, rounded up to a power
+  /// of two
+  /// \param[in] _rate refreshes per second
+  public slots: void StartSpectrum(int _handle, int _size, double _rate);
+
+  /// \brief Stop computing the spectrum of a series and free it.
+  /// \param[in] _handle series handle
+  public slots: void StopSpectrum(int _handle);
+
+  /// \brief Copy the latest spectrum of a series into a QtCharts series,
+  /// as amplitudes by frequency.
+  /// \param[in] _handle series handle
+  /// \param[in] _series XY series to fill, such as a QML LineSeries
+  /// \return Bounds of the spectrum, null if there's none yet
+  public: Q_INVOKABLE QRectF UpdateSpectrum(int _handle,
+                                            QObject *_series) const;
+
+  /// \brief Notify that a new spectrum of a series is ready.
+  /// \param[in] _handle series handle
+  signals: void SpectrumChanged(int _handle);
+
+  /// \brief Notify that new points were stored for a series. Emitted at
+  /// most once per series each time the UI is refreshed.
+  /// \param[in] _chart chart ID
+  /// \param[in] _fieldID field path or component ID
+  signals: void SeriesChanged(int _chart, QString _fieldID);
+
+  /// \brief Notify that new points were stored for a series, by handle.
+  /// Emitted along with SeriesChanged.
+  /// \param[in] _chart chart ID
+  /// \param[in] _handle series handle
+  signals: void SeriesHandleChanged(int _chart, int _handle);
+
+  /// \brief Notify of the points plotted to a series since the last time,
+  /// all at once. Emitted at most once per series each time the UI is
+  /// refreshed, whether the series was added or not.
+  /// \param[in] _chart chart ID
+  /// \param[in] _fieldID field path or component ID
+  /// \param[in] _points new points, oldest first
+  signals: void PointsPlotted(int _chart, QString _fieldID,
+                              QVector<QPointF> _points);
+
   /// \brief called by Qml to register a chart to a component attribute
   /// \param[in] _entity entity id which has the component
   /// \param[in] _typeId component type id
@@ -281,6 +750,51 @@ class IGNITION_GUI_VISIBLE PlottingInterface : public QObject
                                             QString _attribute,
                                             int _chart);
 
+  /// \brief Subscribe to many component attributes at once, such as
+  /// all joints of a model. ComponentsSubscribe is emitted once, or
+  /// ComponentSubscribe for each attribute if nothing handles the batch.
+  /// \param[in] _components attributes
+  public: void SubscribeComponents(
+              const std::vector<PlotComponent> &_components);
+
+  /// \brief Subscribe to many component attributes at once, from QML.
+  /// \param[in] _components maps with the entity, typeId, type, attribute
+  /// and chart of each attribute, IDs as numbers or strings
+  public slots: void subscribeComponents(QVariantList _components);
+
+  /// \brief Unsubscribe from many component attributes at once, see
+  /// SubscribeComponents.
+  /// \param[in] _components attributes, their types aren't needed
+  public: void UnsubscribeComponents(
+              const std::vector<PlotComponent> &_components);
+
+  /// \brief Unsubscribe from many component attributes at once, from QML.
+  /// \param[in] _components maps with the entity, typeId, attribute and
+  /// chart of each attribute
+  public slots: void unsubscribeComponents(QVariantList _components);
+
+  /// \brief Notify the application to subscribe to component attributes,
+  /// all at once.
+  /// \param[in] _components attributes
+  signals: void ComponentsSubscribe(
+               const std::vector<ignition::gui::PlotComponent> &_components);
+
+  /// \brief Notify the application to unsubscribe from component
+  /// attributes, all at once.
+  /// \param[in] _components attributes
+  signals: void ComponentsUnSubscribe(
+               const std::vector<ignition::gui::PlotComponent> &_components);
+
+  /// \brief Plot the values of many component attributes at once, such
+  /// as those of one simulation step, instead of calling onPlot for each.
+  /// Series are given by handle, see Handle and PlotComponent::Id, which
+  /// can be resolved once when subscribing. The points are stored with
+  /// the next refresh of the UI, which is notified once per series. Can
+  /// be called from any thread.
+  /// \param[in] _points points by series handle, oldest first, at the
+  /// time of the values such as the simulation time
+  public: void PlotBatch(const PlotHandlePoints &_points);
+
   /// \brief Notify the gazebo plugin to subscribe to a component data
   /// \param[in] _entity entity id which has the component
   /// \param[in] _typeId component type id
@@ -307,7 +821,7 @@ class IGNITION_GUI_VISIBLE PlottingInterface : public QObject
   /// \brief Create suitable file path with unique name and extention
   /// \param[in] _path path selected from the UI
   /// \param[in] _name file name
-  /// \param[in] _extention file extention (csv or pdf)
+  /// \param[in] _extention file extention (csv, bin or pdf)
   public slots: std::string FilePath(QString _path, std::string _name,
                                      std::string _extention);
 
@@ -319,17 +833,110 @@ class IGNITION_GUI_VISIBLE PlottingInterface : public QObject
   public slots: bool exportCSV(QString _path, int _chart,
                                QMap< QString, QVariant> _serieses);
 
+  /// \brief export the stored series of a chart to csv files
+  /// \param[in] _path path of folder to save the csv files
+  /// \param[in] _chart plot id
+  /// \return True if successfully export, False if any error
+  public slots: bool exportCSV(QString _path, int _chart);
+
+  /// \brief Export the stored series of charts, one file per series,
+  /// written on a worker thread. The points are copied when called, so
+  /// later points aren't exported. Only one export is written at a time.
+  ///
+  /// The "bin" format is made of, in native byte order: the 8 characters
+  /// "IGNPLT01", the size of the series name as a uint32, the name, the
+  /// number of points as a uint64, then all x coordinates followed by all
+  /// y coordinates as doubles.
+  /// \param[in] _path path of folder to save the files
+  /// \param[in] _charts chart ids
+  /// \param[in] _format "csv" or "bin"
+  /// \return True if the export was started, see ExportFinished
+  public slots: bool ExportSeries(QString _path, QVariantList _charts,
+                                  QString _format);
+
+  /// \brief Record all series, current and future ones, to files in a
+  /// folder, one per series. Long histories can then be browsed at full
+  /// resolution while memory use stays the same.
+  /// \param[in] _path Folder, which must exist
+  /// \return False if the folder doesn't exist
+  public slots: bool StartRecording(QString _path);
+
+  /// \brief Stop recording, keeping the files.
+  public slots: void StopRecording();
+
+  /// \brief Whether series are being recorded.
+  /// \return True if recording
+  public: Q_INVOKABLE bool Recording() const;
+
+  /// \brief Notify that recording started or stopped
+  signals: void RecordingChanged();
+
+  /// \brief Notify of the progress of an export. Emitted from the worker
+  /// thread.
+  /// \param[in] _progress Share of the points written, from 0 to 1
+  signals: void ExportProgress(double _progress);
+
+  /// \brief Notify that an export is over. Emitted from the worker
+  /// thread.
+  /// \param[in] _success True if all files were written
+  signals: void ExportFinished(bool _success);
+
   /// \brief Get Component Name based on its type Id
   /// \param[in] _typeId type Id of the component
   /// \return Component name
   signals: std::string ComponentName(uint64_t _typeId);
 
   /// \brief configration of the timer
+  /// \deprecated There's no plotting timer anymore, this does nothing.
   public: void InitTimer();
 
   /// \brief update the plotting tool time
+  /// \deprecated Time is read from Clock, this does nothing.
   public slots: void UpdateTime();
 
+  /// \brief Store a plotted point in its series
+  /// \param[in] _chart chart ID
+  /// \param[in] _fieldID field path ID
+  /// \param[in] _x x coordinates of the plot point
+  /// \param[in] _y y coordinates of the plot point
+  private slots: void OnPoint(int _chart, QString _fieldID,
+                              double _x, double _y);
+
+  /// \brief Store the points queued by topics and notify the UI of the
+  /// series which got new points
+  private slots: void FlushSeries();
+
+  /// \brief Write a series to a csv file
+  /// \param[in] _path path of folder to save the csv file
+  /// \param[in] _chart plot id to make its name unique
+  /// \param[in] _key series key
+  /// \param[in] _series points
+  /// \return True if successfully written
+  private: bool WriteCSV(const QString &_path, int _chart,
+                         const std::string &_key,
+                         const PlotSeries &_series);
+
+  /// \brief Start recording a series to the recording folder
+  /// \param[in] _chart plot id to make its name unique
+  /// \param[in] _fieldID field path or component ID
+  /// \param[in] _series series to record
+  private: void RecordSeries(int _chart, const QString &_fieldID,
+                             PlotSeries &_series);
+
+  /// \brief Name the file of an exported series and copy its points
+  /// \param[in] _path path of folder to save the file
+  /// \param[in] _chart plot id to make its name unique
+  /// \param[in] _key series key
+  /// \param[in] _series points
+  /// \param[in] _extension file extension
+  /// \param[out] _job file, name and points to write
+  /// \return False if the file path can't be made
+  private: bool PrepareExport(const QString &_path, int _chart,
+                              const std::string &_key,
+                              const PlotSeries &_series,
+                              const std::string &_extension,
+                              ExportJob &_job);
+
   /// \brief Private data member.
   private: std::unique_ptr<PlottingIfacePrivate> dataPtr;
 };
@@ -18,6 +18,7 @@
 #define IGNITION_GUI_PLUGIN_HH_
 
 #include <tinyxml2.h>
+#include <cstddef>
 #include <memory>
 #include <string>
 
@@ -72,6 +73,17 @@ namespace ignition
       /// \param[in] _pluginElem Element containing configuration
       public: void Load(const tinyxml2::XMLElement *_pluginElem);
 
+      /// \brief Apply a new configuration to a plugin which is already
+      /// running, instead of creating it again. This is only possible if the
+      /// configuration only differs from the one the plugin was loaded with
+      /// in its card properties and anchors. Call PostParentChanges
+      /// afterwards to rearrange the card.
+      /// \param[in] _pluginElem Element containing the new configuration
+      /// \return True if the configuration was applied, false if the
+      /// plugin must be created again, in which case nothing changed.
+      /// \sa Application::LoadConfig
+      public: bool Reconfigure(const tinyxml2::XMLElement *_pluginElem);
+
       /// \brief Get the configuration XML as a string
       /// \return Config element
       public: virtual std::string ConfigStr();
@@ -85,6 +97,18 @@ namespace ignition
       /// \return Pointer to plugin item.
       public: QQuickItem *PluginItem() const;
 
+      /// \brief Whether the plugin's QML is still being created, which
+      /// happens when the application has an incubation budget. Until
+      /// Loaded is emitted, PluginItem is null and LoadConfig hasn't been
+      /// called.
+      /// \return True while loading.
+      /// \sa Application::SetIncubationBudget
+      public: bool Loading() const;
+
+      /// \brief Notify that the plugin's QML was created asynchronously and
+      /// its configuration loaded, successfully or not.
+      signals: void Loaded();
+
       /// \brief Get the QML context where the plugin was created.
       /// \return Pointer context.
       public: QQmlContext *Context() const;
@@ -104,15 +128,51 @@ namespace ignition
       protected: virtual void LoadConfig(
           const tinyxml2::XMLElement * /*_pluginElem*/) {}
 
+      /// \brief Called when the plugin's card is hidden or collapsed.
+      /// Override to stop work nobody can see, such as subscriptions and
+      /// timers.
+      /// \sa Resume
+      protected: virtual void Suspend() {}
+
+      /// \brief Called when the plugin's card is shown again after Suspend.
+      /// \sa Suspend
+      protected: virtual void Resume() {}
+
+      /// \brief Whether the plugin's card is shown and LoadConfig was called.
+      /// A plugin with <lazy>true</lazy> in its <ignition-gui> element is
+      /// only configured when its card is first shown.
+      /// \return True if active.
+      public: bool Active() const;
+
       /// \brief Get title
       /// \return Plugin title.
       public: virtual std::string Title() const {return this->title;}
 
+      /// \brief Estimate the memory held by the plugin's own buffers, such
+      /// as images or message histories, for accounting. Override on
+      /// plugins which keep large buffers.
+      /// \return Bytes, 0 by default.
+      /// \sa PluginAccounting
+      public: virtual std::size_t MemoryUsage() const {return 0u;}
+
+      /// \brief Whether the plugin's library must stay loaded after all its
+      /// plugins are closed. Libraries are unloaded by default, to give
+      /// their memory back. Override on plugins which leave code of their
+      /// library behind in Qt, such as types registered with QML.
+      /// \return False by default.
+      public: virtual bool KeepLoaded() const {return false;}
+
       /// \brief Get the value of the the `delete_later` element from the
       /// configuration file, which defaults to false.
       /// \return The value of `delete_later`.
       public: bool DeleteLaterRequested() const;
 
+      /// \brief Get the most messages per second the plugin wants from
+      /// each topic, from <qos msgs_per_sec="..."/> in its <ignition-gui>
+      /// element. Plugins pass it to SubscriptionHub::SetMsgsPerSec.
+      /// \return Messages per second, 0 for no limit.
+      public: double MsgsPerSec() const;
+
       /// \brief Wait until the plugin has a parent, then close and delete the
       /// parent.
       protected: void DeleteLater();
@@ -136,6 +196,10 @@ namespace ignition
       /// through the <anchor> tag and any state properties.
       private: void ApplyAnchors();
 
+      /// \brief Check whether the card is shown, loading the configuration
+      /// of a lazy plugin or suspending and resuming the plugin as needed.
+      private: void UpdateActive();
+
       /// \internal
       /// \brief Pointer to private data
       private: std::unique_ptr<PluginPrivate> dataPtr;
@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GUI_PLUGINACCOUNTING_HH_
+#define IGNITION_GUI_PLUGINACCOUNTING_HH_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ignition/gui/Export.hh"
+#include "ignition/gui/Trace.hh"
+
+#ifdef _WIN32
+// Disable warning C4251 which is triggered by
+// std::unique_ptr
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+
+namespace ignition
+{
+  namespace gui
+  {
+    class Plugin;
+    class PluginAccountingPrivate;
+
+    /// \brief What a plugin's time is spent on
+    enum class CostKind : int
+    {
+      /// \brief Transport callbacks, through the SubscriptionHub
+      kTransport = 0,
+
+      /// \brief Events and queued slots on the GUI thread
+      kEvent = 1,
+
+      /// \brief Render hooks
+      kRender = 2
+    };
+
+    /// \brief Time spent on one kind of work
+    struct CostUsage
+    {
+      /// \brief Number of calls
+      unsigned int calls{0};
+
+      /// \brief Total duration of the calls, in milliseconds
+      double total{0.0};
+
+      /// \brief Longest call, in milliseconds
+      double max{0.0};
+    };
+
+    /// \brief What a plugin cost since accounting was last reset
+    struct PluginCost
+    {
+      /// \brief Plugin
+      const Plugin *plugin{nullptr};
+
+      /// \brief Plugin title, or object name if it has no title
+      std::string name;
+
+      /// \brief Transport callbacks
+      CostUsage transport;
+
+      /// \brief Events and queued slots
+      CostUsage events;
+
+      /// \brief Render hooks
+      CostUsage render;
+
+      /// \brief Number of QML items in the plugin's card
+      std::size_t items{0};
+
+      /// \brief Estimated memory of the QML items plus the plugin's own
+      /// buffers, in bytes
+      /// \sa Plugin::MemoryUsage
+      std::size_t memory{0};
+    };
+
+    /// \brief Attributes the time spent in transport callbacks, events,
+    /// queued slots and render hooks to the plugin responsible, and
+    /// estimates the memory each plugin uses.
+    ///
+    /// Subscriptions and render hooks belong to the plugin which was
+    /// current when they were created: the plugin being configured, or the
+    /// one handling an event while accounting is enabled. Time is only
+    /// measured while accounting is enabled, which the Performance plugin
+    /// does, or while the Metrics are served.
+    class IGNITION_GUI_VISIBLE PluginAccounting
+    {
+      /// \brief Constructor. Use Instance instead.
+      public: PluginAccounting();
+
+      /// \brief Destructor
+      public: ~PluginAccounting();
+
+      /// \brief Get the accounting shared by the whole process.
+      /// \return Accounting
+      public: static PluginAccounting &Instance();
+
+      /// \brief Turn the measurement of time on or off.
+      /// \param[in] _enabled True to measure
+      public: void SetEnabled(const bool _enabled);
+
+      /// \brief Whether time is being measured.
+      /// \return True if enabled
+      public: bool Enabled() const;
+
+      /// \brief Get the plugin work on the calling thread is attributed to.
+      /// \return Plugin, null if none
+      /// \sa PluginCostScope
+      public: static const Plugin *CurrentPlugin();
+
+      /// \brief Start accounting for a plugin. Called by the application
+      /// when a plugin is added.
+      /// \param[in] _plugin Plugin
+      public: void Track(const Plugin *_plugin);
+
+      /// \brief Stop accounting for a plugin, before it's destroyed.
+      /// \param[in] _plugin Plugin
+      public: void Forget(const Plugin *_plugin);
+
+      /// \brief Add time spent by a plugin. Ignored for plugins which
+      /// aren't tracked, and while accounting is disabled. Also handed to
+      /// the Metrics while they're served. Can be called from any thread.
+      /// \param[in] _plugin Plugin
+      /// \param[in] _kind What the time was spent on
+      /// \param[in] _duration Time spent
+      public: void Add(const Plugin *_plugin, const CostKind _kind,
+                       const Trace::Clock::duration &_duration);
+
+      /// \brief Get what each tracked plugin cost since the last Reset,
+      /// and estimate their memory. Must be called from the GUI thread.
+      /// \return Costs, in the order plugins were tracked
+      public: std::vector<PluginCost> Costs() const;
+
+      /// \brief Clear the time accounted so far.
+      public: void Reset();
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<PluginAccountingPrivate> dataPtr;
+    };
+
+    /// \brief Attributes the work done on the calling thread, from its
+    /// construction to its destruction, to a plugin. While accounting is
+    /// enabled, the time is added to the plugin, unless the scope is nested
+    /// in another one of the same plugin.
+    class IGNITION_GUI_VISIBLE PluginCostScope
+    {
+      /// \brief Constructor
+      /// \param[in] _plugin Plugin, null for a scope which does nothing
+      /// \param[in] _kind What the time is spent on
+      public: PluginCostScope(const Plugin *_plugin, const CostKind _kind);
+
+      /// \brief Destructor, adds the time spent
+      public: ~PluginCostScope();
+
+      /// \brief Plugin
+      private: const Plugin *plugin;
+
+      /// \brief Plugin current before this scope
+      private: const Plugin *previous;
+
+      /// \brief What the time is spent on
+      private: CostKind kind;
+
+      /// \brief Whether the time is measured
+      private: bool timed{false};
+
+      /// \brief Time the scope started
+      private: Trace::Clock::time_point start;
+    };
+  }
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif
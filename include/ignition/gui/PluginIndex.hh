@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GUI_PLUGININDEX_HH_
+#define IGNITION_GUI_PLUGININDEX_HH_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ignition/gui/Export.hh"
+
+#ifdef _WIN32
+// Disable warning C4251 which is triggered by
+// std::unique_ptr
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+
+namespace ignition
+{
+  namespace gui
+  {
+    class PluginIndexPrivate;
+
+    /// \brief Index of the plugin libraries found on disk, kept in a file
+    /// so it outlives the process.
+    ///
+    /// It remembers the libraries in each plugin directory, where plugins
+    /// were found and which plugins each library exports. Entries are
+    /// checked against the modification times of the directories and
+    /// libraries they came from, so the file system is only scanned again
+    /// when something changed.
+    ///
+    /// Nothing here needs a QGuiApplication, so command line tools can list
+    /// and inspect plugins without starting QtQuick or needing a display.
+    ///
+    /// All functions can be called from any thread.
+    class IGNITION_GUI_VISIBLE PluginIndex
+    {
+      /// \brief Function searching the file system for a library.
+      public: using Finder = std::function<std::string()>;
+
+      /// \brief Constructor. Entries in the file are loaded, if it exists.
+      /// \param[in] _file Path to the file holding the index.
+      public: explicit PluginIndex(const std::string &_file);
+
+      /// \brief Destructor. Changes are saved.
+      public: ~PluginIndex();
+
+      /// \brief Get the index shared by the application, kept in
+      /// ~/.ignition/gui.
+      /// \return The index.
+      public: static PluginIndex &Instance();
+
+      /// \brief Get the directories searched for plugins, in order:
+      ///
+      /// 1. Paths given by the environment variable
+      /// 2. Extra paths
+      /// 3. Path ~/.ignition/gui/plugins
+      /// 4. The path where Ignition GUI plugins are installed
+      ///
+      /// \param[in] _env Name of the environment variable, such as
+      /// IGN_GUI_PLUGIN_PATH.
+      /// \param[in] _extra Extra paths.
+      /// \return Directories.
+      public: static std::vector<std::string> PluginDirectories(
+          const std::string &_env,
+          const std::vector<std::string> &_extra = {});
+
+      /// \brief Get the plugin libraries in a directory, that is, the files
+      /// whose name starts with "lib".
+      /// \param[in] _dir Path to the directory.
+      /// \return File names, empty if the directory doesn't exist.
+      public: std::vector<std::string> Libraries(const std::string &_dir);
+
+      /// \brief Find a plugin library. A previous result is returned
+      /// if none of the directories changed since.
+      /// \param[in] _dirs Directories searched, in order.
+      /// \param[in] _filename Plugin filename, such as "Publisher".
+      /// \param[in] _find Called to search the directories when there's no
+      /// valid entry, returns the path or an empty string.
+      /// \return Path to the library, empty if not found.
+      public: std::string FindLibrary(const std::vector<std::string> &_dirs,
+                                      const std::string &_filename,
+                                      const Finder &_find);
+
+      /// \brief Get the plugins exported by a library, as recorded with
+      /// SetPluginNames.
+      /// \param[in] _path Path to the library.
+      /// \return Plugin names, empty if unknown or if the library changed.
+      public: std::vector<std::string> PluginNames(
+          const std::string &_path) const;
+
+      /// \brief Record the plugins exported by a library.
+      /// \param[in] _path Path to the library.
+      /// \param[in] _names Plugin names.
+      public: void SetPluginNames(const std::string &_path,
+                                  const std::vector<std::string> &_names);
+
+      /// \brief Get the plugins exported by a library and the Qt resources
+      /// it holds, such as its QML files. Recorded values are returned if
+      /// the library didn't change, otherwise it's loaded to find out,
+      /// without instantiating any plugin. Resources can only be told apart
+      /// when the library wasn't loaded into the process before, so this is
+      /// meant for command line tools.
+      /// \param[in] _path Path to the library.
+      /// \param[out] _names Plugin names.
+      /// \param[out] _resources Resource paths, such as
+      /// ":/Publisher/Publisher.qml".
+      /// \return False if the library couldn't be loaded.
+      public: bool Inspect(const std::string &_path,
+                           std::vector<std::string> &_names,
+                           std::vector<std::string> &_resources);
+
+      /// \brief Write the index to its file, if it changed.
+      /// \return True if the file is up to date.
+      public: bool Save();
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<PluginIndexPrivate> dataPtr;
+    };
+  }
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif
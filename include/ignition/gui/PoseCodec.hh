@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GUI_POSECODEC_HH_
+#define IGNITION_GUI_POSECODEC_HH_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ignition/math/Pose3.hh>
+#include <ignition/msgs/pose_v.pb.h>
+
+#include "ignition/gui/Export.hh"
+
+#ifdef _WIN32
+// Disable warning C4251 which is triggered by
+// std::unique_ptr
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+
+namespace ignition
+{
+  namespace gui
+  {
+    class PoseDecoderPrivate;
+    class PoseEncoderPrivate;
+
+    /// \brief Encodes pose vector msgs compactly, for GUIs on slow links.
+    /// The result is published as the data of an ignition::msgs::Bytes msg,
+    /// and read by a Scene3D plugin with \<compact_poses\> set.
+    ///
+    /// Each frame only holds the entities whose pose changed since it was
+    /// last encoded. Positions are rounded to a fixed resolution and
+    /// rotations are stored as the three smallest quaternion components in
+    /// 48 bits, so an entity takes 22 bytes instead of the ~80 of a full
+    /// pose msg. Every few frames a keyframe holds all entities seen so
+    /// far, so that subscribers which joined late or missed frames catch
+    /// up. Poses are absolute, missing a frame only delays changes until
+    /// the entity moves again or the next keyframe.
+    ///
+    /// An encoder is meant to be used from one thread.
+    class IGNITION_GUI_VISIBLE PoseEncoder
+    {
+      /// \brief Constructor
+      /// \param[in] _resolution Position resolution in meters. Positions
+      /// up to 2^31 times this far from the origin can be encoded.
+      /// \param[in] _keyframeInterval Number of frames between keyframes,
+      /// zero for a keyframe only on the first frame.
+      public: explicit PoseEncoder(double _resolution = 1e-4,
+                  unsigned int _keyframeInterval = 30u);
+
+      /// \brief Destructor
+      public: ~PoseEncoder();
+
+      /// \brief Encode the next frame.
+      /// \param[in] _msg Poses of the entities which may have moved. The
+      /// header stamp is kept.
+      /// \return Encoded frame
+      public: std::string Encode(const msgs::Pose_V &_msg);
+
+      /// \brief Make the next frame a keyframe, for example when a
+      /// subscriber connects.
+      public: void ForceKeyframe();
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<PoseEncoderPrivate> dataPtr;
+    };
+
+    /// \brief Decodes frames made by a PoseEncoder.
+    ///
+    /// A decoder is meant to be used from one thread.
+    class IGNITION_GUI_VISIBLE PoseDecoder
+    {
+      /// \brief Constructor
+      public: PoseDecoder();
+
+      /// \brief Destructor
+      public: ~PoseDecoder();
+
+      /// \brief Decode a frame.
+      /// \param[in] _data Encoded frame
+      /// \param[out] _ids Ids of the entities in the frame
+      /// \param[out] _poses Pose of each of those entities
+      /// \param[out] _stamp Simulation time in seconds from the header of
+      /// the encoded msg, zero if it wasn't stamped
+      /// \return False if the data isn't a valid frame, the outputs are
+      /// unspecified then.
+      public: bool Decode(const std::string &_data,
+                          std::vector<unsigned int> &_ids,
+                          std::vector<math::Pose3d> &_poses,
+                          double &_stamp);
+
+      /// \brief Get the number of frames which were missed, going by their
+      /// sequence numbers.
+      /// \return Number of frames
+      public: unsigned int Missed() const;
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<PoseDecoderPrivate> dataPtr;
+    };
+  }
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif
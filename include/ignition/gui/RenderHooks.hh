@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GUI_RENDERHOOKS_HH_
+#define IGNITION_GUI_RENDERHOOKS_HH_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ignition/gui/Export.hh"
+
+#ifdef _WIN32
+// Disable warning C4251 which is triggered by
+// std::unique_ptr
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+
+namespace ignition
+{
+  namespace gui
+  {
+    class RenderHooksPrivate;
+
+    /// \brief How a render hook has been doing.
+    struct RenderHookStats
+    {
+      /// \brief Name given when registering
+      std::string name;
+
+      /// \brief Priority given when registering
+      int priority{0};
+
+      /// \brief Budget given when registering, in milliseconds
+      double budget{0.0};
+
+      /// \brief Duration of the latest call, in milliseconds
+      double last{0.0};
+
+      /// \brief Average duration of the calls, in milliseconds
+      double average{0.0};
+
+      /// \brief Longest call, in milliseconds
+      double max{0.0};
+
+      /// \brief Number of calls
+      std::uint64_t calls{0};
+
+      /// \brief Number of calls which took longer than the budget
+      std::uint64_t overBudget{0};
+
+      /// \brief Number of frames it is currently called every, including
+      /// the backoff after going over budget
+      unsigned int divisor{1};
+    };
+
+    /// \brief Functions called on the render thread of 3D scenes once a
+    /// frame was rendered, as an alternative to filtering the
+    /// events::Render event sent to the main window.
+    ///
+    /// Hooks are called in decreasing order of priority. Each can be
+    /// called only every few frames, and can be given a time budget. A
+    /// hook going over its budget is called half as often, down to once
+    /// every 16 times its divisor, and twice as often again each time it
+    /// fits in its budget, so a single slow hook doesn't hold back every
+    /// frame. The cost of each hook is recorded in its stats, and in the
+    /// trace when tracing is on.
+    ///
+    /// Functions can be called from any thread, hooks are called where Run
+    /// is.
+    class IGNITION_GUI_VISIBLE RenderHooks
+    {
+      /// \brief Function called after a frame was rendered
+      public: using Callback = std::function<void()>;
+
+      /// \brief Constructor
+      public: RenderHooks();
+
+      /// \brief Destructor
+      public: ~RenderHooks();
+
+      /// \brief Get the hooks run by the 3D scenes of the application.
+      /// \return The hooks.
+      public: static RenderHooks &Instance();
+
+      /// \brief Register a hook.
+      /// \param[in] _name Name, for stats and warnings, such as the plugin
+      /// name.
+      /// \param[in] _cb Function to call.
+      /// \param[in] _priority Hooks with higher priorities are called first.
+      /// \param[in] _budget Time the hook is expected to take, in
+      /// milliseconds, 0 for no budget.
+      /// \param[in] _divisor Call the hook every this many frames.
+      /// \return ID to unregister the hook, 0 if the callback is empty.
+      public: std::size_t Register(const std::string &_name,
+                                   const Callback &_cb,
+                                   int _priority = 0,
+                                   double _budget = 0.0,
+                                   unsigned int _divisor = 1);
+
+      /// \brief Unregister a hook. It won't be called once this returns,
+      /// unless it's unregistering itself.
+      /// \param[in] _id ID returned by Register.
+      public: void Unregister(std::size_t _id);
+
+      /// \brief Call the hooks due this frame. Called by the renderer after
+      /// each frame.
+      public: void Run();
+
+      /// \brief Get the stats of all hooks, in the order they're called.
+      /// \return Stats
+      public: std::vector<RenderHookStats> Stats() const;
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<RenderHooksPrivate> dataPtr;
+    };
+  }
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif
@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GUI_SCENEINDEX_HH_
+#define IGNITION_GUI_SCENEINDEX_HH_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ignition/gui/Export.hh"
+
+#ifdef _WIN32
+// Disable warning C4251 which is triggered by
+// std::unique_ptr
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+
+namespace ignition
+{
+  namespace gui
+  {
+    class SceneIndexPrivate;
+
+    /// \brief An entity shown in a 3D scene.
+    struct SceneEntity
+    {
+      /// \brief Kinds of entities
+      enum class Kind
+      {
+        /// \brief Model, at the top level or nested
+        MODEL,
+
+        /// \brief Link of a model
+        LINK,
+
+        /// \brief Visual of a link
+        VISUAL,
+
+        /// \brief Light, at the top level or in a link
+        LIGHT
+      };
+
+      /// \brief Entity id
+      unsigned int id{0u};
+
+      /// \brief Name, unique among the children of the parent only
+      std::string name;
+
+      /// \brief Name scoped by the names of the ancestors, such as
+      /// "model::link::visual"
+      std::string scopedName;
+
+      /// \brief Id of the parent, zero at the top level
+      unsigned int parent{0u};
+
+      /// \brief Kind of entity
+      Kind kind{Kind::MODEL};
+    };
+
+    /// \brief Read-only index of the entities of a 3D scene, for plugins
+    /// which refer to them, such as for selection, following or overlays.
+    /// Entities can be looked up by id or scoped name without going through
+    /// the rendering scene, and so can their rendering node.
+    ///
+    /// The Scene3D plugin showing the scene keeps the index up to date as it
+    /// loads and deletes entities, on the render thread. Queries can be made
+    /// from any thread, though render hooks registered with RenderHooks are
+    /// the only place where the scene can't change between a query and using
+    /// the rendering node.
+    class IGNITION_GUI_VISIBLE SceneIndex
+    {
+      /// \brief Constructor
+      public: SceneIndex();
+
+      /// \brief Destructor
+      public: ~SceneIndex();
+
+      /// \brief Get the index of a scene of the application.
+      /// \param[in] _scene Name of the rendering scene
+      /// \return The index, empty until a Scene3D plugin shows the scene.
+      public: static SceneIndex &Instance(const std::string &_scene = "scene");
+
+      /// \brief Get an entity.
+      /// \param[in] _id Entity id
+      /// \param[out] _entity The entity, untouched if it isn't in the scene
+      /// \return True if the entity is in the scene
+      public: bool Entity(unsigned int _id, SceneEntity &_entity) const;
+
+      /// \brief Get the id of an entity by its scoped name.
+      /// \param[in] _scopedName Scoped name, such as "model::link"
+      /// \return Entity id, zero if there's no such entity
+      public: unsigned int IdByName(const std::string &_scopedName) const;
+
+      /// \brief Get the children of an entity.
+      /// \param[in] _id Entity id, zero for the top level entities
+      /// \return Ids of the children, in the order they were added
+      public: std::vector<unsigned int> Children(unsigned int _id) const;
+
+      /// \brief Get the rendering node of an entity.
+      /// \tparam NodeT ignition::rendering::Node, cast to rendering::Visual
+      /// or rendering::Light afterwards
+      /// \param[in] _id Entity id
+      /// \return The node, null if the entity isn't in the scene or was
+      /// added without a node
+      public: template<typename NodeT>
+              std::shared_ptr<NodeT> Node(unsigned int _id) const
+      {
+        return std::static_pointer_cast<NodeT>(this->NodePtr(_id));
+      }
+
+      /// \brief Get the number of entities.
+      /// \return Number of entities
+      public: std::size_t Size() const;
+
+      /// \brief Get a number which changes each time entities are added or
+      /// removed, so that callers can cache what they derive from the index.
+      /// \return Revision
+      public: std::uint64_t Revision() const;
+
+      /// \brief Add an entity, or replace the entity with the same id.
+      /// Called by the plugin showing the scene.
+      /// \param[in] _entity Entity. The scoped name is filled in from the
+      /// parent, which should be added first.
+      /// \param[in] _node Rendering node of the entity, a
+      /// rendering::NodePtr.
+      public: void Add(const SceneEntity &_entity,
+                       const std::shared_ptr<void> &_node = nullptr);
+
+      /// \brief Remove an entity and its descendants. Called by the plugin
+      /// showing the scene.
+      /// \param[in] _id Entity id
+      public: void Remove(unsigned int _id);
+
+      /// \brief Remove all entities. Called by the plugin showing the scene.
+      public: void Clear();
+
+      /// \brief Get the rendering node of an entity, as stored.
+      /// \param[in] _id Entity id
+      /// \return The node, null if unknown or destroyed
+      private: std::shared_ptr<void> NodePtr(unsigned int _id) const;
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<SceneIndexPrivate> dataPtr;
+    };
+  }
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif
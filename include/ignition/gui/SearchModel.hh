@@ -17,24 +17,55 @@
 #ifndef IGNITION_GUI_SEARCHMODEL_HH_
 #define IGNITION_GUI_SEARCHMODEL_HH_
 
+#include <memory>
+
 #include "ignition/gui/Export.hh"
 #include "ignition/gui/qt.h"
 
+#ifdef _WIN32
+// Disable warning C4251 which is triggered by
+// std::unique_ptr
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+
 namespace ignition
 {
 namespace gui
 {
+  class SearchModelPrivate;
+  struct SearchMatch;
+
   /// \brief Customize the proxy model to display search results.
   ///
   /// Features:
   ///
   /// * This has been tested with QTreeView and QTableView.
   /// * Manages expansion of nested items through DataRole::TO_EXPAND when
-  ///   applicable
+  ///   applicable. The role is provided by this model, the source model
+  ///   is never written to.
   /// * Items with DataRole::TYPE == "title" are ignored
+  /// * The text of the source model is indexed once, and each search is
+  ///   matched against the whole tree in a single pass. Both are updated
+  ///   when the source model or the search change.
+  /// * With a delay, see SetDelay, searches wait for typing to pause and
+  ///   run on a background thread. The rows shown are updated at once when
+  ///   the search is done.
   ///
   class IGNITION_GUI_VISIBLE SearchModel : public QSortFilterProxyModel
   {
+    Q_OBJECT
+
+    /// \brief Constructor
+    public: SearchModel();
+
+    /// \brief Destructor
+    public: ~SearchModel() override;
+
+    /// \brief Overloaded Qt method. Index the new model.
+    /// \param[in] _sourceModel Model being searched.
+    public: void setSourceModel(QAbstractItemModel *_sourceModel) override;
+
     /// \brief Overloaded Qt method. Customize so we accept rows where:
     /// 1. Each of the words can be found in its ancestors or itself, but not
     /// necessarily all words on the same row, or
@@ -59,6 +90,14 @@ namespace gui
     public: bool filterAcceptsRow(const int _srcRow,
                                   const QModelIndex &_srcParent) const;
 
+    /// \brief Overloaded Qt method. DataRole::TO_EXPAND is true for rows
+    /// with a descendant containing one of the words.
+    /// \param[in] _index Index on this model.
+    /// \param[in] _role Data role.
+    /// \return Data of the role.
+    public: QVariant data(const QModelIndex &_index,
+                          int _role = Qt::DisplayRole) const override;
+
     /// \brief Check if row contains the word on itself.
     /// \param[in] _srcRow Row on the source model.
     /// \param[in] _srcParent Parent on the source model.
@@ -82,13 +121,53 @@ namespace gui
     public: bool HasChildAcceptsItself(const QModelIndex &_srcParent,
                                        const QString &_word) const;
 
-    /// \brief Set a new search value.
+    /// \brief Set a new search value. Without delay, the rows are filtered
+    /// right away. With a delay, a search waiting or in progress is
+    /// replaced by this one.
     /// \param[in] _search Full search string.
     public: void SetSearch(const QString &_search);
 
+    /// \brief Set how long to wait after the last SetSearch before
+    /// searching, so searching as the user types doesn't search for every
+    /// keystroke. Searches with a delay run on a background thread.
+    /// \param[in] _delay Delay in milliseconds, 0 to filter right away,
+    /// which is the default.
+    public: void SetDelay(const int _delay);
+
+    /// \brief Get how long to wait after the last SetSearch before
+    /// searching.
+    /// \return Delay in milliseconds, 0 if searches are done right away.
+    public: int Delay() const;
+
     /// \brief Full search string.
     public: QString search;
+
+    /// \brief Get the result of the search shown for a source row.
+    /// \param[in] _srcIndex Index on the source model.
+    /// \return The result, accepted and not expanded for unknown rows.
+    private: SearchMatch Match(const QModelIndex &_srcIndex) const;
+
+    /// \brief Take a snapshot of the source model if it changed.
+    private: void Snapshot() const;
+
+    /// \brief Filter the rows again.
+    private: void Refilter();
+
+    /// \brief Start searching in the background once the delay is over.
+    private slots: void StartSearch();
+
+    /// \brief Show the result of the background search.
+    private slots: void ApplySearch();
+
+    /// \internal
+    /// \brief Private data pointer
+    private: std::unique_ptr<SearchModelPrivate> dataPtr;
   };
 }
 }
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
 #endif
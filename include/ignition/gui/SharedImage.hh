@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GUI_SHAREDIMAGE_HH_
+#define IGNITION_GUI_SHAREDIMAGE_HH_
+
+#include <memory>
+#include <string>
+
+#include <ignition/msgs/image.pb.h>
+
+#include "ignition/gui/Export.hh"
+
+#ifdef _WIN32
+// Disable warning C4251 which is triggered by
+// std::unique_ptr
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+
+namespace ignition
+{
+  namespace gui
+  {
+    class SharedImageReaderPrivate;
+    class SharedImageWriterPrivate;
+
+    /// \brief Moves the pixels of image msgs into a ring of shared memory
+    /// slots, so that a process on the same host publishes a small msg
+    /// referring to the slot instead of the whole image. GUI plugins such
+    /// as ImageDisplay read the pixels straight from the slot with a
+    /// SharedImageReader.
+    ///
+    /// The ring holds a few frames. A reader which falls behind by more
+    /// than that misses frames rather than slowing the writer down. Only
+    /// subscribers on the same host can read the frames, so this is for
+    /// simulations whose GUI runs on the same workstation. Shared memory
+    /// isn't available on Windows.
+    ///
+    /// A writer is meant to be used from one thread.
+    class IGNITION_GUI_VISIBLE SharedImageWriter
+    {
+      /// \brief Constructor
+      /// \param[in] _slots Number of frames kept in the ring
+      public: explicit SharedImageWriter(unsigned int _slots = 3);
+
+      /// \brief Destructor. Removes the shared memory, readers which mapped
+      /// it keep their mapping.
+      public: ~SharedImageWriter();
+
+      /// \brief Move the pixels of a msg into the next slot, leaving the
+      /// msg without data and with a reference to the slot in its header.
+      /// The ring is created on the first call, and again with larger slots
+      /// if a frame doesn't fit.
+      /// \param[in,out] _msg Image msg to publish afterwards
+      /// \return False if shared memory isn't available, in which case the
+      /// msg is untouched and should be published as is.
+      public: bool Write(msgs::Image &_msg);
+
+      /// \brief Get the name of the shared memory.
+      /// \return Name, empty before the first frame is written.
+      public: std::string Name() const;
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<SharedImageWriterPrivate> dataPtr;
+    };
+
+    /// \brief Reads the pixels of image msgs written by a SharedImageWriter.
+    /// The shared memory is mapped the first time a msg refers to it, and
+    /// remapped when the writer changes.
+    ///
+    /// A reader is meant to be used from one thread.
+    class IGNITION_GUI_VISIBLE SharedImageReader
+    {
+      /// \brief Constructor
+      public: SharedImageReader();
+
+      /// \brief Destructor
+      public: ~SharedImageReader();
+
+      /// \brief Check whether a msg refers to a shared memory slot instead
+      /// of holding its pixels.
+      /// \param[in] _msg Image msg
+      /// \return True if the pixels are in shared memory
+      public: static bool IsShared(const msgs::Image &_msg);
+
+      /// \brief Fill the data of a msg from the slot it refers to.
+      /// \param[in,out] _msg Image msg for which IsShared is true
+      /// \return False if the slot can't be read, such as when the writer
+      /// is on another host, or when the frame was already replaced by a
+      /// newer one. The msg data is unspecified then.
+      public: bool Read(msgs::Image &_msg);
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<SharedImageReaderPrivate> dataPtr;
+    };
+  }
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif
@@ -0,0 +1,213 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGNITION_GUI_SPLITLAYOUT_HH_
+#define IGNITION_GUI_SPLITLAYOUT_HH_
+
+#include <memory>
+#include <vector>
+
+#include "ignition/gui/qt.h"
+#include "ignition/gui/Export.hh"
+
+#ifdef _WIN32
+// Disable warning C4251 which is triggered by
+// std::unique_ptr
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+
+namespace ignition
+{
+  namespace gui
+  {
+    class SplitLayoutPrivate;
+
+    /// \brief Quick item arranging the docked cards of the main window.
+    ///
+    /// Cards are docked into split items created by the layout. The first
+    /// item fills the left side of the layout, and the others are stacked
+    /// at their minimum heights in a column on the right, as wide as the
+    /// widest of their minimum widths. The column scrolls when it's taller
+    /// than the layout. Dragging the gaps between items resizes them.
+    ///
+    /// Items are arranged in C++, in a single pass before the next frame
+    /// however many items were added, removed or resized since the last
+    /// one, instead of through bindings evaluated for each change.
+    ///
+    /// Split items read their minimum size from "minimumWidth" and
+    /// "minimumHeight" properties, if they have them.
+    class IGNITION_GUI_VISIBLE SplitLayout : public QQuickItem
+    {
+      Q_OBJECT
+
+      /// \brief Component creating the split items, plain items if null
+      Q_PROPERTY(
+        QQmlComponent *delegate
+        READ Delegate
+        WRITE SetDelegate
+        NOTIFY DelegateChanged
+      )
+
+      /// \brief Split items keyed by their names
+      Q_PROPERTY(
+        QVariantMap childItems
+        READ ChildItems
+        NOTIFY ItemsChanged
+      )
+
+      /// \brief Rectangle of the column on the right, empty without it
+      Q_PROPERTY(
+        QRectF sideRect
+        READ SideRect
+        NOTIFY LayoutChanged
+      )
+
+      /// \brief Height of all items of the column
+      Q_PROPERTY(
+        qreal sideContentHeight
+        READ SideContentHeight
+        NOTIFY LayoutChanged
+      )
+
+      /// \brief How far the column is scrolled down
+      Q_PROPERTY(
+        qreal sideScroll
+        READ SideScroll
+        WRITE SetSideScroll
+        NOTIFY LayoutChanged
+      )
+
+      /// \brief Constructor
+      /// \param[in] _parent Parent item
+      public: explicit SplitLayout(QQuickItem *_parent = nullptr);
+
+      /// \brief Destructor
+      public: ~SplitLayout() override;
+
+      /// \brief Get the component creating the split items.
+      /// \return Component, null for plain items
+      public: QQmlComponent *Delegate() const;
+
+      /// \brief Set the component creating the split items.
+      /// \param[in] _delegate Component, null for plain items
+      public: void SetDelegate(QQmlComponent *_delegate);
+
+      /// \brief Notify that the delegate has changed
+      signals: void DelegateChanged();
+
+      /// \brief Add a split item, at the end of the column.
+      /// \return The item, named "split_item_<n>", to which a card can be
+      /// added.
+      public: QQuickItem *AddItem();
+
+      /// \brief Remove a split item. It's destroyed once it holds nothing.
+      /// \param[in] _item Item added with AddItem
+      /// \return False if it isn't an item of the layout
+      public: bool RemoveItem(QQuickItem *_item);
+
+      /// \brief Remove several split items.
+      /// \param[in] _items Items added with AddItem
+      /// \return False if any of them isn't an item of the layout
+      public: bool RemoveItems(const std::vector<QQuickItem *> &_items);
+
+      /// \brief Get the split items, in the order they're laid out.
+      /// \return Items, the first one being on the left
+      public: std::vector<QQuickItem *> Items() const;
+
+      /// \brief Get the split items keyed by their names.
+      /// \return Items
+      public: QVariantMap ChildItems() const;
+
+      /// \brief Notify that items were added or removed
+      signals: void ItemsChanged();
+
+      /// \brief Add a split item from QML.
+      /// \return Name of the item
+      /// \sa AddItem
+      public: Q_INVOKABLE QString addSplitItem();
+
+      /// \brief Remove a split item from QML.
+      /// \param[in] _name Name of the item
+      /// \sa RemoveItem
+      public: Q_INVOKABLE void removeSplitItem(const QString &_name);
+
+      /// \brief Remove several split items from QML.
+      /// \param[in] _names List of item names
+      /// \sa RemoveItems
+      public: Q_INVOKABLE void removeSplitItems(const QVariant &_names);
+
+      /// \brief Get the rectangle of the column on the right.
+      /// \return Rectangle, empty if there's only one item
+      public: QRectF SideRect() const;
+
+      /// \brief Get the height of all items of the column.
+      /// \return Height in pixels
+      public: qreal SideContentHeight() const;
+
+      /// \brief Get how far the column is scrolled down.
+      /// \return Pixels
+      public: qreal SideScroll() const;
+
+      /// \brief Scroll the column.
+      /// \param[in] _scroll Pixels from the top, clamped to the content
+      public: void SetSideScroll(qreal _scroll);
+
+      /// \brief Notify that items were moved or resized
+      signals: void LayoutChanged();
+
+      /// \brief Arrange the items now. It's otherwise done once before the
+      /// next frame after anything changed.
+      public: void UpdateLayout();
+
+      // Documentation inherited
+      protected: void updatePolish() override;
+
+      // Documentation inherited
+      protected: void geometryChanged(const QRectF &_newGeometry,
+          const QRectF &_oldGeometry) override;
+
+      // Documentation inherited
+      protected: void mousePressEvent(QMouseEvent *_event) override;
+
+      // Documentation inherited
+      protected: void mouseMoveEvent(QMouseEvent *_event) override;
+
+      // Documentation inherited
+      protected: void mouseReleaseEvent(QMouseEvent *_event) override;
+
+      // Documentation inherited
+      protected: void hoverMoveEvent(QHoverEvent *_event) override;
+
+      // Documentation inherited
+      protected: void wheelEvent(QWheelEvent *_event) override;
+
+      /// \brief Called when the minimum size of an item changes
+      private slots: void OnMinimumSizeChanged();
+
+      /// \internal
+      /// \brief Pointer to private data.
+      private: std::unique_ptr<SplitLayoutPrivate> dataPtr;
+    };
+  }
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif
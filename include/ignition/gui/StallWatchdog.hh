@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GUI_STALLWATCHDOG_HH_
+#define IGNITION_GUI_STALLWATCHDOG_HH_
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ignition/gui/Export.hh"
+
+#ifdef _WIN32
+// Disable warning C4251 which is triggered by
+// std::unique_ptr
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+
+class QEvent;
+class QObject;
+
+namespace ignition
+{
+  namespace gui
+  {
+    class StallWatchdogPrivate;
+
+    /// \brief What the GUI thread was doing while it didn't process events.
+    struct StallReport
+    {
+      /// \brief How long the event loop was stalled, in milliseconds
+      double duration{0.0};
+
+      /// \brief Class of the object handling an event, such as
+      /// "ignition::gui::plugins::ImageDisplay". Empty if the stall wasn't
+      /// in an event handler.
+      std::string handler;
+
+      /// \brief Type of the event, such as "MetaCall" for queued slots
+      /// and signals or "Timer".
+      std::string event;
+
+      /// \brief Title of the plugin the handler belongs to, empty if none.
+      std::string plugin;
+
+      /// \brief Stack of the GUI thread sampled during the stall, innermost
+      /// frame first. Only sampled on Linux.
+      std::vector<std::string> stack;
+
+      /// \brief Get a readable description of the stall.
+      /// \return Multi-line description
+      public: std::string String() const;
+    };
+
+    /// \brief Watches the GUI thread's event loop from another thread, and
+    /// reports when it stops processing events for longer than a
+    /// threshold: the handler which was running, its plugin and a sample of
+    /// the stack. Reports are logged as warnings, recorded in the Trace and
+    /// optionally published on a topic as msgs::StringMsg.
+    ///
+    /// The application enables it when the IGN_GUI_STALL_THRESHOLD
+    /// environment variable holds a threshold in milliseconds, publishing
+    /// on IGN_GUI_STALL_TOPIC if set. See Application::StartStallWatchdog.
+    class IGNITION_GUI_VISIBLE StallWatchdog
+    {
+      /// \brief Constructor. Must be called from the GUI thread, once a
+      /// QCoreApplication exists.
+      /// \param[in] _threshold Shortest stall reported
+      /// \param[in] _topic Topic to publish reports on, empty not to
+      /// publish
+      public: StallWatchdog(const std::chrono::milliseconds &_threshold,
+                            const std::string &_topic = "");
+
+      /// \brief Destructor, stops watching
+      public: ~StallWatchdog();
+
+      /// \brief Get the shortest stall reported.
+      /// \return Threshold
+      public: std::chrono::milliseconds Threshold() const;
+
+      /// \brief Set a function called on the GUI thread for each report,
+      /// once the stall is over.
+      /// \param[in] _callback Callback, null to remove it
+      public: void SetCallback(
+          std::function<void(const StallReport &)> _callback);
+
+      /// \brief Record that the GUI thread started handling an event.
+      /// Called by Application::notify.
+      /// \param[in] _receiver Object receiving the event
+      /// \param[in] _event Event
+      public: void Enter(const QObject *_receiver, const QEvent *_event);
+
+      /// \brief Record that the GUI thread finished handling the latest
+      /// event given to Enter.
+      public: void Leave();
+
+      /// \brief Get the number of stalls reported so far.
+      /// \return Number of stalls
+      public: unsigned int StallCount() const;
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<StallWatchdogPrivate> dataPtr;
+    };
+  }
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif
@@ -0,0 +1,268 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GUI_SUBSCRIPTIONHUB_HH_
+#define IGNITION_GUI_SUBSCRIPTIONHUB_HH_
+
+#include <google/protobuf/message.h>
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "ignition/gui/qt.h"
+#include "ignition/gui/Export.hh"
+
+#ifdef _WIN32
+// Disable warning C4251 which is triggered by
+// std::unique_ptr
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+
+namespace ignition
+{
+  namespace gui
+  {
+    class SubscriptionHubPrivate;
+
+    /// \brief Subscriptions to transport topics, shared by all plugins.
+    ///
+    /// The hub subscribes once to each topic, whatever the number of
+    /// plugins interested in it. Each message is received as raw bytes,
+    /// parsed once and handed to all of them through the same shared
+    /// pointer, so they can keep it without copying. Once the last of them
+    /// lets go of a message, the next one of the topic is parsed into it,
+    /// reusing its buffers.
+    ///
+    /// Callbacks are called on transport threads. Subscribers can come and
+    /// go at any time; as with transport::Node, a callback which is already
+    /// running may finish after Unsubscribe returns.
+    class IGNITION_GUI_VISIBLE SubscriptionHub : public QObject
+    {
+      Q_OBJECT
+
+      /// \brief Callback receiving the messages of a topic.
+      public: using Callback = std::function<void(
+          const std::shared_ptr<const google::protobuf::Message> &)>;
+
+      /// \brief Callback receiving the serialized messages of all topics.
+      /// Called with the topic name, the message type, the serialized
+      /// message and its size.
+      public: using TapCallback = std::function<void(const std::string &,
+          const std::string &, const char *, const std::size_t)>;
+
+      /// \brief Constructor. Use Instance instead.
+      private: SubscriptionHub();
+
+      /// \brief Destructor
+      public: ~SubscriptionHub() override;
+
+      /// \brief Get the hub, creating it on first use. It's owned by the
+      /// running application if there's one, and lives until the end of the
+      /// program otherwise.
+      /// \return Pointer to the hub, never null.
+      public: static SubscriptionHub *Instance();
+
+      /// \brief Receive the messages of a topic, whatever their type.
+      /// \param[in] _topic Topic name.
+      /// \param[in] _callback Called with each message.
+      /// \return ID to unsubscribe with, 0 if the topic can't be
+      /// subscribed to.
+      public: std::size_t Subscribe(const std::string &_topic,
+                                    const Callback &_callback);
+
+      /// \brief Receive the messages of a topic carrying one message type.
+      /// Messages of other types are skipped.
+      /// \param[in] _topic Topic name.
+      /// \param[in] _callback Called with each message.
+      /// \return ID to unsubscribe with, 0 if the topic can't be
+      /// subscribed to.
+      public: template<typename MessageT>
+              std::size_t Subscribe(const std::string &_topic,
+                  const std::function<void(
+                      const std::shared_ptr<const MessageT> &)> &_callback)
+      {
+        return this->Subscribe(_topic, Callback(
+            [_callback](
+                const std::shared_ptr<const google::protobuf::Message> &_msg)
+            {
+              auto msg = std::dynamic_pointer_cast<const MessageT>(_msg);
+              if (msg)
+                _callback(msg);
+            }));
+      }
+
+      /// \brief Receive the messages of a topic with a member function,
+      /// like transport::Node::Subscribe.
+      /// \param[in] _topic Topic name.
+      /// \param[in] _callback Member function called with each message.
+      /// \param[in] _obj Object the function is called on.
+      /// \return ID to unsubscribe with, 0 if the topic can't be
+      /// subscribed to.
+      public: template<typename ClassT, typename MessageT>
+              std::size_t Subscribe(const std::string &_topic,
+                  void (ClassT::*_callback)(const MessageT &), ClassT *_obj)
+      {
+        return this->Subscribe<MessageT>(_topic,
+            [_callback, _obj](const std::shared_ptr<const MessageT> &_msg)
+            {
+              (_obj->*_callback)(*_msg);
+            });
+      }
+
+      /// \brief Receive only the latest message of a topic, on the thread
+      /// the hub lives in, at most once per display frame. Messages
+      /// arriving in between replace the one waiting to be delivered, and
+      /// nothing is delivered when no message arrived. This suits plugins
+      /// which just display the latest state, such as statistics published
+      /// at a high rate. Must be called from the GUI thread.
+      /// \param[in] _topic Topic name.
+      /// \param[in] _callback Called with the latest message.
+      /// \return ID to unsubscribe with, 0 if the topic can't be
+      /// subscribed to.
+      public: std::size_t SubscribeLatest(const std::string &_topic,
+                                          const Callback &_callback);
+
+      /// \brief Receive only the latest message of a topic carrying one
+      /// message type, at most once per display frame.
+      /// \param[in] _topic Topic name.
+      /// \param[in] _callback Called with the latest message.
+      /// \return ID to unsubscribe with, 0 if the topic can't be
+      /// subscribed to.
+      /// \sa SubscribeLatest
+      public: template<typename MessageT>
+              std::size_t SubscribeLatest(const std::string &_topic,
+                  const std::function<void(
+                      const std::shared_ptr<const MessageT> &)> &_callback)
+      {
+        return this->SubscribeLatest(_topic, Callback(
+            [_callback](
+                const std::shared_ptr<const google::protobuf::Message> &_msg)
+            {
+              auto msg = std::dynamic_pointer_cast<const MessageT>(_msg);
+              if (msg)
+                _callback(msg);
+            }));
+      }
+
+      /// \brief Receive only the latest message of a topic with a member
+      /// function, at most once per display frame.
+      /// \param[in] _topic Topic name.
+      /// \param[in] _callback Member function called with the latest
+      /// message.
+      /// \param[in] _obj Object the function is called on.
+      /// \return ID to unsubscribe with, 0 if the topic can't be
+      /// subscribed to.
+      /// \sa SubscribeLatest
+      public: template<typename ClassT, typename MessageT>
+              std::size_t SubscribeLatest(const std::string &_topic,
+                  void (ClassT::*_callback)(const MessageT &), ClassT *_obj)
+      {
+        return this->SubscribeLatest<MessageT>(_topic,
+            [_callback, _obj](const std::shared_ptr<const MessageT> &_msg)
+            {
+              (_obj->*_callback)(*_msg);
+            });
+      }
+
+      /// \brief Stop receiving messages. The topic is unsubscribed from
+      /// when it has no subscribers left.
+      /// \param[in] _id ID returned by Subscribe, 0 is ignored.
+      public: void Unsubscribe(const std::size_t _id);
+
+      /// \brief Limit the rate a subscriber receives messages at. Messages
+      /// arriving sooner after the last one delivered to it are skipped,
+      /// and messages no subscriber of the topic is due for aren't even
+      /// parsed. Subscribers which only want the latest message are
+      /// limited on top of the display frame rate.
+      /// \param[in] _id ID returned by Subscribe or SubscribeLatest.
+      /// \param[in] _msgsPerSec Most messages per second, 0 for no limit.
+      /// \sa Plugin::MsgsPerSec
+      public: void SetMsgsPerSec(const std::size_t _id,
+                                 const double _msgsPerSec);
+
+      /// \brief Get the number of subscribers to a topic.
+      /// \param[in] _topic Topic name.
+      /// \return Number of subscribers, 0 if the hub isn't subscribed to
+      /// the topic.
+      public: std::size_t SubscriberCount(const std::string &_topic) const;
+
+      /// \brief Receive the serialized messages of every topic the hub is
+      /// subscribed to, before they're parsed, such as to record them.
+      /// Tapping doesn't subscribe to any topic by itself, and messages
+      /// given to Inject aren't tapped. Called on transport threads.
+      /// \param[in] _callback Called with each message.
+      /// \return ID to remove the tap with, 0 if the callback is empty.
+      public: std::size_t Tap(const TapCallback &_callback);
+
+      /// \brief Stop receiving the messages of a tap.
+      /// \param[in] _id ID returned by Tap, 0 is ignored.
+      public: void Untap(const std::size_t _id);
+
+      /// \brief Wait until callbacks removed by Unsubscribe and Untap
+      /// can't run anymore. Threads which took the callbacks before they
+      /// were removed may still be calling them when those return. Once
+      /// this returns, they're done and the callbacks are destroyed, such
+      /// as before unloading the library they come from. Don't call it
+      /// from a callback.
+      public: void WaitForDispatches();
+
+      /// \brief Hand a serialized message to the subscribers of a topic,
+      /// as if it came from transport, such as when replaying a log. Can be
+      /// called from any thread, callbacks are called on it.
+      /// \param[in] _topic Topic name.
+      /// \param[in] _type Message type, such as "ignition.msgs.Pose".
+      /// \param[in] _data Serialized message.
+      /// \param[in] _size Size of the data.
+      /// \return False if the topic has no subscribers or the message
+      /// can't be parsed.
+      public: bool Inject(const std::string &_topic, const std::string &_type,
+                          const char *_data, const std::size_t _size);
+
+      /// \brief Choose whether messages from transport reach subscribers.
+      /// While a log is replayed, live messages are dropped so plugins only
+      /// see the log. Subscriptions are kept either way.
+      /// \param[in] _live False to drop messages from transport.
+      public: void SetLive(const bool _live);
+
+      /// \brief Get whether messages from transport reach subscribers.
+      /// \return True unless SetLive(false) was called.
+      public: bool Live() const;
+
+      /// \brief Subscribe with either delivery.
+      /// \param[in] _topic Topic name.
+      /// \param[in] _callback Callback.
+      /// \param[in] _latest True to only deliver the latest message once
+      /// per frame.
+      /// \return ID to unsubscribe with, 0 on failure.
+      private: std::size_t AddSubscriber(const std::string &_topic,
+                                         const Callback &_callback,
+                                         bool _latest);
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<SubscriptionHubPrivate> dataPtr;
+    };
+  }
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif
@@ -0,0 +1,308 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GUI_TOPICLOG_HH_
+#define IGNITION_GUI_TOPICLOG_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ignition/gui/qt.h"
+#include "ignition/gui/Export.hh"
+
+#ifdef _WIN32
+// Disable warning C4251 which is triggered by
+// std::unique_ptr
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+
+namespace ignition
+{
+  namespace gui
+  {
+    class TopicLogPlayerPrivate;
+    class TopicLogReaderPrivate;
+    class TopicLogRecorderPrivate;
+    class TopicLogWriterPrivate;
+
+    /// \brief A message in a topic log
+    struct TopicLogRecord
+    {
+      /// \brief Time the message was received, in nanoseconds since the
+      /// epoch of the system clock
+      int64_t time{0};
+
+      /// \brief Topic name, owned by the reader
+      const std::string *topic{nullptr};
+
+      /// \brief Message type, owned by the reader
+      const std::string *type{nullptr};
+
+      /// \brief Serialized message, valid while the reader is open
+      const char *data{nullptr};
+
+      /// \brief Size of the data
+      std::size_t size{0};
+    };
+
+    /// \brief Writes serialized messages with their receive time to a log
+    /// file, for replaying later what the GUI received.
+    ///
+    /// Messages are gathered in chunks, each written as a whole once it's
+    /// full, so a log cut short by a crash loses at most the last chunk.
+    /// Closing the log appends an index of the chunks, which lets readers
+    /// seek without going through the whole file. Integers are stored in
+    /// the byte order of the host.
+    ///
+    /// Safe to write from several threads at once.
+    class IGNITION_GUI_VISIBLE TopicLogWriter
+    {
+      /// \brief Constructor
+      /// \param[in] _chunkSize Bytes of messages gathered before a chunk is
+      /// written
+      public: explicit TopicLogWriter(
+          const std::size_t _chunkSize = 1024 * 1024);
+
+      /// \brief Destructor. Closes the log.
+      public: ~TopicLogWriter();
+
+      /// \brief Create a log file, replacing any file at that path. Closes
+      /// the log which was open.
+      /// \param[in] _path Path of the file
+      /// \return False if the file can't be created
+      public: bool Open(const std::string &_path);
+
+      /// \brief Write the last chunk and the index, then close the file.
+      /// Does nothing if no log is open.
+      public: void Close();
+
+      /// \brief Get whether a log is open.
+      /// \return True between a successful Open and Close
+      public: bool IsOpen() const;
+
+      /// \brief Append a message.
+      /// \param[in] _time Receive time, in nanoseconds
+      /// \param[in] _topic Topic name
+      /// \param[in] _type Message type
+      /// \param[in] _data Serialized message
+      /// \param[in] _size Size of the data
+      /// \return False if no log is open or writing failed
+      public: bool Write(const int64_t _time, const std::string &_topic,
+                         const std::string &_type, const char *_data,
+                         const std::size_t _size);
+
+      /// \brief Get the number of messages written since the log was
+      /// opened.
+      /// \return Number of messages
+      public: uint64_t Count() const;
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<TopicLogWriterPrivate> dataPtr;
+    };
+
+    /// \brief Reads a log written by TopicLogWriter.
+    ///
+    /// The file is memory mapped where possible, so messages are read in
+    /// place without copying, and read into memory otherwise. Seeking
+    /// searches the chunk index, then goes through a single chunk. A log
+    /// whose index is missing, because the writer didn't close it, is
+    /// indexed again when opened.
+    ///
+    /// A reader is meant to be used from one thread.
+    class IGNITION_GUI_VISIBLE TopicLogReader
+    {
+      /// \brief Constructor
+      public: TopicLogReader();
+
+      /// \brief Destructor
+      public: ~TopicLogReader();
+
+      /// \brief Open a log, and move to its first message. Closes the log
+      /// which was open.
+      /// \param[in] _path Path of the file
+      /// \return False if the file can't be read or isn't a topic log
+      public: bool Open(const std::string &_path);
+
+      /// \brief Close the log. Records which were read become invalid.
+      public: void Close();
+
+      /// \brief Get whether a log is open.
+      /// \return True after a successful Open
+      public: bool IsOpen() const;
+
+      /// \brief Get the number of messages in the log.
+      /// \return Number of messages
+      public: uint64_t Count() const;
+
+      /// \brief Get the time of the first message.
+      /// \return Time in nanoseconds, 0 if the log is empty
+      public: int64_t StartTime() const;
+
+      /// \brief Get the time of the last message.
+      /// \return Time in nanoseconds, 0 if the log is empty
+      public: int64_t EndTime() const;
+
+      /// \brief Get the topics in the log.
+      /// \return Topic names, in the order they first appear
+      public: std::vector<std::string> Topics() const;
+
+      /// \brief Move to the first message received at or after a time.
+      /// \param[in] _time Time in nanoseconds
+      /// \return False if there's no message after that time, in which
+      /// case Next returns false too
+      public: bool Seek(const int64_t _time);
+
+      /// \brief Read the message at the current position and move past it.
+      /// \param[out] _record The message
+      /// \return False at the end of the log
+      public: bool Next(TopicLogRecord &_record);
+
+      /// \brief Get the time of the message Next would read, without
+      /// moving.
+      /// \param[out] _time Time in nanoseconds
+      /// \return False at the end of the log
+      public: bool PeekTime(int64_t &_time) const;
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<TopicLogReaderPrivate> dataPtr;
+    };
+
+    /// \brief Records what plugins receive from the subscription hub to a
+    /// topic log. Every topic plugins are subscribed to is recorded, while
+    /// they're subscribed to it, without subscribing to anything else.
+    class IGNITION_GUI_VISIBLE TopicLogRecorder
+    {
+      /// \brief Constructor
+      public: TopicLogRecorder();
+
+      /// \brief Destructor. Stops recording.
+      public: ~TopicLogRecorder();
+
+      /// \brief Start recording to a file, stopping any recording first.
+      /// \param[in] _path Path of the log
+      /// \return False if the log can't be created
+      public: bool Start(const std::string &_path);
+
+      /// \brief Stop recording and close the log.
+      public: void Stop();
+
+      /// \brief Get whether recording.
+      /// \return True between Start and Stop
+      public: bool Recording() const;
+
+      /// \brief Get the number of messages recorded since Start.
+      /// \return Number of messages
+      public: uint64_t Count() const;
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<TopicLogRecorderPrivate> dataPtr;
+    };
+
+    /// \brief Replays a topic log to plugins through the subscription hub,
+    /// as they received it. Messages from transport are dropped while
+    /// the log is open, so plugins only see the log.
+    ///
+    /// Must be used from the GUI thread, which messages are delivered on.
+    class IGNITION_GUI_VISIBLE TopicLogPlayer : public QObject
+    {
+      Q_OBJECT
+
+      /// \brief Constructor
+      public: TopicLogPlayer();
+
+      /// \brief Destructor. Closes the log, so messages from transport
+      /// reach plugins again.
+      public: ~TopicLogPlayer() override;
+
+      /// \brief Open a log, paused at its start.
+      /// \param[in] _path Path of the log
+      /// \return False if the log can't be read
+      public: bool Open(const std::string &_path);
+
+      /// \brief Close the log, so messages from transport reach plugins
+      /// again.
+      public: void Close();
+
+      /// \brief Get the reader of the open log, such as for its topics and
+      /// times.
+      /// \return The reader
+      public: const TopicLogReader &Reader() const;
+
+      /// \brief Deliver messages at the pace they were received, scaled by
+      /// the rate.
+      public: void Play();
+
+      /// \brief Stop delivering messages.
+      public: void Pause();
+
+      /// \brief Get whether playing.
+      /// \return True between Play and Pause or the end of the log
+      public: bool Playing() const;
+
+      /// \brief Deliver the next message right away, while paused.
+      /// \return False at the end of the log
+      public: bool Step();
+
+      /// \brief Move to a time. Nothing is delivered until playing or
+      /// stepping.
+      /// \param[in] _time Time in nanoseconds, between the start and end
+      /// times of the log
+      /// \return False if there's no message at or after that time
+      public: bool Seek(const int64_t _time);
+
+      /// \brief Set how fast the log is played.
+      /// \param[in] _rate 1 to play at the pace messages were received,
+      /// higher to play faster. Ignored unless positive.
+      public: void SetRate(const double _rate);
+
+      /// \brief Get how fast the log is played.
+      /// \return Rate, 1 by default
+      public: double Rate() const;
+
+      /// \brief Get the time of the log playback is at.
+      /// \return Time in nanoseconds of the last message delivered, or the
+      /// time sought to
+      public: int64_t Time() const;
+
+      /// \brief Notifies that messages were delivered.
+      /// \param[in] _time Time in nanoseconds of the last message delivered
+      signals: void TimeChanged(qint64 _time);
+
+      /// \brief Notifies that playing reached the end of the log.
+      signals: void Finished();
+
+      /// \brief Deliver the messages which are due.
+      private slots: void OnTimer();
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<TopicLogPlayerPrivate> dataPtr;
+    };
+  }
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GUI_TOPICREGISTRY_HH_
+#define IGNITION_GUI_TOPICREGISTRY_HH_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ignition/gui/qt.h"
+#include "ignition/gui/Export.hh"
+
+#ifdef _WIN32
+// Disable warning C4251 which is triggered by
+// std::unique_ptr
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+
+namespace ignition
+{
+  namespace gui
+  {
+    class TopicRegistryPrivate;
+
+    /// \brief Cache of the topics on the network and their message types,
+    /// shared by all plugins.
+    ///
+    /// The graph is walked once when the registry is first used, and then
+    /// kept up to date by a background thread which only asks for the
+    /// message type of topics it hasn't seen before. Queries never touch the
+    /// network, so they're cheap to call from the GUI thread.
+    ///
+    /// A topic's message type is the one of the first publisher found for it.
+    class IGNITION_GUI_VISIBLE TopicRegistry : public QObject
+    {
+      Q_OBJECT
+
+      /// \brief Constructor, walks the graph once. Use Instance instead.
+      private: TopicRegistry();
+
+      /// \brief Destructor
+      public: ~TopicRegistry() override;
+
+      /// \brief Get the registry, creating it on first use. It's owned by
+      /// the running application if there's one, and lives until the end of
+      /// the program otherwise. The first call should be made from the GUI
+      /// thread.
+      /// \return Pointer to the registry, never null.
+      public: static TopicRegistry *Instance();
+
+      /// \brief Get all known topics.
+      /// \return Map of topic names to message types.
+      public: std::map<std::string, std::string> Topics() const;
+
+      /// \brief Get the topics carrying a message type.
+      /// \param[in] _msgType Message type, such as "ignition.msgs.Image".
+      /// \return Topic names, sorted.
+      public: std::vector<std::string> Topics(
+          const std::string &_msgType) const;
+
+      /// \brief Get the message type of a topic.
+      /// \param[in] _topic Topic name.
+      /// \return Message type, or an empty string if the topic isn't known.
+      public: std::string MsgType(const std::string &_topic) const;
+
+      /// \brief Ask for the graph to be walked again now instead of waiting
+      /// for the next update. Returns right away.
+      public: void Refresh();
+
+      /// \brief Notify that topics were added or removed. Emitted from the
+      /// background thread, so connections to objects living on other
+      /// threads are queued.
+      signals: void TopicsChanged();
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<TopicRegistryPrivate> dataPtr;
+    };
+  }
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif
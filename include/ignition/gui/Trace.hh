@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GUI_TRACE_HH_
+#define IGNITION_GUI_TRACE_HH_
+
+#include <chrono>
+#include <string>
+
+#include "ignition/gui/Export.hh"
+
+#ifdef _WIN32
+// Disable warning C4251 which is triggered by
+// std::string
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+
+namespace ignition
+{
+  namespace gui
+  {
+    /// \brief Timeline of what the GUI spends its time on, such as loading
+    /// plugins, written in the Chrome trace event format. Open the file
+    /// with chrome://tracing or https://ui.perfetto.dev.
+    ///
+    /// Tracing is off unless the IGN_GUI_TRACE environment variable holds
+    /// the path of the file to write, or Start is called. Events can be
+    /// recorded from any thread.
+    class IGNITION_GUI_VISIBLE Trace
+    {
+      /// \brief Clock used for all events
+      public: using Clock = std::chrono::steady_clock;
+
+      /// \brief Start recording events.
+      /// \param[in] _path File the events are written to.
+      public: static void Start(const std::string &_path);
+
+      /// \brief Whether events are being recorded.
+      /// \return True if tracing is on.
+      public: static bool Enabled();
+
+      /// \brief Record something which took some time.
+      /// \param[in] _name Event name, such as "LoadLib [Publisher]".
+      /// \param[in] _category Category, such as "plugin".
+      /// \param[in] _start Time it started.
+      /// \param[in] _end Time it ended.
+      public: static void Complete(const std::string &_name,
+                                   const std::string &_category,
+                                   const Clock::time_point &_start,
+                                   const Clock::time_point &_end);
+
+      /// \brief Record something which happened now.
+      /// \param[in] _name Event name, such as "First frame".
+      /// \param[in] _category Category, such as "window".
+      public: static void Instant(const std::string &_name,
+                                  const std::string &_category);
+
+      /// \brief Write all events recorded so far to the file given to
+      /// Start.
+      /// \return True if written, false if tracing is off or the file
+      /// couldn't be written.
+      public: static bool Write();
+    };
+
+    /// \brief Records an event lasting from its construction to its
+    /// destruction. It does nothing when tracing is off.
+    class IGNITION_GUI_VISIBLE TraceScope
+    {
+      /// \brief Constructor
+      /// \param[in] _name Event name
+      /// \param[in] _category Event category
+      public: TraceScope(const std::string &_name,
+                         const std::string &_category);
+
+      /// \brief Destructor, records the event
+      public: ~TraceScope();
+
+      /// \brief Event name, empty when tracing is off
+      private: std::string name;
+
+      /// \brief Event category
+      private: std::string category;
+
+      /// \brief Time the event started
+      private: Trace::Clock::time_point start;
+    };
+  }
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif
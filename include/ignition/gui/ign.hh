@@ -27,6 +27,14 @@ extern "C" IGNITION_GUI_VISIBLE char *ignitionVersion();
 /// \brief External hook to execute 'ign gui -l' from the command line.
 extern "C" IGNITION_GUI_VISIBLE void cmdPluginList();
 
+/// \brief External hook to execute 'ign gui -i' from the command line.
+/// \param[in] _filename Name of a plugin file.
+extern "C" IGNITION_GUI_VISIBLE void cmdPluginInfo(const char *_filename);
+
+/// \brief External hook to execute 'ign gui --warm-cache' from the command
+/// line.
+extern "C" IGNITION_GUI_VISIBLE void cmdWarmCache();
+
 /// \brief External hook to execute 'ign gui -s' from the command line.
 /// \param[in] _filename Name of a plugin file.
 extern "C" IGNITION_GUI_VISIBLE void cmdStandalone(const char *_filename);
@@ -38,6 +46,11 @@ extern "C" IGNITION_GUI_VISIBLE void cmdConfig(const char *_config);
 /// \brief External hook to execute 'ign gui' from the command line.
 extern "C" IGNITION_GUI_VISIBLE void cmdEmptyWindow();
 
+/// \brief External hook when executing 'ign gui --trace' from the command
+/// line.
+/// \param[in] _path Path to the trace file to write.
+extern "C" IGNITION_GUI_VISIBLE void cmdTrace(const char *_path);
+
 /// \brief External hook when executing 'ign gui -t' from the command line.
 /// \param[in] _filename Path to a QSS file.
 extern "C" IGNITION_GUI_VISIBLE void cmdSetStyleFromFile(const char *_filename);
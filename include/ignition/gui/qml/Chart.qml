@@ -20,6 +20,7 @@ import QtQuick.Controls 2.2
 import QtQuick.Controls.Styles 1.4
 import QtQuick.Controls.Material 2.1
 import QtQuick.Layouts 1.3
+import PlotItem 1.0
 
 Rectangle {
   id: main
@@ -46,30 +47,67 @@ Rectangle {
     Id: chartID
   */
   signal clicked(real Id);
+  /**
+    the close button of the chart is clicked
+    Id: chartID
+  */
+  signal closed(real Id);
+  /**
+    the mouse moved over the plot area, so that all charts show their values
+    at that time
+    time: time under the mouse, NaN when the mouse left the chart
+  */
+  signal cursorMoved(real time);
 
   /**
-    Points Limitation: max points of each series
-    When points exceed that limit, some points from begining are deleted
+    Points Limitation: max points of each series kept at full resolution
+    When points exceed that limit, older points are only kept at lower
+    levels of detail, unless they're recorded to disk
   */
   property int maxPoints: 10000
   /**
     Chart ID
   */
   property int chartID: -1
+  /**
+    Duration of the hover animations in ms, 0 when the window is lightweight
+  */
+  property int hoverDuration: typeof MainWindow !== "undefined" &&
+      MainWindow.lightweight ? 0 : 100
   /**
     True if the chart is a small chart in the multi charts mode
   */
   property bool multiChartsMode: false
+  /**
+    Time range shared with other charts, null for a time axis of its own.
+    An object with min, max and started properties, a setRange(min, max)
+    function and a rangeChanged(min, max) signal
+  */
+  property var sharedTime: null
+  /**
+    True while the time axis is being set from the shared range, so that
+    it isn't shared back
+  */
+  property bool followingTime: false
+
+  onSharedTimeChanged: {
+    if (sharedTime && sharedTime.started)
+      followTime(sharedTime.min, sharedTime.max);
+  }
+
+  Connections {
+    target: main.sharedTime
+    ignoreUnknownSignals: true
+    onRangeChanged: main.followTime(min, max);
+  }
 
   /**
-    add point to a field graph
-    _fieldID field key or path
-    _x x coordinate of the point
-    _y y coordinate of the point
+    redraw a field graph from the points stored for it
+    _handle series handle of the field
   */
-  function appendPoint(_fieldID, _x, _y)
+  function updateSeries(_handle)
   {
-    chart.appendPoint(_fieldID, _x, _y);
+    chart.updateSeries(_handle);
   }
   /**
     set the chart opacity
@@ -118,14 +156,112 @@ Rectangle {
   }
 
   /**
-    fix OpenGL Disappear problem when the plugin is docked
+    get the time axis of the chart
+  */
+  function getTimeAxis()
+  {
+    return xAxis;
+  }
+
+  /**
+    True if points were drawn since the chart was created or cleared
+  */
+  function hasPoints()
+  {
+    return Object.keys(chart.drawn).length > 0;
+  }
+
+  /**
+    set the time axis to the shared range, spectrums keep their axes
+    _min start of the range
+    _max end of the range
+  */
+  function followTime(_min, _max)
+  {
+    if (chart.spectrumMode)
+      return;
+
+    followingTime = true;
+    // keep min below max on the way
+    if (_min > xAxis.max)
+    {
+      xAxis.max = _max;
+      xAxis.min = _min;
+    }
+    else
+    {
+      xAxis.min = _min;
+      xAxis.max = _max;
+    }
+    followingTime = false;
+  }
+
+  /**
+    show a time cursor with the values of all serieses at that time, each
+    one found by binary search over the points stored in C++
+    _time time of the cursor, NaN to hide it
   */
-  function fixOpenGL()
+  function showCursor(_time)
   {
-    lineSeries.useOpenGL = false;
-    lineSeries.useOpenGL = true;
+    if (isNaN(_time) || chart.spectrumMode || _time < xAxis.min ||
+        _time > xAxis.max)
+    {
+      cursorLine.visible = false;
+      cursorText.visible = false;
+      return;
+    }
+
+    cursorLine.x = chart.plotArea.x +
+        (_time - xAxis.min) / (xAxis.max - xAxis.min) * chart.plotArea.width;
+    cursorLine.visible = true;
+
+    // the hovered chart shows the hover text instead
+    cursorText.visible = !multiChartsMode && !hoverText.visible;
+    if (!cursorText.visible)
+      return;
+
+    var handles = Object.keys(chart.handles);
+    var values = PlottingIface.ValuesAt(handles, _time);
+    var text = "t " + _time.toFixed(2);
+    for (var i = 0; i < handles.length; i++)
+    {
+      if (values[i] === undefined)
+        continue;
+      var ID = chart.handles[handles[i]];
+      text += "\n" + chart.serieses[ID].name + " " + values[i].y.toFixed(3);
+    }
+    cursorText.text = text;
+    cursorText.x = (cursorLine.x + 6 + cursorText.width < chart.plotArea.x + chart.plotArea.width) ?
+                   cursorLine.x + 6 : cursorLine.x - 6 - cursorText.width;
   }
 
+  /**
+    remove all fields, components and expressions and put the chart back
+    the way it was created, so that it can be reused for another plot
+  */
+  function clear()
+  {
+    // removing a field takes it out of the row
+    var fields = [];
+    for (var i = 0; i < row.children.length; i++)
+      fields.push(row.children[i]);
+    for (var j = 0; j < fields.length; j++)
+      fields[j].remove();
+
+    hoverCheckBox.checked = false;
+    spectrumCheckBox.checked = false;
+    expressionField.clear();
+    guideText.visible = Qt.binding(function() {return !multiChartsMode});
+
+    showCursor(NaN);
+    chart.indexColor = 0;
+    chart.opacity = 1;
+    chart.drawn = {};
+    xAxis.min = 0;
+    xAxis.max = 3;
+    yAxis.min = 0;
+    yAxis.max = 3;
+  }
 
   color: "transparent"
 
@@ -216,6 +352,40 @@ Rectangle {
       field.path = path;
       field.type = "Field"
     }
+
+    /**
+      add a series derived from the fields and components of the chart
+      expression expression over the series, such as
+                 sqrt({/topic-x}^2 + {/topic-y}^2)
+      return: false if the expression isn't valid
+    */
+    function addExpression(expression)
+    {
+      // Derived Series ID
+      var ID = "=" + expression;
+      if (ID in chart.serieses)
+        return true;
+
+      if (!chart.addSeries(ID, expression, expression))
+        return false;
+
+      var field = fieldInfo.createObject(row);
+      field.width = 150;
+      field.height = Qt.binding( function() {return infoRect.height * 0.8} );
+      field.y = Qt.binding( function()
+        {
+          if (infoRect.height)
+            return (infoRect.height - field.height)/2;
+          else
+            return 0;
+        }
+      );
+
+      field.expression = expression;
+      field.type = "Expression";
+      guideText.visible = false;
+      return true;
+    }
     /**
       add component to the chart
       entity entity ID
@@ -278,6 +448,8 @@ Rectangle {
     // make it scrolable
     ScrollView {
       anchors.fill: parent
+      anchors.rightMargin: expressionField.visible ?
+                           expressionField.width + 20 : 0
       ScrollBar.horizontal.policy: ScrollBar.AsNeeded
       ScrollBar.vertical.policy: ScrollBar.AlwaysOff
       clip: true
@@ -297,6 +469,22 @@ Rectangle {
         infoRect.onDrop(text);
       }
     }
+
+    // series derived from the others, computed on the C++ side
+    TextField {
+      id: expressionField
+      width: 200
+      anchors.right: parent.right
+      anchors.rightMargin: 10
+      anchors.verticalCenter: parent.verticalCenter
+      visible: !multiChartsMode
+      selectByMouse: true
+      placeholderText: qsTr("= sqrt({/topic-x}^2 + {/topic-y}^2)")
+      onAccepted: {
+        if (text.length > 0 && infoRect.addExpression(text))
+          clear();
+      }
+    }
   }
 
   // ================ Field / Component ====================
@@ -333,12 +521,47 @@ Rectangle {
       property string componentId: entity + "," + typeId + "," + attribute;
       property string displayText: ""
 
+      /**
+        expression data:
+        expression expression of the derived series
+      */
+      property string expression: ""
+
       /**
         set the field name text
       */
       function setText(text) {
           fieldname.text = text;
       }
+      /**
+        unsubscribe and delete the series of the field / component /
+        expression, then delete its info component
+      */
+      function remove()
+      {
+        // unSubscribe from the transport / Component
+        if (component.type === "Field")
+          main.unSubscribe(main.chartID, component.topic, component.path);
+
+        else if (component.type === "Component")
+          main.componentUnSubscribe(component.entity, component.typeId,
+                                      component.attribute, main.chartID)
+
+
+        // delete the series points and deattache it from the chart
+        if (component.type === "Field")
+          chart.deleteSeries(component.topic + "-" + component.path)
+
+        else if (component.type === "Component")
+          chart.deleteSeries(component.componentId);
+
+        else if (component.type === "Expression")
+          chart.deleteSeries("=" + component.expression);
+
+        // delete the field info component, out of the row right away
+        component.parent = null;
+        component.destroy();
+      }
       signal unsubscribe(string topic, string path);
 
       radius: width/4
@@ -361,7 +584,8 @@ Rectangle {
           id: fieldname
           text: (component.type === "Field") ? component.topic + "/"+ component.path :
                 (component.type === "Component") ? component.entity + "," + component.typeName
-                                                   + "," + component.attribute : ""
+                                                   + "," + component.attribute :
+                (component.type === "Expression") ? "= " + component.expression : ""
           color: "white"
           elide: Text.ElideRight
           width: parent.width * 0.9
@@ -377,7 +601,8 @@ Rectangle {
                                                     "typeId: " + component.typeId + "\n" +
                                                     "typeName: " + component.typeName + "\n" +
                                                     "dataType: " + component.componentType + "\n" +
-                                                    "attribute: " + component.attribute : ""
+                                                    "attribute: " + component.attribute :
+                (component.type === "Expression") ? component.expression : ""
           visible: fieldInfoMouse.containsMouse
           y: fieldInfoMouse.mouseY
           x: fieldInfoMouse.mouseX
@@ -402,35 +627,17 @@ Rectangle {
           anchors.fill: parent
           onClicked: {
             exitAnimation.start();
-
-            // unSubscribe from the transport / Component
-            if (component.type === "Field")
-              main.unSubscribe(main.chartID, component.topic, component.path);
-
-            else if (component.type === "Component")
-              main.componentUnSubscribe(component.entity, component.typeId,
-                                          component.attribute, main.chartID)
-
-
-            // delete the series points and deattache it from the chart
-            if (component.type === "Field")
-              chart.deleteSeries(component.topic + "-" + component.path)
-
-            else if (component.type === "Component")
-              chart.deleteSeries(component.componentId);
-
-            // delete the field info component
-            component.destroy();
+            component.remove();
           }
         }
         NumberAnimation {
           id: enterAnimation
-          target: exitBtn; property: "opacity"; duration: 100
+          target: exitBtn; property: "opacity"; duration: main.hoverDuration
           easing.type: Easing.InOutQuad; from: 0; to: 1;
         }
         NumberAnimation {
           id: exitAnimation
-          target: exitBtn; property: "opacity"; duration: 100;
+          target: exitBtn; property: "opacity"; duration: main.hoverDuration;
           easing.type: Easing.InOutQuad; from: 0.85; to: 0;
         }
       }
@@ -444,6 +651,18 @@ Rectangle {
       all serieses, field path is the key, series is the value
     */
     property var serieses: ({})
+    /**
+      field paths of the serieses, series handle is the key
+    */
+    property var handles: ({})
+    /**
+      fields which were drawn since they were added, series handle is the key
+    */
+    property var drawn: ({})
+    /**
+      plot items drawing the serieses, field path is the key
+    */
+    property var plots: ({})
     /**
       colors to give the fields different colors
     */
@@ -454,6 +673,84 @@ Rectangle {
       current index of colors array
     */
     property int indexColor: 0
+    /**
+      true to show the amplitude spectrum of the serieses instead of their
+      points, computed on the C++ side
+    */
+    property bool spectrumMode: spectrumCheckBox.checked
+    /**
+      number of recent points the spectrum is computed from
+    */
+    property int spectrumSize: 1024
+    /**
+      spectrum refreshes per second
+    */
+    property double spectrumRate: 5
+
+    onSpectrumModeChanged: {
+      if (spectrumMode)
+      {
+        xAxis.min = 0;
+        xAxis.max = 1;
+        yAxis.min = 0;
+        yAxis.max = 0.001;
+      }
+      for (var handle in handles)
+        setSpectrum(parseInt(handle), spectrumMode);
+    }
+
+    /**
+      show the spectrum of a series instead of its points, or the other way
+      _handle series handle
+      _on true for the spectrum
+    */
+    function setSpectrum(_handle, _on)
+    {
+      var ID = handles[_handle];
+      if (_on)
+      {
+        PlottingIface.StartSpectrum(_handle, spectrumSize, spectrumRate);
+        plots[ID].visible = false;
+        return;
+      }
+
+      PlottingIface.StopSpectrum(_handle);
+      serieses[ID].clear();
+      plots[ID].visible = true;
+
+      // back to following the points
+      var bounds = PlottingIface.HandleBounds(_handle);
+      if (bounds === undefined)
+        return;
+      xAxis.min = bounds.x;
+      xAxis.max = bounds.x + Math.max(bounds.width, 10);
+      yAxis.min = Math.min(yAxis.min, bounds.y);
+      yAxis.max = Math.max(yAxis.max, bounds.y + bounds.height);
+    }
+
+    /**
+      draw the latest spectrum of a series and fit the axes to it
+      _handle series handle
+    */
+    function updateSpectrum(_handle)
+    {
+      if (!spectrumMode || handles[_handle] === undefined)
+        return;
+
+      var bounds = PlottingIface.UpdateSpectrum(_handle, serieses[handles[_handle]]);
+      if (bounds.width <= 0)
+        return;
+
+      if (xAxis.max < bounds.width)
+        xAxis.max = bounds.width;
+      if (yAxis.max < bounds.height)
+        yAxis.max = bounds.height;
+    }
+
+    Connections {
+      target: PlottingIface
+      onSpectrumChanged: chart.updateSpectrum(_handle);
+    }
 
     /**
       get sereieses
@@ -466,6 +763,9 @@ Rectangle {
 
     /**
       update the text that shows the hover point value (x,y) on the mouse cursor
+      it shows the drawn point closest to the cursor, or the cursor
+      coordinates if there's none, followed by the running statistics of
+      the series of the point
     */
     function updateHoverText()
     {
@@ -476,7 +776,49 @@ Rectangle {
       var axisHeight = yAxis.max - yAxis.min;
       var xPos = xAxis.min + ( (chartMouse.mouseX - chart.plotArea.x) / chart.plotArea.width ) * axisWidth;
       var yPos = yAxis.max - ( (chartMouse.mouseY - chart.plotArea.y) / chart.plotArea.height) * axisHeight;
+
+      // closest point in pixels among the points of each series closest in x
+      var best = undefined;
+      var bestID = undefined;
+      var bestDistance = Infinity;
+      for (var ID in chart.plots)
+      {
+        if (!chart.plots[ID].visible)
+          continue;
+
+        var point = chart.plots[ID].NearestPoint(xPos);
+        if (point === undefined)
+          continue;
+
+        var dx = (point.x - xPos) / axisWidth * chart.plotArea.width;
+        var dy = (point.y - yPos) / axisHeight * chart.plotArea.height;
+        var distance = dx * dx + dy * dy;
+        if (distance < bestDistance)
+        {
+          best = point;
+          bestID = ID;
+          bestDistance = distance;
+        }
+      }
+      if (best !== undefined)
+      {
+        xPos = best.x;
+        yPos = best.y;
+      }
+
       hoverText.text =  "(" + xPos.toFixed(2).toString() + ", " + yPos.toFixed(2).toString() + ")";
+
+      // statistics are kept as points are stored, so this is cheap
+      var stats = (bestID !== undefined) ?
+          PlottingIface.SeriesStatistics(PlottingIface.SeriesHandle(chartID, bestID)) : undefined;
+      if (stats !== undefined)
+      {
+        hoverText.text += "\nmean " + stats.mean.toFixed(3) + " \u00b1 " + stats.stdDev.toFixed(3) +
+                          "\nmin " + stats.min.toFixed(3) + "  max " + stats.max.toFixed(3) +
+                          "\np50 " + stats.p50.toFixed(3) + "  p95 " + stats.p95.toFixed(3) +
+                          "  p99 " + stats.p99.toFixed(3) +
+                          "\nn " + stats.count;
+      }
       hoverText.x = chartMouse.mouseX + 12;
       hoverText.y = chartMouse.mouseY;
     }
@@ -484,16 +826,39 @@ Rectangle {
     /**
       add new series
       ID key of the series: path of the field of the series
+      expression expression of a derived series, empty for the others
+      return: false if the expression isn't valid
     */
-    function addSeries(ID, seriesDisplayText) {
+    function addSeries(ID, seriesDisplayText, expression) {
+      // points are stored on the C++ side and drawn from there
+      if (expression)
+      {
+        if (!PlottingIface.AddDerivedSeries(chartID, ID, expression, maxPoints))
+          return false;
+      }
+      else
+      {
+        PlottingIface.AddSeries(chartID, ID, maxPoints);
+      }
+
       var seriesName = (seriesDisplayText) ? seriesDisplayText : ID
+      var color = chart.colors[chart.indexColor % chart.colors.length];
+
+      // the chart series stays empty, it only shows up in the legend
       var newSeries = createSeries(ChartView.SeriesTypeLine, seriesName, xAxis, yAxis);
-      newSeries.useOpenGL = true;
       newSeries.width = 2;
-      newSeries.color = chart.colors[chart.indexColor % chart.colors.length]
+      newSeries.color = color;
       serieses[ID] = newSeries;
 
+      handles[PlottingIface.SeriesHandle(chartID, ID)] = ID;
+      plots[ID] = plotComponent.createObject(chart, {
+          "chartId": chartID, "fieldId": ID, "color": color});
+
       chart.indexColor = (chart.indexColor + 1)  % chart.colors.length;
+
+      if (spectrumMode)
+        setSpectrum(PlottingIface.SeriesHandle(chartID, ID), true);
+      return true;
     }
 
     /**
@@ -501,56 +866,83 @@ Rectangle {
       ID field path
     */
     function deleteSeries(ID) {
-      // remove the points of the series from the chart
+      // remove the series from the legend
       removeSeries(serieses[ID]);
       // remove the series key from the serieses map
       delete serieses[ID];
+      var handle = PlottingIface.SeriesHandle(chartID, ID);
+      delete handles[handle];
+      delete drawn[handle];
+      if (plots[ID])
+        plots[ID].destroy();
+      delete plots[ID];
+      PlottingIface.RemoveSeries(chartID, ID);
     }
 
     /**
-      add point to a specific TextField
-      _fieldID field ID or Path
-      _x x of the point
-      _y y of the point
+      follow the stored points of a field series with the axes, the plot
+      items redraw themselves
+      _handle series handle of the field
     */
-    function appendPoint(_fieldID, _x, _y)
+    function updateSeries(_handle)
     {
-      if (!chart.serieses[_fieldID])
+      if (chart.handles[_handle] === undefined || chart.spectrumMode)
+        return;
+
+      var bounds = PlottingIface.HandleBounds(_handle);
+      if (bounds === undefined)
         return;
 
-      // if this is the first point (if the chart is empty):
-      // set the min/max according to that point's coordinates
+      // if these are the first points (if the chart is empty):
+      // set the min/max according to the first point's coordinates
       // note: count == 2: because chart has 1 series by default to show plotting grid
-      if (chart.count === 2 && chart.serieses[_fieldID].count === 0)
+      var first = (chart.count === 2 && !chart.drawn[_handle]);
+      chart.drawn[_handle] = true;
+
+      // charts sharing the time axis follow the one which got points first
+      if (first && (!main.sharedTime || !main.sharedTime.started))
       {
-        xAxis.min = _x;
-        xAxis.max = _x + 10;
-        chart.serieses[_fieldID].append(_x, _y);
-        return;
+        xAxis.min = bounds.x;
+        xAxis.max = bounds.x + 10;
+        if (main.sharedTime)
+          main.sharedTime.started = true;
       }
 
       // expand the chart boundries if needed
-      if (xAxis.max  < _x)
+      var maxX = bounds.x + bounds.width;
+      var maxY = bounds.y + bounds.height;
+      if (xAxis.max < maxX)
       {
-        xAxis.max = _x;
+        xAxis.max = maxX;
         chart.scrollRight(chart.width * 0.0012);
       }
 
-      if (yAxis.max  < _y)
-        yAxis.max = _y ;
-      if (yAxis.min > _y)
-        yAxis.min = _y ;
-      if (xAxis.min > _x)
-        xAxis.min = _x ;
-
-      // add the point
-      chart.serieses[_fieldID].append(_x, _y);
-
-      // delete the oldest point to limit the points size
-      if (chart.serieses[_fieldID].count > maxPoints)
-          chart.serieses[_fieldID].removePoints(0,1)
+      if (yAxis.max < maxY)
+        yAxis.max = maxY;
+      if (yAxis.min > bounds.y)
+        yAxis.min = bounds.y;
+      if (xAxis.min > bounds.x)
+        xAxis.min = bounds.x;
+    }
 
-      chart.updateHoverText();
+    /**
+      line of a field series, drawn over the plot area straight from the
+      points stored in C++
+    */
+    Component {
+      id: plotComponent
+      PlotItem {
+        x: chart.plotArea.x
+        y: chart.plotArea.y
+        width: chart.plotArea.width
+        height: chart.plotArea.height
+        minX: xAxis.min
+        maxX: xAxis.max
+        minY: yAxis.min
+        maxY: yAxis.max
+        lineWidth: 2
+        plotting: PlottingIface
+      }
     }
 
     width: parent.width
@@ -565,6 +957,23 @@ Rectangle {
 
     theme: (Material.theme == Material.Light) ? ChartView.ChartThemeLight: ChartView.ChartThemeDark
 
+    // time cursor, drawn in all charts at the time hovered in any of them
+    Rectangle {
+      id: cursorLine
+      visible: false
+      y: chart.plotArea.y
+      width: 1
+      height: chart.plotArea.height
+      color: Material.color(Material.Grey, Material.Shade500)
+    }
+
+    Text {
+      id: cursorText
+      visible: false
+      y: chart.plotArea.y + 6
+      color: (Material.theme == Material.Light) ? "black" : Material.color(Material.Grey,Material.Shade200)
+    }
+
     Text {
       id:hoverText
       visible: (chartMouse.flag && !multiChartsMode && chartMouse.containsMouse) ? true : false
@@ -598,6 +1007,7 @@ Rectangle {
       onExited: {
         if (multiChartsMode)
           chart.opacity = 1;
+        main.cursorMoved(NaN);
       }
       onPressed: {
         xHold = mouseX;
@@ -620,8 +1030,14 @@ Rectangle {
           yHold = mouseY
         }
         else
+        {
           chart.updateHoverText();
 
+          var inside = mouseX >= chart.plotArea.x &&
+                       mouseX <= chart.plotArea.x + chart.plotArea.width;
+          main.cursorMoved(inside ? xAxis.min + (mouseX - chart.plotArea.x) /
+              chart.plotArea.width * (xAxis.max - xAxis.min) : NaN);
+        }
       }
 
       onClicked: {
@@ -696,6 +1112,12 @@ Rectangle {
       min: 0
       max: 3
       tickCount: 9
+
+      // scrolling, zooming and new points move the shared time range too
+      onRangeChanged: {
+        if (main.sharedTime && !main.followingTime && !chart.spectrumMode)
+          main.sharedTime.setRange(min, max);
+      }
     }
 
     // to just show the plot at begining
@@ -704,7 +1126,6 @@ Rectangle {
       axisX: xAxis
       axisY: yAxis
       visible: false
-      useOpenGL: true
     }
 
     Text {
@@ -737,4 +1158,41 @@ Rectangle {
     anchors.margins: 20
     text: "hover"
   }
+
+  CheckBox {
+    id: spectrumCheckBox;
+    visible: (main.multiChartsMode) ? false : true
+    checkState: Qt.Unchecked
+    anchors.right: hoverCheckBox.left
+    anchors.top: chart.top
+    anchors.topMargin: 20
+    text: "spectrum"
+  }
+
+  Rectangle {
+    id: closeBtn
+    visible: (main.multiChartsMode) ? false : true
+    anchors.right: spectrumCheckBox.left
+    anchors.verticalCenter: spectrumCheckBox.verticalCenter
+    anchors.rightMargin: 10
+    width: 24
+    height: 24
+    radius: width/2
+    color: Material.color(Material.Grey, Material.Shade500)
+    opacity: (mouseCloseBtn.containsMouse) ? 0.8 : 1
+    Text { anchors.centerIn: parent; text: "x"; color: "white"}
+
+    MouseArea {
+      id: mouseCloseBtn
+      anchors.fill: parent
+      hoverEnabled: true
+      cursorShape: Qt.PointingHandCursor
+      onClicked: main.closed(main.chartID);
+    }
+
+    ToolTip.text: "Close"
+    ToolTip.delay: 500
+    ToolTip.timeout: 1000
+    ToolTip.visible: mouseCloseBtn.containsMouse
+  }
 }
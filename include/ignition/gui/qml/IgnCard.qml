@@ -143,6 +143,30 @@ Pane {
     (Material.theme === Material.Light) ?
     MainWindow.pluginToolBarTextColorLight : MainWindow.pluginToolBarTextColorDark
 
+  /**
+   * True to draw the card without animations and shadows, for windows with
+   * many cards or software rendering
+   */
+  property bool lightweight: typeof MainWindow !== "undefined" &&
+      MainWindow.lightweight
+
+  /**
+   * Duration of the collapse and expand animations, in ms
+   */
+  property int animationDuration: lightweight ? 0 : 200
+
+  /**
+   * True to keep the card in a texture while lightweight, so it isn't
+   * drawn again until it changes. Meant for cards which seldom change,
+   * it isn't supported by the software renderer.
+   */
+  property bool cacheAsLayer: false
+
+  /**
+   * Settings dialog, created when first shown
+   */
+  property var settingsDialog: null
+
   /**
    * Close signal
    */
@@ -240,6 +264,8 @@ Pane {
 
   padding: 0
 
+  layer.enabled: lightweight && cacheAsLayer
+
   state: "docked"
 
   states: [
@@ -294,7 +320,7 @@ Pane {
       NumberAnimation {
         target: cardPane
         property: "height"
-        duration: 200
+        duration: animationDuration
         easing.type: Easing.OutCubic
         from: cardPane.height
         to: 50
@@ -306,7 +332,7 @@ Pane {
       NumberAnimation {
         target: cardPane
         property: "height"
-        duration: 200
+        duration: animationDuration
         easing.type: Easing.InCubic
         from: 50
         to: lastHeight
@@ -326,7 +352,7 @@ Pane {
       NumberAnimation {
         target: cardPane
         property: "parent.Layout.minimumHeight"
-        duration: 200
+        duration: animationDuration
         easing.type: Easing.OutCubic
         from: cardPane.height
         to: 50
@@ -338,7 +364,7 @@ Pane {
       NumberAnimation {
         target: cardPane
         property: "parent.Layout.minimumHeight"
-        duration: 200
+        duration: animationDuration
         easing.type: Easing.InCubic
         from: 50
         to: content.children[0] === undefined ? 50 : content.children[0].Layout.minimumHeight
@@ -361,7 +387,7 @@ Pane {
         NumberAnimation {
           target: cardPane
           property: "height"
-          duration: 200
+          duration: animationDuration
           easing.type: Easing.OutCubic
           from: cardPane.height
           to: 50
@@ -470,6 +496,7 @@ Pane {
     visible: cardPane.showTitleBar
     Material.foreground: Material.foreground
     Material.background: pluginToolBarColor
+    Material.elevation: cardPane.lightweight ? 0 : 4
     width: cardPane.width
     height: cardPane.showTitleBar ? 50 : 0
     x: 0
@@ -615,22 +642,28 @@ Pane {
     anchors.fill: content
     acceptedButtons: Qt.RightButton
     onClicked: {
+      var contextMenu = contextMenuComponent.createObject(cardPane)
       contextMenu.x = mouseX
       contextMenu.y = mouseY
       contextMenu.open()
     }
   }
 
-  Menu {
-    id: contextMenu
-    transformOrigin: Menu.TopRight
-    MenuItem {
-      text: "Settings"
-      onTriggered: cardPane.showSettingsDialog();
-    }
-    MenuItem {
-      text: "Close"
-      onTriggered: cardPane.close();
+  // Popups are only created when needed, so cards which never show them
+  // don't carry their items
+  Component {
+    id: contextMenuComponent
+    Menu {
+      transformOrigin: Menu.TopRight
+      onClosed: destroy()
+      MenuItem {
+        text: "Settings"
+        onTriggered: cardPane.showSettingsDialog();
+      }
+      MenuItem {
+        text: "Close"
+        onTriggered: cardPane.close();
+      }
     }
   }
 
@@ -638,17 +671,21 @@ Pane {
    * Show settings dialog
    */
   function showSettingsDialog() {
+    if (!settingsDialog)
+      settingsDialog = settingsComponent.createObject(cardPane)
     settingsDialog.open()
   }
 
-  IgnCardSettings {
-    id: settingsDialog
-    modal: false
-    focus: true
-    title: pluginName + " settings"
-    parent: cardPane.parent
-    x: parent ? (parent.width - width) / 2 : 0
-    y: parent ? (parent.height - height) / 2 : 0
+  Component {
+    id: settingsComponent
+    IgnCardSettings {
+      modal: false
+      focus: true
+      title: pluginName + " settings"
+      parent: cardPane.parent
+      x: parent ? (parent.width - width) / 2 : 0
+      y: parent ? (parent.height - height) / 2 : 0
+    }
   }
 
   /**
@@ -682,10 +719,13 @@ Pane {
     }
   }
 
-  IgnRulers {
+  // Only floating cards can be resized
+  Loader {
     anchors.fill: parent
-    enabled: cardPane.state === "floating" && resizable
-    minSize: cardPane.minSize
-    target: cardPane
+    active: cardPane.state === "floating" && resizable
+    sourceComponent: IgnRulers {
+      minSize: cardPane.minSize
+      target: cardPane
+    }
   }
 }
@@ -52,19 +52,109 @@ Rectangle
   property var window: null
 
   /**
-  add new chart to the view
+  True if all charts share one time axis: scrolling, zooming or plotting
+  new points in a chart moves the time range of the others
+  */
+  property bool sharedTimeAxis: false
+
+  /**
+  number of charts built ahead of time, in the background, so that adding
+  a chart doesn't wait for a ChartView to be created
+  */
+  property int warmCharts: 2
+
+  /**
+  chart component, loaded once for all charts
+  */
+  property Component chartComponent: Qt.createComponent("Chart.qml")
+
+  /**
+  closed or prebuilt charts, cleared and hidden, waiting to be reused
+  */
+  property var pool: []
+
+  /**
+  number of charts being built for the pool
+  */
+  property int incubating: 0
+
+  onSharedTimeAxisChanged: {
+    if (sharedTimeAxis && charts[mainChartID])
+    {
+      // the others follow the main chart
+      var axis = charts[mainChartID].getTimeAxis();
+      sharedTime.started = charts[mainChartID].hasPoints();
+      sharedTime.setRange(axis.min, axis.max);
+    }
+
+    for (var key in charts)
+      charts[key].sharedTime = sharedTimeAxis ? sharedTime : null;
+  }
+
+  /**
+  create a chart and connect it, it's parented to the pool until it's shown
+  */
+  function createChart()
+  {
+    return connectChart(chartComponent.createObject(chartPool));
+  }
+
+  /**
+  build a chart while the view is idle and put it in the pool
+  */
+  function incubateChart()
+  {
+    var incubator = chartComponent.incubateObject(chartPool);
+    if (incubator.status === Component.Ready)
+    {
+      pool.push(connectChart(incubator.object));
+      return;
+    }
+
+    incubating++;
+    incubator.onStatusChanged = function(status) {
+      if (status === Component.Loading)
+        return;
+      incubating--;
+      if (status === Component.Ready)
+        pool.push(connectChart(incubator.object));
+    }
+  }
+
+  /**
+  connect the signals of a new chart, once for all the times it's reused
+  _chart chart object
+  return: the chart
+  */
+  function connectChart(_chart)
+  {
+    _chart.subscribe.connect(main.onSubscribe);
+    _chart.unSubscribe.connect(main.onUnSubscribe);
+    _chart.componentSubscribe.connect(main.onComponentSubscribe);
+    _chart.componentUnSubscribe.connect(main.onComponentUnSubscribe);
+    _chart.clicked.connect(main.onClicked);
+    _chart.closed.connect(main.onClosed);
+    _chart.cursorMoved.connect(main.onCursorMoved);
+    return _chart;
+  }
+
+  /**
+  add new chart to the view, reusing a pooled one if there's any
   */
   function addChart()
   {
     main.idIncrementor++;
 
-    var chartComponent = Qt.createComponent("Chart.qml");
-    var chartObject;
+    var chartObject = (pool.length > 0) ? pool.pop() : createChart();
+    // top the pool up in the background
+    for (var i = pool.length + incubating; i < warmCharts; i++)
+      incubateChart();
+
     // if the mode is many charts that are organized in horizontal layout
     if (multiChartsMode)
     {
       // add it to the horizontal layout
-      chartObject = chartComponent.createObject(rowChartsLayout);
+      chartObject.parent = rowChartsLayout;
       chartObject.width = 200;
       chartObject.height = Qt.binding( function() {return rowCharts.height * 0.9} );
       chartObject.y = Qt.binding( function() {return (rowCharts.height - chartObject.height)/2} );
@@ -74,9 +164,7 @@ Rectangle
     else
     {
       // if normal mode, add the chart to the normal vertical layout
-      chartObject = chartComponent.createObject(chartsLayout);
-      chartObject.height = Qt.binding( function() {return chartsLayout.height / chartsLayout.heightFactor});
-      chartObject.width = Qt.binding( function() {return chartsLayout.width});
+      moveToMainLayout(chartObject);
       // to change the height of each vertical chart
       chartsLayout.heightFactor ++ ;
     }
@@ -84,12 +172,75 @@ Rectangle
     // Chart ID
     chartObject.chartID = main.idIncrementor;
     charts[idIncrementor] = chartObject;
-    // Signals and Slots
-    chartObject.subscribe.connect(main.onSubscribe);
-    chartObject.unSubscribe.connect(main.onUnSubscribe);
-    chartObject.componentSubscribe.connect(main.onComponentSubscribe);
-    chartObject.componentUnSubscribe.connect(main.onComponentUnSubscribe);
-    chartObject.clicked.connect(main.onClicked);
+    chartObject.sharedTime = sharedTimeAxis ? sharedTime : null;
+  }
+
+  /**
+  move a chart to the vertical layout of the main charts
+  _chart chart object
+  */
+  function moveToMainLayout(_chart)
+  {
+    _chart.parent = chartsLayout;
+    _chart.y = 0;
+    _chart.height = Qt.binding( function() {return chartsLayout.height / chartsLayout.heightFactor});
+    _chart.width = Qt.binding( function() {return chartsLayout.width});
+    _chart.multiChartsMode = false;
+    _chart.fillPlotInOrOut();
+    _chart.setChartOpacity(1);
+  }
+
+  /**
+  on chart closed:
+  clear the chart and put it in the pool, the last chart is only cleared
+  Id: id of the closed chart
+  */
+  function onClosed(Id)
+  {
+    var chart = charts[Id];
+    if (!chart)
+      return;
+
+    chart.sharedTime = null;
+    chart.clear();
+    if (Object.keys(charts).length === 1)
+    {
+      chart.sharedTime = sharedTimeAxis ? sharedTime : null;
+      return;
+    }
+
+    delete charts[Id];
+    chart.parent = chartPool;
+    pool.push(chart);
+
+    // a small chart takes the place of the closed main chart
+    if (Id === mainChartID)
+    {
+      if (multiChartsMode)
+      {
+        moveToMainLayout(rowChartsLayout.children[0]);
+      }
+      else
+      {
+        chartsLayout.heightFactor--;
+      }
+      mainChartID = chartsLayout.children[0].chartID;
+    }
+    else if (!multiChartsMode)
+    {
+      chartsLayout.heightFactor--;
+    }
+
+    // back to the vertical layout for 2 charts
+    if (multiChartsMode && Object.keys(charts).length <= 2)
+    {
+      multiChartsMode = false;
+      while (rowChartsLayout.children.length > 0)
+      {
+        moveToMainLayout(rowChartsLayout.children[0]);
+        chartsLayout.heightFactor++;
+      }
+    }
   }
 
   /**
@@ -149,44 +300,81 @@ Rectangle
       charts[mainChartID].parent = rowChartsLayout;
 
       // ======= swapped chart =======
-      charts[Id].parent = chartsLayout;
+      moveToMainLayout(charts[Id]);
       charts[Id].x = charts[mainChartID].x;
-      charts[Id].y = 0;
-      charts[Id].height = Qt.binding( function() {return chartsLayout.height / chartsLayout.heightFactor});
-      charts[Id].width = Qt.binding( function() {return chartsLayout.width});
-      charts[Id].multiChartsMode = false;
-      charts[Id].fillPlotInOrOut();
-      charts[Id].setChartOpacity(1);
 
       mainChartID = Id;
     }
   }
 
   /**
-    fix the OpenGL disappear problem when the plugin is docked
+  on chart cursorMoved:
+  show the time cursor in all charts, with the values at that time
+  _time: hovered time, NaN to hide the cursor
   */
-  function fixOpenGL()
+  function onCursorMoved(_time)
   {
-    Object.keys(main.charts).forEach(function(key) {
-      main.charts[key].fixOpenGL();
-    });
+    for (var key in charts)
+      charts[key].showCursor(_time);
   }
 
   /**
-  plot point to a chart
+  redraw a chart series which got new points
   _chart: chart id
-  _fieldID: field path or id
-  _x: x coordinates of the point
-  _y: y coordinates of the point
+  _handle: series handle
   */
-  function handlePlot(_chart, _fieldID, _x, _y)
+  function handleSeriesChanged(_chart, _handle)
   {
-    charts[_chart].appendPoint(_fieldID, _x, _y);
+    if (charts[_chart])
+      charts[_chart].updateSeries(_handle);
   }
 
   Connections {
     target: PlottingIface
-    onPlot : handlePlot(_chart, _fieldID, _x, _y);
+    onSeriesHandleChanged : handleSeriesChanged(_chart, _handle);
+  }
+
+  /**
+  time range of the charts while sharedTimeAxis is on
+  */
+  QtObject {
+    id: sharedTime
+
+    /**
+    start of the range
+    */
+    property real min: 0
+    /**
+    end of the range
+    */
+    property real max: 3
+    /**
+    True once a chart got points, the others then follow it
+    */
+    property bool started: false
+
+    /**
+    the range changed
+    */
+    signal rangeChanged(real min, real max);
+
+    /**
+    set the range and tell the charts
+    */
+    function setRange(_min, _max)
+    {
+      if (_min === min && _max === max)
+        return;
+      min = _min;
+      max = _max;
+      rangeChanged(_min, _max);
+    }
+  }
+
+  // Parent of the pooled charts
+  Item {
+    id: chartPool
+    visible: false
   }
 
 
@@ -195,11 +383,6 @@ Rectangle
   anchors.fill: parent
   color: (Material.theme == Material.Light) ? Material.color(Material.Grey,Material.Shade100) : Material.background
 
-  // when the chart is docked fix the OpenGL Disappear problem
-  onWidthChanged: {
-    main.fixOpenGL();
-  }
-
   // Horizonal Layout to hold multi charts (small charts)
   Rectangle {
     id: rowCharts
@@ -240,7 +423,7 @@ Rectangle
   Rectangle {
     id : addBtn
 
-    anchors.right: openExport.left
+    anchors.right: sharedTimeBtn.left
     anchors.top: parent.top
     anchors.margins: 15
 
@@ -297,6 +480,107 @@ Rectangle
     addChart();
   }
 
+  Rectangle {
+    id: sharedTimeBtn
+
+    anchors.right: recordBtn.left
+    anchors.top: parent.top
+    anchors.margins: 15
+
+    width: 40
+    height: 40
+    radius: width/2
+    color: (main.sharedTimeAxis) ? Material.accentColor : "transparent"
+    border.width: 1
+    border.color: Material.color(Material.Grey, Material.Shade500)
+    Text {
+      text: "\u2194"
+      font.weight: Font.Bold
+      font.pixelSize: parent.width/2
+      color: (main.sharedTimeAxis) ? "white" : Material.color(Material.Grey, Material.Shade500)
+      anchors.centerIn: parent
+    }
+
+    MouseArea {
+      id: mouseSharedTimeBtn
+      anchors.fill: parent
+      hoverEnabled: true
+      onEntered: { sharedTimeBtn.opacity = 0.8; cursorShape = Qt.PointingHandCursor; }
+      onExited: { sharedTimeBtn.opacity = 1; cursorShape =  Qt.ArrowCursor; }
+      onClicked: main.sharedTimeAxis = !main.sharedTimeAxis;
+    }
+
+    ToolTip.text: main.sharedTimeAxis ? "Separate time axes" : "Share the time axis"
+    ToolTip.delay: 500
+    ToolTip.timeout: 1000
+    ToolTip.visible: mouseSharedTimeBtn.containsMouse
+  }
+
+  /**
+    record all plotted fields to disk, so long histories can be scrolled back
+    at full resolution
+  */
+  Rectangle {
+    id: recordBtn
+
+    /**
+    True while recording
+    */
+    property bool recording: PlottingIface.Recording()
+
+    anchors.right: openExport.left
+    anchors.top: parent.top
+    anchors.margins: 15
+
+    width: 40
+    height: 40
+    radius: width/2
+    color: "transparent"
+    border.width: 1
+    border.color: Material.color(Material.Grey, Material.Shade500)
+
+    Rectangle {
+      anchors.centerIn: parent
+      width: parent.width * 0.4
+      height: width
+      radius: recordBtn.recording ? 0 : width/2
+      color: Material.color(Material.Red)
+    }
+
+    Connections {
+      target: PlottingIface
+      onRecordingChanged: recordBtn.recording = PlottingIface.Recording();
+    }
+
+    MouseArea {
+      id: mouseRecordBtn
+      anchors.fill: parent
+      hoverEnabled: true
+      onEntered: { recordBtn.opacity = 0.8; cursorShape = Qt.PointingHandCursor; }
+      onExited: { recordBtn.opacity = 1; cursorShape =  Qt.ArrowCursor; }
+
+      onClicked: {
+        if (recordBtn.recording)
+          PlottingIface.StopRecording();
+        else
+          recordDialog.open();
+      }
+    }
+
+    FolderDialog {
+      id: recordDialog
+      title: "Choose a folder to record to"
+      visible: false
+      options: FolderDialog.ShowDirsOnly
+      onAccepted: PlottingIface.StartRecording(folder);
+    }
+
+    ToolTip.text: recording ? "Stop recording" : "Record to disk"
+    ToolTip.delay: 500
+    ToolTip.timeout: 1000
+    ToolTip.visible: mouseRecordBtn.containsMouse
+  }
+
   ToolButton {
     id: openExport
     width: 40;
@@ -415,42 +699,42 @@ Rectangle
 
       /**
       export all selected charts in the export window to that path
+      the files are written in the background
+      _format: "csv" or "bin"
+      return: True if the export was started
       */
-      function exportCSV(path)
-      {
-      for (var i = 0; i < chartImages.length; i++)
+      function exportSeries(path, _format)
       {
-        if (!chartImages[i].isSelected())
-          continue;
-
-        var chart = charts[chartImages[i].chartIndex];
-        var serieses = chart.getChart().getAllSerieses();
-        var chart_id = chart.chartID;
-
-        if (Object.keys(serieses).length === 0)
-          continue;
-
-
-        // convert Serieses to Map of {series_name : points list}
-        // slots in cpp accepts QMap<QString, QVariant>
-        // QVariant could be a list instead of series object
+        var chartIDs = [];
+        for (var i = 0; i < chartImages.length; i++)
+        {
+          if (!chartImages[i].isSelected())
+            continue;
 
-        var chartSerieses = {};
-        var seriesArray = [];
-        Object.keys(serieses).forEach(function(key) {
+          var chart = charts[chartImages[i].chartIndex];
+          var serieses = chart.getChart().getAllSerieses();
 
-          seriesArray = []
+          if (Object.keys(serieses).length === 0)
+            continue;
 
-          // convert Series to QList<QPointF>
-          for (var j =0; j < serieses[key].count; j++)
-            seriesArray.push(serieses[key].at(j));
+          chartIDs.push(chart.chartID);
+        }
 
-          // add series
-          chartSerieses[key] = seriesArray;
-        });
+        if (chartIDs.length === 0)
+          return false;
 
-        return PlottingIface.exportCSV(path, chart_id, chartSerieses);
+        // the points are read from the series store
+        return PlottingIface.ExportSeries(path, chartIDs, _format);
       }
+
+      Connections {
+        target: PlottingIface
+        onExportProgress: exportProgress.value = _progress;
+        onExportFinished: {
+          exportProgress.visible = false;
+          if (_success)
+            exportApp.close();
+        }
       }
 
       /**
@@ -500,7 +784,7 @@ Rectangle
           property string color: Material.primaryColor
 
           displayText: "Export to"
-          model: ["CSV"]
+          model: ["CSV", "Binary"]
 
           background: Rectangle {
             implicitWidth: 120
@@ -516,6 +800,14 @@ Rectangle
             fileDialog.open();
           }
         }
+        ProgressBar {
+          id: exportProgress
+          visible: false
+          anchors.verticalCenter: exportBtn.verticalCenter
+          anchors.left: cancelBtn.right
+          anchors.right: exportBtn.left
+          anchors.margins: 20
+        }
         Rectangle {
           id: cancelBtn
           color: Material.color(Material.Grey, Material.Shade600);
@@ -547,11 +839,11 @@ Rectangle
         options: FolderDialog.ShowDirsOnly
 
         onAccepted: {
-          if (exportBtn.currentText == "CSV")
+          var format = (exportBtn.currentText == "Binary") ? "bin" : "csv";
+          if (exportApp.exportSeries(folder, format))
           {
-            var success = exportApp.exportCSV(folder);
-            if (success)
-              exportApp.close();
+            exportProgress.value = 0;
+            exportProgress.visible = true;
           }
         }
         onRejected: fileDialog.close();
@@ -25,6 +25,9 @@ Menu {
     onConfigChanged: {
       pluginMenuListView.model = MainWindow.PluginListModel()
     }
+    onPluginListChanged: {
+      pluginMenuListView.model = MainWindow.PluginListModel()
+    }
   }
 
   ListView {
@@ -26,8 +26,10 @@
 
 #include <QGuiApplication>
 #include <QApplication>
+#include <QColor>
 
 #include <QOffscreenSurface>
+#include <QOpenGLExtraFunctions>
 #include <QOpenGLFunctions>
 
 #include <QQmlApplicationEngine>
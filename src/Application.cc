@@ -15,10 +15,27 @@
  *
  */
 
+#include <QSurfaceFormat>
 #include <tinyxml2.h>
+
+#ifndef _WIN32
+#include <dlfcn.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <queue>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
 #include <ignition/common/SignalHandler.hh>
 #include <ignition/common/SystemPaths.hh>
 #include <ignition/common/Util.hh>
@@ -26,26 +43,142 @@
 #include <ignition/plugin/Loader.hh>
 
 #include "ignition/gui/Application.hh"
+#include "ignition/gui/AsyncLog.hh"
 #include "ignition/gui/config.hh"
 #include "ignition/gui/Dialog.hh"
+#include "ignition/gui/Executor.hh"
 #include "ignition/gui/MainWindow.hh"
+#include "ignition/gui/Metrics.hh"
 #include "ignition/gui/Plugin.hh"
+#include "ignition/gui/PluginAccounting.hh"
+#include "ignition/gui/PluginIndex.hh"
+#include "ignition/gui/SplitLayout.hh"
+#include "ignition/gui/StallWatchdog.hh"
+#include "ignition/gui/SubscriptionHub.hh"
+#include "ignition/gui/Trace.hh"
 
 namespace ignition
 {
   namespace gui
   {
+    /// \brief A plugin library which was found and opened, ready for its
+    /// plugins to be instantiated
+    struct PluginLibrary
+    {
+      /// \brief Path to the library
+      std::string path;
+
+      /// \brief Plugins in the library
+      std::unordered_set<std::string> names;
+
+      /// \brief The plugin implementing ignition::gui::Plugin, empty until
+      /// one has been instantiated
+      std::string guiPlugin;
+
+      /// \brief Plugins created from the library and added, which may have
+      /// been destroyed since
+      std::vector<std::weak_ptr<Plugin>> instances;
+
+      /// \brief Filenames the plugins were loaded with, which name their
+      /// QML files
+      std::unordered_set<std::string> filenames;
+
+      /// \brief True if a plugin asked for the library to stay loaded
+      /// \sa Plugin::KeepLoaded
+      bool keepLoaded{false};
+    };
+
+    /// \brief Creates QML for a fixed time on each frame, while there's
+    /// something to create
+    class IncubationController
+      : public QObject, public QQmlIncubationController
+    {
+      // Documentation inherited
+      protected: void incubatingObjectCountChanged(int _count) override
+      {
+        if (_count > 0 && this->timerId == 0)
+        {
+          this->timerId = this->startTimer(16);
+        }
+        else if (_count == 0 && this->timerId != 0)
+        {
+          this->killTimer(this->timerId);
+          this->timerId = 0;
+        }
+      }
+
+      // Documentation inherited
+      protected: void timerEvent(QTimerEvent *) override
+      {
+        this->incubateFor(this->budget);
+      }
+
+      /// \brief Milliseconds spent creating QML on each frame
+      public: int budget{0};
+
+      /// \brief Timer running while there's QML being created
+      private: int timerId{0};
+    };
+
     class ApplicationPrivate
     {
+      /// \brief Find and open a plugin library. It doesn't involve Qt, so
+      /// it can be called from any thread.
+      /// \param[in] _filename Plugin filename
+      /// \param[out] _library The library, if successful
+      /// \return True if the library was opened
+      public: bool OpenLibrary(const std::string &_filename,
+                               PluginLibrary &_library);
+
+      /// \brief Instantiate the GUI plugin of an opened library. It
+      /// creates Qt objects, so it must be called from the GUI thread.
+      /// \param[in] _filename Plugin filename
+      /// \param[in] _library Opened library
+      /// \return The plugin, null if it couldn't be instantiated
+      public: std::shared_ptr<Plugin> Instantiate(
+                  const std::string &_filename,
+                  PluginLibrary &_library);
+
       /// \brief QML engine
       public: QQmlApplicationEngine *engine{nullptr};
 
+      /// \brief Components compiled so far, keyed by QML URL. They're owned
+      /// by the engine.
+      public: QHash<QString, QPointer<QQmlComponent>> components;
+
       /// \brief Pointer to main window
       public: MainWindow *mainWin{nullptr};
 
       /// \brief Vector of pointers to dialogs
       public: std::vector<Dialog *> dialogs;
 
+      /// \brief Loader shared by all plugins, so each library is loaded
+      /// once however many of its plugins are created. Declared before the
+      /// plugins so it outlives them.
+      public: plugin::Loader loader;
+
+      /// \brief Libraries opened by the loader, keyed by path
+      public: std::map<std::string, PluginLibrary> libraries;
+
+      /// \brief Protects the loader and libraries, which are used by
+      /// several threads while a config is loaded
+      public: std::mutex loaderMutex;
+
+      /// \brief Creates QML asynchronously, if there's a budget
+      public: IncubationController incubationController;
+
+      /// \brief Objects registered by name
+      /// \sa Application::RegisterObject
+      public: QHash<QString, QPointer<QObject>> objects;
+
+      /// \brief Cards of the plugins added so far, keyed by the name shown
+      /// on them
+      public: QHash<QString, QPointer<QQuickItem>> cards;
+
+      /// \brief Plugins waiting for their QML before being added to the
+      /// window
+      public: std::vector<std::shared_ptr<Plugin>> pluginsLoading;
+
       /// \brief Queue of plugins which should be added to the window
       public: std::queue<std::shared_ptr<Plugin>> pluginsToAdd;
 
@@ -53,6 +186,10 @@ namespace ignition
       /// these until it is ok to unload the plugin's shared library.
       public: std::vector<std::shared_ptr<Plugin>> pluginsAdded;
 
+      /// \brief Plugins which were removed, to be destroyed once control
+      /// returns to the event loop
+      public: std::vector<std::shared_ptr<Plugin>> pluginsToDestroy;
+
       /// \brief Environment variable which holds paths to look for plugins
       public: std::string pluginPathEnv = "IGN_GUI_PLUGIN_PATH";
 
@@ -69,14 +206,49 @@ namespace ignition
 
       public: common::SignalHandler signalHandler;
 
+      /// \brief Watches the event loop for stalls, null if not watching
+      public: std::unique_ptr<StallWatchdog> stallWatchdog;
+
+      /// \brief Unload the libraries whose plugins were all destroyed,
+      /// together with the QML compiled from their resources, so closing
+      /// plugins gives their memory back. Libraries are opened again the
+      /// next time one of their plugins is loaded.
+      public: void UnloadUnusedLibraries();
+
+      /// \brief Index the card of an added plugin, unless a plugin with the
+      /// same name was indexed before.
+      /// \param[in] _cardItem Card
+      public: void IndexCard(QQuickItem *_cardItem);
+
       /// \brief QT message handler that pipes qt messages into our console
-      /// system.
+      /// system, asynchronously.
+      /// \sa AsyncLog
       public: static void MessageHandler(QtMsgType _type,
           const QMessageLogContext &_context, const QString &_msg);
+
+      /// \brief Complete the render options with the environment and
+      /// apply them, before any window is created.
+      public: static void ApplyRenderOptions();
+
+      /// \brief How windows are rendered and paced
+      public: static RenderOptions renderOptions;
+
+      /// \brief Check whether the main window can be seen, and notify if
+      /// that changed.
+      public: void UpdateWindowShown();
+
+      /// \brief Whether the main window can be seen
+      public: bool windowShown{true};
+
+      /// \brief True once the main window was exposed, after which it being
+      /// covered is told by its exposure
+      public: bool exposeKnown{false};
     };
   }
 }
 
+RenderOptions ApplicationPrivate::renderOptions;
+
 using namespace ignition;
 using namespace gui;
 
@@ -84,11 +256,26 @@ using namespace gui;
 Application::Application(int &_argc, char **_argv, const WindowType _type)
   : QApplication(_argc, _argv), dataPtr(new ApplicationPrivate)
 {
+  TraceScope trace("Application", "startup");
+
   igndbg << "Initializing application." << std::endl;
 
   // Configure console
   common::Console::SetPrefix("[GUI] ");
 
+  // Compiled QML is kept on disk, unless the user chose another place or
+  // turned it off. Qt versions which don't know the variable use their
+  // default cache location.
+  if (!qEnvironmentVariableIsSet("QML_DISK_CACHE_PATH"))
+  {
+    auto cacheDir = common::joinPaths(CacheDirectory(), "qml");
+    if (common::createDirectories(cacheDir))
+      qputenv("QML_DISK_CACHE_PATH", QByteArray::fromStdString(cacheDir));
+  }
+
+  // Render loop and swap interval, before the first window picks them
+  this->dataPtr->ApplyRenderOptions();
+
   // QML engine
   this->dataPtr->engine = new QQmlApplicationEngine();
 
@@ -102,6 +289,44 @@ Application::Application(int &_argc, char **_argv, const WindowType _type)
   // Handle qt console messages
   qInstallMessageHandler(this->dataPtr->MessageHandler);
 
+  // Stall watchdog
+  std::string stallThreshold;
+  if (common::env("IGN_GUI_STALL_THRESHOLD", stallThreshold) &&
+      !stallThreshold.empty())
+  {
+    std::string stallTopic;
+    common::env("IGN_GUI_STALL_TOPIC", stallTopic);
+    try
+    {
+      this->StartStallWatchdog(
+          std::chrono::milliseconds(std::stoi(stallThreshold)), stallTopic);
+    }
+    catch(const std::exception &)
+    {
+      ignerr << "Invalid IGN_GUI_STALL_THRESHOLD [" << stallThreshold
+             << "], expected milliseconds" << std::endl;
+    }
+  }
+
+  // Metrics endpoint
+  std::string metricsPort;
+  if (common::env("IGN_GUI_METRICS_PORT", metricsPort) &&
+      !metricsPort.empty())
+  {
+    try
+    {
+      // Only scraped from this machine, unless told otherwise
+      std::string metricsAddress{"127.0.0.1"};
+      common::env("IGN_GUI_METRICS_ADDRESS", metricsAddress);
+      this->StartMetrics(std::stoi(metricsPort), metricsAddress);
+    }
+    catch(const std::exception &)
+    {
+      ignerr << "Invalid IGN_GUI_METRICS_PORT [" << metricsPort
+             << "], expected a port number" << std::endl;
+    }
+  }
+
   // Default config path
   std::string home;
   common::env(IGN_HOMEDIR, home);
@@ -129,15 +354,20 @@ Application::~Application()
 {
   igndbg << "Terminating application." << std::endl;
 
+  this->StopStallWatchdog();
+  this->StopMetrics();
+
+  Trace::Write();
+
   if (this->dataPtr->mainWin && this->dataPtr->mainWin->QuickWindow())
   {
     // Detach object from main window and leave libraries for ign-common
+    std::vector<std::string> pluginNames;
     auto plugins = this->dataPtr->mainWin->findChildren<Plugin *>();
     for (auto plugin : plugins)
-    {
-      auto pluginName = plugin->CardItem()->objectName();
-      this->RemovePlugin(pluginName.toStdString());
-    }
+      pluginNames.push_back(plugin->CardItem()->objectName().toStdString());
+    this->RemovePlugins(pluginNames);
+    this->dataPtr->pluginsToDestroy.clear();
     if (this->dataPtr->mainWin->QuickWindow()->isVisible())
       this->dataPtr->mainWin->QuickWindow()->close();
     delete this->dataPtr->mainWin;
@@ -152,16 +382,22 @@ Application::~Application()
   }
   this->dataPtr->dialogs.clear();
 
+  std::queue<std::shared_ptr<Plugin>> empty;
+  std::swap(this->dataPtr->pluginsToAdd, empty);
+  this->dataPtr->pluginsLoading.clear();
+
   if (this->dataPtr->engine)
   {
+    this->dataPtr->engine->setIncubationController(nullptr);
     this->dataPtr->engine->deleteLater();
   }
 
-  std::queue<std::shared_ptr<Plugin>> empty;
-  std::swap(this->dataPtr->pluginsToAdd, empty);
   this->dataPtr->pluginsAdded.clear();
   this->dataPtr->pluginPaths.clear();
   this->dataPtr->pluginPathEnv = "IGN_GUI_PLUGIN_PATH";
+
+  // Qt messages so far are on the console before the program goes on
+  AsyncLog::Instance().Flush();
 }
 
 /////////////////////////////////////////////////
@@ -171,43 +407,209 @@ QQmlApplicationEngine *Application::Engine() const
 }
 
 /////////////////////////////////////////////////
-Application *ignition::gui::App()
+void Application::SetIncubationBudget(const int _budget)
 {
-  return qobject_cast<Application *>(qGuiApp);
+  this->dataPtr->incubationController.budget = std::max(0, _budget);
+  if (this->dataPtr->engine)
+  {
+    this->dataPtr->engine->setIncubationController(_budget > 0 ?
+        &this->dataPtr->incubationController : nullptr);
+  }
 }
 
 /////////////////////////////////////////////////
-bool Application::RemovePlugin(const std::string &_pluginName)
+int Application::IncubationBudget() const
 {
-  bool found{false};
-  for (auto plugin : this->dataPtr->pluginsAdded)
+  return this->dataPtr->incubationController.budget;
+}
+
+/////////////////////////////////////////////////
+void Application::StartStallWatchdog(
+    const std::chrono::milliseconds &_threshold, const std::string &_topic)
+{
+  this->StopStallWatchdog();
+  if (_threshold.count() <= 0)
   {
-    auto cardItem = plugin->CardItem();
-    if (!cardItem)
-      continue;
+    ignerr << "Stall threshold must be positive, got [" << _threshold.count()
+           << "] ms" << std::endl;
+    return;
+  }
+  this->dataPtr->stallWatchdog.reset(new StallWatchdog(_threshold, _topic));
+}
 
-    if (cardItem->objectName().toStdString() == _pluginName)
-    {
-      // Remove on QML
-      cardItem->deleteLater();
+/////////////////////////////////////////////////
+void Application::StopStallWatchdog()
+{
+  this->dataPtr->stallWatchdog.reset();
+}
 
-      // Remove split on QML
-      auto bgItem = this->dataPtr->mainWin->QuickWindow()
-          ->findChild<QQuickItem *>("background");
-      if (bgItem)
-      {
-        QMetaObject::invokeMethod(bgItem, "removeSplitItem",
-            Q_ARG(QVariant, cardItem->parentItem()->objectName()));
-      }
+/////////////////////////////////////////////////
+StallWatchdog *Application::CurrentStallWatchdog() const
+{
+  return this->dataPtr->stallWatchdog.get();
+}
 
-      // Unload shared library
-      this->RemovePlugin(plugin);
+/////////////////////////////////////////////////
+bool Application::StartMetrics(const int _port,
+    const std::string &_address)
+{
+  return Metrics::Instance().Start(_port, _address);
+}
 
-      found = true;
-      break;
+/////////////////////////////////////////////////
+void Application::StopMetrics()
+{
+  Metrics::Instance().Stop();
+}
+
+/////////////////////////////////////////////////
+bool Application::notify(QObject *_receiver, QEvent *_event)
+{
+  if (QThread::currentThread() != this->thread())
+    return QApplication::notify(_receiver, _event);
+
+  // Events for plugins and for the objects they own directly, such as
+  // timers, are accounted to them
+  const Plugin *plugin{nullptr};
+  if (_receiver && (PluginAccounting::Instance().Enabled() ||
+      Metrics::Instance().Enabled()))
+  {
+    plugin = qobject_cast<const Plugin *>(_receiver);
+    if (!plugin && _receiver->parent())
+      plugin = qobject_cast<const Plugin *>(_receiver->parent());
+  }
+  PluginCostScope cost(plugin, CostKind::kEvent);
+
+  auto watchdog = this->dataPtr->stallWatchdog.get();
+  if (!watchdog)
+    return QApplication::notify(_receiver, _event);
+
+  watchdog->Enter(_receiver, _event);
+  auto result = QApplication::notify(_receiver, _event);
+  watchdog->Leave();
+  return result;
+}
+
+/////////////////////////////////////////////////
+MainWindow *Application::MainWin() const
+{
+  return this->dataPtr->mainWin;
+}
+
+/////////////////////////////////////////////////
+bool Application::WindowShown() const
+{
+  return this->dataPtr->windowShown;
+}
+
+/////////////////////////////////////////////////
+bool Application::eventFilter(QObject *_watched, QEvent *_event)
+{
+  if (_event->type() == QEvent::Expose && this->dataPtr->mainWin &&
+      _watched == this->dataPtr->mainWin->QuickWindow())
+  {
+    if (this->dataPtr->mainWin->QuickWindow()->isExposed())
+      this->dataPtr->exposeKnown = true;
+    this->dataPtr->UpdateWindowShown();
+  }
+  return QApplication::eventFilter(_watched, _event);
+}
+
+/////////////////////////////////////////////////
+void Application::RegisterObject(const QString &_name, QObject *_object)
+{
+  if (_object)
+    this->dataPtr->objects[_name] = _object;
+  else
+    this->dataPtr->objects.remove(_name);
+}
+
+/////////////////////////////////////////////////
+QObject *Application::FindObject(const QString &_name) const
+{
+  return this->dataPtr->objects.value(_name).data();
+}
+
+/////////////////////////////////////////////////
+QQuickItem *Application::FindCard(const QString &_pluginName) const
+{
+  return this->dataPtr->cards.value(_pluginName).data();
+}
+
+/////////////////////////////////////////////////
+void ApplicationPrivate::IndexCard(QQuickItem *_cardItem)
+{
+  auto &card = this->cards[_cardItem->property("pluginName").toString()];
+  if (!card)
+    card = _cardItem;
+}
+
+/////////////////////////////////////////////////
+QQmlComponent *Application::Component(const QString &_url)
+{
+  auto &component = this->dataPtr->components[_url];
+  if (!component)
+  {
+    component = new QQmlComponent(this->dataPtr->engine, _url,
+        this->dataPtr->engine);
+  }
+  return component;
+}
+
+/////////////////////////////////////////////////
+Application *ignition::gui::App()
+{
+  return qobject_cast<Application *>(qGuiApp);
+}
+
+/////////////////////////////////////////////////
+bool Application::RemovePlugin(const std::string &_pluginName)
+{
+  return this->RemovePlugins({_pluginName});
+}
+
+/////////////////////////////////////////////////
+bool Application::RemovePlugins(const std::vector<std::string> &_pluginNames)
+{
+  bool found{true};
+  std::vector<std::shared_ptr<Plugin>> plugins;
+  std::vector<QQuickItem *> splitItems;
+  for (const auto &pluginName : _pluginNames)
+  {
+    auto pluginIt = std::find_if(this->dataPtr->pluginsAdded.begin(),
+        this->dataPtr->pluginsAdded.end(),
+        [&pluginName](const std::shared_ptr<Plugin> &_plugin)
+        {
+          auto cardItem = _plugin->CardItem();
+          return cardItem &&
+              cardItem->objectName().toStdString() == pluginName;
+        });
+    if (pluginIt == this->dataPtr->pluginsAdded.end())
+    {
+      found = false;
+      continue;
     }
+    if (std::find(plugins.begin(), plugins.end(), *pluginIt) != plugins.end())
+      continue;
+    plugins.push_back(*pluginIt);
+
+    // Remove on QML
+    auto cardItem = (*pluginIt)->CardItem();
+    if (cardItem->parentItem())
+      splitItems.push_back(cardItem->parentItem());
+    cardItem->setVisible(false);
+    cardItem->deleteLater();
   }
 
+  // Remove splits, the others are laid out again once. Floating cards
+  // have no split.
+  auto layout = this->FindObject<SplitLayout>("background");
+  if (!splitItems.empty() && layout)
+    layout->RemoveItems(splitItems);
+
+  // Unload shared libraries
+  this->RemovePlugins(plugins);
+
   return found;
 }
 
@@ -239,40 +641,102 @@ bool Application::LoadConfig(const std::string &_config)
 
   ignmsg << "Loading config [" << _config << "]" << std::endl;
 
-  // Clear all previous plugins
-  auto plugins = this->dataPtr->mainWin->findChildren<Plugin *>();
-  for (auto plugin : plugins)
+  // Plugins already running with a compatible configuration are kept and
+  // only have their cards rearranged, so switching layouts doesn't drop
+  // their state
+  auto running = this->dataPtr->pluginsAdded;
+  std::vector<std::shared_ptr<Plugin>> reused;
+  std::vector<std::pair<std::string, const tinyxml2::XMLElement *>> toLoad;
+  for (auto pluginElem = doc.FirstChildElement("plugin"); pluginElem != nullptr;
+      pluginElem = pluginElem->NextSiblingElement("plugin"))
   {
-    auto pluginName = plugin->CardItem()->objectName();
-    this->RemovePlugin(pluginName.toStdString());
+    auto filename = pluginElem->Attribute("filename");
+    if (!filename)
+    {
+      ignerr << "Missing filename attribute of <plugin>" << std::endl;
+      continue;
+    }
+
+    auto runningIt = running.begin();
+    while (runningIt != running.end() && !(*runningIt)->Reconfigure(pluginElem))
+      ++runningIt;
+
+    if (runningIt != running.end())
+    {
+      igndbg << "Reusing plugin [" << (*runningIt)->Title() << "]"
+             << std::endl;
+      reused.push_back(*runningIt);
+      running.erase(runningIt);
+      continue;
+    }
+    toLoad.push_back({filename, pluginElem});
+  }
+
+  // Remove the others all at once
+  std::vector<std::string> runningNames;
+  std::vector<std::shared_ptr<Plugin>> cardless;
+  for (auto plugin : running)
+  {
+    if (auto cardItem = plugin->CardItem())
+      runningNames.push_back(cardItem->objectName().toStdString());
+    else
+      cardless.push_back(plugin);
   }
-  if (this->dataPtr->pluginsAdded.size() > 0)
+  this->RemovePlugins(runningNames);
+  this->RemovePlugins(cardless);
+  if (this->dataPtr->pluginsAdded.size() != reused.size())
   {
     ignerr << "The plugin list was not properly cleaned up." << std::endl;
   }
-  this->dataPtr->pluginsAdded.clear();
-
-  // Process each plugin
-  for (auto pluginElem = doc.FirstChildElement("plugin"); pluginElem != nullptr;
-      pluginElem = pluginElem->NextSiblingElement("plugin"))
+  this->dataPtr->pluginsAdded = reused;
+
+  // Finding and opening the libraries is mostly spent on the file system
+  // and dlopen, so it's done by several threads
+  std::vector<PluginLibrary> libraries(toLoad.size());
+  std::vector<char> opened(toLoad.size(), 0);
+  std::atomic<std::size_t> next{0};
+  auto open = [&]()
   {
-    auto filename = pluginElem->Attribute("filename");
-    this->LoadPlugin(filename, pluginElem);
+    for (auto i = next++; i < toLoad.size(); i = next++)
+      opened[i] = this->dataPtr->OpenLibrary(toLoad[i].first, libraries[i]);
+  };
+
+  auto threadCount = std::min<std::size_t>(toLoad.size(),
+      std::max(1u, std::thread::hardware_concurrency()));
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < threadCount; ++i)
+    threads.emplace_back(open);
+  open();
+  for (auto &thread : threads)
+    thread.join();
+  PluginIndex::Instance().Save();
+
+  // Plugins are created on this thread in the order of the config
+  for (std::size_t i = 0; i < toLoad.size(); ++i)
+  {
+    if (!opened[i])
+      continue;
+
+    auto plugin = this->dataPtr->Instantiate(toLoad[i].first, libraries[i]);
+    if (plugin)
+    {
+      this->AddPlugin(plugin, toLoad[i].first, libraries[i].path,
+          toLoad[i].second);
+    }
   }
 
+  // Rearrange reused cards once all others are in place, as they may be
+  // anchored to new plugins
+  for (auto plugin : reused)
+    plugin->PostParentChanges();
+
   // Process window properties
   if (auto winElem = doc.FirstChildElement("window"))
   {
     igndbg << "Loading window config" << std::endl;
 
-    tinyxml2::XMLPrinter printer;
-    if (!winElem->Accept(&printer))
-    {
-      ignwarn << "There was an error parsing the <window> element"
-              << std::endl;
-      return false;
-    }
-    this->dataPtr->windowConfig.MergeFromXML(std::string(printer.CStr()));
+    // Straight from the document, without printing and parsing it again
+    this->dataPtr->windowConfig.MergeFromXML(winElem);
   }
 
   this->ApplyConfig();
@@ -299,15 +763,15 @@ std::string Application::DefaultConfigPath()
 }
 
 /////////////////////////////////////////////////
-bool Application::LoadPlugin(const std::string &_filename,
-    const tinyxml2::XMLElement *_pluginElem)
+bool ApplicationPrivate::OpenLibrary(const std::string &_filename,
+    PluginLibrary &_library)
 {
   igndbg << "Loading plugin [" << _filename << "]" << std::endl;
 
   common::SystemPaths systemPaths;
-  systemPaths.SetPluginPathEnv(this->dataPtr->pluginPathEnv);
+  systemPaths.SetPluginPathEnv(this->pluginPathEnv);
 
-  for (const auto &path : this->dataPtr->pluginPaths)
+  for (const auto &path : this->pluginPaths)
     systemPaths.AddPluginPaths(path);
 
   // Add default folder and install folder
@@ -316,7 +780,18 @@ bool Application::LoadPlugin(const std::string &_filename,
   systemPaths.AddPluginPaths(home + "/.ignition/gui/plugins:" +
                              IGN_GUI_PLUGIN_INSTALL_DIR);
 
-  auto pathToLib = systemPaths.FindSharedLibrary(_filename);
+  const auto &searched = systemPaths.PluginPaths();
+  auto &index = PluginIndex::Instance();
+  std::string pathToLib;
+  {
+    TraceScope trace("Find [" + _filename + "]", "plugin");
+    pathToLib = index.FindLibrary(
+        std::vector<std::string>(searched.begin(), searched.end()), _filename,
+        [&]()
+        {
+          return systemPaths.FindSharedLibrary(_filename);
+        });
+  }
   if (pathToLib.empty())
   {
     ignerr << "Failed to load plugin [" << _filename <<
@@ -324,10 +799,53 @@ bool Application::LoadPlugin(const std::string &_filename,
     return false;
   }
 
-  // Load plugin
-  plugin::Loader pluginLoader;
+  // Already loaded
+  {
+    std::lock_guard<std::mutex> lock(this->loaderMutex);
+    auto libIt = this->libraries.find(pathToLib);
+    if (libIt != this->libraries.end())
+    {
+      _library = libIt->second;
+      return true;
+    }
+  }
+
+#ifndef _WIN32
+  // The loader isn't thread safe, so it's used under the lock. Opening the
+  // library first, with the loader's flags, does the expensive part of
+  // dlopen, mapping, relocating and running static initializers, without
+  // it. The loader then gets the same handle, and this one is released.
+  void *handle{nullptr};
+  {
+    TraceScope trace("dlopen [" + _filename + "]", "plugin");
+    handle = dlopen(pathToLib.c_str(), RTLD_LAZY | RTLD_LOCAL);
+  }
+#endif
+
+  std::lock_guard<std::mutex> lock(this->loaderMutex);
 
-  auto pluginNames = pluginLoader.LoadLib(pathToLib);
+  // Another thread may have loaded it meanwhile
+  auto libIt = this->libraries.find(pathToLib);
+  bool loaded = libIt != this->libraries.end();
+  if (loaded)
+  {
+    _library = libIt->second;
+  }
+  else
+  {
+    TraceScope trace("LoadLib [" + _filename + "]", "plugin");
+    _library.names = this->loader.LoadLib(pathToLib);
+  }
+
+#ifndef _WIN32
+  if (handle)
+    dlclose(handle);
+#endif
+
+  if (loaded)
+    return true;
+
+  const auto &pluginNames = _library.names;
   if (pluginNames.empty())
   {
     ignerr << "Failed to load plugin [" << _filename <<
@@ -336,32 +854,64 @@ bool Application::LoadPlugin(const std::string &_filename,
     return false;
   }
 
+  index.SetPluginNames(pathToLib,
+      std::vector<std::string>(pluginNames.begin(), pluginNames.end()));
+
+  _library.path = pathToLib;
+  this->libraries[pathToLib] = _library;
+  return true;
+}
+
+/////////////////////////////////////////////////
+std::shared_ptr<Plugin> ApplicationPrivate::Instantiate(
+    const std::string &_filename, PluginLibrary &_library)
+{
+  TraceScope trace("Instantiate [" + _filename + "]", "plugin");
+  std::lock_guard<std::mutex> lock(this->loaderMutex);
+
+  // Straight to the plugin found last time
+  if (!_library.guiPlugin.empty())
+  {
+    auto commonPlugin = this->loader.Instantiate(_library.guiPlugin);
+    if (commonPlugin)
+    {
+      auto plugin =
+          commonPlugin->QueryInterfaceSharedPtr<ignition::gui::Plugin>();
+      if (plugin)
+        return plugin;
+    }
+  }
+
   // Go over all plugin names and get the first one that implements the
   // ignition::gui::Plugin interface
   plugin::PluginPtr commonPlugin;
   std::shared_ptr<gui::Plugin> plugin{nullptr};
-  for (auto pluginName : pluginNames)
+  for (auto pluginName : _library.names)
   {
-    commonPlugin = pluginLoader.Instantiate(pluginName);
+    commonPlugin = this->loader.Instantiate(pluginName);
     if (!commonPlugin)
       continue;
 
     plugin = commonPlugin->QueryInterfaceSharedPtr<ignition::gui::Plugin>();
     if (plugin)
+    {
+      _library.guiPlugin = pluginName;
+      this->libraries[_library.path].guiPlugin = pluginName;
       break;
+    }
   }
 
   if (!commonPlugin)
   {
     ignerr << "Failed to load plugin [" << _filename <<
-              "] : couldn't instantiate plugin on path [" << pathToLib <<
+              "] : couldn't instantiate plugin on path [" << _library.path <<
               "]. Tried plugin names: " << std::endl;
 
-    for (auto pluginName : pluginNames)
+    for (auto pluginName : _library.names)
     {
       ignerr << " * " << pluginName << std::endl;
     }
-    return false;
+    return nullptr;
   }
 
   if (!plugin)
@@ -369,9 +919,36 @@ bool Application::LoadPlugin(const std::string &_filename,
     ignerr << "Failed to load plugin [" << _filename <<
               "] : couldn't get [ignition::gui::Plugin] interface."
            << std::endl;
-    return false;
+    return nullptr;
   }
 
+  return plugin;
+}
+
+/////////////////////////////////////////////////
+bool Application::LoadPlugin(const std::string &_filename,
+    const tinyxml2::XMLElement *_pluginElem)
+{
+  PluginLibrary library;
+  auto opened = this->dataPtr->OpenLibrary(_filename, library);
+  PluginIndex::Instance().Save();
+  if (!opened)
+    return false;
+
+  auto plugin = this->dataPtr->Instantiate(_filename, library);
+  if (!plugin)
+    return false;
+
+  return this->AddPlugin(plugin, _filename, library.path, _pluginElem);
+}
+
+/////////////////////////////////////////////////
+bool Application::AddPlugin(std::shared_ptr<Plugin> _plugin,
+    const std::string &_filename, const std::string &_pathToLib,
+    const tinyxml2::XMLElement *_pluginElem)
+{
+  auto plugin = _plugin;
+
   // Basic config in case there is none
   if (!_pluginElem)
   {
@@ -385,6 +962,19 @@ bool Application::LoadPlugin(const std::string &_filename,
   else
     plugin->Load(_pluginElem);
 
+  // The library is unloaded once it has no plugins left
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->loaderMutex);
+    auto libIt = this->dataPtr->libraries.find(_pathToLib);
+    if (libIt != this->dataPtr->libraries.end())
+    {
+      libIt->second.instances.push_back(plugin);
+      libIt->second.filenames.insert(_filename);
+      if (plugin->KeepLoaded())
+        libIt->second.keepLoaded = true;
+    }
+  }
+
   // Store plugin in queue to be added to the window
   this->dataPtr->pluginsToAdd.push(plugin);
 
@@ -395,7 +985,7 @@ bool Application::LoadPlugin(const std::string &_filename,
     this->InitializeDialogs();
 
   this->PluginAdded(plugin->objectName());
-  ignmsg << "Loaded plugin [" << _filename << "] from path [" << pathToLib
+  ignmsg << "Loaded plugin [" << _filename << "] from path [" << _pathToLib
          << "]" << std::endl;
 
   return true;
@@ -404,6 +994,8 @@ bool Application::LoadPlugin(const std::string &_filename,
 /////////////////////////////////////////////////
 bool Application::InitializeMainWindow()
 {
+  TraceScope trace("InitializeMainWindow", "startup");
+
   igndbg << "Create main window" << std::endl;
 
   this->dataPtr->mainWin = new MainWindow();
@@ -412,6 +1004,45 @@ bool Application::InitializeMainWindow()
 
   this->dataPtr->mainWin->setParent(this);
 
+  // Looked up once here, so cards can be added and anchored to it without
+  // searching the window
+  this->RegisterObject("background", this->dataPtr->mainWin->QuickWindow()
+      ->findChild<QQuickItem *>("background"));
+
+  // Plugins rest while the window can't be seen
+  auto window = this->dataPtr->mainWin->QuickWindow();
+  window->installEventFilter(this);
+  this->connect(window, &QWindow::visibilityChanged, this, [this]()
+  {
+    this->dataPtr->UpdateWindowShown();
+  });
+  this->connect(this, &QGuiApplication::applicationStateChanged, this,
+      [this]()
+  {
+    this->dataPtr->UpdateWindowShown();
+  });
+
+  // Frames are counted on the thread which shows them, without waiting for
+  // the GUI thread
+  this->connect(window, &QQuickWindow::frameSwapped, this, []()
+  {
+    if (Metrics::Instance().Enabled())
+      Metrics::Instance().AddFrame(Trace::Clock::now());
+  }, Qt::DirectConnection);
+
+  // Startup ends with the first frame
+  if (Trace::Enabled())
+  {
+    auto connection = std::make_shared<QMetaObject::Connection>();
+    *connection = this->connect(this->dataPtr->mainWin->QuickWindow(),
+        &QQuickWindow::frameSwapped, this, [connection]()
+    {
+      QObject::disconnect(*connection);
+      Trace::Instant("First frame", "startup");
+      Trace::Write();
+    });
+  }
+
   return true;
 }
 
@@ -432,10 +1063,11 @@ bool Application::AddPluginsToWindow()
   if (!this->dataPtr->mainWin || !this->dataPtr->mainWin->QuickWindow())
     return false;
 
+  TraceScope trace("AddPluginsToWindow", "startup");
+
   // Get main window background item
-  auto bgItem = this->dataPtr->mainWin->QuickWindow()
-      ->findChild<QQuickItem *>("background");
-  if (!this->dataPtr->pluginsToAdd.empty() && !bgItem)
+  auto layout = this->FindObject<SplitLayout>("background");
+  if (!this->dataPtr->pluginsToAdd.empty() && !layout)
   {
     ignerr << "Null background QQuickItem!" << std::endl;
     return false;
@@ -445,9 +1077,18 @@ bool Application::AddPluginsToWindow()
   while (!this->dataPtr->pluginsToAdd.empty())
   {
     auto plugin = this->dataPtr->pluginsToAdd.front();
+    this->dataPtr->pluginsToAdd.pop();
+
+    // Added once its QML is ready
+    if (plugin->Loading())
+    {
+      this->dataPtr->pluginsLoading.push_back(plugin);
+      this->connect(plugin.get(), SIGNAL(Loaded()), this,
+          SLOT(OnPluginLoaded()), Qt::QueuedConnection);
+      continue;
+    }
 
     this->dataPtr->pluginsAdded.push_back(plugin);
-    this->dataPtr->pluginsToAdd.pop();
 
     if (plugin->DeleteLaterRequested())
     {
@@ -459,17 +1100,11 @@ bool Application::AddPluginsToWindow()
     if (!cardItem)
       continue;
 
-    // Add split item
-    QVariant splitName;
-    QMetaObject::invokeMethod(bgItem, "addSplitItem",
-        Q_RETURN_ARG(QVariant, splitName));
-
-    auto splitItem = bgItem->findChild<QQuickItem *>(
-        splitName.toString());
+    // Add split item, laid out with the others before the next frame
+    auto splitItem = layout->AddItem();
     if (!splitItem)
     {
-      ignerr << "Internal error: failed to create split ["
-             << splitName.toString().toStdString() << "]" << std::endl;
+      ignerr << "Internal error: failed to create split" << std::endl;
       return false;
     }
 
@@ -477,6 +1112,7 @@ bool Application::AddPluginsToWindow()
     cardItem->setParentItem(splitItem);
     cardItem->setParent(this->dataPtr->engine);
     plugin->setParent(this->dataPtr->mainWin);
+    this->dataPtr->IndexCard(cardItem);
 
     // Apply anchors and state changes now that it's attached to window
     plugin->PostParentChanges();
@@ -526,6 +1162,7 @@ bool Application::InitializeDialogs()
     dialog->QuickWindow()->setProperty("minimumHeight", cardHeight);
 
     cardItem->setParentItem(dialog->RootItem());
+    this->dataPtr->IndexCard(cardItem);
 
     // Signals
     this->dataPtr->mainWin->connect(cardItem, SIGNAL(close()),
@@ -547,57 +1184,105 @@ bool Application::InitializeDialogs()
 void Application::SetPluginPathEnv(const std::string &_env)
 {
   this->dataPtr->pluginPathEnv = _env;
+  this->PluginPathsChanged();
 }
 
 /////////////////////////////////////////////////
 void Application::AddPluginPath(const std::string &_path)
 {
   this->dataPtr->pluginPaths.push_back(_path);
+  this->PluginPathsChanged();
 }
 
 /////////////////////////////////////////////////
 std::vector<std::pair<std::string, std::vector<std::string>>>
     Application::PluginList()
 {
-  // 1. Paths from env variable
-  auto paths = common::SystemPaths::PathsFromEnv(this->dataPtr->pluginPathEnv);
+  auto paths = PluginIndex::PluginDirectories(this->dataPtr->pluginPathEnv,
+      this->dataPtr->pluginPaths);
 
-  // 2. Paths added by calling addPluginPath
-  for (auto const &path : this->dataPtr->pluginPaths)
-    paths.push_back(path);
+  // Populate map, only listing directories which changed since last time
+  std::vector<std::pair<std::string, std::vector<std::string>>> plugins;
+  auto &index = PluginIndex::Instance();
+
+  for (auto const &path : paths)
+    plugins.push_back(std::make_pair(path, index.Libraries(path)));
 
-  // 3. ~/.ignition/gui/plugins
+  index.Save();
+
+  return plugins;
+}
+
+/////////////////////////////////////////////////
+std::string Application::CacheDirectory()
+{
   std::string home;
   common::env(IGN_HOMEDIR, home);
-  paths.push_back(home + "/.ignition/gui/plugins");
+  return common::joinPaths(home, ".ignition", "gui", "cache",
+      std::string(IGNITION_GUI_VERSION_FULL) + "-qt" + qVersion());
+}
 
-  // 4. Install path
-  paths.push_back(IGN_GUI_PLUGIN_INSTALL_DIR);
+/////////////////////////////////////////////////
+void Application::SetRenderOptions(const RenderOptions &_options)
+{
+  ApplicationPrivate::renderOptions = _options;
+}
 
-  // Populate map
-  std::vector<std::pair<std::string, std::vector<std::string>>> plugins;
+/////////////////////////////////////////////////
+RenderOptions Application::CurrentRenderOptions()
+{
+  return ApplicationPrivate::renderOptions;
+}
 
-  for (auto const &path : paths)
-  {
-    std::vector<std::string> ps;
+/////////////////////////////////////////////////
+int Application::WarmCache()
+{
+  TraceScope trace("WarmCache", "startup");
 
-    common::DirIter endIter;
-    for (common::DirIter dirIter(path);
-        dirIter != endIter; ++dirIter)
+  // Opening plugin libraries registers their resources
+  for (const auto &path : this->PluginList())
+  {
+    for (const auto &filename : path.second)
     {
-      auto plugin = common::basename(*dirIter);
-
-      // All we verify is that the file starts with "lib", any further
-      // checks would require loading the plugin.
+      PluginLibrary library;
+      this->dataPtr->OpenLibrary(common::joinPaths(path.first, filename),
+          library);
+    }
+  }
+  PluginIndex::Instance().Save();
 
-      if (plugin.find("lib") == 0)
-        ps.push_back(plugin);
+  // Compiling is enough to write the cache, nothing is created
+  int compiled{0};
+  QDirIterator it(":/", {"*.qml"}, QDir::Files, QDirIterator::Subdirectories);
+  while (it.hasNext())
+  {
+    auto path = it.next();
+    auto component = this->Component(path);
+    if (component->isError())
+    {
+      igndbg << "Failed to compile [" << path.toStdString()
+             << "]: " << component->errorString().toStdString() << std::endl;
+      continue;
     }
+    ++compiled;
+  }
 
-    plugins.push_back(std::make_pair(path, ps));
+  // Render a frame, so Qt caches the shader programs of the scene graph
+  if (this->dataPtr->mainWin && this->dataPtr->mainWin->QuickWindow())
+  {
+    auto window = this->dataPtr->mainWin->QuickWindow();
+    QEventLoop loop;
+    QTimer::singleShot(5000, &loop, &QEventLoop::quit);
+    this->connect(window, &QQuickWindow::frameSwapped, &loop,
+        &QEventLoop::quit);
+    window->show();
+    loop.exec();
+    window->hide();
   }
 
-  return plugins;
+  igndbg << "Compiled [" << compiled << "] QML files into ["
+         << CacheDirectory() << "]" << std::endl;
+  return compiled;
 }
 
 /////////////////////////////////////////////////
@@ -607,13 +1292,68 @@ void Application::OnPluginClose()
   this->RemovePlugin(pluginName.toStdString());
 }
 
+/////////////////////////////////////////////////
+void Application::OnPluginLoaded()
+{
+  auto &loading = this->dataPtr->pluginsLoading;
+  auto pluginIt = std::find_if(loading.begin(), loading.end(),
+      [this](const std::shared_ptr<Plugin> &_plugin)
+      {
+        return _plugin.get() == this->sender();
+      });
+  if (pluginIt == loading.end())
+    return;
+
+  this->dataPtr->pluginsToAdd.push(*pluginIt);
+  loading.erase(pluginIt);
+  this->AddPluginsToWindow();
+}
+
 /////////////////////////////////////////////////
 void Application::RemovePlugin(std::shared_ptr<Plugin> _plugin)
 {
-  this->dataPtr->pluginsAdded.erase(std::remove(
-      this->dataPtr->pluginsAdded.begin(),
-      this->dataPtr->pluginsAdded.end(), _plugin),
-      this->dataPtr->pluginsAdded.end());
+  this->RemovePlugins(std::vector<std::shared_ptr<Plugin>>{_plugin});
+}
+
+/////////////////////////////////////////////////
+void Application::RemovePlugins(
+    const std::vector<std::shared_ptr<Plugin>> &_plugins)
+{
+  if (_plugins.empty())
+    return;
+
+  // Plugins are destroyed once control returns to the event loop, so
+  // closing many of them doesn't stall the caller on their destructors,
+  // such as transport unsubscribes
+  auto &toDestroy = this->dataPtr->pluginsToDestroy;
+  bool scheduled = !toDestroy.empty();
+  for (auto plugin : _plugins)
+  {
+    this->dataPtr->pluginsAdded.erase(std::remove(
+        this->dataPtr->pluginsAdded.begin(),
+        this->dataPtr->pluginsAdded.end(), plugin),
+        this->dataPtr->pluginsAdded.end());
+
+    plugin->setParent(nullptr);
+    toDestroy.push_back(plugin);
+  }
+
+  // Index the remaining cards again, so another plugin with the same name
+  // takes over the entry of a removed one
+  this->dataPtr->cards.clear();
+  for (auto plugin : this->dataPtr->pluginsAdded)
+  {
+    if (auto cardItem = plugin->CardItem())
+      this->dataPtr->IndexCard(cardItem);
+  }
+  if (!scheduled)
+  {
+    QTimer::singleShot(0, this, [this]()
+    {
+      this->dataPtr->pluginsToDestroy.clear();
+      this->dataPtr->UnloadUnusedLibraries();
+    });
+  }
 
   auto pluginCount = this->dataPtr->pluginsAdded.size();
 
@@ -629,6 +1369,68 @@ void Application::RemovePlugin(std::shared_ptr<Plugin> _plugin)
   }
 }
 
+/////////////////////////////////////////////////
+void ApplicationPrivate::UnloadUnusedLibraries()
+{
+  // Items the plugins scheduled for deletion may run the libraries' code
+  QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+
+  // So may functions the plugins posted to the GUI thread, and subscriber
+  // callbacks which transport threads took before they were unsubscribed
+  Executor::Instance().DropDeadGuiTasks();
+  SubscriptionHub::Instance()->WaitForDispatches();
+
+  std::lock_guard<std::mutex> lock(this->loaderMutex);
+  bool unloaded{false};
+  for (auto libIt = this->libraries.begin(); libIt != this->libraries.end();)
+  {
+    auto &library = libIt->second;
+
+    // Libraries which were just opened have no plugins yet
+    if (library.keepLoaded || library.instances.empty())
+    {
+      ++libIt;
+      continue;
+    }
+
+    library.instances.erase(std::remove_if(library.instances.begin(),
+        library.instances.end(),
+        [](const std::weak_ptr<Plugin> &_instance)
+        {
+          return _instance.expired();
+        }), library.instances.end());
+    if (!library.instances.empty())
+    {
+      ++libIt;
+      continue;
+    }
+
+    // Components hold the QML compiled from the library's resources
+    for (const auto &filename : library.filenames)
+    {
+      auto url = QString::fromStdString(":/" + filename + "/" + filename +
+          ".qml");
+      auto componentIt = this->components.find(url);
+      if (componentIt != this->components.end())
+      {
+        delete componentIt.value().data();
+        this->components.erase(componentIt);
+      }
+    }
+
+    // The library is closed once the loader forgets it, as instances which
+    // may hold it are gone
+    igndbg << "Unloading plugin library [" << library.path << "]"
+           << std::endl;
+    this->loader.ForgetLibrary(library.path);
+    libIt = this->libraries.erase(libIt);
+    unloaded = true;
+  }
+
+  if (unloaded && this->engine)
+    this->engine->trimComponentCache();
+}
+
 //////////////////////////////////////////////////
 void ApplicationPrivate::MessageHandler(QtMsgType _type,
     const QMessageLogContext &_context, const QString &_msg)
@@ -637,24 +1439,109 @@ void ApplicationPrivate::MessageHandler(QtMsgType _type,
   if (_context.function)
     msg += std::string("(") + _context.function + ")";
 
+  // Written on another thread, so floods of QML warnings don't stall the
+  // GUI thread on the console
+  auto &log = AsyncLog::Instance();
   switch (_type)
   {
     case QtDebugMsg:
-      igndbg << msg << std::endl;
+      log.Push(AsyncLog::Level::kDebug, std::move(msg));
       break;
     case QtInfoMsg:
-      ignmsg << msg << std::endl;
+      log.Push(AsyncLog::Level::kInfo, std::move(msg));
       break;
     case QtWarningMsg:
-      ignwarn << msg << std::endl;
+      log.Push(AsyncLog::Level::kWarning, std::move(msg));
       break;
     case QtFatalMsg:
-    case QtCriticalMsg:
+      // Qt aborts right after
+      log.Flush();
       ignerr << msg << std::endl;
       break;
+    case QtCriticalMsg:
+      log.Push(AsyncLog::Level::kError, std::move(msg));
+      break;
     default:
-      ignwarn << "Unknown QT Message type[" << _type << "]: "
-        << msg << std::endl;
+      log.Push(AsyncLog::Level::kWarning, "Unknown QT Message type[" +
+          std::to_string(_type) + "]: " + msg);
       break;
   }
 }
+
+/////////////////////////////////////////////////
+void ApplicationPrivate::ApplyRenderOptions()
+{
+  auto &options = renderOptions;
+
+  std::string value;
+  if (common::env("IGN_GUI_RENDER_LOOP", value) && !value.empty())
+    options.renderLoop = value;
+  if (common::env("IGN_GUI_LOW_LATENCY", value) && !value.empty())
+    options.lowLatency = value == "1" || value == "true";
+  try
+  {
+    if (common::env("IGN_GUI_SWAP_INTERVAL", value) && !value.empty())
+      options.swapInterval = std::stoi(value);
+    if (common::env("IGN_GUI_TARGET_FPS", value) && !value.empty())
+      options.targetFps = std::stod(value);
+  }
+  catch(const std::exception &)
+  {
+    ignerr << "Invalid render option [" << value << "], expected a number"
+           << std::endl;
+  }
+
+  if (!options.renderLoop.empty())
+  {
+    if (options.renderLoop == "threaded" || options.renderLoop == "basic")
+    {
+      qputenv("QSG_RENDER_LOOP",
+          QByteArray::fromStdString(options.renderLoop));
+    }
+    else
+    {
+      ignerr << "Unknown render loop [" << options.renderLoop
+             << "], expected [threaded] or [basic]" << std::endl;
+      options.renderLoop.clear();
+    }
+  }
+
+  // Frames are shown as soon as they're drawn, unless asked otherwise
+  if (options.lowLatency && options.swapInterval < 0)
+    options.swapInterval = 0;
+
+  auto format = QSurfaceFormat::defaultFormat();
+  if (options.swapInterval >= 0)
+    format.setSwapInterval(options.swapInterval);
+  if (options.lowLatency)
+    format.setSwapBehavior(QSurfaceFormat::DoubleBuffer);
+  QSurfaceFormat::setDefaultFormat(format);
+
+  igndbg << "Render loop [" << (options.renderLoop.empty() ?
+      qgetenv("QSG_RENDER_LOOP").toStdString() : options.renderLoop)
+         << "], swap interval [" << format.swapInterval()
+         << "], target FPS [" << options.targetFps << "], low latency ["
+         << options.lowLatency << "]" << std::endl;
+}
+
+/////////////////////////////////////////////////
+void ApplicationPrivate::UpdateWindowShown()
+{
+  if (!this->mainWin || !this->mainWin->QuickWindow())
+    return;
+
+  auto window = this->mainWin->QuickWindow();
+  auto visibility = window->visibility();
+  auto state = QGuiApplication::applicationState();
+  bool shown = visibility != QWindow::Hidden &&
+      visibility != QWindow::Minimized &&
+      state != Qt::ApplicationHidden && state != Qt::ApplicationSuspended &&
+      (window->isExposed() || !this->exposeKnown);
+
+  if (shown == this->windowShown)
+    return;
+
+  this->windowShown = shown;
+  igndbg << "Main window " << (shown ? "shown" : "hidden") << std::endl;
+  emit App()->WindowShownChanged(shown);
+}
@@ -17,11 +17,17 @@
 
 #include <stdlib.h>
 #include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+
 #include <ignition/common/Console.hh>
 #include <ignition/utilities/ExtraTestMacros.hh>
 
 #include "test_config.h"  // NOLINT(build/include)
 #include "ignition/gui/Application.hh"
+#include "ignition/gui/config.hh"
 #include "ignition/gui/Dialog.hh"
 #include "ignition/gui/MainWindow.hh"
 #include "ignition/gui/Plugin.hh"
@@ -117,6 +123,42 @@ TEST(ApplicationTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(LoadPlugin))
   }
 }
 
+//////////////////////////////////////////////////
+TEST(ApplicationTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(Component))
+{
+  ignition::common::Console::SetVerbosity(4);
+
+  Application app(g_argc, g_argv);
+
+  // Compiled once, shared afterwards
+  auto card = app.Component(":qml/IgnCard.qml");
+  ASSERT_NE(nullptr, card);
+  EXPECT_FALSE(card->isError());
+  EXPECT_EQ(card, app.Component(":qml/IgnCard.qml"));
+
+  auto missing = app.Component(":qml/Missing.qml");
+  ASSERT_NE(nullptr, missing);
+  EXPECT_TRUE(missing->isError());
+  EXPECT_NE(card, missing);
+}
+
+//////////////////////////////////////////////////
+TEST(ApplicationTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(WarmCache))
+{
+  ignition::common::Console::SetVerbosity(4);
+
+  Application app(g_argc, g_argv, WindowType::kDialog);
+
+  // Versioned, and used for the QML cache
+  auto cacheDir = Application::CacheDirectory();
+  EXPECT_NE(std::string::npos, cacheDir.find(IGNITION_GUI_VERSION_FULL));
+  EXPECT_TRUE(qEnvironmentVariableIsSet("QML_DISK_CACHE_PATH"));
+
+  // At least the library's own QML is compiled
+  EXPECT_GT(app.WarmCache(), 0);
+  EXPECT_FALSE(app.Component(":/qml/IgnCard.qml")->isError());
+}
+
 //////////////////////////////////////////////////
 TEST(ApplicationTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(LoadConfig))
 {
@@ -240,6 +282,269 @@ TEST(ApplicationTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(InitializeMainWindow))
   }
 }
 
+//////////////////////////////////////////////////
+TEST(ApplicationTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(IncubationBudget))
+{
+  ignition::common::Console::SetVerbosity(4);
+
+  Application app(g_argc, g_argv);
+  EXPECT_EQ(0, app.IncubationBudget());
+
+  app.SetIncubationBudget(-1);
+  EXPECT_EQ(0, app.IncubationBudget());
+
+  app.SetIncubationBudget(5);
+  EXPECT_EQ(5, app.IncubationBudget());
+
+  auto win = App()->findChild<MainWindow *>();
+  ASSERT_NE(nullptr, win);
+
+  // The plugin is added to the window once its QML is created
+  EXPECT_TRUE(app.LoadPlugin("Publisher"));
+
+  for (int i = 0; i < 100 && win->findChildren<Plugin *>().empty(); ++i)
+  {
+    QCoreApplication::processEvents(QEventLoop::AllEvents, 30);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  auto plugins = win->findChildren<Plugin *>();
+  ASSERT_EQ(1, plugins.count());
+  EXPECT_FALSE(plugins[0]->Loading());
+  EXPECT_NE(nullptr, plugins[0]->PluginItem());
+  EXPECT_NE(nullptr, plugins[0]->CardItem());
+}
+
+//////////////////////////////////////////////////
+TEST(ApplicationTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(RemovePlugins))
+{
+  ignition::common::Console::SetVerbosity(4);
+
+  Application app(g_argc, g_argv);
+
+  auto win = App()->findChild<MainWindow *>();
+  ASSERT_NE(nullptr, win);
+
+  EXPECT_TRUE(app.LoadPlugin("Publisher"));
+  EXPECT_TRUE(app.LoadPlugin("Publisher"));
+  EXPECT_TRUE(app.LoadPlugin("Publisher"));
+
+  auto plugins = win->findChildren<Plugin *>();
+  ASSERT_EQ(3, plugins.count());
+
+  std::vector<std::string> names;
+  for (auto plugin : plugins)
+    names.push_back(plugin->CardItem()->objectName().toStdString());
+  QPointer<Plugin> removed(plugins[0]);
+
+  // Unknown names are skipped
+  EXPECT_FALSE(app.RemovePlugins({names[0], names[1], "not_a_plugin"}));
+  EXPECT_EQ(1, win->findChildren<Plugin *>().count());
+  EXPECT_EQ(1, win->PluginCount());
+
+  // Destroyed once back in the event loop
+  EXPECT_FALSE(removed.isNull());
+  for (int i = 0; i < 10 && !removed.isNull(); ++i)
+    QCoreApplication::processEvents(QEventLoop::AllEvents, 30);
+  EXPECT_TRUE(removed.isNull());
+
+  EXPECT_TRUE(app.RemovePlugins({names[2]}));
+  EXPECT_EQ(0, win->findChildren<Plugin *>().count());
+  EXPECT_FALSE(app.RemovePlugins({names[2]}));
+}
+
+//////////////////////////////////////////////////
+TEST(ApplicationTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(UnloadLibraries))
+{
+  ignition::common::Console::SetVerbosity(4);
+
+  Application app(g_argc, g_argv);
+
+  auto win = App()->findChild<MainWindow *>();
+  ASSERT_NE(nullptr, win);
+
+  EXPECT_TRUE(app.LoadPlugin("Publisher"));
+  EXPECT_TRUE(app.LoadPlugin("Publisher"));
+
+  auto plugins = win->findChildren<Plugin *>();
+  ASSERT_EQ(2, plugins.count());
+  QPointer<Plugin> first(plugins[0]);
+  QPointer<Plugin> second(plugins[1]);
+
+  // The library stays while one of its plugins is left
+  EXPECT_TRUE(app.RemovePlugins(
+      {plugins[0]->CardItem()->objectName().toStdString()}));
+  for (int i = 0; i < 10 && !first.isNull(); ++i)
+    QCoreApplication::processEvents(QEventLoop::AllEvents, 30);
+  EXPECT_TRUE(first.isNull());
+  ASSERT_FALSE(second.isNull());
+  EXPECT_NE(nullptr, second->PluginItem());
+
+  // And is unloaded with the last one
+  EXPECT_TRUE(app.RemovePlugins(
+      {second->CardItem()->objectName().toStdString()}));
+  for (int i = 0; i < 10 && !second.isNull(); ++i)
+    QCoreApplication::processEvents(QEventLoop::AllEvents, 30);
+  EXPECT_TRUE(second.isNull());
+
+  // Then opened again, with its QML
+  EXPECT_TRUE(app.LoadPlugin("Publisher"));
+  plugins = win->findChildren<Plugin *>();
+  ASSERT_EQ(1, plugins.count());
+  EXPECT_NE(nullptr, plugins[0]->PluginItem());
+  EXPECT_NE(nullptr, plugins[0]->CardItem());
+}
+
+//////////////////////////////////////////////////
+TEST(ApplicationTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(Registry))
+{
+  ignition::common::Console::SetVerbosity(4);
+
+  Application app(g_argc, g_argv);
+
+  auto win = app.MainWin();
+  ASSERT_NE(nullptr, win);
+  EXPECT_EQ(win, App()->findChild<MainWindow *>());
+
+  // Background is registered with the window
+  auto bgItem = app.FindObject<QQuickItem>("background");
+  ASSERT_NE(nullptr, bgItem);
+  EXPECT_EQ(bgItem, win->QuickWindow()->findChild<QQuickItem *>("background"));
+  EXPECT_EQ(nullptr, app.FindObject<MainWindow>("background"));
+
+  // Objects are forgotten when unregistered or destroyed
+  auto object = new QObject();
+  app.RegisterObject("object", object);
+  EXPECT_EQ(object, app.FindObject("object"));
+  app.RegisterObject("object", nullptr);
+  EXPECT_EQ(nullptr, app.FindObject("object"));
+  app.RegisterObject("object", object);
+  delete object;
+  EXPECT_EQ(nullptr, app.FindObject("object"));
+
+  // Cards are found by their name, the first one added if it's repeated
+  EXPECT_EQ(nullptr, app.FindCard("Publisher"));
+  EXPECT_TRUE(app.LoadPlugin("Publisher"));
+  EXPECT_TRUE(app.LoadPlugin("Publisher"));
+
+  auto plugins = win->findChildren<Plugin *>();
+  ASSERT_EQ(2, plugins.count());
+  EXPECT_EQ(plugins[0]->CardItem(), app.FindCard("Publisher"));
+
+  // And the next one takes over if it's removed
+  EXPECT_TRUE(app.RemovePlugins(
+      {plugins[0]->CardItem()->objectName().toStdString()}));
+  EXPECT_EQ(plugins[1]->CardItem(), app.FindCard("Publisher"));
+
+  EXPECT_TRUE(app.RemovePlugins(
+      {plugins[1]->CardItem()->objectName().toStdString()}));
+  EXPECT_EQ(nullptr, app.FindCard("Publisher"));
+}
+
+//////////////////////////////////////////////////
+TEST(ApplicationTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(WindowShown))
+{
+  ignition::common::Console::SetVerbosity(4);
+
+  Application app(g_argc, g_argv);
+  ASSERT_NE(nullptr, app.MainWin());
+  EXPECT_TRUE(app.WindowShown());
+
+  EXPECT_TRUE(app.LoadPlugin("Publisher"));
+  auto plugins = app.MainWin()->findChildren<Plugin *>();
+  ASSERT_EQ(1, plugins.count());
+  EXPECT_TRUE(plugins[0]->Active());
+
+  int changes{0};
+  app.connect(&app, &Application::WindowShownChanged, [&changes](bool)
+  {
+    ++changes;
+  });
+
+  auto waitExposed = [](QWindow *_window, const bool _exposed)
+  {
+    for (int i = 0; i < 100 && _window->isExposed() != _exposed; ++i)
+    {
+      QCoreApplication::processEvents();
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  };
+
+  auto window = app.MainWin()->QuickWindow();
+  window->show();
+  waitExposed(window, true);
+  EXPECT_TRUE(app.WindowShown());
+  EXPECT_TRUE(plugins[0]->Active());
+  EXPECT_EQ(0, changes);
+
+  // Plugins are suspended while the window is hidden
+  window->hide();
+  waitExposed(window, false);
+  EXPECT_FALSE(app.WindowShown());
+  EXPECT_FALSE(plugins[0]->Active());
+  EXPECT_EQ(1, changes);
+
+  window->show();
+  waitExposed(window, true);
+  EXPECT_TRUE(app.WindowShown());
+  EXPECT_TRUE(plugins[0]->Active());
+  EXPECT_EQ(2, changes);
+}
+
+//////////////////////////////////////////////////
+TEST(ApplicationTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(RenderOptions))
+{
+  ignition::common::Console::SetVerbosity(4);
+
+  // Defaults leave Qt alone
+  EXPECT_TRUE(Application::CurrentRenderOptions().renderLoop.empty());
+  EXPECT_EQ(-1, Application::CurrentRenderOptions().swapInterval);
+  EXPECT_DOUBLE_EQ(0.0, Application::CurrentRenderOptions().targetFps);
+  EXPECT_FALSE(Application::CurrentRenderOptions().lowLatency);
+
+  // Low latency doesn't wait for vsync, and the environment takes
+  // precedence
+  RenderOptions options;
+  options.renderLoop = "threaded";
+  options.targetFps = 30.0;
+  options.lowLatency = true;
+  Application::SetRenderOptions(options);
+  setenv("IGN_GUI_RENDER_LOOP", "basic", 1);
+  {
+    Application app(g_argc, g_argv);
+    ASSERT_NE(nullptr, app.MainWin());
+
+    auto current = Application::CurrentRenderOptions();
+    EXPECT_EQ("basic", current.renderLoop);
+    EXPECT_EQ(0, current.swapInterval);
+    EXPECT_DOUBLE_EQ(30.0, current.targetFps);
+    EXPECT_TRUE(current.lowLatency);
+
+    EXPECT_EQ("basic", qgetenv("QSG_RENDER_LOOP").toStdString());
+    EXPECT_EQ(0, QSurfaceFormat::defaultFormat().swapInterval());
+    EXPECT_EQ(QSurfaceFormat::DoubleBuffer,
+        QSurfaceFormat::defaultFormat().swapBehavior());
+  }
+
+  // Unknown loops are ignored
+  unsetenv("IGN_GUI_RENDER_LOOP");
+  unsetenv("QSG_RENDER_LOOP");
+  options = RenderOptions();
+  options.renderLoop = "fast";
+  options.swapInterval = 1;
+  Application::SetRenderOptions(options);
+  {
+    Application app(g_argc, g_argv);
+
+    EXPECT_TRUE(Application::CurrentRenderOptions().renderLoop.empty());
+    EXPECT_FALSE(qEnvironmentVariableIsSet("QSG_RENDER_LOOP"));
+    EXPECT_EQ(1, QSurfaceFormat::defaultFormat().swapInterval());
+  }
+
+  Application::SetRenderOptions(RenderOptions());
+  QSurfaceFormat::setDefaultFormat(QSurfaceFormat());
+}
+
 //////////////////////////////////////////////////
 TEST(ApplicationTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(Dialog))
 {
@@ -0,0 +1,385 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/gui/AsyncLog.hh"
+
+namespace ignition
+{
+  namespace gui
+  {
+    /// \brief A slot of the queue
+    struct LogCell
+    {
+      /// \brief Position the cell is ready for: its position in the queue
+      /// when free, one more once it holds a line
+      std::atomic<std::size_t> sequence;
+
+      /// \brief Severity
+      AsyncLog::Level level;
+
+      /// \brief Line
+      std::string line;
+    };
+
+    class AsyncLogPrivate
+    {
+      /// \brief Queue a line, without blocking.
+      /// \param[in] _level Severity
+      /// \param[in, out] _line Line, swapped into the queue
+      /// \return False if the queue is full
+      public: bool TryPush(const AsyncLog::Level _level, std::string &_line);
+
+      /// \brief Take the oldest line, on the writer thread.
+      /// \param[out] _level Severity
+      /// \param[out] _line Line
+      /// \return False if the queue is empty
+      public: bool TryPop(AsyncLog::Level &_level, std::string &_line);
+
+      /// \brief Write all queued lines, on the writer thread.
+      public: void Drain();
+
+      /// \brief Write how many times the last line was repeated, if it was.
+      public: void WriteRepeats();
+
+      /// \brief Writer thread
+      public: void Run();
+
+      /// \brief Writes lines
+      public: AsyncLog::Writer writer;
+
+      /// \brief Ring of cells, its size a power of two
+      public: std::unique_ptr<LogCell[]> cells;
+
+      /// \brief Size of the ring minus one
+      public: std::size_t mask{0u};
+
+      /// \brief Position of the next line to queue
+      public: std::atomic<std::size_t> enqueuePos{0u};
+
+      /// \brief Position of the next line to write, only used by the
+      /// writer thread
+      public: std::size_t dequeuePos{0u};
+
+      /// \brief Most lines queued per second, 0 for no limit
+      public: unsigned int rate{0u};
+
+      /// \brief Second in which lines are currently being counted
+      public: std::atomic<std::int64_t> rateSecond{-1};
+
+      /// \brief Lines queued during rateSecond
+      public: std::atomic<unsigned int> rateCount{0u};
+
+      /// \brief Lines dropped so far
+      public: std::atomic<std::uint64_t> dropped{0u};
+
+      /// \brief Dropped lines already reported, only used by the writer
+      /// thread
+      public: std::uint64_t droppedReported{0u};
+
+      /// \brief Last line written, only used by the writer thread
+      public: std::string last;
+
+      /// \brief Severity of the last line written
+      public: AsyncLog::Level lastLevel{AsyncLog::Level::kDebug};
+
+      /// \brief Repeats of the last line not written yet
+      public: std::uint64_t repeats{0u};
+
+      /// \brief Time the last line was queued, as seen by the writer
+      public: std::chrono::steady_clock::time_point lastTime;
+
+      /// \brief Whether the writer thread should keep running
+      public: bool running{true};
+
+      /// \brief Number of flushes requested
+      public: std::uint64_t flushRequested{0u};
+
+      /// \brief Number of flushes done
+      public: std::uint64_t flushed{0u};
+
+      /// \brief Protects running and the flush counters
+      public: std::mutex mutex;
+
+      /// \brief Wakes the writer up to flush or stop
+      public: std::condition_variable cv;
+
+      /// \brief Notified when flushes are done
+      public: std::condition_variable flushedCv;
+
+      /// \brief Writer thread
+      public: std::thread thread;
+    };
+  }
+}
+
+using namespace ignition;
+using namespace gui;
+
+/// \brief How often the writer thread checks for lines
+static const std::chrono::milliseconds kWritePeriod{20};
+
+/// \brief How long a line must stop repeating before the repeats are
+/// written
+static const std::chrono::seconds kRepeatTimeout{1};
+
+/////////////////////////////////////////////////
+bool AsyncLogPrivate::TryPush(const AsyncLog::Level _level,
+    std::string &_line)
+{
+  auto pos = this->enqueuePos.load(std::memory_order_relaxed);
+  LogCell *cell{nullptr};
+  while (true)
+  {
+    cell = &this->cells[pos & this->mask];
+    auto sequence = cell->sequence.load(std::memory_order_acquire);
+    auto diff = static_cast<std::ptrdiff_t>(sequence) -
+        static_cast<std::ptrdiff_t>(pos);
+    if (diff == 0)
+    {
+      if (this->enqueuePos.compare_exchange_weak(pos, pos + 1,
+          std::memory_order_relaxed))
+      {
+        break;
+      }
+    }
+    else if (diff < 0)
+    {
+      return false;
+    }
+    else
+    {
+      pos = this->enqueuePos.load(std::memory_order_relaxed);
+    }
+  }
+
+  cell->level = _level;
+  cell->line.swap(_line);
+  cell->sequence.store(pos + 1, std::memory_order_release);
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool AsyncLogPrivate::TryPop(AsyncLog::Level &_level, std::string &_line)
+{
+  auto pos = this->dequeuePos;
+  auto cell = &this->cells[pos & this->mask];
+  if (cell->sequence.load(std::memory_order_acquire) != pos + 1)
+    return false;
+
+  _level = cell->level;
+  _line.swap(cell->line);
+  cell->line.clear();
+  cell->sequence.store(pos + this->mask + 1, std::memory_order_release);
+  this->dequeuePos = pos + 1;
+  return true;
+}
+
+/////////////////////////////////////////////////
+void AsyncLogPrivate::Drain()
+{
+  AsyncLog::Level level;
+  std::string line;
+  while (this->TryPop(level, line))
+  {
+    this->lastTime = std::chrono::steady_clock::now();
+    if (level == this->lastLevel && line == this->last)
+    {
+      ++this->repeats;
+      continue;
+    }
+
+    this->WriteRepeats();
+    this->writer(level, line);
+    this->last.swap(line);
+    this->lastLevel = level;
+  }
+
+  auto dropped = this->dropped.load();
+  if (dropped != this->droppedReported)
+  {
+    this->WriteRepeats();
+    this->writer(AsyncLog::Level::kWarning, "Dropped " +
+        std::to_string(dropped - this->droppedReported) + " log lines");
+    this->droppedReported = dropped;
+    this->last.clear();
+  }
+}
+
+/////////////////////////////////////////////////
+void AsyncLogPrivate::WriteRepeats()
+{
+  if (this->repeats == 0u)
+    return;
+
+  this->writer(this->lastLevel, "Last message repeated " +
+      std::to_string(this->repeats) + " times");
+  this->repeats = 0u;
+}
+
+/////////////////////////////////////////////////
+void AsyncLogPrivate::Run()
+{
+  std::unique_lock<std::mutex> lock(this->mutex);
+  while (true)
+  {
+    auto flushTarget = this->flushRequested;
+    bool stopping = !this->running;
+    lock.unlock();
+
+    this->Drain();
+    if (flushTarget != this->flushed || stopping ||
+        std::chrono::steady_clock::now() - this->lastTime > kRepeatTimeout)
+    {
+      this->WriteRepeats();
+    }
+
+    lock.lock();
+    if (flushTarget != this->flushed)
+    {
+      this->flushed = flushTarget;
+      this->flushedCv.notify_all();
+    }
+    if (stopping)
+      break;
+
+    this->cv.wait_for(lock, kWritePeriod, [this, flushTarget]
+    {
+      return !this->running || this->flushRequested != flushTarget;
+    });
+  }
+}
+
+/////////////////////////////////////////////////
+AsyncLog::AsyncLog(const Writer &_writer, const std::size_t _capacity,
+    const unsigned int _rate)
+  : dataPtr(new AsyncLogPrivate)
+{
+  std::size_t capacity{2u};
+  while (capacity < _capacity)
+    capacity *= 2u;
+
+  this->dataPtr->writer = _writer;
+  this->dataPtr->rate = _rate;
+  this->dataPtr->mask = capacity - 1u;
+  this->dataPtr->cells.reset(new LogCell[capacity]);
+  for (std::size_t i = 0; i < capacity; ++i)
+    this->dataPtr->cells[i].sequence.store(i, std::memory_order_relaxed);
+
+  this->dataPtr->thread = std::thread([this]()
+  {
+    this->dataPtr->Run();
+  });
+}
+
+/////////////////////////////////////////////////
+AsyncLog::~AsyncLog()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->running = false;
+  }
+  this->dataPtr->cv.notify_all();
+  if (this->dataPtr->thread.joinable())
+    this->dataPtr->thread.join();
+}
+
+/////////////////////////////////////////////////
+AsyncLog &AsyncLog::Instance()
+{
+  static AsyncLog log([](const Level _level, const std::string &_line)
+  {
+    switch (_level)
+    {
+      case Level::kDebug:
+        igndbg << _line << std::endl;
+        break;
+      case Level::kInfo:
+        ignmsg << _line << std::endl;
+        break;
+      case Level::kWarning:
+        ignwarn << _line << std::endl;
+        break;
+      case Level::kError:
+      default:
+        ignerr << _line << std::endl;
+        break;
+    }
+  });
+  return log;
+}
+
+/////////////////////////////////////////////////
+bool AsyncLog::Push(const Level _level, std::string _line)
+{
+  if (this->dataPtr->rate > 0u && _level != Level::kError)
+  {
+    auto second = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    auto current = this->dataPtr->rateSecond.load(std::memory_order_relaxed);
+    if (second != current &&
+        this->dataPtr->rateSecond.compare_exchange_strong(current, second))
+    {
+      this->dataPtr->rateCount = 0u;
+    }
+
+    if (++this->dataPtr->rateCount > this->dataPtr->rate)
+    {
+      ++this->dataPtr->dropped;
+      return false;
+    }
+  }
+
+  if (this->dataPtr->TryPush(_level, _line))
+    return true;
+
+  // Errors are written even if it means waiting
+  if (_level == Level::kError)
+  {
+    this->dataPtr->writer(_level, _line);
+    return true;
+  }
+
+  ++this->dataPtr->dropped;
+  return false;
+}
+
+/////////////////////////////////////////////////
+void AsyncLog::Flush()
+{
+  std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+  auto ticket = ++this->dataPtr->flushRequested;
+  this->dataPtr->cv.notify_all();
+  this->dataPtr->flushedCv.wait(lock, [this, ticket]
+  {
+    return this->dataPtr->flushed >= ticket || !this->dataPtr->running;
+  });
+}
+
+/////////////////////////////////////////////////
+std::uint64_t AsyncLog::DroppedCount() const
+{
+  return this->dataPtr->dropped;
+}
@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "ignition/gui/AsyncLog.hh"
+
+using namespace ignition;
+using namespace gui;
+
+/// \brief Lines written by a log
+class Lines
+{
+  /// \brief Get a writer adding to the lines
+  /// \return Writer
+  public: AsyncLog::Writer Writer()
+  {
+    return [this](const AsyncLog::Level _level, const std::string &_line)
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      this->lines.push_back({_level, _line});
+    };
+  }
+
+  /// \brief Get the lines written so far
+  /// \return Lines
+  public: std::vector<std::pair<AsyncLog::Level, std::string>> Get()
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->lines;
+  }
+
+  /// \brief Lines written
+  private: std::vector<std::pair<AsyncLog::Level, std::string>> lines;
+
+  /// \brief Protects lines
+  private: std::mutex mutex;
+};
+
+/////////////////////////////////////////////////
+TEST(AsyncLogTest, Repeats)
+{
+  Lines lines;
+  AsyncLog log(lines.Writer(), 64u, 0u);
+
+  EXPECT_TRUE(log.Push(AsyncLog::Level::kInfo, "first"));
+  for (int i = 0; i < 5; ++i)
+    EXPECT_TRUE(log.Push(AsyncLog::Level::kWarning, "Binding loop"));
+  EXPECT_TRUE(log.Push(AsyncLog::Level::kError, "last"));
+  log.Flush();
+
+  auto written = lines.Get();
+  ASSERT_EQ(4u, written.size());
+  EXPECT_EQ(AsyncLog::Level::kInfo, written[0].first);
+  EXPECT_EQ("first", written[0].second);
+  EXPECT_EQ(AsyncLog::Level::kWarning, written[1].first);
+  EXPECT_EQ("Binding loop", written[1].second);
+  EXPECT_EQ("Last message repeated 4 times", written[2].second);
+  EXPECT_EQ("last", written[3].second);
+  EXPECT_EQ(0u, log.DroppedCount());
+
+  // Repeats pending at a flush are written
+  log.Push(AsyncLog::Level::kError, "last");
+  log.Flush();
+  written = lines.Get();
+  ASSERT_EQ(5u, written.size());
+  EXPECT_EQ("Last message repeated 1 times", written[4].second);
+}
+
+/////////////////////////////////////////////////
+TEST(AsyncLogTest, RateLimit)
+{
+  Lines lines;
+  AsyncLog log(lines.Writer(), 1024u, 10u);
+
+  // Errors are never limited
+  unsigned int queued{0u};
+  for (int i = 0; i < 100; ++i)
+  {
+    if (log.Push(AsyncLog::Level::kDebug, "line " + std::to_string(i)))
+      ++queued;
+    log.Push(AsyncLog::Level::kError, "error " + std::to_string(i));
+  }
+  log.Flush();
+
+  // A second may have started during the loop
+  EXPECT_LE(10u, queued);
+  EXPECT_GE(20u, queued);
+  EXPECT_EQ(100u - queued, log.DroppedCount());
+
+  auto written = lines.Get();
+  ASSERT_FALSE(written.empty());
+  EXPECT_EQ(AsyncLog::Level::kWarning, written.back().first);
+  EXPECT_EQ("Dropped " + std::to_string(100u - queued) + " log lines",
+      written.back().second);
+}
+
+/////////////////////////////////////////////////
+TEST(AsyncLogTest, Threads)
+{
+  Lines lines;
+  unsigned int written{0u};
+  {
+    AsyncLog log(lines.Writer(), 16u, 0u);
+
+    // The queue is small, so some lines are dropped, but each one is
+    // either written or counted
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+      threads.emplace_back([&log, t]()
+      {
+        for (int i = 0; i < 1000; ++i)
+        {
+          log.Push(AsyncLog::Level::kInfo,
+              std::to_string(t) + ":" + std::to_string(i));
+        }
+      });
+    }
+    for (auto &thread : threads)
+      thread.join();
+    log.Flush();
+
+    for (const auto &line : lines.Get())
+    {
+      if (line.second.find("Dropped") != 0)
+        ++written;
+    }
+    EXPECT_EQ(4000u, written + log.DroppedCount());
+  }
+}
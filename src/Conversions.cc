@@ -15,11 +15,32 @@
  *
 */
 
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IGN_GUI_CONVERSIONS_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define IGN_GUI_CONVERSIONS_NEON
+#include <arm_neon.h>
+#endif
+
 #include <ignition/common/MouseEvent.hh>
 #include <ignition/math/Color.hh>
 
 #include "ignition/gui/Conversions.hh"
 
+// Arrays of vectors are read as arrays of their components
+static_assert(std::is_standard_layout<ignition::math::Vector3d>::value &&
+    sizeof(ignition::math::Vector3d) == 3 * sizeof(double),
+    "Vector3d must be three packed doubles");
+static_assert(std::is_standard_layout<ignition::math::Vector2d>::value &&
+    sizeof(ignition::math::Vector2d) == 2 * sizeof(double),
+    "Vector2d must be two packed doubles");
+
 //////////////////////////////////////////////////
 QColor ignition::gui::convert(const ignition::math::Color &_color)
 {
@@ -62,6 +83,71 @@ ignition::math::Vector3d ignition::gui::convert(const QVector3D &_vec)
   return ignition::math::Vector3d(_vec.x(), _vec.y(), _vec.z());
 }
 
+//////////////////////////////////////////////////
+void ignition::gui::convert(const ignition::math::Vector3d *_vecs,
+    const std::size_t _count, float *_out)
+{
+  auto src = reinterpret_cast<const double *>(_vecs);
+  std::size_t n = _count * 3u;
+  std::size_t i = 0u;
+#if defined(IGN_GUI_CONVERSIONS_SSE2)
+  for (; i + 4u <= n; i += 4u)
+  {
+    __m128 lo = _mm_cvtpd_ps(_mm_loadu_pd(src + i));
+    __m128 hi = _mm_cvtpd_ps(_mm_loadu_pd(src + i + 2u));
+    _mm_storeu_ps(_out + i, _mm_movelh_ps(lo, hi));
+  }
+#elif defined(IGN_GUI_CONVERSIONS_NEON)
+  for (; i + 4u <= n; i += 4u)
+  {
+    float32x2_t lo = vcvt_f32_f64(vld1q_f64(src + i));
+    float32x2_t hi = vcvt_f32_f64(vld1q_f64(src + i + 2u));
+    vst1q_f32(_out + i, vcombine_f32(lo, hi));
+  }
+#endif
+  for (; i < n; ++i)
+    _out[i] = static_cast<float>(src[i]);
+}
+
+//////////////////////////////////////////////////
+void ignition::gui::convert(const ignition::math::Vector2d *_pts,
+    const std::size_t _count, QPointF *_out)
+{
+  // QPointF is two qreals, which are doubles except on some embedded builds
+  if (std::is_same<qreal, double>::value &&
+      sizeof(QPointF) == sizeof(ignition::math::Vector2d))
+  {
+    std::memcpy(static_cast<void *>(_out), _pts, _count * sizeof(QPointF));
+    return;
+  }
+
+  for (std::size_t i = 0u; i < _count; ++i)
+    _out[i] = QPointF(_pts[i].X(), _pts[i].Y());
+}
+
+//////////////////////////////////////////////////
+std::size_t ignition::gui::convert(const ignition::msgs::Pose_V &_poses,
+    double *_positions, double *_orientations, const std::size_t _capacity)
+{
+  // Msg fields aren't laid out contiguously, so this is a plain gather
+  std::size_t count = std::min(_capacity,
+      static_cast<std::size_t>(_poses.pose_size()));
+  for (std::size_t i = 0u; i < count; ++i)
+  {
+    const auto &pose = _poses.pose(static_cast<int>(i));
+    const auto &p = pose.position();
+    const auto &q = pose.orientation();
+    _positions[i * 3u] = p.x();
+    _positions[i * 3u + 1u] = p.y();
+    _positions[i * 3u + 2u] = p.z();
+    _orientations[i * 4u] = q.w();
+    _orientations[i * 4u + 1u] = q.x();
+    _orientations[i * 4u + 2u] = q.y();
+    _orientations[i * 4u + 3u] = q.z();
+  }
+  return count;
+}
+
 //////////////////////////////////////////////////
 ignition::common::MouseEvent ignition::gui::convert(const QMouseEvent &_e)
 {
@@ -17,6 +17,8 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
 #include <ignition/common/Console.hh>
 #include <ignition/common/MouseEvent.hh>
 #include <ignition/math/Color.hh>
@@ -99,6 +101,76 @@ TEST(ConversionsTest, Vector3d)
   }
 }
 
+/////////////////////////////////////////////////
+TEST(ConversionsTest, Vector3dArray)
+{
+  // Odd count to go through the vectorized loop and the remainder
+  std::vector<math::Vector3d> vecs;
+  for (int i = 0; i < 7; ++i)
+    vecs.emplace_back(i * 0.5, -i * 1.25, 1000.0 + i);
+
+  std::vector<float> out(vecs.size() * 3u + 1u, -1.0f);
+  convert(vecs.data(), vecs.size(), out.data());
+
+  for (std::size_t i = 0u; i < vecs.size(); ++i)
+  {
+    EXPECT_FLOAT_EQ(out[i * 3u], static_cast<float>(vecs[i].X()));
+    EXPECT_FLOAT_EQ(out[i * 3u + 1u], static_cast<float>(vecs[i].Y()));
+    EXPECT_FLOAT_EQ(out[i * 3u + 2u], static_cast<float>(vecs[i].Z()));
+  }
+
+  // Nothing written past the end
+  EXPECT_FLOAT_EQ(out.back(), -1.0f);
+}
+
+/////////////////////////////////////////////////
+TEST(ConversionsTest, Point2dArray)
+{
+  std::vector<math::Vector2d> pts{{-0.5, 123}, {1, 2}, {3e6, -4e-6}};
+
+  QVector<QPointF> out(static_cast<int>(pts.size()));
+  convert(pts.data(), pts.size(), out.data());
+
+  for (std::size_t i = 0u; i < pts.size(); ++i)
+    EXPECT_EQ(convert(out[static_cast<int>(i)]), pts[i]);
+}
+
+/////////////////////////////////////////////////
+TEST(ConversionsTest, PoseArrays)
+{
+  msgs::Pose_V poses;
+  for (int i = 0; i < 3; ++i)
+  {
+    auto pose = poses.add_pose();
+    pose->mutable_position()->set_x(i);
+    pose->mutable_position()->set_y(i + 0.5);
+    pose->mutable_position()->set_z(-i);
+    pose->mutable_orientation()->set_w(1.0);
+    pose->mutable_orientation()->set_x(0.1 * i);
+    pose->mutable_orientation()->set_y(0.2 * i);
+    pose->mutable_orientation()->set_z(0.3 * i);
+  }
+
+  double positions[3 * 3];
+  double orientations[3 * 4];
+  EXPECT_EQ(3u, convert(poses, positions, orientations, 3u));
+  for (int i = 0; i < 3; ++i)
+  {
+    EXPECT_DOUBLE_EQ(positions[i * 3], i);
+    EXPECT_DOUBLE_EQ(positions[i * 3 + 1], i + 0.5);
+    EXPECT_DOUBLE_EQ(positions[i * 3 + 2], -i);
+    EXPECT_DOUBLE_EQ(orientations[i * 4], 1.0);
+    EXPECT_DOUBLE_EQ(orientations[i * 4 + 1], 0.1 * i);
+    EXPECT_DOUBLE_EQ(orientations[i * 4 + 2], 0.2 * i);
+    EXPECT_DOUBLE_EQ(orientations[i * 4 + 3], 0.3 * i);
+  }
+
+  // Capped by the capacity
+  positions[3] = -1.0;
+  EXPECT_EQ(1u, convert(poses, positions, orientations, 1u));
+  EXPECT_DOUBLE_EQ(positions[3], -1.0);
+}
+
 /////////////////////////////////////////////////
 TEST(ConversionsTest, MouseEvent)
 {
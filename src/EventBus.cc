@@ -0,0 +1,259 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "ignition/gui/EventBus.hh"
+
+namespace ignition
+{
+  namespace gui
+  {
+    class Mailbox;
+
+    /// \brief Events waiting to be handled on a context's thread
+    struct MailboxState
+    {
+      /// \brief Handlers with the copies of the events they get
+      std::deque<std::pair<EventBus::Handler,
+                           std::shared_ptr<const void>>> events;
+
+      /// \brief Object living in the context's thread, null once the
+      /// context is destroyed or the handler unsubscribed
+      Mailbox *mailbox{nullptr};
+
+      /// \brief Protects the members above
+      std::mutex mutex;
+    };
+
+    /// \brief Handles the events in a mailbox when its event loop gets to
+    /// it.
+    class Mailbox : public QObject
+    {
+      /// \brief Constructor
+      /// \param[in] _state Events to handle
+      public: explicit Mailbox(const std::shared_ptr<MailboxState> &_state)
+        : state(_state)
+      {
+      }
+
+      // Documentation inherited
+      public: bool event(QEvent *_event) override
+      {
+        if (_event->type() != kType)
+          return QObject::event(_event);
+
+        decltype(this->state->events) events;
+        {
+          std::lock_guard<std::mutex> lock(this->state->mutex);
+          events.swap(this->state->events);
+        }
+        for (const auto &event : events)
+          event.first(event.second.get());
+        return true;
+      }
+
+      /// \brief Type of the events waking the mailbox up
+      public: static const QEvent::Type kType =
+          QEvent::Type(QEvent::MaxUser - 1000);
+
+      /// \brief Events to handle
+      private: std::shared_ptr<MailboxState> state;
+    };
+
+    /// \brief A handler of one type of events
+    struct BusSubscriber
+    {
+      /// \brief ID returned by Subscribe
+      std::size_t id;
+
+      /// \brief Handler
+      EventBus::Handler handler;
+
+      /// \brief Copies events for queued handlers, empty for direct ones
+      EventBus::Copier copier;
+
+      /// \brief Mailbox of queued handlers
+      std::shared_ptr<MailboxState> mailbox;
+    };
+
+    class EventBusPrivate
+    {
+      /// \brief Handlers of each type. Each list is replaced rather than
+      /// modified, so publishers can go through it without any lock.
+      public: std::map<std::type_index,
+          std::shared_ptr<const std::vector<BusSubscriber>>> subscribers;
+
+      /// \brief Type of each ID
+      public: std::map<std::size_t, std::type_index> types;
+
+      /// \brief Last ID given
+      public: std::size_t lastId{0};
+
+      /// \brief Protects the members above
+      public: mutable std::mutex mutex;
+    };
+  }
+}
+
+using namespace ignition;
+using namespace gui;
+
+/////////////////////////////////////////////////
+EventBus::EventBus()
+  : dataPtr(new EventBusPrivate)
+{
+}
+
+/////////////////////////////////////////////////
+EventBus::~EventBus()
+{
+}
+
+/////////////////////////////////////////////////
+EventBus &EventBus::Instance()
+{
+  static EventBus bus;
+  return bus;
+}
+
+/////////////////////////////////////////////////
+std::size_t EventBus::Add(const std::type_index &_type,
+    const Handler &_handler, QObject *_context, const Copier &_copier)
+{
+  BusSubscriber subscriber;
+  subscriber.handler = _handler;
+  subscriber.copier = _copier;
+
+  if (nullptr != _context)
+  {
+    auto state = std::make_shared<MailboxState>();
+    state->mailbox = new Mailbox(state);
+    state->mailbox->moveToThread(_context->thread());
+    subscriber.mailbox = state;
+
+    // The mailbox goes away with its context
+    QObject::connect(_context, &QObject::destroyed, [state]()
+    {
+      std::lock_guard<std::mutex> lock(state->mutex);
+      if (state->mailbox)
+        state->mailbox->deleteLater();
+      state->mailbox = nullptr;
+      state->events.clear();
+    });
+  }
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  subscriber.id = ++this->dataPtr->lastId;
+
+  auto &current = this->dataPtr->subscribers[_type];
+  auto subscribers = std::make_shared<std::vector<BusSubscriber>>();
+  if (current)
+    *subscribers = *current;
+  subscribers->push_back(subscriber);
+  current = subscribers;
+
+  this->dataPtr->types.emplace(subscriber.id, _type);
+  return subscriber.id;
+}
+
+/////////////////////////////////////////////////
+void EventBus::Unsubscribe(std::size_t _id)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  auto typeIt = this->dataPtr->types.find(_id);
+  if (typeIt == this->dataPtr->types.end())
+    return;
+
+  auto &current = this->dataPtr->subscribers[typeIt->second];
+  auto subscribers = std::make_shared<std::vector<BusSubscriber>>(*current);
+  auto it = std::find_if(subscribers->begin(), subscribers->end(),
+      [&_id](const BusSubscriber &_subscriber)
+      {
+        return _subscriber.id == _id;
+      });
+  if (it != subscribers->end())
+  {
+    if (auto state = it->mailbox)
+    {
+      std::lock_guard<std::mutex> mailboxLock(state->mutex);
+      if (state->mailbox)
+        state->mailbox->deleteLater();
+      state->mailbox = nullptr;
+      state->events.clear();
+    }
+    subscribers->erase(it);
+  }
+
+  if (subscribers->empty())
+    this->dataPtr->subscribers.erase(typeIt->second);
+  else
+    current = subscribers;
+  this->dataPtr->types.erase(typeIt);
+}
+
+/////////////////////////////////////////////////
+void EventBus::Dispatch(const std::type_index &_type, const void *_event)
+{
+  std::shared_ptr<const std::vector<BusSubscriber>> subscribers;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    auto it = this->dataPtr->subscribers.find(_type);
+    if (it == this->dataPtr->subscribers.end())
+      return;
+    subscribers = it->second;
+  }
+
+  for (const auto &subscriber : *subscribers)
+  {
+    if (!subscriber.mailbox)
+    {
+      subscriber.handler(_event);
+      continue;
+    }
+
+    auto &state = subscriber.mailbox;
+    std::lock_guard<std::mutex> lock(state->mutex);
+    if (!state->mailbox)
+      continue;
+
+    // Wake the mailbox up once for all events waiting
+    if (state->events.empty())
+    {
+      QCoreApplication::postEvent(state->mailbox,
+          new QEvent(Mailbox::kType));
+    }
+    state->events.emplace_back(subscriber.handler,
+        subscriber.copier(_event));
+  }
+}
+
+/////////////////////////////////////////////////
+std::size_t EventBus::HandlerCount(const std::type_index &_type) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto it = this->dataPtr->subscribers.find(_type);
+  if (it == this->dataPtr->subscribers.end())
+    return 0;
+  return it->second->size();
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ignition/gui/EventBus.hh"
+
+int g_argc = 1;
+char **g_argv = new char *[g_argc];
+
+using namespace ignition;
+using namespace gui;
+
+/// \brief An event for the tests
+struct TestEvent
+{
+  /// \brief Some data
+  int data;
+};
+
+/// \brief Another event for the tests
+struct OtherEvent
+{
+  /// \brief Some data
+  std::string data;
+};
+
+/////////////////////////////////////////////////
+TEST(EventBusTest, Direct)
+{
+  EventBus bus;
+
+  // Nothing to deliver to
+  bus.Publish(TestEvent{1});
+
+  std::vector<int> received;
+  std::vector<std::string> others;
+  auto first = bus.Subscribe<TestEvent>([&](const TestEvent &_event)
+  {
+    received.push_back(_event.data);
+  });
+  auto second = bus.Subscribe<TestEvent>([&](const TestEvent &_event)
+  {
+    received.push_back(_event.data * 10);
+  });
+  bus.Subscribe<OtherEvent>([&](const OtherEvent &_event)
+  {
+    others.push_back(_event.data);
+  });
+  EXPECT_NE(first, second);
+  EXPECT_EQ(2u, bus.HandlerCount<TestEvent>());
+  EXPECT_EQ(1u, bus.HandlerCount<OtherEvent>());
+
+  // Handled right away, by handlers of that type only
+  TestEvent event{2};
+  bus.Publish(event);
+  EXPECT_EQ(std::vector<int>({2, 20}), received);
+  EXPECT_TRUE(others.empty());
+
+  bus.Publish(OtherEvent{"banana"});
+  EXPECT_EQ(std::vector<std::string>({"banana"}), others);
+  EXPECT_EQ(2u, received.size());
+
+  bus.Unsubscribe(first);
+  bus.Unsubscribe(first);
+  EXPECT_EQ(1u, bus.HandlerCount<TestEvent>());
+  bus.Publish(TestEvent{3});
+  EXPECT_EQ(std::vector<int>({2, 20, 30}), received);
+
+  bus.Unsubscribe(second);
+  EXPECT_EQ(0u, bus.HandlerCount<TestEvent>());
+}
+
+/////////////////////////////////////////////////
+TEST(EventBusTest, Queued)
+{
+  QCoreApplication app(g_argc, g_argv);
+  EventBus bus;
+
+  EXPECT_EQ(0u, bus.Subscribe<TestEvent>(nullptr,
+      [](const TestEvent &) {}));
+
+  auto context = new QObject();
+  std::vector<int> received;
+  std::vector<std::thread::id> threads;
+  auto id = bus.Subscribe<TestEvent>(context, [&](const TestEvent &_event)
+  {
+    received.push_back(_event.data);
+    threads.push_back(std::this_thread::get_id());
+  });
+  EXPECT_NE(0u, id);
+
+  // Published from another thread, with events which don't outlive the
+  // call
+  std::thread([&bus]()
+  {
+    for (int i = 0; i < 3; ++i)
+      bus.Publish(TestEvent{i});
+  }).join();
+  EXPECT_TRUE(received.empty());
+
+  // Handled in order on the context's thread
+  QCoreApplication::processEvents();
+  EXPECT_EQ(std::vector<int>({0, 1, 2}), received);
+  ASSERT_EQ(3u, threads.size());
+  EXPECT_EQ(std::this_thread::get_id(), threads[0]);
+
+  // Not delivered once unsubscribed
+  bus.Publish(TestEvent{3});
+  bus.Unsubscribe(id);
+  QCoreApplication::processEvents();
+  EXPECT_EQ(3u, received.size());
+
+  // Nor once the context is gone
+  bus.Subscribe<TestEvent>(context, [&](const TestEvent &_event)
+  {
+    received.push_back(_event.data);
+  });
+  bus.Publish(TestEvent{4});
+  delete context;
+  bus.Publish(TestEvent{5});
+  QCoreApplication::processEvents();
+  EXPECT_EQ(3u, received.size());
+}
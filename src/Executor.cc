@@ -0,0 +1,437 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Util.hh>
+
+#include "ignition/gui/Executor.hh"
+#include "ignition/gui/qt.h"
+
+namespace ignition
+{
+  namespace gui
+  {
+    /// \brief Tasks of one owner
+    struct ExecutorQueue
+    {
+      /// \brief Tasks which didn't start yet
+      std::deque<Executor::Task> tasks;
+
+      /// \brief Number of tasks running
+      unsigned int running{0u};
+
+      /// \brief Number of tasks which may run at the same time
+      unsigned int concurrency{1u};
+
+      /// \brief Whether the owner is in the list of owners ready to run
+      bool ready{false};
+    };
+
+    /// \brief A function waiting to run on the GUI thread
+    struct GuiTask
+    {
+      /// \brief Context given when posting, only to compare with
+      const QObject *context;
+
+      /// \brief Context, null once it's destroyed
+      QPointer<QObject> object;
+
+      /// \brief Key functions are coalesced by
+      std::string key;
+
+      /// \brief Function
+      Executor::Task task;
+    };
+
+    /// \brief Runs functions posted to the GUI thread
+    class GuiDispatcher : public QObject
+    {
+      /// \brief Constructor
+      /// \param[in] _data Executor data
+      public: explicit GuiDispatcher(ExecutorPrivate *_data)
+          : data(_data)
+      {
+      }
+
+      // Documentation inherited
+      public: bool event(QEvent *_event) override;
+
+      /// \brief Executor data
+      private: ExecutorPrivate *data;
+    };
+
+    class ExecutorPrivate
+    {
+      /// \brief Run tasks until stopping, on a worker thread.
+      public: void Run();
+
+      /// \brief Add an owner to the list of owners ready to run, if it has
+      /// tasks waiting and room to run them. Call with mutex locked.
+      /// \param[in] _owner Owner
+      /// \param[in] _queue Its queue
+      public: void MakeReady(const void *_owner, ExecutorQueue &_queue);
+
+      /// \brief Worker threads
+      public: std::vector<std::thread> threads;
+
+      /// \brief Queue of each owner
+      public: std::unordered_map<const void *, ExecutorQueue> queues;
+
+      /// \brief Owners with tasks to run, in the order they get a turn
+      public: std::deque<const void *> ready;
+
+      /// \brief Set on destruction to stop the workers
+      public: bool stopping{false};
+
+      /// \brief Protects the members above
+      public: mutable std::mutex mutex;
+
+      /// \brief Wakes workers up when there are tasks to run
+      public: std::condition_variable wake;
+
+      /// \brief Notified each time a task finishes
+      public: std::condition_variable finished;
+
+      /// \brief Runs functions on the GUI thread, created when first needed
+      public: GuiDispatcher *dispatcher{nullptr};
+
+      /// \brief Type of the events asking the dispatcher to run functions
+      public: QEvent::Type dispatchType{QEvent::None};
+
+      /// \brief Functions waiting to run on the GUI thread
+      public: std::vector<GuiTask> guiTasks;
+
+      /// \brief Protects the dispatcher and GUI functions
+      public: std::mutex guiMutex;
+    };
+  }
+}
+
+using namespace ignition;
+using namespace gui;
+
+/// \brief Owner of the task running on this thread, null if none
+static thread_local const void *t_currentOwner{nullptr};
+
+/////////////////////////////////////////////////
+bool GuiDispatcher::event(QEvent *_event)
+{
+  if (_event->type() != this->data->dispatchType)
+    return QObject::event(_event);
+
+  std::vector<GuiTask> tasks;
+  {
+    std::lock_guard<std::mutex> lock(this->data->guiMutex);
+    tasks.swap(this->data->guiTasks);
+  }
+
+  for (auto &task : tasks)
+  {
+    if (task.object)
+      task.task();
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////
+void ExecutorPrivate::MakeReady(const void *_owner, ExecutorQueue &_queue)
+{
+  if (_queue.ready || _queue.tasks.empty() ||
+      _queue.running >= _queue.concurrency)
+  {
+    return;
+  }
+
+  _queue.ready = true;
+  this->ready.push_back(_owner);
+  this->wake.notify_one();
+}
+
+/////////////////////////////////////////////////
+void ExecutorPrivate::Run()
+{
+  std::unique_lock<std::mutex> lock(this->mutex);
+  while (true)
+  {
+    this->wake.wait(lock, [this]
+    {
+      return this->stopping || !this->ready.empty();
+    });
+    if (this->stopping)
+      return;
+
+    auto owner = this->ready.front();
+    this->ready.pop_front();
+
+    auto &queue = this->queues[owner];
+    queue.ready = false;
+    auto task = std::move(queue.tasks.front());
+    queue.tasks.pop_front();
+    ++queue.running;
+
+    // Go to the back of the list if there's more, so other owners get a
+    // turn in between
+    this->MakeReady(owner, queue);
+
+    lock.unlock();
+    t_currentOwner = owner;
+    try
+    {
+      task();
+    }
+    catch (const std::exception &_e)
+    {
+      ignerr << "Worker task failed: " << _e.what() << std::endl;
+    }
+    t_currentOwner = nullptr;
+    task = nullptr;
+    lock.lock();
+
+    // The queue may have been cancelled by its own task
+    auto queueIt = this->queues.find(owner);
+    if (queueIt != this->queues.end())
+    {
+      --queueIt->second.running;
+      if (queueIt->second.running == 0 && queueIt->second.tasks.empty() &&
+          queueIt->second.concurrency == 1u)
+      {
+        this->queues.erase(queueIt);
+      }
+      else
+      {
+        this->MakeReady(owner, queueIt->second);
+      }
+    }
+    this->finished.notify_all();
+  }
+}
+
+/////////////////////////////////////////////////
+Executor::Executor(unsigned int _threads)
+  : dataPtr(new ExecutorPrivate)
+{
+  if (_threads == 0u)
+  {
+    std::string env;
+    if (common::env("IGN_GUI_WORKER_THREADS", env) && !env.empty())
+    {
+      try
+      {
+        _threads = static_cast<unsigned int>(std::max(0, std::stoi(env)));
+      }
+      catch (const std::exception &)
+      {
+        ignwarn << "Ignoring invalid IGN_GUI_WORKER_THREADS [" << env << "]"
+                << std::endl;
+      }
+    }
+  }
+
+  // Leave a core to the GUI thread
+  if (_threads == 0u)
+  {
+    _threads = std::max(1u,
+        std::max(1u, std::thread::hardware_concurrency()) - 1u);
+  }
+
+  for (unsigned int i = 0; i < _threads; ++i)
+  {
+    this->dataPtr->threads.emplace_back(&ExecutorPrivate::Run,
+        this->dataPtr.get());
+  }
+}
+
+/////////////////////////////////////////////////
+Executor::~Executor()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->stopping = true;
+  }
+  this->dataPtr->wake.notify_all();
+  for (auto &thread : this->dataPtr->threads)
+    thread.join();
+
+  if (this->dataPtr->dispatcher)
+  {
+    if (QCoreApplication::instance())
+      QCoreApplication::removePostedEvents(this->dataPtr->dispatcher);
+    delete this->dataPtr->dispatcher;
+  }
+}
+
+/////////////////////////////////////////////////
+Executor &Executor::Instance()
+{
+  static Executor executor;
+  return executor;
+}
+
+/////////////////////////////////////////////////
+unsigned int Executor::ThreadCount() const
+{
+  return static_cast<unsigned int>(this->dataPtr->threads.size());
+}
+
+/////////////////////////////////////////////////
+void Executor::Post(const void *_owner, Task _task)
+{
+  if (!_task)
+    return;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto &queue = this->dataPtr->queues[_owner];
+  queue.tasks.push_back(std::move(_task));
+  this->dataPtr->MakeReady(_owner, queue);
+}
+
+/////////////////////////////////////////////////
+void Executor::SetConcurrency(const void *_owner, unsigned int _max)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto &queue = this->dataPtr->queues[_owner];
+  queue.concurrency = std::max(1u, std::min(_max, this->ThreadCount()));
+  this->dataPtr->MakeReady(_owner, queue);
+}
+
+/////////////////////////////////////////////////
+std::size_t Executor::Pending(const void *_owner) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto queueIt = this->dataPtr->queues.find(_owner);
+  if (queueIt == this->dataPtr->queues.end())
+    return 0u;
+  return queueIt->second.tasks.size();
+}
+
+/////////////////////////////////////////////////
+std::size_t Executor::Cancel(const void *_owner)
+{
+  std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+  auto queueIt = this->dataPtr->queues.find(_owner);
+  if (queueIt == this->dataPtr->queues.end())
+    return 0u;
+
+  auto dropped = queueIt->second.tasks.size();
+  queueIt->second.tasks.clear();
+  if (queueIt->second.ready)
+  {
+    auto &ready = this->dataPtr->ready;
+    ready.erase(std::remove(ready.begin(), ready.end(), _owner), ready.end());
+    queueIt->second.ready = false;
+  }
+
+  // A task cancelling its own owner doesn't wait for itself
+  unsigned int self = t_currentOwner == _owner ? 1u : 0u;
+  this->dataPtr->finished.wait(lock, [&]
+  {
+    auto it = this->dataPtr->queues.find(_owner);
+    return it == this->dataPtr->queues.end() || it->second.running <= self;
+  });
+
+  // Forget the owner, the worker running its task does when it finishes
+  queueIt = this->dataPtr->queues.find(_owner);
+  if (queueIt != this->dataPtr->queues.end())
+  {
+    if (self == 0u)
+      this->dataPtr->queues.erase(queueIt);
+    else
+      queueIt->second.concurrency = 1u;
+  }
+
+  return dropped;
+}
+
+/////////////////////////////////////////////////
+void Executor::PostToGui(QObject *_context, Task _task,
+    const std::string &_key)
+{
+  if (!_context || !_task)
+    return;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->guiMutex);
+
+  if (!this->dataPtr->dispatcher)
+  {
+    auto app = QCoreApplication::instance();
+    if (!app)
+    {
+      ignerr << "Can't post to the GUI thread without an application"
+             << std::endl;
+      return;
+    }
+    this->dataPtr->dispatchType = static_cast<QEvent::Type>(
+        QEvent::registerEventType());
+    this->dataPtr->dispatcher = new GuiDispatcher(this->dataPtr.get());
+    this->dataPtr->dispatcher->moveToThread(app->thread());
+  }
+
+  auto &tasks = this->dataPtr->guiTasks;
+  if (!_key.empty())
+  {
+    auto taskIt = std::find_if(tasks.begin(), tasks.end(),
+        [&](const GuiTask &_other)
+        {
+          return _other.context == _context && _other.key == _key;
+        });
+    if (taskIt != tasks.end())
+    {
+      taskIt->task = std::move(_task);
+      return;
+    }
+  }
+
+  // One event runs everything posted until it's handled
+  if (tasks.empty())
+  {
+    QCoreApplication::postEvent(this->dataPtr->dispatcher,
+        new QEvent(this->dataPtr->dispatchType));
+  }
+  tasks.push_back({_context, _context, _key, std::move(_task)});
+}
+
+/////////////////////////////////////////////////
+std::size_t Executor::DropDeadGuiTasks()
+{
+  // Destroyed after unlocking
+  std::vector<GuiTask> dead;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->guiMutex);
+    auto &tasks = this->dataPtr->guiTasks;
+    auto deadIt = std::stable_partition(tasks.begin(), tasks.end(),
+        [](const GuiTask &_task)
+        {
+          return !_task.object.isNull();
+        });
+    dead.insert(dead.end(), std::make_move_iterator(deadIt),
+        std::make_move_iterator(tasks.end()));
+    tasks.erase(deadIt, tasks.end());
+  }
+  return dead.size();
+}
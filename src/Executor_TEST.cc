@@ -0,0 +1,255 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/utilities/ExtraTestMacros.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+#include "ignition/gui/Application.hh"
+#include "ignition/gui/Executor.hh"
+
+int g_argc = 1;
+char **g_argv = new char *[g_argc];
+
+using namespace ignition;
+using namespace gui;
+
+/////////////////////////////////////////////////
+/// \brief Wait until a condition holds, for up to a second.
+/// \param[in] _cond Condition
+/// \return True if it holds
+bool WaitFor(const std::function<bool()> &_cond)
+{
+  for (int i = 0; i < 100 && !_cond(); ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  return _cond();
+}
+
+/////////////////////////////////////////////////
+TEST(ExecutorTest, Order)
+{
+  Executor executor(4);
+  EXPECT_EQ(4u, executor.ThreadCount());
+
+  // Tasks of an owner run one at a time, in order
+  int owner;
+  std::mutex mutex;
+  std::vector<int> order;
+  std::atomic<int> running{0};
+  std::atomic<int> maxRunning{0};
+  for (int i = 0; i < 20; ++i)
+  {
+    executor.Post(&owner, [&, i]()
+    {
+      auto now = ++running;
+      maxRunning = std::max(maxRunning.load(), now);
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        order.push_back(i);
+      }
+      --running;
+    });
+  }
+
+  EXPECT_TRUE(WaitFor([&]()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    return order.size() == 20u;
+  }));
+  EXPECT_EQ(1, maxRunning);
+  for (int i = 0; i < 20; ++i)
+    EXPECT_EQ(i, order[i]);
+  EXPECT_EQ(0u, executor.Pending(&owner));
+}
+
+/////////////////////////////////////////////////
+TEST(ExecutorTest, Concurrency)
+{
+  Executor executor(4);
+
+  // Up to the concurrency run at the same time
+  int owner;
+  executor.SetConcurrency(&owner, 2);
+  std::atomic<int> running{0};
+  std::atomic<int> maxRunning{0};
+  std::atomic<int> done{0};
+  for (int i = 0; i < 10; ++i)
+  {
+    executor.Post(&owner, [&]()
+    {
+      auto now = ++running;
+      maxRunning = std::max(maxRunning.load(), now);
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      --running;
+      ++done;
+    });
+  }
+  EXPECT_TRUE(WaitFor([&]() {return done == 10;}));
+  EXPECT_EQ(2, maxRunning);
+
+  // A busy owner doesn't keep others waiting
+  int busy, other;
+  std::atomic<bool> release{false};
+  for (int i = 0; i < 10; ++i)
+  {
+    executor.Post(&busy, [&]()
+    {
+      while (!release)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    });
+  }
+  std::atomic<bool> otherRan{false};
+  executor.Post(&other, [&]() {otherRan = true;});
+  EXPECT_TRUE(WaitFor([&]() {return otherRan.load();}));
+  EXPECT_EQ(9u, executor.Pending(&busy));
+  release = true;
+}
+
+/////////////////////////////////////////////////
+TEST(ExecutorTest, Cancel)
+{
+  Executor executor(1);
+
+  int owner;
+  std::atomic<bool> started{false};
+  std::atomic<bool> finished{false};
+  std::atomic<int> ran{0};
+  executor.Post(&owner, [&]()
+  {
+    started = true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    finished = true;
+  });
+  for (int i = 0; i < 5; ++i)
+    executor.Post(&owner, [&]() {++ran;});
+
+  ASSERT_TRUE(WaitFor([&]() {return started.load();}));
+  EXPECT_EQ(5u, executor.Pending(&owner));
+
+  // The running task is waited for and the others are dropped
+  EXPECT_EQ(5u, executor.Cancel(&owner));
+  EXPECT_TRUE(finished);
+  EXPECT_EQ(0u, executor.Pending(&owner));
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_EQ(0, ran);
+  EXPECT_EQ(0u, executor.Cancel(&owner));
+
+  // A task may cancel its own owner
+  std::atomic<bool> cancel{false};
+  std::atomic<bool> cancelled{false};
+  executor.Post(&owner, [&]()
+  {
+    while (!cancel)
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    executor.Cancel(&owner);
+    cancelled = true;
+  });
+  executor.Post(&owner, [&]() {++ran;});
+  cancel = true;
+  EXPECT_TRUE(WaitFor([&]() {return cancelled.load();}));
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_EQ(0, ran);
+
+  // And the owner can be used again
+  executor.Post(&owner, [&]() {++ran;});
+  EXPECT_TRUE(WaitFor([&]() {return ran == 1;}));
+}
+
+/////////////////////////////////////////////////
+TEST(ExecutorTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(PostToGui))
+{
+  common::Console::SetVerbosity(4);
+
+  Application app(g_argc, g_argv, WindowType::kDialog);
+  Executor executor(2);
+
+  QObject context;
+  std::vector<int> values;
+  int plain{0};
+
+  // Posted from a worker, run on the GUI thread, latest value only
+  int owner;
+  std::atomic<bool> posted{false};
+  executor.Post(&owner, [&]()
+  {
+    for (int i = 0; i < 100; ++i)
+    {
+      executor.PostToGui(&context, [&values, i]()
+      {
+        values.push_back(i);
+      }, "value");
+      executor.PostToGui(&context, [&plain]() {++plain;});
+    }
+    posted = true;
+  });
+  ASSERT_TRUE(WaitFor([&]() {return posted.load();}));
+  EXPECT_TRUE(values.empty());
+
+  QCoreApplication::processEvents();
+  ASSERT_EQ(1u, values.size());
+  EXPECT_EQ(99, values[0]);
+  EXPECT_EQ(100, plain);
+
+  // Not run once the context is destroyed
+  {
+    QObject gone;
+    executor.PostToGui(&gone, [&plain]() {++plain;});
+  }
+  QCoreApplication::processEvents();
+  EXPECT_EQ(100, plain);
+}
+
+/////////////////////////////////////////////////
+TEST(ExecutorTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(DropDeadGuiTasks))
+{
+  common::Console::SetVerbosity(4);
+
+  Application app(g_argc, g_argv, WindowType::kDialog);
+  Executor executor(1);
+
+  // The function holds this until it's destroyed
+  auto held = std::make_shared<int>(0);
+  int ran{0};
+
+  QObject context;
+  executor.PostToGui(&context, [&ran]() {++ran;});
+  {
+    QObject gone;
+    executor.PostToGui(&gone, [held, &ran]() {++ran;});
+  }
+  EXPECT_EQ(2, held.use_count());
+
+  // Only the dead one is dropped, and it's destroyed right away
+  EXPECT_EQ(1u, executor.DropDeadGuiTasks());
+  EXPECT_EQ(1, held.use_count());
+  EXPECT_EQ(0u, executor.DropDeadGuiTasks());
+
+  QCoreApplication::processEvents();
+  EXPECT_EQ(1, ran);
+}
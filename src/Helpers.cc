@@ -170,7 +170,7 @@ std::string ignition::gui::uniqueFilePath(const std::string &_pathAndName,
 /////////////////////////////////////////////////
 QStringList ignition::gui::worldNames()
 {
-  auto win = App()->findChild<MainWindow *>();
+  auto win = App()->MainWin();
   if (nullptr == win)
     return {};
 
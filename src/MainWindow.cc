@@ -18,6 +18,8 @@
 #include <tinyxml2.h>
 #include <regex>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 
 #include <ignition/common/Console.hh>
 #include <ignition/common/Filesystem.hh>
@@ -25,6 +27,7 @@
 #include "ignition/gui/MainWindow.hh"
 #include "ignition/gui/Plugin.hh"
 #include "ignition/gui/qt.h"
+#include "ignition/gui/SplitLayout.hh"
 
 namespace ignition
 {
@@ -47,6 +50,23 @@ namespace ignition
       /// \brief Minimum number of paint events to consider the window to be
       /// fully initialized.
       public: const unsigned int paintCountMin{20};
+
+      /// \brief Plugin names for the menu, valid unless pluginListDirty
+      public: QStringList pluginList;
+
+      /// \brief True if pluginList must be built again
+      public: bool pluginListDirty{true};
+
+      /// \brief Display name of each plugin library file name, kept across
+      /// rebuilds so only new files are converted
+      public: std::unordered_map<std::string, std::string> displayNames;
+
+      /// \brief Plugins to show, from the window config
+      public: std::unordered_set<std::string> showPlugins;
+
+      /// \brief Watches the plugin directories, to update the list when
+      /// libraries are added or removed
+      public: QFileSystemWatcher pluginWatcher;
     };
   }
 }
@@ -63,13 +83,35 @@ std::string dirName(const std::string &_path)
   return _path.substr(0, found);
 }
 
+/// \brief Get the name shown in the menu for a plugin library.
+/// \param[in] _filename Library file name, such as libImageDisplay.so
+/// \return Name, such as "Image Display"
+static std::string displayName(const std::string &_filename)
+{
+  // Remove lib and .so
+  auto pluginName = _filename.substr(3, _filename.find(".") - 3);
+
+  // Split WWWCamelCase3D -> WWW Camel Case 3D
+  static const std::regex reg("(\\B[A-Z][a-z])|(\\B[0-9])");
+  return std::regex_replace(pluginName, reg, " $&");
+}
+
 /////////////////////////////////////////////////
 MainWindow::MainWindow()
   : dataPtr(new MainWindowPrivate)
 {
+  this->connect(&this->dataPtr->pluginWatcher,
+      &QFileSystemWatcher::directoryChanged, this,
+      &MainWindow::OnPluginsChanged);
+  this->connect(App(), &Application::PluginPathsChanged, this,
+      &MainWindow::OnPluginsChanged);
+
   // Make MainWindow functions available from all QML files (using root)
   App()->Engine()->rootContext()->setContextProperty("MainWindow", this);
 
+  // Cards are docked into it
+  qmlRegisterType<SplitLayout>("SplitLayout", 1, 0, "SplitLayout");
+
   // Load QML and keep pointer to generated QQuickWindow
   std::string qmlFile("qrc:qml/Main.qml");
   App()->Engine()->load(QUrl(QString::fromStdString(qmlFile)));
@@ -94,43 +136,66 @@ MainWindow::~MainWindow()
 /////////////////////////////////////////////////
 QStringList MainWindow::PluginListModel() const
 {
-  QStringList pluginNames;
+  auto &d = *this->dataPtr;
+  if (!d.pluginListDirty)
+    return d.pluginList;
+
+  d.pluginList.clear();
+  QStringList watched;
   auto plugins = App()->PluginList();
   for (auto const &path : plugins)
   {
+    // Directories which don't exist can't be watched
+    watched.append(QString::fromStdString(path.first));
+
     for (auto const &plugin : path.second)
     {
-      // Remove lib and .so
-      auto pluginName = plugin.substr(3, plugin.find(".") - 3);
-
-      // Split WWWCamelCase3D -> WWW Camel Case 3D
-      std::regex reg("(\\B[A-Z][a-z])|(\\B[0-9])");
-      pluginName = std::regex_replace(pluginName, reg, " $&");
+      auto nameIt = d.displayNames.find(plugin);
+      if (nameIt == d.displayNames.end())
+        nameIt = d.displayNames.emplace(plugin, displayName(plugin)).first;
+      const auto &pluginName = nameIt->second;
 
       // Show?
-      if (this->dataPtr->windowConfig.pluginsFromPaths ||
-          std::find(this->dataPtr->windowConfig.showPlugins.begin(),
-                    this->dataPtr->windowConfig.showPlugins.end(),
-                    pluginName) !=
-                    this->dataPtr->windowConfig.showPlugins.end())
-      {
-        pluginNames.append(QString::fromStdString(pluginName));
-      }
+      if (d.windowConfig.pluginsFromPaths || d.showPlugins.count(pluginName))
+        d.pluginList.append(QString::fromStdString(pluginName));
     }
   }
 
   // Error
-  for (auto plugin : this->dataPtr->windowConfig.showPlugins)
+  for (auto plugin : d.windowConfig.showPlugins)
   {
-    if (!pluginNames.contains(QString::fromStdString(plugin)))
+    if (!d.pluginList.contains(QString::fromStdString(plugin)))
     {
       ignwarn << "Requested to show plugin [" << plugin <<
           "] but it doesn't exist." << std::endl;
     }
   }
 
-  pluginNames.sort();
-  return pluginNames;
+  d.pluginList.sort();
+
+  // Watch the current directories only
+  auto current = d.pluginWatcher.directories();
+  if (!current.isEmpty())
+    d.pluginWatcher.removePaths(current);
+  watched.removeDuplicates();
+  for (const auto &dir : watched)
+  {
+    if (QFileInfo(dir).isDir())
+      d.pluginWatcher.addPath(dir);
+  }
+
+  d.pluginListDirty = false;
+  return d.pluginList;
+}
+
+/////////////////////////////////////////////////
+void MainWindow::OnPluginsChanged()
+{
+  if (this->dataPtr->pluginListDirty)
+    return;
+
+  this->dataPtr->pluginListDirty = true;
+  this->PluginListChanged();
 }
 
 //////////////////////////////////////////////////
@@ -252,6 +317,8 @@ bool MainWindow::ApplyConfig(const WindowConfig &_config)
         _config.pluginToolBarColorDark));
     this->SetPluginToolBarTextColorDark(QString::fromStdString(
         _config.pluginToolBarTextColorDark));
+
+    this->SetLightweight(_config.lightweight);
   }
 
   // Menus
@@ -261,6 +328,10 @@ bool MainWindow::ApplyConfig(const WindowConfig &_config)
 
   // Keep a copy
   this->dataPtr->windowConfig = _config;
+  this->dataPtr->showPlugins.clear();
+  this->dataPtr->showPlugins.insert(_config.showPlugins.begin(),
+      _config.showPlugins.end());
+  this->dataPtr->pluginListDirty = true;
 
   // Notify view
   this->configChanged();
@@ -302,6 +373,7 @@ WindowConfig MainWindow::CurrentWindowConfig() const
     this->QuickWindow()->property("toolBarColorDark").toString().toStdString();
   config.toolBarTextColorDark = this->QuickWindow()->property(
     "toolBarTextColorDark").toString().toStdString();
+  config.lightweight = this->dataPtr->windowConfig.lightweight;
 
   // Menus configuration and ignored properties are kept the same as the
   // initial ones. They might have been changed programatically but we
@@ -328,8 +400,13 @@ bool WindowConfig::MergeFromXML(const std::string &_windowXml)
   // TinyXml element from string
   tinyxml2::XMLDocument doc;
   doc.Parse(_windowXml.c_str());
-  auto winElem = doc.FirstChildElement("window");
+  return this->MergeFromXML(doc.FirstChildElement("window"));
+}
 
+/////////////////////////////////////////////////
+bool WindowConfig::MergeFromXML(const tinyxml2::XMLElement *_windowElem)
+{
+  auto winElem = _windowElem;
   if (!winElem)
     return false;
 
@@ -416,6 +493,7 @@ bool WindowConfig::MergeFromXML(const std::string &_windowXml)
     {
       this->pluginToolBarTextColorDark = pluginTBTextColorDark;
     }
+    styleElem->QueryBoolAttribute("lightweight", &this->lightweight);
   }
 
   // Menus
@@ -553,6 +631,9 @@ std::string WindowConfig::XMLString() const
     elem->SetAttribute("plugin_toolbar_text_color_dark",
         this->pluginToolBarTextColorDark.c_str());
 
+    if (this->lightweight)
+      elem->SetAttribute("lightweight", true);
+
     windowElem->InsertEndChild(elem);
   }
 
@@ -843,3 +924,19 @@ void MainWindow::SetShowPluginMenu(const bool _showPluginMenu)
   this->dataPtr->windowConfig.showPluginMenu = _showPluginMenu;
   this->ShowPluginMenuChanged();
 }
+
+/////////////////////////////////////////////////
+bool MainWindow::Lightweight() const
+{
+  return this->dataPtr->windowConfig.lightweight;
+}
+
+/////////////////////////////////////////////////
+void MainWindow::SetLightweight(const bool _lightweight)
+{
+  if (this->dataPtr->windowConfig.lightweight == _lightweight)
+    return;
+
+  this->dataPtr->windowConfig.lightweight = _lightweight;
+  this->LightweightChanged();
+}
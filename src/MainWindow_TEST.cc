@@ -16,9 +16,12 @@
 */
 
 #include <gtest/gtest.h>
+#include <chrono>
+#include <fstream>
 #include <thread>
 
 #include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
 #include <ignition/utilities/ExtraTestMacros.hh>
 
 #include "test_config.h"  // NOLINT(build/include)
@@ -149,6 +152,18 @@ TEST(MainWindowTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(OnLoadConfig))
     EXPECT_EQ(1, plugins.size());
   }
 
+  // Loading it again keeps the running plugin
+  {
+    auto plugin = plugins[0];
+    auto path = QString::fromStdString(
+          std::string(PROJECT_SOURCE_PATH) + "/test/config/test.config");
+    mainWindow->OnLoadConfig(path);
+
+    plugins = mainWindow->findChildren<Plugin *>();
+    ASSERT_EQ(1, plugins.size());
+    EXPECT_EQ(plugin, plugins[0]);
+  }
+
   // Load file with 2 plugins and window state
   {
     // Trigger load
@@ -194,6 +209,55 @@ TEST(MainWindowTest, IGN_UTILS_TEST_ENABLED_ONLY_ON_LINUX(OnAddPlugin))
   EXPECT_EQ(plugins.size(), 2);
 }
 
+/////////////////////////////////////////////////
+TEST(MainWindowTest, IGN_UTILS_TEST_ENABLED_ONLY_ON_LINUX(PluginListModel))
+{
+  ignition::common::Console::SetVerbosity(4);
+  Application app(g_argc, g_argv);
+
+  auto dir = common::joinPaths(PROJECT_BINARY_PATH, "plugin_list_test");
+  common::removeAll(dir);
+  ASSERT_TRUE(common::createDirectories(dir));
+  std::ofstream(common::joinPaths(dir, "libFakeCamelCase3D.so")) << "x";
+
+  auto mainWindow = App()->findChild<MainWindow *>();
+  ASSERT_NE(nullptr, mainWindow);
+
+  int changes{0};
+  mainWindow->connect(mainWindow, &MainWindow::PluginListChanged,
+      [&changes]()
+      {
+        ++changes;
+      });
+
+  App()->AddPluginPath(dir);
+  auto list = mainWindow->PluginListModel();
+  EXPECT_TRUE(list.contains("Fake Camel Case 3D"));
+
+  // Kept until something changes
+  EXPECT_EQ(list, mainWindow->PluginListModel());
+  EXPECT_EQ(0, changes);
+
+  // New libraries are noticed
+  std::ofstream(common::joinPaths(dir, "libFakeOther.so")) << "x";
+  for (int i = 0; i < 50 && changes == 0; ++i)
+  {
+    QCoreApplication::processEvents(QEventLoop::AllEvents, 20);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+  EXPECT_EQ(1, changes);
+  EXPECT_TRUE(mainWindow->PluginListModel().contains("Fake Other"));
+
+  // Only the requested plugins
+  WindowConfig config;
+  config.pluginsFromPaths = false;
+  config.showPlugins.push_back("Fake Other");
+  EXPECT_TRUE(mainWindow->ApplyConfig(config));
+  EXPECT_EQ(QStringList({"Fake Other"}), mainWindow->PluginListModel());
+
+  common::removeAll(dir);
+}
+
 /////////////////////////////////////////////////
 TEST(WindowConfigTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(defaultValues))
 {
@@ -267,6 +331,40 @@ TEST(WindowConfigTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(mergeFromXML))
   EXPECT_TRUE(c.IsIgnoring("size"));
 }
 
+/////////////////////////////////////////////////
+TEST(WindowConfigTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(mergeFromElement))
+{
+  WindowConfig c;
+  EXPECT_FALSE(c.MergeFromXML(
+      static_cast<const tinyxml2::XMLElement *>(nullptr)));
+
+  tinyxml2::XMLDocument doc;
+  doc.Parse("<window><width>800</width><ignore>state</ignore></window>");
+  EXPECT_TRUE(c.MergeFromXML(doc.FirstChildElement("window")));
+  EXPECT_EQ(c.width, 800);
+  EXPECT_TRUE(c.IsIgnoring("state"));
+}
+
+/////////////////////////////////////////////////
+TEST(WindowConfigTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(Lightweight))
+{
+  WindowConfig c;
+  EXPECT_FALSE(c.lightweight);
+  EXPECT_EQ(c.XMLString().find("lightweight"), std::string::npos);
+
+  EXPECT_TRUE(c.MergeFromXML(
+      "<window><style lightweight=\"true\"/></window>"));
+  EXPECT_TRUE(c.lightweight);
+
+  auto str = c.XMLString();
+  EXPECT_NE(str.find("lightweight=\"true\""), std::string::npos) << str;
+
+  // Round trip
+  WindowConfig d;
+  EXPECT_TRUE(d.MergeFromXML(str));
+  EXPECT_TRUE(d.lightweight);
+}
+
 /////////////////////////////////////////////////
 TEST(WindowConfigTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(MenusToString))
 {
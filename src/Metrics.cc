@@ -0,0 +1,596 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <locale>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/gui/Metrics.hh"
+
+namespace ignition
+{
+  namespace gui
+  {
+    /// \brief Times of a tracked plugin
+    struct MetricsPlugin
+    {
+      /// \brief Plugin
+      const Plugin *plugin{nullptr};
+
+      /// \brief Number telling apart plugins with the same name
+      std::size_t id{0u};
+
+      /// \brief Exported name. Only accessed with std::atomic_load and
+      /// std::atomic_store.
+      std::shared_ptr<const std::string> name;
+
+      /// \brief Number of calls, indexed by CostKind
+      std::array<std::atomic<std::uint64_t>, 3> calls{};
+
+      /// \brief Nanoseconds spent, indexed by CostKind
+      std::array<std::atomic<std::uint64_t>, 3> nanoseconds{};
+    };
+
+    /// \brief Tracked plugins, replaced as a whole when one comes or goes
+    using MetricsPlugins =
+        std::vector<std::shared_ptr<MetricsPlugin>>;
+
+    class MetricsPrivate
+    {
+      /// \brief Serve requests until stopping. Runs on the server thread.
+      public: void Serve();
+
+      /// \brief Answer one request.
+      /// \param[in] _client Connected socket
+      public: void Respond(const int _client) const;
+
+      /// \brief Metrics served
+      public: const Metrics *metrics{nullptr};
+
+      /// \brief Events counted, indexed by MetricCounter
+      public: std::array<std::atomic<std::uint64_t>, 3> counters{};
+
+      /// \brief Frames shown
+      public: std::atomic<std::uint64_t> frames{0u};
+
+      /// \brief Time of the last frame, in nanoseconds of Trace::Clock, 0
+      /// before the first one
+      public: std::atomic<std::int64_t> lastFrame{0};
+
+      /// \brief Number of frame times in each histogram bucket, not
+      /// cumulative
+      public: std::array<std::atomic<std::uint64_t>, 10> frameBuckets{};
+
+      /// \brief Number of frame times in the histogram
+      public: std::atomic<std::uint64_t> frameTimes{0u};
+
+      /// \brief Sum of the frame times in the histogram, in nanoseconds
+      public: std::atomic<std::uint64_t> frameNanoseconds{0u};
+
+      /// \brief Tracked plugins, only accessed with std::atomic_load and
+      /// std::atomic_store
+      public: std::shared_ptr<const MetricsPlugins> plugins;
+
+      /// \brief Last plugin ID given out
+      public: std::size_t lastId{0u};
+
+      /// \brief Protects changes to plugins, and the server members below
+      public: std::mutex mutex;
+
+      /// \brief Socket listened on, -1 if not running
+      public: int listener{-1};
+
+      /// \brief Port listened on, 0 if not running
+      public: std::atomic<int> port{0};
+
+      /// \brief Set to stop the server thread
+      public: std::atomic<bool> stopping{false};
+
+      /// \brief Serves the requests
+      public: std::thread thread;
+    };
+  }
+}
+
+using namespace ignition;
+using namespace gui;
+
+/// \brief Upper bounds of the frame time histogram buckets, in seconds.
+/// The +Inf bucket is implicit.
+static const std::array<double, 10> kFrameBuckets{
+    {0.005, 0.010, 0.0167, 0.025, 0.0334, 0.050, 0.100, 0.250, 0.500, 1.0}};
+
+/// \brief Longest time between frames recorded in the histogram, longer
+/// ones mean the window was idle
+static const std::chrono::seconds kIdleGap{1};
+
+/// \brief Milliseconds the server waits for connections before checking
+/// whether it should stop
+static const int kPollInterval{200};
+
+/// \brief Longest request read, in bytes
+static const std::size_t kMaxRequest{8192u};
+
+/// \brief Names of the cost kinds, indexed by CostKind
+static const char *kCostKinds[] = {"transport", "event", "render"};
+
+/////////////////////////////////////////////////
+/// \brief Escape a label value.
+/// \param[in] _value Value
+/// \return Value with backslashes, quotes and new lines escaped
+static std::string EscapeLabel(const std::string &_value)
+{
+  std::string escaped;
+  escaped.reserve(_value.size());
+  for (auto c : _value)
+  {
+    if (c == '\\' || c == '"')
+    {
+      escaped += '\\';
+      escaped += c;
+    }
+    else if (c == '\n')
+    {
+      escaped += "\\n";
+    }
+    else
+    {
+      escaped += c;
+    }
+  }
+  return escaped;
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the memory the process holds in RAM.
+/// \return Bytes, 0 if unknown
+static std::uint64_t ResidentBytes()
+{
+#ifdef __linux__
+  std::ifstream statm("/proc/self/statm");
+  std::uint64_t size{0u};
+  std::uint64_t resident{0u};
+  if (statm >> size >> resident)
+    return resident * static_cast<std::uint64_t>(sysconf(_SC_PAGESIZE));
+#endif
+  return 0u;
+}
+
+/////////////////////////////////////////////////
+void MetricsPrivate::Serve()
+{
+#ifndef _WIN32
+  while (!this->stopping)
+  {
+    pollfd listening{this->listener, POLLIN, 0};
+    if (poll(&listening, 1, kPollInterval) <= 0)
+      continue;
+
+    int client = accept(this->listener, nullptr, nullptr);
+    if (client < 0)
+      continue;
+    this->Respond(client);
+    close(client);
+  }
+#endif
+}
+
+/////////////////////////////////////////////////
+void MetricsPrivate::Respond(const int _client) const
+{
+#ifndef _WIN32
+  // A slow or stuck scraper doesn't hold the server for long
+  timeval timeout{1, 0};
+  setsockopt(_client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  setsockopt(_client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+#ifdef SO_NOSIGPIPE
+  int noSigPipe{1};
+  setsockopt(_client, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe,
+      sizeof(noSigPipe));
+#endif
+
+  std::string request;
+  char buffer[1024];
+  while (request.find("\r\n\r\n") == std::string::npos &&
+      request.size() < kMaxRequest)
+  {
+    auto received = recv(_client, buffer, sizeof(buffer), 0);
+    if (received <= 0)
+      return;
+    request.append(buffer, static_cast<std::size_t>(received));
+  }
+
+  std::string status{"200 OK"};
+  std::string body;
+  std::string type;
+  auto lineEnd = request.find("\r\n");
+  std::istringstream line(request.substr(0, lineEnd));
+  std::string method;
+  std::string path;
+  line >> method >> path;
+  if (method != "GET")
+  {
+    status = "405 Method Not Allowed";
+  }
+  else if (path != "/metrics")
+  {
+    status = "404 Not Found";
+  }
+  else
+  {
+    // Scrapers ask for OpenMetrics in the Accept header
+    bool openMetrics =
+        request.find("application/openmetrics-text") != std::string::npos;
+    body = this->metrics->Text(openMetrics);
+    type = openMetrics ?
+        "application/openmetrics-text; version=1.0.0; charset=utf-8" :
+        "text/plain; version=0.0.4; charset=utf-8";
+  }
+
+  std::ostringstream response;
+  response << "HTTP/1.1 " << status << "\r\n";
+  if (!type.empty())
+    response << "Content-Type: " << type << "\r\n";
+  response << "Content-Length: " << body.size() << "\r\n"
+           << "Connection: close\r\n\r\n" << body;
+
+  auto data = response.str();
+  int flags{0};
+#ifdef MSG_NOSIGNAL
+  flags = MSG_NOSIGNAL;
+#endif
+  std::size_t sent{0u};
+  while (sent < data.size())
+  {
+    auto count = send(_client, data.data() + sent, data.size() - sent, flags);
+    if (count <= 0)
+      return;
+    sent += static_cast<std::size_t>(count);
+  }
+#else
+  (void)_client;
+#endif
+}
+
+/////////////////////////////////////////////////
+Metrics::Metrics()
+  : dataPtr(new MetricsPrivate)
+{
+  this->dataPtr->metrics = this;
+}
+
+/////////////////////////////////////////////////
+Metrics::~Metrics()
+{
+  this->Stop();
+}
+
+/////////////////////////////////////////////////
+Metrics &Metrics::Instance()
+{
+  static Metrics metrics;
+  return metrics;
+}
+
+/////////////////////////////////////////////////
+bool Metrics::Start(const int _port, const std::string &_address)
+{
+  this->Stop();
+
+#ifdef _WIN32
+  ignerr << "The metrics endpoint isn't available on Windows" << std::endl;
+  (void)_port;
+  (void)_address;
+  return false;
+#else
+  if (_port < 0 || _port > 65535)
+  {
+    ignerr << "Invalid metrics port [" << _port << "]" << std::endl;
+    return false;
+  }
+
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(static_cast<std::uint16_t>(_port));
+  if (inet_pton(AF_INET, _address.c_str(), &address.sin_addr) != 1)
+  {
+    ignerr << "Invalid metrics address [" << _address
+           << "], expected an IPv4 address" << std::endl;
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  int listener = socket(AF_INET, SOCK_STREAM, 0);
+  if (listener < 0)
+  {
+    ignerr << "Failed to create the metrics socket" << std::endl;
+    return false;
+  }
+
+  int reuse{1};
+  setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+  socklen_t length = sizeof(address);
+  if (bind(listener, reinterpret_cast<sockaddr *>(&address), length) != 0 ||
+      listen(listener, 16) != 0 ||
+      getsockname(listener, reinterpret_cast<sockaddr *>(&address),
+          &length) != 0)
+  {
+    ignerr << "Failed to listen for metrics on [" << _address << ":" << _port
+           << "]" << std::endl;
+    close(listener);
+    return false;
+  }
+
+  this->dataPtr->listener = listener;
+  this->dataPtr->port = ntohs(address.sin_port);
+  this->dataPtr->stopping = false;
+  this->dataPtr->thread = std::thread(&MetricsPrivate::Serve,
+      this->dataPtr.get());
+
+  ignmsg << "Serving metrics on [" << _address << ":"
+         << this->dataPtr->port << "]" << std::endl;
+  return true;
+#endif
+}
+
+/////////////////////////////////////////////////
+void Metrics::Stop()
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  if (!this->dataPtr->thread.joinable())
+    return;
+
+  this->dataPtr->stopping = true;
+  this->dataPtr->thread.join();
+#ifndef _WIN32
+  close(this->dataPtr->listener);
+#endif
+  this->dataPtr->listener = -1;
+  this->dataPtr->port = 0;
+}
+
+/////////////////////////////////////////////////
+bool Metrics::Enabled() const
+{
+  return this->dataPtr->port != 0;
+}
+
+/////////////////////////////////////////////////
+int Metrics::Port() const
+{
+  return this->dataPtr->port;
+}
+
+/////////////////////////////////////////////////
+void Metrics::Add(const MetricCounter _counter, const std::uint64_t _count)
+{
+  this->dataPtr->counters[static_cast<int>(_counter)].fetch_add(_count,
+      std::memory_order_relaxed);
+}
+
+/////////////////////////////////////////////////
+std::uint64_t Metrics::Count(const MetricCounter _counter) const
+{
+  return this->dataPtr->counters[static_cast<int>(_counter)];
+}
+
+/////////////////////////////////////////////////
+void Metrics::AddFrame(const Trace::Clock::time_point &_time)
+{
+  auto &d = this->dataPtr;
+  d->frames.fetch_add(1u, std::memory_order_relaxed);
+
+  auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      _time.time_since_epoch()).count();
+  auto last = d->lastFrame.exchange(now);
+  if (last == 0 || now <= last)
+    return;
+
+  auto interval = std::chrono::nanoseconds(now - last);
+  if (interval > kIdleGap)
+    return;
+
+  auto seconds = std::chrono::duration<double>(interval).count();
+  auto bucket = std::lower_bound(kFrameBuckets.begin(), kFrameBuckets.end(),
+      seconds) - kFrameBuckets.begin();
+  d->frameBuckets[std::min<std::size_t>(bucket, kFrameBuckets.size() - 1u)]
+      .fetch_add(1u, std::memory_order_relaxed);
+  d->frameTimes.fetch_add(1u, std::memory_order_relaxed);
+  d->frameNanoseconds.fetch_add(static_cast<std::uint64_t>(interval.count()),
+      std::memory_order_relaxed);
+}
+
+/////////////////////////////////////////////////
+std::uint64_t Metrics::FrameCount() const
+{
+  return this->dataPtr->frames;
+}
+
+/////////////////////////////////////////////////
+void Metrics::Track(const Plugin *_plugin, const std::string &_name)
+{
+  if (!_plugin)
+    return;
+
+  std::shared_ptr<const std::string> name =
+      std::make_shared<std::string>(_name);
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto plugins = std::make_shared<MetricsPlugins>();
+  if (auto current = std::atomic_load(&this->dataPtr->plugins))
+    *plugins = *current;
+
+  for (auto &plugin : *plugins)
+  {
+    if (plugin->plugin == _plugin)
+    {
+      std::atomic_store(&plugin->name, name);
+      return;
+    }
+  }
+
+  auto plugin = std::make_shared<MetricsPlugin>();
+  plugin->plugin = _plugin;
+  plugin->id = ++this->dataPtr->lastId;
+  plugin->name = name;
+  plugins->push_back(plugin);
+
+  std::shared_ptr<const MetricsPlugins> published = plugins;
+  std::atomic_store(&this->dataPtr->plugins, published);
+}
+
+/////////////////////////////////////////////////
+void Metrics::Forget(const Plugin *_plugin)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto current = std::atomic_load(&this->dataPtr->plugins);
+  if (!current)
+    return;
+
+  auto plugins = std::make_shared<MetricsPlugins>(*current);
+  plugins->erase(std::remove_if(plugins->begin(), plugins->end(),
+      [&_plugin](const std::shared_ptr<MetricsPlugin> &_tracked)
+      {
+        return _tracked->plugin == _plugin;
+      }), plugins->end());
+
+  std::shared_ptr<const MetricsPlugins> published = plugins;
+  std::atomic_store(&this->dataPtr->plugins, published);
+}
+
+/////////////////////////////////////////////////
+void Metrics::AddPluginCost(const Plugin *_plugin, const CostKind _kind,
+    const Trace::Clock::duration &_duration)
+{
+  if (!_plugin)
+    return;
+
+  auto plugins = std::atomic_load(&this->dataPtr->plugins);
+  if (!plugins)
+    return;
+
+  for (const auto &plugin : *plugins)
+  {
+    if (plugin->plugin != _plugin)
+      continue;
+
+    auto kind = static_cast<int>(_kind);
+    plugin->calls[kind].fetch_add(1u, std::memory_order_relaxed);
+    plugin->nanoseconds[kind].fetch_add(static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+        _duration).count()), std::memory_order_relaxed);
+    return;
+  }
+}
+
+/////////////////////////////////////////////////
+std::string Metrics::Text(const bool _openMetrics) const
+{
+  auto &d = this->dataPtr;
+
+  std::ostringstream out;
+  out.imbue(std::locale::classic());
+  out << std::setprecision(9);
+
+  // OpenMetrics names counter families without the _total of their samples
+  auto counter = [&](const std::string &_name, const std::string &_help,
+      const std::uint64_t _value)
+  {
+    auto family = _openMetrics ? _name : _name + "_total";
+    out << "# HELP " << family << " " << _help << "\n"
+        << "# TYPE " << family << " counter\n"
+        << _name << "_total " << _value << "\n";
+  };
+
+  counter("ign_gui_frames", "Frames shown by the main window.", d->frames);
+
+  out << "# HELP ign_gui_frame_seconds Time between frames of the main "
+      << "window, idle gaps excluded.\n"
+      << "# TYPE ign_gui_frame_seconds histogram\n";
+  std::uint64_t cumulative{0u};
+  for (std::size_t i = 0u; i < kFrameBuckets.size(); ++i)
+  {
+    cumulative += d->frameBuckets[i];
+    out << "ign_gui_frame_seconds_bucket{le=\"" << kFrameBuckets[i] << "\"} "
+        << cumulative << "\n";
+  }
+  out << "ign_gui_frame_seconds_bucket{le=\"+Inf\"} " << cumulative << "\n"
+      << "ign_gui_frame_seconds_sum "
+      << d->frameNanoseconds.load() * 1e-9 << "\n"
+      << "ign_gui_frame_seconds_count " << cumulative << "\n";
+
+  counter("ign_gui_stalls", "GUI thread stalls reported by the watchdog.",
+      this->Count(MetricCounter::kStalls));
+  counter("ign_gui_dropped_images", "Images received but never shown.",
+      this->Count(MetricCounter::kDroppedImages));
+  counter("ign_gui_plot_points", "Points added to plots.",
+      this->Count(MetricCounter::kPlotPoints));
+
+  if (auto plugins = std::atomic_load(&d->plugins))
+  {
+    out << "# HELP ign_gui_plugin_seconds Time plugins spent in transport "
+        << "callbacks, events and render hooks.\n"
+        << "# TYPE ign_gui_plugin_seconds summary\n";
+    for (const auto &plugin : *plugins)
+    {
+      auto name = std::atomic_load(&plugin->name);
+      for (int kind = 0; kind < 3; ++kind)
+      {
+        std::ostringstream labels;
+        labels << "{plugin=\"" << EscapeLabel(*name) << "\",id=\""
+               << plugin->id << "\",kind=\"" << kCostKinds[kind] << "\"}";
+        out << "ign_gui_plugin_seconds_sum" << labels.str() << " "
+            << plugin->nanoseconds[kind].load() * 1e-9 << "\n"
+            << "ign_gui_plugin_seconds_count" << labels.str() << " "
+            << plugin->calls[kind] << "\n";
+      }
+    }
+  }
+
+  if (auto resident = ResidentBytes())
+  {
+    out << "# HELP ign_gui_resident_memory_bytes Memory of the process "
+        << "held in RAM.\n"
+        << "# TYPE ign_gui_resident_memory_bytes gauge\n"
+        << "ign_gui_resident_memory_bytes " << resident << "\n";
+  }
+
+  if (_openMetrics)
+    out << "# EOF\n";
+  return out.str();
+}
@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <chrono>
+#include <string>
+
+#include <ignition/common/Console.hh>
+#include <ignition/utilities/ExtraTestMacros.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+#include "ignition/gui/Metrics.hh"
+
+using namespace ignition;
+using namespace gui;
+
+/////////////////////////////////////////////////
+/// \brief Send a request to the metrics endpoint.
+/// \param[in] _port Port
+/// \param[in] _request HTTP request
+/// \return Response, empty if it couldn't connect
+std::string Get(const int _port, const std::string &_request)
+{
+  std::string response;
+#ifndef _WIN32
+  int client = socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(static_cast<std::uint16_t>(_port));
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (connect(client, reinterpret_cast<sockaddr *>(&address),
+      sizeof(address)) == 0)
+  {
+    send(client, _request.data(), _request.size(), 0);
+    char buffer[4096];
+    ssize_t received;
+    while ((received = recv(client, buffer, sizeof(buffer), 0)) > 0)
+      response.append(buffer, static_cast<std::size_t>(received));
+  }
+  close(client);
+#endif
+  return response;
+}
+
+/////////////////////////////////////////////////
+TEST(MetricsTest, Text)
+{
+  common::Console::SetVerbosity(4);
+
+  Metrics metrics;
+  EXPECT_FALSE(metrics.Enabled());
+  EXPECT_EQ(0, metrics.Port());
+
+  metrics.Add(MetricCounter::kPlotPoints, 40u);
+  metrics.Add(MetricCounter::kPlotPoints, 2u);
+  metrics.Add(MetricCounter::kDroppedImages);
+  EXPECT_EQ(42u, metrics.Count(MetricCounter::kPlotPoints));
+  EXPECT_EQ(1u, metrics.Count(MetricCounter::kDroppedImages));
+  EXPECT_EQ(0u, metrics.Count(MetricCounter::kStalls));
+
+  // Idle gaps are counted as frames, but not as frame times
+  auto start = Trace::Clock::now();
+  metrics.AddFrame(start);
+  metrics.AddFrame(start + std::chrono::milliseconds(16));
+  metrics.AddFrame(start + std::chrono::seconds(5));
+  EXPECT_EQ(3u, metrics.FrameCount());
+
+  // Plugins are only told apart by address
+  auto plugin = reinterpret_cast<const Plugin *>(&metrics);
+  metrics.Track(plugin, "Image \"display\"");
+  metrics.AddPluginCost(plugin, CostKind::kTransport,
+      std::chrono::milliseconds(3));
+  metrics.AddPluginCost(nullptr, CostKind::kTransport,
+      std::chrono::milliseconds(3));
+
+  auto text = metrics.Text(false);
+  EXPECT_NE(std::string::npos, text.find(
+      "# TYPE ign_gui_plot_points_total counter\n"
+      "ign_gui_plot_points_total 42\n"));
+  EXPECT_NE(std::string::npos, text.find("ign_gui_frames_total 3\n"));
+  EXPECT_NE(std::string::npos, text.find(
+      "ign_gui_frame_seconds_bucket{le=\"0.01\"} 0\n"));
+  EXPECT_NE(std::string::npos, text.find(
+      "ign_gui_frame_seconds_bucket{le=\"0.0167\"} 1\n"));
+  EXPECT_NE(std::string::npos, text.find(
+      "ign_gui_frame_seconds_count 1\n"));
+  EXPECT_NE(std::string::npos, text.find(
+      "ign_gui_plugin_seconds_count{plugin=\"Image \\\"display\\\"\","
+      "id=\"1\",kind=\"transport\"} 1\n"));
+  EXPECT_EQ(std::string::npos, text.find("# EOF"));
+
+  // OpenMetrics names counter families without _total, and ends with EOF
+  text = metrics.Text(true);
+  EXPECT_NE(std::string::npos, text.find(
+      "# TYPE ign_gui_plot_points counter\n"
+      "ign_gui_plot_points_total 42\n"));
+  EXPECT_EQ(text.size() - 6u, text.rfind("# EOF\n"));
+
+  // Renamed plugins keep their times
+  metrics.Track(plugin, "Renamed");
+  text = metrics.Text(false);
+  EXPECT_NE(std::string::npos, text.find(
+      "ign_gui_plugin_seconds_count{plugin=\"Renamed\",id=\"1\","
+      "kind=\"transport\"} 1\n"));
+
+  metrics.Forget(plugin);
+  text = metrics.Text(false);
+  EXPECT_EQ(std::string::npos, text.find("Renamed"));
+}
+
+/////////////////////////////////////////////////
+TEST(MetricsTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(Endpoint))
+{
+  common::Console::SetVerbosity(4);
+
+  Metrics metrics;
+  EXPECT_FALSE(metrics.Start(-1));
+  EXPECT_FALSE(metrics.Enabled());
+  EXPECT_FALSE(metrics.Start(0, "localhost"));
+  EXPECT_FALSE(metrics.Enabled());
+
+  // All network interfaces
+  ASSERT_TRUE(metrics.Start(0, "0.0.0.0"));
+  EXPECT_GT(metrics.Port(), 0);
+  EXPECT_EQ(0u, Get(metrics.Port(), "GET /metrics HTTP/1.0\r\n\r\n").find(
+      "HTTP/1.1 200 OK\r\n"));
+
+  // Loopback by default
+
+  ASSERT_TRUE(metrics.Start(0));
+  EXPECT_TRUE(metrics.Enabled());
+  auto port = metrics.Port();
+  EXPECT_GT(port, 0);
+
+  // The port is taken
+  Metrics other;
+  EXPECT_FALSE(other.Start(port));
+
+  // Scrapers asking for OpenMetrics get it, others get Prometheus text
+  auto response = Get(port, "GET /metrics HTTP/1.1\r\n"
+      "Accept: application/openmetrics-text; version=1.0.0\r\n\r\n");
+  EXPECT_EQ(0u, response.find("HTTP/1.1 200 OK\r\n"));
+  EXPECT_NE(std::string::npos, response.find(
+      "Content-Type: application/openmetrics-text"));
+  EXPECT_NE(std::string::npos, response.find("# EOF\n"));
+
+  response = Get(port, "GET /metrics HTTP/1.0\r\n\r\n");
+  EXPECT_EQ(0u, response.find("HTTP/1.1 200 OK\r\n"));
+  EXPECT_NE(std::string::npos, response.find("Content-Type: text/plain"));
+  EXPECT_NE(std::string::npos, response.find("ign_gui_frames_total"));
+
+  EXPECT_EQ(0u, Get(port, "GET / HTTP/1.1\r\n\r\n").find(
+      "HTTP/1.1 404 Not Found\r\n"));
+  EXPECT_EQ(0u, Get(port, "POST /metrics HTTP/1.1\r\n\r\n").find(
+      "HTTP/1.1 405 Method Not Allowed\r\n"));
+
+  metrics.Stop();
+  EXPECT_FALSE(metrics.Enabled());
+  EXPECT_EQ(0, metrics.Port());
+  EXPECT_TRUE(Get(port, "GET /metrics HTTP/1.1\r\n\r\n").empty());
+}
@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <map>
+#include <mutex>
+#include <set>
+
+#include <ignition/msgs/Factory.hh>
+
+#include "ignition/gui/MsgSchema.hh"
+
+namespace ignition
+{
+  namespace gui
+  {
+    class MsgSchemaPrivate
+    {
+      /// \brief Add the plottable fields of a message type.
+      /// \param[in] _descriptor Message type
+      /// \param[in] _path Path of the message, empty for the top one
+      /// \param[in] _expanding Types being gone through, so types which
+      /// contain themselves are only gone through once
+      public: void AddPlottable(
+          const google::protobuf::Descriptor *_descriptor,
+          const std::string &_path,
+          std::set<const google::protobuf::Descriptor *> &_expanding);
+
+      /// \brief Default instance, also used to create new messages
+      public: std::unique_ptr<google::protobuf::Message> prototype;
+
+      /// \brief Paths of the fields which can be plotted
+      public: std::vector<std::string> plottable;
+    };
+  }
+}
+
+using namespace ignition;
+using namespace gui;
+
+/// \brief Schemas created so far, by the type names they were asked for.
+/// Null for unknown types, so they're only looked for once.
+static std::map<std::string, std::shared_ptr<const MsgSchema>> g_schemas;
+
+/// \brief Protects g_schemas
+static std::mutex g_schemasMutex;
+
+/////////////////////////////////////////////////
+void MsgSchemaPrivate::AddPlottable(
+    const google::protobuf::Descriptor *_descriptor,
+    const std::string &_path,
+    std::set<const google::protobuf::Descriptor *> &_expanding)
+{
+  using google::protobuf::FieldDescriptor;
+
+  _expanding.insert(_descriptor);
+  for (int i = 0; i < _descriptor->field_count(); ++i)
+  {
+    auto field = _descriptor->field(i);
+    if (field->is_repeated())
+      continue;
+
+    auto path = _path.empty() ? field->name() : _path + "-" + field->name();
+    // The types the plotting interface reads
+    switch (field->type())
+    {
+      case FieldDescriptor::TYPE_MESSAGE:
+        if (!_expanding.count(field->message_type()))
+          this->AddPlottable(field->message_type(), path, _expanding);
+        break;
+      case FieldDescriptor::TYPE_DOUBLE:
+      case FieldDescriptor::TYPE_FLOAT:
+      case FieldDescriptor::TYPE_INT32:
+      case FieldDescriptor::TYPE_INT64:
+      case FieldDescriptor::TYPE_UINT32:
+      case FieldDescriptor::TYPE_UINT64:
+      case FieldDescriptor::TYPE_BOOL:
+        this->plottable.push_back(path);
+        break;
+      default:
+        break;
+    }
+  }
+  _expanding.erase(_descriptor);
+}
+
+/////////////////////////////////////////////////
+MsgSchema::MsgSchema(std::unique_ptr<google::protobuf::Message> _prototype)
+  : dataPtr(new MsgSchemaPrivate)
+{
+  this->dataPtr->prototype = std::move(_prototype);
+
+  std::set<const google::protobuf::Descriptor *> expanding;
+  this->dataPtr->AddPlottable(this->Descriptor(), "", expanding);
+}
+
+/////////////////////////////////////////////////
+MsgSchema::~MsgSchema()
+{
+}
+
+/////////////////////////////////////////////////
+std::shared_ptr<const MsgSchema> MsgSchema::Find(const std::string &_msgType)
+{
+  std::lock_guard<std::mutex> lock(g_schemasMutex);
+
+  auto cached = g_schemas.find(_msgType);
+  if (cached != g_schemas.end())
+    return cached->second;
+
+  std::shared_ptr<const MsgSchema> schema;
+  auto msg = msgs::Factory::New(_msgType);
+  if (msg && msg->GetDescriptor())
+  {
+    // The same type may have been asked for with another name, such as
+    // "Pose" and "ignition.msgs.Pose"
+    auto name = msg->GetDescriptor()->full_name();
+    auto same = g_schemas.find(name);
+    if (same != g_schemas.end() && same->second)
+    {
+      schema = same->second;
+    }
+    else
+    {
+      schema.reset(new MsgSchema(std::unique_ptr<google::protobuf::Message>(
+          msg.release())));
+      g_schemas[name] = schema;
+    }
+  }
+
+  g_schemas[_msgType] = schema;
+  return schema;
+}
+
+/////////////////////////////////////////////////
+const std::string &MsgSchema::Name() const
+{
+  return this->Descriptor()->full_name();
+}
+
+/////////////////////////////////////////////////
+const google::protobuf::Descriptor *MsgSchema::Descriptor() const
+{
+  return this->dataPtr->prototype->GetDescriptor();
+}
+
+/////////////////////////////////////////////////
+const google::protobuf::Message &MsgSchema::DefaultInstance() const
+{
+  return *this->dataPtr->prototype;
+}
+
+/////////////////////////////////////////////////
+std::unique_ptr<google::protobuf::Message> MsgSchema::New() const
+{
+  return std::unique_ptr<google::protobuf::Message>(
+      this->dataPtr->prototype->New());
+}
+
+/////////////////////////////////////////////////
+const std::vector<std::string> &MsgSchema::PlottableFields() const
+{
+  return this->dataPtr->plottable;
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include <ignition/msgs/collision.pb.h>
+#include <ignition/msgs/pose.pb.h>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/gui/MsgSchema.hh"
+
+using namespace ignition;
+using namespace gui;
+
+/////////////////////////////////////////////////
+TEST(MsgSchemaTest, Find)
+{
+  EXPECT_EQ(nullptr, MsgSchema::Find("banana.message"));
+  EXPECT_EQ(nullptr, MsgSchema::Find(""));
+
+  auto schema = MsgSchema::Find("ignition.msgs.Pose");
+  ASSERT_NE(nullptr, schema);
+  EXPECT_EQ("ignition.msgs.Pose", schema->Name());
+  EXPECT_EQ(msgs::Pose::descriptor(), schema->Descriptor());
+
+  // Created once, whatever the name used
+  EXPECT_EQ(schema, MsgSchema::Find("ignition.msgs.Pose"));
+  EXPECT_EQ(schema, MsgSchema::Find("Pose"));
+
+  // New messages have default values
+  auto msg = schema->New();
+  ASSERT_NE(nullptr, msg);
+  EXPECT_EQ(schema->Descriptor(), msg->GetDescriptor());
+  EXPECT_EQ("", msg->DebugString());
+  EXPECT_NE(msg.get(), &schema->DefaultInstance());
+  EXPECT_EQ(schema->Descriptor(), schema->DefaultInstance().GetDescriptor());
+}
+
+/////////////////////////////////////////////////
+TEST(MsgSchemaTest, PlottableFields)
+{
+  auto schema = MsgSchema::Find("ignition.msgs.Collision");
+  ASSERT_NE(nullptr, schema);
+
+  const auto &fields = schema->PlottableFields();
+  auto has = [&fields](const std::string &_path)
+  {
+    return std::find(fields.begin(), fields.end(), _path) != fields.end();
+  };
+
+  EXPECT_TRUE(has("id"));
+  EXPECT_TRUE(has("pose-position-x"));
+  EXPECT_TRUE(has("pose-orientation-w"));
+  EXPECT_TRUE(has("header-stamp-sec"));
+
+  // Strings and messages can't be plotted
+  EXPECT_FALSE(has("name"));
+  EXPECT_FALSE(has("pose"));
+  EXPECT_FALSE(has("pose-name"));
+}
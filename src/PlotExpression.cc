@@ -0,0 +1,760 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <limits>
+#include <locale>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/gui/PlotExpression.hh"
+
+namespace ignition
+{
+  namespace gui
+  {
+    /// \brief Operations of the stack machine
+    enum class PlotOp
+    {
+      /// \brief Push a constant
+      CONSTANT,
+
+      /// \brief Push the value of an input
+      INPUT,
+
+      /// \brief Binary operators, popping two values and pushing one
+      ADD, SUB, MUL, DIV, POW, ATAN2, MIN, MAX,
+
+      /// \brief Unary operators, replacing the top of the stack
+      NEG, ABS, SQRT, EXP, LOG, SIN, COS, TAN,
+
+      /// \brief Filters, replacing the top of the stack and keeping a state
+      EMA, DERIVATIVE, INTEGRAL
+    };
+
+    /// \brief An instruction of the stack machine
+    struct PlotInstruction
+    {
+      /// \brief Operation
+      PlotOp op;
+
+      /// \brief Constant, or smoothing factor of an EMA
+      double value{0.0};
+
+      /// \brief Input index, or filter state index
+      std::size_t index{0u};
+    };
+
+    /// \brief State kept by a filter between samples
+    struct PlotFilterState
+    {
+      /// \brief Whether a sample was seen since the last reset
+      bool started{false};
+
+      /// \brief X coordinate of the last sample
+      double x{0.0};
+
+      /// \brief Input of the last sample
+      double input{0.0};
+
+      /// \brief Output of the last sample
+      double output{std::numeric_limits<double>::quiet_NaN()};
+    };
+
+    /// \brief A function which can be called from expressions
+    struct PlotFunction
+    {
+      /// \brief Name in expressions
+      const char *name;
+
+      /// \brief Operation
+      PlotOp op;
+
+      /// \brief Number of arguments
+      int arity;
+    };
+
+    /// \brief Functions which can be called from expressions
+    static const PlotFunction kPlotFunctions[] = {
+      {"abs", PlotOp::ABS, 1},
+      {"sqrt", PlotOp::SQRT, 1},
+      {"exp", PlotOp::EXP, 1},
+      {"log", PlotOp::LOG, 1},
+      {"sin", PlotOp::SIN, 1},
+      {"cos", PlotOp::COS, 1},
+      {"tan", PlotOp::TAN, 1},
+      {"atan2", PlotOp::ATAN2, 2},
+      {"min", PlotOp::MIN, 2},
+      {"max", PlotOp::MAX, 2},
+      {"ema", PlotOp::EMA, 2},
+      {"derivative", PlotOp::DERIVATIVE, 1},
+      {"integral", PlotOp::INTEGRAL, 1},
+    };
+
+    /// \brief Recursive descent parser emitting instructions in postfix
+    /// order.
+    class PlotParser
+    {
+      /// \brief Constructor
+      /// \param[in] _text Expression
+      public: explicit PlotParser(const std::string &_text)
+        : text(_text)
+      {
+      }
+
+      /// \brief Parse the whole expression.
+      /// \return False on error, see error
+      public: bool Parse();
+
+      /// \brief expression := term (('+' | '-') term)*
+      /// \return False on error
+      private: bool Expression();
+
+      /// \brief term := unary (('*' | '/') unary)*
+      /// \return False on error
+      private: bool Term();
+
+      /// \brief unary := '-' unary | power
+      /// \return False on error
+      private: bool Unary();
+
+      /// \brief power := primary ('^' unary)?
+      /// \return False on error
+      private: bool Power();
+
+      /// \brief primary := number | '{' series '}' | name |
+      /// function '(' arguments ')' | '(' expression ')'
+      /// \return False on error
+      private: bool Primary();
+
+      /// \brief Parse a function call, after its name.
+      /// \param[in] _function Function
+      /// \return False on error
+      private: bool Call(const PlotFunction &_function);
+
+      /// \brief Parse a number.
+      /// \param[out] _value Number
+      /// \return False if there's no number
+      private: bool Number(double &_value);
+
+      /// \brief Skip spaces and check the next character.
+      /// \param[in] _c Character
+      /// \return True if it's the next one, which is then skipped
+      private: bool Accept(char _c);
+
+      /// \brief Skip spaces.
+      /// \return Next character, zero at the end
+      private: char Peek();
+
+      /// \brief Add an instruction.
+      /// \param[in] _op Operation
+      /// \param[in] _value Constant
+      /// \param[in] _index Input or filter state index
+      private: void Emit(PlotOp _op, double _value = 0.0,
+                         std::size_t _index = 0u);
+
+      /// \brief Record an error at the current position.
+      /// \param[in] _error What's wrong
+      /// \return False
+      private: bool Fail(const std::string &_error);
+
+      /// \brief Expression
+      public: const std::string &text;
+
+      /// \brief Position in the text
+      public: std::size_t pos{0u};
+
+      /// \brief Instructions, in postfix order
+      public: std::vector<PlotInstruction> program;
+
+      /// \brief Inputs, in the order of their first appearance
+      public: std::vector<std::string> inputs;
+
+      /// \brief Number of filter states used
+      public: std::size_t filters{0u};
+
+      /// \brief Deepest the stack gets
+      public: std::size_t maxDepth{0u};
+
+      /// \brief Depth of the stack after the instructions so far
+      public: std::size_t depth{0u};
+
+      /// \brief First error
+      public: std::string error;
+    };
+
+    class PlotExpressionPrivate
+    {
+      /// \brief Expression text
+      public: std::string text;
+
+      /// \brief Instructions, in postfix order
+      public: std::vector<PlotInstruction> program;
+
+      /// \brief Inputs read by the expression
+      public: std::vector<std::string> inputs;
+
+      /// \brief Filter states
+      public: std::vector<PlotFilterState> filters;
+
+      /// \brief Stack, sized for the deepest it gets so it's never
+      /// reallocated
+      public: std::vector<double> stack;
+    };
+  }
+}
+
+using namespace ignition;
+using namespace gui;
+
+/////////////////////////////////////////////////
+bool PlotParser::Parse()
+{
+  if (!this->Expression())
+    return false;
+
+  if (this->Peek() != '\0')
+    return this->Fail("unexpected character");
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool PlotParser::Expression()
+{
+  if (!this->Term())
+    return false;
+
+  while (true)
+  {
+    if (this->Accept('+'))
+    {
+      if (!this->Term())
+        return false;
+      this->Emit(PlotOp::ADD);
+    }
+    else if (this->Accept('-'))
+    {
+      if (!this->Term())
+        return false;
+      this->Emit(PlotOp::SUB);
+    }
+    else
+    {
+      return true;
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+bool PlotParser::Term()
+{
+  if (!this->Unary())
+    return false;
+
+  while (true)
+  {
+    if (this->Accept('*'))
+    {
+      if (!this->Unary())
+        return false;
+      this->Emit(PlotOp::MUL);
+    }
+    else if (this->Accept('/'))
+    {
+      if (!this->Unary())
+        return false;
+      this->Emit(PlotOp::DIV);
+    }
+    else
+    {
+      return true;
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+bool PlotParser::Unary()
+{
+  if (this->Accept('-'))
+  {
+    if (!this->Unary())
+      return false;
+    this->Emit(PlotOp::NEG);
+    return true;
+  }
+  return this->Power();
+}
+
+/////////////////////////////////////////////////
+bool PlotParser::Power()
+{
+  if (!this->Primary())
+    return false;
+
+  // right associative, and binding tighter than a unary minus on its left
+  if (this->Accept('^'))
+  {
+    if (!this->Unary())
+      return false;
+    this->Emit(PlotOp::POW);
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool PlotParser::Primary()
+{
+  char c = this->Peek();
+  if (c == '\0')
+    return this->Fail("unexpected end");
+
+  if (this->Accept('('))
+  {
+    if (!this->Expression())
+      return false;
+    if (!this->Accept(')'))
+      return this->Fail("expected ')'");
+    return true;
+  }
+
+  if (this->Accept('{'))
+  {
+    auto end = this->text.find('}', this->pos);
+    if (end == std::string::npos)
+      return this->Fail("expected '}'");
+
+    auto id = this->text.substr(this->pos, end - this->pos);
+    if (id.empty())
+      return this->Fail("empty series");
+    this->pos = end + 1;
+
+    auto inputIt = std::find(this->inputs.begin(), this->inputs.end(), id);
+    auto index = static_cast<std::size_t>(inputIt - this->inputs.begin());
+    if (inputIt == this->inputs.end())
+      this->inputs.push_back(id);
+
+    this->Emit(PlotOp::INPUT, 0.0, index);
+    return true;
+  }
+
+  double value;
+  if (this->Number(value))
+  {
+    this->Emit(PlotOp::CONSTANT, value);
+    return true;
+  }
+
+  if (!std::isalpha(static_cast<unsigned char>(c)))
+    return this->Fail("unexpected character");
+
+  auto start = this->pos;
+  while (this->pos < this->text.size() &&
+         (std::isalnum(static_cast<unsigned char>(this->text[this->pos])) ||
+          this->text[this->pos] == '_'))
+  {
+    ++this->pos;
+  }
+  auto name = this->text.substr(start, this->pos - start);
+
+  if (name == "pi")
+  {
+    this->Emit(PlotOp::CONSTANT, std::acos(-1.0));
+    return true;
+  }
+  if (name == "e")
+  {
+    this->Emit(PlotOp::CONSTANT, std::exp(1.0));
+    return true;
+  }
+
+  for (const auto &function : kPlotFunctions)
+  {
+    if (name == function.name)
+      return this->Call(function);
+  }
+
+  this->pos = start;
+  return this->Fail("unknown name [" + name + "]");
+}
+
+/////////////////////////////////////////////////
+bool PlotParser::Call(const PlotFunction &_function)
+{
+  if (!this->Accept('('))
+    return this->Fail("expected '('");
+
+  if (!this->Expression())
+    return false;
+
+  if (_function.op == PlotOp::EMA)
+  {
+    // the smoothing factor is part of the filter, not a value
+    double alpha;
+    if (!this->Accept(',') || !this->Number(alpha))
+      return this->Fail("expected a constant smoothing factor");
+    if (alpha <= 0.0 || alpha > 1.0)
+      return this->Fail("smoothing factor isn't in (0, 1]");
+    if (!this->Accept(')'))
+      return this->Fail("expected ')'");
+
+    this->Emit(PlotOp::EMA, alpha, this->filters++);
+    return true;
+  }
+
+  for (int i = 1; i < _function.arity; ++i)
+  {
+    if (!this->Accept(','))
+      return this->Fail("expected ','");
+    if (!this->Expression())
+      return false;
+  }
+
+  if (!this->Accept(')'))
+    return this->Fail("expected ')'");
+
+  if (_function.op == PlotOp::DERIVATIVE || _function.op == PlotOp::INTEGRAL)
+    this->Emit(_function.op, 0.0, this->filters++);
+  else
+    this->Emit(_function.op);
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool PlotParser::Number(double &_value)
+{
+  char c = this->Peek();
+  if (!std::isdigit(static_cast<unsigned char>(c)) && c != '.')
+    return false;
+
+  // digits, fraction and exponent
+  auto isDigit = [this](std::size_t _pos)
+  {
+    return _pos < this->text.size() &&
+        std::isdigit(static_cast<unsigned char>(this->text[_pos]));
+  };
+  auto end = this->pos;
+  while (isDigit(end))
+    ++end;
+  if (end < this->text.size() && this->text[end] == '.')
+  {
+    ++end;
+    while (isDigit(end))
+      ++end;
+  }
+  if (end < this->text.size() &&
+      (this->text[end] == 'e' || this->text[end] == 'E'))
+  {
+    auto exponent = end + 1;
+    if (exponent < this->text.size() &&
+        (this->text[exponent] == '+' || this->text[exponent] == '-'))
+    {
+      ++exponent;
+    }
+    if (isDigit(exponent))
+    {
+      end = exponent;
+      while (isDigit(end))
+        ++end;
+    }
+  }
+
+  // not strtod, which would follow the locale set by the application
+  std::istringstream stream(this->text.substr(this->pos, end - this->pos));
+  stream.imbue(std::locale::classic());
+  if (!(stream >> _value))
+    return false;
+
+  this->pos = end;
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool PlotParser::Accept(char _c)
+{
+  if (this->Peek() != _c)
+    return false;
+
+  ++this->pos;
+  return true;
+}
+
+/////////////////////////////////////////////////
+char PlotParser::Peek()
+{
+  while (this->pos < this->text.size() &&
+         std::isspace(static_cast<unsigned char>(this->text[this->pos])))
+  {
+    ++this->pos;
+  }
+  return this->pos < this->text.size() ? this->text[this->pos] : '\0';
+}
+
+/////////////////////////////////////////////////
+void PlotParser::Emit(PlotOp _op, double _value, std::size_t _index)
+{
+  PlotInstruction instruction;
+  instruction.op = _op;
+  instruction.value = _value;
+  instruction.index = _index;
+  this->program.push_back(instruction);
+
+  switch (_op)
+  {
+    case PlotOp::CONSTANT:
+    case PlotOp::INPUT:
+      ++this->depth;
+      break;
+    case PlotOp::ADD:
+    case PlotOp::SUB:
+    case PlotOp::MUL:
+    case PlotOp::DIV:
+    case PlotOp::POW:
+    case PlotOp::ATAN2:
+    case PlotOp::MIN:
+    case PlotOp::MAX:
+      --this->depth;
+      break;
+    default:
+      break;
+  }
+  this->maxDepth = std::max(this->maxDepth, this->depth);
+}
+
+/////////////////////////////////////////////////
+bool PlotParser::Fail(const std::string &_error)
+{
+  if (this->error.empty())
+  {
+    this->error = _error + " at character " + std::to_string(this->pos + 1);
+  }
+  return false;
+}
+
+/////////////////////////////////////////////////
+PlotExpression::PlotExpression()
+  : dataPtr(new PlotExpressionPrivate)
+{
+}
+
+/////////////////////////////////////////////////
+PlotExpression::PlotExpression(const PlotExpression &_other)
+  : dataPtr(new PlotExpressionPrivate(*_other.dataPtr))
+{
+}
+
+/////////////////////////////////////////////////
+PlotExpression::~PlotExpression() = default;
+
+/////////////////////////////////////////////////
+PlotExpression &PlotExpression::operator=(const PlotExpression &_other)
+{
+  if (this != &_other)
+    *this->dataPtr = *_other.dataPtr;
+  return *this;
+}
+
+/////////////////////////////////////////////////
+bool PlotExpression::Compile(const std::string &_text)
+{
+  PlotParser parser(_text);
+  if (!parser.Parse())
+  {
+    ignerr << "Invalid plot expression [" << _text << "]: " << parser.error
+           << std::endl;
+    return false;
+  }
+
+  this->dataPtr->text = _text;
+  this->dataPtr->program = std::move(parser.program);
+  this->dataPtr->inputs = std::move(parser.inputs);
+  this->dataPtr->filters.assign(parser.filters, PlotFilterState());
+  this->dataPtr->stack.assign(parser.maxDepth, 0.0);
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool PlotExpression::Valid() const
+{
+  return !this->dataPtr->program.empty();
+}
+
+/////////////////////////////////////////////////
+const std::string &PlotExpression::Text() const
+{
+  return this->dataPtr->text;
+}
+
+/////////////////////////////////////////////////
+const std::vector<std::string> &PlotExpression::Inputs() const
+{
+  return this->dataPtr->inputs;
+}
+
+/////////////////////////////////////////////////
+bool PlotExpression::Evaluate(double _x, const std::vector<double> &_inputs,
+                              double &_y)
+{
+  if (!this->Valid() || _inputs.size() < this->dataPtr->inputs.size())
+    return false;
+
+  // the program was checked when compiled, so the stack can't overflow or
+  // underflow
+  double *stack = this->dataPtr->stack.data();
+  std::size_t top = 0u;
+  for (const auto &instruction : this->dataPtr->program)
+  {
+    switch (instruction.op)
+    {
+      case PlotOp::CONSTANT:
+        stack[top++] = instruction.value;
+        break;
+      case PlotOp::INPUT:
+        stack[top++] = _inputs[instruction.index];
+        break;
+      case PlotOp::ADD:
+        --top;
+        stack[top - 1] += stack[top];
+        break;
+      case PlotOp::SUB:
+        --top;
+        stack[top - 1] -= stack[top];
+        break;
+      case PlotOp::MUL:
+        --top;
+        stack[top - 1] *= stack[top];
+        break;
+      case PlotOp::DIV:
+        --top;
+        stack[top - 1] /= stack[top];
+        break;
+      case PlotOp::POW:
+        --top;
+        stack[top - 1] = std::pow(stack[top - 1], stack[top]);
+        break;
+      case PlotOp::ATAN2:
+        --top;
+        stack[top - 1] = std::atan2(stack[top - 1], stack[top]);
+        break;
+      case PlotOp::MIN:
+        --top;
+        stack[top - 1] = std::min(stack[top - 1], stack[top]);
+        break;
+      case PlotOp::MAX:
+        --top;
+        stack[top - 1] = std::max(stack[top - 1], stack[top]);
+        break;
+      case PlotOp::NEG:
+        stack[top - 1] = -stack[top - 1];
+        break;
+      case PlotOp::ABS:
+        stack[top - 1] = std::abs(stack[top - 1]);
+        break;
+      case PlotOp::SQRT:
+        stack[top - 1] = std::sqrt(stack[top - 1]);
+        break;
+      case PlotOp::EXP:
+        stack[top - 1] = std::exp(stack[top - 1]);
+        break;
+      case PlotOp::LOG:
+        stack[top - 1] = std::log(stack[top - 1]);
+        break;
+      case PlotOp::SIN:
+        stack[top - 1] = std::sin(stack[top - 1]);
+        break;
+      case PlotOp::COS:
+        stack[top - 1] = std::cos(stack[top - 1]);
+        break;
+      case PlotOp::TAN:
+        stack[top - 1] = std::tan(stack[top - 1]);
+        break;
+      case PlotOp::EMA:
+      {
+        auto &state = this->dataPtr->filters[instruction.index];
+        double input = stack[top - 1];
+        if (!state.started)
+        {
+          state.started = true;
+          state.output = input;
+        }
+        else
+        {
+          state.output += instruction.value * (input - state.output);
+        }
+        stack[top - 1] = state.output;
+        break;
+      }
+      case PlotOp::DERIVATIVE:
+      {
+        // a sample at the same x keeps the last value, going back in x
+        // starts over
+        auto &state = this->dataPtr->filters[instruction.index];
+        double input = stack[top - 1];
+        if (!state.started || _x < state.x)
+        {
+          state.started = true;
+          state.output = std::numeric_limits<double>::quiet_NaN();
+          state.x = _x;
+          state.input = input;
+        }
+        else if (_x > state.x)
+        {
+          state.output = (input - state.input) / (_x - state.x);
+          state.x = _x;
+          state.input = input;
+        }
+        stack[top - 1] = state.output;
+        break;
+      }
+      case PlotOp::INTEGRAL:
+      {
+        auto &state = this->dataPtr->filters[instruction.index];
+        double input = stack[top - 1];
+        if (!state.started || _x < state.x)
+        {
+          state.started = true;
+          state.output = 0.0;
+          state.x = _x;
+          state.input = input;
+        }
+        else if (_x > state.x)
+        {
+          state.output += 0.5 * (input + state.input) * (_x - state.x);
+          state.x = _x;
+          state.input = input;
+        }
+        stack[top - 1] = state.output;
+        break;
+      }
+    }
+  }
+
+  _y = stack[0];
+  return std::isfinite(_y);
+}
+
+/////////////////////////////////////////////////
+void PlotExpression::Reset()
+{
+  this->dataPtr->filters.assign(this->dataPtr->filters.size(),
+      PlotFilterState());
+}
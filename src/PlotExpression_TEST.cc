@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+#include "ignition/gui/PlotExpression.hh"
+
+using namespace ignition;
+using namespace gui;
+
+/////////////////////////////////////////////////
+/// \brief Evaluate an expression of constants.
+/// \param[in] _text Expression
+/// \return Value, NaN if it can't be compiled or evaluated
+double Value(const std::string &_text)
+{
+  PlotExpression expression;
+  double y;
+  if (!expression.Compile(_text) || !expression.Evaluate(0, {}, y))
+    return std::nan("");
+  return y;
+}
+
+/////////////////////////////////////////////////
+TEST(PlotExpressionTest, Arithmetic)
+{
+  common::Console::SetVerbosity(4);
+
+  EXPECT_DOUBLE_EQ(7, Value("1 + 2 * 3"));
+  EXPECT_DOUBLE_EQ(9, Value("(1 + 2) * 3"));
+  EXPECT_DOUBLE_EQ(-1, Value("1 - 2"));
+  EXPECT_DOUBLE_EQ(-4, Value("-2^2"));
+  EXPECT_DOUBLE_EQ(512, Value("2^3^2"));
+  EXPECT_DOUBLE_EQ(0.25, Value("1 / 2 / 2"));
+  EXPECT_DOUBLE_EQ(1500, Value("1.5e3"));
+  EXPECT_DOUBLE_EQ(5, Value("sqrt(abs(-25))"));
+  EXPECT_DOUBLE_EQ(2, Value("max(min(2, 3), 1)"));
+  EXPECT_NEAR(0.0, Value("sin(pi)"), 1e-12);
+  EXPECT_DOUBLE_EQ(1, Value("log(e)"));
+  EXPECT_NEAR(0.25 * std::acos(-1.0), Value("atan2(1, 1)"), 1e-12);
+
+  // no finite result
+  EXPECT_TRUE(std::isnan(Value("1 / 0")));
+  EXPECT_TRUE(std::isnan(Value("sqrt(-1)")));
+
+  // invalid
+  PlotExpression expression;
+  EXPECT_FALSE(expression.Valid());
+  EXPECT_FALSE(expression.Compile(""));
+  EXPECT_FALSE(expression.Compile("1 +"));
+  EXPECT_FALSE(expression.Compile("(1"));
+  EXPECT_FALSE(expression.Compile("1 2"));
+  EXPECT_FALSE(expression.Compile("foo(1)"));
+  EXPECT_FALSE(expression.Compile("max(1)"));
+  EXPECT_FALSE(expression.Compile("{}"));
+  EXPECT_FALSE(expression.Compile("{/topic-x"));
+  EXPECT_FALSE(expression.Compile("ema({/a}, {/b})"));
+  EXPECT_FALSE(expression.Compile("ema({/a}, 2)"));
+  EXPECT_FALSE(expression.Valid());
+  EXPECT_TRUE(expression.Text().empty());
+}
+
+/////////////////////////////////////////////////
+TEST(PlotExpressionTest, Inputs)
+{
+  PlotExpression expression;
+  ASSERT_TRUE(expression.Compile(
+      "sqrt({/odom-twist-linear-x}^2 + {/odom-twist-linear-y}^2) - "
+      "{/odom-twist-linear-x} * 0"));
+  EXPECT_TRUE(expression.Valid());
+  ASSERT_EQ(2u, expression.Inputs().size());
+  EXPECT_EQ("/odom-twist-linear-x", expression.Inputs()[0]);
+  EXPECT_EQ("/odom-twist-linear-y", expression.Inputs()[1]);
+
+  double y;
+  ASSERT_TRUE(expression.Evaluate(0, {3, 4}, y));
+  EXPECT_DOUBLE_EQ(5, y);
+  ASSERT_TRUE(expression.Evaluate(1, {6, 8}, y));
+  EXPECT_DOUBLE_EQ(10, y);
+
+  // missing inputs
+  EXPECT_FALSE(expression.Evaluate(2, {1}, y));
+
+  // a failed compilation keeps the previous expression
+  EXPECT_FALSE(expression.Compile("{/a} +"));
+  EXPECT_EQ(2u, expression.Inputs().size());
+}
+
+/////////////////////////////////////////////////
+TEST(PlotExpressionTest, Filters)
+{
+  double y;
+
+  // derivative, undefined for the first sample
+  PlotExpression derivative;
+  ASSERT_TRUE(derivative.Compile("abs(derivative({/x}))"));
+  EXPECT_FALSE(derivative.Evaluate(0, {1}, y));
+  ASSERT_TRUE(derivative.Evaluate(0.5, {0}, y));
+  EXPECT_DOUBLE_EQ(2, y);
+  ASSERT_TRUE(derivative.Evaluate(0.5, {10}, y));
+  EXPECT_DOUBLE_EQ(2, y);
+  ASSERT_TRUE(derivative.Evaluate(1.5, {3}, y));
+  EXPECT_DOUBLE_EQ(3, y);
+
+  // going back in time starts over, and so does a reset
+  EXPECT_FALSE(derivative.Evaluate(1, {3}, y));
+  ASSERT_TRUE(derivative.Evaluate(2, {4}, y));
+  EXPECT_DOUBLE_EQ(1, y);
+  derivative.Reset();
+  EXPECT_FALSE(derivative.Evaluate(3, {4}, y));
+
+  // copies have their own state
+  auto copy = derivative;
+  ASSERT_TRUE(copy.Evaluate(4, {6}, y));
+  EXPECT_DOUBLE_EQ(2, y);
+  ASSERT_TRUE(derivative.Evaluate(5, {6}, y));
+  EXPECT_DOUBLE_EQ(1, y);
+
+  // moving average
+  PlotExpression ema;
+  ASSERT_TRUE(ema.Compile("ema({/x}, 0.5)"));
+  ASSERT_TRUE(ema.Evaluate(0, {4}, y));
+  EXPECT_DOUBLE_EQ(4, y);
+  ASSERT_TRUE(ema.Evaluate(1, {8}, y));
+  EXPECT_DOUBLE_EQ(6, y);
+  ASSERT_TRUE(ema.Evaluate(2, {8}, y));
+  EXPECT_DOUBLE_EQ(7, y);
+
+  // integral of a constant, and of the difference of two series
+  PlotExpression integral;
+  ASSERT_TRUE(integral.Compile("integral({/cmd} - {/pos})"));
+  ASSERT_TRUE(integral.Evaluate(0, {2, 0}, y));
+  EXPECT_DOUBLE_EQ(0, y);
+  ASSERT_TRUE(integral.Evaluate(1, {2, 0}, y));
+  EXPECT_DOUBLE_EQ(2, y);
+  ASSERT_TRUE(integral.Evaluate(3, {2, 1}, y));
+  EXPECT_DOUBLE_EQ(5, y);
+}
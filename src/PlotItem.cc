@@ -0,0 +1,497 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <QSGFlatColorMaterial>
+#include <QSGGeometryNode>
+#include <QSGTransformNode>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/gui/PlotItem.hh"
+#include "ignition/gui/PlottingInterface.hh"
+
+namespace ignition
+{
+  namespace gui
+  {
+    class PlotItemPrivate
+    {
+      /// \brief Read the points of the whole window again.
+      /// \param[in] _series Series to read from
+      /// \param[in] _count Number of points wanted in the window
+      public: void Read(const PlotSeries &_series, const std::size_t _count);
+
+      /// \brief Add the points stored after the last one drawn, if they can
+      /// be read at full resolution.
+      /// \param[in] _series Series to read from
+      /// \param[in] _count Number of points wanted in the window
+      /// \return False if the window must be read again instead
+      public: bool Append(const PlotSeries &_series,
+                          const std::size_t _count);
+
+      /// \brief Get the handle of the series once both IDs are set.
+      public: void UpdateHandle();
+
+      /// \brief Interface storing the points
+      public: QPointer<PlottingInterface> plotting;
+
+      /// \brief Chart ID of the series
+      public: int chart{-1};
+
+      /// \brief Field path or component ID of the series
+      public: QString fieldID;
+
+      /// \brief Handle of the series, from the chart and field IDs
+      public: int handle{-1};
+
+      /// \brief Line color
+      public: QColor color{Qt::black};
+
+      /// \brief Line width in pixels
+      public: qreal lineWidth{1};
+
+      /// \brief Range shown
+      public: qreal minX{0};
+
+      /// \brief Range shown
+      public: qreal maxX{1};
+
+      /// \brief Range shown
+      public: qreal minY{0};
+
+      /// \brief Range shown
+      public: qreal maxY{1};
+
+      /// \brief Points drawn, oldest first
+      public: QVector<QPointF> points;
+
+      /// \brief Drawn points relative to origin, x and y interleaved
+      public: std::vector<float> vertices;
+
+      /// \brief Point the vertices are relative to, so they stay precise as
+      /// floats far from 0
+      public: QPointF origin;
+
+      /// \brief Whether the points drawn are all the ones in the window
+      public: bool full{false};
+
+      /// \brief Lowest x coordinate read
+      public: double windowMin{0};
+
+      /// \brief Highest x coordinate read
+      public: double windowMax{0};
+
+      /// \brief Width of the range when the window was read
+      public: double windowSpan{0};
+
+      /// \brief Number of points asked for when the window was read
+      public: std::size_t windowCount{0};
+
+      /// \brief Set when the window must be read again
+      public: bool stale{true};
+
+      /// \brief Set when points were stored since the last sync
+      public: bool newPoints{false};
+
+      /// \brief Set when the color or width changed since the last sync
+      public: bool styleChanged{true};
+    };
+  }
+}
+
+using namespace ignition;
+using namespace gui;
+
+/////////////////////////////////////////////////
+void PlotItemPrivate::Read(const PlotSeries &_series,
+    const std::size_t _count)
+{
+  auto span = this->maxX - this->minX;
+  this->windowMin = this->minX - span;
+  this->windowMax = this->maxX + span;
+  this->windowSpan = span;
+  this->windowCount = _count;
+
+  this->points = _series.Points(this->windowMin, this->windowMax, _count,
+      &this->full);
+
+  this->vertices.clear();
+  this->vertices.reserve(this->points.size() * 2);
+  this->origin = this->points.empty() ? QPointF() : this->points.front();
+  for (const auto &point : this->points)
+  {
+    this->vertices.push_back(
+        static_cast<float>(point.x() - this->origin.x()));
+    this->vertices.push_back(
+        static_cast<float>(point.y() - this->origin.y()));
+  }
+}
+
+/////////////////////////////////////////////////
+void PlotItemPrivate::UpdateHandle()
+{
+  if (this->chart < 0 || this->fieldID.isEmpty())
+    this->handle = -1;
+  else
+    this->handle = PlottingInterface::Handle(this->chart, this->fieldID);
+}
+
+/////////////////////////////////////////////////
+bool PlotItemPrivate::Append(const PlotSeries &_series,
+    const std::size_t _count)
+{
+  if (!this->full || this->points.empty())
+    return false;
+
+  auto lastX = this->points.back().x();
+  if (lastX > this->windowMax)
+    return true;
+
+  bool full;
+  auto tail = _series.Points(lastX, this->windowMax, _count, &full);
+  if (!full)
+    return false;
+
+  for (const auto &point : tail)
+  {
+    if (point.x() <= lastX)
+      continue;
+
+    this->points.append(point);
+    this->vertices.push_back(
+        static_cast<float>(point.x() - this->origin.x()));
+    this->vertices.push_back(
+        static_cast<float>(point.y() - this->origin.y()));
+  }
+  return static_cast<std::size_t>(this->points.size()) <= 2 * _count;
+}
+
+/////////////////////////////////////////////////
+PlotItem::PlotItem(QQuickItem *_parent)
+  : QQuickItem(_parent), dataPtr(new PlotItemPrivate)
+{
+  this->setFlag(ItemHasContents);
+  this->setClip(true);
+}
+
+/////////////////////////////////////////////////
+PlotItem::~PlotItem()
+{
+}
+
+/////////////////////////////////////////////////
+QObject *PlotItem::Plotting() const
+{
+  return this->dataPtr->plotting;
+}
+
+/////////////////////////////////////////////////
+void PlotItem::SetPlotting(QObject *_plotting)
+{
+  auto plotting = qobject_cast<PlottingInterface *>(_plotting);
+  if (_plotting && !plotting)
+  {
+    ignerr << "A plot item can only draw from a PlottingInterface"
+           << std::endl;
+    return;
+  }
+
+  if (plotting == this->dataPtr->plotting)
+    return;
+
+  if (this->dataPtr->plotting)
+    this->dataPtr->plotting->disconnect(this);
+
+  this->dataPtr->plotting = plotting;
+  if (plotting)
+  {
+    this->connect(plotting, SIGNAL(SeriesHandleChanged(int, int)), this,
+        SLOT(OnSeriesChanged(int, int)));
+  }
+
+  this->dataPtr->stale = true;
+  this->update();
+  emit this->PlottingChanged();
+}
+
+/////////////////////////////////////////////////
+int PlotItem::ChartId() const
+{
+  return this->dataPtr->chart;
+}
+
+/////////////////////////////////////////////////
+void PlotItem::SetChartId(int _chart)
+{
+  if (_chart == this->dataPtr->chart)
+    return;
+
+  this->dataPtr->chart = _chart;
+  this->dataPtr->UpdateHandle();
+  this->dataPtr->stale = true;
+  this->update();
+  emit this->ChartIdChanged();
+}
+
+/////////////////////////////////////////////////
+QString PlotItem::FieldId() const
+{
+  return this->dataPtr->fieldID;
+}
+
+/////////////////////////////////////////////////
+void PlotItem::SetFieldId(const QString &_fieldID)
+{
+  if (_fieldID == this->dataPtr->fieldID)
+    return;
+
+  this->dataPtr->fieldID = _fieldID;
+  this->dataPtr->UpdateHandle();
+  this->dataPtr->stale = true;
+  this->update();
+  emit this->FieldIdChanged();
+}
+
+/////////////////////////////////////////////////
+QColor PlotItem::Color() const
+{
+  return this->dataPtr->color;
+}
+
+/////////////////////////////////////////////////
+void PlotItem::SetColor(const QColor &_color)
+{
+  if (_color == this->dataPtr->color)
+    return;
+
+  this->dataPtr->color = _color;
+  this->dataPtr->styleChanged = true;
+  this->update();
+  emit this->ColorChanged();
+}
+
+/////////////////////////////////////////////////
+qreal PlotItem::LineWidth() const
+{
+  return this->dataPtr->lineWidth;
+}
+
+/////////////////////////////////////////////////
+void PlotItem::SetLineWidth(qreal _width)
+{
+  if (qFuzzyCompare(_width, this->dataPtr->lineWidth))
+    return;
+
+  this->dataPtr->lineWidth = _width;
+  this->dataPtr->styleChanged = true;
+  this->update();
+  emit this->LineWidthChanged();
+}
+
+/////////////////////////////////////////////////
+qreal PlotItem::MinX() const
+{
+  return this->dataPtr->minX;
+}
+
+/////////////////////////////////////////////////
+void PlotItem::SetMinX(qreal _x)
+{
+  if (qFuzzyCompare(_x, this->dataPtr->minX))
+    return;
+
+  this->dataPtr->minX = _x;
+  this->update();
+  emit this->RangeChanged();
+}
+
+/////////////////////////////////////////////////
+qreal PlotItem::MaxX() const
+{
+  return this->dataPtr->maxX;
+}
+
+/////////////////////////////////////////////////
+void PlotItem::SetMaxX(qreal _x)
+{
+  if (qFuzzyCompare(_x, this->dataPtr->maxX))
+    return;
+
+  this->dataPtr->maxX = _x;
+  this->update();
+  emit this->RangeChanged();
+}
+
+/////////////////////////////////////////////////
+qreal PlotItem::MinY() const
+{
+  return this->dataPtr->minY;
+}
+
+/////////////////////////////////////////////////
+void PlotItem::SetMinY(qreal _y)
+{
+  if (qFuzzyCompare(_y, this->dataPtr->minY))
+    return;
+
+  this->dataPtr->minY = _y;
+  this->update();
+  emit this->RangeChanged();
+}
+
+/////////////////////////////////////////////////
+qreal PlotItem::MaxY() const
+{
+  return this->dataPtr->maxY;
+}
+
+/////////////////////////////////////////////////
+void PlotItem::SetMaxY(qreal _y)
+{
+  if (qFuzzyCompare(_y, this->dataPtr->maxY))
+    return;
+
+  this->dataPtr->maxY = _y;
+  this->update();
+  emit this->RangeChanged();
+}
+
+/////////////////////////////////////////////////
+QVariant PlotItem::NearestPoint(qreal _x) const
+{
+  const auto &points = this->dataPtr->points;
+  if (points.empty())
+    return QVariant();
+
+  auto it = std::lower_bound(points.begin(), points.end(), _x,
+      [](const QPointF &_point, qreal _value)
+      {
+        return _point.x() < _value;
+      });
+
+  if (it == points.end())
+    return points.back();
+  if (it != points.begin() && _x - (it - 1)->x() < it->x() - _x)
+    --it;
+  return *it;
+}
+
+/////////////////////////////////////////////////
+void PlotItem::OnSeriesChanged(int, int _handle)
+{
+  if (_handle != this->dataPtr->handle)
+    return;
+
+  this->dataPtr->newPoints = true;
+  this->update();
+}
+
+/////////////////////////////////////////////////
+QSGNode *PlotItem::updatePaintNode(QSGNode *_node,
+    QQuickItem::UpdatePaintNodeData *)
+{
+  // The GUI thread is blocked while syncing, so the store can be read
+  const PlotSeries *series{nullptr};
+  if (this->dataPtr->plotting)
+  {
+    series = this->dataPtr->plotting->Series(this->dataPtr->handle);
+  }
+
+  auto spanX = this->dataPtr->maxX - this->dataPtr->minX;
+  auto spanY = this->dataPtr->maxY - this->dataPtr->minY;
+  if (!series || series->Size() == 0 || this->width() <= 0 ||
+      this->height() <= 0 || spanX <= 0 || spanY <= 0)
+  {
+    this->dataPtr->points.clear();
+    this->dataPtr->vertices.clear();
+    this->dataPtr->stale = true;
+    delete _node;
+    return nullptr;
+  }
+
+  // About a point per pixel across the 3 spans of the window
+  auto count = static_cast<std::size_t>(std::ceil(this->width())) * 3;
+
+  auto &d = *this->dataPtr;
+  bool read = d.stale || d.minX < d.windowMin || d.maxX > d.windowMax ||
+      spanX > 2 * d.windowSpan || spanX < 0.5 * d.windowSpan ||
+      count != d.windowCount;
+  bool changed = read || d.newPoints;
+  if (!read && d.newPoints)
+    read = !d.Append(*series, count);
+  if (read)
+    d.Read(*series, count);
+  d.stale = false;
+  d.newPoints = false;
+
+  auto transform = static_cast<QSGTransformNode *>(_node);
+  if (!transform)
+  {
+    transform = new QSGTransformNode();
+
+    auto node = new QSGGeometryNode();
+    auto geometry = new QSGGeometry(
+        QSGGeometry::defaultAttributes_Point2D(), 0);
+    geometry->setDrawingMode(QSGGeometry::DrawLineStrip);
+    node->setGeometry(geometry);
+    node->setFlag(QSGNode::OwnsGeometry);
+
+    auto material = new QSGFlatColorMaterial();
+    node->setMaterial(material);
+    node->setFlag(QSGNode::OwnsMaterial);
+
+    transform->appendChildNode(node);
+    changed = true;
+  }
+  auto node = static_cast<QSGGeometryNode *>(transform->firstChild());
+
+  if (d.styleChanged)
+  {
+    auto material = static_cast<QSGFlatColorMaterial *>(node->material());
+    material->setColor(d.color);
+    node->geometry()->setLineWidth(static_cast<float>(d.lineWidth));
+    node->markDirty(QSGNode::DirtyMaterial | QSGNode::DirtyGeometry);
+    d.styleChanged = false;
+  }
+
+  if (changed)
+  {
+    auto geometry = node->geometry();
+    auto vertexCount = static_cast<int>(d.vertices.size() / 2);
+    if (geometry->vertexCount() != vertexCount)
+      geometry->allocate(vertexCount);
+    std::copy(d.vertices.begin(), d.vertices.end(),
+        static_cast<float *>(geometry->vertexData()));
+    node->markDirty(QSGNode::DirtyGeometry);
+  }
+
+  // Map the range to the item, y pointing up
+  auto scaleX = this->width() / spanX;
+  auto scaleY = this->height() / spanY;
+  QMatrix4x4 matrix(
+      scaleX, 0, 0, (d.origin.x() - d.minX) * scaleX,
+      0, -scaleY, 0, this->height() - (d.origin.y() - d.minY) * scaleY,
+      0, 0, 1, 0,
+      0, 0, 0, 1);
+  transform->setMatrix(matrix);
+
+  return transform;
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <ignition/common/Console.hh>
+#include <ignition/utilities/ExtraTestMacros.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+#include "ignition/gui/Application.hh"
+#include "ignition/gui/PlotItem.hh"
+#include "ignition/gui/PlottingInterface.hh"
+
+int g_argc = 1;
+char **g_argv = new char *[g_argc];
+
+using namespace ignition;
+using namespace gui;
+
+/////////////////////////////////////////////////
+TEST(PlotItemTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(Properties))
+{
+  common::Console::SetVerbosity(4);
+
+  Application app(g_argc, g_argv);
+  PlottingInterface plotting;
+
+  PlotItem item;
+  EXPECT_EQ(nullptr, item.Plotting());
+  EXPECT_EQ(-1, item.ChartId());
+  EXPECT_TRUE(item.FieldId().isEmpty());
+
+  // Only a plotting interface is accepted
+  QObject other;
+  item.SetPlotting(&other);
+  EXPECT_EQ(nullptr, item.Plotting());
+
+  item.SetPlotting(&plotting);
+  EXPECT_EQ(&plotting, item.Plotting());
+
+  item.SetChartId(2);
+  EXPECT_EQ(2, item.ChartId());
+
+  item.SetFieldId("/topic-x");
+  EXPECT_EQ("/topic-x", item.FieldId());
+
+  item.SetColor(Qt::red);
+  EXPECT_EQ(QColor(Qt::red), item.Color());
+
+  item.SetLineWidth(3);
+  EXPECT_DOUBLE_EQ(3, item.LineWidth());
+
+  int rangeChanged{0};
+  QObject::connect(&item, &PlotItem::RangeChanged, [&rangeChanged]()
+  {
+    ++rangeChanged;
+  });
+  item.SetMinX(-5);
+  item.SetMaxX(5);
+  item.SetMinY(-1);
+  item.SetMaxY(1);
+  item.SetMaxY(1);
+  EXPECT_EQ(4, rangeChanged);
+  EXPECT_DOUBLE_EQ(-5, item.MinX());
+  EXPECT_DOUBLE_EQ(5, item.MaxX());
+  EXPECT_DOUBLE_EQ(-1, item.MinY());
+  EXPECT_DOUBLE_EQ(1, item.MaxY());
+
+  // Points are only read when the item is drawn
+  plotting.AddSeries(2, "/topic-x", 10);
+  EXPECT_FALSE(item.NearestPoint(0).isValid());
+
+  // Forget about a deleted interface
+  {
+    PlottingInterface temporary;
+    item.SetPlotting(&temporary);
+    EXPECT_EQ(&temporary, item.Plotting());
+  }
+  EXPECT_EQ(nullptr, item.Plotting());
+}
@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "ignition/gui/PlotSpectrum.hh"
+
+namespace ignition
+{
+  namespace gui
+  {
+    class PlotSpectrumPrivate
+    {
+      /// \brief Transform re and im in place.
+      public: void Transform();
+
+      /// \brief Number of samples, a power of two
+      public: std::size_t size;
+
+      /// \brief Window coefficients
+      public: std::vector<double> window;
+
+      /// \brief Sum of the window coefficients, to scale amplitudes
+      public: double windowSum{0.0};
+
+      /// \brief Cosines of the twiddle factors, for half of the circle
+      public: std::vector<double> cosines;
+
+      /// \brief Sines of the twiddle factors, for half of the circle
+      public: std::vector<double> sines;
+
+      /// \brief Bit reversed index of each sample
+      public: std::vector<std::size_t> reversed;
+
+      /// \brief Real parts, kept apart from the imaginary ones so
+      /// butterflies run over contiguous arrays
+      public: std::vector<double> re;
+
+      /// \brief Imaginary parts
+      public: std::vector<double> im;
+    };
+  }
+}
+
+using namespace ignition;
+using namespace gui;
+
+/// \brief Pi
+static const double kPi = std::acos(-1.0);
+
+/////////////////////////////////////////////////
+void PlotSpectrumPrivate::Transform()
+{
+  auto n = this->size;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    auto j = this->reversed[i];
+    if (i < j)
+    {
+      std::swap(this->re[i], this->re[j]);
+      std::swap(this->im[i], this->im[j]);
+    }
+  }
+
+  double *re = this->re.data();
+  double *im = this->im.data();
+  for (std::size_t half = 1; half < n; half *= 2)
+  {
+    auto stride = n / (half * 2);
+    for (std::size_t start = 0; start < n; start += half * 2)
+    {
+      for (std::size_t k = 0; k < half; ++k)
+      {
+        double c = this->cosines[k * stride];
+        double s = this->sines[k * stride];
+        auto a = start + k;
+        auto b = a + half;
+        double tre = re[b] * c - im[b] * s;
+        double tim = re[b] * s + im[b] * c;
+        re[b] = re[a] - tre;
+        im[b] = im[a] - tim;
+        re[a] += tre;
+        im[a] += tim;
+      }
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+PlotSpectrum::PlotSpectrum(const std::size_t _size, const Window _window)
+  : dataPtr(new PlotSpectrumPrivate)
+{
+  std::size_t size = 8;
+  unsigned int bits = 3;
+  while (size < _size)
+  {
+    size *= 2;
+    ++bits;
+  }
+
+  auto &d = *this->dataPtr;
+  d.size = size;
+  d.re.resize(size);
+  d.im.resize(size);
+
+  d.reversed.resize(size);
+  for (std::size_t i = 0; i < size; ++i)
+  {
+    std::size_t r = 0;
+    for (unsigned int b = 0; b < bits; ++b)
+      r |= ((i >> b) & 1u) << (bits - 1 - b);
+    d.reversed[i] = r;
+  }
+
+  d.cosines.resize(size / 2);
+  d.sines.resize(size / 2);
+  for (std::size_t k = 0; k < size / 2; ++k)
+  {
+    double angle = -2.0 * kPi * static_cast<double>(k) /
+        static_cast<double>(size);
+    d.cosines[k] = std::cos(angle);
+    d.sines[k] = std::sin(angle);
+  }
+
+  d.window.resize(size);
+  for (std::size_t i = 0; i < size; ++i)
+  {
+    double phase = 2.0 * kPi * static_cast<double>(i) /
+        static_cast<double>(size - 1);
+    switch (_window)
+    {
+      case Window::RECTANGULAR:
+        d.window[i] = 1.0;
+        break;
+      case Window::HANN:
+        d.window[i] = 0.5 - 0.5 * std::cos(phase);
+        break;
+      case Window::HAMMING:
+        d.window[i] = 0.54 - 0.46 * std::cos(phase);
+        break;
+      case Window::BLACKMAN:
+        d.window[i] = 0.42 - 0.5 * std::cos(phase) +
+            0.08 * std::cos(2.0 * phase);
+        break;
+    }
+    d.windowSum += d.window[i];
+  }
+}
+
+/////////////////////////////////////////////////
+PlotSpectrum::~PlotSpectrum() = default;
+
+/////////////////////////////////////////////////
+std::size_t PlotSpectrum::Size() const
+{
+  return this->dataPtr->size;
+}
+
+/////////////////////////////////////////////////
+bool PlotSpectrum::Compute(const std::vector<double> &_x,
+                           const std::vector<double> &_y,
+                           std::vector<double> &_frequencies,
+                           std::vector<double> &_amplitudes)
+{
+  auto &d = *this->dataPtr;
+  if (_x.size() != _y.size() || _x.size() < 8u)
+    return false;
+
+  double span = _x.back() - _x.front();
+  if (!(span > 0.0))
+    return false;
+
+  // resample linearly at a uniform rate over the span
+  auto n = d.size;
+  double step = span / static_cast<double>(n - 1);
+  double mean{0.0};
+  std::size_t source = 0;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    double t = _x.front() + step * static_cast<double>(i);
+    while (source + 2 < _x.size() && _x[source + 1] < t)
+      ++source;
+
+    double x0 = _x[source];
+    double x1 = _x[source + 1];
+    double value = _y[source];
+    if (x1 > x0)
+    {
+      double alpha = std::min(std::max((t - x0) / (x1 - x0), 0.0), 1.0);
+      value += alpha * (_y[source + 1] - _y[source]);
+    }
+    d.re[i] = value;
+    mean += value;
+  }
+  mean /= static_cast<double>(n);
+
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    d.re[i] = (d.re[i] - mean) * d.window[i];
+    d.im[i] = 0.0;
+  }
+
+  d.Transform();
+
+  // one sided, so the bins other than DC and Nyquist count twice
+  auto bins = n / 2 + 1;
+  double rate = 1.0 / step;
+  _frequencies.resize(bins);
+  _amplitudes.resize(bins);
+  for (std::size_t k = 0; k < bins; ++k)
+  {
+    double scale = (k == 0 || k == n / 2) ? 1.0 : 2.0;
+    _frequencies[k] = rate * static_cast<double>(k) / static_cast<double>(n);
+    _amplitudes[k] = scale * std::sqrt(d.re[k] * d.re[k] + d.im[k] * d.im[k])
+        / d.windowSum;
+  }
+  return true;
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "test_config.h"  // NOLINT(build/include)
+#include "ignition/gui/PlotSpectrum.hh"
+
+using namespace ignition;
+using namespace gui;
+
+/////////////////////////////////////////////////
+/// \brief Find the bin with the highest amplitude.
+/// \param[in] _amplitudes Amplitudes
+/// \return Bin index
+std::size_t Peak(const std::vector<double> &_amplitudes)
+{
+  return static_cast<std::size_t>(std::max_element(_amplitudes.begin(),
+      _amplitudes.end()) - _amplitudes.begin());
+}
+
+/////////////////////////////////////////////////
+TEST(PlotSpectrumTest, Size)
+{
+  EXPECT_EQ(1024u, PlotSpectrum().Size());
+  EXPECT_EQ(512u, PlotSpectrum(300).Size());
+  EXPECT_EQ(8u, PlotSpectrum(1).Size());
+
+  PlotSpectrum spectrum(16);
+  std::vector<double> frequencies, amplitudes;
+  EXPECT_FALSE(spectrum.Compute({1, 2, 3}, {1, 2, 3}, frequencies,
+      amplitudes));
+  EXPECT_FALSE(spectrum.Compute(std::vector<double>(10, 1.0),
+      std::vector<double>(10, 0.0), frequencies, amplitudes));
+  EXPECT_FALSE(spectrum.Compute(std::vector<double>(10, 1.0),
+      std::vector<double>(9, 0.0), frequencies, amplitudes));
+}
+
+/////////////////////////////////////////////////
+TEST(PlotSpectrumTest, Sines)
+{
+  const double pi = std::acos(-1.0);
+
+  // 1 kHz samples of 50 Hz and 120 Hz oscillations around an offset
+  std::vector<double> x, y;
+  for (int i = 0; i < 1024; ++i)
+  {
+    double t = i * 0.001;
+    x.push_back(t);
+    y.push_back(5.0 + 2.0 * std::sin(2 * pi * 50 * t) +
+        0.5 * std::sin(2 * pi * 120 * t));
+  }
+
+  for (auto window : {PlotSpectrum::Window::RECTANGULAR,
+                      PlotSpectrum::Window::HANN,
+                      PlotSpectrum::Window::HAMMING,
+                      PlotSpectrum::Window::BLACKMAN})
+  {
+    PlotSpectrum spectrum(1024, window);
+    std::vector<double> frequencies, amplitudes;
+    ASSERT_TRUE(spectrum.Compute(x, y, frequencies, amplitudes));
+    ASSERT_EQ(513u, frequencies.size());
+    ASSERT_EQ(513u, amplitudes.size());
+    EXPECT_DOUBLE_EQ(0, frequencies.front());
+    EXPECT_NEAR(500, frequencies.back(), 1e-9);
+
+    // the offset is removed, only what the window leaks is left
+    EXPECT_LT(amplitudes[0], 0.05);
+
+    auto peak = Peak(amplitudes);
+    EXPECT_NEAR(50, frequencies[peak], 1.0);
+    EXPECT_NEAR(2.0, amplitudes[peak], 0.8);
+
+    // the other oscillation, away from the first
+    for (std::size_t k = 0; k < amplitudes.size(); ++k)
+    {
+      if (frequencies[k] < 80)
+        amplitudes[k] = 0;
+    }
+    peak = Peak(amplitudes);
+    EXPECT_NEAR(120, frequencies[peak], 1.0);
+    EXPECT_NEAR(0.5, amplitudes[peak], 0.2);
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(PlotSpectrumTest, UnevenSamples)
+{
+  const double pi = std::acos(-1.0);
+
+  // samples far from regular, at about 500 Hz
+  std::vector<double> x, y;
+  double t{0.0};
+  for (int i = 0; i < 600; ++i)
+  {
+    t += (i % 3 == 0) ? 0.003 : 0.0015;
+    x.push_back(t);
+    y.push_back(std::cos(2 * pi * 20 * t));
+  }
+
+  PlotSpectrum spectrum(512);
+  std::vector<double> frequencies, amplitudes;
+  ASSERT_TRUE(spectrum.Compute(x, y, frequencies, amplitudes));
+  auto peak = Peak(amplitudes);
+  EXPECT_NEAR(20, frequencies[peak], 1.0);
+  EXPECT_NEAR(1.0, amplitudes[peak], 0.3);
+}
@@ -0,0 +1,306 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "ignition/gui/PlotStatistics.hh"
+
+namespace ignition
+{
+  namespace gui
+  {
+    /// \brief A cluster of values of the digest
+    struct PlotCentroid
+    {
+      /// \brief Mean of the values
+      double mean;
+
+      /// \brief Number of values
+      double weight;
+    };
+
+    class PlotStatisticsPrivate
+    {
+      /// \brief Merge the buffered values into the clusters.
+      public: void Merge();
+
+      /// \brief Scale function of the digest, mapping a quantile to a
+      /// number of clusters, so clusters get smaller near the tails.
+      /// \param[in] _q Quantile
+      /// \return Scale
+      public: double Scale(const double _q) const;
+
+      /// \brief Inverse of Scale.
+      /// \param[in] _k Scale
+      /// \return Quantile
+      public: double InverseScale(const double _k) const;
+
+      /// \brief Compression of the digest
+      public: double compression;
+
+      /// \brief Number of values
+      public: std::size_t count{0u};
+
+      /// \brief Running mean
+      public: double mean{0.0};
+
+      /// \brief Running sum of the squared differences to the mean
+      public: double m2{0.0};
+
+      /// \brief Lowest value
+      public: double min{0.0};
+
+      /// \brief Highest value
+      public: double max{0.0};
+
+      /// \brief Clusters, sorted by mean
+      public: std::vector<PlotCentroid> centroids;
+
+      /// \brief Values not merged into the clusters yet
+      public: std::vector<double> buffer;
+
+      /// \brief Most values buffered before merging
+      public: std::size_t bufferSize;
+    };
+  }
+}
+
+using namespace ignition;
+using namespace gui;
+
+/// \brief Pi, for the scale function
+static const double kPi = std::acos(-1.0);
+
+/////////////////////////////////////////////////
+double PlotStatisticsPrivate::Scale(const double _q) const
+{
+  return this->compression / (2.0 * kPi) * std::asin(2.0 * _q - 1.0);
+}
+
+/////////////////////////////////////////////////
+double PlotStatisticsPrivate::InverseScale(const double _k) const
+{
+  if (_k >= this->compression * 0.25)
+    return 1.0;
+  return (std::sin(_k * 2.0 * kPi / this->compression) + 1.0) * 0.5;
+}
+
+/////////////////////////////////////////////////
+void PlotStatisticsPrivate::Merge()
+{
+  if (this->buffer.empty())
+    return;
+
+  for (auto value : this->buffer)
+    this->centroids.push_back({value, 1.0});
+  this->buffer.clear();
+
+  std::sort(this->centroids.begin(), this->centroids.end(),
+      [](const PlotCentroid &_a, const PlotCentroid &_b)
+      {
+        return _a.mean < _b.mean;
+      });
+
+  // each cluster covers at most one unit of scale
+  auto total = static_cast<double>(this->count);
+  std::vector<PlotCentroid> merged;
+  merged.reserve(static_cast<std::size_t>(this->compression));
+  double before{0.0};
+  double limit = total * this->InverseScale(this->Scale(0.0) + 1.0);
+  auto current = this->centroids.front();
+  for (std::size_t i = 1; i < this->centroids.size(); ++i)
+  {
+    const auto &next = this->centroids[i];
+    if (before + current.weight + next.weight <= limit)
+    {
+      current.weight += next.weight;
+      current.mean += (next.mean - current.mean) * next.weight /
+          current.weight;
+      continue;
+    }
+
+    before += current.weight;
+    merged.push_back(current);
+    limit = total * this->InverseScale(this->Scale(before / total) + 1.0);
+    current = next;
+  }
+  merged.push_back(current);
+  this->centroids.swap(merged);
+}
+
+/////////////////////////////////////////////////
+PlotStatistics::PlotStatistics(const double _compression)
+  : dataPtr(new PlotStatisticsPrivate)
+{
+  this->dataPtr->compression = std::max(_compression, 10.0);
+  this->dataPtr->bufferSize =
+      static_cast<std::size_t>(this->dataPtr->compression * 5.0);
+  this->dataPtr->buffer.reserve(this->dataPtr->bufferSize);
+}
+
+/////////////////////////////////////////////////
+PlotStatistics::PlotStatistics(const PlotStatistics &_other)
+  : dataPtr(new PlotStatisticsPrivate(*_other.dataPtr))
+{
+}
+
+/////////////////////////////////////////////////
+PlotStatistics::~PlotStatistics() = default;
+
+/////////////////////////////////////////////////
+PlotStatistics &PlotStatistics::operator=(const PlotStatistics &_other)
+{
+  if (this != &_other)
+    *this->dataPtr = *_other.dataPtr;
+  return *this;
+}
+
+/////////////////////////////////////////////////
+void PlotStatistics::Add(const double _value)
+{
+  if (!std::isfinite(_value))
+    return;
+
+  auto &d = *this->dataPtr;
+  if (d.count == 0u)
+  {
+    d.min = _value;
+    d.max = _value;
+  }
+  else
+  {
+    d.min = std::min(d.min, _value);
+    d.max = std::max(d.max, _value);
+  }
+
+  ++d.count;
+  double delta = _value - d.mean;
+  d.mean += delta / static_cast<double>(d.count);
+  d.m2 += delta * (_value - d.mean);
+
+  d.buffer.push_back(_value);
+  if (d.buffer.size() >= d.bufferSize)
+    d.Merge();
+}
+
+/////////////////////////////////////////////////
+void PlotStatistics::Clear()
+{
+  auto &d = *this->dataPtr;
+  d.count = 0u;
+  d.mean = 0.0;
+  d.m2 = 0.0;
+  d.min = 0.0;
+  d.max = 0.0;
+  d.centroids.clear();
+  d.buffer.clear();
+}
+
+/////////////////////////////////////////////////
+std::size_t PlotStatistics::Count() const
+{
+  return this->dataPtr->count;
+}
+
+/////////////////////////////////////////////////
+double PlotStatistics::Mean() const
+{
+  return this->dataPtr->mean;
+}
+
+/////////////////////////////////////////////////
+double PlotStatistics::Variance() const
+{
+  if (this->dataPtr->count < 2u)
+    return 0.0;
+  return this->dataPtr->m2 / static_cast<double>(this->dataPtr->count - 1u);
+}
+
+/////////////////////////////////////////////////
+double PlotStatistics::StdDev() const
+{
+  return std::sqrt(this->Variance());
+}
+
+/////////////////////////////////////////////////
+double PlotStatistics::Min() const
+{
+  return this->dataPtr->min;
+}
+
+/////////////////////////////////////////////////
+double PlotStatistics::Max() const
+{
+  return this->dataPtr->max;
+}
+
+/////////////////////////////////////////////////
+double PlotStatistics::Quantile(const double _q) const
+{
+  auto &d = *this->dataPtr;
+  if (d.count == 0u)
+    return 0.0;
+  if (_q <= 0.0)
+    return d.min;
+  if (_q >= 1.0)
+    return d.max;
+
+  d.Merge();
+  const auto &c = d.centroids;
+  if (c.size() == 1u)
+    return c.front().mean;
+
+  // interpolate between the centers of the clusters around the rank, and
+  // between the extremes and the outer centers
+  auto total = static_cast<double>(d.count);
+  double rank = _q * total;
+  double value;
+  if (rank < c.front().weight * 0.5)
+  {
+    value = d.min + (c.front().mean - d.min) * rank /
+        (c.front().weight * 0.5);
+    return std::min(std::max(value, d.min), d.max);
+  }
+
+  double before{0.0};
+  for (std::size_t i = 0; i + 1 < c.size(); ++i)
+  {
+    double left = before + c[i].weight * 0.5;
+    double right = before + c[i].weight + c[i + 1].weight * 0.5;
+    if (rank <= right)
+    {
+      value = c[i].mean + (c[i + 1].mean - c[i].mean) * (rank - left) /
+          (right - left);
+      return std::min(std::max(value, d.min), d.max);
+    }
+    before += c[i].weight;
+  }
+
+  double left = total - c.back().weight * 0.5;
+  value = c.back().mean + (d.max - c.back().mean) * (rank - left) /
+      (total - left);
+  return std::min(std::max(value, d.min), d.max);
+}
+
+/////////////////////////////////////////////////
+std::size_t PlotStatistics::Clusters() const
+{
+  this->dataPtr->Merge();
+  return this->dataPtr->centroids.size();
+}
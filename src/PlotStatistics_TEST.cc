@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "test_config.h"  // NOLINT(build/include)
+#include "ignition/gui/PlotStatistics.hh"
+
+using namespace ignition;
+using namespace gui;
+
+/////////////////////////////////////////////////
+TEST(PlotStatisticsTest, Moments)
+{
+  PlotStatistics stats;
+  EXPECT_EQ(0u, stats.Count());
+  EXPECT_DOUBLE_EQ(0, stats.Mean());
+  EXPECT_DOUBLE_EQ(0, stats.StdDev());
+  EXPECT_DOUBLE_EQ(0, stats.Quantile(0.5));
+
+  for (double value : {2, 4, 4, 4, 5, 5, 7, 9})
+    stats.Add(value);
+  stats.Add(std::nan(""));
+  stats.Add(INFINITY);
+
+  EXPECT_EQ(8u, stats.Count());
+  EXPECT_DOUBLE_EQ(5, stats.Mean());
+  EXPECT_DOUBLE_EQ(32.0 / 7.0, stats.Variance());
+  EXPECT_DOUBLE_EQ(std::sqrt(32.0 / 7.0), stats.StdDev());
+  EXPECT_DOUBLE_EQ(2, stats.Min());
+  EXPECT_DOUBLE_EQ(9, stats.Max());
+  EXPECT_DOUBLE_EQ(2, stats.Quantile(0));
+  EXPECT_DOUBLE_EQ(9, stats.Quantile(1));
+  EXPECT_NEAR(4.5, stats.Quantile(0.5), 0.5);
+
+  // accurate over a large offset, where sums of squares aren't
+  PlotStatistics offset;
+  for (int i = 0; i < 1000; ++i)
+    offset.Add(1e9 + (i % 2));
+  EXPECT_NEAR(1e9 + 0.5, offset.Mean(), 1e-6);
+  EXPECT_NEAR(0.25 * 1000 / 999, offset.Variance(), 1e-6);
+
+  // copies are independent
+  auto copy = stats;
+  copy.Add(100);
+  EXPECT_EQ(8u, stats.Count());
+  EXPECT_EQ(9u, copy.Count());
+
+  stats.Clear();
+  EXPECT_EQ(0u, stats.Count());
+  EXPECT_DOUBLE_EQ(0, stats.Max());
+  EXPECT_EQ(0u, stats.Clusters());
+}
+
+/////////////////////////////////////////////////
+TEST(PlotStatisticsTest, Quantiles)
+{
+  std::mt19937 random(42);
+  std::normal_distribution<double> normal(10.0, 2.0);
+
+  PlotStatistics stats;
+  std::vector<double> values;
+  for (int i = 0; i < 100000; ++i)
+  {
+    double value = normal(random);
+    values.push_back(value);
+    stats.Add(value);
+  }
+  std::sort(values.begin(), values.end());
+
+  // bounded memory
+  EXPECT_LT(stats.Clusters(), 200u);
+
+  EXPECT_NEAR(10.0, stats.Mean(), 0.05);
+  EXPECT_NEAR(2.0, stats.StdDev(), 0.05);
+  EXPECT_DOUBLE_EQ(values.front(), stats.Min());
+  EXPECT_DOUBLE_EQ(values.back(), stats.Max());
+
+  // within a fraction of a percent in rank, closer at the tails
+  for (double q : {0.001, 0.01, 0.25, 0.5, 0.75, 0.95, 0.99, 0.999})
+  {
+    auto estimate = stats.Quantile(q);
+    auto rank = static_cast<double>(std::lower_bound(values.begin(),
+        values.end(), estimate) - values.begin()) / values.size();
+    double tolerance = std::min(q, 1.0 - q) < 0.02 ? 0.001 : 0.005;
+    EXPECT_NEAR(q, rank, tolerance) << q;
+  }
+}
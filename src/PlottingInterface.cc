@@ -15,19 +15,45 @@
  *
 */
 
+#include <QtCharts/QXYSeries>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <mutex>
 #include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 #include <ignition/common/Console.hh>
 #include <ignition/common/StringUtils.hh>
+#include <ignition/msgs/world_stats.pb.h>
 #include <ignition/transport/Node.hh>
 #include <ignition/transport/MessageInfo.hh>
 #include <ignition/transport/Publisher.hh>
 
+#include "ignition/gui/Executor.hh"
+#include "ignition/gui/Metrics.hh"
+#include "ignition/gui/PlotExpression.hh"
+#include "ignition/gui/PlotItem.hh"
+#include "ignition/gui/PlotSpectrum.hh"
 #include "ignition/gui/PlottingInterface.hh"
 #include "ignition/gui/Application.hh"
+#include "ignition/gui/SubscriptionHub.hh"
 
 #define DEFAULT_TIME (INT_MIN)
-// 1/60 Period like the GuiSystem frequency (60Hz)
-#define MAX_PERIOD_DIFF (0.0166666667)
+
+/// \brief Milliseconds between the UI notifications of new points
+static const int kFlushInterval{33};
+
+/// \brief Milliseconds between the UI notifications of new points while
+/// the charts can't be seen
+static const int kSuspendedFlushInterval{1000};
 
 namespace ignition
 {
@@ -46,8 +72,601 @@ class PlotDataPrivate
 };
 
 
+/// \brief Lowest and highest point of consecutive points
+struct PlotBucket
+{
+  /// \brief Add a point, after the ones already in the bucket.
+  /// \param[in] _x x coordinate
+  /// \param[in] _y y coordinate
+  void Add(const double _x, const double _y)
+  {
+    if (this->count == 0)
+    {
+      this->firstX = _x;
+      this->minX = this->maxX = _x;
+      this->minY = this->maxY = _y;
+    }
+    else if (_y < this->minY)
+    {
+      this->minX = _x;
+      this->minY = _y;
+    }
+    else if (_y > this->maxY)
+    {
+      this->maxX = _x;
+      this->maxY = _y;
+    }
+    this->lastX = _x;
+    ++this->count;
+  }
+
+  /// \brief x coordinate of the first point
+  double firstX = 0;
+
+  /// \brief x coordinate of the last point
+  double lastX = 0;
+
+  /// \brief x coordinate of the lowest point
+  double minX = 0;
+
+  /// \brief Lowest y coordinate
+  double minY = 0;
+
+  /// \brief x coordinate of the highest point
+  double maxX = 0;
+
+  /// \brief Highest y coordinate
+  double maxY = 0;
+
+  /// \brief Number of points added
+  std::size_t count = 0;
+};
+
+/// \brief One level of detail of a series, a ring buffer of buckets of a
+/// fixed number of points
+class PlotLevel
+{
+  /// \brief Add a point to the open bucket, closing it once full.
+  /// \param[in] _x x coordinate
+  /// \param[in] _y y coordinate
+  public: void Add(const double _x, const double _y)
+  {
+    this->open.Add(_x, _y);
+    if (this->open.count < this->span)
+      return;
+
+    if (this->buckets.size() < kCapacity)
+    {
+      this->buckets.push_back(this->open);
+    }
+    else
+    {
+      this->buckets[this->head] = this->open;
+      this->head = (this->head + 1) % kCapacity;
+    }
+    this->open = PlotBucket();
+  }
+
+  /// \brief Remove all buckets.
+  public: void Clear()
+  {
+    this->buckets.clear();
+    this->head = 0;
+    this->open = PlotBucket();
+  }
+
+  /// \brief Number of buckets, including the open one if it has points
+  /// \return Bucket count
+  public: std::size_t Size() const
+  {
+    return this->buckets.size() + (this->open.count > 0 ? 1 : 0);
+  }
+
+  /// \brief Get a bucket.
+  /// \param[in] _index Bucket index, 0 being the oldest and the open bucket
+  /// the newest.
+  /// \return The bucket
+  public: const PlotBucket &At(const std::size_t _index) const
+  {
+    if (_index == this->buckets.size())
+      return this->open;
+    return this->buckets[(this->head + _index) % this->buckets.size()];
+  }
+
+  /// \brief Most closed buckets kept
+  public: static constexpr std::size_t kCapacity = 4096;
+
+  /// \brief Closed buckets. Grows up to kCapacity, then wraps around.
+  public: std::vector<PlotBucket> buckets;
+
+  /// \brief Index of the oldest closed bucket, 0 until full
+  public: std::size_t head = 0;
+
+  /// \brief Bucket the next points go to
+  public: PlotBucket open;
+
+  /// \brief Number of points in each bucket
+  public: std::size_t span = 1;
+};
+
+/// \brief Range of items to draw between two x coordinates, plus the items
+/// right outside of it.
+/// \param[in] _size Number of items, sorted by x
+/// \param[in] _minX Lowest x coordinate
+/// \param[in] _maxX Highest x coordinate
+/// \param[in] _firstX Function giving the x coordinate an item starts at
+/// \param[in] _lastX Function giving the x coordinate an item ends at
+/// \return First item and one past the last item
+template<typename First, typename Last>
+static std::pair<std::size_t, std::size_t> VisibleRange(
+    const std::size_t _size, const double _minX, const double _maxX,
+    First _firstX, Last _lastX)
+{
+  // first item ending at or after _minX
+  std::size_t begin = 0;
+  std::size_t count = _size;
+  while (count > 0)
+  {
+    auto step = count / 2;
+    if (_lastX(begin + step) < _minX)
+    {
+      begin += step + 1;
+      count -= step + 1;
+    }
+    else
+    {
+      count = step;
+    }
+  }
+
+  // first item starting after _maxX
+  std::size_t end = begin;
+  count = _size - begin;
+  while (count > 0)
+  {
+    auto step = count / 2;
+    if (_firstX(end + step) <= _maxX)
+    {
+      end += step + 1;
+      count -= step + 1;
+    }
+    else
+    {
+      count = step;
+    }
+  }
+
+  if (begin > 0)
+    --begin;
+  if (end < _size)
+    ++end;
+  return {begin, end};
+}
+
+/// \brief Points of a series recorded to an append-only file, in chunks
+/// of kChunk points. Each chunk is a column of x coordinates followed by a
+/// column of y coordinates, as doubles in native byte order, after an 8
+/// character "IGNREC01" header. Only the x range of each chunk and the
+/// chunk being filled are kept in memory, chunks are mapped from the file
+/// when read.
+class PlotRecording
+{
+  /// \brief Points in each chunk
+  public: static constexpr std::size_t kChunk = 4096;
+
+  /// \brief Size of the file header
+  public: static constexpr qint64 kHeader = 8;
+
+  /// \brief Create the file, replacing any file at that path.
+  /// \param[in] _path File path
+  /// \return False if the file can't be written
+  public: bool Open(const QString &_path)
+  {
+    this->file.setFileName(_path);
+    if (!this->file.open(QIODevice::ReadWrite | QIODevice::Truncate))
+    {
+      ignerr << "Can't record plot to [" << _path.toStdString() << "]: "
+             << this->file.errorString().toStdString() << std::endl;
+      return false;
+    }
+    this->file.write("IGNREC01", kHeader);
+    this->file.flush();
+    return true;
+  }
+
+  /// \brief Add a point, writing the chunk once full.
+  /// \param[in] _x x coordinate
+  /// \param[in] _y y coordinate
+  public: void Add(const double _x, const double _y)
+  {
+    if (!this->file.isOpen())
+      return;
+
+    this->x.push_back(_x);
+    this->y.push_back(_y);
+    if (this->x.size() < kChunk)
+      return;
+
+    const qint64 columnSize = kChunk * sizeof(double);
+    if (this->file.write(reinterpret_cast<const char *>(this->x.data()),
+            columnSize) != columnSize ||
+        this->file.write(reinterpret_cast<const char *>(this->y.data()),
+            columnSize) != columnSize || !this->file.flush())
+    {
+      ignerr << "Failed to record plot to ["
+             << this->file.fileName().toStdString() << "], recording stops"
+             << std::endl;
+      this->file.close();
+    }
+    else
+    {
+      this->chunks.emplace_back(this->x.front(), this->x.back());
+    }
+    this->x.clear();
+    this->y.clear();
+  }
+
+  /// \brief Drop all points, keeping on recording to the same file.
+  public: void Clear()
+  {
+    this->chunks.clear();
+    this->x.clear();
+    this->y.clear();
+    if (this->file.isOpen())
+    {
+      this->file.resize(kHeader);
+      this->file.seek(kHeader);
+    }
+  }
+
+  /// \brief x coordinate of the oldest point recorded.
+  /// \return x coordinate, or infinity if there are none.
+  public: double FirstX() const
+  {
+    if (!this->chunks.empty())
+      return this->chunks.front().first;
+    if (!this->x.empty())
+      return this->x.front();
+    return std::numeric_limits<double>::infinity();
+  }
+
+  /// \brief Read the points between two x coordinates, plus the ones right
+  /// outside, if there are no more than a number of them.
+  /// \param[in] _minX Lowest x coordinate
+  /// \param[in] _maxX Highest x coordinate
+  /// \param[in] _count Most points read
+  /// \param[out] _points Points read, oldest first
+  /// \return False if there are too many points in the range
+  public: bool Read(const double _minX, const double _maxX,
+                    const std::size_t _count, QVector<QPointF> &_points)
+  {
+    auto chunkCount = this->chunks.size();
+    auto range = VisibleRange(chunkCount, _minX, _maxX,
+        [this](std::size_t _i) {return this->chunks[_i].first;},
+        [this](std::size_t _i) {return this->chunks[_i].second;});
+
+    // leaving out the chunk right outside and the one partly in range on
+    // each side, the chunks are full of visible points
+    if (range.second - range.first > 4 &&
+        (range.second - range.first - 4) * kChunk > _count)
+    {
+      return false;
+    }
+
+    // map the chunks in range, and go on with the chunk being filled
+    const uchar *mapped{nullptr};
+    auto mappedChunks = range.second - range.first;
+    if (mappedChunks > 0)
+    {
+      mapped = this->file.map(
+          kHeader + static_cast<qint64>(range.first * kChunk * 2 *
+              sizeof(double)),
+          static_cast<qint64>(mappedChunks * kChunk * 2 * sizeof(double)));
+      if (!mapped)
+      {
+        ignerr << "Can't map recorded plot ["
+               << this->file.fileName().toStdString() << "]" << std::endl;
+        return false;
+      }
+    }
+    bool pending = (range.second == chunkCount);
+
+    auto size = mappedChunks * kChunk + (pending ? this->x.size() : 0);
+    auto column = [&](std::size_t _i, bool _y)
+    {
+      if (_i >= mappedChunks * kChunk)
+      {
+        auto i = _i - mappedChunks * kChunk;
+        return _y ? this->y[i] : this->x[i];
+      }
+      auto chunk = reinterpret_cast<const double *>(mapped) +
+          (_i / kChunk) * kChunk * 2;
+      return chunk[(_y ? kChunk : 0) + _i % kChunk];
+    };
+    auto pointX = [&column](std::size_t _i) {return column(_i, false);};
+
+    auto points = VisibleRange(size, _minX, _maxX, pointX, pointX);
+    bool fits = (points.second - points.first <= _count);
+    if (fits)
+    {
+      _points.reserve(static_cast<int>(points.second - points.first));
+      for (auto i = points.first; i < points.second; ++i)
+        _points.append(QPointF(column(i, false), column(i, true)));
+    }
+
+    if (mapped)
+      this->file.unmap(const_cast<uchar *>(mapped));
+    return fits;
+  }
+
+  /// \brief File being recorded to, closed if writing failed
+  public: QFile file;
+
+  /// \brief x range of each chunk in the file, oldest first
+  public: std::vector<std::pair<double, double>> chunks;
+
+  /// \brief x coordinates of the chunk being filled
+  public: std::vector<double> x;
+
+  /// \brief y coordinates of the chunk being filled
+  public: std::vector<double> y;
+};
+
+class PlotSeriesPrivate
+{
+  /// \brief Constructor, sets the span of each level
+  public: PlotSeriesPrivate()
+  {
+    std::size_t span = kFanout;
+    for (auto &level : this->levels)
+    {
+      level.span = span;
+      span *= kFanout;
+    }
+  }
+
+  /// \brief Storage index of a point
+  /// \param[in] _index Point index, 0 being the oldest
+  /// \return Index in x and y
+  public: std::size_t Index(const std::size_t _index) const
+  {
+    return (this->head + _index) % this->x.size();
+  }
+
+  /// \brief x coordinates. Grows up to the capacity, then wraps around.
+  public: std::vector<double> x;
+
+  /// \brief y coordinates, same layout as x
+  public: std::vector<double> y;
+
+  /// \brief Storage index of the oldest point, 0 until full
+  public: std::size_t head = 0;
+
+  /// \brief Most points kept
+  public: std::size_t capacity;
+
+  /// \brief Number of buckets of a level summed up in each bucket of the
+  /// next level
+  public: static constexpr std::size_t kFanout = 4;
+
+  /// \brief Levels of detail, finest first
+  public: std::array<PlotLevel, 10> levels;
+
+  /// \brief Bounds of all points since the last Clear
+  public: QRectF bounds;
+
+  /// \brief Statistics of the y coordinates of all points since the last
+  /// Clear
+  public: PlotStatistics statistics;
+
+  /// \brief File points are recorded to, null if not recording
+  public: std::unique_ptr<PlotRecording> recording;
+};
+
+/// \brief A field path resolved against a message type
+struct FieldAccessor
+{
+  /// \brief Message type the path was resolved against, null if it wasn't
+  /// resolved yet
+  const google::protobuf::Descriptor *type = nullptr;
+
+  /// \brief Fields to go through from the message down to the plotted
+  /// one, which is the last. Empty if the path doesn't exist in the type.
+  std::vector<const google::protobuf::FieldDescriptor *> fields;
+};
+
+class PlotClockPrivate
+{
+  /// \brief Store the simulation time of a stats msg
+  /// \param[in] _msg World statistics
+  public: void OnStats(const msgs::WorldStatistics &_msg)
+  {
+    this->simTime = _msg.sim_time().sec() + _msg.sim_time().nsec() * 1e-9;
+    this->hasSimTime = true;
+  }
+
+  /// \brief When the clock was created
+  public: std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+
+  /// \brief Last simulation time received
+  public: std::atomic<double> simTime{0};
+
+  /// \brief True once a simulation time was received
+  public: std::atomic<bool> hasSimTime{false};
+
+  /// \brief Subscription to the stats topic, 0 if none
+  public: std::size_t subscription{0};
+};
+
+/// \brief Applies the sampling policy of a field to its samples
+class FieldSampler
+{
+  /// \brief Add a sample.
+  /// \param[in] _time Sample time
+  /// \param[in] _value Sample value
+  /// \param[out] _samples Samples to plot are appended to these
+  public: void Add(const double _time, const double _value,
+                   std::vector<QPointF> &_samples)
+  {
+    // time went back, such as when a simulation is reset
+    if (this->started && _time < this->last)
+      this->Reset();
+
+    switch (this->policy.mode)
+    {
+      case PlotSampling::Mode::ALL:
+        _samples.push_back(QPointF(_time, _value));
+        break;
+
+      case PlotSampling::Mode::THROTTLE:
+        if (this->started && _time - this->last < this->policy.period)
+          return;
+        _samples.push_back(QPointF(_time, _value));
+        break;
+
+      case PlotSampling::Mode::DECIMATE:
+        if (this->bucketCount++ % std::max(this->policy.count, 1u) == 0)
+          _samples.push_back(QPointF(_time, _value));
+        break;
+
+      case PlotSampling::Mode::AVERAGE:
+      case PlotSampling::Mode::MIN_MAX:
+        if (this->bucketCount == 0)
+        {
+          this->bucketStart = _time;
+          this->sum = 0;
+          this->low = this->high = QPointF(_time, _value);
+        }
+        ++this->bucketCount;
+        this->sum += _value;
+        if (_value < this->low.y())
+          this->low = QPointF(_time, _value);
+        if (_value > this->high.y())
+          this->high = QPointF(_time, _value);
+
+        if (_time - this->bucketStart >= this->policy.period)
+        {
+          if (this->policy.mode == PlotSampling::Mode::AVERAGE)
+          {
+            _samples.push_back(QPointF(_time, this->sum / this->bucketCount));
+          }
+          else if (this->low.x() == this->high.x())
+          {
+            _samples.push_back(this->low);
+          }
+          else
+          {
+            _samples.push_back(
+                this->low.x() < this->high.x() ? this->low : this->high);
+            _samples.push_back(
+                this->low.x() < this->high.x() ? this->high : this->low);
+          }
+          this->bucketCount = 0;
+        }
+        break;
+    }
+
+    this->started = true;
+    this->last = _time;
+  }
+
+  /// \brief Forget the previous samples.
+  public: void Reset()
+  {
+    this->started = false;
+    this->bucketCount = 0;
+  }
+
+  /// \brief Sampling policy
+  public: PlotSampling policy;
+
+  /// \brief True once a sample was added
+  public: bool started{false};
+
+  /// \brief Time of the last sample added
+  public: double last{0};
+
+  /// \brief Samples in the current bucket, or seen for DECIMATE
+  public: std::size_t bucketCount{0};
+
+  /// \brief Time of the first sample of the bucket
+  public: double bucketStart{0};
+
+  /// \brief Sum of the bucket's values
+  public: double sum{0};
+
+  /// \brief Lowest sample of the bucket
+  public: QPointF low;
+
+  /// \brief Highest sample of the bucket
+  public: QPointF high;
+};
+
+/// \brief What callbacks change as they read a field
+struct FieldState
+{
+  /// \brief Sampling policy and state
+  FieldSampler sampler;
+
+  /// \brief Resolved field path, so msgs don't go through names
+  FieldAccessor accessor;
+};
+
+/// \brief A registered field, as read by callbacks. Entries are copied
+/// into a new table for each change, the published ones are never
+/// modified.
+struct TopicField
+{
+  /// \brief Field path
+  std::string path;
+
+  /// \brief Full path ID, kept so it isn't rebuilt for each point
+  QString id;
+
+  /// \brief Charts the field is plotted on
+  std::vector<int> charts;
+
+  /// \brief Series handles of the field, one per chart
+  std::vector<int> handles;
+
+  /// \brief Latest value of the field
+  std::shared_ptr<PlotData> data;
+
+  /// \brief Only used by callbacks, replaced when the policy changes
+  std::shared_ptr<FieldState> state;
+};
+
 class TopicPrivate
 {
+  /// \brief Get the accessor of a field path for a message type, resolving
+  /// it if it's the first time or if the type changed.
+  /// \param[in] _path field path, names separated by '-'
+  /// \param[in] _type message type
+  /// \param[in,out] _accessor accessor resolved for the previous type
+  /// \param[in] _warn whether to warn if the path can't be followed
+  /// \return accessor, with no fields if the path can't be followed
+  public: const FieldAccessor &Accessor(const std::string &_path,
+              const google::protobuf::Descriptor *_type,
+              FieldAccessor &_accessor, const bool _warn = true);
+
+  /// \brief Register a chart to a field.
+  /// \param[in] _fieldPath field path
+  /// \param[in] _chart chart ID
+  /// \param[in] _sampling new sampling policy of the field, null to keep
+  /// the current one
+  public: void Register(const std::string &_fieldPath, int _chart,
+                        const PlotSampling *_sampling);
+
+  /// \brief Publish the registry as the table read by callbacks.
+  public: void Publish();
+
+  /// \brief Queue a point on all charts of a field.
+  /// \param[in] _field field
+  /// \param[in] _x x coordinate
+  /// \param[in] _y y coordinate
+  public: void Queue(const TopicField &_field, double _x, double _y);
+
   /// \brief Check the plotable types and get data from reflection
   /// \param[in] _msg Message to get data from
   /// \param[in] _field Field within the message to get
@@ -61,542 +680,2061 @@ class TopicPrivate
   /// \brief Default Plotting time
   public: std::shared_ptr<double> plottingTime;
 
-  /// \brief Previous header time to limit the frequency of publishing
-  public: double lastHeaderTime = 0;
+  /// \brief Clock giving the time of msgs without header
+  public: std::shared_ptr<const PlotClock> clock;
+
+  /// \brief Registered fields, changed on the thread registering them
+  public: std::map<std::string, TopicField> registry;
 
-  /// \brief Plotting fields to update its values
+  /// \brief Plotting fields to update its values, a view of the registry
   public: std::map<std::string, ignition::gui::PlotData*> fields;
+
+  /// \brief Fields read by callbacks without locking the registry. Only
+  /// accessed with std::atomic_load and std::atomic_store, a callback
+  /// keeps the table it loaded alive until it's done.
+  public: std::shared_ptr<const std::vector<TopicField>> table;
+
+  /// \brief Serializes callbacks coming from several threads, never
+  /// taken when fields are registered
+  public: std::mutex callbackMutex;
+
+  /// \brief Samples to plot for the field being updated, kept to reuse
+  /// its memory
+  public: std::vector<QPointF> samples;
+
+  /// \brief Path from the msg to its header stamp seconds, resolved for the
+  /// last msg type seen. No fields if the type has no header stamp.
+  public: FieldAccessor stampAccessor;
+
+  /// \brief Nanoseconds of the header stamp, next to the seconds
+  public: const google::protobuf::FieldDescriptor *nsecField = nullptr;
+
+  /// \brief Points waiting to be taken
+  public: PlotHandlePoints points;
+
+  /// \brief Protects points
+  public: std::mutex pointsMutex;
+};
+
+class TransportPrivate
+{
+  /// \brief Node for Commincation, only used to list topics
+  public: ignition::transport::Node node;
+
+  /// \brief subscribed topics
+  public: std::map<std::string, ignition::gui::Topic*> topics;
+
+  /// \brief Owners of the subscribed topics. Subscriptions share them, so
+  /// a topic outlives the callbacks in flight when it's unsubscribed.
+  public: std::map<std::string, std::shared_ptr<ignition::gui::Topic>>
+      handlers;
+
+  /// \brief Subscriptions to the topics, shared with other plugins
+  public: std::map<std::string, std::size_t> subscriptions;
+
+  /// \brief Most messages per second received on each topic, 0 for no
+  /// limit
+  public: double msgsPerSec{0.0};
+
+  /// \brief Stop receiving a topic.
+  /// \param[in] _topic Topic name
+  public: void Remove(const std::string &_topic)
+  {
+    SubscriptionHub::Instance()->Unsubscribe(this->subscriptions[_topic]);
+    this->subscriptions.erase(_topic);
+    this->handlers.erase(_topic);
+    this->topics.erase(_topic);
+  }
+};
+
+/// \brief A series to export, copied from the store so it can be written
+/// on another thread
+struct ExportJob
+{
+  /// \brief File to write
+  std::string filePath;
+
+  /// \brief Series name written in the file
+  std::string key;
+
+  /// \brief x coordinates, oldest first
+  std::vector<double> x;
+
+  /// \brief y coordinates, oldest first
+  std::vector<double> y;
+};
+
+/// \brief Write an exported series to its file.
+/// \param[in] _job Series to write
+/// \param[in] _binary True for the binary format, false for csv
+/// \param[in] _progress Called with the number of points written since the
+/// last call
+/// \return True if the whole series was written
+static bool WriteExport(const ExportJob &_job, const bool _binary,
+    const std::function<void(std::size_t)> &_progress)
+{
+  // progress is reported every that many points
+  const std::size_t kChunk = 65536;
+
+  std::vector<char> buffer(1 << 20);
+  std::ofstream file;
+  file.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+  file.open(_job.filePath, _binary ? std::ios::binary : std::ios::out);
+  if (!file.is_open())
+  {
+    ignwarn << "[Couldn't open file: " << _job.filePath << "]" << std::endl;
+    return false;
+  }
+
+  auto size = _job.x.size();
+  if (_binary)
+  {
+    auto keySize = static_cast<uint32_t>(_job.key.size());
+    auto count = static_cast<uint64_t>(size);
+    file.write("IGNPLT01", 8);
+    file.write(reinterpret_cast<const char *>(&keySize), sizeof(keySize));
+    file.write(_job.key.data(), keySize);
+    file.write(reinterpret_cast<const char *>(&count), sizeof(count));
+    for (const auto *column : {&_job.x, &_job.y})
+    {
+      for (std::size_t i = 0; i < size; i += kChunk)
+      {
+        auto n = std::min(kChunk, size - i);
+        file.write(reinterpret_cast<const char *>(column->data() + i),
+            static_cast<std::streamsize>(n * sizeof(double)));
+
+        // each column is half of the work
+        _progress(column == &_job.x ? n / 2 : n - n / 2);
+      }
+    }
+  }
+  else
+  {
+    file << "time, " << _job.key << '\n';
+    for (std::size_t i = 0; i < size; ++i)
+    {
+      file << _job.x[i] << ", " << _job.y[i] << '\n';
+      if ((i + 1) % kChunk == 0)
+        _progress(kChunk);
+    }
+    _progress(size % kChunk);
+  }
+
+  file.close();
+  if (file.fail())
+  {
+    ignwarn << "[Couldn't write file: " << _job.filePath << "]" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+/// \brief Handles given to series, see PlottingInterface::Handle
+struct SeriesHandles
+{
+  /// \brief Handles by chart and field ID
+  std::map<std::pair<int, QString>, int> handles;
+
+  /// \brief Chart and field ID of each handle
+  std::vector<std::pair<int, QString>> keys;
+
+  /// \brief Protects the members above
+  std::mutex mutex;
 };
 
-class TransportPrivate
+/// \brief Get the handles of the process.
+/// \return Handles
+static SeriesHandles &Handles()
+{
+  static SeriesHandles handles;
+  return handles;
+}
+
+/// \brief A stored series, as found by its handle
+struct HandleSeries
+{
+  /// \brief Chart ID
+  int chart;
+
+  /// \brief Stored points, owned by PlottingIfacePrivate::series
+  PlotSeries *series;
+};
+
+/// \brief A series derived from others of its chart
+struct DerivedSeries
+{
+  /// \brief Compiled expression
+  PlotExpression expression;
+
+  /// \brief Handles of the inputs, in the order of the expression inputs
+  std::vector<int> inputs;
+
+  /// \brief Latest value of each input
+  std::vector<double> values;
+
+  /// \brief Whether each input got a value
+  std::vector<bool> seen;
+
+  /// \brief Number of inputs which didn't get a value yet
+  std::size_t missing{0u};
+};
+
+/// \brief Spectrum of a series, refreshed on a worker
+struct SpectrumJob
+{
+  /// \brief Transform, only used by the worker
+  std::unique_ptr<PlotSpectrum> spectrum;
+
+  /// \brief Triggers refreshes
+  QTimer timer;
+
+  /// \brief Latest spectrum, as amplitudes by frequency
+  QVector<QPointF> points;
+
+  /// \brief Bounds of points
+  QRectF bounds;
+};
+
+class PlottingIfacePrivate
+{
+  /// \brief Evaluate the derived series for new points of their inputs,
+  /// in the order of the x coordinates across inputs.
+  /// \param[in] _points new points
+  /// \param[in,out] _derived points of the derived series are appended
+  /// to these
+  public: void Derive(const PlotHandlePoints &_points,
+                      PlotHandlePoints &_derived);
+
+  /// \brief Responsible for transport messages and topics
+  public: Transport transport;
+
+  /// \brief Clock giving the time of msgs without header, shared with
+  /// topics which read it as msgs arrive
+  public: std::shared_ptr<PlotClock> clock = std::make_shared<PlotClock>();
+
+  /// \brief Stored points, by chart and then by field path or component ID
+  public: std::map<int, std::map<QString, std::unique_ptr<PlotSeries>>>
+      series;
+
+  /// \brief Stored points by series handle, a view of series
+  public: std::unordered_map<int, HandleSeries> byHandle;
+
+  /// \brief Handles of the series which got points since the UI was last
+  /// notified
+  public: std::set<int> changed;
+
+  /// \brief Derived series, by handle
+  public: std::unordered_map<int, DerivedSeries> derived;
+
+  /// \brief Points plotted one at a time since the last flush, kept for
+  /// the derived series. Empty without derived series.
+  public: PlotHandlePoints pending;
+
+  /// \brief Points plotted in batches since the last flush
+  public: PlotHandlePoints batched;
+
+  /// \brief Protects batched
+  public: std::mutex batchedMutex;
+
+  /// \brief Spectra being computed, by series handle. The jobs are the
+  /// owners of their worker tasks.
+  public: std::map<int, std::unique_ptr<SpectrumJob>> spectra;
+
+  /// \brief timer to notify the UI of new points, a lot less often than
+  /// points may come in
+  public: QTimer flushTimer;
+
+  /// \brief Thread writing the last export
+  public: std::thread exportThread;
+
+  /// \brief True while an export is being written
+  public: std::atomic<bool> exporting{false};
+
+  /// \brief Folder series are recorded to, empty if not recording
+  public: QString recordPath;
+
+  /// \brief Sampling of fields without a policy of their own
+  public: PlotSampling defaultSampling;
+
+  /// \brief Sampling of specific fields, by topic and field path
+  public: std::map<std::pair<std::string, std::string>, PlotSampling>
+      sampling;
+};
+
+}
+}
+
+using namespace ignition;
+using namespace gui;
+
+//////////////////////////////////////////////////////
+PlotData::PlotData() :
+    dataPtr(std::make_unique<PlotDataPrivate>())
+{
+  this->dataPtr->value = 0;
+}
+
+//////////////////////////////////////////////////////
+PlotData::~PlotData()
+{
+}
+
+//////////////////////////////////////////////////////
+void PlotData::SetValue(const double _value)
+{
+  this->dataPtr->value = _value;
+}
+
+//////////////////////////////////////////////////////
+double PlotData::Value() const
+{
+  return this->dataPtr->value;
+}
+
+//////////////////////////////////////////////////////
+void PlotData::SetTime(const double _time)
+{
+  this->dataPtr->time = _time;
+}
+
+//////////////////////////////////////////////////////
+double PlotData::Time() const
+{
+  return this->dataPtr->time;
+}
+
+//////////////////////////////////////////////////////
+void PlotData::AddChart(int _chart)
+{
+  this->dataPtr->charts.insert(_chart);
+}
+
+//////////////////////////////////////////////////////
+void PlotData::RemoveChart(int _chart)
+{
+  auto chartIt = this->dataPtr->charts.find(_chart);
+  if (chartIt != this->dataPtr->charts.end())
+    this->dataPtr->charts.erase(chartIt);
+}
+
+//////////////////////////////////////////////////////
+int PlotData::ChartCount() const
+{
+  return this->dataPtr->charts.size();
+}
+
+//////////////////////////////////////////////////////
+std::set<int> &PlotData::Charts()
+{
+  return this->dataPtr->charts;
+}
+
+//////////////////////////////////////////////////////
+PlotSeries::PlotSeries(const std::size_t _capacity) :
+    dataPtr(std::make_unique<PlotSeriesPrivate>())
+{
+  this->dataPtr->capacity = std::max<std::size_t>(_capacity, 1);
+}
+
+//////////////////////////////////////////////////////
+PlotSeries::~PlotSeries()
+{
+}
+
+//////////////////////////////////////////////////////
+void PlotSeries::Append(const double _x, const double _y)
+{
+  for (auto &level : this->dataPtr->levels)
+    level.Add(_x, _y);
+  if (this->dataPtr->recording)
+    this->dataPtr->recording->Add(_x, _y);
+  this->dataPtr->statistics.Add(_y);
+
+  auto &bounds = this->dataPtr->bounds;
+  if (this->dataPtr->x.empty())
+  {
+    bounds = QRectF(_x, _y, 0, 0);
+  }
+  else
+  {
+    bounds.setLeft(std::min(bounds.left(), _x));
+    bounds.setRight(std::max(bounds.right(), _x));
+    bounds.setTop(std::min(bounds.top(), _y));
+    bounds.setBottom(std::max(bounds.bottom(), _y));
+  }
+
+  // fill up first, then overwrite the oldest point
+  if (this->dataPtr->x.size() < this->dataPtr->capacity)
+  {
+    this->dataPtr->x.push_back(_x);
+    this->dataPtr->y.push_back(_y);
+    return;
+  }
+
+  this->dataPtr->x[this->dataPtr->head] = _x;
+  this->dataPtr->y[this->dataPtr->head] = _y;
+  this->dataPtr->head = (this->dataPtr->head + 1) % this->dataPtr->capacity;
+}
+
+//////////////////////////////////////////////////////
+void PlotSeries::Clear()
+{
+  this->dataPtr->x.clear();
+  this->dataPtr->y.clear();
+  this->dataPtr->head = 0;
+  for (auto &level : this->dataPtr->levels)
+    level.Clear();
+  if (this->dataPtr->recording)
+    this->dataPtr->recording->Clear();
+  this->dataPtr->bounds = QRectF();
+  this->dataPtr->statistics.Clear();
+}
+
+//////////////////////////////////////////////////////
+std::size_t PlotSeries::Size() const
+{
+  return this->dataPtr->x.size();
+}
+
+//////////////////////////////////////////////////////
+std::size_t PlotSeries::Capacity() const
+{
+  return this->dataPtr->capacity;
+}
+
+//////////////////////////////////////////////////////
+void PlotSeries::SetCapacity(const std::size_t _capacity)
+{
+  auto capacity = std::max<std::size_t>(_capacity, 1);
+  auto size = this->Size();
+  auto kept = std::min(size, capacity);
+
+  // lay the newest points out from the start again
+  std::vector<double> x, y;
+  x.reserve(kept);
+  y.reserve(kept);
+  for (auto i = size - kept; i < size; ++i)
+  {
+    x.push_back(this->X(i));
+    y.push_back(this->Y(i));
+  }
+
+  this->dataPtr->x.swap(x);
+  this->dataPtr->y.swap(y);
+  this->dataPtr->head = 0;
+  this->dataPtr->capacity = capacity;
+}
+
+//////////////////////////////////////////////////////
+double PlotSeries::X(const std::size_t _index) const
+{
+  return this->dataPtr->x[this->dataPtr->Index(_index)];
+}
+
+//////////////////////////////////////////////////////
+double PlotSeries::Y(const std::size_t _index) const
+{
+  return this->dataPtr->y[this->dataPtr->Index(_index)];
+}
+
+//////////////////////////////////////////////////////
+bool PlotSeries::Nearest(const double _x, QPointF &_point) const
+{
+  auto size = this->Size();
+  if (size == 0)
+    return false;
+
+  // first point at or after _x, indices going from oldest to newest
+  std::size_t first = 0;
+  std::size_t count = size;
+  while (count > 0)
+  {
+    auto step = count / 2;
+    if (this->X(first + step) < _x)
+    {
+      first += step + 1;
+      count -= step + 1;
+    }
+    else
+    {
+      count = step;
+    }
+  }
+
+  if (first == size ||
+      (first > 0 && _x - this->X(first - 1) < this->X(first) - _x))
+  {
+    --first;
+  }
+  _point = QPointF(this->X(first), this->Y(first));
+  return true;
+}
+
+//////////////////////////////////////////////////////
+QVector<QPointF> PlotSeries::Points(const double _minX, const double _maxX,
+                                    const std::size_t _count,
+                                    bool *_full) const
+{
+  QVector<QPointF> points;
+  if (_full)
+    *_full = true;
+  if (this->Size() == 0)
+    return points;
+
+  auto count = std::max<std::size_t>(_count, 2);
+  auto oldestX = this->dataPtr->bounds.left();
+
+  // full resolution, if it goes back far enough and isn't too dense
+  if (this->X(0) <= _minX || this->X(0) <= oldestX)
+  {
+    auto x = [this](std::size_t _i) {return this->X(_i);};
+    auto range = VisibleRange(this->Size(), _minX, _maxX, x, x);
+    if (range.second - range.first <= count)
+    {
+      points.reserve(static_cast<int>(range.second - range.first));
+      for (auto i = range.first; i < range.second; ++i)
+        points.append(QPointF(this->X(i), this->Y(i)));
+      return points;
+    }
+  }
+
+  // then the recording, read from disk at full resolution
+  auto recording = this->dataPtr->recording.get();
+  if (this->Recording() && (recording->FirstX() <= _minX ||
+      recording->FirstX() <= oldestX))
+  {
+    if (recording->Read(_minX, _maxX, count, points))
+      return points;
+    points.clear();
+  }
+
+  // otherwise the finest level that does, which gives up to 2 points per
+  // bucket. The coarsest level is used if none fits.
+  if (_full)
+    *_full = false;
+  const auto &levels = this->dataPtr->levels;
+  for (std::size_t l = 0; l < levels.size(); ++l)
+  {
+    const auto &level = levels[l];
+    bool last = (l + 1 == levels.size());
+    if (!last && level.At(0).firstX > _minX && level.At(0).firstX > oldestX)
+      continue;
+
+    auto range = VisibleRange(level.Size(), _minX, _maxX,
+        [&level](std::size_t _i) {return level.At(_i).firstX;},
+        [&level](std::size_t _i) {return level.At(_i).lastX;});
+    if (!last && (range.second - range.first) * 2 > count)
+      continue;
+
+    points.reserve(static_cast<int>(range.second - range.first) * 2);
+    for (auto i = range.first; i < range.second; ++i)
+    {
+      const auto &bucket = level.At(i);
+      QPointF low(bucket.minX, bucket.minY);
+      QPointF high(bucket.maxX, bucket.maxY);
+      if (bucket.count == 1)
+      {
+        points.append(low);
+      }
+      else if (low == high)
+      {
+        // flat, keep its length
+        points.append(low);
+        points.append(QPointF(bucket.lastX, bucket.minY));
+      }
+      else if (bucket.minX <= bucket.maxX)
+      {
+        points.append(low);
+        points.append(high);
+      }
+      else
+      {
+        points.append(high);
+        points.append(low);
+      }
+    }
+    break;
+  }
+  return points;
+}
+
+//////////////////////////////////////////////////////
+QRectF PlotSeries::Bounds() const
+{
+  return this->dataPtr->bounds;
+}
+
+//////////////////////////////////////////////////////
+const PlotStatistics &PlotSeries::Statistics() const
+{
+  return this->dataPtr->statistics;
+}
+
+//////////////////////////////////////////////////////
+bool PlotSeries::StartRecording(const std::string &_path)
+{
+  auto recording = std::make_unique<PlotRecording>();
+  if (!recording->Open(QString::fromStdString(_path)))
+    return false;
+
+  this->dataPtr->recording = std::move(recording);
+  return true;
+}
+
+//////////////////////////////////////////////////////
+void PlotSeries::StopRecording()
+{
+  this->dataPtr->recording.reset();
+}
+
+//////////////////////////////////////////////////////
+bool PlotSeries::Recording() const
+{
+  return this->dataPtr->recording &&
+      this->dataPtr->recording->file.isOpen();
+}
+
+//////////////////////////////////////////////////////
+PlotClock::PlotClock() :
+    dataPtr(std::make_unique<PlotClockPrivate>())
+{
+}
+
+//////////////////////////////////////////////////////
+PlotClock::~PlotClock()
+{
+  SubscriptionHub::Instance()->Unsubscribe(this->dataPtr->subscription);
+}
+
+//////////////////////////////////////////////////////
+double PlotClock::Now() const
+{
+  if (this->dataPtr->hasSimTime)
+    return this->dataPtr->simTime;
+
+  return std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - this->dataPtr->start).count();
+}
+
+//////////////////////////////////////////////////////
+bool PlotClock::SetStatsTopic(const std::string &_topic)
+{
+  auto hub = SubscriptionHub::Instance();
+  hub->Unsubscribe(this->dataPtr->subscription);
+  this->dataPtr->subscription = 0;
+  this->dataPtr->hasSimTime = false;
+
+  if (_topic.empty())
+    return true;
+
+  this->dataPtr->subscription = hub->Subscribe(_topic,
+      &PlotClockPrivate::OnStats, this->dataPtr.get());
+  if (!this->dataPtr->subscription)
+  {
+    ignerr << "Failed to subscribe to stats topic [" << _topic << "]"
+           << std::endl;
+    return false;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////////
+bool PlotSampling::Parse(const std::string &_text, PlotSampling &_sampling)
+{
+  std::istringstream stream(_text);
+  std::string name;
+  stream >> name;
+  std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+
+  PlotSampling sampling;
+  if (name == "all")
+  {
+    sampling.mode = Mode::ALL;
+  }
+  else if (name == "decimate")
+  {
+    sampling.mode = Mode::DECIMATE;
+    if (!(stream >> sampling.count) || sampling.count == 0)
+      return false;
+  }
+  else if (name == "throttle" || name == "average" || name == "minmax")
+  {
+    if (name == "throttle")
+      sampling.mode = Mode::THROTTLE;
+    else if (name == "average")
+      sampling.mode = Mode::AVERAGE;
+    else
+      sampling.mode = Mode::MIN_MAX;
+
+    if (!(stream >> sampling.period) || sampling.period < 0)
+      return false;
+  }
+  else
+  {
+    return false;
+  }
+
+  std::string extra;
+  if (stream >> extra)
+    return false;
+
+  _sampling = sampling;
+  return true;
+}
+
+//////////////////////////////////////////////////////
+Topic::Topic(const std::string &_name) : QObject(),
+    dataPtr(std::make_unique<TopicPrivate>())
+{
+  this->dataPtr->name = _name;
+}
+
+//////////////////////////////////////////////////////
+Topic::~Topic()
+{
+}
+
+//////////////////////////////////////////////////////
+std::string &Topic::Name() const
+{
+  return this->dataPtr->name;
+}
+
+//////////////////////////////////////////////////////
+void Topic::Register(const std::string &_fieldPath, int _chart)
+{
+  this->dataPtr->Register(_fieldPath, _chart, nullptr);
+}
+
+//////////////////////////////////////////////////////
+void Topic::Register(const std::string &_fieldPath, int _chart,
+                     const PlotSampling &_sampling)
+{
+  this->dataPtr->Register(_fieldPath, _chart, &_sampling);
+}
+
+//////////////////////////////////////////////////////
+void Topic::UnRegister(const std::string &_fieldPath, int _chart)
+{
+  auto fieldIt = this->dataPtr->registry.find(_fieldPath);
+  if (fieldIt == this->dataPtr->registry.end())
+    return;
+
+  fieldIt->second.data->RemoveChart(_chart);
+
+  // if no one registers to the field, remove it
+  if (!fieldIt->second.data->ChartCount())
+    this->dataPtr->registry.erase(fieldIt);
+
+  this->dataPtr->Publish();
+}
+
+//////////////////////////////////////////////////////
+int Topic::FieldCount() const
+{
+  return this->dataPtr->fields.size();
+}
+
+//////////////////////////////////////////////////////
+std::map<std::string, PlotData*> &Topic::Fields()
+{
+  return this->dataPtr->fields;
+}
+
+//////////////////////////////////////////////////////
+void Topic::Callback(const google::protobuf::Message &_msg)
+{
+  auto table = std::atomic_load(&this->dataPtr->table);
+  if (!table || table->empty())
+    return;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->callbackMutex);
+
+  // header time, or the time it arrived
+  double time;
+  if (!this->HasHeader(_msg, time))
+  {
+    if (this->dataPtr->clock)
+      time = this->dataPtr->clock->Now();
+    else if (this->dataPtr->plottingTime)
+      time = *this->dataPtr->plottingTime;
+    else
+      return;
+  }
+
+  // loop over the registered fields and update them
+  auto msgDescriptor = _msg.GetDescriptor();
+  for (const auto &field : *table)
+  {
+    auto &state = *field.state;
+    const auto &accessor = this->dataPtr->Accessor(field.path,
+        msgDescriptor, state.accessor);
+    if (accessor.fields.empty())
+      continue;
+
+    // go down to the message holding the field, unset messages read as
+    // their defaults
+    const google::protobuf::Message *valueMsg = &_msg;
+    for (std::size_t i = 0; i + 1 < accessor.fields.size(); ++i)
+    {
+      valueMsg = &valueMsg->GetReflection()->GetMessage(*valueMsg,
+          accessor.fields[i]);
+    }
+
+    double data = this->dataPtr->FieldData(*valueMsg,
+        accessor.fields.back());
+
+    // reduce the samples here, before anything is queued for the UI
+    auto &samples = this->dataPtr->samples;
+    samples.clear();
+    state.sampler.Add(time, data, samples);
+
+    for (const auto &sample : samples)
+    {
+      // Field Arrival Time
+      field.data->SetTime(sample.x());
+
+      // Field Value
+      field.data->SetValue(sample.y());
+
+      // Update Field Charts UI
+      this->dataPtr->Queue(field, sample.x(), sample.y());
+    }
+  }
+}
+
+//////////////////////////////////////////////////////
+bool Topic::HasHeader(const google::protobuf::Message &_msg,
+                      double &_headerTime)
+{
+  auto type = _msg.GetDescriptor();
+  if (type != this->dataPtr->stampAccessor.type)
+  {
+    this->dataPtr->Accessor("header-stamp-sec", type,
+        this->dataPtr->stampAccessor, false);
+    this->dataPtr->nsecField = nullptr;
+    if (!this->dataPtr->stampAccessor.fields.empty())
+    {
+      this->dataPtr->nsecField = this->dataPtr->stampAccessor.fields[1]->
+          message_type()->FindFieldByName("nsec");
+    }
+
+    // without nsec, the type is checked again but nothing is read
+    if (!this->dataPtr->nsecField)
+      this->dataPtr->stampAccessor.fields.clear();
+  }
+
+  // most msgs without a header stop here
+  const auto &fields = this->dataPtr->stampAccessor.fields;
+  if (fields.empty())
+    return false;
+
+  auto ref = _msg.GetReflection();
+  if (!ref->HasField(_msg, fields[0]))
+    return false;
+
+  const auto &headerMsg = ref->GetMessage(_msg, fields[0]);
+  const auto &stampMsg = headerMsg.GetReflection()->GetMessage(headerMsg,
+      fields[1]);
+
+  _headerTime = this->dataPtr->FieldData(stampMsg, fields[2]) +
+      this->dataPtr->FieldData(stampMsg, this->dataPtr->nsecField) * 1e-9;
+
+  return true;
+}
+
+//////////////////////////////////////////////////////
+void Topic::UpdateGui(const std::string &_field)
+{
+  auto table = std::atomic_load(&this->dataPtr->table);
+  if (!table)
+    return;
+
+  auto field = std::find_if(table->begin(), table->end(),
+      [&_field](const TopicField &_entry)
+      {
+        return _entry.path == _field;
+      });
+  if (field == table->end())
+    return;
+
+  auto x = field->data->Time();
+
+  // msgs without header time are plotted at the time they arrived
+  if (static_cast<int>(x) == DEFAULT_TIME && this->dataPtr->plottingTime)
+    x = *this->dataPtr->plottingTime;
+
+  this->dataPtr->Queue(*field, x, field->data->Value());
+}
+
+//////////////////////////////////////////////////////
+void Topic::TakePoints(PlotPoints &_points)
+{
+  PlotHandlePoints points;
+  this->TakePoints(points);
+
+  int chart;
+  QString fieldID;
+  for (auto &series : points)
+  {
+    if (PlottingInterface::HandleKey(series.first, chart, fieldID))
+      _points[chart][fieldID].append(series.second);
+  }
+}
+
+//////////////////////////////////////////////////////
+void Topic::TakePoints(PlotHandlePoints &_points)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->pointsMutex);
+  if (_points.empty())
+  {
+    _points.swap(this->dataPtr->points);
+    return;
+  }
+
+  for (auto &series : this->dataPtr->points)
+    _points[series.first].append(series.second);
+  this->dataPtr->points.clear();
+}
+
+//////////////////////////////////////////////////////
+void Topic::SetPlottingTimeRef(const std::shared_ptr<double> &_timeRef)
+{
+  if (!this->dataPtr->plottingTime)
+    this->dataPtr->plottingTime = _timeRef;
+}
+
+//////////////////////////////////////////////////////
+void Topic::SetClock(const std::shared_ptr<const PlotClock> &_clock)
+{
+  this->dataPtr->clock = _clock;
+}
+
+//////////////////////////////////////////////////////
+void TopicPrivate::Register(const std::string &_fieldPath, int _chart,
+                            const PlotSampling *_sampling)
+{
+  // if a new field create a new field and register the chart
+  auto &field = this->registry[_fieldPath];
+  if (!field.data)
+  {
+    field.path = _fieldPath;
+    field.id = QString::fromStdString(this->name + "-" + _fieldPath);
+    field.data = std::make_shared<PlotData>();
+    field.state = std::make_shared<FieldState>();
+  }
+
+  // callbacks may be using the current state, so it's replaced
+  if (_sampling)
+  {
+    field.state = std::make_shared<FieldState>();
+    field.state->sampler.policy = *_sampling;
+  }
+
+  field.data->AddChart(_chart);
+  this->Publish();
+}
+
+//////////////////////////////////////////////////////
+void TopicPrivate::Publish()
+{
+  auto table = std::make_shared<std::vector<TopicField>>();
+  table->reserve(this->registry.size());
+  this->fields.clear();
+  for (auto &field : this->registry)
+  {
+    auto &charts = field.second.charts;
+    charts.assign(field.second.data->Charts().begin(),
+        field.second.data->Charts().end());
+
+    auto &handles = field.second.handles;
+    handles.clear();
+    for (auto chart : charts)
+      handles.push_back(PlottingInterface::Handle(chart, field.second.id));
+
+    table->push_back(field.second);
+    this->fields[field.first] = field.second.data.get();
+  }
+
+  std::shared_ptr<const std::vector<TopicField>> published = table;
+  std::atomic_store(&this->table, published);
+}
+
+//////////////////////////////////////////////////////
+void TopicPrivate::Queue(const TopicField &_field, double _x, double _y)
+{
+  std::lock_guard<std::mutex> lock(this->pointsMutex);
+  for (auto handle : _field.handles)
+    this->points[handle].append(QPointF(_x, _y));
+}
+
+//////////////////////////////////////////////////////
+const FieldAccessor &TopicPrivate::Accessor(const std::string &_path,
+    const google::protobuf::Descriptor *_type, FieldAccessor &_accessor,
+    const bool _warn)
+{
+  using google::protobuf::FieldDescriptor;
+
+  auto &accessor = _accessor;
+  if (accessor.type == _type)
+    return accessor;
+
+  accessor.type = _type;
+  accessor.fields.clear();
+
+  auto names = ignition::common::Split(_path, '-');
+  auto type = _type;
+  for (std::size_t i = 0; i < names.size(); ++i)
+  {
+    auto field = type ? type->FindFieldByName(names[i]) : nullptr;
+
+    // all but the last field must be single messages
+    bool last = i + 1 == names.size();
+    if (!field || field->is_repeated() ||
+        (!last && field->cpp_type() != FieldDescriptor::CPPTYPE_MESSAGE))
+    {
+      if (_warn)
+      {
+        ignwarn << "Can't plot [" << _path << "] of topic [" << this->name
+                << "], it isn't a field of [" << _type->full_name() << "]"
+                << std::endl;
+      }
+      accessor.fields.clear();
+      return accessor;
+    }
+
+    accessor.fields.push_back(field);
+    type = field->message_type();
+  }
+  return accessor;
+}
+
+//////////////////////////////////////////////////////
+double TopicPrivate::FieldData(const google::protobuf::Message &_msg,
+                               const google::protobuf::FieldDescriptor *_field)
+{
+  using namespace google::protobuf;
+  auto ref = _msg.GetReflection();
+  auto type = _field->type();
+
+  if (type == FieldDescriptor::Type::TYPE_DOUBLE)
+    return ref->GetDouble(_msg, _field);
+  else if (type == FieldDescriptor::Type::TYPE_FLOAT)
+    return ref->GetFloat(_msg, _field);
+  else if (type == FieldDescriptor::Type::TYPE_INT32)
+    return ref->GetInt32(_msg, _field);
+  else if (type == FieldDescriptor::Type::TYPE_INT64)
+    return ref->GetInt64(_msg, _field);
+  else if (type == FieldDescriptor::Type::TYPE_BOOL)
+    return ref->GetBool(_msg, _field);
+  else if (type == FieldDescriptor::Type::TYPE_UINT32)
+    return ref->GetUInt32(_msg, _field);
+  else if (type == FieldDescriptor::Type::TYPE_UINT64)
+    return ref->GetUInt64(_msg, _field);
+  else
+  {
+    ignwarn << "Non Plotting Type" << std::endl;
+    return 0;
+  }
+}
+
+////////////////////////////////////////////
+Transport::Transport() : dataPtr(std::make_unique<TransportPrivate>())
 {
-  /// \brief Node for Commincation
-  public: ignition::transport::Node node;
-
-  /// \brief subscribed topics
-  public: std::map<std::string, ignition::gui::Topic*> topics;
-};
+}
 
-class PlottingIfacePrivate
+////////////////////////////////////////////
+Transport::~Transport()
 {
-  /// \brief Responsible for transport messages and topics
-  public: Transport transport;
-
-  /// \brief Plotting time pointer to give access to topics to read it
-  public: std::shared_ptr<double> plottingTimeRef = std::make_shared<double>();
-
-  /// \brief timeout to update the plot with the timer
-  public: int timeout;
+  // unsubscribe from all topics in the transport
+  for (auto subscription : this->dataPtr->subscriptions)
+    SubscriptionHub::Instance()->Unsubscribe(subscription.second);
+}
 
-  /// \brief timer to update the plotting each time step
-  public: QTimer timer;
-};
+////////////////////////////////////////////
+void Transport::Unsubscribe(const std::string &_topic,
+                            const std::string &_fieldPath,
+                            int _chart)
+{
+  if (this->dataPtr->topics.count(_topic))
+  {
+    this->dataPtr->topics[_topic]->UnRegister(_fieldPath, _chart);
 
-}
+    // if there is no registered fields, unsubscribe from the topic
+    if (this->dataPtr->topics[_topic]->FieldCount() == 0)
+      this->dataPtr->Remove(_topic);
+  }
 }
 
-using namespace ignition;
-using namespace gui;
+////////////////////////////////////////////
+void Transport::Subscribe(const std::string &_topic,
+                          const std::string &_fieldPath,
+                          int _chart, const std::shared_ptr<double> &_time,
+                          const PlotSampling &_sampling)
+{
+  this->Subscribe(_topic, _fieldPath, _chart,
+                  std::shared_ptr<const PlotClock>(), _sampling);
+  this->dataPtr->topics[_topic]->SetPlottingTimeRef(_time);
+}
 
-//////////////////////////////////////////////////////
-PlotData::PlotData() :
-    dataPtr(std::make_unique<PlotDataPrivate>())
+////////////////////////////////////////////
+void Transport::Subscribe(const std::string &_topic,
+                          const std::string &_fieldPath,
+                          int _chart,
+                          const std::shared_ptr<const PlotClock> &_clock,
+                          const PlotSampling &_sampling)
 {
-  this->dataPtr->value = 0;
+  // new topic
+  if (this->dataPtr->topics.count(_topic) == 0)
+  {
+    auto topicHandler = std::make_shared<Topic>(_topic);
+    this->dataPtr->topics[_topic] = topicHandler.get();
+    this->dataPtr->handlers[_topic] = topicHandler;
+
+    topicHandler->SetClock(_clock);
+    topicHandler->Register(_fieldPath, _chart, _sampling);
+
+    this->dataPtr->subscriptions[_topic] =
+        SubscriptionHub::Instance()->Subscribe(_topic,
+        [topicHandler](
+            const std::shared_ptr<const google::protobuf::Message> &_msg)
+        {
+          topicHandler->Callback(*_msg);
+        });
+    SubscriptionHub::Instance()->SetMsgsPerSec(
+        this->dataPtr->subscriptions[_topic], this->dataPtr->msgsPerSec);
+  }
+  // already exist topic, callbacks see the new field from their next msg
+  else
+  {
+    this->dataPtr->topics[_topic]->Register(_fieldPath, _chart, _sampling);
+  }
 }
 
 //////////////////////////////////////////////////////
-PlotData::~PlotData()
+void Transport::SetMsgsPerSec(const double _msgsPerSec)
 {
+  this->dataPtr->msgsPerSec = _msgsPerSec;
+  for (const auto &subscription : this->dataPtr->subscriptions)
+    SubscriptionHub::Instance()->SetMsgsPerSec(subscription.second,
+        _msgsPerSec);
 }
 
 //////////////////////////////////////////////////////
-void PlotData::SetValue(const double _value)
+const std::map<std::string, Topic*> &Transport::Topics()
 {
-  this->dataPtr->value = _value;
+  return this->dataPtr->topics;
 }
 
 //////////////////////////////////////////////////////
-double PlotData::Value() const
+void Transport::TakePoints(PlotPoints &_points)
 {
-  return this->dataPtr->value;
+  for (auto topic : this->dataPtr->topics)
+    topic.second->TakePoints(_points);
 }
 
 //////////////////////////////////////////////////////
-void PlotData::SetTime(const double _time)
+void Transport::TakePoints(PlotHandlePoints &_points)
 {
-  this->dataPtr->time = _time;
+  for (auto topic : this->dataPtr->topics)
+    topic.second->TakePoints(_points);
 }
 
 //////////////////////////////////////////////////////
-double PlotData::Time() const
+void Transport::onPlot(int _chart, QString _fieldID, double _x, double _y)
 {
-  return this->dataPtr->time;
+  emit this->plot(_chart, _fieldID, _x, _y);
 }
 
 //////////////////////////////////////////////////////
-void PlotData::AddChart(int _chart)
+void Transport::UnsubscribeOutdatedTopics()
 {
-  this->dataPtr->charts.insert(_chart);
+  // get all topics in the transport
+  std::vector<std::string> topics;
+  this->dataPtr->node.TopicList(topics);
+
+  for (auto topic = this->dataPtr->topics.begin();
+       topic != this->dataPtr->topics.end();)
+  {
+    // check if the topic exist
+    if (std::find(topics.begin(), topics.end(), topic->first) == topics.end())
+    {
+      auto name = topic->first;
+      ++topic;
+      this->dataPtr->Remove(name);
+    }
+    else
+    {
+      ++topic;
+    }
+  }
 }
 
 //////////////////////////////////////////////////////
-void PlotData::RemoveChart(int _chart)
+PlottingInterface::PlottingInterface() : QObject(),
+    dataPtr(std::make_unique<PlottingIfacePrivate>())
 {
-  auto chartIt = this->dataPtr->charts.find(_chart);
-  if (chartIt != this->dataPtr->charts.end())
-    this->dataPtr->charts.erase(chartIt);
+  connect(&this->dataPtr->transport,
+          SIGNAL(plot(int, QString, double, double)), this,
+          SLOT(onPlot(int, QString, double, double)));
+
+  // store all plotted points, including the ones emitted from outside
+  connect(this, SIGNAL(plot(int, QString, double, double)), this,
+          SLOT(OnPoint(int, QString, double, double)));
+
+  // about 30 Hz, which is plenty for the UI
+  this->dataPtr->flushTimer.setInterval(kFlushInterval);
+  connect(&this->dataPtr->flushTimer, SIGNAL(timeout()), this,
+          SLOT(FlushSeries()));
+  this->dataPtr->flushTimer.start();
+
+  // charts draw their series with it
+  qmlRegisterType<PlotItem>("PlotItem", 1, 0, "PlotItem");
+
+  App()->Engine()->rootContext()->setContextProperty("PlottingIface", this);
 }
 
 //////////////////////////////////////////////////////
-int PlotData::ChartCount() const
+PlottingInterface::~PlottingInterface()
 {
-  return this->dataPtr->charts.size();
+  for (auto &spectrum : this->dataPtr->spectra)
+    Executor::Instance().Cancel(spectrum.second.get());
+
+  if (this->dataPtr->exportThread.joinable())
+    this->dataPtr->exportThread.join();
 }
 
 //////////////////////////////////////////////////////
-std::set<int> &PlotData::Charts()
+void PlottingInterface::unsubscribe(int _chart,
+                                    QString _topic,
+                                    QString _fieldPath)
 {
-  return this->dataPtr->charts;
+  this->dataPtr->transport.Unsubscribe(_topic.toStdString(),
+                                       _fieldPath.toStdString(),
+                                       _chart);
 }
 
 //////////////////////////////////////////////////////
-Topic::Topic(const std::string &_name) : QObject(),
-    dataPtr(std::make_unique<TopicPrivate>())
+float PlottingInterface::Timeout() const
 {
-  this->dataPtr->name = _name;
+  return 0;
 }
 
 //////////////////////////////////////////////////////
-Topic::~Topic()
+PlotClock &PlottingInterface::Clock()
 {
-  for (auto field : this->dataPtr->fields)
-    delete field.second;
+  return *this->dataPtr->clock;
 }
 
 //////////////////////////////////////////////////////
-std::string &Topic::Name() const
+QString PlotComponent::Id() const
 {
-  return this->dataPtr->name;
+  return QString::number(this->entity) + "," + QString::number(this->typeId) +
+      "," + QString::fromStdString(this->attribute);
 }
 
 //////////////////////////////////////////////////////
-void Topic::Register(const std::string &_fieldPath, int _chart)
+/// \brief Read a component attribute from QML.
+/// \param[in] _map entity, typeId, type, attribute and chart
+/// \param[out] _component attribute
+/// \return False if the IDs aren't numbers
+static bool ComponentFromMap(const QVariantMap &_map,
+                             PlotComponent &_component)
 {
-  // if a new field create a new field and register the chart
-  if (this->dataPtr->fields.count(_fieldPath) == 0)
-    this->dataPtr->fields[_fieldPath] = new PlotData();
-
-  this->dataPtr->fields[_fieldPath]->AddChart(_chart);
+  bool entityOk{false};
+  bool typeOk{false};
+  _component.entity = _map.value("entity").toULongLong(&entityOk);
+  _component.typeId = _map.value("typeId").toULongLong(&typeOk);
+  _component.type = _map.value("type").toString().toStdString();
+  _component.attribute = _map.value("attribute").toString().toStdString();
+  _component.chart = _map.value("chart").toInt();
+  if (!entityOk || !typeOk)
+  {
+    ignerr << "Invalid component entity [" <<
+        _map.value("entity").toString().toStdString() << "] or type ID [" <<
+        _map.value("typeId").toString().toStdString() << "]" << std::endl;
+    return false;
+  }
+  return true;
 }
 
 //////////////////////////////////////////////////////
-void Topic::UnRegister(const std::string &_fieldPath, int _chart)
+void PlottingInterface::onComponentSubscribe(QString _entity, QString _typeId,
+                                             QString _type, QString _attribute,
+                                             int _chart)
 {
-  this->dataPtr->fields[_fieldPath]->RemoveChart(_chart);
-
-  // if no one registers to the field, remove it
-  if (!this->dataPtr->fields[_fieldPath]->ChartCount())
-    this->dataPtr->fields.erase(_fieldPath);
+  QVariantMap map;
+  map["entity"] = _entity;
+  map["typeId"] = _typeId;
+  map["type"] = _type;
+  map["attribute"] = _attribute;
+  map["chart"] = _chart;
+  this->subscribeComponents({map});
 }
 
 //////////////////////////////////////////////////////
-int Topic::FieldCount() const
+void PlottingInterface::onComponentUnSubscribe(QString _entity, QString _typeId,
+                                               QString _attribute, int _chart)
 {
-  return this->dataPtr->fields.size();
+  QVariantMap map;
+  map["entity"] = _entity;
+  map["typeId"] = _typeId;
+  map["attribute"] = _attribute;
+  map["chart"] = _chart;
+  this->unsubscribeComponents({map});
 }
 
 //////////////////////////////////////////////////////
-std::map<std::string, PlotData*> &Topic::Fields()
+void PlottingInterface::SubscribeComponents(
+    const std::vector<PlotComponent> &_components)
 {
-  return this->dataPtr->fields;
+  if (_components.empty())
+    return;
+
+  // applications which only handle one attribute at a time still get all
+  if (this->receivers(SIGNAL(ComponentsSubscribe(
+      const std::vector<ignition::gui::PlotComponent> &))) > 0)
+  {
+    emit this->ComponentsSubscribe(_components);
+    return;
+  }
+
+  for (const auto &component : _components)
+  {
+    emit this->ComponentSubscribe(component.entity, component.typeId,
+        component.type, component.attribute, component.chart);
+  }
 }
 
 //////////////////////////////////////////////////////
-void Topic::Callback(const google::protobuf::Message &_msg)
+void PlottingInterface::subscribeComponents(QVariantList _components)
 {
-  // check for header time
-  double headerTime;
-  if (!this->HasHeader(_msg, headerTime))
+  std::vector<PlotComponent> components;
+  components.reserve(static_cast<std::size_t>(_components.size()));
+  for (const auto &variant : _components)
   {
-    if (!this->dataPtr->plottingTime)
-        return;
-
-    headerTime = DEFAULT_TIME;
+    PlotComponent component;
+    if (ComponentFromMap(variant.toMap(), component))
+      components.push_back(component);
+  }
+  this->SubscribeComponents(components);
+}
 
-    if (*this->dataPtr->plottingTime - this->dataPtr->lastHeaderTime
-          < MAX_PERIOD_DIFF)
-      return;
+//////////////////////////////////////////////////////
+void PlottingInterface::UnsubscribeComponents(
+    const std::vector<PlotComponent> &_components)
+{
+  if (_components.empty())
+    return;
 
-    this->dataPtr->lastHeaderTime = *this->dataPtr->plottingTime;
+  if (this->receivers(SIGNAL(ComponentsUnSubscribe(
+      const std::vector<ignition::gui::PlotComponent> &))) > 0)
+  {
+    emit this->ComponentsUnSubscribe(_components);
+    return;
   }
-  else
+
+  for (const auto &component : _components)
   {
-    if (headerTime - this->dataPtr->lastHeaderTime < MAX_PERIOD_DIFF)
-        return;
+    emit this->ComponentUnSubscribe(component.entity, component.typeId,
+        component.attribute, component.chart);
+  }
+}
 
-    this->dataPtr->lastHeaderTime = headerTime;
+//////////////////////////////////////////////////////
+void PlottingInterface::unsubscribeComponents(QVariantList _components)
+{
+  std::vector<PlotComponent> components;
+  components.reserve(static_cast<std::size_t>(_components.size()));
+  for (const auto &variant : _components)
+  {
+    PlotComponent component;
+    if (ComponentFromMap(variant.toMap(), component))
+      components.push_back(component);
   }
+  this->UnsubscribeComponents(components);
+}
 
-  // loop over the registered fields and update them
-  for (auto fieldIt : this->dataPtr->fields)
+//////////////////////////////////////////////////////
+void PlottingInterface::PlotBatch(const PlotHandlePoints &_points)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->batchedMutex);
+  if (this->dataPtr->batched.empty())
   {
-    auto msgDescriptor = _msg.GetDescriptor();
-    auto ref = _msg.GetReflection();
+    this->dataPtr->batched = _points;
+    return;
+  }
 
-    google::protobuf::Message *valueMsg = nullptr;
+  for (const auto &series : _points)
+    this->dataPtr->batched[series.first].append(series.second);
+}
 
-    auto fieldFullPath = ignition::common::Split(fieldIt.first, '-');
-    int pathSize = fieldFullPath.size();
+//////////////////////////////////////////////////////
+void PlottingInterface::subscribe(int _chart,
+                                  QString _topic,
+                                  QString _fieldPath)
+{
+  auto topic = _topic.toStdString();
+  auto fieldPath = _fieldPath.toStdString();
 
-    // loop until you reach the last field in the path
-    for (int i = 0; i < pathSize-1 ; i++)
-    {
-      std::string fieldName = fieldFullPath[i];
+  auto sampling = this->dataPtr->defaultSampling;
+  auto samplingIt = this->dataPtr->sampling.find({topic, fieldPath});
+  if (samplingIt != this->dataPtr->sampling.end())
+    sampling = samplingIt->second;
 
-      auto field = msgDescriptor->FindFieldByName(fieldName);
+  this->dataPtr->transport.Subscribe(topic, fieldPath, _chart,
+                                     this->dataPtr->clock, sampling);
+}
 
-      msgDescriptor = field->message_type();
+//////////////////////////////////////////////////////
+void PlottingInterface::SetDefaultSampling(const PlotSampling &_sampling)
+{
+  this->dataPtr->defaultSampling = _sampling;
+}
 
-      if (valueMsg)
-      {
-        valueMsg = ref->MutableMessage
-                (const_cast<google::protobuf::Message *>(valueMsg), field);
-      }
-      else
-      {
-        valueMsg = ref->MutableMessage
-                (const_cast<google::protobuf::Message *>(&_msg), field);
-      }
+//////////////////////////////////////////////////////
+void PlottingInterface::SetSampling(const std::string &_topic,
+                                    const std::string &_fieldPath,
+                                    const PlotSampling &_sampling)
+{
+  this->dataPtr->sampling[{_topic, _fieldPath}] = _sampling;
+}
 
-      if (valueMsg)
-        ref = valueMsg->GetReflection();
-      else
-      {
-        ignwarn << "Invalid topic msg" << std::endl;
-        return;
-      }
-    }
+//////////////////////////////////////////////////////
+void PlottingInterface::SetMsgsPerSec(const double _msgsPerSec)
+{
+  this->dataPtr->transport.SetMsgsPerSec(_msgsPerSec);
+}
 
-    std::string fieldName = fieldFullPath[pathSize-1];
-    double data;
+//////////////////////////////////////////////////////
+void PlottingInterface::SetSuspended(const bool _suspended)
+{
+  this->dataPtr->flushTimer.setInterval(
+      _suspended ? kSuspendedFlushInterval : kFlushInterval);
+}
 
-    if (valueMsg)
-    {
-      auto field = valueMsg->GetDescriptor()->FindFieldByName(fieldName);
-      data = this->dataPtr->FieldData(*valueMsg, field);
-    }
-    else
-    {
-      auto field = msgDescriptor->FindFieldByName(fieldName);
-      data = this->dataPtr->FieldData(_msg, field);
-    }
+////////////////////////////////////////////
+void PlottingInterface::InitTimer()
+{
+}
 
-    if (!fieldIt.second)
-      continue;
+//////////////////////////////////////////////////////
+void PlottingInterface::onPlot(int _chart, QString _fieldID,
+                               double _x, double _y)
+{
+  // if _x == DEFAULT_TIME, then the msg has not header time
+  // so update x with the time it arrived
+  if (static_cast<int>(_x) == DEFAULT_TIME)
+      _x = this->dataPtr->clock->Now();
 
-    // Field Arrival Time
-    fieldIt.second->SetTime(headerTime);
+  emit this->plot(_chart, _fieldID, _x, _y);
+}
 
-    // Field Value
-    fieldIt.second->SetValue(data);
+//////////////////////////////////////////////////////
+void PlottingInterface::UpdateTime()
+{
+}
 
-    // Update Field Charts UI
-    this->UpdateGui(fieldIt.first);
+//////////////////////////////////////////////////////
+void PlottingInterface::AddSeries(int _chart, QString _fieldID, int _capacity)
+{
+  auto &series = this->dataPtr->series[_chart][_fieldID];
+  auto capacity = static_cast<std::size_t>(std::max(_capacity, 1));
+  if (!series)
+  {
+    series = std::make_unique<PlotSeries>(capacity);
+    this->dataPtr->byHandle[Handle(_chart, _fieldID)] =
+        HandleSeries{_chart, series.get()};
+    if (this->Recording())
+      this->RecordSeries(_chart, _fieldID, *series);
+  }
+  else
+  {
+    series->SetCapacity(capacity);
   }
 }
 
 //////////////////////////////////////////////////////
-bool Topic::HasHeader(const google::protobuf::Message &_msg,
-                      double &_headerTime)
+bool PlottingInterface::StartRecording(QString _path)
 {
-  auto ref = _msg.GetReflection();
-  auto header = _msg.GetDescriptor()->FindFieldByName("header");
-  auto found = ref->HasField(_msg, header);
+  // from a QML folder dialog
+  if (_path.startsWith("file://"))
+    _path.remove(0, 7);
 
-  if (!found)
+  if (!QDir(_path).exists())
+  {
+    ignerr << "Can't record plots to [" << _path.toStdString()
+           << "], the folder doesn't exist" << std::endl;
     return false;
+  }
 
-  auto stamp = header->message_type()->FindFieldByName("stamp");
-
-  if (!stamp)
-    return false;
+  this->dataPtr->recordPath = _path;
+  for (auto &chart : this->dataPtr->series)
+  {
+    for (auto &series : chart.second)
+      this->RecordSeries(chart.first, series.first, *series.second);
+  }
+  emit this->RecordingChanged();
+  return true;
+}
 
-  auto headerMsg = ref->MutableMessage
-          (const_cast<google::protobuf::Message *>(&_msg), header);
+//////////////////////////////////////////////////////
+void PlottingInterface::StopRecording()
+{
+  if (this->dataPtr->recordPath.isEmpty())
+    return;
 
-  if (!headerMsg)
-    return false;
+  this->dataPtr->recordPath.clear();
+  for (auto &chart : this->dataPtr->series)
+  {
+    for (auto &series : chart.second)
+      series.second->StopRecording();
+  }
+  emit this->RecordingChanged();
+}
 
-  ref = headerMsg->GetReflection();
+//////////////////////////////////////////////////////
+bool PlottingInterface::Recording() const
+{
+  return !this->dataPtr->recordPath.isEmpty();
+}
 
-  auto stampMsg = ref->MutableMessage
-          (const_cast<google::protobuf::Message *>(headerMsg), stamp);
+//////////////////////////////////////////////////////
+void PlottingInterface::RecordSeries(int _chart, const QString &_fieldID,
+                                     PlotSeries &_series)
+{
+  auto name = _fieldID.toStdString();
+  std::replace(name.begin(), name.end(), '/', '_');
+  std::replace(name.begin(), name.end(), '-', '_');
+  std::replace(name.begin(), name.end(), ',', '_');
+
+  auto path = this->dataPtr->recordPath.toStdString() + "/Plot" +
+      std::to_string(_chart) + "_" + name + ".rec";
+  _series.StartRecording(path);
+}
 
-  if (!stampMsg)
+//////////////////////////////////////////////////////
+bool PlottingInterface::AddDerivedSeries(int _chart, QString _fieldID,
+    QString _expression, int _capacity)
+{
+  DerivedSeries derived;
+  if (!derived.expression.Compile(_expression.toStdString()))
     return false;
 
-  auto secField = stamp->message_type()->FindFieldByName("sec");
-  auto nsecField = stamp->message_type()->FindFieldByName("nsec");
-
-  auto sec = this->dataPtr->FieldData(*stampMsg, secField);
-  auto nsec = this->dataPtr->FieldData(*stampMsg, nsecField);
+  if (derived.expression.Inputs().empty())
+  {
+    ignerr << "Plot expression [" << _expression.toStdString()
+           << "] doesn't read any series" << std::endl;
+    return false;
+  }
 
-  _headerTime = sec + nsec * std::pow(10, -9);
+  for (const auto &input : derived.expression.Inputs())
+  {
+    auto id = QString::fromStdString(input);
+    if (id == _fieldID)
+    {
+      ignerr << "Derived series [" << _fieldID.toStdString()
+             << "] can't read itself" << std::endl;
+      return false;
+    }
+    derived.inputs.push_back(Handle(_chart, id));
+  }
+  derived.values.assign(derived.inputs.size(), 0.0);
+  derived.seen.assign(derived.inputs.size(), false);
+  derived.missing = derived.inputs.size();
 
+  this->AddSeries(_chart, _fieldID, _capacity);
+  this->dataPtr->derived[Handle(_chart, _fieldID)] = std::move(derived);
   return true;
 }
 
 //////////////////////////////////////////////////////
-void Topic::UpdateGui(const std::string &_field)
+void PlottingInterface::RemoveSeries(int _chart, QString _fieldID)
 {
-  auto field = this->dataPtr->fields[_field];
-
-  auto x = field->Time();
-  auto y = field->Value();
+  auto chartIt = this->dataPtr->series.find(_chart);
+  if (chartIt == this->dataPtr->series.end())
+    return;
+
+  if (chartIt->second.erase(_fieldID) == 0)
+    return;
+
+  if (chartIt->second.empty())
+    this->dataPtr->series.erase(chartIt);
+
+  auto handle = Handle(_chart, _fieldID);
+  this->dataPtr->byHandle.erase(handle);
+  this->dataPtr->changed.erase(handle);
+  this->dataPtr->derived.erase(handle);
+  if (this->dataPtr->derived.empty())
+    this->dataPtr->pending.clear();
+  this->StopSpectrum(handle);
+}
 
-  QString fieldFullPath = QString::fromStdString
-          (this->dataPtr->name + "-" + _field);
+//////////////////////////////////////////////////////
+const PlotSeries *PlottingInterface::Series(int _chart,
+                                            const QString &_fieldID) const
+{
+  auto chartIt = this->dataPtr->series.find(_chart);
+  if (chartIt == this->dataPtr->series.end())
+    return nullptr;
 
-  auto charts = field->Charts();
+  auto seriesIt = chartIt->second.find(_fieldID);
+  if (seriesIt == chartIt->second.end())
+    return nullptr;
 
-  for (auto const &chart : charts)
-    emit plot(chart, fieldFullPath, x, y);
+  return seriesIt->second.get();
 }
 
 //////////////////////////////////////////////////////
-void Topic::SetPlottingTimeRef(const std::shared_ptr<double> &_timeRef)
+const PlotSeries *PlottingInterface::Series(int _handle) const
 {
-  if (!this->dataPtr->plottingTime)
-    this->dataPtr->plottingTime = _timeRef;
+  auto seriesIt = this->dataPtr->byHandle.find(_handle);
+  if (seriesIt == this->dataPtr->byHandle.end())
+    return nullptr;
+
+  return seriesIt->second.series;
 }
 
 //////////////////////////////////////////////////////
-double TopicPrivate::FieldData(const google::protobuf::Message &_msg,
-                               const google::protobuf::FieldDescriptor *_field)
+int PlottingInterface::Handle(int _chart, const QString &_fieldID)
 {
-  using namespace google::protobuf;
-  auto ref = _msg.GetReflection();
-  auto type = _field->type();
-
-  if (type == FieldDescriptor::Type::TYPE_DOUBLE)
-    return ref->GetDouble(_msg, _field);
-  else if (type == FieldDescriptor::Type::TYPE_FLOAT)
-    return ref->GetFloat(_msg, _field);
-  else if (type == FieldDescriptor::Type::TYPE_INT32)
-    return ref->GetInt32(_msg, _field);
-  else if (type == FieldDescriptor::Type::TYPE_INT64)
-    return ref->GetInt64(_msg, _field);
-  else if (type == FieldDescriptor::Type::TYPE_BOOL)
-    return ref->GetBool(_msg, _field);
-  else if (type == FieldDescriptor::Type::TYPE_UINT32)
-    return ref->GetUInt32(_msg, _field);
-  else if (type == FieldDescriptor::Type::TYPE_UINT64)
-    return ref->GetUInt64(_msg, _field);
-  else
-  {
-    ignwarn << "Non Plotting Type" << std::endl;
-    return 0;
-  }
+  auto &handles = Handles();
+  std::lock_guard<std::mutex> lock(handles.mutex);
+  auto key = std::make_pair(_chart, _fieldID);
+  auto handleIt = handles.handles.find(key);
+  if (handleIt != handles.handles.end())
+    return handleIt->second;
+
+  int handle = static_cast<int>(handles.keys.size());
+  handles.keys.push_back(key);
+  handles.handles.emplace(std::move(key), handle);
+  return handle;
 }
 
-////////////////////////////////////////////
-Transport::Transport() : dataPtr(std::make_unique<TransportPrivate>())
+//////////////////////////////////////////////////////
+bool PlottingInterface::HandleKey(int _handle, int &_chart,
+                                  QString &_fieldID)
 {
+  auto &handles = Handles();
+  std::lock_guard<std::mutex> lock(handles.mutex);
+  if (_handle < 0 || static_cast<std::size_t>(_handle) >= handles.keys.size())
+    return false;
+
+  _chart = handles.keys[_handle].first;
+  _fieldID = handles.keys[_handle].second;
+  return true;
 }
 
-////////////////////////////////////////////
-Transport::~Transport()
+//////////////////////////////////////////////////////
+int PlottingInterface::SeriesHandle(int _chart, QString _fieldID) const
 {
-  // unsubscribe from all topics in the transport
-  for (auto topic : this->dataPtr->topics)
-    this->dataPtr->node.Unsubscribe(topic.first);
+  return Handle(_chart, _fieldID);
 }
 
-////////////////////////////////////////////
-void Transport::Unsubscribe(const std::string &_topic,
-                            const std::string &_fieldPath,
-                            int _chart)
+//////////////////////////////////////////////////////
+QRectF PlottingInterface::UpdateSeries(int _chart, QString _fieldID,
+                                       QObject *_series)
 {
-  if (this->dataPtr->topics.count(_topic))
+  auto xySeries = qobject_cast<QtCharts::QXYSeries *>(_series);
+  if (!xySeries)
   {
-    this->dataPtr->topics[_topic]->UnRegister(_fieldPath, _chart);
-
-    // if there is no registered fields, unsubscribe from the topic
-    if (this->dataPtr->topics[_topic]->FieldCount() == 0)
-    {
-      this->dataPtr->node.Unsubscribe(_topic);
-      this->dataPtr->topics.erase(_topic);
-    }
+    ignerr << "Can't update series [" << _fieldID.toStdString()
+           << "], it isn't an XY series" << std::endl;
+    return QRectF();
   }
-}
 
-////////////////////////////////////////////
-void Transport::Subscribe(const std::string &_topic,
-                          const std::string &_fieldPath,
-                          int _chart, const std::shared_ptr<double> &_time)
-{
-  // new topic
-  if (this->dataPtr->topics.count(_topic) == 0)
+  auto series = this->Series(_chart, _fieldID);
+  if (!series || series->Size() == 0)
   {
-    auto topicHandler = new Topic(_topic);
-    this->dataPtr->topics[_topic] = topicHandler;
-
-    topicHandler->Register(_fieldPath, _chart);
-    this->dataPtr->node.Subscribe(_topic, &Topic::Callback, topicHandler);
+    xySeries->clear();
+    return QRectF();
+  }
 
-    topicHandler->SetPlottingTimeRef(_time);
+  double minX = series->X(0);
+  double maxX = minX;
+  double minY = series->Y(0);
+  double maxY = minY;
 
-    connect(topicHandler, SIGNAL(plot(int, QString, double, double)),
-            this, SLOT(onPlot(int, QString, double, double)));
-  }
-  // already exist topic
-  else
+  QVector<QPointF> points;
+  points.reserve(static_cast<int>(series->Size()));
+  for (std::size_t i = 0; i < series->Size(); ++i)
   {
-    this->dataPtr->topics[_topic]->Register(_fieldPath, _chart);
-    this->dataPtr->node.Subscribe(_topic, &Topic::Callback,
-                                  this->dataPtr->topics[_topic]);
+    double x = series->X(i);
+    double y = series->Y(i);
+    points.append(QPointF(x, y));
+
+    minX = std::min(minX, x);
+    maxX = std::max(maxX, x);
+    minY = std::min(minY, y);
+    maxY = std::max(maxY, y);
   }
-}
 
-//////////////////////////////////////////////////////
-const std::map<std::string, Topic*> &Transport::Topics()
-{
-  return this->dataPtr->topics;
-}
+  // a single replace redraws once, instead of once per point
+  xySeries->replace(points);
 
-//////////////////////////////////////////////////////
-void Transport::onPlot(int _chart, QString _fieldID, double _x, double _y)
-{
-  emit this->plot(_chart, _fieldID, _x, _y);
+  return QRectF(QPointF(minX, minY), QPointF(maxX, maxY));
 }
 
 //////////////////////////////////////////////////////
-void Transport::UnsubscribeOutdatedTopics()
+int PlottingInterface::UpdateSeries(int _chart, QString _fieldID,
+                                    QObject *_series, double _minX,
+                                    double _maxX, int _count)
 {
-  // get all topics in the transport
-  std::vector<std::string> topics;
-  this->dataPtr->node.TopicList(topics);
+  auto xySeries = qobject_cast<QtCharts::QXYSeries *>(_series);
+  if (!xySeries)
+  {
+    ignerr << "Can't update series [" << _fieldID.toStdString()
+           << "], it isn't an XY series" << std::endl;
+    return 0;
+  }
 
-  for (auto topic : this->dataPtr->topics)
+  auto series = this->Series(_chart, _fieldID);
+  if (!series)
   {
-    // check if the topic exist
-    if (std::find(topics.begin(), topics.end(), topic.first) == topics.end())
-    {
-      this->dataPtr->node.Unsubscribe(topic.first);
-      delete topic.second;
-      this->dataPtr->topics.erase(topic.first);
-    }
+    xySeries->clear();
+    return 0;
   }
+
+  auto points = series->Points(_minX, _maxX,
+      static_cast<std::size_t>(std::max(_count, 0)));
+  xySeries->replace(points);
+  return points.size();
 }
 
 //////////////////////////////////////////////////////
-PlottingInterface::PlottingInterface() : QObject(),
-    dataPtr(std::make_unique<PlottingIfacePrivate>())
+QVariant PlottingInterface::SeriesBounds(int _chart, QString _fieldID) const
 {
-  connect(&this->dataPtr->transport,
-          SIGNAL(plot(int, QString, double, double)), this,
-          SLOT(onPlot(int, QString, double, double)));
-
-  this->dataPtr->timeout = 1;
-  this->InitTimer();
+  auto series = this->Series(_chart, _fieldID);
+  if (!series || series->Size() == 0)
+    return QVariant();
 
-  App()->Engine()->rootContext()->setContextProperty("PlottingIface", this);
+  return series->Bounds();
 }
 
 //////////////////////////////////////////////////////
-PlottingInterface::~PlottingInterface()
+QVariant PlottingInterface::HandleBounds(int _handle) const
 {
+  auto series = this->Series(_handle);
+  if (!series || series->Size() == 0)
+    return QVariant();
+
+  return series->Bounds();
 }
 
 //////////////////////////////////////////////////////
-void PlottingInterface::unsubscribe(int _chart,
-                                    QString _topic,
-                                    QString _fieldPath)
+QVariant PlottingInterface::SeriesStatistics(int _handle) const
 {
-  this->dataPtr->transport.Unsubscribe(_topic.toStdString(),
-                                       _fieldPath.toStdString(),
-                                       _chart);
+  auto series = this->Series(_handle);
+  if (!series || series->Statistics().Count() == 0u)
+    return QVariant();
+
+  const auto &statistics = series->Statistics();
+  QVariantMap map;
+  map["count"] = static_cast<qulonglong>(statistics.Count());
+  map["mean"] = statistics.Mean();
+  map["stdDev"] = statistics.StdDev();
+  map["min"] = statistics.Min();
+  map["max"] = statistics.Max();
+  map["p50"] = statistics.Quantile(0.5);
+  map["p95"] = statistics.Quantile(0.95);
+  map["p99"] = statistics.Quantile(0.99);
+  return map;
 }
 
 //////////////////////////////////////////////////////
-float PlottingInterface::Timeout() const
+QVariantList PlottingInterface::ValuesAt(const QVariantList &_handles,
+    double _x) const
 {
-  return this->dataPtr->timer.interval();
+  QVariantList values;
+  values.reserve(_handles.size());
+  for (const auto &handle : _handles)
+  {
+    auto series = this->Series(handle.toInt());
+    QPointF point;
+    if (series && series->Nearest(_x, point))
+      values.append(point);
+    else
+      values.append(QVariant());
+  }
+  return values;
 }
 
 //////////////////////////////////////////////////////
-void PlottingInterface::onComponentSubscribe(QString _entity, QString _typeId,
-                                             QString _type, QString _attribute,
-                                             int _chart)
+void PlottingInterface::StartSpectrum(int _handle, int _size, double _rate)
 {
-  // convert the strings into
-  uint64_t entity, typeId;
-  std::istringstream issEntity(_entity.toStdString());
-  issEntity >> entity;
-  std::istringstream issTypeId(_typeId.toStdString());
-  issTypeId >> typeId;
+  auto size = static_cast<std::size_t>(std::max(_size, 8));
+  auto &job = this->dataPtr->spectra[_handle];
+  if (!job)
+  {
+    job = std::make_unique<SpectrumJob>();
+    SpectrumJob *spectrumJob = job.get();
+    this->connect(&job->timer, &QTimer::timeout, this,
+        [this, _handle, spectrumJob]()
+    {
+      auto series = this->Series(_handle);
+      if (!series || series->Size() < 8u)
+        return;
+
+      // one refresh at a time, the worker may fall behind a high rate
+      auto &executor = Executor::Instance();
+      if (executor.Pending(spectrumJob) > 0u)
+        return;
+
+      // only the newest points are copied here, the rest is up to the
+      // worker
+      auto count = std::min(series->Size(), spectrumJob->spectrum->Size());
+      auto first = series->Size() - count;
+      std::vector<double> x(count), y(count);
+      for (std::size_t i = 0; i < count; ++i)
+      {
+        x[i] = series->X(first + i);
+        y[i] = series->Y(first + i);
+      }
 
-  emit this->ComponentSubscribe(entity, typeId, _type.toStdString(),
-                                _attribute.toStdString(), _chart);
+      executor.Post(spectrumJob,
+          [this, _handle, spectrumJob, x = std::move(x), y = std::move(y)]()
+      {
+        std::vector<double> frequencies, amplitudes;
+        if (!spectrumJob->spectrum->Compute(x, y, frequencies, amplitudes))
+          return;
+
+        QVector<QPointF> points;
+        points.reserve(static_cast<int>(frequencies.size()));
+        double maxAmplitude{0.0};
+        for (std::size_t k = 0; k < frequencies.size(); ++k)
+        {
+          points.append(QPointF(frequencies[k], amplitudes[k]));
+          maxAmplitude = std::max(maxAmplitude, amplitudes[k]);
+        }
+        QRectF bounds(0.0, 0.0, frequencies.back(), maxAmplitude);
+
+        Executor::Instance().PostToGui(this,
+            [this, _handle, points, bounds]()
+        {
+          auto jobIt = this->dataPtr->spectra.find(_handle);
+          if (jobIt == this->dataPtr->spectra.end())
+            return;
+
+          jobIt->second->points = points;
+          jobIt->second->bounds = bounds;
+          emit this->SpectrumChanged(_handle);
+        }, "spectrum" + std::to_string(_handle));
+      });
+    });
+  }
+  else
+  {
+    // the worker is done with the transform once cancelled
+    Executor::Instance().Cancel(job.get());
+  }
+  job->spectrum = std::make_unique<PlotSpectrum>(size);
+
+  auto rate = std::min(std::max(_rate, 0.1), 100.0);
+  job->timer.setInterval(static_cast<int>(1000.0 / rate));
+  job->timer.start();
 }
 
 //////////////////////////////////////////////////////
-void PlottingInterface::onComponentUnSubscribe(QString _entity, QString _typeId,
-                                               QString _attribute, int _chart)
+void PlottingInterface::StopSpectrum(int _handle)
 {
-  // convert the strings into
-  uint64_t entity, typeId;
-  std::istringstream issEntity(_entity.toStdString());
-  issEntity >> entity;
-  std::istringstream issTypeId(_typeId.toStdString());
-  issTypeId >> typeId;
+  auto jobIt = this->dataPtr->spectra.find(_handle);
+  if (jobIt == this->dataPtr->spectra.end())
+    return;
 
-  emit this->ComponentUnSubscribe(entity, typeId,
-                                  _attribute.toStdString(), _chart);
+  Executor::Instance().Cancel(jobIt->second.get());
+  this->dataPtr->spectra.erase(jobIt);
 }
 
 //////////////////////////////////////////////////////
-void PlottingInterface::subscribe(int _chart,
-                                  QString _topic,
-                                  QString _fieldPath)
+QRectF PlottingInterface::UpdateSpectrum(int _handle, QObject *_series) const
 {
-  this->dataPtr->transport.Subscribe(_topic.toStdString(),
-                                     _fieldPath.toStdString(),
-                                     _chart, this->dataPtr->plottingTimeRef);
+  auto xySeries = qobject_cast<QtCharts::QXYSeries *>(_series);
+  if (!xySeries)
+  {
+    ignerr << "Can't update spectrum, it isn't an XY series" << std::endl;
+    return QRectF();
+  }
+
+  auto jobIt = this->dataPtr->spectra.find(_handle);
+  if (jobIt == this->dataPtr->spectra.end())
+  {
+    xySeries->clear();
+    return QRectF();
+  }
+
+  xySeries->replace(jobIt->second->points);
+  return jobIt->second->bounds;
 }
 
-////////////////////////////////////////////
-void PlottingInterface::InitTimer()
+//////////////////////////////////////////////////////
+void PlottingInterface::OnPoint(int _chart, QString _fieldID,
+                                double _x, double _y)
 {
-  this->dataPtr->timer.setInterval(this->dataPtr->timeout);
-  connect(&this->dataPtr->timer, SIGNAL(timeout()), this, SLOT(UpdateTime()));
-  this->dataPtr->timer.start();
+  auto handle = Handle(_chart, _fieldID);
+  if (!this->dataPtr->derived.empty())
+    this->dataPtr->pending[handle].append(QPointF(_x, _y));
+
+  auto seriesIt = this->dataPtr->byHandle.find(handle);
+  if (seriesIt == this->dataPtr->byHandle.end())
+    return;
+
+  seriesIt->second.series->Append(_x, _y);
+  this->dataPtr->changed.insert(handle);
 }
 
 //////////////////////////////////////////////////////
-void PlottingInterface::onPlot(int _chart, QString _fieldID,
-                               double _x, double _y)
+void PlottingIfacePrivate::Derive(const PlotHandlePoints &_points,
+                                  PlotHandlePoints &_derived)
 {
-  // if _x == -1, then the msg has not header time
-  // so update x with the default plotting time that is handled by a timer
-  if (static_cast<int>(_x) == DEFAULT_TIME)
-      _x = *this->dataPtr->plottingTimeRef;
+  if (_points.empty())
+    return;
 
-  emit this->plot(_chart, _fieldID, _x, _y);
+  std::vector<const QVector<QPointF> *> batches;
+  std::vector<int> next;
+  for (auto &entry : this->derived)
+  {
+    auto &series = entry.second;
+    auto count = series.inputs.size();
+    batches.assign(count, nullptr);
+    next.assign(count, 0);
+    bool any{false};
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      auto batchIt = _points.find(series.inputs[i]);
+      if (batchIt == _points.end())
+        continue;
+      batches[i] = &batchIt->second;
+      any = true;
+    }
+    if (!any)
+      continue;
+
+    // merge the batches by x, the inputs plotted at the same x are
+    // updated together before evaluating
+    while (true)
+    {
+      bool found{false};
+      double x{0.0};
+      for (std::size_t i = 0; i < count; ++i)
+      {
+        if (!batches[i] || next[i] >= batches[i]->size())
+          continue;
+        auto inputX = (*batches[i])[next[i]].x();
+        if (!found || inputX < x)
+          x = inputX;
+        found = true;
+      }
+      if (!found)
+        break;
+
+      for (std::size_t i = 0; i < count; ++i)
+      {
+        if (!batches[i] || next[i] >= batches[i]->size() ||
+            (*batches[i])[next[i]].x() != x)
+        {
+          continue;
+        }
+
+        series.values[i] = (*batches[i])[next[i]].y();
+        ++next[i];
+        if (!series.seen[i])
+        {
+          series.seen[i] = true;
+          --series.missing;
+        }
+      }
+
+      double y;
+      if (series.missing == 0u &&
+          series.expression.Evaluate(x, series.values, y))
+      {
+        _derived[entry.first].append(QPointF(x, y));
+      }
+    }
+  }
 }
 
 //////////////////////////////////////////////////////
-void PlottingInterface::UpdateTime()
+void PlottingInterface::FlushSeries()
 {
-  *this->dataPtr->plottingTimeRef += this->dataPtr->timeout * 0.001;
+  // points from topics come in batches, one per series. The field IDs are
+  // only looked up for the signals which carry them, if they're connected.
+  PlotHandlePoints points;
+  this->dataPtr->transport.TakePoints(points);
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->batchedMutex);
+    if (points.empty())
+    {
+      points.swap(this->dataPtr->batched);
+    }
+    else
+    {
+      for (auto &series : this->dataPtr->batched)
+        points[series.first].append(series.second);
+      this->dataPtr->batched.clear();
+    }
+  }
+
+  // derived series are computed from the new points of their inputs, then
+  // stored like the others. Points plotted one at a time were already
+  // stored.
+  if (!this->dataPtr->derived.empty())
+  {
+    PlotHandlePoints derived;
+    this->dataPtr->Derive(points, derived);
+    this->dataPtr->Derive(this->dataPtr->pending, derived);
+    this->dataPtr->pending.clear();
+    for (auto &batch : derived)
+      points[batch.first].append(batch.second);
+  }
+
+  std::uint64_t count{0u};
+  for (const auto &batch : points)
+    count += static_cast<std::uint64_t>(batch.second.size());
+  Metrics::Instance().Add(MetricCounter::kPlotPoints, count);
+
+  bool plotted = this->receivers(
+      SIGNAL(PointsPlotted(int, QString, QVector<QPointF>))) > 0;
+  int chart;
+  QString fieldID;
+  for (const auto &batch : points)
+  {
+    if (plotted && HandleKey(batch.first, chart, fieldID))
+      emit this->PointsPlotted(chart, fieldID, batch.second);
+
+    auto seriesIt = this->dataPtr->byHandle.find(batch.first);
+    if (seriesIt == this->dataPtr->byHandle.end())
+      continue;
+
+    for (const auto &point : batch.second)
+      seriesIt->second.series->Append(point.x(), point.y());
+    this->dataPtr->changed.insert(batch.first);
+  }
+
+  if (this->dataPtr->changed.empty())
+    return;
+
+  std::set<int> changed;
+  changed.swap(this->dataPtr->changed);
+
+  bool byID = this->receivers(SIGNAL(SeriesChanged(int, QString))) > 0;
+  for (auto handle : changed)
+  {
+    auto seriesIt = this->dataPtr->byHandle.find(handle);
+    if (seriesIt == this->dataPtr->byHandle.end())
+      continue;
+
+    emit this->SeriesHandleChanged(seriesIt->second.chart, handle);
+    if (byID && HandleKey(handle, chart, fieldID))
+      emit this->SeriesChanged(chart, fieldID);
+  }
 }
 
 //////////////////////////////////////////////////////
 std::string PlottingInterface::FilePath(QString _path, std::string _name,
                                         std::string _extention)
 {
-  if (_extention != "csv" && _extention != "pdf")
+  if (_extention != "csv" && _extention != "pdf" && _extention != "bin")
     return "";
 
   if (_path.toStdString().size() < 8)
@@ -619,61 +2757,170 @@ std::string PlottingInterface::FilePath(QString _path, std::string _name,
 bool PlottingInterface::exportCSV(QString _path, int _chart,
                                   QMap< QString, QVariant> _serieses)
 {
-  std::string plotName = "Plot" + std::to_string(_chart);
-
-  std::ofstream file;
-
   QMap<QString, QVariant>::const_iterator series = _serieses.constBegin();
   while (series != _serieses.constEnd())
   {
-    auto key = series.key().toStdString();
+    auto points = series.value().toList();
 
-    // check if it is a component
-    auto seriesKeys = ignition::common::Split(key, ',');
-    if (seriesKeys.size() == 3)
+    PlotSeries data(points.size());
+    for (int j = 0 ; j < points.size(); j++)
     {
-      // convert from string to uint64_t
-      uint64_t typeId;
-      std::string typeIdString = seriesKeys[1];
-      std::istringstream issTypeId(typeIdString);
-      issTypeId >> typeId;
+      auto point = points.at(j).toPointF();
+      data.Append(point.x(), point.y());
+    }
+
+    if (!this->WriteCSV(_path, _chart, series.key().toStdString(), data))
+      return false;
+
+    ++series;
+  }
+  return true;
+}
 
-      // replace the typeId num with the type name
-      auto typeName = emit ComponentName(typeId);
-      seriesKeys[1] = typeName;
+//////////////////////////////////////////////////////
+bool PlottingInterface::exportCSV(QString _path, int _chart)
+{
+  auto chartIt = this->dataPtr->series.find(_chart);
+  if (chartIt == this->dataPtr->series.end())
+    return true;
 
-      // make the new series key
-      key = seriesKeys[0] + "_" + seriesKeys[1] + "_" + seriesKeys[2];
+  for (const auto &series : chartIt->second)
+  {
+    if (!this->WriteCSV(_path, _chart, series.first.toStdString(),
+                        *series.second))
+    {
+      return false;
     }
-    // if Field
-    else
-      std::replace(key.begin(), key.end(), '-', '/');
+  }
+  return true;
+}
 
-    auto name = plotName +  "_" + key;
+//////////////////////////////////////////////////////
+bool PlottingInterface::ExportSeries(QString _path, QVariantList _charts,
+                                     QString _format)
+{
+  bool binary = (_format == "bin");
+  if (!binary && _format != "csv")
+  {
+    ignerr << "Unknown export format [" << _format.toStdString()
+           << "], use csv or bin" << std::endl;
+    return false;
+  }
+
+  if (this->dataPtr->exporting)
+  {
+    ignwarn << "An export is already being written" << std::endl;
+    return false;
+  }
+  if (this->dataPtr->exportThread.joinable())
+    this->dataPtr->exportThread.join();
 
-    auto filePath = this->FilePath(_path , name, "csv");
+  // copying the columns is fast, formatting and writing them isn't
+  std::vector<ExportJob> jobs;
+  std::size_t total{0};
+  for (const auto &chartVariant : _charts)
+  {
+    int chart = chartVariant.toInt();
+    auto chartIt = this->dataPtr->series.find(chart);
+    if (chartIt == this->dataPtr->series.end())
+      continue;
 
-    if (!filePath.size())
+    for (const auto &series : chartIt->second)
     {
-        ignwarn << "[Couldn't parse file: " << filePath << "]" << std::endl;
+      ExportJob job;
+      if (!this->PrepareExport(_path, chart, series.first.toStdString(),
+                               *series.second, binary ? "bin" : "csv", job))
+      {
         return false;
+      }
+      total += job.x.size();
+      jobs.push_back(std::move(job));
     }
+  }
 
-    file.open(filePath);
-    if (!file.is_open())
-        ignwarn << "[Couldn't open file: " << filePath << "]" << std::endl;
+  this->dataPtr->exporting = true;
+  this->dataPtr->exportThread = std::thread(
+      [this, binary, total](std::vector<ExportJob> _jobs)
+      {
+        bool success{true};
+        std::size_t written{0};
+        auto progress = [this, &written, total](std::size_t _count)
+        {
+          written += _count;
+          if (total > 0)
+            emit this->ExportProgress(static_cast<double>(written) / total);
+        };
+
+        for (const auto &job : _jobs)
+          success = WriteExport(job, binary, progress) && success;
+
+        this->dataPtr->exporting = false;
+        emit this->ExportFinished(success);
+      }, std::move(jobs));
+  return true;
+}
 
-    file << "time, " << key << std::endl;
+//////////////////////////////////////////////////////
+bool PlottingInterface::WriteCSV(const QString &_path, int _chart,
+                                 const std::string &_key,
+                                 const PlotSeries &_series)
+{
+  ExportJob job;
+  if (!this->PrepareExport(_path, _chart, _key, _series, "csv", job))
+    return false;
 
-    auto points = series.value().toList();
-    for (int j = 0 ; j < points.size(); j++)
-    {
-        auto point = points.at(j).toPointF();
-        file << point.x() << ", " << point.y() << std::endl;
-    }
+  return WriteExport(job, false, [](std::size_t){});
+}
 
-    file.close();
-    ++series;
+//////////////////////////////////////////////////////
+bool PlottingInterface::PrepareExport(const QString &_path, int _chart,
+                                      const std::string &_key,
+                                      const PlotSeries &_series,
+                                      const std::string &_extension,
+                                      ExportJob &_job)
+{
+  std::string plotName = "Plot" + std::to_string(_chart);
+  auto key = _key;
+
+  // check if it is a component
+  auto seriesKeys = ignition::common::Split(key, ',');
+  if (seriesKeys.size() == 3)
+  {
+    // convert from string to uint64_t
+    uint64_t typeId;
+    std::string typeIdString = seriesKeys[1];
+    std::istringstream issTypeId(typeIdString);
+    issTypeId >> typeId;
+
+    // replace the typeId num with the type name
+    auto typeName = emit ComponentName(typeId);
+    seriesKeys[1] = typeName;
+
+    // make the new series key
+    key = seriesKeys[0] + "_" + seriesKeys[1] + "_" + seriesKeys[2];
+  }
+  // if Field
+  else
+    std::replace(key.begin(), key.end(), '-', '/');
+
+  auto name = plotName +  "_" + key;
+
+  auto filePath = this->FilePath(_path , name, _extension);
+
+  if (!filePath.size())
+  {
+      ignwarn << "[Couldn't parse file: " << filePath << "]" << std::endl;
+      return false;
+  }
+
+  _job.filePath = filePath;
+  _job.key = key;
+  _job.x.resize(_series.Size());
+  _job.y.resize(_series.Size());
+  for (std::size_t j = 0; j < _series.Size(); j++)
+  {
+    _job.x[j] = _series.X(j);
+    _job.y[j] = _series.Y(j);
   }
   return true;
 }
@@ -16,6 +16,14 @@
 */
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
 #ifdef _MSC_VER
 #pragma warning(push, 0)
 #endif
@@ -24,13 +32,19 @@
 #pragma warning(pop)
 #endif
 
+#include <QtCharts/QLineSeries>
+
 #include <ignition/transport.hh>
 #include <ignition/common/Console.hh>
 #include <ignition/utilities/ExtraTestMacros.hh>
 #include "test_config.h"  // NOLINT(build/include)
+#include "ignition/gui/Application.hh"
 #include "ignition/gui/Enums.hh"
 #include "ignition/gui/PlottingInterface.hh"
 
+int g_argc = 1;
+char **g_argv = new char *[g_argc];
+
 using namespace ignition;
 using namespace gui;
 
@@ -110,6 +124,21 @@ TEST(PlottingInterfaceTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(Topic))
 
   // will not be set to 20 because the too small time diff
   EXPECT_NE(static_cast<int>(fields["pose-position-x"]->Value()), 20);
+
+  // ========== Callback Test with paths which can't be followed ==========
+  topic.Register("pose-nonexistent", 1);
+  topic.Register("pose-position-x-y", 1);
+
+  *time += 1;
+  vector3d->set_x(30);
+  topic.Callback(msg);
+
+  fields = topic.Fields();
+
+  // valid fields are still updated
+  EXPECT_EQ(static_cast<int>(fields["pose-position-x"]->Value()), 30);
+  EXPECT_EQ(static_cast<int>(fields["pose-nonexistent"]->Value()), 0);
+  EXPECT_EQ(static_cast<int>(fields["pose-position-x-y"]->Value()), 0);
 }
 
 //////////////////////////////////////////////////
@@ -142,6 +171,18 @@ TEST(PlottingInterfaceTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(HeaderTime))
 
   EXPECT_EQ(static_cast<int>(fields["data"]->Value()), 10);
 
+  // the point is queued for its chart, at the header time
+  PlotPoints points;
+  topic.TakePoints(points);
+  ASSERT_EQ(points[1]["-data"].size(), 1);
+  EXPECT_DOUBLE_EQ(points[1]["-data"][0].x(), currentTime);
+  EXPECT_DOUBLE_EQ(points[1]["-data"][0].y(), 10);
+
+  // taking again gives nothing new
+  PlotPoints empty;
+  topic.TakePoints(empty);
+  EXPECT_TRUE(empty.empty());
+
   // ======== Header time with too small time diff ==========
 
   msg.set_data(20);
@@ -159,6 +200,185 @@ TEST(PlottingInterfaceTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(HeaderTime))
   EXPECT_NE(static_cast<int>(fields["data"]->Value()), 20);
 }
 
+/////////////////////////////////////////////////
+TEST(PlottingInterfaceTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(Clock))
+{
+  auto clock = std::make_shared<PlotClock>();
+
+  // seconds since it was created
+  auto start = clock->Now();
+  EXPECT_GE(start, 0);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_GE(clock->Now() - start, 0.02);
+
+  // msgs without header are plotted when they arrive
+  Topic topic("");
+  topic.SetClock(clock);
+  topic.Register("data", 1);
+  msgs::Int32 msg;
+  msg.set_data(3);
+  auto before = clock->Now();
+  topic.Callback(msg);
+  PlotPoints points;
+  topic.TakePoints(points);
+  ASSERT_EQ(1, points[1]["-data"].size());
+  EXPECT_GE(points[1]["-data"][0].x(), before);
+  EXPECT_LE(points[1]["-data"][0].x(), clock->Now());
+
+  // follow the simulation time
+  EXPECT_TRUE(clock->SetStatsTopic("/plot_clock_stats"));
+  transport::Node node;
+  auto pub = node.Advertise<msgs::WorldStatistics>("/plot_clock_stats");
+  msgs::WorldStatistics stats;
+  stats.mutable_sim_time()->set_sec(1000);
+  stats.mutable_sim_time()->set_nsec(500000000);
+
+  for (int sleep = 0; sleep < 30 && clock->Now() < 1000; ++sleep)
+  {
+    pub.Publish(stats);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+  EXPECT_DOUBLE_EQ(1000.5, clock->Now());
+
+  // back to the steady clock
+  EXPECT_TRUE(clock->SetStatsTopic(""));
+  EXPECT_LT(clock->Now(), 1000);
+}
+
+/////////////////////////////////////////////////
+TEST(PlottingInterfaceTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(Sampling))
+{
+  PlotSampling sampling;
+  EXPECT_TRUE(PlotSampling::Parse("all", sampling));
+  EXPECT_EQ(PlotSampling::Mode::ALL, sampling.mode);
+  EXPECT_TRUE(PlotSampling::Parse("decimate 3", sampling));
+  EXPECT_EQ(PlotSampling::Mode::DECIMATE, sampling.mode);
+  EXPECT_EQ(3u, sampling.count);
+  EXPECT_TRUE(PlotSampling::Parse("MinMax 2", sampling));
+  EXPECT_EQ(PlotSampling::Mode::MIN_MAX, sampling.mode);
+  EXPECT_DOUBLE_EQ(2, sampling.period);
+  EXPECT_FALSE(PlotSampling::Parse("decimate", sampling));
+  EXPECT_FALSE(PlotSampling::Parse("average 1 2", sampling));
+  EXPECT_FALSE(PlotSampling::Parse("median 1", sampling));
+  EXPECT_EQ(PlotSampling::Mode::MIN_MAX, sampling.mode);
+
+  // send values with header times 0, 1, 2...
+  auto send = [](Topic &_topic, const std::vector<int> &_values)
+  {
+    msgs::Int32 msg;
+    for (unsigned int i = 0; i < _values.size(); ++i)
+    {
+      msg.mutable_header()->mutable_stamp()->set_sec(i);
+      msg.set_data(_values[i]);
+      _topic.Callback(msg);
+    }
+    PlotPoints points;
+    _topic.TakePoints(points);
+    return points[1]["-data"];
+  };
+
+  // keep all, even when closer than the default throttling
+  {
+    Topic topic("");
+    PlotSampling::Parse("all", sampling);
+    topic.Register("data", 1, sampling);
+    msgs::Int32 msg;
+    msg.mutable_header()->mutable_stamp()->set_nsec(1);
+    topic.Callback(msg);
+    msg.mutable_header()->mutable_stamp()->set_nsec(2);
+    topic.Callback(msg);
+    PlotPoints points;
+    topic.TakePoints(points);
+    EXPECT_EQ(2, points[1]["-data"].size());
+  }
+
+  // one out of three
+  {
+    Topic topic("");
+    PlotSampling::Parse("decimate 3", sampling);
+    topic.Register("data", 1, sampling);
+    auto points = send(topic, {5, 6, 7, 8, 9, 10, 11});
+    ASSERT_EQ(3, points.size());
+    EXPECT_DOUBLE_EQ(5, points[0].y());
+    EXPECT_DOUBLE_EQ(8, points[1].y());
+    EXPECT_DOUBLE_EQ(11, points[2].y());
+  }
+
+  // average of each 2 seconds, at their last sample
+  {
+    Topic topic("");
+    PlotSampling::Parse("average 2", sampling);
+    topic.Register("data", 1, sampling);
+    auto points = send(topic, {1, 2, 6, 10, 10, 10, 0});
+    ASSERT_EQ(2, points.size());
+    EXPECT_DOUBLE_EQ(2, points[0].x());
+    EXPECT_DOUBLE_EQ(3, points[0].y());
+    EXPECT_DOUBLE_EQ(5, points[1].x());
+    EXPECT_DOUBLE_EQ(10, points[1].y());
+  }
+
+  // lowest and highest of each 2 seconds, in time order
+  {
+    Topic topic("");
+    PlotSampling::Parse("minmax 2", sampling);
+    topic.Register("data", 1, sampling);
+    auto points = send(topic, {4, 9, 1, 3, 3, 3});
+    ASSERT_EQ(3, points.size());
+    EXPECT_DOUBLE_EQ(1, points[0].x());
+    EXPECT_DOUBLE_EQ(9, points[0].y());
+    EXPECT_DOUBLE_EQ(2, points[1].x());
+    EXPECT_DOUBLE_EQ(1, points[1].y());
+    EXPECT_DOUBLE_EQ(3, points[2].x());
+    EXPECT_DOUBLE_EQ(3, points[2].y());
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(PlottingInterfaceTest,
+    IGN_UTILS_TEST_DISABLED_ON_WIN32(RegisterDuringCallbacks))
+{
+  Topic topic("");
+  PlotSampling all;
+  all.mode = PlotSampling::Mode::ALL;
+  topic.Register("data", 1, all);
+
+  // msgs keep coming from two threads
+  std::atomic<bool> stop{false};
+  std::atomic<int> count{0};
+  auto publish = [&]()
+  {
+    msgs::Int32 msg;
+    msg.set_data(1);
+    while (!stop)
+    {
+      msg.mutable_header()->mutable_stamp()->set_sec(count++);
+      topic.Callback(msg);
+    }
+  };
+  std::thread first(publish);
+  std::thread second(publish);
+
+  // while fields come and go
+  for (int i = 0; i < 1000; ++i)
+  {
+    topic.Register("header-stamp-sec", i % 3, all);
+    topic.UnRegister("header-stamp-sec", i % 3);
+
+    PlotPoints points;
+    topic.TakePoints(points);
+  }
+  stop = true;
+  first.join();
+  second.join();
+
+  EXPECT_EQ(1, topic.FieldCount());
+  EXPECT_GT(count, 0);
+
+  // unknown fields are ignored
+  topic.UnRegister("nonexistent", 1);
+  EXPECT_EQ(1, topic.FieldCount());
+}
+
 //////////////////////////////////////////////////
 // Disable test on windows until we fix "LNK2001 unresolved external symbol"
 // error
@@ -243,3 +463,554 @@ TEST(PlottingInterfaceTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(Transport))
   topics = transport.Topics();
   EXPECT_EQ(static_cast<int>(topics.size()), 1);
 }
+
+//////////////////////////////////////////////////
+TEST(PlottingInterfaceTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(PlotSeries))
+{
+  PlotSeries series(4);
+  EXPECT_EQ(series.Capacity(), 4u);
+  EXPECT_EQ(series.Size(), 0u);
+
+  // fill up
+  for (int i = 0; i < 3; ++i)
+    series.Append(i, i * 10);
+  ASSERT_EQ(series.Size(), 3u);
+  EXPECT_DOUBLE_EQ(series.X(0), 0);
+  EXPECT_DOUBLE_EQ(series.Y(2), 20);
+
+  // once full, the oldest points go first
+  for (int i = 3; i < 10; ++i)
+    series.Append(i, i * 10);
+  ASSERT_EQ(series.Size(), 4u);
+  for (std::size_t i = 0; i < series.Size(); ++i)
+  {
+    EXPECT_DOUBLE_EQ(series.X(i), 6 + i);
+    EXPECT_DOUBLE_EQ(series.Y(i), (6 + i) * 10);
+  }
+
+  // shrinking keeps the newest points
+  series.SetCapacity(2);
+  ASSERT_EQ(series.Size(), 2u);
+  EXPECT_DOUBLE_EQ(series.X(0), 8);
+  EXPECT_DOUBLE_EQ(series.X(1), 9);
+
+  // growing keeps all of them
+  series.SetCapacity(3);
+  series.Append(10, 100);
+  ASSERT_EQ(series.Size(), 3u);
+  EXPECT_DOUBLE_EQ(series.X(0), 8);
+  EXPECT_DOUBLE_EQ(series.X(2), 10);
+
+  series.Append(11, 110);
+  ASSERT_EQ(series.Size(), 3u);
+  EXPECT_DOUBLE_EQ(series.X(0), 9);
+  EXPECT_DOUBLE_EQ(series.Y(2), 110);
+
+  series.Clear();
+  EXPECT_EQ(series.Size(), 0u);
+  series.Append(1, 2);
+  EXPECT_DOUBLE_EQ(series.X(0), 1);
+}
+
+/////////////////////////////////////////////////
+TEST(PlottingInterfaceTest,
+     IGN_UTILS_TEST_DISABLED_ON_WIN32(PlotSeriesLevels))
+{
+  PlotSeries series(100);
+  EXPECT_TRUE(series.Points(0, 1, 10).empty());
+
+  // a spike in the middle of a flat line
+  for (int i = 0; i < 100000; ++i)
+    series.Append(i, i == 50000 ? 10 : 0);
+  ASSERT_EQ(series.Size(), 100u);
+
+  // bounds cover points which aren't kept at full resolution anymore
+  auto bounds = series.Bounds();
+  EXPECT_DOUBLE_EQ(bounds.left(), 0);
+  EXPECT_DOUBLE_EQ(bounds.right(), 99999);
+  EXPECT_DOUBLE_EQ(bounds.top(), 0);
+  EXPECT_DOUBLE_EQ(bounds.bottom(), 10);
+
+  // recent points at full resolution, plus the ones right outside
+  auto points = series.Points(99950, 99960, 100);
+  ASSERT_EQ(points.size(), 13);
+  EXPECT_DOUBLE_EQ(points.front().x(), 99949);
+  EXPECT_DOUBLE_EQ(points.back().x(), 99961);
+
+  // the whole history reduced to about the count, keeping the spike
+  points = series.Points(0, 99999, 500);
+  EXPECT_GT(points.size(), 100);
+  EXPECT_LE(points.size(), 500);
+  EXPECT_LE(points.front().x(), 0);
+  EXPECT_GE(points.back().x(), 99999);
+  double maxY = 0;
+  for (int i = 1; i < points.size(); ++i)
+  {
+    EXPECT_LE(points[i - 1].x(), points[i].x());
+    maxY = std::max(maxY, points[i].y());
+  }
+  EXPECT_DOUBLE_EQ(maxY, 10);
+
+  series.Clear();
+  EXPECT_TRUE(series.Points(0, 99999, 500).empty());
+}
+
+/////////////////////////////////////////////////
+TEST(PlottingInterfaceTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(Export))
+{
+  common::Console::SetVerbosity(4);
+
+  Application app(g_argc, g_argv);
+  PlottingInterface plotting;
+  plotting.AddSeries(1, "/topic-x", 100);
+  for (int i = 0; i < 10; ++i)
+    plotting.onPlot(1, "/topic-x", i, i * 2);
+
+  QTemporaryDir dir;
+  ASSERT_TRUE(dir.isValid());
+  auto url = "file://" + dir.path();
+
+  std::atomic<int> finished{0};
+  std::atomic<bool> success{false};
+  QObject::connect(&plotting, &PlottingInterface::ExportFinished,
+      [&finished, &success](bool _success)
+      {
+        success = _success;
+        ++finished;
+      });
+  auto wait = [&finished](int _count)
+  {
+    for (int i = 0; i < 500 && finished < _count; ++i)
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  };
+
+  EXPECT_FALSE(plotting.ExportSeries(url, {1}, "xml"));
+
+  // binary
+  ASSERT_TRUE(plotting.ExportSeries(url, {1}, "bin"));
+  wait(1);
+  ASSERT_EQ(1, finished);
+  EXPECT_TRUE(success);
+
+  std::ifstream bin(dir.path().toStdString() + "/'Plot1__topic_x.bin'",
+      std::ios::binary);
+  ASSERT_TRUE(bin.is_open());
+
+  char magic[8];
+  bin.read(magic, 8);
+  EXPECT_EQ("IGNPLT01", std::string(magic, 8));
+
+  uint32_t keySize{0};
+  bin.read(reinterpret_cast<char *>(&keySize), sizeof(keySize));
+  std::string key(keySize, ' ');
+  bin.read(&key[0], keySize);
+  EXPECT_EQ("/topic/x", key);
+
+  uint64_t count{0};
+  bin.read(reinterpret_cast<char *>(&count), sizeof(count));
+  ASSERT_EQ(10u, count);
+
+  std::vector<double> x(count), y(count);
+  bin.read(reinterpret_cast<char *>(x.data()), count * sizeof(double));
+  bin.read(reinterpret_cast<char *>(y.data()), count * sizeof(double));
+  ASSERT_TRUE(bin.good());
+  EXPECT_DOUBLE_EQ(3, x[3]);
+  EXPECT_DOUBLE_EQ(6, y[3]);
+
+  // csv
+  ASSERT_TRUE(plotting.ExportSeries(url, {1}, "csv"));
+  wait(2);
+  ASSERT_EQ(2, finished);
+  EXPECT_TRUE(success);
+
+  std::ifstream csv(dir.path().toStdString() + "/'Plot1__topic_x.csv'");
+  ASSERT_TRUE(csv.is_open());
+  std::string line;
+  std::getline(csv, line);
+  EXPECT_EQ("time, /topic/x", line);
+  std::getline(csv, line);
+  EXPECT_EQ("0, 0", line);
+}
+
+/////////////////////////////////////////////////
+TEST(PlottingInterfaceTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(PlotRecording))
+{
+  QTemporaryDir dir;
+  ASSERT_TRUE(dir.isValid());
+  auto path = dir.path().toStdString() + "/series.rec";
+
+  PlotSeries series(100);
+  EXPECT_FALSE(series.Recording());
+  EXPECT_FALSE(series.StartRecording("/not/a/folder/series.rec"));
+  ASSERT_TRUE(series.StartRecording(path));
+  EXPECT_TRUE(series.Recording());
+
+  for (int i = 0; i < 100000; ++i)
+    series.Append(i, i * 2);
+  ASSERT_EQ(series.Size(), 100u);
+
+  // old points at full resolution, from the file
+  bool full{false};
+  auto points = series.Points(5000, 5010, 100, &full);
+  EXPECT_TRUE(full);
+  ASSERT_EQ(points.size(), 13);
+  for (int i = 0; i < points.size(); ++i)
+  {
+    EXPECT_DOUBLE_EQ(points[i].x(), 4999 + i);
+    EXPECT_DOUBLE_EQ(points[i].y(), (4999 + i) * 2);
+  }
+
+  // across the last chunk written and the one being filled
+  points = series.Points(98300, 98310, 100, &full);
+  EXPECT_TRUE(full);
+  ASSERT_EQ(points.size(), 13);
+  EXPECT_DOUBLE_EQ(points.front().x(), 98299);
+
+  // too many points for the file, reduced instead
+  points = series.Points(0, 99999, 500, &full);
+  EXPECT_FALSE(full);
+  EXPECT_LE(points.size(), 500);
+
+  series.StopRecording();
+  EXPECT_FALSE(series.Recording());
+  points = series.Points(5000, 5010, 100, &full);
+  EXPECT_FALSE(full);
+
+  // the file is kept
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  ASSERT_TRUE(file.is_open());
+  EXPECT_EQ(8 + 24 * 4096 * 16, static_cast<int>(file.tellg()));
+}
+
+/////////////////////////////////////////////////
+TEST(PlottingInterfaceTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(SeriesHandles))
+{
+  common::Console::SetVerbosity(4);
+
+  // a pair keeps its handle, other pairs get others
+  auto handle = PlottingInterface::Handle(3, "/handles-data");
+  EXPECT_GE(handle, 0);
+  EXPECT_EQ(handle, PlottingInterface::Handle(3, "/handles-data"));
+  EXPECT_NE(handle, PlottingInterface::Handle(4, "/handles-data"));
+  EXPECT_NE(handle, PlottingInterface::Handle(3, "/handles-other"));
+
+  int chart{-1};
+  QString fieldID;
+  ASSERT_TRUE(PlottingInterface::HandleKey(handle, chart, fieldID));
+  EXPECT_EQ(3, chart);
+  EXPECT_EQ("/handles-data", fieldID);
+  EXPECT_FALSE(PlottingInterface::HandleKey(-1, chart, fieldID));
+  EXPECT_FALSE(PlottingInterface::HandleKey(1000000, chart, fieldID));
+
+  // topics queue points by handle
+  Topic topic("/handles");
+  topic.Register("data", 3);
+  topic.Register("data", 4);
+
+  msgs::Int32 msg;
+  msg.set_data(7);
+  msg.mutable_header()->mutable_stamp()->set_sec(2);
+  topic.Callback(msg);
+
+  PlotHandlePoints points;
+  topic.TakePoints(points);
+  ASSERT_EQ(2u, points.size());
+  ASSERT_EQ(1, points[handle].size());
+  EXPECT_DOUBLE_EQ(7, points[handle][0].y());
+  auto other = PlottingInterface::Handle(4, "/handles-data");
+  ASSERT_EQ(1, points[other].size());
+
+  // stored series are found by handle
+  Application app(g_argc, g_argv);
+  PlottingInterface plotting;
+  EXPECT_EQ(nullptr, plotting.Series(handle));
+  EXPECT_FALSE(plotting.HandleBounds(handle).isValid());
+
+  plotting.AddSeries(3, "/handles-data", 10);
+  EXPECT_EQ(handle, plotting.SeriesHandle(3, "/handles-data"));
+  ASSERT_NE(nullptr, plotting.Series(handle));
+  EXPECT_EQ(plotting.Series(3, "/handles-data"), plotting.Series(handle));
+
+  plotting.onPlot(3, "/handles-data", 1, 2);
+  plotting.onPlot(3, "/handles-data", 2, 5);
+  EXPECT_EQ(2u, plotting.Series(handle)->Size());
+  auto bounds = plotting.HandleBounds(handle).toRectF();
+  EXPECT_DOUBLE_EQ(1, bounds.x());
+  EXPECT_DOUBLE_EQ(3, bounds.height());
+
+  plotting.RemoveSeries(3, "/handles-data");
+  EXPECT_EQ(nullptr, plotting.Series(handle));
+  EXPECT_EQ(handle, PlottingInterface::Handle(3, "/handles-data"));
+}
+
+/////////////////////////////////////////////////
+TEST(PlottingInterfaceTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(DerivedSeries))
+{
+  common::Console::SetVerbosity(4);
+
+  Application app(g_argc, g_argv);
+  PlottingInterface plotting;
+  EXPECT_FALSE(plotting.AddDerivedSeries(1, "speed", "sqrt(", 10));
+  EXPECT_FALSE(plotting.AddDerivedSeries(1, "speed", "1 + 2", 10));
+  EXPECT_FALSE(plotting.AddDerivedSeries(1, "speed", "{speed} * 2", 10));
+  EXPECT_EQ(nullptr, plotting.Series(1, "speed"));
+
+  ASSERT_TRUE(plotting.AddDerivedSeries(1, "speed",
+      "sqrt({/vel-x}^2 + {/vel-y}^2)", 10));
+  auto speed = plotting.Series(1, "speed");
+  ASSERT_NE(nullptr, speed);
+
+  // nothing until both inputs have a value, then once per x coordinate
+  plotting.onPlot(1, "/vel-x", 1, 3);
+  plotting.onPlot(1, "/vel-x", 2, 3);
+  plotting.onPlot(1, "/vel-y", 2, 4);
+  plotting.onPlot(1, "/vel-y", 3, 0);
+  plotting.onPlot(2, "/vel-x", 4, 100);
+  QMetaObject::invokeMethod(&plotting, "FlushSeries");
+
+  auto points = speed->Points(0, 10, 100);
+  ASSERT_EQ(2, points.size());
+  EXPECT_DOUBLE_EQ(2, points[0].x());
+  EXPECT_DOUBLE_EQ(5, points[0].y());
+  EXPECT_DOUBLE_EQ(3, points[1].x());
+  EXPECT_DOUBLE_EQ(3, points[1].y());
+
+  // removed like the others
+  plotting.RemoveSeries(1, "speed");
+  EXPECT_EQ(nullptr, plotting.Series(1, "speed"));
+  plotting.onPlot(1, "/vel-x", 5, 1);
+  QMetaObject::invokeMethod(&plotting, "FlushSeries");
+}
+
+/////////////////////////////////////////////////
+TEST(PlottingInterfaceTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(Statistics))
+{
+  // kept for all points, not only the ones in memory
+  PlotSeries series(10);
+  for (int i = 1; i <= 100; ++i)
+    series.Append(i, i);
+  EXPECT_EQ(10u, series.Size());
+  EXPECT_EQ(100u, series.Statistics().Count());
+  EXPECT_DOUBLE_EQ(50.5, series.Statistics().Mean());
+  EXPECT_DOUBLE_EQ(1, series.Statistics().Min());
+  EXPECT_DOUBLE_EQ(100, series.Statistics().Max());
+  EXPECT_NEAR(50.5, series.Statistics().Quantile(0.5), 1.0);
+
+  series.Clear();
+  EXPECT_EQ(0u, series.Statistics().Count());
+
+  Application app(g_argc, g_argv);
+  PlottingInterface plotting;
+  auto handle = PlottingInterface::Handle(1, "/stats-x");
+  EXPECT_FALSE(plotting.SeriesStatistics(handle).isValid());
+
+  plotting.AddSeries(1, "/stats-x", 100);
+  EXPECT_FALSE(plotting.SeriesStatistics(handle).isValid());
+  plotting.onPlot(1, "/stats-x", 1, 2);
+  plotting.onPlot(1, "/stats-x", 2, 4);
+
+  auto stats = plotting.SeriesStatistics(handle).toMap();
+  EXPECT_EQ(2u, stats["count"].toULongLong());
+  EXPECT_DOUBLE_EQ(3, stats["mean"].toDouble());
+  EXPECT_DOUBLE_EQ(2, stats["min"].toDouble());
+  EXPECT_DOUBLE_EQ(4, stats["max"].toDouble());
+  EXPECT_TRUE(stats.contains("p99"));
+}
+
+/////////////////////////////////////////////////
+TEST(PlottingInterfaceTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(ValuesAt))
+{
+  common::Console::SetVerbosity(4);
+
+  PlotSeries series(10);
+  QPointF point;
+  EXPECT_FALSE(series.Nearest(0, point));
+
+  // wrapped around, only 91 to 100 are kept
+  for (int i = 1; i <= 100; ++i)
+    series.Append(i, i * 2);
+  ASSERT_TRUE(series.Nearest(95.4, point));
+  EXPECT_EQ(QPointF(95, 190), point);
+  ASSERT_TRUE(series.Nearest(95.6, point));
+  EXPECT_EQ(QPointF(96, 192), point);
+  ASSERT_TRUE(series.Nearest(0, point));
+  EXPECT_EQ(QPointF(91, 182), point);
+  ASSERT_TRUE(series.Nearest(1000, point));
+  EXPECT_EQ(QPointF(100, 200), point);
+
+  Application app(g_argc, g_argv);
+  PlottingInterface plotting;
+  plotting.AddSeries(1, "/cursor-x", 100);
+  plotting.AddSeries(2, "/cursor-y", 100);
+  plotting.onPlot(1, "/cursor-x", 1, 2);
+  plotting.onPlot(1, "/cursor-x", 2, 4);
+  plotting.onPlot(2, "/cursor-y", 1.9, 8);
+
+  // series without points and unknown handles give invalid values
+  plotting.AddSeries(3, "/cursor-z", 100);
+  QVariantList handles{PlottingInterface::Handle(1, "/cursor-x"),
+      PlottingInterface::Handle(2, "/cursor-y"),
+      PlottingInterface::Handle(3, "/cursor-z"), -1};
+  auto values = plotting.ValuesAt(handles, 1.8);
+  ASSERT_EQ(4, values.size());
+  EXPECT_EQ(QPointF(2, 4), values[0].toPointF());
+  EXPECT_EQ(QPointF(1.9, 8), values[1].toPointF());
+  EXPECT_FALSE(values[2].isValid());
+  EXPECT_FALSE(values[3].isValid());
+}
+
+/////////////////////////////////////////////////
+TEST(PlottingInterfaceTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(Spectrum))
+{
+  common::Console::SetVerbosity(4);
+
+  Application app(g_argc, g_argv);
+  PlottingInterface plotting;
+  plotting.AddSeries(1, "/spectrum-x", 10000);
+  auto handle = PlottingInterface::Handle(1, "/spectrum-x");
+
+  // 1 kHz samples of a 50 Hz oscillation
+  const double pi = std::acos(-1.0);
+  for (int i = 0; i < 4000; ++i)
+  {
+    double t = i * 0.001;
+    plotting.onPlot(1, "/spectrum-x", t, std::sin(2 * pi * 50 * t));
+  }
+
+  int changed{0};
+  QObject::connect(&plotting, &PlottingInterface::SpectrumChanged,
+      [&changed, handle](int _handle)
+      {
+        if (_handle == handle)
+          ++changed;
+      });
+
+  QtCharts::QLineSeries lineSeries;
+  EXPECT_TRUE(plotting.UpdateSpectrum(handle, &lineSeries).isNull());
+
+  plotting.StartSpectrum(handle, 1024, 50);
+  for (int i = 0; i < 200 && changed == 0; ++i)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    QCoreApplication::processEvents();
+  }
+  ASSERT_GT(changed, 0);
+
+  auto bounds = plotting.UpdateSpectrum(handle, &lineSeries);
+  EXPECT_NEAR(500, bounds.width(), 1e-6);
+  ASSERT_EQ(513, lineSeries.count());
+
+  int peak{0};
+  for (int k = 0; k < lineSeries.count(); ++k)
+  {
+    if (lineSeries.at(k).y() > lineSeries.at(peak).y())
+      peak = k;
+  }
+  EXPECT_NEAR(50, lineSeries.at(peak).x(), 1.0);
+  EXPECT_DOUBLE_EQ(bounds.height(), lineSeries.at(peak).y());
+
+  // removed along with the series
+  plotting.RemoveSeries(1, "/spectrum-x");
+  EXPECT_TRUE(plotting.UpdateSpectrum(handle, &lineSeries).isNull());
+  EXPECT_EQ(0, lineSeries.count());
+}
+
+/////////////////////////////////////////////////
+TEST(PlottingInterfaceTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(Components))
+{
+  common::Console::SetVerbosity(4);
+
+  Application app(g_argc, g_argv);
+  PlottingInterface plotting;
+
+  // one attribute at a time if nothing handles batches
+  std::vector<uint64_t> entities;
+  QObject::connect(&plotting, &PlottingInterface::ComponentSubscribe,
+      [&](uint64_t _entity, uint64_t, const std::string &,
+          const std::string &, int)
+      {
+        entities.push_back(_entity);
+      });
+
+  QVariantMap joint;
+  joint["entity"] = "12";
+  joint["typeId"] = "7654321";
+  joint["type"] = "Double";
+  joint["attribute"] = "value";
+  joint["chart"] = 1;
+  QVariantMap other = joint;
+  other["entity"] = 13;
+  QVariantMap invalid = joint;
+  invalid["entity"] = "joint";
+  plotting.subscribeComponents({joint, invalid, other});
+  ASSERT_EQ(2u, entities.size());
+  EXPECT_EQ(12u, entities[0]);
+  EXPECT_EQ(13u, entities[1]);
+
+  // all at once otherwise
+  std::vector<PlotComponent> subscribed;
+  int batches{0};
+  QObject::connect(&plotting, &PlottingInterface::ComponentsSubscribe,
+      [&](const std::vector<PlotComponent> &_components)
+      {
+        subscribed = _components;
+        ++batches;
+      });
+  plotting.onComponentSubscribe("12", "7654321", "Double", "value", 1);
+  plotting.subscribeComponents({joint, other});
+  EXPECT_EQ(2, batches);
+  EXPECT_EQ(2u, entities.size());
+  ASSERT_EQ(2u, subscribed.size());
+  EXPECT_EQ(7654321u, subscribed[1].typeId);
+  EXPECT_EQ("value", subscribed[1].attribute);
+  EXPECT_EQ(1, subscribed[1].chart);
+  EXPECT_EQ("13,7654321,value", subscribed[1].Id());
+
+  std::vector<PlotComponent> unsubscribed;
+  QObject::connect(&plotting, &PlottingInterface::ComponentsUnSubscribe,
+      [&](const std::vector<PlotComponent> &_components)
+      {
+        unsubscribed = _components;
+      });
+  plotting.onComponentUnSubscribe("13", "7654321", "value", 1);
+  ASSERT_EQ(1u, unsubscribed.size());
+  EXPECT_EQ(13u, unsubscribed[0].entity);
+
+  // values of a step are stored together with the next refresh
+  auto first = PlottingInterface::Handle(1, subscribed[0].Id());
+  auto second = PlottingInterface::Handle(1, subscribed[1].Id());
+  plotting.AddSeries(1, subscribed[0].Id(), 10);
+  plotting.AddSeries(1, subscribed[1].Id(), 10);
+
+  std::vector<int> changed;
+  QObject::connect(&plotting, &PlottingInterface::SeriesHandleChanged,
+      [&](int, int _handle)
+      {
+        changed.push_back(_handle);
+      });
+
+  PlotHandlePoints step;
+  step[first].append(QPointF(1, 0.5));
+  step[second].append(QPointF(1, -0.5));
+  plotting.PlotBatch(step);
+  step[first][0] = QPointF(2, 0.7);
+  step[second][0] = QPointF(2, -0.7);
+  std::thread thread([&plotting, &step]()
+      {
+        plotting.PlotBatch(step);
+      });
+  thread.join();
+  EXPECT_EQ(0u, plotting.Series(first)->Size());
+
+  QMetaObject::invokeMethod(&plotting, "FlushSeries");
+  EXPECT_EQ(2u, changed.size());
+  ASSERT_EQ(2u, plotting.Series(first)->Size());
+  auto points = plotting.Series(second)->Points(0, 10, 10);
+  ASSERT_EQ(2, points.size());
+  EXPECT_DOUBLE_EQ(-0.5, points[0].y());
+  EXPECT_DOUBLE_EQ(-0.7, points[1].y());
+
+  changed.clear();
+  QMetaObject::invokeMethod(&plotting, "FlushSeries");
+  EXPECT_TRUE(changed.empty());
+}
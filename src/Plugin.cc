@@ -15,13 +15,22 @@
  *
  */
 
+#include <functional>
+#include <memory>
+#include <string>
+#include <tuple>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include <ignition/common/Console.hh>
 #include "ignition/gui/Application.hh"
 #include "ignition/gui/Helpers.hh"
 #include "ignition/gui/MainWindow.hh"
+#include "ignition/gui/Metrics.hh"
 #include "ignition/gui/Plugin.hh"
+#include "ignition/gui/PluginAccounting.hh"
+#include "ignition/gui/Trace.hh"
 
 /// \brief Used to store information about anchors set by the user.
 struct Anchors
@@ -51,6 +60,58 @@ static const std::unordered_set<std::string> kIgnoredProps{
     "pluginName",
     "anchored"};
 
+/// \brief Print a plugin configuration without the card properties and
+/// anchors, which can be changed on a running plugin.
+/// \param[in] _pluginElem <plugin> element
+/// \return Configuration string
+static std::string LayoutFreeConfig(const tinyxml2::XMLElement *_pluginElem)
+{
+  tinyxml2::XMLPrinter printer;
+  _pluginElem->Accept(&printer);
+
+  tinyxml2::XMLDocument doc;
+  doc.Parse(printer.CStr());
+  auto pluginElem = doc.FirstChildElement("plugin");
+  if (!pluginElem)
+    return printer.CStr();
+
+  if (auto ignGuiElem = pluginElem->FirstChildElement("ignition-gui"))
+  {
+    for (auto name : {"property", "anchors"})
+    {
+      while (auto elem = ignGuiElem->FirstChildElement(name))
+        ignGuiElem->DeleteChild(elem);
+    }
+  }
+
+  tinyxml2::XMLPrinter layoutFreePrinter;
+  pluginElem->Accept(&layoutFreePrinter);
+  return layoutFreePrinter.CStr();
+}
+
+/// \brief Creates a plugin item across several frames, then tells the
+/// plugin
+class PluginIncubator : public QQmlIncubator
+{
+  /// \brief Constructor
+  /// \param[in] _callback Called once the item is created or failed
+  public: explicit PluginIncubator(std::function<void()> _callback)
+      : QQmlIncubator(QQmlIncubator::Asynchronous),
+        callback(std::move(_callback))
+  {
+  }
+
+  // Documentation inherited
+  protected: void statusChanged(Status _status) override
+  {
+    if (_status == QQmlIncubator::Ready || _status == QQmlIncubator::Error)
+      this->callback();
+  }
+
+  /// \brief Called once the item is created or failed
+  private: std::function<void()> callback;
+};
+
 class ignition::gui::PluginPrivate
 {
   /// \brief Set this to true if the plugin should be deleted as soon as it has
@@ -65,6 +126,39 @@ class ignition::gui::PluginPrivate
   /// \brief Pointer to item generated with plugin's QML
   public: QQuickItem *pluginItem{nullptr};
 
+  /// \brief Creates the plugin item when loading asynchronously, null
+  /// otherwise
+  public: std::unique_ptr<PluginIncubator> incubator;
+
+  /// \brief Holds the value of the `lazy` element on the configuration.
+  /// Lazy plugins are only configured once their card is first shown.
+  public: bool lazy{false};
+
+  /// \brief Holds the `msgs_per_sec` attribute of the `qos` element on the
+  /// configuration, 0 for no limit.
+  public: double msgsPerSec{0.0};
+
+  /// \brief Configuration of a lazy plugin which wasn't shown yet, empty
+  /// once loaded
+  public: std::string pendingConfig;
+
+  /// \brief True while the card is shown and the plugin configured
+  public: bool active{false};
+
+  /// \brief True once card changes are followed to update `active`
+  public: bool watchingCard{false};
+
+  /// \brief Card properties written to the config by the last ConfigStr
+  /// call, to skip the XML work when they didn't change
+  public: std::string savedCardState;
+
+  /// \brief Config returned by the last ConfigStr call
+  public: std::string savedConfig;
+
+  /// \brief Configuration the plugin was loaded with, before the plugin
+  /// or the card changed it
+  public: std::string loadedConfig;
+
   /// \brief Pointer to wrapping card item
   public: QQuickItem *cardItem{nullptr};
 
@@ -91,6 +185,10 @@ Plugin::Plugin() : dataPtr(new PluginPrivate)
 /////////////////////////////////////////////////
 Plugin::~Plugin()
 {
+  PluginAccounting::Instance().Forget(this);
+  Metrics::Instance().Forget(this);
+  if (this->dataPtr->incubator)
+    this->dataPtr->incubator->clear();
   delete this->dataPtr->pluginItem;
 }
 
@@ -103,6 +201,10 @@ void Plugin::Load(const tinyxml2::XMLElement *_pluginElem)
     return;
   }
 
+  // Subscriptions and render hooks created while configuring belong to
+  // this plugin
+  PluginAccounting::Instance().Track(this);
+
   // TODO(anyone): Too complicated to deep clone elements with tinyxml2, storing
   // string for now and consider moving away from tinyxml
   tinyxml2::XMLPrinter printer;
@@ -114,11 +216,15 @@ void Plugin::Load(const tinyxml2::XMLElement *_pluginElem)
   else
   {
     this->configStr = std::string(printer.CStr());
+    this->dataPtr->loadedConfig = this->configStr;
   }
 
   // Qml file
   std::string filename = _pluginElem->Attribute("filename");
 
+  // Exported by library name, which is stable across configs
+  Metrics::Instance().Track(this, filename);
+
   // This let's <filename>.qml use <pluginclass> functions and properties
   this->dataPtr->context = new QQmlContext(App()->Engine()->rootContext());
   this->dataPtr->context->setContextProperty(QString::fromStdString(filename),
@@ -126,25 +232,95 @@ void Plugin::Load(const tinyxml2::XMLElement *_pluginElem)
 
   // Instantiate plugin QML file into a component
   std::string qmlFile(":/" + filename + "/" + filename + ".qml");
-  QQmlComponent component(App()->Engine(), QString::fromStdString(qmlFile));
+  QQmlComponent *component{nullptr};
+  {
+    TraceScope trace("Compile QML [" + filename + "]", "plugin");
+    component = App()->Component(QString::fromStdString(qmlFile));
+  }
 
-  // Create an item for the plugin
-  this->dataPtr->pluginItem =
-      qobject_cast<QQuickItem *>(component.create(this->dataPtr->context));
-  if (!this->dataPtr->pluginItem)
+  auto failed = [qmlFile]()
   {
     ignerr << "Failed to instantiate QML file [" << qmlFile << "]." << std::endl
            << "* Are you sure it's been added to the .qrc file?" << std::endl
            << "* Are you sure the file is valid QML? "
            << "You can check with the `qmlscene` tool" << std::endl;
+  };
+
+  // Create the item a little at a time while the window keeps drawing, then
+  // load the configuration from a copy of the element, which may be gone
+  // by then
+  if (App()->IncubationBudget() > 0 && App()->MainWin() &&
+      component->isReady())
+  {
+    auto config = this->configStr;
+    this->dataPtr->incubator = std::make_unique<PluginIncubator>(
+        [this, config, failed, filename]()
+    {
+      this->dataPtr->pluginItem =
+          qobject_cast<QQuickItem *>(this->dataPtr->incubator->object());
+      if (!this->dataPtr->pluginItem)
+      {
+        failed();
+      }
+      else
+      {
+        tinyxml2::XMLDocument doc;
+        doc.Parse(config.c_str());
+        auto pluginElem = doc.FirstChildElement("plugin");
+
+        this->LoadCommonConfig(pluginElem ?
+            pluginElem->FirstChildElement("ignition-gui") : nullptr);
+        if (this->dataPtr->lazy)
+        {
+          this->dataPtr->pendingConfig = config;
+        }
+        else
+        {
+          TraceScope trace("LoadConfig [" + filename + "]", "plugin");
+          PluginCostScope cost(this, CostKind::kEvent);
+          this->LoadConfig(pluginElem);
+          this->dataPtr->active = true;
+        }
+      }
+
+      this->Loaded();
+    });
+    component->create(*this->dataPtr->incubator, this->dataPtr->context);
+    return;
+  }
+
+  // Create an item for the plugin
+  {
+    TraceScope trace("Create QML [" + filename + "]", "plugin");
+    this->dataPtr->pluginItem =
+        qobject_cast<QQuickItem *>(component->create(this->dataPtr->context));
+  }
+  if (!this->dataPtr->pluginItem)
+  {
+    failed();
     return;
   }
 
   // Load common configuration
   this->LoadCommonConfig(_pluginElem->FirstChildElement("ignition-gui"));
 
-  // Load custom configuration
+  // Load custom configuration, unless it can wait for the card to be shown
+  if (this->dataPtr->lazy)
+  {
+    this->dataPtr->pendingConfig = this->configStr;
+    return;
+  }
+  TraceScope trace("LoadConfig [" + filename + "]", "plugin");
+  PluginCostScope cost(this, CostKind::kEvent);
   this->LoadConfig(_pluginElem);
+  this->dataPtr->active = true;
+}
+
+/////////////////////////////////////////////////
+bool Plugin::Loading() const
+{
+  return this->dataPtr->incubator &&
+      this->dataPtr->incubator->isLoading();
 }
 
 /////////////////////////////////////////////////
@@ -171,6 +347,28 @@ void Plugin::LoadCommonConfig(const tinyxml2::XMLElement *_ignGuiElem)
       this->DeleteLater();
   }
 
+  // Lazy
+  elem = _ignGuiElem->FirstChildElement("lazy");
+  if (nullptr != elem)
+    elem->QueryBoolText(&this->dataPtr->lazy);
+
+  // Quality of service of subscriptions
+  elem = _ignGuiElem->FirstChildElement("qos");
+  if (nullptr != elem)
+  {
+    double msgsPerSec{0.0};
+    if (elem->QueryDoubleAttribute("msgs_per_sec", &msgsPerSec) ==
+        tinyxml2::XML_SUCCESS && msgsPerSec >= 0.0)
+    {
+      this->dataPtr->msgsPerSec = msgsPerSec;
+    }
+    else
+    {
+      ignwarn << "Ignoring invalid <qos msgs_per_sec> on plugin ["
+              << this->title << "]" << std::endl;
+    }
+  }
+
   // Properties
   for (auto propElem = _ignGuiElem->FirstChildElement("property");
       propElem != nullptr;
@@ -249,12 +447,95 @@ void Plugin::LoadCommonConfig(const tinyxml2::XMLElement *_ignGuiElem)
   }
 }
 
+/////////////////////////////////////////////////
+bool Plugin::Reconfigure(const tinyxml2::XMLElement *_pluginElem)
+{
+  if (!_pluginElem || !this->dataPtr->cardItem || this->Loading() ||
+      this->dataPtr->loadedConfig.empty())
+  {
+    return false;
+  }
+
+  tinyxml2::XMLDocument loadedDoc;
+  loadedDoc.Parse(this->dataPtr->loadedConfig.c_str());
+  auto loadedElem = loadedDoc.FirstChildElement("plugin");
+  if (!loadedElem ||
+      LayoutFreeConfig(loadedElem) != LayoutFreeConfig(_pluginElem))
+  {
+    return false;
+  }
+
+  // An anchored card has left its split, so it can't go back to one
+  auto ignGuiElem = _pluginElem->FirstChildElement("ignition-gui");
+  if (this->dataPtr->cardItem->property("anchored").toBool() &&
+      (!ignGuiElem || !ignGuiElem->FirstChildElement("anchors")))
+  {
+    return false;
+  }
+
+  tinyxml2::XMLPrinter printer;
+  if (!_pluginElem->Accept(&printer))
+    return false;
+  this->configStr = std::string(printer.CStr());
+  this->dataPtr->loadedConfig = this->configStr;
+  this->dataPtr->savedConfig.clear();
+
+  // Only the card properties and anchors differ
+  this->dataPtr->cardProperties.clear();
+  this->dataPtr->anchors = Anchors();
+  this->LoadCommonConfig(ignGuiElem);
+
+  return true;
+}
+
 /////////////////////////////////////////////////
 std::string Plugin::ConfigStr()
 {
   // TODO(anyone): When plugins override this function they will lose the
   // card updates, must refactor config handling
 
+  // Card properties which would be written, in a form cheap to compare
+  std::vector<std::tuple<std::string, std::string, std::string>> cardProps;
+  auto meta = this->CardItem()->metaObject();
+  for (int i = 0; i < meta->propertyCount(); ++i)
+  {
+    auto key = meta->property(i).name();
+    auto type = std::string(meta->property(i).typeName());
+
+    // Explicitly skip some keys
+    if (kIgnoredProps.find(key) != kAnchorLineSet.end())
+      continue;
+
+    // When setting, it will need to be string
+    if (type == "QString")
+      type = "string";
+
+    if (type != "double" && type != "int" && type != "bool" && type != "string")
+    {
+      continue;
+    }
+
+    auto value = this->CardItem()->property(meta->property(i).name())
+                 .toString().toStdString();
+    cardProps.emplace_back(key, type, value);
+  }
+  auto anchored = this->CardItem()->property("anchored").toBool();
+
+  std::string cardState = anchored ? "1" : "0";
+  for (const auto &prop : cardProps)
+  {
+    cardState += '\n' + std::get<0>(prop) + '\t' + std::get<1>(prop) + '\t' +
+        std::get<2>(prop);
+  }
+
+  // Nothing changed since last time
+  if (!this->dataPtr->savedConfig.empty() &&
+      this->configStr == this->dataPtr->savedConfig &&
+      cardState == this->dataPtr->savedCardState)
+  {
+    return this->configStr;
+  }
+
   // Convert string to XML
   tinyxml2::XMLDocument doc;
   doc.Parse(this->configStr.c_str());
@@ -286,39 +567,17 @@ std::string Plugin::ConfigStr()
   }
 
   // Add <property>s
-  auto meta = this->CardItem()->metaObject();
-  for (int i = 0; i < meta->propertyCount(); ++i)
+  for (const auto &prop : cardProps)
   {
-    auto key = meta->property(i).name();
-    auto type = std::string(meta->property(i).typeName());
-
-    // Explicitly skip some keys
-    if (kIgnoredProps.find(key) != kAnchorLineSet.end())
-      continue;
-
-    // When setting, it will need to be string
-    if (type == "QString")
-      type = "string";
-
-    std::string value;
-    if (type != "double" && type != "int" && type != "bool" && type != "string")
-    {
-      continue;
-    }
-
-    value = this->CardItem()->property(meta->property(i).name())
-            .toString().toStdString();
-
     auto elem = doc.NewElement("property");
-    elem->SetAttribute("key", key);
-    elem->SetAttribute("type", type.c_str());
-    elem->SetText(value.c_str());
+    elem->SetAttribute("key", std::get<0>(prop).c_str());
+    elem->SetAttribute("type", std::get<1>(prop).c_str());
+    elem->SetText(std::get<2>(prop).c_str());
     ignGuiElem->InsertEndChild(elem);
   }
 
   // Remove <anchors> if needed
   // TODO(louise) Support setting anchors from UI and then saving it.
-  auto anchored = this->CardItem()->property("anchored").toBool();
   if (!anchored)
   {
     for (auto anchorElem = ignGuiElem->FirstChildElement("anchors");
@@ -340,6 +599,8 @@ std::string Plugin::ConfigStr()
   else
   {
     this->configStr = std::string(printer.CStr());
+    this->dataPtr->savedConfig = this->configStr;
+    this->dataPtr->savedCardState = cardState;
   }
 
   return this->configStr;
@@ -365,6 +626,12 @@ bool Plugin::DeleteLaterRequested() const
   return this->dataPtr->deleteLaterRequested;
 }
 
+/////////////////////////////////////////////////
+double Plugin::MsgsPerSec() const
+{
+  return this->dataPtr->msgsPerSec;
+}
+
 /////////////////////////////////////////////////
 QQuickItem *Plugin::PluginItem() const
 {
@@ -383,9 +650,8 @@ QQuickItem *Plugin::CardItem() const
 
   // Instantiate a card
   std::string qmlFile(":qml/IgnCard.qml");
-  QQmlComponent cardComp(App()->Engine(),
-      QString(QString::fromStdString(qmlFile)));
-  auto cardItem = qobject_cast<QQuickItem *>(cardComp.create());
+  auto cardComp = App()->Component(QString::fromStdString(qmlFile));
+  auto cardItem = qobject_cast<QQuickItem *>(cardComp->create());
   if (!cardItem)
   {
     ignerr << "Internal error: Failed to instantiate QML file [" << qmlFile
@@ -479,6 +745,75 @@ void Plugin::PostParentChanges()
 
     this->CardItem()->setProperty(prop.first.c_str(), prop.second);
   }
+
+  // Follow the card being shown and hidden
+  if (!this->dataPtr->watchingCard)
+  {
+    this->dataPtr->watchingCard = true;
+    auto cardItem = this->CardItem();
+    this->connect(cardItem, &QQuickItem::visibleChanged, this, [this]()
+    {
+      this->UpdateActive();
+    });
+    this->connect(cardItem, &QQuickItem::stateChanged, this, [this]()
+    {
+      this->UpdateActive();
+    });
+    if (App())
+    {
+      this->connect(App(), &Application::WindowShownChanged, this, [this]()
+      {
+        this->UpdateActive();
+      });
+    }
+  }
+  this->UpdateActive();
+}
+
+/////////////////////////////////////////////////
+bool Plugin::Active() const
+{
+  return this->dataPtr->active;
+}
+
+/////////////////////////////////////////////////
+void Plugin::UpdateActive()
+{
+  auto cardItem = this->dataPtr->cardItem;
+  bool shown = cardItem && cardItem->isVisible() &&
+      !cardItem->state().endsWith("_collapsed");
+
+  // Cards of the main window can't be seen while it's minimized or covered
+  if (shown && App() && App()->MainWin() &&
+      cardItem->window() == App()->MainWin()->QuickWindow())
+  {
+    shown = App()->WindowShown();
+  }
+
+  PluginCostScope cost(this, CostKind::kEvent);
+
+  // Lazy plugins are configured when first shown
+  if (!this->dataPtr->pendingConfig.empty())
+  {
+    if (!shown)
+      return;
+
+    tinyxml2::XMLDocument doc;
+    doc.Parse(this->dataPtr->pendingConfig.c_str());
+    this->dataPtr->pendingConfig.clear();
+    this->dataPtr->active = true;
+    this->LoadConfig(doc.FirstChildElement("plugin"));
+    return;
+  }
+
+  if (shown == this->dataPtr->active)
+    return;
+
+  this->dataPtr->active = shown;
+  if (shown)
+    this->Resume();
+  else
+    this->Suspend();
 }
 
 /////////////////////////////////////////////////
@@ -502,14 +837,13 @@ void Plugin::ApplyAnchors()
 
   if (this->dataPtr->anchors.target == "window")
   {
-    auto win = App()->findChild<MainWindow *>();
-    if (!win)
+    if (!App()->MainWin())
     {
       ignerr << "Internal error: missing window" << std::endl;
       return;
     }
 
-    auto bgItem = win->QuickWindow()->findChild<QQuickItem *>("background");
+    auto bgItem = App()->FindObject<QQuickItem>("background");
     if (!bgItem)
     {
       ignerr << "Internal error: missing background item" << std::endl;
@@ -521,9 +855,8 @@ void Plugin::ApplyAnchors()
   else
   {
     // See if there's a plugin with that name
-    target =
-        findFirstByProperty(App()->Engine()->findChildren<QQuickItem *>(),
-        "pluginName", QString::fromStdString(this->dataPtr->anchors.target));
+    target = App()->FindCard(
+        QString::fromStdString(this->dataPtr->anchors.target));
   }
 
   if (!target)
@@ -0,0 +1,237 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "ignition/gui/Metrics.hh"
+#include "ignition/gui/Plugin.hh"
+#include "ignition/gui/PluginAccounting.hh"
+#include "ignition/gui/qt.h"
+
+namespace ignition
+{
+  namespace gui
+  {
+    /// \brief Time accounted to a tracked plugin
+    struct PluginAccount
+    {
+      /// \brief Plugin
+      const Plugin *plugin;
+
+      /// \brief Usage of each kind of work, indexed by CostKind
+      CostUsage usage[3];
+    };
+
+    class PluginAccountingPrivate
+    {
+      /// \brief Whether time is measured
+      public: std::atomic<bool> enabled{false};
+
+      /// \brief Tracked plugins, in the order they were tracked
+      public: std::vector<PluginAccount> accounts;
+
+      /// \brief Protects accounts
+      public: mutable std::mutex mutex;
+    };
+  }
+}
+
+using namespace ignition;
+using namespace gui;
+
+/// \brief Rough memory used by a QML item and its private data, in bytes
+static const std::size_t kItemBytes{512u};
+
+/// \brief Plugin the work on this thread is attributed to
+static thread_local const Plugin *t_currentPlugin{nullptr};
+
+/////////////////////////////////////////////////
+/// \brief Count an item and all its descendants.
+/// \param[in] _item Item
+/// \return Number of items
+static std::size_t CountItems(const QQuickItem *_item)
+{
+  std::size_t count{1u};
+  for (auto child : _item->childItems())
+    count += CountItems(child);
+  return count;
+}
+
+/////////////////////////////////////////////////
+PluginAccounting::PluginAccounting()
+  : dataPtr(new PluginAccountingPrivate)
+{
+}
+
+/////////////////////////////////////////////////
+PluginAccounting::~PluginAccounting() = default;
+
+/////////////////////////////////////////////////
+PluginAccounting &PluginAccounting::Instance()
+{
+  static PluginAccounting accounting;
+  return accounting;
+}
+
+/////////////////////////////////////////////////
+void PluginAccounting::SetEnabled(const bool _enabled)
+{
+  this->dataPtr->enabled = _enabled;
+}
+
+/////////////////////////////////////////////////
+bool PluginAccounting::Enabled() const
+{
+  return this->dataPtr->enabled;
+}
+
+/////////////////////////////////////////////////
+const Plugin *PluginAccounting::CurrentPlugin()
+{
+  return t_currentPlugin;
+}
+
+/////////////////////////////////////////////////
+void PluginAccounting::Track(const Plugin *_plugin)
+{
+  if (!_plugin)
+    return;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto &accounts = this->dataPtr->accounts;
+  if (std::none_of(accounts.begin(), accounts.end(),
+      [&_plugin](const PluginAccount &_account)
+      {
+        return _account.plugin == _plugin;
+      }))
+  {
+    accounts.push_back({_plugin, {}});
+  }
+}
+
+/////////////////////////////////////////////////
+void PluginAccounting::Forget(const Plugin *_plugin)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto &accounts = this->dataPtr->accounts;
+  accounts.erase(std::remove_if(accounts.begin(), accounts.end(),
+      [&_plugin](const PluginAccount &_account)
+      {
+        return _account.plugin == _plugin;
+      }), accounts.end());
+}
+
+/////////////////////////////////////////////////
+void PluginAccounting::Add(const Plugin *_plugin, const CostKind _kind,
+    const Trace::Clock::duration &_duration)
+{
+  if (_plugin && Metrics::Instance().Enabled())
+    Metrics::Instance().AddPluginCost(_plugin, _kind, _duration);
+
+  if (!_plugin || !this->dataPtr->enabled)
+    return;
+
+  auto duration =
+      std::chrono::duration<double, std::milli>(_duration).count();
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  for (auto &account : this->dataPtr->accounts)
+  {
+    if (account.plugin != _plugin)
+      continue;
+
+    auto &usage = account.usage[static_cast<int>(_kind)];
+    ++usage.calls;
+    usage.total += duration;
+    usage.max = std::max(usage.max, duration);
+    return;
+  }
+}
+
+/////////////////////////////////////////////////
+std::vector<PluginCost> PluginAccounting::Costs() const
+{
+  std::vector<PluginCost> costs;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    for (const auto &account : this->dataPtr->accounts)
+    {
+      PluginCost cost;
+      cost.plugin = account.plugin;
+      cost.transport = account.usage[static_cast<int>(CostKind::kTransport)];
+      cost.events = account.usage[static_cast<int>(CostKind::kEvent)];
+      cost.render = account.usage[static_cast<int>(CostKind::kRender)];
+      costs.push_back(cost);
+    }
+  }
+
+  // Plugins are only forgotten on the GUI thread, so they're still alive
+  for (auto &cost : costs)
+  {
+    cost.name = cost.plugin->Title().empty() ?
+        cost.plugin->objectName().toStdString() : cost.plugin->Title();
+    if (auto item = cost.plugin->PluginItem())
+      cost.items = CountItems(item);
+    cost.memory = cost.items * kItemBytes + cost.plugin->MemoryUsage();
+  }
+
+  return costs;
+}
+
+/////////////////////////////////////////////////
+void PluginAccounting::Reset()
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  for (auto &account : this->dataPtr->accounts)
+  {
+    for (auto &usage : account.usage)
+      usage = CostUsage();
+  }
+}
+
+/////////////////////////////////////////////////
+PluginCostScope::PluginCostScope(const Plugin *_plugin,
+    const CostKind _kind)
+  : plugin(_plugin), previous(t_currentPlugin), kind(_kind)
+{
+  if (!this->plugin)
+    return;
+
+  this->timed = this->previous != this->plugin &&
+      (PluginAccounting::Instance().Enabled() ||
+      Metrics::Instance().Enabled());
+  if (this->timed)
+    this->start = Trace::Clock::now();
+  t_currentPlugin = this->plugin;
+}
+
+/////////////////////////////////////////////////
+PluginCostScope::~PluginCostScope()
+{
+  if (!this->plugin)
+    return;
+
+  t_currentPlugin = this->previous;
+  if (this->timed)
+  {
+    PluginAccounting::Instance().Add(this->plugin, this->kind,
+        Trace::Clock::now() - this->start);
+  }
+}
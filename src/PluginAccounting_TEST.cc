@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+#include "ignition/gui/Plugin.hh"
+#include "ignition/gui/PluginAccounting.hh"
+
+using namespace ignition;
+using namespace gui;
+
+/////////////////////////////////////////////////
+TEST(PluginAccountingTest, Scopes)
+{
+  auto &accounting = PluginAccounting::Instance();
+  EXPECT_FALSE(accounting.Enabled());
+  EXPECT_EQ(nullptr, PluginAccounting::CurrentPlugin());
+
+  Plugin first;
+  first.setObjectName("first");
+  Plugin second;
+  second.setObjectName("second");
+  accounting.Track(&first);
+  accounting.Track(&second);
+  accounting.Track(&second);
+
+  // Nothing is measured while disabled, but the plugin is still current
+  {
+    PluginCostScope scope(&first, CostKind::kEvent);
+    EXPECT_EQ(&first, PluginAccounting::CurrentPlugin());
+  }
+  EXPECT_EQ(nullptr, PluginAccounting::CurrentPlugin());
+
+  auto costs = accounting.Costs();
+  ASSERT_EQ(2u, costs.size());
+  EXPECT_EQ("first", costs[0].name);
+  EXPECT_EQ("second", costs[1].name);
+  EXPECT_EQ(0u, costs[0].events.calls);
+
+  accounting.SetEnabled(true);
+  {
+    PluginCostScope scope(&first, CostKind::kEvent);
+    {
+      // Nested in the same plugin, already measured
+      PluginCostScope nested(&first, CostKind::kEvent);
+    }
+    {
+      PluginCostScope other(&second, CostKind::kTransport);
+      EXPECT_EQ(&second, PluginAccounting::CurrentPlugin());
+    }
+    EXPECT_EQ(&first, PluginAccounting::CurrentPlugin());
+  }
+  accounting.Add(&second, CostKind::kRender, std::chrono::milliseconds(4));
+  accounting.Add(&second, CostKind::kRender, std::chrono::milliseconds(2));
+
+  // Untracked plugins are ignored
+  Plugin untracked;
+  accounting.Add(&untracked, CostKind::kRender,
+      std::chrono::milliseconds(1));
+
+  costs = accounting.Costs();
+  ASSERT_EQ(2u, costs.size());
+  EXPECT_EQ(1u, costs[0].events.calls);
+  EXPECT_EQ(0u, costs[0].transport.calls);
+  EXPECT_EQ(1u, costs[1].transport.calls);
+  EXPECT_EQ(2u, costs[1].render.calls);
+  EXPECT_DOUBLE_EQ(6.0, costs[1].render.total);
+  EXPECT_DOUBLE_EQ(4.0, costs[1].render.max);
+  EXPECT_EQ(0u, costs[1].items);
+
+  accounting.Reset();
+  costs = accounting.Costs();
+  ASSERT_EQ(2u, costs.size());
+  EXPECT_EQ(0u, costs[1].render.calls);
+  EXPECT_DOUBLE_EQ(0.0, costs[1].render.max);
+
+  accounting.Forget(&first);
+  costs = accounting.Costs();
+  ASSERT_EQ(1u, costs.size());
+  EXPECT_EQ(&second, costs[0].plugin);
+
+  accounting.SetEnabled(false);
+}
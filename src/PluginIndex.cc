@@ -0,0 +1,488 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <utility>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
+#include <ignition/common/SystemPaths.hh>
+#include <ignition/common/Util.hh>
+#include <ignition/plugin/Loader.hh>
+
+#include "ignition/gui/config.hh"
+#include "ignition/gui/PluginIndex.hh"
+#include "ignition/gui/qt.h"
+
+namespace ignition
+{
+  namespace gui
+  {
+    /// \brief Libraries found in a directory
+    struct IndexedDir
+    {
+      /// \brief Modification time of the directory when it was listed
+      std::int64_t mtime;
+
+      /// \brief File names of the libraries
+      std::vector<std::string> libraries;
+    };
+
+    /// \brief Where a plugin was found
+    struct IndexedFind
+    {
+      /// \brief Path to the library
+      std::string path;
+
+      /// \brief Modification time of each searched directory at the time
+      std::vector<std::int64_t> mtimes;
+    };
+
+    /// \brief Plugins exported by a library
+    struct IndexedLib
+    {
+      /// \brief Modification time of the library when it was loaded
+      std::int64_t mtime;
+
+      /// \brief Plugin names
+      std::vector<std::string> names;
+    };
+
+    class PluginIndexPrivate
+    {
+      /// \brief Get the modification time of a file or directory.
+      /// \param[in] _path Path
+      /// \return Time in seconds, -1 if it doesn't exist.
+      public: static std::int64_t ModificationTime(const std::string &_path);
+
+      /// \brief Get the modification time to record for a path. A path
+      /// modified during the current second may change again without its
+      /// time changing, so it isn't trusted.
+      /// \param[in] _path Path
+      /// \return Time in seconds, -2 if it shouldn't be trusted.
+      public: static std::int64_t StableTime(const std::string &_path);
+
+      /// \brief Read the index file.
+      public: void Load();
+
+      /// \brief Path to the index file
+      public: std::string file;
+
+      /// \brief Libraries of each directory
+      public: std::map<std::string, IndexedDir> dirs;
+
+      /// \brief Finds, keyed by filename and then searched directories
+      public: std::map<std::pair<std::string, std::vector<std::string>>,
+                       IndexedFind> finds;
+
+      /// \brief Plugins of each library path
+      public: std::map<std::string, IndexedLib> libs;
+
+      /// \brief Resources of each library path, the names in each entry
+      /// being resource paths
+      public: std::map<std::string, IndexedLib> resources;
+
+      /// \brief Whether there are changes which weren't saved
+      public: bool dirty{false};
+
+      /// \brief Protects the members above
+      public: mutable std::mutex mutex;
+    };
+  }
+}
+
+using namespace ignition;
+using namespace gui;
+
+/// \brief First line of the index file, to be bumped when the format changes
+static const char kIndexHeader[] = "ign-gui-plugin-index 1";
+
+/////////////////////////////////////////////////
+/// \brief Split a line of the index file into its tab separated fields.
+/// \param[in] _line Line
+/// \return Fields
+static std::vector<std::string> SplitFields(const std::string &_line)
+{
+  std::vector<std::string> fields;
+  std::istringstream stream(_line);
+  std::string field;
+  while (std::getline(stream, field, '\t'))
+    fields.push_back(field);
+  return fields;
+}
+
+/////////////////////////////////////////////////
+std::int64_t PluginIndexPrivate::ModificationTime(const std::string &_path)
+{
+  struct stat info;
+  if (stat(_path.c_str(), &info) != 0)
+    return -1;
+  return static_cast<std::int64_t>(info.st_mtime);
+}
+
+/////////////////////////////////////////////////
+std::int64_t PluginIndexPrivate::StableTime(const std::string &_path)
+{
+  auto mtime = ModificationTime(_path);
+  if (mtime >= static_cast<std::int64_t>(std::time(nullptr)) - 1)
+    return -2;
+  return mtime;
+}
+
+/////////////////////////////////////////////////
+void PluginIndexPrivate::Load()
+{
+  std::ifstream in(this->file);
+  if (!in)
+    return;
+
+  std::string line;
+  if (!std::getline(in, line) || line != kIndexHeader)
+  {
+    ignwarn << "Ignoring plugin index [" << this->file
+            << "] written by another version" << std::endl;
+    return;
+  }
+
+  try
+  {
+    while (std::getline(in, line))
+    {
+      auto fields = SplitFields(line);
+      if (fields.size() < 3)
+        continue;
+
+      // D <dir> <mtime> <library>...
+      if (fields[0] == "D")
+      {
+        auto &dir = this->dirs[fields[1]];
+        dir.mtime = std::stoll(fields[2]);
+        dir.libraries.assign(fields.begin() + 3, fields.end());
+      }
+      // F <filename> <path> (<dir> <mtime>)...
+      else if (fields[0] == "F" && fields.size() % 2 == 1)
+      {
+        std::vector<std::string> searched;
+        IndexedFind find;
+        find.path = fields[2];
+        for (std::size_t i = 3; i < fields.size(); i += 2)
+        {
+          searched.push_back(fields[i]);
+          find.mtimes.push_back(std::stoll(fields[i + 1]));
+        }
+        this->finds[{fields[1], searched}] = find;
+      }
+      // L <path> <mtime> <plugin>...
+      else if (fields[0] == "L")
+      {
+        auto &lib = this->libs[fields[1]];
+        lib.mtime = std::stoll(fields[2]);
+        lib.names.assign(fields.begin() + 3, fields.end());
+      }
+      // R <path> <mtime> <resource>...
+      else if (fields[0] == "R")
+      {
+        auto &lib = this->resources[fields[1]];
+        lib.mtime = std::stoll(fields[2]);
+        lib.names.assign(fields.begin() + 3, fields.end());
+      }
+    }
+  }
+  catch(const std::exception &)
+  {
+    ignwarn << "Ignoring corrupted plugin index [" << this->file << "]"
+            << std::endl;
+    this->dirs.clear();
+    this->finds.clear();
+    this->libs.clear();
+    this->resources.clear();
+  }
+}
+
+/////////////////////////////////////////////////
+PluginIndex::PluginIndex(const std::string &_file)
+  : dataPtr(new PluginIndexPrivate)
+{
+  this->dataPtr->file = _file;
+  this->dataPtr->Load();
+}
+
+/////////////////////////////////////////////////
+PluginIndex::~PluginIndex()
+{
+  this->Save();
+}
+
+/////////////////////////////////////////////////
+PluginIndex &PluginIndex::Instance()
+{
+  static PluginIndex index([]()
+  {
+    std::string home;
+    common::env(IGN_HOMEDIR, home);
+    return common::joinPaths(home, ".ignition", "gui", "plugin_index");
+  }());
+  return index;
+}
+
+/////////////////////////////////////////////////
+std::vector<std::string> PluginIndex::PluginDirectories(
+    const std::string &_env, const std::vector<std::string> &_extra)
+{
+  auto dirs = common::SystemPaths::PathsFromEnv(_env);
+  dirs.insert(dirs.end(), _extra.begin(), _extra.end());
+
+  std::string home;
+  common::env(IGN_HOMEDIR, home);
+  dirs.push_back(common::joinPaths(home, ".ignition", "gui", "plugins"));
+  dirs.push_back(IGN_GUI_PLUGIN_INSTALL_DIR);
+  return dirs;
+}
+
+/////////////////////////////////////////////////
+std::vector<std::string> PluginIndex::Libraries(const std::string &_dir)
+{
+  auto mtime = PluginIndexPrivate::ModificationTime(_dir);
+
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    auto dirIt = this->dataPtr->dirs.find(_dir);
+    if (dirIt != this->dataPtr->dirs.end() && dirIt->second.mtime == mtime)
+      return dirIt->second.libraries;
+  }
+
+  IndexedDir dir;
+  dir.mtime = PluginIndexPrivate::StableTime(_dir);
+
+  common::DirIter endIter;
+  for (common::DirIter dirIter(_dir); dirIter != endIter; ++dirIter)
+  {
+    auto library = common::basename(*dirIter);
+
+    // All we verify is that the file starts with "lib", any further
+    // checks would require loading the plugin.
+    if (library.find("lib") == 0)
+      dir.libraries.push_back(library);
+  }
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->dirs[_dir] = dir;
+  this->dataPtr->dirty = true;
+  return dir.libraries;
+}
+
+/////////////////////////////////////////////////
+std::string PluginIndex::FindLibrary(const std::vector<std::string> &_dirs,
+    const std::string &_filename, const Finder &_find)
+{
+  std::vector<std::int64_t> mtimes;
+  for (const auto &dir : _dirs)
+    mtimes.push_back(PluginIndexPrivate::ModificationTime(dir));
+
+  auto key = std::make_pair(_filename, _dirs);
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    auto findIt = this->dataPtr->finds.find(key);
+    if (findIt != this->dataPtr->finds.end() &&
+        findIt->second.mtimes == mtimes &&
+        PluginIndexPrivate::ModificationTime(findIt->second.path) != -1)
+    {
+      return findIt->second.path;
+    }
+  }
+
+  IndexedFind find;
+  for (const auto &dir : _dirs)
+    find.mtimes.push_back(PluginIndexPrivate::StableTime(dir));
+
+  find.path = _find();
+  if (find.path.empty())
+    return find.path;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->finds[key] = find;
+  this->dataPtr->dirty = true;
+  return find.path;
+}
+
+/////////////////////////////////////////////////
+std::vector<std::string> PluginIndex::PluginNames(
+    const std::string &_path) const
+{
+  auto mtime = PluginIndexPrivate::ModificationTime(_path);
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto libIt = this->dataPtr->libs.find(_path);
+  if (libIt == this->dataPtr->libs.end() || libIt->second.mtime != mtime)
+    return {};
+  return libIt->second.names;
+}
+
+/////////////////////////////////////////////////
+void PluginIndex::SetPluginNames(const std::string &_path,
+    const std::vector<std::string> &_names)
+{
+  IndexedLib lib;
+  lib.mtime = PluginIndexPrivate::StableTime(_path);
+  lib.names = _names;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto &current = this->dataPtr->libs[_path];
+  if (current.mtime == lib.mtime && current.names == lib.names)
+    return;
+  current = lib;
+  this->dataPtr->dirty = true;
+}
+
+/////////////////////////////////////////////////
+/// \brief List the files of the Qt resources registered in the process.
+/// \return Resource paths
+static std::vector<std::string> ResourceFiles()
+{
+  std::vector<std::string> files;
+  QDirIterator it(":/", QDir::Files, QDirIterator::Subdirectories);
+  while (it.hasNext())
+    files.push_back(it.next().toStdString());
+  std::sort(files.begin(), files.end());
+  return files;
+}
+
+/////////////////////////////////////////////////
+bool PluginIndex::Inspect(const std::string &_path,
+    std::vector<std::string> &_names, std::vector<std::string> &_resources)
+{
+  auto mtime = PluginIndexPrivate::ModificationTime(_path);
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    auto libIt = this->dataPtr->libs.find(_path);
+    auto resIt = this->dataPtr->resources.find(_path);
+    if (libIt != this->dataPtr->libs.end() && libIt->second.mtime == mtime &&
+        resIt != this->dataPtr->resources.end() &&
+        resIt->second.mtime == mtime)
+    {
+      _names = libIt->second.names;
+      _resources = resIt->second.names;
+      return true;
+    }
+  }
+
+  // Loading the library registers its resources, which are told apart from
+  // those already there
+  auto before = ResourceFiles();
+  plugin::Loader loader;
+  auto names = loader.LoadLib(_path);
+  if (names.empty())
+  {
+    ignerr << "Failed to inspect [" << _path << "]: no plugins found"
+           << std::endl;
+    return false;
+  }
+  auto after = ResourceFiles();
+
+  _names.assign(names.begin(), names.end());
+  std::sort(_names.begin(), _names.end());
+  _resources.clear();
+  std::set_difference(after.begin(), after.end(), before.begin(),
+      before.end(), std::back_inserter(_resources));
+
+  this->SetPluginNames(_path, _names);
+
+  IndexedLib lib;
+  lib.mtime = PluginIndexPrivate::StableTime(_path);
+  lib.names = _resources;
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->resources[_path] = lib;
+  this->dataPtr->dirty = true;
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool PluginIndex::Save()
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  if (!this->dataPtr->dirty)
+    return true;
+
+  // Written next to the index and moved in place, so other processes never
+  // read half a file
+  common::createDirectories(common::parentPath(this->dataPtr->file));
+  auto tmpFile = this->dataPtr->file + ".tmp";
+  {
+    std::ofstream out(tmpFile, std::ios::out | std::ios::trunc);
+    if (!out)
+    {
+      ignwarn << "Unable to write plugin index [" << tmpFile << "]"
+              << std::endl;
+      return false;
+    }
+
+    out << kIndexHeader << "\n";
+    for (const auto &dir : this->dataPtr->dirs)
+    {
+      out << "D\t" << dir.first << "\t" << dir.second.mtime;
+      for (const auto &library : dir.second.libraries)
+        out << "\t" << library;
+      out << "\n";
+    }
+    for (const auto &find : this->dataPtr->finds)
+    {
+      out << "F\t" << find.first.first << "\t" << find.second.path;
+      for (std::size_t i = 0; i < find.first.second.size(); ++i)
+        out << "\t" << find.first.second[i] << "\t" << find.second.mtimes[i];
+      out << "\n";
+    }
+    for (const auto &lib : this->dataPtr->libs)
+    {
+      out << "L\t" << lib.first << "\t" << lib.second.mtime;
+      for (const auto &name : lib.second.names)
+        out << "\t" << name;
+      out << "\n";
+    }
+    for (const auto &lib : this->dataPtr->resources)
+    {
+      out << "R\t" << lib.first << "\t" << lib.second.mtime;
+      for (const auto &name : lib.second.names)
+        out << "\t" << name;
+      out << "\n";
+    }
+  }
+
+  if (std::rename(tmpFile.c_str(), this->dataPtr->file.c_str()) != 0)
+  {
+    // Windows doesn't replace existing files
+    std::remove(this->dataPtr->file.c_str());
+    if (std::rename(tmpFile.c_str(), this->dataPtr->file.c_str()) != 0)
+    {
+      ignwarn << "Unable to write plugin index [" << this->dataPtr->file
+              << "]" << std::endl;
+      return false;
+    }
+  }
+
+  this->dataPtr->dirty = false;
+  return true;
+}
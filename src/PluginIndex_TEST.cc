@@ -0,0 +1,226 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <utime.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
+#include <ignition/utilities/ExtraTestMacros.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/gui/PluginIndex.hh"
+
+using namespace ignition;
+using namespace gui;
+
+/// \brief Set the modification time of a path, in the past so the index
+/// trusts it.
+/// \param[in] _path Path
+/// \param[in] _age Seconds ago
+void SetModificationTime(const std::string &_path, int _age)
+{
+  struct utimbuf times;
+  times.actime = std::time(nullptr) - _age;
+  times.modtime = times.actime;
+  ASSERT_EQ(0, utime(_path.c_str(), &times));
+}
+
+/// \brief Create an empty file
+/// \param[in] _path Path
+void Touch(const std::string &_path)
+{
+  std::ofstream out(_path);
+}
+
+/////////////////////////////////////////////////
+TEST(PluginIndexTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(Libraries))
+{
+  common::Console::SetVerbosity(4);
+
+  auto testDir = common::joinPaths(PROJECT_BINARY_PATH, "test",
+      "plugin_index_libraries");
+  common::removeAll(testDir);
+  auto dir = common::joinPaths(testDir, "plugins");
+  ASSERT_TRUE(common::createDirectories(dir));
+  auto file = common::joinPaths(testDir, "index");
+
+  Touch(common::joinPaths(dir, "libfoo.so"));
+  Touch(common::joinPaths(dir, "libbar.so"));
+  Touch(common::joinPaths(dir, "notes.txt"));
+  SetModificationTime(dir, 100);
+
+  {
+    PluginIndex index(file);
+    auto libraries = index.Libraries(dir);
+    std::sort(libraries.begin(), libraries.end());
+    ASSERT_EQ(2u, libraries.size());
+    EXPECT_EQ("libbar.so", libraries[0]);
+    EXPECT_EQ("libfoo.so", libraries[1]);
+
+    EXPECT_TRUE(index.Libraries(testDir + "/doesnt_exist").empty());
+    EXPECT_TRUE(index.Save());
+  }
+  EXPECT_TRUE(common::exists(file));
+
+  // The listing comes from the file while the directory looks unchanged
+  Touch(common::joinPaths(dir, "libbaz.so"));
+  SetModificationTime(dir, 100);
+  {
+    PluginIndex index(file);
+    EXPECT_EQ(2u, index.Libraries(dir).size());
+  }
+
+  // And is refreshed when it changes
+  SetModificationTime(dir, 50);
+  {
+    PluginIndex index(file);
+    EXPECT_EQ(3u, index.Libraries(dir).size());
+  }
+
+  common::removeAll(testDir);
+}
+
+/////////////////////////////////////////////////
+TEST(PluginIndexTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(FindLibrary))
+{
+  auto testDir = common::joinPaths(PROJECT_BINARY_PATH, "test",
+      "plugin_index_find");
+  common::removeAll(testDir);
+  auto dirA = common::joinPaths(testDir, "a");
+  auto dirB = common::joinPaths(testDir, "b");
+  ASSERT_TRUE(common::createDirectories(dirA));
+  ASSERT_TRUE(common::createDirectories(dirB));
+  auto file = common::joinPaths(testDir, "index");
+
+  auto lib = common::joinPaths(dirB, "libfoo.so");
+  Touch(lib);
+  SetModificationTime(lib, 100);
+  SetModificationTime(dirA, 100);
+  SetModificationTime(dirB, 100);
+
+  int searches{0};
+  auto find = [&]()
+  {
+    ++searches;
+    return common::exists(lib) ? lib : std::string();
+  };
+  std::vector<std::string> dirs{dirA, dirB};
+
+  {
+    PluginIndex index(file);
+    EXPECT_EQ(lib, index.FindLibrary(dirs, "foo", find));
+    EXPECT_EQ(1, searches);
+    EXPECT_EQ(lib, index.FindLibrary(dirs, "foo", find));
+    EXPECT_EQ(1, searches);
+
+    // Other directories are another search
+    EXPECT_EQ(lib, index.FindLibrary({dirB}, "foo", find));
+    EXPECT_EQ(2, searches);
+
+    index.SetPluginNames(lib, {"ignition::gui::plugins::Foo"});
+  }
+
+  {
+    PluginIndex index(file);
+    EXPECT_EQ(lib, index.FindLibrary(dirs, "foo", find));
+    EXPECT_EQ(2, searches);
+
+    auto names = index.PluginNames(lib);
+    ASSERT_EQ(1u, names.size());
+    EXPECT_EQ("ignition::gui::plugins::Foo", names[0]);
+    EXPECT_TRUE(index.PluginNames(dirA).empty());
+
+    // A library added to a directory searched first may be found instead
+    SetModificationTime(dirA, 50);
+    EXPECT_EQ(lib, index.FindLibrary(dirs, "foo", find));
+    EXPECT_EQ(3, searches);
+
+    // A rebuilt library may export other plugins
+    SetModificationTime(lib, 50);
+    EXPECT_TRUE(index.PluginNames(lib).empty());
+
+    // A removed library isn't found
+    common::removeFile(lib);
+    EXPECT_TRUE(index.FindLibrary(dirs, "foo", find).empty());
+    EXPECT_EQ(4, searches);
+  }
+
+  common::removeAll(testDir);
+}
+
+/////////////////////////////////////////////////
+TEST(PluginIndexTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(PluginDirectories))
+{
+  setenv("IGN_GUI_TEST_PLUGIN_PATH", "/a:/b", 1);
+  auto dirs = PluginIndex::PluginDirectories("IGN_GUI_TEST_PLUGIN_PATH",
+      {"/c"});
+  ASSERT_EQ(5u, dirs.size());
+  EXPECT_EQ("/a", dirs[0]);
+  EXPECT_EQ("/b", dirs[1]);
+  EXPECT_EQ("/c", dirs[2]);
+  EXPECT_NE(std::string::npos, dirs[3].find(".ignition"));
+}
+
+/////////////////////////////////////////////////
+TEST(PluginIndexTest, IGN_UTILS_TEST_ENABLED_ONLY_ON_LINUX(Inspect))
+{
+  auto testDir = common::joinPaths(PROJECT_BINARY_PATH, "test",
+      "plugin_index_inspect");
+  common::removeAll(testDir);
+  ASSERT_TRUE(common::createDirectories(testDir));
+  auto file = common::joinPaths(testDir, "index");
+
+  // Copied so that it's old enough to be trusted
+  auto lib = common::joinPaths(testDir, "libTestPlugin.so");
+  ASSERT_TRUE(common::copyFile(
+      common::joinPaths(PROJECT_BINARY_PATH, "lib", "libTestPlugin.so"), lib));
+  SetModificationTime(lib, 100);
+
+  {
+    PluginIndex index(file);
+    std::vector<std::string> names;
+    std::vector<std::string> resources;
+    ASSERT_TRUE(index.Inspect(lib, names, resources));
+    ASSERT_EQ(1u, names.size());
+    EXPECT_EQ("ignition::gui::TestPlugin", names[0]);
+    ASSERT_EQ(1u, resources.size());
+    EXPECT_EQ(":/TestPlugin/TestPlugin.qml", resources[0]);
+
+    EXPECT_FALSE(index.Inspect(file, names, resources));
+  }
+
+  // Recorded in the file
+  {
+    PluginIndex index(file);
+    std::vector<std::string> names;
+    std::vector<std::string> resources;
+    ASSERT_TRUE(index.Inspect(lib, names, resources));
+    EXPECT_EQ(1u, names.size());
+    EXPECT_EQ(1u, resources.size());
+  }
+
+  common::removeAll(testDir);
+}
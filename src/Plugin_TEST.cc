@@ -70,6 +70,51 @@ TEST(PluginTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(DeleteLater))
   EXPECT_EQ(1, win->findChildren<Plugin *>().size());
 }
 
+/////////////////////////////////////////////////
+TEST(PluginTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(Lazy))
+{
+  ignition::common::Console::SetVerbosity(4);
+
+  Application app(g_argc, g_argv);
+  app.AddPluginPath(std::string(PROJECT_BINARY_PATH) + "/lib");
+
+  // Starts collapsed, so it isn't configured yet
+  const char *pluginStr =
+    "<plugin filename=\"TestPlugin\">"
+      "<ignition-gui>"
+        "<lazy>true</lazy>"
+        "<property type=\"string\" key=\"state\">docked_collapsed</property>"
+      "</ignition-gui>"
+    "</plugin>";
+
+  tinyxml2::XMLDocument pluginDoc;
+  pluginDoc.Parse(pluginStr);
+  EXPECT_TRUE(app.LoadPlugin("TestPlugin",
+      pluginDoc.FirstChildElement("plugin")));
+
+  auto win = app.findChild<MainWindow *>();
+  ASSERT_NE(nullptr, win);
+
+  auto plugins = win->findChildren<Plugin *>();
+  ASSERT_EQ(1, plugins.size());
+  EXPECT_FALSE(plugins[0]->Active());
+
+  // Configured when expanded
+  plugins[0]->CardItem()->setProperty("state", "docked");
+  EXPECT_TRUE(plugins[0]->Active());
+
+  // Suspended when collapsed again
+  plugins[0]->CardItem()->setProperty("state", "docked_collapsed");
+  EXPECT_FALSE(plugins[0]->Active());
+
+  plugins[0]->CardItem()->setVisible(false);
+  plugins[0]->CardItem()->setProperty("state", "docked");
+  EXPECT_FALSE(plugins[0]->Active());
+
+  plugins[0]->CardItem()->setVisible(true);
+  EXPECT_TRUE(plugins[0]->Active());
+}
+
 /////////////////////////////////////////////////
 TEST(PluginTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(InvalidXmlText))
 {
@@ -0,0 +1,448 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/msgs/Utility.hh>
+
+#include "ignition/gui/PoseCodec.hh"
+
+/// \brief First bytes of every frame
+static const char kMagic[2]{'I', 'P'};
+
+/// \brief Version of the frame layout
+static const std::uint8_t kVersion{1u};
+
+/// \brief Flag set on keyframes
+static const std::uint8_t kKeyframe{1u};
+
+/// \brief Magic, version, flags, sequence, stamp, resolution and count
+static const std::size_t kHeaderSize{2u + 1u + 1u + 4u + 8u + 8u + 4u};
+
+/// \brief Id, three positions and the packed rotation
+static const std::size_t kEntrySize{4u + 3u * 4u + 6u};
+
+/// \brief Largest value of a 15 bit rotation component
+static const double kRotationSteps{32767.0};
+
+/// \brief The three smallest components of a unit quaternion are within
+/// plus or minus this
+static const double kRotationRange{1.0 / std::sqrt(2.0)};
+
+namespace ignition
+{
+  namespace gui
+  {
+    /// \brief A pose as encoded
+    struct QuantizedPose
+    {
+      /// \brief Position in multiples of the resolution
+      std::int32_t position[3];
+
+      /// \brief Index of the largest component in the top two of 47 bits,
+      /// then the other three in 15 bits each
+      std::uint64_t rotation;
+
+      /// \brief Equality operator
+      /// \param[in] _other Pose to compare to
+      /// \return True if equal
+      bool operator==(const QuantizedPose &_other) const
+      {
+        return this->position[0] == _other.position[0] &&
+            this->position[1] == _other.position[1] &&
+            this->position[2] == _other.position[2] &&
+            this->rotation == _other.rotation;
+      }
+    };
+
+    class PoseEncoderPrivate
+    {
+      /// \brief Round a pose.
+      /// \param[in] _pose Pose
+      /// \return Rounded pose
+      public: QuantizedPose Quantize(const math::Pose3d &_pose) const;
+
+      /// \brief Position resolution in meters
+      public: double resolution;
+
+      /// \brief Frames between keyframes
+      public: unsigned int keyframeInterval;
+
+      /// \brief Frames since the last keyframe
+      public: unsigned int sinceKeyframe{0u};
+
+      /// \brief Whether the next frame must be a keyframe
+      public: bool forceKeyframe{true};
+
+      /// \brief Sequence number of the next frame
+      public: std::uint32_t sequence{0u};
+
+      /// \brief Last pose encoded for each entity
+      public: std::unordered_map<std::uint32_t, QuantizedPose> last;
+    };
+
+    class PoseDecoderPrivate
+    {
+      /// \brief Sequence number of the last frame, if any
+      public: std::uint32_t sequence{0u};
+
+      /// \brief Whether a frame was decoded yet
+      public: bool started{false};
+
+      /// \brief Frames missed
+      public: unsigned int missed{0u};
+
+      /// \brief Encoded positions, one array per axis, kept to reuse
+      public: std::vector<std::int32_t> encoded[3];
+
+      /// \brief Encoded rotations, kept to reuse
+      public: std::vector<std::uint64_t> rotations;
+
+      /// \brief Decoded positions, one array per axis, kept to reuse
+      public: std::vector<double> positions[3];
+
+      /// \brief Decoded smallest rotation components, then the largest
+      /// one, kept to reuse
+      public: std::vector<double> components[4];
+    };
+  }
+}
+
+using namespace ignition;
+using namespace gui;
+
+/////////////////////////////////////////////////
+/// \brief Append a little endian integer.
+/// \param[in] _value Value
+/// \param[in] _bytes Number of bytes to append
+/// \param[in,out] _data Data to append to
+static void Put(std::uint64_t _value, std::size_t _bytes, std::string &_data)
+{
+  for (std::size_t i = 0; i < _bytes; ++i)
+    _data.push_back(static_cast<char>((_value >> (8u * i)) & 0xffu));
+}
+
+/////////////////////////////////////////////////
+/// \brief Read a little endian integer.
+/// \param[in] _data Pointer to the first byte
+/// \param[in] _bytes Number of bytes to read
+/// \return Value
+static std::uint64_t Get(const char *_data, std::size_t _bytes)
+{
+  std::uint64_t value{0u};
+  for (std::size_t i = 0; i < _bytes; ++i)
+  {
+    value |= static_cast<std::uint64_t>(
+        static_cast<unsigned char>(_data[i])) << (8u * i);
+  }
+  return value;
+}
+
+/////////////////////////////////////////////////
+/// \brief Append a double by its bits.
+/// \param[in] _value Value
+/// \param[in,out] _data Data to append to
+static void PutDouble(double _value, std::string &_data)
+{
+  std::uint64_t bits;
+  std::memcpy(&bits, &_value, sizeof(bits));
+  Put(bits, 8u, _data);
+}
+
+/////////////////////////////////////////////////
+/// \brief Read a double by its bits.
+/// \param[in] _data Pointer to the first byte
+/// \return Value
+static double GetDouble(const char *_data)
+{
+  auto bits = Get(_data, 8u);
+  double value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+/////////////////////////////////////////////////
+QuantizedPose PoseEncoderPrivate::Quantize(const math::Pose3d &_pose) const
+{
+  QuantizedPose result;
+
+  const double position[3]{_pose.Pos().X(), _pose.Pos().Y(), _pose.Pos().Z()};
+  for (int i = 0; i < 3; ++i)
+  {
+    auto steps = std::round(position[i] / this->resolution);
+    steps = std::max(steps,
+        static_cast<double>(std::numeric_limits<std::int32_t>::min()));
+    steps = std::min(steps,
+        static_cast<double>(std::numeric_limits<std::int32_t>::max()));
+    result.position[i] = static_cast<std::int32_t>(steps);
+  }
+
+  auto rot = _pose.Rot();
+  rot.Normalize();
+  const double components[4]{rot.W(), rot.X(), rot.Y(), rot.Z()};
+
+  int largest = 0;
+  for (int i = 1; i < 4; ++i)
+  {
+    if (std::abs(components[i]) > std::abs(components[largest]))
+      largest = i;
+  }
+
+  // q and -q are the same rotation, so the largest component is made
+  // positive and isn't stored
+  double sign = components[largest] < 0.0 ? -1.0 : 1.0;
+  result.rotation = static_cast<std::uint64_t>(largest);
+  for (int i = 0; i < 4; ++i)
+  {
+    if (i == largest)
+      continue;
+    auto value = std::max(-kRotationRange,
+        std::min(kRotationRange, components[i] * sign));
+    auto steps = std::round((value / kRotationRange + 1.0) * 0.5 *
+        kRotationSteps);
+    result.rotation = (result.rotation << 15u) |
+        static_cast<std::uint64_t>(steps);
+  }
+  return result;
+}
+
+/////////////////////////////////////////////////
+PoseEncoder::PoseEncoder(double _resolution, unsigned int _keyframeInterval)
+  : dataPtr(new PoseEncoderPrivate)
+{
+  if (_resolution <= 0.0)
+  {
+    ignerr << "Invalid pose resolution [" << _resolution
+           << "], using 1e-4." << std::endl;
+    _resolution = 1e-4;
+  }
+  this->dataPtr->resolution = _resolution;
+  this->dataPtr->keyframeInterval = _keyframeInterval;
+}
+
+/////////////////////////////////////////////////
+PoseEncoder::~PoseEncoder() = default;
+
+/////////////////////////////////////////////////
+std::string PoseEncoder::Encode(const msgs::Pose_V &_msg)
+{
+  auto &last = this->dataPtr->last;
+
+  bool keyframe = this->dataPtr->forceKeyframe ||
+      (this->dataPtr->keyframeInterval > 0u &&
+       this->dataPtr->sinceKeyframe >= this->dataPtr->keyframeInterval);
+
+  std::vector<std::pair<std::uint32_t, QuantizedPose>> changed;
+  for (int i = 0; i < _msg.pose_size(); ++i)
+  {
+    auto id = static_cast<std::uint32_t>(_msg.pose(i).id());
+    auto quantized = this->dataPtr->Quantize(msgs::Convert(_msg.pose(i)));
+
+    auto lastIt = last.find(id);
+    if (lastIt != last.end() && lastIt->second == quantized)
+      continue;
+
+    last[id] = quantized;
+    if (!keyframe)
+      changed.emplace_back(id, quantized);
+  }
+
+  // Keyframes hold every entity seen so far
+  if (keyframe)
+  {
+    changed.assign(last.begin(), last.end());
+    std::sort(changed.begin(), changed.end(),
+        [](const std::pair<std::uint32_t, QuantizedPose> &_a,
+           const std::pair<std::uint32_t, QuantizedPose> &_b)
+        {
+          return _a.first < _b.first;
+        });
+    this->dataPtr->forceKeyframe = false;
+    this->dataPtr->sinceKeyframe = 0u;
+  }
+  ++this->dataPtr->sinceKeyframe;
+
+  double stamp = 0.0;
+  if (_msg.has_header() && _msg.header().has_stamp())
+  {
+    stamp = _msg.header().stamp().sec() +
+        _msg.header().stamp().nsec() * 1e-9;
+  }
+
+  std::string data;
+  data.reserve(kHeaderSize + changed.size() * kEntrySize);
+  data.append(kMagic, sizeof(kMagic));
+  Put(kVersion, 1u, data);
+  Put(keyframe ? kKeyframe : 0u, 1u, data);
+  Put(this->dataPtr->sequence++, 4u, data);
+  PutDouble(stamp, data);
+  PutDouble(this->dataPtr->resolution, data);
+  Put(changed.size(), 4u, data);
+
+  for (const auto &entity : changed)
+  {
+    Put(entity.first, 4u, data);
+    for (auto position : entity.second.position)
+      Put(static_cast<std::uint32_t>(position), 4u, data);
+    Put(entity.second.rotation, 6u, data);
+  }
+  return data;
+}
+
+/////////////////////////////////////////////////
+void PoseEncoder::ForceKeyframe()
+{
+  this->dataPtr->forceKeyframe = true;
+}
+
+/////////////////////////////////////////////////
+PoseDecoder::PoseDecoder()
+  : dataPtr(new PoseDecoderPrivate)
+{
+}
+
+/////////////////////////////////////////////////
+PoseDecoder::~PoseDecoder() = default;
+
+/////////////////////////////////////////////////
+bool PoseDecoder::Decode(const std::string &_data,
+    std::vector<unsigned int> &_ids, std::vector<math::Pose3d> &_poses,
+    double &_stamp)
+{
+  const char *data = _data.data();
+  if (_data.size() < kHeaderSize ||
+      std::memcmp(data, kMagic, sizeof(kMagic)) != 0)
+  {
+    ignerr << "Received data which isn't an encoded pose frame" << std::endl;
+    return false;
+  }
+  if (static_cast<std::uint8_t>(data[2]) != kVersion)
+  {
+    ignerr << "Unsupported pose frame version ["
+           << static_cast<int>(static_cast<std::uint8_t>(data[2])) << "]"
+           << std::endl;
+    return false;
+  }
+
+  auto sequence = static_cast<std::uint32_t>(Get(data + 4, 4u));
+  _stamp = GetDouble(data + 8);
+  auto resolution = GetDouble(data + 16);
+  auto count = static_cast<std::size_t>(Get(data + 24, 4u));
+  if (_data.size() != kHeaderSize + count * kEntrySize)
+  {
+    ignerr << "Pose frame of size [" << _data.size() << "] doesn't hold ["
+           << count << "] entities" << std::endl;
+    return false;
+  }
+
+  // Unsigned wrap around gives the distance, a publisher which restarted
+  // counting isn't a gap
+  if (this->dataPtr->started)
+  {
+    auto gap = sequence - this->dataPtr->sequence;
+    if (gap > 1u && gap < (1u << 31u))
+      this->dataPtr->missed += gap - 1u;
+  }
+  this->dataPtr->sequence = sequence;
+  this->dataPtr->started = true;
+
+  // Unpack into one array per field, so the conversions below are simple
+  // loops over contiguous data which the compiler vectorizes
+  auto &encoded = this->dataPtr->encoded;
+  auto &rotations = this->dataPtr->rotations;
+  _ids.resize(count);
+  for (auto &axis : encoded)
+    axis.resize(count);
+  rotations.resize(count);
+
+  const char *entry = data + kHeaderSize;
+  for (std::size_t i = 0; i < count; ++i, entry += kEntrySize)
+  {
+    _ids[i] = static_cast<unsigned int>(Get(entry, 4u));
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      encoded[axis][i] =
+          static_cast<std::int32_t>(Get(entry + 4 + axis * 4, 4u));
+    }
+    rotations[i] = Get(entry + 16, 6u);
+  }
+
+  auto &positions = this->dataPtr->positions;
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    positions[axis].resize(count);
+    const std::int32_t *in = encoded[axis].data();
+    double *out = positions[axis].data();
+    for (std::size_t i = 0; i < count; ++i)
+      out[i] = in[i] * resolution;
+  }
+
+  // Components from the most to the least significant bits, then the
+  // largest one from the unit length
+  auto &components = this->dataPtr->components;
+  for (auto &component : components)
+    component.resize(count);
+  const std::uint64_t *packed = rotations.data();
+  const double scale = 2.0 * kRotationRange / kRotationSteps;
+  for (int c = 0; c < 3; ++c)
+  {
+    const unsigned int shift = 30u - 15u * c;
+    double *out = components[c].data();
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      out[i] = static_cast<double>((packed[i] >> shift) & 0x7fffu) * scale -
+          kRotationRange;
+    }
+  }
+  {
+    const double *a = components[0].data();
+    const double *b = components[1].data();
+    const double *c = components[2].data();
+    double *out = components[3].data();
+    for (std::size_t i = 0; i < count; ++i)
+      out[i] = std::sqrt(std::max(0.0, 1.0 - a[i] * a[i] - b[i] * b[i] -
+          c[i] * c[i]));
+  }
+
+  _poses.resize(count);
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    double wxyz[4];
+    auto largest = static_cast<unsigned int>(rotations[i] >> 45u) & 0x3u;
+    for (unsigned int k = 0, c = 0; k < 4u; ++k)
+      wxyz[k] = k == largest ? components[3][i] : components[c++][i];
+
+    _poses[i].Set(
+        math::Vector3d(positions[0][i], positions[1][i], positions[2][i]),
+        math::Quaterniond(wxyz[0], wxyz[1], wxyz[2], wxyz[3]));
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////
+unsigned int PoseDecoder::Missed() const
+{
+  return this->dataPtr->missed;
+}
@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/msgs/Utility.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+#include "ignition/gui/PoseCodec.hh"
+
+using namespace ignition;
+using namespace gui;
+
+/////////////////////////////////////////////////
+/// \brief Add a pose to a msg.
+/// \param[in] _id Entity id
+/// \param[in] _pose Pose
+/// \param[in,out] _msg Msg to add to
+void AddPose(unsigned int _id, const math::Pose3d &_pose, msgs::Pose_V &_msg)
+{
+  auto pose = _msg.add_pose();
+  msgs::Set(pose, _pose);
+  pose->set_id(_id);
+}
+
+/////////////////////////////////////////////////
+/// \brief Check that two poses are the same rotation at about the same
+/// position.
+/// \param[in] _expected Expected pose
+/// \param[in] _actual Decoded pose
+void ExpectNear(const math::Pose3d &_expected, const math::Pose3d &_actual)
+{
+  EXPECT_NEAR(_expected.Pos().X(), _actual.Pos().X(), 1e-4);
+  EXPECT_NEAR(_expected.Pos().Y(), _actual.Pos().Y(), 1e-4);
+  EXPECT_NEAR(_expected.Pos().Z(), _actual.Pos().Z(), 1e-4);
+
+  // q and -q are the same rotation
+  auto dot = _expected.Rot().W() * _actual.Rot().W() +
+      _expected.Rot().X() * _actual.Rot().X() +
+      _expected.Rot().Y() * _actual.Rot().Y() +
+      _expected.Rot().Z() * _actual.Rot().Z();
+  EXPECT_NEAR(1.0, std::abs(dot), 1e-6);
+}
+
+/////////////////////////////////////////////////
+TEST(PoseCodecTest, RoundTrip)
+{
+  common::Console::SetVerbosity(4);
+
+  std::vector<math::Pose3d> poses{
+      {0, 0, 0, 0, 0, 0},
+      {1.2345, -6.789, 100.5, 0.1, 0.2, 0.3},
+      {-1000, 2000, -3000, IGN_PI, 0, 0},
+      {0.5, 0.5, 0.5, 0, -IGN_PI * 0.5, IGN_PI * 0.75},
+      {-0.00005, 0.00004, 0, -2.5, 1.0, -0.7}};
+
+  msgs::Pose_V msg;
+  msg.mutable_header()->mutable_stamp()->set_sec(12);
+  msg.mutable_header()->mutable_stamp()->set_nsec(500000000);
+  for (unsigned int i = 0; i < poses.size(); ++i)
+    AddPose(i + 10, poses[i], msg);
+
+  PoseEncoder encoder;
+  auto data = encoder.Encode(msg);
+
+  // Much smaller than the msg
+  EXPECT_LT(data.size() * 2, msg.ByteSizeLong());
+
+  PoseDecoder decoder;
+  std::vector<unsigned int> ids;
+  std::vector<math::Pose3d> decoded;
+  double stamp{0.0};
+  ASSERT_TRUE(decoder.Decode(data, ids, decoded, stamp));
+  EXPECT_DOUBLE_EQ(12.5, stamp);
+  ASSERT_EQ(poses.size(), ids.size());
+  ASSERT_EQ(poses.size(), decoded.size());
+  for (unsigned int i = 0; i < poses.size(); ++i)
+  {
+    EXPECT_EQ(i + 10, ids[i]);
+    ExpectNear(poses[i], decoded[i]);
+  }
+  EXPECT_EQ(0u, decoder.Missed());
+
+  // Invalid data is rejected
+  EXPECT_FALSE(decoder.Decode("not a frame", ids, decoded, stamp));
+  EXPECT_FALSE(decoder.Decode(data.substr(0, data.size() - 1), ids, decoded,
+      stamp));
+}
+
+/////////////////////////////////////////////////
+TEST(PoseCodecTest, Changes)
+{
+  PoseEncoder encoder(1e-3, 3);
+  PoseDecoder decoder;
+  std::vector<unsigned int> ids;
+  std::vector<math::Pose3d> decoded;
+  double stamp{0.0};
+
+  msgs::Pose_V msg;
+  AddPose(1, {1, 2, 3, 0, 0, 0}, msg);
+  AddPose(2, {4, 5, 6, 0, 0, 0}, msg);
+  ASSERT_TRUE(decoder.Decode(encoder.Encode(msg), ids, decoded, stamp));
+  EXPECT_EQ(2u, ids.size());
+
+  // Only entities which moved by at least the resolution are sent
+  msg.mutable_pose(0)->mutable_position()->set_x(1.0001);
+  msg.mutable_pose(1)->mutable_position()->set_x(4.1);
+  ASSERT_TRUE(decoder.Decode(encoder.Encode(msg), ids, decoded, stamp));
+  ASSERT_EQ(1u, ids.size());
+  EXPECT_EQ(2u, ids[0]);
+  EXPECT_NEAR(4.1, decoded[0].Pos().X(), 1e-3);
+
+  ASSERT_TRUE(decoder.Decode(encoder.Encode(msg), ids, decoded, stamp));
+  EXPECT_TRUE(ids.empty());
+
+  // Keyframes hold every entity, even those which aren't in the msg
+  msgs::Pose_V partial;
+  AddPose(3, {7, 8, 9, 0, 0, 0}, partial);
+  ASSERT_TRUE(decoder.Decode(encoder.Encode(partial), ids, decoded, stamp));
+  ASSERT_EQ(3u, ids.size());
+  EXPECT_EQ(1u, ids[0]);
+  EXPECT_EQ(2u, ids[1]);
+  EXPECT_EQ(3u, ids[2]);
+
+  ASSERT_TRUE(decoder.Decode(encoder.Encode(msg), ids, decoded, stamp));
+  EXPECT_TRUE(ids.empty());
+
+  encoder.ForceKeyframe();
+  ASSERT_TRUE(decoder.Decode(encoder.Encode(msg), ids, decoded, stamp));
+  EXPECT_EQ(3u, ids.size());
+
+  // Frames which didn't arrive are counted
+  encoder.Encode(msg);
+  encoder.Encode(msg);
+  ASSERT_TRUE(decoder.Decode(encoder.Encode(msg), ids, decoded, stamp));
+  EXPECT_EQ(2u, decoder.Missed());
+}
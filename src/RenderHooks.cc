@@ -0,0 +1,245 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/gui/PluginAccounting.hh"
+#include "ignition/gui/RenderHooks.hh"
+#include "ignition/gui/Trace.hh"
+
+namespace ignition
+{
+  namespace gui
+  {
+    /// \brief A registered hook
+    struct RenderHook
+    {
+      /// \brief ID returned by Register
+      std::size_t id;
+
+      /// \brief Function to call
+      RenderHooks::Callback cb;
+
+      /// \brief Frames between calls, as registered
+      unsigned int divisor;
+
+      /// \brief Multiplies the divisor while the hook is over budget
+      unsigned int backoff{1};
+
+      /// \brief Frames since the latest call
+      unsigned int frames{0};
+
+      /// \brief Total duration of the calls, in milliseconds
+      double total{0.0};
+
+      /// \brief Whether a warning about the budget was printed
+      bool warned{false};
+
+      /// \brief True once unregistered
+      bool removed{false};
+
+      /// \brief Stats, with the priority and budget as registered
+      RenderHookStats stats;
+
+      /// \brief Plugin which registered the hook, null if unknown
+      const Plugin *owner{nullptr};
+    };
+
+    class RenderHooksPrivate
+    {
+      /// \brief Hooks, sorted by decreasing priority
+      public: std::vector<std::shared_ptr<RenderHook>> hooks;
+
+      /// \brief Last ID given
+      public: std::size_t lastId{0};
+
+      /// \brief Protects the members above and the hooks' contents
+      public: mutable std::mutex mutex;
+
+      /// \brief Held while hooks are called, so Unregister can wait for
+      /// them. Recursive so hooks can unregister themselves.
+      public: std::recursive_mutex runMutex;
+    };
+  }
+}
+
+using namespace ignition;
+using namespace gui;
+
+/// \brief Most the divisor of a hook is multiplied by while over budget
+static const unsigned int kMaxBackoff{16};
+
+/////////////////////////////////////////////////
+RenderHooks::RenderHooks()
+  : dataPtr(new RenderHooksPrivate)
+{
+}
+
+/////////////////////////////////////////////////
+RenderHooks::~RenderHooks()
+{
+}
+
+/////////////////////////////////////////////////
+RenderHooks &RenderHooks::Instance()
+{
+  static RenderHooks hooks;
+  return hooks;
+}
+
+/////////////////////////////////////////////////
+std::size_t RenderHooks::Register(const std::string &_name,
+    const Callback &_cb, int _priority, double _budget,
+    unsigned int _divisor)
+{
+  if (!_cb)
+  {
+    ignerr << "Can't register empty render hook [" << _name << "]"
+           << std::endl;
+    return 0;
+  }
+
+  auto hook = std::make_shared<RenderHook>();
+  hook->cb = _cb;
+  hook->owner = PluginAccounting::CurrentPlugin();
+  hook->divisor = std::max(1u, _divisor);
+  hook->stats.name = _name;
+  hook->stats.priority = _priority;
+  hook->stats.budget = std::max(0.0, _budget);
+  hook->stats.divisor = hook->divisor;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  hook->id = ++this->dataPtr->lastId;
+
+  // After those of the same priority, so they're called in the order they
+  // were registered
+  auto &hooks = this->dataPtr->hooks;
+  auto it = std::upper_bound(hooks.begin(), hooks.end(), _priority,
+      [](int _p, const std::shared_ptr<RenderHook> &_h)
+      {
+        return _p > _h->stats.priority;
+      });
+  hooks.insert(it, hook);
+
+  return hook->id;
+}
+
+/////////////////////////////////////////////////
+void RenderHooks::Unregister(std::size_t _id)
+{
+  std::lock_guard<std::recursive_mutex> runLock(this->dataPtr->runMutex);
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  auto &hooks = this->dataPtr->hooks;
+  auto it = std::find_if(hooks.begin(), hooks.end(),
+      [&_id](const std::shared_ptr<RenderHook> &_hook)
+      {
+        return _hook->id == _id;
+      });
+  if (it == hooks.end())
+    return;
+
+  (*it)->removed = true;
+  hooks.erase(it);
+}
+
+/////////////////////////////////////////////////
+void RenderHooks::Run()
+{
+  std::lock_guard<std::recursive_mutex> runLock(this->dataPtr->runMutex);
+
+  // Hooks due this frame
+  std::vector<std::shared_ptr<RenderHook>> due;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    for (auto &hook : this->dataPtr->hooks)
+    {
+      if (++hook->frames >= hook->divisor * hook->backoff)
+      {
+        hook->frames = 0;
+        due.push_back(hook);
+      }
+    }
+  }
+
+  for (auto &hook : due)
+  {
+    {
+      std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+      if (hook->removed)
+        continue;
+    }
+
+    auto start = Trace::Clock::now();
+    hook->cb();
+    auto end = Trace::Clock::now();
+
+    if (Trace::Enabled())
+      Trace::Complete(hook->stats.name, "render_hook", start, end);
+    PluginAccounting::Instance().Add(hook->owner, CostKind::kRender,
+        end - start);
+
+    auto duration =
+        std::chrono::duration<double, std::milli>(end - start).count();
+
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    auto &stats = hook->stats;
+    stats.last = duration;
+    stats.max = std::max(stats.max, duration);
+    hook->total += duration;
+    ++stats.calls;
+    stats.average = hook->total / stats.calls;
+
+    if (stats.budget <= 0.0)
+      continue;
+
+    // Back off while over budget, and recover once back under it
+    if (duration > stats.budget)
+    {
+      ++stats.overBudget;
+      hook->backoff = std::min(hook->backoff * 2, kMaxBackoff);
+      if (!hook->warned)
+      {
+        ignwarn << "Render hook [" << stats.name << "] took " << duration
+                << " ms, over its budget of " << stats.budget
+                << " ms. It will be called less often." << std::endl;
+        hook->warned = true;
+      }
+    }
+    else
+    {
+      hook->backoff = std::max(hook->backoff / 2, 1u);
+    }
+    stats.divisor = hook->divisor * hook->backoff;
+  }
+}
+
+/////////////////////////////////////////////////
+std::vector<RenderHookStats> RenderHooks::Stats() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  std::vector<RenderHookStats> stats;
+  for (const auto &hook : this->dataPtr->hooks)
+    stats.push_back(hook->stats);
+  return stats;
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/gui/RenderHooks.hh"
+
+using namespace ignition;
+using namespace gui;
+
+/////////////////////////////////////////////////
+TEST(RenderHooksTest, Order)
+{
+  common::Console::SetVerbosity(4);
+
+  RenderHooks hooks;
+  EXPECT_EQ(0u, hooks.Register("empty", RenderHooks::Callback()));
+
+  std::vector<std::string> calls;
+  auto low = hooks.Register("low", [&]() {calls.push_back("low");}, -1);
+  auto first = hooks.Register("first", [&]() {calls.push_back("first");});
+  auto high = hooks.Register("high", [&]() {calls.push_back("high");}, 10);
+  auto second = hooks.Register("second", [&]() {calls.push_back("second");});
+  EXPECT_NE(0u, low);
+  EXPECT_NE(0u, high);
+
+  hooks.Run();
+  EXPECT_EQ(std::vector<std::string>({"high", "first", "second", "low"}),
+      calls);
+
+  auto stats = hooks.Stats();
+  ASSERT_EQ(4u, stats.size());
+  EXPECT_EQ("high", stats[0].name);
+  EXPECT_EQ(10, stats[0].priority);
+  EXPECT_EQ(1u, stats[0].calls);
+
+  hooks.Unregister(first);
+  hooks.Unregister(second);
+  hooks.Unregister(second);
+  calls.clear();
+  hooks.Run();
+  EXPECT_EQ(std::vector<std::string>({"high", "low"}), calls);
+  EXPECT_EQ(2u, hooks.Stats().size());
+}
+
+/////////////////////////////////////////////////
+TEST(RenderHooksTest, Divisor)
+{
+  RenderHooks hooks;
+
+  int everyFrame{0};
+  int everyThird{0};
+  hooks.Register("every frame", [&]() {++everyFrame;});
+  hooks.Register("every third", [&]() {++everyThird;}, 0, 0.0, 3);
+
+  for (int i = 0; i < 9; ++i)
+    hooks.Run();
+  EXPECT_EQ(9, everyFrame);
+  EXPECT_EQ(3, everyThird);
+}
+
+/////////////////////////////////////////////////
+TEST(RenderHooksTest, Budget)
+{
+  RenderHooks hooks;
+
+  bool slow{true};
+  int calls{0};
+  hooks.Register("slow", [&]()
+  {
+    ++calls;
+    if (slow)
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }, 0, 1.0);
+
+  // Called every 2 frames, then 4
+  for (int i = 0; i < 7; ++i)
+    hooks.Run();
+  EXPECT_EQ(3, calls);
+
+  auto stats = hooks.Stats();
+  ASSERT_EQ(1u, stats.size());
+  EXPECT_EQ(3u, stats[0].calls);
+  EXPECT_EQ(3u, stats[0].overBudget);
+  EXPECT_EQ(8u, stats[0].divisor);
+  EXPECT_GE(stats[0].max, 5.0);
+
+  // Never less often than every 16 frames
+  for (int i = 0; i < 64; ++i)
+    hooks.Run();
+  EXPECT_EQ(16u, hooks.Stats()[0].divisor);
+
+  // Back to every frame once fast
+  slow = false;
+  for (int i = 0; i < 64; ++i)
+    hooks.Run();
+  stats = hooks.Stats();
+  EXPECT_EQ(1u, stats[0].divisor);
+  EXPECT_LT(stats[0].last, 1.0);
+}
+
+/////////////////////////////////////////////////
+TEST(RenderHooksTest, UnregisterItself)
+{
+  RenderHooks hooks;
+
+  int calls{0};
+  std::size_t id{0};
+  id = hooks.Register("once", [&]()
+  {
+    ++calls;
+    hooks.Unregister(id);
+  });
+
+  hooks.Run();
+  hooks.Run();
+  EXPECT_EQ(1, calls);
+  EXPECT_TRUE(hooks.Stats().empty());
+}
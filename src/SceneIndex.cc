@@ -0,0 +1,232 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ignition/gui/SceneIndex.hh"
+
+namespace ignition
+{
+  namespace gui
+  {
+    /// \brief An entity and what's derived from it
+    struct SceneIndexEntry
+    {
+      /// \brief The entity
+      SceneEntity entity;
+
+      /// \brief Rendering node
+      std::weak_ptr<void> node;
+
+      /// \brief Ids of the children
+      std::vector<unsigned int> children;
+    };
+
+    class SceneIndexPrivate
+    {
+      /// \brief Remove an entity and its descendants. Call with mutex
+      /// locked.
+      /// \param[in] _id Entity id
+      /// \param[in] _unlink Whether to remove it from its parent's children
+      public: void Remove(unsigned int _id, bool _unlink);
+
+      /// \brief Entities by id
+      public: std::unordered_map<unsigned int, SceneIndexEntry> entries;
+
+      /// \brief Entity ids by scoped name
+      public: std::unordered_map<std::string, unsigned int> names;
+
+      /// \brief Ids of the top level entities
+      public: std::vector<unsigned int> roots;
+
+      /// \brief Incremented on each change
+      public: std::uint64_t revision{0u};
+
+      /// \brief Protects the members above
+      public: mutable std::mutex mutex;
+    };
+  }
+}
+
+using namespace ignition;
+using namespace gui;
+
+/////////////////////////////////////////////////
+void SceneIndexPrivate::Remove(unsigned int _id, bool _unlink)
+{
+  auto entryIt = this->entries.find(_id);
+  if (entryIt == this->entries.end())
+    return;
+
+  auto entry = std::move(entryIt->second);
+  this->entries.erase(entryIt);
+
+  auto nameIt = this->names.find(entry.entity.scopedName);
+  if (nameIt != this->names.end() && nameIt->second == _id)
+    this->names.erase(nameIt);
+
+  if (_unlink)
+  {
+    auto parentIt = this->entries.find(entry.entity.parent);
+    auto &siblings = parentIt == this->entries.end() ?
+        this->roots : parentIt->second.children;
+    siblings.erase(std::remove(siblings.begin(), siblings.end(), _id),
+        siblings.end());
+  }
+
+  for (auto child : entry.children)
+    this->Remove(child, false);
+}
+
+/////////////////////////////////////////////////
+SceneIndex::SceneIndex()
+  : dataPtr(new SceneIndexPrivate)
+{
+}
+
+/////////////////////////////////////////////////
+SceneIndex::~SceneIndex() = default;
+
+/////////////////////////////////////////////////
+SceneIndex &SceneIndex::Instance(const std::string &_scene)
+{
+  static std::mutex mutex;
+  static std::map<std::string, std::unique_ptr<SceneIndex>> indices;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto &index = indices[_scene];
+  if (!index)
+    index.reset(new SceneIndex);
+  return *index;
+}
+
+/////////////////////////////////////////////////
+bool SceneIndex::Entity(unsigned int _id, SceneEntity &_entity) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto entryIt = this->dataPtr->entries.find(_id);
+  if (entryIt == this->dataPtr->entries.end())
+    return false;
+
+  _entity = entryIt->second.entity;
+  return true;
+}
+
+/////////////////////////////////////////////////
+unsigned int SceneIndex::IdByName(const std::string &_scopedName) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto nameIt = this->dataPtr->names.find(_scopedName);
+  return nameIt == this->dataPtr->names.end() ? 0u : nameIt->second;
+}
+
+/////////////////////////////////////////////////
+std::vector<unsigned int> SceneIndex::Children(unsigned int _id) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  if (_id == 0u)
+    return this->dataPtr->roots;
+
+  auto entryIt = this->dataPtr->entries.find(_id);
+  if (entryIt == this->dataPtr->entries.end())
+    return {};
+  return entryIt->second.children;
+}
+
+/////////////////////////////////////////////////
+std::size_t SceneIndex::Size() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->entries.size();
+}
+
+/////////////////////////////////////////////////
+std::uint64_t SceneIndex::Revision() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->revision;
+}
+
+/////////////////////////////////////////////////
+void SceneIndex::Add(const SceneEntity &_entity,
+    const std::shared_ptr<void> &_node)
+{
+  if (_entity.id == 0u)
+    return;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->Remove(_entity.id, true);
+
+  SceneIndexEntry entry;
+  entry.entity = _entity;
+  entry.node = _node;
+
+  auto parentIt = this->dataPtr->entries.find(_entity.parent);
+  if (parentIt == this->dataPtr->entries.end())
+  {
+    entry.entity.parent = 0u;
+    entry.entity.scopedName = _entity.name;
+    this->dataPtr->roots.push_back(_entity.id);
+  }
+  else
+  {
+    entry.entity.scopedName =
+        parentIt->second.entity.scopedName + "::" + _entity.name;
+    parentIt->second.children.push_back(_entity.id);
+  }
+
+  // The first entity keeps the name when there are duplicates
+  this->dataPtr->names.emplace(entry.entity.scopedName, _entity.id);
+  this->dataPtr->entries[_entity.id] = std::move(entry);
+  ++this->dataPtr->revision;
+}
+
+/////////////////////////////////////////////////
+void SceneIndex::Remove(unsigned int _id)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  if (this->dataPtr->entries.find(_id) == this->dataPtr->entries.end())
+    return;
+
+  this->dataPtr->Remove(_id, true);
+  ++this->dataPtr->revision;
+}
+
+/////////////////////////////////////////////////
+void SceneIndex::Clear()
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->entries.clear();
+  this->dataPtr->names.clear();
+  this->dataPtr->roots.clear();
+  ++this->dataPtr->revision;
+}
+
+/////////////////////////////////////////////////
+std::shared_ptr<void> SceneIndex::NodePtr(unsigned int _id) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto entryIt = this->dataPtr->entries.find(_id);
+  if (entryIt == this->dataPtr->entries.end())
+    return nullptr;
+  return entryIt->second.node.lock();
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "test_config.h"  // NOLINT(build/include)
+#include "ignition/gui/SceneIndex.hh"
+
+using namespace ignition;
+using namespace gui;
+
+/////////////////////////////////////////////////
+/// \brief Make an entity.
+/// \param[in] _id Id
+/// \param[in] _name Name
+/// \param[in] _parent Parent id
+/// \param[in] _kind Kind
+/// \return The entity
+SceneEntity MakeEntity(unsigned int _id, const std::string &_name,
+    unsigned int _parent, SceneEntity::Kind _kind)
+{
+  SceneEntity entity;
+  entity.id = _id;
+  entity.name = _name;
+  entity.parent = _parent;
+  entity.kind = _kind;
+  return entity;
+}
+
+/////////////////////////////////////////////////
+TEST(SceneIndexTest, Lookup)
+{
+  SceneIndex index;
+  EXPECT_EQ(0u, index.Size());
+  auto revision = index.Revision();
+
+  auto node = std::make_shared<int>(5);
+  index.Add(MakeEntity(1, "box", 0, SceneEntity::Kind::MODEL));
+  index.Add(MakeEntity(2, "link", 1, SceneEntity::Kind::LINK), node);
+  index.Add(MakeEntity(3, "visual", 2, SceneEntity::Kind::VISUAL));
+  index.Add(MakeEntity(4, "sun", 0, SceneEntity::Kind::LIGHT));
+  EXPECT_EQ(4u, index.Size());
+  EXPECT_NE(revision, index.Revision());
+
+  // By id
+  SceneEntity entity;
+  ASSERT_TRUE(index.Entity(3, entity));
+  EXPECT_EQ("visual", entity.name);
+  EXPECT_EQ("box::link::visual", entity.scopedName);
+  EXPECT_EQ(2u, entity.parent);
+  EXPECT_EQ(SceneEntity::Kind::VISUAL, entity.kind);
+  EXPECT_FALSE(index.Entity(5, entity));
+
+  // By name
+  EXPECT_EQ(2u, index.IdByName("box::link"));
+  EXPECT_EQ(4u, index.IdByName("sun"));
+  EXPECT_EQ(0u, index.IdByName("link"));
+
+  // Relationships
+  EXPECT_EQ(std::vector<unsigned int>({1, 4}), index.Children(0));
+  EXPECT_EQ(std::vector<unsigned int>({2}), index.Children(1));
+  EXPECT_TRUE(index.Children(3).empty());
+
+  // Nodes
+  EXPECT_EQ(node, index.Node<int>(2));
+  EXPECT_EQ(nullptr, index.Node<int>(1));
+  node.reset();
+  EXPECT_EQ(nullptr, index.Node<int>(2));
+}
+
+/////////////////////////////////////////////////
+TEST(SceneIndexTest, Remove)
+{
+  SceneIndex index;
+  index.Add(MakeEntity(1, "box", 0, SceneEntity::Kind::MODEL));
+  index.Add(MakeEntity(2, "link", 1, SceneEntity::Kind::LINK));
+  index.Add(MakeEntity(3, "visual", 2, SceneEntity::Kind::VISUAL));
+  index.Add(MakeEntity(4, "sphere", 0, SceneEntity::Kind::MODEL));
+
+  // Descendants go with their ancestor
+  auto revision = index.Revision();
+  index.Remove(1);
+  EXPECT_NE(revision, index.Revision());
+  EXPECT_EQ(1u, index.Size());
+  EXPECT_EQ(0u, index.IdByName("box::link::visual"));
+  EXPECT_EQ(std::vector<unsigned int>({4}), index.Children(0));
+
+  revision = index.Revision();
+  index.Remove(1);
+  EXPECT_EQ(revision, index.Revision());
+
+  // Adding again replaces
+  index.Add(MakeEntity(4, "cylinder", 0, SceneEntity::Kind::MODEL));
+  EXPECT_EQ(1u, index.Size());
+  EXPECT_EQ(0u, index.IdByName("sphere"));
+  EXPECT_EQ(4u, index.IdByName("cylinder"));
+
+  index.Clear();
+  EXPECT_EQ(0u, index.Size());
+  EXPECT_TRUE(index.Children(0).empty());
+
+  // Each scene has its own
+  EXPECT_NE(&SceneIndex::Instance("a"), &SceneIndex::Instance("b"));
+  EXPECT_EQ(&SceneIndex::Instance(), &SceneIndex::Instance("scene"));
+}
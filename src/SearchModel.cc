@@ -15,85 +15,336 @@
  *
 */
 
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
 #include <ignition/common/Console.hh>
 
 #include "ignition/gui/Enums.hh"
 #include "ignition/gui/SearchModel.hh"
 
+namespace ignition
+{
+namespace gui
+{
+  /// \brief A source row, as searched
+  struct SearchNode
+  {
+    /// \brief Lowercase text of the filter role
+    QString text;
+
+    /// \brief True for titles, which are never accepted
+    bool title;
+
+    /// \brief Position of the parent row, -1 for top level rows
+    int parent;
+  };
+
+  /// \brief Snapshot of the text of the source model, which can be
+  /// searched away from the GUI thread. Rows are in pre-order, so parents
+  /// come before their children.
+  struct SearchTree
+  {
+    /// \brief All rows of the source model
+    std::vector<SearchNode> nodes;
+  };
+
+  /// \brief Result of a search for a source row
+  struct SearchMatch
+  {
+    /// \brief True if the row is accepted
+    bool accepted;
+
+    /// \brief True if one of its descendants contains one of the words
+    bool expand;
+  };
+
+  class SearchModelPrivate
+  {
+    /// \brief Add a source row and its descendants to the snapshot.
+    /// \param[in] _model Source model
+    /// \param[in] _index Source row, invalid for the root
+    /// \param[in] _parent Position of the row in the snapshot, -1 for the
+    /// root
+    /// \param[in, out] _tree Snapshot being built
+    public: void Index(const QAbstractItemModel *_model,
+                       const QModelIndex &_index, const int _parent,
+                       SearchTree &_tree);
+
+    /// \brief Match all rows of a snapshot against a search.
+    /// \param[in] _tree Snapshot
+    /// \param[in] _search Full search string
+    /// \param[out] _matches Result for each row of the snapshot
+    /// \param[in] _generation Search generation, checked regularly so the
+    /// search stops when a newer one starts. Null to never stop.
+    /// \param[in] _expected Generation of this search
+    /// \return False if the search was stopped
+    public: static bool Match(const SearchTree &_tree, const QString &_search,
+                              std::vector<SearchMatch> &_matches,
+                              const std::atomic<uint64_t> *_generation,
+                              const uint64_t _expected);
+
+    /// \brief Snapshot of the source model, null until needed and when the
+    /// model changes
+    public: std::shared_ptr<const SearchTree> tree;
+
+    /// \brief Position of each source row in the snapshot
+    public: QHash<QModelIndex, int> ids;
+
+    /// \brief Role the snapshot was taken from
+    public: int indexedRole{-1};
+
+    /// \brief Snapshot the shown matches were computed on
+    public: std::shared_ptr<const SearchTree> matchedTree;
+
+    /// \brief Search the shown matches were computed for
+    public: QString matchedSearch;
+
+    /// \brief Shown result for each row of the matched snapshot
+    public: std::vector<SearchMatch> matches;
+
+    /// \brief Delay before searching, in milliseconds. 0 to search right
+    /// away.
+    public: int delay{0};
+
+    /// \brief Waits for typing to pause before searching
+    public: QTimer timer;
+
+    /// \brief Searches in the background
+    public: std::thread worker;
+
+    /// \brief Incremented for each search, stopping older ones
+    public: std::atomic<uint64_t> generation{0};
+
+    /// \brief Protects the result below
+    public: std::mutex mutex;
+
+    /// \brief Last result of the worker
+    public: std::vector<SearchMatch> result;
+
+    /// \brief Snapshot the result was computed on
+    public: std::shared_ptr<const SearchTree> resultTree;
+
+    /// \brief Search the result was computed for
+    public: QString resultSearch;
+
+    /// \brief Generation of the result
+    public: uint64_t resultGeneration{0};
+  };
+}
+}
+
 using namespace ignition;
 using namespace gui;
 
 /////////////////////////////////////////////////
-bool SearchModel::filterAcceptsRow(const int _srcRow,
-      const QModelIndex &_srcParent) const
+void SearchModelPrivate::Index(const QAbstractItemModel *_model,
+    const QModelIndex &_index, const int _parent, SearchTree &_tree)
 {
-  // Item index in search model.
-  auto id = this->sourceModel()->index(_srcRow, 0, _srcParent);
-
-  // Ignore titles.
-  if (this->sourceModel()->data(id, DataRole::TYPE).toString() ==
-      "title")
+  for (int i = 0; i < _model->rowCount(_index); ++i)
   {
-    return false;
+    auto child = _model->index(i, 0, _index);
+    int id = static_cast<int>(_tree.nodes.size());
+    this->ids[child] = id;
+    _tree.nodes.push_back({
+        _model->data(child, this->indexedRole).toString().toLower(),
+        _model->data(child, DataRole::TYPE).toString() == "title",
+        _parent});
+    this->Index(_model, child, id, _tree);
   }
+}
 
-  // Collapsed by default.
-  this->sourceModel()->blockSignals(true);
-  this->sourceModel()->setData(id, false, DataRole::TO_EXPAND);
-  this->sourceModel()->blockSignals(false);
+/////////////////////////////////////////////////
+bool SearchModelPrivate::Match(const SearchTree &_tree,
+    const QString &_search, std::vector<SearchMatch> &_matches,
+    const std::atomic<uint64_t> *_generation, const uint64_t _expected)
+{
+  // Lowercase, distinct words. Only the first 64 are used, one bit each.
+  QStringList words;
+  for (const auto &word : _search.toLower().split(" "))
+  {
+    if (!word.isEmpty() && !words.contains(word) && words.size() < 64)
+      words.append(word);
+  }
+  uint64_t all = words.size() >= 64 ? ~uint64_t(0) :
+      (uint64_t(1) << words.size()) - 1;
 
-  // Empty search matches everything.
-  if (this->search.isEmpty())
-    return true;
+  const auto &nodes = _tree.nodes;
+  std::vector<uint64_t> self(nodes.size(), 0);
+  std::vector<uint64_t> path(nodes.size(), 0);
 
-  // Each word must match at least once, either self, parent or child.
-  auto words = this->search.split(" ");
-  for (auto word : words)
+  // Words in each row and its ancestors, parents first
+  for (std::size_t i = 0; i < nodes.size(); ++i)
   {
-    if (word.isEmpty())
-      continue;
+    if (_generation && (i & 255) == 0 && *_generation != _expected)
+      return false;
 
-    // Expand this if at least one child contains the word.
-    // Note that this is not enough for this to be accepted, we need to match
-    // all words.
-    if (this->HasChildAcceptsItself(id, word))
+    for (int w = 0; w < words.size(); ++w)
     {
-      this->sourceModel()->blockSignals(true);
-      this->sourceModel()->setData(id, true, DataRole::TO_EXPAND);
-      this->sourceModel()->blockSignals(false);
+      if (nodes[i].text.contains(words[w]))
+        self[i] |= uint64_t(1) << w;
     }
+    path[i] = self[i] | (nodes[i].parent < 0 ? 0 : path[nodes[i].parent]);
+  }
 
-    // At least one of the children fits rule 1.
-    if (this->HasAcceptedChildren(_srcRow, _srcParent))
-      continue;
+  // A row is accepted if all words are in itself or its ancestors, or if
+  // one of its children is accepted. Children first.
+  std::vector<uint64_t> descendants(nodes.size(), 0);
+  std::vector<char> childAccepted(nodes.size(), 0);
+  _matches.assign(nodes.size(), {false, false});
+  for (auto i = nodes.size(); i-- > 0;)
+  {
+    if (_generation && (i & 255) == 0 && *_generation != _expected)
+      return false;
 
-    // Row itself contains this word.
-    if (this->FilterAcceptsRowItself(_srcRow, _srcParent, word))
-      continue;
+    bool accepted = !nodes[i].title &&
+        (childAccepted[i] || (path[i] & all) == all);
+    _matches[i] = {accepted, descendants[i] != 0};
 
-    // One of the ancestors contains this word.
-    QModelIndex parentIndex = _srcParent;
-    bool parentAccepted = false;
-    while (parentIndex.isValid())
+    auto parent = nodes[i].parent;
+    if (parent >= 0)
     {
-      if (this->FilterAcceptsRowItself(parentIndex.row(),
-          parentIndex.parent(), word))
-      {
-        parentAccepted = true;
-        break;
-      }
-      parentIndex = parentIndex.parent();
+      descendants[parent] |= self[i] | descendants[i];
+      if (accepted)
+        childAccepted[parent] = 1;
     }
+  }
+  return true;
+}
 
-    if (parentAccepted)
-      continue;
+/////////////////////////////////////////////////
+SearchModel::SearchModel()
+  : dataPtr(new SearchModelPrivate)
+{
+  this->dataPtr->timer.setSingleShot(true);
+  this->connect(&this->dataPtr->timer, SIGNAL(timeout()), this,
+      SLOT(StartSearch()));
+}
 
-    // This word can't be found on the row or a parent, and no child is fully
-    // accepted.
-    return false;
+/////////////////////////////////////////////////
+SearchModel::~SearchModel()
+{
+  ++this->dataPtr->generation;
+  if (this->dataPtr->worker.joinable())
+    this->dataPtr->worker.join();
+}
+
+/////////////////////////////////////////////////
+void SearchModel::setSourceModel(QAbstractItemModel *_sourceModel)
+{
+  if (this->sourceModel())
+    this->sourceModel()->disconnect(this);
+
+  // Connected before the proxy's own connections, so the snapshot is
+  // dropped before the proxy filters the changed rows
+  if (_sourceModel)
+  {
+    auto clear = [this]()
+    {
+      this->dataPtr->tree.reset();
+      this->dataPtr->ids.clear();
+    };
+    // Data which isn't searched, such as live statistics, can change
+    // often without indexing the model again
+    this->connect(_sourceModel, &QAbstractItemModel::dataChanged, this,
+        [this, clear](const QModelIndex &, const QModelIndex &,
+            const QVector<int> &_roles)
+        {
+          if (_roles.isEmpty() || _roles.contains(this->filterRole()) ||
+              _roles.contains(DataRole::TYPE))
+          {
+            clear();
+          }
+        });
+    this->connect(_sourceModel, &QAbstractItemModel::rowsInserted, this,
+        clear);
+    this->connect(_sourceModel, &QAbstractItemModel::rowsRemoved, this,
+        clear);
+    this->connect(_sourceModel, &QAbstractItemModel::rowsMoved, this,
+        clear);
+    this->connect(_sourceModel, &QAbstractItemModel::modelReset, this,
+        clear);
+    this->connect(_sourceModel, &QAbstractItemModel::layoutChanged, this,
+        clear);
   }
 
-  return true;
+  this->dataPtr->tree.reset();
+  this->dataPtr->ids.clear();
+
+  QSortFilterProxyModel::setSourceModel(_sourceModel);
+}
+
+/////////////////////////////////////////////////
+void SearchModel::Snapshot() const
+{
+  auto &data = *this->dataPtr;
+  if (data.tree && data.indexedRole == this->filterRole())
+    return;
+
+  data.ids.clear();
+  data.indexedRole = this->filterRole();
+
+  auto tree = std::make_shared<SearchTree>();
+  if (this->sourceModel())
+    data.Index(this->sourceModel(), QModelIndex(), -1, *tree);
+  data.tree = tree;
+}
+
+/////////////////////////////////////////////////
+bool SearchModel::filterAcceptsRow(const int _srcRow,
+      const QModelIndex &_srcParent) const
+{
+  // Nothing is written to the source model, the expansion is kept with
+  // the matches
+  return this->Match(this->sourceModel()->index(_srcRow, 0,
+      _srcParent)).accepted;
+}
+
+/////////////////////////////////////////////////
+QVariant SearchModel::data(const QModelIndex &_index, int _role) const
+{
+  // Expanded if at least one descendant contains a word.
+  if (_role == DataRole::TO_EXPAND)
+  {
+    if (!_index.isValid())
+      return QVariant();
+    return this->Match(this->mapToSource(_index)).expand;
+  }
+
+  return QSortFilterProxyModel::data(_index, _role);
+}
+
+/////////////////////////////////////////////////
+SearchMatch SearchModel::Match(const QModelIndex &_srcIndex) const
+{
+  auto &data = *this->dataPtr;
+
+  this->Snapshot();
+
+  // Without delay, the search is always the one shown
+  if (data.delay <= 0 && data.matchedSearch != this->search)
+  {
+    data.matchedSearch = this->search;
+    data.matchedTree.reset();
+  }
+
+  // The model changed since the shown search, which is quick to redo
+  if (data.matchedTree != data.tree)
+  {
+    SearchModelPrivate::Match(*data.tree, data.matchedSearch, data.matches,
+        nullptr, 0);
+    data.matchedTree = data.tree;
+  }
+
+  auto node = data.ids.value(_srcIndex, -1);
+  if (node < 0)
+    return {true, false};
+  return data.matches[node];
 }
 
 /////////////////////////////////////////////////
@@ -148,6 +399,101 @@ void SearchModel::SetSearch(const QString &_search)
 {
   this->search = _search;
 
+  // A search in progress is outdated
+  ++this->dataPtr->generation;
+
+  if (this->dataPtr->delay > 0)
+  {
+    // Restarted on each keystroke
+    this->dataPtr->timer.start(this->dataPtr->delay);
+    return;
+  }
+
+  this->dataPtr->timer.stop();
+  this->Refilter();
+}
+
+/////////////////////////////////////////////////
+void SearchModel::SetDelay(const int _delay)
+{
+  this->dataPtr->delay = _delay;
+}
+
+/////////////////////////////////////////////////
+int SearchModel::Delay() const
+{
+  return this->dataPtr->delay;
+}
+
+/////////////////////////////////////////////////
+void SearchModel::StartSearch()
+{
+  auto &data = *this->dataPtr;
+  if (!this->sourceModel())
+    return;
+
+  this->Snapshot();
+
+  // The previous search was stopped when this one was asked for
+  auto generation = ++data.generation;
+  if (data.worker.joinable())
+    data.worker.join();
+
+  auto tree = data.tree;
+  auto search = this->search;
+  data.worker = std::thread([this, tree, search, generation]()
+  {
+    auto &worker = *this->dataPtr;
+
+    std::vector<SearchMatch> matches;
+    if (!SearchModelPrivate::Match(*tree, search, matches, &worker.generation,
+        generation))
+    {
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(worker.mutex);
+      worker.result = std::move(matches);
+      worker.resultTree = tree;
+      worker.resultSearch = search;
+      worker.resultGeneration = generation;
+    }
+    QMetaObject::invokeMethod(this, "ApplySearch", Qt::QueuedConnection);
+  });
+}
+
+/////////////////////////////////////////////////
+void SearchModel::ApplySearch()
+{
+  auto &data = *this->dataPtr;
+  {
+    std::lock_guard<std::mutex> lock(data.mutex);
+
+    // Superseded by another search
+    if (data.resultGeneration != data.generation || !data.resultTree)
+      return;
+
+    // The model changed meanwhile, search it again
+    if (data.resultTree != data.tree)
+    {
+      data.resultTree.reset();
+      QMetaObject::invokeMethod(this, "StartSearch", Qt::QueuedConnection);
+      return;
+    }
+
+    data.matches = std::move(data.result);
+    data.matchedTree = data.resultTree;
+    data.matchedSearch = data.resultSearch;
+    data.resultTree.reset();
+  }
+
+  this->Refilter();
+}
+
+/////////////////////////////////////////////////
+void SearchModel::Refilter()
+{
   // Trigger repaint on whole model
   this->invalidateFilter();
 
@@ -155,4 +501,3 @@ void SearchModel::SetSearch(const QString &_search)
   // TopicsStats
   this->layoutChanged();
 }
-
@@ -17,6 +17,9 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <thread>
+
 #include <ignition/common/Console.hh>
 
 #include "test_config.h"  // NOLINT(build/include)
@@ -94,6 +97,12 @@ TEST(SearchModelTest, FlatStructure)
 
   searchModel->SetSearch("ob");
   EXPECT_EQ(searchModel->rowCount(), 1);
+
+  // Only changes to the searched text are searched again
+  sourceModel->item(1)->setData(42, Qt::UserRole);
+  EXPECT_EQ(searchModel->rowCount(), 1);
+  sourceModel->item(1)->setData("foobaz", DataRole::DISPLAY_NAME);
+  EXPECT_EQ(searchModel->rowCount(), 2);
 }
 
 /////////////////////////////////////////////////
@@ -162,6 +171,10 @@ TEST(SearchModelTest, NestedStructure)
     EXPECT_EQ(countRowsOfIndex(id) + 1, 2);
   }
 
+  // The expansion isn't written to the source model
+  EXPECT_FALSE(sourceModel->data(sourceModel->index(0, 0),
+      DataRole::TO_EXPAND).isValid());
+
   // Searches which only have rows "a", "c", "d"
   for (auto s : {"c", "d", "a c", "a d", "a c d", "c d"})
   {
@@ -173,3 +186,73 @@ TEST(SearchModelTest, NestedStructure)
   }
 }
 
+
+/////////////////////////////////////////////////
+TEST(SearchModelTest, Delay)
+{
+  ignition::common::Console::SetVerbosity(4);
+
+  int argc = 1;
+  char **argv = new char *[argc];
+  QCoreApplication app(argc, argv);
+
+  auto sourceModel = new QStandardItemModel();
+  for (auto item : {"foo", "bar", "foobar", "foofoo"})
+  {
+    auto it = new QStandardItem();
+    it->setData(item, DataRole::DISPLAY_NAME);
+    sourceModel->appendRow(it);
+  }
+
+  auto searchModel = new SearchModel();
+  searchModel->setFilterRole(DataRole::DISPLAY_NAME);
+  searchModel->setSourceModel(sourceModel);
+  EXPECT_EQ(0, searchModel->Delay());
+
+  searchModel->SetDelay(50);
+  EXPECT_EQ(50, searchModel->Delay());
+
+  // Waits until the search is shown
+  auto wait = [&](const int _rows)
+  {
+    for (int i = 0; i < 100 && searchModel->rowCount() != _rows; ++i)
+    {
+      QCoreApplication::processEvents();
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return searchModel->rowCount();
+  };
+
+  // Not filtered right away
+  searchModel->SetSearch("foo");
+  EXPECT_EQ(4, searchModel->rowCount());
+  EXPECT_EQ(3, wait(3));
+
+  // Only the last of several quick searches is shown
+  searchModel->SetSearch("b");
+  searchModel->SetSearch("ba");
+  searchModel->SetSearch("lala");
+  EXPECT_EQ(3, searchModel->rowCount());
+  EXPECT_EQ(0, wait(0));
+
+  // Model changes are applied to the search shown
+  searchModel->SetSearch("foo");
+  EXPECT_EQ(3, wait(3));
+  auto it = new QStandardItem();
+  it->setData("food", DataRole::DISPLAY_NAME);
+  sourceModel->appendRow(it);
+  EXPECT_EQ(4, searchModel->rowCount());
+
+  // Back to filtering right away
+  searchModel->SetDelay(0);
+  searchModel->SetSearch("bar");
+  EXPECT_EQ(2, searchModel->rowCount());
+
+  // Destroyed while searching
+  searchModel->SetDelay(1);
+  searchModel->SetSearch("foo");
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  QCoreApplication::processEvents();
+  delete searchModel;
+  delete sourceModel;
+}
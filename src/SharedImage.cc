@@ -0,0 +1,460 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <set>
+#include <string>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/gui/SharedImage.hh"
+
+namespace ignition
+{
+  namespace gui
+  {
+    /// \brief Start of the shared memory
+    struct SharedRingHeader
+    {
+      /// \brief Identifies ring layouts this code understands
+      std::uint32_t magic;
+
+      /// \brief Number of slots
+      std::uint32_t slots;
+
+      /// \brief Bytes of pixel data each slot holds
+      std::uint64_t slotSize;
+    };
+
+    /// \brief Start of each slot, followed by its pixel data
+    struct SharedSlotHeader
+    {
+      /// \brief Odd while the slot is being written
+      std::atomic<std::uint64_t> seq;
+
+      /// \brief Number of the frame in the slot, starting at 1
+      std::uint64_t frame;
+
+      /// \brief Bytes of pixel data in the slot
+      std::uint64_t size;
+    };
+
+    /// \brief A mapped ring
+    struct SharedRing
+    {
+      /// \brief Name of the shared memory, empty if not mapped
+      std::string name;
+
+      /// \brief Start of the mapping
+      void *memory{nullptr};
+
+      /// \brief Size of the mapping
+      std::size_t length{0u};
+
+      /// \brief Ring header, within the mapping
+      SharedRingHeader *header{nullptr};
+    };
+
+    class SharedImageWriterPrivate
+    {
+      /// \brief Create a ring with slots of at least the given size.
+      /// \param[in] _size Bytes of pixel data per slot
+      /// \return True if created
+      public: bool Create(std::size_t _size);
+
+      /// \brief Number of slots
+      public: unsigned int slots;
+
+      /// \brief Current ring
+      public: SharedRing ring;
+
+      /// \brief Frames written so far
+      public: std::uint64_t frames{0u};
+
+      /// \brief True once creating shared memory failed, to stop trying
+      public: bool failed{false};
+    };
+
+    class SharedImageReaderPrivate
+    {
+      /// \brief Map a ring, unless it's mapped already.
+      /// \param[in] _name Name of the shared memory
+      /// \return True if mapped
+      public: bool Map(const std::string &_name);
+
+      /// \brief Current ring
+      public: SharedRing ring;
+
+      /// \brief Rings which couldn't be mapped, to warn once each
+      public: std::set<std::string> failed;
+    };
+  }
+}
+
+using namespace ignition;
+using namespace gui;
+
+/// \brief Key of the header entry referring to a slot. Its values are the
+/// shared memory name, the frame number and the writer's host name.
+static const char kSharedKey[] = "ign_gui_shm";
+
+/// \brief Value of SharedRingHeader::magic, bumped when the layout changes
+static const std::uint32_t kSharedMagic = 0x49475301u;
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+    "Slots need lock free atomics to be shared between processes");
+
+/////////////////////////////////////////////////
+/// \brief Round a size up to a cache line, so slots don't share lines.
+/// \param[in] _size Size
+/// \return Rounded size
+static std::size_t alignToLine(const std::size_t _size)
+{
+  return (_size + 63u) & ~static_cast<std::size_t>(63u);
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the header of a slot.
+/// \param[in] _ring Mapped ring
+/// \param[in] _frame Frame number
+/// \return Slot header, followed by its data
+static SharedSlotHeader *slotOf(const SharedRing &_ring,
+    const std::uint64_t _frame)
+{
+  auto stride = alignToLine(sizeof(SharedSlotHeader)) +
+      alignToLine(_ring.header->slotSize);
+  auto index = _frame % _ring.header->slots;
+  return reinterpret_cast<SharedSlotHeader *>(
+      static_cast<char *>(_ring.memory) +
+      alignToLine(sizeof(SharedRingHeader)) + index * stride);
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the data of a slot.
+/// \param[in] _slot Slot header
+/// \return Pixel data
+static char *dataOf(SharedSlotHeader *_slot)
+{
+  return reinterpret_cast<char *>(_slot) +
+      alignToLine(sizeof(SharedSlotHeader));
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the name of this host, to tell whether a writer is local.
+/// \return Host name
+static std::string hostName()
+{
+#ifndef _WIN32
+  char name[256] = {0};
+  if (gethostname(name, sizeof(name) - 1) == 0)
+    return name;
+#endif
+  return std::string();
+}
+
+/////////////////////////////////////////////////
+/// \brief Unmap a ring.
+/// \param[in,out] _ring Ring, cleared
+static void unmap(SharedRing &_ring)
+{
+#ifndef _WIN32
+  if (_ring.memory)
+    munmap(_ring.memory, _ring.length);
+#endif
+  _ring = SharedRing();
+}
+
+/////////////////////////////////////////////////
+bool SharedImageWriterPrivate::Create(std::size_t _size)
+{
+#ifdef _WIN32
+  (void)_size;
+  return false;
+#else
+  if (!this->ring.name.empty())
+  {
+    shm_unlink(this->ring.name.c_str());
+    unmap(this->ring);
+  }
+
+  // Short enough for macOS, and new for each ring
+  static std::atomic<unsigned int> counter{0u};
+  auto name = "/igngui_" + std::to_string(getpid()) + "_" +
+      std::to_string(++counter);
+
+  // Room to grow a little, so sizes jittering around don't each make a
+  // new ring
+  _size = alignToLine(_size + _size / 8u);
+  auto length = alignToLine(sizeof(SharedRingHeader)) + this->slots *
+      (alignToLine(sizeof(SharedSlotHeader)) + _size);
+
+  int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0)
+  {
+    ignwarn << "Failed to create shared memory [" << name << "]: "
+            << std::strerror(errno) << std::endl;
+    return false;
+  }
+
+  void *memory{MAP_FAILED};
+  if (ftruncate(fd, static_cast<off_t>(length)) == 0)
+    memory = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+
+  if (memory == MAP_FAILED)
+  {
+    ignwarn << "Failed to map shared memory [" << name << "]: "
+            << std::strerror(errno) << std::endl;
+    shm_unlink(name.c_str());
+    return false;
+  }
+
+  // Fresh shared memory is zeroed, so slots start out empty
+  this->ring.name = name;
+  this->ring.memory = memory;
+  this->ring.length = length;
+  this->ring.header = static_cast<SharedRingHeader *>(memory);
+  this->ring.header->slots = this->slots;
+  this->ring.header->slotSize = _size;
+  std::atomic_thread_fence(std::memory_order_release);
+  this->ring.header->magic = kSharedMagic;
+  this->frames = 0u;
+  return true;
+#endif
+}
+
+/////////////////////////////////////////////////
+SharedImageWriter::SharedImageWriter(unsigned int _slots)
+  : dataPtr(new SharedImageWriterPrivate)
+{
+  this->dataPtr->slots = std::max(2u, _slots);
+}
+
+/////////////////////////////////////////////////
+SharedImageWriter::~SharedImageWriter()
+{
+#ifndef _WIN32
+  if (!this->dataPtr->ring.name.empty())
+    shm_unlink(this->dataPtr->ring.name.c_str());
+#endif
+  unmap(this->dataPtr->ring);
+}
+
+/////////////////////////////////////////////////
+bool SharedImageWriter::Write(msgs::Image &_msg)
+{
+  const auto &data = _msg.data();
+  if (data.empty() || this->dataPtr->failed)
+    return false;
+
+  auto &ring = this->dataPtr->ring;
+  if (ring.name.empty() || data.size() > ring.header->slotSize)
+  {
+    if (!this->dataPtr->Create(data.size()))
+    {
+      this->dataPtr->failed = true;
+      return false;
+    }
+  }
+
+  // Readers check the sequence is the same and even before and after
+  // copying, so they never use a slot which was being written meanwhile
+  auto frame = ++this->dataPtr->frames;
+  auto slot = slotOf(ring, frame);
+  auto seq = slot->seq.load(std::memory_order_relaxed);
+  slot->seq.store(seq + 1u, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot->frame = frame;
+  slot->size = data.size();
+  std::memcpy(dataOf(slot), data.data(), data.size());
+  slot->seq.store(seq + 2u, std::memory_order_release);
+
+  // Leave a reference to the slot instead of the pixels
+  _msg.clear_data();
+  auto header = _msg.mutable_header();
+  msgs::Header::Map *entry{nullptr};
+  for (int i = 0; i < header->data_size(); ++i)
+  {
+    if (header->data(i).key() == kSharedKey)
+      entry = header->mutable_data(i);
+  }
+  if (!entry)
+  {
+    entry = header->add_data();
+    entry->set_key(kSharedKey);
+  }
+  entry->clear_value();
+  entry->add_value(ring.name);
+  entry->add_value(std::to_string(frame));
+  entry->add_value(hostName());
+  return true;
+}
+
+/////////////////////////////////////////////////
+std::string SharedImageWriter::Name() const
+{
+  return this->dataPtr->ring.name;
+}
+
+/////////////////////////////////////////////////
+bool SharedImageReaderPrivate::Map(const std::string &_name)
+{
+  if (this->ring.name == _name)
+    return true;
+
+  unmap(this->ring);
+  if (this->failed.count(_name))
+    return false;
+
+#ifdef _WIN32
+  return false;
+#else
+  auto fail = [&](const std::string &_why)
+  {
+    ignwarn << "Failed to map shared images [" << _name << "]: " << _why
+            << std::endl;
+    this->failed.insert(_name);
+    return false;
+  };
+
+  int fd = shm_open(_name.c_str(), O_RDONLY, 0);
+  if (fd < 0)
+    return fail(std::strerror(errno));
+
+  struct stat info;
+  void *memory{MAP_FAILED};
+  std::size_t length{0u};
+  if (fstat(fd, &info) == 0 &&
+      static_cast<std::size_t>(info.st_size) >= sizeof(SharedRingHeader))
+  {
+    length = static_cast<std::size_t>(info.st_size);
+    memory = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+  }
+  close(fd);
+  if (memory == MAP_FAILED)
+    return fail("can't map it");
+
+  auto header = static_cast<SharedRingHeader *>(memory);
+  auto magic = header->magic;
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (magic != kSharedMagic || header->slots == 0u ||
+      alignToLine(sizeof(SharedRingHeader)) + header->slots *
+      (alignToLine(sizeof(SharedSlotHeader)) +
+      alignToLine(header->slotSize)) > length)
+  {
+    munmap(memory, length);
+    return fail("unknown layout");
+  }
+
+  this->ring.name = _name;
+  this->ring.memory = memory;
+  this->ring.length = length;
+  this->ring.header = header;
+  return true;
+#endif
+}
+
+/////////////////////////////////////////////////
+SharedImageReader::SharedImageReader()
+  : dataPtr(new SharedImageReaderPrivate)
+{
+}
+
+/////////////////////////////////////////////////
+SharedImageReader::~SharedImageReader()
+{
+  unmap(this->dataPtr->ring);
+}
+
+/////////////////////////////////////////////////
+/// \brief Find the header entry referring to a slot.
+/// \param[in] _msg Image msg
+/// \return The entry, null if there's none
+static const msgs::Header::Map *sharedEntry(const msgs::Image &_msg)
+{
+  if (!_msg.has_header())
+    return nullptr;
+
+  for (const auto &entry : _msg.header().data())
+  {
+    if (entry.key() == kSharedKey && entry.value_size() >= 2)
+      return &entry;
+  }
+  return nullptr;
+}
+
+/////////////////////////////////////////////////
+bool SharedImageReader::IsShared(const msgs::Image &_msg)
+{
+  return _msg.data().empty() && sharedEntry(_msg) != nullptr;
+}
+
+/////////////////////////////////////////////////
+bool SharedImageReader::Read(msgs::Image &_msg)
+{
+  auto entry = sharedEntry(_msg);
+  if (!entry)
+    return false;
+
+  // The name of another host's memory may exist here too
+  if (entry->value_size() >= 3 && entry->value(2) != hostName())
+  {
+    if (this->dataPtr->failed.insert(entry->value(0)).second)
+    {
+      ignwarn << "Shared images [" << entry->value(0) << "] come from "
+              << "another host [" << entry->value(2) << "]" << std::endl;
+    }
+    return false;
+  }
+
+  if (!this->dataPtr->Map(entry->value(0)))
+    return false;
+
+  std::uint64_t frame;
+  try
+  {
+    frame = std::stoull(entry->value(1));
+  }
+  catch (const std::exception &)
+  {
+    return false;
+  }
+
+  const auto &ring = this->dataPtr->ring;
+  auto slot = slotOf(ring, frame);
+  auto seq = slot->seq.load(std::memory_order_acquire);
+  auto size = slot->size;
+  if (seq % 2u != 0u || slot->frame != frame || size > ring.header->slotSize)
+    return false;
+
+  _msg.mutable_data()->assign(dataOf(slot), size);
+
+  // The writer may have moved on to this slot while it was copied
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return slot->seq.load(std::memory_order_relaxed) == seq;
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/utilities/ExtraTestMacros.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+#include "ignition/gui/SharedImage.hh"
+
+using namespace ignition;
+using namespace gui;
+
+/////////////////////////////////////////////////
+/// \brief Make an image msg.
+/// \param[in] _width Width
+/// \param[in] _fill Byte all pixels are filled with
+/// \return Msg with 3 bytes per pixel and 2 rows
+msgs::Image MakeImage(unsigned int _width, char _fill)
+{
+  msgs::Image msg;
+  msg.set_width(_width);
+  msg.set_height(2);
+  msg.set_step(_width * 3);
+  msg.set_data(std::string(_width * 3 * 2, _fill));
+  return msg;
+}
+
+/////////////////////////////////////////////////
+TEST(SharedImageTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(WriteRead))
+{
+  common::Console::SetVerbosity(4);
+
+  SharedImageWriter writer;
+  EXPECT_TRUE(writer.Name().empty());
+
+  // Empty msgs stay as they are
+  msgs::Image empty;
+  EXPECT_FALSE(writer.Write(empty));
+  EXPECT_FALSE(SharedImageReader::IsShared(empty));
+
+  // Pixels move to shared memory
+  auto msg = MakeImage(100, 'a');
+  ASSERT_TRUE(writer.Write(msg));
+  EXPECT_FALSE(writer.Name().empty());
+  EXPECT_TRUE(msg.data().empty());
+  EXPECT_EQ(100u, msg.width());
+  EXPECT_TRUE(SharedImageReader::IsShared(msg));
+
+  // And are read back from it, however many times
+  SharedImageReader reader;
+  auto copy = msg;
+  ASSERT_TRUE(reader.Read(msg));
+  EXPECT_EQ(std::string(600, 'a'), msg.data());
+  ASSERT_TRUE(reader.Read(copy));
+  EXPECT_EQ(msg.data(), copy.data());
+
+  // Msgs which don't refer to shared memory can't be read
+  auto plain = MakeImage(10, 'b');
+  EXPECT_FALSE(SharedImageReader::IsShared(plain));
+  EXPECT_FALSE(reader.Read(plain));
+}
+
+/////////////////////////////////////////////////
+TEST(SharedImageTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(Ring))
+{
+  SharedImageWriter writer(3);
+  SharedImageReader reader;
+
+  std::vector<msgs::Image> msgs;
+  for (char c = 'a'; c < 'e'; ++c)
+  {
+    msgs.push_back(MakeImage(100, c));
+    ASSERT_TRUE(writer.Write(msgs.back()));
+  }
+  auto name = writer.Name();
+
+  // The oldest frame was replaced by the newest one
+  EXPECT_FALSE(reader.Read(msgs[0]));
+  for (std::size_t i = 1; i < msgs.size(); ++i)
+  {
+    ASSERT_TRUE(reader.Read(msgs[i]));
+    EXPECT_EQ(std::string(600, static_cast<char>('a' + i)), msgs[i].data());
+  }
+
+  // Smaller frames fit in the same ring, larger ones make a new one
+  auto smaller = MakeImage(50, 's');
+  ASSERT_TRUE(writer.Write(smaller));
+  EXPECT_EQ(name, writer.Name());
+  ASSERT_TRUE(reader.Read(smaller));
+  EXPECT_EQ(std::string(300, 's'), smaller.data());
+
+  auto larger = MakeImage(1000, 'l');
+  ASSERT_TRUE(writer.Write(larger));
+  EXPECT_NE(name, writer.Name());
+  ASSERT_TRUE(reader.Read(larger));
+  EXPECT_EQ(std::string(6000, 'l'), larger.data());
+
+  // A msg reused for another frame refers to that frame only
+  msgs[1].set_data(std::string(600, 'z'));
+  ASSERT_TRUE(writer.Write(msgs[1]));
+  EXPECT_EQ(1, msgs[1].header().data_size());
+  ASSERT_TRUE(reader.Read(msgs[1]));
+  EXPECT_EQ(std::string(600, 'z'), msgs[1].data());
+}
+
+/////////////////////////////////////////////////
+TEST(SharedImageTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(Gone))
+{
+  common::Console::SetVerbosity(4);
+
+  msgs::Image msg;
+  {
+    SharedImageWriter writer;
+    msg = MakeImage(10, 'a');
+    ASSERT_TRUE(writer.Write(msg));
+  }
+
+  // The memory is removed with the writer
+  SharedImageReader reader;
+  EXPECT_TRUE(SharedImageReader::IsShared(msg));
+  EXPECT_FALSE(reader.Read(msg));
+
+  // And shared memory of other hosts isn't looked at
+  SharedImageWriter writer;
+  msg = MakeImage(10, 'a');
+  ASSERT_TRUE(writer.Write(msg));
+  msg.mutable_header()->mutable_data(0)->set_value(2, "not_this_host");
+  EXPECT_FALSE(reader.Read(msg));
+}
@@ -0,0 +1,577 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/gui/SplitLayout.hh"
+
+namespace ignition
+{
+  namespace gui
+  {
+    /// \brief A split item and how it was resized
+    struct SplitEntry
+    {
+      /// \brief Item
+      QPointer<QQuickItem> item;
+
+      /// \brief Height dragged by the user, negative to keep the minimum
+      qreal height{-1};
+    };
+
+    /// \brief What's being dragged
+    enum class SplitDrag
+    {
+      /// \brief Nothing
+      kNone,
+
+      /// \brief The gap between the left item and the column
+      kSide,
+
+      /// \brief The gap below an item of the column
+      kItem
+    };
+
+    class SplitLayoutPrivate
+    {
+      /// \brief Get the minimum size of an item.
+      /// \param[in] _item Item
+      /// \return Minimum width and height
+      public: QSizeF MinimumSize(const QQuickItem *_item) const;
+
+      /// \brief Find the handle at a position.
+      /// \param[in] _pos Position in the layout
+      /// \param[out] _index Index of the item above the handle, for
+      /// kItem
+      /// \return What would be dragged from there
+      public: SplitDrag HandleAt(const QPointF &_pos,
+                                 std::size_t &_index) const;
+
+      /// \brief Release an item which was removed, destroying it once the
+      /// cards it holds are gone.
+      /// \param[in] _item Item
+      public: void Discard(QQuickItem *_item);
+
+      /// \brief Creates the split items
+      public: QPointer<QQmlComponent> delegate;
+
+      /// \brief Split items, the first one on the left
+      public: std::vector<SplitEntry> entries;
+
+      /// \brief Holds the column's items, and clips them while scrolling
+      public: QQuickItem *side{nullptr};
+
+      /// \brief Number of items added so far, for their names
+      public: unsigned int added{0u};
+
+      /// \brief Width of the column dragged by the user, negative to keep
+      /// the minimum
+      public: qreal sideWidth{-1};
+
+      /// \brief Column rectangle as of the last pass
+      public: QRectF sideRect;
+
+      /// \brief Height of the column's items as of the last pass
+      public: qreal sideContentHeight{0};
+
+      /// \brief How far the column is scrolled down
+      public: qreal scroll{0};
+
+      /// \brief What's being dragged
+      public: SplitDrag drag{SplitDrag::kNone};
+
+      /// \brief Item above the handle being dragged
+      public: std::size_t dragIndex{0u};
+
+      /// \brief Where the drag started, in the layout
+      public: QPointF dragStart;
+
+      /// \brief Size being dragged when it started
+      public: qreal dragSize{0};
+    };
+  }
+}
+
+using namespace ignition;
+using namespace gui;
+
+/// \brief Gap between items, which can be dragged
+static const qreal kHandle = 5;
+
+/// \brief Room kept on the right of the column for its scroll bar
+static const qreal kScrollBarWidth = 17;
+
+/// \brief Minimum width and height of items which don't tell theirs
+static const qreal kDefaultMinimum = 100;
+
+/// \brief Pixels scrolled by a wheel step
+static const qreal kScrollStep = 40;
+
+/////////////////////////////////////////////////
+QSizeF SplitLayoutPrivate::MinimumSize(const QQuickItem *_item) const
+{
+  auto width = _item->property("minimumWidth");
+  auto height = _item->property("minimumHeight");
+  return QSizeF(width.isValid() ? width.toReal() : kDefaultMinimum,
+                height.isValid() ? height.toReal() : kDefaultMinimum);
+}
+
+/////////////////////////////////////////////////
+SplitDrag SplitLayoutPrivate::HandleAt(const QPointF &_pos,
+    std::size_t &_index) const
+{
+  if (this->sideRect.isEmpty())
+    return SplitDrag::kNone;
+
+  if (_pos.x() >= this->sideRect.left() - kHandle &&
+      _pos.x() < this->sideRect.left())
+  {
+    return SplitDrag::kSide;
+  }
+
+  if (!this->sideRect.contains(_pos))
+    return SplitDrag::kNone;
+
+  // Handles are below each item of the column
+  auto y = _pos.y() - this->sideRect.top() + this->scroll;
+  for (std::size_t i = 1u; i < this->entries.size(); ++i)
+  {
+    auto item = this->entries[i].item;
+    if (!item)
+      continue;
+
+    auto bottom = item->y() + this->scroll + item->height();
+    if (y >= bottom && y < bottom + kHandle)
+    {
+      _index = i;
+      return SplitDrag::kItem;
+    }
+  }
+  return SplitDrag::kNone;
+}
+
+/////////////////////////////////////////////////
+void SplitLayoutPrivate::Discard(QQuickItem *_item)
+{
+  _item->setVisible(false);
+  if (_item->childItems().isEmpty())
+  {
+    _item->deleteLater();
+    return;
+  }
+
+  // A card leaving the dock is moved elsewhere after its item is removed,
+  // and a closed card is deleted later
+  QPointer<QQuickItem> item(_item);
+  QObject::connect(_item, &QQuickItem::childrenChanged, _item, [item]()
+  {
+    if (item && item->childItems().isEmpty())
+      item->deleteLater();
+  });
+}
+
+/////////////////////////////////////////////////
+SplitLayout::SplitLayout(QQuickItem *_parent)
+  : QQuickItem(_parent), dataPtr(new SplitLayoutPrivate)
+{
+  this->dataPtr->side = new QQuickItem(this);
+  this->dataPtr->side->setClip(true);
+
+  this->setAcceptedMouseButtons(Qt::LeftButton);
+  this->setAcceptHoverEvents(true);
+}
+
+/////////////////////////////////////////////////
+SplitLayout::~SplitLayout()
+{
+}
+
+/////////////////////////////////////////////////
+QQmlComponent *SplitLayout::Delegate() const
+{
+  return this->dataPtr->delegate;
+}
+
+/////////////////////////////////////////////////
+void SplitLayout::SetDelegate(QQmlComponent *_delegate)
+{
+  if (this->dataPtr->delegate == _delegate)
+    return;
+
+  this->dataPtr->delegate = _delegate;
+  this->DelegateChanged();
+}
+
+/////////////////////////////////////////////////
+QQuickItem *SplitLayout::AddItem()
+{
+  QQuickItem *item{nullptr};
+  if (this->dataPtr->delegate)
+  {
+    auto context = qmlContext(this);
+    if (!context)
+      context = this->dataPtr->delegate->creationContext();
+    auto object = this->dataPtr->delegate->beginCreate(context);
+    item = qobject_cast<QQuickItem *>(object);
+    if (!item)
+    {
+      ignerr << "Split item delegate doesn't create an item" << std::endl;
+      delete object;
+      return nullptr;
+    }
+    item->setParentItem(this->dataPtr->side);
+    this->dataPtr->delegate->completeCreate();
+  }
+  else
+  {
+    item = new QQuickItem(this->dataPtr->side);
+  }
+  item->setParent(this);
+  QQmlEngine::setObjectOwnership(item, QQmlEngine::CppOwnership);
+  item->setObjectName("split_item_" +
+      QString::number(this->dataPtr->added++));
+
+  // Minimum sizes are read by each pass, which their changes schedule
+  auto meta = item->metaObject();
+  if (meta->indexOfSignal("minimumWidthChanged()") >= 0)
+  {
+    this->connect(item, SIGNAL(minimumWidthChanged()), this,
+        SLOT(OnMinimumSizeChanged()));
+  }
+  if (meta->indexOfSignal("minimumHeightChanged()") >= 0)
+  {
+    this->connect(item, SIGNAL(minimumHeightChanged()), this,
+        SLOT(OnMinimumSizeChanged()));
+  }
+
+  SplitEntry entry;
+  entry.item = item;
+  this->dataPtr->entries.push_back(entry);
+
+  this->polish();
+  this->ItemsChanged();
+  return item;
+}
+
+/////////////////////////////////////////////////
+bool SplitLayout::RemoveItem(QQuickItem *_item)
+{
+  return this->RemoveItems({_item});
+}
+
+/////////////////////////////////////////////////
+bool SplitLayout::RemoveItems(const std::vector<QQuickItem *> &_items)
+{
+  auto &entries = this->dataPtr->entries;
+  bool found{true};
+  bool removed{false};
+  for (auto item : _items)
+  {
+    auto entryIt = std::find_if(entries.begin(), entries.end(),
+        [item](const SplitEntry &_entry)
+        {
+          return _entry.item == item;
+        });
+    if (!item || entryIt == entries.end())
+    {
+      found = false;
+      continue;
+    }
+
+    entries.erase(entryIt);
+    item->disconnect(this);
+    this->dataPtr->Discard(item);
+    removed = true;
+  }
+
+  if (removed)
+  {
+    this->polish();
+    this->ItemsChanged();
+  }
+  return found;
+}
+
+/////////////////////////////////////////////////
+std::vector<QQuickItem *> SplitLayout::Items() const
+{
+  std::vector<QQuickItem *> items;
+  for (const auto &entry : this->dataPtr->entries)
+  {
+    if (entry.item)
+      items.push_back(entry.item);
+  }
+  return items;
+}
+
+/////////////////////////////////////////////////
+QVariantMap SplitLayout::ChildItems() const
+{
+  QVariantMap items;
+  for (const auto &entry : this->dataPtr->entries)
+  {
+    if (entry.item)
+      items[entry.item->objectName()] = QVariant::fromValue(entry.item.data());
+  }
+  return items;
+}
+
+/////////////////////////////////////////////////
+QString SplitLayout::addSplitItem()
+{
+  auto item = this->AddItem();
+  return item ? item->objectName() : QString();
+}
+
+/////////////////////////////////////////////////
+void SplitLayout::removeSplitItem(const QString &_name)
+{
+  this->removeSplitItems(QStringList{_name});
+}
+
+/////////////////////////////////////////////////
+void SplitLayout::removeSplitItems(const QVariant &_names)
+{
+  std::vector<QQuickItem *> items;
+  for (const auto &name : _names.toStringList())
+  {
+    for (const auto &entry : this->dataPtr->entries)
+    {
+      if (entry.item && entry.item->objectName() == name)
+        items.push_back(entry.item);
+    }
+  }
+  this->RemoveItems(items);
+}
+
+/////////////////////////////////////////////////
+QRectF SplitLayout::SideRect() const
+{
+  return this->dataPtr->sideRect;
+}
+
+/////////////////////////////////////////////////
+qreal SplitLayout::SideContentHeight() const
+{
+  return this->dataPtr->sideContentHeight;
+}
+
+/////////////////////////////////////////////////
+qreal SplitLayout::SideScroll() const
+{
+  return this->dataPtr->scroll;
+}
+
+/////////////////////////////////////////////////
+void SplitLayout::SetSideScroll(qreal _scroll)
+{
+  auto most = std::max<qreal>(0,
+      this->dataPtr->sideContentHeight - this->dataPtr->sideRect.height());
+  _scroll = std::min(std::max<qreal>(0, _scroll), most);
+  if (qFuzzyCompare(_scroll + 1, this->dataPtr->scroll + 1))
+    return;
+
+  this->dataPtr->scroll = _scroll;
+  this->polish();
+}
+
+/////////////////////////////////////////////////
+void SplitLayout::UpdateLayout()
+{
+  auto &d = *this->dataPtr;
+
+  // Items which were destroyed elsewhere are forgotten
+  d.entries.erase(std::remove_if(d.entries.begin(), d.entries.end(),
+      [](const SplitEntry &_entry)
+      {
+        return _entry.item.isNull();
+      }), d.entries.end());
+
+  auto width = this->width();
+  auto height = this->height();
+  auto mainWidth = width;
+  QRectF sideRect;
+  qreal contentHeight{0};
+
+  if (d.entries.size() > 1u)
+  {
+    // The column is as wide as its widest item needs, or as dragged
+    qreal sideMinimum{0};
+    for (std::size_t i = 1u; i < d.entries.size(); ++i)
+    {
+      sideMinimum = std::max(sideMinimum,
+          d.MinimumSize(d.entries[i].item).width());
+    }
+    sideMinimum += kScrollBarWidth;
+
+    auto mainMinimum = d.MinimumSize(d.entries[0].item).width();
+    auto sideWidth = std::max(d.sideWidth, sideMinimum);
+    sideWidth = std::max(sideMinimum,
+        std::min(sideWidth, width - kHandle - mainMinimum));
+    mainWidth = std::max<qreal>(0, width - kHandle - sideWidth);
+
+    sideRect = QRectF(mainWidth + kHandle, 0, sideWidth, height);
+
+    for (std::size_t i = 1u; i < d.entries.size(); ++i)
+    {
+      auto &entry = d.entries[i];
+      auto itemHeight = std::max(d.MinimumSize(entry.item).height(),
+          entry.height);
+      contentHeight += itemHeight + (i > 1u ? kHandle : 0);
+    }
+
+    // Scrolled no further than the content
+    d.scroll = std::min(d.scroll,
+        std::max<qreal>(0, contentHeight - height));
+
+    auto y = -d.scroll;
+    for (std::size_t i = 1u; i < d.entries.size(); ++i)
+    {
+      auto &entry = d.entries[i];
+      auto itemHeight = std::max(d.MinimumSize(entry.item).height(),
+          entry.height);
+      entry.item->setParentItem(d.side);
+      entry.item->setPosition(QPointF(0, y));
+      entry.item->setSize(QSizeF(sideWidth - kScrollBarWidth, itemHeight));
+      y += itemHeight + kHandle;
+    }
+  }
+
+  if (d.entries.size() <= 1u)
+    d.scroll = 0;
+
+  // The item on the left isn't clipped with the column, and stays below
+  // floating cards, which are also children of the layout
+  if (!d.entries.empty())
+  {
+    auto main = d.entries[0].item;
+    main->setParentItem(this);
+    main->stackBefore(d.side);
+    main->setPosition(QPointF(0, 0));
+    main->setSize(QSizeF(mainWidth, height));
+  }
+
+  d.side->setPosition(sideRect.topLeft());
+  d.side->setSize(sideRect.size());
+  d.sideRect = sideRect;
+  d.sideContentHeight = contentHeight;
+  this->LayoutChanged();
+}
+
+/////////////////////////////////////////////////
+void SplitLayout::updatePolish()
+{
+  this->UpdateLayout();
+}
+
+/////////////////////////////////////////////////
+void SplitLayout::geometryChanged(const QRectF &_newGeometry,
+    const QRectF &_oldGeometry)
+{
+  QQuickItem::geometryChanged(_newGeometry, _oldGeometry);
+  if (_newGeometry.size() != _oldGeometry.size())
+    this->polish();
+}
+
+/////////////////////////////////////////////////
+void SplitLayout::mousePressEvent(QMouseEvent *_event)
+{
+  auto &d = *this->dataPtr;
+  d.drag = d.HandleAt(_event->localPos(), d.dragIndex);
+  if (d.drag == SplitDrag::kNone)
+  {
+    _event->ignore();
+    return;
+  }
+
+  d.dragStart = _event->localPos();
+  if (d.drag == SplitDrag::kSide)
+    d.dragSize = d.sideRect.width();
+  else
+    d.dragSize = d.entries[d.dragIndex].item->height();
+  _event->accept();
+}
+
+/////////////////////////////////////////////////
+void SplitLayout::mouseMoveEvent(QMouseEvent *_event)
+{
+  auto &d = *this->dataPtr;
+  auto delta = _event->localPos() - d.dragStart;
+  if (d.drag == SplitDrag::kSide)
+  {
+    // Dragging left widens the column
+    d.sideWidth = std::max<qreal>(0, d.dragSize - delta.x());
+    this->polish();
+  }
+  else if (d.drag == SplitDrag::kItem && d.dragIndex < d.entries.size())
+  {
+    d.entries[d.dragIndex].height = std::max<qreal>(0, d.dragSize + delta.y());
+    this->polish();
+  }
+}
+
+/////////////////////////////////////////////////
+void SplitLayout::mouseReleaseEvent(QMouseEvent *)
+{
+  this->dataPtr->drag = SplitDrag::kNone;
+}
+
+/////////////////////////////////////////////////
+void SplitLayout::hoverMoveEvent(QHoverEvent *_event)
+{
+  std::size_t index;
+  switch (this->dataPtr->HandleAt(_event->posF(), index))
+  {
+    case SplitDrag::kSide:
+      this->setCursor(Qt::SplitHCursor);
+      break;
+    case SplitDrag::kItem:
+      this->setCursor(Qt::SplitVCursor);
+      break;
+    default:
+      this->unsetCursor();
+  }
+}
+
+/////////////////////////////////////////////////
+void SplitLayout::wheelEvent(QWheelEvent *_event)
+{
+  if (!this->dataPtr->sideRect.contains(_event->posF()))
+  {
+    _event->ignore();
+    return;
+  }
+
+  this->SetSideScroll(this->dataPtr->scroll -
+      _event->angleDelta().y() / 120.0 * kScrollStep);
+}
+
+/////////////////////////////////////////////////
+void SplitLayout::OnMinimumSizeChanged()
+{
+  // Cards collapse and expand by changing their item's minimum height,
+  // which the height dragged by the user would otherwise override
+  for (auto &entry : this->dataPtr->entries)
+  {
+    if (entry.item == this->sender())
+      entry.height = -1;
+  }
+  this->polish();
+}
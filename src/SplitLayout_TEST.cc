@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <ignition/common/Console.hh>
+#include <ignition/utilities/ExtraTestMacros.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+#include "ignition/gui/Application.hh"
+#include "ignition/gui/SplitLayout.hh"
+
+int g_argc = 1;
+char **g_argv = new char *[g_argc];
+
+using namespace ignition;
+using namespace gui;
+
+/////////////////////////////////////////////////
+TEST(SplitLayoutTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(Items))
+{
+  common::Console::SetVerbosity(4);
+
+  Application app(g_argc, g_argv);
+
+  SplitLayout layout;
+  layout.setSize(QSizeF(800, 600));
+  EXPECT_TRUE(layout.Items().empty());
+  EXPECT_TRUE(layout.ChildItems().isEmpty());
+
+  // A single item takes the whole layout
+  auto first = layout.AddItem();
+  ASSERT_NE(nullptr, first);
+  EXPECT_TRUE(first->objectName().startsWith("split_item_"));
+  layout.UpdateLayout();
+  EXPECT_EQ(QRectF(0, 0, 800, 600),
+      QRectF(first->position(), first->size()));
+  EXPECT_TRUE(layout.SideRect().isEmpty());
+
+  // Others are stacked on the right, at their minimum sizes
+  auto second = layout.AddItem();
+  auto third = layout.AddItem();
+  ASSERT_NE(nullptr, second);
+  ASSERT_NE(nullptr, third);
+  third->setProperty("minimumWidth", 200);
+  third->setProperty("minimumHeight", 150);
+  layout.UpdateLayout();
+
+  auto side = layout.SideRect();
+  EXPECT_DOUBLE_EQ(600, side.height());
+  EXPECT_GT(side.width(), 200);
+  EXPECT_DOUBLE_EQ(800, side.right());
+  EXPECT_LT(first->width(), side.left());
+  EXPECT_DOUBLE_EQ(600, first->height());
+
+  EXPECT_DOUBLE_EQ(0, second->y());
+  EXPECT_DOUBLE_EQ(100, second->height());
+  EXPECT_GT(third->y(), second->y() + second->height());
+  EXPECT_DOUBLE_EQ(150, third->height());
+  EXPECT_DOUBLE_EQ(second->width(), third->width());
+  EXPECT_GE(third->width(), 200);
+  EXPECT_DOUBLE_EQ(third->y() + third->height(), layout.SideContentHeight());
+
+  auto items = layout.ChildItems();
+  EXPECT_EQ(3, items.size());
+  EXPECT_EQ(second,
+      qvariant_cast<QQuickItem *>(items.value(second->objectName())));
+
+  // Removing the item on the left moves the next one there
+  EXPECT_TRUE(layout.RemoveItem(first));
+  EXPECT_FALSE(layout.RemoveItem(first));
+  EXPECT_FALSE(first->isVisible());
+  layout.UpdateLayout();
+  ASSERT_EQ(2u, layout.Items().size());
+  EXPECT_EQ(second, layout.Items()[0]);
+  EXPECT_DOUBLE_EQ(0, second->x());
+  EXPECT_DOUBLE_EQ(600, second->height());
+
+  // Removed by name from QML
+  layout.removeSplitItems(QStringList{second->objectName(), "unknown"});
+  layout.UpdateLayout();
+  ASSERT_EQ(1u, layout.Items().size());
+  EXPECT_EQ(QRectF(0, 0, 800, 600),
+      QRectF(third->position(), third->size()));
+}
+
+/////////////////////////////////////////////////
+TEST(SplitLayoutTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(Scroll))
+{
+  common::Console::SetVerbosity(4);
+
+  Application app(g_argc, g_argv);
+
+  SplitLayout layout;
+  layout.setSize(QSizeF(800, 300));
+
+  // Nothing to scroll while the column fits
+  layout.AddItem();
+  auto top = layout.AddItem();
+  layout.UpdateLayout();
+  layout.SetSideScroll(50);
+  EXPECT_DOUBLE_EQ(0, layout.SideScroll());
+
+  for (int i = 0; i < 5; ++i)
+    layout.AddItem();
+  layout.UpdateLayout();
+  auto content = layout.SideContentHeight();
+  EXPECT_GT(content, 300);
+
+  // Clamped to the content
+  layout.SetSideScroll(50);
+  layout.UpdateLayout();
+  EXPECT_DOUBLE_EQ(50, layout.SideScroll());
+  EXPECT_DOUBLE_EQ(-50, top->y());
+
+  layout.SetSideScroll(1e6);
+  EXPECT_DOUBLE_EQ(content - 300, layout.SideScroll());
+  layout.SetSideScroll(-10);
+  EXPECT_DOUBLE_EQ(0, layout.SideScroll());
+
+  // Reduced when the content shrinks
+  layout.SetSideScroll(1e6);
+  layout.setHeight(content - 10);
+  layout.UpdateLayout();
+  EXPECT_DOUBLE_EQ(10, layout.SideScroll());
+}
@@ -0,0 +1,500 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifdef __linux__
+#include <cxxabi.h>
+#include <execinfo.h>
+#include <pthread.h>
+#include <signal.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/msgs/stringmsg.pb.h>
+#include <ignition/transport/Node.hh>
+
+#include "ignition/gui/Metrics.hh"
+#include "ignition/gui/Plugin.hh"
+#include "ignition/gui/StallWatchdog.hh"
+#include "ignition/gui/Trace.hh"
+#include "ignition/gui/qt.h"
+
+namespace ignition
+{
+  namespace gui
+  {
+    /// \brief An event the GUI thread is handling
+    struct StallHandler
+    {
+      /// \brief Object receiving the event, only dereferenced on the GUI
+      /// thread
+      const QObject *receiver;
+
+      /// \brief Class of the receiver
+      const char *className;
+
+      /// \brief Event type
+      int type;
+
+      /// \brief Time handling started
+      Trace::Clock::time_point start;
+    };
+
+    /// \brief Answers pings from the watchdog thread on the GUI thread
+    class StallPinger : public QObject
+    {
+      /// \brief Constructor
+      /// \param[in] _data Watchdog data
+      public: explicit StallPinger(StallWatchdogPrivate *_data)
+          : data(_data)
+      {
+      }
+
+      // Documentation inherited
+      public: bool event(QEvent *_event) override;
+
+      /// \brief Watchdog data
+      private: StallWatchdogPrivate *data;
+    };
+
+    class StallWatchdogPrivate
+    {
+      /// \brief Ping the GUI thread and check how it responds, on the
+      /// watchdog thread.
+      public: void Run();
+
+      /// \brief Start a report on a stall which was just detected. Called
+      /// on the watchdog thread, with the mutex locked.
+      /// \param[in] _pingSent Time of the ping which wasn't answered
+      public: void Detect(const Trace::Clock::time_point &_pingSent);
+
+      /// \brief Complete the report of a stall which is over and send it.
+      /// Called on the GUI thread.
+      /// \param[in] _lock Lock on the mutex, released before sending
+      public: void Finish(std::unique_lock<std::mutex> &_lock);
+
+      /// \brief Shortest stall reported
+      public: std::chrono::milliseconds threshold;
+
+      /// \brief Node used to publish reports
+      public: transport::Node node;
+
+      /// \brief Publisher of reports, invalid if not publishing
+      public: transport::Node::Publisher pub;
+
+      /// \brief Called with each report
+      public: std::function<void(const StallReport &)> callback;
+
+      /// \brief Answers pings on the GUI thread
+      public: std::unique_ptr<StallPinger> pinger;
+
+      /// \brief Event type of pings
+      public: QEvent::Type pingType;
+
+      /// \brief Events being handled, outermost first
+      public: std::vector<StallHandler> handlers;
+
+      /// \brief Whether a ping was posted and not answered yet
+      public: bool pingPending{false};
+
+      /// \brief Time the latest ping was posted
+      public: Trace::Clock::time_point pingSent;
+
+      /// \brief Whether a stall was detected and isn't over yet
+      public: bool stalled{false};
+
+      /// \brief Number of handlers when the stall was detected, 0 if it
+      /// wasn't in a handler
+      public: std::size_t stalledDepth{0};
+
+      /// \brief Receiver of the stalled handler
+      public: const QObject *stalledReceiver{nullptr};
+
+      /// \brief Time the stall started
+      public: Trace::Clock::time_point stallStart;
+
+      /// \brief Report being filled for the current stall
+      public: StallReport report;
+
+      /// \brief Number of stalls reported
+      public: std::atomic<unsigned int> stallCount{0};
+
+      /// \brief Whether the watchdog thread should keep running
+      public: bool running{true};
+
+      /// \brief Protects the members above, except stallCount
+      public: std::mutex mutex;
+
+      /// \brief Wakes the watchdog thread up to stop it
+      public: std::condition_variable cv;
+
+      /// \brief Watchdog thread
+      public: std::thread thread;
+
+#ifdef __linux__
+      /// \brief GUI thread, to sample its stack
+      public: pthread_t guiThread;
+#endif
+    };
+  }
+}
+
+using namespace ignition;
+using namespace gui;
+
+#ifdef __linux__
+/// \brief Signal sent to the GUI thread to sample its stack
+static const int kSampleSignal = SIGRTMIN + 4;
+
+/// \brief Most stack frames sampled
+static const int kMaxStackFrames{64};
+
+/// \brief Frames of the latest sample
+static void *g_stackFrames[kMaxStackFrames];
+
+/// \brief Number of frames in the latest sample, -1 while sampling
+static std::atomic<int> g_stackFrameCount{-1};
+
+/////////////////////////////////////////////////
+/// \brief Signal handler recording the stack of the thread it runs on.
+static void SampleStackHandler(int)
+{
+  g_stackFrameCount = backtrace(g_stackFrames, kMaxStackFrames);
+}
+
+/////////////////////////////////////////////////
+/// \brief Demangle a frame given by backtrace_symbols, such as
+/// "libfoo.so(_ZN3foo3barEv+0x12) [0x7f...]".
+/// \param[in] _symbol Frame
+/// \return Frame with the function name demangled
+static std::string DemangleFrame(const std::string &_symbol)
+{
+  auto begin = _symbol.find('(');
+  auto end = _symbol.find('+', begin);
+  if (begin == std::string::npos || end == std::string::npos ||
+      end == begin + 1)
+  {
+    return _symbol;
+  }
+
+  auto mangled = _symbol.substr(begin + 1, end - begin - 1);
+  int status{0};
+  auto demangled = abi::__cxa_demangle(mangled.c_str(), nullptr, nullptr,
+      &status);
+  if (status != 0 || !demangled)
+    return _symbol;
+
+  std::string result = demangled;
+  std::free(demangled);
+  return result + " (" + _symbol.substr(0, begin) + ")";
+}
+
+/////////////////////////////////////////////////
+/// \brief Sample the stack of another thread.
+/// \param[in] _thread Thread
+/// \return Frames, innermost first, empty if the thread didn't respond
+static std::vector<std::string> SampleStack(pthread_t _thread)
+{
+  std::vector<std::string> stack;
+
+  g_stackFrameCount = -1;
+  if (pthread_kill(_thread, kSampleSignal) != 0)
+    return stack;
+
+  auto deadline = Trace::Clock::now() + std::chrono::milliseconds(100);
+  while (g_stackFrameCount < 0 && Trace::Clock::now() < deadline)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+  int count = g_stackFrameCount;
+  if (count <= 0)
+    return stack;
+
+  auto symbols = backtrace_symbols(g_stackFrames, count);
+  if (!symbols)
+    return stack;
+
+  // Skip the signal handler and the trampoline calling it
+  for (int i = 2; i < count; ++i)
+    stack.push_back(DemangleFrame(symbols[i]));
+  std::free(symbols);
+  return stack;
+}
+#endif
+
+/////////////////////////////////////////////////
+/// \brief Get the name of an event type.
+/// \param[in] _type Event type
+/// \return Name such as "MetaCall", or the number for custom events
+static std::string EventTypeName(int _type)
+{
+  auto name = QMetaEnum::fromType<QEvent::Type>().valueToKey(_type);
+  return name ? std::string(name) : std::to_string(_type);
+}
+
+/////////////////////////////////////////////////
+/// \brief Find the plugin an object belongs to.
+/// \param[in] _object Object
+/// \return Plugin title, empty if none
+static std::string PluginOf(const QObject *_object)
+{
+  for (auto object = _object; object; object = object->parent())
+  {
+    auto plugin = qobject_cast<const Plugin *>(object);
+    if (plugin)
+    {
+      return plugin->Title().empty() ? plugin->objectName().toStdString() :
+          plugin->Title();
+    }
+  }
+  return std::string();
+}
+
+/////////////////////////////////////////////////
+std::string StallReport::String() const
+{
+  std::ostringstream out;
+  out << "GUI thread stalled for " << static_cast<int>(this->duration)
+      << " ms";
+  if (!this->handler.empty())
+  {
+    out << " in [" << this->handler << "] handling [" << this->event
+        << "]";
+  }
+  else
+  {
+    out << " outside event handlers";
+  }
+  if (!this->plugin.empty())
+    out << " of plugin [" << this->plugin << "]";
+  for (std::size_t i = 0; i < this->stack.size(); ++i)
+    out << "\n  #" << i << " " << this->stack[i];
+  return out.str();
+}
+
+/////////////////////////////////////////////////
+bool StallPinger::event(QEvent *_event)
+{
+  if (_event->type() != this->data->pingType)
+    return QObject::event(_event);
+
+  std::unique_lock<std::mutex> lock(this->data->mutex);
+  this->data->pingPending = false;
+  if (this->data->stalled)
+    this->data->Finish(lock);
+  return true;
+}
+
+/////////////////////////////////////////////////
+void StallWatchdogPrivate::Run()
+{
+  // Ping often enough to notice stalls not much longer than the threshold
+  auto interval = std::max(this->threshold / 4,
+      std::chrono::milliseconds(5));
+
+  std::unique_lock<std::mutex> lock(this->mutex);
+  while (this->running)
+  {
+    this->cv.wait_for(lock, interval, [this] {return !this->running;});
+    if (!this->running)
+      break;
+
+    auto now = Trace::Clock::now();
+    if (!this->pingPending)
+    {
+      this->pingPending = true;
+      this->pingSent = now;
+      QCoreApplication::postEvent(this->pinger.get(),
+          new QEvent(this->pingType), Qt::HighEventPriority);
+    }
+    else if (!this->stalled && now - this->pingSent > this->threshold)
+    {
+      this->Detect(this->pingSent);
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+void StallWatchdogPrivate::Detect(const Trace::Clock::time_point &_pingSent)
+{
+  this->stalled = true;
+  this->report = StallReport();
+  this->stalledDepth = this->handlers.size();
+  this->stalledReceiver = nullptr;
+  this->stallStart = _pingSent;
+
+  // The innermost handler is the one not returning
+  if (!this->handlers.empty())
+  {
+    const auto &handler = this->handlers.back();
+    this->report.handler = handler.className;
+    this->report.event = EventTypeName(handler.type);
+    this->stalledReceiver = handler.receiver;
+    this->stallStart = std::min(this->stallStart, handler.start);
+  }
+
+#ifdef __linux__
+  this->report.stack = SampleStack(this->guiThread);
+#endif
+}
+
+/////////////////////////////////////////////////
+void StallWatchdogPrivate::Finish(std::unique_lock<std::mutex> &_lock)
+{
+  auto end = Trace::Clock::now();
+  this->stalled = false;
+
+  auto report = this->report;
+  report.duration = std::chrono::duration<double, std::milli>(
+      end - this->stallStart).count();
+  if (this->stalledReceiver)
+    report.plugin = PluginOf(this->stalledReceiver);
+  auto start = this->stallStart;
+  auto callback = this->callback;
+  _lock.unlock();
+
+  ++this->stallCount;
+  Metrics::Instance().Add(MetricCounter::kStalls);
+  ignwarn << report.String() << std::endl;
+  Trace::Complete("Stall [" + (report.handler.empty() ?
+      std::string("outside event handlers") : report.handler) + "]",
+      "stall", start, end);
+
+  if (this->pub)
+  {
+    msgs::StringMsg msg;
+    msg.set_data(report.String());
+    this->pub.Publish(msg);
+  }
+
+  if (callback)
+    callback(report);
+}
+
+/////////////////////////////////////////////////
+StallWatchdog::StallWatchdog(const std::chrono::milliseconds &_threshold,
+    const std::string &_topic)
+  : dataPtr(new StallWatchdogPrivate)
+{
+  this->dataPtr->threshold = _threshold;
+  this->dataPtr->pingType = static_cast<QEvent::Type>(
+      QEvent::registerEventType());
+  this->dataPtr->pinger.reset(new StallPinger(this->dataPtr.get()));
+  this->dataPtr->handlers.reserve(32);
+
+  if (!_topic.empty())
+  {
+    this->dataPtr->pub =
+        this->dataPtr->node.Advertise<msgs::StringMsg>(_topic);
+    if (!this->dataPtr->pub)
+    {
+      ignerr << "Failed to advertise stall reports on [" << _topic << "]"
+             << std::endl;
+    }
+  }
+
+#ifdef __linux__
+  this->dataPtr->guiThread = pthread_self();
+
+  struct sigaction action;
+  sigemptyset(&action.sa_mask);
+  action.sa_flags = SA_RESTART;
+  action.sa_handler = SampleStackHandler;
+  sigaction(kSampleSignal, &action, nullptr);
+
+  // The first backtrace loads what it needs, which isn't safe to do in a
+  // signal handler
+  void *frame;
+  backtrace(&frame, 1);
+#endif
+
+  this->dataPtr->thread = std::thread([this]()
+  {
+    this->dataPtr->Run();
+  });
+
+  igndbg << "Watching for GUI thread stalls longer than ["
+         << _threshold.count() << "] ms" << std::endl;
+}
+
+/////////////////////////////////////////////////
+StallWatchdog::~StallWatchdog()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->running = false;
+  }
+  this->dataPtr->cv.notify_all();
+  if (this->dataPtr->thread.joinable())
+    this->dataPtr->thread.join();
+}
+
+/////////////////////////////////////////////////
+std::chrono::milliseconds StallWatchdog::Threshold() const
+{
+  return this->dataPtr->threshold;
+}
+
+/////////////////////////////////////////////////
+void StallWatchdog::SetCallback(
+    std::function<void(const StallReport &)> _callback)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->callback = std::move(_callback);
+}
+
+/////////////////////////////////////////////////
+void StallWatchdog::Enter(const QObject *_receiver, const QEvent *_event)
+{
+  auto className = _receiver->metaObject()->className();
+  auto now = Trace::Clock::now();
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->handlers.push_back({_receiver, className,
+      static_cast<int>(_event->type()), now});
+}
+
+/////////////////////////////////////////////////
+void StallWatchdog::Leave()
+{
+  std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+  if (this->dataPtr->handlers.empty())
+    return;
+
+  this->dataPtr->handlers.pop_back();
+
+  // The stalled handler returned
+  if (this->dataPtr->stalled &&
+      this->dataPtr->handlers.size() < this->dataPtr->stalledDepth)
+  {
+    this->dataPtr->Finish(lock);
+  }
+}
+
+/////////////////////////////////////////////////
+unsigned int StallWatchdog::StallCount() const
+{
+  return this->dataPtr->stallCount;
+}
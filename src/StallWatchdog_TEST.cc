@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/msgs/stringmsg.pb.h>
+#include <ignition/transport/Node.hh>
+#include <ignition/utilities/ExtraTestMacros.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+#include "ignition/gui/Application.hh"
+#include "ignition/gui/Plugin.hh"
+#include "ignition/gui/StallWatchdog.hh"
+
+int g_argc = 1;
+char **g_argv = new char *[g_argc];
+
+using namespace ignition;
+using namespace gui;
+
+/////////////////////////////////////////////////
+/// \brief Run the event loop for a while.
+/// \param[in] _ms Milliseconds
+void RunEventLoop(int _ms)
+{
+  QEventLoop loop;
+  QTimer::singleShot(_ms, &loop, &QEventLoop::quit);
+  loop.exec();
+}
+
+/////////////////////////////////////////////////
+TEST(StallWatchdogTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(Report))
+{
+  common::Console::SetVerbosity(4);
+
+  Application app(g_argc, g_argv, WindowType::kDialog);
+  EXPECT_EQ(nullptr, app.CurrentStallWatchdog());
+
+  app.StartStallWatchdog(std::chrono::milliseconds(100), "/test/stalls");
+  auto watchdog = app.CurrentStallWatchdog();
+  ASSERT_NE(nullptr, watchdog);
+  EXPECT_EQ(100, watchdog->Threshold().count());
+
+  std::vector<StallReport> reports;
+  watchdog->SetCallback([&reports](const StallReport &_report)
+  {
+    reports.push_back(_report);
+  });
+
+  std::vector<std::string> published;
+  transport::Node node;
+  std::function<void(const msgs::StringMsg &)> cb =
+      [&published](const msgs::StringMsg &_msg)
+  {
+    published.push_back(_msg.data());
+  };
+  EXPECT_TRUE(node.Subscribe("/test/stalls", cb));
+
+  // A responsive event loop isn't reported
+  RunEventLoop(300);
+  EXPECT_EQ(0u, watchdog->StallCount());
+
+  // A plugin's timer stalls the loop
+  Plugin plugin;
+  plugin.setObjectName("slow_plugin");
+  QTimer timer(&plugin);
+  timer.setSingleShot(true);
+  QObject::connect(&timer, &QTimer::timeout, []()
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(400));
+  });
+  timer.start(0);
+  RunEventLoop(300);
+
+  EXPECT_EQ(1u, watchdog->StallCount());
+  ASSERT_EQ(1u, reports.size());
+  EXPECT_EQ("QTimer", reports[0].handler);
+  EXPECT_EQ("Timer", reports[0].event);
+  EXPECT_EQ("slow_plugin", reports[0].plugin);
+  EXPECT_GE(reports[0].duration, 350.0);
+  EXPECT_LT(reports[0].duration, 2000.0);
+#ifdef __linux__
+  EXPECT_FALSE(reports[0].stack.empty());
+#endif
+
+  auto description = reports[0].String();
+  EXPECT_NE(std::string::npos, description.find("in [QTimer] handling "
+      "[Timer] of plugin [slow_plugin]")) << description;
+
+  for (int i = 0; i < 50 && published.empty(); ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  ASSERT_EQ(1u, published.size());
+  EXPECT_EQ(description, published[0]);
+
+  app.StopStallWatchdog();
+  EXPECT_EQ(nullptr, app.CurrentStallWatchdog());
+}
@@ -0,0 +1,680 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/transport/Node.hh>
+
+#include "ignition/gui/Application.hh"
+#include "ignition/gui/MsgSchema.hh"
+#include "ignition/gui/PluginAccounting.hh"
+#include "ignition/gui/SubscriptionHub.hh"
+
+namespace ignition
+{
+  namespace gui
+  {
+    /// \brief Rate limit of a subscriber, shared by all copies of the
+    /// subscriber list so it can be changed and claimed without locking
+    struct HubThrottle
+    {
+      /// \brief Get the current time on the throttle's clock.
+      /// \return Nanoseconds
+      static std::int64_t Now()
+      {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+      }
+
+      /// \brief Whether a message would be delivered now, without claiming
+      /// the delivery.
+      /// \param[in] _now Current time, see Now
+      /// \return True if due
+      bool Due(const std::int64_t _now) const
+      {
+        return this->interval.load() <= 0 || _now >= this->next.load();
+      }
+
+      /// \brief Claim a delivery, so that no other message is delivered
+      /// to the subscriber until the interval elapsed.
+      /// \param[in] _now Current time, see Now
+      /// \return False if not due, or another thread claimed it first
+      bool Claim(const std::int64_t _now)
+      {
+        auto step = this->interval.load();
+        if (step <= 0)
+          return true;
+        auto due = this->next.load();
+        if (_now < due)
+          return false;
+        return this->next.compare_exchange_strong(due, _now + step);
+      }
+
+      /// \brief Nanoseconds between deliveries, 0 for no limit
+      std::atomic<std::int64_t> interval{0};
+
+      /// \brief Time from which the next message may be delivered
+      std::atomic<std::int64_t> next{0};
+    };
+
+    /// \brief A plugin receiving a topic
+    struct HubSubscriber
+    {
+      /// \brief ID returned by Subscribe
+      std::size_t id;
+
+      /// \brief Called with each message
+      SubscriptionHub::Callback callback;
+
+      /// \brief True if only the latest message is delivered, once per
+      /// frame
+      bool latest;
+
+      /// \brief Plugin which subscribed, null if unknown
+      const Plugin *owner;
+
+      /// \brief Rate limit, never null
+      std::shared_ptr<HubThrottle> throttle;
+    };
+
+    /// \brief A callback receiving the serialized messages of all topics
+    struct HubTap
+    {
+      /// \brief ID returned by Tap
+      std::size_t id;
+
+      /// \brief Called with each message
+      SubscriptionHub::TapCallback callback;
+    };
+
+    /// \brief Messages of a topic which subscribers are done with. They're
+    /// parsed into again, so that their buffers, such as the data of
+    /// images, are reused instead of allocated for every message. A
+    /// message goes back to the pool when the last subscriber holding it
+    /// lets go, from whichever thread that happens on, and keeps the pool
+    /// alive while it's out.
+    class HubMsgPool : public std::enable_shared_from_this<HubMsgPool>
+    {
+      /// \brief Take a free message of a type, or make one.
+      /// \param[in] _schema Message type
+      /// \return Message with undefined contents, to be parsed into
+      public: std::shared_ptr<google::protobuf::Message> Acquire(
+          const MsgSchema &_schema)
+      {
+        std::unique_ptr<google::protobuf::Message> msg;
+        {
+          std::lock_guard<std::mutex> lock(this->mutex);
+
+          // Topics rarely change type, when they do the old msgs are useless
+          if (this->descriptor != _schema.Descriptor())
+          {
+            this->free.clear();
+            this->descriptor = _schema.Descriptor();
+          }
+          else if (!this->free.empty())
+          {
+            msg = std::move(this->free.back());
+            this->free.pop_back();
+          }
+        }
+        if (!msg)
+          msg = _schema.New();
+
+        auto pool = this->shared_from_this();
+        return std::shared_ptr<google::protobuf::Message>(msg.release(),
+            [pool](google::protobuf::Message *_msg)
+            {
+              pool->Release(_msg);
+            });
+      }
+
+      /// \brief Get a message back once nobody holds it anymore.
+      /// \param[in] _msg Message, owned by the pool from now on
+      private: void Release(google::protobuf::Message *_msg)
+      {
+        // Deleted after unlocking if it isn't kept
+        std::unique_ptr<google::protobuf::Message> msg(_msg);
+
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (msg->GetDescriptor() == this->descriptor &&
+            this->free.size() < kMaxFree)
+        {
+          this->free.push_back(std::move(msg));
+        }
+      }
+
+      /// \brief Most messages kept around unused. Subscribers such as
+      /// image displays hold a couple at once, the one shown and the next.
+      private: static constexpr std::size_t kMaxFree{2u};
+
+      /// \brief Protects the members below
+      private: std::mutex mutex;
+
+      /// \brief Type of the free messages
+      private: const google::protobuf::Descriptor *descriptor{nullptr};
+
+      /// \brief Messages which aren't in use
+      private: std::vector<std::unique_ptr<google::protobuf::Message>> free;
+    };
+
+    /// \brief State shared by the hub and all its topics
+    struct HubShared
+    {
+      /// \brief False to drop messages from transport
+      std::atomic<bool> live{true};
+
+      /// \brief Taps, replaced as a whole when they change. Only accessed
+      /// with std::atomic_load and std::atomic_store.
+      std::shared_ptr<const std::vector<HubTap>> taps;
+    };
+
+    /// \brief The subscribers of a topic, shared with its transport
+    /// subscription
+    class HubTopic
+    {
+      /// \brief Constructor
+      /// \param[in] _name Topic name
+      /// \param[in] _shared State shared with the hub
+      public: HubTopic(const std::string &_name,
+                       const std::shared_ptr<HubShared> &_shared)
+        : name(_name), shared(_shared)
+      {
+      }
+
+      /// \brief Handle a message from transport.
+      /// \param[in] _data Serialized message
+      /// \param[in] _size Size of the data
+      /// \param[in] _info Information about the message, such as its type
+      public: void OnTransport(const char *_data, const std::size_t _size,
+                               const transport::MessageInfo &_info)
+      {
+        if (auto taps = std::atomic_load(&this->shared->taps))
+        {
+          for (const auto &tap : *taps)
+            tap.callback(this->name, _info.Type(), _data, _size);
+        }
+
+        if (this->shared->live)
+          this->OnMessage(_info.Type(), _data, _size);
+      }
+
+      /// \brief Deserialize a message and hand it to all subscribers.
+      /// \param[in] _type Message type
+      /// \param[in] _data Serialized message
+      /// \param[in] _size Size of the data
+      /// \return False if there are no subscribers or the message can't be
+      /// parsed
+      public: bool OnMessage(const std::string &_type, const char *_data,
+                             const std::size_t _size)
+      {
+        auto subscribers = std::atomic_load(&this->subscribers);
+        if (!subscribers || subscribers->empty())
+          return false;
+
+        // Messages nobody is due for are dropped before the parsing cost
+        auto now = HubThrottle::Now();
+        if (std::none_of(subscribers->begin(), subscribers->end(),
+            [&now](const HubSubscriber &_subscriber)
+            {
+              return _subscriber.throttle->Due(now);
+            }))
+        {
+          return true;
+        }
+
+        // Parsed once, straight into the message shared by everyone,
+        // reusing one subscribers are done with
+        auto schema = MsgSchema::Find(_type);
+        if (!schema)
+        {
+          ignerr << "Unknown message type [" << _type
+                 << "] on topic [" << this->name << "]" << std::endl;
+          return false;
+        }
+        auto msg = this->pool->Acquire(*schema);
+        if (!msg->ParseFromArray(_data, static_cast<int>(_size)))
+        {
+          ignerr << "Failed to parse message of type [" << _type
+                 << "] on topic [" << this->name << "]" << std::endl;
+          return false;
+        }
+
+        bool latest{false};
+        for (const auto &subscriber : *subscribers)
+        {
+          if (subscriber.latest)
+          {
+            latest = latest || subscriber.throttle->Due(now);
+          }
+          else if (subscriber.throttle->Claim(now))
+          {
+            PluginCostScope cost(subscriber.owner, CostKind::kTransport);
+            subscriber.callback(msg);
+          }
+        }
+
+        // Replaces any message which wasn't delivered yet
+        if (latest)
+        {
+          std::shared_ptr<const google::protobuf::Message> constMsg = msg;
+          std::atomic_store(&this->latest, constMsg);
+        }
+        return true;
+      }
+
+      /// \brief Topic name
+      public: const std::string name;
+
+      /// \brief State shared with the hub
+      public: const std::shared_ptr<HubShared> shared;
+
+      /// \brief Messages to parse into
+      public: const std::shared_ptr<HubMsgPool> pool{
+          std::make_shared<HubMsgPool>()};
+
+      /// \brief Subscribers, replaced as a whole when they change so
+      /// messages are handed out without locking. Only accessed with
+      /// std::atomic_load and std::atomic_store.
+      public: std::shared_ptr<const std::vector<HubSubscriber>> subscribers;
+
+      /// \brief Latest message not delivered yet to the subscribers which
+      /// only want the latest, null if none. Only accessed with
+      /// std::atomic_load, std::atomic_store and std::atomic_exchange.
+      public: std::shared_ptr<const google::protobuf::Message> latest;
+    };
+
+    class SubscriptionHubPrivate
+    {
+      /// \brief Node holding one subscription per topic
+      public: transport::Node node;
+
+      /// \brief Topics subscribed to
+      public: std::map<std::string, std::shared_ptr<HubTopic>> topics;
+
+      /// \brief Topic of each subscriber ID
+      public: std::map<std::size_t, std::string> ids;
+
+      /// \brief Last ID given out
+      public: std::size_t lastId{0};
+
+      /// \brief Number of subscribers which only want the latest messages
+      public: std::size_t latestCount{0};
+
+      /// \brief Taps and live state, shared with the topics
+      public: std::shared_ptr<HubShared> shared{
+          std::make_shared<HubShared>()};
+
+      /// \brief Subscriber and tap lists replaced by Unsubscribe and
+      /// Untap, which messages may still be handed out from
+      /// \sa SubscriptionHub::WaitForDispatches
+      public: std::vector<std::weak_ptr<const void>> retired;
+
+      /// \brief Protects the members above, never taken while messages
+      /// are handed out
+      public: mutable std::mutex mutex;
+
+      /// \brief Keep a replaced list until nobody hands out messages from
+      /// it anymore.
+      /// \param[in] _list Replaced list
+      public: void Retire(const std::shared_ptr<const void> &_list)
+      {
+        this->retired.erase(std::remove_if(this->retired.begin(),
+            this->retired.end(),
+            [](const std::weak_ptr<const void> &_retired)
+            {
+              return _retired.expired();
+            }), this->retired.end());
+        this->retired.push_back(_list);
+      }
+
+      /// \brief Delivers the latest messages once per frame, while there
+      /// are subscribers for them
+      public: QTimer latestTimer;
+    };
+  }
+}
+
+using namespace ignition;
+using namespace gui;
+
+/// \brief Milliseconds between deliveries of the latest messages, about one
+/// display frame
+static const int kLatestInterval = 16;
+
+/// \brief Hub returned by Instance, null until first used
+static SubscriptionHub *g_hub{nullptr};
+
+/// \brief Protects g_hub
+static std::mutex g_hubMutex;
+
+/////////////////////////////////////////////////
+SubscriptionHub::SubscriptionHub()
+  : dataPtr(new SubscriptionHubPrivate)
+{
+  this->dataPtr->latestTimer.setInterval(kLatestInterval);
+  this->connect(&this->dataPtr->latestTimer, &QTimer::timeout, this,
+      [this]()
+  {
+    // Gathered first, so callbacks are free to subscribe and unsubscribe
+    std::vector<std::pair<std::shared_ptr<const google::protobuf::Message>,
+        std::shared_ptr<const std::vector<HubSubscriber>>>> deliveries;
+    {
+      std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+      for (const auto &topic : this->dataPtr->topics)
+      {
+        auto msg = std::atomic_exchange(&topic.second->latest,
+            std::shared_ptr<const google::protobuf::Message>());
+        if (msg)
+        {
+          deliveries.push_back(
+              {msg, std::atomic_load(&topic.second->subscribers)});
+        }
+      }
+    }
+
+    auto now = HubThrottle::Now();
+    for (const auto &delivery : deliveries)
+    {
+      if (!delivery.second)
+        continue;
+      for (const auto &subscriber : *delivery.second)
+      {
+        if (subscriber.latest && subscriber.throttle->Claim(now))
+        {
+          PluginCostScope cost(subscriber.owner, CostKind::kTransport);
+          subscriber.callback(delivery.first);
+        }
+      }
+    }
+  });
+}
+
+/////////////////////////////////////////////////
+SubscriptionHub::~SubscriptionHub()
+{
+  {
+    std::lock_guard<std::mutex> lock(g_hubMutex);
+    if (g_hub == this)
+      g_hub = nullptr;
+  }
+
+  for (const auto &topic : this->dataPtr->topics)
+    this->dataPtr->node.Unsubscribe(topic.first);
+}
+
+/////////////////////////////////////////////////
+SubscriptionHub *SubscriptionHub::Instance()
+{
+  std::lock_guard<std::mutex> lock(g_hubMutex);
+  if (!g_hub)
+  {
+    g_hub = new SubscriptionHub();
+
+    // Go away with the application, so the next one subscribes again with
+    // its own partition
+    if (App())
+      g_hub->setParent(App());
+  }
+  return g_hub;
+}
+
+/////////////////////////////////////////////////
+std::size_t SubscriptionHub::Subscribe(const std::string &_topic,
+    const Callback &_callback)
+{
+  return this->AddSubscriber(_topic, _callback, false);
+}
+
+/////////////////////////////////////////////////
+std::size_t SubscriptionHub::SubscribeLatest(const std::string &_topic,
+    const Callback &_callback)
+{
+  return this->AddSubscriber(_topic, _callback, true);
+}
+
+/////////////////////////////////////////////////
+std::size_t SubscriptionHub::AddSubscriber(const std::string &_topic,
+    const Callback &_callback, bool _latest)
+{
+  if (!_callback)
+    return 0;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  auto &topic = this->dataPtr->topics[_topic];
+  if (!topic)
+  {
+    topic = std::make_shared<HubTopic>(_topic, this->dataPtr->shared);
+
+    // The subscription shares the topic, which outlives the callbacks in
+    // flight when it's unsubscribed
+    auto handler = topic;
+    auto cb = [handler](const char *_data, const std::size_t _size,
+        const transport::MessageInfo &_info)
+    {
+      handler->OnTransport(_data, _size, _info);
+    };
+    if (!this->dataPtr->node.SubscribeRaw(_topic, cb))
+    {
+      ignerr << "Unable to subscribe to topic [" << _topic << "]"
+             << std::endl;
+      this->dataPtr->topics.erase(_topic);
+      return 0;
+    }
+  }
+
+  auto subscribers = std::make_shared<std::vector<HubSubscriber>>();
+  if (auto current = std::atomic_load(&topic->subscribers))
+    *subscribers = *current;
+
+  auto id = ++this->dataPtr->lastId;
+  subscribers->push_back({id, _callback, _latest,
+      PluginAccounting::CurrentPlugin(), std::make_shared<HubThrottle>()});
+  std::shared_ptr<const std::vector<HubSubscriber>> published = subscribers;
+  std::atomic_store(&topic->subscribers, published);
+
+  this->dataPtr->ids[id] = _topic;
+
+  if (_latest && this->dataPtr->latestCount++ == 0)
+    this->dataPtr->latestTimer.start();
+
+  return id;
+}
+
+/////////////////////////////////////////////////
+void SubscriptionHub::Unsubscribe(const std::size_t _id)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  auto idIt = this->dataPtr->ids.find(_id);
+  if (idIt == this->dataPtr->ids.end())
+    return;
+
+  auto topicIt = this->dataPtr->topics.find(idIt->second);
+  auto &topic = topicIt->second;
+
+  auto current = std::atomic_load(&topic->subscribers);
+  this->dataPtr->Retire(current);
+
+  auto subscribers = std::make_shared<std::vector<HubSubscriber>>(*current);
+  auto subscriberIt = std::find_if(subscribers->begin(), subscribers->end(),
+      [&_id](const HubSubscriber &_subscriber)
+      {
+        return _subscriber.id == _id;
+      });
+  if (subscriberIt != subscribers->end())
+  {
+    if (subscriberIt->latest && --this->dataPtr->latestCount == 0)
+      this->dataPtr->latestTimer.stop();
+    subscribers->erase(subscriberIt);
+  }
+
+  if (subscribers->empty())
+  {
+    this->dataPtr->node.Unsubscribe(topicIt->first);
+    std::atomic_store(&topic->subscribers,
+        std::shared_ptr<const std::vector<HubSubscriber>>());
+    this->dataPtr->topics.erase(topicIt);
+  }
+  else
+  {
+    std::shared_ptr<const std::vector<HubSubscriber>> published =
+        subscribers;
+    std::atomic_store(&topic->subscribers, published);
+  }
+
+  this->dataPtr->ids.erase(idIt);
+}
+
+/////////////////////////////////////////////////
+void SubscriptionHub::SetMsgsPerSec(const std::size_t _id,
+    const double _msgsPerSec)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  auto idIt = this->dataPtr->ids.find(_id);
+  if (idIt == this->dataPtr->ids.end())
+    return;
+
+  auto subscribers = std::atomic_load(
+      &this->dataPtr->topics[idIt->second]->subscribers);
+  for (const auto &subscriber : *subscribers)
+  {
+    if (subscriber.id != _id)
+      continue;
+
+    std::int64_t interval{0};
+    if (_msgsPerSec > 0.0)
+      interval = static_cast<std::int64_t>(1e9 / _msgsPerSec);
+    subscriber.throttle->interval = interval;
+    subscriber.throttle->next = 0;
+    break;
+  }
+}
+
+/////////////////////////////////////////////////
+std::size_t SubscriptionHub::SubscriberCount(const std::string &_topic) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  auto topicIt = this->dataPtr->topics.find(_topic);
+  if (topicIt == this->dataPtr->topics.end())
+    return 0;
+
+  auto subscribers = std::atomic_load(&topicIt->second->subscribers);
+  return subscribers ? subscribers->size() : 0;
+}
+
+/////////////////////////////////////////////////
+std::size_t SubscriptionHub::Tap(const TapCallback &_callback)
+{
+  if (!_callback)
+    return 0;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  auto &shared = *this->dataPtr->shared;
+  auto taps = std::make_shared<std::vector<HubTap>>();
+  if (auto current = std::atomic_load(&shared.taps))
+    *taps = *current;
+
+  auto id = ++this->dataPtr->lastId;
+  taps->push_back({id, _callback});
+  std::shared_ptr<const std::vector<HubTap>> published = taps;
+  std::atomic_store(&shared.taps, published);
+  return id;
+}
+
+/////////////////////////////////////////////////
+void SubscriptionHub::Untap(const std::size_t _id)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  auto &shared = *this->dataPtr->shared;
+  auto current = std::atomic_load(&shared.taps);
+  if (!current)
+    return;
+
+  this->dataPtr->Retire(current);
+
+  auto taps = std::make_shared<std::vector<HubTap>>(*current);
+  taps->erase(std::remove_if(taps->begin(), taps->end(),
+      [&_id](const HubTap &_tap)
+      {
+        return _tap.id == _id;
+      }), taps->end());
+
+  std::shared_ptr<const std::vector<HubTap>> published;
+  if (!taps->empty())
+    published = taps;
+  std::atomic_store(&shared.taps, published);
+}
+
+/////////////////////////////////////////////////
+void SubscriptionHub::WaitForDispatches()
+{
+  std::vector<std::weak_ptr<const void>> retired;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    retired.swap(this->dataPtr->retired);
+  }
+
+  // Messages are handed out from a list held for the whole dispatch, so
+  // once it's gone so are the callbacks it held
+  for (const auto &list : retired)
+  {
+    while (!list.expired())
+      std::this_thread::yield();
+  }
+}
+
+/////////////////////////////////////////////////
+bool SubscriptionHub::Inject(const std::string &_topic,
+    const std::string &_type, const char *_data, const std::size_t _size)
+{
+  std::shared_ptr<HubTopic> topic;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    auto topicIt = this->dataPtr->topics.find(_topic);
+    if (topicIt == this->dataPtr->topics.end())
+      return false;
+    topic = topicIt->second;
+  }
+  return topic->OnMessage(_type, _data, _size);
+}
+
+/////////////////////////////////////////////////
+void SubscriptionHub::SetLive(const bool _live)
+{
+  this->dataPtr->shared->live = _live;
+}
+
+/////////////////////////////////////////////////
+bool SubscriptionHub::Live() const
+{
+  return this->dataPtr->shared->live;
+}
@@ -0,0 +1,362 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/msgs/int32.pb.h>
+#include <ignition/msgs/stringmsg.pb.h>
+#include <ignition/transport/Node.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/gui/SubscriptionHub.hh"
+
+using namespace ignition;
+using namespace gui;
+
+/// \brief Receives msgs through a member function
+class Receiver
+{
+  /// \brief Callback
+  /// \param[in] _msg Message received
+  public: void OnMsg(const msgs::Int32 &_msg)
+  {
+    this->data = _msg.data();
+  }
+
+  /// \brief Last data received
+  public: std::atomic<int> data{0};
+};
+
+/////////////////////////////////////////////////
+TEST(SubscriptionHubTest, Subscribe)
+{
+  common::Console::SetVerbosity(4);
+  setenv("IGN_PARTITION", "ign-gui-subscription-hub-test", 1);
+
+  auto hub = SubscriptionHub::Instance();
+  ASSERT_NE(nullptr, hub);
+  EXPECT_EQ(hub, SubscriptionHub::Instance());
+
+  EXPECT_EQ(0u, hub->Subscribe("invalid topic", [](
+      const std::shared_ptr<const google::protobuf::Message> &){}));
+  EXPECT_EQ(0u, hub->SubscriberCount("invalid topic"));
+
+  // Three subscribers, one subscription
+  std::shared_ptr<const google::protobuf::Message> generic;
+  std::mutex mutex;
+  auto genericId = hub->Subscribe("/hub_test", [&](
+      const std::shared_ptr<const google::protobuf::Message> &_msg)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    generic = _msg;
+  });
+  EXPECT_NE(0u, genericId);
+
+  std::shared_ptr<const msgs::Int32> typed;
+  auto typedId = hub->Subscribe<msgs::Int32>("/hub_test", [&](
+      const std::shared_ptr<const msgs::Int32> &_msg)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    typed = _msg;
+  });
+  EXPECT_NE(0u, typedId);
+
+  Receiver receiver;
+  auto memberId = hub->Subscribe("/hub_test", &Receiver::OnMsg, &receiver);
+  EXPECT_NE(0u, memberId);
+  EXPECT_EQ(3u, hub->SubscriberCount("/hub_test"));
+
+  transport::Node node;
+  auto pub = node.Advertise<msgs::Int32>("/hub_test");
+  msgs::Int32 msg;
+  msg.set_data(5);
+
+  for (int i = 0; i < 30 && receiver.data != 5; ++i)
+  {
+    pub.Publish(msg);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+  EXPECT_EQ(5, receiver.data);
+
+  // Everyone got the same message
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_NE(nullptr, typed);
+    EXPECT_EQ(5, typed->data());
+    EXPECT_EQ(generic.get(), typed.get());
+  }
+
+  // Typed subscribers skip other types
+  std::atomic<int> strings{0};
+  auto stringId = hub->Subscribe<msgs::StringMsg>("/hub_test", [&](
+      const std::shared_ptr<const msgs::StringMsg> &)
+  {
+    ++strings;
+  });
+  msg.set_data(6);
+  for (int i = 0; i < 30 && receiver.data != 6; ++i)
+  {
+    pub.Publish(msg);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+  EXPECT_EQ(6, receiver.data);
+  EXPECT_EQ(0, strings);
+
+  // The subscription goes away with the last subscriber
+  hub->Unsubscribe(stringId);
+  hub->Unsubscribe(genericId);
+  hub->Unsubscribe(typedId);
+  hub->Unsubscribe(0);
+  EXPECT_EQ(1u, hub->SubscriberCount("/hub_test"));
+  hub->Unsubscribe(memberId);
+  EXPECT_EQ(0u, hub->SubscriberCount("/hub_test"));
+
+  msg.set_data(7);
+  pub.Publish(msg);
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  EXPECT_EQ(6, receiver.data);
+}
+
+/////////////////////////////////////////////////
+TEST(SubscriptionHubTest, SubscribeLatest)
+{
+  common::Console::SetVerbosity(4);
+  setenv("IGN_PARTITION", "ign-gui-subscription-hub-test", 1);
+
+  int argc = 1;
+  char *argv[] = {const_cast<char *>("SubscriptionHub_TEST")};
+  QCoreApplication app(argc, argv);
+
+  auto hub = SubscriptionHub::Instance();
+
+  // Delivered on this thread
+  std::vector<int> received;
+  auto latestId = hub->SubscribeLatest<msgs::Int32>("/hub_latest_test",
+      [&](const std::shared_ptr<const msgs::Int32> &_msg)
+  {
+    EXPECT_EQ(QThread::currentThread(), app.thread());
+    received.push_back(_msg->data());
+  });
+  EXPECT_NE(0u, latestId);
+
+  Receiver receiver;
+  auto memberId = hub->Subscribe("/hub_latest_test", &Receiver::OnMsg,
+      &receiver);
+  EXPECT_EQ(2u, hub->SubscriberCount("/hub_latest_test"));
+
+  transport::Node node;
+  auto pub = node.Advertise<msgs::Int32>("/hub_latest_test");
+  msgs::Int32 msg;
+  msg.set_data(1);
+  for (int i = 0; i < 30 && receiver.data != 1; ++i)
+  {
+    pub.Publish(msg);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+  ASSERT_EQ(1, receiver.data);
+
+  // A burst of messages between frames is coalesced into the last one
+  for (int i = 2; i <= 100; ++i)
+  {
+    msg.set_data(i);
+    pub.Publish(msg);
+  }
+  for (int i = 0; i < 30 && receiver.data != 100; ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  ASSERT_EQ(100, receiver.data);
+
+  received.clear();
+  for (int i = 0; i < 10; ++i)
+  {
+    QCoreApplication::processEvents(QEventLoop::AllEvents, 30);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+  ASSERT_EQ(1u, received.size());
+  EXPECT_EQ(100, received[0]);
+
+  hub->Unsubscribe(latestId);
+  hub->Unsubscribe(memberId);
+  EXPECT_EQ(0u, hub->SubscriberCount("/hub_latest_test"));
+}
+
+/////////////////////////////////////////////////
+TEST(SubscriptionHubTest, MsgsPerSec)
+{
+  common::Console::SetVerbosity(4);
+  setenv("IGN_PARTITION", "ign-gui-subscription-hub-test", 1);
+
+  auto hub = SubscriptionHub::Instance();
+
+  std::atomic<int> all{0};
+  auto allId = hub->Subscribe("/hub_rate_test", [&](
+      const std::shared_ptr<const google::protobuf::Message> &)
+  {
+    ++all;
+  });
+  std::atomic<int> limited{0};
+  auto limitedId = hub->Subscribe("/hub_rate_test", [&](
+      const std::shared_ptr<const google::protobuf::Message> &)
+  {
+    ++limited;
+  });
+  ASSERT_NE(0u, allId);
+  ASSERT_NE(0u, limitedId);
+  hub->SetMsgsPerSec(limitedId, 1.0);
+
+  msgs::Int32 msg;
+  msg.set_data(1);
+  auto data = msg.SerializeAsString();
+
+  // Only the first of a burst reaches the limited subscriber
+  for (int i = 0; i < 10; ++i)
+  {
+    EXPECT_TRUE(hub->Inject("/hub_rate_test", "ignition.msgs.Int32",
+        data.data(), data.size()));
+  }
+  EXPECT_EQ(10, all);
+  EXPECT_EQ(1, limited);
+
+  // Nobody is due, nothing is delivered
+  hub->SetMsgsPerSec(allId, 1.0);
+  all = 0;
+  limited = 0;
+  EXPECT_TRUE(hub->Inject("/hub_rate_test", "ignition.msgs.Int32",
+      data.data(), data.size()));
+  EXPECT_TRUE(hub->Inject("/hub_rate_test", "ignition.msgs.Int32",
+      data.data(), data.size()));
+  EXPECT_EQ(1, all);
+  EXPECT_EQ(0, limited);
+
+  // Lifting the limit delivers everything again
+  hub->SetMsgsPerSec(limitedId, 0.0);
+  for (int i = 0; i < 5; ++i)
+  {
+    EXPECT_TRUE(hub->Inject("/hub_rate_test", "ignition.msgs.Int32",
+        data.data(), data.size()));
+  }
+  EXPECT_EQ(5, limited);
+
+  hub->Unsubscribe(allId);
+  hub->Unsubscribe(limitedId);
+  EXPECT_EQ(0u, hub->SubscriberCount("/hub_rate_test"));
+}
+
+/////////////////////////////////////////////////
+TEST(SubscriptionHubTest, RecycleMsgs)
+{
+  common::Console::SetVerbosity(4);
+  setenv("IGN_PARTITION", "ign-gui-subscription-hub-test", 1);
+
+  auto hub = SubscriptionHub::Instance();
+
+  std::shared_ptr<const msgs::StringMsg> held;
+  std::vector<const google::protobuf::Message *> received;
+  auto id = hub->Subscribe<msgs::StringMsg>("/hub_recycle_test", [&](
+      const std::shared_ptr<const msgs::StringMsg> &_msg)
+  {
+    received.push_back(_msg.get());
+    held = _msg;
+  });
+  ASSERT_NE(0u, id);
+
+  msgs::StringMsg msg;
+  msg.set_data(std::string(1000, 'a'));
+  auto data = msg.SerializeAsString();
+  auto inject = [&]()
+  {
+    return hub->Inject("/hub_recycle_test", "ignition.msgs.StringMsg",
+        data.data(), data.size());
+  };
+
+  // A msg which is still held isn't parsed into
+  ASSERT_TRUE(inject());
+  ASSERT_TRUE(inject());
+  ASSERT_EQ(2u, received.size());
+  EXPECT_NE(received[0], received[1]);
+
+  // Once let go of, it's parsed into again, with the new contents
+  held.reset();
+  msg.set_data("b");
+  data = msg.SerializeAsString();
+  ASSERT_TRUE(inject());
+  ASSERT_EQ(3u, received.size());
+  EXPECT_TRUE(received[2] == received[0] || received[2] == received[1]);
+  ASSERT_NE(nullptr, held);
+  EXPECT_EQ("b", held->data());
+
+  held.reset();
+  hub->Unsubscribe(id);
+}
+
+/////////////////////////////////////////////////
+TEST(SubscriptionHubTest, WaitForDispatches)
+{
+  common::Console::SetVerbosity(4);
+  setenv("IGN_PARTITION", "ign-gui-subscription-hub-test", 1);
+
+  auto hub = SubscriptionHub::Instance();
+
+  std::atomic<bool> entered{false};
+  std::atomic<bool> release{false};
+  auto id = hub->Subscribe("/hub_wait_test", [&](
+      const std::shared_ptr<const google::protobuf::Message> &)
+  {
+    entered = true;
+    while (!release)
+      std::this_thread::yield();
+  });
+  ASSERT_NE(0u, id);
+
+  msgs::Int32 msg;
+  msg.set_data(1);
+  auto data = msg.SerializeAsString();
+  std::thread dispatch([&]()
+  {
+    hub->Inject("/hub_wait_test", "ignition.msgs.Int32", data.data(),
+        data.size());
+  });
+  while (!entered)
+    std::this_thread::yield();
+
+  // The callback is still running after it's unsubscribed, so waiting only
+  // returns once it's done
+  hub->Unsubscribe(id);
+  std::atomic<bool> waited{false};
+  std::thread wait([&]()
+  {
+    hub->WaitForDispatches();
+    waited = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_FALSE(waited);
+
+  release = true;
+  wait.join();
+  dispatch.join();
+  EXPECT_TRUE(waited);
+
+  // Nothing left to wait for
+  hub->WaitForDispatches();
+}
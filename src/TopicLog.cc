@@ -0,0 +1,1087 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <utility>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/gui/SubscriptionHub.hh"
+#include "ignition/gui/TopicLog.hh"
+
+namespace ignition
+{
+  namespace gui
+  {
+    /// \brief Start of a log file
+    struct LogFileHeader
+    {
+      /// \brief Identifies topic logs
+      char magic[8];
+
+      /// \brief Version of the layout
+      uint32_t version;
+
+      /// \brief Unused, keeps chunks aligned
+      uint32_t reserved;
+    };
+
+    /// \brief Start of a chunk, followed by its records
+    struct LogChunkHeader
+    {
+      /// \brief Identifies chunks
+      uint32_t magic;
+
+      /// \brief Number of messages, not counting topic definitions
+      uint32_t count;
+
+      /// \brief Bytes of records following the header
+      uint64_t size;
+
+      /// \brief Time of the first message
+      int64_t first;
+
+      /// \brief Time of the last message
+      int64_t last;
+    };
+
+    /// \brief Start of a record, followed by its payload
+    struct LogRecordHeader
+    {
+      /// \brief Receive time of a message, 0 for a definition
+      int64_t time;
+
+      /// \brief Topic ID, with kDefinitionFlag set if the record defines
+      /// the topic instead of carrying a message
+      uint32_t topic;
+
+      /// \brief Bytes of payload
+      uint32_t size;
+    };
+
+    /// \brief Entry of the index written when the log is closed
+    struct LogIndexEntry
+    {
+      /// \brief Offset of the chunk header in the file
+      uint64_t offset;
+
+      /// \brief Time of the first message
+      int64_t first;
+
+      /// \brief Time of the last message
+      int64_t last;
+
+      /// \brief Number of messages
+      uint32_t count;
+
+      /// \brief Unused, keeps entries aligned
+      uint32_t reserved;
+    };
+
+    /// \brief End of a closed log file
+    struct LogFileFooter
+    {
+      /// \brief Offset of the index in the file
+      uint64_t index;
+
+      /// \brief Identifies closed logs
+      char magic[8];
+    };
+
+    /// \brief A topic and the type of its messages
+    struct LogTopic
+    {
+      /// \brief Topic name
+      std::string name;
+
+      /// \brief Message type
+      std::string type;
+    };
+
+    class TopicLogWriterPrivate
+    {
+      /// \brief Write the chunk being gathered, if it has any record.
+      /// \return False if writing failed
+      public: bool FlushChunk();
+
+      /// \brief Append a record to the chunk being gathered.
+      /// \param[in] _header Record header
+      /// \param[in] _data Payload
+      public: void Append(const LogRecordHeader &_header, const char *_data);
+
+      /// \brief Bytes of records gathered before a chunk is written
+      public: std::size_t chunkSize;
+
+      /// \brief Open file, null if none
+      public: std::FILE *file{nullptr};
+
+      /// \brief Bytes written to the file
+      public: uint64_t offset{0};
+
+      /// \brief Records of the chunk being gathered
+      public: std::string chunk;
+
+      /// \brief Header of the chunk being gathered
+      public: LogChunkHeader chunkHeader{};
+
+      /// \brief Chunks written
+      public: std::vector<LogIndexEntry> index;
+
+      /// \brief ID of each topic and type
+      public: std::map<std::pair<std::string, std::string>, uint32_t> ids;
+
+      /// \brief Topics, by ID
+      public: std::vector<LogTopic> topics;
+
+      /// \brief Time of the last message, times never go back
+      public: int64_t lastTime{0};
+
+      /// \brief Messages written
+      public: uint64_t count{0};
+
+      /// \brief Protects the members above
+      public: mutable std::mutex mutex;
+    };
+
+    /// \brief Position of a reader
+    struct LogCursor
+    {
+      /// \brief Chunk being read
+      std::size_t chunk{0};
+
+      /// \brief Offset of the next record in the file
+      uint64_t offset{0};
+    };
+
+    class TopicLogReaderPrivate
+    {
+      /// \brief Read the index at the end of the file.
+      /// \return False if the log wasn't closed or the index is damaged
+      public: bool ReadIndex();
+
+      /// \brief Index the log by going through the chunks, up to the first
+      /// one which is damaged or cut short.
+      public: void Recover();
+
+      /// \brief Read the topic definition of a record.
+      /// \param[in] _header Record header
+      /// \param[in] _data Payload
+      public: void Define(const LogRecordHeader &_header, const char *_data);
+
+      /// \brief Move a cursor to its first record if it's at the start of a
+      /// chunk or the end of one.
+      /// \param[in, out] _cursor Cursor
+      /// \return False at the end of the log
+      public: bool Settle(LogCursor &_cursor) const;
+
+      /// \brief Read the message at a cursor and move past it.
+      /// \param[in, out] _cursor Cursor
+      /// \param[out] _record Message read, null to only move
+      /// \return False at the end of the log
+      public: bool Advance(LogCursor &_cursor,
+                           TopicLogRecord *_record) const;
+
+      /// \brief Start of the file in memory
+      public: const char *data{nullptr};
+
+      /// \brief Bytes of the file
+      public: std::size_t length{0};
+
+#ifndef _WIN32
+      /// \brief Memory mapping of the file, null if read into the buffer
+      public: void *mapping{nullptr};
+#endif
+
+      /// \brief Contents of the file, when it isn't mapped
+      public: std::string buffer;
+
+      /// \brief Chunks, by time
+      public: std::vector<LogIndexEntry> chunks;
+
+      /// \brief Topics, by ID
+      public: std::vector<LogTopic> topics;
+
+      /// \brief Number of messages
+      public: uint64_t count{0};
+
+      /// \brief Position of the next message
+      public: LogCursor cursor;
+    };
+
+    class TopicLogRecorderPrivate
+    {
+      /// \brief Writer, shared with the tap, which may still be running
+      /// right after being removed
+      public: std::shared_ptr<TopicLogWriter> writer{
+          std::make_shared<TopicLogWriter>()};
+
+      /// \brief ID of the tap on the subscription hub, 0 if not recording
+      public: std::size_t tap{0};
+    };
+
+    class TopicLogPlayerPrivate
+    {
+      /// \brief Log played
+      public: TopicLogReader reader;
+
+      /// \brief Delivers messages while playing
+      public: QTimer timer;
+
+      /// \brief Measures time since playing started or the rate changed
+      public: QElapsedTimer elapsed;
+
+      /// \brief Log time when elapsed started
+      public: int64_t base{0};
+
+      /// \brief Log time of the last message delivered, or sought to
+      public: int64_t time{0};
+
+      /// \brief Playing rate
+      public: double rate{1.0};
+    };
+  }
+}
+
+using namespace ignition;
+using namespace gui;
+
+/// \brief Identifies topic logs
+static const char kFileMagic[8] = {'I', 'G', 'N', 'T', 'L', 'O', 'G', '\0'};
+
+/// \brief Identifies closed topic logs
+static const char kFooterMagic[8] = {'I', 'G', 'N', 'T', 'I', 'D', 'X', '\0'};
+
+/// \brief Version of the layout written
+static const uint32_t kVersion{1u};
+
+/// \brief Identifies chunks, "CHNK"
+static const uint32_t kChunkMagic{0x4b4e4843u};
+
+/// \brief Identifies the index, "TIDX"
+static const uint32_t kIndexMagic{0x58444954u};
+
+/// \brief Set on the topic of records which define a topic
+static const uint32_t kDefinitionFlag{0x80000000u};
+
+/// \brief Milliseconds between deliveries while playing
+static const int kPlayInterval{10};
+
+/// \brief Most messages delivered at once, so the GUI keeps responding
+/// when playing much faster than received
+static const int kMaxDeliveries{2000};
+
+/////////////////////////////////////////////////
+/// \brief Copy a value out of memory which may not be aligned.
+/// \param[in] _data Start of the value
+/// \return The value
+template<typename T>
+static T load(const char *_data)
+{
+  T value;
+  std::memcpy(&value, _data, sizeof(T));
+  return value;
+}
+
+/////////////////////////////////////////////////
+TopicLogWriter::TopicLogWriter(const std::size_t _chunkSize)
+  : dataPtr(new TopicLogWriterPrivate)
+{
+  this->dataPtr->chunkSize = std::max<std::size_t>(_chunkSize, 1u);
+}
+
+/////////////////////////////////////////////////
+TopicLogWriter::~TopicLogWriter()
+{
+  this->Close();
+}
+
+/////////////////////////////////////////////////
+bool TopicLogWriter::Open(const std::string &_path)
+{
+  this->Close();
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto &d = *this->dataPtr;
+
+  d.file = std::fopen(_path.c_str(), "wb");
+  if (!d.file)
+  {
+    ignerr << "Unable to create topic log [" << _path << "]" << std::endl;
+    return false;
+  }
+
+  LogFileHeader header{};
+  std::memcpy(header.magic, kFileMagic, sizeof(kFileMagic));
+  header.version = kVersion;
+  if (std::fwrite(&header, sizeof(header), 1, d.file) != 1)
+  {
+    ignerr << "Unable to write topic log [" << _path << "]" << std::endl;
+    std::fclose(d.file);
+    d.file = nullptr;
+    return false;
+  }
+
+  d.offset = sizeof(header);
+  d.chunk.clear();
+  d.chunkHeader = LogChunkHeader{};
+  d.index.clear();
+  d.ids.clear();
+  d.topics.clear();
+  d.lastTime = 0;
+  d.count = 0;
+  return true;
+}
+
+/////////////////////////////////////////////////
+void TopicLogWriter::Close()
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto &d = *this->dataPtr;
+  if (!d.file)
+    return;
+
+  if (d.FlushChunk())
+  {
+    // Index, then the footer pointing to it
+    std::string index;
+    auto appendRaw = [&index](const void *_data, const std::size_t _size)
+    {
+      index.append(static_cast<const char *>(_data), _size);
+    };
+    auto appendString = [&](const std::string &_value)
+    {
+      auto size = static_cast<uint32_t>(_value.size());
+      appendRaw(&size, sizeof(size));
+      index.append(_value);
+    };
+
+    auto chunkCount = static_cast<uint32_t>(d.index.size());
+    appendRaw(&kIndexMagic, sizeof(kIndexMagic));
+    appendRaw(&chunkCount, sizeof(chunkCount));
+    if (!d.index.empty())
+      appendRaw(d.index.data(), d.index.size() * sizeof(LogIndexEntry));
+
+    auto topicCount = static_cast<uint32_t>(d.topics.size());
+    appendRaw(&topicCount, sizeof(topicCount));
+    for (const auto &topic : d.topics)
+    {
+      appendString(topic.name);
+      appendString(topic.type);
+    }
+
+    LogFileFooter footer{};
+    footer.index = d.offset;
+    std::memcpy(footer.magic, kFooterMagic, sizeof(kFooterMagic));
+    appendRaw(&footer, sizeof(footer));
+
+    if (std::fwrite(index.data(), index.size(), 1, d.file) != 1)
+      ignerr << "Unable to write the index of a topic log" << std::endl;
+  }
+
+  std::fclose(d.file);
+  d.file = nullptr;
+}
+
+/////////////////////////////////////////////////
+bool TopicLogWriter::IsOpen() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->file != nullptr;
+}
+
+/////////////////////////////////////////////////
+bool TopicLogWriter::Write(const int64_t _time, const std::string &_topic,
+    const std::string &_type, const char *_data, const std::size_t _size)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto &d = *this->dataPtr;
+  if (!d.file)
+    return false;
+
+  auto key = std::make_pair(_topic, _type);
+  auto idIt = d.ids.find(key);
+  if (idIt == d.ids.end())
+  {
+    // Defined in the chunk of its first message, so a log indexed again
+    // after a crash knows all the topics of the chunks it kept
+    auto id = static_cast<uint32_t>(d.topics.size());
+    idIt = d.ids.emplace(key, id).first;
+    d.topics.push_back({_topic, _type});
+
+    std::string definition = _topic + '\0' + _type;
+    d.Append({0, id | kDefinitionFlag,
+        static_cast<uint32_t>(definition.size())}, definition.data());
+  }
+
+  // Callbacks racing for the lock may come a little out of order, which
+  // would break seeking
+  auto time = std::max(_time, d.lastTime);
+  d.lastTime = time;
+
+  if (d.chunkHeader.count == 0)
+    d.chunkHeader.first = time;
+  d.chunkHeader.last = time;
+  ++d.chunkHeader.count;
+  d.Append({time, idIt->second, static_cast<uint32_t>(_size)}, _data);
+  ++d.count;
+
+  if (d.chunk.size() >= d.chunkSize)
+    return d.FlushChunk();
+  return true;
+}
+
+/////////////////////////////////////////////////
+uint64_t TopicLogWriter::Count() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->count;
+}
+
+/////////////////////////////////////////////////
+void TopicLogWriterPrivate::Append(const LogRecordHeader &_header,
+    const char *_data)
+{
+  this->chunk.append(reinterpret_cast<const char *>(&_header),
+      sizeof(_header));
+  if (_header.size > 0)
+    this->chunk.append(_data, _header.size);
+}
+
+/////////////////////////////////////////////////
+bool TopicLogWriterPrivate::FlushChunk()
+{
+  if (this->chunk.empty())
+    return true;
+
+  this->chunkHeader.magic = kChunkMagic;
+  this->chunkHeader.size = this->chunk.size();
+
+  // Flushed as a whole, so a crash leaves complete chunks behind
+  if (std::fwrite(&this->chunkHeader, sizeof(this->chunkHeader), 1,
+      this->file) != 1 ||
+      std::fwrite(this->chunk.data(), this->chunk.size(), 1,
+      this->file) != 1 ||
+      std::fflush(this->file) != 0)
+  {
+    ignerr << "Unable to write a chunk of a topic log" << std::endl;
+    return false;
+  }
+
+  LogIndexEntry entry{};
+  entry.offset = this->offset;
+  entry.first = this->chunkHeader.first;
+  entry.last = this->chunkHeader.last;
+  entry.count = this->chunkHeader.count;
+  this->index.push_back(entry);
+
+  this->offset += sizeof(this->chunkHeader) + this->chunk.size();
+  this->chunk.clear();
+  this->chunkHeader = LogChunkHeader{};
+  return true;
+}
+
+/////////////////////////////////////////////////
+TopicLogReader::TopicLogReader()
+  : dataPtr(new TopicLogReaderPrivate)
+{
+}
+
+/////////////////////////////////////////////////
+TopicLogReader::~TopicLogReader()
+{
+  this->Close();
+}
+
+/////////////////////////////////////////////////
+bool TopicLogReader::Open(const std::string &_path)
+{
+  this->Close();
+  auto &d = *this->dataPtr;
+
+#ifndef _WIN32
+  int fd = open(_path.c_str(), O_RDONLY);
+  if (fd >= 0)
+  {
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size > 0)
+    {
+      auto length = static_cast<std::size_t>(info.st_size);
+      void *memory = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (memory != MAP_FAILED)
+      {
+        d.mapping = memory;
+        d.data = static_cast<const char *>(memory);
+        d.length = length;
+      }
+    }
+    close(fd);
+  }
+#endif
+
+  // Read into memory where it can't be mapped
+  if (!d.data)
+  {
+    std::ifstream file(_path, std::ios::binary);
+    if (!file)
+    {
+      ignerr << "Unable to open topic log [" << _path << "]" << std::endl;
+      return false;
+    }
+    d.buffer.assign(std::istreambuf_iterator<char>(file),
+        std::istreambuf_iterator<char>());
+    d.data = d.buffer.data();
+    d.length = d.buffer.size();
+  }
+
+  if (d.length < sizeof(LogFileHeader) ||
+      std::memcmp(d.data, kFileMagic, sizeof(kFileMagic)) != 0 ||
+      load<LogFileHeader>(d.data).version != kVersion)
+  {
+    ignerr << "[" << _path << "] isn't a topic log" << std::endl;
+    this->Close();
+    return false;
+  }
+
+  if (!d.ReadIndex())
+  {
+    ignwarn << "Topic log [" << _path << "] wasn't closed, indexing it"
+            << std::endl;
+    d.Recover();
+  }
+
+  for (const auto &chunk : d.chunks)
+    d.count += chunk.count;
+
+  this->Seek(this->StartTime());
+  return true;
+}
+
+/////////////////////////////////////////////////
+void TopicLogReader::Close()
+{
+  auto &d = *this->dataPtr;
+#ifndef _WIN32
+  if (d.mapping)
+    munmap(d.mapping, d.length);
+  d.mapping = nullptr;
+#endif
+  d.buffer.clear();
+  d.buffer.shrink_to_fit();
+  d.data = nullptr;
+  d.length = 0;
+  d.chunks.clear();
+  d.topics.clear();
+  d.count = 0;
+  d.cursor = LogCursor();
+}
+
+/////////////////////////////////////////////////
+bool TopicLogReader::IsOpen() const
+{
+  return this->dataPtr->data != nullptr;
+}
+
+/////////////////////////////////////////////////
+uint64_t TopicLogReader::Count() const
+{
+  return this->dataPtr->count;
+}
+
+/////////////////////////////////////////////////
+int64_t TopicLogReader::StartTime() const
+{
+  auto &chunks = this->dataPtr->chunks;
+  return chunks.empty() ? 0 : chunks.front().first;
+}
+
+/////////////////////////////////////////////////
+int64_t TopicLogReader::EndTime() const
+{
+  auto &chunks = this->dataPtr->chunks;
+  return chunks.empty() ? 0 : chunks.back().last;
+}
+
+/////////////////////////////////////////////////
+std::vector<std::string> TopicLogReader::Topics() const
+{
+  std::vector<std::string> names;
+  for (const auto &topic : this->dataPtr->topics)
+  {
+    if (std::find(names.begin(), names.end(), topic.name) == names.end())
+      names.push_back(topic.name);
+  }
+  return names;
+}
+
+/////////////////////////////////////////////////
+bool TopicLogReader::Seek(const int64_t _time)
+{
+  auto &d = *this->dataPtr;
+
+  // First chunk which doesn't end before the time
+  auto chunkIt = std::partition_point(d.chunks.begin(), d.chunks.end(),
+      [&_time](const LogIndexEntry &_chunk)
+      {
+        return _chunk.last < _time;
+      });
+
+  d.cursor.chunk = static_cast<std::size_t>(chunkIt - d.chunks.begin());
+  d.cursor.offset = chunkIt == d.chunks.end() ? 0 :
+      chunkIt->offset + sizeof(LogChunkHeader);
+
+  // Then through that chunk only
+  int64_t time;
+  while (this->PeekTime(time))
+  {
+    if (time >= _time)
+      return true;
+    d.Advance(d.cursor, nullptr);
+  }
+  return false;
+}
+
+/////////////////////////////////////////////////
+bool TopicLogReader::Next(TopicLogRecord &_record)
+{
+  return this->dataPtr->Advance(this->dataPtr->cursor, &_record);
+}
+
+/////////////////////////////////////////////////
+bool TopicLogReader::PeekTime(int64_t &_time) const
+{
+  auto cursor = this->dataPtr->cursor;
+  TopicLogRecord record;
+  if (!this->dataPtr->Advance(cursor, &record))
+    return false;
+  _time = record.time;
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool TopicLogReaderPrivate::ReadIndex()
+{
+  if (this->length < sizeof(LogFileHeader) + sizeof(LogFileFooter))
+    return false;
+
+  auto footer = load<LogFileFooter>(
+      this->data + this->length - sizeof(LogFileFooter));
+  if (std::memcmp(footer.magic, kFooterMagic, sizeof(kFooterMagic)) != 0)
+    return false;
+
+  const char *pos = this->data + footer.index;
+  const char *end = this->data + this->length - sizeof(LogFileFooter);
+  if (footer.index < sizeof(LogFileHeader) ||
+      footer.index > this->length - sizeof(LogFileFooter))
+  {
+    return false;
+  }
+
+  auto read = [&pos, &end](void *_value, const std::size_t _size)
+  {
+    if (static_cast<std::size_t>(end - pos) < _size)
+      return false;
+    std::memcpy(_value, pos, _size);
+    pos += _size;
+    return true;
+  };
+  auto readString = [&](std::string &_value)
+  {
+    uint32_t size;
+    if (!read(&size, sizeof(size)) ||
+        static_cast<std::size_t>(end - pos) < size)
+    {
+      return false;
+    }
+    _value.assign(pos, size);
+    pos += size;
+    return true;
+  };
+
+  uint32_t magic, chunkCount;
+  if (!read(&magic, sizeof(magic)) || magic != kIndexMagic ||
+      !read(&chunkCount, sizeof(chunkCount)) ||
+      static_cast<std::size_t>(end - pos) / sizeof(LogIndexEntry) <
+      chunkCount)
+  {
+    return false;
+  }
+
+  std::vector<LogIndexEntry> index(chunkCount);
+  for (auto &entry : index)
+  {
+    read(&entry, sizeof(entry));
+    if (entry.offset < sizeof(LogFileHeader) ||
+        entry.offset + sizeof(LogChunkHeader) > footer.index ||
+        load<LogChunkHeader>(this->data + entry.offset).size >
+        footer.index - entry.offset - sizeof(LogChunkHeader))
+    {
+      return false;
+    }
+  }
+
+  uint32_t topicCount;
+  if (!read(&topicCount, sizeof(topicCount)))
+    return false;
+  std::vector<LogTopic> topicList(topicCount);
+  for (auto &topic : topicList)
+  {
+    if (!readString(topic.name) || !readString(topic.type))
+      return false;
+  }
+
+  this->chunks = std::move(index);
+  this->topics = std::move(topicList);
+  return true;
+}
+
+/////////////////////////////////////////////////
+void TopicLogReaderPrivate::Recover()
+{
+  this->chunks.clear();
+  this->topics.clear();
+
+  uint64_t offset = sizeof(LogFileHeader);
+  while (offset + sizeof(LogChunkHeader) <= this->length)
+  {
+    auto header = load<LogChunkHeader>(this->data + offset);
+    auto records = offset + sizeof(LogChunkHeader);
+    if (header.magic != kChunkMagic ||
+        header.size > this->length - records)
+    {
+      break;
+    }
+
+    // Definitions are needed even where no index refers to them
+    uint64_t pos = records;
+    while (pos + sizeof(LogRecordHeader) <= records + header.size)
+    {
+      auto record = load<LogRecordHeader>(this->data + pos);
+      pos += sizeof(LogRecordHeader);
+      if (record.size > records + header.size - pos)
+        break;
+      if (record.topic & kDefinitionFlag)
+        this->Define(record, this->data + pos);
+      pos += record.size;
+    }
+
+    LogIndexEntry entry{};
+    entry.offset = offset;
+    entry.first = header.first;
+    entry.last = header.last;
+    entry.count = header.count;
+    this->chunks.push_back(entry);
+
+    offset = records + header.size;
+  }
+}
+
+/////////////////////////////////////////////////
+void TopicLogReaderPrivate::Define(const LogRecordHeader &_header,
+    const char *_data)
+{
+  auto id = _header.topic & ~kDefinitionFlag;
+  std::string definition(_data, _header.size);
+  auto separator = definition.find('\0');
+  if (separator == std::string::npos)
+    return;
+
+  if (this->topics.size() <= id)
+    this->topics.resize(id + 1);
+  this->topics[id].name = definition.substr(0, separator);
+  this->topics[id].type = definition.substr(separator + 1);
+}
+
+/////////////////////////////////////////////////
+bool TopicLogReaderPrivate::Settle(LogCursor &_cursor) const
+{
+  while (_cursor.chunk < this->chunks.size())
+  {
+    const auto &chunk = this->chunks[_cursor.chunk];
+    auto records = chunk.offset + sizeof(LogChunkHeader);
+    auto end = records + load<LogChunkHeader>(this->data + chunk.offset).size;
+    if (_cursor.offset < records)
+      _cursor.offset = records;
+    if (_cursor.offset + sizeof(LogRecordHeader) <= end)
+      return true;
+
+    ++_cursor.chunk;
+    _cursor.offset = 0;
+  }
+  return false;
+}
+
+/////////////////////////////////////////////////
+bool TopicLogReaderPrivate::Advance(LogCursor &_cursor,
+    TopicLogRecord *_record) const
+{
+  while (this->Settle(_cursor))
+  {
+    const auto &chunk = this->chunks[_cursor.chunk];
+    auto end = chunk.offset + sizeof(LogChunkHeader) +
+        load<LogChunkHeader>(this->data + chunk.offset).size;
+
+    auto header = load<LogRecordHeader>(this->data + _cursor.offset);
+    auto payload = _cursor.offset + sizeof(LogRecordHeader);
+    if (header.size > end - payload)
+    {
+      // Damaged, skip the rest of the chunk
+      _cursor.offset = end;
+      continue;
+    }
+    _cursor.offset = payload + header.size;
+
+    if ((header.topic & kDefinitionFlag) ||
+        header.topic >= this->topics.size())
+    {
+      continue;
+    }
+
+    if (_record)
+    {
+      const auto &topic = this->topics[header.topic];
+      _record->time = header.time;
+      _record->topic = &topic.name;
+      _record->type = &topic.type;
+      _record->data = this->data + payload;
+      _record->size = header.size;
+    }
+    return true;
+  }
+  return false;
+}
+
+/////////////////////////////////////////////////
+TopicLogRecorder::TopicLogRecorder()
+  : dataPtr(new TopicLogRecorderPrivate)
+{
+}
+
+/////////////////////////////////////////////////
+TopicLogRecorder::~TopicLogRecorder()
+{
+  this->Stop();
+}
+
+/////////////////////////////////////////////////
+bool TopicLogRecorder::Start(const std::string &_path)
+{
+  this->Stop();
+
+  auto writer = this->dataPtr->writer;
+  if (!writer->Open(_path))
+    return false;
+
+  this->dataPtr->tap = SubscriptionHub::Instance()->Tap(
+      [writer](const std::string &_topic, const std::string &_type,
+               const char *_data, const std::size_t _size)
+      {
+        auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        writer->Write(now, _topic, _type, _data, _size);
+      });
+  return true;
+}
+
+/////////////////////////////////////////////////
+void TopicLogRecorder::Stop()
+{
+  if (this->dataPtr->tap == 0)
+    return;
+
+  SubscriptionHub::Instance()->Untap(this->dataPtr->tap);
+  this->dataPtr->tap = 0;
+  this->dataPtr->writer->Close();
+}
+
+/////////////////////////////////////////////////
+bool TopicLogRecorder::Recording() const
+{
+  return this->dataPtr->tap != 0;
+}
+
+/////////////////////////////////////////////////
+uint64_t TopicLogRecorder::Count() const
+{
+  return this->dataPtr->writer->Count();
+}
+
+/////////////////////////////////////////////////
+TopicLogPlayer::TopicLogPlayer()
+  : dataPtr(new TopicLogPlayerPrivate)
+{
+  this->dataPtr->timer.setInterval(kPlayInterval);
+  this->dataPtr->timer.setTimerType(Qt::PreciseTimer);
+  this->connect(&this->dataPtr->timer, &QTimer::timeout, this,
+      &TopicLogPlayer::OnTimer);
+}
+
+/////////////////////////////////////////////////
+TopicLogPlayer::~TopicLogPlayer()
+{
+  this->Close();
+}
+
+/////////////////////////////////////////////////
+bool TopicLogPlayer::Open(const std::string &_path)
+{
+  this->Close();
+  if (!this->dataPtr->reader.Open(_path))
+    return false;
+
+  SubscriptionHub::Instance()->SetLive(false);
+  this->dataPtr->time = this->dataPtr->reader.StartTime();
+  return true;
+}
+
+/////////////////////////////////////////////////
+void TopicLogPlayer::Close()
+{
+  this->dataPtr->timer.stop();
+  if (!this->dataPtr->reader.IsOpen())
+    return;
+
+  this->dataPtr->reader.Close();
+  SubscriptionHub::Instance()->SetLive(true);
+}
+
+/////////////////////////////////////////////////
+const TopicLogReader &TopicLogPlayer::Reader() const
+{
+  return this->dataPtr->reader;
+}
+
+/////////////////////////////////////////////////
+void TopicLogPlayer::Play()
+{
+  int64_t next;
+  if (this->dataPtr->timer.isActive() ||
+      !this->dataPtr->reader.PeekTime(next))
+  {
+    return;
+  }
+
+  this->dataPtr->base = this->dataPtr->time;
+  this->dataPtr->elapsed.start();
+  this->dataPtr->timer.start();
+}
+
+/////////////////////////////////////////////////
+void TopicLogPlayer::Pause()
+{
+  this->dataPtr->timer.stop();
+}
+
+/////////////////////////////////////////////////
+bool TopicLogPlayer::Playing() const
+{
+  return this->dataPtr->timer.isActive();
+}
+
+/////////////////////////////////////////////////
+bool TopicLogPlayer::Step()
+{
+  TopicLogRecord record;
+  if (!this->dataPtr->reader.Next(record))
+    return false;
+
+  SubscriptionHub::Instance()->Inject(*record.topic, *record.type,
+      record.data, record.size);
+  this->dataPtr->time = record.time;
+  emit this->TimeChanged(record.time);
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool TopicLogPlayer::Seek(const int64_t _time)
+{
+  this->dataPtr->time = _time;
+  this->dataPtr->base = _time;
+  this->dataPtr->elapsed.start();
+  return this->dataPtr->reader.Seek(_time);
+}
+
+/////////////////////////////////////////////////
+void TopicLogPlayer::SetRate(const double _rate)
+{
+  if (!(_rate > 0.0))
+    return;
+
+  // Carry on from where playing is, at the new rate
+  if (this->dataPtr->timer.isActive())
+  {
+    this->dataPtr->base += static_cast<int64_t>(
+        this->dataPtr->elapsed.nsecsElapsed() * this->dataPtr->rate);
+    this->dataPtr->elapsed.start();
+  }
+  this->dataPtr->rate = _rate;
+}
+
+/////////////////////////////////////////////////
+double TopicLogPlayer::Rate() const
+{
+  return this->dataPtr->rate;
+}
+
+/////////////////////////////////////////////////
+int64_t TopicLogPlayer::Time() const
+{
+  return this->dataPtr->time;
+}
+
+/////////////////////////////////////////////////
+void TopicLogPlayer::OnTimer()
+{
+  auto &d = *this->dataPtr;
+  auto due = d.base +
+      static_cast<int64_t>(d.elapsed.nsecsElapsed() * d.rate);
+
+  auto hub = SubscriptionHub::Instance();
+  int delivered{0};
+  int64_t next;
+  while (delivered < kMaxDeliveries && d.reader.PeekTime(next) &&
+         next <= due)
+  {
+    TopicLogRecord record;
+    d.reader.Next(record);
+    hub->Inject(*record.topic, *record.type, record.data, record.size);
+    d.time = record.time;
+    ++delivered;
+  }
+
+  if (delivered > 0)
+    emit this->TimeChanged(d.time);
+
+  if (!d.reader.PeekTime(next))
+  {
+    d.timer.stop();
+    emit this->Finished();
+  }
+}
@@ -0,0 +1,245 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
+#include <ignition/msgs/int32.pb.h>
+#include <ignition/transport/Node.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/gui/SubscriptionHub.hh"
+#include "ignition/gui/TopicLog.hh"
+
+using namespace ignition;
+using namespace gui;
+
+/////////////////////////////////////////////////
+/// \brief Path of a log in the build directory.
+/// \param[in] _name File name
+/// \return Path
+std::string LogPath(const std::string &_name)
+{
+  return common::joinPaths(PROJECT_BINARY_PATH, _name);
+}
+
+/////////////////////////////////////////////////
+/// \brief Write a log with a message every 10 ns from time 1000, the
+/// payload being the index of the message.
+/// \param[in] _path Path of the log
+/// \param[in] _count Number of messages
+/// \param[in] _writer Writer, with small chunks
+void WriteLog(const std::string &_path, const int _count,
+    TopicLogWriter &_writer)
+{
+  ASSERT_TRUE(_writer.Open(_path));
+  for (int i = 0; i < _count; ++i)
+  {
+    auto payload = std::to_string(i);
+    ASSERT_TRUE(_writer.Write(1000 + i * 10, i % 3 == 0 ? "/b" : "/a",
+        "ignition.msgs.StringMsg", payload.data(), payload.size()));
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(TopicLogTest, WriteRead)
+{
+  common::Console::SetVerbosity(4);
+  auto path = LogPath("topic_log_test.tlog");
+
+  {
+    TopicLogWriter writer(200);
+    EXPECT_FALSE(writer.IsOpen());
+    EXPECT_FALSE(writer.Write(0, "/a", "type", "x", 1));
+
+    WriteLog(path, 1000, writer);
+    EXPECT_TRUE(writer.IsOpen());
+
+    // Times never go back
+    EXPECT_TRUE(writer.Write(5, "/a", "ignition.msgs.StringMsg", "x", 1));
+    EXPECT_EQ(1001u, writer.Count());
+  }
+
+  TopicLogReader reader;
+  EXPECT_FALSE(reader.IsOpen());
+  ASSERT_TRUE(reader.Open(path));
+  EXPECT_TRUE(reader.IsOpen());
+  EXPECT_EQ(1001u, reader.Count());
+  EXPECT_EQ(1000, reader.StartTime());
+  EXPECT_EQ(10990, reader.EndTime());
+  EXPECT_EQ(std::vector<std::string>({"/b", "/a"}), reader.Topics());
+
+  TopicLogRecord record;
+  int count{0};
+  int64_t last{0};
+  while (reader.Next(record))
+  {
+    EXPECT_LE(last, record.time);
+    last = record.time;
+    ++count;
+  }
+  EXPECT_EQ(1001, count);
+  EXPECT_EQ(10990, last);
+
+  // Seeking lands on the first message at or after the time
+  ASSERT_TRUE(reader.Seek(5995));
+  int64_t time;
+  ASSERT_TRUE(reader.PeekTime(time));
+  EXPECT_EQ(6000, time);
+  ASSERT_TRUE(reader.Next(record));
+  EXPECT_EQ(6000, record.time);
+  EXPECT_EQ("500", std::string(record.data, record.size));
+  EXPECT_EQ("/a", *record.topic);
+  EXPECT_EQ("ignition.msgs.StringMsg", *record.type);
+
+  ASSERT_TRUE(reader.Seek(0));
+  ASSERT_TRUE(reader.Next(record));
+  EXPECT_EQ("0", std::string(record.data, record.size));
+  EXPECT_EQ("/b", *record.topic);
+
+  EXPECT_FALSE(reader.Seek(20000));
+  EXPECT_FALSE(reader.Next(record));
+
+  reader.Close();
+  EXPECT_FALSE(reader.IsOpen());
+  EXPECT_EQ(0u, reader.Count());
+
+  EXPECT_FALSE(reader.Open(LogPath("no_such_log.tlog")));
+  std::ofstream(LogPath("not_a_log.tlog")) << "not a log";
+  EXPECT_FALSE(reader.Open(LogPath("not_a_log.tlog")));
+}
+
+/////////////////////////////////////////////////
+TEST(TopicLogTest, Recover)
+{
+  common::Console::SetVerbosity(4);
+  auto path = LogPath("topic_log_recover_test.tlog");
+  auto cutPath = LogPath("topic_log_cut_test.tlog");
+
+  // Copied while the writer is still open, as if it crashed
+  {
+    TopicLogWriter writer(200);
+    WriteLog(path, 1000, writer);
+
+    std::ifstream in(path, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(in)),
+        std::istreambuf_iterator<char>());
+
+    // Halfway through the last chunk
+    std::ofstream out(cutPath, std::ios::binary);
+    out.write(contents.data(), contents.size() - 50);
+  }
+
+  TopicLogReader reader;
+  ASSERT_TRUE(reader.Open(cutPath));
+  EXPECT_GT(reader.Count(), 900u);
+  EXPECT_LT(reader.Count(), 1000u);
+  EXPECT_EQ(2u, reader.Topics().size());
+
+  uint64_t count{0};
+  TopicLogRecord record;
+  while (reader.Next(record))
+    ++count;
+  EXPECT_EQ(reader.Count(), count);
+
+  ASSERT_TRUE(reader.Seek(3000));
+  ASSERT_TRUE(reader.Next(record));
+  EXPECT_EQ("200", std::string(record.data, record.size));
+}
+
+/////////////////////////////////////////////////
+TEST(TopicLogTest, RecordReplay)
+{
+  common::Console::SetVerbosity(4);
+  setenv("IGN_PARTITION", "ign-gui-topic-log-test", 1);
+  auto path = LogPath("topic_log_replay_test.tlog");
+
+  auto hub = SubscriptionHub::Instance();
+  std::atomic<int> received{0};
+  std::atomic<int> last{0};
+  auto id = hub->Subscribe<msgs::Int32>("/topic_log_test",
+      [&](const std::shared_ptr<const msgs::Int32> &_msg)
+  {
+    last = _msg->data();
+    ++received;
+  });
+  ASSERT_NE(0u, id);
+
+  // Record what the hub receives
+  TopicLogRecorder recorder;
+  EXPECT_FALSE(recorder.Recording());
+  ASSERT_TRUE(recorder.Start(path));
+  EXPECT_TRUE(recorder.Recording());
+
+  transport::Node node;
+  auto pub = node.Advertise<msgs::Int32>("/topic_log_test");
+  msgs::Int32 msg;
+  for (int i = 0; i < 50 && last != 3; ++i)
+  {
+    msg.set_data(received < 3 ? received + 1 : 3);
+    pub.Publish(msg);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+  ASSERT_EQ(3, last);
+
+  recorder.Stop();
+  EXPECT_FALSE(recorder.Recording());
+  auto recorded = recorder.Count();
+  EXPECT_GE(recorded, 3u);
+
+  // Replayed to the same subscriber, without messages from transport
+  TopicLogPlayer player;
+  ASSERT_TRUE(player.Open(path));
+  EXPECT_FALSE(hub->Live());
+  EXPECT_EQ(recorded, player.Reader().Count());
+  EXPECT_EQ(player.Reader().StartTime(), player.Time());
+
+  received = 0;
+  msg.set_data(100);
+  pub.Publish(msg);
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  EXPECT_EQ(0, received);
+
+  EXPECT_TRUE(player.Step());
+  EXPECT_EQ(1, received);
+  EXPECT_EQ(1, last);
+
+  EXPECT_TRUE(player.Seek(player.Reader().EndTime()));
+  EXPECT_TRUE(player.Step());
+  EXPECT_EQ(3, last);
+  EXPECT_FALSE(player.Step());
+
+  player.SetRate(4.0);
+  EXPECT_DOUBLE_EQ(4.0, player.Rate());
+  player.SetRate(-1.0);
+  EXPECT_DOUBLE_EQ(4.0, player.Rate());
+
+  player.Close();
+  EXPECT_TRUE(hub->Live());
+
+  hub->Unsubscribe(id);
+}
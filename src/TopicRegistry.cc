@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include <ignition/transport/Node.hh>
+
+#include "ignition/gui/Application.hh"
+#include "ignition/gui/TopicRegistry.hh"
+
+namespace ignition
+{
+  namespace gui
+  {
+    class TopicRegistryPrivate
+    {
+      /// \brief Walk the graph, only asking for the types of new topics.
+      /// \return True if topics were added or removed.
+      public: bool Update();
+
+      /// \brief Keep updating until stopped.
+      /// \param[in] _registry Registry to notify of changes.
+      public: void Run(TopicRegistry *_registry);
+
+      /// \brief Time between updates
+      public: static constexpr std::chrono::seconds kPeriod{1};
+
+      /// \brief Node used to query the graph, only used by Update
+      public: transport::Node node;
+
+      /// \brief Topic names to message types
+      public: std::map<std::string, std::string> topics;
+
+      /// \brief Message types to the topics carrying them
+      public: std::map<std::string, std::set<std::string>> types;
+
+      /// \brief Protects topics and types
+      public: mutable std::mutex mutex;
+
+      /// \brief Protects the flags below
+      public: std::mutex runMutex;
+
+      /// \brief Wakes the thread up for a refresh or to stop
+      public: std::condition_variable runCv;
+
+      /// \brief Set to update before the period is over
+      public: bool refresh{false};
+
+      /// \brief Set to end the thread
+      public: bool stop{false};
+
+      /// \brief Thread running updates
+      public: std::thread thread;
+    };
+  }
+}
+
+using namespace ignition;
+using namespace gui;
+
+/// \brief Registry returned by Instance, null until first used
+static TopicRegistry *g_registry{nullptr};
+
+/// \brief Protects g_registry
+static std::mutex g_registryMutex;
+
+/////////////////////////////////////////////////
+TopicRegistry::TopicRegistry()
+  : dataPtr(new TopicRegistryPrivate)
+{
+  this->dataPtr->Update();
+  this->dataPtr->thread = std::thread(&TopicRegistryPrivate::Run,
+      this->dataPtr.get(), this);
+}
+
+/////////////////////////////////////////////////
+TopicRegistry::~TopicRegistry()
+{
+  {
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    if (g_registry == this)
+      g_registry = nullptr;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->runMutex);
+    this->dataPtr->stop = true;
+  }
+  this->dataPtr->runCv.notify_one();
+  if (this->dataPtr->thread.joinable())
+    this->dataPtr->thread.join();
+}
+
+/////////////////////////////////////////////////
+TopicRegistry *TopicRegistry::Instance()
+{
+  std::lock_guard<std::mutex> lock(g_registryMutex);
+  if (!g_registry)
+  {
+    g_registry = new TopicRegistry();
+
+    // Go away with the application, so the next one walks the graph again
+    // with its own partition
+    if (App())
+      g_registry->setParent(App());
+  }
+  return g_registry;
+}
+
+/////////////////////////////////////////////////
+std::map<std::string, std::string> TopicRegistry::Topics() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->topics;
+}
+
+/////////////////////////////////////////////////
+std::vector<std::string> TopicRegistry::Topics(
+    const std::string &_msgType) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto it = this->dataPtr->types.find(_msgType);
+  if (it == this->dataPtr->types.end())
+    return {};
+  return {it->second.begin(), it->second.end()};
+}
+
+/////////////////////////////////////////////////
+std::string TopicRegistry::MsgType(const std::string &_topic) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto it = this->dataPtr->topics.find(_topic);
+  if (it == this->dataPtr->topics.end())
+    return std::string();
+  return it->second;
+}
+
+/////////////////////////////////////////////////
+void TopicRegistry::Refresh()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->runMutex);
+    this->dataPtr->refresh = true;
+  }
+  this->dataPtr->runCv.notify_one();
+}
+
+/////////////////////////////////////////////////
+bool TopicRegistryPrivate::Update()
+{
+  std::vector<std::string> current;
+  this->node.TopicList(current);
+  std::sort(current.begin(), current.end());
+
+  std::map<std::string, std::string> known;
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    known = this->topics;
+  }
+
+  // Only new topics are worth a TopicInfo call, done without holding the
+  // lock so queries aren't held up
+  std::map<std::string, std::string> added;
+  for (const auto &topic : current)
+  {
+    if (known.count(topic))
+      continue;
+
+    std::vector<transport::MessagePublisher> publishers;
+    this->node.TopicInfo(topic, publishers);
+    if (publishers.empty())
+      continue;
+
+    added[topic] = publishers[0].MsgTypeName();
+  }
+
+  std::vector<std::string> removed;
+  for (const auto &it : known)
+  {
+    if (!std::binary_search(current.begin(), current.end(), it.first))
+      removed.push_back(it.first);
+  }
+
+  if (added.empty() && removed.empty())
+    return false;
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+  for (const auto &topic : removed)
+  {
+    auto it = this->topics.find(topic);
+    auto typeIt = this->types.find(it->second);
+    typeIt->second.erase(topic);
+    if (typeIt->second.empty())
+      this->types.erase(typeIt);
+    this->topics.erase(it);
+  }
+  for (const auto &it : added)
+  {
+    this->topics[it.first] = it.second;
+    this->types[it.second].insert(it.first);
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////
+void TopicRegistryPrivate::Run(TopicRegistry *_registry)
+{
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> lock(this->runMutex);
+      this->runCv.wait_for(lock, kPeriod, [this]
+      {
+        return this->refresh || this->stop;
+      });
+      if (this->stop)
+        return;
+      this->refresh = false;
+    }
+
+    if (this->Update())
+      _registry->TopicsChanged();
+  }
+}
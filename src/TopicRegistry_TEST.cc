@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+#include <ignition/common/Console.hh>
+#include <ignition/msgs/image.pb.h>
+#include <ignition/msgs/int32.pb.h>
+#include <ignition/transport/Node.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/gui/TopicRegistry.hh"
+
+using namespace ignition;
+using namespace gui;
+
+/////////////////////////////////////////////////
+TEST(TopicRegistryTest, Topics)
+{
+  common::Console::SetVerbosity(4);
+  setenv("IGN_PARTITION", "ign-gui-topic-registry-test", 1);
+
+  transport::Node node;
+  auto pubImage = node.Advertise<msgs::Image>("/image_topic");
+  auto pubInt = node.Advertise<msgs::Int32>("/int_topic");
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+  // The first use walks the graph
+  auto registry = TopicRegistry::Instance();
+  ASSERT_NE(nullptr, registry);
+  EXPECT_EQ(registry, TopicRegistry::Instance());
+
+  auto images = registry->Topics("ignition.msgs.Image");
+  ASSERT_EQ(1u, images.size());
+  EXPECT_EQ("/image_topic", images[0]);
+
+  EXPECT_EQ("ignition.msgs.Int32", registry->MsgType("/int_topic"));
+  EXPECT_TRUE(registry->MsgType("/none").empty());
+  EXPECT_TRUE(registry->Topics("ignition.msgs.Boolean").empty());
+  EXPECT_EQ(2u, registry->Topics().size());
+
+  // Later changes are picked up in the background
+  auto pubImage2 = node.Advertise<msgs::Image>("/image_topic_2");
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  registry->Refresh();
+
+  bool found{false};
+  for (int i = 0; i < 30 && !found; ++i)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    found = registry->Topics("ignition.msgs.Image").size() == 2u;
+  }
+  EXPECT_TRUE(found);
+  EXPECT_EQ("ignition.msgs.Image", registry->MsgType("/image_topic_2"));
+}
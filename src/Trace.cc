@@ -0,0 +1,226 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Util.hh>
+
+#include "ignition/gui/Trace.hh"
+
+namespace ignition
+{
+  namespace gui
+  {
+    /// \brief An event on the timeline
+    struct TraceEvent
+    {
+      /// \brief Event name
+      std::string name;
+
+      /// \brief Event category
+      std::string category;
+
+      /// \brief Phase, 'X' for complete events and 'i' for instant ones
+      char phase;
+
+      /// \brief Microseconds since tracing started
+      std::int64_t ts;
+
+      /// \brief Duration in microseconds, for complete events
+      std::int64_t dur;
+
+      /// \brief Thread the event happened on
+      int tid;
+    };
+  }
+}
+
+using namespace ignition;
+using namespace gui;
+
+/// \brief Whether tracing is on
+static std::atomic<bool> g_traceEnabled{false};
+
+/// \brief File events are written to
+static std::string g_tracePath;
+
+/// \brief Time tracing started
+static Trace::Clock::time_point g_traceOrigin;
+
+/// \brief Events recorded so far
+static std::vector<TraceEvent> g_traceEvents;
+
+/// \brief Protects the globals above, except g_traceEnabled
+static std::mutex g_traceMutex;
+
+/////////////////////////////////////////////////
+/// \brief Get a small number identifying the calling thread.
+/// \return Thread ID, starting at 1
+static int TraceThreadId()
+{
+  static std::atomic<int> lastId{0};
+  thread_local int id = ++lastId;
+  return id;
+}
+
+/////////////////////////////////////////////////
+/// \brief Get microseconds since tracing started.
+/// \param[in] _time Time point
+/// \return Microseconds
+static std::int64_t TraceMicroseconds(const Trace::Clock::time_point &_time)
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+      _time - g_traceOrigin).count();
+}
+
+/////////////////////////////////////////////////
+/// \brief Write a string as a JSON string.
+/// \param[in] _out Stream to write to
+/// \param[in] _str String
+static void WriteJsonString(std::ostream &_out, const std::string &_str)
+{
+  _out << '"';
+  for (auto c : _str)
+  {
+    if (c == '"' || c == '\\')
+      _out << '\\' << c;
+    else if (static_cast<unsigned char>(c) < 0x20)
+      _out << ' ';
+    else
+      _out << c;
+  }
+  _out << '"';
+}
+
+/////////////////////////////////////////////////
+void Trace::Start(const std::string &_path)
+{
+  std::lock_guard<std::mutex> lock(g_traceMutex);
+  g_tracePath = _path;
+  if (!g_traceEnabled)
+  {
+    g_traceOrigin = Clock::now();
+    g_traceEnabled = true;
+  }
+}
+
+/////////////////////////////////////////////////
+bool Trace::Enabled()
+{
+  static bool fromEnv = []()
+  {
+    std::string path;
+    if (common::env("IGN_GUI_TRACE", path) && !path.empty())
+      Trace::Start(path);
+    return true;
+  }();
+  (void)fromEnv;
+
+  return g_traceEnabled;
+}
+
+/////////////////////////////////////////////////
+void Trace::Complete(const std::string &_name, const std::string &_category,
+    const Clock::time_point &_start, const Clock::time_point &_end)
+{
+  if (!Enabled())
+    return;
+
+  auto tid = TraceThreadId();
+  std::lock_guard<std::mutex> lock(g_traceMutex);
+  auto ts = TraceMicroseconds(_start);
+  g_traceEvents.push_back({_name, _category, 'X', ts,
+      TraceMicroseconds(_end) - ts, tid});
+}
+
+/////////////////////////////////////////////////
+void Trace::Instant(const std::string &_name, const std::string &_category)
+{
+  if (!Enabled())
+    return;
+
+  auto now = Clock::now();
+  auto tid = TraceThreadId();
+  std::lock_guard<std::mutex> lock(g_traceMutex);
+  g_traceEvents.push_back({_name, _category, 'i', TraceMicroseconds(now), 0,
+      tid});
+}
+
+/////////////////////////////////////////////////
+bool Trace::Write()
+{
+  if (!Enabled())
+    return false;
+
+  std::lock_guard<std::mutex> lock(g_traceMutex);
+
+  std::ofstream out(g_tracePath, std::ios::out | std::ios::trunc);
+  if (!out)
+  {
+    ignerr << "Unable to write trace to [" << g_tracePath << "]"
+           << std::endl;
+    return false;
+  }
+
+  out << "{\"traceEvents\":[";
+  for (std::size_t i = 0; i < g_traceEvents.size(); ++i)
+  {
+    const auto &event = g_traceEvents[i];
+    out << (i == 0 ? "\n" : ",\n") << "{\"name\":";
+    WriteJsonString(out, event.name);
+    out << ",\"cat\":";
+    WriteJsonString(out, event.category);
+    out << ",\"ph\":\"" << event.phase << "\",\"ts\":" << event.ts;
+    if (event.phase == 'X')
+      out << ",\"dur\":" << event.dur;
+    else
+      out << ",\"s\":\"g\"";
+    out << ",\"pid\":1,\"tid\":" << event.tid << "}";
+  }
+  out << "\n]}\n";
+
+  ignmsg << "Wrote trace to [" << g_tracePath << "]" << std::endl;
+  return true;
+}
+
+/////////////////////////////////////////////////
+TraceScope::TraceScope(const std::string &_name,
+    const std::string &_category)
+{
+  if (!Trace::Enabled())
+    return;
+
+  this->name = _name;
+  this->category = _category;
+  this->start = Trace::Clock::now();
+}
+
+/////////////////////////////////////////////////
+TraceScope::~TraceScope()
+{
+  if (this->name.empty())
+    return;
+
+  Trace::Complete(this->name, this->category, this->start,
+      Trace::Clock::now());
+}
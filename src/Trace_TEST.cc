@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+#include "ignition/gui/Trace.hh"
+
+using namespace ignition;
+using namespace gui;
+
+/////////////////////////////////////////////////
+TEST(TraceTest, Write)
+{
+  common::Console::SetVerbosity(4);
+
+  // Off by default
+  EXPECT_FALSE(Trace::Enabled());
+  EXPECT_FALSE(Trace::Write());
+  {
+    TraceScope scope("Ignored", "test");
+  }
+
+  auto path = common::joinPaths(PROJECT_BINARY_PATH, "test", "trace.json");
+  common::createDirectories(common::parentPath(path));
+  Trace::Start(path);
+  EXPECT_TRUE(Trace::Enabled());
+
+  {
+    TraceScope scope("LoadLib [\"quoted\"]", "plugin");
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  }
+  std::thread([]()
+  {
+    TraceScope scope("Other thread", "plugin");
+  }).join();
+  Trace::Instant("First frame", "startup");
+  ASSERT_TRUE(Trace::Write());
+
+  std::ifstream in(path);
+  std::stringstream buffer;
+  buffer << in.rdbuf();
+  auto json = buffer.str();
+
+  EXPECT_EQ(0u, json.find("{\"traceEvents\":["));
+  EXPECT_EQ(std::string::npos, json.find("Ignored"));
+  EXPECT_NE(std::string::npos,
+      json.find("\"name\":\"LoadLib [\\\"quoted\\\"]\",\"cat\":\"plugin\","
+                "\"ph\":\"X\""));
+  EXPECT_NE(std::string::npos, json.find("\"name\":\"Other thread\""));
+  EXPECT_NE(std::string::npos,
+      json.find("\"name\":\"First frame\",\"cat\":\"startup\",\"ph\":\"i\""));
+  EXPECT_NE(std::string::npos, json.find("\"tid\":2"));
+
+  common::removeFile(path);
+}
@@ -18,18 +18,26 @@
 #include <string.h>
 
 #include <iostream>
+#include <string>
+#include <vector>
 
 #include <ignition/common/Console.hh>
+#include <ignition/common/SystemPaths.hh>
 
 #include "ignition/gui/Application.hh"
 #include "ignition/gui/config.hh"
 #include "ignition/gui/Export.hh"
 #include "ignition/gui/ign.hh"
 #include "ignition/gui/MainWindow.hh"
+#include "ignition/gui/PluginIndex.hh"
+#include "ignition/gui/Trace.hh"
 
 int g_argc = 1;
 char **g_argv = new char *[g_argc];
 
+/// \brief Environment variable with plugin paths, as used by Application
+static const char kPluginPathEnv[] = "IGN_GUI_PLUGIN_PATH";
+
 //////////////////////////////////////////////////
 extern "C" IGNITION_GUI_VISIBLE char *ignitionVersion()
 {
@@ -39,24 +47,72 @@ extern "C" IGNITION_GUI_VISIBLE char *ignitionVersion()
 //////////////////////////////////////////////////
 extern "C" IGNITION_GUI_VISIBLE void cmdPluginList()
 {
-  ignition::gui::Application app(g_argc, g_argv);
-
-  auto pluginsList = app.PluginList();
-  for (auto const &path : pluginsList)
+  // Only the index is needed, not an application
+  auto &index = ignition::gui::PluginIndex::Instance();
+  for (auto const &dir :
+      ignition::gui::PluginIndex::PluginDirectories(kPluginPathEnv))
   {
-    std::cout << path.first << std::endl;
+    std::cout << dir << std::endl;
 
-    for (unsigned int i = 0; i < path.second.size(); ++i)
+    auto libraries = index.Libraries(dir);
+    for (unsigned int i = 0; i < libraries.size(); ++i)
     {
-      if (i == path.second.size() - 1)
-        std::cout << "└── " << path.second[i] << std::endl;
+      if (i == libraries.size() - 1)
+        std::cout << "└── " << libraries[i] << std::endl;
       else
-        std::cout << "├── " << path.second[i] << std::endl;
+        std::cout << "├── " << libraries[i] << std::endl;
     }
 
-    if (path.second.empty())
+    if (libraries.empty())
       std::cout << "└── No plugins" << std::endl;
   }
+  index.Save();
+}
+
+//////////////////////////////////////////////////
+extern "C" IGNITION_GUI_VISIBLE void cmdPluginInfo(const char *_filename)
+{
+  auto &index = ignition::gui::PluginIndex::Instance();
+  auto dirs = ignition::gui::PluginIndex::PluginDirectories(kPluginPathEnv);
+
+  ignition::common::SystemPaths systemPaths;
+  systemPaths.SetPluginPathEnv(kPluginPathEnv);
+  for (const auto &dir : dirs)
+    systemPaths.AddPluginPaths(dir);
+
+  auto path = index.FindLibrary(dirs, _filename, [&]()
+  {
+    return systemPaths.FindSharedLibrary(_filename);
+  });
+  if (path.empty())
+  {
+    std::cerr << "Couldn't find plugin [" << _filename << "]" << std::endl;
+    index.Save();
+    return;
+  }
+
+  std::vector<std::string> names;
+  std::vector<std::string> resources;
+  if (index.Inspect(path, names, resources))
+  {
+    std::cout << path << std::endl << "Plugins:" << std::endl;
+    for (const auto &name : names)
+      std::cout << "  " << name << std::endl;
+    std::cout << "Resources:" << std::endl;
+    for (const auto &resource : resources)
+      std::cout << "  " << resource << std::endl;
+  }
+  index.Save();
+}
+
+//////////////////////////////////////////////////
+extern "C" IGNITION_GUI_VISIBLE void cmdWarmCache()
+{
+  ignition::gui::Application app(g_argc, g_argv);
+
+  auto compiled = app.WarmCache();
+  std::cout << "Compiled " << compiled << " QML files into "
+            << ignition::gui::Application::CacheDirectory() << std::endl;
 }
 
 //////////////////////////////////////////////////
@@ -78,11 +134,14 @@ extern "C" IGNITION_GUI_VISIBLE void cmdConfig(const char *_config)
 {
   ignition::gui::Application app(g_argc, g_argv);
 
-  if (!app.findChild<ignition::gui::MainWindow *>())
+  if (!app.MainWin())
   {
     return;
   }
 
+  // Show the window right away and fill in cards as their QML is created
+  app.SetIncubationBudget(5);
+
   if (!app.LoadConfig(std::string(_config)))
   {
     return;
@@ -97,16 +156,25 @@ extern "C" IGNITION_GUI_VISIBLE void cmdVerbose(const char *_verbosity)
   ignition::common::Console::SetVerbosity(std::atoi(_verbosity));
 }
 
+//////////////////////////////////////////////////
+extern "C" IGNITION_GUI_VISIBLE void cmdTrace(const char *_path)
+{
+  ignition::gui::Trace::Start(_path);
+}
+
 //////////////////////////////////////////////////
 extern "C" IGNITION_GUI_VISIBLE void cmdEmptyWindow()
 {
   ignition::gui::Application app(g_argc, g_argv);
 
-  if (!app.findChild<ignition::gui::MainWindow *>())
+  if (!app.MainWin())
   {
     return;
   }
 
+  // Show the window right away and fill in cards as their QML is created
+  app.SetIncubationBudget(5);
+
   app.LoadDefaultConfig();
 
   app.exec();
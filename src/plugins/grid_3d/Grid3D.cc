@@ -16,11 +16,17 @@
 */
 
 #include <algorithm>
+#include <fstream>
+#include <map>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
+#include <ignition/common/Util.hh>
 #include <ignition/math/Color.hh>
 #include <ignition/math/Pose3.hh>
 #include <ignition/plugin/Register.hh>
@@ -33,9 +39,11 @@
 #endif
 
 #include <ignition/rendering/Grid.hh>
+#include <ignition/rendering/Material.hh>
 #include <ignition/rendering/RenderEngine.hh>
 #include <ignition/rendering/RenderingIface.hh>
 #include <ignition/rendering/Scene.hh>
+#include <ignition/rendering/ShaderParams.hh>
 #include <ignition/rendering/Visual.hh>
 
 #ifdef _MSC_VER
@@ -60,6 +68,43 @@ static const ignition::math::Pose3d kDefaultPose{ignition::math::Pose3d::Zero};
 static const ignition::math::Color kDefaultColor{
     ignition::math::Color(0.7f, 0.7f, 0.7f, 1.0f)};
 
+// Default line width of shader grids, in pixels
+static const double kDefaultLineWidth{1.0};
+
+/// \brief Vertex shader of shader grids, passing on positions in the grid
+/// frame
+static const char kGridVertexShader[] = R"(#version 130
+uniform mat4 worldviewproj_matrix;
+uniform float size;
+in vec4 vertex;
+out vec2 gridPos;
+void main()
+{
+  gl_Position = worldviewproj_matrix * vertex;
+  gridPos = vertex.xy * size;
+}
+)";
+
+/// \brief Fragment shader of shader grids, drawing lines where the grid
+/// position is close to a multiple of the cell length
+static const char kGridFragmentShader[] = R"(#version 130
+uniform float cell_length;
+uniform float line_width;
+uniform float color_r;
+uniform float color_g;
+uniform float color_b;
+in vec2 gridPos;
+out vec4 fragColor;
+void main()
+{
+  vec2 cell = gridPos / cell_length;
+  vec2 pixels = abs(fract(cell - 0.5) - 0.5) / fwidth(cell);
+  if (min(pixels.x, pixels.y) > line_width * 0.5)
+    discard;
+  fragColor = vec4(color_r, color_g, color_b, 1.0);
+}
+)";
+
 namespace ignition
 {
 namespace gui
@@ -83,6 +128,28 @@ namespace plugins
 
     /// \brief Grid ambient color
     math::Color color{kDefaultColor};
+
+    /// \brief True to draw the lines with a shader on a single plane
+    bool shader{false};
+
+    /// \brief Line width of shader grids, in pixels
+    double lineWidth{kDefaultLineWidth};
+  };
+
+  /// \brief A grid in the scene
+  struct GridHandle
+  {
+    /// \brief Current configuration
+    GridInfo info;
+
+    /// \brief Visual holding the grid
+    rendering::VisualPtr visual;
+
+    /// \brief Line geometry, null for shader grids
+    rendering::GridPtr grid;
+
+    /// \brief Material, shared by line grids of the same color
+    rendering::MaterialPtr material;
   };
 
   class Grid3DPrivate
@@ -104,8 +171,54 @@ namespace plugins
     /// \brief Grids received from config file on startup
     public: std::vector<GridInfo> startupGrids;
 
+    /// \brief Create a grid in the scene.
+    /// \param[in] _scene Scene
+    /// \param[in] _info Grid configuration
+    /// \return The new grid
+    public: GridHandle CreateGrid(const rendering::ScenePtr &_scene,
+        const GridInfo &_info);
+
+    /// \brief Get the material of line grids of a color, creating it the
+    /// first time.
+    /// \param[in] _scene Scene
+    /// \param[in] _color Color
+    /// \return Material
+    public: rendering::MaterialPtr LineMaterial(
+        const rendering::ScenePtr &_scene, const math::Color &_color);
+
+    /// \brief Set the shader parameters of a shader grid from its
+    /// configuration.
+    /// \param[in] _handle Grid
+    public: static void UpdateShaderParams(GridHandle &_handle);
+
+    /// \brief Apply the changes made since the last frame. Called on the
+    /// render thread.
+    public: void ApplyChanges();
+
     /// \brief Keep track of grids we currently found on the scene
     public: std::vector<rendering::GridPtr> grids;
+
+    /// \brief Grids created by this plugin. Only used on the render thread.
+    public: std::vector<GridHandle> handles;
+
+    /// \brief Materials shared by line grids, keyed by color
+    public: std::map<std::tuple<float, float, float, float>,
+        rendering::MaterialPtr> lineMaterials;
+
+    /// \brief Path to the vertex shader of shader grids, empty until
+    /// written
+    public: std::string vertexShaderPath;
+
+    /// \brief Path to the fragment shader of shader grids, empty until
+    /// written
+    public: std::string fragmentShaderPath;
+
+    /// \brief Changes waiting for the render thread: grid index, widget
+    /// name and value
+    public: std::vector<std::tuple<int, std::string, QVariant>> changes;
+
+    /// \brief Protects changes
+    public: std::mutex changesMutex;
   };
 }
 }
@@ -115,6 +228,180 @@ using namespace ignition;
 using namespace gui;
 using namespace plugins;
 
+/////////////////////////////////////////////////
+/// \brief Write a shader to the shader cache, unless it's there already.
+/// \param[in] _filename File name
+/// \param[in] _source Shader source
+/// \return Path to the shader, empty if it couldn't be written
+static std::string WriteShader(const std::string &_filename,
+    const std::string &_source)
+{
+  std::string home;
+  common::env(IGN_HOMEDIR, home);
+  auto dir = common::joinPaths(home, ".ignition", "gui", "shaders");
+  auto path = common::joinPaths(dir, _filename);
+
+  std::ifstream in(path);
+  std::stringstream current;
+  current << in.rdbuf();
+  if (in && current.str() == _source)
+    return path;
+
+  common::createDirectories(dir);
+  std::ofstream out(path, std::ios::out | std::ios::trunc);
+  if (!out || !(out << _source))
+  {
+    ignerr << "Unable to write shader [" << path << "]" << std::endl;
+    return std::string();
+  }
+  return path;
+}
+
+/////////////////////////////////////////////////
+rendering::MaterialPtr Grid3DPrivate::LineMaterial(
+    const rendering::ScenePtr &_scene, const math::Color &_color)
+{
+  auto key = std::make_tuple(_color.R(), _color.G(), _color.B(), _color.A());
+  auto &mat = this->lineMaterials[key];
+  if (!mat)
+  {
+    mat = _scene->CreateMaterial();
+    mat->SetAmbient(_color);
+  }
+  return mat;
+}
+
+/////////////////////////////////////////////////
+GridHandle Grid3DPrivate::CreateGrid(const rendering::ScenePtr &_scene,
+    const GridInfo &_info)
+{
+  GridHandle handle;
+  handle.info = _info;
+
+  // Custom shaders are only supported by ogre 1
+  if (handle.info.shader && this->engineName != "ogre")
+  {
+    ignwarn << "Shader grids aren't supported by engine ["
+            << this->engineName << "], drawing lines instead." << std::endl;
+    handle.info.shader = false;
+  }
+
+  if (handle.info.shader && this->vertexShaderPath.empty())
+  {
+    this->vertexShaderPath = WriteShader("grid_3d.vert", kGridVertexShader);
+    this->fragmentShaderPath = WriteShader("grid_3d.frag",
+        kGridFragmentShader);
+  }
+  if (handle.info.shader &&
+      (this->vertexShaderPath.empty() || this->fragmentShaderPath.empty()))
+  {
+    handle.info.shader = false;
+  }
+
+  handle.visual = _scene->CreateVisual();
+  _scene->RootVisual()->AddChild(handle.visual);
+  handle.visual->SetLocalPose(handle.info.pose);
+
+  if (handle.info.shader)
+  {
+    // A single plane, whatever the number of cells
+    handle.visual->AddGeometry(_scene->CreatePlane());
+
+    handle.material = _scene->CreateMaterial();
+    handle.material->SetVertexShader(this->vertexShaderPath);
+    handle.material->SetFragmentShader(this->fragmentShaderPath);
+    handle.visual->SetMaterial(handle.material, false);
+    UpdateShaderParams(handle);
+  }
+  else
+  {
+    handle.grid = _scene->CreateGrid();
+    handle.grid->SetCellCount(handle.info.cellCount);
+    handle.grid->SetVerticalCellCount(handle.info.vertCellCount);
+    handle.grid->SetCellLength(handle.info.cellLength);
+    handle.visual->AddGeometry(handle.grid);
+
+    handle.material = this->LineMaterial(_scene, handle.info.color);
+    handle.visual->SetMaterial(handle.material, false);
+  }
+
+  return handle;
+}
+
+/////////////////////////////////////////////////
+void Grid3DPrivate::UpdateShaderParams(GridHandle &_handle)
+{
+  const auto &info = _handle.info;
+  auto size = info.cellCount * info.cellLength;
+  _handle.visual->SetLocalScale(size, size, 1.0);
+
+  auto vertexParams = _handle.material->VertexShaderParams();
+  (*vertexParams)["size"] = static_cast<float>(size);
+
+  auto fragmentParams = _handle.material->FragmentShaderParams();
+  (*fragmentParams)["cell_length"] = static_cast<float>(info.cellLength);
+  (*fragmentParams)["line_width"] = static_cast<float>(info.lineWidth);
+  (*fragmentParams)["color_r"] = info.color.R();
+  (*fragmentParams)["color_g"] = info.color.G();
+  (*fragmentParams)["color_b"] = info.color.B();
+}
+
+/////////////////////////////////////////////////
+void Grid3DPrivate::ApplyChanges()
+{
+  std::vector<std::tuple<int, std::string, QVariant>> toApply;
+  {
+    std::lock_guard<std::mutex> lock(this->changesMutex);
+    toApply.swap(this->changes);
+  }
+
+  for (const auto &change : toApply)
+  {
+    auto index = std::get<0>(change);
+    const auto &type = std::get<1>(change);
+    const auto &value = std::get<2>(change);
+    if (index < 0 || index >= static_cast<int>(this->handles.size()))
+      continue;
+
+    auto &handle = this->handles[index];
+    auto &info = handle.info;
+    if (type == "cellCountWidget")
+      info.cellCount = value.toInt();
+    else if (type == "vertCellCountWidget")
+      info.vertCellCount = value.toInt();
+    else if (type == "cellLengthWidget")
+      info.cellLength = value.toDouble();
+    else if (type == "colorWidget")
+    {
+      auto color = value.value<QColor>();
+      info.color.Set(color.redF(), color.greenF(), color.blueF(),
+          color.alphaF());
+    }
+    else
+      continue;
+
+    // Shader grids only need new parameters
+    if (info.shader)
+    {
+      UpdateShaderParams(handle);
+      continue;
+    }
+
+    // Line grids keep their geometry, which only rebuilds its lines
+    if (type == "cellCountWidget")
+      handle.grid->SetCellCount(info.cellCount);
+    else if (type == "vertCellCountWidget")
+      handle.grid->SetVerticalCellCount(info.vertCellCount);
+    else if (type == "cellLengthWidget")
+      handle.grid->SetCellLength(info.cellLength);
+    else
+    {
+      handle.material = this->LineMaterial(handle.visual->Scene(), info.color);
+      handle.visual->SetMaterial(handle.material, false);
+    }
+  }
+}
+
 /////////////////////////////////////////////////
 Grid3D::Grid3D()
   : Plugin(), dataPtr(new Grid3DPrivate)
@@ -176,6 +463,12 @@ void Grid3D::LoadConfig(const tinyxml2::XMLElement *_pluginElem)
         colorStr >> gridInfo.color;
       }
 
+      if (auto shaderElem = insertElem->FirstChildElement("shader"))
+        shaderElem->QueryBoolText(&gridInfo.shader);
+
+      if (auto widthElem = insertElem->FirstChildElement("line_width"))
+        widthElem->QueryDoubleText(&gridInfo.lineWidth);
+
       this->dataPtr->startupGrids.push_back(gridInfo);
     }
   }
@@ -230,25 +523,16 @@ void Grid3D::Initialize()
     }
     else
     {
-      auto root = scene->RootVisual();
-
       // Initial grids
       for (const auto &g : this->dataPtr->startupGrids)
-      {
-        auto grid = scene->CreateGrid();
-        grid->SetCellCount(g.cellCount);
-        grid->SetVerticalCellCount(g.vertCellCount);
-        grid->SetCellLength(g.cellLength);
-
-        auto gridVis = scene->CreateVisual();
-        root->AddChild(gridVis);
-        gridVis->SetLocalPose(g.pose);
-        gridVis->AddGeometry(grid);
-
-        auto mat = scene->CreateMaterial();
-        mat->SetAmbient(g.color);
-        gridVis->SetMaterial(mat);
-      }
+        this->dataPtr->handles.push_back(this->dataPtr->CreateGrid(scene, g));
+
+      // Later changes are applied on the render thread too
+      this->connect(this->dataPtr->quickWindow,
+          &QQuickWindow::beforeRendering, this, [this]()
+          {
+            this->dataPtr->ApplyChanges();
+          }, Qt::DirectConnection);
     }
   }
 
@@ -423,30 +707,17 @@ void Grid3D::Refresh()
 }
 
 /////////////////////////////////////////////////
-void Grid3D::OnChange(const QVariant & /*_value*/)
+void Grid3D::OnChange(const QVariant &_value)
 {
-//  auto gridName =
-//      this->sender()->property("gridName").toString().toStdString();
-//  auto type = this->sender()->objectName().toStdString();
-//
-//  for (auto grid : this->dataPtr->grids)
-//  {
-//    if (grid->Name() != gridName)
-//      continue;
-//
-//    if (type == "cellCountWidget")
-//      grid->SetCellCount(_value.toInt());
-//    else if (type == "vertCellCountWidget")
-//      grid->SetVerticalCellCount(_value.toInt());
-//    else if (type == "cellLengthWidget")
-//      grid->SetCellLength(_value.toDouble());
-//    else if (type == "poseWidget")
-//      grid->Parent()->SetWorldPose(_value.value<math::Pose3d>());
-//    else if (type == "colorWidget")
-//      grid->Material()->SetAmbient(_value.value<math::Color>());
-//
-//    break;
-//  }
+  // Widgets tell which grid and property they edit, the render thread
+  // applies the change in place before the next frame
+  auto sender = this->sender();
+  if (nullptr == sender)
+    return;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->changesMutex);
+  this->dataPtr->changes.emplace_back(sender->property("gridIndex").toInt(),
+      sender->objectName().toStdString(), _value);
 }
 
 /////////////////////////////////////////////////
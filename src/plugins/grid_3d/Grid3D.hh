@@ -54,6 +54,16 @@ namespace plugins
   ///   * \<cell_length\> : Length of each cell, defaults to 1.
   ///   * \<pose\> : Grid pose, defaults to the origin.
   ///   * \<color\> : Grid color, defaults to (0.7, 0.7, 0.7, 1.0)
+  ///   * \<shader\> : True to draw the lines with a shader on a single
+  ///                  plane, so the cost doesn't grow with the cell count.
+  ///                  Vertical cells aren't drawn. Only supported by the
+  ///                  'ogre' engine, defaults to false.
+  ///   * \<line_width\> : Line width of shader grids in pixels, defaults
+  ///                      to 1.
+  ///
+  /// Line grids of the same color share a material. Changes to grids
+  /// are applied in place on the render thread, shader grids only updating
+  /// their shader parameters.
   class Grid3D : public Plugin
   {
     Q_OBJECT
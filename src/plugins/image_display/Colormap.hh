@@ -0,0 +1,264 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGNITION_GUI_PLUGINS_IMAGEDISPLAY_COLORMAP_HH_
+#define IGNITION_GUI_PLUGINS_IMAGEDISPLAY_COLORMAP_HH_
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace ignition
+{
+namespace gui
+{
+namespace plugins
+{
+  /// \brief Colors single channel images are shown with
+  enum class Colormap
+  {
+    /// \brief Black to white
+    GRAY = 0,
+
+    /// \brief Google's Turbo, dark blue to dark red
+    TURBO,
+
+    /// \brief Matlab's Jet, dark blue to dark red
+    JET,
+
+    /// \brief Matplotlib's Inferno, black to light yellow
+    INFERNO,
+
+    /// \brief Number of colormaps
+    COUNT
+  };
+
+  /// \brief Lookup tables turning gray levels and 16 bit values into
+  /// colors. Colors are packed as 0xffRRGGBB, like QRgb, so that rows of
+  /// them can be written straight into QImage::Format_RGB32 images.
+  namespace ColormapLut
+  {
+    /// \brief Get a colormap's name, as used in configs.
+    /// \param[in] _colormap Colormap
+    /// \return Lowercase name
+    inline std::string Name(const Colormap _colormap)
+    {
+      switch (_colormap)
+      {
+        case Colormap::TURBO:
+          return "turbo";
+        case Colormap::JET:
+          return "jet";
+        case Colormap::INFERNO:
+          return "inferno";
+        default:
+          return "gray";
+      }
+    }
+
+    /// \brief Get a colormap from its name.
+    /// \param[in] _name Lowercase name
+    /// \param[out] _colormap Colormap, unchanged if the name is unknown
+    /// \return False if the name is unknown
+    inline bool FromName(const std::string &_name, Colormap &_colormap)
+    {
+      for (int i = 0; i < static_cast<int>(Colormap::COUNT); ++i)
+      {
+        if (Name(static_cast<Colormap>(i)) == _name)
+        {
+          _colormap = static_cast<Colormap>(i);
+          return true;
+        }
+      }
+      return false;
+    }
+
+    /// \brief Compute a color. Used to fill the tables, use Table instead.
+    /// \param[in] _colormap Colormap
+    /// \param[in] _t Position along the colormap, in [0, 1]
+    /// \return Packed color
+    inline std::uint32_t Compute(const Colormap _colormap, const double _t)
+    {
+      double r = _t;
+      double g = _t;
+      double b = _t;
+      const double t = _t;
+      switch (_colormap)
+      {
+        case Colormap::TURBO:
+          // Polynomial approximation published along with the table
+          r = 0.13572138 + t * (4.61539260 + t * (-42.66032258 +
+              t * (132.13108234 + t * (-152.94239396 + t * 59.28637943))));
+          g = 0.09140261 + t * (2.19418839 + t * (4.84296658 +
+              t * (-14.18503333 + t * (4.27729857 + t * 2.82956604))));
+          b = 0.10667330 + t * (12.64194608 + t * (-60.58204836 +
+              t * (110.36276771 + t * (-89.90310912 + t * 27.34824973))));
+          break;
+        case Colormap::JET:
+          r = 1.5 - std::abs(4.0 * t - 3.0);
+          g = 1.5 - std::abs(4.0 * t - 2.0);
+          b = 1.5 - std::abs(4.0 * t - 1.0);
+          break;
+        case Colormap::INFERNO:
+          // Polynomial fit of the matplotlib table
+          r = 0.0002189403691192265 + t * (0.1065134194856116 +
+              t * (11.60249308247187 + t * (-41.70399613139459 +
+              t * (77.16293569942700 + t * (-71.31942824499214 +
+              t * 25.13112622477341)))));
+          g = 0.001651004631001012 + t * (0.5639564367884091 +
+              t * (-3.972853965665698 + t * (17.43639888205313 +
+              t * (-33.40235894210092 + t * (32.62606426397723 +
+              t * -12.24266895238567)))));
+          b = -0.01948089843709184 + t * (3.932712388889277 +
+              t * (-15.94239410629140 + t * (44.35414519872813 +
+              t * (-81.80730925738993 + t * (73.20951985803202 +
+              t * -23.07032500287172)))));
+          break;
+        default:
+          break;
+      }
+
+      auto channel = [](const double _c)
+      {
+        return static_cast<std::uint32_t>(
+            std::min(std::max(_c, 0.0), 1.0) * 255.0 + 0.5);
+      };
+      return 0xff000000u | (channel(r) << 16) | (channel(g) << 8) |
+          channel(b);
+    }
+
+    /// \brief Get the colors of the 256 gray levels for a colormap. Tables
+    /// are computed once, the first time they're asked for.
+    /// \param[in] _colormap Colormap
+    /// \return Colors indexed by gray level
+    inline const std::array<std::uint32_t, 256> &Table(
+        const Colormap _colormap)
+    {
+      using Tables = std::array<std::array<std::uint32_t, 256>,
+          static_cast<std::size_t>(Colormap::COUNT)>;
+      static const Tables tables = []
+      {
+        Tables t;
+        for (std::size_t c = 0u; c < t.size(); ++c)
+        {
+          for (std::size_t i = 0u; i < 256u; ++i)
+            t[c][i] = Compute(static_cast<Colormap>(c), i / 255.0);
+        }
+        return t;
+      }();
+
+      auto index = static_cast<std::size_t>(_colormap);
+      return tables[index < tables.size() ? index : 0u];
+    }
+
+    /// \brief Color gray levels.
+    /// \param[in] _gray Gray levels
+    /// \param[in] _count Number of gray levels
+    /// \param[in] _table Colors indexed by gray level, see Table
+    /// \param[out] _out Colors, _count of them
+    inline void GrayToColor(const std::uint8_t *_gray,
+        const std::size_t _count, const std::array<std::uint32_t, 256> &_table,
+        std::uint32_t *_out)
+    {
+      for (std::size_t i = 0u; i < _count; ++i)
+        _out[i] = _table[_gray[i]];
+    }
+  }
+
+  /// \brief Colors of all 16 bit values across a range, so that 16 bit
+  /// images are colored with one lookup per pixel. Values below the range
+  /// get the first color and values above it the last one.
+  ///
+  /// The table is only rebuilt when the colormap changes, or when the range
+  /// moves by more than kTolerance of its width, so that images whose range
+  /// jitters from frame to frame don't rebuild it every time.
+  class RangeLut
+  {
+    /// \brief Fraction of the range width either end of the range may move
+    /// by before the table is rebuilt.
+    public: static constexpr double kTolerance = 0.01;
+
+    /// \brief Make sure the table is for a colormap and a range.
+    /// \param[in] _colormap Colormap
+    /// \param[in] _min Value shown with the first color
+    /// \param[in] _max Value shown with the last color
+    /// \return True if the table was rebuilt
+    public: bool Update(const Colormap _colormap, const std::uint16_t _min,
+        const std::uint16_t _max)
+    {
+      double tolerance = kTolerance * (_max > _min ? _max - _min : 0);
+      if (!this->table.empty() && _colormap == this->colormap &&
+          std::abs(static_cast<double>(_min) - this->min) <= tolerance &&
+          std::abs(static_cast<double>(_max) - this->max) <= tolerance)
+      {
+        return false;
+      }
+
+      this->colormap = _colormap;
+      this->min = _min;
+      this->max = _max;
+      this->table.resize(65536u);
+
+      const auto &colors = ColormapLut::Table(_colormap);
+      double scale = _max > _min ? 255.0 / (_max - _min) : 0.0;
+      for (std::size_t v = 0u; v < this->table.size(); ++v)
+      {
+        double level = (static_cast<double>(v) - _min) * scale;
+        auto i = static_cast<int>(level + 0.5);
+        this->table[v] = colors[std::min(std::max(i, 0), 255)];
+      }
+      return true;
+    }
+
+    /// \brief Color 16 bit values.
+    /// \param[in] _data Unsigned 16 bit values, possibly unaligned
+    /// \param[in] _count Number of values
+    /// \param[out] _out Colors, _count of them
+    public: void Map(const void *_data, const std::size_t _count,
+        std::uint32_t *_out) const
+    {
+      auto src = static_cast<const char *>(_data);
+      for (std::size_t i = 0u; i < _count; ++i)
+      {
+        std::uint16_t v;
+        std::memcpy(&v, src + i * sizeof(v), sizeof(v));
+        _out[i] = this->table[v];
+      }
+    }
+
+    /// \brief Colormap of the table
+    private: Colormap colormap{Colormap::GRAY};
+
+    /// \brief Range of the table
+    private: double min{0.0};
+
+    /// \brief Range of the table
+    private: double max{0.0};
+
+    /// \brief Colors of each value, empty until the first update
+    private: std::vector<std::uint32_t> table;
+  };
+}
+}
+}
+
+#endif
@@ -0,0 +1,379 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGNITION_GUI_PLUGINS_IMAGEDISPLAY_IMAGECONVERSION_HH_
+#define IGNITION_GUI_PLUGINS_IMAGEDISPLAY_IMAGECONVERSION_HH_
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IGN_GUI_IMAGECONVERSION_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define IGN_GUI_IMAGECONVERSION_NEON
+#include <arm_neon.h>
+#endif
+
+namespace ignition
+{
+namespace gui
+{
+namespace plugins
+{
+  /// \brief Kernels turning single channel images into 8 bit grayscale.
+  ///
+  /// Each conversion is two passes: a reduction finding the range of the
+  /// image, then a normalization writing gray levels straight into the
+  /// destination rows. Sources are read in place, they don't need to be
+  /// aligned. The kernels use SSE2 on x86 and NEON on 64 bit ARM, which are
+  /// always available there, and plain loops anywhere else. The plain loops
+  /// are also available as ImageConversion::Scalar*, and the kernels match
+  /// them to within one gray level.
+  namespace ImageConversion
+  {
+    /// \brief Read an element from a possibly unaligned buffer.
+    /// \param[in] _data Buffer.
+    /// \param[in] _i Element index.
+    /// \return The element.
+    template <typename T>
+    inline T Load(const void *_data, const std::size_t _i)
+    {
+      T value;
+      std::memcpy(&value, static_cast<const char *>(_data) + _i * sizeof(T),
+          sizeof(T));
+      return value;
+    }
+
+    /// \brief Gray level of a depth relative to the farthest depth.
+    /// \param[in] _depth Depth.
+    /// \param[in] _factor 255 divided by the farthest depth.
+    /// \return 255 at zero depth down to 0 at the farthest depth, 0 beyond
+    /// it and for NaN depths.
+    inline std::uint8_t DepthGray(const float _depth, const float _factor)
+    {
+      float v = 255.0f - _depth * _factor;
+      // Also catches NaN
+      if (!(v > 0.0f))
+        return 0u;
+      if (v > 255.0f)
+        v = 255.0f;
+      return static_cast<std::uint8_t>(v + 0.5f);
+    }
+
+    /// \brief Gray level of a value within a range.
+    /// \param[in] _value Value.
+    /// \param[in] _min Lower end of the range.
+    /// \param[in] _scale 255 divided by the range.
+    /// \return 0 at the lower end up to 255 at the upper end, clamped
+    /// outside of it.
+    inline std::uint8_t RangeGray(const std::uint16_t _value,
+        const std::uint16_t _min, const float _scale)
+    {
+      if (_value <= _min)
+        return 0u;
+      float v = static_cast<float>(_value - _min) * _scale + 0.5f;
+      return v < 255.0f ? static_cast<std::uint8_t>(v) : 255u;
+    }
+
+    /// \brief Plain version of MaxDepth.
+    /// \param[in] _data Floats.
+    /// \param[in] _count Number of floats.
+    /// \return Largest finite value, or zero if there's none above zero.
+    inline float ScalarMaxDepth(const void *_data, const std::size_t _count)
+    {
+      float max = 0.0f;
+      for (std::size_t i = 0u; i < _count; ++i)
+      {
+        float d = Load<float>(_data, i);
+        if (d > max && !std::isinf(d))
+          max = d;
+      }
+      return max;
+    }
+
+    /// \brief Plain version of DepthToGray.
+    /// \param[in] _data Floats.
+    /// \param[in] _count Number of floats.
+    /// \param[in] _factor 255 divided by the farthest depth.
+    /// \param[out] _out Gray levels, _count of them.
+    inline void ScalarDepthToGray(const void *_data, const std::size_t _count,
+        const float _factor, std::uint8_t *_out)
+    {
+      for (std::size_t i = 0u; i < _count; ++i)
+        _out[i] = DepthGray(Load<float>(_data, i), _factor);
+    }
+
+    /// \brief Plain version of MinMax.
+    /// \param[in] _data Unsigned 16 bit values.
+    /// \param[in] _count Number of values.
+    /// \param[out] _min Smallest value, the type's max if there are none.
+    /// \param[out] _max Largest value, zero if there are none.
+    inline void ScalarMinMax(const void *_data, const std::size_t _count,
+        std::uint16_t &_min, std::uint16_t &_max)
+    {
+      _min = std::numeric_limits<std::uint16_t>::max();
+      _max = 0u;
+      for (std::size_t i = 0u; i < _count; ++i)
+      {
+        auto v = Load<std::uint16_t>(_data, i);
+        if (v < _min)
+          _min = v;
+        if (v > _max)
+          _max = v;
+      }
+    }
+
+    /// \brief Plain version of RangeToGray.
+    /// \param[in] _data Unsigned 16 bit values.
+    /// \param[in] _count Number of values.
+    /// \param[in] _min Lower end of the range, values outside of it are
+    /// clamped.
+    /// \param[in] _scale 255 divided by the range.
+    /// \param[out] _out Gray levels, _count of them.
+    inline void ScalarRangeToGray(const void *_data, const std::size_t _count,
+        const std::uint16_t _min, const float _scale, std::uint8_t *_out)
+    {
+      for (std::size_t i = 0u; i < _count; ++i)
+        _out[i] = RangeGray(Load<std::uint16_t>(_data, i), _min, _scale);
+    }
+
+    /// \brief Find the farthest finite depth of a depth image.
+    /// \param[in] _data Floats.
+    /// \param[in] _count Number of floats.
+    /// \return Largest finite value, or zero if there's none above zero.
+    inline float MaxDepth(const void *_data, const std::size_t _count)
+    {
+      auto src = static_cast<const float *>(_data);
+      std::size_t i = 0u;
+      float max = 0.0f;
+#if defined(IGN_GUI_IMAGECONVERSION_SSE2)
+      // Infinite and NaN values fail the comparison and are masked to zero
+      const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+      const __m128 inf = _mm_set1_ps(std::numeric_limits<float>::infinity());
+      __m128 m0 = _mm_setzero_ps();
+      __m128 m1 = _mm_setzero_ps();
+      for (; i + 8u <= _count; i += 8u)
+      {
+        __m128 a = _mm_loadu_ps(src + i);
+        __m128 b = _mm_loadu_ps(src + i + 4u);
+        a = _mm_and_ps(a, _mm_cmplt_ps(_mm_and_ps(a, absMask), inf));
+        b = _mm_and_ps(b, _mm_cmplt_ps(_mm_and_ps(b, absMask), inf));
+        m0 = _mm_max_ps(m0, a);
+        m1 = _mm_max_ps(m1, b);
+      }
+      m0 = _mm_max_ps(m0, m1);
+      m0 = _mm_max_ps(m0, _mm_movehl_ps(m0, m0));
+      m0 = _mm_max_ss(m0, _mm_shuffle_ps(m0, m0, 1));
+      max = _mm_cvtss_f32(m0);
+#elif defined(IGN_GUI_IMAGECONVERSION_NEON)
+      const float32x4_t inf =
+          vdupq_n_f32(std::numeric_limits<float>::infinity());
+      const float32x4_t zero = vdupq_n_f32(0.0f);
+      float32x4_t m0 = zero;
+      float32x4_t m1 = zero;
+      for (; i + 8u <= _count; i += 8u)
+      {
+        float32x4_t a = vld1q_f32(src + i);
+        float32x4_t b = vld1q_f32(src + i + 4u);
+        a = vbslq_f32(vcltq_f32(vabsq_f32(a), inf), a, zero);
+        b = vbslq_f32(vcltq_f32(vabsq_f32(b), inf), b, zero);
+        m0 = vmaxq_f32(m0, a);
+        m1 = vmaxq_f32(m1, b);
+      }
+      max = vmaxvq_f32(vmaxq_f32(m0, m1));
+#endif
+      float tail = ScalarMaxDepth(src + i, _count - i);
+      return tail > max ? tail : max;
+    }
+
+    /// \brief Convert depths to gray levels, near being white.
+    /// \param[in] _data Floats.
+    /// \param[in] _count Number of floats.
+    /// \param[in] _factor 255 divided by the farthest depth.
+    /// \param[out] _out Gray levels, _count of them.
+    inline void DepthToGray(const void *_data, const std::size_t _count,
+        const float _factor, std::uint8_t *_out)
+    {
+      auto src = static_cast<const float *>(_data);
+      std::size_t i = 0u;
+#if defined(IGN_GUI_IMAGECONVERSION_SSE2)
+      const __m128 factor = _mm_set1_ps(_factor);
+      const __m128 white = _mm_set1_ps(255.0f);
+      const __m128 half = _mm_set1_ps(0.5f);
+      const __m128 zero = _mm_setzero_ps();
+      auto gray = [&](const float *_src)
+      {
+        __m128 v = _mm_sub_ps(white, _mm_mul_ps(_mm_loadu_ps(_src), factor));
+        // max returns its second operand for NaN
+        v = _mm_min_ps(_mm_max_ps(v, zero), white);
+        return _mm_cvttps_epi32(_mm_add_ps(v, half));
+      };
+      for (; i + 16u <= _count; i += 16u)
+      {
+        __m128i lo = _mm_packs_epi32(gray(src + i), gray(src + i + 4u));
+        __m128i hi = _mm_packs_epi32(gray(src + i + 8u), gray(src + i + 12u));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(_out + i),
+            _mm_packus_epi16(lo, hi));
+      }
+#elif defined(IGN_GUI_IMAGECONVERSION_NEON)
+      const float32x4_t factor = vdupq_n_f32(_factor);
+      const float32x4_t white = vdupq_n_f32(255.0f);
+      const float32x4_t half = vdupq_n_f32(0.5f);
+      const float32x4_t zero = vdupq_n_f32(0.0f);
+      auto gray = [&](const float *_src)
+      {
+        float32x4_t v = vsubq_f32(white, vmulq_f32(vld1q_f32(_src), factor));
+        // maxnm returns the number for NaN
+        v = vminq_f32(vmaxnmq_f32(v, zero), white);
+        return vmovn_u32(vcvtq_u32_f32(vaddq_f32(v, half)));
+      };
+      for (; i + 16u <= _count; i += 16u)
+      {
+        uint16x8_t lo = vcombine_u16(gray(src + i), gray(src + i + 4u));
+        uint16x8_t hi = vcombine_u16(gray(src + i + 8u), gray(src + i + 12u));
+        vst1q_u8(_out + i, vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)));
+      }
+#endif
+      ScalarDepthToGray(src + i, _count - i, _factor, _out + i);
+    }
+
+    /// \brief Find the smallest and largest values in one pass.
+    /// \param[in] _data Unsigned 16 bit values.
+    /// \param[in] _count Number of values.
+    /// \param[out] _min Smallest value, the type's max if there are none.
+    /// \param[out] _max Largest value, zero if there are none.
+    inline void MinMax(const void *_data, const std::size_t _count,
+        std::uint16_t &_min, std::uint16_t &_max)
+    {
+      auto src = static_cast<const std::uint16_t *>(_data);
+      std::size_t i = 0u;
+      std::uint16_t min = std::numeric_limits<std::uint16_t>::max();
+      std::uint16_t max = 0u;
+#if defined(IGN_GUI_IMAGECONVERSION_SSE2)
+      // SSE2 only compares signed 16 bit ints, so flip the sign bit to map
+      // the unsigned range onto the signed one
+      const __m128i sign = _mm_set1_epi16(-0x8000);
+      __m128i mn = _mm_set1_epi16(0x7fff);
+      __m128i mx = _mm_set1_epi16(-0x8000);
+      for (; i + 8u <= _count; i += 8u)
+      {
+        __m128i v = _mm_xor_si128(_mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(src + i)), sign);
+        mn = _mm_min_epi16(mn, v);
+        mx = _mm_max_epi16(mx, v);
+      }
+      alignas(16) std::int16_t mins[8];
+      alignas(16) std::int16_t maxs[8];
+      _mm_store_si128(reinterpret_cast<__m128i *>(mins), mn);
+      _mm_store_si128(reinterpret_cast<__m128i *>(maxs), mx);
+      for (int j = 0; j < 8; ++j)
+      {
+        auto lo = static_cast<std::uint16_t>(mins[j] ^ -0x8000);
+        auto hi = static_cast<std::uint16_t>(maxs[j] ^ -0x8000);
+        if (lo < min)
+          min = lo;
+        if (hi > max)
+          max = hi;
+      }
+#elif defined(IGN_GUI_IMAGECONVERSION_NEON)
+      uint16x8_t mn = vdupq_n_u16(min);
+      uint16x8_t mx = vdupq_n_u16(max);
+      for (; i + 8u <= _count; i += 8u)
+      {
+        uint16x8_t v = vld1q_u16(src + i);
+        mn = vminq_u16(mn, v);
+        mx = vmaxq_u16(mx, v);
+      }
+      min = vminvq_u16(mn);
+      max = vmaxvq_u16(mx);
+#endif
+      ScalarMinMax(src + i, _count - i, _min, _max);
+      if (min < _min)
+        _min = min;
+      if (max > _max)
+        _max = max;
+    }
+
+    /// \brief Convert values to gray levels across a range.
+    /// \param[in] _data Unsigned 16 bit values.
+    /// \param[in] _count Number of values.
+    /// \param[in] _min Lower end of the range, values outside of it are
+    /// clamped.
+    /// \param[in] _scale 255 divided by the range.
+    /// \param[out] _out Gray levels, _count of them.
+    inline void RangeToGray(const void *_data, const std::size_t _count,
+        const std::uint16_t _min, const float _scale, std::uint8_t *_out)
+    {
+      auto src = static_cast<const std::uint16_t *>(_data);
+      std::size_t i = 0u;
+#if defined(IGN_GUI_IMAGECONVERSION_SSE2)
+      const __m128i min = _mm_set1_epi16(static_cast<std::int16_t>(_min));
+      const __m128i zero = _mm_setzero_si128();
+      const __m128 scale = _mm_set1_ps(_scale);
+      const __m128 half = _mm_set1_ps(0.5f);
+      auto gray = [&](const __m128i _v)
+      {
+        __m128 f = _mm_cvtepi32_ps(_v);
+        return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(f, scale), half));
+      };
+      for (; i + 16u <= _count; i += 16u)
+      {
+        __m128i a = _mm_subs_epu16(_mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(src + i)), min);
+        __m128i b = _mm_subs_epu16(_mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(src + i + 8u)), min);
+        __m128i lo = _mm_packs_epi32(gray(_mm_unpacklo_epi16(a, zero)),
+            gray(_mm_unpackhi_epi16(a, zero)));
+        __m128i hi = _mm_packs_epi32(gray(_mm_unpacklo_epi16(b, zero)),
+            gray(_mm_unpackhi_epi16(b, zero)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(_out + i),
+            _mm_packus_epi16(lo, hi));
+      }
+#elif defined(IGN_GUI_IMAGECONVERSION_NEON)
+      const uint16x8_t min = vdupq_n_u16(_min);
+      const float32x4_t scale = vdupq_n_f32(_scale);
+      const float32x4_t half = vdupq_n_f32(0.5f);
+      auto gray = [&](const uint16x4_t _v)
+      {
+        float32x4_t f = vcvtq_f32_u32(vmovl_u16(_v));
+        return vqmovn_u32(vcvtq_u32_f32(vaddq_f32(vmulq_f32(f, scale),
+            half)));
+      };
+      for (; i + 16u <= _count; i += 16u)
+      {
+        uint16x8_t a = vqsubq_u16(vld1q_u16(src + i), min);
+        uint16x8_t b = vqsubq_u16(vld1q_u16(src + i + 8u), min);
+        uint16x8_t lo = vcombine_u16(gray(vget_low_u16(a)),
+            gray(vget_high_u16(a)));
+        uint16x8_t hi = vcombine_u16(gray(vget_low_u16(b)),
+            gray(vget_high_u16(b)));
+        vst1q_u8(_out + i, vcombine_u8(vqmovn_u16(lo), vqmovn_u16(hi)));
+      }
+#endif
+      ScalarRangeToGray(src + i, _count - i, _min, _scale, _out + i);
+    }
+  }
+}
+}
+}
+
+#endif
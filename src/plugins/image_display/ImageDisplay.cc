@@ -20,16 +20,35 @@
 #include <QQuickImageProvider>
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <ignition/common/Console.hh>
 #include <ignition/common/Image.hh>
 #include <ignition/plugin/Register.hh>
-#include <ignition/transport/Node.hh>
 
 #include "ignition/gui/Application.hh"
+#include "ignition/gui/Metrics.hh"
+#include "ignition/gui/SharedImage.hh"
+#include "ignition/gui/SubscriptionHub.hh"
+#include "ignition/gui/TopicRegistry.hh"
+
+#include "Colormap.hh"
+#include "ImageConversion.hh"
+#include "ImageDisplayItem.hh"
+#include "ImageRange.hh"
+#include "PixelFormats.hh"
 
 namespace ignition
 {
@@ -37,6 +56,142 @@ namespace gui
 {
 namespace plugins
 {
+  /// \brief Recycles the pixel buffers of images handed to QML, so that
+  /// showing an image doesn't allocate. Images made by the pool give their
+  /// buffer back once the last copy of them is gone, from whichever thread
+  /// that happens on. Each buffer keeps the pool alive while it's out.
+  class ImageBufferPool
+    : public std::enable_shared_from_this<ImageBufferPool>
+  {
+    /// \brief Make an image which takes over a buffer filled elsewhere,
+    /// such as the data of a msg, without copying it.
+    /// \param[in,out] _data Pixel data, swapped with an unused buffer
+    /// \param[in] _width Width in pixels
+    /// \param[in] _height Height in pixels
+    /// \param[in] _step Bytes per row
+    /// \param[in] _format Pixel format
+    /// \return Image backed by the data
+    public: QImage Wrap(std::string &_data, const int _width,
+        const int _height, const int _step, const QImage::Format _format)
+    {
+      auto buffer = this->Acquire(Key(_width, _height, _format));
+      buffer->data.swap(_data);
+      return QImage(reinterpret_cast<uchar *>(&buffer->data[0]), _width,
+          _height, _step, _format, &ImageBufferPool::Release, buffer);
+    }
+
+    /// \brief Make an image to be written to, reusing a buffer of the same
+    /// resolution and format if there's one.
+    /// \param[in] _width Width in pixels
+    /// \param[in] _height Height in pixels
+    /// \param[in] _format Pixel format, with up to 4 bytes per pixel
+    /// \return Image with undefined contents
+    public: QImage Make(const int _width, const int _height,
+        const QImage::Format _format)
+    {
+      // Rows are 32 bit aligned, like the ones QImage allocates
+      int bytesPerPixel = QImage::toPixelFormat(_format).bitsPerPixel() / 8;
+      int step = (_width * bytesPerPixel + 3) & ~3;
+
+      auto buffer = this->Acquire(Key(_width, _height, _format));
+      buffer->data.resize(static_cast<std::size_t>(step) * _height);
+      return QImage(reinterpret_cast<uchar *>(&buffer->data[0]), _width,
+          _height, step, _format, &ImageBufferPool::Release, buffer);
+    }
+
+    /// \brief Get the memory held by buffers which aren't in use.
+    /// \return Bytes
+    public: std::size_t FreeBytes()
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      std::size_t bytes{0u};
+      for (const auto &buffer : this->free)
+        bytes += buffer->data.capacity();
+      return bytes;
+    }
+
+    /// \brief A pooled buffer
+    private: struct Buffer
+    {
+      /// \brief Pixel data
+      std::string data;
+
+      /// \brief Resolution and format it was last used for
+      std::uint64_t key;
+
+      /// \brief Pool to return to, set while the buffer is out
+      std::shared_ptr<ImageBufferPool> pool;
+    };
+
+    /// \brief Pack a resolution and format into a key
+    /// \param[in] _width Width in pixels
+    /// \param[in] _height Height in pixels
+    /// \param[in] _format Pixel format
+    /// \return Key
+    private: static std::uint64_t Key(const int _width, const int _height,
+        const QImage::Format _format)
+    {
+      return (static_cast<std::uint64_t>(_width & 0xffffff) << 40) |
+          (static_cast<std::uint64_t>(_height & 0xffffff) << 16) |
+          static_cast<std::uint64_t>(_format & 0xffff);
+    }
+
+    /// \brief Take a free buffer, preferring one used for the same key.
+    /// \param[in] _key Resolution and format
+    /// \return Buffer, owned by the image it's given to
+    private: Buffer *Acquire(const std::uint64_t _key)
+    {
+      Buffer *buffer{nullptr};
+      {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        auto it = std::find_if(this->free.begin(), this->free.end(),
+            [_key](const std::unique_ptr<Buffer> &_b)
+            {
+              return _b->key == _key;
+            });
+        if (it == this->free.end() && !this->free.empty())
+          it = this->free.begin();
+        if (it != this->free.end())
+        {
+          buffer = it->release();
+          this->free.erase(it);
+        }
+      }
+
+      if (!buffer)
+        buffer = new Buffer();
+      buffer->key = _key;
+      buffer->pool = this->shared_from_this();
+      return buffer;
+    }
+
+    /// \brief Cleanup function of pooled images
+    /// \param[in] _buffer The image's buffer
+    private: static void Release(void *_buffer)
+    {
+      auto buffer = static_cast<Buffer *>(_buffer);
+
+      // The buffer may hold the last reference to the pool
+      auto pool = std::move(buffer->pool);
+
+      std::lock_guard<std::mutex> lock(pool->mutex);
+      if (pool->free.size() < kMaxFree)
+        pool->free.emplace_back(buffer);
+      else
+        delete buffer;
+    }
+
+    /// \brief Most buffers kept around unused. A couple of images can be
+    /// in flight at once, the one being shown and the one replacing it.
+    private: static constexpr std::size_t kMaxFree{4u};
+
+    /// \brief Protects free
+    private: std::mutex mutex;
+
+    /// \brief Buffers which aren't in use
+    private: std::vector<std::unique_ptr<Buffer>> free;
+  };
+
   class ImageProvider : public QQuickImageProvider
   {
     public: ImageProvider()
@@ -47,11 +202,14 @@ namespace plugins
     public: QImage requestImage(const QString &, QSize *,
         const QSize &) override
     {
-      if (!this->img.isNull())
       {
-        // Must return a copy
-        QImage copy(this->img);
-        return copy;
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (!this->img.isNull())
+        {
+          // Must return a copy
+          QImage copy(this->img);
+          return copy;
+        }
       }
 
       // Placeholder in case we have no image yet
@@ -60,30 +218,173 @@ namespace plugins
       return i;
     }
 
+    /// \brief Replace the image. Can be called from any thread.
+    /// \param[in] _image New image, which must own its data or come from an
+    /// ImageBufferPool
     public: void SetImage(const QImage &_image)
     {
+      std::lock_guard<std::mutex> lock(this->mutex);
       this->img = _image;
     }
 
+    /// \brief Protects img, which is set by the conversion worker and read
+    /// by QML
+    private: std::mutex mutex;
+
     private: QImage img;
   };
 
+  /// \brief Converts image msgs in the background, newest first. Only one
+  /// runs at a time per display, and it keeps going for as long as new msgs
+  /// arrive.
+  class ImageTask : public QRunnable
+  {
+    /// \brief Constructor
+    /// \param[in] _display Display to deliver images to
+    /// \param[in] _data Display data, which outlives the task
+    public: ImageTask(ImageDisplay *_display, ImageDisplayPrivate *_data)
+      : display(_display), data(_data)
+    {
+    }
+
+    // Documentation inherited
+    public: void run() override;
+
+    /// \brief Display to deliver images to
+    private: ImageDisplay *display;
+
+    /// \brief Display data
+    private: ImageDisplayPrivate *data;
+  };
+
+  /// \brief Part of the image which is visible, and the size it's shown
+  /// at
+  struct ImageView
+  {
+    /// \brief Left edge, as a fraction of the image width
+    double x{0.0};
+
+    /// \brief Top edge, as a fraction of the image height
+    double y{0.0};
+
+    /// \brief Width, as a fraction of the image width
+    double width{1.0};
+
+    /// \brief Height, as a fraction of the image height
+    double height{1.0};
+
+    /// \brief Width shown at in pixels, 0 if unknown
+    unsigned int outWidth{0u};
+
+    /// \brief Height shown at in pixels, 0 if unknown
+    unsigned int outHeight{0u};
+  };
+
   class ImageDisplayPrivate
   {
     /// \brief List of topics publishing image messages.
     public: QStringList topicList;
 
-    /// \brief Holds data to set as the next image
-    public: msgs::Image imageMsg;
+    /// \brief Holds data to set as the next image, shared with other
+    /// subscribers to the topic
+    public: std::shared_ptr<const msgs::Image> imageMsg;
+
+    /// \brief True if imageMsg holds a msg which wasn't converted yet
+    public: bool imagePending{false};
+
+    /// \brief True if imageMsg is the last shown msg, queued again for a
+    /// new view, so replacing it doesn't count as a dropped frame
+    public: bool imageReplay{false};
+
+    /// \brief Last msg taken by the conversion task, shown again when the
+    /// view changes. Protected by imageMutex.
+    public: std::shared_ptr<const msgs::Image> shownMsg;
+
+    /// \brief Visible part of the image, protected by imageMutex
+    public: ImageView view;
+
+    /// \brief True while a conversion task is queued or running
+    public: bool converting{false};
+
+    /// \brief Set on destruction to stop the conversion task
+    public: bool stopping{false};
+
+    /// \brief Wakes up a conversion task waiting for its turn
+    public: std::condition_variable wake;
+
+    /// \brief Shortest time between images, zero for no limit
+    public: std::chrono::steady_clock::duration minInterval{0};
+
+    /// \brief Time the last image was converted
+    public: std::chrono::steady_clock::time_point lastImage;
+
+    /// \brief Number of msgs replaced by newer ones before being converted
+    public: std::atomic<unsigned int> dropped{0u};
+
+    /// \brief Dropped count last notified to QML
+    public: unsigned int droppedShown{0u};
+
+    /// \brief Subscription to the image topic, 0 if none
+    public: std::size_t subscription{0};
 
-    /// \brief Node for communication.
-    public: transport::Node node;
+    /// \brief Topic chosen, subscribed to unless suspended
+    public: std::string topic;
+
+    /// \brief True while the card is hidden
+    public: bool suspended{false};
 
     /// \brief Mutex for accessing image data
-    public: std::recursive_mutex imageMutex;
+    public: std::mutex imageMutex;
+
+    /// \brief Runs the conversion task
+    public: QThreadPool pool;
+
+    /// \brief True from the time a new image is announced until the GUI
+    /// thread picks it up, so that announcements don't pile up
+    public: std::atomic<bool> announced{false};
 
     /// \brief To provide images for QML.
     public: ImageProvider *provider{nullptr};
+
+    /// \brief Buffers of images given to the provider
+    public: std::shared_ptr<ImageBufferPool> buffers{
+        std::make_shared<ImageBufferPool>()};
+
+    /// \brief Draws images on the GPU, null if it isn't there
+    public: ImageDisplayItem *item{nullptr};
+
+    /// \brief Reads msgs whose pixels are in shared memory, used by the
+    /// conversion task only
+    public: SharedImageReader shared;
+
+    /// \brief Colors depth and 16 bit images are shown with. Set on the
+    /// GUI thread and read by the conversion task.
+    public: std::atomic<Colormap> colormap{Colormap::GRAY};
+
+    /// \brief Colors of 16 bit values, used by the conversion task only
+    public: RangeLut rangeLut;
+
+    /// \brief Gray levels of a row of depths, used by the conversion task
+    /// only
+    public: std::vector<std::uint8_t> grayRow;
+
+    /// \brief How depth and 16 bit images are normalized, set by the config
+    public: RangeMode rangeMode{RangeMode::FULL};
+
+    /// \brief Fixed range, the lower end is only used for 16 bit images
+    /// since depths are always shown from zero
+    public: double fixedMin{0.0};
+
+    /// \brief Fixed range, farthest depth or largest 16 bit value
+    public: double fixedMax{0.0};
+
+    /// \brief Percentile range of depth images, used by the conversion
+    /// task only
+    public: ImageRange depthPercentiles;
+
+    /// \brief Percentile range of 16 bit images, used by the conversion
+    /// task only
+    public: ImageRange valuePercentiles;
   };
 }
 }
@@ -94,248 +395,959 @@ using namespace gui;
 using namespace plugins;
 
 /////////////////////////////////////////////////
-ImageDisplay::ImageDisplay()
-  : Plugin(), dataPtr(new ImageDisplayPrivate)
+/// \brief Check that an image msg holds all the rows its size calls for
+/// \param[in] _msg Image msg
+/// \param[in] _pixelSize Bytes per pixel
+/// \return Bytes per row, zero if the image is empty or its data is too
+/// short
+static unsigned int rowStep(const msgs::Image &_msg,
+    const unsigned int _pixelSize)
 {
+  // Nothing to show
+  if (_msg.width() == 0u || _msg.height() == 0u)
+    return 0u;
+
+  unsigned int packed = _msg.width() * _pixelSize;
+  unsigned int step = _msg.step() >= packed ? _msg.step() : packed;
+
+  if (_msg.data().size() <
+      static_cast<std::size_t>(step) * (_msg.height() - 1u) + packed)
+  {
+    ignerr << "Image data is too short for a " << _msg.width() << "x"
+           << _msg.height() << " image of type "
+           << _msg.pixel_format_type() << std::endl;
+    return 0u;
+  }
+  return step;
 }
 
 /////////////////////////////////////////////////
-ImageDisplay::~ImageDisplay()
+/// \brief Convert an RGB_INT8 image msg
+/// \param[in] _msg Image msg, its data is taken on success
+/// \param[in,out] _data Display data, holding the buffer pool the image
+/// is made from
+/// \return Image, null if the msg couldn't be converted
+static QImage convertRgbInt8(msgs::Image &_msg, ImageDisplayPrivate &_data)
 {
-  App()->Engine()->removeImageProvider(
-      this->CardItem()->objectName() + "imagedisplay");
+  auto step = rowStep(_msg, 3u);
+  if (step == 0u)
+    return QImage();
+
+  // The image takes over the msg data
+  return _data.buffers->Wrap(*_msg.mutable_data(), _msg.width(), _msg.height(),
+      step, QImage::Format_RGB888);
 }
 
 /////////////////////////////////////////////////
-void ImageDisplay::LoadConfig(const tinyxml2::XMLElement *_pluginElem)
+/// \brief Find the farthest finite depth of an R_FLOAT32 image msg
+/// \param[in] _msg Image msg, with valid data
+/// \param[in] _step Bytes per row
+/// \return Farthest depth, zero if there's none
+static float maxDepth(const msgs::Image &_msg, const unsigned int _step)
 {
-  // Default name in case user didn't define one
-  if (this->title.empty())
-    this->title = "Image display";
+  const char *data = _msg.data().data();
+  if (_step == _msg.width() * sizeof(float))
+    return ImageConversion::MaxDepth(data, _msg.width() * _msg.height());
 
-  std::string topic;
-  bool topicPicker = true;
+  float max = 0.0f;
+  for (unsigned int j = 0; j < _msg.height(); ++j)
+    max = std::max(max, ImageConversion::MaxDepth(data + j * _step,
+        _msg.width()));
+  return max;
+}
 
-  // Read configuration
-  if (_pluginElem)
+/////////////////////////////////////////////////
+/// \brief Find the range of an L_INT16 image msg
+/// \param[in] _msg Image msg, with valid data
+/// \param[in] _step Bytes per row
+/// \param[out] _min Smallest value
+/// \param[out] _max Largest value
+static void valueRange(const msgs::Image &_msg, const unsigned int _step,
+    uint16_t &_min, uint16_t &_max)
+{
+  const char *data = _msg.data().data();
+  if (_step == _msg.width() * sizeof(uint16_t))
   {
-    if (auto topicElem = _pluginElem->FirstChildElement("topic"))
-      topic = topicElem->GetText();
+    ImageConversion::MinMax(data, _msg.width() * _msg.height(), _min, _max);
+    return;
+  }
 
-    if (auto pickerElem = _pluginElem->FirstChildElement("topic_picker"))
-      pickerElem->QueryBoolText(&topicPicker);
+  _min = std::numeric_limits<uint16_t>::max();
+  _max = 0u;
+  for (unsigned int j = 0; j < _msg.height(); ++j)
+  {
+    uint16_t min, max;
+    ImageConversion::MinMax(data + j * _step, _msg.width(), min, max);
+    _min = std::min(_min, min);
+    _max = std::max(_max, max);
   }
+}
 
-  if (topic.empty() && !topicPicker)
+/////////////////////////////////////////////////
+/// \brief Find the depth shown as black in an R_FLOAT32 image msg, as set
+/// by the range mode
+/// \param[in] _msg Image msg, with valid data
+/// \param[in] _step Bytes per row
+/// \param[in,out] _data Display data holding the range mode
+/// \return Farthest depth, zero if there's none
+static float farDepth(const msgs::Image &_msg, const unsigned int _step,
+    ImageDisplayPrivate &_data)
+{
+  switch (_data.rangeMode)
   {
-    ignwarn << "Can't hide topic picker without a default topic." << std::endl;
-    topicPicker = true;
+    case RangeMode::FIXED:
+      return static_cast<float>(_data.fixedMax);
+    case RangeMode::PERCENTILE:
+    {
+      double min, max;
+      _data.depthPercentiles.Update<float>(_msg.data().data(), _msg.width(),
+          _msg.height(), _step, min, max);
+      return static_cast<float>(max);
+    }
+    default:
+      return maxDepth(_msg, _step);
   }
+}
 
-  this->PluginItem()->setProperty("showPicker", topicPicker);
+/////////////////////////////////////////////////
+/// \brief Find the range shown from black to white in an L_INT16 image
+/// msg, as set by the range mode
+/// \param[in] _msg Image msg, with valid data
+/// \param[in] _step Bytes per row
+/// \param[in,out] _data Display data holding the range mode
+/// \param[out] _min Lower end of the range
+/// \param[out] _max Upper end of the range
+static void shownRange(const msgs::Image &_msg, const unsigned int _step,
+    ImageDisplayPrivate &_data, uint16_t &_min, uint16_t &_max)
+{
+  auto toValue = [](const double _v)
+  {
+    return static_cast<uint16_t>(std::min(std::max(_v + 0.5, 0.0),
+        static_cast<double>(std::numeric_limits<uint16_t>::max())));
+  };
 
-  if (!topic.empty())
-    this->OnTopic(QString::fromStdString(topic));
-  else
-    this->OnRefresh();
+  switch (_data.rangeMode)
+  {
+    case RangeMode::FIXED:
+      _min = toValue(_data.fixedMin);
+      _max = toValue(_data.fixedMax);
+      return;
+    case RangeMode::PERCENTILE:
+    {
+      double min, max;
+      _data.valuePercentiles.Update<uint16_t>(_msg.data().data(), _msg.width(),
+          _msg.height(), _step, min, max);
+      _min = toValue(min);
+      _max = toValue(max);
+      return;
+    }
+    default:
+      valueRange(_msg, _step, _min, _max);
+  }
+}
 
-  this->dataPtr->provider = new ImageProvider();
-  App()->Engine()->addImageProvider(
-      this->CardItem()->objectName() + "imagedisplay", this->dataPtr->provider);
+/////////////////////////////////////////////////
+/// \brief Convert an R_FLOAT32 image msg
+/// \param[in] _msg Image msg
+/// \param[in,out] _data Display data, holding the buffer pool the image
+/// is made from, the colormap and the range mode
+/// \return Image, null if the msg couldn't be converted
+static QImage convertFloat32(const msgs::Image &_msg,
+    ImageDisplayPrivate &_data)
+{
+  auto step = rowStep(_msg, sizeof(float));
+  if (step == 0u)
+    return QImage();
+
+  auto &buffers = *_data.buffers;
+  Colormap colormap = _data.colormap;
+  float max = farDepth(_msg, step, _data);
+  float factor = max > 0.0f ? 255.0f / max : 0.0f;
+
+  // Grayscale rows can be written directly, one byte per pixel
+  if (colormap == Colormap::GRAY)
+  {
+    auto image = buffers.Make(_msg.width(), _msg.height(),
+        QImage::Format_Grayscale8);
+    for (unsigned int j = 0; j < _msg.height(); ++j)
+    {
+      ImageConversion::DepthToGray(_msg.data().data() + j * step,
+          _msg.width(), factor, image.scanLine(j));
+    }
+    return image;
+  }
+
+  // Otherwise gray levels index the colormap, one row at a time
+  auto image = buffers.Make(_msg.width(), _msg.height(),
+      QImage::Format_RGB32);
+  const auto &table = ColormapLut::Table(colormap);
+  _data.grayRow.resize(_msg.width());
+  for (unsigned int j = 0; j < _msg.height(); ++j)
+  {
+    ImageConversion::DepthToGray(_msg.data().data() + j * step,
+        _msg.width(), factor, _data.grayRow.data());
+    ColormapLut::GrayToColor(_data.grayRow.data(), _msg.width(), table,
+        reinterpret_cast<std::uint32_t *>(image.scanLine(j)));
+  }
+  return image;
+}
+
+/////////////////////////////////////////////////
+/// \brief Convert an L_INT16 image msg
+/// \param[in] _msg Image msg
+/// \param[in,out] _data Display data, holding the buffer pool the image
+/// is made from, the colormap, its lookup table and the range mode
+/// \return Image, null if the msg couldn't be converted
+static QImage convertLInt16(const msgs::Image &_msg,
+    ImageDisplayPrivate &_data)
+{
+  auto step = rowStep(_msg, sizeof(uint16_t));
+  if (step == 0u)
+    return QImage();
+
+  auto &buffers = *_data.buffers;
+  Colormap colormap = _data.colormap;
+
+  // get min and max of temperature values
+  uint16_t min;
+  uint16_t max;
+  shownRange(_msg, step, _data, min, max);
+
+  // False color is one lookup per pixel
+  if (colormap != Colormap::GRAY)
+  {
+    auto image = buffers.Make(_msg.width(), _msg.height(),
+        QImage::Format_RGB32);
+    _data.rangeLut.Update(colormap, min, max);
+    for (unsigned int j = 0; j < _msg.height(); ++j)
+    {
+      _data.rangeLut.Map(_msg.data().data() + j * step, _msg.width(),
+          reinterpret_cast<std::uint32_t *>(image.scanLine(j)));
+    }
+    return image;
+  }
+
+  auto image = buffers.Make(_msg.width(), _msg.height(),
+      QImage::Format_Grayscale8);
+
+  // convert temperature to grayscale image
+  float scale = max > min ? 255.0f / (max - min) : 0.0f;
+  for (unsigned int j = 0; j < _msg.height(); ++j)
+  {
+    ImageConversion::RangeToGray(_msg.data().data() + j * step,
+        _msg.width(), min, scale, image.scanLine(j));
+  }
+  return image;
 }
 
 /////////////////////////////////////////////////
-void ImageDisplay::ProcessImage()
+/// \brief Turn an image msg into a frame for the GPU path, which only needs
+/// the range of depth and 16 bit images.
+/// \param[in] _msg Image msg, its data is taken on success
+/// \param[in,out] _data Display data, holding the colormap and the range
+/// mode
+/// \param[out] _frame Frame
+/// \return False if the msg can't be drawn
+static bool toFrame(msgs::Image &_msg, ImageDisplayPrivate &_data,
+    ImageDisplayItem::Frame &_frame)
 {
-  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->imageMutex);
-  switch (this->dataPtr->imageMsg.pixel_format_type())
+  unsigned int pixelSize;
+  switch (_msg.pixel_format_type())
   {
     case msgs::PixelFormatType::RGB_INT8:
-      this->UpdateFromRgbInt8();
+      _frame.format = ImageDisplayItem::Format::RGB_INT8;
+      pixelSize = 3u;
       break;
     case msgs::PixelFormatType::R_FLOAT32:
-      this->UpdateFromFloat32();
+      _frame.format = ImageDisplayItem::Format::R_FLOAT32;
+      pixelSize = sizeof(float);
       break;
     case msgs::PixelFormatType::L_INT16:
-      this->UpdateFromLInt16();
+      _frame.format = ImageDisplayItem::Format::L_INT16;
+      pixelSize = sizeof(uint16_t);
       break;
     default:
     {
       ignwarn << "Unsupported image type: "
-              << this->dataPtr->imageMsg.pixel_format_type() << std::endl;
+              << _msg.pixel_format_type() << std::endl;
+      return false;
     }
   }
+
+  auto step = rowStep(_msg, pixelSize);
+  if (step == 0u)
+    return false;
+
+  // Rows are uploaded in whole pixels
+  if (step % pixelSize != 0u)
+  {
+    ignerr << "Image step [" << step << "] isn't a whole number of pixels"
+           << std::endl;
+    return false;
+  }
+
+  _frame.offset = 0.0f;
+  _frame.scale = 1.0f;
+  if (_frame.format == ImageDisplayItem::Format::R_FLOAT32)
+  {
+    float max = farDepth(_msg, step, _data);
+    _frame.scale = max > 0.0f ? 1.0f / max : 0.0f;
+  }
+  else if (_frame.format == ImageDisplayItem::Format::L_INT16)
+  {
+    uint16_t min, max;
+    shownRange(_msg, step, _data, min, max);
+    _frame.offset = min;
+    _frame.scale = max > min ? 1.0f / (max - min) : 0.0f;
+  }
+
+  _frame.colormap = _data.colormap;
+  _frame.width = _msg.width();
+  _frame.height = _msg.height();
+  _frame.step = step;
+  _frame.data.swap(*_msg.mutable_data());
+  return true;
 }
 
 /////////////////////////////////////////////////
-void ImageDisplay::OnImageMsg(const msgs::Image &_msg)
+/// \brief Convert an image msg of one of the PixelFormats to RGB
+/// \param[in] _msg Image msg
+/// \param[in,out] _data Display data, holding the buffer pool the image
+/// is made from
+/// \return Image, null if the msg couldn't be converted
+template <typename Format>
+static QImage convertToRgb(msgs::Image &_msg, ImageDisplayPrivate &_data)
 {
-  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->imageMutex);
-  this->dataPtr->imageMsg = _msg;
+  auto step = rowStep(_msg, Format::kPixelSize);
+  if (step == 0u)
+    return QImage();
 
-  // Signal to main thread that the image changed
-  QMetaObject::invokeMethod(this, "ProcessImage");
+  auto image = _data.buffers->Make(_msg.width(), _msg.height(),
+      QImage::Format_RGB888);
+  Format::Convert(_msg.data().data(), _msg.width(), _msg.height(), step,
+      image.bits(), image.bytesPerLine());
+  return image;
 }
 
+/// \brief Turns msgs of a pixel format into images for the CPU path
+struct ImageConverter
+{
+  /// \brief Bytes per pixel
+  std::size_t pixelSize;
+
+  /// \brief Width and height of the pixel blocks which must be kept
+  /// whole, such as the 2x2 blocks of Bayer mosaics
+  unsigned int block;
+
+  /// \brief Convert a msg, taking its data if it likes
+  QImage (*convert)(msgs::Image &, ImageDisplayPrivate &);
+};
+
 /////////////////////////////////////////////////
-void ImageDisplay::OnTopic(const QString _topic)
+/// \brief Get the converters of all pixel formats which can be shown. The
+/// formats the display normalizes itself are listed here, and all the
+/// PixelFormats are converted to RGB.
+/// \return Converters keyed by msgs::PixelFormatType
+static const std::unordered_map<int, ImageConverter> &converters()
 {
-  auto topic = _topic.toStdString();
-  if (topic.empty())
-    return;
+  static const auto table = []
+  {
+    std::unordered_map<int, ImageConverter> t{
+      {msgs::PixelFormatType::RGB_INT8, {3u, 1u, convertRgbInt8}},
+      {msgs::PixelFormatType::R_FLOAT32, {sizeof(float), 1u,
+          [](msgs::Image &_msg, ImageDisplayPrivate &_data)
+          {
+            return convertFloat32(_msg, _data);
+          }}},
+      {msgs::PixelFormatType::L_INT16, {sizeof(uint16_t), 1u,
+          [](msgs::Image &_msg, ImageDisplayPrivate &_data)
+          {
+            return convertLInt16(_msg, _data);
+          }}}};
 
-  // Unsubscribe
-  auto subs = this->dataPtr->node.SubscribedTopics();
-  for (auto sub : subs)
-    this->dataPtr->node.Unsubscribe(sub);
+    PixelFormats::ForEach([&t](auto _format)
+    {
+      using Format = decltype(_format);
+      t[Format::kType] = {Format::kPixelSize, Format::kBlock,
+          convertToRgb<Format>};
+    });
+    return t;
+  }();
+  return table;
+}
 
-  // Subscribe to new topic
-  if (!this->dataPtr->node.Subscribe(topic, &ImageDisplay::OnImageMsg,
-      this))
+/////////////////////////////////////////////////
+/// \brief Convert an image msg for the CPU path, with the converter of its
+/// pixel format
+/// \param[in] _msg Image msg, its data may be taken
+/// \param[in,out] _data Display data
+/// \return Image, null if the msg couldn't be converted
+static QImage convert(msgs::Image &_msg, ImageDisplayPrivate &_data)
+{
+  auto it = converters().find(_msg.pixel_format_type());
+  if (it == converters().end())
   {
-    ignerr << "Unable to subscribe to topic [" << topic << "]" << std::endl;
+    ignwarn << "Unsupported image type: "
+            << _msg.pixel_format_type() << std::endl;
+    return QImage();
   }
+  return it->second.convert(_msg, _data);
 }
 
 /////////////////////////////////////////////////
-void ImageDisplay::OnRefresh()
+/// \brief Check if the GPU path draws a pixel format as it is. Other
+/// formats are converted to RGB first.
+/// \param[in] _format Pixel format
+/// \return True for RGB_INT8, R_FLOAT32 and L_INT16
+static bool isFrameFormat(const msgs::PixelFormatType _format)
 {
-  // Clear
-  this->dataPtr->topicList.clear();
+  return _format == msgs::PixelFormatType::RGB_INT8 ||
+      _format == msgs::PixelFormatType::R_FLOAT32 ||
+      _format == msgs::PixelFormatType::L_INT16;
+}
+
+/////////////////////////////////////////////////
+/// \brief Check if an image msg carries a JPEG or PNG file instead of raw
+/// pixels. Raw data which happens to start like one is told apart by its
+/// size.
+/// \param[in] _msg Image msg
+/// \return True if the data is compressed
+static bool isCompressed(const msgs::Image &_msg)
+{
+  static const std::string kJpeg{"\xff\xd8\xff"};
+  static const std::string kPng{"\x89PNG\r\n\x1a\n"};
+
+  const auto &data = _msg.data();
+  if (data.compare(0, kJpeg.size(), kJpeg) != 0 &&
+      data.compare(0, kPng.size(), kPng) != 0)
+  {
+    return false;
+  }
+
+  auto it = converters().find(_msg.pixel_format_type());
+  if (it == converters().end())
+    return true;
+
+  return data.size() < static_cast<std::size_t>(_msg.width()) *
+      _msg.height() * it->second.pixelSize;
+}
 
-  // Get updated list
-  std::vector<std::string> allTopics;
-  this->dataPtr->node.TopicList(allTopics);
-  for (auto topic : allTopics)
+/////////////////////////////////////////////////
+/// \brief Decode a compressed image msg
+/// \param[in] _msg Image msg with JPEG or PNG data
+/// \return RGB image, null if decoding failed
+static QImage decompress(const msgs::Image &_msg)
+{
+  const auto &data = _msg.data();
+  auto image = QImage::fromData(
+      reinterpret_cast<const uchar *>(data.data()), data.size());
+  if (image.isNull())
   {
-    std::vector<transport::MessagePublisher> publishers;
-    this->dataPtr->node.TopicInfo(topic, publishers);
-    for (auto pub : publishers)
+    ignerr << "Failed to decode compressed image" << std::endl;
+    return image;
+  }
+  return image.convertToFormat(QImage::Format_RGB888);
+}
+
+/////////////////////////////////////////////////
+/// \brief Turn a decoded image into a frame for the GPU path
+/// \param[in] _image RGB image
+/// \param[out] _frame Frame
+static void toFrame(const QImage &_image, ImageDisplayItem::Frame &_frame)
+{
+  _frame.format = ImageDisplayItem::Format::RGB_INT8;
+  _frame.width = _image.width();
+  _frame.height = _image.height();
+  _frame.step = _image.bytesPerLine();
+  _frame.offset = 0.0f;
+  _frame.scale = 1.0f;
+  _frame.colormap = Colormap::GRAY;
+  _frame.data.assign(reinterpret_cast<const char *>(_image.constBits()),
+      static_cast<std::size_t>(_image.bytesPerLine()) * _image.height());
+}
+
+/////////////////////////////////////////////////
+/// \brief Copy the part of a raw image msg which is visible, skipping
+/// pixels which wouldn't be seen at the size it's shown at. Bayer mosaics
+/// are sampled in whole 2x2 blocks.
+/// \param[in] _src Image msg
+/// \param[in] _view Visible part of the image
+/// \param[out] _dst Cropped image msg, only written on success
+/// \return False if the whole image is visible at its own resolution, or
+/// if it can't be cropped, such as a compressed or shared memory one
+static bool cropToView(const msgs::Image &_src, const ImageView &_view,
+    msgs::Image &_dst)
+{
+  if (SharedImageReader::IsShared(_src) || isCompressed(_src))
+    return false;
+
+  auto it = converters().find(_src.pixel_format_type());
+  if (it == converters().end())
+    return false;
+
+  const std::size_t pixelSize = it->second.pixelSize;
+  const unsigned int block = it->second.block;
+  auto step = rowStep(_src, pixelSize);
+  if (step == 0u)
+    return false;
+
+  // Edges in pixels, rounded outwards
+  auto edge = [](const double _fraction, const unsigned int _size,
+      const bool _up)
+  {
+    double v = _fraction * _size;
+    v = _up ? std::ceil(v) : std::floor(v);
+    return static_cast<unsigned int>(
+        std::min(std::max(v, 0.0), static_cast<double>(_size)));
+  };
+  const unsigned int width = _src.width();
+  const unsigned int height = _src.height();
+  unsigned int x0 = edge(_view.x, width, false);
+  unsigned int y0 = edge(_view.y, height, false);
+  unsigned int x1 = edge(_view.x + _view.width, width, true);
+  unsigned int y1 = edge(_view.y + _view.height, height, true);
+  x1 = std::min(width, std::max(x1, x0 + 1u));
+  y1 = std::min(height, std::max(y1, y0 + 1u));
+  x0 -= x0 % block;
+  y0 -= y0 % block;
+  if (x0 + block > width || y0 + block > height)
+    return false;
+
+  // Source pixels per pixel shown, the same both ways to keep the aspect
+  unsigned int stride = 1u;
+  if (_view.outWidth > 0u && _view.outHeight > 0u)
+  {
+    stride = std::max(1u, std::min((x1 - x0) / _view.outWidth,
+        (y1 - y0) / _view.outHeight));
+  }
+
+  if (x0 == 0u && y0 == 0u && x1 == width && y1 == height && stride == 1u)
+    return false;
+
+  // Blocks copied across and down, keeping whole blocks inside the image
+  const unsigned int jump = stride * block;
+  const unsigned int cols = std::min((x1 - x0 + jump - 1u) / jump,
+      (width - x0 - block) / jump + 1u);
+  const unsigned int rows = std::min((y1 - y0 + jump - 1u) / jump,
+      (height - y0 - block) / jump + 1u);
+
+  const std::size_t outStep = cols * block * pixelSize;
+  auto &data = *_dst.mutable_data();
+  data.resize(outStep * rows * block);
+  auto out = &data[0];
+  for (unsigned int j = 0u; j < rows; ++j)
+  {
+    for (unsigned int dy = 0u; dy < block; ++dy, out += outStep)
     {
-      if (pub.MsgTypeName() == "ignition.msgs.Image")
+      auto row = _src.data().data() +
+          static_cast<std::size_t>(y0 + j * jump + dy) * step +
+          x0 * pixelSize;
+      if (stride == 1u)
+      {
+        std::memcpy(out, row, outStep);
+        continue;
+      }
+      for (unsigned int i = 0u; i < cols; ++i)
       {
-        this->dataPtr->topicList.push_back(QString::fromStdString(topic));
-        break;
+        std::memcpy(out + i * block * pixelSize, row + i * jump * pixelSize,
+            block * pixelSize);
       }
     }
   }
 
-  // Select first one
-  if (this->dataPtr->topicList.count() > 0)
-    this->OnTopic(this->dataPtr->topicList.at(0));
-  this->TopicListChanged();
+  _dst.mutable_header()->CopyFrom(_src.header());
+  _dst.set_width(cols * block);
+  _dst.set_height(rows * block);
+  _dst.set_step(static_cast<unsigned int>(outStep));
+  _dst.set_pixel_format_type(_src.pixel_format_type());
+  return true;
 }
 
 /////////////////////////////////////////////////
-void ImageDisplay::UpdateFromRgbInt8()
+void ImageTask::run()
 {
-  QImage image(
-    reinterpret_cast<const uchar *>(this->dataPtr->imageMsg.data().c_str()),
-    this->dataPtr->imageMsg.width(), this->dataPtr->imageMsg.height(),
-    QImage::Format_RGB888);
+  msgs::Image msg;
+  std::shared_ptr<const msgs::Image> next;
+  ImageDisplayItem::Frame frame;
+  ImageView view;
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> lock(this->data->imageMutex);
 
-  this->dataPtr->provider->SetImage(image);
-  this->newImage();
+      // Msgs arriving while waiting replace each other
+      if (this->data->minInterval > std::chrono::steady_clock::duration::zero())
+      {
+        this->data->wake.wait_until(lock,
+            this->data->lastImage + this->data->minInterval,
+            [this] {return this->data->stopping;});
+      }
+
+      if (!this->data->imagePending || this->data->stopping)
+      {
+        this->data->converting = false;
+        return;
+      }
+      next.swap(this->data->imageMsg);
+      this->data->imagePending = false;
+      this->data->imageReplay = false;
+      this->data->shownMsg = next;
+      this->data->lastImage = std::chrono::steady_clock::now();
+      view = this->data->view;
+    }
+
+    // Only msgs which are shown are copied, the conversion takes the data.
+    // When zoomed in or shown smaller than they are, only the visible
+    // pixels at the shown resolution are.
+    if (!cropToView(*next, view, msg))
+      msg.CopyFrom(*next);
+    next.reset();
+
+    // Pixels left in shared memory are copied from it once
+    if (SharedImageReader::IsShared(msg) && !this->data->shared.Read(msg))
+    {
+      ++this->data->dropped;
+      Metrics::Instance().Add(MetricCounter::kDroppedImages);
+      continue;
+    }
+
+    // Compressed images are decoded here, whichever way they're shown
+    QImage decoded;
+    if (isCompressed(msg))
+    {
+      decoded = decompress(msg);
+      if (decoded.isNull())
+        continue;
+    }
+
+    // Let the GPU do the conversion if it can
+    auto item = this->data->item;
+    if (item && item->Supported())
+    {
+      // Other formats are converted to RGB first, like compressed ones
+      if (decoded.isNull() && !isFrameFormat(msg.pixel_format_type()))
+      {
+        decoded = convert(msg, *this->data);
+        if (decoded.isNull())
+          continue;
+      }
+
+      if (!decoded.isNull())
+        toFrame(decoded, frame);
+      else if (!toFrame(msg, *this->data, frame))
+        continue;
+      item->SetFrame(frame);
+      continue;
+    }
+
+    QImage image = decoded.isNull() ? convert(msg, *this->data) : decoded;
+    if (image.isNull())
+      continue;
+
+    this->data->provider->SetImage(image);
+
+    // Tell QML once, however many images were converted until it gets to it
+    if (!this->data->announced.exchange(true))
+      QMetaObject::invokeMethod(this->display, "OnImageReady");
+  }
 }
 
 /////////////////////////////////////////////////
-void ImageDisplay::UpdateFromFloat32()
+ImageDisplay::ImageDisplay()
+  : Plugin(), dataPtr(new ImageDisplayPrivate)
 {
-  unsigned int height = this->dataPtr->imageMsg.height();
-  unsigned int width = this->dataPtr->imageMsg.width();
-  QImage::Format qFormat = QImage::Format_RGB888;
+  this->dataPtr->pool.setMaxThreadCount(1);
+  qmlRegisterType<ImageDisplayItem>("ImageDisplayItem", 1, 0,
+      "ImageDisplayItem");
+}
 
-  QImage image = QImage(width, height, qFormat);
+/////////////////////////////////////////////////
+ImageDisplay::~ImageDisplay()
+{
+  // Stop receiving and let the conversion finish before the provider goes
+  SubscriptionHub::Instance()->Unsubscribe(this->dataPtr->subscription);
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->imageMutex);
+    this->dataPtr->stopping = true;
+  }
+  this->dataPtr->wake.notify_all();
+  this->dataPtr->pool.waitForDone();
 
-  unsigned int depthSamples = width * height;
-  float f;
-  // cppchecker recommends using sizeof(varname)
-  unsigned int depthBufferSize = depthSamples * sizeof(f);
+  App()->Engine()->removeImageProvider(
+      this->CardItem()->objectName() + "imagedisplay");
+}
 
-  float * depthBuffer = new float[depthSamples];
+/////////////////////////////////////////////////
+void ImageDisplay::LoadConfig(const tinyxml2::XMLElement *_pluginElem)
+{
+  // Default name in case user didn't define one
+  if (this->title.empty())
+    this->title = "Image display";
 
-  memcpy(depthBuffer, this->dataPtr->imageMsg.data().c_str(),
-      depthBufferSize);
+  std::string topic;
+  bool topicPicker = true;
 
-  float maxDepth = 0;
-  for (unsigned int i = 0; i < depthSamples; ++i)
+  // Read configuration
+  if (_pluginElem)
   {
-    if (depthBuffer[i] > maxDepth && !std::isinf(depthBuffer[i]))
+    if (auto topicElem = _pluginElem->FirstChildElement("topic"))
+      topic = topicElem->GetText();
+
+    if (auto pickerElem = _pluginElem->FirstChildElement("topic_picker"))
+      pickerElem->QueryBoolText(&topicPicker);
+
+    if (auto rateElem = _pluginElem->FirstChildElement("max_rate"))
     {
-      maxDepth = depthBuffer[i];
+      double rate = 0.0;
+      rateElem->QueryDoubleText(&rate);
+      if (rate > 0.0)
+      {
+        this->dataPtr->minInterval =
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(1.0 / rate));
+      }
     }
-  }
-  unsigned int idx = 0;
-  double factor = 255 / maxDepth;
-  for (unsigned int j = 0; j < height; ++j)
-  {
-    for (unsigned int i = 0; i < width; ++i)
+
+    if (auto colormapElem = _pluginElem->FirstChildElement("colormap"))
+    {
+      if (colormapElem->GetText())
+        this->SetColormap(QString(colormapElem->GetText()).toLower());
+    }
+
+    if (auto modeElem = _pluginElem->FirstChildElement("range_mode"))
+    {
+      auto mode = QString(modeElem->GetText()).toLower().toStdString();
+      if (!ImageRange::FromName(mode, this->dataPtr->rangeMode))
+      {
+        ignerr << "Unknown range mode [" << mode
+               << "], expected full, fixed or percentile" << std::endl;
+      }
+    }
+
+    if (auto minElem = _pluginElem->FirstChildElement("range_min"))
+      minElem->QueryDoubleText(&this->dataPtr->fixedMin);
+
+    if (auto maxElem = _pluginElem->FirstChildElement("range_max"))
+      maxElem->QueryDoubleText(&this->dataPtr->fixedMax);
+
+    if (this->dataPtr->rangeMode == RangeMode::FIXED &&
+        !(this->dataPtr->fixedMax > this->dataPtr->fixedMin))
+    {
+      ignerr << "Fixed range needs a <range_max> larger than <range_min>, "
+             << "using the full range" << std::endl;
+      this->dataPtr->rangeMode = RangeMode::FULL;
+    }
+
+    if (auto percentileElem =
+        _pluginElem->FirstChildElement("range_percentile"))
     {
-      float d = depthBuffer[idx++];
-      d = 255 - (d * factor);
-      QRgb value = qRgb(d, d, d);
-      image.setPixel(i, j, value);
+      double percentile = 98.0;
+      percentileElem->QueryDoubleText(&percentile);
+      this->dataPtr->depthPercentiles.SetPercentile(percentile);
+      this->dataPtr->valuePercentiles.SetPercentile(percentile);
     }
   }
 
-  this->dataPtr->provider->SetImage(image);
+  if (topic.empty() && !topicPicker)
+  {
+    ignwarn << "Can't hide topic picker without a default topic." << std::endl;
+    topicPicker = true;
+  }
+
+  this->PluginItem()->setProperty("showPicker", topicPicker);
+
+  // The provider must be there before images start arriving
+  this->dataPtr->provider = new ImageProvider();
+  App()->Engine()->addImageProvider(
+      this->CardItem()->objectName() + "imagedisplay", this->dataPtr->provider);
+
+  // Images are drawn by the GPU item when it's supported, and go through
+  // the provider otherwise
+  this->dataPtr->item = this->PluginItem()->findChild<ImageDisplayItem *>();
+
+  if (!topic.empty())
+    this->OnTopic(QString::fromStdString(topic));
+  else
+    this->OnRefresh();
+}
+
+/////////////////////////////////////////////////
+void ImageDisplay::OnImageReady()
+{
+  this->dataPtr->announced = false;
   this->newImage();
 
-  delete[] depthBuffer;
+  auto dropped = this->dataPtr->dropped.load();
+  if (dropped != this->dataPtr->droppedShown)
+  {
+    this->dataPtr->droppedShown = dropped;
+    this->DroppedFramesChanged();
+  }
+}
+
+/////////////////////////////////////////////////
+unsigned int ImageDisplay::DroppedFrames() const
+{
+  return this->dataPtr->droppedShown;
 }
 
 /////////////////////////////////////////////////
-void ImageDisplay::UpdateFromLInt16()
+QString ImageDisplay::Colormap() const
 {
-  unsigned int height = this->dataPtr->imageMsg.height();
-  unsigned int width = this->dataPtr->imageMsg.width();
-  QImage::Format qFormat = QImage::Format_RGB888;
+  return QString::fromStdString(
+      ColormapLut::Name(this->dataPtr->colormap));
+}
 
-  QImage image = QImage(width, height, qFormat);
+/////////////////////////////////////////////////
+void ImageDisplay::SetColormap(const QString &_colormap)
+{
+  auto colormap = this->dataPtr->colormap.load();
+  if (!ColormapLut::FromName(_colormap.toStdString(), colormap))
+  {
+    ignerr << "Unknown colormap [" << _colormap.toStdString()
+           << "], expected gray, turbo, jet or inferno" << std::endl;
+    return;
+  }
 
-  unsigned int samples = width * height;
-  uint16_t type;
-  // cppchecker recommends using sizeof(varname)
-  unsigned int bufferSize = samples * sizeof(type);
+  if (colormap == this->dataPtr->colormap)
+    return;
 
-  uint16_t *buffer = new uint16_t[samples];
-  memcpy(buffer, this->dataPtr->imageMsg.data().c_str(),
-      bufferSize);
+  // Shown from the next image on
+  this->dataPtr->colormap = colormap;
+  this->ColormapChanged();
+}
 
-  // get min and max of temperature values
-  uint16_t min = std::numeric_limits<uint16_t>::max();
-  uint16_t max = 0;
-  for (unsigned int i = 0; i < samples; ++i)
-  {
-    uint16_t temp = buffer[i];
-    if (temp > max)
-      max = temp;
-    if (temp < min)
-      min = temp;
+/////////////////////////////////////////////////
+void ImageDisplay::SetView(const double _x, const double _y,
+    const double _width, const double _height, const int _outWidth,
+    const int _outHeight)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->imageMutex);
+  auto &view = this->dataPtr->view;
+  view.x = _x;
+  view.y = _y;
+  view.width = _width;
+  view.height = _height;
+  view.outWidth = static_cast<unsigned int>(std::max(_outWidth, 0));
+  view.outHeight = static_cast<unsigned int>(std::max(_outHeight, 0));
+
+  // Show the last image again for the new view, in case no more come
+  if (this->dataPtr->imagePending || !this->dataPtr->shownMsg)
+    return;
+
+  this->dataPtr->imageMsg = this->dataPtr->shownMsg;
+  this->dataPtr->imagePending = true;
+  this->dataPtr->imageReplay = true;
+  if (!this->dataPtr->converting)
+  {
+    this->dataPtr->converting = true;
+    this->dataPtr->pool.start(new ImageTask(this, this->dataPtr.get()));
   }
+}
 
-  // convert temperature to grayscale image
-  double range = static_cast<double>(max - min);
-  if (ignition::math::equal(range, 0.0))
-    range = 1.0;
-  unsigned int idx = 0;
-  for (unsigned int j = 0; j < height; ++j)
+/////////////////////////////////////////////////
+void ImageDisplay::OnImageMsg(const std::shared_ptr<const msgs::Image> &_msg)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->imageMutex);
+  if (this->dataPtr->imagePending && !this->dataPtr->imageReplay)
   {
-    for (unsigned int i = 0; i < width; ++i)
-    {
-      uint16_t temp = buffer[idx++];
-      double t = static_cast<double>(temp-min) / range;
-      int r = 255*t;
-      int g = r;
-      int b = r;
-      QRgb value = qRgb(r, g, b);
-      image.setPixel(i, j, value);
-    }
+    ++this->dataPtr->dropped;
+    Metrics::Instance().Add(MetricCounter::kDroppedImages);
   }
-  this->dataPtr->provider->SetImage(image);
-  this->newImage();
+  this->dataPtr->imageMsg = _msg;
+  this->dataPtr->imagePending = true;
+  this->dataPtr->imageReplay = false;
 
-  delete[] buffer;
+  // Convert in the background, the GUI thread only hears about the result.
+  // A conversion which is already going picks up the new msg.
+  if (!this->dataPtr->converting)
+  {
+    this->dataPtr->converting = true;
+    this->dataPtr->pool.start(new ImageTask(this, this->dataPtr.get()));
+  }
+}
+
+/////////////////////////////////////////////////
+void ImageDisplay::OnTopic(const QString _topic)
+{
+  auto topic = _topic.toStdString();
+  if (topic.empty())
+    return;
+
+  // Unsubscribe
+  auto hub = SubscriptionHub::Instance();
+  hub->Unsubscribe(this->dataPtr->subscription);
+  this->dataPtr->subscription = 0;
+  this->dataPtr->topic = topic;
+
+  // Subscribed to once the card is shown
+  if (this->dataPtr->suspended)
+    return;
+
+  // Subscribe to new topic, sharing msgs with other plugins showing it
+  this->dataPtr->subscription = hub->Subscribe<msgs::Image>(topic,
+      [this](const std::shared_ptr<const msgs::Image> &_msg)
+      {
+        this->OnImageMsg(_msg);
+      });
+  if (!this->dataPtr->subscription)
+  {
+    ignerr << "Unable to subscribe to topic [" << topic << "]" << std::endl;
+    return;
+  }
+  hub->SetMsgsPerSec(this->dataPtr->subscription, this->MsgsPerSec());
+}
+
+/////////////////////////////////////////////////
+void ImageDisplay::Suspend()
+{
+  this->dataPtr->suspended = true;
+  SubscriptionHub::Instance()->Unsubscribe(this->dataPtr->subscription);
+  this->dataPtr->subscription = 0;
+}
+
+/////////////////////////////////////////////////
+void ImageDisplay::Resume()
+{
+  this->dataPtr->suspended = false;
+  if (!this->dataPtr->topic.empty())
+    this->OnTopic(QString::fromStdString(this->dataPtr->topic));
+}
+
+/////////////////////////////////////////////////
+std::size_t ImageDisplay::MemoryUsage() const
+{
+  auto bytes = this->dataPtr->buffers->FreeBytes();
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->imageMutex);
+  if (this->dataPtr->imageMsg)
+    bytes += this->dataPtr->imageMsg->data().size();
+  return bytes;
+}
+
+/////////////////////////////////////////////////
+bool ImageDisplay::KeepLoaded() const
+{
+  return true;
+}
+
+/////////////////////////////////////////////////
+void ImageDisplay::OnRefresh()
+{
+  // Clear
+  this->dataPtr->topicList.clear();
+
+  // Get updated list from the shared cache, and have it checked again so
+  // topics which just showed up are there next time
+  auto registry = TopicRegistry::Instance();
+  for (const auto &topic : registry->Topics("ignition.msgs.Image"))
+    this->dataPtr->topicList.push_back(QString::fromStdString(topic));
+  registry->Refresh();
+
+  // Select first one
+  if (this->dataPtr->topicList.count() > 0)
+    this->OnTopic(this->dataPtr->topicList.at(0));
+  this->TopicListChanged();
 }
 
 /////////////////////////////////////////////////
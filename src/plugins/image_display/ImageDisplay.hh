@@ -44,6 +44,45 @@ namespace plugins
   /// \<topic\> : Set the topic to receive image messages.
   /// \<topic_picker\> : Whether to show the topic picker, true by default. If
   ///                    this is false, a \<topic\> must be specified.
+  /// \<max_rate\> : Maximum rate in Hz at which images are shown, no limit by
+  ///                default.
+  /// \<colormap\> : Colors depth and 16 bit images are shown with, one of
+  ///                gray, turbo, jet and inferno. Defaults to gray. Can be
+  ///                changed from the card too.
+  /// \<range_mode\> : How the range depth and 16 bit images are shown
+  ///                  across is found, one of:
+  ///                  * full: smallest and largest values of each image,
+  ///                    the default.
+  ///                  * fixed: from \<range_min\> to \<range_max\>, so
+  ///                    nothing is computed. Depths are always shown from
+  ///                    zero to \<range_max\>.
+  ///                  * percentile: percentiles of a subset of the pixels,
+  ///                    smoothed over time, so that outliers don't rescale
+  ///                    the image and the range doesn't flicker.
+  /// \<range_min\>, \<range_max\> : Range of the fixed mode.
+  /// \<range_percentile\> : Upper percentile of the percentile mode, 98 by
+  ///                        default. The lower one is 100 minus it.
+  ///
+  /// Images are converted on a background thread. Msgs which arrive while
+  /// one is being converted, or while waiting for the max rate, replace each
+  /// other, so only the newest one is shown. The replaced ones are counted
+  /// and shown as dropped frames.
+  ///
+  /// The card can be zoomed into with the mouse wheel. Only the visible
+  /// part of raw images is converted, skipping pixels which are too small
+  /// to be seen at the size the image is shown at.
+  ///
+  /// Raw RGB_INT8, R_FLOAT32 and L_INT16 pixels are shown, on the GPU when
+  /// it can. The formats in PixelFormats, such as RGBA_INT8, BGR_INT8,
+  /// L_INT8 and 8 bit Bayer mosaics, are converted to RGB first. Msgs may
+  /// also carry a whole JPEG or PNG file as their data, which is decoded in
+  /// the background. Leave the pixel format unset for those, or set it to the
+  /// format of the decoded image.
+  ///
+  /// Publishers on the same host can leave the pixels in shared memory with
+  /// a SharedImageWriter and publish msgs which only refer to them. Those
+  /// are read straight from shared memory, skipping transport, and are
+  /// counted as dropped if the publisher already replaced them.
   class ImageDisplay : public Plugin
   {
     Q_OBJECT
@@ -56,6 +95,21 @@ namespace plugins
       NOTIFY TopicListChanged
     )
 
+    /// \brief Number of frames replaced by newer ones before being shown
+    Q_PROPERTY(
+      unsigned int droppedFrames
+      READ DroppedFrames
+      NOTIFY DroppedFramesChanged
+    )
+
+    /// \brief Colors depth and 16 bit images are shown with
+    Q_PROPERTY(
+      QString colormap
+      READ Colormap
+      WRITE SetColormap
+      NOTIFY ColormapChanged
+    )
+
     /// \brief Constructor
     public: ImageDisplay();
 
@@ -71,6 +125,19 @@ namespace plugins
     /// \brief Callback when a new topic is chosen on the combo box.
     public slots: void OnTopic(const QString _topic);
 
+    // Documentation inherited
+    protected: void Suspend() override;
+
+    // Documentation inherited
+    protected: void Resume() override;
+
+    // Documentation inherited
+    public: std::size_t MemoryUsage() const override;
+
+    /// \brief The image item is registered with QML.
+    /// \return True
+    public: bool KeepLoaded() const override;
+
     /// \brief Get the topic list as a string, for example
     /// 'ignition.msgs.StringMsg'
     /// \return Message type
@@ -84,24 +151,49 @@ namespace plugins
     /// \brief Notify that topic list has changed
     signals: void TopicListChanged();
 
+    /// \brief Get the number of frames which were replaced by newer ones
+    /// before being shown.
+    /// \return Dropped frame count
+    public: Q_INVOKABLE unsigned int DroppedFrames() const;
+
+    /// \brief Notify that the dropped frame count has changed
+    signals: void DroppedFramesChanged();
+
+    /// \brief Get the colors depth and 16 bit images are shown with.
+    /// \return Colormap name, such as gray or turbo
+    public: Q_INVOKABLE QString Colormap() const;
+
+    /// \brief Set the colors depth and 16 bit images are shown with, from
+    /// the next image on.
+    /// \param[in] _colormap One of gray, turbo, jet and inferno
+    public: Q_INVOKABLE void SetColormap(const QString &_colormap);
+
+    /// \brief Notify that the colormap has changed
+    signals: void ColormapChanged();
+
+    /// \brief Set the part of the image which is visible, and the size it's
+    /// shown at. Only those pixels are converted, at that resolution. The
+    /// last image is shown again for the new view.
+    /// \param[in] _x Left edge, as a fraction of the image width
+    /// \param[in] _y Top edge, as a fraction of the image height
+    /// \param[in] _width Width, as a fraction of the image width
+    /// \param[in] _height Height, as a fraction of the image height
+    /// \param[in] _outWidth Width shown at in pixels, 0 if unknown
+    /// \param[in] _outHeight Height shown at in pixels, 0 if unknown
+    public: Q_INVOKABLE void SetView(const double _x, const double _y,
+        const double _width, const double _height, const int _outWidth,
+        const int _outHeight);
+
     /// \brief Notify that a new image has been received.
     signals: void newImage();
 
-    /// \brief Callback in main thread when image changes
-    private slots: void ProcessImage();
-
-    /// \brief Update from rx'd RGB_INT8
-    private: void UpdateFromRgbInt8();
-
-    /// \brief Update from rx'd R_FLOAT32
-    private: void UpdateFromFloat32();
-
-    /// \brief Update from L_INT16
-    private: void UpdateFromLInt16();
+    /// \brief Callback in main thread when a converted image is ready
+    private slots: void OnImageReady();
 
     /// \brief Subscriber callback when new image is received
-    /// \param[in] _msg New image
-    private: void OnImageMsg(const ignition::msgs::Image &_msg);
+    /// \param[in] _msg New image, shared with other subscribers
+    private: void OnImageMsg(
+        const std::shared_ptr<const ignition::msgs::Image> &_msg);
 
     /// \internal
     /// \brief Pointer to private data.
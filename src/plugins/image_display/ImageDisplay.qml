@@ -18,6 +18,8 @@ import QtQuick 2.9
 import QtQuick.Controls 2.2
 import QtQuick.Controls.Material 2.1
 import QtQuick.Layouts 1.3
+import QtQuick.Window 2.2
+import ImageDisplayItem 1.0
 
 Rectangle {
   id: "imageDisplay"
@@ -86,15 +88,113 @@ Rectangle {
         ToolTip.text: qsTr("Ignition transport topics publishing Image messages")
       }
     }
-    Image {
-      id: image
-      fillMode: Image.PreserveAspectFit
+    RowLayout {
+      Label {
+        text: "Colormap"
+      }
+      ComboBox {
+        id: colormapCombo
+        Layout.fillWidth: true
+        model: ["gray", "turbo", "jet", "inferno"]
+        currentIndex: model.indexOf(ImageDisplay.colormap)
+        onActivated: {
+          ImageDisplay.SetColormap(textAt(index));
+        }
+        ToolTip.visible: hovered
+        ToolTip.delay: tooltipDelay
+        ToolTip.timeout: tooltipTimeout
+        ToolTip.text: qsTr("Colors depth and 16 bit images are shown with")
+      }
+    }
+    /*
+     * Zoomed with the wheel around the center and panned by dragging,
+     * double click to see the whole image again. Only the visible part of
+     * images is converted, so both image items show just that part.
+     */
+    Item {
+      id: view
+      clip: true
       Layout.fillHeight: true
       Layout.fillWidth: true
-      verticalAlignment: Image.AlignTop
-      function reload() {
-        // Force image request to C++
-        source = "image://" + uniqueName + "/" + Math.random().toString(36).substr(2, 5);
+
+      /**
+       * Magnification, 1 shows the whole image
+       */
+      property real zoom: 1.0
+
+      /**
+       * Center of the visible part, as fractions of the image size
+       */
+      property real centerX: 0.5
+      property real centerY: 0.5
+
+      function update() {
+        var half = 0.5 / zoom;
+        centerX = Math.min(Math.max(centerX, half), 1.0 - half);
+        centerY = Math.min(Math.max(centerY, half), 1.0 - half);
+        ImageDisplay.SetView(centerX - half, centerY - half, 2 * half,
+            2 * half, width * Screen.devicePixelRatio,
+            height * Screen.devicePixelRatio);
+      }
+
+      onWidthChanged: update();
+      onHeightChanged: update();
+
+      /*
+       * Draws images on the GPU when the graphics context allows
+       */
+      ImageDisplayItem {
+        id: gpuImage
+        visible: supported
+        anchors.fill: parent
+      }
+      Image {
+        id: image
+        visible: !gpuImage.supported
+        fillMode: Image.PreserveAspectFit
+        anchors.fill: parent
+        verticalAlignment: Image.AlignTop
+        function reload() {
+          // Force image request to C++
+          source = "image://" + uniqueName + "/" + Math.random().toString(36).substr(2, 5);
+        }
+      }
+      MouseArea {
+        anchors.fill: parent
+        property point last
+        onPressed: {
+          last = Qt.point(mouse.x, mouse.y);
+        }
+        onPositionChanged: {
+          view.centerX -= (mouse.x - last.x) / (width * view.zoom);
+          view.centerY -= (mouse.y - last.y) / (height * view.zoom);
+          last = Qt.point(mouse.x, mouse.y);
+          view.update();
+        }
+        onWheel: {
+          var factor = wheel.angleDelta.y > 0 ? 1.25 : 0.8;
+          view.zoom = Math.min(Math.max(view.zoom * factor, 1.0), 64.0);
+          view.update();
+        }
+        onDoubleClicked: {
+          view.zoom = 1.0;
+          view.centerX = 0.5;
+          view.centerY = 0.5;
+          view.update();
+        }
+      }
+    }
+    Label {
+      visible: ImageDisplay.droppedFrames > 0
+      text: "Dropped frames: " + ImageDisplay.droppedFrames
+      ToolTip.visible: droppedArea.containsMouse
+      ToolTip.delay: tooltipDelay
+      ToolTip.timeout: tooltipTimeout
+      ToolTip.text: qsTr("Images replaced by newer ones before being shown")
+      MouseArea {
+        id: droppedArea
+        anchors.fill: parent
+        hoverEnabled: true
       }
     }
   }
@@ -0,0 +1,494 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "ImageDisplayItem.hh"
+
+#include <QSGGeometryNode>
+#include <QSGMaterial>
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+
+#include <ignition/common/Console.hh>
+
+// Sized formats which the OpenGL ES 2 headers don't have
+#ifndef GL_RED
+#define GL_RED 0x1903
+#endif
+#ifndef GL_RG
+#define GL_RG 0x8227
+#endif
+#ifndef GL_RG8
+#define GL_RG8 0x822B
+#endif
+#ifndef GL_R32F
+#define GL_R32F 0x822E
+#endif
+#ifndef GL_UNPACK_ROW_LENGTH
+#define GL_UNPACK_ROW_LENGTH 0x0CF2
+#endif
+
+namespace ignition
+{
+namespace gui
+{
+namespace plugins
+{
+  class ImageDisplayItemPrivate
+  {
+    /// \brief Protects frame and framePending
+    public: std::mutex mutex;
+
+    /// \brief Frame to draw next
+    public: ImageDisplayItem::Frame frame;
+
+    /// \brief True if frame wasn't uploaded yet
+    public: bool framePending{false};
+
+    /// \brief False once the item was found out to be unsupported
+    public: std::atomic<bool> supported{true};
+
+    /// \brief True once support was checked
+    public: bool checked{false};
+  };
+
+  /// \brief Material sampling the frame texture
+  class ImageMaterial : public QSGMaterial
+  {
+    // Documentation inherited
+    public: QSGMaterialType *type() const override
+    {
+      static QSGMaterialType type;
+      return &type;
+    }
+
+    // Documentation inherited
+    public: QSGMaterialShader *createShader() const override;
+
+    /// \brief Frame texture, owned by the node
+    public: GLuint texture{0u};
+
+    /// \brief Pixel format of the texture
+    public: ImageDisplayItem::Format format{
+        ImageDisplayItem::Format::RGB_INT8};
+
+    /// \brief See Frame::offset
+    public: float offset{0.0f};
+
+    /// \brief See Frame::scale
+    public: float scale{1.0f};
+
+    /// \brief Colormap texture, owned by the node, 0 for gray
+    public: GLuint colormapTexture{0u};
+  };
+
+  /// \brief Shader turning frame texels into colors
+  class ImageShader : public QSGMaterialShader
+  {
+    // Documentation inherited
+    public: const char *vertexShader() const override
+    {
+      return
+        "uniform highp mat4 qt_Matrix;\n"
+        "attribute highp vec4 qt_VertexPosition;\n"
+        "attribute highp vec2 qt_VertexTexCoord;\n"
+        "varying highp vec2 texCoord;\n"
+        "void main()\n"
+        "{\n"
+        "  texCoord = qt_VertexTexCoord;\n"
+        "  gl_Position = qt_Matrix * qt_VertexPosition;\n"
+        "}\n";
+    }
+
+    // Documentation inherited
+    public: const char *fragmentShader() const override
+    {
+      // Mode 0 is RGB, 1 is depth and 2 is 16 bit values, stored as two
+      // bytes in the red and green channels so that the texture works the
+      // same on OpenGL and OpenGL ES. Gray levels are looked up in the
+      // 256 texel wide colormap texture when there's one.
+      return
+        "uniform sampler2D image;\n"
+        "uniform sampler2D colormap;\n"
+        "uniform bool colored;\n"
+        "uniform lowp float qt_Opacity;\n"
+        "uniform int mode;\n"
+        "uniform highp float offset;\n"
+        "uniform highp float scale;\n"
+        "varying highp vec2 texCoord;\n"
+        "void main()\n"
+        "{\n"
+        "  highp vec4 t = texture2D(image, texCoord);\n"
+        "  if (mode == 0)\n"
+        "  {\n"
+        "    gl_FragColor = vec4(t.rgb, 1.0) * qt_Opacity;\n"
+        "    return;\n"
+        "  }\n"
+        "  highp float g;\n"
+        "  if (mode == 1)\n"
+        "    g = 1.0 - t.r * scale;\n"
+        "  else\n"
+        "    g = (t.r * 255.0 + t.g * 65280.0 - offset) * scale;\n"
+        "  // Also catches NaN and infinite depths\n"
+        "  if (!(g > 0.0))\n"
+        "    g = 0.0;\n"
+        "  g = min(g, 1.0);\n"
+        "  if (colored)\n"
+        "  {\n"
+        "    highp vec2 c = vec2((g * 255.0 + 0.5) / 256.0, 0.5);\n"
+        "    gl_FragColor = vec4(texture2D(colormap, c).rgb, 1.0) *\n"
+        "        qt_Opacity;\n"
+        "    return;\n"
+        "  }\n"
+        "  gl_FragColor = vec4(vec3(g), 1.0) * qt_Opacity;\n"
+        "}\n";
+    }
+
+    // Documentation inherited
+    public: char const *const *attributeNames() const override
+    {
+      static const char *names[] =
+          {"qt_VertexPosition", "qt_VertexTexCoord", nullptr};
+      return names;
+    }
+
+    // Documentation inherited
+    public: void updateState(const RenderState &_state,
+        QSGMaterial *_newMaterial, QSGMaterial *) override
+    {
+      auto program = this->program();
+      if (_state.isMatrixDirty())
+        program->setUniformValue(this->matrixId, _state.combinedMatrix());
+      if (_state.isOpacityDirty())
+        program->setUniformValue(this->opacityId, _state.opacity());
+
+      auto material = static_cast<ImageMaterial *>(_newMaterial);
+      auto f = QOpenGLContext::currentContext()->functions();
+      if (material->colormapTexture != 0u)
+      {
+        f->glActiveTexture(GL_TEXTURE1);
+        f->glBindTexture(GL_TEXTURE_2D, material->colormapTexture);
+      }
+      f->glActiveTexture(GL_TEXTURE0);
+      f->glBindTexture(GL_TEXTURE_2D, material->texture);
+
+      int mode = 0;
+      if (material->format == ImageDisplayItem::Format::R_FLOAT32)
+        mode = 1;
+      else if (material->format == ImageDisplayItem::Format::L_INT16)
+        mode = 2;
+      program->setUniformValue(this->modeId, mode);
+      program->setUniformValue(this->offsetId, material->offset);
+      program->setUniformValue(this->scaleId, material->scale);
+      program->setUniformValue(this->coloredId,
+          material->colormapTexture != 0u ? 1 : 0);
+    }
+
+    // Documentation inherited
+    protected: void initialize() override
+    {
+      auto program = this->program();
+      this->matrixId = program->uniformLocation("qt_Matrix");
+      this->opacityId = program->uniformLocation("qt_Opacity");
+      this->modeId = program->uniformLocation("mode");
+      this->offsetId = program->uniformLocation("offset");
+      this->scaleId = program->uniformLocation("scale");
+      this->coloredId = program->uniformLocation("colored");
+      program->setUniformValue("image", 0);
+      program->setUniformValue("colormap", 1);
+    }
+
+    /// \brief Uniform locations
+    private: int matrixId{-1};
+    private: int opacityId{-1};
+    private: int modeId{-1};
+    private: int offsetId{-1};
+    private: int scaleId{-1};
+    private: int coloredId{-1};
+  };
+
+  /// \brief Node drawing the frame texture, which it owns
+  class ImageNode : public QSGGeometryNode
+  {
+    /// \brief Constructor
+    public: ImageNode()
+      : geometry(QSGGeometry::defaultAttributes_TexturedPoint2D(), 4)
+    {
+      this->setGeometry(&this->geometry);
+      this->setMaterial(&this->material);
+    }
+
+    /// \brief Destructor, called on the render thread
+    public: ~ImageNode() override
+    {
+      auto f = QOpenGLContext::currentContext()->functions();
+      if (this->material.texture != 0u)
+        f->glDeleteTextures(1, &this->material.texture);
+      if (this->material.colormapTexture != 0u)
+        f->glDeleteTextures(1, &this->material.colormapTexture);
+    }
+
+    /// \brief Upload a frame into the texture, which is only reallocated
+    /// when the size or format changes.
+    /// \param[in] _frame Frame
+    public: void Upload(const ImageDisplayItem::Frame &_frame)
+    {
+      auto f = QOpenGLContext::currentContext()->functions();
+      if (this->material.texture == 0u)
+      {
+        f->glGenTextures(1, &this->material.texture);
+        f->glBindTexture(GL_TEXTURE_2D, this->material.texture);
+        // Float and packed textures can't be filtered
+        f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S,
+            GL_CLAMP_TO_EDGE);
+        f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T,
+            GL_CLAMP_TO_EDGE);
+      }
+      else
+      {
+        f->glBindTexture(GL_TEXTURE_2D, this->material.texture);
+      }
+
+      GLint internalFormat = GL_RGB;
+      GLenum format = GL_RGB;
+      GLenum type = GL_UNSIGNED_BYTE;
+      unsigned int pixelSize = 3u;
+      switch (_frame.format)
+      {
+        case ImageDisplayItem::Format::RGB_INT8:
+          break;
+        case ImageDisplayItem::Format::R_FLOAT32:
+          internalFormat = GL_R32F;
+          format = GL_RED;
+          type = GL_FLOAT;
+          pixelSize = sizeof(float);
+          break;
+        case ImageDisplayItem::Format::L_INT16:
+          internalFormat = GL_RG8;
+          format = GL_RG;
+          pixelSize = sizeof(uint16_t);
+          break;
+      }
+
+      int rowLength = 0;
+      if (_frame.step != _frame.width * pixelSize)
+        rowLength = _frame.step / pixelSize;
+
+      f->glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+      if (rowLength > 0)
+        f->glPixelStorei(GL_UNPACK_ROW_LENGTH, rowLength);
+
+      auto size = QSize(_frame.width, _frame.height);
+      if (size != this->textureSize || _frame.format != this->material.format)
+      {
+        f->glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, _frame.width,
+            _frame.height, 0, format, type, _frame.data.data());
+        this->textureSize = size;
+        this->material.format = _frame.format;
+      }
+      else
+      {
+        f->glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, _frame.width,
+            _frame.height, format, type, _frame.data.data());
+      }
+
+      if (rowLength > 0)
+        f->glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+      f->glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+      this->material.offset = _frame.offset;
+      this->material.scale = _frame.scale;
+      this->SetColormap(_frame.format == ImageDisplayItem::Format::RGB_INT8 ?
+          Colormap::GRAY : _frame.colormap);
+      this->markDirty(QSGNode::DirtyMaterial);
+    }
+
+    /// \brief Upload the colors of a colormap into the colormap texture,
+    /// if it changed. Gray needs no texture.
+    /// \param[in] _colormap Colormap
+    public: void SetColormap(const Colormap _colormap)
+    {
+      if (_colormap == this->colormap)
+        return;
+      this->colormap = _colormap;
+
+      auto f = QOpenGLContext::currentContext()->functions();
+      if (_colormap == Colormap::GRAY)
+      {
+        if (this->material.colormapTexture != 0u)
+          f->glDeleteTextures(1, &this->material.colormapTexture);
+        this->material.colormapTexture = 0u;
+        return;
+      }
+
+      // Packed 0xffRRGGBB colors, as bytes in RGBA order
+      const auto &table = ColormapLut::Table(_colormap);
+      std::array<std::uint8_t, 256 * 4> texels;
+      for (std::size_t i = 0u; i < table.size(); ++i)
+      {
+        texels[i * 4u] = (table[i] >> 16) & 0xffu;
+        texels[i * 4u + 1u] = (table[i] >> 8) & 0xffu;
+        texels[i * 4u + 2u] = table[i] & 0xffu;
+        texels[i * 4u + 3u] = 0xffu;
+      }
+
+      if (this->material.colormapTexture == 0u)
+      {
+        f->glGenTextures(1, &this->material.colormapTexture);
+        f->glBindTexture(GL_TEXTURE_2D, this->material.colormapTexture);
+        f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S,
+            GL_CLAMP_TO_EDGE);
+        f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T,
+            GL_CLAMP_TO_EDGE);
+      }
+      else
+      {
+        f->glBindTexture(GL_TEXTURE_2D, this->material.colormapTexture);
+      }
+      f->glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 256, 1, 0, GL_RGBA,
+          GL_UNSIGNED_BYTE, texels.data());
+    }
+
+    /// \brief Fit the frame in a rectangle, keeping its aspect ratio and
+    /// aligning it to the top like the image provider path.
+    /// \param[in] _rect Item rectangle
+    public: void Fit(const QRectF &_rect)
+    {
+      if (this->textureSize.isEmpty())
+        return;
+
+      auto size = QSizeF(this->textureSize).scaled(_rect.size(),
+          Qt::KeepAspectRatio);
+      QRectF rect(_rect.x() + (_rect.width() - size.width()) * 0.5,
+          _rect.y(), size.width(), size.height());
+      if (rect == this->rect)
+        return;
+
+      QSGGeometry::updateTexturedRectGeometry(&this->geometry, rect,
+          QRectF(0, 0, 1, 1));
+      this->rect = rect;
+      this->markDirty(QSGNode::DirtyGeometry);
+    }
+
+    /// \brief Quad the texture is drawn on
+    private: QSGGeometry geometry;
+
+    /// \brief Material drawing the texture
+    private: ImageMaterial material;
+
+    /// \brief Size of the texture, empty until the first upload
+    private: QSize textureSize;
+
+    /// \brief Colormap in the colormap texture
+    private: Colormap colormap{Colormap::GRAY};
+
+    /// \brief Rectangle the quad covers
+    private: QRectF rect;
+  };
+}
+}
+}
+
+using namespace ignition;
+using namespace gui;
+using namespace plugins;
+
+/////////////////////////////////////////////////
+QSGMaterialShader *ImageMaterial::createShader() const
+{
+  return new ImageShader();
+}
+
+/////////////////////////////////////////////////
+ImageDisplayItem::ImageDisplayItem(QQuickItem *_parent)
+  : QQuickItem(_parent), dataPtr(new ImageDisplayItemPrivate)
+{
+  this->setFlag(ItemHasContents);
+}
+
+/////////////////////////////////////////////////
+ImageDisplayItem::~ImageDisplayItem()
+{
+}
+
+/////////////////////////////////////////////////
+bool ImageDisplayItem::Supported() const
+{
+  return this->dataPtr->supported;
+}
+
+/////////////////////////////////////////////////
+void ImageDisplayItem::SetFrame(Frame &_frame)
+{
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    std::swap(this->dataPtr->frame, _frame);
+    this->dataPtr->framePending = true;
+  }
+
+  // Must be called on the GUI thread
+  QMetaObject::invokeMethod(this, "update");
+}
+
+/////////////////////////////////////////////////
+QSGNode *ImageDisplayItem::updatePaintNode(QSGNode *_node,
+    QQuickItem::UpdatePaintNodeData *)
+{
+  if (!this->dataPtr->checked)
+  {
+    this->dataPtr->checked = true;
+    auto context = QOpenGLContext::currentContext();
+    if (!context || context->format().majorVersion() < 3)
+    {
+      ignwarn << "Image display needs OpenGL 3.0 or OpenGL ES 3.0 to draw "
+              << "images on the GPU, converting them on the CPU instead"
+              << std::endl;
+      this->dataPtr->supported = false;
+      QMetaObject::invokeMethod(this, "SupportedChanged");
+    }
+  }
+
+  if (!this->dataPtr->supported)
+  {
+    delete _node;
+    return nullptr;
+  }
+
+  auto node = static_cast<ImageNode *>(_node);
+
+  std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+  if (!node && !this->dataPtr->framePending)
+    return nullptr;
+
+  if (!node)
+    node = new ImageNode();
+
+  if (this->dataPtr->framePending)
+  {
+    node->Upload(this->dataPtr->frame);
+    this->dataPtr->framePending = false;
+  }
+  lock.unlock();
+
+  node->Fit(this->boundingRect());
+  return node;
+}
@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGNITION_GUI_PLUGINS_IMAGEDISPLAY_IMAGEDISPLAYITEM_HH_
+#define IGNITION_GUI_PLUGINS_IMAGEDISPLAY_IMAGEDISPLAYITEM_HH_
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "ignition/gui/qt.h"
+
+#include "Colormap.hh"
+
+namespace ignition
+{
+namespace gui
+{
+namespace plugins
+{
+  class ImageDisplayItemPrivate;
+
+  /// \brief Quick item drawing raw image data from a texture of its own.
+  ///
+  /// Frames are uploaded as they come into a texture which is kept across
+  /// frames, and gray levels for depth and 16 bit images are computed by a
+  /// fragment shader, which colors them through a colormap texture. Needs
+  /// OpenGL 3.0 or OpenGL ES 3.0, which is checked the first time the item
+  /// is drawn; if that fails, Supported turns false and frames are ignored.
+  class ImageDisplayItem : public QQuickItem
+  {
+    Q_OBJECT
+
+    /// \brief Whether frames can be drawn
+    Q_PROPERTY(
+      bool supported
+      READ Supported
+      NOTIFY SupportedChanged
+    )
+
+    /// \brief How pixels are stored and shown
+    public: enum class Format
+    {
+      /// \brief 8 bit RGB, shown as is
+      RGB_INT8,
+
+      /// \brief Float depth, near is white and far is black
+      R_FLOAT32,
+
+      /// \brief Unsigned 16 bit values, scaled to gray across a range
+      L_INT16
+    };
+
+    /// \brief A frame waiting to be drawn
+    public: struct Frame
+    {
+      /// \brief Pixel data, rows are step bytes apart
+      std::string data;
+
+      /// \brief Pixel format
+      Format format;
+
+      /// \brief Width in pixels
+      unsigned int width;
+
+      /// \brief Height in pixels
+      unsigned int height;
+
+      /// \brief Bytes per row, a whole number of pixels
+      unsigned int step;
+
+      /// \brief Value shown as black for L_INT16
+      float offset;
+
+      /// \brief Factor bringing values into [0, 1] once offset is removed,
+      /// 1 / farthest depth for R_FLOAT32 and 1 / range for L_INT16
+      float scale;
+
+      /// \brief Colors R_FLOAT32 and L_INT16 frames are shown with
+      Colormap colormap{Colormap::GRAY};
+    };
+
+    /// \brief Constructor
+    /// \param[in] _parent Parent item
+    public: explicit ImageDisplayItem(QQuickItem *_parent = nullptr);
+
+    /// \brief Destructor
+    public: ~ImageDisplayItem() override;
+
+    /// \brief Whether frames can be drawn. True until the first time the
+    /// item is drawn, where it's found out. Can be called from any thread.
+    /// \return False if the graphics context can't draw frames
+    public: Q_INVOKABLE bool Supported() const;
+
+    /// \brief Replace the frame to draw next. Can be called from any thread.
+    /// \param[in] _frame Frame, its data is taken
+    public: void SetFrame(Frame &_frame);
+
+    /// \brief Notify that support was found out to be missing
+    signals: void SupportedChanged();
+
+    // Documentation inherited
+    protected: QSGNode *updatePaintNode(QSGNode *_oldNode,
+        QQuickItem::UpdatePaintNodeData *_data) override;
+
+    /// \internal
+    /// \brief Pointer to private data.
+    private: std::unique_ptr<ImageDisplayItemPrivate> dataPtr;
+  };
+}
+}
+}
+
+#endif
@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGNITION_GUI_PLUGINS_IMAGEDISPLAY_IMAGERANGE_HH_
+#define IGNITION_GUI_PLUGINS_IMAGEDISPLAY_IMAGERANGE_HH_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace ignition
+{
+namespace gui
+{
+namespace plugins
+{
+  /// \brief How the range depth and 16 bit images are normalized across is
+  /// found.
+  enum class RangeMode
+  {
+    /// \brief Smallest and largest values of each image
+    FULL = 0,
+
+    /// \brief Range given in the config, nothing is computed
+    FIXED,
+
+    /// \brief Percentiles of a subset of the pixels, smoothed over time
+    PERCENTILE
+  };
+
+  /// \brief Estimates the range of images from percentiles of a subset of
+  /// their pixels, so that a few outliers don't squash all other values
+  /// into a handful of gray levels. At most kMaxSamples pixels are looked
+  /// at, on a regular grid, and the range is smoothed over frames so that
+  /// it doesn't flicker.
+  class ImageRange
+  {
+    /// \brief Most pixels looked at per image
+    public: static constexpr std::size_t kMaxSamples = 4096u;
+
+    /// \brief Weight of each new image in the smoothed range
+    public: static constexpr double kSmoothing = 0.2;
+
+    /// \brief Get a mode's name, as used in configs.
+    /// \param[in] _mode Mode
+    /// \return Lowercase name
+    public: static std::string Name(const RangeMode _mode)
+    {
+      switch (_mode)
+      {
+        case RangeMode::FIXED:
+          return "fixed";
+        case RangeMode::PERCENTILE:
+          return "percentile";
+        default:
+          return "full";
+      }
+    }
+
+    /// \brief Get a mode from its name.
+    /// \param[in] _name Lowercase name
+    /// \param[out] _mode Mode, unchanged if the name is unknown
+    /// \return False if the name is unknown
+    public: static bool FromName(const std::string &_name, RangeMode &_mode)
+    {
+      for (auto mode : {RangeMode::FULL, RangeMode::FIXED,
+          RangeMode::PERCENTILE})
+      {
+        if (Name(mode) == _name)
+        {
+          _mode = mode;
+          return true;
+        }
+      }
+      return false;
+    }
+
+    /// \brief Set the percentiles taken as the ends of the range.
+    /// \param[in] _upper Upper percentile, such as 98, the lower one being
+    /// 100 minus it. Clamped to [50, 100].
+    public: void SetPercentile(const double _upper)
+    {
+      this->upper = std::min(std::max(_upper, 50.0), 100.0) / 100.0;
+    }
+
+    /// \brief Forget the smoothed range, so that the next image sets it.
+    public: void Reset()
+    {
+      this->started = false;
+    }
+
+    /// \brief Update the range with an image.
+    /// \param[in] _data First row of pixels, possibly unaligned
+    /// \param[in] _width Pixels per row
+    /// \param[in] _height Number of rows
+    /// \param[in] _step Bytes per row
+    /// \param[out] _min Smoothed lower end of the range
+    /// \param[out] _max Smoothed upper end of the range
+    /// \return False if the image has no finite pixels, then the range is
+    /// unchanged
+    public: template <typename T>
+    bool Update(const void *_data, const unsigned int _width,
+        const unsigned int _height, const unsigned int _step, double &_min,
+        double &_max)
+    {
+      // Same stride across and down, so that samples spread evenly
+      std::size_t stride = 1u;
+      std::size_t count = static_cast<std::size_t>(_width) * _height;
+      if (count > kMaxSamples)
+      {
+        stride = static_cast<std::size_t>(
+            std::ceil(std::sqrt(static_cast<double>(count) / kMaxSamples)));
+      }
+
+      this->samples.clear();
+      auto bytes = static_cast<const char *>(_data);
+      for (std::size_t j = stride / 2u; j < _height; j += stride)
+      {
+        auto row = bytes + j * _step;
+        for (std::size_t i = stride / 2u; i < _width; i += stride)
+        {
+          T value;
+          std::memcpy(&value, row + i * sizeof(T), sizeof(T));
+          double v = static_cast<double>(value);
+          if (std::isfinite(v))
+            this->samples.push_back(v);
+        }
+      }
+
+      if (this->samples.empty())
+      {
+        _min = this->min;
+        _max = this->max;
+        return false;
+      }
+
+      auto last = this->samples.size() - 1u;
+      auto high = static_cast<std::size_t>(this->upper * last + 0.5);
+      auto low = last - high;
+      std::nth_element(this->samples.begin(), this->samples.begin() + high,
+          this->samples.end());
+      double newMax = this->samples[high];
+      std::nth_element(this->samples.begin(), this->samples.begin() + low,
+          this->samples.begin() + high);
+      double newMin = this->samples[low];
+
+      if (this->started)
+      {
+        this->min += kSmoothing * (newMin - this->min);
+        this->max += kSmoothing * (newMax - this->max);
+      }
+      else
+      {
+        this->min = newMin;
+        this->max = newMax;
+        this->started = true;
+      }
+
+      _min = this->min;
+      _max = this->max;
+      return true;
+    }
+
+    /// \brief Upper percentile, as a fraction
+    private: double upper{0.98};
+
+    /// \brief True once the smoothed range was set by an image
+    private: bool started{false};
+
+    /// \brief Smoothed lower end of the range
+    private: double min{0.0};
+
+    /// \brief Smoothed upper end of the range
+    private: double max{0.0};
+
+    /// \brief Sampled pixels, reused across images
+    private: std::vector<double> samples;
+  };
+}
+}
+}
+
+#endif
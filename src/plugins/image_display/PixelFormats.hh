@@ -0,0 +1,322 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGNITION_GUI_PLUGINS_IMAGEDISPLAY_PIXELFORMATS_HH_
+#define IGNITION_GUI_PLUGINS_IMAGEDISPLAY_PIXELFORMATS_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+
+#if defined(__SSSE3__)
+#define IGN_GUI_PIXELFORMATS_SSSE3
+#include <tmmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define IGN_GUI_PIXELFORMATS_NEON
+#include <arm_neon.h>
+#endif
+
+// TODO(louise) Remove these pragmas once ign-msgs is disabling the warnings
+#ifdef _MSC_VER
+#pragma warning(push, 0)
+#endif
+#include <ignition/msgs/image.pb.h>
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+namespace ignition
+{
+namespace gui
+{
+namespace plugins
+{
+  /// \brief Pixel formats which are shown by converting them to 8 bit RGB.
+  ///
+  /// Each format is a traits struct with its msgs::PixelFormatType, its
+  /// bytes per pixel, the size of the pixel blocks it must be cropped in
+  /// and a Convert function writing RGB rows. Most of them
+  /// are instances of the Color and Bayer templates, whose kernels are
+  /// generated from the channel layout at compile time. To show a new
+  /// format, add its traits to Formats. ImageDisplay registers a converter
+  /// for each of them.
+  namespace PixelFormats
+  {
+    /// \brief Packed color pixels, converted to RGB by picking and scaling
+    /// their channels. 8 bit layouts use SSSE3 on x86 when the compiler
+    /// targets it and NEON on 64 bit ARM, the others are plain loops which
+    /// compilers vectorize.
+    /// \tparam Type Pixel format
+    /// \tparam T Channel type, 8 or 16 bits unsigned
+    /// \tparam Channels Channels per pixel
+    /// \tparam Red Index of the red channel
+    /// \tparam Green Index of the green channel
+    /// \tparam Blue Index of the blue channel
+    template <msgs::PixelFormatType Type, typename T, unsigned int Channels,
+        unsigned int Red, unsigned int Green, unsigned int Blue>
+    struct Color
+    {
+      /// \brief Pixel format
+      static constexpr msgs::PixelFormatType kType = Type;
+
+      /// \brief Bytes per pixel
+      static constexpr std::size_t kPixelSize = Channels * sizeof(T);
+
+      /// \brief Pixels are independent
+      static constexpr unsigned int kBlock = 1u;
+
+      /// \brief Bits dropped to turn a channel into 8 bits
+      static constexpr unsigned int kShift = (sizeof(T) - 1u) * 8u;
+
+      /// \brief Plain version of ConvertRow.
+      /// \param[in] _src Pixels, possibly unaligned
+      /// \param[in] _count Number of pixels
+      /// \param[out] _out RGB pixels, _count of them
+      static void ScalarConvertRow(const void *_src,
+          const std::size_t _count, std::uint8_t *_out)
+      {
+        auto src = static_cast<const char *>(_src);
+        for (std::size_t i = 0u; i < _count; ++i, src += kPixelSize)
+        {
+          T pixel[Channels];
+          std::memcpy(pixel, src, kPixelSize);
+          _out[i * 3u] = static_cast<std::uint8_t>(pixel[Red] >> kShift);
+          _out[i * 3u + 1u] =
+              static_cast<std::uint8_t>(pixel[Green] >> kShift);
+          _out[i * 3u + 2u] = static_cast<std::uint8_t>(pixel[Blue] >> kShift);
+        }
+      }
+
+      /// \brief Convert a row of pixels to RGB.
+      /// \param[in] _src Pixels, possibly unaligned
+      /// \param[in] _count Number of pixels
+      /// \param[out] _out RGB pixels, _count of them
+      static void ConvertRow(const void *_src, const std::size_t _count,
+          std::uint8_t *_out)
+      {
+        std::size_t i = 0u;
+#if defined(IGN_GUI_PIXELFORMATS_SSSE3)
+        if constexpr (sizeof(T) == 1u && (Channels == 3u || Channels == 4u))
+        {
+          // One shuffle per 16 source bytes, which hold 4 or 5 pixels.
+          // Stores write 16 bytes, so the last pixels are left to the
+          // plain loop.
+          constexpr std::size_t step = Channels == 4u ? 4u : 5u;
+          constexpr char c = static_cast<char>(Channels);
+          constexpr char r = static_cast<char>(Red);
+          constexpr char g = static_cast<char>(Green);
+          constexpr char b = static_cast<char>(Blue);
+          const __m128i shuffle = _mm_setr_epi8(
+              r, g, b, c + r, c + g, c + b, 2 * c + r, 2 * c + g, 2 * c + b,
+              3 * c + r, 3 * c + g, 3 * c + b,
+              Channels == 4u ? -1 : 4 * c + r,
+              Channels == 4u ? -1 : 4 * c + g,
+              Channels == 4u ? -1 : 4 * c + b, -1);
+          auto src = static_cast<const std::uint8_t *>(_src);
+          for (; i + step + 2u <= _count; i += step)
+          {
+            __m128i v = _mm_loadu_si128(
+                reinterpret_cast<const __m128i *>(src + i * Channels));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(_out + i * 3u),
+                _mm_shuffle_epi8(v, shuffle));
+          }
+        }
+#elif defined(IGN_GUI_PIXELFORMATS_NEON)
+        if constexpr (sizeof(T) == 1u && Channels == 4u)
+        {
+          auto src = static_cast<const std::uint8_t *>(_src);
+          for (; i + 16u <= _count; i += 16u)
+          {
+            uint8x16x4_t v = vld4q_u8(src + i * 4u);
+            uint8x16x3_t rgb = {{v.val[Red], v.val[Green], v.val[Blue]}};
+            vst3q_u8(_out + i * 3u, rgb);
+          }
+        }
+        else if constexpr (sizeof(T) == 1u && Channels == 3u)
+        {
+          auto src = static_cast<const std::uint8_t *>(_src);
+          for (; i + 16u <= _count; i += 16u)
+          {
+            uint8x16x3_t v = vld3q_u8(src + i * 3u);
+            uint8x16x3_t rgb = {{v.val[Red], v.val[Green], v.val[Blue]}};
+            vst3q_u8(_out + i * 3u, rgb);
+          }
+        }
+#endif
+        ScalarConvertRow(static_cast<const char *>(_src) + i * kPixelSize,
+            _count - i, _out + i * 3u);
+      }
+
+      /// \brief Convert an image to RGB.
+      /// \param[in] _src First row of pixels
+      /// \param[in] _width Pixels per row
+      /// \param[in] _height Number of rows
+      /// \param[in] _step Bytes per source row
+      /// \param[out] _out First RGB row, of the same size
+      /// \param[in] _outStep Bytes per RGB row
+      static void Convert(const void *_src, const unsigned int _width,
+          const unsigned int _height, const unsigned int _step,
+          std::uint8_t *_out, const std::size_t _outStep)
+      {
+        auto src = static_cast<const char *>(_src);
+        for (unsigned int j = 0u; j < _height; ++j)
+          ConvertRow(src + j * _step, _width, _out + j * _outStep);
+      }
+    };
+
+    /// \brief 8 bit Bayer mosaics, demosaiced by giving each 2x2 block of
+    /// pixels the red and blue of its block and the mean of its two greens.
+    /// That's a quarter of the resolution in color, which is plenty for a
+    /// preview and keeps the kernel a single pass without neighbors.
+    /// \tparam Type Pixel format
+    /// \tparam RedX Column of the red pixel within a block, 0 or 1
+    /// \tparam RedY Row of the red pixel within a block, 0 or 1
+    template <msgs::PixelFormatType Type, unsigned int RedX,
+        unsigned int RedY>
+    struct Bayer
+    {
+      /// \brief Pixel format
+      static constexpr msgs::PixelFormatType kType = Type;
+
+      /// \brief Bytes per pixel
+      static constexpr std::size_t kPixelSize = 1u;
+
+      /// \brief Colors come from 2x2 blocks
+      static constexpr unsigned int kBlock = 2u;
+
+      /// \brief Convert an image to RGB. An odd last row or column repeats
+      /// the colors of the one before it, and images without a whole block
+      /// are black.
+      /// \param[in] _src First row of pixels
+      /// \param[in] _width Pixels per row
+      /// \param[in] _height Number of rows
+      /// \param[in] _step Bytes per source row
+      /// \param[out] _out First RGB row, of the same size
+      /// \param[in] _outStep Bytes per RGB row
+      static void Convert(const void *_src, const unsigned int _width,
+          const unsigned int _height, const unsigned int _step,
+          std::uint8_t *_out, const std::size_t _outStep)
+      {
+        // Blue is across from red, greens are on the other diagonal
+        constexpr unsigned int blueX = 1u - RedX;
+        constexpr unsigned int blueY = 1u - RedY;
+
+        if (_width < 2u || _height < 2u)
+        {
+          for (unsigned int j = 0u; j < _height; ++j)
+            std::memset(_out + j * _outStep, 0, _width * 3u);
+          return;
+        }
+
+        auto src = static_cast<const std::uint8_t *>(_src);
+        unsigned int evenWidth = _width & ~1u;
+        for (unsigned int j = 0u; j + 1u < _height; j += 2u)
+        {
+          const std::uint8_t *rows[2] = {src + j * _step,
+              src + (j + 1u) * _step};
+          std::uint8_t *out[2] = {_out + j * _outStep,
+              _out + (j + 1u) * _outStep};
+          for (unsigned int i = 0u; i < evenWidth; i += 2u)
+          {
+            std::uint8_t r = rows[RedY][i + RedX];
+            std::uint8_t b = rows[blueY][i + blueX];
+            std::uint8_t g = static_cast<std::uint8_t>(
+                (rows[RedY][i + blueX] + rows[blueY][i + RedX] + 1u) / 2u);
+            for (auto row : out)
+            {
+              auto pixel = row + i * 3u;
+              pixel[0] = r;
+              pixel[1] = g;
+              pixel[2] = b;
+              pixel[3] = r;
+              pixel[4] = g;
+              pixel[5] = b;
+            }
+          }
+          if (evenWidth != _width)
+          {
+            for (auto row : out)
+            {
+              std::memcpy(row + evenWidth * 3u, row + (evenWidth - 1u) * 3u,
+                  3u);
+            }
+          }
+        }
+
+        if ((_height & 1u) != 0u)
+        {
+          std::memcpy(_out + (_height - 1u) * _outStep,
+              _out + (_height - 2u) * _outStep, _width * 3u);
+        }
+      }
+    };
+
+    /// \brief RGBA, such as images published by Scene3D
+    using RgbaInt8 = Color<msgs::PixelFormatType::RGBA_INT8, std::uint8_t,
+        4u, 0u, 1u, 2u>;
+
+    /// \brief BGR, as used by OpenCV
+    using BgrInt8 = Color<msgs::PixelFormatType::BGR_INT8, std::uint8_t,
+        3u, 2u, 1u, 0u>;
+
+    /// \brief BGRA
+    using BgraInt8 = Color<msgs::PixelFormatType::BGRA_INT8, std::uint8_t,
+        4u, 2u, 1u, 0u>;
+
+    /// \brief 16 bit RGB
+    using RgbInt16 = Color<msgs::PixelFormatType::RGB_INT16, std::uint16_t,
+        3u, 0u, 1u, 2u>;
+
+    /// \brief 16 bit BGR
+    using BgrInt16 = Color<msgs::PixelFormatType::BGR_INT16, std::uint16_t,
+        3u, 2u, 1u, 0u>;
+
+    /// \brief 8 bit gray, shown as RGB so that both paths take it
+    using LInt8 = Color<msgs::PixelFormatType::L_INT8, std::uint8_t,
+        1u, 0u, 0u, 0u>;
+
+    /// \brief Bayer mosaics, named after their first 2x2 block
+    using BayerRggb8 = Bayer<msgs::PixelFormatType::BAYER_RGGB8, 0u, 0u>;
+
+    /// \brief See BayerRggb8
+    using BayerBggr8 = Bayer<msgs::PixelFormatType::BAYER_BGGR8, 1u, 1u>;
+
+    /// \brief See BayerRggb8
+    using BayerGbrg8 = Bayer<msgs::PixelFormatType::BAYER_GBRG8, 0u, 1u>;
+
+    /// \brief See BayerRggb8
+    using BayerGrbg8 = Bayer<msgs::PixelFormatType::BAYER_GRBG8, 1u, 0u>;
+
+    /// \brief All formats converted to RGB
+    using Formats = std::tuple<RgbaInt8, BgrInt8, BgraInt8, RgbInt16,
+        BgrInt16, LInt8, BayerRggb8, BayerBggr8, BayerGbrg8, BayerGrbg8>;
+
+    /// \brief Call a function with a default constructed instance of each
+    /// format, to register them.
+    /// \param[in] _fn Function taking any format
+    template <typename Fn>
+    void ForEach(Fn &&_fn)
+    {
+      std::apply([&_fn](auto... _formats) {(_fn(_formats), ...);}, Formats());
+    }
+  }
+}
+}
+}
+
+#endif
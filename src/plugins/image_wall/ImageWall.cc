@@ -0,0 +1,641 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "ImageWall.hh"
+
+#include <QBuffer>
+#include <QImageReader>
+#include <QQuickImageProvider>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/plugin/Register.hh>
+
+#include "ignition/gui/Application.hh"
+#include "ignition/gui/Executor.hh"
+#include "ignition/gui/SubscriptionHub.hh"
+#include "ignition/gui/TopicRegistry.hh"
+
+#include "image_display/ImageConversion.hh"
+
+namespace ignition
+{
+namespace gui
+{
+namespace plugins
+{
+  /// \brief State of one tile. Everything but topic is protected by the
+  /// wall's mutex.
+  class ImageStream
+  {
+    /// \brief Topic images come from
+    public: std::string topic;
+
+    /// \brief Newest msg which wasn't converted yet, shared with other
+    /// subscribers to the topic
+    public: std::shared_ptr<const msgs::Image> msg;
+
+    /// \brief True if msg holds a msg which wasn't converted yet
+    public: bool pending{false};
+
+    /// \brief True while a conversion task is queued or running
+    public: bool converting{false};
+
+    /// \brief Tile width in device pixels
+    public: int width{0};
+
+    /// \brief Tile height in device pixels
+    public: int height{0};
+
+    /// \brief Whether the tile can be seen
+    public: bool visible{false};
+
+    /// \brief Newest converted image
+    public: QImage image;
+  };
+
+  /// \brief Serves the newest image of each tile to QML, with ids of the
+  /// form "<tile index>/<anything>".
+  class ImageWallProvider : public QQuickImageProvider
+  {
+    /// \brief Constructor
+    /// \param[in] _data Wall data, which outlives the provider
+    public: explicit ImageWallProvider(ImageWallPrivate *_data)
+       : QQuickImageProvider(QQuickImageProvider::Image), data(_data)
+    {
+    }
+
+    // Documentation inherited
+    public: QImage requestImage(const QString &_id, QSize *,
+        const QSize &) override;
+
+    /// \brief Wall data
+    private: ImageWallPrivate *data;
+  };
+
+  class ImageWallPrivate
+  {
+    /// \brief Queue a conversion for a stream if it has a msg waiting, can
+    /// be seen and isn't being converted already. Call with mutex locked.
+    /// \param[in] _wall Wall to deliver images to
+    /// \param[in] _index Stream index
+    public: void Schedule(ImageWall *_wall, const unsigned int _index);
+
+    /// \brief Convert the newest msg of one stream, then make way for the
+    /// other streams. Runs on a worker thread.
+    /// \param[in] _wall Wall to deliver images to
+    /// \param[in] _index Stream index
+    public: void Convert(ImageWall *_wall, const unsigned int _index);
+
+    /// \brief One stream per tile
+    public: std::vector<std::unique_ptr<ImageStream>> streams;
+
+    /// \brief Number of columns
+    public: int columns{1};
+
+    /// \brief Protects the streams, ready and stopping
+    public: std::mutex mutex;
+
+    /// \brief Indices of streams with images QML wasn't told about yet
+    public: std::vector<unsigned int> ready;
+
+    /// \brief Set on destruction to stop conversions
+    public: bool stopping{false};
+
+    /// \brief True from the time new images are announced until the GUI
+    /// thread picks them up, so that announcements don't pile up
+    public: std::atomic<bool> announced{false};
+
+
+    /// \brief Subscriptions of all streams
+    public: std::vector<std::size_t> subscriptions;
+
+    /// \brief Name the provider is registered with
+    public: QString providerName;
+  };
+}
+}
+}
+
+using namespace ignition;
+using namespace gui;
+using namespace plugins;
+
+/////////////////////////////////////////////////
+/// \brief Check that an image msg holds all the rows its size calls for
+/// \param[in] _msg Image msg
+/// \param[in] _pixelSize Bytes per pixel
+/// \return Bytes per row, zero if the image is empty or its data is too
+/// short
+static unsigned int rowStep(const msgs::Image &_msg,
+    const unsigned int _pixelSize)
+{
+  if (_msg.width() == 0u || _msg.height() == 0u)
+    return 0u;
+
+  unsigned int packed = _msg.width() * _pixelSize;
+  unsigned int step = _msg.step() >= packed ? _msg.step() : packed;
+
+  if (_msg.data().size() <
+      static_cast<std::size_t>(step) * (_msg.height() - 1u) + packed)
+  {
+    ignerr << "Image data is too short for a " << _msg.width() << "x"
+           << _msg.height() << " image of type "
+           << _msg.pixel_format_type() << std::endl;
+    return 0u;
+  }
+  return step;
+}
+
+/////////////////////////////////////////////////
+/// \brief Find how much an image can be reduced and still fill its tile
+/// \param[in] _width Image width
+/// \param[in] _height Image height
+/// \param[in] _tileWidth Tile width
+/// \param[in] _tileHeight Tile height
+/// \return Keep one pixel out of this many in both directions, at least 1
+static unsigned int reduction(const unsigned int _width,
+    const unsigned int _height, const int _tileWidth, const int _tileHeight)
+{
+  if (_tileWidth <= 0 || _tileHeight <= 0)
+    return 1u;
+
+  // The image is fit in the tile, so the side which is reduced the most
+  // decides how much is shown
+  unsigned int factor = std::max(
+      _width / static_cast<unsigned int>(_tileWidth),
+      _height / static_cast<unsigned int>(_tileHeight));
+  factor = std::min(factor, std::min(_width, _height));
+  return std::max(factor, 1u);
+}
+
+/////////////////////////////////////////////////
+/// \brief Keep every _factor-th pixel of every _factor-th row of an image
+/// msg, packed.
+/// \param[in] _msg Image msg, with valid data
+/// \param[in] _step Bytes per row
+/// \param[in] _pixelSize Bytes per pixel
+/// \param[in] _factor Reduction factor
+/// \param[out] _buffer Storage for the pixels, if they must be moved
+/// \return The pixels, which may be the msg data itself
+static const char *sample(const msgs::Image &_msg, const unsigned int _step,
+    const unsigned int _pixelSize, const unsigned int _factor,
+    std::string &_buffer)
+{
+  unsigned int width = _msg.width() / _factor;
+  unsigned int height = _msg.height() / _factor;
+  const char *data = _msg.data().data();
+  if (_factor == 1u && _step == width * _pixelSize)
+    return data;
+
+  _buffer.resize(static_cast<std::size_t>(width) * height * _pixelSize);
+  char *dst = &_buffer[0];
+  for (unsigned int j = 0; j < height; ++j)
+  {
+    const char *src = data + static_cast<std::size_t>(j) * _factor * _step;
+    if (_factor == 1u)
+    {
+      std::memcpy(dst, src, width * _pixelSize);
+      dst += width * _pixelSize;
+      continue;
+    }
+
+    for (unsigned int i = 0; i < width; ++i)
+    {
+      std::memcpy(dst, src + i * _factor * _pixelSize, _pixelSize);
+      dst += _pixelSize;
+    }
+  }
+  return _buffer.data();
+}
+
+/////////////////////////////////////////////////
+/// \brief Check if an image msg carries a JPEG or PNG file instead of raw
+/// pixels, the same way ImageDisplay does.
+/// \param[in] _msg Image msg
+/// \return True if the data is compressed
+static bool isCompressed(const msgs::Image &_msg)
+{
+  static const std::string kJpeg{"\xff\xd8\xff"};
+  static const std::string kPng{"\x89PNG\r\n\x1a\n"};
+
+  const auto &data = _msg.data();
+  if (data.compare(0, kJpeg.size(), kJpeg) != 0 &&
+      data.compare(0, kPng.size(), kPng) != 0)
+  {
+    return false;
+  }
+
+  std::size_t pixelSize = 0u;
+  switch (_msg.pixel_format_type())
+  {
+    case msgs::PixelFormatType::RGB_INT8:
+      pixelSize = 3u;
+      break;
+    case msgs::PixelFormatType::R_FLOAT32:
+      pixelSize = sizeof(float);
+      break;
+    case msgs::PixelFormatType::L_INT16:
+      pixelSize = sizeof(uint16_t);
+      break;
+    default:
+      return true;
+  }
+  return data.size() <
+      static_cast<std::size_t>(_msg.width()) * _msg.height() * pixelSize;
+}
+
+/////////////////////////////////////////////////
+/// \brief Decode a compressed image msg at about the size of its tile.
+/// JPEG images are scaled while decoding, which is much cheaper than
+/// decoding them whole.
+/// \param[in] _msg Image msg with JPEG or PNG data
+/// \param[in] _tileWidth Tile width
+/// \param[in] _tileHeight Tile height
+/// \return RGB image, null if decoding failed
+static QImage decompress(const msgs::Image &_msg, const int _tileWidth,
+    const int _tileHeight)
+{
+  auto bytes = QByteArray::fromRawData(_msg.data().data(),
+      static_cast<int>(_msg.data().size()));
+  QBuffer buffer(&bytes);
+  QImageReader reader(&buffer);
+
+  auto size = reader.size();
+  if (size.isValid())
+  {
+    auto factor = reduction(size.width(), size.height(), _tileWidth,
+        _tileHeight);
+    if (factor > 1u)
+      reader.setScaledSize(size / static_cast<int>(factor));
+  }
+
+  QImage image;
+  if (!reader.read(&image))
+  {
+    ignerr << "Failed to decode compressed image: "
+           << reader.errorString().toStdString() << std::endl;
+    return QImage();
+  }
+  return image.convertToFormat(QImage::Format_RGB888);
+}
+
+/////////////////////////////////////////////////
+/// \brief Convert a raw image msg, reduced to about the size of its tile
+/// \param[in] _msg Image msg
+/// \param[in] _tileWidth Tile width
+/// \param[in] _tileHeight Tile height
+/// \param[in,out] _buffer Scratch space kept across calls
+/// \return Image, null if the msg couldn't be converted
+static QImage convert(const msgs::Image &_msg, const int _tileWidth,
+    const int _tileHeight, std::string &_buffer)
+{
+  unsigned int pixelSize;
+  switch (_msg.pixel_format_type())
+  {
+    case msgs::PixelFormatType::RGB_INT8:
+      pixelSize = 3u;
+      break;
+    case msgs::PixelFormatType::R_FLOAT32:
+      pixelSize = sizeof(float);
+      break;
+    case msgs::PixelFormatType::L_INT16:
+      pixelSize = sizeof(uint16_t);
+      break;
+    default:
+    {
+      ignwarn << "Unsupported image type: "
+              << _msg.pixel_format_type() << std::endl;
+      return QImage();
+    }
+  }
+
+  auto step = rowStep(_msg, pixelSize);
+  if (step == 0u)
+    return QImage();
+
+  auto factor = reduction(_msg.width(), _msg.height(), _tileWidth,
+      _tileHeight);
+  int width = static_cast<int>(_msg.width() / factor);
+  int height = static_cast<int>(_msg.height() / factor);
+  std::size_t count = static_cast<std::size_t>(width) * height;
+  std::size_t packed = static_cast<std::size_t>(width) * pixelSize;
+  const char *pixels = sample(_msg, step, pixelSize, factor, _buffer);
+
+  if (_msg.pixel_format_type() == msgs::PixelFormatType::RGB_INT8)
+  {
+    QImage image(width, height, QImage::Format_RGB888);
+    for (int j = 0; j < height; ++j)
+      std::memcpy(image.scanLine(j), pixels + j * packed, packed);
+    return image;
+  }
+
+  // Grayscale rows can be written directly, one byte per pixel. The range
+  // is found over the pixels which are kept.
+  QImage image(width, height, QImage::Format_Grayscale8);
+  if (_msg.pixel_format_type() == msgs::PixelFormatType::R_FLOAT32)
+  {
+    float max = ImageConversion::MaxDepth(pixels, count);
+    float scale = max > 0.0f ? 255.0f / max : 0.0f;
+    for (int j = 0; j < height; ++j)
+    {
+      ImageConversion::DepthToGray(pixels + j * packed, width, scale,
+          image.scanLine(j));
+    }
+  }
+  else
+  {
+    uint16_t min, max;
+    ImageConversion::MinMax(pixels, count, min, max);
+    float scale = max > min ? 255.0f / (max - min) : 0.0f;
+    for (int j = 0; j < height; ++j)
+    {
+      ImageConversion::RangeToGray(pixels + j * packed, width, min, scale,
+          image.scanLine(j));
+    }
+  }
+  return image;
+}
+
+/////////////////////////////////////////////////
+QImage ImageWallProvider::requestImage(const QString &_id, QSize *,
+    const QSize &)
+{
+  bool ok{false};
+  auto index = _id.section('/', 0, 0).toUInt(&ok);
+  {
+    std::lock_guard<std::mutex> lock(this->data->mutex);
+    if (ok && index < this->data->streams.size() &&
+        !this->data->streams[index]->image.isNull())
+    {
+      return this->data->streams[index]->image;
+    }
+  }
+
+  // Placeholder in case we have no image yet
+  QImage i(400, 400, QImage::Format_RGB888);
+  i.fill(QColor(128, 128, 128, 100));
+  return i;
+}
+
+/////////////////////////////////////////////////
+void ImageWallPrivate::Schedule(ImageWall *_wall, const unsigned int _index)
+{
+  auto &stream = *this->streams[_index];
+  if (this->stopping || stream.converting || !stream.pending ||
+      !stream.visible)
+  {
+    return;
+  }
+
+  stream.converting = true;
+  Executor::Instance().Post(this, [this, _wall, _index]()
+  {
+    this->Convert(_wall, _index);
+  });
+}
+
+/////////////////////////////////////////////////
+void ImageWallPrivate::Convert(ImageWall *_wall, const unsigned int _index)
+{
+  std::shared_ptr<const msgs::Image> msgPtr;
+  int width, height;
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto &stream = *this->streams[_index];
+    if (this->stopping || !stream.pending)
+    {
+      stream.converting = false;
+      return;
+    }
+    msgPtr.swap(stream.msg);
+    stream.pending = false;
+    width = stream.width;
+    height = stream.height;
+  }
+
+  // Conversions only read the msg, so it isn't copied
+  const auto &msg = *msgPtr;
+
+  // Each worker thread keeps its own scratch space
+  thread_local std::string buffer;
+  QImage image = isCompressed(msg) ? decompress(msg, width, height) :
+      convert(msg, width, height, buffer);
+
+  bool announce{false};
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto &stream = *this->streams[_index];
+    stream.converting = false;
+    if (!image.isNull())
+    {
+      stream.image = image;
+      if (std::find(this->ready.begin(), this->ready.end(),
+          _index) == this->ready.end())
+      {
+        this->ready.push_back(_index);
+      }
+      announce = true;
+    }
+
+    // Go to the back of the queue if a newer msg came in, so that a fast
+    // stream doesn't hold a thread to itself
+    this->Schedule(_wall, _index);
+  }
+
+  // Tell QML once, however many images were converted until it gets to it
+  if (announce && !this->announced.exchange(true))
+    QMetaObject::invokeMethod(_wall, "OnImageReady");
+}
+
+/////////////////////////////////////////////////
+ImageWall::ImageWall()
+  : Plugin(), dataPtr(new ImageWallPrivate)
+{
+  Executor::Instance().SetConcurrency(this->dataPtr.get(),
+      std::max(1u, Executor::Instance().ThreadCount() / 2));
+}
+
+/////////////////////////////////////////////////
+ImageWall::~ImageWall()
+{
+  // Stop receiving and let conversions finish before the provider goes
+  for (auto subscription : this->dataPtr->subscriptions)
+    SubscriptionHub::Instance()->Unsubscribe(subscription);
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->stopping = true;
+  }
+  Executor::Instance().Cancel(this->dataPtr.get());
+
+  if (!this->dataPtr->providerName.isEmpty())
+    App()->Engine()->removeImageProvider(this->dataPtr->providerName);
+}
+
+/////////////////////////////////////////////////
+void ImageWall::LoadConfig(const tinyxml2::XMLElement *_pluginElem)
+{
+  // Default name in case user didn't define one
+  if (this->title.empty())
+    this->title = "Image wall";
+
+  std::vector<std::string> topics;
+  int columns = 0;
+
+  // Read configuration
+  if (_pluginElem)
+  {
+    for (auto topicElem = _pluginElem->FirstChildElement("topic");
+         topicElem != nullptr;
+         topicElem = topicElem->NextSiblingElement("topic"))
+    {
+      if (topicElem->GetText())
+        topics.push_back(topicElem->GetText());
+    }
+
+    if (auto columnsElem = _pluginElem->FirstChildElement("columns"))
+      columnsElem->QueryIntText(&columns);
+
+    if (auto threadsElem = _pluginElem->FirstChildElement("threads"))
+    {
+      int threads = 0;
+      threadsElem->QueryIntText(&threads);
+      if (threads > 0)
+      {
+        Executor::Instance().SetConcurrency(this->dataPtr.get(),
+            static_cast<unsigned int>(threads));
+      }
+    }
+  }
+
+  if (topics.empty())
+    topics = TopicRegistry::Instance()->Topics("ignition.msgs.Image");
+
+  if (topics.empty())
+    ignwarn << "No image topics to show." << std::endl;
+
+  if (columns <= 0)
+  {
+    columns = static_cast<int>(std::ceil(std::sqrt(
+        static_cast<double>(topics.size()))));
+  }
+  this->dataPtr->columns = std::max(columns, 1);
+
+  for (const auto &topic : topics)
+  {
+    auto stream = std::make_unique<ImageStream>();
+    stream->topic = topic;
+    this->dataPtr->streams.push_back(std::move(stream));
+  }
+
+  // The provider must be there before images start arriving
+  this->dataPtr->providerName = this->CardItem()->objectName() + "imagewall";
+  App()->Engine()->addImageProvider(this->dataPtr->providerName,
+      new ImageWallProvider(this->dataPtr.get()));
+
+  for (unsigned int i = 0; i < this->dataPtr->streams.size(); ++i)
+  {
+    const auto &topic = this->dataPtr->streams[i]->topic;
+    auto subscription = SubscriptionHub::Instance()->Subscribe<msgs::Image>(
+        topic, [this, i](const std::shared_ptr<const msgs::Image> &_msg)
+        {
+          this->OnImageMsg(i, _msg);
+        });
+    if (subscription)
+      this->dataPtr->subscriptions.push_back(subscription);
+    else
+      ignerr << "Unable to subscribe to topic [" << topic << "]" << std::endl;
+  }
+
+  this->TopicListChanged();
+  this->ColumnsChanged();
+}
+
+/////////////////////////////////////////////////
+QStringList ImageWall::TopicList() const
+{
+  QStringList topics;
+  for (const auto &stream : this->dataPtr->streams)
+    topics.push_back(QString::fromStdString(stream->topic));
+  return topics;
+}
+
+/////////////////////////////////////////////////
+int ImageWall::Columns() const
+{
+  return this->dataPtr->columns;
+}
+
+/////////////////////////////////////////////////
+void ImageWall::SetTile(int _index, int _width, int _height, bool _visible)
+{
+  if (_index < 0 ||
+      static_cast<std::size_t>(_index) >= this->dataPtr->streams.size())
+  {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto &stream = *this->dataPtr->streams[_index];
+  stream.width = _width;
+  stream.height = _height;
+  stream.visible = _visible && _width > 0 && _height > 0;
+
+  // A tile showing up gets its newest msg right away
+  this->dataPtr->Schedule(this, _index);
+}
+
+/////////////////////////////////////////////////
+void ImageWall::OnImageReady()
+{
+  this->dataPtr->announced = false;
+
+  std::vector<unsigned int> ready;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    ready.swap(this->dataPtr->ready);
+  }
+
+  for (auto index : ready)
+    this->newImage(static_cast<int>(index));
+}
+
+/////////////////////////////////////////////////
+void ImageWall::OnImageMsg(const unsigned int _index,
+    const std::shared_ptr<const msgs::Image> &_msg)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto &stream = *this->dataPtr->streams[_index];
+  stream.msg = _msg;
+  stream.pending = true;
+  this->dataPtr->Schedule(this, _index);
+}
+
+// Register this plugin
+IGNITION_ADD_PLUGIN(ignition::gui::plugins::ImageWall,
+                    ignition::gui::Plugin)
@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGNITION_GUI_PLUGINS_IMAGEWALL_HH_
+#define IGNITION_GUI_PLUGINS_IMAGEWALL_HH_
+
+#include <memory>
+#ifdef _MSC_VER
+#pragma warning(push, 0)
+#endif
+#include <ignition/msgs/image.pb.h>
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#include "ignition/gui/Plugin.hh"
+
+namespace ignition
+{
+namespace gui
+{
+namespace plugins
+{
+  class ImageWallPrivate;
+
+  /// \brief Display images from several Ignition transport topics at once,
+  /// tiled in a grid.
+  ///
+  /// ## Configuration
+  ///
+  /// \<topic\> : Topic to receive image messages on, one element per tile.
+  ///             If there are none, all topics publishing images when the
+  ///             plugin is loaded are shown.
+  /// \<columns\> : Number of columns, the smallest square grid fitting all
+  ///               tiles by default.
+  /// \<threads\> : Number of images converted at the same time for all
+  ///               tiles, half the worker threads by default.
+  ///
+  /// All tiles share a single node and a bounded share of the worker threads,
+  /// so the cost of the wall follows the pixels on screen rather than the
+  /// number of streams:
+  ///
+  /// * Only the newest msg of each stream is converted, older ones are
+  ///   dropped.
+  /// * Tiles which aren't shown, such as when the window is minimized, aren't
+  ///   converted at all. Their newest msg is converted when they show up
+  ///   again.
+  /// * Images are reduced as they're converted to about the size of their
+  ///   tile, keeping every n-th pixel of every n-th row. JPEG images are
+  ///   decoded at the reduced size directly.
+  /// * Streams take turns, one image each.
+  class ImageWall : public Plugin
+  {
+    Q_OBJECT
+
+    /// \brief Topic of each tile
+    Q_PROPERTY(
+      QStringList topicList
+      READ TopicList
+      NOTIFY TopicListChanged
+    )
+
+    /// \brief Number of columns in the grid
+    Q_PROPERTY(
+      int columns
+      READ Columns
+      NOTIFY ColumnsChanged
+    )
+
+    /// \brief Constructor
+    public: ImageWall();
+
+    /// \brief Destructor
+    public: virtual ~ImageWall();
+
+    // Documentation inherited
+    public: virtual void LoadConfig(const tinyxml2::XMLElement *_pluginElem);
+
+    /// \brief Get the topic of each tile.
+    /// \return Topics, in tile order
+    public: Q_INVOKABLE QStringList TopicList() const;
+
+    /// \brief Notify that the topic list has changed
+    signals: void TopicListChanged();
+
+    /// \brief Get the number of columns in the grid.
+    /// \return Column count
+    public: Q_INVOKABLE int Columns() const;
+
+    /// \brief Notify that the number of columns has changed
+    signals: void ColumnsChanged();
+
+    /// \brief Tell how a tile is shown, which decides whether and at which
+    /// resolution its images are converted.
+    /// \param[in] _index Tile index
+    /// \param[in] _width Width of the tile in device pixels
+    /// \param[in] _height Height of the tile in device pixels
+    /// \param[in] _visible Whether the tile can be seen
+    public: Q_INVOKABLE void SetTile(int _index, int _width, int _height,
+        bool _visible);
+
+    /// \brief Notify that a tile has a new image.
+    /// \param[in] _index Tile index
+    signals: void newImage(int _index);
+
+    /// \brief Callback in main thread when converted images are ready
+    private slots: void OnImageReady();
+
+    /// \brief Subscriber callback when a new image is received
+    /// \param[in] _index Tile index
+    /// \param[in] _msg New image, shared with other subscribers
+    private: void OnImageMsg(const unsigned int _index,
+        const std::shared_ptr<const ignition::msgs::Image> &_msg);
+
+    /// \internal
+    /// \brief Pointer to private data.
+    private: std::unique_ptr<ImageWallPrivate> dataPtr;
+  };
+}
+}
+}
+
+#endif
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+import QtQuick 2.9
+import QtQuick.Controls 2.2
+import QtQuick.Layouts 1.3
+import QtQuick.Window 2.2
+
+Rectangle {
+  id: imageWall
+  color: "transparent"
+  anchors.fill: parent
+  Layout.minimumWidth: 400
+  Layout.minimumHeight: 400
+
+  /**
+   * Unique name for this plugin instance
+   */
+  property string uniqueName: ""
+
+  /**
+   * False while the window is minimized or hidden
+   */
+  property bool windowShown: Window.visibility !== Window.Minimized &&
+      Window.visibility !== Window.Hidden
+
+  onParentChanged: {
+    if (undefined === parent)
+      return;
+
+    uniqueName = parent.card().objectName + "imagewall";
+  }
+
+  GridLayout {
+    anchors.fill: parent
+    anchors.margins: 10
+    columns: ImageWall.columns
+    rowSpacing: 4
+    columnSpacing: 4
+
+    Repeater {
+      model: ImageWall.topicList
+
+      Item {
+        id: tile
+        Layout.fillWidth: true
+        Layout.fillHeight: true
+
+        /**
+         * Whether the tile can be seen
+         */
+        property bool shown: visible && windowShown && uniqueName !== ""
+
+        /**
+         * Tell the plugin how big the tile is and whether it can be seen,
+         * so images are converted at the size they're drawn at
+         */
+        function report() {
+          var ratio = Screen.devicePixelRatio;
+          ImageWall.SetTile(index, Math.ceil(image.width * ratio),
+              Math.ceil(image.height * ratio), shown);
+        }
+
+        onShownChanged: report()
+        Component.onCompleted: report()
+
+        Connections {
+          target: ImageWall
+          onNewImage: {
+            if (_index === index)
+              image.reload();
+          }
+        }
+
+        Image {
+          id: image
+          anchors.top: parent.top
+          anchors.left: parent.left
+          anchors.right: parent.right
+          anchors.bottom: topicLabel.top
+          fillMode: Image.PreserveAspectFit
+          cache: false
+          onWidthChanged: tile.report()
+          onHeightChanged: tile.report()
+          function reload() {
+            // Force image request to C++
+            source = "image://" + uniqueName + "/" + index + "/" +
+                Math.random().toString(36).substr(2, 5);
+          }
+        }
+
+        Label {
+          id: topicLabel
+          anchors.left: parent.left
+          anchors.right: parent.right
+          anchors.bottom: parent.bottom
+          text: modelData
+          elide: Text.ElideLeft
+          horizontalAlignment: Text.AlignHCenter
+        }
+      }
+    }
+  }
+}
@@ -15,10 +15,20 @@
  *
 */
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
 #ifdef _MSC_VER
 #pragma warning(push, 0)
 #endif
 #include <ignition/msgs/int32.pb.h>
+#include <ignition/msgs/int32_v.pb.h>
 #ifdef _MSC_VER
 #pragma warning(pop)
 #endif
@@ -33,32 +43,232 @@ namespace ignition
 {
 namespace gui
 {
+  /// \brief A key event waiting to be published
+  struct KeyEvent
+  {
+    /// \brief Qt key code, unused for focus loss
+    int key;
+
+    /// \brief What happened to the key
+    enum Kind {PRESS, RELEASE, REPEAT, RELEASE_ALL} kind;
+
+    /// \brief When it was captured, to measure latency
+    std::chrono::steady_clock::time_point captured;
+
+    /// \brief When it was captured, for the message header
+    std::chrono::system_clock::time_point stamp;
+  };
+
   class KeyPublisherPrivate
   {
+    /// \brief Queue an event for the publishing thread.
+    /// \param[in] _key Qt key code
+    /// \param[in] _kind What happened to the key
+    public: void Enqueue(int _key, KeyEvent::Kind _kind);
+
+    /// \brief Publish queued events and held keys until stopped. Runs on
+    /// its own thread.
+    public: void Run();
+
+    /// \brief Stop the publishing thread, if running, and wait for it.
+    public: void Stop();
+
     /// \brief Node for communication
     public: ignition::transport::Node node;
 
     /// \brief Publisher
     public: ignition::transport::Node::Publisher pub;
 
+    /// \brief Publisher of released keys
+    public: ignition::transport::Node::Publisher releasePub;
+
+    /// \brief Publisher of held keys
+    public: ignition::transport::Node::Publisher heldPub;
+
     /// \brief Topic
     public: std::string topic = "keyboard/keypress";
 
-    /// \brief Publish keyboard strokes
-    /// \param[in] key_press Pointer to the keyevent
-    public: void KeyPub(QKeyEvent *_keyPress)
-    {
-      ignition::msgs::Int32 Msg;
-      Msg.set_data(_keyPress->key());
-      pub.Publish(Msg);
-    }
+    /// \brief Topic for released keys
+    public: std::string releaseTopic = "keyboard/keyrelease";
+
+    /// \brief Topic for held keys
+    public: std::string heldTopic = "keyboard/held";
+
+    /// \brief Rate at which held keys are published, 0 for never
+    public: double heldRate{0.0};
+
+    /// \brief Events waiting to be published
+    public: std::deque<KeyEvent> events;
+
+    /// \brief Publishing thread
+    public: std::thread thread;
+
+    /// \brief True while the thread should keep publishing
+    public: bool running{false};
+
+    /// \brief Sum of the latencies measured since the last report, in
+    /// milliseconds
+    public: double latencySum{0.0};
+
+    /// \brief Number of latencies measured since the last report
+    public: unsigned int latencyCount{0};
+
+    /// \brief Longest latency measured since the last report
+    public: double latencyMax{0.0};
+
+    /// \brief Latest reported average latency
+    public: double latency{0.0};
+
+    /// \brief Latest reported longest latency
+    public: double maxLatency{0.0};
+
+    /// \brief Protects everything above shared with the thread
+    public: mutable std::mutex mutex;
+
+    /// \brief Wakes up the thread for new events or to stop it
+    public: std::condition_variable condition;
+
+    /// \brief Reports the latencies once a second
+    public: QTimer *timer{nullptr};
   };
 }
 }
-
 using namespace ignition;
 using namespace gui;
 
+/////////////////////////////////////////////////
+/// \brief Set a message header stamp.
+/// \param[in] _header Header
+/// \param[in] _time Wall clock time
+static void SetStamp(msgs::Header *_header,
+    const std::chrono::system_clock::time_point &_time)
+{
+  auto nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      _time.time_since_epoch()).count();
+  _header->mutable_stamp()->set_sec(nsec / 1000000000);
+  _header->mutable_stamp()->set_nsec(nsec % 1000000000);
+}
+
+/////////////////////////////////////////////////
+void KeyPublisherPrivate::Enqueue(int _key, KeyEvent::Kind _kind)
+{
+  KeyEvent event{_key, _kind, std::chrono::steady_clock::now(),
+      std::chrono::system_clock::now()};
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (!this->running)
+      return;
+    this->events.push_back(event);
+  }
+  this->condition.notify_one();
+}
+
+/////////////////////////////////////////////////
+void KeyPublisherPrivate::Run()
+{
+  std::set<int> held;
+  bool heldChanged{false};
+  auto heldPeriod = this->heldRate > 0.0 ?
+      std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(1.0 / this->heldRate)) :
+      std::chrono::steady_clock::duration::zero();
+  std::chrono::steady_clock::time_point heldDeadline;
+
+  std::unique_lock<std::mutex> lock(this->mutex);
+  while (this->running)
+  {
+    while (!this->events.empty())
+    {
+      auto event = this->events.front();
+      this->events.pop_front();
+
+      // Don't hold the lock while publishing, so capturing never waits
+      lock.unlock();
+
+      msgs::Int32 msg;
+      SetStamp(msg.mutable_header(), event.stamp);
+      msg.set_data(event.key);
+      switch (event.kind)
+      {
+        case KeyEvent::PRESS:
+          this->pub.Publish(msg);
+          heldChanged |= held.insert(event.key).second;
+          break;
+        case KeyEvent::REPEAT:
+          this->pub.Publish(msg);
+          break;
+        case KeyEvent::RELEASE:
+          this->releasePub.Publish(msg);
+          heldChanged |= held.erase(event.key) > 0;
+          break;
+        case KeyEvent::RELEASE_ALL:
+          for (auto key : held)
+          {
+            msg.set_data(key);
+            this->releasePub.Publish(msg);
+          }
+          heldChanged |= !held.empty();
+          held.clear();
+          break;
+      }
+
+      auto latency = std::chrono::duration<double, std::milli>(
+          std::chrono::steady_clock::now() - event.captured).count();
+
+      lock.lock();
+      this->latencySum += latency;
+      ++this->latencyCount;
+      this->latencyMax = std::max(this->latencyMax, latency);
+    }
+
+    // Held keys are published as soon as they change, then periodically
+    auto now = std::chrono::steady_clock::now();
+    if (heldPeriod.count() > 0 &&
+        (heldChanged || (!held.empty() && now >= heldDeadline)))
+    {
+      lock.unlock();
+
+      msgs::Int32_V msg;
+      SetStamp(msg.mutable_header(), std::chrono::system_clock::now());
+      for (auto key : held)
+        msg.add_data(key);
+      this->heldPub.Publish(msg);
+
+      lock.lock();
+
+      // Stay on schedule unless it changed or fell behind
+      if (heldChanged || now - heldDeadline >= heldPeriod)
+        heldDeadline = now + heldPeriod;
+      else
+        heldDeadline += heldPeriod;
+    }
+    heldChanged = false;
+
+    auto wake = [this]
+    {
+      return !this->running || !this->events.empty();
+    };
+    if (held.empty() || heldPeriod.count() == 0)
+      this->condition.wait(lock, wake);
+    else
+      this->condition.wait_until(lock, heldDeadline, wake);
+  }
+}
+
+/////////////////////////////////////////////////
+void KeyPublisherPrivate::Stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->running = false;
+    this->events.clear();
+  }
+  this->condition.notify_one();
+
+  if (this->thread.joinable())
+    this->thread.join();
+}
+
 /////////////////////////////////////////////////
 KeyPublisher::KeyPublisher(): Plugin(), dataPtr(new KeyPublisherPrivate)
 {
@@ -70,29 +280,105 @@ KeyPublisher::KeyPublisher(): Plugin(), dataPtr(new KeyPublisherPrivate)
 /////////////////////////////////////////////////
 KeyPublisher::~KeyPublisher()
 {
+  this->dataPtr->Stop();
 }
 
 /////////////////////////////////////////////////
-void KeyPublisher::LoadConfig(const tinyxml2::XMLElement *)
+void KeyPublisher::LoadConfig(const tinyxml2::XMLElement *_pluginElem)
 {
   if (this->title.empty())
     this->title = "Key publisher";
 
-  ignition::gui::App()->findChild
-    <ignition::gui::MainWindow *>()->QuickWindow()->installEventFilter(this);
+  if (_pluginElem)
+  {
+    auto topicElem = _pluginElem->FirstChildElement("release_topic");
+    if (nullptr != topicElem && nullptr != topicElem->GetText())
+      this->dataPtr->releaseTopic = topicElem->GetText();
+
+    topicElem = _pluginElem->FirstChildElement("held_topic");
+    if (nullptr != topicElem && nullptr != topicElem->GetText())
+      this->dataPtr->heldTopic = topicElem->GetText();
+
+    if (auto rateElem = _pluginElem->FirstChildElement("held_rate"))
+      rateElem->QueryDoubleText(&this->dataPtr->heldRate);
+  }
+
+  this->dataPtr->releasePub =
+      this->dataPtr->node.Advertise<ignition::msgs::Int32>(
+      this->dataPtr->releaseTopic);
+  if (this->dataPtr->heldRate > 0.0)
+  {
+    this->dataPtr->heldPub =
+        this->dataPtr->node.Advertise<ignition::msgs::Int32_V>(
+        this->dataPtr->heldTopic);
+  }
+
+  this->dataPtr->running = true;
+  this->dataPtr->thread = std::thread(&KeyPublisherPrivate::Run,
+      this->dataPtr.get());
+
+  // The latencies are measured by the publishing thread and reported once
+  // a second
+  this->dataPtr->timer = new QTimer(this);
+  this->connect(this->dataPtr->timer, &QTimer::timeout, [this]()
+  {
+    {
+      std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+      if (this->dataPtr->latencyCount == 0)
+        return;
+      this->dataPtr->latency =
+          this->dataPtr->latencySum / this->dataPtr->latencyCount;
+      this->dataPtr->maxLatency = this->dataPtr->latencyMax;
+      this->dataPtr->latencySum = 0.0;
+      this->dataPtr->latencyCount = 0;
+      this->dataPtr->latencyMax = 0.0;
+    }
+    this->LatencyChanged();
+  });
+  this->dataPtr->timer->start(1000);
+
+  ignition::gui::App()->MainWin()->QuickWindow()->installEventFilter(this);
 }
 
 /////////////////////////////////////////////////
 bool KeyPublisher::eventFilter(QObject *_obj, QEvent *_event)
 {
-  if (_event->type() == QEvent::KeyPress)
+  if (_event->type() == QEvent::KeyPress ||
+      _event->type() == QEvent::KeyRelease)
   {
-    QKeyEvent *keyEvent = static_cast<QKeyEvent*>(_event);
-    this->dataPtr->KeyPub(keyEvent);
+    auto keyEvent = static_cast<QKeyEvent *>(_event);
+    KeyEvent::Kind kind;
+    if (_event->type() == QEvent::KeyPress)
+      kind = keyEvent->isAutoRepeat() ? KeyEvent::REPEAT : KeyEvent::PRESS;
+    else if (!keyEvent->isAutoRepeat())
+      kind = KeyEvent::RELEASE;
+    else
+      return QObject::eventFilter(_obj, _event);
+
+    this->dataPtr->Enqueue(keyEvent->key(), kind);
+  }
+  // Releases won't come while another window has the focus
+  else if (_event->type() == QEvent::FocusOut)
+  {
+    this->dataPtr->Enqueue(0, KeyEvent::RELEASE_ALL);
   }
   return QObject::eventFilter(_obj, _event);
 }
 
+/////////////////////////////////////////////////
+double KeyPublisher::Latency() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->latency;
+}
+
+/////////////////////////////////////////////////
+double KeyPublisher::MaxLatency() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->maxLatency;
+}
+
 // Register this plugin
 IGNITION_ADD_PLUGIN(ignition::gui::KeyPublisher,
                     ignition::gui::Plugin)
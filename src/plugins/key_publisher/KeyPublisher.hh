@@ -33,12 +33,41 @@ namespace gui
 
   /// \brief Publish keyboard stokes to "keyboard/keypress" topic.
   ///
+  /// Events are timestamped as soon as they're captured and published from
+  /// a dedicated thread, so they don't wait for the GUI thread. The header
+  /// stamp of each message is the wall clock time the key event was
+  /// captured.
+  ///
   /// ## Configuration
-  /// This plugin doesn't accept any custom configuration.
+  ///
+  /// * \<release_topic\> : Topic for released keys, "keyboard/keyrelease"
+  ///                       by default. Auto repeats aren't published there.
+  /// * \<held_topic\> : Topic for the set of keys held down, as an
+  ///                    `ignition::msgs::Int32_V`, "keyboard/held" by
+  ///                    default.
+  /// * \<held_rate\> : Rate in Hz at which the set of held keys is published
+  ///                   while not empty, 0 by default to not publish it. An
+  ///                   empty set is published once all keys are released.
   class KeyPublisher : public ignition::gui::Plugin
   {
     Q_OBJECT
 
+    /// \brief Average time from capturing key events to publishing them,
+    /// over the last second
+    Q_PROPERTY(
+      double latency
+      READ Latency
+      NOTIFY LatencyChanged
+    )
+
+    /// \brief Longest time from capturing a key event to publishing it,
+    /// over the last second
+    Q_PROPERTY(
+      double maxLatency
+      READ MaxLatency
+      NOTIFY LatencyChanged
+    )
+
     /// \brief Constructor
     public: KeyPublisher();
 
@@ -48,6 +77,19 @@ namespace gui
     // Documentation inherited
     public: virtual void LoadConfig(const tinyxml2::XMLElement *) override;
 
+    /// \brief Get the average time from capturing key events to publishing
+    /// them, over the last second with events.
+    /// \return Milliseconds
+    public: Q_INVOKABLE double Latency() const;
+
+    /// \brief Get the longest time from capturing a key event to publishing
+    /// it, over the last second with events.
+    /// \return Milliseconds
+    public: Q_INVOKABLE double MaxLatency() const;
+
+    /// \brief Notify that the latencies have been measured again
+    signals: void LatencyChanged();
+
     /// \brief Filter events in Qt
     /// \param[in] _obj The watched object
     /// \param[in] _event Event that happen in Qt
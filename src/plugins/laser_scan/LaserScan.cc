@@ -0,0 +1,629 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "LaserScan.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/math/Color.hh>
+#include <ignition/math/Vector3.hh>
+#include <ignition/plugin/Register.hh>
+
+#ifdef _MSC_VER
+#pragma warning(push, 0)
+#endif
+#include <ignition/msgs/laserscan.pb.h>
+#include <ignition/msgs/Utility.hh>
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+// TODO(louise) Remove these pragmas once ign-rendering is disabling the
+// warnings
+#ifdef _WIN32
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+
+#include <ignition/rendering/Marker.hh>
+#include <ignition/rendering/Material.hh>
+#include <ignition/rendering/RenderEngine.hh>
+#include <ignition/rendering/RenderingIface.hh>
+#include <ignition/rendering/Scene.hh>
+#include <ignition/rendering/Visual.hh>
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#include "ignition/gui/EventBus.hh"
+#include "ignition/gui/GuiEvents.hh"
+#include "ignition/gui/SubscriptionHub.hh"
+#include "ignition/gui/TopicRegistry.hh"
+
+#include "ScanConversion.hh"
+
+// Default color
+static const ignition::math::Color kDefaultColor{
+    ignition::math::Color(1.0f, 0.0f, 0.0f, 1.0f)};
+
+namespace ignition
+{
+namespace gui
+{
+namespace plugins
+{
+  /// \brief The scans of one topic
+  struct ScanStream
+  {
+    /// \brief Topic
+    std::string topic;
+
+    /// \brief Subscription to the topic, 0 if none. Only used on the GUI
+    /// thread.
+    std::size_t subscription{0};
+
+    /// \brief Newest scan not drawn yet, shared with other subscribers.
+    /// Protected by the state's mutex.
+    std::shared_ptr<const msgs::LaserScan> msg;
+
+    /// \brief Visual placed at the sensor, null until the first scan.
+    /// Only used on the render thread, like the members below.
+    rendering::VisualPtr visual;
+
+    /// \brief Points or lines, whose vertex buffer is kept between scans
+    rendering::MarkerPtr marker;
+
+    /// \brief Beam directions of the latest scan
+    ScanConversion::Directions dirs;
+
+    /// \brief X of each beam of the latest scan
+    std::vector<float> x;
+
+    /// \brief Y of each beam of the latest scan
+    std::vector<float> y;
+
+    /// \brief Z of each beam of the latest scan
+    std::vector<float> z;
+
+    /// \brief Whether each range of the latest scan is valid
+    std::vector<std::uint8_t> valid;
+
+    /// \brief True once a scan with the wrong number of ranges was
+    /// reported, so it's only said once
+    bool warned{false};
+  };
+
+  /// \brief What the render event handler works on. It's shared with the
+  /// handler, which may outlive the plugin until the visuals are destroyed
+  /// on the render thread.
+  class LaserScanState
+  {
+    /// \brief Draw the scans received since the last frame. Called on the
+    /// render thread.
+    public: void OnRender();
+
+    /// \brief Draw a scan.
+    /// \param[in] _stream Stream the scan came from
+    /// \param[in] _msg Scan
+    private: void Draw(ScanStream &_stream, const msgs::LaserScan &_msg);
+
+    /// \brief Destroy the visual of a stream.
+    /// \param[in] _stream Stream
+    private: void Destroy(ScanStream &_stream);
+
+    /// \brief Render engine name
+    public: std::string engineName{"ogre"};
+
+    /// \brief Scene name
+    public: std::string sceneName{"scene"};
+
+    /// \brief True to join neighbouring ranges with lines
+    public: bool lines{false};
+
+    /// \brief Color of the scans
+    public: math::Color color{kDefaultColor};
+
+    /// \brief Protects the members below
+    public: std::mutex mutex;
+
+    /// \brief Topics shown
+    public: std::vector<std::shared_ptr<ScanStream>> streams;
+
+    /// \brief Streams removed, whose visuals are yet to be destroyed
+    public: std::vector<std::shared_ptr<ScanStream>> removed;
+
+    /// \brief Set once the plugin is gone
+    public: bool stopping{false};
+
+    /// \brief True once the render thread may have made visuals, which it
+    /// then destroys itself once stopping
+    public: bool drawing{false};
+
+    /// \brief Subscription to render events
+    public: std::atomic<std::size_t> renderSubscription{0};
+
+    /// \brief Scene drawn to, null until the first scan. Only used on the
+    /// render thread, like the members below.
+    private: rendering::ScenePtr scene;
+
+    /// \brief Material of all scans
+    private: rendering::MaterialPtr material;
+
+    /// \brief True once the scene couldn't be found, so it's only said once
+    private: bool failed{false};
+  };
+
+  class LaserScanPrivate
+  {
+    /// \brief Subscribe to the topic of a stream
+    /// \param[in] _stream Stream
+    public: void Subscribe(const std::shared_ptr<ScanStream> &_stream);
+
+    /// \brief Shared with the render event handler
+    public: std::shared_ptr<LaserScanState> state{
+        std::make_shared<LaserScanState>()};
+
+    /// \brief Topics publishing laser scans
+    public: QStringList topicList;
+
+    /// \brief True while the card is hidden
+    public: bool suspended{false};
+  };
+}
+}
+}
+
+using namespace ignition;
+using namespace gui;
+using namespace plugins;
+
+/////////////////////////////////////////////////
+void LaserScanState::OnRender()
+{
+  std::vector<std::pair<std::shared_ptr<ScanStream>,
+      std::shared_ptr<const msgs::LaserScan>>> batch;
+  std::vector<std::shared_ptr<ScanStream>> destroy;
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    destroy.swap(this->removed);
+    if (this->stopping)
+    {
+      destroy.insert(destroy.end(), this->streams.begin(),
+          this->streams.end());
+      this->streams.clear();
+    }
+    for (auto &stream : this->streams)
+    {
+      if (stream->msg)
+        batch.emplace_back(stream, std::move(stream->msg));
+    }
+    if (!batch.empty() && !this->failed)
+      this->drawing = true;
+  }
+
+  for (auto &stream : destroy)
+    this->Destroy(*stream);
+
+  if (!batch.empty() && !this->scene && !this->failed)
+  {
+    auto engine = rendering::engine(this->engineName);
+    if (engine)
+      this->scene = engine->SceneByName(this->sceneName);
+    if (this->scene)
+    {
+      this->material = this->scene->CreateMaterial();
+      this->material->SetAmbient(this->color);
+      this->material->SetDiffuse(this->color);
+      this->material->SetEmissive(this->color);
+    }
+    else
+    {
+      ignwarn << "Scene \"" << this->sceneName << "\" of engine \""
+              << this->engineName << "\" not found, laser scans won't be "
+              << "shown." << std::endl;
+      this->failed = true;
+    }
+  }
+
+  if (this->scene)
+  {
+    for (auto &item : batch)
+      this->Draw(*item.first, *item.second);
+  }
+
+  // Done once everything was destroyed
+  bool stopping;
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    stopping = this->stopping;
+  }
+  if (stopping)
+  {
+    if (this->scene && this->material)
+      this->scene->DestroyMaterial(this->material);
+    this->material.reset();
+    this->scene.reset();
+    if (auto id = this->renderSubscription.exchange(0u))
+      EventBus::Instance().Unsubscribe(id);
+  }
+}
+
+/////////////////////////////////////////////////
+void LaserScanState::Draw(ScanStream &_stream, const msgs::LaserScan &_msg)
+{
+  // Older publishers leave the steps out
+  auto count = static_cast<std::size_t>(_msg.count());
+  auto verticalCount =
+      std::max<std::size_t>(static_cast<std::size_t>(_msg.vertical_count()),
+      1u);
+  double step = _msg.angle_step();
+  if (step == 0.0 && count > 1)
+    step = (_msg.angle_max() - _msg.angle_min()) / (count - 1);
+  double verticalStep = _msg.vertical_angle_step();
+  if (verticalStep == 0.0 && verticalCount > 1)
+  {
+    verticalStep = (_msg.vertical_angle_max() - _msg.vertical_angle_min()) /
+        (verticalCount - 1);
+  }
+
+  auto size = static_cast<std::size_t>(_msg.ranges_size());
+  if (size != count * verticalCount)
+  {
+    if (!_stream.warned)
+    {
+      ignwarn << "Scan on [" << _stream.topic << "] has " << size
+              << " ranges instead of " << count * verticalCount
+              << ", it won't be shown." << std::endl;
+      _stream.warned = true;
+    }
+    return;
+  }
+
+  _stream.dirs.Update(_msg.angle_min(), step, count,
+      _msg.vertical_angle_min(), verticalStep, _msg.vertical_count());
+  _stream.x.resize(size);
+  _stream.y.resize(size);
+  _stream.z.resize(size);
+  _stream.valid.resize(size);
+  ScanConversion::Project(_msg.ranges().data(), _stream.dirs, size,
+      _msg.range_min(), _msg.range_max(), _stream.x.data(),
+      _stream.y.data(), _stream.z.data(), _stream.valid.data());
+
+  if (!_stream.visual)
+  {
+    _stream.visual = this->scene->CreateVisual();
+    this->scene->RootVisual()->AddChild(_stream.visual);
+
+    _stream.marker = this->scene->CreateMarker();
+    _stream.marker->SetType(this->lines ?
+        rendering::MarkerType::MT_LINE_LIST :
+        rendering::MarkerType::MT_POINTS);
+    _stream.marker->SetMaterial(this->material, false);
+    _stream.visual->AddGeometry(_stream.marker);
+  }
+
+  // Clearing keeps the capacity of the vertex buffer
+  auto &marker = *_stream.marker;
+  marker.ClearPoints();
+  auto point = [&_stream](const std::size_t _i)
+  {
+    return math::Vector3d(_stream.x[_i], _stream.y[_i], _stream.z[_i]);
+  };
+  if (this->lines)
+  {
+    // Segments between neighbouring valid ranges, along each row
+    for (std::size_t j = 0; j < verticalCount; ++j)
+    {
+      for (std::size_t i = j * count + 1; i < (j + 1) * count; ++i)
+      {
+        if (!_stream.valid[i - 1] || !_stream.valid[i])
+          continue;
+        marker.AddPoint(point(i - 1), this->color);
+        marker.AddPoint(point(i), this->color);
+      }
+    }
+  }
+  else
+  {
+    for (std::size_t i = 0; i < size; ++i)
+    {
+      if (_stream.valid[i])
+        marker.AddPoint(point(i), this->color);
+    }
+  }
+
+  _stream.visual->SetWorldPose(msgs::Convert(_msg.world_pose()));
+}
+
+/////////////////////////////////////////////////
+void LaserScanState::Destroy(ScanStream &_stream)
+{
+  if (_stream.visual && this->scene)
+    this->scene->DestroyVisual(_stream.visual);
+  _stream.visual.reset();
+  _stream.marker.reset();
+}
+
+/////////////////////////////////////////////////
+void LaserScanPrivate::Subscribe(const std::shared_ptr<ScanStream> &_stream)
+{
+  // The callback holds on to what it writes to, so it doesn't matter if it
+  // runs once more after unsubscribing
+  auto state = this->state;
+  auto stream = _stream;
+  _stream->subscription = SubscriptionHub::Instance()->Subscribe<
+      msgs::LaserScan>(_stream->topic,
+      [state, stream](const std::shared_ptr<const msgs::LaserScan> &_msg)
+      {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        stream->msg = _msg;
+      });
+  if (!_stream->subscription)
+  {
+    ignerr << "Unable to subscribe to topic [" << _stream->topic << "]"
+           << std::endl;
+  }
+}
+
+/////////////////////////////////////////////////
+LaserScan::LaserScan()
+  : Plugin(), dataPtr(new LaserScanPrivate)
+{
+}
+
+/////////////////////////////////////////////////
+LaserScan::~LaserScan()
+{
+  auto state = this->dataPtr->state;
+  bool drawing;
+  std::vector<std::size_t> subscriptions;
+  {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    for (auto &stream : state->streams)
+      subscriptions.push_back(stream->subscription);
+    state->stopping = true;
+    drawing = state->drawing;
+  }
+
+  // Not holding the mutex, which subscriber callbacks take
+  for (auto subscription : subscriptions)
+    SubscriptionHub::Instance()->Unsubscribe(subscription);
+
+  // Otherwise the next render event destroys the visuals, then
+  // unsubscribes
+  if (!drawing)
+  {
+    if (auto id = state->renderSubscription.exchange(0u))
+      EventBus::Instance().Unsubscribe(id);
+  }
+}
+
+/////////////////////////////////////////////////
+void LaserScan::LoadConfig(const tinyxml2::XMLElement *_pluginElem)
+{
+  // Default name in case user didn't define one
+  if (this->title.empty())
+    this->title = "Laser scan";
+
+  auto state = this->dataPtr->state;
+  std::vector<std::string> topics;
+
+  // Read configuration
+  if (_pluginElem)
+  {
+    for (auto topicElem = _pluginElem->FirstChildElement("topic");
+         topicElem != nullptr;
+         topicElem = topicElem->NextSiblingElement("topic"))
+    {
+      if (topicElem->GetText())
+        topics.push_back(topicElem->GetText());
+    }
+
+    auto elem = _pluginElem->FirstChildElement("engine");
+    if (nullptr != elem && nullptr != elem->GetText())
+      state->engineName = elem->GetText();
+
+    elem = _pluginElem->FirstChildElement("scene");
+    if (nullptr != elem && nullptr != elem->GetText())
+      state->sceneName = elem->GetText();
+
+    elem = _pluginElem->FirstChildElement("style");
+    if (nullptr != elem && nullptr != elem->GetText())
+    {
+      std::string style = elem->GetText();
+      if (style == "lines")
+        state->lines = true;
+      else if (style != "points")
+      {
+        ignwarn << "Unknown style [" << style << "], drawing points."
+                << std::endl;
+      }
+    }
+
+    elem = _pluginElem->FirstChildElement("color");
+    if (nullptr != elem && nullptr != elem->GetText())
+    {
+      std::stringstream colorStr;
+      colorStr << std::string(elem->GetText());
+      colorStr >> state->color;
+    }
+  }
+
+  // Scans are drawn on the render thread, right after each frame. The
+  // handler keeps the state until it unsubscribes.
+  state->renderSubscription = EventBus::Instance().Subscribe<events::Render>(
+      [state](const events::Render &)
+      {
+        state->OnRender();
+      });
+
+  this->OnRefresh();
+  if (topics.empty() && !this->dataPtr->topicList.empty())
+    topics.push_back(this->dataPtr->topicList.front().toStdString());
+
+  for (const auto &topic : topics)
+    this->AddTopic(QString::fromStdString(topic));
+}
+
+/////////////////////////////////////////////////
+void LaserScan::AddTopic(const QString &_topic)
+{
+  auto topic = _topic.toStdString();
+  if (topic.empty())
+    return;
+
+  auto state = this->dataPtr->state;
+  {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    for (const auto &stream : state->streams)
+    {
+      if (stream->topic == topic)
+        return;
+    }
+  }
+
+  auto stream = std::make_shared<ScanStream>();
+  stream->topic = topic;
+
+  // Subscribed to once the card is shown
+  if (!this->dataPtr->suspended)
+    this->dataPtr->Subscribe(stream);
+
+  {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->streams.push_back(stream);
+  }
+  this->ShownTopicsChanged();
+}
+
+/////////////////////////////////////////////////
+void LaserScan::RemoveTopic(const QString &_topic)
+{
+  auto topic = _topic.toStdString();
+  auto state = this->dataPtr->state;
+  std::shared_ptr<ScanStream> stream;
+  {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    auto it = std::find_if(state->streams.begin(), state->streams.end(),
+        [&topic](const std::shared_ptr<ScanStream> &_stream)
+        {
+          return _stream->topic == topic;
+        });
+    if (it == state->streams.end())
+      return;
+
+    stream = *it;
+    state->removed.push_back(stream);
+    state->streams.erase(it);
+  }
+
+  SubscriptionHub::Instance()->Unsubscribe(stream->subscription);
+  stream->subscription = 0;
+  this->ShownTopicsChanged();
+}
+
+/////////////////////////////////////////////////
+void LaserScan::Suspend()
+{
+  this->dataPtr->suspended = true;
+  auto state = this->dataPtr->state;
+  std::vector<std::shared_ptr<ScanStream>> streams;
+  {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    streams = state->streams;
+  }
+  for (auto &stream : streams)
+  {
+    SubscriptionHub::Instance()->Unsubscribe(stream->subscription);
+    stream->subscription = 0;
+  }
+}
+
+/////////////////////////////////////////////////
+void LaserScan::Resume()
+{
+  this->dataPtr->suspended = false;
+  auto state = this->dataPtr->state;
+  std::vector<std::shared_ptr<ScanStream>> streams;
+  {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    streams = state->streams;
+  }
+  for (auto &stream : streams)
+    this->dataPtr->Subscribe(stream);
+}
+
+/////////////////////////////////////////////////
+std::size_t LaserScan::MemoryUsage() const
+{
+  auto state = this->dataPtr->state;
+  std::lock_guard<std::mutex> lock(state->mutex);
+  std::size_t bytes{0};
+  for (const auto &stream : state->streams)
+  {
+    if (stream->msg)
+      bytes += stream->msg->ranges_size() * sizeof(double);
+    bytes += stream->dirs.Size() * 3 * sizeof(float);
+    bytes += stream->x.capacity() * 3 * sizeof(float);
+    bytes += stream->valid.capacity();
+  }
+  return bytes;
+}
+
+/////////////////////////////////////////////////
+void LaserScan::OnRefresh()
+{
+  // Get updated list from the shared cache, and have it checked again so
+  // topics which just showed up are there next time
+  this->dataPtr->topicList.clear();
+  auto registry = TopicRegistry::Instance();
+  for (const auto &topic : registry->Topics("ignition.msgs.LaserScan"))
+    this->dataPtr->topicList.push_back(QString::fromStdString(topic));
+  registry->Refresh();
+  this->TopicListChanged();
+}
+
+/////////////////////////////////////////////////
+QStringList LaserScan::TopicList() const
+{
+  return this->dataPtr->topicList;
+}
+
+/////////////////////////////////////////////////
+QStringList LaserScan::ShownTopics() const
+{
+  QStringList topics;
+  auto state = this->dataPtr->state;
+  std::lock_guard<std::mutex> lock(state->mutex);
+  for (const auto &stream : state->streams)
+    topics.push_back(QString::fromStdString(stream->topic));
+  return topics;
+}
+
+// Register this plugin
+IGNITION_ADD_PLUGIN(ignition::gui::plugins::LaserScan,
+                    ignition::gui::Plugin)
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGNITION_GUI_PLUGINS_LASERSCAN_HH_
+#define IGNITION_GUI_PLUGINS_LASERSCAN_HH_
+
+#include <memory>
+
+#include "ignition/gui/Plugin.hh"
+
+namespace ignition
+{
+namespace gui
+{
+namespace plugins
+{
+  class LaserScanPrivate;
+
+  /// \brief Display laser scans coming through Ignition transport topics
+  /// in the 3D scene.
+  ///
+  /// ## Configuration
+  ///
+  /// \<topic\> : Topic to receive ignition::msgs::LaserScan msgs on. Can be
+  ///             given more than once to show several scans. The first
+  ///             topic publishing scans is shown if there's none.
+  /// \<engine\> : Render engine of the scene, defaults to "ogre".
+  /// \<scene\> : Name of the scene, defaults to "scene".
+  /// \<style\> : "points" to draw a point per range, or "lines" to join
+  ///             neighbouring ranges. Defaults to "points".
+  /// \<color\> : Color of the scans, defaults to red.
+  ///
+  /// Scans are drawn at the world pose of their sensor. Ranges which are
+  /// out of the scan's limits, infinite or NaN are left out, and lines
+  /// don't cross them.
+  ///
+  /// Each topic keeps a single marker, whose vertex buffer is refilled
+  /// with every scan. All the scans received since the last frame are
+  /// drawn in one go when the scene sends its events::Render event, on the
+  /// render thread, and only the newest scan of each topic is drawn.
+  class LaserScan : public Plugin
+  {
+    Q_OBJECT
+
+    /// \brief Topics publishing laser scans
+    Q_PROPERTY(
+      QStringList topicList
+      READ TopicList
+      NOTIFY TopicListChanged
+    )
+
+    /// \brief Topics whose scans are shown
+    Q_PROPERTY(
+      QStringList shownTopics
+      READ ShownTopics
+      NOTIFY ShownTopicsChanged
+    )
+
+    /// \brief Constructor
+    public: LaserScan();
+
+    /// \brief Destructor
+    public: virtual ~LaserScan();
+
+    // Documentation inherited
+    public: virtual void LoadConfig(const tinyxml2::XMLElement *_pluginElem);
+
+    /// \brief Callback when refresh button is pressed.
+    public slots: void OnRefresh();
+
+    /// \brief Show the scans of a topic.
+    /// \param[in] _topic Topic
+    public slots: void AddTopic(const QString &_topic);
+
+    /// \brief Stop showing the scans of a topic.
+    /// \param[in] _topic Topic
+    public slots: void RemoveTopic(const QString &_topic);
+
+    // Documentation inherited
+    protected: void Suspend() override;
+
+    // Documentation inherited
+    protected: void Resume() override;
+
+    // Documentation inherited
+    public: std::size_t MemoryUsage() const override;
+
+    /// \brief Get the topics publishing laser scans, as of the latest
+    /// refresh.
+    /// \return Topics
+    public: Q_INVOKABLE QStringList TopicList() const;
+
+    /// \brief Notify that topic list has changed
+    signals: void TopicListChanged();
+
+    /// \brief Get the topics whose scans are shown.
+    /// \return Topics
+    public: Q_INVOKABLE QStringList ShownTopics() const;
+
+    /// \brief Notify that the shown topics have changed
+    signals: void ShownTopicsChanged();
+
+    /// \internal
+    /// \brief Pointer to private data.
+    private: std::unique_ptr<LaserScanPrivate> dataPtr;
+  };
+}
+}
+}
+
+#endif
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+import QtQuick 2.9
+import QtQuick.Controls 2.2
+import QtQuick.Controls.Material 2.1
+import QtQuick.Layouts 1.3
+
+Rectangle {
+  id: "laserScan"
+  color: "transparent"
+  anchors.fill: parent
+  Layout.minimumWidth: 250
+  Layout.minimumHeight: 150
+
+  property int tooltipDelay: 500
+  property int tooltipTimeout: 1000
+
+  ColumnLayout {
+    anchors.fill: parent
+    anchors.margins: 10
+
+    RowLayout {
+      RoundButton {
+        text: "\u21bb"
+        Material.background: Material.primary
+        onClicked: {
+          LaserScan.OnRefresh();
+        }
+        ToolTip.visible: hovered
+        ToolTip.delay: tooltipDelay
+        ToolTip.timeout: tooltipTimeout
+        ToolTip.text: qsTr("Refresh list of topics publishing laser scans")
+      }
+      ComboBox {
+        id: combo
+        Layout.fillWidth: true
+        model: LaserScan.topicList
+        ToolTip.visible: hovered
+        ToolTip.delay: tooltipDelay
+        ToolTip.timeout: tooltipTimeout
+        ToolTip.text: qsTr("Ignition transport topics publishing LaserScan messages")
+      }
+      RoundButton {
+        text: "+"
+        enabled: combo.currentIndex >= 0
+        Material.background: Material.primary
+        onClicked: {
+          LaserScan.AddTopic(combo.currentText);
+        }
+        ToolTip.visible: hovered
+        ToolTip.delay: tooltipDelay
+        ToolTip.timeout: tooltipTimeout
+        ToolTip.text: qsTr("Show the scans of this topic")
+      }
+    }
+    Repeater {
+      model: LaserScan.shownTopics
+      RowLayout {
+        Label {
+          text: modelData
+          elide: Text.ElideLeft
+          Layout.fillWidth: true
+        }
+        RoundButton {
+          text: "\u2715"
+          flat: true
+          onClicked: {
+            LaserScan.RemoveTopic(modelData);
+          }
+          ToolTip.visible: hovered
+          ToolTip.delay: tooltipDelay
+          ToolTip.timeout: tooltipTimeout
+          ToolTip.text: qsTr("Stop showing the scans of this topic")
+        }
+      }
+    }
+    Item {
+      Layout.fillHeight: true
+    }
+  }
+}
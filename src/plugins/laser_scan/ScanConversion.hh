@@ -0,0 +1,279 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGNITION_GUI_PLUGINS_LASERSCAN_SCANCONVERSION_HH_
+#define IGNITION_GUI_PLUGINS_LASERSCAN_SCANCONVERSION_HH_
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IGN_GUI_SCANCONVERSION_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define IGN_GUI_SCANCONVERSION_NEON
+#include <arm_neon.h>
+#endif
+
+namespace ignition
+{
+namespace gui
+{
+namespace plugins
+{
+  /// \brief Kernels turning the ranges of laser scans into points in the
+  /// sensor frame.
+  ///
+  /// The direction of each beam only depends on the scan's angles, so it's
+  /// computed once into a Directions table and kept for as long as the
+  /// angles don't change. Each scan then only takes a multiplication per
+  /// coordinate, plus a check of the range limits. The kernels use SSE2 on
+  /// x86 and NEON on 64 bit ARM, which are always available there, and
+  /// plain loops anywhere else. The plain loops are also available as
+  /// ScanConversion::Scalar*, and the kernels match them to within float
+  /// rounding.
+  namespace ScanConversion
+  {
+    /// \brief Unit vector of each beam of a scan, in the order of its
+    /// ranges: horizontal beams for each vertical angle in turn.
+    struct Directions
+    {
+      /// \brief X of each beam
+      std::vector<float> x;
+
+      /// \brief Y of each beam
+      std::vector<float> y;
+
+      /// \brief Z of each beam
+      std::vector<float> z;
+
+      /// \brief Angle of the first horizontal beam
+      double angleMin{0.0};
+
+      /// \brief Angle between horizontal beams
+      double angleStep{0.0};
+
+      /// \brief Number of horizontal beams
+      std::size_t count{0};
+
+      /// \brief Angle of the first vertical beam
+      double verticalMin{0.0};
+
+      /// \brief Angle between vertical beams
+      double verticalStep{0.0};
+
+      /// \brief Number of vertical beams
+      std::size_t verticalCount{0};
+
+      /// \brief Get the number of beams.
+      /// \return Horizontal times vertical beam count
+      std::size_t Size() const
+      {
+        return this->x.size();
+      }
+
+      /// \brief Compute the table for a scan's angles, unless it's the one
+      /// already there.
+      /// \param[in] _angleMin Angle of the first horizontal beam
+      /// \param[in] _angleStep Angle between horizontal beams
+      /// \param[in] _count Number of horizontal beams
+      /// \param[in] _verticalMin Angle of the first vertical beam
+      /// \param[in] _verticalStep Angle between vertical beams
+      /// \param[in] _verticalCount Number of vertical beams, 0 is taken as
+      /// 1 for planar scans
+      /// \return True if the table was computed again
+      bool Update(const double _angleMin, const double _angleStep,
+          const std::size_t _count, const double _verticalMin,
+          const double _verticalStep, const std::size_t _verticalCount)
+      {
+        auto verticalCount = _verticalCount > 0 ? _verticalCount : 1;
+        if (_angleMin == this->angleMin && _angleStep == this->angleStep &&
+            _count == this->count && _verticalMin == this->verticalMin &&
+            _verticalStep == this->verticalStep &&
+            verticalCount == this->verticalCount)
+        {
+          return false;
+        }
+
+        this->angleMin = _angleMin;
+        this->angleStep = _angleStep;
+        this->count = _count;
+        this->verticalMin = _verticalMin;
+        this->verticalStep = _verticalStep;
+        this->verticalCount = verticalCount;
+
+        this->x.resize(_count * verticalCount);
+        this->y.resize(_count * verticalCount);
+        this->z.resize(_count * verticalCount);
+        for (std::size_t j = 0; j < verticalCount; ++j)
+        {
+          // Planar scans are in the sensor's XY plane
+          double vertical = _verticalCount > 1 ?
+              _verticalMin + j * _verticalStep : 0.0;
+          double cv = std::cos(vertical);
+          double sv = std::sin(vertical);
+          for (std::size_t i = 0; i < _count; ++i)
+          {
+            double angle = _angleMin + i * _angleStep;
+            auto k = j * _count + i;
+            this->x[k] = static_cast<float>(std::cos(angle) * cv);
+            this->y[k] = static_cast<float>(std::sin(angle) * cv);
+            this->z[k] = static_cast<float>(sv);
+          }
+        }
+        return true;
+      }
+    };
+
+    /// \brief Get the upper range limit the kernels compare against.
+    /// \param[in] _min Smallest valid range
+    /// \param[in] _max Largest valid range, ignored unless it's above _min
+    /// \return Upper limit, finite so that infinite ranges are invalid
+    inline float UpperLimit(const double _min, const double _max)
+    {
+      if (_max > _min && _max < std::numeric_limits<float>::max())
+        return static_cast<float>(_max);
+      return std::numeric_limits<float>::max();
+    }
+
+    /// \brief Plain loop of the kernels, from one beam on.
+    /// \param[in] _ranges Ranges, as carried by the msg
+    /// \param[in] _dirs Direction of each beam, at least as many as ranges
+    /// \param[in] _first First beam
+    /// \param[in] _count Number of ranges
+    /// \param[in] _min Smallest valid range
+    /// \param[in] _max Upper limit, from UpperLimit
+    /// \param[out] _x X of each point, _count of them
+    /// \param[out] _y Y of each point
+    /// \param[out] _z Z of each point
+    /// \param[out] _valid 1 for each valid range, 0 for the others
+    /// \return Number of valid ranges from the first beam on
+    inline std::size_t ProjectFrom(const double *_ranges,
+        const Directions &_dirs, const std::size_t _first,
+        const std::size_t _count, const float _min, const float _max,
+        float *_x, float *_y, float *_z, std::uint8_t *_valid)
+    {
+      std::size_t valid{0};
+      for (std::size_t i = _first; i < _count; ++i)
+      {
+        auto r = static_cast<float>(_ranges[i]);
+        _x[i] = r * _dirs.x[i];
+        _y[i] = r * _dirs.y[i];
+        _z[i] = r * _dirs.z[i];
+
+        // Also catches NaN
+        _valid[i] = r >= _min && r <= _max ? 1u : 0u;
+        valid += _valid[i];
+      }
+      return valid;
+    }
+
+    /// \brief Plain version of Project.
+    /// \param[in] _ranges Ranges, as carried by the msg
+    /// \param[in] _dirs Direction of each beam, at least as many as ranges
+    /// \param[in] _count Number of ranges
+    /// \param[in] _min Smallest valid range
+    /// \param[in] _max Largest valid range, no limit unless it's above _min
+    /// \param[out] _x X of each point, _count of them
+    /// \param[out] _y Y of each point
+    /// \param[out] _z Z of each point
+    /// \param[out] _valid 1 for each range within the limits, 0 for the
+    /// others, including infinite and NaN ones
+    /// \return Number of valid ranges
+    inline std::size_t ScalarProject(const double *_ranges,
+        const Directions &_dirs, const std::size_t _count, const double _min,
+        const double _max, float *_x, float *_y, float *_z,
+        std::uint8_t *_valid)
+    {
+      return ProjectFrom(_ranges, _dirs, 0u, _count,
+          static_cast<float>(_min), UpperLimit(_min, _max), _x, _y, _z,
+          _valid);
+    }
+
+    /// \brief Turn ranges into points in the sensor frame.
+    /// \param[in] _ranges Ranges, as carried by the msg
+    /// \param[in] _dirs Direction of each beam, at least as many as ranges
+    /// \param[in] _count Number of ranges
+    /// \param[in] _min Smallest valid range
+    /// \param[in] _max Largest valid range, no limit unless it's above _min
+    /// \param[out] _x X of each point, _count of them
+    /// \param[out] _y Y of each point
+    /// \param[out] _z Z of each point
+    /// \param[out] _valid 1 for each range within the limits, 0 for the
+    /// others, including infinite and NaN ones
+    /// \return Number of valid ranges
+    inline std::size_t Project(const double *_ranges,
+        const Directions &_dirs, const std::size_t _count, const double _min,
+        const double _max, float *_x, float *_y, float *_z,
+        std::uint8_t *_valid)
+    {
+      std::size_t i = 0u;
+      std::size_t valid{0};
+#if defined(IGN_GUI_SCANCONVERSION_SSE2)
+      // Comparisons with NaN are false
+      const __m128 min = _mm_set1_ps(static_cast<float>(_min));
+      const __m128 max = _mm_set1_ps(UpperLimit(_min, _max));
+      for (; i + 4u <= _count; i += 4u)
+      {
+        __m128 r = _mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(_ranges + i)),
+            _mm_cvtpd_ps(_mm_loadu_pd(_ranges + i + 2u)));
+        _mm_storeu_ps(_x + i, _mm_mul_ps(r, _mm_loadu_ps(&_dirs.x[i])));
+        _mm_storeu_ps(_y + i, _mm_mul_ps(r, _mm_loadu_ps(&_dirs.y[i])));
+        _mm_storeu_ps(_z + i, _mm_mul_ps(r, _mm_loadu_ps(&_dirs.z[i])));
+
+        int mask = _mm_movemask_ps(_mm_and_ps(_mm_cmpge_ps(r, min),
+            _mm_cmple_ps(r, max)));
+        for (int k = 0; k < 4; ++k)
+        {
+          _valid[i + k] = static_cast<std::uint8_t>((mask >> k) & 1);
+          valid += _valid[i + k];
+        }
+      }
+#elif defined(IGN_GUI_SCANCONVERSION_NEON)
+      const float32x4_t min = vdupq_n_f32(static_cast<float>(_min));
+      const float32x4_t max = vdupq_n_f32(UpperLimit(_min, _max));
+      for (; i + 4u <= _count; i += 4u)
+      {
+        float32x4_t r = vcombine_f32(vcvt_f32_f64(vld1q_f64(_ranges + i)),
+            vcvt_f32_f64(vld1q_f64(_ranges + i + 2u)));
+        vst1q_f32(_x + i, vmulq_f32(r, vld1q_f32(&_dirs.x[i])));
+        vst1q_f32(_y + i, vmulq_f32(r, vld1q_f32(&_dirs.y[i])));
+        vst1q_f32(_z + i, vmulq_f32(r, vld1q_f32(&_dirs.z[i])));
+
+        uint32x4_t ok = vshrq_n_u32(vandq_u32(vcgeq_f32(r, min),
+            vcleq_f32(r, max)), 31);
+        uint8x8_t bytes = vmovn_u16(vcombine_u16(vmovn_u32(ok),
+            vdup_n_u16(0)));
+        vst1_lane_u32(reinterpret_cast<std::uint32_t *>(_valid + i),
+            vreinterpret_u32_u8(bytes), 0);
+        valid += vaddvq_u32(ok);
+      }
+#endif
+      return valid + ProjectFrom(_ranges, _dirs, i, _count,
+          static_cast<float>(_min), UpperLimit(_min, _max), _x, _y, _z,
+          _valid);
+    }
+  }
+}
+}
+}
+
+#endif
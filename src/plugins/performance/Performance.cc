@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2017 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "Performance.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+#include <ignition/common/Console.hh>
+#include <ignition/msgs/stringmsg.pb.h>
+#include <ignition/plugin/Register.hh>
+#include <ignition/transport/Node.hh>
+
+#include "ignition/gui/PluginAccounting.hh"
+
+namespace ignition
+{
+namespace gui
+{
+namespace plugins
+{
+  class PerformancePrivate
+  {
+    /// \brief Costs over the latest period, as given to QML
+    public: QVariantList costs;
+
+    /// \brief Triggers updates
+    public: QTimer timer;
+
+    /// \brief Time of the previous update
+    public: std::chrono::steady_clock::time_point lastUpdate;
+
+    /// \brief Node to publish statistics
+    public: transport::Node node;
+
+    /// \brief Publisher of statistics, invalid if not publishing
+    public: transport::Node::Publisher pub;
+  };
+}
+}
+}
+
+using namespace ignition;
+using namespace gui;
+using namespace plugins;
+
+/// \brief Number of Performance plugins loaded, accounting is enabled while
+/// there's at least one
+static int g_performanceCount{0};
+
+/////////////////////////////////////////////////
+/// \brief Convert the usage of one kind of work to JSON.
+/// \param[in] _usage Usage
+/// \param[in] _period Milliseconds the usage was accounted over
+/// \return JSON object
+static QJsonObject UsageJson(const CostUsage &_usage, double _period)
+{
+  QJsonObject json;
+  json["calls"] = static_cast<int>(_usage.calls);
+  json["ms"] = _usage.total;
+  json["load"] = _period > 0.0 ? 100.0 * _usage.total / _period : 0.0;
+  json["max_ms"] = _usage.max;
+  return json;
+}
+
+/////////////////////////////////////////////////
+Performance::Performance()
+  : Plugin(), dataPtr(new PerformancePrivate)
+{
+  if (g_performanceCount++ == 0)
+    PluginAccounting::Instance().SetEnabled(true);
+
+  this->connect(&this->dataPtr->timer, &QTimer::timeout, this,
+      &Performance::Update);
+}
+
+/////////////////////////////////////////////////
+Performance::~Performance()
+{
+  if (--g_performanceCount == 0)
+    PluginAccounting::Instance().SetEnabled(false);
+}
+
+/////////////////////////////////////////////////
+void Performance::LoadConfig(const tinyxml2::XMLElement *_pluginElem)
+{
+  if (this->title.empty())
+    this->title = "Performance";
+
+  int period{1000};
+  std::string topic{"/gui/stats"};
+  if (_pluginElem)
+  {
+    if (auto elem = _pluginElem->FirstChildElement("period"))
+      elem->QueryIntText(&period);
+
+    if (auto elem = _pluginElem->FirstChildElement("topic"))
+      topic = elem->GetText() ? elem->GetText() : "";
+  }
+
+  if (!topic.empty())
+  {
+    this->dataPtr->pub =
+        this->dataPtr->node.Advertise<msgs::StringMsg>(topic);
+    if (!this->dataPtr->pub)
+    {
+      ignerr << "Failed to advertise performance statistics on [" << topic
+             << "]" << std::endl;
+    }
+  }
+
+  // What was accounted while loading isn't part of the first period
+  PluginAccounting::Instance().Reset();
+  this->dataPtr->lastUpdate = std::chrono::steady_clock::now();
+  this->dataPtr->timer.start(std::max(period, 1));
+}
+
+/////////////////////////////////////////////////
+QVariantList Performance::Costs() const
+{
+  return this->dataPtr->costs;
+}
+
+/////////////////////////////////////////////////
+void Performance::Update()
+{
+  auto &accounting = PluginAccounting::Instance();
+  auto costs = accounting.Costs();
+  accounting.Reset();
+
+  auto now = std::chrono::steady_clock::now();
+  auto period = std::chrono::duration<double, std::milli>(
+      now - this->dataPtr->lastUpdate).count();
+  this->dataPtr->lastUpdate = now;
+
+  QJsonArray plugins;
+  for (const auto &cost : costs)
+  {
+    QJsonObject plugin;
+    plugin["name"] = QString::fromStdString(cost.name);
+    plugin["transport"] = UsageJson(cost.transport, period);
+    plugin["events"] = UsageJson(cost.events, period);
+    plugin["render"] = UsageJson(cost.render, period);
+    plugin["items"] = static_cast<double>(cost.items);
+    plugin["memory"] = static_cast<double>(cost.memory);
+    plugins.append(plugin);
+  }
+
+  this->dataPtr->costs = plugins.toVariantList();
+  this->CostsChanged();
+
+  if (this->dataPtr->pub)
+  {
+    QJsonObject stats;
+    stats["period_ms"] = period;
+    stats["plugins"] = plugins;
+
+    msgs::StringMsg msg;
+    msg.set_data(QJsonDocument(stats).toJson(
+        QJsonDocument::Compact).toStdString());
+    this->dataPtr->pub.Publish(msg);
+  }
+}
+
+// Register this plugin
+IGNITION_ADD_PLUGIN(ignition::gui::plugins::Performance,
+                    ignition::gui::Plugin)
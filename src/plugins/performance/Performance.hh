@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2017 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GUI_PLUGINS_PERFORMANCE_HH_
+#define IGNITION_GUI_PLUGINS_PERFORMANCE_HH_
+
+#include <memory>
+
+#include "ignition/gui/Export.hh"
+#include "ignition/gui/Plugin.hh"
+
+#ifndef _WIN32
+#  define Performance_EXPORTS_API
+#else
+#  if (defined(Performance_EXPORTS))
+#    define Performance_EXPORTS_API __declspec(dllexport)
+#  else
+#    define Performance_EXPORTS_API __declspec(dllimport)
+#  endif
+#endif
+
+namespace ignition
+{
+namespace gui
+{
+namespace plugins
+{
+  class PerformancePrivate;
+
+  /// \brief Shows what each loaded plugin costs: the share of a core spent
+  /// in its transport callbacks, events and queued slots, and render
+  /// hooks, the longest of those calls, and an estimate of its memory. The
+  /// same statistics are published as JSON on a topic. Accounting is
+  /// enabled while the plugin is loaded.
+  ///
+  /// ## Configuration
+  ///
+  /// * \<period\> : Milliseconds between updates, 1000 by default.
+  /// * \<topic\> : Topic to publish the statistics on as msgs::StringMsg,
+  ///               "/gui/stats" by default. Leave empty not to publish.
+  ///
+  /// \sa PluginAccounting
+  class Performance_EXPORTS_API Performance : public ignition::gui::Plugin
+  {
+    Q_OBJECT
+
+    /// \brief Costs of each plugin over the latest period
+    Q_PROPERTY(
+      QVariantList costs
+      READ Costs
+      NOTIFY CostsChanged
+    )
+
+    /// \brief Constructor
+    public: Performance();
+
+    /// \brief Destructor
+    public: virtual ~Performance();
+
+    // Documentation inherited
+    public: virtual void LoadConfig(const tinyxml2::XMLElement *_pluginElem);
+
+    /// \brief Get the costs of each plugin over the latest period. Each one
+    /// is a map with the plugin's "name", the "transport", "events" and
+    /// "render" usage, each with its "calls", total "ms", "load" as a
+    /// percentage of one core and "max_ms", and the "items" and "memory" in
+    /// bytes of the plugin.
+    /// \return Costs
+    public: Q_INVOKABLE QVariantList Costs() const;
+
+    /// \brief Notify that the costs changed
+    signals: void CostsChanged();
+
+    /// \brief Gather the costs accounted since the previous update, display
+    /// and publish them.
+    public slots: void Update();
+
+    /// \internal
+    /// \brief Pointer to private data.
+    private: std::unique_ptr<PerformancePrivate> dataPtr;
+  };
+}
+}
+}
+
+#endif
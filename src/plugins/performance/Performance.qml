@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+import QtQuick 2.9
+import QtQuick.Controls 2.2
+import QtQuick.Layouts 1.3
+
+Rectangle {
+  id: performance
+  color: "transparent"
+  Layout.minimumWidth: 420
+  Layout.minimumHeight: 200
+
+  /**
+   * Format a usage as its load and longest call.
+   * \param _usage Usage with "load" and "max_ms"
+   */
+  function usage(_usage)
+  {
+    if (_usage.calls === 0)
+      return "-";
+    return _usage.load.toFixed(1) + "% (" + _usage.max_ms.toFixed(1) + ")";
+  }
+
+  /**
+   * Format a number of bytes.
+   * \param _bytes Bytes
+   */
+  function memory(_bytes)
+  {
+    if (_bytes >= 1048576)
+      return (_bytes / 1048576).toFixed(1) + " MB";
+    return (_bytes / 1024).toFixed(0) + " kB";
+  }
+
+  ColumnLayout {
+    anchors.fill: parent
+    anchors.margins: 10
+
+    GridLayout {
+      columns: 5
+      columnSpacing: 10
+
+      Label {
+        text: "Plugin"
+        font.bold: true
+        Layout.fillWidth: true
+      }
+      Label {
+        text: "Transport"
+        font.bold: true
+      }
+      Label {
+        text: "Events"
+        font.bold: true
+      }
+      Label {
+        text: "Render"
+        font.bold: true
+      }
+      Label {
+        text: "Memory"
+        font.bold: true
+      }
+
+      Repeater {
+        model: Performance.costs
+        delegate: Label {
+          Layout.row: index + 1
+          Layout.column: 0
+          Layout.fillWidth: true
+          text: modelData.name
+          elide: Text.ElideRight
+        }
+      }
+      Repeater {
+        model: Performance.costs
+        delegate: Label {
+          Layout.row: index + 1
+          Layout.column: 1
+          text: usage(modelData.transport)
+        }
+      }
+      Repeater {
+        model: Performance.costs
+        delegate: Label {
+          Layout.row: index + 1
+          Layout.column: 2
+          text: usage(modelData.events)
+        }
+      }
+      Repeater {
+        model: Performance.costs
+        delegate: Label {
+          Layout.row: index + 1
+          Layout.column: 3
+          text: usage(modelData.render)
+        }
+      }
+      Repeater {
+        model: Performance.costs
+        delegate: Label {
+          Layout.row: index + 1
+          Layout.column: 4
+          text: memory(modelData.memory)
+          ToolTip.visible: memoryArea.containsMouse
+          ToolTip.text: modelData.items + " QML items"
+          MouseArea {
+            id: memoryArea
+            anchors.fill: parent
+            hoverEnabled: true
+          }
+        }
+      }
+    }
+
+    Label {
+      text: "Share of a core, and longest call in ms, over the latest period"
+      font.pixelSize: 10
+      opacity: 0.6
+    }
+
+    Item {
+      Layout.fillHeight: true
+    }
+  }
+}
@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2017 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include <tinyxml2.h>
+
+#include <ignition/common/Console.hh>
+#include <ignition/msgs/stringmsg.pb.h>
+#include <ignition/transport/Node.hh>
+#include <ignition/utilities/ExtraTestMacros.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+#include "ignition/gui/Application.hh"
+#include "ignition/gui/MainWindow.hh"
+#include "ignition/gui/Plugin.hh"
+#include "ignition/gui/PluginAccounting.hh"
+#include "ignition/gui/SubscriptionHub.hh"
+#include "Performance.hh"
+
+int g_argc = 1;
+char **g_argv = new char *[g_argc];
+
+using namespace ignition;
+using namespace gui;
+
+/////////////////////////////////////////////////
+TEST(PerformanceTest, IGN_UTILS_TEST_ENABLED_ONLY_ON_LINUX(Costs))
+{
+  common::Console::SetVerbosity(4);
+
+  Application app(g_argc, g_argv);
+  app.AddPluginPath(std::string(PROJECT_BINARY_PATH) + "/lib");
+
+  EXPECT_FALSE(PluginAccounting::Instance().Enabled());
+  const char *pluginStr =
+    "<plugin filename=\"Performance\">"
+      "<period>100000</period>"
+      "<topic>/test/gui/stats</topic>"
+    "</plugin>";
+  tinyxml2::XMLDocument pluginDoc;
+  pluginDoc.Parse(pluginStr);
+  EXPECT_TRUE(app.LoadPlugin("Performance",
+      pluginDoc.FirstChildElement("plugin")));
+  EXPECT_TRUE(PluginAccounting::Instance().Enabled());
+
+  auto win = app.findChild<MainWindow *>();
+  ASSERT_NE(nullptr, win);
+  auto plugin = win->findChild<plugins::Performance *>();
+  ASSERT_NE(nullptr, plugin);
+
+  std::string published;
+  transport::Node node;
+  std::function<void(const msgs::StringMsg &)> cb =
+      [&published](const msgs::StringMsg &_msg)
+  {
+    published = _msg.data();
+  };
+  EXPECT_TRUE(node.Subscribe("/test/gui/stats", cb));
+
+  // A subscription made on behalf of the plugin is accounted to it
+  std::size_t subscription{0};
+  {
+    PluginCostScope scope(plugin, CostKind::kEvent);
+    EXPECT_EQ(plugin, PluginAccounting::CurrentPlugin());
+    subscription = SubscriptionHub::Instance()->Subscribe<msgs::StringMsg>(
+        "/test/performance/slow",
+        [](const std::shared_ptr<const msgs::StringMsg> &)
+        {
+          std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        });
+  }
+  EXPECT_EQ(nullptr, PluginAccounting::CurrentPlugin());
+
+  auto pub = node.Advertise<msgs::StringMsg>("/test/performance/slow");
+  msgs::StringMsg msg;
+  pub.Publish(msg);
+  pub.Publish(msg);
+  for (int i = 0; i < 100; ++i)
+  {
+    auto current = PluginAccounting::Instance().Costs();
+    if (!current.empty() && current[0].transport.calls == 2u)
+      break;
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  plugin->Update();
+
+  auto costs = plugin->Costs();
+  ASSERT_EQ(1, costs.size());
+  auto cost = costs[0].toMap();
+  EXPECT_EQ("Performance", cost["name"].toString());
+  auto transport = cost["transport"].toMap();
+  EXPECT_EQ(2, transport["calls"].toInt());
+  EXPECT_GE(transport["ms"].toDouble(), 40.0);
+  EXPECT_GE(transport["max_ms"].toDouble(), 20.0);
+  EXPECT_GT(transport["load"].toDouble(), 0.0);
+  EXPECT_GT(cost["items"].toDouble(), 0.0);
+  EXPECT_GT(cost["memory"].toDouble(), 0.0);
+
+  for (int i = 0; i < 50 && published.empty(); ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_NE(std::string::npos, published.find("\"name\":\"Performance\""))
+      << published;
+
+  // Costs are for each period
+  plugin->Update();
+  transport = plugin->Costs()[0].toMap()["transport"].toMap();
+  EXPECT_EQ(0, transport["calls"].toInt());
+
+  SubscriptionHub::Instance()->Unsubscribe(subscription);
+}
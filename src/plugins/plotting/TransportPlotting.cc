@@ -14,6 +14,7 @@
  * limitations under the License.
  *
 */
+#include <ignition/common/Console.hh>
 #include <ignition/plugin/Register.hh>
 #include "TransportPlotting.hh"
 
@@ -26,10 +27,60 @@ TransportPlotting::~TransportPlotting()
 }
 
 //////////////////////////////////////////
-void TransportPlotting::LoadConfig(const tinyxml2::XMLElement *)
+void TransportPlotting::LoadConfig(const tinyxml2::XMLElement *_pluginElem)
 {
   if (this->title.empty())
     this->title = "Transport plotting";
+
+  this->dataPtr->SetMsgsPerSec(this->MsgsPerSec());
+
+  if (!_pluginElem)
+    return;
+
+  auto statsElem = _pluginElem->FirstChildElement("stats_topic");
+  if (statsElem && statsElem->GetText())
+    this->dataPtr->Clock().SetStatsTopic(statsElem->GetText());
+
+  if (auto sharedElem = _pluginElem->FirstChildElement("shared_time_axis"))
+  {
+    auto shared = false;
+    sharedElem->QueryBoolText(&shared);
+    this->PluginItem()->setProperty("sharedTimeAxis", shared);
+  }
+
+  for (auto samplingElem = _pluginElem->FirstChildElement("sampling");
+       samplingElem != nullptr;
+       samplingElem = samplingElem->NextSiblingElement("sampling"))
+  {
+    PlotSampling sampling;
+    if (!samplingElem->GetText() ||
+        !PlotSampling::Parse(samplingElem->GetText(), sampling))
+    {
+      ignerr << "Invalid sampling ["
+             << (samplingElem->GetText() ? samplingElem->GetText() : "")
+             << "]" << std::endl;
+      continue;
+    }
+
+    auto topic = samplingElem->Attribute("topic");
+    auto field = samplingElem->Attribute("field");
+    if (topic && field)
+      this->dataPtr->SetSampling(topic, field, sampling);
+    else
+      this->dataPtr->SetDefaultSampling(sampling);
+  }
+}
+
+//////////////////////////////////////////
+void TransportPlotting::Suspend()
+{
+  this->dataPtr->SetSuspended(true);
+}
+
+//////////////////////////////////////////
+void TransportPlotting::Resume()
+{
+  this->dataPtr->SetSuspended(false);
 }
 
 //////////////////////////////////////////
@@ -32,6 +32,23 @@ namespace plugins
 
 /// \brief Plots fields from Ignition Transport topics.
 /// Fields can be dragged from the Topic Viewer or the Component Inspector.
+///
+/// ## Configuration
+///
+/// \<sampling\> : How samples of a field are reduced before they're
+///                plotted, such as "all", "throttle 0.05", "decimate 10",
+///                "average 0.1" or "minmax 0.1". With topic and field
+///                attributes it only applies to that field, otherwise it
+///                replaces the default of throttling to 60 samples per
+///                second.
+/// \<stats_topic\> : World statistics topic, such as
+///                   /world/default/stats. If set, fields of msgs without
+///                   a header are plotted at its simulation time instead
+///                   of the time since the plugin was loaded.
+/// \<shared_time_axis\> : True for all charts to share one time axis, so
+///                        that scrolling or zooming one moves them all.
+///                        Can be toggled from the toolbar. Defaults to
+///                        false.
 class TransportPlotting : public ignition::gui::Plugin
 {
   Q_OBJECT
@@ -43,7 +60,13 @@ class TransportPlotting : public ignition::gui::Plugin
   public: ~TransportPlotting();
 
   // Documentation inherited
-  public: void LoadConfig(const tinyxml2::XMLElement *) override;
+  public: void LoadConfig(const tinyxml2::XMLElement *_pluginElem) override;
+
+  // Documentation inherited
+  protected: void Suspend() override;
+
+  // Documentation inherited
+  protected: void Resume() override;
 
   /// \brief Interface with the UI to Handle Transport Plotting
   IGN_UTILS_WARN_IGNORE__DLL_INTERFACE_MISSING
@@ -0,0 +1,953 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "PluginHost.hh"
+
+#include <QBuffer>
+#include <QPointer>
+#include <QProcess>
+#include <QQuickImageProvider>
+#include <QTimer>
+
+#ifndef _WIN32
+#include <signal.h>
+#include <sys/types.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#ifdef _MSC_VER
+#pragma warning(push, 0)
+#endif
+#include <ignition/msgs/image.pb.h>
+#include <ignition/msgs/stringmsg.pb.h>
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
+#include <ignition/common/Util.hh>
+#include <ignition/plugin/Register.hh>
+#include <ignition/transport/Node.hh>
+
+#include "ignition/gui/Application.hh"
+#include "ignition/gui/Executor.hh"
+#include "ignition/gui/MainWindow.hh"
+#include "ignition/gui/SharedImage.hh"
+#include "ignition/gui/SubscriptionHub.hh"
+
+#include "PluginHostProtocol.hh"
+
+namespace ignition
+{
+namespace gui
+{
+namespace plugins
+{
+  /// \brief Provides the child's frames to QML
+  class FrameProvider : public QQuickImageProvider
+  {
+    public: FrameProvider()
+       : QQuickImageProvider(QQuickImageProvider::Image)
+    {
+    }
+
+    public: QImage requestImage(const QString &, QSize *,
+        const QSize &) override
+    {
+      {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (!this->img.isNull())
+        {
+          // Must return a copy
+          QImage copy(this->img);
+          return copy;
+        }
+      }
+
+      // Placeholder until the child sends its first frame
+      QImage i(400, 400, QImage::Format_RGB888);
+      i.fill(QColor(128, 128, 128, 100));
+      return i;
+    }
+
+    /// \brief Replace the frame. Can be called from any thread.
+    /// \param[in] _image New frame, which must own its data
+    public: void SetImage(const QImage &_image)
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      this->img = _image;
+    }
+
+    /// \brief Get the memory held by the frame.
+    /// \return Bytes
+    public: std::size_t Bytes()
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      return static_cast<std::size_t>(this->img.bytesPerLine()) *
+          this->img.height();
+    }
+
+    /// \brief Protects img, which is set by the frame worker and read by
+    /// QML
+    private: std::mutex mutex;
+
+    /// \brief Latest frame
+    private: QImage img;
+  };
+
+  class PluginHostPrivate
+  {
+    /// \brief Write the child's config and start it.
+    public: void Start();
+
+    /// \brief Subscribe to the child's frames.
+    public: void Subscribe();
+
+    /// \brief Send an event to the child.
+    /// \param[in] _event Event
+    public: void Send(const PluginHostProtocol::InputEvent &_event);
+
+    /// \brief Take the frames received, one at a time, until there are no
+    /// new ones. Runs on the executor, one at a time.
+    public: void Decode();
+
+    /// \brief Find the window to export, the first time it's there.
+    /// \return Window, null if the main window isn't up yet
+    public: QQuickWindow *Window();
+
+    /// \brief Send the window's frame, if it changed. Called by the GUI
+    /// thread of the child.
+    public: void Export();
+
+    /// \brief Compress a frame and send it. Runs on the executor, one at a
+    /// time.
+    /// \param[in] _image Frame
+    public: void Compress(const QImage &_image);
+
+    /// \brief Receive an event from the host. Called by transport.
+    /// \param[in] _msg Encoded event
+    public: void OnInputMsg(const msgs::StringMsg &_msg);
+
+    /// \brief Act on an event from the host. Called by the GUI thread of
+    /// the child.
+    /// \param[in] _event Event
+    public: void Deliver(const PluginHostProtocol::InputEvent &_event);
+
+    /// \brief Quit if the host process is gone. Called by the GUI thread of
+    /// the child.
+    public: void CheckParent();
+
+    /// \brief The plugin
+    public: PluginHost *plugin{nullptr};
+
+    /// \brief True for the hidden plugin of the child, which exports the
+    /// window instead of hosting a plugin
+    public: bool exporting{false};
+
+    /// \brief Base of the topics frames and input are exchanged on
+    public: std::string topic;
+
+    /// \brief Most frames per second
+    public: double rate{30.0};
+
+    /// \brief Node to exchange input and frames on
+    public: transport::Node node;
+
+    /// \brief Host: true if showing a remote window instead of a child
+    public: bool remote{false};
+
+    /// \brief Host: config of the hosted plugin
+    public: tinyxml2::XMLDocument hostedDoc;
+
+    /// \brief Host: command starting the child
+    public: std::string command{"ign gui"};
+
+    /// \brief Host: whether the child renders offscreen
+    public: bool offscreen{true};
+
+    /// \brief Host: file the child's config is written to
+    public: std::string configPath;
+
+    /// \brief Host: child process, null until it's started the first time
+    public: QProcess *process{nullptr};
+
+    /// \brief Host: true while the child runs
+    public: bool running{false};
+
+    /// \brief Host: why the child isn't running
+    public: QString status;
+
+    /// \brief Host: latest size of the card, which the child's window
+    /// follows
+    public: int width{640};
+
+    /// \brief Host: latest height of the card
+    public: int height{480};
+
+    /// \brief Host: publisher of input for the child
+    public: transport::Node::Publisher inputPub;
+
+    /// \brief Host: subscription to the child's frames, 0 if none
+    public: std::size_t subscription{0};
+
+    /// \brief Host: true while the card is hidden
+    public: bool suspended{false};
+
+    /// \brief Host: protects pending, decoding and stopping
+    public: std::mutex mutex;
+
+    /// \brief Host: latest frame msg which wasn't decoded yet
+    public: std::shared_ptr<const msgs::Image> pending;
+
+    /// \brief Host: true while a decoding task is queued or running
+    public: bool decoding{false};
+
+    /// \brief Host: set on destruction to stop decoding
+    public: bool stopping{false};
+
+    /// \brief Host: reads the frames' pixels from shared memory, used by
+    /// the decoding task only
+    public: SharedImageReader reader;
+
+    /// \brief Host: provides the frames to QML
+    public: FrameProvider *provider{nullptr};
+
+    /// \brief Child: window whose frames are exported
+    public: QPointer<QQuickWindow> window;
+
+    /// \brief Child: true if the window was drawn since the latest frame
+    /// was sent
+    public: bool dirty{true};
+
+    /// \brief Child: true while the host's card is hidden
+    public: bool paused{false};
+
+    /// \brief Child: sends frames at the rate
+    public: QTimer *frameTimer{nullptr};
+
+    /// \brief Child: checks that the host is still there
+    public: QTimer *parentTimer{nullptr};
+
+    /// \brief Child: process of the host
+    public: long long parentPid{0};
+
+    /// \brief Child: JPEG quality of the frames, or -1 to send them raw
+    /// through shared memory
+    public: int quality{-1};
+
+    /// \brief Child: true while a frame is being compressed
+    public: std::atomic<bool> compressing{false};
+
+    /// \brief Child: publisher of frames
+    public: transport::Node::Publisher framePub;
+
+    /// \brief Child: frame msg, reused so its buffer is kept
+    public: msgs::Image frame;
+
+    /// \brief Child: moves the frames' pixels to shared memory
+    public: SharedImageWriter writer;
+  };
+}
+}
+}
+
+using namespace ignition;
+using namespace gui;
+using namespace plugins;
+
+/////////////////////////////////////////////////
+void PluginHostPrivate::Start()
+{
+  auto hostedElem = this->hostedDoc.FirstChildElement("plugin");
+  if (!hostedElem)
+    return;
+
+  std::string home;
+  common::env(IGN_HOMEDIR, home);
+  auto dir = common::joinPaths(home, ".ignition", "gui", "plugin_host");
+  common::createDirectories(dir);
+
+  std::ofstream out(this->configPath, std::ios::out | std::ios::trunc);
+  if (!out || !(out << PluginHostProtocol::ChildConfig(hostedElem,
+      this->topic, this->rate, QCoreApplication::applicationPid(),
+      this->width, this->height)))
+  {
+    ignerr << "Unable to write config [" << this->configPath << "]"
+           << std::endl;
+    this->status = "Unable to write the child's config";
+    this->plugin->RunningChanged();
+    return;
+  }
+  out.close();
+
+  auto args = QString::fromStdString(this->command).split(' ',
+      QString::SkipEmptyParts);
+  if (args.empty())
+  {
+    ignerr << "Empty <command>" << std::endl;
+    this->status = "No command to start the child";
+    this->plugin->RunningChanged();
+    return;
+  }
+  auto program = args.takeFirst();
+  args << "-c" << QString::fromStdString(this->configPath);
+
+  auto env = QProcessEnvironment::systemEnvironment();
+  if (this->offscreen)
+    env.insert("QT_QPA_PLATFORM", "offscreen");
+  this->process->setProcessEnvironment(env);
+
+  igndbg << "Starting [" << this->command << "] to host ["
+         << hostedElem->Attribute("filename") << "]" << std::endl;
+
+  this->process->start(program, args);
+  this->running = true;
+  this->status.clear();
+  this->plugin->RunningChanged();
+}
+
+/////////////////////////////////////////////////
+void PluginHostPrivate::Subscribe()
+{
+  this->subscription = SubscriptionHub::Instance()->Subscribe<msgs::Image>(
+      this->topic + "/frame",
+      [this](const std::shared_ptr<const msgs::Image> &_msg)
+      {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->pending = _msg;
+        if (this->stopping || this->decoding)
+          return;
+
+        this->decoding = true;
+        Executor::Instance().Post(this, [this]()
+        {
+          this->Decode();
+        });
+      });
+  if (!this->subscription)
+  {
+    ignerr << "Unable to subscribe to topic [" << this->topic << "/frame]"
+           << std::endl;
+  }
+}
+
+/////////////////////////////////////////////////
+void PluginHostPrivate::Send(const PluginHostProtocol::InputEvent &_event)
+{
+  if (!this->running)
+    return;
+
+  msgs::StringMsg msg;
+  msg.set_data(PluginHostProtocol::Encode(_event));
+  this->inputPub.Publish(msg);
+}
+
+/////////////////////////////////////////////////
+void PluginHostPrivate::Decode()
+{
+  msgs::Image msg;
+  while (true)
+  {
+    std::shared_ptr<const msgs::Image> next;
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      if (this->stopping || !this->pending)
+      {
+        this->decoding = false;
+        return;
+      }
+      next.swap(this->pending);
+    }
+
+    // The msg is small, the pixels are read from shared memory once
+    msg.CopyFrom(*next);
+    next.reset();
+    if (SharedImageReader::IsShared(msg) && !this->reader.Read(msg))
+      continue;
+
+    QImage image;
+    auto step = msg.step();
+    if (PluginHostProtocol::IsJpeg(msg.data()))
+    {
+      image = QImage::fromData(
+          reinterpret_cast<const uchar *>(msg.data().data()),
+          static_cast<int>(msg.data().size()), "JPG");
+      if (image.isNull())
+      {
+        ignwarn << "Dropping frame which can't be decoded" << std::endl;
+        continue;
+      }
+    }
+    else if (msg.pixel_format_type() != msgs::PixelFormatType::BGRA_INT8 ||
+        msg.width() == 0u || msg.height() == 0u ||
+        step < msg.width() * 4u ||
+        msg.data().size() < static_cast<std::size_t>(step) * msg.height())
+    {
+      ignwarn << "Dropping malformed frame" << std::endl;
+      continue;
+    }
+    else
+    {
+      // Raw frames were grabbed on this host, so their bytes are QImage's
+      // native ARGB32. The image takes over the msg data.
+      auto data = new std::string();
+      data->swap(*msg.mutable_data());
+      image = QImage(reinterpret_cast<uchar *>(&(*data)[0]), msg.width(),
+          msg.height(), step, QImage::Format_ARGB32_Premultiplied,
+          [](void *_data)
+          {
+            delete static_cast<std::string *>(_data);
+          }, data);
+    }
+    this->provider->SetImage(image);
+
+    auto plugin = this->plugin;
+    Executor::Instance().PostToGui(plugin, [plugin]()
+    {
+      plugin->newFrame();
+    }, "frame");
+  }
+}
+
+/////////////////////////////////////////////////
+QQuickWindow *PluginHostPrivate::Window()
+{
+  if (this->window)
+    return this->window;
+
+  auto win = App() ? App()->findChild<MainWindow *>() : nullptr;
+  if (!win || !win->QuickWindow())
+    return nullptr;
+
+  // Frames are only sent when the window was drawn since the last one
+  this->window = win->QuickWindow();
+  QObject::connect(this->window, &QQuickWindow::frameSwapped, this->plugin,
+      [this]()
+      {
+        this->dirty = true;
+      });
+  this->dirty = true;
+  return this->window;
+}
+
+/////////////////////////////////////////////////
+void PluginHostPrivate::Export()
+{
+  auto win = this->Window();
+  if (!win || !this->dirty || this->paused)
+    return;
+
+  // Nobody watches, or the previous frame is still being compressed. The
+  // window stays dirty so the next tick sends it.
+  if (!this->framePub.HasConnections() || this->compressing)
+    return;
+  this->dirty = false;
+
+  auto image = win->grabWindow().convertToFormat(
+      QImage::Format_ARGB32_Premultiplied);
+  if (image.isNull())
+    return;
+
+  // Compression takes longer than grabbing, so it's kept off the GUI thread
+  if (this->quality >= 0)
+  {
+    this->compressing = true;
+    Executor::Instance().Post(this, [this, image]()
+    {
+      this->Compress(image);
+    });
+    return;
+  }
+
+  this->frame.set_width(image.width());
+  this->frame.set_height(image.height());
+  this->frame.set_step(image.bytesPerLine());
+  this->frame.set_pixel_format_type(msgs::PixelFormatType::BGRA_INT8);
+  this->frame.mutable_data()->assign(
+      reinterpret_cast<const char *>(image.constBits()),
+      static_cast<std::size_t>(image.bytesPerLine()) * image.height());
+
+  // Without shared memory the pixels go in the msg
+  this->writer.Write(this->frame);
+  this->framePub.Publish(this->frame);
+}
+
+/////////////////////////////////////////////////
+void PluginHostPrivate::Compress(const QImage &_image)
+{
+  QByteArray bytes;
+  QBuffer buffer(&bytes);
+  buffer.open(QIODevice::WriteOnly);
+  if (!_image.save(&buffer, "JPG", this->quality))
+  {
+    ignerr << "Failed to compress frame" << std::endl;
+    this->compressing = false;
+    return;
+  }
+
+  // Told apart from raw RGB by its size, so ImageDisplay can show it too
+  msgs::Image msg;
+  msg.set_width(_image.width());
+  msg.set_height(_image.height());
+  msg.set_step(_image.width() * 3);
+  msg.set_pixel_format_type(msgs::PixelFormatType::RGB_INT8);
+  msg.set_data(bytes.constData(), bytes.size());
+  this->framePub.Publish(msg);
+  this->compressing = false;
+}
+
+/////////////////////////////////////////////////
+void PluginHostPrivate::OnInputMsg(const msgs::StringMsg &_msg)
+{
+  PluginHostProtocol::InputEvent event;
+  if (!PluginHostProtocol::Decode(_msg.data(), event))
+  {
+    ignwarn << "Ignoring malformed input [" << _msg.data() << "]"
+            << std::endl;
+    return;
+  }
+
+  // Events are delivered in order, none is coalesced
+  Executor::Instance().PostToGui(this->plugin, [this, event]()
+  {
+    this->Deliver(event);
+  });
+}
+
+/////////////////////////////////////////////////
+void PluginHostPrivate::Deliver(const PluginHostProtocol::InputEvent &_event)
+{
+  if (_event.type == "pause")
+  {
+    this->paused = true;
+    return;
+  }
+  if (_event.type == "resume")
+  {
+    this->paused = false;
+    this->dirty = true;
+    return;
+  }
+
+  auto win = this->Window();
+  if (!win)
+    return;
+
+  if (_event.type == "resize")
+  {
+    if (_event.x >= 1.0 && _event.y >= 1.0)
+      win->resize(static_cast<int>(_event.x), static_cast<int>(_event.y));
+    return;
+  }
+
+  QPointF pos(_event.x, _event.y);
+  QPointF globalPos(win->mapToGlobal(pos.toPoint()));
+  auto button = static_cast<Qt::MouseButton>(_event.button);
+  auto buttons = static_cast<Qt::MouseButtons>(_event.buttons);
+  auto modifiers = static_cast<Qt::KeyboardModifiers>(_event.modifiers);
+
+  QEvent::Type mouseType{QEvent::None};
+  if (_event.type == "press")
+    mouseType = QEvent::MouseButtonPress;
+  else if (_event.type == "release")
+    mouseType = QEvent::MouseButtonRelease;
+  else if (_event.type == "double")
+    mouseType = QEvent::MouseButtonDblClick;
+  else if (_event.type == "move")
+    mouseType = QEvent::MouseMove;
+
+  if (mouseType != QEvent::None)
+  {
+    QMouseEvent event(mouseType, pos, pos, globalPos, button, buttons,
+        modifiers);
+    QCoreApplication::sendEvent(win, &event);
+  }
+  else if (_event.type == "wheel")
+  {
+    QWheelEvent event(pos, globalPos, QPoint(), QPoint(0, _event.value),
+        _event.value, Qt::Vertical, buttons, modifiers);
+    QCoreApplication::sendEvent(win, &event);
+  }
+  else if (_event.type == "keypress" || _event.type == "keyrelease")
+  {
+    QKeyEvent event(_event.type == "keypress" ? QEvent::KeyPress :
+        QEvent::KeyRelease, _event.value, modifiers,
+        QString::fromStdString(_event.text));
+    QCoreApplication::sendEvent(win, &event);
+  }
+  else
+  {
+    ignwarn << "Unknown input type [" << _event.type << "]" << std::endl;
+  }
+}
+
+/////////////////////////////////////////////////
+void PluginHostPrivate::CheckParent()
+{
+#ifndef _WIN32
+  if (this->parentPid > 0 &&
+      kill(static_cast<pid_t>(this->parentPid), 0) != 0 && errno == ESRCH)
+  {
+    ignmsg << "Host process [" << this->parentPid << "] is gone, quitting"
+           << std::endl;
+    QCoreApplication::quit();
+  }
+#endif
+}
+
+/////////////////////////////////////////////////
+PluginHost::PluginHost()
+  : Plugin(), dataPtr(new PluginHostPrivate)
+{
+  this->dataPtr->plugin = this;
+}
+
+/////////////////////////////////////////////////
+PluginHost::~PluginHost()
+{
+  if (this->dataPtr->exporting)
+  {
+    Executor::Instance().Cancel(this->dataPtr.get());
+    return;
+  }
+
+  // Stop receiving and let the worker finish before the provider goes
+  SubscriptionHub::Instance()->Unsubscribe(this->dataPtr->subscription);
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->stopping = true;
+  }
+  Executor::Instance().Cancel(this->dataPtr.get());
+
+  // Ask the child to quit, then make it
+  auto process = this->dataPtr->process;
+  if (process)
+  {
+    process->disconnect(this);
+    if (process->state() != QProcess::NotRunning)
+    {
+      process->terminate();
+      if (!process->waitForFinished(2000))
+      {
+        process->kill();
+        process->waitForFinished(1000);
+      }
+    }
+  }
+
+  if (!this->dataPtr->configPath.empty())
+    common::removeFile(this->dataPtr->configPath);
+
+  if (this->dataPtr->provider)
+  {
+    App()->Engine()->removeImageProvider(
+        this->CardItem()->objectName() + "pluginhost");
+  }
+}
+
+/////////////////////////////////////////////////
+void PluginHost::LoadConfig(const tinyxml2::XMLElement *_pluginElem)
+{
+  if (!_pluginElem)
+  {
+    ignerr << "Null plugin element." << std::endl;
+    return;
+  }
+
+  if (auto rateElem = _pluginElem->FirstChildElement("rate"))
+  {
+    double rate = 0.0;
+    rateElem->QueryDoubleText(&rate);
+    if (rate > 0.0)
+      this->dataPtr->rate = rate;
+  }
+
+  // Child: export the window hosting the plugin
+  if (auto exportElem = _pluginElem->FirstChildElement("export"))
+  {
+    this->dataPtr->exporting = true;
+    this->dataPtr->topic = exportElem->GetText() ? exportElem->GetText() : "";
+    if (this->title.empty())
+      this->title = "Plugin export";
+
+    if (auto pidElem = _pluginElem->FirstChildElement("parent_pid"))
+      pidElem->QueryInt64Text(&this->dataPtr->parentPid);
+
+    if (auto encodingElem = _pluginElem->FirstChildElement("encoding"))
+    {
+      std::string encoding = encodingElem->GetText() ?
+          encodingElem->GetText() : "";
+      if (encoding == "jpeg")
+        this->dataPtr->quality = 80;
+      else if (encoding != "shared")
+        ignwarn << "Unknown <encoding> [" << encoding << "]" << std::endl;
+    }
+
+    auto qualityElem = _pluginElem->FirstChildElement("quality");
+    if (qualityElem && this->dataPtr->quality >= 0)
+    {
+      int quality = this->dataPtr->quality;
+      qualityElem->QueryIntText(&quality);
+      this->dataPtr->quality = std::max(1, std::min(100, quality));
+    }
+
+    this->dataPtr->framePub = this->dataPtr->node.Advertise<msgs::Image>(
+        this->dataPtr->topic + "/frame");
+    if (!this->dataPtr->node.Subscribe(this->dataPtr->topic + "/input",
+        &PluginHostPrivate::OnInputMsg, this->dataPtr.get()))
+    {
+      ignerr << "Unable to subscribe to topic [" << this->dataPtr->topic
+             << "/input]" << std::endl;
+    }
+
+    this->dataPtr->frameTimer = new QTimer(this);
+    this->connect(this->dataPtr->frameTimer, &QTimer::timeout, this,
+        [this]()
+        {
+          this->dataPtr->Export();
+        });
+    this->dataPtr->frameTimer->start(
+        std::max(1, static_cast<int>(1000.0 / this->dataPtr->rate)));
+
+    this->dataPtr->parentTimer = new QTimer(this);
+    this->connect(this->dataPtr->parentTimer, &QTimer::timeout, this,
+        [this]()
+        {
+          this->dataPtr->CheckParent();
+        });
+    this->dataPtr->parentTimer->start(1000);
+    return;
+  }
+
+  // Host: show a window exported elsewhere, or run the plugin in a child
+  auto remoteElem = _pluginElem->FirstChildElement("remote");
+  auto hostedElem = _pluginElem->FirstChildElement("plugin");
+  if (remoteElem && remoteElem->GetText())
+  {
+    this->dataPtr->remote = true;
+    this->dataPtr->topic = remoteElem->GetText();
+    if (this->title.empty())
+      this->title = "Remote view";
+  }
+  else if (hostedElem && hostedElem->Attribute("filename"))
+  {
+    this->dataPtr->hostedDoc.InsertEndChild(
+        hostedElem->DeepClone(&this->dataPtr->hostedDoc));
+    if (this->title.empty())
+      this->title = hostedElem->Attribute("filename");
+
+    // Topics and config file are unique to this card of this process
+    auto pid = std::to_string(QCoreApplication::applicationPid());
+    auto name = this->CardItem()->objectName().toStdString();
+    this->dataPtr->topic = "/gui/plugin_host/" + pid + "/" + name;
+
+    std::string home;
+    common::env(IGN_HOMEDIR, home);
+    this->dataPtr->configPath = common::joinPaths(home, ".ignition", "gui",
+        "plugin_host", pid + "_" + name + ".config");
+  }
+  else
+  {
+    ignerr << "Missing <plugin filename=...> to host, or <remote> topic to "
+           << "show." << std::endl;
+    this->dataPtr->status = "No plugin to host";
+    return;
+  }
+
+  this->dataPtr->inputPub = this->dataPtr->node.Advertise<msgs::StringMsg>(
+      this->dataPtr->topic + "/input");
+
+  // The provider must be there before frames start arriving
+  this->dataPtr->provider = new FrameProvider();
+  App()->Engine()->addImageProvider(
+      this->CardItem()->objectName() + "pluginhost",
+      this->dataPtr->provider);
+  this->PluginItem()->setProperty("hosting", true);
+
+  // The remote window keeps its size, its frames are scaled to the card
+  if (this->dataPtr->remote)
+  {
+    this->dataPtr->running = true;
+    this->dataPtr->Subscribe();
+    return;
+  }
+
+  if (auto commandElem = _pluginElem->FirstChildElement("command"))
+  {
+    if (commandElem->GetText())
+      this->dataPtr->command = commandElem->GetText();
+  }
+
+  if (auto offscreenElem = _pluginElem->FirstChildElement("offscreen"))
+    offscreenElem->QueryBoolText(&this->dataPtr->offscreen);
+
+  if (this->PluginItem()->width() >= 1.0 &&
+      this->PluginItem()->height() >= 1.0)
+  {
+    this->dataPtr->width = static_cast<int>(this->PluginItem()->width());
+    this->dataPtr->height = static_cast<int>(this->PluginItem()->height());
+  }
+
+  this->dataPtr->process = new QProcess(this);
+  this->dataPtr->process->setProcessChannelMode(QProcess::ForwardedChannels);
+  this->connect(this->dataPtr->process,
+      QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this,
+      [this](int _exitCode, QProcess::ExitStatus _exitStatus)
+      {
+        this->OnChildFinished(_exitCode,
+            _exitStatus == QProcess::CrashExit);
+      });
+  this->connect(this->dataPtr->process, &QProcess::errorOccurred, this,
+      [this](QProcess::ProcessError _error)
+      {
+        // Otherwise it's told by finished
+        if (_error != QProcess::FailedToStart)
+          return;
+
+        ignerr << "Failed to start [" << this->dataPtr->command << "]"
+               << std::endl;
+        this->dataPtr->running = false;
+        this->dataPtr->status = QString("Failed to start [%1]").arg(
+            QString::fromStdString(this->dataPtr->command));
+        this->RunningChanged();
+      });
+
+  this->dataPtr->Subscribe();
+  this->dataPtr->Start();
+}
+
+/////////////////////////////////////////////////
+void PluginHost::OnChildFinished(int _exitCode, bool _crashed)
+{
+  ignwarn << "Child hosting [" << this->title << "] "
+          << (_crashed ? "crashed" : "exited with code ") << _exitCode
+          << std::endl;
+
+  this->dataPtr->running = false;
+  this->dataPtr->status = _crashed ? QString("Crashed") :
+      QString("Exited with code %1").arg(_exitCode);
+  this->RunningChanged();
+}
+
+/////////////////////////////////////////////////
+void PluginHost::OnRestart()
+{
+  if (this->dataPtr->running || !this->dataPtr->process)
+    return;
+
+  this->dataPtr->Start();
+}
+
+/////////////////////////////////////////////////
+void PluginHost::OnInput(const QString &_type, double _x, double _y,
+    int _button, int _buttons, int _modifiers, int _value,
+    const QString &_text)
+{
+  PluginHostProtocol::InputEvent event;
+  event.type = _type.toStdString();
+  event.x = _x;
+  event.y = _y;
+  event.button = _button;
+  event.buttons = _buttons;
+  event.modifiers = _modifiers;
+  event.value = _value;
+  event.text = _text.toStdString();
+
+  // Restarts use the latest size. A remote window may have several
+  // viewers, and keeps its own size.
+  if (event.type == "resize")
+  {
+    if (this->dataPtr->remote)
+      return;
+    if (_x >= 1.0 && _y >= 1.0)
+    {
+      this->dataPtr->width = static_cast<int>(_x);
+      this->dataPtr->height = static_cast<int>(_y);
+    }
+  }
+
+  this->dataPtr->Send(event);
+}
+
+/////////////////////////////////////////////////
+void PluginHost::Suspend()
+{
+  if (this->dataPtr->exporting)
+    return;
+
+  // The child keeps running, but stops sending frames
+  this->dataPtr->suspended = true;
+  SubscriptionHub::Instance()->Unsubscribe(this->dataPtr->subscription);
+  this->dataPtr->subscription = 0;
+
+  // Remote windows may have other viewers, and stop sending frames once
+  // nobody is subscribed
+  if (this->dataPtr->remote)
+    return;
+
+  PluginHostProtocol::InputEvent event;
+  event.type = "pause";
+  this->dataPtr->Send(event);
+}
+
+/////////////////////////////////////////////////
+void PluginHost::Resume()
+{
+  if (this->dataPtr->exporting || !this->dataPtr->suspended)
+    return;
+
+  this->dataPtr->suspended = false;
+  this->dataPtr->Subscribe();
+  if (this->dataPtr->remote)
+    return;
+
+  PluginHostProtocol::InputEvent event;
+  event.type = "resume";
+  this->dataPtr->Send(event);
+}
+
+/////////////////////////////////////////////////
+std::size_t PluginHost::MemoryUsage() const
+{
+  if (!this->dataPtr->provider)
+    return 0u;
+  return this->dataPtr->provider->Bytes();
+}
+
+/////////////////////////////////////////////////
+bool PluginHost::Running() const
+{
+  return this->dataPtr->running;
+}
+
+/////////////////////////////////////////////////
+QString PluginHost::Status() const
+{
+  return this->dataPtr->status;
+}
+
+// Register this plugin
+IGNITION_ADD_PLUGIN(ignition::gui::plugins::PluginHost,
+                    ignition::gui::Plugin)
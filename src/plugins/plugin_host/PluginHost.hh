@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGNITION_GUI_PLUGINS_PLUGINHOST_HH_
+#define IGNITION_GUI_PLUGINS_PLUGINHOST_HH_
+
+#include <memory>
+
+#include "ignition/gui/Plugin.hh"
+
+namespace ignition
+{
+namespace gui
+{
+namespace plugins
+{
+  class PluginHostPrivate;
+
+  /// \brief Run another plugin in a child process, and show its frames in
+  /// this card. A heavy or misbehaving plugin then has a GUI thread and a
+  /// render thread of its own, and can't freeze the main window.
+  ///
+  /// The child is an `ign gui` process whose window only holds the hosted
+  /// plugin. It renders offscreen, and its frames come back through shared
+  /// memory, see SharedImageWriter, with a small msg on an Ignition
+  /// transport topic announcing each of them. Mouse, wheel and key events
+  /// on the card, as well as its size, are forwarded to the child's window.
+  /// Frames are only sent when the child's window was redrawn.
+  ///
+  /// If the child exits, the card shows why and offers to start it again.
+  /// The child quits when the card is closed, or when this process goes
+  /// away without closing it.
+  ///
+  /// The same exchange shows a GUI running on another machine, such as
+  /// next to a simulator, over the network. That GUI exports its whole
+  /// window by loading a PluginHost with \<export\> and JPEG encoding,
+  /// and the remote viewer loads one with \<remote\> on the same topic.
+  /// Scene3D, ImageDisplay and any other plugin are then seen as a single
+  /// compressed stream instead of all the topics they subscribe to, and
+  /// input goes back to the exported window's mouse and key handlers.
+  /// Frames are only grabbed and compressed while a viewer is subscribed.
+  ///
+  /// ## Configuration
+  ///
+  /// \<plugin\> : Config of the hosted plugin, as it would be given to the
+  ///              main window. Required.
+  /// \<command\> : Command starting the child, to which "-c <config>" is
+  ///               added. Defaults to "ign gui".
+  /// \<rate\> : Most frames per second sent by the child, defaults to 30.
+  /// \<offscreen\> : Set to false for the child to open a window of its
+  ///                 own, for plugins which need a display to render.
+  ///                 Defaults to true.
+  ///
+  /// To view a remote window instead:
+  ///
+  /// \<remote\> : Base topic the window is exported on, replaces
+  ///              \<plugin\>. The remote window keeps its size.
+  ///
+  /// To export the window of this GUI:
+  ///
+  /// \<export\> : Base topic to export the window on. Frames are sent on
+  ///              "<topic>/frame" and input received on "<topic>/input".
+  /// \<encoding\> : "shared" to move raw frames through shared memory,
+  ///                which only works on the same host, or "jpeg" to
+  ///                compress them for the network. Defaults to "shared".
+  /// \<quality\> : JPEG quality from 1 to 100, defaults to 80.
+  /// \<rate\> : Most frames per second, defaults to 30.
+  ///
+  /// Children are started with an \<export\> element of their own.
+  class PluginHost : public Plugin
+  {
+    Q_OBJECT
+
+    /// \brief True while the child process runs
+    Q_PROPERTY(
+      bool running
+      READ Running
+      NOTIFY RunningChanged
+    )
+
+    /// \brief Why the child isn't running, empty while it is
+    Q_PROPERTY(
+      QString status
+      READ Status
+      NOTIFY RunningChanged
+    )
+
+    /// \brief Constructor
+    public: PluginHost();
+
+    /// \brief Destructor
+    public: virtual ~PluginHost();
+
+    // Documentation inherited
+    public: virtual void LoadConfig(const tinyxml2::XMLElement *_pluginElem);
+
+    /// \brief Start the child again after it exited.
+    public slots: void OnRestart();
+
+    /// \brief Forward an input event to the child.
+    /// \param[in] _type Event type, see PluginHostProtocol::InputEvent
+    /// \param[in] _x X in the child's window, or its width
+    /// \param[in] _y Y in the child's window, or its height
+    /// \param[in] _button Mouse button which changed
+    /// \param[in] _buttons Mouse buttons held
+    /// \param[in] _modifiers Keyboard modifiers held
+    /// \param[in] _value Key, or wheel angle delta
+    /// \param[in] _text Key text
+    public slots: void OnInput(const QString &_type, double _x, double _y,
+        int _button, int _buttons, int _modifiers, int _value,
+        const QString &_text);
+
+    // Documentation inherited
+    protected: void Suspend() override;
+
+    // Documentation inherited
+    protected: void Resume() override;
+
+    // Documentation inherited
+    public: std::size_t MemoryUsage() const override;
+
+    /// \brief Get whether the child process runs.
+    /// \return True while it runs
+    public: Q_INVOKABLE bool Running() const;
+
+    /// \brief Get why the child isn't running.
+    /// \return Status, empty while it runs
+    public: Q_INVOKABLE QString Status() const;
+
+    /// \brief Notify that the child started or exited
+    signals: void RunningChanged();
+
+    /// \brief Notify that there's a new frame
+    signals: void newFrame();
+
+    /// \brief Called by the GUI thread when the child exits.
+    /// \param[in] _exitCode Exit code
+    /// \param[in] _crashed True if the child crashed
+    private: void OnChildFinished(int _exitCode, bool _crashed);
+
+    /// \internal
+    /// \brief Pointer to private data.
+    private: std::unique_ptr<PluginHostPrivate> dataPtr;
+  };
+}
+}
+}
+
+#endif
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+import QtQuick 2.9
+import QtQuick.Controls 2.2
+import QtQuick.Controls.Material 2.1
+import QtQuick.Layouts 1.3
+
+Rectangle {
+  id: pluginHost
+  color: "transparent"
+  anchors.fill: parent
+  Layout.minimumWidth: 250
+  Layout.minimumHeight: 250
+
+  /**
+   * True for the card showing a child, false for the hidden exporter
+   */
+  property bool hosting: false
+
+  /**
+   * Unique name for this plugin instance
+   */
+  property string uniqueName: ""
+
+  property int tooltipDelay: 500
+  property int tooltipTimeout: 1000
+
+  onParentChanged: {
+    if (undefined === parent)
+      return;
+
+    uniqueName = parent.card().objectName + "pluginhost";
+  }
+
+  // Only the host has frames to show
+  onHostingChanged: frame.reload();
+
+  Connections {
+    target: PluginHost
+    onNewFrame: frame.reload();
+  }
+
+  /**
+   * Map from the card to the exported window, which may be catching up
+   * with the card's size, or keep a size of its own when it's remote
+   */
+  function windowX(x) {
+    if (frame.paintedWidth <= 0)
+      return x;
+    var offset = (frame.width - frame.paintedWidth) / 2;
+    return (x - offset) * frame.implicitWidth / frame.paintedWidth;
+  }
+
+  function windowY(y) {
+    if (frame.paintedHeight <= 0)
+      return y;
+    var offset = (frame.height - frame.paintedHeight) / 2;
+    return (y - offset) * frame.implicitHeight / frame.paintedHeight;
+  }
+
+  function sendMouse(type, mouse) {
+    PluginHost.OnInput(type, windowX(mouse.x), windowY(mouse.y),
+        mouse.button, mouse.buttons, mouse.modifiers, 0, "");
+  }
+
+  function sendKey(type, event) {
+    PluginHost.OnInput(type, 0, 0, 0, 0, event.modifiers, event.key,
+        event.text);
+    event.accepted = true;
+  }
+
+  Image {
+    id: frame
+    visible: hosting
+    anchors.fill: parent
+    fillMode: Image.PreserveAspectFit
+    cache: false
+    focus: true
+    function reload() {
+      // Force image request to C++
+      source = "image://" + uniqueName + "/" + Math.random().toString(36).substr(2, 5);
+    }
+
+    onWidthChanged: resizeTimer.restart()
+    onHeightChanged: resizeTimer.restart()
+
+    Keys.onPressed: sendKey("keypress", event)
+    Keys.onReleased: sendKey("keyrelease", event)
+
+    MouseArea {
+      anchors.fill: parent
+      enabled: hosting && PluginHost.running
+      hoverEnabled: true
+      acceptedButtons: Qt.AllButtons
+      onPressed: {
+        frame.forceActiveFocus();
+        sendMouse("press", mouse);
+      }
+      onReleased: sendMouse("release", mouse)
+      onDoubleClicked: sendMouse("double", mouse)
+      onPositionChanged: sendMouse("move", mouse)
+      onWheel: {
+        PluginHost.OnInput("wheel", windowX(wheel.x), windowY(wheel.y), 0,
+            wheel.buttons, wheel.modifiers, wheel.angleDelta.y, "");
+      }
+    }
+  }
+
+  /**
+   * Resize the child once the card settles
+   */
+  Timer {
+    id: resizeTimer
+    interval: 100
+    onTriggered: {
+      if (frame.width >= 1 && frame.height >= 1)
+      {
+        PluginHost.OnInput("resize", frame.width, frame.height, 0, 0, 0, 0,
+            "");
+      }
+    }
+  }
+
+  Rectangle {
+    visible: hosting && !PluginHost.running
+    anchors.fill: parent
+    color: Material.background
+    opacity: 0.9
+
+    ColumnLayout {
+      anchors.centerIn: parent
+      Label {
+        Layout.alignment: Qt.AlignHCenter
+        text: PluginHost.status
+      }
+      Button {
+        Layout.alignment: Qt.AlignHCenter
+        text: qsTr("Restart")
+        Material.background: Material.primary
+        onClicked: PluginHost.OnRestart()
+        ToolTip.visible: hovered
+        ToolTip.delay: tooltipDelay
+        ToolTip.timeout: tooltipTimeout
+        ToolTip.text: qsTr("Start the process hosting the plugin again")
+      }
+    }
+  }
+}
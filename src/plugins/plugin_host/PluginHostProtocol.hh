@@ -0,0 +1,212 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGNITION_GUI_PLUGINS_PLUGINHOST_PLUGINHOSTPROTOCOL_HH_
+#define IGNITION_GUI_PLUGINS_PLUGINHOST_PLUGINHOSTPROTOCOL_HH_
+
+#include <tinyxml2.h>
+
+#include <sstream>
+#include <string>
+
+namespace ignition
+{
+namespace gui
+{
+namespace plugins
+{
+  /// \brief What the host and the child process of a PluginHost tell each
+  /// other, and the config the child is started with.
+  ///
+  /// Input is sent to the child as one line of text per event:
+  /// "type x y button buttons modifiers value text", where text is the
+  /// rest of the line and may hold spaces.
+  namespace PluginHostProtocol
+  {
+    /// \brief An input event, or a request, for the child
+    struct InputEvent
+    {
+      /// \brief One of "press", "release", "double", "move", "wheel",
+      /// "keypress", "keyrelease", "resize", "pause" and "resume"
+      std::string type;
+
+      /// \brief X of the pointer in the child's window, or its new width
+      double x{0.0};
+
+      /// \brief Y of the pointer in the child's window, or its new height
+      double y{0.0};
+
+      /// \brief Qt::MouseButton which changed
+      int button{0};
+
+      /// \brief Qt::MouseButtons held
+      int buttons{0};
+
+      /// \brief Qt::KeyboardModifiers held
+      int modifiers{0};
+
+      /// \brief Qt::Key of key events, or the vertical angle delta of wheel
+      /// events
+      int value{0};
+
+      /// \brief Text of key events
+      std::string text;
+    };
+
+    /// \brief Turn an event into its line of text.
+    /// \param[in] _event Event
+    /// \return Text, without a line break
+    inline std::string Encode(const InputEvent &_event)
+    {
+      std::ostringstream out;
+      out << _event.type << " " << _event.x << " " << _event.y << " "
+          << _event.button << " " << _event.buttons << " "
+          << _event.modifiers << " " << _event.value << " " << _event.text;
+      return out.str();
+    }
+
+    /// \brief Read an event from its line of text.
+    /// \param[in] _text Text made by Encode
+    /// \param[out] _event Event
+    /// \return False if the text isn't an event
+    inline bool Decode(const std::string &_text, InputEvent &_event)
+    {
+      std::istringstream in(_text);
+      if (!(in >> _event.type >> _event.x >> _event.y >> _event.button
+          >> _event.buttons >> _event.modifiers >> _event.value))
+      {
+        return false;
+      }
+
+      // Skip the separator only, the text may start with a space
+      _event.text.clear();
+      if (in.get() == ' ')
+        std::getline(in, _event.text);
+      return true;
+    }
+
+    /// \brief Check if a frame is a JPEG file instead of raw pixels.
+    /// \param[in] _data Frame data
+    /// \return True if the data starts like a JPEG file
+    inline bool IsJpeg(const std::string &_data)
+    {
+      return _data.size() > 3u && _data[0] == '\xff' &&
+          _data[1] == '\xd8' && _data[2] == '\xff';
+    }
+
+    /// \brief Set a card property of a plugin config, replacing the one
+    /// which may be there.
+    /// \param[in,out] _pluginElem Plugin element
+    /// \param[in] _key Property key
+    /// \param[in] _type Property type
+    /// \param[in] _value Property value
+    inline void SetProperty(tinyxml2::XMLElement *_pluginElem,
+        const char *_key, const char *_type, const char *_value)
+    {
+      auto doc = _pluginElem->GetDocument();
+      auto guiElem = _pluginElem->FirstChildElement("ignition-gui");
+      if (!guiElem)
+      {
+        guiElem = doc->NewElement("ignition-gui");
+        _pluginElem->InsertEndChild(guiElem);
+      }
+
+      for (auto propElem = guiElem->FirstChildElement("property");
+          propElem != nullptr;)
+      {
+        auto next = propElem->NextSiblingElement("property");
+        auto key = propElem->Attribute("key");
+        if (key && std::string(key) == _key)
+          guiElem->DeleteChild(propElem);
+        propElem = next;
+      }
+
+      auto propElem = doc->NewElement("property");
+      propElem->SetAttribute("key", _key);
+      propElem->SetAttribute("type", _type);
+      propElem->SetText(_value);
+      guiElem->InsertEndChild(propElem);
+    }
+
+    /// \brief Make the config the child process is started with. Its
+    /// window only holds the hosted plugin, without title bar or menus, and
+    /// a hidden PluginHost which exports the window's frames.
+    /// \param[in] _hostedElem Config of the hosted plugin
+    /// \param[in] _topic Base topic of the frames and input
+    /// \param[in] _rate Most frames per second
+    /// \param[in] _parentPid Process the child quits with
+    /// \param[in] _width Initial width of the child's window
+    /// \param[in] _height Initial height of the child's window
+    /// \return Config file contents
+    inline std::string ChildConfig(const tinyxml2::XMLElement *_hostedElem,
+        const std::string &_topic, const double _rate,
+        const long long _parentPid, const int _width, const int _height)
+    {
+      tinyxml2::XMLDocument doc;
+      doc.InsertEndChild(doc.NewDeclaration());
+
+      auto windowElem = doc.NewElement("window");
+      doc.InsertEndChild(windowElem);
+      auto widthElem = doc.NewElement("width");
+      widthElem->SetText(_width);
+      windowElem->InsertEndChild(widthElem);
+      auto heightElem = doc.NewElement("height");
+      heightElem->SetText(_height);
+      windowElem->InsertEndChild(heightElem);
+
+      auto menusElem = doc.NewElement("menus");
+      windowElem->InsertEndChild(menusElem);
+      auto drawerElem = doc.NewElement("drawer");
+      drawerElem->SetAttribute("visible", false);
+      menusElem->InsertEndChild(drawerElem);
+      auto pluginsElem = doc.NewElement("plugins");
+      pluginsElem->SetAttribute("visible", false);
+      menusElem->InsertEndChild(pluginsElem);
+
+      // The hosted plugin takes the whole window
+      auto hostedElem = _hostedElem->DeepClone(&doc)->ToElement();
+      SetProperty(hostedElem, "showTitleBar", "bool", "false");
+      SetProperty(hostedElem, "state", "string", "docked");
+      doc.InsertEndChild(hostedElem);
+
+      // The exporter stays out of the way
+      auto exportElem = doc.NewElement("plugin");
+      exportElem->SetAttribute("filename", "PluginHost");
+      doc.InsertEndChild(exportElem);
+      SetProperty(exportElem, "visible", "bool", "false");
+      SetProperty(exportElem, "state", "string", "floating");
+
+      auto topicElem = doc.NewElement("export");
+      topicElem->SetText(_topic.c_str());
+      exportElem->InsertEndChild(topicElem);
+      auto rateElem = doc.NewElement("rate");
+      rateElem->SetText(_rate);
+      exportElem->InsertEndChild(rateElem);
+      auto pidElem = doc.NewElement("parent_pid");
+      pidElem->SetText(std::to_string(_parentPid).c_str());
+      exportElem->InsertEndChild(pidElem);
+
+      tinyxml2::XMLPrinter printer;
+      doc.Print(&printer);
+      return printer.CStr();
+    }
+  }
+}
+}
+}
+
+#endif
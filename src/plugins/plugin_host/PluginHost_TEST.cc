@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <tinyxml2.h>
+
+#include <string>
+
+#include "PluginHostProtocol.hh"
+
+using namespace ignition;
+using namespace gui;
+using namespace plugins;
+using namespace PluginHostProtocol;
+
+/////////////////////////////////////////////////
+/// \brief Find the card property of a plugin config.
+/// \param[in] _pluginElem Plugin element
+/// \param[in] _key Property key
+/// \return Property value, empty if there's none
+std::string Property(const tinyxml2::XMLElement *_pluginElem,
+    const std::string &_key)
+{
+  auto guiElem = _pluginElem->FirstChildElement("ignition-gui");
+  if (!guiElem)
+    return std::string();
+
+  std::string value;
+  for (auto propElem = guiElem->FirstChildElement("property");
+      propElem != nullptr; propElem = propElem->NextSiblingElement("property"))
+  {
+    if (propElem->Attribute("key", _key.c_str()))
+    {
+      EXPECT_TRUE(value.empty()) << "Property [" << _key << "] repeated";
+      value = propElem->GetText();
+    }
+  }
+  return value;
+}
+
+/////////////////////////////////////////////////
+TEST(PluginHostTest, Input)
+{
+  InputEvent event;
+  event.type = "press";
+  event.x = 10.5;
+  event.y = 20.0;
+  event.button = 1;
+  event.buttons = 3;
+  event.modifiers = 0x04000000;
+
+  InputEvent decoded;
+  ASSERT_TRUE(Decode(Encode(event), decoded));
+  EXPECT_EQ("press", decoded.type);
+  EXPECT_DOUBLE_EQ(10.5, decoded.x);
+  EXPECT_DOUBLE_EQ(20.0, decoded.y);
+  EXPECT_EQ(1, decoded.button);
+  EXPECT_EQ(3, decoded.buttons);
+  EXPECT_EQ(0x04000000, decoded.modifiers);
+  EXPECT_EQ(0, decoded.value);
+  EXPECT_TRUE(decoded.text.empty());
+
+  // Key text is kept as is, spaces included
+  event.type = "keypress";
+  event.value = 0x20;
+  event.text = " ";
+  ASSERT_TRUE(Decode(Encode(event), decoded));
+  EXPECT_EQ("keypress", decoded.type);
+  EXPECT_EQ(0x20, decoded.value);
+  EXPECT_EQ(" ", decoded.text);
+
+  event.text = "a b";
+  ASSERT_TRUE(Decode(Encode(event), decoded));
+  EXPECT_EQ("a b", decoded.text);
+
+  // Truncated
+  EXPECT_FALSE(Decode("", decoded));
+  EXPECT_FALSE(Decode("move 1 2", decoded));
+  EXPECT_FALSE(Decode("move a b 0 0 0 0", decoded));
+}
+
+/////////////////////////////////////////////////
+TEST(PluginHostTest, IsJpeg)
+{
+  EXPECT_TRUE(IsJpeg(std::string("\xff\xd8\xff\xe0\x00\x10JFIF", 10)));
+  EXPECT_FALSE(IsJpeg(std::string("\xff\xd8\xff", 3)));
+  EXPECT_FALSE(IsJpeg(std::string("\x89PNG\r\n\x1a\n")));
+  EXPECT_FALSE(IsJpeg(std::string(16, '\0')));
+  EXPECT_FALSE(IsJpeg(std::string()));
+}
+
+/////////////////////////////////////////////////
+TEST(PluginHostTest, ChildConfig)
+{
+  tinyxml2::XMLDocument hostDoc;
+  ASSERT_EQ(tinyxml2::XML_SUCCESS, hostDoc.Parse(
+      "<plugin filename=\"ImageDisplay\">"
+      "  <ignition-gui>"
+      "    <title>Camera</title>"
+      "    <property key=\"state\" type=\"string\">floating</property>"
+      "  </ignition-gui>"
+      "  <topic>/camera</topic>"
+      "</plugin>"));
+
+  auto config = ChildConfig(hostDoc.FirstChildElement("plugin"),
+      "/gui/plugin_host/1", 15.0, 1234, 640, 480);
+
+  tinyxml2::XMLDocument doc;
+  ASSERT_EQ(tinyxml2::XML_SUCCESS, doc.Parse(config.c_str())) << config;
+
+  auto windowElem = doc.FirstChildElement("window");
+  ASSERT_NE(nullptr, windowElem);
+  EXPECT_EQ(640, windowElem->FirstChildElement("width")->IntText());
+  EXPECT_EQ(480, windowElem->FirstChildElement("height")->IntText());
+  auto menusElem = windowElem->FirstChildElement("menus");
+  ASSERT_NE(nullptr, menusElem);
+  EXPECT_FALSE(menusElem->FirstChildElement("drawer")->BoolAttribute(
+      "visible", true));
+  EXPECT_FALSE(menusElem->FirstChildElement("plugins")->BoolAttribute(
+      "visible", true));
+
+  // Hosted plugin keeps its config and fills the window
+  auto hostedElem = doc.FirstChildElement("plugin");
+  ASSERT_NE(nullptr, hostedElem);
+  EXPECT_STREQ("ImageDisplay", hostedElem->Attribute("filename"));
+  EXPECT_STREQ("/camera", hostedElem->FirstChildElement("topic")->GetText());
+  EXPECT_STREQ("Camera", hostedElem->FirstChildElement("ignition-gui")
+      ->FirstChildElement("title")->GetText());
+  EXPECT_EQ("docked", Property(hostedElem, "state"));
+  EXPECT_EQ("false", Property(hostedElem, "showTitleBar"));
+
+  // Exporter is hidden
+  auto exportElem = hostedElem->NextSiblingElement("plugin");
+  ASSERT_NE(nullptr, exportElem);
+  EXPECT_STREQ("PluginHost", exportElem->Attribute("filename"));
+  EXPECT_EQ("false", Property(exportElem, "visible"));
+  EXPECT_STREQ("/gui/plugin_host/1",
+      exportElem->FirstChildElement("export")->GetText());
+  EXPECT_DOUBLE_EQ(15.0, exportElem->FirstChildElement("rate")->DoubleText());
+  EXPECT_EQ(1234, exportElem->FirstChildElement("parent_pid")->IntText());
+  EXPECT_EQ(nullptr, exportElem->NextSiblingElement("plugin"));
+}
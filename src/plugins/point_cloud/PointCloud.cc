@@ -0,0 +1,771 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "PointCloud.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
+#include <ignition/common/Util.hh>
+#include <ignition/math/Color.hh>
+#include <ignition/math/Vector3.hh>
+#include <ignition/plugin/Register.hh>
+
+// TODO(louise) Remove these pragmas once ign-rendering is disabling the
+// warnings
+#ifdef _WIN32
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+
+#include <ignition/rendering/Marker.hh>
+#include <ignition/rendering/Material.hh>
+#include <ignition/rendering/RenderEngine.hh>
+#include <ignition/rendering/RenderingIface.hh>
+#include <ignition/rendering/Scene.hh>
+#include <ignition/rendering/ShaderParams.hh>
+#include <ignition/rendering/Visual.hh>
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#include "ignition/gui/Executor.hh"
+#include "ignition/gui/RenderHooks.hh"
+#include "ignition/gui/SubscriptionHub.hh"
+#include "ignition/gui/TopicRegistry.hh"
+
+#include "PointCloudDecoding.hh"
+
+// Default most points drawn per cloud
+static const int kDefaultMaxPoints{2000000};
+
+// Default smallest voxel used to decimate clouds, in meters
+static const double kDefaultVoxelSize{0.05};
+
+// Time the render hook is expected to take, in milliseconds
+static const double kRenderBudget{8.0};
+
+/// \brief Vertex shader of points, mapping the red channel of the vertex
+/// color from blue through green to red, like PointCloudDecoding::ColorMap,
+/// or passing the color through
+static const char kPointVertexShader[] = R"(#version 130
+uniform mat4 worldviewproj_matrix;
+uniform float map;
+in vec4 vertex;
+in vec4 colour;
+out vec4 pointColor;
+void main()
+{
+  gl_Position = worldviewproj_matrix * vertex;
+  vec3 jet = clamp(vec3(1.5) - abs(4.0 * colour.r - vec3(3.0, 2.0, 1.0)),
+      0.0, 1.0);
+  pointColor = map > 0.5 ? vec4(jet, colour.a) : colour;
+}
+)";
+
+/// \brief Fragment shader of points
+static const char kPointFragmentShader[] = R"(#version 130
+in vec4 pointColor;
+out vec4 fragColor;
+void main()
+{
+  fragColor = pointColor;
+}
+)";
+
+namespace ignition
+{
+namespace gui
+{
+namespace plugins
+{
+  /// \brief A cloud unpacked on the worker, waiting to be drawn
+  struct PointFrame
+  {
+    /// \brief Points and their colors
+    PointCloudDecoding::Points points;
+
+    /// \brief True if the shader maps the red channel to a color
+    bool map{false};
+  };
+
+  /// \brief Where one of the clouds on screen is drawn
+  struct PointSlot
+  {
+    /// \brief Visual holding the marker
+    rendering::VisualPtr visual;
+
+    /// \brief Points, whose vertex buffer is kept between clouds
+    rendering::MarkerPtr marker;
+
+    /// \brief Shader material, null without shaders
+    rendering::MaterialPtr material;
+  };
+
+  /// \brief What's only touched on the render thread. It outlives the
+  /// plugin until its visuals are destroyed on that thread.
+  struct PointRenderState
+  {
+    /// \brief Scene drawn to, null until the first cloud
+    rendering::ScenePtr scene;
+
+    /// \brief One slot per cloud kept on screen
+    std::vector<PointSlot> slots;
+
+    /// \brief Slot the next cloud goes to
+    std::size_t next{0};
+
+    /// \brief True once the scene couldn't be found, so it's only said
+    /// once
+    bool failed{false};
+  };
+
+  class PointCloudPrivate
+  {
+    /// \brief Unpack the pending cloud until there's none, on a worker.
+    public: void Decode();
+
+    /// \brief Have a worker unpack the pending cloud, unless one is
+    /// already at it. Called with the mutex locked.
+    public: void Schedule();
+
+    /// \brief Draw the cloud unpacked last, if it wasn't yet. Called by
+    /// the render hook.
+    public: void Draw();
+
+    /// \brief Find the scene and make the slots.
+    /// \return False if there's no scene to draw to
+    public: bool InitRender();
+
+    /// \brief Plugin, which announces the point count
+    public: PointCloud *plugin{nullptr};
+
+    /// \brief List of topics publishing point clouds.
+    public: QStringList topicList;
+
+    /// \brief Protects the msg, frames and settings below
+    public: mutable std::mutex mutex;
+
+    /// \brief Latest cloud, kept to draw again when the color mode
+    /// changes, shared with other subscribers to the topic
+    public: std::shared_ptr<const msgs::PointCloudPacked> msg;
+
+    /// \brief True if msg wasn't unpacked yet
+    public: bool pending{false};
+
+    /// \brief True while a worker is unpacking
+    public: bool decoding{false};
+
+    /// \brief Set on destruction to stop the worker
+    public: bool stopping{false};
+
+    /// \brief Cloud unpacked and not drawn yet
+    public: std::unique_ptr<PointFrame> ready;
+
+    /// \brief Cloud drawn already, recycled so unpacking doesn't allocate
+    public: std::unique_ptr<PointFrame> spare;
+
+    /// \brief How points are colored
+    public: PointCloudDecoding::ColorMode colorMode{
+        PointCloudDecoding::ColorMode::HEIGHT};
+
+    /// \brief Color of flat points, as 0xRRGGBBAA
+    public: std::uint32_t flatColor{0xffffffffu};
+
+    /// \brief Most points per cloud, 0 for no limit
+    public: std::size_t maxPoints{kDefaultMaxPoints};
+
+    /// \brief Smallest voxel used to decimate
+    public: float voxelSize{static_cast<float>(kDefaultVoxelSize)};
+
+    /// \brief Voxel table of the worker, kept between clouds
+    public: std::vector<std::uint64_t> cells;
+
+    /// \brief Number of clouds kept on screen
+    public: unsigned int history{1};
+
+    /// \brief Render engine name
+    public: std::string engineName{"ogre"};
+
+    /// \brief Scene name
+    public: std::string sceneName{"scene"};
+
+    /// \brief Path to the point vertex shader, empty if shaders aren't
+    /// used
+    public: std::string vertexShaderPath;
+
+    /// \brief Path to the point fragment shader
+    public: std::string fragmentShaderPath;
+
+    /// \brief Render thread state, shared with the cleanup hook
+    public: std::shared_ptr<PointRenderState> render{
+        std::make_shared<PointRenderState>()};
+
+    /// \brief Render hook drawing clouds, 0 if none
+    public: std::size_t hook{0};
+
+    /// \brief Points drawn from the latest cloud
+    public: std::atomic<unsigned int> pointCount{0u};
+
+    /// \brief Point count last notified to QML
+    public: unsigned int pointCountShown{0u};
+
+    /// \brief Subscription to the cloud topic, 0 if none
+    public: std::size_t subscription{0};
+
+    /// \brief Topic chosen, subscribed to unless suspended
+    public: std::string topic;
+
+    /// \brief True while the card is hidden
+    public: bool suspended{false};
+  };
+}
+}
+}
+
+using namespace ignition;
+using namespace gui;
+using namespace plugins;
+
+/////////////////////////////////////////////////
+/// \brief Write a shader to the shader cache, unless it's there already.
+/// \param[in] _filename File name
+/// \param[in] _source Shader source
+/// \return Path to the shader, empty if it couldn't be written
+static std::string WriteShader(const std::string &_filename,
+    const std::string &_source)
+{
+  std::string home;
+  common::env(IGN_HOMEDIR, home);
+  auto dir = common::joinPaths(home, ".ignition", "gui", "shaders");
+  auto path = common::joinPaths(dir, _filename);
+
+  std::ifstream in(path);
+  std::stringstream current;
+  current << in.rdbuf();
+  if (in && current.str() == _source)
+    return path;
+
+  common::createDirectories(dir);
+  std::ofstream out(path, std::ios::out | std::ios::trunc);
+  if (!out || !(out << _source))
+  {
+    ignerr << "Unable to write shader [" << path << "]" << std::endl;
+    return std::string();
+  }
+  return path;
+}
+
+/////////////////////////////////////////////////
+/// \brief Parse a color mode.
+/// \param[in] _name "height", "intensity", "rgb" or "flat"
+/// \param[out] _mode Mode
+/// \return False if the name is unknown
+static bool parseColorMode(const std::string &_name,
+    PointCloudDecoding::ColorMode &_mode)
+{
+  if (_name == "height")
+    _mode = PointCloudDecoding::ColorMode::HEIGHT;
+  else if (_name == "intensity")
+    _mode = PointCloudDecoding::ColorMode::INTENSITY;
+  else if (_name == "rgb")
+    _mode = PointCloudDecoding::ColorMode::RGB;
+  else if (_name == "flat")
+    _mode = PointCloudDecoding::ColorMode::FLAT;
+  else
+    return false;
+  return true;
+}
+
+/////////////////////////////////////////////////
+void PointCloudPrivate::Schedule()
+{
+  if (this->stopping || this->decoding || !this->pending)
+    return;
+
+  this->decoding = true;
+  Executor::Instance().Post(this, [this]()
+  {
+    this->Decode();
+  });
+}
+
+/////////////////////////////////////////////////
+void PointCloudPrivate::Decode()
+{
+  while (true)
+  {
+    std::shared_ptr<const msgs::PointCloudPacked> next;
+    std::unique_ptr<PointFrame> frame;
+    PointCloudDecoding::ColorMode mode;
+    std::uint32_t flat;
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      if (this->stopping || !this->pending)
+      {
+        this->decoding = false;
+        return;
+      }
+      next = this->msg;
+      this->pending = false;
+      frame = std::move(this->spare);
+      mode = this->colorMode;
+      flat = this->flatColor;
+    }
+
+    if (!frame)
+      frame.reset(new PointFrame);
+
+    // Only read, the msg is shared
+    PointCloudDecoding::Layout layout;
+    if (!PointCloudDecoding::MakeLayout(*next, layout))
+    {
+      ignerr << "Point cloud doesn't have x, y and z fields" << std::endl;
+      continue;
+    }
+
+    float min, max;
+    bool shader = !this->vertexShaderPath.empty();
+    frame->map = false;
+    if (PointCloudDecoding::Unpack(next->data(), layout, mode, flat,
+        frame->points, min, max))
+    {
+      PointCloudDecoding::Normalize(frame->points, min, max, !shader);
+      frame->map = shader;
+    }
+    next.reset();
+
+    PointCloudDecoding::Decimate(frame->points, this->maxPoints,
+        this->voxelSize, this->cells);
+
+    // A cloud the render thread didn't get to yet is replaced
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (this->ready)
+      this->spare = std::move(this->ready);
+    this->ready = std::move(frame);
+  }
+}
+
+/////////////////////////////////////////////////
+bool PointCloudPrivate::InitRender()
+{
+  auto &state = *this->render;
+  if (state.failed)
+    return false;
+
+  auto engine = rendering::engine(this->engineName);
+  if (engine)
+    state.scene = engine->SceneByName(this->sceneName);
+  if (!state.scene)
+  {
+    ignwarn << "Scene \"" << this->sceneName << "\" of engine \""
+            << this->engineName << "\" not found, point clouds won't be "
+            << "shown." << std::endl;
+    state.failed = true;
+    return false;
+  }
+
+  for (unsigned int i = 0; i < this->history; ++i)
+  {
+    PointSlot slot;
+    slot.visual = state.scene->CreateVisual();
+    state.scene->RootVisual()->AddChild(slot.visual);
+
+    slot.marker = state.scene->CreateMarker();
+    slot.marker->SetType(rendering::MarkerType::MT_POINTS);
+    slot.visual->AddGeometry(slot.marker);
+
+    // Without shaders the marker's own material shows vertex colors
+    if (!this->vertexShaderPath.empty())
+    {
+      slot.material = state.scene->CreateMaterial();
+      slot.material->SetVertexShader(this->vertexShaderPath);
+      slot.material->SetFragmentShader(this->fragmentShaderPath);
+      slot.marker->SetMaterial(slot.material, false);
+    }
+    state.slots.push_back(slot);
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////
+void PointCloudPrivate::Draw()
+{
+  std::unique_ptr<PointFrame> frame;
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    frame = std::move(this->ready);
+  }
+  if (!frame)
+    return;
+
+  auto &state = *this->render;
+  if (!state.scene && !this->InitRender())
+    return;
+
+  // The newest cloud replaces the oldest one
+  auto &slot = state.slots[state.next];
+  state.next = (state.next + 1) % state.slots.size();
+
+  if (slot.material)
+  {
+    auto params = slot.material->VertexShaderParams();
+    (*params)["map"] = frame->map ? 1.0f : 0.0f;
+  }
+
+  // Clearing keeps the capacity of the vertex buffer, so clouds of similar
+  // sizes are uploaded into the same buffer
+  const auto &points = frame->points;
+  slot.marker->ClearPoints();
+  math::Color color;
+  for (std::size_t i = 0; i < points.Size(); ++i)
+  {
+    const float *p = &points.positions[i * 3];
+    color.SetFromRGBA(points.colors[i]);
+    slot.marker->AddPoint(math::Vector3d(p[0], p[1], p[2]), color);
+  }
+
+  this->pointCount = static_cast<unsigned int>(points.Size());
+  auto plugin = this->plugin;
+  Executor::Instance().PostToGui(plugin, [this, plugin]()
+  {
+    auto count = this->pointCount.load();
+    if (count == this->pointCountShown)
+      return;
+    this->pointCountShown = count;
+    plugin->PointCountChanged();
+  }, "pointCount");
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+  if (!this->spare)
+    this->spare = std::move(frame);
+}
+
+/////////////////////////////////////////////////
+PointCloud::PointCloud()
+  : Plugin(), dataPtr(new PointCloudPrivate)
+{
+  this->dataPtr->plugin = this;
+}
+
+/////////////////////////////////////////////////
+PointCloud::~PointCloud()
+{
+  // Stop receiving and let the worker finish
+  SubscriptionHub::Instance()->Unsubscribe(this->dataPtr->subscription);
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->stopping = true;
+  }
+  Executor::Instance().Cancel(this->dataPtr.get());
+
+  auto &hooks = RenderHooks::Instance();
+  hooks.Unregister(this->dataPtr->hook);
+
+  // Visuals can only be destroyed on the render thread, by a hook which then
+  // unregisters itself
+  auto state = this->dataPtr->render;
+  if (!state->scene)
+    return;
+
+  auto id = std::make_shared<std::atomic<std::size_t>>(0u);
+  *id = hooks.Register("PointCloud cleanup", [state, id]()
+  {
+    if (state->scene)
+    {
+      for (auto &slot : state->slots)
+      {
+        state->scene->DestroyVisual(slot.visual);
+        if (slot.material)
+          state->scene->DestroyMaterial(slot.material);
+      }
+      state->slots.clear();
+      state->scene.reset();
+    }
+
+    // Called once more if this ran before the ID was set
+    if (auto self = id->exchange(0u))
+      RenderHooks::Instance().Unregister(self);
+  });
+}
+
+/////////////////////////////////////////////////
+void PointCloud::LoadConfig(const tinyxml2::XMLElement *_pluginElem)
+{
+  // Default name in case user didn't define one
+  if (this->title.empty())
+    this->title = "Point cloud";
+
+  std::string topic;
+
+  // Read configuration
+  if (_pluginElem)
+  {
+    if (auto topicElem = _pluginElem->FirstChildElement("topic"))
+    {
+      if (topicElem->GetText())
+        topic = topicElem->GetText();
+    }
+
+    auto elem = _pluginElem->FirstChildElement("engine");
+    if (nullptr != elem && nullptr != elem->GetText())
+      this->dataPtr->engineName = elem->GetText();
+
+    elem = _pluginElem->FirstChildElement("scene");
+    if (nullptr != elem && nullptr != elem->GetText())
+      this->dataPtr->sceneName = elem->GetText();
+
+    elem = _pluginElem->FirstChildElement("color_mode");
+    if (nullptr != elem && nullptr != elem->GetText() &&
+        !parseColorMode(elem->GetText(), this->dataPtr->colorMode))
+    {
+      ignwarn << "Unknown color mode [" << elem->GetText()
+              << "], coloring by height." << std::endl;
+    }
+
+    elem = _pluginElem->FirstChildElement("color");
+    if (nullptr != elem && nullptr != elem->GetText())
+    {
+      math::Color color;
+      std::stringstream colorStr;
+      colorStr << std::string(elem->GetText());
+      colorStr >> color;
+      this->dataPtr->flatColor = color.AsRGBA();
+    }
+
+    if (auto maxElem = _pluginElem->FirstChildElement("max_points"))
+    {
+      int maxPoints = kDefaultMaxPoints;
+      maxElem->QueryIntText(&maxPoints);
+      this->dataPtr->maxPoints = static_cast<std::size_t>(
+          std::max(maxPoints, 0));
+    }
+
+    if (auto voxelElem = _pluginElem->FirstChildElement("voxel_size"))
+    {
+      double voxel = kDefaultVoxelSize;
+      voxelElem->QueryDoubleText(&voxel);
+      if (voxel > 0.0)
+        this->dataPtr->voxelSize = static_cast<float>(voxel);
+      else
+        ignwarn << "Voxel size must be positive, using default." << std::endl;
+    }
+
+    if (auto historyElem = _pluginElem->FirstChildElement("history"))
+    {
+      int history = 1;
+      historyElem->QueryIntText(&history);
+      this->dataPtr->history = static_cast<unsigned int>(
+          std::max(history, 1));
+    }
+  }
+
+  // Custom shaders are only supported by ogre 1, colors are mapped on the
+  // worker otherwise
+  if (this->dataPtr->engineName == "ogre")
+  {
+    auto vertex = WriteShader("point_cloud.vert", kPointVertexShader);
+    auto fragment = WriteShader("point_cloud.frag", kPointFragmentShader);
+    if (!vertex.empty() && !fragment.empty())
+    {
+      this->dataPtr->vertexShaderPath = vertex;
+      this->dataPtr->fragmentShaderPath = fragment;
+    }
+  }
+
+  // Clouds are handed to the scene after each frame it renders
+  this->dataPtr->hook = RenderHooks::Instance().Register("PointCloud",
+      [this]()
+      {
+        this->dataPtr->Draw();
+      }, 0, kRenderBudget);
+
+  if (!topic.empty())
+    this->OnTopic(QString::fromStdString(topic));
+  else
+    this->OnRefresh();
+}
+
+/////////////////////////////////////////////////
+void PointCloud::OnCloud(
+    const std::shared_ptr<const msgs::PointCloudPacked> &_msg)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->msg = _msg;
+  this->dataPtr->pending = true;
+
+  // A worker which is already going picks up the new msg
+  this->dataPtr->Schedule();
+}
+
+/////////////////////////////////////////////////
+void PointCloud::OnTopic(const QString _topic)
+{
+  auto topic = _topic.toStdString();
+  if (topic.empty())
+    return;
+
+  // Unsubscribe
+  auto hub = SubscriptionHub::Instance();
+  hub->Unsubscribe(this->dataPtr->subscription);
+  this->dataPtr->subscription = 0;
+  this->dataPtr->topic = topic;
+
+  // Subscribed to once the card is shown
+  if (this->dataPtr->suspended)
+    return;
+
+  // Subscribe to new topic, sharing msgs with other plugins showing it
+  this->dataPtr->subscription = hub->Subscribe<msgs::PointCloudPacked>(topic,
+      [this](const std::shared_ptr<const msgs::PointCloudPacked> &_msg)
+      {
+        this->OnCloud(_msg);
+      });
+  if (!this->dataPtr->subscription)
+  {
+    ignerr << "Unable to subscribe to topic [" << topic << "]" << std::endl;
+  }
+}
+
+/////////////////////////////////////////////////
+void PointCloud::Suspend()
+{
+  this->dataPtr->suspended = true;
+  SubscriptionHub::Instance()->Unsubscribe(this->dataPtr->subscription);
+  this->dataPtr->subscription = 0;
+}
+
+/////////////////////////////////////////////////
+void PointCloud::Resume()
+{
+  this->dataPtr->suspended = false;
+  if (!this->dataPtr->topic.empty())
+    this->OnTopic(QString::fromStdString(this->dataPtr->topic));
+}
+
+/////////////////////////////////////////////////
+std::size_t PointCloud::MemoryUsage() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  std::size_t bytes = this->dataPtr->cells.capacity() * sizeof(std::uint64_t);
+  if (this->dataPtr->msg)
+    bytes += this->dataPtr->msg->data().size();
+  for (const auto &frame : {this->dataPtr->ready.get(),
+      this->dataPtr->spare.get()})
+  {
+    if (!frame)
+      continue;
+    bytes += frame->points.positions.capacity() * sizeof(float) +
+        frame->points.colors.capacity() * sizeof(std::uint32_t);
+  }
+  return bytes;
+}
+
+/////////////////////////////////////////////////
+void PointCloud::OnRefresh()
+{
+  // Clear
+  this->dataPtr->topicList.clear();
+
+  // Get updated list from the shared cache, and have it checked again so
+  // topics which just showed up are there next time
+  auto registry = TopicRegistry::Instance();
+  for (const auto &topic : registry->Topics("ignition.msgs.PointCloudPacked"))
+    this->dataPtr->topicList.push_back(QString::fromStdString(topic));
+  registry->Refresh();
+
+  // Select first one
+  if (this->dataPtr->topicList.count() > 0)
+    this->OnTopic(this->dataPtr->topicList.at(0));
+  this->TopicListChanged();
+}
+
+/////////////////////////////////////////////////
+QStringList PointCloud::TopicList() const
+{
+  return this->dataPtr->topicList;
+}
+
+/////////////////////////////////////////////////
+void PointCloud::SetTopicList(const QStringList &_topicList)
+{
+  this->dataPtr->topicList = _topicList;
+  this->TopicListChanged();
+}
+
+/////////////////////////////////////////////////
+QString PointCloud::ColorMode() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  switch (this->dataPtr->colorMode)
+  {
+    case PointCloudDecoding::ColorMode::INTENSITY:
+      return "intensity";
+    case PointCloudDecoding::ColorMode::RGB:
+      return "rgb";
+    case PointCloudDecoding::ColorMode::FLAT:
+      return "flat";
+    default:
+      return "height";
+  }
+}
+
+/////////////////////////////////////////////////
+void PointCloud::SetColorMode(const QString &_mode)
+{
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    auto mode = this->dataPtr->colorMode;
+    if (!parseColorMode(_mode.toStdString(), mode))
+    {
+      ignwarn << "Unknown color mode [" << _mode.toStdString() << "]"
+              << std::endl;
+      return;
+    }
+    if (mode == this->dataPtr->colorMode)
+      return;
+    this->dataPtr->colorMode = mode;
+
+    // Draw the latest cloud again
+    if (this->dataPtr->msg)
+    {
+      this->dataPtr->pending = true;
+      this->dataPtr->Schedule();
+    }
+  }
+  this->ColorModeChanged();
+}
+
+/////////////////////////////////////////////////
+unsigned int PointCloud::PointCount() const
+{
+  return this->dataPtr->pointCountShown;
+}
+
+// Register this plugin
+IGNITION_ADD_PLUGIN(ignition::gui::plugins::PointCloud,
+                    ignition::gui::Plugin)
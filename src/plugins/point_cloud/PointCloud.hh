@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGNITION_GUI_PLUGINS_POINTCLOUD_HH_
+#define IGNITION_GUI_PLUGINS_POINTCLOUD_HH_
+
+#include <memory>
+#ifdef _MSC_VER
+#pragma warning(push, 0)
+#endif
+#include <ignition/msgs/pointcloud_packed.pb.h>
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#include "ignition/gui/Plugin.hh"
+
+namespace ignition
+{
+namespace gui
+{
+namespace plugins
+{
+  class PointCloudPrivate;
+
+  /// \brief Display point clouds coming through an Ignition transport topic
+  /// in the 3D scene.
+  ///
+  /// ## Configuration
+  ///
+  /// \<topic\> : Topic to receive ignition::msgs::PointCloudPacked msgs on.
+  /// \<engine\> : Render engine of the scene, defaults to "ogre".
+  /// \<scene\> : Name of the scene, defaults to "scene".
+  /// \<color_mode\> : How points are colored, "height", "intensity", "rgb"
+  ///                  or "flat". Defaults to "height".
+  /// \<color\> : Color of points when flat, defaults to white.
+  /// \<max_points\> : Most points drawn per cloud, defaults to 2000000.
+  ///                  Larger clouds are decimated, 0 for no limit.
+  /// \<voxel_size\> : Smallest voxel used to decimate clouds, in meters,
+  ///                  defaults to 0.05. The voxel doubles until the cloud
+  ///                  fits.
+  /// \<history\> : Number of clouds kept on screen, the newest replacing
+  ///               the oldest. Defaults to 1.
+  ///
+  /// Clouds are unpacked and decimated on a worker. Clouds which arrive
+  /// while one is being unpacked replace each other, so only the newest one
+  /// is drawn. The points are handed to the scene on the render thread,
+  /// through a render hook, into markers whose vertex buffers are kept from
+  /// cloud to cloud. With ogre, height and intensity are turned into colors
+  /// by a shader.
+  class PointCloud : public Plugin
+  {
+    Q_OBJECT
+
+    /// \brief Topic list
+    Q_PROPERTY(
+      QStringList topicList
+      READ TopicList
+      WRITE SetTopicList
+      NOTIFY TopicListChanged
+    )
+
+    /// \brief Color mode, "height", "intensity", "rgb" or "flat"
+    Q_PROPERTY(
+      QString colorMode
+      READ ColorMode
+      WRITE SetColorMode
+      NOTIFY ColorModeChanged
+    )
+
+    /// \brief Number of points drawn from the latest cloud
+    Q_PROPERTY(
+      unsigned int pointCount
+      READ PointCount
+      NOTIFY PointCountChanged
+    )
+
+    /// \brief Constructor
+    public: PointCloud();
+
+    /// \brief Destructor
+    public: virtual ~PointCloud();
+
+    // Documentation inherited
+    public: virtual void LoadConfig(const tinyxml2::XMLElement *_pluginElem);
+
+    /// \brief Callback when refresh button is pressed.
+    public slots: void OnRefresh();
+
+    /// \brief Callback when a new topic is chosen on the combo box.
+    /// \param[in] _topic Topic
+    public slots: void OnTopic(const QString _topic);
+
+    // Documentation inherited
+    protected: void Suspend() override;
+
+    // Documentation inherited
+    protected: void Resume() override;
+
+    // Documentation inherited
+    public: std::size_t MemoryUsage() const override;
+
+    /// \brief Get the topic list
+    /// \return List of topics publishing point clouds
+    public: Q_INVOKABLE QStringList TopicList() const;
+
+    /// \brief Set the topic list
+    /// \param[in] _topicList List of topics
+    public: Q_INVOKABLE void SetTopicList(const QStringList &_topicList);
+
+    /// \brief Notify that topic list has changed
+    signals: void TopicListChanged();
+
+    /// \brief Get the color mode
+    /// \return "height", "intensity", "rgb" or "flat"
+    public: Q_INVOKABLE QString ColorMode() const;
+
+    /// \brief Set the color mode. The latest cloud is drawn again with it.
+    /// \param[in] _mode "height", "intensity", "rgb" or "flat"
+    public: Q_INVOKABLE void SetColorMode(const QString &_mode);
+
+    /// \brief Notify that the color mode has changed
+    signals: void ColorModeChanged();
+
+    /// \brief Get the number of points drawn from the latest cloud
+    /// \return Point count
+    public: Q_INVOKABLE unsigned int PointCount() const;
+
+    /// \brief Notify that the point count has changed
+    signals: void PointCountChanged();
+
+    /// \brief Subscriber callback when a new cloud is received
+    /// \param[in] _msg New cloud, shared with other subscribers
+    private: void OnCloud(
+        const std::shared_ptr<const ignition::msgs::PointCloudPacked> &_msg);
+
+    /// \internal
+    /// \brief Pointer to private data.
+    private: std::unique_ptr<PointCloudPrivate> dataPtr;
+  };
+}
+}
+}
+
+#endif
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+import QtQuick 2.9
+import QtQuick.Controls 2.2
+import QtQuick.Controls.Material 2.1
+import QtQuick.Layouts 1.3
+
+Rectangle {
+  id: "pointCloud"
+  color: "transparent"
+  anchors.fill: parent
+  Layout.minimumWidth: 250
+  Layout.minimumHeight: 150
+
+  property int tooltipDelay: 500
+  property int tooltipTimeout: 1000
+
+  ColumnLayout {
+    anchors.fill: parent
+    anchors.margins: 10
+
+    RowLayout {
+      RoundButton {
+        text: "\u21bb"
+        Material.background: Material.primary
+        onClicked: {
+          PointCloud.OnRefresh();
+        }
+        ToolTip.visible: hovered
+        ToolTip.delay: tooltipDelay
+        ToolTip.timeout: tooltipTimeout
+        ToolTip.text: qsTr("Refresh list of topics publishing point clouds")
+      }
+      ComboBox {
+        id: combo
+        Layout.fillWidth: true
+        model: PointCloud.topicList
+        onCurrentIndexChanged: {
+          if (currentIndex < 0)
+            return;
+
+          PointCloud.OnTopic(textAt(currentIndex));
+        }
+        ToolTip.visible: hovered
+        ToolTip.delay: tooltipDelay
+        ToolTip.timeout: tooltipTimeout
+        ToolTip.text: qsTr("Ignition transport topics publishing PointCloudPacked messages")
+      }
+    }
+    RowLayout {
+      Label {
+        text: "Color by"
+      }
+      ComboBox {
+        id: colorMode
+        Layout.fillWidth: true
+        model: ["height", "intensity", "rgb", "flat"]
+        currentIndex: Math.max(0, find(PointCloud.colorMode))
+        onActivated: {
+          PointCloud.colorMode = textAt(index);
+        }
+        ToolTip.visible: hovered
+        ToolTip.delay: tooltipDelay
+        ToolTip.timeout: tooltipTimeout
+        ToolTip.text: qsTr("How points are colored")
+      }
+    }
+    Label {
+      text: "Points: " + PointCloud.pointCount
+      ToolTip.visible: countArea.containsMouse
+      ToolTip.delay: tooltipDelay
+      ToolTip.timeout: tooltipTimeout
+      ToolTip.text: qsTr("Points drawn from the latest cloud, after decimation")
+      MouseArea {
+        id: countArea
+        anchors.fill: parent
+        hoverEnabled: true
+      }
+    }
+    Item {
+      Layout.fillHeight: true
+    }
+  }
+}
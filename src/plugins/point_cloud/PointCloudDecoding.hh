@@ -0,0 +1,470 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GUI_PLUGINS_POINTCLOUD_POINTCLOUDDECODING_HH_
+#define IGNITION_GUI_PLUGINS_POINTCLOUD_POINTCLOUDDECODING_HH_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#ifdef _MSC_VER
+#pragma warning(push, 0)
+#endif
+#include <ignition/msgs/pointcloud_packed.pb.h>
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+namespace ignition
+{
+namespace gui
+{
+namespace plugins
+{
+  /// \brief Unpacking of point cloud msgs into plain arrays which are
+  /// quick to hand to the renderer, and voxel grid decimation of large
+  /// clouds.
+  namespace PointCloudDecoding
+  {
+    /// \brief How points are colored
+    enum class ColorMode
+    {
+      /// \brief One color for all points
+      FLAT,
+
+      /// \brief Colormap of the height of each point
+      HEIGHT,
+
+      /// \brief Colormap of the intensity field
+      INTENSITY,
+
+      /// \brief The packed rgb or rgba field
+      RGB
+    };
+
+    /// \brief Where a field is in each point
+    struct Channel
+    {
+      /// \brief Byte offset in the point, -1 if the cloud doesn't have it
+      int offset{-1};
+
+      /// \brief One of msgs::PointCloudPacked::Field::DataType
+      int datatype{0};
+
+      /// \brief Check whether the cloud has the field.
+      /// \return True if it does
+      bool Valid() const
+      {
+        return this->offset >= 0;
+      }
+    };
+
+    /// \brief Layout of the points of a cloud
+    struct Layout
+    {
+      /// \brief X coordinate
+      Channel x;
+
+      /// \brief Y coordinate
+      Channel y;
+
+      /// \brief Z coordinate
+      Channel z;
+
+      /// \brief Intensity, if any
+      Channel intensity;
+
+      /// \brief Packed color, if any
+      Channel rgb;
+
+      /// \brief Bytes per point
+      std::size_t pointStep{0};
+
+      /// \brief Number of points in the data
+      std::size_t count{0};
+
+      /// \brief True if multi-byte values must be swapped
+      bool swap{false};
+    };
+
+    /// \brief Points ready to be drawn
+    struct Points
+    {
+      /// \brief X, Y and Z of each point
+      std::vector<float> positions;
+
+      /// \brief Color of each point, as 0xRRGGBBAA. When colors are
+      /// computed by a shader, the red channel holds the value to map.
+      std::vector<std::uint32_t> colors;
+
+      /// \brief Get the number of points.
+      /// \return Number of points
+      std::size_t Size() const
+      {
+        return this->colors.size();
+      }
+
+      /// \brief Remove all points, keeping the memory.
+      void Clear()
+      {
+        this->positions.clear();
+        this->colors.clear();
+      }
+    };
+
+    /// \brief Get the size of a field.
+    /// \param[in] _datatype One of msgs::PointCloudPacked::Field::DataType
+    /// \return Bytes, 0 if unknown
+    inline std::size_t DataSize(const int _datatype)
+    {
+      switch (_datatype)
+      {
+        case msgs::PointCloudPacked::Field::INT8:
+        case msgs::PointCloudPacked::Field::UINT8:
+          return 1;
+        case msgs::PointCloudPacked::Field::INT16:
+        case msgs::PointCloudPacked::Field::UINT16:
+          return 2;
+        case msgs::PointCloudPacked::Field::INT32:
+        case msgs::PointCloudPacked::Field::UINT32:
+        case msgs::PointCloudPacked::Field::FLOAT32:
+          return 4;
+        case msgs::PointCloudPacked::Field::FLOAT64:
+          return 8;
+        default:
+          return 0;
+      }
+    }
+
+    /// \brief Get the layout of the points of a msg.
+    /// \param[in] _msg Point cloud
+    /// \param[out] _layout Layout
+    /// \return False if the msg has no x, y and z fields fitting in its
+    /// points
+    inline bool MakeLayout(const msgs::PointCloudPacked &_msg,
+        Layout &_layout)
+    {
+      _layout = Layout();
+      _layout.pointStep = _msg.point_step();
+      if (_layout.pointStep == 0)
+        return false;
+
+      for (const auto &field : _msg.field())
+      {
+        Channel channel;
+        channel.offset = static_cast<int>(field.offset());
+        channel.datatype = field.datatype();
+        auto size = DataSize(channel.datatype);
+        if (size == 0 || field.offset() + size > _layout.pointStep)
+          continue;
+
+        const auto &name = field.name();
+        if (name == "x")
+          _layout.x = channel;
+        else if (name == "y")
+          _layout.y = channel;
+        else if (name == "z")
+          _layout.z = channel;
+        else if (name == "intensity" || name == "i")
+          _layout.intensity = channel;
+        else if ((name == "rgb" || name == "rgba") && size == 4)
+          _layout.rgb = channel;
+      }
+
+      const std::uint16_t one{1};
+      bool hostBig = *reinterpret_cast<const std::uint8_t *>(&one) == 0;
+      _layout.swap = _msg.is_bigendian() != hostBig;
+
+      _layout.count = _msg.data().size() / _layout.pointStep;
+      return _layout.x.Valid() && _layout.y.Valid() && _layout.z.Valid();
+    }
+
+    /// \brief Copy a value, swapping its bytes if needed.
+    /// \param[in] _data Start of the value, may not be aligned
+    /// \param[in] _swap True to swap bytes
+    /// \return The value
+    template <typename T>
+    inline T Load(const char *_data, const bool _swap)
+    {
+      char bytes[sizeof(T)];
+      std::memcpy(bytes, _data, sizeof(T));
+      if (_swap)
+        std::reverse(bytes, bytes + sizeof(T));
+      T value;
+      std::memcpy(&value, bytes, sizeof(T));
+      return value;
+    }
+
+    /// \brief Read a field of a point as a float.
+    /// \param[in] _point Start of the point
+    /// \param[in] _channel Field
+    /// \param[in] _swap True to swap bytes
+    /// \return Value
+    inline float Read(const char *_point, const Channel &_channel,
+        const bool _swap)
+    {
+      const char *data = _point + _channel.offset;
+      switch (_channel.datatype)
+      {
+        case msgs::PointCloudPacked::Field::INT8:
+          return Load<std::int8_t>(data, false);
+        case msgs::PointCloudPacked::Field::UINT8:
+          return Load<std::uint8_t>(data, false);
+        case msgs::PointCloudPacked::Field::INT16:
+          return Load<std::int16_t>(data, _swap);
+        case msgs::PointCloudPacked::Field::UINT16:
+          return Load<std::uint16_t>(data, _swap);
+        case msgs::PointCloudPacked::Field::INT32:
+          return static_cast<float>(Load<std::int32_t>(data, _swap));
+        case msgs::PointCloudPacked::Field::UINT32:
+          return static_cast<float>(Load<std::uint32_t>(data, _swap));
+        case msgs::PointCloudPacked::Field::FLOAT32:
+          return Load<float>(data, _swap);
+        case msgs::PointCloudPacked::Field::FLOAT64:
+          return static_cast<float>(Load<double>(data, _swap));
+        default:
+          return 0.0f;
+      }
+    }
+
+    /// \brief Colormap from blue through green to red.
+    /// \param[in] _value Value between 0 and 1, clamped
+    /// \return Color as 0xRRGGBBAA
+    inline std::uint32_t ColorMap(const float _value)
+    {
+      float v = std::min(std::max(_value, 0.0f), 1.0f);
+      auto channel = [](const float _c)
+      {
+        float c = std::min(std::max(_c, 0.0f), 1.0f);
+        return static_cast<std::uint32_t>(c * 255.0f + 0.5f);
+      };
+      // The same as the shader
+      return (channel(1.5f - std::fabs(4.0f * v - 3.0f)) << 24) |
+             (channel(1.5f - std::fabs(4.0f * v - 2.0f)) << 16) |
+             (channel(1.5f - std::fabs(4.0f * v - 1.0f)) << 8) | 0xffu;
+    }
+
+    /// \brief Unpack the points of a cloud, skipping the ones which aren't
+    /// finite. The range of the mapped value is found on the way, so each
+    /// point is read once.
+    /// \param[in] _data Point data of the msg
+    /// \param[in] _layout Layout of the points
+    /// \param[in] _mode How points are colored
+    /// \param[in] _flat Color as 0xRRGGBBAA of FLAT points
+    /// \param[out] _points Points, replaced. Colors of HEIGHT and INTENSITY
+    /// points hold the raw value in the red channel, scaled by Normalize.
+    /// \param[out] _min Smallest mapped value, height or intensity
+    /// \param[out] _max Largest mapped value, height or intensity
+    /// \return True if colors hold values to Normalize, false if they're
+    /// final, such as when the cloud doesn't have the field to color by
+    inline bool Unpack(const std::string &_data, const Layout &_layout,
+        const ColorMode _mode, const std::uint32_t _flat, Points &_points,
+        float &_min, float &_max)
+    {
+      _points.Clear();
+      _points.positions.reserve(_layout.count * 3);
+      _points.colors.reserve(_layout.count);
+      _min = std::numeric_limits<float>::max();
+      _max = std::numeric_limits<float>::lowest();
+
+      // The common case is read without going through the type switch
+      bool floats = !_layout.swap &&
+          _layout.x.datatype == msgs::PointCloudPacked::Field::FLOAT32 &&
+          _layout.y.datatype == msgs::PointCloudPacked::Field::FLOAT32 &&
+          _layout.z.datatype == msgs::PointCloudPacked::Field::FLOAT32;
+
+      bool intensity = _mode == ColorMode::INTENSITY &&
+          _layout.intensity.Valid();
+      bool rgb = _mode == ColorMode::RGB && _layout.rgb.Valid();
+
+      const char *point = _data.data();
+      for (std::size_t i = 0; i < _layout.count;
+           ++i, point += _layout.pointStep)
+      {
+        float x, y, z;
+        if (floats)
+        {
+          std::memcpy(&x, point + _layout.x.offset, sizeof(float));
+          std::memcpy(&y, point + _layout.y.offset, sizeof(float));
+          std::memcpy(&z, point + _layout.z.offset, sizeof(float));
+        }
+        else
+        {
+          x = Read(point, _layout.x, _layout.swap);
+          y = Read(point, _layout.y, _layout.swap);
+          z = Read(point, _layout.z, _layout.swap);
+        }
+        if (!std::isfinite(x) || !std::isfinite(y) || !std::isfinite(z))
+          continue;
+
+        std::uint32_t color{_flat};
+        if (rgb)
+        {
+          // Packed as 0x00RRGGBB, whatever the declared type
+          auto packed = Load<std::uint32_t>(point + _layout.rgb.offset,
+              _layout.swap);
+          color = (packed << 8) | 0xffu;
+        }
+        else if (_mode == ColorMode::HEIGHT || intensity)
+        {
+          float value = intensity ?
+              Read(point, _layout.intensity, _layout.swap) : z;
+          if (!std::isfinite(value))
+            value = 0.0f;
+          _min = std::min(_min, value);
+          _max = std::max(_max, value);
+
+          // Kept as a float until the range is known
+          std::memcpy(&color, &value, sizeof(color));
+        }
+
+        _points.positions.push_back(x);
+        _points.positions.push_back(y);
+        _points.positions.push_back(z);
+        _points.colors.push_back(color);
+      }
+
+      if (_min > _max)
+      {
+        _min = 0.0f;
+        _max = 0.0f;
+      }
+      return _mode == ColorMode::HEIGHT || intensity;
+    }
+
+    /// \brief Turn the raw values left by Unpack into colors, once their
+    /// range is known.
+    /// \param[in, out] _points Points unpacked with HEIGHT or INTENSITY
+    /// \param[in] _min Smallest value
+    /// \param[in] _max Largest value
+    /// \param[in] _map True to apply the colormap, false to only keep the
+    /// value between 0 and 255 in the red channel, for a shader to map
+    inline void Normalize(Points &_points, const float _min,
+        const float _max, const bool _map)
+    {
+      float scale = _max > _min ? 1.0f / (_max - _min) : 0.0f;
+      for (auto &color : _points.colors)
+      {
+        float value;
+        std::memcpy(&value, &color, sizeof(value));
+        float v = (value - _min) * scale;
+        if (_map)
+        {
+          color = ColorMap(v);
+        }
+        else
+        {
+          auto level = static_cast<std::uint32_t>(
+              std::min(std::max(v, 0.0f), 1.0f) * 255.0f + 0.5f);
+          color = (level << 24) | 0xffu;
+        }
+      }
+    }
+
+    /// \brief Keep a single point in each cell of a voxel grid, the first
+    /// one found, in place.
+    /// \param[in, out] _points Points
+    /// \param[in] _voxel Length of the voxels, points are left alone
+    /// unless it's positive
+    /// \param[in, out] _cells Scratch open addressing table of cell keys,
+    /// kept between calls so it doesn't allocate again. Node based sets
+    /// are several times slower at millions of points.
+    inline void VoxelFilter(Points &_points, const float _voxel,
+        std::vector<std::uint64_t> &_cells)
+    {
+      if (!(_voxel > 0.0f))
+        return;
+
+      // At most half full, sized to a power of two so probing is a mask
+      std::size_t capacity{16};
+      while (capacity < _points.Size() * 2)
+        capacity <<= 1;
+      _cells.assign(capacity, 0u);
+      const std::size_t slots = capacity - 1;
+
+      // 21 bits per axis, so clouds up to a million voxels across. Keys are
+      // offset by one so that zero marks an empty slot.
+      const float inverse = 1.0f / _voxel;
+      const std::int64_t bias = 1 << 20;
+      const std::int64_t mask = (1 << 21) - 1;
+
+      std::size_t kept{0};
+      for (std::size_t i = 0; i < _points.Size(); ++i)
+      {
+        const float *p = &_points.positions[i * 3];
+        std::uint64_t key{0};
+        for (int axis = 0; axis < 3; ++axis)
+        {
+          auto cell = static_cast<std::int64_t>(std::floor(p[axis] * inverse));
+          key = (key << 21) |
+              static_cast<std::uint64_t>((cell + bias) & mask);
+        }
+        ++key;
+
+        // Fibonacci hashing spreads neighbouring cells over the table
+        auto slot = static_cast<std::size_t>(
+            (key * 0x9e3779b97f4a7c15ull) >> 32) & slots;
+        while (_cells[slot] != 0u && _cells[slot] != key)
+          slot = (slot + 1) & slots;
+        if (_cells[slot] == key)
+          continue;
+        _cells[slot] = key;
+
+        if (kept != i)
+        {
+          std::copy(p, p + 3, &_points.positions[kept * 3]);
+          _points.colors[kept] = _points.colors[i];
+        }
+        ++kept;
+      }
+      _points.positions.resize(kept * 3);
+      _points.colors.resize(kept);
+    }
+
+    /// \brief Decimate a cloud with a voxel grid until it has at most some
+    /// points, doubling the voxel length each time it has too many.
+    /// \param[in, out] _points Points
+    /// \param[in] _max Most points to keep, 0 for no limit
+    /// \param[in] _voxel Initial voxel length
+    /// \param[in, out] _cells Scratch table
+    /// \return Voxel length used, 0 if the cloud was small enough
+    inline float Decimate(Points &_points, const std::size_t _max,
+        const float _voxel, std::vector<std::uint64_t> &_cells)
+    {
+      if (_max == 0 || _points.Size() <= _max || !(_voxel > 0.0f))
+        return 0.0f;
+
+      float voxel = _voxel;
+      VoxelFilter(_points, voxel, _cells);
+      while (_points.Size() > _max)
+      {
+        voxel *= 2.0f;
+        VoxelFilter(_points, voxel, _cells);
+      }
+      return voxel;
+    }
+  }
+}
+}
+}
+
+#endif
@@ -0,0 +1,242 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "PointCloudDecoding.hh"
+
+using namespace ignition;
+using namespace gui;
+using namespace plugins;
+using namespace PointCloudDecoding;
+
+/////////////////////////////////////////////////
+/// \brief Add a field to a cloud.
+/// \param[in, out] _msg Cloud
+/// \param[in] _name Field name
+/// \param[in] _offset Offset in each point
+/// \param[in] _type Data type
+void AddField(msgs::PointCloudPacked &_msg, const std::string &_name,
+    const unsigned int _offset,
+    const msgs::PointCloudPacked::Field::DataType _type)
+{
+  auto field = _msg.add_field();
+  field->set_name(_name);
+  field->set_offset(_offset);
+  field->set_datatype(_type);
+  field->set_count(1);
+}
+
+/////////////////////////////////////////////////
+/// \brief Make a cloud of float x, y, z and intensity, with packed rgb.
+/// \param[in] _points X, Y, Z and intensity of each point
+/// \return Cloud
+msgs::PointCloudPacked MakeCloud(const std::vector<float> &_points)
+{
+  msgs::PointCloudPacked msg;
+  AddField(msg, "x", 0, msgs::PointCloudPacked::Field::FLOAT32);
+  AddField(msg, "y", 4, msgs::PointCloudPacked::Field::FLOAT32);
+  AddField(msg, "z", 8, msgs::PointCloudPacked::Field::FLOAT32);
+  AddField(msg, "intensity", 12, msgs::PointCloudPacked::Field::FLOAT32);
+  AddField(msg, "rgb", 16, msgs::PointCloudPacked::Field::FLOAT32);
+  msg.set_point_step(20);
+
+  std::string data;
+  for (std::size_t i = 0; i + 3 < _points.size(); i += 4)
+  {
+    char point[20];
+    std::memcpy(point, &_points[i], 16);
+    std::uint32_t rgb = 0x102030u;
+    std::memcpy(point + 16, &rgb, 4);
+    data.append(point, sizeof(point));
+  }
+  msg.set_width(static_cast<unsigned int>(data.size() / 20));
+  msg.set_height(1);
+  msg.set_row_step(static_cast<unsigned int>(data.size()));
+  msg.set_data(data);
+  return msg;
+}
+
+/////////////////////////////////////////////////
+TEST(PointCloudTest, Layout)
+{
+  Layout layout;
+  msgs::PointCloudPacked msg;
+  EXPECT_FALSE(MakeLayout(msg, layout));
+
+  msg = MakeCloud({1, 2, 3, 4, 5, 6, 7, 8});
+  ASSERT_TRUE(MakeLayout(msg, layout));
+  EXPECT_EQ(2u, layout.count);
+  EXPECT_EQ(20u, layout.pointStep);
+  EXPECT_EQ(12, layout.intensity.offset);
+  EXPECT_EQ(16, layout.rgb.offset);
+  EXPECT_FALSE(layout.swap);
+
+  // Fields which don't fit in a point are ignored
+  msg.set_point_step(16);
+  ASSERT_TRUE(MakeLayout(msg, layout));
+  EXPECT_FALSE(layout.rgb.Valid());
+
+  msg.clear_field();
+  AddField(msg, "x", 0, msgs::PointCloudPacked::Field::FLOAT32);
+  EXPECT_FALSE(MakeLayout(msg, layout));
+}
+
+/////////////////////////////////////////////////
+TEST(PointCloudTest, Unpack)
+{
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  auto msg = MakeCloud({1, 2, 3, 10,
+                        nan, 0, 0, 20,
+                        4, 5, 6, 30,
+                        7, 8, -3, 40});
+  Layout layout;
+  ASSERT_TRUE(MakeLayout(msg, layout));
+
+  // Points which aren't finite are skipped
+  Points points;
+  float min, max;
+  EXPECT_FALSE(Unpack(msg.data(), layout, ColorMode::FLAT, 0x11223344u,
+      points, min, max));
+  ASSERT_EQ(3u, points.Size());
+  EXPECT_FLOAT_EQ(4, points.positions[3]);
+  EXPECT_FLOAT_EQ(-3, points.positions[8]);
+  EXPECT_EQ(0x11223344u, points.colors[0]);
+
+  EXPECT_FALSE(Unpack(msg.data(), layout, ColorMode::RGB, 0u, points, min,
+      max));
+  EXPECT_EQ(0x102030ffu, points.colors[1]);
+
+  // Heights are mapped over their range
+  EXPECT_TRUE(Unpack(msg.data(), layout, ColorMode::HEIGHT, 0u, points, min,
+      max));
+  EXPECT_FLOAT_EQ(-3, min);
+  EXPECT_FLOAT_EQ(6, max);
+  Normalize(points, min, max, true);
+  EXPECT_EQ(ColorMap(6.0f / 9.0f), points.colors[0]);
+  EXPECT_EQ(ColorMap(1.0f), points.colors[1]);
+  EXPECT_EQ(ColorMap(0.0f), points.colors[2]);
+
+  // Intensities are left for the shader in the red channel
+  EXPECT_TRUE(Unpack(msg.data(), layout, ColorMode::INTENSITY, 0u, points,
+      min, max));
+  EXPECT_FLOAT_EQ(10, min);
+  EXPECT_FLOAT_EQ(40, max);
+  Normalize(points, min, max, false);
+  EXPECT_EQ(0x000000ffu, points.colors[0]);
+  EXPECT_EQ(0xaa0000ffu, points.colors[1]);
+  EXPECT_EQ(0xff0000ffu, points.colors[2]);
+
+  // Colormap from dark blue to dark red, clamped
+  EXPECT_EQ(0x000080ffu, ColorMap(0.0f));
+  EXPECT_EQ(0x000080ffu, ColorMap(-1.0f));
+  EXPECT_EQ(0x00ff00ffu, ColorMap(0.5f) & 0x00ff00ffu);
+  EXPECT_EQ(0x800000ffu, ColorMap(1.0f));
+  EXPECT_EQ(0x800000ffu, ColorMap(2.0f));
+}
+
+/////////////////////////////////////////////////
+TEST(PointCloudTest, Types)
+{
+  // Big endian doubles and an unsigned 16 bit intensity
+  msgs::PointCloudPacked msg;
+  AddField(msg, "x", 0, msgs::PointCloudPacked::Field::FLOAT64);
+  AddField(msg, "y", 8, msgs::PointCloudPacked::Field::FLOAT64);
+  AddField(msg, "z", 16, msgs::PointCloudPacked::Field::FLOAT64);
+  AddField(msg, "i", 24, msgs::PointCloudPacked::Field::UINT16);
+  msg.set_point_step(26);
+
+  const std::uint16_t one{1};
+  bool hostBig = *reinterpret_cast<const std::uint8_t *>(&one) == 0;
+  msg.set_is_bigendian(!hostBig);
+
+  std::string data(26, '\0');
+  double values[3] = {1.5, -2.5, 3.5};
+  for (int i = 0; i < 3; ++i)
+  {
+    char bytes[8];
+    std::memcpy(bytes, &values[i], 8);
+    std::reverse(bytes, bytes + 8);
+    std::memcpy(&data[i * 8], bytes, 8);
+  }
+  data[24] = 0x01;
+  data[25] = 0x02;
+  msg.set_data(data);
+
+  Layout layout;
+  ASSERT_TRUE(MakeLayout(msg, layout));
+  EXPECT_TRUE(layout.swap);
+
+  Points points;
+  float min, max;
+  EXPECT_TRUE(Unpack(msg.data(), layout, ColorMode::INTENSITY, 0u, points,
+      min, max));
+  ASSERT_EQ(1u, points.Size());
+  EXPECT_FLOAT_EQ(1.5, points.positions[0]);
+  EXPECT_FLOAT_EQ(-2.5, points.positions[1]);
+  EXPECT_FLOAT_EQ(3.5, points.positions[2]);
+  EXPECT_FLOAT_EQ(0x0102, min);
+}
+
+/////////////////////////////////////////////////
+TEST(PointCloudTest, Decimate)
+{
+  // A 100 x 100 grid of points 1 cm apart, 4 per 2 cm voxel
+  Points points;
+  for (int x = 0; x < 100; ++x)
+  {
+    for (int y = 0; y < 100; ++y)
+    {
+      points.positions.push_back(x * 0.01f + 0.001f);
+      points.positions.push_back(y * 0.01f + 0.001f);
+      points.positions.push_back(0.5f);
+      points.colors.push_back(static_cast<std::uint32_t>(x * 100 + y));
+    }
+  }
+
+  std::vector<std::uint64_t> cells;
+  auto copy = points;
+  EXPECT_FLOAT_EQ(0.0f, Decimate(copy, 20000, 0.02f, cells));
+  EXPECT_EQ(10000u, copy.Size());
+
+  VoxelFilter(copy, 0.02f, cells);
+  ASSERT_EQ(2500u, copy.Size());
+  EXPECT_EQ(0u, copy.colors[0]);
+  EXPECT_EQ(2u, copy.colors[1]);
+  EXPECT_EQ(copy.Size() * 3, copy.positions.size());
+
+  // Coarser voxels until few enough points
+  copy = points;
+  auto voxel = Decimate(copy, 1000, 0.02f, cells);
+  EXPECT_FLOAT_EQ(0.04f, voxel);
+  EXPECT_EQ(625u, copy.Size());
+
+  // Negative coordinates have voxels of their own
+  Points negative;
+  negative.positions = {-0.001f, 0, 0, 0.001f, 0, 0};
+  negative.colors = {1, 2};
+  VoxelFilter(negative, 1.0f, cells);
+  EXPECT_EQ(2u, negative.Size());
+}
@@ -15,7 +15,20 @@
  *
 */
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <google/protobuf/text_format.h>
 #ifdef _MSC_VER
 #pragma warning(push, 0)
 #endif
@@ -27,6 +40,7 @@
 #include <ignition/plugin/Register.hh>
 #include <ignition/transport/Node.hh>
 
+#include "ignition/gui/MsgSchema.hh"
 #include "Publisher.hh"
 
 namespace ignition
@@ -35,8 +49,86 @@ namespace gui
 {
 namespace plugins
 {
+  /// \brief Clock used to schedule messages
+  using PublishClock = std::chrono::steady_clock;
+
+  /// \brief A topic published by the scheduler
+  struct PublishStream
+  {
+    /// \brief Topic
+    std::string topic;
+
+    /// \brief Message type
+    std::string msgType;
+
+    /// \brief Message contents, in Protobuf text format
+    std::string msgData;
+
+    /// \brief Deadlines per second, 0 to publish once
+    double frequency{1.0};
+
+    /// \brief Messages published back to back at each deadline
+    unsigned int burst{1};
+
+    /// \brief Numeric field set to the sequence number of each message,
+    /// empty for none
+    std::string counterField;
+
+    /// \brief Whether header.stamp is set to the time each message is
+    /// published
+    bool stamp{false};
+
+    /// \brief Size in bytes the payload field is padded or truncated to, 0
+    /// to leave it as is
+    std::size_t payloadSize{0};
+
+    /// \brief String or bytes field resized by payloadSize
+    std::string payloadField{"data"};
+
+    /// \brief Message, parsed once and updated before each publication
+    std::shared_ptr<google::protobuf::Message> msg;
+
+    /// \brief Publisher
+    transport::Node::Publisher pub;
+
+    /// \brief Descriptor of the counter field, null if there isn't one
+    const google::protobuf::FieldDescriptor *counter{nullptr};
+
+    /// \brief Header whose stamp is set, null if not stamping
+    msgs::Header *header{nullptr};
+
+    /// \brief Sequence number of the next message
+    std::uint64_t seq{0};
+
+    /// \brief Time between deadlines
+    PublishClock::duration period{1};
+
+    /// \brief Next deadline
+    PublishClock::time_point deadline;
+
+    /// \brief Messages published during the current measurement window
+    std::uint64_t windowMsgs{0};
+  };
+
   class PublisherPrivate
   {
+    /// \brief Parse a stream's message and advertise its topic.
+    /// \param[in, out] _stream Stream
+    /// \return True if the stream can be published
+    public: bool Prepare(PublishStream &_stream);
+
+    /// \brief Update the fields which vary from message to message.
+    /// \param[in, out] _stream Stream about to be published
+    public: static void Vary(PublishStream &_stream);
+
+    /// \brief Publish all streams until stopped. Runs on its own thread.
+    /// \param[in] _batched Whether missed deadlines are caught up
+    public: void Run(bool _batched);
+
+    /// \brief Stop the publishing thread, if running, and wait for it, then
+    /// stop advertising all streams.
+    public: void Stop();
+
     /// \brief Message type
     public: QString msgType = "ignition.msgs.StringMsg";
 
@@ -49,14 +141,49 @@ namespace plugins
     /// \brief Frequency
     public: double frequency = 1.0;
 
-    /// \brief Timer to keep publishing
-    public: QTimer *timer;
+    /// \brief Messages published back to back at each deadline
+    public: unsigned int burst{1};
+
+    /// \brief Whether missed deadlines are caught up
+    public: bool batched{false};
+
+    /// \brief Streams from <stream> elements. If there are any, they're
+    /// published instead of the single message above.
+    public: std::vector<PublishStream> configStreams;
+
+    /// \brief Streams being published. Only used by the publishing thread
+    /// while it runs.
+    public: std::vector<PublishStream> streams;
+
+    /// \brief Timer to refresh the achieved rate and jitter
+    public: QTimer *timer{nullptr};
+
+    /// \brief Thread publishing messages
+    public: std::thread thread;
+
+    /// \brief True while the thread should keep publishing
+    public: bool running{false};
+
+    /// \brief Protects running
+    public: std::mutex mutex;
+
+    /// \brief Wakes up the thread to stop it
+    public: std::condition_variable stopCondition;
+
+    /// \brief Messages per second over the last second, for all streams
+    public: std::atomic<double> achievedRate{0.0};
+
+    /// \brief Average lateness in milliseconds over the last second
+    public: std::atomic<double> jitter{0.0};
+
+    /// \brief Topic and messages per second of each stream
+    public: std::vector<std::pair<std::string, double>> streamRates;
+
+    /// \brief Protects streamRates
+    public: std::mutex statsMutex;
 
     /// \brief Node for communication
     public: ignition::transport::Node node;
-
-    /// \brief Publisher
-    public: ignition::transport::Node::Publisher pub;
   };
 }
 }
@@ -66,6 +193,261 @@ using namespace ignition;
 using namespace gui;
 using namespace plugins;
 
+/////////////////////////////////////////////////
+bool PublisherPrivate::Prepare(PublishStream &_stream)
+{
+  // Check it's possible to create message. It's created once and
+  // published as many times as needed.
+  if (auto schema = MsgSchema::Find(_stream.msgType))
+  {
+    _stream.msg = schema->New();
+    google::protobuf::TextFormat::ParseFromString(_stream.msgData,
+        _stream.msg.get());
+  }
+  if (!_stream.msg ||
+      (_stream.msg->DebugString() == "" && _stream.msgData != ""))
+  {
+    ignerr << "Unable to create message of type[" << _stream.msgType << "] "
+      << "with data[" << _stream.msgData << "].\n";
+    return false;
+  }
+
+  auto descriptor = _stream.msg->GetDescriptor();
+  auto reflection = _stream.msg->GetReflection();
+  using Field = google::protobuf::FieldDescriptor;
+
+  // Payload
+  if (_stream.payloadSize > 0)
+  {
+    auto field = descriptor->FindFieldByName(_stream.payloadField);
+    if (field && !field->is_repeated() &&
+        field->cpp_type() == Field::CPPTYPE_STRING)
+    {
+      auto payload = reflection->GetString(*_stream.msg, field);
+      payload.resize(_stream.payloadSize, ' ');
+      reflection->SetString(_stream.msg.get(), field, payload);
+    }
+    else
+    {
+      ignwarn << "Message type [" << _stream.msgType << "] has no string "
+              << "field [" << _stream.payloadField << "] to hold the payload"
+              << std::endl;
+    }
+  }
+
+  // Counter
+  if (!_stream.counterField.empty())
+  {
+    auto field = descriptor->FindFieldByName(_stream.counterField);
+    if (field && !field->is_repeated() &&
+        (field->cpp_type() == Field::CPPTYPE_INT32 ||
+         field->cpp_type() == Field::CPPTYPE_INT64 ||
+         field->cpp_type() == Field::CPPTYPE_UINT32 ||
+         field->cpp_type() == Field::CPPTYPE_UINT64 ||
+         field->cpp_type() == Field::CPPTYPE_DOUBLE ||
+         field->cpp_type() == Field::CPPTYPE_FLOAT))
+    {
+      _stream.counter = field;
+    }
+    else
+    {
+      ignwarn << "Message type [" << _stream.msgType << "] has no numeric "
+              << "field [" << _stream.counterField << "] to hold the counter"
+              << std::endl;
+    }
+  }
+
+  // Stamp
+  if (_stream.stamp)
+  {
+    auto field = descriptor->FindFieldByName("header");
+    if (field && !field->is_repeated() &&
+        field->cpp_type() == Field::CPPTYPE_MESSAGE)
+    {
+      _stream.header = dynamic_cast<msgs::Header *>(
+          reflection->MutableMessage(_stream.msg.get(), field));
+    }
+    if (!_stream.header)
+    {
+      ignwarn << "Message type [" << _stream.msgType << "] has no header "
+              << "to stamp" << std::endl;
+    }
+  }
+
+  // Advertise the topic
+  _stream.pub = this->node.Advertise(_stream.topic, _stream.msgType);
+  if (!_stream.pub)
+  {
+    ignerr << "Unable to publish on topic[" << _stream.topic << "] "
+      << "with message type[" << _stream.msgType << "].\n";
+    return false;
+  }
+
+  if (_stream.frequency >= 0.00001)
+  {
+    _stream.period = std::chrono::duration_cast<PublishClock::duration>(
+        std::chrono::duration<double>(1.0 / _stream.frequency));
+    if (_stream.period <= PublishClock::duration::zero())
+      _stream.period = PublishClock::duration(1);
+  }
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+void PublisherPrivate::Vary(PublishStream &_stream)
+{
+  if (auto field = _stream.counter)
+  {
+    auto msg = _stream.msg.get();
+    auto reflection = msg->GetReflection();
+    using Field = google::protobuf::FieldDescriptor;
+    switch (field->cpp_type())
+    {
+      case Field::CPPTYPE_INT32:
+        reflection->SetInt32(msg, field,
+            static_cast<google::protobuf::int32>(_stream.seq));
+        break;
+      case Field::CPPTYPE_INT64:
+        reflection->SetInt64(msg, field,
+            static_cast<google::protobuf::int64>(_stream.seq));
+        break;
+      case Field::CPPTYPE_UINT32:
+        reflection->SetUInt32(msg, field,
+            static_cast<google::protobuf::uint32>(_stream.seq));
+        break;
+      case Field::CPPTYPE_UINT64:
+        reflection->SetUInt64(msg, field, _stream.seq);
+        break;
+      case Field::CPPTYPE_DOUBLE:
+        reflection->SetDouble(msg, field, static_cast<double>(_stream.seq));
+        break;
+      case Field::CPPTYPE_FLOAT:
+        reflection->SetFloat(msg, field, static_cast<float>(_stream.seq));
+        break;
+      default:
+        break;
+    }
+  }
+
+  if (_stream.header)
+  {
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    auto sec = std::chrono::duration_cast<std::chrono::seconds>(now);
+    auto nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        now - sec);
+    _stream.header->mutable_stamp()->set_sec(sec.count());
+    _stream.header->mutable_stamp()->set_nsec(
+        static_cast<google::protobuf::int32>(nsec.count()));
+  }
+
+  ++_stream.seq;
+}
+
+/////////////////////////////////////////////////
+void PublisherPrivate::Run(bool _batched)
+{
+  // Deadlines are absolute, so time spent publishing doesn't add up
+  auto start = PublishClock::now();
+  for (auto &stream : this->streams)
+  {
+    stream.deadline = stream.frequency >= 0.00001 ?
+        start : PublishClock::time_point::max();
+  }
+
+  auto windowStart = start;
+  std::uint64_t windowWakes{0};
+  PublishClock::duration windowLateness{0};
+
+  std::unique_lock<std::mutex> lock(this->mutex);
+  while (this->running)
+  {
+    lock.unlock();
+
+    auto now = PublishClock::now();
+    auto next = PublishClock::time_point::max();
+    for (auto &stream : this->streams)
+    {
+      if (stream.deadline <= now)
+      {
+        windowLateness += now - stream.deadline;
+        ++windowWakes;
+
+        for (unsigned int i = 0; i < stream.burst; ++i)
+        {
+          Vary(stream);
+          stream.pub.Publish(*stream.msg);
+        }
+        stream.windowMsgs += stream.burst;
+
+        stream.deadline += stream.period;
+
+        // Fell behind, skip the deadlines which were missed unless batching,
+        // in which case they're published without waiting
+        auto published = PublishClock::now();
+        if (!_batched && published > stream.deadline)
+        {
+          stream.deadline +=
+              ((published - stream.deadline) / stream.period + 1) *
+              stream.period;
+        }
+      }
+      next = std::min(next, stream.deadline);
+    }
+
+    now = PublishClock::now();
+    if (now - windowStart >= std::chrono::seconds(1))
+    {
+      std::chrono::duration<double> elapsed = now - windowStart;
+      std::uint64_t windowMsgs{0};
+      {
+        std::lock_guard<std::mutex> statsLock(this->statsMutex);
+        for (std::size_t i = 0; i < this->streams.size(); ++i)
+        {
+          windowMsgs += this->streams[i].windowMsgs;
+          this->streamRates[i].second =
+              this->streams[i].windowMsgs / elapsed.count();
+          this->streams[i].windowMsgs = 0;
+        }
+      }
+      this->achievedRate = windowMsgs / elapsed.count();
+      this->jitter = std::chrono::duration<double, std::milli>(
+          windowLateness).count() / std::max<std::uint64_t>(1, windowWakes);
+
+      windowStart = now;
+      windowWakes = 0;
+      windowLateness = PublishClock::duration::zero();
+    }
+
+    lock.lock();
+    this->stopCondition.wait_until(lock, next, [this]
+    {
+      return !this->running;
+    });
+  }
+}
+
+/////////////////////////////////////////////////
+void PublisherPrivate::Stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->running = false;
+  }
+  this->stopCondition.notify_all();
+
+  if (this->thread.joinable())
+    this->thread.join();
+
+  this->streams.clear();
+  {
+    std::lock_guard<std::mutex> statsLock(this->statsMutex);
+    this->streamRates.clear();
+  }
+  this->achievedRate = 0.0;
+  this->jitter = 0.0;
+}
+
 /////////////////////////////////////////////////
 Publisher::Publisher()
   : Plugin(), dataPtr(new PublisherPrivate)
@@ -75,6 +457,7 @@ Publisher::Publisher()
 /////////////////////////////////////////////////
 Publisher::~Publisher()
 {
+  this->dataPtr->Stop();
 }
 
 /////////////////////////////////////////////////
@@ -100,65 +483,132 @@ void Publisher::LoadConfig(const tinyxml2::XMLElement *_pluginElem)
 
     if (auto frequencyElem = _pluginElem->FirstChildElement("frequency"))
       frequencyElem->QueryDoubleText(&this->dataPtr->frequency);
+
+    if (auto burstElem = _pluginElem->FirstChildElement("burst"))
+    {
+      burstElem->QueryUnsignedText(&this->dataPtr->burst);
+      this->SetBurst(this->dataPtr->burst);
+    }
+
+    if (auto batchedElem = _pluginElem->FirstChildElement("batched"))
+      batchedElem->QueryBoolText(&this->dataPtr->batched);
+
+    // Load generator
+    for (auto streamElem = _pluginElem->FirstChildElement("stream");
+        streamElem != nullptr;
+        streamElem = streamElem->NextSiblingElement("stream"))
+    {
+      PublishStream stream;
+      stream.topic = this->dataPtr->topic.toStdString();
+      stream.msgType = this->dataPtr->msgType.toStdString();
+      stream.burst = this->dataPtr->burst;
+
+      auto elem = streamElem->FirstChildElement("topic");
+      if (nullptr != elem && nullptr != elem->GetText())
+        stream.topic = elem->GetText();
+
+      elem = streamElem->FirstChildElement("message_type");
+      if (nullptr != elem && nullptr != elem->GetText())
+        stream.msgType = elem->GetText();
+
+      elem = streamElem->FirstChildElement("message");
+      if (nullptr != elem && nullptr != elem->GetText())
+        stream.msgData = elem->GetText();
+
+      if (auto frequencyElem = streamElem->FirstChildElement("frequency"))
+        frequencyElem->QueryDoubleText(&stream.frequency);
+
+      if (auto burstElem = streamElem->FirstChildElement("burst"))
+      {
+        burstElem->QueryUnsignedText(&stream.burst);
+        stream.burst = std::max(1u, stream.burst);
+      }
+
+      elem = streamElem->FirstChildElement("counter");
+      if (nullptr != elem && nullptr != elem->GetText())
+        stream.counterField = elem->GetText();
+
+      if (auto stampElem = streamElem->FirstChildElement("stamp"))
+        stampElem->QueryBoolText(&stream.stamp);
+
+      if (auto sizeElem = streamElem->FirstChildElement("payload_size"))
+      {
+        unsigned int size{0};
+        sizeElem->QueryUnsignedText(&size);
+        stream.payloadSize = size;
+        if (auto field = sizeElem->Attribute("field"))
+          stream.payloadField = field;
+      }
+
+      this->dataPtr->configStreams.push_back(stream);
+    }
   }
 
+  // The stats are measured by the publishing thread and shown once a second
   this->dataPtr->timer = new QTimer(this);
+  this->dataPtr->timer->setInterval(1000);
+  this->connect(this->dataPtr->timer, &QTimer::timeout, this,
+      &Publisher::StatsChanged);
 }
 
 /////////////////////////////////////////////////
 void Publisher::OnPublish(const bool _checked)
 {
+  // Stop the thread before touching the streams it uses
+  this->dataPtr->Stop();
+  if (this->dataPtr->timer != nullptr)
+    this->dataPtr->timer->stop();
+  this->StatsChanged();
+
   if (!_checked)
-  {
-    if (this->dataPtr->timer != nullptr)
-    {
-      this->dataPtr->timer->stop();
-      this->disconnect(this->dataPtr->timer, 0, 0, 0);
-    }
-    this->dataPtr->pub = ignition::transport::Node::Publisher();
     return;
-  }
-
-  auto topic = this->dataPtr->topic.toStdString();
-  auto msgType = this->dataPtr->msgType.toStdString();
-  auto msgData = this->dataPtr->msgData.toStdString();
 
-  // Check it's possible to create message
-  auto msg = ignition::msgs::Factory::New(msgType, msgData);
-  if (!msg || (msg->DebugString() == "" && msgData != ""))
+  // Streams from the config, or the single message being edited
+  std::vector<PublishStream> streams = this->dataPtr->configStreams;
+  if (streams.empty())
   {
-    ignerr << "Unable to create message of type[" << msgType << "] "
-      << "with data[" << msgData << "].\n";
-    // TODO(anyone): notify error and uncheck switch
-    return;
+    PublishStream stream;
+    stream.topic = this->dataPtr->topic.toStdString();
+    stream.msgType = this->dataPtr->msgType.toStdString();
+    stream.msgData = this->dataPtr->msgData.toStdString();
+    stream.frequency = this->dataPtr->frequency;
+    stream.burst = this->dataPtr->burst;
+    streams.push_back(stream);
   }
 
-  // Advertise the topic
-  this->dataPtr->pub = this->dataPtr->node.Advertise(topic, msgType);
-
-  if (!this->dataPtr->pub)
+  for (auto &stream : streams)
   {
-    ignerr << "Unable to publish on topic[" << topic << "] "
-      << "with message type[" << msgType << "].\n";
     // TODO(anyone): notify error and uncheck switch
-    return;
+    if (!this->dataPtr->Prepare(stream))
+      continue;
+
+    // Zero frequency, publish once
+    if (stream.frequency < 0.00001)
+    {
+      PublisherPrivate::Vary(stream);
+      stream.pub.Publish(*stream.msg);
+    }
+    this->dataPtr->streams.push_back(stream);
   }
 
-  // Zero frequency, publish once
-  if (this->dataPtr->frequency < 0.00001)
-  {
-    this->dataPtr->pub.Publish(*msg);
-    // TODO(anyone): notify error and uncheck switch
+  // Periodic streams are published by the scheduler thread, the others
+  // stay advertised until publishing stops
+  auto periodic = std::any_of(this->dataPtr->streams.begin(),
+      this->dataPtr->streams.end(), [](const PublishStream &_stream)
+      {
+        return _stream.frequency >= 0.00001;
+      });
+  if (!periodic)
     return;
-  }
 
-  this->dataPtr->timer->setInterval(1000/this->dataPtr->frequency);
-  this->connect(this->dataPtr->timer, &QTimer::timeout, [=]()
-  {
-    auto newMsg = ignition::msgs::Factory::New(msgType, msgData);
-    this->dataPtr->pub.Publish(*newMsg);
-  });
-  this->dataPtr->timer->start();
+  for (const auto &stream : this->dataPtr->streams)
+    this->dataPtr->streamRates.push_back({stream.topic, 0.0});
+
+  this->dataPtr->running = true;
+  this->dataPtr->thread = std::thread(&PublisherPrivate::Run,
+      this->dataPtr.get(), this->dataPtr->batched);
+  if (this->dataPtr->timer != nullptr)
+    this->dataPtr->timer->start();
 }
 
 /////////////////////////////////////////////////
@@ -213,6 +663,57 @@ void Publisher::SetFrequency(const double _frequency)
   this->FrequencyChanged();
 }
 
+/////////////////////////////////////////////////
+unsigned int Publisher::Burst() const
+{
+  return this->dataPtr->burst;
+}
+
+/////////////////////////////////////////////////
+void Publisher::SetBurst(const unsigned int _burst)
+{
+  this->dataPtr->burst = std::max(1u, _burst);
+}
+
+/////////////////////////////////////////////////
+bool Publisher::Batched() const
+{
+  return this->dataPtr->batched;
+}
+
+/////////////////////////////////////////////////
+void Publisher::SetBatched(const bool _batched)
+{
+  this->dataPtr->batched = _batched;
+}
+
+/////////////////////////////////////////////////
+double Publisher::AchievedRate() const
+{
+  return this->dataPtr->achievedRate;
+}
+
+/////////////////////////////////////////////////
+double Publisher::Jitter() const
+{
+  return this->dataPtr->jitter;
+}
+
+/////////////////////////////////////////////////
+QVariantList Publisher::StreamStats() const
+{
+  QVariantList stats;
+  std::lock_guard<std::mutex> lock(this->dataPtr->statsMutex);
+  for (const auto &rate : this->dataPtr->streamRates)
+  {
+    QVariantMap stat;
+    stat["topic"] = QString::fromStdString(rate.first);
+    stat["rate"] = rate.second;
+    stats.push_back(stat);
+  }
+  return stats;
+}
+
 // Register this plugin
 IGNITION_ADD_PLUGIN(ignition::gui::plugins::Publisher,
                     ignition::gui::Plugin)
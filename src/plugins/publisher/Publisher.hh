@@ -42,8 +42,35 @@ namespace plugins
 
   /// \brief Widget which publishes a custom Ignition transport message.
   ///
+  /// Messages are published from a dedicated thread, on deadlines from a
+  /// steady clock, so the rate doesn't depend on how busy the GUI is. The
+  /// rate and jitter achieved are reported, which makes the plugin usable
+  /// as a load generator.
+  ///
   /// ## Configuration
-  /// This plugin doesn't accept any custom configuration.
+  ///
+  /// * `<message_type>` : Message type, such as `ignition.msgs.StringMsg`.
+  /// * `<message>` : Message contents in Protobuf text format.
+  /// * `<topic>` : Topic to publish on.
+  /// * `<frequency>` : Publishing frequency in Hz, 0 to publish once.
+  /// * `<burst>` : Number of messages published back to back at each
+  ///               deadline, defaults to 1.
+  /// * `<batched>` : If true, deadlines which are missed because the thread
+  ///                 fell behind are caught up by publishing all of their
+  ///                 messages at once. Otherwise they're skipped. Defaults
+  ///                 to false.
+  /// * `<stream>` : Turns the plugin into a load generator. Each `<stream>`
+  ///                element is a topic published from the same scheduler
+  ///                thread, instead of the single message above. It accepts
+  ///                `<topic>`, `<message_type>`, `<message>`, `<frequency>`
+  ///                and `<burst>` as above, plus:
+  ///   * `<counter>` : Name of a numeric field set to the sequence number of
+  ///                   each message.
+  ///   * `<stamp>` : If true, the message's `header.stamp` is set to the time
+  ///                 each message is published.
+  ///   * `<payload_size>` : Size in bytes the string field named by the
+  ///                        `field` attribute, `data` by default, is padded
+  ///                        or truncated to.
   class Publisher_EXPORTS_API Publisher : public Plugin
   {
     Q_OBJECT
@@ -80,6 +107,28 @@ namespace plugins
       NOTIFY FrequencyChanged
     )
 
+    /// \brief Messages published per second, measured over the last second
+    Q_PROPERTY(
+      double achievedRate
+      READ AchievedRate
+      NOTIFY StatsChanged
+    )
+
+    /// \brief Average lateness of deadlines over the last second, in
+    /// milliseconds
+    Q_PROPERTY(
+      double jitter
+      READ Jitter
+      NOTIFY StatsChanged
+    )
+
+    /// \brief Topic and achieved rate of each stream
+    Q_PROPERTY(
+      QVariantList streamStats
+      READ StreamStats
+      NOTIFY StatsChanged
+    )
+
     /// \brief Constructor
     public: Publisher();
 
@@ -143,6 +192,43 @@ namespace plugins
     /// \brief Notify that frequency has changed
     signals: void FrequencyChanged();
 
+    /// \brief Get the number of messages published at each deadline
+    /// \return Burst size, at least 1
+    public: unsigned int Burst() const;
+
+    /// \brief Set the number of messages published at each deadline. Takes
+    /// effect the next time publishing starts.
+    /// \param[in] _burst Burst size, at least 1
+    public: void SetBurst(const unsigned int _burst);
+
+    /// \brief Get whether missed deadlines are caught up.
+    /// \return True if batched
+    public: bool Batched() const;
+
+    /// \brief Set whether missed deadlines are caught up by publishing all
+    /// of their messages at once, instead of being skipped. Takes effect the
+    /// next time publishing starts.
+    /// \param[in] _batched True to batch
+    public: void SetBatched(const bool _batched);
+
+    /// \brief Get the number of messages published per second, measured
+    /// over the last second.
+    /// \return Rate in Hz
+    public: Q_INVOKABLE double AchievedRate() const;
+
+    /// \brief Get how late deadlines were met on average over the last
+    /// second.
+    /// \return Jitter in milliseconds
+    public: Q_INVOKABLE double Jitter() const;
+
+    /// \brief Get the topic and messages published per second of each
+    /// stream being published, measured over the last second.
+    /// \return List of maps with "topic" and "rate" keys
+    public: Q_INVOKABLE QVariantList StreamStats() const;
+
+    /// \brief Notify that the achieved rate and jitter were measured again
+    signals: void StatsChanged();
+
     /// \internal
     /// \brief Pointer to private data.
     private: std::unique_ptr<PublisherPrivate> dataPtr;
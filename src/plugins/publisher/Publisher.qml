@@ -22,7 +22,7 @@ Rectangle {
   id: publisher
   color: "transparent"
   Layout.minimumWidth: 250
-  Layout.minimumHeight: 375
+  Layout.minimumHeight: 400
 
   property int tooltipDelay: 500
   property int tooltipTimeout: 1000
@@ -78,6 +78,8 @@ Rectangle {
     SpinBox {
       id: frequencyField
       value: 1.00
+      to: 100000
+      editable: true
 // why can't this be parsed?
 //      decimals: 2
 //      minimumValue: 0.0
@@ -101,5 +103,18 @@ Rectangle {
       ToolTip.timeout: tooltipTimeout
       ToolTip.text: checked ? qsTr("Stop publising") : qsTr("Start publishing")
     }
+
+    Label {
+      text: Publisher.achievedRate.toFixed(1) + " Hz, jitter " +
+          Publisher.jitter.toFixed(3) + " ms"
+    }
+
+    // One line per topic when generating load
+    Repeater {
+      model: Publisher.streamStats.length > 1 ? Publisher.streamStats : []
+      Label {
+        text: modelData.topic + ": " + modelData.rate.toFixed(1) + " Hz"
+      }
+    }
   }
 }
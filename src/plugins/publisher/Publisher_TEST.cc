@@ -16,9 +16,15 @@
 */
 
 #include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
 #ifdef _MSC_VER
 #pragma warning(push, 0)
 #endif
+#include <ignition/msgs/int32.pb.h>
 #include <ignition/msgs/stringmsg.pb.h>
 #ifdef _MSC_VER
 #pragma warning(pop)
@@ -253,3 +259,143 @@ TEST(PublisherTest, IGN_UTILS_TEST_ENABLED_ONLY_ON_LINUX(ParamsFromSDF))
   // Frequency
   EXPECT_DOUBLE_EQ(plugin->Frequency(), 0.1);
 }
+
+//////////////////////////////////////////////////
+TEST(PublisherTest, IGN_UTILS_TEST_ENABLED_ONLY_ON_LINUX(HighRate))
+{
+  common::Console::SetVerbosity(4);
+
+  Application app(g_argc, g_argv);
+  app.AddPluginPath(std::string(PROJECT_BINARY_PATH) + "/lib");
+
+  // Load plugin
+  const char *pluginStr =
+    "<plugin filename=\"Publisher\">"
+      "<topic>/high_rate</topic>"
+      "<frequency>500</frequency>"
+      "<burst>2</burst>"
+      "<batched>true</batched>"
+    "</plugin>";
+
+  tinyxml2::XMLDocument pluginDoc;
+  EXPECT_EQ(tinyxml2::XML_SUCCESS, pluginDoc.Parse(pluginStr));
+  EXPECT_TRUE(app.LoadPlugin("Publisher",
+      pluginDoc.FirstChildElement("plugin")));
+
+  auto win = app.findChild<MainWindow *>();
+  ASSERT_NE(nullptr, win);
+
+  auto plugins = win->findChildren<plugins::Publisher *>();
+  ASSERT_EQ(plugins.size(), 1);
+
+  auto plugin = plugins[0];
+  EXPECT_EQ(2u, plugin->Burst());
+  EXPECT_TRUE(plugin->Batched());
+
+  std::atomic<int> received{0};
+  std::function<void(const msgs::StringMsg &)> cb =
+      [&](const msgs::StringMsg &)
+  {
+    ++received;
+  };
+  transport::Node node;
+  node.Subscribe("/high_rate", cb);
+
+  plugin->OnPublish(true);
+
+  // Published from its own thread, while this one is busy
+  std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+  QCoreApplication::processEvents();
+
+  EXPECT_GT(plugin->AchievedRate(), 500.0);
+  EXPECT_GE(plugin->Jitter(), 0.0);
+  EXPECT_GT(received, 500);
+
+  plugin->OnPublish(false);
+  EXPECT_DOUBLE_EQ(0.0, plugin->AchievedRate());
+}
+
+//////////////////////////////////////////////////
+TEST(PublisherTest, IGN_UTILS_TEST_ENABLED_ONLY_ON_LINUX(Streams))
+{
+  common::Console::SetVerbosity(4);
+
+  Application app(g_argc, g_argv);
+  app.AddPluginPath(std::string(PROJECT_BINARY_PATH) + "/lib");
+
+  // Load plugin
+  const char *pluginStr =
+    "<plugin filename=\"Publisher\">"
+      "<stream>"
+        "<topic>/load_a</topic>"
+        "<message_type>ignition.msgs.Int32</message_type>"
+        "<frequency>200</frequency>"
+        "<counter>data</counter>"
+        "<stamp>true</stamp>"
+      "</stream>"
+      "<stream>"
+        "<topic>/load_b</topic>"
+        "<frequency>50</frequency>"
+        "<payload_size>1000</payload_size>"
+      "</stream>"
+    "</plugin>";
+
+  tinyxml2::XMLDocument pluginDoc;
+  EXPECT_EQ(tinyxml2::XML_SUCCESS, pluginDoc.Parse(pluginStr));
+  EXPECT_TRUE(app.LoadPlugin("Publisher",
+      pluginDoc.FirstChildElement("plugin")));
+
+  auto win = app.findChild<MainWindow *>();
+  ASSERT_NE(nullptr, win);
+
+  auto plugins = win->findChildren<plugins::Publisher *>();
+  ASSERT_EQ(plugins.size(), 1);
+  auto plugin = plugins[0];
+
+  std::mutex mutex;
+  std::vector<int> counters;
+  bool stamped{true};
+  std::function<void(const msgs::Int32 &)> cbA =
+      [&](const msgs::Int32 &_msg)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    counters.push_back(_msg.data());
+    stamped = stamped && _msg.header().stamp().sec() > 0;
+  };
+  std::atomic<int> receivedB{0};
+  std::atomic<bool> sized{true};
+  std::function<void(const msgs::StringMsg &)> cbB =
+      [&](const msgs::StringMsg &_msg)
+  {
+    ++receivedB;
+    sized = sized && _msg.data().size() == 1000u;
+  };
+  transport::Node node;
+  node.Subscribe("/load_a", cbA);
+  node.Subscribe("/load_b", cbB);
+
+  plugin->OnPublish(true);
+  std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+  QCoreApplication::processEvents();
+
+  auto stats = plugin->StreamStats();
+  ASSERT_EQ(2, stats.size());
+  EXPECT_EQ("/load_a", stats[0].toMap()["topic"].toString());
+  EXPECT_GT(stats[0].toMap()["rate"].toDouble(), 100.0);
+  EXPECT_EQ("/load_b", stats[1].toMap()["topic"].toString());
+  EXPECT_GT(stats[1].toMap()["rate"].toDouble(), 25.0);
+
+  plugin->OnPublish(false);
+  EXPECT_TRUE(plugin->StreamStats().empty());
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_GT(counters.size(), 100u);
+    EXPECT_TRUE(stamped);
+
+    // Counters go up, though a few messages may be lost
+    EXPECT_TRUE(std::is_sorted(counters.begin(), counters.end()));
+  }
+  EXPECT_GT(receivedB, 25);
+  EXPECT_TRUE(sized);
+}
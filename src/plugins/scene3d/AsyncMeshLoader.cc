@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "AsyncMeshLoader.hh"
+
+#include <algorithm>
+#include <cctype>
+#include <mutex>
+#include <set>
+
+#include <ignition/common/ColladaLoader.hh>
+#include <ignition/common/Console.hh>
+#include <ignition/common/Mesh.hh>
+#include <ignition/common/MeshManager.hh>
+#include <ignition/common/OBJLoader.hh>
+#include <ignition/common/STLLoader.hh>
+#include <ignition/common/Util.hh>
+
+#include "ignition/gui/Executor.hh"
+
+namespace ignition
+{
+namespace gui
+{
+namespace plugins
+{
+  class AsyncMeshLoaderPrivate
+  {
+    /// \brief Parse a single mesh file, on a worker thread.
+    /// \param[in] _filename Mesh name, as it'll be known to the mesh manager
+    /// \param[in] _fullPath Path to the mesh file
+    public: void Load(const std::string &_filename,
+                      const std::string &_fullPath);
+
+    /// \brief Protects pending and done
+    public: std::mutex mutex;
+
+    /// \brief Meshes requested and not yet returned by Completed
+    public: std::set<std::string> pending;
+
+    /// \brief Parsed meshes waiting to be picked up, null if parsing failed
+    public: std::vector<std::pair<std::string, common::Mesh *>> done;
+  };
+}
+}
+}
+
+using namespace ignition;
+using namespace gui;
+using namespace plugins;
+
+/////////////////////////////////////////////////
+/// \brief Get the extension of a file, in lower case
+/// \param[in] _path File path
+/// \return Extension without the dot
+static std::string extension(const std::string &_path)
+{
+  auto dot = _path.rfind('.');
+  if (dot == std::string::npos)
+    return std::string();
+
+  auto ext = _path.substr(dot + 1);
+  std::transform(ext.begin(), ext.end(), ext.begin(),
+      [](unsigned char _c) {return std::tolower(_c);});
+  return ext;
+}
+
+/////////////////////////////////////////////////
+void AsyncMeshLoaderPrivate::Load(const std::string &_filename,
+    const std::string &_fullPath)
+{
+  // Use a loader of our own so that tasks don't share parser state. These
+  // are the same loaders common::MeshManager uses.
+  common::Mesh *mesh{nullptr};
+  auto ext = extension(_fullPath);
+  if (ext == "stl" || ext == "stlb" || ext == "stla")
+  {
+    common::STLLoader loader;
+    mesh = loader.Load(_fullPath);
+  }
+  else if (ext == "dae")
+  {
+    common::ColladaLoader loader;
+    mesh = loader.Load(_fullPath);
+  }
+  else if (ext == "obj")
+  {
+    common::OBJLoader loader;
+    mesh = loader.Load(_fullPath);
+  }
+
+  if (mesh)
+    mesh->SetName(_filename);
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->done.push_back({_filename, mesh});
+}
+
+/////////////////////////////////////////////////
+AsyncMeshLoader::AsyncMeshLoader()
+  : dataPtr(new AsyncMeshLoaderPrivate)
+{
+  // Meshes don't depend on each other, so they're parsed in parallel
+  Executor::Instance().SetConcurrency(this->dataPtr.get(),
+      Executor::Instance().ThreadCount());
+}
+
+/////////////////////////////////////////////////
+AsyncMeshLoader::~AsyncMeshLoader()
+{
+  Executor::Instance().Cancel(this->dataPtr.get());
+  for (auto &done : this->dataPtr->done)
+    delete done.second;
+}
+
+/////////////////////////////////////////////////
+bool AsyncMeshLoader::Request(const std::string &_filename)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  if (this->dataPtr->pending.find(_filename) != this->dataPtr->pending.end())
+    return true;
+
+  auto ext = extension(_filename);
+  if (ext != "stl" && ext != "stlb" && ext != "stla" && ext != "dae" &&
+      ext != "obj")
+  {
+    return false;
+  }
+
+  // Resolve the path up front so that failures are reported the same way
+  // common::MeshManager does.
+  auto fullPath = common::findFile(_filename);
+  if (fullPath.empty())
+    return false;
+
+  this->dataPtr->pending.insert(_filename);
+  auto data = this->dataPtr.get();
+  Executor::Instance().Post(data, [data, _filename, fullPath]()
+  {
+    data->Load(_filename, fullPath);
+  });
+  return true;
+}
+
+/////////////////////////////////////////////////
+std::vector<std::pair<std::string, bool>> AsyncMeshLoader::Completed()
+{
+  std::vector<std::pair<std::string, common::Mesh *>> done;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    done.swap(this->dataPtr->done);
+    for (const auto &d : done)
+      this->dataPtr->pending.erase(d.first);
+  }
+
+  std::vector<std::pair<std::string, bool>> result;
+  auto meshManager = common::MeshManager::Instance();
+  for (auto &d : done)
+  {
+    if (!d.second)
+    {
+      ignerr << "Failed to load mesh [" << d.first << "]" << std::endl;
+      result.push_back({d.first, false});
+      continue;
+    }
+
+    // Someone else may have loaded it in the meantime
+    if (meshManager->HasMesh(d.first))
+      delete d.second;
+    else
+      meshManager->AddMesh(d.second);
+    result.push_back({d.first, true});
+  }
+  return result;
+}
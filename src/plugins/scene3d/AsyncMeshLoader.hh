@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGNITION_GUI_PLUGINS_SCENE3D_ASYNCMESHLOADER_HH_
+#define IGNITION_GUI_PLUGINS_SCENE3D_ASYNCMESHLOADER_HH_
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ignition
+{
+namespace gui
+{
+namespace plugins
+{
+  class AsyncMeshLoaderPrivate;
+
+  /// \brief Parses mesh files on the worker threads shared by the
+  /// application.
+  ///
+  /// Meshes are requested from the render thread, parsed in the background,
+  /// and handed back to the render thread on the next call to Completed,
+  /// which adds them to common::MeshManager. From then on they can be used
+  /// to create rendering geometry without touching the disk.
+  class AsyncMeshLoader
+  {
+    /// \brief Constructor
+    public: AsyncMeshLoader();
+
+    /// \brief Destructor. Drops requests which didn't start and waits for
+    /// meshes being parsed.
+    public: ~AsyncMeshLoader();
+
+    /// \brief Start loading a mesh in the background. Requesting a mesh which
+    /// is already being loaded is a no-op.
+    /// \param[in] _filename Mesh file, as given to common::MeshManager.
+    /// \return False if the file format can't be loaded in the background,
+    /// in which case the caller should load it directly.
+    public: bool Request(const std::string &_filename);
+
+    /// \brief Add meshes which finished loading to common::MeshManager. This
+    /// must be called from the thread which uses the meshes.
+    /// \return File names of all requests completed since the last call,
+    /// each paired with false if it failed to load.
+    public: std::vector<std::pair<std::string, bool>> Completed();
+
+    /// \brief Private data pointer
+    private: std::unique_ptr<AsyncMeshLoaderPrivate> dataPtr;
+  };
+}
+}
+}
+
+#endif
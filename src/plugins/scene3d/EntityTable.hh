@@ -0,0 +1,390 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGNITION_GUI_PLUGINS_SCENE3D_ENTITYTABLE_HH_
+#define IGNITION_GUI_PLUGINS_SCENE3D_ENTITYTABLE_HH_
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <ignition/math/Pose3.hh>
+
+namespace ignition
+{
+namespace gui
+{
+namespace plugins
+{
+  /// \brief Dense store of scene nodes keyed by entity id.
+  ///
+  /// The entity ids, node handles and poses are kept in parallel contiguous
+  /// arrays, and a sparse index maps entity ids into them. Erasing moves the
+  /// last entry into the hole, so the arrays never have gaps and applying
+  /// poses is a single linear sweep.
+  ///
+  /// Poses are applied in two steps: SetPose stages a pose for an entity and
+  /// Apply hands all staged poses to the nodes at once. Poses which are the
+  /// same as the last one applied to a node, within kPoseTolerance, aren't
+  /// handed over again, so static entities don't dirty the scene graph.
+  ///
+  /// \tparam T Node handle type, such as rendering::VisualPtr::weak_type.
+  template <typename T>
+  class EntityTable
+  {
+    /// \brief Value returned by Index for unknown entities.
+    public: static constexpr std::size_t kNone =
+        std::numeric_limits<std::size_t>::max();
+
+    /// \brief Largest difference in position and in quaternion components
+    /// between two poses which are considered the same.
+    public: static constexpr double kPoseTolerance = 1e-6;
+
+    /// \brief Number of entities in the table.
+    /// \return Entity count.
+    public: std::size_t Size() const
+    {
+      return this->ids.size();
+    }
+
+    /// \brief Get the dense index of an entity.
+    /// \param[in] _id Entity id.
+    /// \return Index into the table, or kNone if not present.
+    public: std::size_t Index(const unsigned int _id) const
+    {
+      auto it = this->index.find(_id);
+      return it == this->index.end() ? kNone : it->second;
+    }
+
+    /// \brief Check if an entity is in the table.
+    /// \param[in] _id Entity id.
+    /// \return True if present.
+    public: bool Has(const unsigned int _id) const
+    {
+      return this->index.find(_id) != this->index.end();
+    }
+
+    /// \brief Add an entity, or replace the node of an existing one. The
+    /// local pose is reset and any staged pose is dropped.
+    /// \param[in] _id Entity id.
+    /// \param[in] _node Node handle.
+    public: void Set(const unsigned int _id, const T &_node)
+    {
+      auto it = this->index.find(_id);
+      if (it != this->index.end())
+      {
+        auto i = it->second;
+        this->nodes[i] = _node;
+        this->localPoses[i] = math::Pose3d::Zero;
+        this->applied[i] = false;
+        if (this->dirty[i])
+        {
+          this->dirty[i] = false;
+          --this->dirtyCount;
+        }
+        return;
+      }
+
+      this->index[_id] = this->ids.size();
+      this->ids.push_back(_id);
+      this->nodes.push_back(_node);
+      this->poses.push_back(math::Pose3d::Zero);
+      this->localPoses.push_back(math::Pose3d::Zero);
+      this->appliedPoses.push_back(math::Pose3d::Zero);
+      this->applied.push_back(false);
+      this->dirty.push_back(false);
+    }
+
+    /// \brief Get the node handle of an entity.
+    /// \param[in] _id Entity id.
+    /// \return The node handle, or a default constructed handle if the
+    /// entity isn't in the table.
+    public: T Node(const unsigned int _id) const
+    {
+      auto i = this->Index(_id);
+      return i == kNone ? T() : this->nodes[i];
+    }
+
+    /// \brief Set a transform which is always applied on top of the poses
+    /// set through SetPose.
+    /// \param[in] _id Entity id.
+    /// \param[in] _pose Local pose.
+    /// \return False if the entity isn't in the table.
+    public: bool SetLocalPose(const unsigned int _id,
+        const math::Pose3d &_pose)
+    {
+      auto i = this->Index(_id);
+      if (i == kNone)
+        return false;
+
+      this->localPoses[i] = _pose;
+      return true;
+    }
+
+    /// \brief Stage a pose to be applied on the next call to Apply. Staging
+    /// again before that overrides the previous pose.
+    /// \param[in] _id Entity id.
+    /// \param[in] _pose New pose.
+    /// \return False if the entity isn't in the table.
+    public: bool SetPose(const unsigned int _id, const math::Pose3d &_pose)
+    {
+      auto i = this->Index(_id);
+      if (i == kNone)
+        return false;
+
+      this->poses[i] = _pose;
+      if (!this->dirty[i])
+      {
+        this->dirty[i] = true;
+        ++this->dirtyCount;
+      }
+      return true;
+    }
+
+    /// \brief Forget the last pose applied to an entity's node, after the
+    /// node was moved some other way, so the next staged pose is handed
+    /// over even if it's the same.
+    /// \param[in] _id Entity id.
+    /// \return False if the entity isn't in the table.
+    public: bool Invalidate(const unsigned int _id)
+    {
+      auto i = this->Index(_id);
+      if (i == kNone)
+        return false;
+
+      this->applied[i] = false;
+      return true;
+    }
+
+    /// \brief Remove an entity.
+    /// \param[in] _id Entity id.
+    /// \return False if the entity wasn't in the table.
+    public: bool Erase(const unsigned int _id)
+    {
+      auto i = this->Index(_id);
+      if (i == kNone)
+        return false;
+
+      this->EraseAt(i);
+      return true;
+    }
+
+    /// \brief Remove many entities in a single sweep. Unlike Erase, the
+    /// remaining entities keep their relative order.
+    /// \param[in] _pred Called as `bool _pred(unsigned int _id)` for each
+    /// entity. Return true to remove it.
+    /// \return Number of entities removed.
+    public: template <typename P>
+    std::size_t EraseIf(P _pred)
+    {
+      std::size_t kept = 0u;
+      for (std::size_t i = 0u; i < this->ids.size(); ++i)
+      {
+        if (_pred(this->ids[i]))
+        {
+          if (this->dirty[i])
+            --this->dirtyCount;
+          this->index.erase(this->ids[i]);
+          continue;
+        }
+
+        if (kept != i)
+        {
+          this->ids[kept] = this->ids[i];
+          this->nodes[kept] = std::move(this->nodes[i]);
+          this->poses[kept] = this->poses[i];
+          this->localPoses[kept] = this->localPoses[i];
+          this->appliedPoses[kept] = this->appliedPoses[i];
+          this->applied[kept] = this->applied[i];
+          this->dirty[kept] = this->dirty[i];
+          this->index[this->ids[kept]] = kept;
+        }
+        ++kept;
+      }
+
+      auto erased = this->ids.size() - kept;
+      this->ids.resize(kept);
+      this->nodes.resize(kept);
+      this->poses.resize(kept);
+      this->localPoses.resize(kept);
+      this->appliedPoses.resize(kept);
+      this->applied.resize(kept);
+      this->dirty.resize(kept);
+      return erased;
+    }
+
+    /// \brief Hand all staged poses, combined with their local poses, to the
+    /// nodes, unless they didn't change.
+    /// \param[in] _func Called as `bool _func(T &_node, const Pose3d &_pose)`
+    /// for each staged entity. Return false to remove the entity from the
+    /// table, for example because its node no longer exists.
+    /// \return Number of poses which were applied.
+    public: template <typename F>
+    std::size_t Apply(F _func)
+    {
+      return this->Apply(_func, [](const unsigned int) {return false;});
+    }
+
+    /// \brief Hand staged poses, combined with their local poses, to the
+    /// nodes, except for the ones which are deferred or didn't change.
+    /// Deferred poses stay staged until a later call, or until they're
+    /// overridden by SetPose.
+    /// \param[in] _func Called as `bool _func(T &_node, const Pose3d &_pose)`
+    /// for each staged entity which isn't deferred. Return false to remove
+    /// the entity from the table, for example because its node no longer
+    /// exists.
+    /// \param[in] _defer Called as `bool _defer(unsigned int _id)` for each
+    /// staged entity. Return true to keep its pose staged.
+    /// \return Number of poses which were applied.
+    /// \sa Skipped
+    public: template <typename F, typename D>
+    std::size_t Apply(F _func, D _defer)
+    {
+      std::size_t applied = 0u;
+      this->skipped = 0u;
+      if (this->dirtyCount == 0u)
+        return applied;
+
+      // Sweep backwards so that erasing, which moves the last element into
+      // the current slot, doesn't skip anything.
+      std::size_t deferred = 0u;
+      for (std::size_t i = this->ids.size(); i-- > 0u;)
+      {
+        if (!this->dirty[i])
+          continue;
+
+        if (_defer(this->ids[i]))
+        {
+          ++deferred;
+          continue;
+        }
+
+        this->dirty[i] = false;
+        auto pose = this->poses[i] * this->localPoses[i];
+        if (this->applied[i] && Same(pose, this->appliedPoses[i]))
+        {
+          ++this->skipped;
+          continue;
+        }
+
+        if (_func(this->nodes[i], pose))
+        {
+          this->appliedPoses[i] = pose;
+          this->applied[i] = true;
+          ++applied;
+        }
+        else
+        {
+          this->EraseAt(i);
+        }
+      }
+      this->dirtyCount = deferred;
+      return applied;
+    }
+
+    /// \brief Number of staged poses which the last call to Apply didn't
+    /// hand over, because they were the same as the last ones applied.
+    /// \return Skipped poses
+    public: std::size_t Skipped() const
+    {
+      return this->skipped;
+    }
+
+    /// \brief Check if two poses are the same within kPoseTolerance.
+    /// \param[in] _a A pose
+    /// \param[in] _b Another pose
+    /// \return True if they're the same
+    private: static bool Same(const math::Pose3d &_a, const math::Pose3d &_b)
+    {
+      return _a.Pos().Equal(_b.Pos(), kPoseTolerance) &&
+          std::abs(_a.Rot().W() - _b.Rot().W()) <= kPoseTolerance &&
+          std::abs(_a.Rot().X() - _b.Rot().X()) <= kPoseTolerance &&
+          std::abs(_a.Rot().Y() - _b.Rot().Y()) <= kPoseTolerance &&
+          std::abs(_a.Rot().Z() - _b.Rot().Z()) <= kPoseTolerance;
+    }
+
+    /// \brief Remove the entity at a dense index by moving the last entity
+    /// into its place.
+    /// \param[in] _i Dense index.
+    private: void EraseAt(const std::size_t _i)
+    {
+      if (this->dirty[_i])
+        --this->dirtyCount;
+      this->index.erase(this->ids[_i]);
+
+      auto last = this->ids.size() - 1u;
+      if (_i != last)
+      {
+        this->ids[_i] = this->ids[last];
+        this->nodes[_i] = std::move(this->nodes[last]);
+        this->poses[_i] = this->poses[last];
+        this->localPoses[_i] = this->localPoses[last];
+        this->appliedPoses[_i] = this->appliedPoses[last];
+        this->applied[_i] = this->applied[last];
+        this->dirty[_i] = this->dirty[last];
+        this->index[this->ids[_i]] = _i;
+      }
+
+      this->ids.pop_back();
+      this->nodes.pop_back();
+      this->poses.pop_back();
+      this->localPoses.pop_back();
+      this->appliedPoses.pop_back();
+      this->applied.pop_back();
+      this->dirty.pop_back();
+    }
+
+    /// \brief Entity ids.
+    private: std::vector<unsigned int> ids;
+
+    /// \brief Node handles, parallel to ids.
+    private: std::vector<T> nodes;
+
+    /// \brief Staged poses, parallel to ids.
+    private: std::vector<math::Pose3d> poses;
+
+    /// \brief Local poses, parallel to ids.
+    private: std::vector<math::Pose3d> localPoses;
+
+    /// \brief Last poses handed to the nodes, parallel to ids.
+    private: std::vector<math::Pose3d> appliedPoses;
+
+    /// \brief Whether a pose was handed to the node since it was set,
+    /// parallel to ids.
+    private: std::vector<unsigned char> applied;
+
+    /// \brief Whether there's a staged pose, parallel to ids. This is not a
+    /// vector<bool> so that each flag can be read and written directly.
+    private: std::vector<unsigned char> dirty;
+
+    /// \brief Number of staged poses.
+    private: std::size_t dirtyCount{0u};
+
+    /// \brief Poses skipped by the last call to Apply.
+    private: std::size_t skipped{0u};
+
+    /// \brief Entity id to dense index.
+    private: std::unordered_map<unsigned int, std::size_t> index;
+  };
+}
+}
+}
+
+#endif
@@ -0,0 +1,210 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "FrameCapture.hh"
+
+#include <array>
+#include <cstring>
+#include <string>
+
+namespace ignition
+{
+namespace gui
+{
+namespace plugins
+{
+  class FrameCapturePrivate
+  {
+    /// \brief A pixel buffer a texture is read into
+    public: struct Buffer
+    {
+      /// \brief Pixel buffer object
+      GLuint pbo{0u};
+
+      /// \brief Signaled once the read is done, null if nothing's in flight
+      GLsync fence{nullptr};
+
+      /// \brief Size of the texture read
+      QSize size;
+
+      /// \brief Allocated size of the pixel buffer in bytes
+      std::size_t capacity{0u};
+    };
+
+    /// \brief Buffers, used in turns
+    public: std::array<Buffer, 2> buffers;
+
+    /// \brief Buffer for the next read, which is also the oldest one
+    public: std::size_t next{0u};
+
+    /// \brief Framebuffer the textures are attached to for reading
+    public: GLuint fbo{0u};
+  };
+}
+}
+}
+
+using namespace ignition;
+using namespace gui;
+using namespace plugins;
+
+/////////////////////////////////////////////////
+/// \brief Get the functions needed for capturing on the current context
+/// \return Functions, or null if capturing isn't supported.
+static QOpenGLExtraFunctions *captureFunctions()
+{
+  auto context = QOpenGLContext::currentContext();
+  if (!context)
+    return nullptr;
+
+  auto version = context->format().version();
+  bool supported = context->isOpenGLES() ?
+      version >= qMakePair(3, 0) : version >= qMakePair(3, 2);
+
+  return supported ? context->extraFunctions() : nullptr;
+}
+
+/////////////////////////////////////////////////
+FrameCapture::FrameCapture()
+  : dataPtr(new FrameCapturePrivate)
+{
+}
+
+/////////////////////////////////////////////////
+FrameCapture::~FrameCapture()
+{
+  auto gl = captureFunctions();
+  if (!gl)
+    return;
+
+  for (auto &buffer : this->dataPtr->buffers)
+  {
+    if (buffer.fence)
+      gl->glDeleteSync(buffer.fence);
+    if (buffer.pbo)
+      gl->glDeleteBuffers(1, &buffer.pbo);
+  }
+  if (this->dataPtr->fbo)
+    gl->glDeleteFramebuffers(1, &this->dataPtr->fbo);
+}
+
+/////////////////////////////////////////////////
+bool FrameCapture::Supported()
+{
+  return captureFunctions() != nullptr;
+}
+
+/////////////////////////////////////////////////
+void FrameCapture::Read(const GLuint _texture, const QSize &_size)
+{
+  auto gl = captureFunctions();
+  if (!gl || _size.isEmpty())
+    return;
+
+  auto &buffer = this->dataPtr->buffers[this->dataPtr->next];
+  this->dataPtr->next =
+      (this->dataPtr->next + 1u) % this->dataPtr->buffers.size();
+
+  // Nobody took it in time
+  if (buffer.fence)
+  {
+    gl->glDeleteSync(buffer.fence);
+    buffer.fence = nullptr;
+  }
+
+  if (!buffer.pbo)
+    gl->glGenBuffers(1, &buffer.pbo);
+  if (!this->dataPtr->fbo)
+    gl->glGenFramebuffers(1, &this->dataPtr->fbo);
+
+  // Leave the render engine's framebuffer bound as it was
+  GLint prevFbo = 0;
+  gl->glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &prevFbo);
+  gl->glBindFramebuffer(GL_READ_FRAMEBUFFER, this->dataPtr->fbo);
+  gl->glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+      GL_TEXTURE_2D, _texture, 0);
+
+  std::size_t bytes = _size.width() * _size.height() * 4u;
+  gl->glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer.pbo);
+  if (bytes > buffer.capacity)
+  {
+    gl->glBufferData(GL_PIXEL_PACK_BUFFER, bytes, nullptr, GL_STREAM_READ);
+    buffer.capacity = bytes;
+  }
+
+  // Into the pixel buffer, so this returns without waiting for the GPU
+  gl->glReadPixels(0, 0, _size.width(), _size.height(), GL_RGBA,
+      GL_UNSIGNED_BYTE, nullptr);
+
+  gl->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  gl->glBindFramebuffer(GL_READ_FRAMEBUFFER, prevFbo);
+
+  buffer.size = _size;
+  buffer.fence = gl->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+/////////////////////////////////////////////////
+bool FrameCapture::Take(msgs::Image &_image)
+{
+  auto gl = captureFunctions();
+  if (!gl)
+    return false;
+
+  auto &buffers = this->dataPtr->buffers;
+  auto *buffer = &buffers[this->dataPtr->next];
+  if (!buffer->fence)
+    buffer = &buffers[(this->dataPtr->next + 1u) % buffers.size()];
+  if (!buffer->fence)
+    return false;
+
+  auto status = gl->glClientWaitSync(buffer->fence, 0, 0);
+  if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+    return false;
+  gl->glDeleteSync(buffer->fence);
+  buffer->fence = nullptr;
+
+  auto width = static_cast<std::size_t>(buffer->size.width());
+  auto height = static_cast<std::size_t>(buffer->size.height());
+  auto step = width * 4u;
+
+  gl->glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer->pbo);
+  auto pixels = static_cast<const char *>(gl->glMapBufferRange(
+      GL_PIXEL_PACK_BUFFER, 0, step * height, GL_MAP_READ_BIT));
+  if (!pixels)
+  {
+    gl->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    return false;
+  }
+
+  // OpenGL rows go bottom up, images top down
+  auto data = _image.mutable_data();
+  data->resize(step * height);
+  for (std::size_t row = 0; row < height; ++row)
+  {
+    std::memcpy(&(*data)[row * step], pixels + (height - 1u - row) * step,
+        step);
+  }
+
+  gl->glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+  gl->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+  _image.set_width(width);
+  _image.set_height(height);
+  _image.set_step(step);
+  _image.set_pixel_format_type(msgs::PixelFormatType::RGBA_INT8);
+  return true;
+}
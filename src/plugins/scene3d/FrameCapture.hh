@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGNITION_GUI_PLUGINS_SCENE3D_FRAMECAPTURE_HH_
+#define IGNITION_GUI_PLUGINS_SCENE3D_FRAMECAPTURE_HH_
+
+#include <memory>
+
+// TODO(louise) Remove these pragmas once ign-msgs is disabling the warnings
+#ifdef _MSC_VER
+#pragma warning(push, 0)
+#endif
+#include <ignition/msgs/image.pb.h>
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#include "ignition/gui/qt.h"
+
+namespace ignition
+{
+namespace gui
+{
+namespace plugins
+{
+  class FrameCapturePrivate;
+
+  /// \brief Reads rendered textures back to the CPU without stalling.
+  ///
+  /// Read copies a texture into one of two pixel buffers and returns right
+  /// away. Take picks up the oldest copy once the GPU is done with it, so
+  /// a frame usually comes out one call later. Buffers are reused, so
+  /// capturing at a steady size doesn't allocate.
+  ///
+  /// All functions, including the destructor, must be called with the
+  /// OpenGL context the textures belong to current.
+  class FrameCapture
+  {
+    /// \brief Constructor
+    public: FrameCapture();
+
+    /// \brief Destructor
+    public: ~FrameCapture();
+
+    /// \brief Check if the current context supports capturing. It needs
+    /// pixel buffers and sync objects, i.e. OpenGL 3.2 or OpenGL ES 3.0.
+    /// \return True if supported
+    public: static bool Supported();
+
+    /// \brief Start reading a texture back. If both buffers are still in
+    /// flight, the oldest copy is dropped.
+    /// \param[in] _texture OpenGL texture id
+    /// \param[in] _size Texture size in pixels
+    public: void Read(const GLuint _texture, const QSize &_size);
+
+    /// \brief Get the oldest copy if the GPU is done with it.
+    /// \param[out] _image Image to fill in as RGBA, reusing its buffer.
+    /// \return True if an image was filled in, false if there's nothing
+    /// ready yet.
+    public: bool Take(msgs::Image &_image);
+
+    /// \brief Private data pointer
+    private: std::unique_ptr<FrameCapturePrivate> dataPtr;
+  };
+}
+}
+}
+
+#endif
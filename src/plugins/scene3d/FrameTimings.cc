@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "FrameTimings.hh"
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+using namespace ignition;
+using namespace gui;
+using namespace plugins;
+
+/////////////////////////////////////////////////
+FrameTimings::FrameTimings(const std::size_t _window)
+  : window(std::max<std::size_t>(_window, 1u))
+{
+  for (auto &s : this->samples)
+    s.reserve(this->window);
+  this->skippedWrites.reserve(this->window);
+  this->migrations.reserve(this->window);
+  this->current.fill(Clock::duration::zero());
+}
+
+/////////////////////////////////////////////////
+void FrameTimings::Record(const Stage _stage,
+    const Clock::duration &_duration)
+{
+  if (_stage >= STAGE_COUNT)
+    return;
+
+  this->current[_stage] += _duration;
+}
+
+/////////////////////////////////////////////////
+void FrameTimings::Record(const Stage _stage, Clock::time_point &_start)
+{
+  auto now = Clock::now();
+  this->Record(_stage, now - _start);
+  _start = now;
+}
+
+/////////////////////////////////////////////////
+void FrameTimings::RecordSkippedWrites(const std::size_t _count)
+{
+  this->currentSkippedWrites += _count;
+}
+
+/////////////////////////////////////////////////
+void FrameTimings::RecordCpu(const int _cpu)
+{
+  this->currentCpu = _cpu;
+}
+
+/////////////////////////////////////////////////
+int FrameTimings::CurrentCpu()
+{
+#ifdef __linux__
+  return sched_getcpu();
+#else
+  return -1;
+#endif
+}
+
+/////////////////////////////////////////////////
+void FrameTimings::EndFrame()
+{
+  for (std::size_t i = 0; i < STAGE_COUNT; ++i)
+  {
+    auto &s = this->samples[i];
+    if (s.size() < this->window)
+      s.push_back(this->current[i]);
+    else
+      s[this->next] = this->current[i];
+  }
+  this->current.fill(Clock::duration::zero());
+
+  if (this->skippedWrites.size() < this->window)
+    this->skippedWrites.push_back(this->currentSkippedWrites);
+  else
+    this->skippedWrites[this->next] = this->currentSkippedWrites;
+  this->currentSkippedWrites = 0u;
+
+  unsigned char migrated = this->currentCpu >= 0 && this->lastCpu >= 0 &&
+      this->currentCpu != this->lastCpu;
+  if (this->migrations.size() < this->window)
+    this->migrations.push_back(migrated);
+  else
+    this->migrations[this->next] = migrated;
+  if (this->currentCpu >= 0)
+    this->lastCpu = this->currentCpu;
+  this->currentCpu = -1;
+
+  this->next = (this->next + 1u) % this->window;
+  this->count = std::min(this->count + 1u, this->window);
+}
+
+/////////////////////////////////////////////////
+std::size_t FrameTimings::FrameCount() const
+{
+  return this->count;
+}
+
+/////////////////////////////////////////////////
+std::string FrameTimings::StageName(const Stage _stage)
+{
+  switch (_stage)
+  {
+    case UPDATE:
+      return "update";
+    case MOUSE:
+      return "mouse";
+    case RENDER:
+      return "render";
+    case RENDER_EVENT:
+      return "render event";
+    case FRAME:
+      return "frame";
+    default:
+      return "unknown";
+  }
+}
+
+/////////////////////////////////////////////////
+std::string FrameTimings::Summary() const
+{
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(2)
+      << "ms over " << this->count << " frames: mean / p50 / p95 / max";
+
+  auto ms = [](const Clock::duration &_d)
+  {
+    return std::chrono::duration<double, std::milli>(_d).count();
+  };
+
+  std::vector<Clock::duration> sorted;
+  for (std::size_t i = 0; i < STAGE_COUNT; ++i)
+  {
+    sorted = this->samples[i];
+    out << std::endl << StageName(static_cast<Stage>(i)) << ": ";
+    if (sorted.empty())
+    {
+      out << "-";
+      continue;
+    }
+
+    std::sort(sorted.begin(), sorted.end());
+    Clock::duration sum = Clock::duration::zero();
+    for (const auto &d : sorted)
+      sum += d;
+
+    out << ms(sum) / sorted.size() << " / "
+        << ms(sorted[sorted.size() / 2]) << " / "
+        << ms(sorted[(sorted.size() - 1) * 95 / 100]) << " / "
+        << ms(sorted.back());
+  }
+
+  if (!this->skippedWrites.empty())
+  {
+    std::size_t sum = 0u;
+    std::size_t max = 0u;
+    for (auto n : this->skippedWrites)
+    {
+      sum += n;
+      max = std::max(max, n);
+    }
+    out << std::endl << "skipped pose writes: "
+        << static_cast<double>(sum) / this->skippedWrites.size() << " / "
+        << max << " (mean / max)";
+  }
+
+  if (this->lastCpu >= 0)
+  {
+    std::size_t moved = 0u;
+    for (auto m : this->migrations)
+      moved += m;
+    out << std::endl << "cpu: " << this->lastCpu << ", moved in " << moved
+        << " of " << this->migrations.size() << " frames";
+  }
+  return out.str();
+}
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGNITION_GUI_PLUGINS_SCENE3D_FRAMETIMINGS_HH_
+#define IGNITION_GUI_PLUGINS_SCENE3D_FRAMETIMINGS_HH_
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace ignition
+{
+namespace gui
+{
+namespace plugins
+{
+  /// \brief Rolling timing statistics for the stages of a frame.
+  ///
+  /// Each stage keeps the durations of the last few frames, from which
+  /// Summary computes the mean, median, 95th percentile and maximum.
+  class FrameTimings
+  {
+    /// \brief Stages of a frame
+    public: enum Stage
+    {
+      /// \brief SceneManager::Update
+      UPDATE = 0,
+
+      /// \brief Handling mouse events
+      MOUSE,
+
+      /// \brief Rendering the camera
+      RENDER,
+
+      /// \brief Dispatching the render event to other plugins
+      RENDER_EVENT,
+
+      /// \brief Whole frame
+      FRAME,
+
+      /// \brief Number of stages
+      STAGE_COUNT
+    };
+
+    /// \brief Clock used for timing
+    public: using Clock = std::chrono::steady_clock;
+
+    /// \brief Constructor
+    /// \param[in] _window Number of frames to keep
+    public: explicit FrameTimings(const std::size_t _window = 120u);
+
+    /// \brief Record how long a stage took in the current frame.
+    /// \param[in] _stage Frame stage
+    /// \param[in] _duration Time spent on it
+    public: void Record(const Stage _stage, const Clock::duration &_duration);
+
+    /// \brief Record the time spent on a stage since a given time point.
+    /// \param[in] _stage Frame stage
+    /// \param[in,out] _start Start of the stage, set to now so that it can be
+    /// used as the start of the next stage.
+    public: void Record(const Stage _stage, Clock::time_point &_start);
+
+    /// \brief Record how many unchanged poses the scene update of the
+    /// current frame didn't write to the scene graph.
+    /// \param[in] _count Skipped writes
+    public: void RecordSkippedWrites(const std::size_t _count);
+
+    /// \brief Record the CPU the current frame was rendered on.
+    /// \param[in] _cpu CPU index, negative if unknown
+    /// \sa CurrentCpu
+    public: void RecordCpu(const int _cpu);
+
+    /// \brief Finish the current frame. Stages not recorded count as zero.
+    public: void EndFrame();
+
+    /// \brief Number of frames recorded, up to the window size.
+    /// \return Frame count
+    public: std::size_t FrameCount() const;
+
+    /// \brief Human readable statistics in milliseconds, one stage per line.
+    /// \return Summary of the recorded frames
+    public: std::string Summary() const;
+
+    /// \brief CPU the calling thread is running on.
+    /// \return CPU index, or -1 where it can't be known
+    public: static int CurrentCpu();
+
+    /// \brief Name of a stage
+    /// \param[in] _stage Frame stage
+    /// \return Name
+    public: static std::string StageName(const Stage _stage);
+
+    /// \brief Number of frames to keep
+    private: std::size_t window;
+
+    /// \brief Durations of the last frames for each stage, used as rings
+    private: std::array<std::vector<Clock::duration>, STAGE_COUNT> samples;
+
+    /// \brief Durations of the frame in progress
+    private: std::array<Clock::duration, STAGE_COUNT> current;
+
+    /// \brief Skipped pose writes of the last frames, used as a ring
+    private: std::vector<std::size_t> skippedWrites;
+
+    /// \brief Skipped pose writes of the frame in progress
+    private: std::size_t currentSkippedWrites{0u};
+
+    /// \brief Whether each of the last frames ran on another CPU than the
+    /// frame before, used as a ring
+    private: std::vector<unsigned char> migrations;
+
+    /// \brief CPU of the frame in progress, negative if unknown
+    private: int currentCpu{-1};
+
+    /// \brief CPU of the last finished frame, negative if unknown
+    private: int lastCpu{-1};
+
+    /// \brief Index of the next sample to overwrite
+    private: std::size_t next{0u};
+
+    /// \brief Number of recorded frames, up to window
+    private: std::size_t count{0u};
+  };
+}
+}
+}
+
+#endif
@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGNITION_GUI_PLUGINS_SCENE3D_LIGHTBUDGET_HH_
+#define IGNITION_GUI_PLUGINS_SCENE3D_LIGHTBUDGET_HH_
+
+#include <algorithm>
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ignition
+{
+namespace gui
+{
+namespace plugins
+{
+  /// \brief Keeps the number of enabled lights of a scene under a cap, by
+  /// telling which lights to enable or disable. The most important lights
+  /// are kept enabled.
+  ///
+  /// Each update, all lights are scored, then Select ranks them. Lights
+  /// which are enabled get a head start of kHysteresis, so that two lights
+  /// of about the same importance don't keep swapping places.
+  class LightBudget
+  {
+    /// \brief How much more important a disabled light must be than an
+    /// enabled one to take its place.
+    public: static constexpr double kHysteresis = 1.25;
+
+    /// \brief Set the most lights enabled at once.
+    /// \param[in] _count Capacity, 0 for no limit
+    public: void SetCapacity(const std::size_t _count)
+    {
+      this->capacity = _count;
+    }
+
+    /// \brief Get the most lights enabled at once.
+    /// \return Capacity, 0 for no limit
+    public: std::size_t Capacity() const
+    {
+      return this->capacity;
+    }
+
+    /// \brief Importance of a light seen from a camera. It's the light's
+    /// brightness, halved at its range and fading out past it.
+    /// \param[in] _brightness Light brightness, such as the mean of its
+    /// diffuse color components
+    /// \param[in] _range Attenuation range, 0 or less for infinite
+    /// \param[in] _distance Distance from the camera to the light
+    /// \return Importance, higher is more important
+    public: static double Importance(const double _brightness,
+        const double _range, const double _distance)
+    {
+      if (_range <= 0.0)
+        return _brightness;
+
+      double rangeSquared = _range * _range;
+      return _brightness * rangeSquared /
+          (rangeSquared + _distance * _distance);
+    }
+
+    /// \brief Score a light for this update. New lights count as enabled.
+    /// \param[in] _light Light id
+    /// \param[in] _importance Importance, see Importance
+    public: void Score(const unsigned int _light, const double _importance)
+    {
+      auto it = this->enabled.emplace(_light, true).first;
+      this->scores.emplace_back(
+          it->second ? _importance * kHysteresis : _importance, _light);
+    }
+
+    /// \brief Check if a light is enabled.
+    /// \param[in] _light Light id
+    /// \return True if enabled or unknown
+    public: bool Enabled(const unsigned int _light) const
+    {
+      auto it = this->enabled.find(_light);
+      return it == this->enabled.end() || it->second;
+    }
+
+    /// \brief Forget a light, such as a deleted one.
+    /// \param[in] _light Light id
+    public: void Remove(const unsigned int _light)
+    {
+      this->enabled.erase(_light);
+    }
+
+    /// \brief Rank the lights scored in this update and end it. The most
+    /// important ones up to the capacity are enabled, and the others are
+    /// disabled.
+    /// \return Lights which were enabled or disabled, paired with whether
+    /// they're now enabled
+    public: std::vector<std::pair<unsigned int, bool>> Select()
+    {
+      std::vector<std::pair<unsigned int, bool>> changed;
+      std::size_t keep = this->capacity == 0u ?
+          this->scores.size() : std::min(this->capacity, this->scores.size());
+
+      // Ties go to the lower id so the selection is stable
+      auto more = [](const std::pair<double, unsigned int> &_a,
+          const std::pair<double, unsigned int> &_b)
+      {
+        return _a.first > _b.first ||
+            (_a.first == _b.first && _a.second < _b.second);
+      };
+      if (keep < this->scores.size())
+      {
+        std::nth_element(this->scores.begin(), this->scores.begin() + keep,
+            this->scores.end(), more);
+      }
+
+      for (std::size_t i = 0u; i < this->scores.size(); ++i)
+      {
+        auto &state = this->enabled[this->scores[i].second];
+        bool on = i < keep;
+        if (state != on)
+        {
+          state = on;
+          changed.emplace_back(this->scores[i].second, on);
+        }
+      }
+      this->scores.clear();
+      return changed;
+    }
+
+    /// \brief Most lights enabled, 0 for no limit
+    private: std::size_t capacity{0u};
+
+    /// \brief Whether each known light is enabled
+    private: std::unordered_map<unsigned int, bool> enabled;
+
+    /// \brief Scores of the lights in this update, paired with their ids
+    private: std::vector<std::pair<double, unsigned int>> scores;
+  };
+}
+}
+}
+
+#endif
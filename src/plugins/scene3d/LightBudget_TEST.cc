@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "LightBudget.hh"
+
+using namespace ignition;
+using namespace gui;
+using namespace plugins;
+
+/////////////////////////////////////////////////
+TEST(LightBudgetTest, Importance)
+{
+  // Infinite range
+  EXPECT_DOUBLE_EQ(0.8, LightBudget::Importance(0.8, 0.0, 100.0));
+
+  // Halved at the range
+  EXPECT_DOUBLE_EQ(1.0, LightBudget::Importance(1.0, 10.0, 0.0));
+  EXPECT_DOUBLE_EQ(0.5, LightBudget::Importance(1.0, 10.0, 10.0));
+  EXPECT_GT(LightBudget::Importance(1.0, 10.0, 10.0),
+      LightBudget::Importance(1.0, 10.0, 20.0));
+}
+
+/////////////////////////////////////////////////
+TEST(LightBudgetTest, NoLimit)
+{
+  LightBudget budget;
+  EXPECT_EQ(0u, budget.Capacity());
+
+  budget.Score(1u, 1.0);
+  budget.Score(2u, 0.0);
+  EXPECT_TRUE(budget.Select().empty());
+  EXPECT_TRUE(budget.Enabled(1u));
+  EXPECT_TRUE(budget.Enabled(2u));
+  EXPECT_TRUE(budget.Enabled(3u));
+}
+
+/////////////////////////////////////////////////
+TEST(LightBudgetTest, MostImportant)
+{
+  LightBudget budget;
+  budget.SetCapacity(2u);
+  EXPECT_EQ(2u, budget.Capacity());
+
+  budget.Score(1u, 0.1);
+  budget.Score(2u, 0.5);
+  budget.Score(3u, 0.9);
+  auto changed = budget.Select();
+  ASSERT_EQ(1u, changed.size());
+  EXPECT_EQ(1u, changed[0].first);
+  EXPECT_FALSE(changed[0].second);
+  EXPECT_FALSE(budget.Enabled(1u));
+  EXPECT_TRUE(budget.Enabled(2u));
+  EXPECT_TRUE(budget.Enabled(3u));
+
+  // Slightly more important isn't enough to swap
+  budget.Score(1u, 0.55);
+  budget.Score(2u, 0.5);
+  budget.Score(3u, 0.9);
+  EXPECT_TRUE(budget.Select().empty());
+
+  // Much more important is
+  budget.Score(1u, 0.7);
+  budget.Score(2u, 0.5);
+  budget.Score(3u, 0.9);
+  changed = budget.Select();
+  ASSERT_EQ(2u, changed.size());
+  EXPECT_TRUE(budget.Enabled(1u));
+  EXPECT_FALSE(budget.Enabled(2u));
+
+  // Removed lights free their place
+  budget.Remove(3u);
+  budget.Score(1u, 0.7);
+  budget.Score(2u, 0.5);
+  changed = budget.Select();
+  ASSERT_EQ(1u, changed.size());
+  EXPECT_EQ(2u, changed[0].first);
+  EXPECT_TRUE(changed[0].second);
+}
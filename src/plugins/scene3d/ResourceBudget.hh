@@ -0,0 +1,255 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGNITION_GUI_PLUGINS_SCENE3D_RESOURCEBUDGET_HH_
+#define IGNITION_GUI_PLUGINS_SCENE3D_RESOURCEBUDGET_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace ignition
+{
+namespace gui
+{
+namespace plugins
+{
+  /// \brief Keeps the memory taken by the meshes and textures of a scene
+  /// under a cap, by telling which owners, such as top level models, to
+  /// evict. The owners which were seen least recently go first.
+  ///
+  /// Resources are shared: one used by several owners is only counted
+  /// once, and only stops counting when all of them were evicted.
+  ///
+  /// Each update, the owners which can be seen are touched, then Evict
+  /// picks the ones to release. Owners touched since the last Evict are
+  /// never picked. Evicted owners use their resources again by calling
+  /// Restore and then Use.
+  class ResourceBudget
+  {
+    /// \brief Set the most bytes taken by the resources of owners which
+    /// weren't evicted.
+    /// \param[in] _bytes Capacity, 0 for no limit
+    public: void SetCapacity(const std::size_t _bytes)
+    {
+      this->capacity = _bytes;
+    }
+
+    /// \brief Get the most bytes taken by resources.
+    /// \return Capacity, 0 for no limit
+    public: std::size_t Capacity() const
+    {
+      return this->capacity;
+    }
+
+    /// \brief Get the bytes taken by the resources of owners which weren't
+    /// evicted.
+    /// \return Bytes used
+    public: std::size_t Used() const
+    {
+      return this->used;
+    }
+
+    /// \brief Record that an owner uses a resource. Using it again from the
+    /// same owner is a no-op.
+    /// \param[in] _owner Owner id
+    /// \param[in] _resource Resource name, such as a file name
+    /// \param[in] _bytes Memory taken by the resource
+    public: void Use(const unsigned int _owner, const std::string &_resource,
+        const std::size_t _bytes)
+    {
+      auto &owner = this->Owner(_owner);
+      if (owner.evicted || !owner.resources.insert(_resource).second)
+        return;
+
+      auto &resource = this->resources[_resource];
+      if (resource.users++ == 0u)
+      {
+        resource.bytes = _bytes;
+        this->used += _bytes;
+      }
+    }
+
+    /// \brief Mark an owner as seen in this update, so it's kept.
+    /// \param[in] _owner Owner id
+    public: void Touch(const unsigned int _owner)
+    {
+      auto it = this->owners.find(_owner);
+      if (it == this->owners.end() || it->second.evicted)
+        return;
+
+      it->second.lastSeen = this->frame;
+      this->order.splice(this->order.end(), this->order, it->second.position);
+    }
+
+    /// \brief Check if an owner's resources were evicted.
+    /// \param[in] _owner Owner id
+    /// \return True if evicted and not restored since
+    public: bool Evicted(const unsigned int _owner) const
+    {
+      auto it = this->owners.find(_owner);
+      return it != this->owners.end() && it->second.evicted;
+    }
+
+    /// \brief Check if a resource is used by any owner which wasn't
+    /// evicted.
+    /// \param[in] _resource Resource name
+    /// \return True if it's counted in Used
+    public: bool InUse(const std::string &_resource) const
+    {
+      return this->resources.find(_resource) != this->resources.end();
+    }
+
+    /// \brief Start tracking an evicted owner again, before it uses its
+    /// resources again. It counts as seen in this update.
+    /// \param[in] _owner Owner id
+    public: void Restore(const unsigned int _owner)
+    {
+      auto it = this->owners.find(_owner);
+      if (it == this->owners.end() || !it->second.evicted)
+        return;
+
+      it->second.evicted = false;
+      it->second.lastSeen = this->frame;
+      it->second.position = this->order.insert(this->order.end(), _owner);
+    }
+
+    /// \brief Forget an owner, such as a deleted model, releasing its
+    /// resources.
+    /// \param[in] _owner Owner id
+    public: void Remove(const unsigned int _owner)
+    {
+      auto it = this->owners.find(_owner);
+      if (it == this->owners.end())
+        return;
+
+      if (!it->second.evicted)
+      {
+        this->Release(it->second);
+        this->order.erase(it->second.position);
+      }
+      this->owners.erase(it);
+    }
+
+    /// \brief Pick the owners to evict so that the resources fit in the
+    /// capacity, least recently seen first, and end the update. Owners
+    /// touched in this update are kept even if that's over capacity.
+    /// \return Owners to release the resources of, which now count as
+    /// evicted
+    public: std::vector<unsigned int> Evict()
+    {
+      std::vector<unsigned int> evicted;
+      while (this->capacity > 0u && this->used > this->capacity &&
+          !this->order.empty())
+      {
+        auto &owner = this->owners[this->order.front()];
+        if (owner.lastSeen == this->frame)
+          break;
+
+        evicted.push_back(this->order.front());
+        this->order.pop_front();
+        owner.evicted = true;
+        this->Release(owner);
+      }
+      ++this->frame;
+      return evicted;
+    }
+
+    /// \brief What's known about an owner
+    private: struct OwnerInfo
+    {
+      /// \brief Resources used
+      std::unordered_set<std::string> resources;
+
+      /// \brief Update the owner was last seen in
+      std::uint64_t lastSeen{0u};
+
+      /// \brief Position in the order, if not evicted
+      std::list<unsigned int>::iterator position;
+
+      /// \brief True once its resources were released
+      bool evicted{false};
+    };
+
+    /// \brief What's known about a resource
+    private: struct ResourceInfo
+    {
+      /// \brief Memory taken
+      std::size_t bytes{0u};
+
+      /// \brief Owners which use it and weren't evicted
+      unsigned int users{0u};
+    };
+
+    /// \brief Get an owner, adding it if it's new.
+    /// \param[in] _owner Owner id
+    /// \return Owner
+    private: OwnerInfo &Owner(const unsigned int _owner)
+    {
+      auto it = this->owners.find(_owner);
+      if (it != this->owners.end())
+        return it->second;
+
+      auto &owner = this->owners[_owner];
+      owner.lastSeen = this->frame;
+      owner.position = this->order.insert(this->order.end(), _owner);
+      return owner;
+    }
+
+    /// \brief Stop counting the resources of an owner.
+    /// \param[in,out] _owner Owner, whose resources are cleared
+    private: void Release(OwnerInfo &_owner)
+    {
+      for (const auto &name : _owner.resources)
+      {
+        auto it = this->resources.find(name);
+        if (it == this->resources.end() || --it->second.users > 0u)
+          continue;
+
+        this->used -= it->second.bytes;
+        this->resources.erase(it);
+      }
+      _owner.resources.clear();
+    }
+
+    /// \brief Most bytes used, 0 for no limit
+    private: std::size_t capacity{0u};
+
+    /// \brief Bytes used
+    private: std::size_t used{0u};
+
+    /// \brief Number of the current update
+    private: std::uint64_t frame{0u};
+
+    /// \brief Owners by id
+    private: std::unordered_map<unsigned int, OwnerInfo> owners;
+
+    /// \brief Owners which weren't evicted, least recently seen first
+    private: std::list<unsigned int> order;
+
+    /// \brief Resources in use, by name
+    private: std::unordered_map<std::string, ResourceInfo> resources;
+  };
+}
+}
+}
+
+#endif
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "ResourceBudget.hh"
+
+using namespace ignition;
+using namespace gui;
+using namespace plugins;
+
+/////////////////////////////////////////////////
+TEST(ResourceBudgetTest, SharedResources)
+{
+  ResourceBudget budget;
+  EXPECT_EQ(0u, budget.Capacity());
+  EXPECT_EQ(0u, budget.Used());
+
+  // Shared resources are counted once
+  budget.Use(1u, "box.dae", 100u);
+  budget.Use(1u, "box.dae", 100u);
+  budget.Use(2u, "box.dae", 100u);
+  budget.Use(2u, "box.png", 50u);
+  EXPECT_EQ(150u, budget.Used());
+
+  // No limit
+  EXPECT_TRUE(budget.Evict().empty());
+
+  // Until all their users are gone
+  budget.Remove(1u);
+  EXPECT_EQ(150u, budget.Used());
+  EXPECT_TRUE(budget.InUse("box.dae"));
+  budget.Remove(2u);
+  EXPECT_EQ(0u, budget.Used());
+  EXPECT_FALSE(budget.InUse("box.dae"));
+  EXPECT_FALSE(budget.InUse("box.png"));
+  budget.Remove(3u);
+}
+
+/////////////////////////////////////////////////
+TEST(ResourceBudgetTest, LeastRecentlySeen)
+{
+  ResourceBudget budget;
+  budget.SetCapacity(250u);
+  EXPECT_EQ(250u, budget.Capacity());
+
+  budget.Use(1u, "a", 100u);
+  budget.Use(2u, "b", 100u);
+  budget.Use(3u, "c", 100u);
+
+  // Everything was just seen, so it's all kept
+  EXPECT_TRUE(budget.Evict().empty());
+  EXPECT_EQ(300u, budget.Used());
+
+  // The least recently seen goes first
+  budget.Touch(1u);
+  budget.Touch(3u);
+  auto evicted = budget.Evict();
+  ASSERT_EQ(1u, evicted.size());
+  EXPECT_EQ(2u, evicted[0]);
+  EXPECT_TRUE(budget.Evicted(2u));
+  EXPECT_FALSE(budget.Evicted(1u));
+  EXPECT_EQ(200u, budget.Used());
+
+  // Evicted owners don't count until restored
+  budget.Use(2u, "b", 100u);
+  budget.Touch(2u);
+  EXPECT_EQ(200u, budget.Used());
+
+  budget.Restore(2u);
+  EXPECT_FALSE(budget.Evicted(2u));
+  budget.Use(2u, "b", 100u);
+  budget.Touch(3u);
+  evicted = budget.Evict();
+  ASSERT_EQ(1u, evicted.size());
+  EXPECT_EQ(1u, evicted[0]);
+  EXPECT_EQ(200u, budget.Used());
+
+  // Removing evicted owners is fine
+  budget.Remove(1u);
+  EXPECT_FALSE(budget.Evicted(1u));
+  EXPECT_EQ(200u, budget.Used());
+}
+
+/////////////////////////////////////////////////
+TEST(ResourceBudgetTest, KeepSeen)
+{
+  ResourceBudget budget;
+  budget.SetCapacity(100u);
+
+  budget.Use(1u, "a", 100u);
+  budget.Use(2u, "b", 100u);
+  budget.Evict();
+
+  // Over capacity, but both can be seen
+  budget.Touch(1u);
+  budget.Touch(2u);
+  EXPECT_TRUE(budget.Evict().empty());
+  EXPECT_EQ(200u, budget.Used());
+
+  // Evicting one owner is enough
+  budget.Touch(2u);
+  auto evicted = budget.Evict();
+  ASSERT_EQ(1u, evicted.size());
+  EXPECT_EQ(1u, evicted[0]);
+  EXPECT_EQ(100u, budget.Used());
+}
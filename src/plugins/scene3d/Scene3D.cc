@@ -17,18 +17,49 @@
 
 #include "Scene3D.hh"
 
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <limits>
 #include <map>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+#include <QImageReader>
+#include <QScreen>
+
 #include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
+#include <ignition/common/Material.hh>
+#include <ignition/common/Mesh.hh>
 #include <ignition/common/MouseEvent.hh>
 #include <ignition/plugin/Register.hh>
 #include <ignition/common/MeshManager.hh>
+#include <ignition/common/SubMesh.hh>
+#include <ignition/common/Util.hh>
 
+#include <ignition/math/AxisAlignedBox.hh>
+#include <ignition/math/Frustum.hh>
+#include <ignition/math/Helpers.hh>
 #include <ignition/math/Vector2.hh>
 #include <ignition/math/Vector3.hh>
 
@@ -40,11 +71,14 @@
 #include <ignition/msgs.hh>
 
 #include <ignition/rendering/Camera.hh>
+#include <ignition/rendering/Material.hh>
+#include <ignition/rendering/Mesh.hh>
 #include <ignition/rendering/OrbitViewController.hh>
 #include <ignition/rendering/RayQuery.hh>
 #include <ignition/rendering/RenderEngine.hh>
 #include <ignition/rendering/RenderingIface.hh>
 #include <ignition/rendering/Scene.hh>
+#include <ignition/rendering/SubMesh.hh>
 
 #ifdef _MSC_VER
 #pragma warning(pop)
@@ -54,8 +88,22 @@
 
 #include "ignition/gui/Application.hh"
 #include "ignition/gui/Conversions.hh"
+#include "ignition/gui/EventBus.hh"
 #include "ignition/gui/GuiEvents.hh"
 #include "ignition/gui/MainWindow.hh"
+#include "ignition/gui/PoseCodec.hh"
+#include "ignition/gui/SceneIndex.hh"
+#include "ignition/gui/RenderHooks.hh"
+
+#include "AsyncMeshLoader.hh"
+#include "EntityTable.hh"
+#include "FrameCapture.hh"
+#include "FrameTimings.hh"
+#include "LightBudget.hh"
+#include "ResourceBudget.hh"
+#ifdef HAVE_IGN_COMMON_AV
+#include "VideoRecorder.hh"
+#endif
 
 namespace ignition
 {
@@ -63,6 +111,72 @@ namespace gui
 {
 namespace plugins
 {
+  /// \brief Highest anti-aliasing level, used unless the resolution is
+  /// being adapted to a target frame time.
+  static const unsigned int kMaxAntiAliasing{8u};
+
+  /// \brief Lock-free triple buffer holding the latest pose of each entity.
+  /// A single transport thread writes to it and the render thread reads from
+  /// it, and neither side ever blocks the other. Poses which the reader
+  /// didn't get to are carried over, so only the newest sample per entity is
+  /// delivered.
+  class PoseBuffer
+  {
+    /// \brief A pose as received
+    public: struct Sample
+    {
+      /// \brief Entity pose
+      math::Pose3d pose;
+
+      /// \brief Simulation time in seconds from the msg header, zero if the
+      /// msg wasn't stamped
+      double stamp;
+
+      /// \brief Time the msg was received
+      std::chrono::steady_clock::time_point received;
+    };
+
+    /// \brief Map of entity id to pose
+    public: using Poses = std::unordered_map<unsigned int, Sample>;
+
+    /// \brief Writer side. Store the poses in a message and publish them to
+    /// the reader.
+    /// \param[in] _msg Pose vector msg
+    public: void Write(const msgs::Pose_V &_msg);
+
+    /// \brief Writer side. Store decoded poses and publish them to the
+    /// reader.
+    /// \param[in] _ids Entity ids
+    /// \param[in] _poses Pose of each entity
+    /// \param[in] _stamp Simulation time in seconds, zero if unknown
+    public: void Write(const std::vector<unsigned int> &_ids,
+                       const std::vector<math::Pose3d> &_poses,
+                       double _stamp);
+
+    /// \brief Reader side. Get the poses published since the last read.
+    /// \return Pointer to the new poses, or null if nothing was published
+    /// since the last call. The poses are valid until the next call.
+    public: const Poses *Read();
+
+    /// \brief Writer side. Publish the writer's buffer to the reader.
+    private: void Publish();
+
+    /// \brief Bit set on the shared index when it holds unread poses
+    private: static constexpr unsigned int kFresh{4u};
+
+    /// \brief The three buffers
+    private: std::array<Poses, 3> slots;
+
+    /// \brief Index of the buffer owned by the writer
+    private: unsigned int writeIdx{0u};
+
+    /// \brief Index of the buffer owned by the reader
+    private: unsigned int readIdx{1u};
+
+    /// \brief Index of the buffer in transit, plus the kFresh bit
+    private: std::atomic<unsigned int> shared{2u};
+  };
+
   /// \brief Scene manager class for loading and managing objects in the scene
   class SceneManager
   {
@@ -93,19 +207,124 @@ namespace plugins
                       const std::string &_sceneTopic,
                       rendering::ScenePtr _scene);
 
-    /// \brief Make the scene service request and populate the scene
+    /// \brief Make the scene service request and populate the scene. This
+    /// doesn't block, the request is retried from Update until the service
+    /// responds.
     public: void Request();
 
-    /// \brief Update the scene based on pose msgs received
-    public: void Update();
+    /// \brief Whether the scene was requested and the service didn't
+    /// respond yet. Can be called from any thread.
+    /// \return True while loading
+    public: bool Loading() const;
+
+    /// \brief A camera looking at the scene
+    public: struct View
+    {
+      /// \brief Camera frustum
+      math::Frustum frustum;
+
+      /// \brief Image width divided by the frustum width at unit distance,
+      /// i.e. pixels covered by an object of unit size at unit distance.
+      double pixelScale;
+    };
+
+    /// \brief Set whether to hold back the poses of top level models which
+    /// can't be seen by any view, because they're off-screen or too small to
+    /// cover a pixel. Must be set before the scene is loaded.
+    /// \param[in] _enabled True to cull poses
+    public: void SetViewCulling(const bool _enabled);
+
+    /// \brief Set the most memory taken by the meshes and textures of top
+    /// level models. Past it, the models which weren't seen for the longest
+    /// lose their meshes until they come into view again. Needs view
+    /// culling, and must be set before the scene is loaded.
+    /// \param[in] _bytes Budget, zero for no limit
+    public: void SetResourceBudget(const std::size_t _bytes);
+
+    /// \brief Set the most point and spot lights enabled at once. Each
+    /// update, the lights are ranked by their brightness, range and
+    /// distance to the nearest view, and the least important ones are taken
+    /// off the scene graph. Directional lights are always enabled. Must be
+    /// set before the scene is loaded.
+    /// \param[in] _count Budget, zero for no limit
+    public: void SetLightBudget(const std::size_t _count);
+
+    /// \brief Set whether to keep a snapshot of the scene on disk. The last
+    /// snapshot is shown right away by Request, and reconciled with the
+    /// service response once it arrives. Must be set before Request.
+    /// \param[in] _enabled True to use the scene cache
+    public: void SetSceneCache(const bool _enabled);
+
+    /// \brief Set whether to interpolate between the last two poses of each
+    /// entity instead of showing the latest one. Entities are shown about
+    /// one publish interval in the past, and extrapolated for a bounded time
+    /// when poses are late. Only stamped pose msgs are interpolated.
+    /// \param[in] _enabled True to interpolate poses
+    public: void SetInterpolatePoses(const bool _enabled);
+
+    /// \brief Set whether the pose topic carries frames made by a
+    /// PoseEncoder, as ignition::msgs::Bytes, instead of pose vector msgs.
+    /// \param[in] _enabled True for compact poses
+    public: void SetCompactPoses(const bool _enabled);
+
+    /// \brief Update the scene based on the msgs received. Poses and
+    /// deletions are always applied, then new entities are loaded and
+    /// deleted ones are destroyed until the budget runs out. Whatever is
+    /// left is carried over to the next call.
+    /// \param[in] _budget Time to spend, zero for no limit.
+    /// \param[in] _views Cameras looking at the scene, used when view
+    /// culling is enabled. Nothing is culled if empty.
+    /// \return True if anything in the scene changed, or if there's work
+    /// left over.
+    public: bool Update(const std::chrono::steady_clock::duration &_budget,
+                        const std::vector<View> &_views);
+
+    /// \brief Number of poses which the last update didn't write to the
+    /// scene graph, because they were the same as the last ones written.
+    /// \return Skipped writes
+    public: std::size_t SkippedWrites() const;
 
     /// \brief Callback function for the pose topic
     /// \param[in] _msg Pose vector msg
     private: void OnPoseVMsg(const msgs::Pose_V &_msg);
 
-    /// \brief Load the scene from a scene msg
-    /// \param[in] _msg Scene msg
-    private: void LoadScene(const msgs::Scene &_msg);
+    /// \brief Callback function for the pose topic with compact poses
+    /// \param[in] _msg Frame made by a PoseEncoder
+    private: void OnCompactPoseMsg(const msgs::Bytes &_msg);
+
+    /// \brief Stage a pose for an entity, keeping the view culling bounds
+    /// up to date.
+    /// \param[in] _id Entity id
+    /// \param[in] _pose New pose
+    /// \param[in] _cull True if view culling is active in this update
+    /// \return False if the entity isn't loaded
+    private: bool StagePose(const unsigned int _id, const math::Pose3d &_pose,
+        const bool _cull);
+
+    /// \brief Fold newly received poses into the pose histories and move
+    /// the playback clock forward.
+    /// \param[in] _poses Poses received since the last update, may be null
+    private: void UpdatePlayback(const PoseBuffer::Poses *_poses);
+
+    /// \brief Load a top level model from a scene msg. Models which are
+    /// already loaded and didn't change are skipped, those which changed are
+    /// updated in place if only their pose changed, or reloaded otherwise.
+    /// \param[in] _msg Model msg
+    /// \return True if anything in the scene changed.
+    private: bool LoadSceneModel(const msgs::Model &_msg);
+
+    /// \brief Load a top level light from a scene msg, skipping unchanged
+    /// lights like LoadSceneModel.
+    /// \param[in] _msg Light msg
+    /// \return True if anything in the scene changed.
+    private: bool LoadSceneLight(const msgs::Light &_msg);
+
+    /// \brief Compute a hash of a msg, used to tell if an entity needs to be
+    /// reloaded.
+    /// \param[in] _msg Model or light msg, with its pose cleared
+    /// \return Hash of the serialized msg
+    private: static std::size_t Signature(
+        const google::protobuf::Message &_msg);
 
     /// \brief Callback function for the request topic
     /// \param[in] _msg Deletion message
@@ -134,6 +353,84 @@ namespace plugins
     /// \return Visual visual created from the msg
     private: rendering::VisualPtr LoadVisual(const msgs::Visual &_msg);
 
+    /// \brief Remember which top level model an entity belongs to, while
+    /// view culling.
+    /// \param[in] _id Entity id
+    private: void TrackModelEntity(const unsigned int _id);
+
+    /// \brief Add an entity to the scene index, as a child of the entity
+    /// being loaded.
+    /// \param[in] _id Entity id
+    /// \param[in] _name Entity name
+    /// \param[in] _kind Kind of entity
+    /// \param[in] _node Rendering node of the entity
+    private: void IndexEntity(const unsigned int _id, const std::string &_name,
+                              SceneEntity::Kind _kind,
+                              const rendering::NodePtr &_node);
+
+    /// \brief Compute the bounding radius of a top level model
+    /// \param[in] _id Model id
+    private: void UpdateModelBounds(const unsigned int _id);
+
+    /// \brief Request the scene if the service is available, and schedule
+    /// the next try otherwise.
+    private: void TryRequest();
+
+    /// \brief Path of the snapshot file for the scene service
+    /// \return Snapshot path
+    private: std::string SnapshotPath() const;
+
+    /// \brief Queue the last snapshot of the scene to be loaded, if there's
+    /// one.
+    private: void LoadSnapshot();
+
+    /// \brief Replace the snapshot of the scene on disk
+    /// \param[in] _msg Scene msg received from the service
+    private: void SaveSnapshot(const msgs::Scene &_msg) const;
+
+    /// \brief Check if a sphere can be seen by any view
+    /// \param[in] _center Sphere center
+    /// \param[in] _radius Sphere radius
+    /// \param[in] _views Views to check
+    /// \return True if it's in a view frustum and large enough to matter
+    private: static bool Visible(const math::Vector3d &_center,
+        const double _radius, const std::vector<View> &_views);
+
+    /// \brief Add the geometry and material of a visual msg to its visual
+    /// \param[in] _msg Visual msg
+    /// \param[in] _visual Visual created for the msg
+    private: void LoadVisualGeometry(const msgs::Visual &_msg,
+        const rendering::VisualPtr &_visual);
+
+    /// \brief Give visuals their mesh once it's been loaded in the
+    /// background.
+    /// \return True if any visual changed.
+    private: bool LoadPendingMeshes();
+
+    /// \brief Count a mesh and its textures against the resource budget.
+    /// \param[in] _model Top level model using the mesh
+    /// \param[in] _filename Mesh file, loaded in common::MeshManager
+    private: void BudgetMesh(const unsigned int _model,
+        const std::string &_filename);
+
+    /// \brief Take the meshes of a top level model off its visuals and
+    /// destroy them, to stay within the resource budget. Meshes no other
+    /// model counts against the budget are removed from
+    /// common::MeshManager.
+    /// \param[in] _model Model id
+    private: void EvictModel(const unsigned int _model);
+
+    /// \brief Give an evicted top level model its meshes back, loading
+    /// them in the background if needed.
+    /// \param[in] _model Model id
+    private: void RestoreModel(const unsigned int _model);
+
+    /// \brief Enable the most important lights within the light budget,
+    /// and disable the others.
+    /// \param[in] _views Cameras looking at the scene
+    /// \return True if any light was enabled or disabled
+    private: bool UpdateLightBudget(const std::vector<View> &_views);
+
     /// \brief Load a geometry from a geometry msg
     /// \param[in] _msg Geometry msg
     /// \param[out] _scale Geometry scale that will be set based on msg param
@@ -145,18 +442,70 @@ namespace plugins
 
     /// \brief Load a material from a material msg
     /// \param[in] _msg Material msg
+    /// \param[in] _name Name to give the material, leave empty to have one
+    /// generated
     /// \return Material object created from the msg
-    private: rendering::MaterialPtr LoadMaterial(const msgs::Material &_msg);
+    private: rendering::MaterialPtr LoadMaterial(const msgs::Material &_msg,
+        const std::string &_name = "");
+
+    /// \brief Get the material for a visual msg. Materials are named after a
+    /// hash of their properties, so that all visuals in a scene which look
+    /// the same share one material, even across Scene3D instances rendering
+    /// the same scene.
+    /// \param[in] _msg Visual msg
+    /// \return Material, owned by the scene
+    private: rendering::MaterialPtr SharedMaterial(const msgs::Visual &_msg);
+
+    /// \brief Make a mesh use the materials shared by all instances of the
+    /// same mesh file with the same transparency, instead of copies of its
+    /// own. The first instance's materials are cloned into the shared ones.
+    /// Vertex buffers are already shared by the render engine for meshes
+    /// of the same name, so repeated meshes then don't duplicate any GPU
+    /// resources.
+    /// \param[in] _msg Visual msg of the mesh
+    /// \param[in] _geom Mesh geometry created for the visual
+    private: void ShareMeshMaterials(const msgs::Visual &_msg,
+        const rendering::GeometryPtr &_geom);
 
     /// \brief Load a light from a light msg
     /// \param[in] _msg Light msg
     /// \return Light object created from the msg
     private: rendering::LightPtr LoadLight(const msgs::Light &_msg);
 
-    /// \brief Delete an entity
+    /// \brief Delete an entity. It's removed from the scene graph right
+    /// away and its resources are released later by ReleaseDeleted.
     /// \param[in] _entity Entity to delete
     private: void DeleteEntity(const unsigned int _entity);
 
+    /// \brief Delete many entities at once, compacting the entity tables in
+    /// a single sweep.
+    /// \param[in] _entities Entities to delete
+    private: void DeleteEntities(
+        const std::unordered_set<unsigned int> &_entities);
+
+    /// \brief Drop deleted models and lights which are still waiting in
+    /// pendingScenes, and the meshes waiting in pendingMeshes for visuals
+    /// which were taken out of the scene graph.
+    /// \param[in] _entities Deleted entities
+    private: void DropPendingLoads(
+        const std::unordered_set<unsigned int> &_entities);
+
+    /// \brief Take a visual or light out of the scene graph and queue it to
+    /// be destroyed.
+    /// \param[in] _entity Entity to detach
+    /// \return False if the entity isn't loaded
+    private: bool DetachEntity(const unsigned int _entity);
+
+    /// \brief Forget what's known about top level models and lights which
+    /// were deleted, other than their table entries.
+    /// \param[in] _entity Deleted entity
+    private: void ForgetEntity(const unsigned int _entity);
+
+    /// \brief Destroy detached visuals and lights
+    /// \param[in] _outOfTime Returns true when it's time to stop. At least
+    /// one node is destroyed regardless.
+    private: void ReleaseDeleted(const std::function<bool()> &_outOfTime);
+
     //// \brief Ign-transport scene service name
     private: std::string service;
 
@@ -172,23 +521,41 @@ namespace plugins
     //// \brief Pointer to the rendering scene
     private: rendering::ScenePtr scene;
 
-    //// \brief Mutex to protect the pose msgs
+    //// \brief Mutex to protect the scene and deletion msgs
     private: std::mutex mutex;
 
-    /// \brief Map of entity id to pose
-    private: std::map<unsigned int, math::Pose3d> poses;
+    /// \brief Latest poses received from the pose topic
+    private: PoseBuffer poseBuffer;
+
+    /// \brief Whether the pose topic carries compact poses
+    private: bool compactPoses{false};
+
+    /// \brief Decodes compact poses, only used by the transport thread
+    private: PoseDecoder poseDecoder;
+
+    /// \brief Ids decoded from the last compact pose frame
+    private: std::vector<unsigned int> decodedIds;
 
-    /// \brief Map of entity id to initial local poses
-    /// This is currently used to handle the normal vector in plane visuals. In
-    /// general, this can be used to store any local transforms between the
-    /// parent Visual and geometry.
-    private: std::map<unsigned int, math::Pose3d> localPoses;
+    /// \brief Poses decoded from the last compact pose frame
+    private: std::vector<math::Pose3d> decodedPoses;
 
-    /// \brief Map of visual id to visual pointers.
-    private: std::map<unsigned int, rendering::VisualPtr::weak_type> visuals;
+    /// \brief Visuals by entity id. Their local poses hold initial local
+    /// transforms between the parent Visual and geometry, used for example
+    /// to handle the normal vector in plane visuals.
+    private: EntityTable<rendering::VisualPtr::weak_type> visuals;
 
-    /// \brief Map of light id to light pointers.
-    private: std::map<unsigned int, rendering::LightPtr::weak_type> lights;
+    /// \brief Lights by entity id.
+    private: EntityTable<rendering::LightPtr::weak_type> lights;
+
+    /// \brief Poses skipped by the last update
+    private: std::size_t skippedWrites{0u};
+
+    /// \brief Hash of the msg each top level model was loaded from, minus
+    /// its pose, used to skip unchanged models in scene updates.
+    private: std::unordered_map<unsigned int, std::size_t> modelSignatures;
+
+    /// \brief Hash of the msg each light was loaded from, minus its pose.
+    private: std::unordered_map<unsigned int, std::size_t> lightSignatures;
 
     /// Entities to be deleted
     private: std::vector<unsigned int> toDeleteEntities;
@@ -196,6 +563,197 @@ namespace plugins
     /// \brief Keeps the a list of unprocessed scene messages
     private: std::vector<msgs::Scene> sceneMsgs;
 
+    /// \brief Deletions taken from toDeleteEntities and not done yet
+    private: std::deque<unsigned int> pendingDeletions;
+
+    /// \brief Visuals taken out of the scene graph and waiting to be
+    /// destroyed. They're still owned by the scene until then.
+    private: std::deque<rendering::VisualPtr::weak_type> releasedVisuals;
+
+    /// \brief Lights taken out of the scene graph and waiting to be
+    /// destroyed
+    private: std::deque<rendering::LightPtr::weak_type> releasedLights;
+
+    /// \brief Scene msgs taken from sceneMsgs and not fully loaded yet
+    private: std::deque<msgs::Scene> pendingScenes;
+
+    /// \brief Whether to keep a snapshot of the scene on disk
+    private: bool sceneCache{false};
+
+    /// \brief True from the scene request until the service responds
+    private: std::atomic<bool> loading{false};
+
+    /// \brief Set when the service request failed and should be retried
+    private: std::atomic<bool> requestFailed{false};
+
+    /// \brief True if a request is in flight
+    private: bool requestSent{false};
+
+    /// \brief True once the user was told the service isn't responding
+    private: bool requestWarned{false};
+
+    /// \brief Time the scene was first requested
+    private: std::chrono::steady_clock::time_point requestStart;
+
+    /// \brief Time of the next request try
+    private: std::chrono::steady_clock::time_point nextRequest;
+
+    /// \brief Time to wait after the next failed try
+    private: std::chrono::milliseconds requestInterval{0};
+
+    /// \brief Ids of the top level models and lights in the snapshot
+    /// loaded at startup, until the service response arrives. Protected by
+    /// mutex.
+    private: std::vector<unsigned int> snapshotIds;
+
+    /// \brief True if the service response arrived and the rest of the
+    /// snapshot shouldn't be loaded anymore. Protected by mutex.
+    private: bool snapshotSuperseded{false};
+
+    /// \brief True while the snapshot is at the front of pendingScenes
+    private: bool snapshotPending{false};
+
+    /// \brief Next model to load from the front of pendingScenes
+    private: int nextModel{0};
+
+    /// \brief Next light to load from the front of pendingScenes
+    private: int nextLight{0};
+
+    /// \brief Loads mesh files in the background
+    private: AsyncMeshLoader meshLoader;
+
+    /// \brief A visual waiting for its mesh
+    private: struct PendingMesh
+    {
+      /// \brief Visual showing a placeholder
+      rendering::VisualPtr::weak_type visual;
+
+      /// \brief Msg the visual was created from
+      msgs::Visual msg;
+    };
+
+    /// \brief Visuals waiting for their mesh, keyed by mesh file name
+    private: std::unordered_multimap<std::string, PendingMesh> pendingMeshes;
+
+    /// \brief What view culling knows about a top level model
+    private: struct ModelBounds
+    {
+      /// \brief Latest world position
+      math::Vector3d position;
+
+      /// \brief World position the model is shown at
+      math::Vector3d shownPosition;
+
+      /// \brief Radius around the model origin bounding all its visuals,
+      /// infinite if unknown
+      double radius;
+
+      /// \brief Meshes still being loaded for the model
+      unsigned int pendingMeshes;
+
+      /// \brief True if the model holds lights, which may light up visible
+      /// parts of the scene
+      bool lit;
+
+      /// \brief Whether the model was visible in the last update
+      bool visible;
+    };
+
+    /// \brief Whether poses of models which can't be seen are held back
+    private: bool viewCulling{false};
+
+    /// \brief Keeps the meshes and textures of top level models within a
+    /// budget, while view culling
+    private: ResourceBudget resourceBudget;
+
+    /// \brief Msgs of the mesh visuals of each top level model, to reload
+    /// them after eviction. Only kept with a resource budget.
+    private: std::unordered_map<unsigned int, std::vector<msgs::Visual>>
+        meshVisuals;
+
+    /// \brief Estimated bytes of each mesh file and texture, so files are
+    /// only measured once
+    private: std::unordered_map<std::string, std::size_t> resourceSizes;
+
+    /// \brief Keeps the number of enabled point and spot lights within a
+    /// budget
+    private: LightBudget lightBudget;
+
+    /// \brief What's needed to rank a light within the light budget
+    private: struct LightInfo
+    {
+      /// \brief Mean of the diffuse color components
+      double brightness;
+
+      /// \brief Attenuation range
+      double range;
+
+      /// \brief Node the light is attached to while enabled
+      rendering::NodePtr::weak_type parent;
+    };
+
+    /// \brief Point and spot lights which count towards the light budget.
+    /// Only kept with a light budget.
+    private: std::unordered_map<unsigned int, LightInfo> lightInfos;
+
+    /// \brief Top level model being loaded
+    private: unsigned int loadingModel{0u};
+
+    /// \brief Index of the entities of the scene, for other plugins
+    private: SceneIndex *index{nullptr};
+
+    /// \brief Ids of the entities whose children are being loaded, from
+    /// the top level down
+    private: std::vector<unsigned int> loadingParents;
+
+    /// \brief The last two stamped poses of an entity
+    private: struct PoseHistory
+    {
+      /// \brief Older pose
+      math::Pose3d from;
+
+      /// \brief Simulation time of the older pose
+      double fromStamp;
+
+      /// \brief Latest pose
+      math::Pose3d to;
+
+      /// \brief Simulation time of the latest pose
+      double toStamp;
+
+      /// \brief True while the entity is being interpolated or
+      /// extrapolated, false once it settled on its latest pose
+      bool moving;
+    };
+
+    /// \brief Whether poses are interpolated
+    private: bool interpolatePoses{false};
+
+    /// \brief Pose histories by entity id, while interpolating
+    private: std::unordered_map<unsigned int, PoseHistory> poseHistories;
+
+    /// \brief Simulation time being shown, negative until the first stamped
+    /// pose arrives
+    private: double playbackTime{-1.0};
+
+    /// \brief Time of the last playback clock update
+    private: std::chrono::steady_clock::time_point playbackUpdate;
+
+    /// \brief Smoothed interval between stamped pose msgs, in seconds
+    private: double publishInterval{0.0};
+
+    /// \brief Newest stamp received, in seconds
+    private: double latestStamp{0.0};
+
+    /// \brief Time the newest stamp was received
+    private: std::chrono::steady_clock::time_point latestReceived;
+
+    /// \brief Top level model of each entity, while view culling
+    private: std::unordered_map<unsigned int, unsigned int> topModels;
+
+    /// \brief Bounds of top level models, while view culling
+    private: std::unordered_map<unsigned int, ModelBounds> modelBounds;
+
     /// \brief Transport node for making service request and subscribing to
     /// pose topic
     private: ignition::transport::Node node;
@@ -204,18 +762,31 @@ namespace plugins
   /// \brief Private data class for IgnRenderer
   class IgnRendererPrivate
   {
-    /// \brief Flag to indicate if mouse event is dirty
-    public: bool mouseDirty = false;
+    /// \brief A mouse event waiting to be handled
+    public: struct MouseInput
+    {
+      /// \brief Mouse event
+      common::MouseEvent event;
 
-    /// \brief Mouse event
-    public: common::MouseEvent mouseEvent;
+      /// \brief Mouse move distance, or scroll amount
+      math::Vector2d drag;
+    };
 
-    /// \brief Mouse move distance since last event.
-    public: math::Vector2d drag;
+    /// \brief Mouse events received since the last frame. Consecutive
+    /// scrolls at the same position and drags with the same buttons are
+    /// merged into one.
+    public: std::vector<MouseInput> mouseEvents;
 
     /// \brief Mutex to protect mouse events
     public: std::mutex mutex;
 
+    /// \brief Screen position the view control target was computed for
+    public: math::Vector2i targetPos;
+
+    /// \brief True if target is still valid for targetPos, i.e. the camera
+    /// only zoomed since the target was computed.
+    public: bool targetValid = false;
+
     /// \brief User camera
     public: rendering::CameraPtr camera;
 
@@ -225,11 +796,124 @@ namespace plugins
     /// \brief Ray query for mouse clicks
     public: rendering::RayQueryPtr rayQuery;
 
-    /// \brief Scene requester to get scene info
-    public: SceneManager sceneManager;
-
     /// \brief View control focus target
     public: math::Vector3d target;
+
+    /// \brief Time when the last frame was rendered
+    public: std::chrono::steady_clock::time_point lastRenderTime;
+
+    /// \brief Timing of the last rendered frames
+    public: FrameTimings frameTimings;
+
+    /// \brief Time spent on the current frame until just before the render
+    /// event was sent
+    public: FrameTimings::Clock::duration frameTime;
+
+    /// \brief Time spent on mouse input for the current frame
+    public: FrameTimings::Clock::duration mouseTime;
+
+    /// \brief True if mouse input moved the camera since the last frame
+    public: bool viewChanged = false;
+
+    /// \brief Current fraction of the full resolution rendered
+    public: double resolutionScale = 1.0;
+
+    /// \brief Current anti-aliasing level
+    public: unsigned int antiAliasing = kMaxAntiAliasing;
+
+    /// \brief Size of the render texture
+    public: QSize renderSize;
+
+    /// \brief Moving average of the frame time in milliseconds
+    public: double avgFrameTime = 0.0;
+
+    /// \brief Frames since the resolution was last adapted
+    public: unsigned int framesSinceAdapt = 0u;
+  };
+
+  /// \brief Private data class for RenderThread
+  class RenderThreadPrivate
+  {
+    /// \brief A renderer drawn by the thread
+    public: struct Target
+    {
+      /// \brief The renderer, owned by the thread
+      IgnRenderer *renderer;
+
+      /// \brief True if the scene graph is done with the last texture
+      bool ready;
+
+      /// \brief True if the scene changed since this renderer's last frame
+      bool sceneChanged;
+
+      /// \brief Last time frame statistics were emitted
+      std::chrono::steady_clock::time_point lastFrameStats;
+
+      /// \brief Reads frames back while capturing, null otherwise
+      std::unique_ptr<FrameCapture> capture;
+
+      /// \brief Publisher of captured frames
+      transport::Node::Publisher capturePub;
+
+      /// \brief Last time a frame was captured
+      std::chrono::steady_clock::time_point lastCapture;
+
+      /// \brief Captured frame, reused so that capturing doesn't allocate
+      msgs::Image image;
+
+#ifdef HAVE_IGN_COMMON_AV
+      /// \brief Reads frames back for recording, null if not recording
+      std::unique_ptr<FrameCapture> recordCapture;
+
+      /// \brief Encodes recorded frames, null if not recording
+      std::unique_ptr<VideoRecorder> recorder;
+
+      /// \brief Last time a frame was read back for recording
+      std::chrono::steady_clock::time_point lastRecord;
+
+      /// \brief Recorded frame, reused so that recording doesn't allocate
+      msgs::Image recordImage;
+#endif
+    };
+
+    /// \brief Engine and scene name, the key of this thread in
+    /// RenderWindowItemPrivate::threads
+    public: std::string key;
+
+    /// \brief Renderers, in the order they were added
+    public: std::vector<Target> targets;
+
+    /// \brief Scene requester shared by all renderers
+    public: SceneManager sceneManager;
+
+    /// \brief True once the scene manager was loaded
+    public: bool sceneLoaded = false;
+
+    /// \brief True if a call to RenderNext is queued
+    public: bool scheduled = false;
+
+    /// \brief True if waiting to poll idle renderers again
+    public: bool polling = false;
+
+    /// \brief Shortest time between frames, zero to render as often as
+    /// the window shows them
+    /// \sa RenderOptions::targetFps
+    public: std::chrono::duration<double> framePeriod{0.0};
+
+    /// \brief Last time frames were rendered
+    public: std::chrono::steady_clock::time_point lastRender;
+
+    /// \brief True if waiting for the frame period to pass
+    public: bool pacing = false;
+
+    /// \brief Protects tasks
+    public: std::mutex mutex;
+
+    /// \brief Tasks posted from other threads
+    public: std::vector<std::function<void()>> tasks;
+
+    /// \brief Transport node for publishing captured frames
+    public: transport::Node node;
   };
 
   /// \brief Private data class for RenderWindowItem
@@ -238,11 +922,30 @@ namespace plugins
     /// \brief Keep latest mouse event
     public: common::MouseEvent mouseEvent;
 
+    /// \brief Renderer, owned by this item until it's added to the render
+    /// thread
+    public: IgnRenderer *ignRenderer = nullptr;
+
+    /// \brief True once the renderer was added to the render thread
+    public: bool attached = false;
+
     /// \brief Render thread
     public : RenderThread *renderThread = nullptr;
 
-    //// \brief List of threads
-    public: static QList<QThread *> threads;
+    /// \brief Render threads, keyed by engine and scene name
+    public: static std::map<std::string, RenderThread *> threads;
+
+    /// \brief Protects threads and the users count of each thread
+    public: static std::mutex threadsMutex;
+
+    /// \brief Latest frame timing statistics
+    public: QString frameStats;
+
+    /// \brief Whether frame statistics are shown
+    public: bool showFrameStats = false;
+
+    /// \brief Whether the scene is being loaded
+    public: bool loading = false;
   };
 
   /// \brief Private data class for Scene3D
@@ -257,7 +960,175 @@ using namespace ignition;
 using namespace gui;
 using namespace plugins;
 
-QList<QThread *> RenderWindowItemPrivate::threads;
+std::map<std::string, RenderThread *> RenderWindowItemPrivate::threads;
+std::mutex RenderWindowItemPrivate::threadsMutex;
+
+/// \brief Interval in milliseconds at which an idle render thread checks for
+/// changes when rendering on demand.
+static const int kIdlePollInterval{16};
+
+/// \brief Scale of the box shown while a mesh is loading
+static const math::Vector3d kPlaceholderSize{0.1, 0.1, 0.1};
+
+/// \brief Number of frames between changes to the resolution scale, so that
+/// the frame time settles in between.
+static const unsigned int kAdaptInterval{30u};
+
+/// \brief Factor by which the resolution scale changes in each step
+static const double kResolutionStep{0.8};
+
+/// \brief Size in pixels below which models aren't worth updating while view
+/// culling
+static const double kMinScreenSize{1.0};
+
+/// \brief First and longest interval between scene service request tries
+static const std::chrono::milliseconds kMinRequestRetry{250};
+static const std::chrono::milliseconds kMaxRequestRetry{8000};
+
+/// \brief Time after which a missing scene service is reported
+static const std::chrono::seconds kRequestWarnTime{30};
+
+/// \brief Longest time in seconds an entity is extrapolated past its latest
+/// pose before it's settled back on it
+static const double kMaxExtrapolation{0.1};
+
+/// \brief Delay of the playback clock behind the newest pose, in publish
+/// intervals. Over one so that there's usually a later pose to interpolate
+/// towards despite jitter.
+static const double kPlaybackDelay{1.5};
+
+/// \brief Fraction of the playback clock error corrected in each update
+static const double kPlaybackGain{0.1};
+
+/// \brief Playback clock error in seconds above which the clock jumps
+/// instead of catching up, for example when the simulation is reset
+static const double kMaxPlaybackError{0.5};
+
+/// \brief Thread priorities by name, as accepted by
+/// <render_thread_priority>
+static const std::map<std::string, QThread::Priority> kThreadPriorities{
+    {"idle", QThread::IdlePriority},
+    {"lowest", QThread::LowestPriority},
+    {"low", QThread::LowPriority},
+    {"normal", QThread::NormalPriority},
+    {"high", QThread::HighPriority},
+    {"highest", QThread::HighestPriority},
+    {"time_critical", QThread::TimeCriticalPriority}};
+
+#ifdef __linux__
+/// \brief Nice value matching a thread priority. Qt leaves threads of the
+/// default scheduling policy at the same nice value whatever the priority.
+/// \param[in] _priority Thread priority
+/// \return Nice value
+static int NiceValue(const QThread::Priority _priority)
+{
+  switch (_priority)
+  {
+    case QThread::IdlePriority:
+      return 19;
+    case QThread::LowestPriority:
+      return 10;
+    case QThread::LowPriority:
+      return 5;
+    case QThread::HighPriority:
+      return -5;
+    case QThread::HighestPriority:
+      return -10;
+    case QThread::TimeCriticalPriority:
+      return -15;
+    default:
+      return 0;
+  }
+}
+#endif
+
+/// \brief Remove the msgs whose id is in a set from a repeated field,
+/// keeping the order of the others.
+/// \param[in, out] _field Repeated model or light msgs
+/// \param[in] _start Index of the first msg which may be removed
+/// \param[in] _ids Ids of the msgs to remove
+template<typename T>
+static void RemoveIds(google::protobuf::RepeatedPtrField<T> &_field,
+    const int _start, const std::unordered_set<unsigned int> &_ids)
+{
+  int kept = _start;
+  for (int i = _start; i < _field.size(); ++i)
+  {
+    if (_ids.find(_field.Get(i).id()) != _ids.end())
+      continue;
+    if (kept != i)
+      _field.SwapElements(kept, i);
+    ++kept;
+  }
+  _field.DeleteSubrange(kept, _field.size() - kept);
+}
+
+/////////////////////////////////////////////////
+void PoseBuffer::Write(const msgs::Pose_V &_msg)
+{
+  double stamp = 0.0;
+  if (_msg.has_header() && _msg.header().has_stamp())
+  {
+    stamp = _msg.header().stamp().sec() +
+        _msg.header().stamp().nsec() * 1e-9;
+  }
+  auto received = std::chrono::steady_clock::now();
+
+  auto &poses = this->slots[this->writeIdx];
+  for (int i = 0; i < _msg.pose_size(); ++i)
+  {
+    poses[_msg.pose(i).id()] =
+        {msgs::Convert(_msg.pose(i)), stamp, received};
+  }
+  this->Publish();
+}
+
+/////////////////////////////////////////////////
+void PoseBuffer::Write(const std::vector<unsigned int> &_ids,
+    const std::vector<math::Pose3d> &_poses, double _stamp)
+{
+  auto received = std::chrono::steady_clock::now();
+
+  auto &poses = this->slots[this->writeIdx];
+  for (std::size_t i = 0; i < _ids.size(); ++i)
+    poses[_ids[i]] = {_poses[i], _stamp, received};
+  this->Publish();
+}
+
+/////////////////////////////////////////////////
+void PoseBuffer::Publish()
+{
+  // Publish our buffer and take whichever one was in transit
+  auto published = this->writeIdx;
+  auto prev = this->shared.exchange(published | kFresh);
+  this->writeIdx = prev & ~kFresh;
+
+  auto &next = this->slots[this->writeIdx];
+  if (prev & kFresh)
+  {
+    // The reader never got these, keep them but bring them up to date with
+    // the buffer we just published. The reader never modifies buffers, so
+    // it's safe to read from it even if the reader picked it up already.
+    for (const auto &pose : this->slots[published])
+      next[pose.first] = pose.second;
+  }
+  else
+  {
+    // The reader is done with this one
+    next.clear();
+  }
+}
+
+/////////////////////////////////////////////////
+const PoseBuffer::Poses *PoseBuffer::Read()
+{
+  if (!(this->shared.load() & kFresh))
+    return nullptr;
+
+  auto prev = this->shared.exchange(this->readIdx);
+  this->readIdx = prev & ~kFresh;
+  return &this->slots[this->readIdx];
+}
 
 /////////////////////////////////////////////////
 SceneManager::SceneManager()
@@ -286,122 +1157,548 @@ void SceneManager::Load(const std::string &_service,
   this->deletionTopic = _deletionTopic;
   this->sceneTopic = _sceneTopic;
   this->scene = _scene;
+
+  // Whatever was indexed belonged to a previous scene manager
+  if (this->scene)
+  {
+    this->index = &SceneIndex::Instance(this->scene->Name());
+    this->index->Clear();
+  }
 }
 
 /////////////////////////////////////////////////
 void SceneManager::Request()
 {
-  // wait for the service to be advertized
+  if (this->sceneCache)
+    this->LoadSnapshot();
+
+  this->loading = true;
+  this->requestStart = std::chrono::steady_clock::now();
+  this->requestInterval = kMinRequestRetry;
+  this->TryRequest();
+}
+
+/////////////////////////////////////////////////
+void SceneManager::TryRequest()
+{
+  auto now = std::chrono::steady_clock::now();
+
+  // Only ask once the service is advertised, the response comes
+  // asynchronously through OnSceneSrvMsg
   std::vector<transport::ServicePublisher> publishers;
-  const std::chrono::duration<double> sleepDuration{1.0};
-  const std::size_t tries = 30;
-  for (std::size_t i = 0; i < tries; ++i)
+  this->node.ServiceInfo(this->service, publishers);
+  if (!publishers.empty() &&
+      this->node.Request(this->service, &SceneManager::OnSceneSrvMsg, this))
   {
-    this->node.ServiceInfo(this->service, publishers);
-    if (publishers.size() > 0)
-      break;
-    std::this_thread::sleep_for(sleepDuration);
-    igndbg << "Waiting for service " << this->service << "\n";
+    this->requestSent = true;
+    return;
   }
 
-  if (publishers.empty() ||
-      !this->node.Request(this->service, &SceneManager::OnSceneSrvMsg, this))
+  igndbg << "Waiting for service " << this->service << std::endl;
+  if (!this->requestWarned && now - this->requestStart >= kRequestWarnTime)
   {
-    ignerr << "Error making service request to " << this->service << std::endl;
+    ignerr << "Error making service request to " << this->service
+           << ", will keep trying" << std::endl;
+    this->requestWarned = true;
   }
+
+  // Back off so a missing server doesn't cost anything
+  this->nextRequest = now + this->requestInterval;
+  this->requestInterval = std::min(this->requestInterval * 2,
+      kMaxRequestRetry);
 }
 
 /////////////////////////////////////////////////
-void SceneManager::OnPoseVMsg(const msgs::Pose_V &_msg)
+bool SceneManager::Loading() const
 {
-  std::lock_guard<std::mutex> lock(this->mutex);
-  for (int i = 0; i < _msg.pose_size(); ++i)
-  {
-    math::Pose3d pose = msgs::Convert(_msg.pose(i));
+  return this->loading;
+}
 
-    // apply additional local poses if available
-    const auto it = this->localPoses.find(_msg.pose(i).id());
-    if (it != this->localPoses.end())
-    {
-      pose = pose * it->second;
-    }
+/////////////////////////////////////////////////
+void SceneManager::SetViewCulling(const bool _enabled)
+{
+  this->viewCulling = _enabled;
+}
 
-    this->poses[_msg.pose(i).id()] = pose;
-  }
+/////////////////////////////////////////////////
+void SceneManager::SetResourceBudget(const std::size_t _bytes)
+{
+  this->resourceBudget.SetCapacity(_bytes);
 }
 
 /////////////////////////////////////////////////
-void SceneManager::OnDeletionMsg(const msgs::UInt32_V &_msg)
+void SceneManager::SetLightBudget(const std::size_t _count)
 {
-  std::lock_guard<std::mutex> lock(this->mutex);
-  std::copy(_msg.data().begin(), _msg.data().end(),
-            std::back_inserter(this->toDeleteEntities));
+  this->lightBudget.SetCapacity(_count);
 }
 
 /////////////////////////////////////////////////
-void SceneManager::Update()
+void SceneManager::SetSceneCache(const bool _enabled)
 {
-  // process msgs
-  std::lock_guard<std::mutex> lock(this->mutex);
+  this->sceneCache = _enabled;
+}
+
+/////////////////////////////////////////////////
+void SceneManager::SetInterpolatePoses(const bool _enabled)
+{
+  this->interpolatePoses = _enabled;
+}
+
+/////////////////////////////////////////////////
+void SceneManager::SetCompactPoses(const bool _enabled)
+{
+  this->compactPoses = _enabled;
+}
+
+/////////////////////////////////////////////////
+std::string SceneManager::SnapshotPath() const
+{
+  // The service name holds the world name, for example
+  // /world/shapes/scene/info
+  std::string name = this->service;
+  std::replace(name.begin(), name.end(), '/', '_');
+
+  std::string home;
+  common::env(IGN_HOMEDIR, home);
+  return common::joinPaths(home, ".ignition", "gui", "scene_cache",
+      name + ".scene");
+}
+
+/////////////////////////////////////////////////
+void SceneManager::LoadSnapshot()
+{
+  auto path = this->SnapshotPath();
+  std::ifstream in(path, std::ios::binary);
+  if (!in)
+    return;
 
-  for (const auto &msg : this->sceneMsgs)
+  msgs::Scene snapshot;
+  if (!snapshot.ParseFromIstream(&in))
   {
-    this->LoadScene(msg);
+    ignwarn << "Ignoring corrupt scene snapshot [" << path << "]"
+            << std::endl;
+    return;
   }
-  this->sceneMsgs.clear();
+  igndbg << "Loading scene snapshot [" << path << "]" << std::endl;
 
-  for (const auto &entity : this->toDeleteEntities)
   {
-    this->DeleteEntity(entity);
+    std::lock_guard<std::mutex> lock(this->mutex);
+    for (int i = 0; i < snapshot.model_size(); ++i)
+      this->snapshotIds.push_back(snapshot.model(i).id());
+    for (int i = 0; i < snapshot.light_size(); ++i)
+      this->snapshotIds.push_back(snapshot.light(i).id());
   }
-  this->toDeleteEntities.clear();
 
+  // Nothing else was received yet, so the snapshot goes first
+  this->pendingScenes.push_front(std::move(snapshot));
+  this->nextModel = 0;
+  this->nextLight = 0;
+  this->snapshotPending = true;
+}
+
+/////////////////////////////////////////////////
+void SceneManager::SaveSnapshot(const msgs::Scene &_msg) const
+{
+  auto path = this->SnapshotPath();
+  common::createDirectories(common::parentPath(path));
 
-  for (auto pIt = this->poses.begin(); pIt != this->poses.end();)
+  // Write to a temporary file first, so that a crash never leaves a half
+  // written snapshot behind
+  auto tmpPath = path + ".tmp";
   {
-    auto vIt = this->visuals.find(pIt->first);
-    if (vIt != this->visuals.end())
+    std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!out || !_msg.SerializeToOstream(&out))
     {
-      auto visual = vIt->second.lock();
-      if (visual)
-      {
-        visual->SetLocalPose(pIt->second);
-      }
-      else
-      {
-        this->visuals.erase(vIt);
-      }
-      this->poses.erase(pIt++);
+      ignwarn << "Failed to write scene snapshot [" << tmpPath << "]"
+              << std::endl;
+      return;
     }
-    else
-    {
-      auto lIt = this->lights.find(pIt->first);
-      if (lIt != this->lights.end())
-      {
-        auto light = lIt->second.lock();
-        if (light)
+  }
+
+  if (std::rename(tmpPath.c_str(), path.c_str()) != 0)
+  {
+    ignwarn << "Failed to write scene snapshot [" << path << "]"
+            << std::endl;
+  }
+}
+
+/////////////////////////////////////////////////
+void SceneManager::OnPoseVMsg(const msgs::Pose_V &_msg)
+{
+  this->poseBuffer.Write(_msg);
+}
+
+/////////////////////////////////////////////////
+void SceneManager::OnCompactPoseMsg(const msgs::Bytes &_msg)
+{
+  double stamp{0.0};
+  if (this->poseDecoder.Decode(_msg.data(), this->decodedIds,
+      this->decodedPoses, stamp))
+  {
+    this->poseBuffer.Write(this->decodedIds, this->decodedPoses, stamp);
+  }
+}
+
+/////////////////////////////////////////////////
+void SceneManager::OnDeletionMsg(const msgs::UInt32_V &_msg)
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  std::copy(_msg.data().begin(), _msg.data().end(),
+            std::back_inserter(this->toDeleteEntities));
+}
+
+/////////////////////////////////////////////////
+bool SceneManager::StagePose(const unsigned int _id,
+    const math::Pose3d &_pose, const bool _cull)
+{
+  if (!this->visuals.SetPose(_id, _pose))
+    return this->lights.SetPose(_id, _pose);
+
+  if (_cull)
+  {
+    // Top level models are children of the root, so this is their world
+    // position
+    auto bIt = this->modelBounds.find(_id);
+    if (bIt != this->modelBounds.end())
+      bIt->second.position = _pose.Pos();
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////
+void SceneManager::UpdatePlayback(const PoseBuffer::Poses *_poses)
+{
+  if (_poses)
+  {
+    for (const auto &pose : *_poses)
+    {
+      const auto &sample = pose.second;
+      auto hIt = this->poseHistories.find(pose.first);
+
+      // Unstamped poses, and the first pose of an entity, are shown as is.
+      // So are poses from before the latest one, which means the simulation
+      // went back in time.
+      if (sample.stamp <= 0.0 || hIt == this->poseHistories.end() ||
+          sample.stamp < hIt->second.toStamp)
+      {
+        this->poseHistories[pose.first] =
+            {sample.pose, sample.stamp, sample.pose, sample.stamp, true};
+      }
+      else if (sample.stamp > hIt->second.toStamp)
+      {
+        auto &h = hIt->second;
+        h.from = h.to;
+        h.fromStamp = h.toStamp;
+        h.to = sample.pose;
+        h.toStamp = sample.stamp;
+        h.moving = true;
+      }
+
+      if (sample.stamp > this->latestStamp)
+      {
+        if (this->latestStamp > 0.0)
+        {
+          double interval = sample.stamp - this->latestStamp;
+          this->publishInterval = this->publishInterval > 0.0 ?
+              this->publishInterval + (interval - this->publishInterval) *
+              kPlaybackGain : interval;
+        }
+        this->latestStamp = sample.stamp;
+        this->latestReceived = sample.received;
+      }
+      else if (sample.stamp > 0.0 &&
+          sample.stamp < this->latestStamp - kMaxPlaybackError)
+      {
+        // Reset
+        this->latestStamp = sample.stamp;
+        this->latestReceived = sample.received;
+      }
+    }
+  }
+
+  if (this->latestStamp <= 0.0)
+    return;
+
+  // Where the playback clock should be, judging by the newest pose
+  auto now = std::chrono::steady_clock::now();
+  double target = this->latestStamp - this->publishInterval * kPlaybackDelay +
+      std::chrono::duration<double>(now - this->latestReceived).count();
+
+  if (this->playbackTime < 0.0)
+  {
+    this->playbackTime = target;
+  }
+  else
+  {
+    // Advance at wall clock rate and ease towards the target, so that
+    // jitter in msg arrival doesn't show up as jitter in motion
+    double next = this->playbackTime +
+        std::chrono::duration<double>(now - this->playbackUpdate).count();
+    double error = target - next;
+    if (std::abs(error) > kMaxPlaybackError)
+      this->playbackTime = target;
+    else
+      this->playbackTime = next + error * kPlaybackGain;
+  }
+  this->playbackUpdate = now;
+}
+
+/////////////////////////////////////////////////
+bool SceneManager::Update(const std::chrono::steady_clock::duration &_budget,
+                          const std::vector<View> &_views)
+{
+  auto deadline = std::chrono::steady_clock::now() + _budget;
+
+  // Keep asking for the scene until the service responds
+  if (this->loading)
+  {
+    if (this->requestFailed.exchange(false))
+      this->requestSent = false;
+    if (!this->requestSent &&
+        std::chrono::steady_clock::now() >= this->nextRequest)
+    {
+      this->TryRequest();
+    }
+  }
+
+  // Take the msgs received since the last update, so that the transport
+  // threads aren't blocked while they're processed
+  bool snapshotSuperseded;
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    for (auto &msg : this->sceneMsgs)
+      this->pendingScenes.push_back(std::move(msg));
+    this->sceneMsgs.clear();
+
+    this->pendingDeletions.insert(this->pendingDeletions.end(),
+        this->toDeleteEntities.begin(), this->toDeleteEntities.end());
+    this->toDeleteEntities.clear();
+
+    snapshotSuperseded = this->snapshotSuperseded;
+    this->snapshotSuperseded = false;
+  }
+
+  // The live scene is in, there's no point in loading what's left of the
+  // snapshot
+  if (snapshotSuperseded && this->snapshotPending)
+  {
+    this->pendingScenes.pop_front();
+    this->nextModel = 0;
+    this->nextLight = 0;
+    this->snapshotPending = false;
+  }
+
+  bool changed = false;
+
+  // Poses first, they're cheap and keep the scene moving
+  bool cull = this->viewCulling && !_views.empty();
+  auto poses = this->poseBuffer.Read();
+  if (this->interpolatePoses)
+  {
+    this->UpdatePlayback(poses);
+
+    for (auto it = this->poseHistories.begin();
+        it != this->poseHistories.end();)
+    {
+      auto &h = it->second;
+      if (!h.moving)
+      {
+        ++it;
+        continue;
+      }
+
+      math::Pose3d pose = h.to;
+      double span = h.toStamp - h.fromStamp;
+      if (span > 0.0 && this->playbackTime < h.toStamp + kMaxExtrapolation)
+      {
+        double t = (std::max(this->playbackTime, h.fromStamp) -
+            h.fromStamp) / span;
+        pose.Pos() = h.from.Pos() + (h.to.Pos() - h.from.Pos()) * t;
+        pose.Rot() = math::Quaterniond::Slerp(t, h.from.Rot(), h.to.Rot(),
+            true);
+      }
+      else
+      {
+        // Out of extrapolation time, settle on the latest known pose
+        h.moving = false;
+      }
+
+      // The entity is gone
+      if (!this->StagePose(it->first, pose, cull))
+        it = this->poseHistories.erase(it);
+      else
+        ++it;
+    }
+
+    // Keep drawing while anything's in motion
+    for (const auto &history : this->poseHistories)
+    {
+      if (history.second.moving)
+      {
+        changed = true;
+        break;
+      }
+    }
+  }
+  else if (poses)
+  {
+    for (const auto &pose : *poses)
+      this->StagePose(pose.first, pose.second.pose, cull);
+  }
+
+  // Models are checked both where they are shown and where they're going,
+  // so that they're moved out of view instead of left at the edge of it
+  if (cull)
+  {
+    for (auto &bounds : this->modelBounds)
+    {
+      auto &b = bounds.second;
+      b.visible = this->Visible(b.position, b.radius, _views) ||
+          this->Visible(b.shownPosition, b.radius, _views);
+    }
+
+    // Models in view keep their meshes, or get them back
+    if (this->resourceBudget.Capacity() > 0u)
+    {
+      for (const auto &bounds : this->modelBounds)
+      {
+        if (!bounds.second.visible)
+          continue;
+
+        if (this->resourceBudget.Evicted(bounds.first))
         {
-          light->SetLocalPose(pIt->second);
+          this->RestoreModel(bounds.first);
+          changed = true;
         }
         else
         {
-          this->lights.erase(lIt);
+          this->resourceBudget.Touch(bounds.first);
         }
-        this->poses.erase(pIt++);
       }
-      else
+    }
+  }
+
+  auto applied = this->visuals.Apply(
+      [](rendering::VisualPtr::weak_type &_visual, const math::Pose3d &_pose)
       {
-        ++pIt;
-      }
+        auto visual = _visual.lock();
+        if (!visual)
+          return false;
+        visual->SetLocalPose(_pose);
+        return true;
+      },
+      [&](const unsigned int _id)
+      {
+        if (!cull)
+          return false;
+        auto tIt = this->topModels.find(_id);
+        if (tIt == this->topModels.end())
+          return false;
+        auto bIt = this->modelBounds.find(tIt->second);
+        return bIt != this->modelBounds.end() && !bIt->second.visible;
+      });
+
+  if (cull)
+  {
+    for (auto &bounds : this->modelBounds)
+    {
+      if (bounds.second.visible)
+        bounds.second.shownPosition = bounds.second.position;
+    }
+  }
+
+  applied += this->lights.Apply(
+      [](rendering::LightPtr::weak_type &_light, const math::Pose3d &_pose)
+      {
+        auto light = _light.lock();
+        if (!light)
+          return false;
+        light->SetLocalPose(_pose);
+        return true;
+      });
+
+  changed = changed || applied > 0u;
+  if (this->lightBudget.Capacity() > 0u && !_views.empty())
+    changed = this->UpdateLightBudget(_views) || changed;
+  this->skippedWrites = this->visuals.Skipped() + this->lights.Skipped();
+
+  // Note we are dropping poses of entities which haven't been loaded yet, but
+  // later on we may need to consider the case where pose msgs arrive before
+  // scene/visual msgs
+
+  // Any time left goes to new entities and then to releasing deleted ones.
+  // Each step handles at least one item so that the queues always make
+  // progress.
+  auto outOfTime = [&]()
+  {
+    return _budget > std::chrono::steady_clock::duration::zero() &&
+        std::chrono::steady_clock::now() >= deadline;
+  };
+
+  // Detaching is cheap, so all deletions are done at once and only the
+  // destruction of what was detached is spread over updates
+  if (!this->pendingDeletions.empty())
+  {
+    std::unordered_set<unsigned int> deletions(
+        this->pendingDeletions.begin(), this->pendingDeletions.end());
+    this->pendingDeletions.clear();
+
+    // Deletions go before loads, so what's deleted must not be loaded
+    // later from the msgs still queued
+    this->DeleteEntities(deletions);
+    this->DropPendingLoads(deletions);
+    changed = true;
+  }
+
+  changed = this->LoadPendingMeshes() || changed;
+
+  while (!this->pendingScenes.empty())
+  {
+    const auto &msg = this->pendingScenes.front();
+    if (this->nextModel < msg.model_size())
+    {
+      changed =
+          this->LoadSceneModel(msg.model(this->nextModel++)) || changed;
+    }
+    else if (this->nextLight < msg.light_size())
+    {
+      changed =
+          this->LoadSceneLight(msg.light(this->nextLight++)) || changed;
     }
+    else
+    {
+      this->pendingScenes.pop_front();
+      this->nextModel = 0;
+      this->nextLight = 0;
+      this->snapshotPending = false;
+    }
+
+    if (outOfTime())
+      break;
+  }
+
+  // Evicted models are out of view, so what's shown doesn't change
+  if (cull)
+  {
+    for (auto model : this->resourceBudget.Evict())
+      this->EvictModel(model);
   }
 
-  // Note we are clearing the pose msgs here but later on we may need to
-  // consider the case where pose msgs arrive before scene/visual msgs
-  this->poses.clear();
+  // Releasing doesn't change what's shown, so it only gets what's left and
+  // doesn't ask for another frame. The idle poll keeps it going.
+  this->ReleaseDeleted(outOfTime);
+
+  // Make sure there's another update soon if work was left over
+  return changed || !this->pendingScenes.empty();
 }
 
 
+/////////////////////////////////////////////////
+std::size_t SceneManager::SkippedWrites() const
+{
+  return this->skippedWrites;
+}
+
 /////////////////////////////////////////////////
 void SceneManager::OnSceneMsg(const msgs::Scene &_msg)
 {
@@ -416,17 +1713,46 @@ void SceneManager::OnSceneSrvMsg(const msgs::Scene &_msg, const bool result)
   {
     ignerr << "Error making service request to " << this->service
            << std::endl;
+    this->requestFailed = true;
     return;
   }
+  this->loading = false;
 
   {
     std::lock_guard<std::mutex> lock(this->mutex);
     this->sceneMsgs.push_back(_msg);
+
+    // Remove whatever was shown from the snapshot and is gone by now. The
+    // rest is reconciled as the live scene is loaded, which only updates
+    // the poses of models which didn't change.
+    if (!this->snapshotIds.empty())
+    {
+      std::unordered_set<unsigned int> live;
+      for (int i = 0; i < _msg.model_size(); ++i)
+        live.insert(_msg.model(i).id());
+      for (int i = 0; i < _msg.light_size(); ++i)
+        live.insert(_msg.light(i).id());
+
+      for (auto id : this->snapshotIds)
+      {
+        if (live.find(id) == live.end())
+          this->toDeleteEntities.push_back(id);
+      }
+      this->snapshotIds.clear();
+      this->snapshotSuperseded = true;
+    }
   }
 
+  if (this->sceneCache)
+    this->SaveSnapshot(_msg);
+
   if (!this->poseTopic.empty())
   {
-    if (!this->node.Subscribe(this->poseTopic, &SceneManager::OnPoseVMsg, this))
+    bool subscribed = this->compactPoses ?
+        this->node.Subscribe(this->poseTopic,
+            &SceneManager::OnCompactPoseMsg, this) :
+        this->node.Subscribe(this->poseTopic, &SceneManager::OnPoseVMsg, this);
+    if (!subscribed)
     {
       ignerr << "Error subscribing to pose topic: " << this->poseTopic
         << std::endl;
@@ -472,36 +1798,117 @@ void SceneManager::OnSceneSrvMsg(const msgs::Scene &_msg, const bool result)
   }
 }
 
-void SceneManager::LoadScene(const msgs::Scene &_msg)
+/////////////////////////////////////////////////
+std::size_t SceneManager::Signature(const google::protobuf::Message &_msg)
 {
-  rendering::VisualPtr rootVis = this->scene->RootVisual();
+  return std::hash<std::string>()(_msg.SerializeAsString());
+}
 
-  // load models
-  for (int i = 0; i < _msg.model_size(); ++i)
+/////////////////////////////////////////////////
+bool SceneManager::LoadSceneModel(const msgs::Model &_msg)
+{
+  bool changed = false;
+  auto id = _msg.id();
+
+  msgs::Model stripped(_msg);
+  stripped.clear_pose();
+  auto signature = this->Signature(stripped);
+
+  if (this->visuals.Has(id))
   {
-    // Only add if it's not already loaded
-    if (this->visuals.find(_msg.model(i).id()) == this->visuals.end())
+    auto sIt = this->modelSignatures.find(id);
+    if (sIt != this->modelSignatures.end() && sIt->second == signature)
     {
-      rendering::VisualPtr modelVis = this->LoadModel(_msg.model(i));
-      if (modelVis)
-        rootVis->AddChild(modelVis);
-      else
-        ignerr << "Failed to load model: " << _msg.model(i).name() << std::endl;
+      // At most the pose changed, there's no need to reload
+      auto modelVis = this->visuals.Node(id).lock();
+      if (modelVis && _msg.has_pose())
+      {
+        auto pose = msgs::Convert(_msg.pose());
+        if (modelVis->LocalPose() != pose)
+        {
+          modelVis->SetLocalPose(pose);
+          this->visuals.Invalidate(id);
+          changed = true;
+
+          auto bIt = this->modelBounds.find(id);
+          if (bIt != this->modelBounds.end())
+          {
+            bIt->second.position = pose.Pos();
+            bIt->second.shownPosition = pose.Pos();
+          }
+        }
+      }
+      return changed;
     }
+
+    this->DeleteEntity(id);
   }
 
-  // load lights
-  for (int i = 0; i < _msg.light_size(); ++i)
+  if (this->viewCulling)
+  {
+    auto position = msgs::Convert(_msg.pose()).Pos();
+    this->modelBounds[id] = {position, position,
+        std::numeric_limits<double>::infinity(), 0u, false, true};
+    this->loadingModel = id;
+  }
+
+  rendering::VisualPtr modelVis = this->LoadModel(_msg);
+  if (modelVis)
+  {
+    this->scene->RootVisual()->AddChild(modelVis);
+    this->modelSignatures[id] = signature;
+    this->UpdateModelBounds(id);
+  }
+  else
+  {
+    ignerr << "Failed to load model: " << _msg.name() << std::endl;
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool SceneManager::LoadSceneLight(const msgs::Light &_msg)
+{
+  bool changed = false;
+  auto id = _msg.id();
+
+  msgs::Light stripped(_msg);
+  stripped.clear_pose();
+  auto signature = this->Signature(stripped);
+
+  if (this->lights.Has(id))
   {
-    if (this->lights.find(_msg.light(i).id()) == this->lights.end())
+    auto sIt = this->lightSignatures.find(id);
+    if (sIt != this->lightSignatures.end() && sIt->second == signature)
     {
-      rendering::LightPtr light = this->LoadLight(_msg.light(i));
-      if (light)
-        rootVis->AddChild(light);
-      else
-        ignerr << "Failed to load light: " << _msg.light(i).name() << std::endl;
+      auto light = this->lights.Node(id).lock();
+      if (light && _msg.has_pose())
+      {
+        auto pose = msgs::Convert(_msg.pose());
+        if (light->LocalPose() != pose)
+        {
+          light->SetLocalPose(pose);
+          this->lights.Invalidate(id);
+          changed = true;
+        }
+      }
+      return changed;
     }
+
+    this->DeleteEntity(id);
+  }
+
+  rendering::LightPtr light = this->LoadLight(_msg);
+  if (light)
+  {
+    this->scene->RootVisual()->AddChild(light);
+    this->lightSignatures[id] = signature;
+  }
+  else
+  {
+    ignerr << "Failed to load light: " << _msg.name() << std::endl;
   }
+  return true;
 }
 
 /////////////////////////////////////////////////
@@ -510,7 +1917,11 @@ rendering::VisualPtr SceneManager::LoadModel(const msgs::Model &_msg)
   rendering::VisualPtr modelVis = this->scene->CreateVisual();
   if (_msg.has_pose())
     modelVis->SetLocalPose(msgs::Convert(_msg.pose()));
-  this->visuals[_msg.id()] = modelVis;
+  this->visuals.Set(_msg.id(), modelVis);
+  this->TrackModelEntity(_msg.id());
+  this->IndexEntity(_msg.id(), _msg.name(), SceneEntity::Kind::MODEL,
+      modelVis);
+  this->loadingParents.push_back(_msg.id());
 
   // load links
   for (int i = 0; i < _msg.link_size(); ++i)
@@ -533,6 +1944,7 @@ rendering::VisualPtr SceneManager::LoadModel(const msgs::Model &_msg)
              << std::endl;
   }
 
+  this->loadingParents.pop_back();
   return modelVis;
 }
 
@@ -542,7 +1954,10 @@ rendering::VisualPtr SceneManager::LoadLink(const msgs::Link &_msg)
   rendering::VisualPtr linkVis = this->scene->CreateVisual();
   if (_msg.has_pose())
     linkVis->SetLocalPose(msgs::Convert(_msg.pose()));
-  this->visuals[_msg.id()] = linkVis;
+  this->visuals.Set(_msg.id(), linkVis);
+  this->TrackModelEntity(_msg.id());
+  this->IndexEntity(_msg.id(), _msg.name(), SceneEntity::Kind::LINK, linkVis);
+  this->loadingParents.push_back(_msg.id());
 
   // load visuals
   for (int i = 0; i < _msg.visual_size(); ++i)
@@ -554,6 +1969,15 @@ rendering::VisualPtr SceneManager::LoadLink(const msgs::Link &_msg)
       ignerr << "Failed to load visual: " << _msg.visual(i).name() << std::endl;
   }
 
+  // Lights may affect what's on screen from anywhere, so never cull their
+  // models
+  if (_msg.light_size() > 0)
+  {
+    auto bIt = this->modelBounds.find(this->loadingModel);
+    if (this->viewCulling && bIt != this->modelBounds.end())
+      bIt->second.lit = true;
+  }
+
   // load lights
   for (int i = 0; i < _msg.light_size(); ++i)
   {
@@ -564,6 +1988,7 @@ rendering::VisualPtr SceneManager::LoadLink(const msgs::Link &_msg)
       ignerr << "Failed to load light: " << _msg.light(i).name() << std::endl;
   }
 
+  this->loadingParents.pop_back();
   return linkVis;
 }
 
@@ -574,109 +1999,466 @@ rendering::VisualPtr SceneManager::LoadVisual(const msgs::Visual &_msg)
     return rendering::VisualPtr();
 
   rendering::VisualPtr visualVis = this->scene->CreateVisual();
-  this->visuals[_msg.id()] = visualVis;
+  this->visuals.Set(_msg.id(), visualVis);
+  this->TrackModelEntity(_msg.id());
+  this->IndexEntity(_msg.id(), _msg.name(), SceneEntity::Kind::VISUAL,
+      visualVis);
+
+  // Remembered to be reloaded after eviction
+  if (this->viewCulling && this->resourceBudget.Capacity() > 0u &&
+      _msg.geometry().has_mesh())
+  {
+    this->meshVisuals[this->loadingModel].push_back(_msg);
+  }
+
+  // Parse meshes which aren't loaded yet in the background and show a
+  // placeholder meanwhile
+  if (_msg.geometry().has_mesh())
+  {
+    const auto &filename = _msg.geometry().mesh().filename();
+    if (!filename.empty() &&
+        !common::MeshManager::Instance()->HasMesh(filename) &&
+        this->meshLoader.Request(filename))
+    {
+      auto material = this->scene->Material("ign-placeholder");
+      if (!material)
+      {
+        material = this->scene->CreateMaterial("ign-placeholder");
+        material->SetAmbient(0.5, 0.5, 0.5);
+        material->SetDiffuse(0.5, 0.5, 0.5);
+        material->SetTransparency(0.7);
+      }
+      auto box = this->scene->CreateBox();
+      box->SetMaterial(material, false);
+      visualVis->AddGeometry(box);
+      visualVis->SetLocalScale(kPlaceholderSize);
+
+      if (_msg.has_pose())
+        visualVis->SetLocalPose(msgs::Convert(_msg.pose()));
+
+      this->pendingMeshes.insert({filename, {visualVis, _msg}});
+
+      // The model's bounds are unknown until the mesh is loaded
+      auto bIt = this->modelBounds.find(this->loadingModel);
+      if (this->viewCulling && bIt != this->modelBounds.end())
+        ++bIt->second.pendingMeshes;
+      return visualVis;
+    }
+  }
+
+  this->LoadVisualGeometry(_msg, visualVis);
+
+  return visualVis;
+}
 
+/////////////////////////////////////////////////
+void SceneManager::LoadVisualGeometry(const msgs::Visual &_msg,
+    const rendering::VisualPtr &_visual)
+{
   math::Vector3d scale = math::Vector3d::One;
   math::Pose3d localPose;
   rendering::GeometryPtr geom =
       this->LoadGeometry(_msg.geometry(), scale, localPose);
 
   if (_msg.has_pose())
-    visualVis->SetLocalPose(msgs::Convert(_msg.pose()) * localPose);
+    _visual->SetLocalPose(msgs::Convert(_msg.pose()) * localPose);
   else
-    visualVis->SetLocalPose(localPose);
+    _visual->SetLocalPose(localPose);
 
   if (geom)
   {
     // store the local pose
-    this->localPoses[_msg.id()] = localPose;
+    this->visuals.SetLocalPose(_msg.id(), localPose);
 
-    visualVis->AddGeometry(geom);
-    visualVis->SetLocalScale(scale);
+    _visual->AddGeometry(geom);
+    _visual->SetLocalScale(scale);
 
-    // set material
-    rendering::MaterialPtr material{nullptr};
-    if (_msg.has_material())
+    if (this->viewCulling && this->resourceBudget.Capacity() > 0u &&
+        _msg.geometry().has_mesh())
     {
-      material = this->LoadMaterial(_msg.material());
+      auto tIt = this->topModels.find(_msg.id());
+      if (tIt != this->topModels.end())
+        this->BudgetMesh(tIt->second, _msg.geometry().mesh().filename());
     }
+
     // Don't set a default material for meshes because they
     // may have their own
     // TODO(anyone) support overriding mesh material
-    else if (_msg.geometry().has_mesh())
+    if (!_msg.has_material() && _msg.geometry().has_mesh())
     {
-      material = geom->Material();
+      this->ShareMeshMaterials(_msg, geom);
     }
     else
     {
-      // create default material
-      material = this->scene->Material("ign-grey");
-      if (!material)
-      {
-        material = this->scene->CreateMaterial("ign-grey");
-        material->SetAmbient(0.3, 0.3, 0.3);
-        material->SetDiffuse(0.7, 0.7, 0.7);
-        material->SetSpecular(1.0, 1.0, 1.0);
-        material->SetRoughness(0.2f);
-        material->SetMetalness(1.0f);
-      }
+      // Visuals which look the same share one material
+      geom->SetMaterial(this->SharedMaterial(_msg), false);
     }
-
-    material->SetTransparency(_msg.transparency());
-
-    // TODO(anyone) Get roughness and metalness from message instead
-    // of giving a default value.
-    material->SetRoughness(0.3f);
-    material->SetMetalness(0.3f);
-
-    geom->SetMaterial(material);
   }
   else
   {
     ignerr << "Failed to load geometry for visual: " << _msg.name()
            << std::endl;
   }
-
-  return visualVis;
 }
 
 /////////////////////////////////////////////////
-rendering::GeometryPtr SceneManager::LoadGeometry(const msgs::Geometry &_msg,
-    math::Vector3d &_scale, math::Pose3d &_localPose)
+bool SceneManager::LoadPendingMeshes()
 {
-  math::Vector3d scale = math::Vector3d::One;
-  math::Pose3d localPose = math::Pose3d::Zero;
-  rendering::GeometryPtr geom{nullptr};
-  if (_msg.has_box())
-  {
-    geom = this->scene->CreateBox();
-    if (_msg.box().has_size())
-      scale = msgs::Convert(_msg.box().size());
-  }
-  else if (_msg.has_cylinder())
-  {
-    geom = this->scene->CreateCylinder();
-    scale.X() = _msg.cylinder().radius() * 2;
-    scale.Y() = scale.X();
-    scale.Z() = _msg.cylinder().length();
-  }
-  else if (_msg.has_plane())
+  bool changed = false;
+  std::vector<unsigned int> models;
+  for (const auto &completed : this->meshLoader.Completed())
   {
-    geom = this->scene->CreatePlane();
-
-    if (_msg.plane().has_size())
+    auto range = this->pendingMeshes.equal_range(completed.first);
+    for (auto it = range.first; it != range.second; ++it)
     {
-      scale.X() = _msg.plane().size().x();
-      scale.Y() = _msg.plane().size().y();
-    }
+      auto visual = it->second.visual.lock();
+      if (!visual)
+        continue;
 
-    if (_msg.plane().has_normal())
-    {
-      // Create a rotation for the plane mesh to account for the normal vector.
-      // The rotation is the angle between the +z(0,0,1) vector and the
-      // normal, which are both expressed in the local (Visual) frame.
-      math::Vector3d normal = msgs::Convert(_msg.plane().normal());
-      localPose.Rot().From2Axes(math::Vector3d::UnitZ, normal.Normalized());
+      auto tIt = this->topModels.find(it->second.msg.id());
+      if (tIt != this->topModels.end())
+      {
+        auto bIt = this->modelBounds.find(tIt->second);
+        if (bIt != this->modelBounds.end() && bIt->second.pendingMeshes > 0u)
+        {
+          --bIt->second.pendingMeshes;
+          models.push_back(tIt->second);
+        }
+      }
+
+      // Keep the pose which may have been set since the placeholder was
+      // created
+      auto pose = visual->LocalPose();
+      visual->RemoveGeometries();
+      changed = true;
+
+      if (!completed.second)
+      {
+        ignerr << "Failed to load geometry for visual: "
+               << it->second.msg.name() << std::endl;
+        continue;
+      }
+
+      // The mesh is in the mesh manager now, so this doesn't block
+      this->LoadVisualGeometry(it->second.msg, visual);
+      visual->SetLocalPose(pose);
+    }
+    this->pendingMeshes.erase(range.first, range.second);
+  }
+
+  for (auto model : models)
+    this->UpdateModelBounds(model);
+  return changed;
+}
+
+/////////////////////////////////////////////////
+void SceneManager::BudgetMesh(const unsigned int _model,
+    const std::string &_filename)
+{
+  auto mesh = common::MeshManager::Instance()->MeshByName(_filename);
+  if (!mesh)
+    return;
+
+  // Positions, normals and texture coordinates, and 32 bit indices, which
+  // is what most engines upload
+  auto sizeIt = this->resourceSizes.find(_filename);
+  if (sizeIt == this->resourceSizes.end())
+  {
+    std::size_t bytes{0u};
+    for (unsigned int i = 0u; i < mesh->SubMeshCount(); ++i)
+    {
+      auto subMesh = mesh->SubMeshByIndex(i).lock();
+      if (subMesh)
+      {
+        bytes += subMesh->VertexCount() * 8u * sizeof(float) +
+            subMesh->IndexCount() * sizeof(std::uint32_t);
+      }
+    }
+    sizeIt = this->resourceSizes.insert({_filename, bytes}).first;
+  }
+  this->resourceBudget.Use(_model, _filename, sizeIt->second);
+
+  // RGBA texels with their mipmaps, read from the image headers only
+  for (unsigned int i = 0u; i < mesh->MaterialCount(); ++i)
+  {
+    auto material = mesh->MaterialByIndex(i);
+    if (!material || material->TextureImage().empty())
+      continue;
+
+    const auto &texture = material->TextureImage();
+    sizeIt = this->resourceSizes.find(texture);
+    if (sizeIt == this->resourceSizes.end())
+    {
+      auto size = QImageReader(QString::fromStdString(texture)).size();
+      std::size_t bytes = size.isValid() ?
+          static_cast<std::size_t>(size.width()) * size.height() * 4u * 4u /
+          3u : 0u;
+      sizeIt = this->resourceSizes.insert({texture, bytes}).first;
+    }
+    this->resourceBudget.Use(_model, texture, sizeIt->second);
+  }
+}
+
+/////////////////////////////////////////////////
+void SceneManager::EvictModel(const unsigned int _model)
+{
+  auto it = this->meshVisuals.find(_model);
+  if (it == this->meshVisuals.end())
+    return;
+
+  std::unordered_set<std::string> meshes;
+  for (const auto &msg : it->second)
+  {
+    auto visual = this->visuals.Node(msg.id()).lock();
+    if (!visual)
+      continue;
+
+    // Each geometry belongs to its visual only, nothing else uses it
+    std::vector<rendering::GeometryPtr> geometries;
+    for (unsigned int i = 0u; i < visual->GeometryCount(); ++i)
+      geometries.push_back(visual->GeometryByIndex(i));
+    visual->RemoveGeometries();
+    for (auto &geometry : geometries)
+      geometry->Destroy();
+
+    meshes.insert(msg.geometry().mesh().filename());
+  }
+
+  // Meshes which no model left counts are dropped from memory, and loaded
+  // again by RestoreModel
+  for (const auto &filename : meshes)
+  {
+    if (!this->resourceBudget.InUse(filename))
+      common::MeshManager::Instance()->RemoveMesh(filename);
+  }
+}
+
+/////////////////////////////////////////////////
+void SceneManager::RestoreModel(const unsigned int _model)
+{
+  this->resourceBudget.Restore(_model);
+
+  auto it = this->meshVisuals.find(_model);
+  if (it == this->meshVisuals.end())
+    return;
+
+  for (const auto &msg : it->second)
+  {
+    auto visual = this->visuals.Node(msg.id()).lock();
+    if (!visual)
+      continue;
+
+    // Meshes which were dropped from memory are parsed in the background
+    // again, and the visual stays empty meanwhile
+    const auto &filename = msg.geometry().mesh().filename();
+    visual->RemoveGeometries();
+    if (!common::MeshManager::Instance()->HasMesh(filename) &&
+        this->meshLoader.Request(filename))
+    {
+      this->pendingMeshes.insert({filename, {visual, msg}});
+      continue;
+    }
+
+    // Keep the pose it was moved to since
+    auto pose = visual->LocalPose();
+    this->LoadVisualGeometry(msg, visual);
+    visual->SetLocalPose(pose);
+  }
+}
+
+/////////////////////////////////////////////////
+bool SceneManager::UpdateLightBudget(const std::vector<View> &_views)
+{
+  for (auto it = this->lightInfos.begin(); it != this->lightInfos.end();)
+  {
+    auto id = it->first;
+    auto &info = it->second;
+    auto light = this->lights.Node(id).lock();
+    if (!light)
+    {
+      this->lightBudget.Remove(id);
+      it = this->lightInfos.erase(it);
+      continue;
+    }
+
+    // Disabled lights are off the scene graph, so their world position
+    // comes from the node they were attached to
+    auto position = light->WorldPosition();
+    if (!this->lightBudget.Enabled(id))
+    {
+      auto parent = info.parent.lock();
+      if (!parent)
+      {
+        // The model it belonged to was destroyed without it
+        this->releasedLights.push_back(light);
+        this->lights.Erase(id);
+        if (this->index)
+          this->index->Remove(id);
+        this->lightBudget.Remove(id);
+        it = this->lightInfos.erase(it);
+        continue;
+      }
+
+      auto parentPose = parent->WorldPose();
+      position = parentPose.Pos() +
+          parentPose.Rot().RotateVector(light->LocalPose().Pos());
+    }
+
+    double distance = std::numeric_limits<double>::infinity();
+    for (const auto &view : _views)
+    {
+      distance = std::min(distance,
+          (position - view.frustum.Pose().Pos()).Length());
+    }
+    this->lightBudget.Score(id,
+        LightBudget::Importance(info.brightness, info.range, distance));
+    ++it;
+  }
+
+  auto changed = this->lightBudget.Select();
+  for (const auto &c : changed)
+  {
+    auto light = this->lights.Node(c.first).lock();
+    auto &info = this->lightInfos[c.first];
+    if (!light)
+      continue;
+
+    if (c.second)
+    {
+      auto parent = info.parent.lock();
+      if (parent)
+        parent->AddChild(light);
+      info.parent.reset();
+    }
+    else
+    {
+      info.parent = light->Parent();
+      light->RemoveParent();
+    }
+  }
+  return !changed.empty();
+}
+
+/////////////////////////////////////////////////
+void SceneManager::TrackModelEntity(const unsigned int _id)
+{
+  if (this->viewCulling)
+    this->topModels[_id] = this->loadingModel;
+}
+
+/////////////////////////////////////////////////
+void SceneManager::IndexEntity(const unsigned int _id,
+    const std::string &_name, SceneEntity::Kind _kind,
+    const rendering::NodePtr &_node)
+{
+  if (!this->index)
+    return;
+
+  SceneEntity entity;
+  entity.id = _id;
+  entity.name = _name;
+  entity.parent = this->loadingParents.empty() ?
+      0u : this->loadingParents.back();
+  entity.kind = _kind;
+  this->index->Add(entity, _node);
+}
+
+/////////////////////////////////////////////////
+void SceneManager::UpdateModelBounds(const unsigned int _id)
+{
+  auto bIt = this->modelBounds.find(_id);
+  if (bIt == this->modelBounds.end())
+    return;
+
+  auto &bounds = bIt->second;
+  bounds.radius = std::numeric_limits<double>::infinity();
+  if (bounds.lit || bounds.pendingMeshes > 0u)
+    return;
+
+  auto visual = this->visuals.Node(_id).lock();
+  if (!visual)
+    return;
+
+  // Links move with respect to the model, this is just what it looks like
+  // right now
+  auto box = visual->BoundingBox();
+  if (box.Min().X() > box.Max().X())
+  {
+    // Nothing to see
+    bounds.radius = 0.0;
+    return;
+  }
+  bounds.radius = (box.Center() - visual->WorldPosition()).Length() +
+      box.Size().Length() * 0.5;
+}
+
+/////////////////////////////////////////////////
+bool SceneManager::Visible(const math::Vector3d &_center,
+    const double _radius, const std::vector<View> &_views)
+{
+  for (const auto &view : _views)
+  {
+    bool inside = true;
+    for (int p = math::FRUSTUM_PLANE_NEAR; p <= math::FRUSTUM_PLANE_BOTTOM;
+        ++p)
+    {
+      auto plane = view.frustum.Plane(static_cast<math::FrustumPlane>(p));
+      if (plane.Distance(_center) < -_radius)
+      {
+        inside = false;
+        break;
+      }
+    }
+    if (!inside)
+      continue;
+
+    auto distance = _center.Distance(view.frustum.Pose().Pos());
+    if (distance <= _radius ||
+        2.0 * _radius / distance * view.pixelScale >= kMinScreenSize)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+/////////////////////////////////////////////////
+rendering::GeometryPtr SceneManager::LoadGeometry(const msgs::Geometry &_msg,
+    math::Vector3d &_scale, math::Pose3d &_localPose)
+{
+  math::Vector3d scale = math::Vector3d::One;
+  math::Pose3d localPose = math::Pose3d::Zero;
+  rendering::GeometryPtr geom{nullptr};
+  if (_msg.has_box())
+  {
+    geom = this->scene->CreateBox();
+    if (_msg.box().has_size())
+      scale = msgs::Convert(_msg.box().size());
+  }
+  else if (_msg.has_cylinder())
+  {
+    geom = this->scene->CreateCylinder();
+    scale.X() = _msg.cylinder().radius() * 2;
+    scale.Y() = scale.X();
+    scale.Z() = _msg.cylinder().length();
+  }
+  else if (_msg.has_plane())
+  {
+    geom = this->scene->CreatePlane();
+
+    if (_msg.plane().has_size())
+    {
+      scale.X() = _msg.plane().size().x();
+      scale.Y() = _msg.plane().size().y();
+    }
+
+    if (_msg.plane().has_normal())
+    {
+      // Create a rotation for the plane mesh to account for the normal vector.
+      // The rotation is the angle between the +z(0,0,1) vector and the
+      // normal, which are both expressed in the local (Visual) frame.
+      math::Vector3d normal = msgs::Convert(_msg.plane().normal());
+      localPose.Rot().From2Axes(math::Vector3d::UnitZ, normal.Normalized());
     }
   }
   else if (_msg.has_sphere())
@@ -715,9 +2497,10 @@ rendering::GeometryPtr SceneManager::LoadGeometry(const msgs::Geometry &_msg,
 }
 
 /////////////////////////////////////////////////
-rendering::MaterialPtr SceneManager::LoadMaterial(const msgs::Material &_msg)
+rendering::MaterialPtr SceneManager::LoadMaterial(const msgs::Material &_msg,
+    const std::string &_name)
 {
-  rendering::MaterialPtr material = this->scene->CreateMaterial();
+  rendering::MaterialPtr material = this->scene->CreateMaterial(_name);
   if (_msg.has_ambient())
   {
     material->SetAmbient(msgs::Convert(_msg.ambient()));
@@ -738,6 +2521,92 @@ rendering::MaterialPtr SceneManager::LoadMaterial(const msgs::Material &_msg)
   return material;
 }
 
+/////////////////////////////////////////////////
+rendering::MaterialPtr SceneManager::SharedMaterial(const msgs::Visual &_msg)
+{
+  // Key on everything which ends up in the material
+  std::string key;
+  if (_msg.has_material())
+    key = _msg.material().SerializeAsString();
+  key += std::to_string(_msg.transparency());
+
+  std::stringstream name;
+  name << "ign-material-" << std::hex << std::hash<std::string>()(key);
+
+  rendering::MaterialPtr material = this->scene->Material(name.str());
+  if (material)
+    return material;
+
+  if (_msg.has_material())
+  {
+    material = this->LoadMaterial(_msg.material(), name.str());
+  }
+  else
+  {
+    // default material
+    material = this->scene->CreateMaterial(name.str());
+    material->SetAmbient(0.3, 0.3, 0.3);
+    material->SetDiffuse(0.7, 0.7, 0.7);
+    material->SetSpecular(1.0, 1.0, 1.0);
+  }
+
+  material->SetTransparency(_msg.transparency());
+
+  // TODO(anyone) Get roughness and metalness from message instead
+  // of giving a default value.
+  material->SetRoughness(0.3f);
+  material->SetMetalness(0.3f);
+
+  return material;
+}
+
+/////////////////////////////////////////////////
+void SceneManager::ShareMeshMaterials(const msgs::Visual &_msg,
+    const rendering::GeometryPtr &_geom)
+{
+  auto mesh = std::dynamic_pointer_cast<rendering::Mesh>(_geom);
+  if (!mesh)
+    return;
+
+  // Name on the key itself, hashes can collide. The separator is escaped
+  // in the file name so that two keys can't spell the same name.
+  std::string prefix = "ign-mesh-material:";
+  for (const auto c : _msg.geometry().mesh().filename())
+  {
+    if (c == '\\' || c == ':')
+      prefix += '\\';
+    prefix += c;
+  }
+  prefix += ":" + std::to_string(_msg.transparency()) + ":";
+
+  for (unsigned int i = 0; i < mesh->SubMeshCount(); ++i)
+  {
+    auto subMesh = mesh->SubMeshByIndex(i);
+    if (!subMesh)
+      continue;
+
+    auto name = prefix + std::to_string(i);
+    auto material = this->scene->Material(name);
+    if (!material)
+    {
+      auto own = subMesh->Material();
+      if (!own)
+        continue;
+
+      material = own->Clone(name);
+      material->SetTransparency(_msg.transparency());
+
+      // TODO(anyone) Get roughness and metalness from message instead
+      // of giving a default value.
+      material->SetRoughness(0.3f);
+      material->SetMetalness(0.3f);
+    }
+
+    // Not unique, so all instances point at the shared one
+    subMesh->SetMaterial(material, false);
+  }
+}
+
 /////////////////////////////////////////////////
 rendering::LightPtr SceneManager::LoadLight(const msgs::Light &_msg)
 {
@@ -789,30 +2658,171 @@ rendering::LightPtr SceneManager::LoadLight(const msgs::Light &_msg)
 
   light->SetCastShadows(_msg.cast_shadows());
 
-  this->lights[_msg.id()] = light;
+  if (this->lightBudget.Capacity() > 0u &&
+      _msg.type() != msgs::Light_LightType_DIRECTIONAL)
+  {
+    auto diffuse = light->DiffuseColor();
+    LightInfo info;
+    info.brightness = (diffuse.R() + diffuse.G() + diffuse.B()) / 3.0;
+    info.range = _msg.range();
+    this->lightInfos[_msg.id()] = info;
+  }
+
+  this->lights.Set(_msg.id(), light);
+  this->IndexEntity(_msg.id(), _msg.name(), SceneEntity::Kind::LIGHT, light);
   return light;
 }
 
 /////////////////////////////////////////////////
 void SceneManager::DeleteEntity(const unsigned int _entity)
 {
-  if (this->visuals.find(_entity) != this->visuals.end())
+  if (!this->DetachEntity(_entity))
+    return;
+
+  this->visuals.Erase(_entity);
+  this->lights.Erase(_entity);
+  this->ForgetEntity(_entity);
+  if (this->index)
+    this->index->Remove(_entity);
+}
+
+/////////////////////////////////////////////////
+void SceneManager::DeleteEntities(
+    const std::unordered_set<unsigned int> &_entities)
+{
+  std::unordered_set<unsigned int> detached;
+  for (auto id : _entities)
+  {
+    if (this->DetachEntity(id))
+      detached.insert(id);
+  }
+
+  if (detached.empty())
+    return;
+
+  auto isDetached = [&detached](const unsigned int _id)
+  {
+    return detached.find(_id) != detached.end();
+  };
+  this->visuals.EraseIf(isDetached);
+  this->lights.EraseIf(isDetached);
+
+  for (auto id : detached)
+  {
+    this->ForgetEntity(id);
+    if (this->index)
+      this->index->Remove(id);
+  }
+}
+
+/////////////////////////////////////////////////
+void SceneManager::DropPendingLoads(
+    const std::unordered_set<unsigned int> &_entities)
+{
+  // What comes before the next model and light of the front msg is loaded
+  // already, and is deleted as usual
+  for (std::size_t i = 0; i < this->pendingScenes.size(); ++i)
   {
-    auto visual = this->visuals[_entity].lock();
+    auto &msg = this->pendingScenes[i];
+    RemoveIds(*msg.mutable_model(), i == 0u ? this->nextModel : 0,
+        _entities);
+    RemoveIds(*msg.mutable_light(), i == 0u ? this->nextLight : 0,
+        _entities);
+  }
+
+  // Visuals of deleted models were taken out of the scene graph
+  auto root = this->scene->RootVisual();
+  for (auto it = this->pendingMeshes.begin(); it != this->pendingMeshes.end();)
+  {
+    rendering::NodePtr node = it->second.visual.lock();
+    while (node && node != root)
+      node = node->Parent();
+
+    if (!node)
+      it = this->pendingMeshes.erase(it);
+    else
+      ++it;
+  }
+}
+
+/////////////////////////////////////////////////
+bool SceneManager::DetachEntity(const unsigned int _entity)
+{
+  if (this->visuals.Has(_entity))
+  {
+    auto visual = this->visuals.Node(_entity).lock();
     if (visual)
     {
-      this->scene->DestroyVisual(visual, true);
+      visual->RemoveParent();
+      this->releasedVisuals.push_back(visual);
     }
-    this->visuals.erase(_entity);
+    return true;
   }
-  else if (this->lights.find(_entity) != this->lights.end())
+
+  if (this->lights.Has(_entity))
   {
-    auto light = this->lights[_entity].lock();
+    auto light = this->lights.Node(_entity).lock();
     if (light)
     {
-      this->scene->DestroyLight(light, true);
+      light->RemoveParent();
+      this->releasedLights.push_back(light);
+    }
+    return true;
+  }
+
+  return false;
+}
+
+/////////////////////////////////////////////////
+void SceneManager::ForgetEntity(const unsigned int _entity)
+{
+  this->poseHistories.erase(_entity);
+  this->modelSignatures.erase(_entity);
+  this->lightSignatures.erase(_entity);
+  this->topModels.erase(_entity);
+  this->resourceBudget.Remove(_entity);
+  this->meshVisuals.erase(_entity);
+  this->lightBudget.Remove(_entity);
+  this->lightInfos.erase(_entity);
+
+  // Descendants of deleted top level models are gone too
+  if (this->modelBounds.erase(_entity) > 0u)
+  {
+    for (auto it = this->topModels.begin(); it != this->topModels.end();)
+    {
+      if (it->second == _entity)
+        it = this->topModels.erase(it);
+      else
+        ++it;
     }
-    this->lights.erase(_entity);
+  }
+}
+
+/////////////////////////////////////////////////
+void SceneManager::ReleaseDeleted(const std::function<bool()> &_outOfTime)
+{
+  while (!this->releasedVisuals.empty())
+  {
+    auto visual = this->releasedVisuals.front().lock();
+    this->releasedVisuals.pop_front();
+    if (!visual)
+      continue;
+
+    this->scene->DestroyVisual(visual, true);
+    if (_outOfTime())
+      return;
+  }
+
+  while (!this->releasedLights.empty())
+  {
+    auto light = this->releasedLights.front().lock();
+    this->releasedLights.pop_front();
+    if (!light)
+      continue;
+
+    this->scene->DestroyLight(light, true);
+    if (_outOfTime())
+      return;
   }
 }
 
@@ -829,93 +2839,249 @@ IgnRenderer::~IgnRenderer()
 }
 
 /////////////////////////////////////////////////
-void IgnRenderer::Render()
+bool IgnRenderer::Render(const bool _sceneChanged,
+    const std::chrono::steady_clock::duration &_updateTime,
+    const std::size_t _skippedWrites)
 {
+  bool dirty = _sceneChanged;
   if (this->textureDirty)
   {
-    this->dataPtr->camera->SetImageWidth(this->textureSize.width());
-    this->dataPtr->camera->SetImageHeight(this->textureSize.height());
-    this->dataPtr->camera->SetAspectRatio(this->textureSize.width() /
+    auto scale = this->dataPtr->resolutionScale;
+    this->dataPtr->renderSize = QSize(
+        std::max(1, static_cast<int>(this->textureSize.width() * scale)),
+        std::max(1, static_cast<int>(this->textureSize.height() * scale)));
+
+    this->dataPtr->camera->SetImageWidth(this->dataPtr->renderSize.width());
+    this->dataPtr->camera->SetImageHeight(this->dataPtr->renderSize.height());
+    this->dataPtr->camera->SetAspectRatio(
+        static_cast<double>(this->textureSize.width()) /
         this->textureSize.height());
+    this->dataPtr->camera->SetAntiAliasing(this->dataPtr->antiAliasing);
     // setting the size should cause the render texture to be rebuilt
     this->dataPtr->camera->PreRender();
     this->textureId = this->dataPtr->camera->RenderTextureGLId();
     this->textureDirty = false;
+    dirty = true;
   }
 
-  // update the scene
-  this->dataPtr->sceneManager.Update();
+  auto start = FrameTimings::Clock::now();
+  auto frameStart = start;
 
-  // view control
-  this->HandleMouseEvent();
+  // view control was already applied through UpdateView
+  if (this->dataPtr->viewChanged)
+  {
+    this->dataPtr->viewChanged = false;
+    dirty = true;
+  }
+
+  // Skip the frame if nothing changed, but make sure other plugins which
+  // modify the scene through render events get a frame every now and then
+  auto now = std::chrono::steady_clock::now();
+  if (this->renderOnDemand && !dirty &&
+      now - this->dataPtr->lastRenderTime < this->maxIdleInterval)
+  {
+    return false;
+  }
+  this->dataPtr->lastRenderTime = now;
 
   // update and render to texture
   this->dataPtr->camera->Update();
 
-  if (ignition::gui::App())
+  this->dataPtr->frameTime = _updateTime + this->dataPtr->mouseTime +
+      (FrameTimings::Clock::now() - frameStart);
+  this->AdaptResolution(this->dataPtr->frameTime);
+
+  if (this->frameStatsEnabled)
   {
-    ignition::gui::App()->sendEvent(
-        ignition::gui::App()->findChild<ignition::gui::MainWindow *>(),
-        new gui::events::Render());
+    this->dataPtr->frameTimings.Record(FrameTimings::UPDATE, _updateTime);
+    this->dataPtr->frameTimings.Record(FrameTimings::MOUSE,
+        this->dataPtr->mouseTime);
+    this->dataPtr->frameTimings.Record(FrameTimings::RENDER, start);
+    this->dataPtr->frameTimings.RecordSkippedWrites(_skippedWrites);
+    this->dataPtr->frameTimings.RecordCpu(FrameTimings::CurrentCpu());
   }
+
+  return true;
 }
 
 /////////////////////////////////////////////////
-void IgnRenderer::HandleMouseEvent()
+void IgnRenderer::UpdateView()
 {
-  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
-  if (!this->dataPtr->mouseDirty)
+  auto start = FrameTimings::Clock::now();
+  if (this->HandleMouseEvent())
+    this->dataPtr->viewChanged = true;
+  this->dataPtr->mouseTime = FrameTimings::Clock::now() - start;
+}
+
+/////////////////////////////////////////////////
+math::Frustum IgnRenderer::Frustum() const
+{
+  auto camera = this->dataPtr->camera;
+  if (!camera)
+    return math::Frustum();
+
+  return math::Frustum(camera->NearClipPlane(), camera->FarClipPlane(),
+      camera->HFOV(), camera->AspectRatio(), camera->WorldPose());
+}
+
+/////////////////////////////////////////////////
+void IgnRenderer::EndFrame(
+    const std::chrono::steady_clock::duration &_renderEventTime)
+{
+  if (!this->frameStatsEnabled)
     return;
 
+  this->dataPtr->frameTimings.Record(FrameTimings::RENDER_EVENT,
+      _renderEventTime);
+  this->dataPtr->frameTimings.Record(FrameTimings::FRAME,
+      this->dataPtr->frameTime + _renderEventTime);
+  this->dataPtr->frameTimings.EndFrame();
+}
+
+/////////////////////////////////////////////////
+bool IgnRenderer::HandleMouseEvent()
+{
+  std::vector<IgnRendererPrivate::MouseInput> events;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    events.swap(this->dataPtr->mouseEvents);
+  }
+  if (events.empty())
+    return false;
+
   this->dataPtr->viewControl.SetCamera(this->dataPtr->camera);
 
-  if (this->dataPtr->mouseEvent.Type() == common::MouseEvent::SCROLL)
+  // Ray queries are expensive, so reuse the last target while the cursor
+  // stays in place and the camera only zoomed
+  auto updateTarget = [this](const math::Vector2i &_pos)
   {
-    this->dataPtr->target =
-        this->ScreenToScene(this->dataPtr->mouseEvent.Pos());
+    if (this->dataPtr->targetValid && this->dataPtr->targetPos == _pos)
+      return;
+
+    this->dataPtr->target = this->ScreenToScene(_pos);
+    this->dataPtr->targetPos = _pos;
+    this->dataPtr->targetValid = true;
     this->dataPtr->viewControl.SetTarget(this->dataPtr->target);
-    double distance = this->dataPtr->camera->WorldPosition().Distance(
-        this->dataPtr->target);
-    double amount = -this->dataPtr->drag.Y() * distance / 5.0;
-    this->dataPtr->viewControl.Zoom(amount);
-  }
-  else
+  };
+
+  for (const auto &input : events)
   {
-    if (this->dataPtr->drag == math::Vector2d::Zero)
+    const auto &event = input.event;
+    const auto &drag = input.drag;
+
+    if (event.Type() == common::MouseEvent::SCROLL)
     {
-      this->dataPtr->target = this->ScreenToScene(
-          this->dataPtr->mouseEvent.PressPos());
-      this->dataPtr->viewControl.SetTarget(this->dataPtr->target);
+      updateTarget(event.Pos());
+      double distance = this->dataPtr->camera->WorldPosition().Distance(
+          this->dataPtr->target);
+      double amount = -drag.Y() * distance / 5.0;
+      this->dataPtr->viewControl.Zoom(amount);
+      continue;
+    }
+
+    if (event.Type() == common::MouseEvent::RELEASE)
+      continue;
+
+    if (event.Type() == common::MouseEvent::PRESS)
+    {
+      // The camera may have moved since the last press
+      this->dataPtr->targetValid = false;
+      updateTarget(event.PressPos());
+      continue;
     }
 
     // Pan with left button
-    if (this->dataPtr->mouseEvent.Buttons() & common::MouseEvent::LEFT)
+    if (event.Buttons() & common::MouseEvent::LEFT)
     {
       if (Qt::ShiftModifier == QGuiApplication::queryKeyboardModifiers())
-        this->dataPtr->viewControl.Orbit(this->dataPtr->drag);
+        this->dataPtr->viewControl.Orbit(drag);
       else
-        this->dataPtr->viewControl.Pan(this->dataPtr->drag);
+        this->dataPtr->viewControl.Pan(drag);
     }
     // Orbit with middle button
-    else if (this->dataPtr->mouseEvent.Buttons() & common::MouseEvent::MIDDLE)
+    else if (event.Buttons() & common::MouseEvent::MIDDLE)
     {
-      this->dataPtr->viewControl.Orbit(this->dataPtr->drag);
+      this->dataPtr->viewControl.Orbit(drag);
     }
-    else if (this->dataPtr->mouseEvent.Buttons() & common::MouseEvent::RIGHT)
+    else if (event.Buttons() & common::MouseEvent::RIGHT)
     {
       double hfov = this->dataPtr->camera->HFOV().Radian();
       double vfov = 2.0f * atan(tan(hfov / 2.0f) /
           this->dataPtr->camera->AspectRatio());
       double distance = this->dataPtr->camera->WorldPosition().Distance(
           this->dataPtr->target);
-      double amount = ((-this->dataPtr->drag.Y() /
-          static_cast<double>(this->dataPtr->camera->ImageHeight()))
+      double amount = ((-drag.Y() /
+          static_cast<double>(this->textureSize.height()))
           * distance * tan(vfov/2.0) * 6.0);
       this->dataPtr->viewControl.Zoom(amount);
     }
+
+    // Panning and orbiting change what's under the cursor. The target
+    // stays the one picked on press until the next press or scroll.
+    this->dataPtr->targetValid = false;
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////
+void IgnRenderer::AdaptResolution(
+    const std::chrono::steady_clock::duration &_frameTime)
+{
+  if (this->targetFrameTime <= 0.0)
+    return;
+
+  double frameTime =
+      std::chrono::duration<double, std::milli>(_frameTime).count();
+  auto &avg = this->dataPtr->avgFrameTime;
+  avg = avg <= 0.0 ? frameTime : 0.9 * avg + 0.1 * frameTime;
+
+  if (++this->dataPtr->framesSinceAdapt < kAdaptInterval)
+    return;
+
+  auto &scale = this->dataPtr->resolutionScale;
+  auto &aa = this->dataPtr->antiAliasing;
+  if (avg > this->targetFrameTime * 1.1)
+  {
+    // Too slow, anti-aliasing goes first since it's the least noticeable
+    if (aa > 0u)
+      aa = aa > 2u ? aa / 2u : 0u;
+    else if (scale > this->minResolutionScale)
+      scale = std::max(this->minResolutionScale, scale * kResolutionStep);
+    else
+      return;
+  }
+  else if (avg < this->targetFrameTime * 0.7)
+  {
+    // Headroom, restore resolution first
+    if (scale < 1.0)
+      scale = std::min(1.0, scale / kResolutionStep);
+    else if (aa < kMaxAntiAliasing)
+      aa = aa == 0u ? 2u : aa * 2u;
+    else
+      return;
   }
-  this->dataPtr->drag = 0;
-  this->dataPtr->mouseDirty = false;
+  else
+  {
+    return;
+  }
+
+  this->dataPtr->framesSinceAdapt = 0u;
+  this->textureDirty = true;
+}
+
+/////////////////////////////////////////////////
+QSize IgnRenderer::RenderTextureSize() const
+{
+  return this->dataPtr->renderSize;
+}
+
+/////////////////////////////////////////////////
+std::string IgnRenderer::FrameStatsSummary() const
+{
+  if (!this->frameStatsEnabled)
+    return std::string();
+
+  return this->dataPtr->frameTimings.Summary();
 }
 
 /////////////////////////////////////////////////
@@ -950,24 +3116,16 @@ void IgnRenderer::Initialize()
   this->dataPtr->camera = scene->CreateCamera();
   root->AddChild(this->dataPtr->camera);
   this->dataPtr->camera->SetLocalPose(this->cameraPose);
+  this->dataPtr->renderSize = this->textureSize;
   this->dataPtr->camera->SetImageWidth(this->textureSize.width());
   this->dataPtr->camera->SetImageHeight(this->textureSize.height());
-  this->dataPtr->camera->SetAntiAliasing(8);
+  this->dataPtr->camera->SetAntiAliasing(this->dataPtr->antiAliasing);
   this->dataPtr->camera->SetHFOV(M_PI * 0.5);
   // setting the size and calling PreRender should cause the render texture to
   //  be rebuilt
   this->dataPtr->camera->PreRender();
   this->textureId = this->dataPtr->camera->RenderTextureGLId();
 
-  // Make service call to populate scene
-  if (!this->sceneService.empty())
-  {
-    this->dataPtr->sceneManager.Load(this->sceneService, this->poseTopic,
-                                     this->deletionTopic, this->sceneTopic,
-                                     scene);
-    this->dataPtr->sceneManager.Request();
-  }
-
   // Ray Query
   this->dataPtr->rayQuery = this->dataPtr->camera->Scene()->CreateRayQuery();
 
@@ -1000,18 +3158,35 @@ void IgnRenderer::NewMouseEvent(const common::MouseEvent &_e,
     const math::Vector2d &_drag)
 {
   std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
-  this->dataPtr->mouseEvent = _e;
-  this->dataPtr->drag += _drag;
-  this->dataPtr->mouseDirty = true;
+  auto &events = this->dataPtr->mouseEvents;
+  if (!events.empty())
+  {
+    auto &last = events.back();
+    bool sameScroll = _e.Type() == common::MouseEvent::SCROLL &&
+        last.event.Type() == common::MouseEvent::SCROLL &&
+        _e.Pos() == last.event.Pos();
+    bool sameDrag = _e.Type() == common::MouseEvent::MOVE &&
+        last.event.Type() == common::MouseEvent::MOVE &&
+        _e.Buttons() == last.event.Buttons() &&
+        _e.PressPos() == last.event.PressPos();
+    if (sameScroll || sameDrag)
+    {
+      last.event = _e;
+      last.drag += _drag;
+      return;
+    }
+  }
+  events.push_back({_e, _drag});
 }
 
 /////////////////////////////////////////////////
 math::Vector3d IgnRenderer::ScreenToScene(
     const math::Vector2i &_screenPos) const
 {
-  // Normalize point on the image
-  double width = this->dataPtr->camera->ImageWidth();
-  double height = this->dataPtr->camera->ImageHeight();
+  // Normalize point on the image. Screen coordinates are in item pixels,
+  // which may differ from the camera's while the resolution is scaled.
+  double width = this->textureSize.width();
+  double height = this->textureSize.height();
 
   double nx = 2.0 * _screenPos.X() / width - 1.0;
   double ny = 1.0 - 2.0 * _screenPos.Y() / height;
@@ -1029,33 +3204,480 @@ math::Vector3d IgnRenderer::ScreenToScene(
       this->dataPtr->rayQuery->Direction() * 10;
 }
 
-/////////////////////////////////////////////////
-RenderThread::RenderThread()
-{
-  RenderWindowItemPrivate::threads << this;
-}
+/////////////////////////////////////////////////
+rendering::ScenePtr IgnRenderer::Scene() const
+{
+  if (!this->dataPtr->camera)
+    return rendering::ScenePtr();
+  return this->dataPtr->camera->Scene();
+}
+
+/////////////////////////////////////////////////
+RenderThread::RenderThread(const std::string &_key)
+  : dataPtr(new RenderThreadPrivate)
+{
+  this->dataPtr->key = _key;
+  this->connect(this, &QThread::finished, this, &QObject::deleteLater);
+
+  // Without vsync, the scene graph takes textures as fast as they come, so
+  // frames are paced to the screen instead
+  auto options = Application::CurrentRenderOptions();
+  double fps = options.targetFps;
+  if (fps <= 0.0 && options.swapInterval == 0 &&
+      QGuiApplication::primaryScreen())
+  {
+    fps = QGuiApplication::primaryScreen()->refreshRate();
+  }
+  if (fps > 0.0)
+    this->dataPtr->framePeriod = std::chrono::duration<double>(1.0 / fps);
+}
+
+/////////////////////////////////////////////////
+RenderThread::~RenderThread()
+{
+}
+
+/////////////////////////////////////////////////
+void RenderThread::run()
+{
+#ifdef __linux__
+  if (!this->cpus.empty())
+  {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (auto cpu : this->cpus)
+    {
+      if (cpu >= 0 && cpu < CPU_SETSIZE)
+        CPU_SET(cpu, &set);
+    }
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0)
+    {
+      ignwarn << "Failed to set the CPU affinity of the render thread"
+              << std::endl;
+    }
+  }
+
+  auto priority = this->priority();
+  if (priority != QThread::InheritPriority &&
+      priority != QThread::NormalPriority &&
+      setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)),
+          NiceValue(priority)) != 0)
+  {
+    ignwarn << "Failed to set the priority of the render thread, raising "
+            << "it needs the CAP_SYS_NICE capability or a higher nice limit"
+            << std::endl;
+  }
+#else
+  if (!this->cpus.empty())
+  {
+    ignwarn << "Setting the CPU affinity of the render thread is only "
+            << "supported on Linux" << std::endl;
+  }
+#endif
+
+  this->exec();
+}
+
+/////////////////////////////////////////////////
+void RenderThread::Post(std::function<void()> _task)
+{
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->tasks.push_back(std::move(_task));
+  }
+  QMetaObject::invokeMethod(this, "RenderNext", Qt::QueuedConnection);
+}
+
+/////////////////////////////////////////////////
+void RenderThread::AddRenderer(IgnRenderer *_renderer)
+{
+  RenderThreadPrivate::Target target;
+  target.renderer = _renderer;
+  target.ready = true;
+  target.sceneChanged = true;
+
+  if (!_renderer->captureTopic.empty())
+  {
+    if (FrameCapture::Supported())
+    {
+      target.capture.reset(new FrameCapture());
+      target.capturePub = this->dataPtr->node.Advertise<msgs::Image>(
+          _renderer->captureTopic);
+    }
+    else
+    {
+      ignerr << "Capturing frames needs OpenGL 3.2 or OpenGL ES 3.0, not "
+             << "publishing on [" << _renderer->captureTopic << "]"
+             << std::endl;
+    }
+  }
+
+#ifdef HAVE_IGN_COMMON_AV
+  if (!_renderer->recordService.empty() || !_renderer->recordFile.empty())
+  {
+    if (FrameCapture::Supported())
+    {
+      target.recordCapture.reset(new FrameCapture());
+      target.recorder.reset(new VideoRecorder());
+      if (!_renderer->recordFile.empty())
+      {
+        auto format = common::lowercase(
+            common::basename(_renderer->recordFile));
+        auto dot = format.rfind('.');
+        format = dot == std::string::npos ? "mp4" : format.substr(dot + 1);
+        target.recorder->Start(_renderer->recordFile, format,
+            _renderer->recordFps, _renderer->recordBitRate);
+      }
+    }
+    else
+    {
+      ignerr << "Recording needs OpenGL 3.2 or OpenGL ES 3.0" << std::endl;
+    }
+  }
+
+  if (target.recorder && !_renderer->recordService.empty())
+  {
+    // The request is handled on this thread, before the next frame
+    std::function<bool(const msgs::VideoRecord &, msgs::Boolean &)> cb =
+        [this, _renderer](const msgs::VideoRecord &_req, msgs::Boolean &_res)
+        {
+          _res.set_data(_req.start() != _req.stop());
+          if (!_res.data())
+            return true;
+
+          this->Post([this, _renderer, _req]()
+          {
+            for (auto &t : this->dataPtr->targets)
+            {
+              if (t.renderer != _renderer)
+                continue;
+
+              if (_req.stop())
+              {
+                t.recorder->Stop();
+                break;
+              }
+
+              auto format = _req.format().empty() ? "mp4" : _req.format();
+              auto file = _req.save_filename().empty() ?
+                  "scene3d." + format : _req.save_filename();
+              t.recorder->Start(file, format, _renderer->recordFps,
+                  _renderer->recordBitRate);
+              break;
+            }
+          });
+          return true;
+        };
+    if (!this->dataPtr->node.Advertise(_renderer->recordService, cb))
+    {
+      ignerr << "Failed to advertise record service ["
+             << _renderer->recordService << "]" << std::endl;
+    }
+  }
+#endif
+
+  this->dataPtr->targets.push_back(std::move(target));
+}
+
+/////////////////////////////////////////////////
+void RenderThread::TextureConsumed(IgnRenderer *_renderer)
+{
+  for (auto &target : this->dataPtr->targets)
+  {
+    if (target.renderer != _renderer)
+      continue;
+
+    target.ready = true;
+
+    // Let the other windows catch up so their frames are rendered together
+    if (!this->dataPtr->scheduled)
+    {
+      this->dataPtr->scheduled = true;
+      QMetaObject::invokeMethod(this, "RenderNext", Qt::QueuedConnection);
+    }
+    return;
+  }
+}
+
+/////////////////////////////////////////////////
+void RenderThread::Release(IgnRenderer *_renderer)
+{
+  bool last;
+  {
+    std::lock_guard<std::mutex> lock(RenderWindowItemPrivate::threadsMutex);
+    last = --this->users == 0u;
+    if (last)
+      RenderWindowItemPrivate::threads.erase(this->dataPtr->key);
+  }
+
+  // Never started, so there's nothing to clean up on the thread
+  if (!this->isRunning())
+  {
+    if (last)
+    {
+      delete this->context;
+      delete this;
+    }
+    return;
+  }
+
+  this->Post([this, _renderer, last]()
+  {
+    if (_renderer)
+    {
+      auto &targets = this->dataPtr->targets;
+      for (auto it = targets.begin(); it != targets.end(); ++it)
+      {
+        if (it->renderer != _renderer)
+          continue;
+#ifdef HAVE_IGN_COMMON_AV
+        if (it->recorder && !_renderer->recordService.empty())
+          this->dataPtr->node.UnadvertiseSrv(_renderer->recordService);
+#endif
+        targets.erase(it);
+        break;
+      }
+
+      _renderer->Destroy();
+      delete _renderer;
+    }
+
+    if (last)
+      this->ShutDown();
+  });
+}
+
+/////////////////////////////////////////////////
+void RenderThread::RenderNext()
+{
+  this->dataPtr->scheduled = false;
+
+  if (!this->context)
+    return;
+
+  this->context->makeCurrent(this->surface);
+
+  std::vector<std::function<void()>> tasks;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    tasks.swap(this->dataPtr->tasks);
+  }
+  for (auto &task : tasks)
+  {
+    task();
+
+    // Shut down by the task
+    if (!this->context)
+      return;
+  }
+
+  // Publish frames read back since the last tick
+  for (auto &target : this->dataPtr->targets)
+  {
+    if (target.capture && target.capture->Take(target.image))
+      target.capturePub.Publish(target.image);
+#ifdef HAVE_IGN_COMMON_AV
+    if (target.recordCapture && target.recordCapture->Take(target.recordImage))
+    {
+      target.recorder->Push(target.recordImage,
+          std::chrono::steady_clock::now());
+    }
+#endif
+  }
+
+  // Keep to the target frame rate, the ready renderers are drawn once the
+  // period has passed
+  auto frameStart = std::chrono::steady_clock::now();
+  if (this->dataPtr->framePeriod.count() > 0.0)
+  {
+    std::chrono::duration<double, std::milli> wait =
+        this->dataPtr->lastRender + this->dataPtr->framePeriod - frameStart;
+    if (wait.count() > 0.0)
+    {
+      if (!this->dataPtr->pacing)
+      {
+        this->dataPtr->pacing = true;
+        QTimer::singleShot(static_cast<int>(std::ceil(wait.count())), this,
+            [this]()
+        {
+          this->dataPtr->pacing = false;
+          this->RenderNext();
+        });
+      }
+      return;
+    }
+  }
+
+  std::vector<RenderThreadPrivate::Target *> batch;
+  for (auto &target : this->dataPtr->targets)
+  {
+    if (!target.ready || target.renderer->suspended)
+      continue;
+
+    auto renderer = target.renderer;
+    if (!renderer->initialized)
+    {
+      // Initialize renderer
+      renderer->Initialize();
+
+      // check if engine has been successfully initialized
+      if (!renderer->initialized)
+      {
+        ignerr << "Unable to initialize renderer" << std::endl;
+        target.ready = false;
+        continue;
+      }
+
+      // Make service call to populate scene
+      if (!this->dataPtr->sceneLoaded && !renderer->sceneService.empty())
+      {
+        this->dataPtr->sceneManager.SetViewCulling(renderer->viewCulling);
+        this->dataPtr->sceneManager.SetResourceBudget(
+            renderer->resourceBudget);
+        this->dataPtr->sceneManager.SetLightBudget(renderer->lightBudget);
+        this->dataPtr->sceneManager.SetSceneCache(renderer->sceneCache);
+        this->dataPtr->sceneManager.SetInterpolatePoses(
+            renderer->interpolatePoses);
+        this->dataPtr->sceneManager.SetCompactPoses(renderer->compactPoses);
+        this->dataPtr->sceneManager.Load(renderer->sceneService,
+            renderer->poseTopic, renderer->deletionTopic,
+            renderer->sceneTopic, renderer->Scene());
+        this->dataPtr->sceneManager.Request();
+        this->dataPtr->sceneLoaded = true;
+      }
+    }
+    batch.push_back(&target);
+  }
+
+  if (batch.empty())
+    return;
+
+  // Move the cameras first, so the scene manager knows what they'll see
+  for (auto target : batch)
+    target->renderer->UpdateView();
+
+  std::vector<SceneManager::View> views;
+  if (this->dataPtr->targets.front().renderer->viewCulling)
+  {
+    for (const auto &target : this->dataPtr->targets)
+    {
+      auto renderer = target.renderer;
+      if (!renderer->initialized)
+        continue;
+
+      auto frustum = renderer->Frustum();
+      double pixelScale = renderer->RenderTextureSize().width() /
+          (2.0 * std::tan(frustum.FOV().Radian() * 0.5));
+      views.push_back({frustum, pixelScale});
+    }
+  }
+
+  // Update the scene once for all views, including the ones which are still
+  // waiting for their last texture to be consumed
+  auto start = std::chrono::steady_clock::now();
+  if (this->dataPtr->sceneManager.Update(
+      this->dataPtr->targets.front().renderer->updateBudget, views))
+  {
+    for (auto &target : this->dataPtr->targets)
+      target.sceneChanged = true;
+  }
+  auto updateTime = std::chrono::steady_clock::now() - start;
+  auto skippedWrites = this->dataPtr->sceneManager.SkippedWrites();
 
-/////////////////////////////////////////////////
-void RenderThread::RenderNext()
-{
-  this->context->makeCurrent(this->surface);
+  bool loading = this->dataPtr->sceneManager.Loading();
+  if (loading != this->loading)
+  {
+    this->loading = loading;
+    emit LoadingChanged(loading);
+  }
 
-  if (!this->ignRenderer.initialized)
+  std::vector<RenderThreadPrivate::Target *> rendered;
+  bool idle = false;
+  for (auto target : batch)
   {
-    // Initialize renderer
-    this->ignRenderer.Initialize();
+    auto renderer = target->renderer;
+    if (!renderer->Render(target->sceneChanged, updateTime, skippedWrites))
+    {
+      // Nothing new to show, keep the current texture and check again later
+      idle = true;
+      continue;
+    }
+
+    target->ready = false;
+    target->sceneChanged = false;
+    rendered.push_back(target);
+    emit TextureReady(renderer, renderer->textureId,
+        renderer->RenderTextureSize());
+
+    // Only read frames back while someone's listening
+    auto now = std::chrono::steady_clock::now();
+    if (target->capture && target->capturePub.HasConnections() &&
+        (renderer->captureRate <= 0.0 ||
+        now - target->lastCapture >= std::chrono::duration<double>(
+        1.0 / renderer->captureRate)))
+    {
+      target->capture->Read(renderer->textureId,
+          renderer->RenderTextureSize());
+      target->lastCapture = now;
+    }
+
+#ifdef HAVE_IGN_COMMON_AV
+    if (target->recorder && target->recorder->Recording() &&
+        now - target->lastRecord >= std::chrono::duration<double>(
+        1.0 / target->recorder->Fps()))
+    {
+      target->recordCapture->Read(renderer->textureId,
+          renderer->RenderTextureSize());
+      target->lastRecord = now;
+    }
+#endif
   }
 
-  // check if engine has been successfully initialized
-  if (!this->ignRenderer.initialized)
+  if (idle && !this->dataPtr->polling)
   {
-    ignerr << "Unable to initialize renderer" << std::endl;
+    this->dataPtr->polling = true;
+    QTimer::singleShot(kIdlePollInterval, this, [this]()
+    {
+      this->dataPtr->polling = false;
+      this->RenderNext();
+    });
+  }
+
+  if (rendered.empty())
     return;
+
+  this->dataPtr->lastRender = frameStart;
+
+  // Let other plugins know a frame was rendered, once for all views
+  start = std::chrono::steady_clock::now();
+  gui::events::Render renderEvent;
+  if (ignition::gui::App())
+  {
+    ignition::gui::App()->sendEvent(ignition::gui::App()->MainWin(),
+        &renderEvent);
   }
+  gui::EventBus::Instance().Publish(renderEvent);
+  gui::RenderHooks::Instance().Run();
+  auto renderEventTime = std::chrono::steady_clock::now() - start;
 
-  this->ignRenderer.Render();
+  auto now = std::chrono::steady_clock::now();
+  for (auto target : rendered)
+  {
+    auto renderer = target->renderer;
+    renderer->EndFrame(renderEventTime);
 
-  emit TextureReady(this->ignRenderer.textureId, this->ignRenderer.textureSize);
+    if (renderer->frameStatsEnabled &&
+        now - target->lastFrameStats >= std::chrono::seconds(1))
+    {
+      target->lastFrameStats = now;
+      auto stats = renderer->FrameStatsSummary();
+#ifdef HAVE_IGN_COMMON_AV
+      if (target->recorder && target->recorder->Recording())
+        stats += "\n" + target->recorder->Summary();
+#endif
+      emit FrameStatsReady(renderer, QString::fromStdString(stats));
+    }
+  }
 }
 
 /////////////////////////////////////////////////
@@ -1063,34 +3685,23 @@ void RenderThread::ShutDown()
 {
   this->context->makeCurrent(this->surface);
 
-  this->ignRenderer.Destroy();
+  for (auto &target : this->dataPtr->targets)
+  {
+    target.renderer->Destroy();
+    delete target.renderer;
+  }
+  this->dataPtr->targets.clear();
 
   this->context->doneCurrent();
   delete this->context;
+  this->context = nullptr;
 
   // schedule this to be deleted only after we're done cleaning up
   this->surface->deleteLater();
 
   // Stop event processing, move the thread to GUI and make sure it is deleted.
   this->moveToThread(QGuiApplication::instance()->thread());
-}
-
-
-/////////////////////////////////////////////////
-void RenderThread::SizeChanged()
-{
-  auto item = qobject_cast<QQuickItem *>(this->sender());
-  if (!item)
-  {
-    ignerr << "Internal error, sender is not QQuickItem." << std::endl;
-    return;
-  }
-
-  if (item->width() <= 0 || item->height() <= 0)
-    return;
-
-  this->ignRenderer.textureSize = QSize(item->width(), item->height());
-  this->ignRenderer.textureDirty = true;
+  this->quit();
 }
 
 /////////////////////////////////////////////////
@@ -1106,6 +3717,10 @@ TextureNode::TextureNode(QQuickWindow *_window)
       QQuickWindow::TextureIsOpaque);
 #endif
   this->setTexture(this->texture);
+
+  // The texture may be smaller than the item while the resolution is scaled
+  // down, smooth it when scaling up
+  this->setFiltering(QSGTexture::Linear);
 }
 
 /////////////////////////////////////////////////
@@ -1114,13 +3729,47 @@ TextureNode::~TextureNode()
   delete this->texture;
 }
 
+/////////////////////////////////////////////////
+/// \brief Get the functions needed for sync objects on the current context
+/// \return Functions, or null if sync objects aren't supported.
+static QOpenGLExtraFunctions *syncFunctions()
+{
+  auto context = QOpenGLContext::currentContext();
+  if (!context)
+    return nullptr;
+
+  auto version = context->format().version();
+  bool supported = context->isOpenGLES() ?
+      version >= qMakePair(3, 0) :
+      version >= qMakePair(3, 2) || context->hasExtension("GL_ARB_sync");
+
+  return supported ? context->extraFunctions() : nullptr;
+}
+
 /////////////////////////////////////////////////
 void TextureNode::NewTexture(int _id, const QSize &_size)
 {
-  this->mutex.lock();
-  this->id = _id;
-  this->size = _size;
-  this->mutex.unlock();
+  // This runs on the render thread, right after rendering the frame. Instead
+  // of blocking until the GPU is done, leave a fence for the scene graph to
+  // wait on.
+  auto gl = syncFunctions();
+
+  auto &frame = this->frames[this->nextFrame];
+  this->nextFrame = (this->nextFrame + 1u) % this->frames.size();
+  frame.id = _id;
+  frame.size = _size;
+  frame.fence = gl ? gl->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0) :
+      nullptr;
+  if (gl)
+    gl->glFlush();
+
+  // Drop the previous frame if the scene graph didn't get to it
+  auto dropped = this->pending.exchange(&frame);
+  if (dropped && dropped->fence && gl)
+  {
+    gl->glDeleteSync(dropped->fence);
+    dropped->fence = nullptr;
+  }
 
   // We cannot call QQuickWindow::update directly here, as this is only allowed
   // from the rendering thread or GUI thread.
@@ -1130,19 +3779,34 @@ void TextureNode::NewTexture(int _id, const QSize &_size)
 /////////////////////////////////////////////////
 void TextureNode::PrepareNode()
 {
-  this->mutex.lock();
-  int newId = this->id;
-  QSize sz = this->size;
-  this->id = 0;
-  this->mutex.unlock();
-  if (newId)
+  auto frame = this->pending.exchange(nullptr);
+  if (!frame || !frame->id)
+    return;
+
+  if (frame->fence)
+  {
+    // Make the scene graph's GL commands wait for the frame without blocking
+    // this thread. The render thread and the scene graph share contexts, so
+    // the fence is valid here.
+    auto gl = syncFunctions();
+    if (gl)
+    {
+      gl->glWaitSync(frame->fence, 0, GL_TIMEOUT_IGNORED);
+      gl->glDeleteSync(frame->fence);
+    }
+    frame->fence = nullptr;
+  }
+
+  // The render texture only changes when it's resized, so keep the wrapper
+  // until then
+  if (frame->id != this->textureId || frame->size != this->textureSize)
   {
     delete this->texture;
     // note: include QQuickWindow::TextureHasAlphaChannel if the rendered
     // content has alpha.
 #if QT_VERSION < QT_VERSION_CHECK(5, 14, 0)
     this->texture = this->window->createTextureFromId(
-        newId, sz, QQuickWindow::TextureIsOpaque);
+        frame->id, frame->size, QQuickWindow::TextureIsOpaque);
 #else
     // TODO(anyone) Use createTextureFromNativeObject
     // https://github.com/ignitionrobotics/ign-gui/issues/113
@@ -1151,20 +3815,22 @@ void TextureNode::PrepareNode()
 # pragma GCC diagnostic ignored "-Wdeprecated-declarations"
 #endif
     this->texture = this->window->createTextureFromId(
-        newId, sz, QQuickWindow::TextureIsOpaque);
+        frame->id, frame->size, QQuickWindow::TextureIsOpaque);
 #ifndef _WIN32
 # pragma GCC diagnostic pop
 #endif
 
 #endif
     this->setTexture(this->texture);
+    this->textureId = frame->id;
+    this->textureSize = frame->size;
+  }
 
-    this->markDirty(DirtyMaterial);
+  this->markDirty(DirtyMaterial);
 
-    // This will notify the rendering thread that the texture is now being
-    // rendered and it can start rendering to the other one.
-    emit TextureInUse();
-  }
+  // This will notify the rendering thread that the texture is now being
+  // rendered and it can start rendering the next frame.
+  emit TextureInUse();
 }
 
 /////////////////////////////////////////////////
@@ -1173,37 +3839,41 @@ RenderWindowItem::RenderWindowItem(QQuickItem *_parent)
 {
   this->setAcceptedMouseButtons(Qt::AllButtons);
   this->setFlag(ItemHasContents);
-  this->dataPtr->renderThread = new RenderThread();
+  this->dataPtr->ignRenderer = new IgnRenderer();
 }
 
 /////////////////////////////////////////////////
 RenderWindowItem::~RenderWindowItem()
 {
+  if (this->dataPtr->attached)
+  {
+    // The render thread owns the renderer now
+    this->dataPtr->renderThread->Release(this->dataPtr->ignRenderer);
+    return;
+  }
+
+  if (this->dataPtr->renderThread)
+    this->dataPtr->renderThread->Release(nullptr);
+  delete this->dataPtr->ignRenderer;
 }
 
 /////////////////////////////////////////////////
 void RenderWindowItem::Ready()
 {
-  this->dataPtr->renderThread->surface = new QOffscreenSurface();
-  this->dataPtr->renderThread->surface->setFormat(
-      this->dataPtr->renderThread->context->format());
-  this->dataPtr->renderThread->surface->create();
-
-  this->dataPtr->renderThread->ignRenderer.textureSize =
-      QSize(std::max({this->width(), 1.0}), std::max({this->height(), 1.0}));
+  auto thread = this->dataPtr->renderThread;
 
-  this->dataPtr->renderThread->moveToThread(this->dataPtr->renderThread);
-
-  this->connect(this, &QObject::destroyed,
-      this->dataPtr->renderThread, &RenderThread::ShutDown,
-      Qt::QueuedConnection);
+  // Another window showing the same scene may have started the thread
+  if (!thread->surface)
+  {
+    thread->surface = new QOffscreenSurface();
+    thread->surface->setFormat(thread->context->format());
+    thread->surface->create();
 
-  this->connect(this, &QQuickItem::widthChanged,
-      this->dataPtr->renderThread, &RenderThread::SizeChanged);
-  this->connect(this, &QQuickItem::heightChanged,
-      this->dataPtr->renderThread, &RenderThread::SizeChanged);
+    thread->cpus = this->dataPtr->ignRenderer->threadCpus;
+    thread->moveToThread(thread);
+    thread->start(this->dataPtr->ignRenderer->threadPriority);
+  }
 
-  this->dataPtr->renderThread->start();
   this->update();
 }
 
@@ -1213,23 +3883,47 @@ QSGNode *RenderWindowItem::updatePaintNode(QSGNode *_node,
 {
   TextureNode *node = static_cast<TextureNode *>(_node);
 
-  if (!this->dataPtr->renderThread->context)
+  if (!this->dataPtr->renderThread)
   {
-    QOpenGLContext *current = this->window()->openglContext();
-    // Some GL implementations require that the currently bound context is
-    // made non-current before we set up sharing, so we doneCurrent here
-    // and makeCurrent down below while setting up our own context.
-    current->doneCurrent();
-
-    this->dataPtr->renderThread->context = new QOpenGLContext();
-    this->dataPtr->renderThread->context->setFormat(current->format());
-    this->dataPtr->renderThread->context->setShareContext(current);
-    this->dataPtr->renderThread->context->create();
-    this->dataPtr->renderThread->context->moveToThread(
-        this->dataPtr->renderThread);
+    auto key = this->dataPtr->ignRenderer->engineName + "/" +
+        this->dataPtr->ignRenderer->sceneName;
 
-    current->makeCurrent(this->window());
+    std::lock_guard<std::mutex> lock(RenderWindowItemPrivate::threadsMutex);
+    auto &thread = RenderWindowItemPrivate::threads[key];
+    if (thread)
+    {
+      ++thread->users;
+      this->dataPtr->renderThread = thread;
+    }
+    else
+    {
+      thread = new RenderThread(key);
+      thread->users = 1u;
+      this->dataPtr->renderThread = thread;
+
+      QOpenGLContext *current = this->window()->openglContext();
+      // Some GL implementations require that the currently bound context is
+      // made non-current before we set up sharing, so we doneCurrent here
+      // and makeCurrent down below while setting up our own context.
+      current->doneCurrent();
+
+      thread->context = new QOpenGLContext();
+      thread->context->setFormat(current->format());
+      thread->context->setShareContext(current);
+      thread->context->create();
+      thread->context->moveToThread(thread);
+
+      current->makeCurrent(this->window());
+
+      QMetaObject::invokeMethod(this, "Ready");
+      return nullptr;
+    }
+  }
 
+  auto thread = this->dataPtr->renderThread;
+  if (!thread->isRunning())
+  {
+    // The window which created the thread may be gone before starting it
     QMetaObject::invokeMethod(this, "Ready");
     return nullptr;
   }
@@ -1249,24 +3943,70 @@ QSGNode *RenderWindowItem::updatePaintNode(QSGNode *_node,
     // When the scene graph starts rendering the next frame, the PrepareNode()
     // function is used to update the node with the new texture. Once it
     // completes, it emits TextureInUse() which we connect to the rendering
-    // thread's RenderNext() to have it start producing content into its render
-    // texture.
+    // thread's TextureConsumed() to have it start producing content into its
+    // render texture.
     //
     // This rendering pipeline is throttled by vsync on the scene graph
-    // rendering thread.
+    // rendering thread. The rendering thread is shared by all windows showing
+    // the same scene, so each node only picks the textures of its own
+    // renderer.
 
-    this->connect(this->dataPtr->renderThread, &RenderThread::TextureReady,
-        node, &TextureNode::NewTexture, Qt::DirectConnection);
+    auto renderer = this->dataPtr->ignRenderer;
+    this->connect(thread, &RenderThread::TextureReady, node,
+        [node, renderer](IgnRenderer *_renderer, int _id, const QSize &_size)
+        {
+          if (_renderer == renderer)
+            node->NewTexture(_id, _size);
+        }, Qt::DirectConnection);
     this->connect(node, &TextureNode::PendingNewTexture, this->window(),
         &QQuickWindow::update, Qt::QueuedConnection);
     this->connect(this->window(), &QQuickWindow::beforeRendering, node,
         &TextureNode::PrepareNode, Qt::DirectConnection);
-    this->connect(node, &TextureNode::TextureInUse, this->dataPtr->renderThread,
-        &RenderThread::RenderNext, Qt::QueuedConnection);
+    this->connect(node, &TextureNode::TextureInUse, thread,
+        [thread, renderer]()
+        {
+          thread->TextureConsumed(renderer);
+        }, Qt::QueuedConnection);
+
+    this->connect(thread, &RenderThread::FrameStatsReady, this,
+        [this, renderer](IgnRenderer *_renderer, const QString &_stats)
+        {
+          if (_renderer == renderer)
+          {
+            QMetaObject::invokeMethod(this, "OnFrameStats",
+                Qt::QueuedConnection, Q_ARG(QString, _stats));
+          }
+        }, Qt::DirectConnection);
+
+    this->connect(thread, &RenderThread::LoadingChanged, this,
+        &RenderWindowItem::OnLoadingChanged, Qt::QueuedConnection);
+    bool loading = thread->loading;
+    QMetaObject::invokeMethod(this, "OnLoadingChanged", Qt::QueuedConnection,
+        Q_ARG(bool, loading));
+
+    auto resize = [this, thread, renderer]()
+    {
+      if (this->width() <= 0 || this->height() <= 0)
+        return;
+
+      QSize size(this->width(), this->height());
+      thread->Post([renderer, size]()
+      {
+        renderer->textureSize = size;
+        renderer->textureDirty = true;
+      });
+    };
+    this->connect(this, &QQuickItem::widthChanged, this, resize);
+    this->connect(this, &QQuickItem::heightChanged, this, resize);
 
     // Get the production of FBO textures started..
-    QMetaObject::invokeMethod(this->dataPtr->renderThread, "RenderNext",
-        Qt::QueuedConnection);
+    renderer->textureSize =
+        QSize(std::max({this->width(), 1.0}), std::max({this->height(), 1.0}));
+    this->dataPtr->attached = true;
+    thread->Post([thread, renderer]()
+    {
+      thread->AddRenderer(renderer);
+    });
   }
 
   node->setRect(this->boundingRect());
@@ -1277,55 +4017,202 @@ QSGNode *RenderWindowItem::updatePaintNode(QSGNode *_node,
 /////////////////////////////////////////////////
 void RenderWindowItem::SetBackgroundColor(const math::Color &_color)
 {
-  this->dataPtr->renderThread->ignRenderer.backgroundColor = _color;
+  this->dataPtr->ignRenderer->backgroundColor = _color;
 }
 
 /////////////////////////////////////////////////
 void RenderWindowItem::SetAmbientLight(const math::Color &_ambient)
 {
-  this->dataPtr->renderThread->ignRenderer.ambientLight = _ambient;
+  this->dataPtr->ignRenderer->ambientLight = _ambient;
 }
 
 /////////////////////////////////////////////////
 void RenderWindowItem::SetEngineName(const std::string &_name)
 {
-  this->dataPtr->renderThread->ignRenderer.engineName = _name;
+  this->dataPtr->ignRenderer->engineName = _name;
 }
 
 /////////////////////////////////////////////////
 void RenderWindowItem::SetSceneName(const std::string &_name)
 {
-  this->dataPtr->renderThread->ignRenderer.sceneName = _name;
+  this->dataPtr->ignRenderer->sceneName = _name;
 }
 
 /////////////////////////////////////////////////
 void RenderWindowItem::SetCameraPose(const math::Pose3d &_pose)
 {
-  this->dataPtr->renderThread->ignRenderer.cameraPose = _pose;
+  this->dataPtr->ignRenderer->cameraPose = _pose;
 }
 
 /////////////////////////////////////////////////
 void RenderWindowItem::SetSceneService(const std::string &_service)
 {
-  this->dataPtr->renderThread->ignRenderer.sceneService = _service;
+  this->dataPtr->ignRenderer->sceneService = _service;
 }
 
 /////////////////////////////////////////////////
 void RenderWindowItem::SetPoseTopic(const std::string &_topic)
 {
-  this->dataPtr->renderThread->ignRenderer.poseTopic = _topic;
+  this->dataPtr->ignRenderer->poseTopic = _topic;
 }
 
 /////////////////////////////////////////////////
 void RenderWindowItem::SetDeletionTopic(const std::string &_topic)
 {
-  this->dataPtr->renderThread->ignRenderer.deletionTopic = _topic;
+  this->dataPtr->ignRenderer->deletionTopic = _topic;
 }
 
 /////////////////////////////////////////////////
 void RenderWindowItem::SetSceneTopic(const std::string &_topic)
 {
-  this->dataPtr->renderThread->ignRenderer.sceneTopic = _topic;
+  this->dataPtr->ignRenderer->sceneTopic = _topic;
+}
+
+/////////////////////////////////////////////////
+void RenderWindowItem::SetRenderOnDemand(const bool _onDemand)
+{
+  this->dataPtr->ignRenderer->renderOnDemand = _onDemand;
+}
+
+/////////////////////////////////////////////////
+void RenderWindowItem::SetMaxIdleInterval(
+    const std::chrono::milliseconds &_interval)
+{
+  this->dataPtr->ignRenderer->maxIdleInterval = _interval;
+}
+
+/////////////////////////////////////////////////
+void RenderWindowItem::SetUpdateBudget(
+    const std::chrono::milliseconds &_budget)
+{
+  this->dataPtr->ignRenderer->updateBudget = _budget;
+}
+
+/////////////////////////////////////////////////
+void RenderWindowItem::SetViewCulling(const bool _viewCulling)
+{
+  this->dataPtr->ignRenderer->viewCulling = _viewCulling;
+}
+
+/////////////////////////////////////////////////
+void RenderWindowItem::SetResourceBudget(const std::size_t _bytes)
+{
+  this->dataPtr->ignRenderer->resourceBudget = _bytes;
+}
+
+/////////////////////////////////////////////////
+void RenderWindowItem::SetLightBudget(const std::size_t _count)
+{
+  this->dataPtr->ignRenderer->lightBudget = _count;
+}
+
+/////////////////////////////////////////////////
+void RenderWindowItem::SetRenderThreadScheduling(
+    const QThread::Priority _priority, const std::vector<int> &_cpus)
+{
+  this->dataPtr->ignRenderer->threadPriority = _priority;
+  this->dataPtr->ignRenderer->threadCpus = _cpus;
+}
+
+/////////////////////////////////////////////////
+void RenderWindowItem::SetRecording(const std::string &_service,
+    const std::string &_file, const unsigned int _fps,
+    const unsigned int _bitRate)
+{
+  this->dataPtr->ignRenderer->recordService = _service;
+  this->dataPtr->ignRenderer->recordFile = _file;
+  this->dataPtr->ignRenderer->recordFps = _fps;
+  this->dataPtr->ignRenderer->recordBitRate = _bitRate;
+}
+
+/////////////////////////////////////////////////
+void RenderWindowItem::SetInterpolatePoses(const bool _interpolate)
+{
+  this->dataPtr->ignRenderer->interpolatePoses = _interpolate;
+}
+
+/////////////////////////////////////////////////
+void RenderWindowItem::SetCompactPoses(const bool _compact)
+{
+  this->dataPtr->ignRenderer->compactPoses = _compact;
+}
+
+/////////////////////////////////////////////////
+void RenderWindowItem::SetCapture(const std::string &_topic,
+    const double _rate)
+{
+  this->dataPtr->ignRenderer->captureTopic = _topic;
+  this->dataPtr->ignRenderer->captureRate = _rate;
+}
+
+/////////////////////////////////////////////////
+void RenderWindowItem::SetSceneCache(const bool _sceneCache)
+{
+  this->dataPtr->ignRenderer->sceneCache = _sceneCache;
+}
+
+/////////////////////////////////////////////////
+void RenderWindowItem::SetTargetFrameTime(const double _target,
+    const double _minScale)
+{
+  this->dataPtr->ignRenderer->targetFrameTime = _target;
+  this->dataPtr->ignRenderer->minResolutionScale = _minScale;
+}
+
+/////////////////////////////////////////////////
+void RenderWindowItem::SetSuspended(const bool _suspended)
+{
+  this->dataPtr->ignRenderer->suspended = _suspended;
+
+  if (!_suspended && this->dataPtr->attached)
+  {
+    QMetaObject::invokeMethod(this->dataPtr->renderThread, "RenderNext",
+        Qt::QueuedConnection);
+    this->update();
+  }
+}
+
+/////////////////////////////////////////////////
+QString RenderWindowItem::FrameStats() const
+{
+  return this->dataPtr->frameStats;
+}
+
+/////////////////////////////////////////////////
+bool RenderWindowItem::ShowFrameStats() const
+{
+  return this->dataPtr->showFrameStats;
+}
+
+/////////////////////////////////////////////////
+void RenderWindowItem::SetShowFrameStats(const bool _show)
+{
+  this->dataPtr->showFrameStats = _show;
+  this->dataPtr->ignRenderer->frameStatsEnabled = _show;
+  this->ShowFrameStatsChanged();
+}
+
+/////////////////////////////////////////////////
+bool RenderWindowItem::Loading() const
+{
+  return this->dataPtr->loading;
+}
+
+/////////////////////////////////////////////////
+void RenderWindowItem::OnLoadingChanged(const bool _loading)
+{
+  if (this->dataPtr->loading == _loading)
+    return;
+
+  this->dataPtr->loading = _loading;
+  this->LoadingChanged();
+}
+
+/////////////////////////////////////////////////
+void RenderWindowItem::OnFrameStats(const QString &_stats)
+{
+  this->dataPtr->frameStats = _stats;
+  this->FrameStatsChanged();
 }
 
 /////////////////////////////////////////////////
@@ -1341,6 +4228,28 @@ Scene3D::~Scene3D()
 {
 }
 
+/////////////////////////////////////////////////
+bool Scene3D::KeepLoaded() const
+{
+  return true;
+}
+
+/////////////////////////////////////////////////
+void Scene3D::Suspend()
+{
+  auto renderWindow = this->PluginItem()->findChild<RenderWindowItem *>();
+  if (renderWindow)
+    renderWindow->SetSuspended(true);
+}
+
+/////////////////////////////////////////////////
+void Scene3D::Resume()
+{
+  auto renderWindow = this->PluginItem()->findChild<RenderWindowItem *>();
+  if (renderWindow)
+    renderWindow->SetSuspended(false);
+}
+
 /////////////////////////////////////////////////
 void Scene3D::LoadConfig(const tinyxml2::XMLElement *_pluginElem)
 {
@@ -1431,6 +4340,191 @@ void Scene3D::LoadConfig(const tinyxml2::XMLElement *_pluginElem)
       std::string topic = elem->GetText();
       renderWindow->SetSceneTopic(topic);
     }
+
+    elem = _pluginElem->FirstChildElement("render_on_demand");
+    if (nullptr != elem)
+    {
+      bool onDemand = false;
+      elem->QueryBoolText(&onDemand);
+      renderWindow->SetRenderOnDemand(onDemand);
+    }
+
+    elem = _pluginElem->FirstChildElement("max_idle_interval");
+    if (nullptr != elem)
+    {
+      int interval = 1000;
+      elem->QueryIntText(&interval);
+      renderWindow->SetMaxIdleInterval(
+          std::chrono::milliseconds(std::max(interval, 0)));
+    }
+
+    elem = _pluginElem->FirstChildElement("target_frame_time");
+    if (nullptr != elem)
+    {
+      double target = 0.0;
+      elem->QueryDoubleText(&target);
+
+      double minScale = 0.5;
+      auto scaleElem = _pluginElem->FirstChildElement("min_resolution_scale");
+      if (nullptr != scaleElem)
+        scaleElem->QueryDoubleText(&minScale);
+
+      renderWindow->SetTargetFrameTime(std::max(target, 0.0),
+          math::clamp(minScale, 0.1, 1.0));
+    }
+
+    elem = _pluginElem->FirstChildElement("frame_stats");
+    if (nullptr != elem)
+    {
+      bool frameStats = false;
+      elem->QueryBoolText(&frameStats);
+      renderWindow->SetShowFrameStats(frameStats);
+    }
+
+    elem = _pluginElem->FirstChildElement("update_budget");
+    if (nullptr != elem)
+    {
+      int budget = 0;
+      elem->QueryIntText(&budget);
+      renderWindow->SetUpdateBudget(
+          std::chrono::milliseconds(std::max(budget, 0)));
+    }
+
+    elem = _pluginElem->FirstChildElement("view_culling");
+    if (nullptr != elem)
+    {
+      bool viewCulling = false;
+      elem->QueryBoolText(&viewCulling);
+      renderWindow->SetViewCulling(viewCulling);
+    }
+
+    elem = _pluginElem->FirstChildElement("resource_budget");
+    if (nullptr != elem)
+    {
+      double megabytes = 0.0;
+      elem->QueryDoubleText(&megabytes);
+      renderWindow->SetResourceBudget(
+          static_cast<std::size_t>(std::max(megabytes, 0.0) * 1024 * 1024));
+
+      bool viewCulling = false;
+      auto cullElem = _pluginElem->FirstChildElement("view_culling");
+      if (nullptr != cullElem)
+        cullElem->QueryBoolText(&viewCulling);
+      if (megabytes > 0.0 && !viewCulling)
+      {
+        ignwarn << "<resource_budget> needs <view_culling>, ignoring it"
+                << std::endl;
+      }
+    }
+
+    elem = _pluginElem->FirstChildElement("light_budget");
+    if (nullptr != elem)
+    {
+      int count = 0;
+      elem->QueryIntText(&count);
+      renderWindow->SetLightBudget(
+          static_cast<std::size_t>(std::max(count, 0)));
+    }
+
+    auto priority = QThread::InheritPriority;
+    elem = _pluginElem->FirstChildElement("render_thread_priority");
+    if (nullptr != elem && nullptr != elem->GetText())
+    {
+      auto it = kThreadPriorities.find(common::lowercase(elem->GetText()));
+      if (it != kThreadPriorities.end())
+      {
+        priority = it->second;
+      }
+      else
+      {
+        ignerr << "Unknown <render_thread_priority> [" << elem->GetText()
+               << "], using the default" << std::endl;
+      }
+    }
+
+    std::vector<int> cpus;
+    elem = _pluginElem->FirstChildElement("render_thread_cpus");
+    if (nullptr != elem && nullptr != elem->GetText())
+    {
+      std::istringstream stream(elem->GetText());
+      int cpu;
+      while (stream >> cpu)
+        cpus.push_back(cpu);
+      if (!stream.eof() || cpus.empty())
+      {
+        ignerr << "Failed to parse <render_thread_cpus> ["
+               << elem->GetText() << "], expected CPU indices" << std::endl;
+        cpus.clear();
+      }
+    }
+    renderWindow->SetRenderThreadScheduling(priority, cpus);
+
+    elem = _pluginElem->FirstChildElement("interpolate_poses");
+    if (nullptr != elem)
+    {
+      bool interpolate = false;
+      elem->QueryBoolText(&interpolate);
+      renderWindow->SetInterpolatePoses(interpolate);
+    }
+
+    elem = _pluginElem->FirstChildElement("compact_poses");
+    if (nullptr != elem)
+    {
+      bool compact = false;
+      elem->QueryBoolText(&compact);
+      renderWindow->SetCompactPoses(compact);
+    }
+
+    elem = _pluginElem->FirstChildElement("capture_topic");
+    if (nullptr != elem && nullptr != elem->GetText())
+    {
+      double rate = 10.0;
+      auto rateElem = _pluginElem->FirstChildElement("capture_rate");
+      if (nullptr != rateElem)
+        rateElem->QueryDoubleText(&rate);
+
+      renderWindow->SetCapture(elem->GetText(), rate);
+    }
+
+    std::string recordService;
+    elem = _pluginElem->FirstChildElement("record_service");
+    if (nullptr != elem && nullptr != elem->GetText())
+      recordService = elem->GetText();
+
+    std::string recordFile;
+    elem = _pluginElem->FirstChildElement("record_file");
+    if (nullptr != elem && nullptr != elem->GetText())
+      recordFile = elem->GetText();
+
+    if (!recordService.empty() || !recordFile.empty())
+    {
+#ifdef HAVE_IGN_COMMON_AV
+      int fps = 25;
+      elem = _pluginElem->FirstChildElement("record_fps");
+      if (nullptr != elem)
+        elem->QueryIntText(&fps);
+
+      int bitRate = 4000000;
+      elem = _pluginElem->FirstChildElement("record_bitrate");
+      if (nullptr != elem)
+        elem->QueryIntText(&bitRate);
+
+      renderWindow->SetRecording(recordService, recordFile,
+          static_cast<unsigned int>(std::max(fps, 1)),
+          static_cast<unsigned int>(std::max(bitRate, 1)));
+#else
+      ignwarn << "Recording isn't available, ignition-gui was built "
+              << "without ignition-common's av component" << std::endl;
+#endif
+    }
+
+    elem = _pluginElem->FirstChildElement("scene_cache");
+    if (nullptr != elem)
+    {
+      bool sceneCache = false;
+      elem->QueryBoolText(&sceneCache);
+      renderWindow->SetSceneCache(sceneCache);
+    }
   }
 }
 
@@ -1442,7 +4536,7 @@ void RenderWindowItem::mousePressEvent(QMouseEvent *_e)
   event.SetPressPos(event.Pos());
   this->dataPtr->mouseEvent = event;
 
-  this->dataPtr->renderThread->ignRenderer.NewMouseEvent(
+  this->dataPtr->ignRenderer->NewMouseEvent(
       this->dataPtr->mouseEvent);
 }
 
@@ -1451,7 +4545,7 @@ void RenderWindowItem::mouseReleaseEvent(QMouseEvent *_e)
 {
   this->dataPtr->mouseEvent = convert(*_e);
 
-  this->dataPtr->renderThread->ignRenderer.NewMouseEvent(
+  this->dataPtr->ignRenderer->NewMouseEvent(
       this->dataPtr->mouseEvent);
 }
 
@@ -1467,7 +4561,7 @@ void RenderWindowItem::mouseMoveEvent(QMouseEvent *_e)
   auto dragInt = event.Pos() - this->dataPtr->mouseEvent.Pos();
   auto dragDistance = math::Vector2d(dragInt.X(), dragInt.Y());
 
-  this->dataPtr->renderThread->ignRenderer.NewMouseEvent(event, dragDistance);
+  this->dataPtr->ignRenderer->NewMouseEvent(event, dragDistance);
   this->dataPtr->mouseEvent = event;
 }
 
@@ -1481,7 +4575,7 @@ void RenderWindowItem::wheelEvent(QWheelEvent *_e)
   this->dataPtr->mouseEvent.SetPos(_e->position().x(), _e->position().y());
 #endif
   double scroll = (_e->angleDelta().y() > 0) ? -1.0 : 1.0;
-  this->dataPtr->renderThread->ignRenderer.NewMouseEvent(
+  this->dataPtr->ignRenderer->NewMouseEvent(
       this->dataPtr->mouseEvent, math::Vector2d(scroll, scroll));
 }
 
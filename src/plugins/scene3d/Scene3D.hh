@@ -18,17 +18,30 @@
 #ifndef IGNITION_GUI_PLUGINS_SCENE3D_HH_
 #define IGNITION_GUI_PLUGINS_SCENE3D_HH_
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include <string>
 #include <memory>
 #include <mutex>
 
 #include <ignition/math/Color.hh>
+#include <ignition/math/Frustum.hh>
 #include <ignition/math/Pose3.hh>
 #include <ignition/math/Vector2.hh>
 #include <ignition/math/Vector3.hh>
 
 #include <ignition/common/MouseEvent.hh>
 
+#ifdef _MSC_VER
+#pragma warning(push, 0)
+#endif
+#include <ignition/rendering/RenderTypes.hh>
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
 #include "ignition/gui/qt.h"
 #include "ignition/gui/Plugin.hh"
 
@@ -39,6 +52,7 @@ namespace gui
 namespace plugins
 {
   class IgnRendererPrivate;
+  class RenderThreadPrivate;
   class RenderWindowItemPrivate;
   class Scene3DPrivate;
 
@@ -58,6 +72,97 @@ namespace plugins
   ///                          (0.3, 0.3, 0.3, 1.0)
   /// * \<camera_pose\> : Optional starting pose for the camera, defaults to
   ///                     (0, 0, 5, 0, 0, 0)
+  /// * \<render_on_demand\> : Optional, set to true to only render a new
+  ///                          frame when the scene, the camera or the texture
+  ///                          size changed. Defaults to false, which renders
+  ///                          continuously.
+  /// * \<max_idle_interval\> : Optional maximum time in milliseconds between
+  ///                           frames while rendering on demand, so changes
+  ///                           made by other plugins are eventually shown.
+  ///                           Defaults to 1000.
+  /// * \<update_budget\> : Optional time in milliseconds to spend on scene
+  ///                       updates per frame. Deletions and new entities
+  ///                       which don't fit are carried over to the next
+  ///                       frame. Defaults to 4, set to 0 for no limit.
+  /// * \<target_frame_time\> : Optional frame time in milliseconds. When set,
+  ///                           the render resolution and anti-aliasing are
+  ///                           lowered while frames take longer than this,
+  ///                           and raised again when there's headroom.
+  ///                           Defaults to 0, which always renders at full
+  ///                           quality.
+  /// * \<min_resolution_scale\> : Optional lowest fraction of the full
+  ///                              resolution used to meet the target frame
+  ///                              time, defaults to 0.5.
+  /// * \<frame_stats\> : Optional, set to true to time the stages of each
+  ///                     frame and show rolling statistics over the view.
+  ///                     Defaults to false.
+  /// * \<view_culling\> : Optional, set to true to hold back pose updates of
+  ///                      models which are outside of all views or too small
+  ///                      to cover a pixel, until they can be seen again.
+  ///                      Meant for large worlds where most models are
+  ///                      off-screen. Defaults to false.
+  /// * \<resource_budget\> : Optional memory in megabytes which the meshes
+  ///                         and textures of models may take. Past it, the
+  ///                         models which weren't seen for the longest
+  ///                         release their meshes, which are loaded again
+  ///                         once they come into view. Needs view culling.
+  ///                         Defaults to 0, for no limit.
+  /// * \<light_budget\> : Optional number of point and spot lights enabled
+  ///                      at once. The lights which matter the least for
+  ///                      the camera, by brightness, range and distance,
+  ///                      are disabled. Defaults to 0, for no limit.
+  /// * \<render_thread_priority\> : Optional priority of the render thread,
+  ///                                one of idle, lowest, low, normal, high,
+  ///                                highest and time_critical. On Linux,
+  ///                                it also sets the thread's nice value,
+  ///                                which needs privileges to go above
+  ///                                normal. Defaults to the GUI thread's.
+  /// * \<render_thread_cpus\> : Optional space separated CPU indices the
+  ///                            render thread may run on. Linux only.
+  /// * \<interpolate_poses\> : Optional, set to true to move entities
+  ///                           smoothly between the poses received instead
+  ///                           of jumping to the latest one. Entities are
+  ///                           shown slightly in the past, and extrapolated
+  ///                           briefly when poses are late. Needs stamped
+  ///                           pose msgs. Defaults to false.
+  /// * \<compact_poses\> : Optional, set to true if the pose topic carries
+  ///                       frames made by an ignition::gui::PoseEncoder as
+  ///                       ignition::msgs::Bytes, which only hold the
+  ///                       entities which moved, at a fraction of the
+  ///                       size. Meant for GUIs on slow links. Defaults to
+  ///                       false.
+  /// * \<capture_topic\> : Optional topic to publish rendered frames on, as
+  ///                       ignition::msgs::Image in RGBA. Frames are read
+  ///                       back asynchronously and only while there are
+  ///                       subscribers. Needs OpenGL 3.2 or OpenGL ES 3.0.
+  /// * \<capture_rate\> : Optional maximum rate in Hz at which frames are
+  ///                      published on the capture topic, defaults to 10.
+  ///                      Set to 0 to publish every rendered frame.
+  /// * \<record_service\> : Optional service which starts and stops
+  ///                        recording the scene to a video file, taking
+  ///                        ignition::msgs::VideoRecord. Frames are read
+  ///                        back like captured frames and encoded on a
+  ///                        background thread. They're dropped while the
+  ///                        encoder is behind. Needs OpenGL 3.2 or OpenGL
+  ///                        ES 3.0, and ignition-gui built with
+  ///                        ignition-common's av component.
+  /// * \<record_file\> : Optional video file to start recording to right
+  ///                     away, such as scene.mp4. Stopped through the
+  ///                     record service, or when the plugin is closed.
+  /// * \<record_fps\> : Optional frame rate of recorded videos, defaults to
+  ///                    25.
+  /// * \<record_bitrate\> : Optional bit rate of recorded videos, defaults
+  ///                        to 4000000.
+  /// * \<scene_cache\> : Optional, set to true to save the scene received
+  ///                     from the scene service under
+  ///                     ~/.ignition/gui/scene_cache, and show it right away
+  ///                     the next time while waiting for the service. The
+  ///                     live scene then replaces it. Defaults to false.
+  ///
+  /// All Scene3D plugins showing the same engine and scene share a render
+  /// thread, which updates the scene once per frame and then renders every
+  /// view. The scene service, topics, update budget and view culling setting
+  /// of the first view to be shown are used for all of them.
   class Scene3D : public Plugin
   {
     Q_OBJECT
@@ -72,6 +177,17 @@ namespace plugins
     public: virtual void LoadConfig(const tinyxml2::XMLElement *_pluginElem)
         override;
 
+    /// \brief The render window item is registered with QML, and render
+    /// engines may keep resources of the library.
+    /// \return True
+    public: bool KeepLoaded() const override;
+
+    // Documentation inherited
+    protected: void Suspend() override;
+
+    // Documentation inherited
+    protected: void Resume() override;
+
     /// \internal
     /// \brief Pointer to private data.
     private: std::unique_ptr<Scene3DPrivate> dataPtr;
@@ -91,8 +207,33 @@ namespace plugins
     ///  \brief Destructor
     public: ~IgnRenderer();
 
-    ///  \brief Main render function
-    public: void Render();
+    ///  \brief Main render function. The scene must have been updated for
+    /// this frame already.
+    /// \param[in] _sceneChanged True if the scene changed since the last
+    /// frame rendered by this renderer.
+    /// \param[in] _updateTime Time spent updating the scene for this frame.
+    /// \param[in] _skippedWrites Number of unchanged poses the scene update
+    /// didn't write to the scene graph.
+    /// \return True if a new frame was rendered, false if rendering was
+    /// skipped because nothing changed while rendering on demand.
+    public: bool Render(const bool _sceneChanged,
+        const std::chrono::steady_clock::duration &_updateTime,
+        const std::size_t _skippedWrites = 0u);
+
+    /// \brief Apply the mouse input received since the last frame to the
+    /// camera. Called before the scene is updated for the frame, so that the
+    /// scene manager knows what the camera will see.
+    public: void UpdateView();
+
+    /// \brief Get the frustum of the camera
+    /// \return Camera frustum, or a default frustum if not initialized
+    public: math::Frustum Frustum() const;
+
+    /// \brief Finish the frame timing of the last frame rendered.
+    /// \param[in] _renderEventTime Time spent handling the render event sent
+    /// after the frame.
+    public: void EndFrame(
+        const std::chrono::steady_clock::duration &_renderEventTime);
 
     /// \brief Initialize the render engine
     public: void Initialize();
@@ -100,6 +241,10 @@ namespace plugins
     /// \brief Destroy camera associated with this renderer
     public: void Destroy();
 
+    /// \brief Get the scene this renderer draws
+    /// \return The scene, or null if not initialized
+    public: rendering::ScenePtr Scene() const;
+
     /// \brief New mouse event triggered
     /// \param[in] _e New mouse event
     /// \param[in] _drag Mouse move distance
@@ -107,7 +252,23 @@ namespace plugins
         const math::Vector2d &_drag = math::Vector2d::Zero);
 
     /// \brief Handle mouse event for view control
-    private: void HandleMouseEvent();
+    /// \return True if there was a mouse event to be handled.
+    private: bool HandleMouseEvent();
+
+    /// \brief Lower or raise the render resolution and anti-aliasing to
+    /// stay close to targetFrameTime.
+    /// \param[in] _frameTime How long the last frame took
+    private: void AdaptResolution(
+        const std::chrono::steady_clock::duration &_frameTime);
+
+    /// \brief Size of the render texture, which is smaller than textureSize
+    /// while the resolution is scaled down.
+    /// \return Render texture size in pixels
+    public: QSize RenderTextureSize() const;
+
+    /// \brief Get timing statistics of the last rendered frames.
+    /// \return Human readable summary, empty if frameStatsEnabled is false.
+    public: std::string FrameStatsSummary() const;
 
     /// \brief Retrieve the first point on a surface in the 3D scene hit by a
     /// ray cast from the given 2D screen coordinates.
@@ -143,6 +304,75 @@ namespace plugins
     /// \brief Flag to indicate texture size has changed.
     public: bool textureDirty = false;
 
+    /// \brief True to only render when something changed in the scene.
+    public: bool renderOnDemand = false;
+
+    /// \brief Maximum time between frames when rendering on demand.
+    public: std::chrono::milliseconds maxIdleInterval{1000};
+
+    /// \brief Time to spend on scene updates per frame, zero for no limit.
+    public: std::chrono::milliseconds updateBudget{4};
+
+    /// \brief True to hold back pose updates of models which can't be seen
+    public: bool viewCulling = false;
+
+    /// \brief Most bytes taken by the meshes and textures of models, zero
+    /// for no limit. Needs view culling.
+    public: std::size_t resourceBudget = 0u;
+
+    /// \brief Most point and spot lights enabled at once, zero for no
+    /// limit.
+    public: std::size_t lightBudget = 0u;
+
+    /// \brief Priority of the render thread, if this renderer starts it
+    public: QThread::Priority threadPriority = QThread::InheritPriority;
+
+    /// \brief CPUs the render thread may run on, if this renderer starts
+    /// it. Empty for any.
+    public: std::vector<int> threadCpus;
+
+    /// \brief True to interpolate between received poses
+    public: bool interpolatePoses = false;
+
+    /// \brief True if the pose topic carries compact poses
+    public: bool compactPoses = false;
+
+    /// \brief True to keep a snapshot of the scene on disk
+    public: bool sceneCache = false;
+
+    /// \brief Topic to publish rendered frames on, empty to not capture
+    public: std::string captureTopic;
+
+    /// \brief Maximum rate in Hz at which frames are captured, zero or less
+    /// for every frame
+    public: double captureRate = 10.0;
+
+    /// \brief Service which starts and stops recording, empty for none
+    public: std::string recordService;
+
+    /// \brief File to start recording to once rendering, empty to wait
+    /// for the record service
+    public: std::string recordFile;
+
+    /// \brief Frame rate of recorded videos
+    public: unsigned int recordFps = 25u;
+
+    /// \brief Bit rate of recorded videos
+    public: unsigned int recordBitRate = 4000000u;
+
+    /// \brief True to time the stages of each frame.
+    public: bool frameStatsEnabled = false;
+
+    /// \brief True while the view can't be seen and isn't rendered.
+    public: std::atomic<bool> suspended{false};
+
+    /// \brief Frame time in milliseconds to aim for by scaling the render
+    /// resolution and anti-aliasing. Zero to always render at full quality.
+    public: double targetFrameTime = 0.0;
+
+    /// \brief Lowest resolution scale used to meet targetFrameTime.
+    public: double minResolutionScale = 0.5;
+
     /// \brief Scene service. If not empty, a request will be made to get the
     /// scene information using this service and the renderer will populate the
     /// scene based on the response data
@@ -171,22 +401,63 @@ namespace plugins
     Q_OBJECT
 
     /// \brief Constructor
-    public: RenderThread();
+    /// \param[in] _key Engine and scene name this thread renders
+    public: explicit RenderThread(const std::string &_key);
+
+    /// \brief Destructor
+    public: ~RenderThread();
 
-    /// \brief Render the next frame
+    /// \brief Render the next frame of all renderers whose last texture is
+    /// in use by the scene graph
     public slots: void RenderNext();
 
-    /// \brief Shutdown the thread and the render engine
-    public slots: void ShutDown();
+    /// \brief Run a task on this thread before the next frame. Can be
+    /// called from any thread.
+    /// \param[in] _task Task to run
+    public: void Post(std::function<void()> _task);
+
+    /// \brief Start rendering with a renderer. Must be called on this
+    /// thread, use Post otherwise. Ownership of the renderer is passed on to
+    /// this thread.
+    /// \param[in] _renderer Renderer to add
+    public: void AddRenderer(IgnRenderer *_renderer);
+
+    /// \brief Mark a renderer as ready to render into its texture again.
+    /// Must be called on this thread.
+    /// \param[in] _renderer Renderer whose texture was consumed
+    public: void TextureConsumed(IgnRenderer *_renderer);
 
-    /// \brief Slot called to update render texture size
-    public slots: void SizeChanged();
+    /// \brief Stop using this thread from a render window. If that was the
+    /// last one, the thread is shut down. Must be called on the GUI thread.
+    /// \param[in] _renderer The window's renderer if it was added
+    /// to this thread, null otherwise
+    public: void Release(IgnRenderer *_renderer);
+
+    /// \brief Apply the CPU affinity and priority, then run the event
+    /// loop.
+    protected: void run() override;
+
+    /// \brief Shutdown the thread and the render engine
+    private: void ShutDown();
 
     /// \brief Signal to indicate that a frame has been rendered and ready
     /// to be displayed
+    /// \param[in] _renderer Renderer which rendered the frame
     /// \param[in] _id GLuid of the opengl texture
     /// \param[in] _size Size of the texture
-    signals: void TextureReady(int _id, const QSize &_size);
+    signals: void TextureReady(IgnRenderer *_renderer, int _id,
+        const QSize &_size);
+
+    /// \brief Signal emitted about once a second with frame timing
+    /// statistics, while they're enabled.
+    /// \param[in] _renderer Renderer the statistics are for
+    /// \param[in] _stats Human readable statistics
+    signals: void FrameStatsReady(IgnRenderer *_renderer,
+        const QString &_stats);
+
+    /// \brief Signal emitted when the scene starts or finishes loading
+    /// \param[in] _loading True while waiting for the scene service
+    signals: void LoadingChanged(bool _loading);
 
     /// \brief Offscreen surface to render to
     public: QOffscreenSurface *surface = nullptr;
@@ -194,8 +465,20 @@ namespace plugins
     /// \brief OpenGL context to be passed to the render engine
     public: QOpenGLContext *context = nullptr;
 
-    /// \brief Ign-rendering renderer
-    public: IgnRenderer ignRenderer;
+    /// \brief CPUs the thread may run on, empty for any. Must be set before
+    /// the thread is started.
+    public: std::vector<int> cpus;
+
+    /// \brief Number of render windows using this thread. Protected by
+    /// RenderWindowItemPrivate::threadsMutex.
+    public: unsigned int users = 0u;
+
+    /// \brief True while waiting for the scene service
+    public: std::atomic<bool> loading{false};
+
+    /// \internal
+    /// \brief Pointer to private data.
+    private: std::unique_ptr<RenderThreadPrivate> dataPtr;
   };
 
 
@@ -204,6 +487,28 @@ namespace plugins
   {
     Q_OBJECT
 
+    /// \brief Frame timing statistics
+    Q_PROPERTY(
+      QString frameStats
+      READ FrameStats
+      NOTIFY FrameStatsChanged
+    )
+
+    /// \brief Whether the scene is still being requested
+    Q_PROPERTY(
+      bool loading
+      READ Loading
+      NOTIFY LoadingChanged
+    )
+
+    /// \brief Whether to show frame timing statistics
+    Q_PROPERTY(
+      bool showFrameStats
+      READ ShowFrameStats
+      WRITE SetShowFrameStats
+      NOTIFY ShowFrameStatsChanged
+    )
+
     /// \brief Constructor
     /// \param[in] _parent Parent item
     public: explicit RenderWindowItem(QQuickItem *_parent = nullptr);
@@ -254,6 +559,121 @@ namespace plugins
     /// \param[in] _topic Scene topic
     public: void SetSceneTopic(const std::string &_topic);
 
+    /// \brief Set whether to render only when something changed.
+    /// \param[in] _onDemand True to render on demand, false to render
+    /// continuously.
+    public: void SetRenderOnDemand(const bool _onDemand);
+
+    /// \brief Set the maximum time between frames when rendering on demand.
+    /// \param[in] _interval Maximum idle interval.
+    public: void SetMaxIdleInterval(
+        const std::chrono::milliseconds &_interval);
+
+    /// \brief Set the time to spend on scene updates per frame.
+    /// \param[in] _budget Update budget, zero for no limit.
+    public: void SetUpdateBudget(const std::chrono::milliseconds &_budget);
+
+    /// \brief Set whether to hold back pose updates of models which can't
+    /// be seen.
+    /// \param[in] _viewCulling True to cull pose updates.
+    public: void SetViewCulling(const bool _viewCulling);
+
+    /// \brief Set the most memory taken by the meshes and textures of
+    /// models. The resources of models which weren't seen for the longest
+    /// are released past it, and loaded again once they come into view.
+    /// Needs view culling.
+    /// \param[in] _bytes Budget in bytes, zero for no limit.
+    public: void SetResourceBudget(const std::size_t _bytes);
+
+    /// \brief Set the most point and spot lights enabled at once. The
+    /// least important ones for the camera are disabled.
+    /// \param[in] _count Budget, zero for no limit.
+    public: void SetLightBudget(const std::size_t _count);
+
+    /// \brief Set the priority and CPU affinity of the render thread. Only
+    /// has an effect before the thread is started, and the first window
+    /// showing a scene starts its thread.
+    /// \param[in] _priority Thread priority
+    /// \param[in] _cpus CPUs the thread may run on, empty for any
+    public: void SetRenderThreadScheduling(const QThread::Priority _priority,
+        const std::vector<int> &_cpus);
+
+    /// \brief Set whether to interpolate between received poses.
+    /// \param[in] _interpolate True to interpolate poses.
+    public: void SetInterpolatePoses(const bool _interpolate);
+
+    /// \brief Set whether the pose topic carries compact poses.
+    /// \param[in] _compact True for frames made by a PoseEncoder.
+    public: void SetCompactPoses(const bool _compact);
+
+    /// \brief Publish rendered frames as images.
+    /// \param[in] _topic Topic to publish on, empty to stop capturing.
+    /// \param[in] _rate Maximum capture rate in Hz, zero or less to capture
+    /// every frame.
+    public: void SetCapture(const std::string &_topic, const double _rate);
+
+    /// \brief Record rendered frames to video files.
+    /// \param[in] _service Service which starts and stops recording, empty
+    /// for none.
+    /// \param[in] _file File to start recording to right away, empty to
+    /// wait for the service.
+    /// \param[in] _fps Frame rate of the videos.
+    /// \param[in] _bitRate Bit rate of the videos.
+    public: void SetRecording(const std::string &_service,
+        const std::string &_file, const unsigned int _fps,
+        const unsigned int _bitRate);
+
+    /// \brief Set whether to show the last known scene while waiting for
+    /// the scene service, and keep it on disk for the next time.
+    /// \param[in] _sceneCache True to use the scene cache.
+    public: void SetSceneCache(const bool _sceneCache);
+
+    /// \brief Set the frame time to aim for by scaling the resolution.
+    /// \param[in] _target Target frame time in milliseconds, zero to always
+    /// render at full quality.
+    /// \param[in] _minScale Lowest resolution scale to use.
+    public: void SetTargetFrameTime(const double _target,
+        const double _minScale);
+
+    /// \brief Stop rendering while the view can't be seen, or start again.
+    /// The scene keeps being updated, so it's current when resumed.
+    /// \param[in] _suspended True to stop rendering
+    public: void SetSuspended(const bool _suspended);
+
+    /// \brief Get the latest frame timing statistics
+    /// \return Human readable statistics
+    public: Q_INVOKABLE QString FrameStats() const;
+
+    /// \brief Notify that the frame timing statistics changed
+    signals: void FrameStatsChanged();
+
+    /// \brief Get whether frame timing statistics are shown
+    /// \return True if shown
+    public: Q_INVOKABLE bool ShowFrameStats() const;
+
+    /// \brief Set whether to collect and show frame timing statistics
+    /// \param[in] _show True to show them
+    public: Q_INVOKABLE void SetShowFrameStats(const bool _show);
+
+    /// \brief Notify that frame timing statistics were shown or hidden
+    signals: void ShowFrameStatsChanged();
+
+    /// \brief Get whether the scene is still being requested
+    /// \return True while waiting for the scene service
+    public: Q_INVOKABLE bool Loading() const;
+
+    /// \brief Notify that the scene started or finished loading
+    signals: void LoadingChanged();
+
+    /// \brief Slot called when the render thread starts or finishes loading
+    /// the scene
+    /// \param[in] _loading True while loading
+    private slots: void OnLoadingChanged(const bool _loading);
+
+    /// \brief Slot called when the render thread has new frame statistics
+    /// \param[in] _stats Human readable statistics
+    private slots: void OnFrameStats(const QString &_stats);
+
     /// \brief Slot called when thread is ready to be started
     public Q_SLOTS: void Ready();
 
@@ -313,14 +733,37 @@ namespace plugins
     /// update
     signals: void PendingNewTexture();
 
-    /// \brief OpenGL texture id
-    public: int id = 0;
+    /// \brief A rendered frame handed from the render thread to the scene
+    /// graph thread
+    public: struct Frame
+    {
+      /// \brief OpenGL texture id
+      int id = 0;
+
+      /// \brief Texture size
+      QSize size = QSize(0, 0);
+
+      /// \brief Signaled once the GPU is done rendering the frame. Null if
+      /// sync objects aren't supported by the context.
+      GLsync fence = nullptr;
+    };
+
+    /// \brief Frames alternately filled by NewTexture. A frame is only
+    /// reused after the scene graph took the one that came after it, which
+    /// the TextureInUse / RenderNext handshake guarantees.
+    public: std::array<Frame, 2> frames;
+
+    /// \brief Index of the frame NewTexture fills next
+    public: unsigned int nextFrame = 0u;
+
+    /// \brief Latest frame not taken by PrepareNode yet, or null
+    public: std::atomic<Frame *> pending{nullptr};
 
-    /// \brief Texture size
-    public: QSize size = QSize(0, 0);
+    /// \brief OpenGL texture id currently wrapped by texture
+    public: int textureId = 0;
 
-    /// \brief Mutex to protect the texture variables
-    public: QMutex mutex;
+    /// \brief Size of the texture currently wrapped by texture
+    public: QSize textureSize = QSize(0, 0);
 
     /// \brief Qt's scene graph texture
     public: QSGTexture *texture = nullptr;
@@ -46,6 +46,33 @@ Rectangle {
       visible: gammaCorrect
   }
 
+  /*
+   * Frame timing statistics, enabled with <frame_stats>
+   */
+  Text {
+    anchors.top: parent.top
+    anchors.left: parent.left
+    anchors.margins: 5
+    visible: renderWindow.showFrameStats
+    text: renderWindow.frameStats
+    color: "white"
+    style: Text.Outline
+    styleColor: "black"
+    font.family: "Monospace"
+  }
+
+  /*
+   * Shown while waiting for the scene service
+   */
+  Text {
+    anchors.centerIn: parent
+    visible: renderWindow.loading
+    text: "Loading scene..."
+    color: "white"
+    style: Text.Outline
+    styleColor: "black"
+  }
+
   onParentChanged: {
     if (undefined === parent)
       return;
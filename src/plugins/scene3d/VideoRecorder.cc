@@ -0,0 +1,324 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "VideoRecorder.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/VideoEncoder.hh>
+
+namespace ignition
+{
+namespace gui
+{
+namespace plugins
+{
+  class VideoRecorderPrivate
+  {
+    /// \brief A frame waiting to be encoded
+    public: struct Frame
+    {
+      /// \brief RGBA pixels
+      std::string data;
+
+      /// \brief Time the frame was rendered
+      VideoRecorder::Clock::time_point stamp;
+    };
+
+    /// \brief Encode a frame. Called on the encoder thread.
+    /// \param[in] _frame Frame to encode
+    public: void Encode(const Frame &_frame);
+
+    /// \brief Encoder thread loop
+    public: void Run();
+
+    /// \brief File being written
+    public: std::string filename;
+
+    /// \brief Video format
+    public: std::string format;
+
+    /// \brief Frame rate of the video
+    public: unsigned int fps{25u};
+
+    /// \brief Bit rate of the video
+    public: unsigned int bitRate{0u};
+
+    /// \brief Size of the frames, set by the first one
+    public: unsigned int width{0u};
+
+    /// \brief Size of the frames, set by the first one
+    public: unsigned int height{0u};
+
+    /// \brief Encoder, only used on the encoder thread. A new one is made
+    /// for each recording.
+    public: std::unique_ptr<common::VideoEncoder> encoder;
+
+    /// \brief True if the encoder failed to start, so frames are discarded
+    public: bool failed{false};
+
+    /// \brief RGB pixels handed to the encoder, reused across frames
+    public: std::vector<unsigned char> rgb;
+
+    /// \brief Encoder thread
+    public: std::thread thread;
+
+    /// \brief Protects queue, pool and stopping
+    public: std::mutex mutex;
+
+    /// \brief Signaled when a frame is queued or on stop
+    public: std::condition_variable condition;
+
+    /// \brief Frames waiting to be encoded, oldest first
+    public: std::deque<Frame> queue;
+
+    /// \brief Encoded frames whose buffers can be reused
+    public: std::vector<Frame> pool;
+
+    /// \brief True once the encoder thread should finish
+    public: bool stopping{false};
+
+    /// \brief True between Start and Stop
+    public: bool recording{false};
+
+    /// \brief Time recording started
+    public: VideoRecorder::Clock::time_point started;
+
+    /// \brief Frames encoded so far
+    public: std::atomic<unsigned int> encoded{0u};
+
+    /// \brief Frames dropped so far
+    public: unsigned int dropped{0u};
+  };
+}
+}
+}
+
+using namespace ignition;
+using namespace gui;
+using namespace plugins;
+
+/// \brief Most frames waiting to be encoded before new ones are dropped
+static const std::size_t kMaxQueuedFrames{3u};
+
+/////////////////////////////////////////////////
+void VideoRecorderPrivate::Encode(const Frame &_frame)
+{
+  // Most encoders need even sizes, so the last odd row or column is cut
+  auto width = this->width & ~1u;
+  auto height = this->height & ~1u;
+  if (this->failed || width == 0u || height == 0u)
+    return;
+
+  if (!this->encoder->IsEncoding())
+  {
+    if (!this->encoder->Start(this->format, this->filename, width, height,
+        this->fps, this->bitRate))
+    {
+      ignerr << "Failed to start recording [" << this->filename << "]"
+             << std::endl;
+      this->failed = true;
+      return;
+    }
+  }
+
+  this->rgb.resize(width * height * 3u);
+  auto src = reinterpret_cast<const unsigned char *>(_frame.data.data());
+  auto dst = this->rgb.data();
+  for (unsigned int row = 0u; row < height; ++row)
+  {
+    auto pixel = src + row * this->width * 4u;
+    for (unsigned int col = 0u; col < width; ++col, pixel += 4)
+    {
+      *dst++ = pixel[0];
+      *dst++ = pixel[1];
+      *dst++ = pixel[2];
+    }
+  }
+
+  if (this->encoder->AddFrame(this->rgb.data(), width, height,
+      _frame.stamp))
+  {
+    ++this->encoded;
+  }
+}
+
+/////////////////////////////////////////////////
+void VideoRecorderPrivate::Run()
+{
+  std::unique_lock<std::mutex> lock(this->mutex);
+  while (true)
+  {
+    this->condition.wait(lock, [this]
+    {
+      return this->stopping || !this->queue.empty();
+    });
+    if (this->queue.empty())
+      break;
+
+    auto frame = std::move(this->queue.front());
+    this->queue.pop_front();
+
+    lock.unlock();
+    this->Encode(frame);
+    lock.lock();
+
+    this->pool.push_back(std::move(frame));
+  }
+
+  if (this->encoder->IsEncoding())
+    this->encoder->Stop();
+}
+
+/////////////////////////////////////////////////
+VideoRecorder::VideoRecorder()
+  : dataPtr(new VideoRecorderPrivate)
+{
+}
+
+/////////////////////////////////////////////////
+VideoRecorder::~VideoRecorder()
+{
+  this->Stop();
+}
+
+/////////////////////////////////////////////////
+void VideoRecorder::Start(const std::string &_filename,
+    const std::string &_format, const unsigned int _fps,
+    const unsigned int _bitRate)
+{
+  this->Stop();
+
+  auto &d = this->dataPtr;
+  d->filename = _filename;
+  d->format = _format;
+  d->fps = std::max(_fps, 1u);
+  d->bitRate = _bitRate;
+  d->width = 0u;
+  d->height = 0u;
+  d->failed = false;
+  d->stopping = false;
+  d->encoded = 0u;
+  d->dropped = 0u;
+  d->started = Clock::now();
+  d->encoder.reset(new common::VideoEncoder());
+  d->recording = true;
+  d->thread = std::thread(&VideoRecorderPrivate::Run, d.get());
+
+  ignmsg << "Recording to [" << _filename << "]" << std::endl;
+}
+
+/////////////////////////////////////////////////
+void VideoRecorder::Stop()
+{
+  auto &d = this->dataPtr;
+  if (!d->recording)
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(d->mutex);
+    d->stopping = true;
+  }
+  d->condition.notify_one();
+  d->thread.join();
+  d->recording = false;
+
+  ignmsg << "Recorded " << d->encoded << " frames to [" << d->filename
+         << "], dropped " << d->dropped << std::endl;
+}
+
+/////////////////////////////////////////////////
+bool VideoRecorder::Recording() const
+{
+  return this->dataPtr->recording;
+}
+
+/////////////////////////////////////////////////
+unsigned int VideoRecorder::Fps() const
+{
+  return this->dataPtr->fps;
+}
+
+/////////////////////////////////////////////////
+bool VideoRecorder::Push(const msgs::Image &_image,
+    const Clock::time_point &_stamp)
+{
+  auto &d = this->dataPtr;
+  if (!d->recording)
+    return false;
+
+  if (d->width == 0u)
+  {
+    d->width = _image.width();
+    d->height = _image.height();
+  }
+
+  // Resizing the window mid-recording isn't supported by the encoder
+  if (_image.width() != d->width || _image.height() != d->height ||
+      _image.data().size() < d->width * d->height * 4u)
+  {
+    ++d->dropped;
+    return false;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(d->mutex);
+    if (d->queue.size() >= kMaxQueuedFrames)
+    {
+      ++d->dropped;
+      return false;
+    }
+
+    VideoRecorderPrivate::Frame frame;
+    if (!d->pool.empty())
+    {
+      frame = std::move(d->pool.back());
+      d->pool.pop_back();
+    }
+    frame.data.assign(_image.data());
+    frame.stamp = _stamp;
+    d->queue.push_back(std::move(frame));
+  }
+  d->condition.notify_one();
+  return true;
+}
+
+/////////////////////////////////////////////////
+std::string VideoRecorder::Summary() const
+{
+  auto &d = this->dataPtr;
+  if (!d->recording)
+    return std::string();
+
+  double seconds = std::chrono::duration<double>(
+      Clock::now() - d->started).count();
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(1) << "recording: " << d->encoded
+      << " frames, " << d->dropped << " dropped, "
+      << (seconds > 0.0 ? d->encoded / seconds : 0.0) << " fps";
+  return out.str();
+}
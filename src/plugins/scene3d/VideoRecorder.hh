@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGNITION_GUI_PLUGINS_SCENE3D_VIDEORECORDER_HH_
+#define IGNITION_GUI_PLUGINS_SCENE3D_VIDEORECORDER_HH_
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+// TODO(louise) Remove these pragmas once ign-msgs is disabling the warnings
+#ifdef _MSC_VER
+#pragma warning(push, 0)
+#endif
+#include <ignition/msgs/image.pb.h>
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+namespace ignition
+{
+namespace gui
+{
+namespace plugins
+{
+  class VideoRecorderPrivate;
+
+  /// \brief Encodes frames to a video file on a background thread.
+  ///
+  /// Push copies a frame into a small queue and returns right away. If the
+  /// encoder is behind and the queue is full, the frame is dropped instead
+  /// of waiting. The encoder is started with the size of the first frame,
+  /// and frames of other sizes are dropped.
+  class VideoRecorder
+  {
+    /// \brief Clock used for frame timestamps
+    public: using Clock = std::chrono::steady_clock;
+
+    /// \brief Constructor
+    public: VideoRecorder();
+
+    /// \brief Destructor, stops recording.
+    public: ~VideoRecorder();
+
+    /// \brief Start recording. Stops the current recording, if any.
+    /// \param[in] _filename File to write
+    /// \param[in] _format Video format, such as mp4
+    /// \param[in] _fps Frame rate of the video
+    /// \param[in] _bitRate Bit rate of the video
+    public: void Start(const std::string &_filename,
+        const std::string &_format, const unsigned int _fps,
+        const unsigned int _bitRate);
+
+    /// \brief Stop recording, after encoding the queued frames, and finish
+    /// the file.
+    public: void Stop();
+
+    /// \brief Check if recording.
+    /// \return True between Start and Stop
+    public: bool Recording() const;
+
+    /// \brief Get the frame rate of the video.
+    /// \return Frames per second
+    public: unsigned int Fps() const;
+
+    /// \brief Queue a frame to be encoded.
+    /// \param[in] _image RGBA frame
+    /// \param[in] _stamp Time the frame was rendered
+    /// \return False if the frame was dropped
+    public: bool Push(const msgs::Image &_image,
+        const Clock::time_point &_stamp);
+
+    /// \brief Human readable recording statistics.
+    /// \return Frames encoded and dropped, and the encoding rate. Empty if
+    /// not recording.
+    public: std::string Summary() const;
+
+    /// \brief Private data pointer
+    private: std::unique_ptr<VideoRecorderPrivate> dataPtr;
+  };
+}
+}
+}
+
+#endif
@@ -15,12 +15,28 @@
  *
 */
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <google/protobuf/text_format.h>
+
 #include <ignition/common/Console.hh>
+#include <ignition/common/StringUtils.hh>
 #include <ignition/plugin/Register.hh>
-#include <ignition/transport/Node.hh>
 
 #include "ignition/gui/Application.hh"
+#include "ignition/gui/SubscriptionHub.hh"
 #include "TopicEcho.hh"
 
 namespace ignition
@@ -29,26 +45,1051 @@ namespace gui
 {
 namespace plugins
 {
+  /// \brief Messages received since the last frame, kept as they came
+  /// from transport. Filled by the transport thread and drained by the GUI
+  /// thread without locking. When more messages than its capacity arrive
+  /// between two frames, the oldest ones are overwritten.
+  class MsgRing
+  {
+    /// \brief Constructor
+    /// \param[in] _capacity Maximum number of messages held
+    public: explicit MsgRing(const std::size_t _capacity)
+      : slots(std::max<std::size_t>(_capacity, 1u))
+    {
+    }
+
+    /// \brief Add a message, overwriting the oldest one if full.
+    /// \param[in] _msg Message received
+    public: void Push(
+        const std::shared_ptr<const google::protobuf::Message> &_msg)
+    {
+      // Claimed atomically, so a message published from another thread of
+      // the process can't corrupt the ring
+      auto seq = this->head.fetch_add(1);
+      auto &slot = this->slots[seq % this->slots.size()];
+
+      // Odd while being written, so the reader can tell it isn't ready
+      slot.seq = 2 * seq + 1;
+      std::atomic_store(&slot.msg, _msg);
+      slot.seq = 2 * seq + 2;
+    }
+
+    /// \brief Take the messages added since the last call, oldest first.
+    /// \param[out] _msgs Messages taken are appended to it
+    public: void Drain(
+        std::vector<std::shared_ptr<const google::protobuf::Message>> &_msgs)
+    {
+      auto end = this->head.load();
+      auto capacity = static_cast<uint64_t>(this->slots.size());
+      if (end - this->tail > capacity)
+        this->tail = end - capacity;
+
+      for (; this->tail < end; ++this->tail)
+      {
+        auto &slot = this->slots[this->tail % capacity];
+        auto expected = 2 * this->tail + 2;
+
+        // Still being written, pick it up next frame
+        if (slot.seq < expected)
+          break;
+
+        // Overwritten since, the newer message comes later
+        if (slot.seq != expected)
+          continue;
+
+        auto msg = std::atomic_load(&slot.msg);
+        if (slot.seq == expected)
+          _msgs.push_back(msg);
+      }
+    }
+
+    /// \brief A message and its position in the stream
+    private: struct Slot
+    {
+      /// \brief Twice the position of the message, plus one while it's
+      /// written and two once it's done. 0 if empty.
+      std::atomic<uint64_t> seq{0};
+
+      /// \brief The message, only accessed with std::atomic_load and
+      /// std::atomic_store
+      std::shared_ptr<const google::protobuf::Message> msg;
+    };
+
+    /// \brief Storage, used circularly
+    private: std::vector<Slot> slots;
+
+    /// \brief Position of the next message pushed
+    private: std::atomic<uint64_t> head{0};
+
+    /// \brief Position of the next message drained, only used by the
+    /// reader
+    private: uint64_t tail{0};
+  };
+
+  /// \brief How messages are formatted for the list
+  enum class EchoFormat
+  {
+    /// \brief Protobuf's text format, complete but slow for large
+    /// messages
+    TEXT,
+
+    /// \brief Text format eliding long strings, bytes and repeated fields
+    COMPACT,
+
+    /// \brief JSON, eliding like COMPACT
+    JSON,
+
+    /// \brief Only the size of the message and of its fields, with the
+    /// first bytes of bytes fields in hex, for messages such as images
+    SIZE
+  };
+
+  /// \brief Formats messages through reflection into a buffer reused from
+  /// one message to the next. Long strings, bytes and repeated fields are
+  /// cut short, so an image or a point cloud formats into a few lines
+  /// instead of megabytes of escaped text. The fields of each message type
+  /// are looked up once.
+  class EchoFormatter
+  {
+    /// \brief Set how messages are formatted.
+    /// \param[in] _format Format, TEXT is left to protobuf
+    public: void SetFormat(const EchoFormat _format)
+    {
+      this->format = _format;
+    }
+
+    /// \brief Get how messages are formatted.
+    /// \return Format
+    public: EchoFormat Format() const
+    {
+      return this->format;
+    }
+
+    /// \brief Format a whole message.
+    /// \param[in] _msg Message
+    /// \return Text, valid until the next call
+    public: const std::string &FormatMessage(
+        const google::protobuf::Message &_msg)
+    {
+      this->buffer.clear();
+      if (this->format == EchoFormat::SIZE)
+      {
+        this->buffer += _msg.GetDescriptor()->full_name();
+        this->buffer += " (";
+        this->AppendSize(_msg.ByteSizeLong());
+        this->buffer += ")\n";
+      }
+      this->AppendMessage(_msg, 0);
+      return this->buffer;
+    }
+
+    /// \brief Format a field of a message.
+    /// \param[in] _msg Message holding the field
+    /// \param[in] _field Field
+    /// \param[in] _index Element of a repeated field, -1 for the whole
+    /// field
+    /// \return Text, valid until the next call
+    public: const std::string &FormatField(
+        const google::protobuf::Message &_msg,
+        const google::protobuf::FieldDescriptor *_field, const int _index)
+    {
+      this->buffer.clear();
+      bool json = this->format == EchoFormat::JSON;
+      if (_index >= 0 &&
+          _field->cpp_type() ==
+          google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE)
+      {
+        // an element of a repeated message is shown as a whole message
+        this->AppendMessage(this->Message(_msg, _field, _index), 0);
+      }
+      else if (json)
+      {
+        this->buffer += "{\n";
+        this->AppendField(_msg, _field, _index, 1, false);
+        this->buffer += "\n}";
+      }
+      else
+      {
+        this->AppendField(_msg, _field, _index, 0, true);
+      }
+
+      // lines of the text format are already ended
+      if (json)
+        this->buffer += '\n';
+      return this->buffer;
+    }
+
+    /// \brief Get the fields of a message type, in declaration order.
+    /// \param[in] _type Message type
+    /// \return Fields
+    private: const std::vector<const google::protobuf::FieldDescriptor *> &
+        Fields(const google::protobuf::Descriptor *_type)
+    {
+      auto &fields = this->fields[_type];
+      if (fields.empty())
+      {
+        for (int i = 0; i < _type->field_count(); ++i)
+          fields.push_back(_type->field(i));
+      }
+      return fields;
+    }
+
+    /// \brief Append the set fields of a message.
+    /// \param[in] _msg Message
+    /// \param[in] _indent Indentation level of the fields
+    private: void AppendMessage(const google::protobuf::Message &_msg,
+                                const int _indent)
+    {
+      bool json = this->format == EchoFormat::JSON;
+      if (json)
+        this->buffer += "{\n";
+
+      auto ref = _msg.GetReflection();
+      bool first{true};
+      for (auto field : this->Fields(_msg.GetDescriptor()))
+      {
+        bool set = field->is_repeated() ? ref->FieldSize(_msg, field) > 0 :
+            ref->HasField(_msg, field);
+        if (!set)
+          continue;
+
+        if (json && !first)
+          this->buffer += ",\n";
+        first = false;
+        this->AppendField(_msg, field, -1, _indent + (json ? 1 : 0),
+            !json);
+      }
+
+      if (json)
+      {
+        if (!first)
+          this->buffer += '\n';
+        this->Indent(_indent);
+        this->buffer += '}';
+      }
+    }
+
+    /// \brief Append a field of a message with its name.
+    /// \param[in] _msg Message holding the field
+    /// \param[in] _field Field
+    /// \param[in] _index Element of a repeated field, -1 for the whole
+    /// field
+    /// \param[in] _indent Indentation level
+    /// \param[in] _newline True to end each line, false to leave the
+    /// last one open, for JSON separators
+    private: void AppendField(const google::protobuf::Message &_msg,
+                              const google::protobuf::FieldDescriptor *_field,
+                              const int _index, const int _indent,
+                              const bool _newline)
+    {
+      using google::protobuf::FieldDescriptor;
+      auto ref = _msg.GetReflection();
+      bool isMessage = _field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE;
+
+      if (this->format == EchoFormat::SIZE)
+      {
+        this->Indent(_indent);
+        this->buffer += _field->name();
+        this->buffer += ": ";
+        if (_field->is_repeated() && _index < 0)
+        {
+          this->AppendNumber(ref->FieldSize(_msg, _field));
+          this->buffer += " elements";
+        }
+        else if (isMessage)
+        {
+          this->AppendSize(this->Message(_msg, _field, _index).ByteSizeLong());
+        }
+        else
+        {
+          this->AppendValue(_msg, _field, _index, _indent);
+        }
+        if (_newline)
+          this->buffer += '\n';
+        return;
+      }
+
+      if (this->format == EchoFormat::JSON)
+      {
+        this->Indent(_indent);
+        this->buffer += '"';
+        this->buffer += _field->json_name();
+        this->buffer += "\": ";
+        if (!_field->is_repeated() || _index >= 0)
+        {
+          this->AppendValue(_msg, _field, _index, _indent);
+        }
+        else
+        {
+          int size = ref->FieldSize(_msg, _field);
+          int shown = std::min(size, kMaxElements);
+          this->buffer += '[';
+          for (int i = 0; i < shown; ++i)
+          {
+            if (i > 0)
+              this->buffer += ", ";
+            this->AppendValue(_msg, _field, i, _indent);
+          }
+          if (shown < size)
+          {
+            this->buffer += ", \"... ";
+            this->AppendNumber(size - shown);
+            this->buffer += " more\"";
+          }
+          this->buffer += ']';
+        }
+        if (_newline)
+          this->buffer += '\n';
+        return;
+      }
+
+      // text format, one line per element of repeated fields
+      int first = _index < 0 ? 0 : _index;
+      int size = !_field->is_repeated() ? 1 :
+          (_index < 0 ? ref->FieldSize(_msg, _field) : _index + 1);
+      int shown = std::min(size - first, kMaxElements);
+      for (int i = first; i < first + shown; ++i)
+      {
+        this->Indent(_indent);
+        this->buffer += _field->name();
+        int element = _field->is_repeated() ? i : -1;
+        if (isMessage)
+        {
+          this->buffer += " {\n";
+          this->AppendMessage(this->Message(_msg, _field, element),
+              _indent + 1);
+          this->Indent(_indent);
+          this->buffer += "}\n";
+        }
+        else
+        {
+          this->buffer += ": ";
+          this->AppendValue(_msg, _field, element, _indent);
+          this->buffer += '\n';
+        }
+      }
+      if (first + shown < size)
+      {
+        this->Indent(_indent);
+        this->buffer += "# ... ";
+        this->AppendNumber(size - first - shown);
+        this->buffer += " more\n";
+      }
+    }
+
+    /// \brief Append the value of a field, without its name.
+    /// \param[in] _msg Message holding the field
+    /// \param[in] _field Field
+    /// \param[in] _index Element of a repeated field, -1 for a singular
+    /// field
+    /// \param[in] _indent Indentation level of the field, for messages
+    private: void AppendValue(const google::protobuf::Message &_msg,
+                              const google::protobuf::FieldDescriptor *_field,
+                              const int _index, const int _indent)
+    {
+      using google::protobuf::FieldDescriptor;
+      auto ref = _msg.GetReflection();
+      bool repeated = _index >= 0;
+      bool json = this->format == EchoFormat::JSON;
+      switch (_field->cpp_type())
+      {
+        case FieldDescriptor::CPPTYPE_INT32:
+          this->AppendNumber(repeated ?
+              ref->GetRepeatedInt32(_msg, _field, _index) :
+              ref->GetInt32(_msg, _field));
+          break;
+        case FieldDescriptor::CPPTYPE_INT64:
+          this->AppendNumber(repeated ?
+              ref->GetRepeatedInt64(_msg, _field, _index) :
+              ref->GetInt64(_msg, _field));
+          break;
+        case FieldDescriptor::CPPTYPE_UINT32:
+          this->AppendNumber(repeated ?
+              ref->GetRepeatedUInt32(_msg, _field, _index) :
+              ref->GetUInt32(_msg, _field));
+          break;
+        case FieldDescriptor::CPPTYPE_UINT64:
+          this->AppendNumber(repeated ?
+              ref->GetRepeatedUInt64(_msg, _field, _index) :
+              ref->GetUInt64(_msg, _field));
+          break;
+        case FieldDescriptor::CPPTYPE_DOUBLE:
+          this->AppendDouble(repeated ?
+              ref->GetRepeatedDouble(_msg, _field, _index) :
+              ref->GetDouble(_msg, _field), 15);
+          break;
+        case FieldDescriptor::CPPTYPE_FLOAT:
+          this->AppendDouble(repeated ?
+              ref->GetRepeatedFloat(_msg, _field, _index) :
+              ref->GetFloat(_msg, _field), 6);
+          break;
+        case FieldDescriptor::CPPTYPE_BOOL:
+          this->buffer += (repeated ?
+              ref->GetRepeatedBool(_msg, _field, _index) :
+              ref->GetBool(_msg, _field)) ? "true" : "false";
+          break;
+        case FieldDescriptor::CPPTYPE_ENUM:
+        {
+          auto value = repeated ?
+              ref->GetRepeatedEnum(_msg, _field, _index) :
+              ref->GetEnum(_msg, _field);
+          if (json)
+            this->buffer += '"';
+          this->buffer += value->name();
+          if (json)
+            this->buffer += '"';
+          break;
+        }
+        case FieldDescriptor::CPPTYPE_STRING:
+        {
+          const auto &value = repeated ?
+              ref->GetRepeatedStringReference(_msg, _field, _index,
+                  &this->scratch) :
+              ref->GetStringReference(_msg, _field, &this->scratch);
+          if (_field->type() == FieldDescriptor::TYPE_BYTES ||
+              this->format == EchoFormat::SIZE)
+          {
+            this->AppendBytes(value);
+          }
+          else
+          {
+            this->AppendString(value);
+          }
+          break;
+        }
+        case FieldDescriptor::CPPTYPE_MESSAGE:
+          this->AppendMessage(this->Message(_msg, _field, _index), _indent);
+          break;
+      }
+    }
+
+    /// \brief Get a message field.
+    /// \param[in] _msg Message holding the field
+    /// \param[in] _field Field
+    /// \param[in] _index Element of a repeated field, -1 for a singular
+    /// field
+    /// \return The field's message
+    private: const google::protobuf::Message &Message(
+        const google::protobuf::Message &_msg,
+        const google::protobuf::FieldDescriptor *_field, const int _index)
+    {
+      auto ref = _msg.GetReflection();
+      return _index >= 0 ? ref->GetRepeatedMessage(_msg, _field, _index) :
+          ref->GetMessage(_msg, _field);
+    }
+
+    /// \brief Append a string, quoted and escaped, cut short if long.
+    /// \param[in] _value String
+    private: void AppendString(const std::string &_value)
+    {
+      static const char kHex[] = "0123456789abcdef";
+      auto shown = std::min(_value.size(), kMaxString);
+      this->buffer += '"';
+      for (std::size_t i = 0; i < shown; ++i)
+      {
+        auto c = static_cast<unsigned char>(_value[i]);
+        switch (c)
+        {
+          case '"': this->buffer += "\\\""; break;
+          case '\\': this->buffer += "\\\\"; break;
+          case '\n': this->buffer += "\\n"; break;
+          case '\r': this->buffer += "\\r"; break;
+          case '\t': this->buffer += "\\t"; break;
+          default:
+            if (c < 0x20)
+            {
+              this->buffer += "\\x";
+              this->buffer += kHex[c >> 4];
+              this->buffer += kHex[c & 0xf];
+            }
+            else
+            {
+              this->buffer += static_cast<char>(c);
+            }
+        }
+      }
+      this->buffer += '"';
+      if (shown < _value.size())
+      {
+        this->buffer += "... (";
+        this->AppendSize(_value.size());
+        this->buffer += ')';
+      }
+    }
+
+    /// \brief Append the size of bytes and the first of them in hex.
+    /// \param[in] _value Bytes
+    private: void AppendBytes(const std::string &_value)
+    {
+      static const char kHex[] = "0123456789abcdef";
+      bool json = this->format == EchoFormat::JSON;
+      if (json)
+        this->buffer += '"';
+      this->buffer += '<';
+      this->AppendSize(_value.size());
+      auto shown = std::min(_value.size(), kMaxHexBytes);
+      if (shown > 0)
+        this->buffer += ':';
+      for (std::size_t i = 0; i < shown; ++i)
+      {
+        auto c = static_cast<unsigned char>(_value[i]);
+        this->buffer += ' ';
+        this->buffer += kHex[c >> 4];
+        this->buffer += kHex[c & 0xf];
+      }
+      if (shown < _value.size())
+        this->buffer += " ...";
+      this->buffer += '>';
+      if (json)
+        this->buffer += '"';
+    }
+
+    /// \brief Append a number of bytes.
+    /// \param[in] _size Number of bytes
+    private: void AppendSize(const std::size_t _size)
+    {
+      this->AppendNumber(static_cast<uint64_t>(_size));
+      this->buffer += _size == 1u ? " byte" : " bytes";
+    }
+
+    /// \brief Append an integer.
+    /// \param[in] _value Integer
+    private: template<typename T>
+             void AppendNumber(const T _value)
+    {
+      char text[24];
+      int length;
+      if (std::is_signed<T>::value)
+      {
+        length = std::snprintf(text, sizeof(text), "%lld",
+            static_cast<long long>(_value));
+      }
+      else
+      {
+        length = std::snprintf(text, sizeof(text), "%llu",
+            static_cast<unsigned long long>(_value));
+      }
+      this->buffer.append(text, static_cast<std::size_t>(length));
+    }
+
+    /// \brief Append a floating point number in its shortest form which
+    /// reads back the same, like protobuf.
+    /// \param[in] _value Number
+    /// \param[in] _digits Digits tried first, 15 for doubles and 6 for
+    /// floats
+    private: void AppendDouble(const double _value, const int _digits)
+    {
+      bool json = this->format == EchoFormat::JSON;
+      if (!std::isfinite(_value))
+      {
+        if (json)
+          this->buffer += '"';
+        this->buffer += std::isnan(_value) ? "nan" :
+            (_value > 0 ? "inf" : "-inf");
+        if (json)
+          this->buffer += '"';
+        return;
+      }
+
+      char text[32];
+      int length = std::snprintf(text, sizeof(text), "%.*g", _digits,
+          _value);
+      bool exact = _digits > 6 ? std::strtod(text, nullptr) == _value :
+          std::strtof(text, nullptr) == static_cast<float>(_value);
+      if (!exact)
+      {
+        length = std::snprintf(text, sizeof(text), "%.*g",
+            _digits > 6 ? 17 : 9, _value);
+      }
+      this->buffer.append(text, static_cast<std::size_t>(length));
+    }
+
+    /// \brief Append the indentation of a level.
+    /// \param[in] _indent Level
+    private: void Indent(const int _indent)
+    {
+      this->buffer.append(static_cast<std::size_t>(_indent) * 2u, ' ');
+    }
+
+    /// \brief Most elements of a repeated field shown
+    private: static constexpr int kMaxElements = 20;
+
+    /// \brief Most characters of a string shown
+    private: static constexpr std::size_t kMaxString = 256u;
+
+    /// \brief Most bytes shown in hex
+    private: static constexpr std::size_t kMaxHexBytes = 16u;
+
+    /// \brief Format of the messages
+    private: EchoFormat format{EchoFormat::TEXT};
+
+    /// \brief Text of the last message formatted, reused
+    private: std::string buffer;
+
+    /// \brief Storage for strings which aren't stored as such, reused
+    private: std::string scratch;
+
+    /// \brief Fields of each message type formatted
+    private: std::unordered_map<const google::protobuf::Descriptor *,
+        std::vector<const google::protobuf::FieldDescriptor *>> fields;
+  };
+
+  /// \brief Part of a message shown instead of the whole message. The
+  /// path uses the syntax of TopicViewer, such as "pose-position-x", and
+  /// may pick an element of a repeated field by its index, such as
+  /// "joint-2". It's resolved once per message type into the fields to go
+  /// through.
+  class EchoFilter
+  {
+    /// \brief Set the path shown.
+    /// \param[in] _path Field path, empty to show whole messages
+    public: void SetPath(const std::string &_path)
+    {
+      this->path = _path;
+      this->type = nullptr;
+    }
+
+    /// \brief Set how messages are formatted.
+    /// \param[in] _format Format
+    public: void SetFormat(const EchoFormat _format)
+    {
+      this->formatter.SetFormat(_format);
+    }
+
+    /// \brief Format the part of a message which is shown.
+    /// \param[in] _msg Message
+    /// \return Text shown for the message
+    public: QString Format(const google::protobuf::Message &_msg)
+    {
+      // formatted straight from the reused buffer
+      bool text = this->formatter.Format() == EchoFormat::TEXT;
+      if (this->path.empty())
+      {
+        if (text)
+          return QString::fromStdString(_msg.DebugString());
+        const auto &formatted = this->formatter.FormatMessage(_msg);
+        return QString::fromUtf8(formatted.data(),
+            static_cast<int>(formatted.size()));
+      }
+      return QString::fromStdString(this->FormatPath(_msg));
+    }
+
+    /// \brief Format the field shown.
+    /// \param[in] _msg Message
+    /// \return Text shown for the message
+    private: std::string FormatPath(const google::protobuf::Message &_msg)
+    {
+      if (_msg.GetDescriptor() != this->type)
+        this->Resolve(_msg.GetDescriptor());
+
+      if (this->steps.empty())
+      {
+        return "Field [" + this->path + "] isn't in [" +
+            this->type->full_name() + "]\n";
+      }
+
+      // Go down to the message holding the field
+      const google::protobuf::Message *msg = &_msg;
+      for (std::size_t i = 0; i + 1 < this->steps.size(); ++i)
+      {
+        const auto &step = this->steps[i];
+        auto ref = msg->GetReflection();
+        if (step.index < 0)
+        {
+          msg = &ref->GetMessage(*msg, step.field);
+        }
+        else if (step.index < ref->FieldSize(*msg, step.field))
+        {
+          msg = &ref->GetRepeatedMessage(*msg, step.field, step.index);
+        }
+        else
+        {
+          return "Field [" + this->path + "] isn't in this message\n";
+        }
+      }
+
+      using google::protobuf::FieldDescriptor;
+      using google::protobuf::TextFormat;
+      const auto &step = this->steps.back();
+      auto ref = msg->GetReflection();
+      if (step.index >= 0 && step.index >= ref->FieldSize(*msg, step.field))
+        return "Field [" + this->path + "] isn't in this message\n";
+
+      if (this->formatter.Format() != EchoFormat::TEXT)
+        return this->formatter.FormatField(*msg, step.field, step.index);
+
+      bool isMessage =
+          step.field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE;
+      std::string text;
+      if (step.index >= 0)
+      {
+        if (isMessage)
+          return ref->GetRepeatedMessage(*msg, step.field,
+              step.index).DebugString();
+
+        TextFormat::PrintFieldValueToString(*msg, step.field, step.index,
+            &text);
+        return step.field->name() + ": " + text + "\n";
+      }
+
+      if (!step.field->is_repeated())
+      {
+        if (isMessage)
+          return ref->GetMessage(*msg, step.field).DebugString();
+
+        TextFormat::PrintFieldValueToString(*msg, step.field, -1, &text);
+        return step.field->name() + ": " + text + "\n";
+      }
+
+      // All elements, the way DebugString prints them
+      TextFormat::Printer printer;
+      printer.SetInitialIndentLevel(1);
+      for (int i = 0; i < ref->FieldSize(*msg, step.field); ++i)
+      {
+        std::string value;
+        if (isMessage)
+        {
+          printer.PrintToString(
+              ref->GetRepeatedMessage(*msg, step.field, i), &value);
+          text += step.field->name() + " {\n" + value + "}\n";
+        }
+        else
+        {
+          TextFormat::PrintFieldValueToString(*msg, step.field, i, &value);
+          text += step.field->name() + ": " + value + "\n";
+        }
+      }
+      return text;
+    }
+
+    /// \brief A field to go through
+    private: struct Step
+    {
+      /// \brief The field
+      const google::protobuf::FieldDescriptor *field;
+
+      /// \brief Element of a repeated field, -1 for the whole field
+      int index;
+    };
+
+    /// \brief Resolve the path against a message type, warning if it
+    /// isn't found.
+    /// \param[in] _type Message type
+    private: void Resolve(const google::protobuf::Descriptor *_type)
+    {
+      this->type = _type;
+      this->steps.clear();
+
+      auto names = common::Split(this->path, '-');
+      auto type = _type;
+      for (std::size_t i = 0; i < names.size(); ++i)
+      {
+        auto field = type ? type->FindFieldByName(names[i]) : nullptr;
+        if (!field)
+        {
+          ignwarn << "Field [" << this->path << "] isn't in ["
+                  << _type->full_name() << "]" << std::endl;
+          this->steps.clear();
+          return;
+        }
+
+        Step step{field, -1};
+        bool more = i + 1 < names.size();
+        if (field->is_repeated() && more &&
+            !names[i + 1].empty() &&
+            names[i + 1].find_first_not_of("0123456789") == std::string::npos)
+        {
+          step.index = std::stoi(names[++i]);
+          more = i + 1 < names.size();
+        }
+        this->steps.push_back(step);
+
+        // Only a single message can be gone through
+        type = field->is_repeated() && step.index < 0 ?
+            nullptr : field->message_type();
+        if (more && !type)
+        {
+          ignwarn << "Field [" << this->path << "] isn't in ["
+                  << _type->full_name() << "]" << std::endl;
+          this->steps.clear();
+          return;
+        }
+      }
+    }
+
+    /// \brief Path shown, empty for the whole message
+    private: std::string path;
+
+    /// \brief Type the path was resolved against, null if not resolved
+    private: const google::protobuf::Descriptor *type{nullptr};
+
+    /// \brief Fields from the message down to the one shown, empty if the
+    /// path isn't in the type
+    private: std::vector<Step> steps;
+
+    /// \brief Formats the messages, unless protobuf's text format is used
+    private: EchoFormatter formatter;
+  };
+
+  /// \brief A row of the echo list
+  struct EchoRow
+  {
+    /// \brief Message shown, null for text added through AddMsg
+    std::shared_ptr<const google::protobuf::Message> msg;
+
+    /// \brief Text shown, formatted from the message when first needed
+    QString text;
+
+    /// \brief True once the text is ready
+    bool formatted{false};
+  };
+
+  /// \brief List of the last messages echoed, held in a circular buffer
+  /// as received. A message is only formatted when a delegate shows it,
+  /// and rows are added and dropped in one batch per frame.
+  class EchoModel : public QAbstractListModel
+  {
+    // Documentation inherited
+    public: int rowCount(const QModelIndex &_parent = QModelIndex()) const
+        override
+    {
+      return _parent.isValid() ? 0 : static_cast<int>(this->count);
+    }
+
+    // Documentation inherited
+    public: QVariant data(const QModelIndex &_index, int _role) const
+        override
+    {
+      if (_role != Qt::DisplayRole || !_index.isValid() ||
+          _index.row() >= this->rowCount())
+      {
+        return QVariant();
+      }
+
+      auto &row = this->Row(_index.row());
+      if (!row.formatted)
+      {
+        row.text = this->filter.Format(*row.msg);
+        row.formatted = true;
+      }
+      return row.text;
+    }
+
+    /// \brief Add rows at the end, dropping the oldest ones which don't
+    /// fit anymore.
+    /// \param[in] _rows Rows to add, oldest first. Only the newest ones
+    /// which fit are added.
+    public: void Append(std::vector<EchoRow> &&_rows)
+    {
+      auto capacity = this->rows.size();
+      if (capacity == 0 || _rows.empty())
+        return;
+
+      auto added = std::min(_rows.size(), capacity);
+      auto dropped = this->count + added > capacity ?
+          this->count + added - capacity : 0u;
+
+      if (dropped > 0)
+      {
+        this->beginRemoveRows(QModelIndex(), 0,
+            static_cast<int>(dropped) - 1);
+        for (std::size_t i = 0; i < dropped; ++i)
+          this->Row(i) = EchoRow();
+        this->start = (this->start + dropped) % capacity;
+        this->count -= dropped;
+        this->endRemoveRows();
+      }
+
+      this->beginInsertRows(QModelIndex(), static_cast<int>(this->count),
+          static_cast<int>(this->count + added) - 1);
+      for (auto it = _rows.end() - added; it != _rows.end(); ++it)
+        this->Row(this->count++) = std::move(*it);
+      this->endInsertRows();
+    }
+
+    /// \brief Set the maximum number of rows, keeping the newest ones.
+    /// \param[in] _capacity Maximum number of rows
+    public: void SetCapacity(const std::size_t _capacity)
+    {
+      if (_capacity == this->rows.size())
+        return;
+
+      auto kept = std::min(this->count, _capacity);
+      auto dropped = this->count - kept;
+      if (dropped > 0)
+      {
+        this->beginRemoveRows(QModelIndex(), 0,
+            static_cast<int>(dropped) - 1);
+      }
+
+      std::vector<EchoRow> resized(_capacity);
+      for (std::size_t i = 0; i < kept; ++i)
+        resized[i] = std::move(this->Row(dropped + i));
+      this->rows = std::move(resized);
+      this->start = 0;
+      this->count = kept;
+
+      if (dropped > 0)
+        this->endRemoveRows();
+    }
+
+    /// \brief Set the part of the messages shown, formatting the rows
+    /// again when they're next shown.
+    /// \param[in] _path Field path, empty to show whole messages
+    public: void SetField(const std::string &_path)
+    {
+      this->filter.SetPath(_path);
+      this->Reformat();
+    }
+
+    /// \brief Set how the messages are formatted, formatting the rows
+    /// again when they're next shown.
+    /// \param[in] _format Format
+    public: void SetFormat(const EchoFormat _format)
+    {
+      this->filter.SetFormat(_format);
+      this->Reformat();
+    }
+
+    /// \brief Format the rows again when they're next shown.
+    private: void Reformat()
+    {
+      if (this->count == 0)
+        return;
+
+      for (std::size_t i = 0; i < this->count; ++i)
+      {
+        auto &row = this->Row(i);
+        if (row.msg)
+        {
+          row.text.clear();
+          row.formatted = false;
+        }
+      }
+      this->dataChanged(this->index(0), this->index(
+          static_cast<int>(this->count) - 1));
+    }
+
+    /// \brief Remove all rows.
+    public: void Clear()
+    {
+      if (this->count == 0)
+        return;
+
+      this->beginRemoveRows(QModelIndex(), 0,
+          static_cast<int>(this->count) - 1);
+      for (auto &row : this->rows)
+        row = EchoRow();
+      this->start = 0;
+      this->count = 0;
+      this->endRemoveRows();
+    }
+
+    /// \brief Get a row from its position in the list.
+    /// \param[in] _row Position, from the oldest row
+    /// \return The row
+    private: EchoRow &Row(const std::size_t _row) const
+    {
+      return this->rows[(this->start + _row) % this->rows.size()];
+    }
+
+    /// \brief Circular buffer of rows, sized to the capacity. Mutable so
+    /// they can be formatted when read.
+    private: mutable std::vector<EchoRow> rows =
+        std::vector<EchoRow>(10u);
+
+    /// \brief Part of the messages shown, mutable so it can be resolved
+    /// when rows are read
+    private: mutable EchoFilter filter;
+
+    /// \brief Storage index of the oldest row
+    private: std::size_t start{0};
+
+    /// \brief Number of rows
+    private: std::size_t count{0};
+  };
+
   class TopicEchoPrivate
   {
+    /// \brief Restart the stats from the messages received so far.
+    /// \param[in] _now Current time
+    public: void ResetStats(const std::chrono::steady_clock::time_point &_now);
+
+    /// \brief Update the stats if they're old enough.
+    /// \param[in] _now Current time
+    /// \return True if they were updated
+    public: bool UpdateStats(const std::chrono::steady_clock::time_point &_now);
+
     /// \brief Topic
     public: QString topic{"/echo"};
 
-    /// \brief A list of text data.
-    public: QStringListModel msgList;
+    /// \brief Path of the field shown, empty for whole messages
+    public: QString field;
+
+    /// \brief How messages are formatted
+    public: QString format{"text"};
+
+    /// \brief The last messages echoed.
+    public: EchoModel msgList;
 
     /// \brief Size of the text buffer. The size is the number of
     /// messages.
     public: unsigned int buffer{10u};
 
     /// \brief Flag used to pause message parsing.
-    public: bool paused{false};
+    public: std::atomic<bool> paused{false};
+
+    /// \brief Maximum number of messages listed per second, 0 for no
+    /// limit.
+    public: double rateLimit{0.0};
+
+    /// \brief Newest message held back by the rate limit
+    public: std::shared_ptr<const google::protobuf::Message> held;
+
+    /// \brief When a message was last listed under the rate limit
+    public: std::chrono::steady_clock::time_point lastListed;
+
+    /// \brief Messages received, counted even while paused
+    public: std::atomic<uint64_t> received{0};
+
+    /// \brief Bytes received, counted even while paused
+    public: std::atomic<uint64_t> receivedBytes{0};
+
+    /// \brief Size of the largest message received since the stats were
+    /// last updated
+    public: std::atomic<uint64_t> largestBytes{0};
+
+    /// \brief When the stats were last updated
+    public: std::chrono::steady_clock::time_point statsTime;
+
+    /// \brief Messages received when the stats were last updated
+    public: uint64_t statsReceived{0};
+
+    /// \brief Bytes received when the stats were last updated
+    public: uint64_t statsBytes{0};
 
-    /// \brief Mutex to protect message buffer.
-    public: std::mutex mutex;
+    /// \brief Messages received per second
+    public: double rate{0.0};
 
-    /// \brief Node for communication
-    public: ignition::transport::Node node;
+    /// \brief Bytes received per second
+    public: double bandwidth{0.0};
+
+    /// \brief Mean message size in bytes
+    public: double meanSize{0.0};
+
+    /// \brief Largest message size in bytes
+    public: double maxSize{0.0};
+
+    /// \brief Messages waiting for the next frame, sized to the buffer.
+    /// Replaced when the buffer changes, so it's only accessed with
+    /// std::atomic_load and std::atomic_store.
+    public: std::shared_ptr<MsgRing> ring{std::make_shared<MsgRing>(10u)};
+
+    /// \brief Moves the received messages to the list once per frame
+    public: QTimer flushTimer;
+
+    /// \brief Subscription to the echoed topic, 0 if none
+    public: std::size_t subscription{0};
   };
 }
 }
@@ -58,6 +1099,45 @@ using namespace ignition;
 using namespace gui;
 using namespace plugins;
 
+/////////////////////////////////////////////////
+void TopicEchoPrivate::ResetStats(
+    const std::chrono::steady_clock::time_point &_now)
+{
+  this->statsTime = _now;
+  this->statsReceived = this->received;
+  this->statsBytes = this->receivedBytes;
+  this->largestBytes = 0;
+  this->rate = 0.0;
+  this->bandwidth = 0.0;
+  this->meanSize = 0.0;
+  this->maxSize = 0.0;
+}
+
+/////////////////////////////////////////////////
+bool TopicEchoPrivate::UpdateStats(
+    const std::chrono::steady_clock::time_point &_now)
+{
+  // Over about a second, like ign topic -f
+  std::chrono::duration<double> elapsed = _now - this->statsTime;
+  if (elapsed.count() < 1.0)
+    return false;
+
+  uint64_t received = this->received;
+  uint64_t bytes = this->receivedBytes;
+  auto count = static_cast<double>(received - this->statsReceived);
+  auto size = static_cast<double>(bytes - this->statsBytes);
+
+  this->rate = count / elapsed.count();
+  this->bandwidth = size / elapsed.count();
+  this->meanSize = count > 0 ? size / count : 0.0;
+  this->maxSize = static_cast<double>(this->largestBytes.exchange(0));
+
+  this->statsTime = _now;
+  this->statsReceived = received;
+  this->statsBytes = bytes;
+  return true;
+}
+
 /////////////////////////////////////////////////
 TopicEcho::TopicEcho()
   : Plugin(), dataPtr(new TopicEchoPrivate)
@@ -65,19 +1145,31 @@ TopicEcho::TopicEcho()
   // Connect model
   App()->Engine()->rootContext()->setContextProperty("TopicEchoMsgList",
       &this->dataPtr->msgList);
+
+  this->dataPtr->flushTimer.setInterval(33);
+  this->connect(&this->dataPtr->flushTimer, SIGNAL(timeout()), this,
+      SLOT(FlushMsgs()));
 }
 
 /////////////////////////////////////////////////
 TopicEcho::~TopicEcho()
 {
+  SubscriptionHub::Instance()->Unsubscribe(this->dataPtr->subscription);
 }
 
 /////////////////////////////////////////////////
-void TopicEcho::LoadConfig(const tinyxml2::XMLElement * /*_pluginElem*/)
+void TopicEcho::LoadConfig(const tinyxml2::XMLElement *_pluginElem)
 {
   if (this->title.empty())
     this->title = "Topic echo";
 
+  if (_pluginElem)
+  {
+    auto formatElem = _pluginElem->FirstChildElement("format");
+    if (formatElem && formatElem->GetText())
+      this->SetFormat(QString(formatElem->GetText()).trimmed());
+  }
+
   this->connect(this, SIGNAL(AddMsg(QString)), this, SLOT(OnAddMsg(QString)),
           Qt::QueuedConnection);
 }
@@ -85,15 +1177,18 @@ void TopicEcho::LoadConfig(const tinyxml2::XMLElement * /*_pluginElem*/)
 /////////////////////////////////////////////////
 void TopicEcho::Stop()
 {
-  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
-
-  // Erase all previous messages
-  this->dataPtr->msgList.removeRows(0,
-      this->dataPtr->msgList.rowCount());
-
   // Unsubscribe
-  for (auto const &sub : this->dataPtr->node.SubscribedTopics())
-    this->dataPtr->node.Unsubscribe(sub);
+  SubscriptionHub::Instance()->Unsubscribe(this->dataPtr->subscription);
+  this->dataPtr->subscription = 0;
+  this->dataPtr->flushTimer.stop();
+  this->dataPtr->held.reset();
+  this->dataPtr->ResetStats(std::chrono::steady_clock::now());
+  this->StatsChanged();
+
+  // Erase all previous messages, including those not listed yet
+  std::atomic_store(&this->dataPtr->ring,
+      std::make_shared<MsgRing>(this->dataPtr->buffer));
+  this->dataPtr->msgList.Clear();
 }
 
 /////////////////////////////////////////////////
@@ -104,44 +1199,92 @@ void TopicEcho::OnEcho(const bool _checked)
   if (!_checked)
     return;
 
-  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
-
   // Subscribe to new topic
   auto topic = this->dataPtr->topic.toStdString();
-  if (!this->dataPtr->node.Subscribe(topic, &TopicEcho::OnMessage, this))
+  this->dataPtr->subscription = SubscriptionHub::Instance()->Subscribe(topic,
+      [this](const std::shared_ptr<const google::protobuf::Message> &_msg)
+      {
+        this->OnMessage(_msg);
+      });
+  if (!this->dataPtr->subscription)
   {
     ignerr << "Invalid topic [" << topic << "]" << std::endl;
+    return;
   }
+  SubscriptionHub::Instance()->SetMsgsPerSec(this->dataPtr->subscription,
+      this->MsgsPerSec());
+  this->dataPtr->ResetStats(std::chrono::steady_clock::now());
+  this->dataPtr->flushTimer.start();
 }
 
 /////////////////////////////////////////////////
-void TopicEcho::OnMessage(const google::protobuf::Message &_msg)
+void TopicEcho::OnMessage(
+    const std::shared_ptr<const google::protobuf::Message> &_msg)
 {
+  // Only counted here, the rates are computed once per second
+  uint64_t size = _msg->ByteSizeLong();
+  ++this->dataPtr->received;
+  this->dataPtr->receivedBytes += size;
+  auto largest = this->dataPtr->largestBytes.load();
+  while (size > largest &&
+      !this->dataPtr->largestBytes.compare_exchange_weak(largest, size))
+  {
+  }
+
   if (this->dataPtr->paused)
     return;
 
-  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
-
-  this->AddMsg(QString::fromStdString(_msg.DebugString()));
+  // Formatted later on the GUI thread, if it's still in the buffer then
+  std::atomic_load(&this->dataPtr->ring)->Push(_msg);
 }
 
 /////////////////////////////////////////////////
-void TopicEcho::OnAddMsg(QString _msg)
+void TopicEcho::FlushMsgs()
 {
-  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto now = std::chrono::steady_clock::now();
+  if (this->dataPtr->UpdateStats(now))
+    this->StatsChanged();
+
+  std::vector<std::shared_ptr<const google::protobuf::Message>> msgs;
+  std::atomic_load(&this->dataPtr->ring)->Drain(msgs);
 
-  // Append msg to list
-  if (this->dataPtr->msgList.insertRow(this->dataPtr->msgList.rowCount()))
+  // Under the rate limit, the newest message waits for its turn and
+  // replaces older ones waiting
+  if (this->dataPtr->rateLimit > 0.0)
   {
-    auto index = this->dataPtr->msgList.index(
-        this->dataPtr->msgList.rowCount() - 1, 0);
-    this->dataPtr->msgList.setData(index, _msg);
+    if (!msgs.empty())
+      this->dataPtr->held = msgs.back();
+    msgs.clear();
+
+    std::chrono::duration<double> sinceListed =
+        now - this->dataPtr->lastListed;
+    if (this->dataPtr->held &&
+        sinceListed.count() >= 1.0 / this->dataPtr->rateLimit)
+    {
+      msgs.push_back(std::move(this->dataPtr->held));
+      this->dataPtr->held.reset();
+      this->dataPtr->lastListed = now;
+    }
   }
 
-  // Remove items if the list is too long.
-  auto diff = this->dataPtr->msgList.rowCount() -
-      this->dataPtr->buffer;
-  this->dataPtr->msgList.removeRows(0, diff);
+  if (msgs.empty())
+    return;
+
+  // Formatted when shown
+  std::vector<EchoRow> rows;
+  rows.reserve(msgs.size());
+  for (auto &msg : msgs)
+    rows.push_back({std::move(msg), QString(), false});
+  this->dataPtr->msgList.Append(std::move(rows));
+}
+
+/////////////////////////////////////////////////
+void TopicEcho::OnAddMsg(QString _msg)
+{
+  // Append msg to list, removing the oldest if the list is too long.
+  std::vector<EchoRow> rows;
+  rows.push_back({nullptr, _msg, true});
+  this->dataPtr->msgList.Append(std::move(rows));
 }
 
 /////////////////////////////////////////////////
@@ -157,16 +1300,116 @@ void TopicEcho::SetTopic(const QString &_topic)
   this->TopicChanged();
 }
 
+/////////////////////////////////////////////////
+QString TopicEcho::Field() const
+{
+  return this->dataPtr->field;
+}
+
+/////////////////////////////////////////////////
+void TopicEcho::SetField(const QString &_field)
+{
+  if (_field == this->dataPtr->field)
+    return;
+
+  this->dataPtr->field = _field;
+  this->dataPtr->msgList.SetField(_field.trimmed().toStdString());
+  this->FieldChanged();
+}
+
+/////////////////////////////////////////////////
+QString TopicEcho::Format() const
+{
+  return this->dataPtr->format;
+}
+
+/////////////////////////////////////////////////
+void TopicEcho::SetFormat(const QString &_format)
+{
+  if (_format == this->dataPtr->format)
+    return;
+
+  static const std::map<QString, EchoFormat> kFormats{
+      {"text", EchoFormat::TEXT},
+      {"compact", EchoFormat::COMPACT},
+      {"json", EchoFormat::JSON},
+      {"size", EchoFormat::SIZE}};
+  auto format = kFormats.find(_format);
+  if (format == kFormats.end())
+  {
+    ignerr << "Unknown format [" << _format.toStdString() << "]" << std::endl;
+    return;
+  }
+
+  this->dataPtr->format = _format;
+  this->dataPtr->msgList.SetFormat(format->second);
+  this->FormatChanged();
+}
+
 /////////////////////////////////////////////////
 void TopicEcho::OnBuffer(const unsigned int _buffer)
 {
+  // List what was received for the previous size before resizing the ring
+  this->FlushMsgs();
+
   this->dataPtr->buffer = _buffer;
+  std::atomic_store(&this->dataPtr->ring, std::make_shared<MsgRing>(_buffer));
+  this->dataPtr->msgList.SetCapacity(_buffer);
+}
+
+/////////////////////////////////////////////////
+double TopicEcho::RateLimit() const
+{
+  return this->dataPtr->rateLimit;
+}
+
+/////////////////////////////////////////////////
+void TopicEcho::SetRateLimit(const double _rateLimit)
+{
+  auto rateLimit = std::max(0.0, _rateLimit);
+  if (rateLimit == this->dataPtr->rateLimit)
+    return;
+
+  this->dataPtr->rateLimit = rateLimit;
+
+  // A message held back is worth showing without a limit
+  if (rateLimit <= 0.0 && this->dataPtr->held)
+  {
+    std::vector<EchoRow> rows;
+    rows.push_back({std::move(this->dataPtr->held), QString(), false});
+    this->dataPtr->held.reset();
+    this->dataPtr->msgList.Append(std::move(rows));
+  }
+  this->RateLimitChanged();
+}
+
+/////////////////////////////////////////////////
+double TopicEcho::Rate() const
+{
+  return this->dataPtr->rate;
+}
+
+/////////////////////////////////////////////////
+double TopicEcho::Bandwidth() const
+{
+  return this->dataPtr->bandwidth;
+}
+
+/////////////////////////////////////////////////
+double TopicEcho::MeanSize() const
+{
+  return this->dataPtr->meanSize;
+}
+
+/////////////////////////////////////////////////
+double TopicEcho::MaxSize() const
+{
+  return this->dataPtr->maxSize;
 }
 
 /////////////////////////////////////////////////
 bool TopicEcho::Paused() const
 {
-  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
   return this->dataPtr->paused;
 }
 
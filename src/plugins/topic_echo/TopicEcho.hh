@@ -41,7 +41,9 @@ namespace plugins
   /// \brief Echo messages coming through an Ignition transport topic.
   ///
   /// ## Configuration
-  /// This plugin doesn't accept any custom configuration.
+  ///
+  /// * \<format\> : How messages are formatted, see SetFormat. Defaults to
+  /// "text".
   class TopicEcho : public Plugin
   {
     Q_OBJECT
@@ -54,6 +56,23 @@ namespace plugins
       NOTIFY TopicChanged
     )
 
+    /// \brief Path of the field shown, empty for whole messages
+    Q_PROPERTY(
+      QString field
+      READ Field
+      WRITE SetField
+      NOTIFY FieldChanged
+    )
+
+    /// \brief How messages are formatted: "text", "compact", "json" or
+    /// "size"
+    Q_PROPERTY(
+      QString format
+      READ Format
+      WRITE SetFormat
+      NOTIFY FormatChanged
+    )
+
     /// \brief Paused
     Q_PROPERTY(
       bool paused
@@ -62,6 +81,43 @@ namespace plugins
       NOTIFY PausedChanged
     )
 
+    /// \brief Maximum number of messages listed per second, 0 for no
+    /// limit. The newest message received is listed each time.
+    Q_PROPERTY(
+      double rateLimit
+      READ RateLimit
+      WRITE SetRateLimit
+      NOTIFY RateLimitChanged
+    )
+
+    /// \brief Messages received per second
+    Q_PROPERTY(
+      double rate
+      READ Rate
+      NOTIFY StatsChanged
+    )
+
+    /// \brief Bytes received per second
+    Q_PROPERTY(
+      double bandwidth
+      READ Bandwidth
+      NOTIFY StatsChanged
+    )
+
+    /// \brief Mean message size in bytes
+    Q_PROPERTY(
+      double meanSize
+      READ MeanSize
+      NOTIFY StatsChanged
+    )
+
+    /// \brief Largest message size in bytes
+    Q_PROPERTY(
+      double maxSize
+      READ MaxSize
+      NOTIFY StatsChanged
+    )
+
     /// \brief Constructor
     public: TopicEcho();
 
@@ -84,6 +140,38 @@ namespace plugins
     /// \brief Notify that topic has changed
     signals: void TopicChanged();
 
+    /// \brief Get the path of the field shown instead of whole messages.
+    /// \return Field path, empty for whole messages
+    public: Q_INVOKABLE QString Field() const;
+
+    /// \brief Show only a field of the messages, for example
+    /// 'pose-position' or 'joint-0' for the first element of a repeated
+    /// field. Paths are the ones given by the topic viewer. Only that field
+    /// is formatted.
+    /// \param[in] _field Field path, empty for whole messages
+    public: Q_INVOKABLE void SetField(const QString &_field);
+
+    /// \brief Notify that the field has changed
+    signals: void FieldChanged();
+
+    /// \brief Get how messages are formatted.
+    /// \return "text", "compact", "json" or "size"
+    public: Q_INVOKABLE QString Format() const;
+
+    /// \brief Set how messages are formatted:
+    /// * "text": protobuf's text format, complete but slow and large for
+    /// messages with large fields
+    /// * "compact": the same text, with long strings, bytes and repeated
+    /// fields cut short
+    /// * "json": JSON, cut short like "compact"
+    /// * "size": only the size of the message and its fields, and the
+    /// first bytes of bytes fields in hex, for images and point clouds
+    /// \param[in] _format Format, unknown ones are ignored
+    public: Q_INVOKABLE void SetFormat(const QString &_format);
+
+    /// \brief Notify that the format has changed
+    signals: void FormatChanged();
+
     public slots: void OnBuffer(const unsigned int _steps);
 
     /// \brief Get whether it is paused
@@ -97,13 +185,53 @@ namespace plugins
     /// \brief Notify that paused has changed
     signals: void PausedChanged();
 
+    /// \brief Get the maximum number of messages listed per second.
+    /// \return Messages per second, 0 for no limit
+    public: Q_INVOKABLE double RateLimit() const;
+
+    /// \brief Set the maximum number of messages listed per second.
+    /// Messages received in between are skipped, except the newest one.
+    /// \param[in] _rateLimit Messages per second, 0 for no limit
+    public: Q_INVOKABLE void SetRateLimit(const double _rateLimit);
+
+    /// \brief Notify that the rate limit has changed
+    signals: void RateLimitChanged();
+
+    /// \brief Get the number of messages received per second, whether
+    /// they're listed or not. Updated every second.
+    /// \return Messages per second
+    public: Q_INVOKABLE double Rate() const;
+
+    /// \brief Get the number of bytes received per second.
+    /// \return Bytes per second
+    public: Q_INVOKABLE double Bandwidth() const;
+
+    /// \brief Get the mean size of the messages received in the last
+    /// second.
+    /// \return Size in bytes
+    public: Q_INVOKABLE double MeanSize() const;
+
+    /// \brief Get the size of the largest message received in the last
+    /// second.
+    /// \return Size in bytes
+    public: Q_INVOKABLE double MaxSize() const;
+
+    /// \brief Notify that the stats have been updated
+    signals: void StatsChanged();
+
     /// \brief Signal to add a message to the GUI list.
+    /// Messages received from the topic don't go through it.
     /// \param[in] _msg Text message to add.
     signals: void AddMsg(QString _msg);
 
-    /// \brief Receives incoming text messages.
-    /// \param[in] _msg New text message.
-    private: void OnMessage(const google::protobuf::Message &_msg);
+    /// \brief Receives incoming messages, queuing them for the next frame.
+    /// Called on a transport thread.
+    /// \param[in] _msg New message.
+    private: void OnMessage(
+        const std::shared_ptr<const google::protobuf::Message> &_msg);
+
+    /// \brief List the messages received since the last frame.
+    private slots: void FlushMsgs();
 
     /// \brief Clear list and unsubscribe.
     private: void Stop();
@@ -58,6 +58,38 @@ Rectangle {
       }
     }
 
+    Label {
+      text: "Field (empty for whole messages)"
+    }
+
+    TextField {
+      id: fieldField
+      text: TopicEcho.field
+      placeholderText: "pose-position"
+      selectByMouse: true
+      onEditingFinished: {
+        TopicEcho.SetField(text)
+      }
+    }
+
+    Label {
+      text: "Format"
+    }
+
+    ComboBox {
+      id: formatField
+      model: ["text", "compact", "json", "size"]
+      currentIndex: Math.max(model.indexOf(TopicEcho.format), 0)
+      onActivated: {
+        TopicEcho.SetFormat(currentText)
+      }
+      ToolTip.visible: hovered
+      ToolTip.delay: tooltipDelay
+      ToolTip.timeout: tooltipTimeout
+      ToolTip.text: qsTr("Compact and json cut long fields short, size " +
+          "only shows the sizes of the fields, for images and point clouds")
+    }
+
     Label {
       text: "Buffer"
     }
@@ -70,6 +102,19 @@ Rectangle {
       }
     }
 
+    Label {
+      text: "Rate limit (msgs/s, 0 for none)"
+    }
+
+    SpinBox {
+      id: rateLimitField
+      value: TopicEcho.rateLimit
+      to: 1000
+      onValueModified: {
+        TopicEcho.SetRateLimit(value)
+      }
+    }
+
     CheckBox {
       text: qsTr("Pause")
       checked: TopicEcho.paused
@@ -78,6 +123,14 @@ Rectangle {
       }
     }
 
+    Label {
+      id: statsLabel
+      text: TopicEcho.rate.toFixed(1) + " Hz, " +
+          (TopicEcho.bandwidth / 1024).toFixed(2) + " KB/s, mean " +
+          TopicEcho.meanSize.toFixed(0) + " B, max " +
+          TopicEcho.maxSize.toFixed(0) + " B"
+    }
+
     Label {
       id: msgsLabel
       text: "Messages"
@@ -85,7 +138,7 @@ Rectangle {
 
     Rectangle {
       width: topicEcho.parent !== null ? topicEcho.parent.width - 20 : 50
-      height: topicEcho.parent !== null ? topicEcho.parent.height - 200 : 50
+      height: topicEcho.parent !== null ? topicEcho.parent.height - 420 : 50
       color: "transparent"
 
       ListView {
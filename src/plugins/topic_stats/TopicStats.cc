@@ -0,0 +1,529 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <QAbstractListModel>
+#include <QTimer>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/plugin/Register.hh>
+#include <ignition/transport/MessageInfo.hh>
+#include <ignition/transport/Node.hh>
+#include <ignition/transport/Publisher.hh>
+
+#include "ignition/gui/Enums.hh"
+#include "ignition/gui/SearchModel.hh"
+#include "ignition/gui/TopicRegistry.hh"
+
+#include "TopicStats.hh"
+
+#define NAME_ROLE DataRole::DISPLAY_NAME
+#define TYPE_ROLE (Qt::UserRole + 1)
+#define MESSAGES_ROLE (Qt::UserRole + 2)
+#define RATE_ROLE (Qt::UserRole + 3)
+#define BANDWIDTH_ROLE (Qt::UserRole + 4)
+#define JITTER_ROLE (Qt::UserRole + 5)
+#define PUBLISHERS_ROLE (Qt::UserRole + 6)
+
+namespace ignition
+{
+namespace gui
+{
+namespace plugins
+{
+  /// \brief Counts the messages of a topic as they arrive, shared with its
+  /// raw subscription so callbacks in flight when it's unsubscribed don't
+  /// outlive it
+  class TopicCounter
+  {
+    /// \brief Count a message.
+    /// \param[in] _size Size of the message, in bytes
+    public: void OnMessage(const std::size_t _size)
+    {
+      auto now = std::chrono::steady_clock::now();
+
+      std::lock_guard<std::mutex> lock(this->mutex);
+      ++this->total;
+      ++this->messages;
+      this->bytes += _size;
+
+      // inter-arrival times, with Welford's running variance
+      if (this->hasLast)
+      {
+        double interval = std::chrono::duration<double>(
+            now - this->last).count();
+        ++this->intervals;
+        double delta = interval - this->mean;
+        this->mean += delta / static_cast<double>(this->intervals);
+        this->m2 += delta * (interval - this->mean);
+      }
+      this->last = now;
+      this->hasLast = true;
+    }
+
+    /// \brief Protects the members below
+    public: std::mutex mutex;
+
+    /// \brief Messages since the topic was subscribed to
+    public: uint64_t total{0u};
+
+    /// \brief Messages since the last refresh
+    public: uint64_t messages{0u};
+
+    /// \brief Bytes since the last refresh
+    public: uint64_t bytes{0u};
+
+    /// \brief Intervals between messages since the last refresh
+    public: uint64_t intervals{0u};
+
+    /// \brief Mean of those intervals, in seconds
+    public: double mean{0.0};
+
+    /// \brief Sum of the squared differences of those intervals to their
+    /// mean
+    public: double m2{0.0};
+
+    /// \brief Time of the last message
+    public: std::chrono::steady_clock::time_point last;
+
+    /// \brief True once a message arrived
+    public: bool hasLast{false};
+  };
+
+  /// \brief A topic and its statistics, as shown
+  struct TopicStatsRow
+  {
+    /// \brief Topic name
+    QString name;
+
+    /// \brief Message type
+    QString type;
+
+    /// \brief Messages received since the topic was found
+    uint64_t messages;
+
+    /// \brief Messages per second
+    double rate;
+
+    /// \brief Bytes per second
+    double bandwidth;
+
+    /// \brief Standard deviation of the time between messages, in
+    /// milliseconds
+    double jitter;
+
+    /// \brief Number of publishers
+    int publishers;
+
+    /// \brief Counts the messages, null while not subscribed
+    std::shared_ptr<TopicCounter> counter;
+  };
+
+  /// \brief Flat model of the topics and their statistics
+  class TopicStatsModel : public QAbstractListModel
+  {
+    // Documentation inherited
+    public: int rowCount(const QModelIndex &_parent = QModelIndex()) const
+                override
+    {
+      return _parent.isValid() ? 0 : static_cast<int>(this->rows.size());
+    }
+
+    // Documentation inherited
+    public: QVariant data(const QModelIndex &_index, int _role) const
+                override;
+
+    /// \brief roles and names of the model
+    public: QHash<int, QByteArray> roleNames() const override
+    {
+      QHash<int, QByteArray> roles;
+      roles[NAME_ROLE] = "name";
+      roles[TYPE_ROLE] = "type";
+      roles[MESSAGES_ROLE] = "messages";
+      roles[RATE_ROLE] = "rate";
+      roles[BANDWIDTH_ROLE] = "bandwidth";
+      roles[JITTER_ROLE] = "jitter";
+      roles[PUBLISHERS_ROLE] = "publishers";
+      return roles;
+    }
+
+    /// \brief Notify that the statistics of all rows changed, only for the
+    /// statistics roles, so the names aren't searched again.
+    public: void StatsChanged()
+    {
+      if (this->rows.empty())
+        return;
+
+      emit this->dataChanged(this->index(0),
+          this->index(static_cast<int>(this->rows.size()) - 1),
+          {MESSAGES_ROLE, RATE_ROLE, BANDWIDTH_ROLE, JITTER_ROLE,
+           PUBLISHERS_ROLE});
+    }
+
+    /// \brief Topics, sorted by name
+    public: std::vector<TopicStatsRow> rows;
+
+    /// \brief Allow the plugin to insert and remove rows
+    friend class TopicStats;
+  };
+
+  class TopicStatsPrivate
+  {
+    /// \brief Subscribe to a topic, to count its messages.
+    /// \param[in] _row Topic
+    public: void Subscribe(TopicStatsRow &_row);
+
+    /// \brief Stop counting the messages of a topic.
+    /// \param[in] _row Topic
+    public: void Unsubscribe(TopicStatsRow &_row);
+
+    /// \brief Update the number of publishers of all topics.
+    public: void UpdatePublishers();
+
+    /// \brief Node with the raw subscriptions, apart from the
+    /// subscriptions of other plugins
+    public: transport::Node node;
+
+    /// \brief Topics and their statistics
+    public: TopicStatsModel model;
+
+    /// \brief Topics filtered by the search and sorted, shown
+    public: SearchModel searchModel;
+
+    /// \brief Updates the statistics
+    public: QTimer timer;
+
+    /// \brief Time of the last refresh
+    public: std::chrono::steady_clock::time_point lastRefresh;
+
+    /// \brief Refreshes since the publishers were last counted
+    public: unsigned int sincePublishers{0u};
+
+    /// \brief True while the plugin isn't visible
+    public: bool suspended{false};
+  };
+}
+}
+}
+
+using namespace ignition;
+using namespace gui;
+using namespace plugins;
+
+/// \brief Default milliseconds between refreshes
+static const int kRefreshPeriod = 1000;
+
+/// \brief Refreshes between counts of the publishers, which ask discovery
+/// about every topic
+static const unsigned int kPublishersPeriod = 5u;
+
+/// \brief Delay before searching, so typing isn't slowed down by large
+/// numbers of topics
+static const int kSearchDelay = 200;
+
+/////////////////////////////////////////////////
+QVariant TopicStatsModel::data(const QModelIndex &_index, int _role) const
+{
+  if (!_index.isValid() || _index.row() >= this->rowCount())
+    return QVariant();
+
+  const auto &row = this->rows[_index.row()];
+  switch (_role)
+  {
+    case Qt::DisplayRole:
+    case NAME_ROLE:
+      return row.name;
+    case TYPE_ROLE:
+      return row.type;
+    case MESSAGES_ROLE:
+      return static_cast<qulonglong>(row.messages);
+    case RATE_ROLE:
+      return row.rate;
+    case BANDWIDTH_ROLE:
+      return row.bandwidth;
+    case JITTER_ROLE:
+      return row.jitter;
+    case PUBLISHERS_ROLE:
+      return row.publishers;
+    default:
+      return QVariant();
+  }
+}
+
+/////////////////////////////////////////////////
+void TopicStatsPrivate::Subscribe(TopicStatsRow &_row)
+{
+  // counted on from before, if it was subscribed to earlier
+  auto counter = std::make_shared<TopicCounter>();
+  counter->total = _row.messages;
+  auto cb = [counter](const char *, const std::size_t _size,
+      const transport::MessageInfo &)
+  {
+    counter->OnMessage(_size);
+  };
+
+  if (!this->node.SubscribeRaw(_row.name.toStdString(), cb))
+  {
+    ignwarn << "Unable to subscribe to topic [" << _row.name.toStdString()
+            << "]" << std::endl;
+    return;
+  }
+  _row.counter = counter;
+}
+
+/////////////////////////////////////////////////
+void TopicStatsPrivate::Unsubscribe(TopicStatsRow &_row)
+{
+  if (!_row.counter)
+    return;
+
+  this->node.Unsubscribe(_row.name.toStdString());
+  _row.counter.reset();
+}
+
+/////////////////////////////////////////////////
+void TopicStatsPrivate::UpdatePublishers()
+{
+  this->sincePublishers = 0u;
+
+  std::vector<transport::MessagePublisher> publishers;
+  for (auto &row : this->model.rows)
+  {
+    publishers.clear();
+    this->node.TopicInfo(row.name.toStdString(), publishers);
+    row.publishers = static_cast<int>(publishers.size());
+  }
+}
+
+/////////////////////////////////////////////////
+TopicStats::TopicStats()
+  : Plugin(), dataPtr(new TopicStatsPrivate)
+{
+  this->dataPtr->searchModel.setFilterRole(NAME_ROLE);
+  this->dataPtr->searchModel.setSortRole(NAME_ROLE);
+  this->dataPtr->searchModel.SetDelay(kSearchDelay);
+  this->dataPtr->searchModel.setSourceModel(&this->dataPtr->model);
+  this->dataPtr->searchModel.sort(0);
+
+  // connected first so no change is missed while the topics are added
+  connect(TopicRegistry::Instance(), SIGNAL(TopicsChanged()), this,
+          SLOT(UpdateTopics()), Qt::QueuedConnection);
+
+  this->dataPtr->timer.setInterval(kRefreshPeriod);
+  connect(&this->dataPtr->timer, SIGNAL(timeout()), this, SLOT(Refresh()));
+
+  this->UpdateTopics();
+  this->dataPtr->lastRefresh = std::chrono::steady_clock::now();
+  this->dataPtr->timer.start();
+}
+
+/////////////////////////////////////////////////
+TopicStats::~TopicStats()
+{
+  for (auto &row : this->dataPtr->model.rows)
+    this->dataPtr->Unsubscribe(row);
+}
+
+/////////////////////////////////////////////////
+void TopicStats::LoadConfig(const tinyxml2::XMLElement *_pluginElem)
+{
+  if (this->title.empty())
+    this->title = "Topic statistics";
+
+  if (!_pluginElem)
+    return;
+
+  if (auto periodElem = _pluginElem->FirstChildElement("refresh_period"))
+  {
+    int period{kRefreshPeriod};
+    periodElem->QueryIntText(&period);
+    if (period > 0)
+      this->dataPtr->timer.setInterval(period);
+    else
+      ignwarn << "Invalid refresh period [" << period << "]" << std::endl;
+  }
+}
+
+/////////////////////////////////////////////////
+QObject *TopicStats::Model() const
+{
+  return &this->dataPtr->searchModel;
+}
+
+/////////////////////////////////////////////////
+void TopicStats::OnSearch(const QString &_search)
+{
+  this->dataPtr->searchModel.SetSearch(_search);
+}
+
+/////////////////////////////////////////////////
+void TopicStats::OnSort(const QString &_role, const bool _ascending)
+{
+  auto roles = this->dataPtr->model.roleNames();
+  auto role = roles.key(_role.toUtf8(), -1);
+  if (role < 0)
+  {
+    ignerr << "Unknown role [" << _role.toStdString() << "]" << std::endl;
+    return;
+  }
+
+  this->dataPtr->searchModel.setSortRole(role);
+  this->dataPtr->searchModel.sort(0,
+      _ascending ? Qt::AscendingOrder : Qt::DescendingOrder);
+}
+
+/////////////////////////////////////////////////
+void TopicStats::UpdateTopics()
+{
+  auto topics = TopicRegistry::Instance()->Topics();
+  auto &model = this->dataPtr->model;
+  auto &rows = model.rows;
+
+  // both are sorted by name, so they're compared in one pass, removing
+  // from the back so the rows before keep their position
+  std::vector<std::pair<std::string, std::string>> added;
+  auto next = topics.rbegin();
+  for (int i = static_cast<int>(rows.size()) - 1; i >= 0 ||
+       next != topics.rend();)
+  {
+    std::string name = i >= 0 ? rows[i].name.toStdString() : std::string();
+    if (next == topics.rend() || (i >= 0 && name > next->first))
+    {
+      model.beginRemoveRows(QModelIndex(), i, i);
+      this->dataPtr->Unsubscribe(rows[i]);
+      rows.erase(rows.begin() + i);
+      model.endRemoveRows();
+      --i;
+    }
+    else if (i < 0 || next->first > name)
+    {
+      added.push_back(*next);
+      ++next;
+    }
+    else
+    {
+      rows[i].type = QString::fromStdString(next->second);
+      --i;
+      ++next;
+    }
+  }
+
+  for (const auto &topic : added)
+  {
+    auto name = QString::fromStdString(topic.first);
+    auto it = std::lower_bound(rows.begin(), rows.end(), name,
+        [](const TopicStatsRow &_row, const QString &_name)
+        {
+          return _row.name < _name;
+        });
+    int row = static_cast<int>(it - rows.begin());
+
+    model.beginInsertRows(QModelIndex(), row, row);
+    it = rows.insert(it, TopicStatsRow{name,
+        QString::fromStdString(topic.second), 0u, 0.0, 0.0, 0.0, 0,
+        nullptr});
+    if (!this->dataPtr->suspended)
+      this->dataPtr->Subscribe(*it);
+    model.endInsertRows();
+  }
+
+  if (!added.empty())
+    this->dataPtr->UpdatePublishers();
+}
+
+/////////////////////////////////////////////////
+void TopicStats::Refresh()
+{
+  auto now = std::chrono::steady_clock::now();
+  double elapsed = std::chrono::duration<double>(
+      now - this->dataPtr->lastRefresh).count();
+  this->dataPtr->lastRefresh = now;
+  if (elapsed <= 0.0)
+    return;
+
+  for (auto &row : this->dataPtr->model.rows)
+  {
+    if (!row.counter)
+      continue;
+
+    auto &counter = *row.counter;
+    std::lock_guard<std::mutex> lock(counter.mutex);
+    row.messages = counter.total;
+    row.rate = static_cast<double>(counter.messages) / elapsed;
+    row.bandwidth = static_cast<double>(counter.bytes) / elapsed;
+    row.jitter = counter.intervals > 1u ?
+        std::sqrt(counter.m2 /
+        static_cast<double>(counter.intervals - 1u)) * 1000.0 : 0.0;
+
+    counter.messages = 0u;
+    counter.bytes = 0u;
+    counter.intervals = 0u;
+    counter.mean = 0.0;
+    counter.m2 = 0.0;
+  }
+
+  if (++this->dataPtr->sincePublishers >= kPublishersPeriod)
+    this->dataPtr->UpdatePublishers();
+
+  this->dataPtr->model.StatsChanged();
+}
+
+/////////////////////////////////////////////////
+void TopicStats::Suspend()
+{
+  this->dataPtr->suspended = true;
+  this->dataPtr->timer.stop();
+  for (auto &row : this->dataPtr->model.rows)
+    this->dataPtr->Unsubscribe(row);
+}
+
+/////////////////////////////////////////////////
+void TopicStats::Resume()
+{
+  this->dataPtr->suspended = false;
+  for (auto &row : this->dataPtr->model.rows)
+  {
+    this->dataPtr->Subscribe(row);
+
+    // counted again from here
+    row.rate = 0.0;
+    row.bandwidth = 0.0;
+    row.jitter = 0.0;
+  }
+  this->dataPtr->lastRefresh = std::chrono::steady_clock::now();
+  this->dataPtr->timer.start();
+}
+
+/////////////////////////////////////////////////
+std::size_t TopicStats::MemoryUsage() const
+{
+  return this->dataPtr->model.rows.capacity() * sizeof(TopicStatsRow) +
+      this->dataPtr->model.rows.size() * sizeof(TopicCounter);
+}
+
+// Register this plugin
+IGNITION_ADD_PLUGIN(ignition::gui::plugins::TopicStats,
+                    ignition::gui::Plugin)
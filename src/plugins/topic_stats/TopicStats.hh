@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GUI_PLUGINS_TOPICSTATS_HH_
+#define IGNITION_GUI_PLUGINS_TOPICSTATS_HH_
+
+#include <memory>
+
+#include <ignition/gui/Plugin.hh>
+
+#ifndef _WIN32
+#  define TopicStats_EXPORTS_API
+#else
+#  if (defined(TopicStats_EXPORTS))
+#    define TopicStats_EXPORTS_API __declspec(dllexport)
+#  else
+#    define TopicStats_EXPORTS_API __declspec(dllimport)
+#  endif
+#endif
+
+namespace ignition
+{
+namespace gui
+{
+namespace plugins
+{
+  class TopicStatsPrivate;
+
+  /// \brief Lists all topics with their message count, rate, bandwidth,
+  /// inter-arrival jitter and number of publishers.
+  ///
+  /// Messages are received as raw bytes and never parsed, so the cost of
+  /// watching a topic is counting its messages, and thousands of topics
+  /// can be watched at once. Statistics are over the last refresh period,
+  /// except for the message count which is since the topic was found.
+  ///
+  /// ## Configuration
+  ///
+  /// * \<refresh_period\> : Milliseconds between updates of the statistics,
+  /// defaults to 1000.
+  class TopicStats_EXPORTS_API TopicStats : public Plugin
+  {
+    Q_OBJECT
+
+    /// \brief Topics and their statistics, filtered by the search and
+    /// sorted
+    Q_PROPERTY(
+      QObject *model
+      READ Model
+      CONSTANT
+    )
+
+    /// \brief Constructor
+    public: TopicStats();
+
+    /// \brief Destructor
+    public: ~TopicStats() override;
+
+    // Documentation inherited
+    public: void LoadConfig(const tinyxml2::XMLElement *_pluginElem) override;
+
+    /// \brief Get the model of the topics shown, filtered by the search
+    /// and sorted. Its rows have the roles "name", "type", "messages",
+    /// "rate", "bandwidth", "jitter" and "publishers".
+    /// \return Pointer to the model
+    public: Q_INVOKABLE QObject *Model() const;
+
+    /// \brief Show only the topics whose name contains all words of a
+    /// search.
+    /// \param[in] _search Words separated by spaces, empty for all topics
+    public slots: void OnSearch(const QString &_search);
+
+    /// \brief Sort the topics shown.
+    /// \param[in] _role Role sorted by, such as "name" or "rate"
+    /// \param[in] _ascending True for ascending order
+    public slots: void OnSort(const QString &_role, const bool _ascending);
+
+    /// \brief Update the topics as they come and go.
+    private slots: void UpdateTopics();
+
+    /// \brief Update the statistics, once per refresh period.
+    private slots: void Refresh();
+
+    // Documentation inherited
+    protected: void Suspend() override;
+
+    // Documentation inherited
+    protected: void Resume() override;
+
+    // Documentation inherited
+    public: std::size_t MemoryUsage() const override;
+
+    /// \internal
+    /// \brief Pointer to private data.
+    private: std::unique_ptr<TopicStatsPrivate> dataPtr;
+  };
+}
+}
+}
+
+#endif
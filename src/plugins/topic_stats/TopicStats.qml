@@ -0,0 +1,195 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+import QtQuick 2.9
+import QtQuick.Controls 2.2
+import QtQuick.Controls.Material 2.1
+import QtQuick.Layouts 1.3
+
+ColumnLayout {
+  id: topicStats
+  Layout.minimumWidth: 560
+  Layout.minimumHeight: 300
+  anchors.fill: parent
+  spacing: 0
+
+  /**
+   * Role the topics are sorted by
+   */
+  property string sortRole: "name"
+
+  /**
+   * True to sort in ascending order
+   */
+  property bool ascending: true
+
+  property int rowHeight: 26
+
+  property color textColor: (Material.theme == Material.Light) ?
+      Material.color(Material.Grey, Material.Shade800) :
+      Material.color(Material.Grey, Material.Shade400)
+
+  property color oddColor: (Material.theme == Material.Light) ?
+      Material.color(Material.Grey, Material.Shade100) :
+      Material.color(Material.Grey, Material.Shade800)
+
+  property color evenColor: (Material.theme == Material.Light) ?
+      Material.color(Material.Grey, Material.Shade200) :
+      Material.color(Material.Grey, Material.Shade900)
+
+  /**
+   * Columns, the first one takes the space left by the others
+   */
+  property var columns: [
+    {"role": "name", "title": "Topic", "width": 0},
+    {"role": "messages", "title": "Messages", "width": 80},
+    {"role": "rate", "title": "Hz", "width": 70},
+    {"role": "bandwidth", "title": "Bandwidth", "width": 90},
+    {"role": "jitter", "title": "Jitter", "width": 70},
+    {"role": "publishers", "title": "Pubs", "width": 50}
+  ]
+
+  function columnWidth(_index)
+  {
+    if (columns[_index].width > 0)
+      return columns[_index].width;
+
+    var others = 0;
+    for (var i = 0; i < columns.length; ++i)
+      others += columns[i].width;
+    return Math.max(topicStats.width - others, 100);
+  }
+
+  function formatBytes(_bytes)
+  {
+    if (_bytes < 1024)
+      return _bytes.toFixed(0) + " B/s";
+    if (_bytes < 1024 * 1024)
+      return (_bytes / 1024).toFixed(1) + " KB/s";
+    return (_bytes / (1024 * 1024)).toFixed(1) + " MB/s";
+  }
+
+  function cellText(_row, _role)
+  {
+    switch (_role)
+    {
+      case "name":
+        return _row.name;
+      case "messages":
+        return _row.messages;
+      case "rate":
+        return _row.rate.toFixed(1);
+      case "bandwidth":
+        return formatBytes(_row.bandwidth);
+      case "jitter":
+        return _row.jitter.toFixed(1) + " ms";
+      case "publishers":
+        return _row.publishers;
+    }
+    return "";
+  }
+
+  function sortBy(_role)
+  {
+    // statistics are more interesting from the highest
+    if (sortRole === _role)
+      ascending = !ascending;
+    else
+      ascending = (_role === "name");
+    sortRole = _role;
+    TopicStats.OnSort(sortRole, ascending);
+  }
+
+  TextField {
+    id: searchField
+    Layout.fillWidth: true
+    Layout.leftMargin: 5
+    Layout.rightMargin: 5
+    placeholderText: "Search topics"
+    selectByMouse: true
+    onTextChanged: TopicStats.OnSearch(text)
+  }
+
+  Row {
+    id: header
+    Layout.fillWidth: true
+    Layout.preferredHeight: rowHeight
+
+    Repeater {
+      model: columns.length
+      delegate: ToolButton {
+        width: columnWidth(index)
+        height: rowHeight
+        text: columns[index].title +
+              (sortRole === columns[index].role ? (ascending ? " ▲" : " ▼") :
+               "")
+        font.pointSize: 10
+        font.bold: sortRole === columns[index].role
+        onClicked: sortBy(columns[index].role)
+      }
+    }
+  }
+
+  ListView {
+    id: list
+    Layout.fillWidth: true
+    Layout.fillHeight: true
+    clip: true
+    model: TopicStats.model
+    ScrollBar.vertical: ScrollBar {
+      policy: ScrollBar.AsNeeded
+    }
+
+    delegate: Rectangle {
+      width: list.width
+      height: rowHeight
+      color: (index % 2 == 0) ? evenColor : oddColor
+
+      property var row: model
+
+      Row {
+        anchors.fill: parent
+        Repeater {
+          model: columns.length
+          delegate: Text {
+            width: columnWidth(index)
+            height: rowHeight
+            leftPadding: 5
+            rightPadding: 5
+            verticalAlignment: Text.AlignVCenter
+            horizontalAlignment: index == 0 ? Text.AlignLeft :
+                                              Text.AlignRight
+            elide: Text.ElideMiddle
+            color: textColor
+            font.pointSize: 10
+            text: cellText(row, columns[index].role)
+          }
+        }
+      }
+
+      ToolTip.visible: hover.containsMouse
+      ToolTip.delay: 500
+      ToolTip.text: row.name + "\n" + row.type
+
+      MouseArea {
+        id: hover
+        anchors.fill: parent
+        hoverEnabled: true
+        acceptedButtons: Qt.NoButton
+      }
+    }
+  }
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include <ignition/common/Console.hh>
+#include <ignition/msgs/stringmsg.pb.h>
+#include <ignition/transport/Node.hh>
+#include <ignition/utilities/ExtraTestMacros.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+#include "ignition/gui/Application.hh"
+#include "ignition/gui/Enums.hh"
+#include "ignition/gui/MainWindow.hh"
+#include "ignition/gui/Plugin.hh"
+#include "TopicStats.hh"
+
+int g_argc = 1;
+char **g_argv = new char *[g_argc];
+
+using namespace ignition;
+using namespace gui;
+
+/////////////////////////////////////////////////
+TEST(TopicStatsTest, IGN_UTILS_TEST_ENABLED_ONLY_ON_LINUX(Stats))
+{
+  setenv("IGN_PARTITION", "ign-gui-topic-stats-test", 1);
+
+  transport::Node node;
+  auto fast = node.Advertise<msgs::StringMsg>("/stats_fast");
+  auto slow = node.Advertise<msgs::StringMsg>("/stats_slow");
+  msgs::StringMsg msg;
+  msg.set_data(std::string(100, 'a'));
+
+  // about 100 Hz and 10 Hz
+  std::atomic<bool> publishing{true};
+  std::thread publisher([&]()
+  {
+    for (int i = 0; publishing; ++i)
+    {
+      fast.Publish(msg);
+      if (i % 10 == 0)
+        slow.Publish(msg);
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+  common::Console::SetVerbosity(4);
+
+  Application app(g_argc, g_argv);
+  app.AddPluginPath(std::string(PROJECT_BINARY_PATH) + "/lib");
+
+  const char *pluginStr =
+    "<plugin filename=\"TopicStats\">"
+      "<refresh_period>500</refresh_period>"
+    "</plugin>";
+
+  tinyxml2::XMLDocument pluginDoc;
+  EXPECT_EQ(tinyxml2::XML_SUCCESS, pluginDoc.Parse(pluginStr));
+  EXPECT_TRUE(app.LoadPlugin("TopicStats",
+      pluginDoc.FirstChildElement("plugin")));
+
+  auto win = app.findChild<MainWindow *>();
+  ASSERT_NE(nullptr, win);
+  auto plugins = win->findChildren<plugins::TopicStats *>();
+  ASSERT_EQ(plugins.size(), 1);
+  auto plugin = plugins[0];
+  EXPECT_EQ("Topic statistics", plugin->Title());
+
+  auto model = qobject_cast<QAbstractItemModel *>(plugin->Model());
+  ASSERT_NE(nullptr, model);
+  auto roles = model->roleNames();
+  auto role = [&roles](const char *_name)
+  {
+    return roles.key(_name);
+  };
+
+  auto row = [&](const QString &_topic)
+  {
+    for (int i = 0; i < model->rowCount(); ++i)
+    {
+      auto index = model->index(i, 0);
+      if (model->data(index, role("name")) == _topic)
+        return index;
+    }
+    return QModelIndex();
+  };
+
+  // a few refreshes
+  auto start = std::chrono::steady_clock::now();
+  while (std::chrono::steady_clock::now() - start <
+         std::chrono::milliseconds(1700))
+  {
+    QCoreApplication::processEvents();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  auto fastRow = row("/stats_fast");
+  auto slowRow = row("/stats_slow");
+  ASSERT_TRUE(fastRow.isValid());
+  ASSERT_TRUE(slowRow.isValid());
+  EXPECT_EQ("ignition.msgs.StringMsg",
+      model->data(fastRow, role("type")).toString());
+
+  EXPECT_GT(model->data(fastRow, role("messages")).toULongLong(), 50u);
+  auto rate = model->data(fastRow, role("rate")).toDouble();
+  EXPECT_GT(rate, 50.0);
+  EXPECT_LT(rate, 120.0);
+  EXPECT_GT(model->data(fastRow, role("bandwidth")).toDouble(), rate * 100);
+  EXPECT_GE(model->data(fastRow, role("jitter")).toDouble(), 0.0);
+  EXPECT_EQ(1, model->data(fastRow, role("publishers")).toInt());
+  EXPECT_LT(model->data(slowRow, role("rate")).toDouble(), rate);
+
+  // fastest first
+  plugin->OnSort("rate", false);
+  EXPECT_EQ("/stats_fast", model->data(model->index(0, 0), role("name")));
+
+  // searched by name, once typing pauses
+  plugin->OnSearch("slow");
+  start = std::chrono::steady_clock::now();
+  while (model->rowCount() != 1 && std::chrono::steady_clock::now() - start <
+         std::chrono::seconds(2))
+  {
+    QCoreApplication::processEvents();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  ASSERT_EQ(1, model->rowCount());
+  EXPECT_EQ("/stats_slow", model->data(model->index(0, 0), role("name")));
+
+  publishing = false;
+  publisher.join();
+}
@@ -15,15 +15,24 @@
  *
 */
 
+#include <QAbstractItemModel>
 #include <QModelIndex>
-#include <QStandardItem>
 #include <QString>
-
-#include <deque>
+#include <QTimer>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <ignition/gui/Application.hh>
+#include <ignition/gui/MsgSchema.hh>
+#include <ignition/gui/TopicRegistry.hh>
 
 #include <ignition/transport/MessageInfo.hh>
 #include <ignition/transport/Node.hh>
@@ -38,12 +47,18 @@
 #define TOPIC_KEY "topic"
 #define PATH_KEY "path"
 #define PLOT_KEY "plottable"
+#define RATE_KEY "rate"
+#define BANDWIDTH_KEY "bandwidth"
+#define SIZE_KEY "size"
 
 #define NAME_ROLE 51
 #define TYPE_ROLE 52
 #define TOPIC_ROLE 53
 #define PATH_ROLE 54
 #define PLOT_ROLE 55
+#define RATE_ROLE 56
+#define BANDWIDTH_ROLE 57
+#define SIZE_ROLE 58
 
 namespace ignition
 {
@@ -51,11 +66,156 @@ namespace gui
 {
 namespace plugins
 {
+  struct MsgTree;
+
+  /// \brief A field of a message type, as shown in the tree
+  struct FieldTree
+  {
+    /// \brief Field name
+    std::string name;
+
+    /// \brief Type shown, such as "Pose" or "double"
+    std::string type;
+
+    /// \brief True if the field can be plotted
+    bool plottable;
+
+    /// \brief Fields of a message field, null for other fields
+    std::shared_ptr<const MsgTree> msg;
+  };
+
+  /// \brief The fields of a message type, expanded once and shared by all
+  /// the topics carrying it
+  struct MsgTree
+  {
+    /// \brief Fields shown, in declaration order
+    std::vector<FieldTree> fields;
+  };
+
+  /// \brief An item of the topics tree. The items of a message's fields
+  /// are only created when it's first expanded.
+  struct TopicItem
+  {
+    /// \brief Parent item, null for the root
+    TopicItem *parent;
+
+    /// \brief Row in the parent
+    int row;
+
+    /// \brief Field shown, null for topics and the root
+    const FieldTree *field;
+
+    /// \brief Topic name, for topics only
+    std::string topic;
+
+    /// \brief Message type, for topics only
+    std::string type;
+
+    /// \brief Path of the field from the topic's message, such as
+    /// "pose-position-x"
+    std::string path;
+
+    /// \brief Fields of the message shown, null for other fields. Holds
+    /// the tree the children's fields point into.
+    std::shared_ptr<const MsgTree> msg;
+
+    /// \brief True once the children were created
+    bool fetched;
+
+    /// \brief Children, in the order of the message's fields
+    std::vector<std::unique_ptr<TopicItem>> children;
+  };
+
+  /// \brief Rates measured for a topic
+  struct TopicRates
+  {
+    /// \brief Messages per second
+    double rate;
+
+    /// \brief Bytes per second
+    double bandwidth;
+
+    /// \brief Mean size of the messages, in bytes
+    double size;
+  };
+
+  /// \brief Messages received on a metered topic, counted by its raw
+  /// subscription and shared with it, so callbacks in flight when it's
+  /// unsubscribed don't outlive it
+  struct TopicCounts
+  {
+    /// \brief Messages received since the last measurement
+    std::atomic<uint64_t> messages{0u};
+
+    /// \brief Bytes received since the last measurement
+    std::atomic<uint64_t> bytes{0u};
+
+    /// \brief Steady clock time of the first of those messages, in
+    /// nanoseconds
+    std::atomic<int64_t> first{0};
+
+    /// \brief Steady clock time of the last of those messages, in
+    /// nanoseconds
+    std::atomic<int64_t> last{0};
+  };
+
   /// \brief Model for the Topics and their Msgs and Fields
   /// a tree model that represents the topics tree with its Msgs
-  /// Childeren and each msg node has its own fileds/msgs childeren
-  class TopicsModel : public QStandardItemModel
+  /// Childeren and each msg node has its own fileds/msgs childeren.
+  /// The fields come from trees shared by all the topics of a message
+  /// type, and their items are created when their parent is expanded.
+  class TopicsModel : public QAbstractItemModel
   {
+    /// \brief Add a topic at the end of the tree.
+    /// \param[in] _topic topic name
+    /// \param[in] _type message type
+    /// \param[in] _tree fields of the message type, null if unknown
+    public: void AddTopic(const std::string &_topic, const std::string &_type,
+                          const std::shared_ptr<const MsgTree> &_tree);
+
+    /// \brief Remove a topic and its fields.
+    /// \param[in] _topic topic name
+    public: void RemoveTopic(const std::string &_topic);
+
+    /// \brief Set the rates measured for a topic, updating only its rate
+    /// roles.
+    /// \param[in] _topic topic name
+    /// \param[in] _rates rates
+    public: void SetRates(const std::string &_topic,
+                          const TopicRates &_rates);
+
+    /// \brief Forget the rates of all topics.
+    public: void ClearRates();
+
+    // Documentation inherited
+    public: QModelIndex index(int _row, int _column,
+                const QModelIndex &_parent = QModelIndex()) const override;
+
+    // Documentation inherited
+    public: QModelIndex parent(const QModelIndex &_index) const override;
+
+    // Documentation inherited
+    public: int rowCount(const QModelIndex &_parent = QModelIndex()) const
+                override;
+
+    // Documentation inherited
+    public: int columnCount(const QModelIndex &_parent = QModelIndex()) const
+                override;
+
+    // Documentation inherited
+    public: bool hasChildren(const QModelIndex &_parent = QModelIndex()) const
+                override;
+
+    // Documentation inherited
+    public: bool canFetchMore(const QModelIndex &_parent) const override;
+
+    // Documentation inherited
+    public: void fetchMore(const QModelIndex &_parent) override;
+
+    // Documentation inherited
+    public: QVariant data(const QModelIndex &_index, int _role) const
+                override;
+
     /// \brief roles and names of the model
     public: QHash<int, QByteArray> roleNames() const override
     {
@@ -65,24 +225,42 @@ namespace plugins
       roles[TOPIC_ROLE] = TOPIC_KEY;
       roles[PATH_ROLE] = PATH_KEY;
       roles[PLOT_ROLE] = PLOT_KEY;
+      roles[RATE_ROLE] = RATE_KEY;
+      roles[BANDWIDTH_ROLE] = BANDWIDTH_KEY;
+      roles[SIZE_ROLE] = SIZE_KEY;
       return roles;
     }
+
+    /// \brief get the index of a topic
+    /// \param[in] _topic topic name
+    /// \return the index, invalid if the topic isn't in the model
+    private: QModelIndex TopicIndex(const std::string &_topic) const;
+
+    /// \brief get the item of an index
+    /// \param[in] _index index, invalid for the root
+    /// \return the item
+    private: TopicItem *Item(const QModelIndex &_index) const;
+
+    /// \brief Root of the tree, whose children are the topics
+    private: TopicItem root{nullptr, 0, nullptr, "", "", "", nullptr, true,
+        {}};
+
+    /// \brief Rates of the topics measured so far, by topic name
+    private: std::map<std::string, TopicRates> rates;
   };
 
   class TopicViewerPrivate
   {
-    /// \brief Node for Commincation
-    public: ignition::transport::Node node;
-
     /// \brief Model to create it from the available topics and messages
     public: TopicsModel *model;
 
-    /// \brief Timer to update the model and keep track of its changes
-    public: QTimer *timer;
-
     /// \brief topic: msgType map to keep track of the model current topics
     public: std::map<std::string, std::string> currentTopics;
 
+    /// \brief Expanded message types, by full name. Null for types which
+    /// can't be created.
+    public: std::map<std::string, std::shared_ptr<const MsgTree>> trees;
+
     /// \brief Create the fields model
     public: void CreateModel();
 
@@ -92,46 +270,23 @@ namespace plugins
     public: void AddTopic(const std::string &_topic,
                          const std::string &_msg);
 
-    /// \brief add a field/msg child to that parent item
-    /// \param[in] _parentItem a parent for the added field/msg
-    /// \param[in] _msgName the displayed name of the field/msg
-    /// \param[in] _msgType field/msg type
-    public: void AddField(QStandardItem *_parentItem,
-                       const std::string &_msgName,
-                       const std::string &_msgType);
-
-    /// \brief factory method for creating an item
-    /// \param[in] _name the display name
-    /// \param[in] _type type of the field of the item
-    /// \param[in] _path a set of concatenate strings of parent msgs
-    /// names that lead to that field, starting from the most parent
-    /// ex : if we have [Collision]msg contains [pose]msg contains [position]
-    /// msg contains [x,y,z] fields, so the path of x = "pose-position-x"
-    /// \param[in] _topic the name of the most parent item
-    /// \return the created Item
-    public: QStandardItem *FactoryItem(const std::string &_name,
-                                      const std::string &_type,
-                                      const std::string &_path = "",
-                                      const std::string &_topic = "");
-
-    /// \brief set the topic role name of the item with the most
-    /// topic parent of that field item
-    /// \param[in] _item item ref to set its topic
-    public: void SetItemTopic(QStandardItem *_item);
-
-    /// \brief set the path/ID of the givin item starting from
-    /// the most topic parent to the field itself
-    /// \param[in] _item item ref to set its path
-    public: void SetItemPath(QStandardItem *_item);
-
-    /// \brief get the topic name of selected item
-    /// \param[in] _item ref to the item to get its parent topic
-    public: std::string TopicName(const QStandardItem *_item) const;
-
-    /// \brief full path starting from topic name till the msg name
-    /// \param[in] _index index of the QStanadardItem
-    /// \return string with all elements separated by '/'
-    public: std::string ItemPath(const QStandardItem *_item) const;
+    /// \brief remove a topic from the model
+    /// \param[in] _topic topic name
+    public: void RemoveTopic(const std::string &_topic);
+
+    /// \brief get the fields of a message type, expanding it on first use
+    /// \param[in] _msgType message type, such as "ignition.msgs.Pose"
+    /// \return the fields, null if the type is unknown
+    public: std::shared_ptr<const MsgTree> Tree(const std::string &_msgType);
+
+    /// \brief get the fields of a message type, expanding it on first use
+    /// \param[in] _descriptor descriptor of the message type
+    /// \param[in] _expanding types being expanded, which are shown as
+    /// leaves if they contain themselves
+    /// \return the fields
+    public: std::shared_ptr<const MsgTree> Tree(
+        const google::protobuf::Descriptor *_descriptor,
+        std::set<const google::protobuf::Descriptor *> &_expanding);
 
     /// \brief check if the type is supported in the plotting types
     /// \param[in] _type the msg type to check if it is supported
@@ -140,6 +295,40 @@ namespace plugins
 
     /// \brief supported types for plotting
     public: std::vector<google::protobuf::FieldDescriptor::Type> plotableTypes;
+
+    /// \brief Report the rates of the metered topics, then meter the next
+    /// ones in turn.
+    public: void Meter();
+
+    /// \brief Start counting the messages of a topic.
+    /// \param[in] _topic topic name
+    public: void StartMeter(const std::string &_topic);
+
+    /// \brief Stop counting the messages of all topics.
+    public: void StopMeters();
+
+    /// \brief Start or stop metering, as rates are shown and the plugin
+    /// is visible.
+    public: void UpdateMetering();
+
+    /// \brief Node with the raw subscriptions of the metered topics,
+    /// apart from the subscriptions of other plugins
+    public: transport::Node meterNode;
+
+    /// \brief Counts of the topics metered now, by topic name
+    public: std::map<std::string, std::shared_ptr<TopicCounts>> metered;
+
+    /// \brief Last topic given a turn, the next turn starts after it
+    public: std::string meterCursor;
+
+    /// \brief Ends each measurement window
+    public: QTimer meterTimer;
+
+    /// \brief True if rates are shown
+    public: bool showRates{false};
+
+    /// \brief True while the plugin isn't visible
+    public: bool suspended{false};
   };
 }
 }
@@ -149,6 +338,237 @@ using namespace ignition;
 using namespace gui;
 using namespace plugins;
 
+/// \brief Most topics metered at a time
+static const std::size_t kMeteredTopics = 8u;
+
+/// \brief Milliseconds each topic is metered before the next ones' turn
+static const int kMeterWindow = 2000;
+
+/// \brief Get the time of a message, for its counts.
+/// \return Steady clock time, in nanoseconds
+static int64_t MeterNow()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//////////////////////////////////////////////////
+void TopicsModel::AddTopic(const std::string &_topic,
+                           const std::string &_type,
+                           const std::shared_ptr<const MsgTree> &_tree)
+{
+  int row = static_cast<int>(this->root.children.size());
+  this->beginInsertRows(QModelIndex(), row, row);
+  this->root.children.emplace_back(new TopicItem{&this->root, row, nullptr,
+      _topic, _type, "", _tree, false, {}});
+  this->endInsertRows();
+}
+
+//////////////////////////////////////////////////
+void TopicsModel::RemoveTopic(const std::string &_topic)
+{
+  auto &topics = this->root.children;
+  auto it = std::find_if(topics.begin(), topics.end(),
+      [&_topic](const std::unique_ptr<TopicItem> &_item)
+      {
+        return _item->topic == _topic;
+      });
+  if (it == topics.end())
+    return;
+
+  int row = (*it)->row;
+  this->beginRemoveRows(QModelIndex(), row, row);
+  topics.erase(it);
+  for (auto i = static_cast<std::size_t>(row); i < topics.size(); ++i)
+    topics[i]->row = static_cast<int>(i);
+  this->rates.erase(_topic);
+  this->endRemoveRows();
+}
+
+//////////////////////////////////////////////////
+QModelIndex TopicsModel::TopicIndex(const std::string &_topic) const
+{
+  const auto &topics = this->root.children;
+  auto it = std::find_if(topics.begin(), topics.end(),
+      [&_topic](const std::unique_ptr<TopicItem> &_item)
+      {
+        return _item->topic == _topic;
+      });
+  if (it == topics.end())
+    return QModelIndex();
+  return this->createIndex((*it)->row, 0, it->get());
+}
+
+//////////////////////////////////////////////////
+void TopicsModel::SetRates(const std::string &_topic,
+                           const TopicRates &_rates)
+{
+  auto index = this->TopicIndex(_topic);
+  if (!index.isValid())
+    return;
+
+  this->rates[_topic] = _rates;
+  emit this->dataChanged(index, index,
+      {RATE_ROLE, BANDWIDTH_ROLE, SIZE_ROLE});
+}
+
+//////////////////////////////////////////////////
+void TopicsModel::ClearRates()
+{
+  auto rated = std::move(this->rates);
+  this->rates.clear();
+  for (const auto &topic : rated)
+  {
+    auto index = this->TopicIndex(topic.first);
+    if (index.isValid())
+    {
+      emit this->dataChanged(index, index,
+          {RATE_ROLE, BANDWIDTH_ROLE, SIZE_ROLE});
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+TopicItem *TopicsModel::Item(const QModelIndex &_index) const
+{
+  if (!_index.isValid())
+    return const_cast<TopicItem *>(&this->root);
+  return static_cast<TopicItem *>(_index.internalPointer());
+}
+
+//////////////////////////////////////////////////
+QModelIndex TopicsModel::index(int _row, int _column,
+                               const QModelIndex &_parent) const
+{
+  auto parent = this->Item(_parent);
+  if (_column != 0 || _row < 0 ||
+      _row >= static_cast<int>(parent->children.size()))
+  {
+    return QModelIndex();
+  }
+  return this->createIndex(_row, 0, parent->children[_row].get());
+}
+
+//////////////////////////////////////////////////
+QModelIndex TopicsModel::parent(const QModelIndex &_index) const
+{
+  if (!_index.isValid())
+    return QModelIndex();
+
+  auto parent = this->Item(_index)->parent;
+  if (parent == &this->root)
+    return QModelIndex();
+  return this->createIndex(parent->row, 0, parent);
+}
+
+//////////////////////////////////////////////////
+int TopicsModel::rowCount(const QModelIndex &_parent) const
+{
+  if (_parent.column() > 0)
+    return 0;
+  return static_cast<int>(this->Item(_parent)->children.size());
+}
+
+//////////////////////////////////////////////////
+int TopicsModel::columnCount(const QModelIndex &) const
+{
+  return 1;
+}
+
+//////////////////////////////////////////////////
+bool TopicsModel::hasChildren(const QModelIndex &_parent) const
+{
+  auto item = this->Item(_parent);
+  if (item->fetched)
+    return !item->children.empty();
+  return item->msg && !item->msg->fields.empty();
+}
+
+//////////////////////////////////////////////////
+bool TopicsModel::canFetchMore(const QModelIndex &_parent) const
+{
+  auto item = this->Item(_parent);
+  return !item->fetched && item->msg && !item->msg->fields.empty();
+}
+
+//////////////////////////////////////////////////
+void TopicsModel::fetchMore(const QModelIndex &_parent)
+{
+  if (!this->canFetchMore(_parent))
+    return;
+
+  auto item = this->Item(_parent);
+  const auto &fields = item->msg->fields;
+
+  this->beginInsertRows(_parent, 0, static_cast<int>(fields.size()) - 1);
+  for (const auto &field : fields)
+  {
+    auto path = item->path.empty() ? field.name :
+        item->path + "-" + field.name;
+    int row = static_cast<int>(item->children.size());
+    item->children.emplace_back(new TopicItem{item, row, &field, "", "",
+        path, field.msg, false, {}});
+  }
+  item->fetched = true;
+  this->endInsertRows();
+}
+
+//////////////////////////////////////////////////
+QVariant TopicsModel::data(const QModelIndex &_index, int _role) const
+{
+  if (!_index.isValid())
+    return QVariant();
+
+  auto item = this->Item(_index);
+
+  // only the fields that can't be expanded have a path and topic
+  bool leaf = item->field && !item->field->msg;
+
+  switch (_role)
+  {
+    case Qt::DisplayRole:
+    case NAME_ROLE:
+      return QString::fromStdString(
+          item->field ? item->field->name : item->topic);
+    case TYPE_ROLE:
+      return QString::fromStdString(
+          item->field ? item->field->type : item->type);
+    case PATH_ROLE:
+      return QString::fromStdString(leaf ? item->path : "");
+    case TOPIC_ROLE:
+    {
+      if (!leaf)
+        return QString();
+
+      auto topic = item;
+      while (topic->parent != &this->root)
+        topic = topic->parent;
+      return QString::fromStdString(topic->topic);
+    }
+    case PLOT_ROLE:
+      return item->field && item->field->plottable;
+    case RATE_ROLE:
+    case BANDWIDTH_ROLE:
+    case SIZE_ROLE:
+    {
+      // only topics are metered, and only once they had their turn
+      if (item->parent != &this->root)
+        return QVariant();
+
+      auto rated = this->rates.find(item->topic);
+      if (rated == this->rates.end())
+        return QVariant();
+      if (_role == RATE_ROLE)
+        return rated->second.rate;
+      if (_role == BANDWIDTH_ROLE)
+        return rated->second.bandwidth;
+      return rated->second.size;
+    }
+    default:
+      return QVariant();
+  }
+}
+
 TopicViewer::TopicViewer() : Plugin(), dataPtr(new TopicViewerPrivate)
 {
   using namespace google::protobuf;
@@ -160,32 +580,90 @@ TopicViewer::TopicViewer() : Plugin(), dataPtr(new TopicViewerPrivate)
   this->dataPtr->plotableTypes.push_back(FieldDescriptor::Type::TYPE_UINT64);
   this->dataPtr->plotableTypes.push_back(FieldDescriptor::Type::TYPE_BOOL);
 
+  // the registry tells when topics come and go, connected first so no
+  // change is missed while the model is created
+  connect(TopicRegistry::Instance(), SIGNAL(TopicsChanged()), this,
+          SLOT(UpdateModel()), Qt::QueuedConnection);
+
+  this->dataPtr->meterTimer.setInterval(kMeterWindow);
+  connect(&this->dataPtr->meterTimer, SIGNAL(timeout()), this,
+          SLOT(MeterTopics()));
+
   this->dataPtr->CreateModel();
 
   ignition::gui::App()->Engine()->rootContext()->setContextProperty(
                 "TopicsModel", this->dataPtr->model);
-
-  this->dataPtr->timer = new QTimer();
-  connect(this->dataPtr->timer, SIGNAL(timeout()), this, SLOT(UpdateModel()));
-  this->dataPtr->timer->start(1000);
 }
 
 //////////////////////////////////////////////////
 TopicViewer::~TopicViewer()
 {
+  this->dataPtr->StopMeters();
 }
 
 //////////////////////////////////////////////////
-void TopicViewer::LoadConfig(const tinyxml2::XMLElement *)
+void TopicViewer::LoadConfig(const tinyxml2::XMLElement *_pluginElem)
 {
   if (this->title.empty())
     this->title = "Topic Viewer";
+
+  if (_pluginElem)
+  {
+    if (auto ratesElem = _pluginElem->FirstChildElement("show_rates"))
+    {
+      bool showRates{false};
+      ratesElem->QueryBoolText(&showRates);
+      this->SetShowRates(showRates);
+    }
+  }
 }
 
 //////////////////////////////////////////////////
-QStandardItemModel *TopicViewer::Model()
+bool TopicViewer::ShowRates() const
 {
-  return reinterpret_cast<QStandardItemModel *>(this->dataPtr->model);
+  return this->dataPtr->showRates;
+}
+
+//////////////////////////////////////////////////
+void TopicViewer::SetShowRates(const bool _show)
+{
+  if (this->dataPtr->showRates == _show)
+    return;
+
+  this->dataPtr->showRates = _show;
+  this->dataPtr->UpdateMetering();
+
+  // rates measured earlier would be stale when shown again
+  if (!_show)
+    this->dataPtr->model->ClearRates();
+
+  emit this->ShowRatesChanged();
+}
+
+//////////////////////////////////////////////////
+void TopicViewer::MeterTopics()
+{
+  this->dataPtr->Meter();
+}
+
+//////////////////////////////////////////////////
+void TopicViewer::Suspend()
+{
+  this->dataPtr->suspended = true;
+  this->dataPtr->UpdateMetering();
+}
+
+//////////////////////////////////////////////////
+void TopicViewer::Resume()
+{
+  this->dataPtr->suspended = false;
+  this->dataPtr->UpdateMetering();
+}
+
+//////////////////////////////////////////////////
+QAbstractItemModel *TopicViewer::Model()
+{
+  return this->dataPtr->model;
 }
 
 //////////////////////////////////////////////////
@@ -193,171 +671,204 @@ void TopicViewerPrivate::CreateModel()
 {
   this->model = new TopicsModel();
 
-  std::vector<std::string> topics;
-  this->node.TopicList(topics);
-
-  for (unsigned int i = 0; i < topics.size(); ++i)
-  {
-    std::vector<ignition::transport::MessagePublisher> infoMsgs;
-    this->node.TopicInfo(topics[i], infoMsgs);
-    std::string msgType = infoMsgs[0].MsgTypeName();
-    this->AddTopic(topics[i], msgType);
-  }
+  for (const auto &topic : TopicRegistry::Instance()->Topics())
+    this->AddTopic(topic.first, topic.second);
 }
 
 //////////////////////////////////////////////////
 void TopicViewerPrivate::AddTopic(const std::string &_topic,
                            const std::string &_msg)
 {
-  QStandardItem *topicItem = this->FactoryItem(_topic, _msg);
-  topicItem->setWhatsThis("Topic");
-  QStandardItem *parent = this->model->invisibleRootItem();
-  parent->appendRow(topicItem);
-
-  this->AddField(topicItem , _msg, _msg);
+  this->model->AddTopic(_topic, _msg, this->Tree(_msg));
 
   // store the topics to keep track of them
   this->currentTopics[_topic] = _msg;
 }
 
 //////////////////////////////////////////////////
-void TopicViewerPrivate::AddField(QStandardItem *_parentItem,
-                           const std::string &_msgName,
-                           const std::string &_msgType)
+void TopicViewerPrivate::RemoveTopic(const std::string &_topic)
 {
-  QStandardItem *msgItem;
+  if (this->metered.erase(_topic) > 0u)
+    this->meterNode.Unsubscribe(_topic);
 
-  // check if it is a topic, to skip the extra level of the topic Msg
-  if (_parentItem->whatsThis() == "Topic")
-  {
-    msgItem = _parentItem;
-    // make it different, so next iteration will make a new msg item
-    msgItem->setWhatsThis("Msg");
-  }
-  else
-  {
-    msgItem = this->FactoryItem(_msgName, _msgType);
-    _parentItem->appendRow(msgItem);
-  }
+  this->model->RemoveTopic(_topic);
+  this->currentTopics.erase(_topic);
+}
 
-  auto msg = ignition::msgs::Factory::New(_msgType);
-  if (!msg)
-  {
-      ignwarn << "Null Msg: " << _msgType << std::endl;
-      return;
-  }
+//////////////////////////////////////////////////
+void TopicViewerPrivate::UpdateMetering()
+{
+  bool metering = this->showRates && !this->suspended;
+  if (metering == this->meterTimer.isActive())
+    return;
 
-  auto msgDescriptor = msg->GetDescriptor();
-  if (!msgDescriptor)
+  if (metering)
   {
-    ignwarn << "Null Descriptor of Msg: " << _msgType << std::endl;
-    return;
+    // the first topics get their turn right away
+    this->Meter();
+    this->meterTimer.start();
   }
-
-  for (int i = 0 ; i < msgDescriptor->field_count(); ++i)
+  else
   {
-    auto msgField = msgDescriptor->field(i);
-
-    if (msgField->is_repeated())
-      continue;
-
-    auto messageType = msgField->message_type();
-
-    if (messageType)
-      this->AddField(msgItem, msgField->name(), messageType->name());
-
-    else
-    {
-      auto msgFieldItem = this->FactoryItem(msgField->name(),
-                                            msgField->type_name());
-      msgItem->appendRow(msgFieldItem);
-
-      this->SetItemPath(msgFieldItem);
-      this->SetItemTopic(msgFieldItem);
-
-      // to make the plottable items draggable
-      if (this->IsPlotable(msgField->type()))
-        msgFieldItem->setData(QVariant(true), PLOT_ROLE);
-    }
+    this->meterTimer.stop();
+    this->StopMeters();
   }
 }
 
 //////////////////////////////////////////////////
-QStandardItem *TopicViewerPrivate::FactoryItem(const std::string &_name,
-                                               const std::string &_type,
-                                               const std::string &_path,
-                                               const std::string &_topic)
+void TopicViewerPrivate::StartMeter(const std::string &_topic)
 {
-  QString name = QString::fromStdString(_name);
-  QString type = QString::fromStdString(_type);
-  QString path = QString::fromStdString(_path);
-  QString topic = QString::fromStdString(_topic);
-
-  QStandardItem *item = new QStandardItem(name);
-
-  item->setData(QVariant(name), NAME_ROLE);
-  item->setData(QVariant(type), TYPE_ROLE);
-  item->setData(QVariant(path), PATH_ROLE);
-  item->setData(QVariant(topic), TOPIC_ROLE);
-  item->setData(QVariant(false), PLOT_ROLE);
+  auto counts = std::make_shared<TopicCounts>();
 
-  return item;
+  // the bytes are only counted, never parsed
+  auto cb = [counts](const char *, const std::size_t _size,
+      const transport::MessageInfo &)
+  {
+    auto now = MeterNow();
+    if (counts->messages.fetch_add(1u) == 0u)
+      counts->first = now;
+    counts->last = now;
+    counts->bytes += _size;
+  };
+  if (!this->meterNode.SubscribeRaw(_topic, cb))
+  {
+    ignwarn << "Unable to measure the rate of topic [" << _topic << "]"
+            << std::endl;
+    return;
+  }
+  this->metered[_topic] = counts;
 }
 
 //////////////////////////////////////////////////
-void TopicViewerPrivate::SetItemTopic(QStandardItem *_item)
+void TopicViewerPrivate::StopMeters()
 {
-  std::string topic = this->TopicName(_item);
-  QVariant Topic(QString::fromStdString(topic));
-  _item->setData(Topic, TOPIC_ROLE);
+  for (const auto &topic : this->metered)
+    this->meterNode.Unsubscribe(topic.first);
+  this->metered.clear();
 }
 
 //////////////////////////////////////////////////
-void TopicViewerPrivate::SetItemPath(QStandardItem *_item)
+void TopicViewerPrivate::Meter()
 {
-  std::string path = this->ItemPath(_item);
-  QVariant Path(QString::fromStdString(path));
-  _item->setData(Path, PATH_ROLE);
+  // rates are measured between the first and last messages of the window,
+  // so the time taken to connect to the publishers doesn't count
+  for (const auto &topic : this->metered)
+  {
+    auto &counts = *topic.second;
+    auto messages = counts.messages.exchange(0u);
+    auto bytes = counts.bytes.exchange(0u);
+    auto span = static_cast<double>(counts.last - counts.first) * 1e-9;
+
+    TopicRates rates{0.0, 0.0, 0.0};
+    if (messages > 0u)
+      rates.size = static_cast<double>(bytes) / messages;
+    if (messages > 1u && span > 0.0)
+    {
+      rates.rate = (messages - 1u) / span;
+      rates.bandwidth = rates.rate * rates.size;
+    }
+    this->model->SetRates(topic.first, rates);
+  }
+
+  // the next topics after the last ones metered, by name, so turns go
+  // round even as topics come and go
+  std::set<std::string> next;
+  auto topicIt = this->currentTopics.upper_bound(this->meterCursor);
+  while (next.size() < std::min(kMeteredTopics, this->currentTopics.size()))
+  {
+    if (topicIt == this->currentTopics.end())
+      topicIt = this->currentTopics.begin();
+    next.insert(topicIt->first);
+    this->meterCursor = topicIt->first;
+    ++topicIt;
+  }
+
+  // topics keeping their turn, when there are few, stay subscribed
+  for (auto it = this->metered.begin(); it != this->metered.end();)
+  {
+    if (next.count(it->first) == 0u)
+    {
+      this->meterNode.Unsubscribe(it->first);
+      it = this->metered.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+
+  for (const auto &topic : next)
+  {
+    if (this->metered.count(topic) == 0u)
+      this->StartMeter(topic);
+  }
 }
 
 //////////////////////////////////////////////////
-std::string TopicViewerPrivate::TopicName(const QStandardItem *_item) const
+std::shared_ptr<const MsgTree> TopicViewerPrivate::Tree(
+    const std::string &_msgType)
 {
-  QStandardItem *parent = _item->parent();
+  auto cached = this->trees.find(_msgType);
+  if (cached != this->trees.end())
+    return cached->second;
 
-  // get the next parent until you reach the first level parent
-  while (parent)
+  // nested types come from the descriptors of the topics' types
+  auto schema = MsgSchema::Find(_msgType);
+  if (!schema)
   {
-    _item = parent;
-    parent = parent->parent();
+    ignwarn << "Null Msg: " << _msgType << std::endl;
+    this->trees[_msgType] = nullptr;
+    return nullptr;
   }
 
-  return _item->data(NAME_ROLE).toString().toStdString();
+  std::set<const google::protobuf::Descriptor *> expanding;
+  auto tree = this->Tree(schema->Descriptor(), expanding);
+  this->trees[_msgType] = tree;
+  return tree;
 }
 
 //////////////////////////////////////////////////
-std::string TopicViewerPrivate::ItemPath(const QStandardItem *_item) const
+std::shared_ptr<const MsgTree> TopicViewerPrivate::Tree(
+    const google::protobuf::Descriptor *_descriptor,
+    std::set<const google::protobuf::Descriptor *> &_expanding)
 {
-  std::deque<std::string> path;
-  while (_item)
+  auto cached = this->trees.find(_descriptor->full_name());
+  if (cached != this->trees.end() && cached->second)
+    return cached->second;
+
+  _expanding.insert(_descriptor);
+
+  auto tree = std::make_shared<MsgTree>();
+  for (int i = 0 ; i < _descriptor->field_count(); ++i)
   {
-    path.push_front(_item->data(NAME_ROLE).toString().toStdString());
-    _item = _item->parent();
-  }
+    auto msgField = _descriptor->field(i);
 
-  if (path.size())
-    path.erase(path.begin());
+    if (msgField->is_repeated())
+      continue;
 
-  // convert to string
-  std::string pathString;
+    FieldTree field;
+    field.name = msgField->name();
 
-  for (unsigned int i = 0; i < path.size()-1; ++i)
-    pathString += path[i] + "-";
+    auto messageType = msgField->message_type();
+    if (messageType)
+    {
+      field.type = messageType->name();
+      field.plottable = false;
+      if (!_expanding.count(messageType))
+        field.msg = this->Tree(messageType, _expanding);
+    }
+    else
+    {
+      field.type = msgField->type_name();
+      field.plottable = this->IsPlotable(msgField->type());
+    }
+    tree->fields.push_back(field);
+  }
 
-  if (path.size())
-    pathString += path[path.size()-1];
+  _expanding.erase(_descriptor);
 
-  return pathString;
+  this->trees[_descriptor->full_name()] = tree;
+  return tree;
 }
 
 /////////////////////////////////////////////////
@@ -371,55 +882,48 @@ bool TopicViewerPrivate::IsPlotable(
 /////////////////////////////////////////////////
 void TopicViewer::UpdateModel()
 {
-  // get the current topics in the network
-  std::vector<std::string> topics;
-  this->dataPtr->node.TopicList(topics);
-
-  // initialize the topics with the old topics & remove every matched topic
-  // when you finish advertised topics the remaining topics will be removed
-  std::map<std::string, std::string> topicsToRemove =
-          this->dataPtr->currentTopics;
-
-  for (unsigned int i = 0; i < topics.size(); ++i)
+  // the registry already knows the topics, only the model changes are left
+  auto topics = TopicRegistry::Instance()->Topics();
+
+  // both maps are sorted, so they're compared in one pass
+  std::vector<std::string> removed;
+  std::vector<std::pair<std::string, std::string>> added;
+  auto current = this->dataPtr->currentTopics.begin();
+  auto next = topics.begin();
+  while (current != this->dataPtr->currentTopics.end() ||
+         next != topics.end())
   {
-    // get the msg type
-    std::vector<ignition::transport::MessagePublisher> infoMsgs;
-    this->dataPtr->node.TopicInfo(topics[i], infoMsgs);
-    std::string msgType = infoMsgs[0].MsgTypeName();
-
-    // skip the matched topics
-    if (this->dataPtr->currentTopics.count(topics[i]) &&
-            this->dataPtr->currentTopics[topics[i]] == msgType)
+    if (next == topics.end() ||
+        (current != this->dataPtr->currentTopics.end() &&
+         current->first < next->first))
     {
-      topicsToRemove.erase(topics[i]);
-      continue;
+      removed.push_back(current->first);
+      ++current;
     }
-
-    // new topic
-    this->dataPtr->AddTopic(topics[i], msgType);
-  }
-
-  // remove the topics that don't exist in the network
-  for (auto topic : topicsToRemove)
-  {
-    auto root = this->dataPtr->model->invisibleRootItem();
-
-    // search for the topic in the model
-    for (int i = 0; i < root->rowCount(); ++i)
+    else if (current == this->dataPtr->currentTopics.end() ||
+             next->first < current->first)
     {
-      auto child = root->child(i);
-
-      if (child->data(NAME_ROLE).toString().toStdString() == topic.first &&
-              child->data(TYPE_ROLE).toString().toStdString() == topic.second)
+      added.push_back(*next);
+      ++next;
+    }
+    else
+    {
+      // a topic whose type changed is added again
+      if (current->second != next->second)
       {
-        // remove from model
-        root->removeRow(i);
-        // remove from topics as it is a dangling topic
-        this->dataPtr->currentTopics.erase(topic.first);
-        break;
+        removed.push_back(current->first);
+        added.push_back(*next);
       }
+      ++current;
+      ++next;
     }
   }
+
+  for (const auto &topic : removed)
+    this->dataPtr->RemoveTopic(topic);
+
+  for (const auto &topic : added)
+    this->dataPtr->AddTopic(topic.first, topic.second);
 }
 
 
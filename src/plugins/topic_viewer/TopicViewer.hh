@@ -39,10 +39,28 @@ namespace plugins
 
   /// \brief a Plugin to view the topics and their msgs & fields
   /// Field's informations can be passed by dragging them via the UI
+  ///
+  /// With rates shown, the message rate, bandwidth and message size of
+  /// the topics are measured by counting the bytes they carry, without
+  /// parsing them. Only a few topics are measured at a time, in turns, so
+  /// the cost doesn't grow with the number of topics.
+  ///
+  /// ## Configuration
+  ///
+  /// * \<show_rates\> : True to measure the rates of the topics, defaults
+  /// to false.
   class TopicViewer_EXPORTS_API TopicViewer : public Plugin
   {
     Q_OBJECT
 
+    /// \brief True if the rates of the topics are measured and shown
+    Q_PROPERTY(
+      bool showRates
+      READ ShowRates
+      WRITE SetShowRates
+      NOTIFY ShowRatesChanged
+    )
+
     /// \brief Constructor
     public: TopicViewer();
 
@@ -52,13 +70,36 @@ namespace plugins
     /// \brief Documentaation inherited
     public: void LoadConfig(const tinyxml2::XMLElement *) override;
 
-    /// \brief Get the model of msgs & fields
+    /// \brief Get the model of msgs & fields. The fields of a msg are
+    /// only in the model once fetched, see QAbstractItemModel::fetchMore.
     /// \return Pointer to the model of msgs & fields
-    public: QStandardItemModel *Model();
+    public: QAbstractItemModel *Model();
 
     /// \brief update the model according to the changes of the topics
     public slots: void UpdateModel();
 
+    /// \brief Get whether the rates of the topics are measured and shown.
+    /// \return True if they are
+    public: Q_INVOKABLE bool ShowRates() const;
+
+    /// \brief Start or stop measuring the rates of the topics. Rates
+    /// measured so far are cleared when stopping.
+    /// \param[in] _show True to measure them
+    public: Q_INVOKABLE void SetShowRates(const bool _show);
+
+    /// \brief Notify that the rates were shown or hidden
+    signals: void ShowRatesChanged();
+
+    /// \brief Measure the rates of the topics in turn, called once per
+    /// measurement window.
+    private slots: void MeterTopics();
+
+    // Documentation inherited
+    protected: void Suspend() override;
+
+    // Documentation inherited
+    protected: void Resume() override;
+
     /// \brief Pointer to private data.
     private: std:: unique_ptr<TopicViewerPrivate> dataPtr;
   };
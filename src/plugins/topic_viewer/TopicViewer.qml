@@ -44,6 +44,31 @@ TreeView {
 
     property color highlightColor: Material.accentColor;
 
+    // =========== Rates ===========
+    function formatBytes(_bytes)
+    {
+        if (_bytes < 1024)
+            return _bytes.toFixed(0) + " B";
+        if (_bytes < 1024 * 1024)
+            return (_bytes / 1024).toFixed(1) + " KB";
+        return (_bytes / (1024 * 1024)).toFixed(1) + " MB";
+    }
+
+    function formatRates(_rate, _bandwidth, _size)
+    {
+        return _rate.toFixed(1) + " Hz  " + formatBytes(_bandwidth) + "/s  " +
+               formatBytes(_size);
+    }
+
+    Menu {
+        id: ratesMenu
+        MenuItem {
+            text: "Show rates"
+            checkable: true
+            checked: TopicViewer.showRates
+            onTriggered: TopicViewer.showRates = checked
+        }
+    }
 
     verticalScrollBarPolicy: Qt.ScrollBarAsNeeded
     horizontalScrollBarPolicy: Qt.ScrollBarAlwaysOff
@@ -103,6 +128,7 @@ TreeView {
         MouseArea {
             id: dragMouse
             anchors.fill: parent
+            acceptedButtons: Qt.LeftButton | Qt.RightButton
 
             // only plottable items are dragable
             drag.target: (model === null) ? null :
@@ -126,6 +152,15 @@ TreeView {
                                                 Qt.DragCopyCursor : Qt.ArrowCursor
 
             onClicked: {
+                if (mouse.button === Qt.RightButton)
+                {
+                    var pos = mapToItem(tree, mouse.x, mouse.y);
+                    ratesMenu.x = pos.x;
+                    ratesMenu.y = pos.y;
+                    ratesMenu.open();
+                    return;
+                }
+
                 // change the selection of the tree by clearing the prev, select a new one
                 tree.selection.select(styleData.index,ItemSelectionModel.ClearAndSelect)
 
@@ -164,11 +199,26 @@ TreeView {
             font.pointSize: 12
             anchors.leftMargin: 5
             anchors.left: icon.right
-            anchors.right: parent.right
+            anchors.right: rates.left
             elide: Text.ElideMiddle
             y: icon.y
         }
 
+        // measured in turns, so topics have no rates until their first turn
+        Text {
+            id: rates
+            visible: TopicViewer.showRates && model !== null &&
+                     model.rate !== undefined
+            text: visible ?
+                  formatRates(model.rate, model.bandwidth, model.size) : ""
+            width: visible ? implicitWidth : 0
+            color: field.color
+            font.pointSize: 10
+            anchors.right: parent.right
+            anchors.rightMargin: 5
+            anchors.verticalCenter: field.verticalCenter
+        }
+
         ToolTip {
             id: tool_tip
             delay: 200
@@ -16,7 +16,12 @@
 */
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+
 #include <ignition/common/Console.hh>
+#include <ignition/msgs/stringmsg.pb.h>
 #include <ignition/transport/Node.hh>
 #include <ignition/utilities/ExtraTestMacros.hh>
 
@@ -31,6 +36,9 @@
 #define TOPIC_ROLE 53
 #define PATH_ROLE 54
 #define PLOT_ROLE 55
+#define RATE_ROLE 56
+#define BANDWIDTH_ROLE 57
+#define SIZE_ROLE 58
 
 
 int g_argc = 1;
@@ -123,52 +131,68 @@ TEST(TopicViewerTest, IGN_UTILS_TEST_ENABLED_ONLY_ON_LINUX(Model))
     auto model = plugin->Model();
     ASSERT_NE(model, nullptr);
 
-    auto root = model->invisibleRootItem();
-    ASSERT_NE(model, nullptr);
+    // fields are only in the model once their parent is expanded
+    auto child = [&model](const QModelIndex &_parent, int _row)
+    {
+      if (model->canFetchMore(_parent))
+        model->fetchMore(_parent);
+      return model->index(_row, 0, _parent);
+    };
 
-    ASSERT_EQ(root->hasChildren(), true);
+    QModelIndex root;
+    ASSERT_EQ(model->hasChildren(root), true);
 
     bool foundCollision = false;
     bool foundInt = false;
 
-    EXPECT_GE(root->rowCount(), 2);
+    EXPECT_GE(model->rowCount(root), 2);
 
     // check plotable items
-    for (int i = 0; i < root->rowCount(); ++i)
+    for (int i = 0; i < model->rowCount(root); ++i)
     {
-        auto child = root->child(i);
+        auto topic = model->index(i, 0, root);
 
-        if (child->data(NAME_ROLE) == "/collision_topic")
+        if (model->data(topic, NAME_ROLE) == "/collision_topic")
         {
             foundCollision = true;
 
-            EXPECT_EQ(child->data(TYPE_ROLE), "ignition.msgs.Collision");
-            EXPECT_EQ(child->rowCount(), 8);
+            EXPECT_EQ(model->data(topic, TYPE_ROLE),
+                "ignition.msgs.Collision");
+            EXPECT_TRUE(model->hasChildren(topic));
+            EXPECT_EQ(model->rowCount(topic), 0);
+            EXPECT_TRUE(model->canFetchMore(topic));
 
-            auto pose = child->child(5);
-            auto position = pose->child(3);
-            auto x = position->child(1);
+            auto pose = child(topic, 5);
+            EXPECT_EQ(model->rowCount(topic), 8);
+            EXPECT_FALSE(model->canFetchMore(topic));
 
-            EXPECT_EQ(x->data(NAME_ROLE), "x");
-            EXPECT_EQ(x->data(TYPE_ROLE), "double");
-            EXPECT_EQ(x->data(PATH_ROLE), "pose-position-x");
-            EXPECT_EQ(x->data(TOPIC_ROLE), "/collision_topic");
-            EXPECT_TRUE(x->data(PLOT_ROLE).toBool());
+            auto position = child(pose, 3);
+            auto x = child(position, 1);
+
+            EXPECT_EQ(model->data(x, NAME_ROLE), "x");
+            EXPECT_EQ(model->data(x, TYPE_ROLE), "double");
+            EXPECT_EQ(model->data(x, PATH_ROLE), "pose-position-x");
+            EXPECT_EQ(model->data(x, TOPIC_ROLE), "/collision_topic");
+            EXPECT_TRUE(model->data(x, PLOT_ROLE).toBool());
+            EXPECT_FALSE(model->hasChildren(x));
+
+            EXPECT_EQ(model->parent(x), position);
+            EXPECT_EQ(model->parent(pose), topic);
         }
-        else if (child->data(NAME_ROLE) == "/int_topic")
+        else if (model->data(topic, NAME_ROLE) == "/int_topic")
         {
             foundInt = true;
 
-            EXPECT_EQ(child->data(TYPE_ROLE), "ignition.msgs.Int32");
-            EXPECT_EQ(child->rowCount(), 2);
+            EXPECT_EQ(model->data(topic, TYPE_ROLE), "ignition.msgs.Int32");
 
-            auto data = child->child(1);
+            auto data = child(topic, 1);
+            EXPECT_EQ(model->rowCount(topic), 2);
 
-            EXPECT_EQ(data->data(NAME_ROLE), "data");
-            EXPECT_EQ(data->data(TYPE_ROLE), "int32");
-            EXPECT_EQ(data->data(PATH_ROLE), "data");
-            EXPECT_EQ(data->data(TOPIC_ROLE), "/int_topic");
-            EXPECT_TRUE(data->data(PLOT_ROLE).toBool());
+            EXPECT_EQ(model->data(data, NAME_ROLE), "data");
+            EXPECT_EQ(model->data(data, TYPE_ROLE), "int32");
+            EXPECT_EQ(model->data(data, PATH_ROLE), "data");
+            EXPECT_EQ(model->data(data, TOPIC_ROLE), "/int_topic");
+            EXPECT_TRUE(model->data(data, PLOT_ROLE).toBool());
         }
         else
         {
@@ -192,7 +216,102 @@ TEST(TopicViewerTest, IGN_UTILS_TEST_ENABLED_ONLY_ON_LINUX(Model))
     // wait for update timeout
     std::this_thread::sleep_for(std::chrono::milliseconds(700));
 
-    root = plugin->Model()->invisibleRootItem();
+    EXPECT_EQ(plugin->Model()->rowCount(), 2);
+}
+
+/////////////////////////////////////////////////
+TEST(TopicViewerTest, IGN_UTILS_TEST_ENABLED_ONLY_ON_LINUX(Rates))
+{
+    setenv("IGN_PARTITION", "ign-gui-topic-rates-test", 1);
+
+    transport::Node node;
+    auto pub = node.Advertise<msgs::StringMsg>("/rate_topic");
+    msgs::StringMsg msg;
+    msg.set_data(std::string(100, 'a'));
+
+    // about 50 Hz
+    std::atomic<bool> publishing{true};
+    std::thread publisher([&]()
+    {
+      while (publishing)
+      {
+        pub.Publish(msg);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      }
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+    common::Console::SetVerbosity(4);
 
-    EXPECT_EQ(root->rowCount(), 2);
+    Application app(g_argc, g_argv);
+    app.AddPluginPath(std::string(PROJECT_BINARY_PATH) + "/lib");
+
+    const char *pluginStr =
+      "<plugin filename=\"TopicViewer\">"
+        "<show_rates>true</show_rates>"
+      "</plugin>";
+
+    tinyxml2::XMLDocument pluginDoc;
+    EXPECT_EQ(tinyxml2::XML_SUCCESS, pluginDoc.Parse(pluginStr));
+    EXPECT_TRUE(app.LoadPlugin("TopicViewer",
+        pluginDoc.FirstChildElement("plugin")));
+
+    auto win = app.findChild<MainWindow *>();
+    ASSERT_NE(nullptr, win);
+    auto plugins = win->findChildren<plugins::TopicViewer *>();
+    ASSERT_EQ(plugins.size(), 1);
+    auto plugin = plugins[0];
+    EXPECT_TRUE(plugin->ShowRates());
+
+    auto model = plugin->Model();
+    QModelIndex topic;
+    for (int i = 0; i < model->rowCount(); ++i)
+    {
+      if (model->data(model->index(i, 0), NAME_ROLE) == "/rate_topic")
+        topic = model->index(i, 0);
+    }
+    ASSERT_TRUE(topic.isValid());
+
+    // nothing until the topic had its turn
+    EXPECT_FALSE(model->data(topic, RATE_ROLE).isValid());
+
+    int changes{0};
+    QObject::connect(model, &QAbstractItemModel::dataChanged,
+        [&](const QModelIndex &_first, const QModelIndex &,
+            const QVector<int> &_roles)
+        {
+          if (_first == topic && _roles.contains(RATE_ROLE))
+            ++changes;
+        });
+
+    auto start = std::chrono::steady_clock::now();
+    while (changes == 0 &&
+        std::chrono::steady_clock::now() - start < std::chrono::seconds(5))
+    {
+      QCoreApplication::processEvents();
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(1, changes);
+
+    auto rate = model->data(topic, RATE_ROLE).toDouble();
+    EXPECT_GT(rate, 30.0);
+    EXPECT_LT(rate, 60.0);
+    auto size = model->data(topic, SIZE_ROLE).toDouble();
+    EXPECT_GE(size, 100.0);
+    EXPECT_LT(size, 120.0);
+    EXPECT_NEAR(rate * size, model->data(topic, BANDWIDTH_ROLE).toDouble(),
+        1e-6);
+
+    // fields aren't metered
+    if (model->canFetchMore(topic))
+      model->fetchMore(topic);
+    EXPECT_FALSE(model->data(model->index(0, 0, topic), RATE_ROLE).isValid());
+
+    // cleared when hidden
+    plugin->SetShowRates(false);
+    EXPECT_FALSE(plugin->ShowRates());
+    EXPECT_FALSE(model->data(topic, RATE_ROLE).isValid());
+
+    publishing = false;
+    publisher.join();
 }
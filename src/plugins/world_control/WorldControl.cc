@@ -17,6 +17,11 @@
 
 #include "WorldControl.hh"
 
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <string>
 
 #include <ignition/common/Console.hh>
@@ -25,6 +30,7 @@
 #include <ignition/plugin/Register.hh>
 
 #include "ignition/gui/Helpers.hh"
+#include "ignition/gui/SubscriptionHub.hh"
 
 namespace ignition
 {
@@ -32,25 +38,72 @@ namespace gui
 {
 namespace plugins
 {
+  /// \brief Control requests waiting for, or being sent to, the service.
+  /// Shared with reply callbacks, which may come after the plugin is gone.
+  struct ControlPipeline
+  {
+    /// \brief Plugin to notify, null once it's destroyed
+    WorldControl *plugin{nullptr};
+
+    /// \brief Requests waiting for the one in flight to be replied
+    std::deque<msgs::WorldControl> queue;
+
+    /// \brief Whether a request is waiting for its reply
+    bool inFlight{false};
+
+    /// \brief Number of the request in flight, to ignore late replies to
+    /// requests given up on
+    std::uint64_t seq{0};
+
+    /// \brief When the request in flight was sent
+    std::chrono::steady_clock::time_point sent;
+
+    /// \brief Round trip time of the latest request, in milliseconds
+    double latency{-1.0};
+
+    /// \brief Protects the members above
+    std::mutex mutex;
+  };
+
   class WorldControlPrivate
   {
-    /// \brief Message holding latest world statistics
+    /// \brief Queue a control request, merging it with the previous one if
+    /// possible, and send it if nothing is in flight.
+    /// \param[in] _req Request
+    public: void Enqueue(const msgs::WorldControl &_req);
+
+    /// \brief Send the next queued request, unless one is in flight.
+    public: void SendNext();
+
+    /// \brief Give up on the request in flight and send the next one.
+    public: void OnTimeout();
+
+    /// \brief Message holding latest world statistics, only used on the
+    /// GUI thread
     public: ignition::msgs::WorldStatistics msg;
 
     /// \brief Service to send world control requests
     public: std::string controlService;
 
-    /// \brief Mutex to protect msg
-    public: std::recursive_mutex mutex;
-
     /// \brief Communication node
     public: ignition::transport::Node node;
 
+    /// \brief Subscription to the stats topic, 0 if none
+    public: std::size_t subscription{0};
+
     /// \brief The multi step value
     public: unsigned int multiStep = 1u;
 
     /// \brief True for paused
     public: bool pause{true};
+
+    /// \brief Requests to the control service
+    public: std::shared_ptr<ControlPipeline> pipeline{
+        std::make_shared<ControlPipeline>()};
+
+    /// \brief Started when a request is sent, fires if it isn't replied
+    /// in time
+    public: QTimer timeoutTimer;
   };
 }
 }
@@ -60,15 +113,147 @@ using namespace ignition;
 using namespace gui;
 using namespace plugins;
 
+/// \brief Time after which a request without reply is considered lost, so
+/// the following ones aren't held back forever
+static const std::chrono::seconds kRequestTimeout{2};
+
+/////////////////////////////////////////////////
+void WorldControlPrivate::Enqueue(const msgs::WorldControl &_req)
+{
+  {
+    std::lock_guard<std::mutex> lock(this->pipeline->mutex);
+    auto &queue = this->pipeline->queue;
+    if (!queue.empty())
+    {
+      auto &last = queue.back();
+
+      // Consecutive steps become a single multi step
+      if (_req.multi_step() > 0 && last.multi_step() > 0 &&
+          _req.pause() == last.pause())
+      {
+        last.set_multi_step(last.multi_step() + _req.multi_step());
+        return;
+      }
+
+      // Only the latest play or pause matters
+      if (_req.multi_step() == 0 && last.multi_step() == 0)
+      {
+        last = _req;
+        return;
+      }
+    }
+    queue.push_back(_req);
+  }
+
+  this->SendNext();
+}
+
+/////////////////////////////////////////////////
+void WorldControlPrivate::SendNext()
+{
+  msgs::WorldControl req;
+  std::uint64_t seq;
+  {
+    std::lock_guard<std::mutex> lock(this->pipeline->mutex);
+    if (this->pipeline->queue.empty() || this->pipeline->inFlight)
+      return;
+
+    req = this->pipeline->queue.front();
+    this->pipeline->queue.pop_front();
+    this->pipeline->inFlight = true;
+    this->pipeline->sent = std::chrono::steady_clock::now();
+    seq = ++this->pipeline->seq;
+  }
+  this->timeoutTimer.start();
+
+  // Replies may come from a transport thread, or right away from this one
+  // if the service is in this process, so the pipeline isn't locked here
+  std::weak_ptr<ControlPipeline> weakPipeline = this->pipeline;
+  auto isPlayPause = req.multi_step() == 0;
+  auto pause = req.pause();
+  std::function<void(const msgs::Boolean &, const bool)> cb =
+      [weakPipeline, seq, isPlayPause, pause](const msgs::Boolean &/*_rep*/,
+      const bool _result)
+  {
+    auto pipeline = weakPipeline.lock();
+    if (!pipeline)
+      return;
+
+    std::lock_guard<std::mutex> lock(pipeline->mutex);
+    if (seq != pipeline->seq)
+      return;
+
+    pipeline->inFlight = false;
+    pipeline->latency = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - pipeline->sent).count();
+
+    if (!pipeline->plugin)
+      return;
+
+    if (_result && isPlayPause)
+      QMetaObject::invokeMethod(pipeline->plugin, pause ? "paused" : "playing");
+    QMetaObject::invokeMethod(pipeline->plugin, "OnControlReply",
+        Qt::QueuedConnection);
+  };
+
+  if (!this->node.Request(this->controlService, req, cb))
+  {
+    ignerr << "Failed to request [" << this->controlService << "]"
+           << std::endl;
+    {
+      std::lock_guard<std::mutex> lock(this->pipeline->mutex);
+      if (seq != this->pipeline->seq)
+        return;
+      this->pipeline->inFlight = false;
+    }
+    this->timeoutTimer.stop();
+
+    // There won't be a reply to send the rest
+    this->SendNext();
+  }
+}
+
+/////////////////////////////////////////////////
+void WorldControlPrivate::OnTimeout()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->pipeline->mutex);
+    if (!this->pipeline->inFlight)
+      return;
+
+    // A late reply to it is ignored
+    this->pipeline->inFlight = false;
+    ++this->pipeline->seq;
+  }
+
+  ignwarn << "No reply from [" << this->controlService << "] within "
+          << kRequestTimeout.count() << " s, sending the next request"
+          << std::endl;
+  this->SendNext();
+}
+
 /////////////////////////////////////////////////
 WorldControl::WorldControl()
   : Plugin(), dataPtr(new WorldControlPrivate)
 {
+  this->dataPtr->pipeline->plugin = this;
+
+  this->dataPtr->timeoutTimer.setSingleShot(true);
+  this->dataPtr->timeoutTimer.setInterval(kRequestTimeout);
+  this->connect(&this->dataPtr->timeoutTimer, &QTimer::timeout, this,
+      [this]()
+      {
+        this->dataPtr->OnTimeout();
+      });
 }
 
 /////////////////////////////////////////////////
 WorldControl::~WorldControl()
 {
+  SubscriptionHub::Instance()->Unsubscribe(this->dataPtr->subscription);
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->pipeline->mutex);
+  this->dataPtr->pipeline->plugin = nullptr;
 }
 
 /////////////////////////////////////////////////
@@ -187,9 +372,11 @@ void WorldControl::LoadConfig(const tinyxml2::XMLElement *_pluginElem)
 
   if (!statsTopic.empty())
   {
-    // Subscribe to world_stats
-    if (!this->dataPtr->node.Subscribe(statsTopic,
-        &WorldControl::OnWorldStatsMsg, this))
+    // Subscribe to world_stats, shared with other plugins
+    this->dataPtr->subscription =
+        SubscriptionHub::Instance()->SubscribeLatest(statsTopic,
+        &WorldControl::OnWorldStatsMsg, this);
+    if (!this->dataPtr->subscription)
     {
       ignerr << "Failed to subscribe to [" << statsTopic << "]" << std::endl;
     }
@@ -203,8 +390,6 @@ void WorldControl::LoadConfig(const tinyxml2::XMLElement *_pluginElem)
 /////////////////////////////////////////////////
 void WorldControl::ProcessMsg()
 {
-  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->mutex);
-
   if (!this->dataPtr->pause && this->dataPtr->msg.paused())
     this->paused();
   else if (this->dataPtr->pause && !this->dataPtr->msg.paused())
@@ -215,42 +400,26 @@ void WorldControl::ProcessMsg()
 /////////////////////////////////////////////////
 void WorldControl::OnWorldStatsMsg(const ignition::msgs::WorldStatistics &_msg)
 {
-  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->mutex);
-
   this->dataPtr->msg.CopyFrom(_msg);
-  QMetaObject::invokeMethod(this, "ProcessMsg");
+  this->ProcessMsg();
 }
 
 /////////////////////////////////////////////////
 void WorldControl::OnPlay()
 {
-  std::function<void(const ignition::msgs::Boolean &, const bool)> cb =
-      [this](const ignition::msgs::Boolean &/*_rep*/, const bool _result)
-  {
-    if (_result)
-      QMetaObject::invokeMethod(this, "playing");
-  };
-
   ignition::msgs::WorldControl req;
   req.set_pause(false);
   this->dataPtr->pause = false;
-  this->dataPtr->node.Request(this->dataPtr->controlService, req, cb);
+  this->dataPtr->Enqueue(req);
 }
 
 /////////////////////////////////////////////////
 void WorldControl::OnPause()
 {
-  std::function<void(const ignition::msgs::Boolean &, const bool)> cb =
-      [this](const ignition::msgs::Boolean &/*_rep*/, const bool _result)
-  {
-    if (_result)
-      QMetaObject::invokeMethod(this, "paused");
-  };
-
   ignition::msgs::WorldControl req;
   req.set_pause(true);
   this->dataPtr->pause = true;
-  this->dataPtr->node.Request(this->dataPtr->controlService, req, cb);
+  this->dataPtr->Enqueue(req);
 }
 
 /////////////////////////////////////////////////
@@ -262,15 +431,24 @@ void WorldControl::OnStepCount(const unsigned int _steps)
 /////////////////////////////////////////////////
 void WorldControl::OnStep()
 {
-  std::function<void(const ignition::msgs::Boolean &, const bool)> cb =
-      [](const ignition::msgs::Boolean &/*_rep*/, const bool /*_result*/)
-  {
-  };
-
   ignition::msgs::WorldControl req;
   req.set_pause(this->dataPtr->pause);
   req.set_multi_step(this->dataPtr->multiStep);
-  this->dataPtr->node.Request(this->dataPtr->controlService, req, cb);
+  this->dataPtr->Enqueue(req);
+}
+
+/////////////////////////////////////////////////
+void WorldControl::OnControlReply()
+{
+  this->LatencyChanged();
+  this->dataPtr->SendNext();
+}
+
+/////////////////////////////////////////////////
+double WorldControl::Latency() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->pipeline->mutex);
+  return this->dataPtr->pipeline->latency;
 }
 
 // Register this plugin
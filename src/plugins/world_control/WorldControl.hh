@@ -63,10 +63,22 @@ namespace plugins
   /// * \<stats_topic\> : Topic to receive world statistics, optional. If not
   ///               present, the plugin will attempt to create a topic with the
   ///               main window's `worldName` property.
+  ///
+  /// Only one control request is in flight at a time. Requests made while
+  /// waiting for a reply are queued, consecutive steps being merged into a
+  /// single multi step request, and a later play or pause replacing an
+  /// earlier one.
   class WorldControl_EXPORTS_API WorldControl: public ignition::gui::Plugin
   {
     Q_OBJECT
 
+    /// \brief Round trip time of the latest control request
+    Q_PROPERTY(
+      double latency
+      READ Latency
+      NOTIFY LatencyChanged
+    )
+
     /// \brief Constructor
     public: WorldControl();
 
@@ -92,15 +104,28 @@ namespace plugins
     /// \param[in] _steps New number of steps.
     public slots: void OnStepCount(const unsigned int _steps);
 
+    /// \brief Get the round trip time of the latest control request.
+    /// \return Milliseconds, negative if no reply came yet.
+    public: Q_INVOKABLE double Latency() const;
+
+    /// \brief Notify that a reply came, with a new latency.
+    signals: void LatencyChanged();
+
     /// \brief Notify that it's now playing.
     signals: void playing();
 
     /// \brief Notify that it's now paused.
     signals: void paused();
 
-    /// \brief Subscriber callback when new world statistics are received
+    /// \brief Subscriber callback with the latest world statistics, called
+    /// on the GUI thread at most once per frame however fast they're
+    /// published
     private: void OnWorldStatsMsg(const ignition::msgs::WorldStatistics &_msg);
 
+    /// \brief Called on the GUI thread once a control request got its
+    /// reply, to send the next one.
+    private slots: void OnControlReply();
+
     // Private data
     private: std::unique_ptr<WorldControlPrivate> dataPtr;
   };
@@ -168,6 +168,21 @@ RowLayout {
             WorldControl.OnStepCount(value)
           }
         }
+
+        Label {
+          text: WorldControl.latency < 0 ? "" :
+              WorldControl.latency.toFixed(1) + " ms"
+          Layout.alignment: Qt.AlignVCenter
+          Layout.rightMargin: 15
+          ToolTip.visible: latencyMa.containsMouse
+          ToolTip.text: qsTr("Round trip time of the latest request")
+
+          MouseArea {
+            id: latencyMa
+            anchors.fill: parent
+            hoverEnabled: true
+          }
+        }
       }
     }
 
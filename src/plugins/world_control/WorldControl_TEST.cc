@@ -127,6 +127,75 @@ TEST(WorldControlTest, IGN_UTILS_TEST_ENABLED_ONLY_ON_LINUX(WorldControl))
   plugins.clear();
 }
 
+/////////////////////////////////////////////////
+TEST(WorldControlTest, IGN_UTILS_TEST_ENABLED_ONLY_ON_LINUX(MergeSteps))
+{
+  common::Console::SetVerbosity(4);
+
+  Application app(g_argc, g_argv);
+  app.AddPluginPath(std::string(PROJECT_BINARY_PATH) + "/lib");
+
+  const char *pluginStr =
+    "<plugin filename=\"WorldControl\">"
+      "<play_pause>true</play_pause>"
+      "<service>/world_control_merge_test</service>"
+    "</plugin>";
+
+  tinyxml2::XMLDocument pluginDoc;
+  EXPECT_EQ(tinyxml2::XML_SUCCESS, pluginDoc.Parse(pluginStr));
+  EXPECT_TRUE(app.LoadPlugin("WorldControl",
+      pluginDoc.FirstChildElement("plugin")));
+
+  auto win = app.findChild<MainWindow *>();
+  ASSERT_NE(nullptr, win);
+  win->QuickWindow()->show();
+
+  auto plugin = win->findChild<plugins::WorldControl *>();
+  ASSERT_NE(nullptr, plugin);
+  EXPECT_LT(plugin->Latency(), 0.0);
+
+  // Services in this process reply before the request returns, so requests
+  // made while the first one is being served are queued
+  std::vector<msgs::WorldControl> requests;
+  std::function<bool(const msgs::WorldControl &, msgs::Boolean &)> cb =
+      [&](const msgs::WorldControl &_req, msgs::Boolean &_rep)
+  {
+    requests.push_back(_req);
+    if (requests.size() == 1u)
+    {
+      for (int i = 0; i < 5; ++i)
+        plugin->OnStep();
+      plugin->OnPlay();
+      plugin->OnPause();
+    }
+    _rep.set_data(true);
+    return true;
+  };
+  transport::Node node;
+  node.Advertise("/world_control_merge_test", cb);
+
+  plugin->OnPause();
+
+  int sleep = 0;
+  int maxSleep = 50;
+  while (requests.size() < 3u && sleep < maxSleep)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    QCoreApplication::processEvents();
+    sleep++;
+  }
+
+  // Pause, 5 steps at once, and only the last of play and pause
+  ASSERT_EQ(3u, requests.size());
+  EXPECT_TRUE(requests[0].pause());
+  EXPECT_EQ(0u, requests[0].multi_step());
+  EXPECT_TRUE(requests[1].pause());
+  EXPECT_EQ(5u, requests[1].multi_step());
+  EXPECT_TRUE(requests[2].pause());
+  EXPECT_EQ(0u, requests[2].multi_step());
+  EXPECT_GE(plugin->Latency(), 0.0);
+}
+
 /////////////////////////////////////////////////
 TEST(WorldControlTest, IGN_UTILS_TEST_ENABLED_ONLY_ON_LINUX(WorldNameNoService))
 {
@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGNITION_GUI_PLUGINS_WORLDDASHBOARD_STATSRING_HH_
+#define IGNITION_GUI_PLUGINS_WORLDDASHBOARD_STATSRING_HH_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ignition
+{
+namespace gui
+{
+namespace plugins
+{
+  /// \brief The statistics of a world which the dashboard keeps, out of a
+  /// world statistics msg
+  struct WorldSample
+  {
+    /// \brief Real time, in seconds
+    double realTime{0.0};
+
+    /// \brief Sim time, in seconds
+    double simTime{0.0};
+
+    /// \brief Iterations since the world started
+    std::uint64_t iterations{0u};
+
+    /// \brief Real time factor, 1 for real time
+    double rtf{0.0};
+
+    /// \brief True if the world is paused
+    bool paused{false};
+  };
+
+  /// \brief Get the iterations per second of real time between two
+  /// samples of a world.
+  /// \param[in] _prev Earlier sample
+  /// \param[in] _next Later sample
+  /// \return Rate, negative if it can't be told, such as when the world
+  /// was reset in between
+  inline double IterationRate(const WorldSample &_prev,
+      const WorldSample &_next)
+  {
+    double span = _next.realTime - _prev.realTime;
+    if (span <= 0.0 || _next.iterations < _prev.iterations)
+      return -1.0;
+    return static_cast<double>(_next.iterations - _prev.iterations) / span;
+  }
+
+  /// \brief Fixed number of the latest values of a statistic. A dashboard
+  /// keeps one per world, so values are floats, and the oldest one is
+  /// overwritten once it's full.
+  class StatsRing
+  {
+    /// \brief Constructor
+    /// \param[in] _capacity Number of values kept
+    public: explicit StatsRing(const std::size_t _capacity = 0u)
+      : values(_capacity)
+    {
+    }
+
+    /// \brief Get the number of values kept at most.
+    /// \return Capacity
+    public: std::size_t Capacity() const
+    {
+      return this->values.size();
+    }
+
+    /// \brief Get the number of values in the ring.
+    /// \return Count
+    public: std::size_t Size() const
+    {
+      return this->count;
+    }
+
+    /// \brief Add a value, replacing the oldest if the ring is full.
+    /// \param[in] _value Value
+    public: void Push(const float _value)
+    {
+      if (this->values.empty())
+        return;
+
+      this->values[this->next] = _value;
+      this->next = (this->next + 1u) % this->values.size();
+      this->count = std::min(this->count + 1u, this->values.size());
+    }
+
+    /// \brief Remove all values.
+    public: void Clear()
+    {
+      this->next = 0u;
+      this->count = 0u;
+    }
+
+    /// \brief Get a value.
+    /// \param[in] _index Index, 0 for the oldest, below Size()
+    /// \return Value
+    public: float At(const std::size_t _index) const
+    {
+      auto size = this->values.size();
+      return this->values[(this->next + size - this->count + _index) % size];
+    }
+
+    /// \brief Shorten the values to a number of points for a sparkline,
+    /// keeping the lowest value of each group so dips stand out.
+    /// \param[in] _points Most points
+    /// \param[out] _out Points, oldest first
+    public: void Downsample(const std::size_t _points,
+        std::vector<float> &_out) const
+    {
+      _out.clear();
+      if (this->count == 0u || _points == 0u)
+        return;
+
+      auto group = (this->count + _points - 1u) / _points;
+      for (std::size_t i = 0u; i < this->count; i += group)
+      {
+        auto end = std::min(i + group, this->count);
+        float low = this->At(i);
+        for (std::size_t j = i + 1u; j < end; ++j)
+          low = std::min(low, this->At(j));
+        _out.push_back(low);
+      }
+    }
+
+    /// \brief Storage, of the capacity
+    private: std::vector<float> values;
+
+    /// \brief Index where the next value goes
+    private: std::size_t next{0u};
+
+    /// \brief Number of values in the ring
+    private: std::size_t count{0u};
+  };
+}
+}
+}
+
+#endif
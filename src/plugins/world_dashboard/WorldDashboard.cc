@@ -0,0 +1,589 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <QAbstractListModel>
+#include <QTimer>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#ifdef _MSC_VER
+#pragma warning(push, 0)
+#endif
+#include <ignition/msgs/world_stats.pb.h>
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/StringUtils.hh>
+#include <ignition/plugin/Register.hh>
+
+#include "ignition/gui/Enums.hh"
+#include "ignition/gui/Helpers.hh"
+#include "ignition/gui/SearchModel.hh"
+#include "ignition/gui/SubscriptionHub.hh"
+#include "ignition/gui/TopicRegistry.hh"
+
+#include "StatsRing.hh"
+#include "WorldDashboard.hh"
+
+#define NAME_ROLE DataRole::DISPLAY_NAME
+#define TOPIC_ROLE (Qt::UserRole + 1)
+#define SIM_TIME_ROLE (Qt::UserRole + 2)
+#define RTF_ROLE (Qt::UserRole + 3)
+#define ITERATION_RATE_ROLE (Qt::UserRole + 4)
+#define PAUSED_ROLE (Qt::UserRole + 5)
+#define STALE_ROLE (Qt::UserRole + 6)
+#define HISTORY_ROLE (Qt::UserRole + 7)
+
+namespace ignition
+{
+namespace gui
+{
+namespace plugins
+{
+  /// \brief Latest statistics of a world, written by transport threads and
+  /// shared with its subscription, so callbacks in flight when it's
+  /// unsubscribed don't outlive it
+  class WorldFeed
+  {
+    /// \brief Keep the statistics of a msg.
+    /// \param[in] _msg World statistics
+    public: void OnMessage(const msgs::WorldStatistics &_msg)
+    {
+      WorldSample sample;
+      sample.realTime = _msg.real_time().sec() +
+          _msg.real_time().nsec() * 1e-9;
+      sample.simTime = _msg.sim_time().sec() + _msg.sim_time().nsec() * 1e-9;
+      sample.iterations = _msg.iterations();
+      sample.rtf = _msg.real_time_factor();
+      sample.paused = _msg.paused();
+
+      std::lock_guard<std::mutex> lock(this->mutex);
+      this->latest = sample;
+      ++this->messages;
+    }
+
+    /// \brief Protects the members below
+    public: std::mutex mutex;
+
+    /// \brief Latest sample
+    public: WorldSample latest;
+
+    /// \brief Messages received
+    public: std::uint64_t messages{0u};
+  };
+
+  /// \brief A world and its statistics, as shown
+  struct WorldRow
+  {
+    /// \brief World name, or the topic if it isn't a world's usual one
+    QString name;
+
+    /// \brief Statistics topic
+    QString topic;
+
+    /// \brief Receives the statistics, null while not subscribed
+    std::shared_ptr<WorldFeed> feed;
+
+    /// \brief Subscription to the topic, 0 if none
+    std::size_t subscription{0u};
+
+    /// \brief Messages of the feed as of the last refresh
+    std::uint64_t seen{0u};
+
+    /// \brief Sample shown
+    WorldSample sample;
+
+    /// \brief False until a sample is shown
+    bool hasSample{false};
+
+    /// \brief True until the first msg since subscribing, whose rate would
+    /// span the time the world wasn't followed
+    bool resumed{true};
+
+    /// \brief Iterations per second since the previous sample
+    double iterationRate{0.0};
+
+    /// \brief True if no msg came for a while
+    bool stale{false};
+
+    /// \brief When a msg last came
+    std::chrono::steady_clock::time_point lastMessage;
+
+    /// \brief Real time factors as percentages, one per refresh with a msg
+    StatsRing rtf;
+  };
+
+  /// \brief Flat model of the worlds and their statistics
+  class WorldDashboardModel : public QAbstractListModel
+  {
+    // Documentation inherited
+    public: int rowCount(const QModelIndex &_parent = QModelIndex()) const
+                override
+    {
+      return _parent.isValid() ? 0 : static_cast<int>(this->rows.size());
+    }
+
+    // Documentation inherited
+    public: QVariant data(const QModelIndex &_index, int _role) const
+                override;
+
+    /// \brief roles and names of the model
+    public: QHash<int, QByteArray> roleNames() const override
+    {
+      QHash<int, QByteArray> roles;
+      roles[NAME_ROLE] = "name";
+      roles[TOPIC_ROLE] = "topic";
+      roles[SIM_TIME_ROLE] = "simTime";
+      roles[RTF_ROLE] = "rtf";
+      roles[ITERATION_RATE_ROLE] = "iterationRate";
+      roles[PAUSED_ROLE] = "paused";
+      roles[STALE_ROLE] = "stale";
+      roles[HISTORY_ROLE] = "history";
+      return roles;
+    }
+
+    /// \brief Notify that the statistics of some rows changed, only for
+    /// the statistics roles, so the names aren't searched again.
+    /// \param[in] _first First row which changed
+    /// \param[in] _last Last row which changed
+    public: void StatsChanged(const int _first, const int _last)
+    {
+      emit this->dataChanged(this->index(_first), this->index(_last),
+          {SIM_TIME_ROLE, RTF_ROLE, ITERATION_RATE_ROLE, PAUSED_ROLE,
+           STALE_ROLE, HISTORY_ROLE});
+    }
+
+    /// \brief Worlds, sorted by name
+    public: std::vector<WorldRow> rows;
+
+    /// \brief Allow the plugin to insert rows
+    friend class WorldDashboard;
+  };
+
+  class WorldDashboardPrivate
+  {
+    /// \brief Subscribe to a world's statistics.
+    /// \param[in] _row World
+    public: void Subscribe(WorldRow &_row);
+
+    /// \brief Stop receiving a world's statistics.
+    /// \param[in] _row World
+    public: void Unsubscribe(WorldRow &_row);
+
+    /// \brief Worlds and their statistics
+    public: WorldDashboardModel model;
+
+    /// \brief Worlds filtered by the search and sorted, shown
+    public: SearchModel searchModel;
+
+    /// \brief Topics of the worlds in the model
+    public: std::set<std::string> known;
+
+    /// \brief Topics given in the config
+    public: std::vector<std::string> topics;
+
+    /// \brief True to add every topic publishing world statistics
+    public: bool discover{true};
+
+    /// \brief Number of refreshes kept in the sparklines
+    public: std::size_t historySize{120u};
+
+    /// \brief Updates the statistics
+    public: QTimer timer;
+
+    /// \brief Refreshes since the worlds were last updated
+    public: unsigned int sinceWorlds{0u};
+
+    /// \brief True while the plugin isn't visible
+    public: bool suspended{false};
+  };
+}
+}
+}
+
+using namespace ignition;
+using namespace gui;
+using namespace plugins;
+
+/// \brief Default milliseconds between refreshes
+static const int kRefreshPeriod = 500;
+
+/// \brief Time without msgs after which a world is shown as stale
+static const std::chrono::seconds kStaleTime{3};
+
+/// \brief Most points of a sparkline
+static const std::size_t kSparklinePoints = 60u;
+
+/// \brief Refreshes between checks of the window's worlds, which aren't
+/// announced when they change
+static const unsigned int kWorldsPeriod = 10u;
+
+/// \brief Delay before searching, so typing isn't slowed down by large
+/// numbers of worlds
+static const int kSearchDelay = 200;
+
+/////////////////////////////////////////////////
+/// \brief Get the name of the world publishing on a topic.
+/// \param[in] _topic Statistics topic
+/// \return The world's name, or the topic if it isn't "/world/<name>/stats"
+static std::string worldName(const std::string &_topic)
+{
+  auto parts = common::Split(_topic, '/');
+  if (parts.size() == 4 && parts[0].empty() && parts[1] == "world" &&
+      !parts[2].empty() && parts[3] == "stats")
+  {
+    return parts[2];
+  }
+  return _topic;
+}
+
+/////////////////////////////////////////////////
+QVariant WorldDashboardModel::data(const QModelIndex &_index, int _role) const
+{
+  if (!_index.isValid() || _index.row() >= this->rowCount())
+    return QVariant();
+
+  const auto &row = this->rows[_index.row()];
+  switch (_role)
+  {
+    case Qt::DisplayRole:
+    case NAME_ROLE:
+      return row.name;
+    case TOPIC_ROLE:
+      return row.topic;
+    case SIM_TIME_ROLE:
+      return row.hasSample ? row.sample.simTime : -1.0;
+    case RTF_ROLE:
+      return row.hasSample ? row.sample.rtf * 100.0 : -1.0;
+    case ITERATION_RATE_ROLE:
+      return row.iterationRate;
+    case PAUSED_ROLE:
+      return row.sample.paused;
+    case STALE_ROLE:
+      return row.stale || !row.hasSample;
+    case HISTORY_ROLE:
+    {
+      // Only asked for the rows in view
+      std::vector<float> points;
+      row.rtf.Downsample(kSparklinePoints, points);
+      QVariantList list;
+      list.reserve(static_cast<int>(points.size()));
+      for (auto point : points)
+        list.push_back(static_cast<double>(point));
+      return list;
+    }
+    default:
+      return QVariant();
+  }
+}
+
+/////////////////////////////////////////////////
+void WorldDashboardPrivate::Subscribe(WorldRow &_row)
+{
+  auto feed = std::make_shared<WorldFeed>();
+  _row.subscription =
+      SubscriptionHub::Instance()->Subscribe<msgs::WorldStatistics>(
+      _row.topic.toStdString(),
+      [feed](const std::shared_ptr<const msgs::WorldStatistics> &_msg)
+      {
+        feed->OnMessage(*_msg);
+      });
+  if (!_row.subscription)
+  {
+    ignwarn << "Unable to subscribe to topic [" << _row.topic.toStdString()
+            << "]" << std::endl;
+    return;
+  }
+
+  _row.feed = feed;
+  _row.seen = 0u;
+  _row.resumed = true;
+}
+
+/////////////////////////////////////////////////
+void WorldDashboardPrivate::Unsubscribe(WorldRow &_row)
+{
+  if (!_row.feed)
+    return;
+
+  SubscriptionHub::Instance()->Unsubscribe(_row.subscription);
+  _row.subscription = 0u;
+  _row.feed.reset();
+}
+
+/////////////////////////////////////////////////
+WorldDashboard::WorldDashboard()
+  : Plugin(), dataPtr(new WorldDashboardPrivate)
+{
+  this->dataPtr->searchModel.setFilterRole(NAME_ROLE);
+  this->dataPtr->searchModel.setSortRole(NAME_ROLE);
+  this->dataPtr->searchModel.SetDelay(kSearchDelay);
+  this->dataPtr->searchModel.setSourceModel(&this->dataPtr->model);
+  this->dataPtr->searchModel.sort(0);
+
+  this->dataPtr->timer.setInterval(kRefreshPeriod);
+  connect(&this->dataPtr->timer, SIGNAL(timeout()), this, SLOT(Refresh()));
+}
+
+/////////////////////////////////////////////////
+WorldDashboard::~WorldDashboard()
+{
+  for (auto &row : this->dataPtr->model.rows)
+    this->dataPtr->Unsubscribe(row);
+}
+
+/////////////////////////////////////////////////
+void WorldDashboard::LoadConfig(const tinyxml2::XMLElement *_pluginElem)
+{
+  if (this->title.empty())
+    this->title = "World dashboard";
+
+  if (_pluginElem)
+  {
+    for (auto topicElem = _pluginElem->FirstChildElement("topic");
+        topicElem != nullptr;
+        topicElem = topicElem->NextSiblingElement("topic"))
+    {
+      if (topicElem->GetText())
+        this->dataPtr->topics.push_back(topicElem->GetText());
+    }
+
+    if (auto discoverElem = _pluginElem->FirstChildElement("discover"))
+      discoverElem->QueryBoolText(&this->dataPtr->discover);
+
+    if (auto periodElem = _pluginElem->FirstChildElement("refresh_period"))
+    {
+      int period{kRefreshPeriod};
+      periodElem->QueryIntText(&period);
+      if (period > 0)
+        this->dataPtr->timer.setInterval(period);
+      else
+        ignwarn << "Invalid refresh period [" << period << "]" << std::endl;
+    }
+
+    if (auto sizeElem = _pluginElem->FirstChildElement("history_size"))
+    {
+      unsigned int size = static_cast<unsigned int>(
+          this->dataPtr->historySize);
+      sizeElem->QueryUnsignedText(&size);
+      this->dataPtr->historySize = std::max(2u, size);
+    }
+  }
+
+  // Connected first so no world is missed while the current ones are added
+  if (this->dataPtr->discover)
+  {
+    connect(TopicRegistry::Instance(), SIGNAL(TopicsChanged()), this,
+            SLOT(UpdateWorlds()), Qt::QueuedConnection);
+    TopicRegistry::Instance()->Refresh();
+  }
+
+  this->UpdateWorlds();
+  this->dataPtr->timer.start();
+}
+
+/////////////////////////////////////////////////
+QObject *WorldDashboard::Model() const
+{
+  return &this->dataPtr->searchModel;
+}
+
+/////////////////////////////////////////////////
+int WorldDashboard::WorldCount() const
+{
+  return static_cast<int>(this->dataPtr->model.rows.size());
+}
+
+/////////////////////////////////////////////////
+void WorldDashboard::OnSearch(const QString &_search)
+{
+  this->dataPtr->searchModel.SetSearch(_search);
+}
+
+/////////////////////////////////////////////////
+void WorldDashboard::OnSort(const QString &_role, const bool _ascending)
+{
+  auto roles = this->dataPtr->model.roleNames();
+  auto role = roles.key(_role.toUtf8(), -1);
+  if (role < 0)
+  {
+    ignerr << "Unknown role [" << _role.toStdString() << "]" << std::endl;
+    return;
+  }
+
+  this->dataPtr->searchModel.setSortRole(role);
+  this->dataPtr->searchModel.sort(0,
+      _ascending ? Qt::AscendingOrder : Qt::DescendingOrder);
+}
+
+/////////////////////////////////////////////////
+void WorldDashboard::UpdateWorlds()
+{
+  this->dataPtr->sinceWorlds = 0u;
+
+  std::vector<std::string> topics = this->dataPtr->topics;
+  for (const auto &name : gui::worldNames())
+    topics.push_back("/world/" + name.toStdString() + "/stats");
+  if (this->dataPtr->discover)
+  {
+    auto published =
+        TopicRegistry::Instance()->Topics("ignition.msgs.WorldStatistics");
+    topics.insert(topics.end(), published.begin(), published.end());
+  }
+
+  // Worlds which stop publishing are kept, and shown as stale
+  auto &model = this->dataPtr->model;
+  auto &rows = model.rows;
+  bool added{false};
+  for (const auto &topic : topics)
+  {
+    if (!this->dataPtr->known.insert(topic).second)
+      continue;
+
+    auto name = QString::fromStdString(worldName(topic));
+    auto it = std::lower_bound(rows.begin(), rows.end(), name,
+        [](const WorldRow &_row, const QString &_name)
+        {
+          return _row.name < _name;
+        });
+    int index = static_cast<int>(it - rows.begin());
+
+    model.beginInsertRows(QModelIndex(), index, index);
+    WorldRow row;
+    row.name = name;
+    row.topic = QString::fromStdString(topic);
+    row.rtf = StatsRing(this->dataPtr->historySize);
+    it = rows.insert(it, std::move(row));
+    if (!this->dataPtr->suspended)
+      this->dataPtr->Subscribe(*it);
+    model.endInsertRows();
+    added = true;
+  }
+
+  if (added)
+    this->WorldCountChanged();
+}
+
+/////////////////////////////////////////////////
+void WorldDashboard::Refresh()
+{
+  if (++this->dataPtr->sinceWorlds >= kWorldsPeriod)
+    this->UpdateWorlds();
+
+  auto now = std::chrono::steady_clock::now();
+  auto &rows = this->dataPtr->model.rows;
+  int first{-1};
+  int last{-1};
+  for (std::size_t i = 0; i < rows.size(); ++i)
+  {
+    auto &row = rows[i];
+    if (!row.feed)
+      continue;
+
+    WorldSample sample;
+    std::uint64_t messages;
+    {
+      std::lock_guard<std::mutex> lock(row.feed->mutex);
+      sample = row.feed->latest;
+      messages = row.feed->messages;
+    }
+
+    bool changed{false};
+    if (messages != row.seen)
+    {
+      if (row.hasSample)
+      {
+        // The world was reset, its history is of the previous run
+        if (sample.iterations < row.sample.iterations)
+          row.rtf.Clear();
+
+        auto rate = IterationRate(row.sample, sample);
+        if (rate >= 0.0 && !row.resumed)
+          row.iterationRate = rate;
+      }
+
+      row.seen = messages;
+      row.sample = sample;
+      row.hasSample = true;
+      row.resumed = false;
+      row.stale = false;
+      row.lastMessage = now;
+      row.rtf.Push(static_cast<float>(sample.rtf * 100.0));
+      changed = true;
+    }
+    else if (row.hasSample && !row.stale && now - row.lastMessage > kStaleTime)
+    {
+      row.stale = true;
+      row.iterationRate = 0.0;
+      changed = true;
+    }
+
+    if (changed)
+    {
+      if (first < 0)
+        first = static_cast<int>(i);
+      last = static_cast<int>(i);
+    }
+  }
+
+  if (first >= 0)
+    this->dataPtr->model.StatsChanged(first, last);
+}
+
+/////////////////////////////////////////////////
+void WorldDashboard::Suspend()
+{
+  this->dataPtr->suspended = true;
+  this->dataPtr->timer.stop();
+  for (auto &row : this->dataPtr->model.rows)
+    this->dataPtr->Unsubscribe(row);
+}
+
+/////////////////////////////////////////////////
+void WorldDashboard::Resume()
+{
+  this->dataPtr->suspended = false;
+  for (auto &row : this->dataPtr->model.rows)
+    this->dataPtr->Subscribe(row);
+  this->UpdateWorlds();
+  this->dataPtr->timer.start();
+}
+
+/////////////////////////////////////////////////
+std::size_t WorldDashboard::MemoryUsage() const
+{
+  std::size_t bytes = this->dataPtr->model.rows.capacity() * sizeof(WorldRow);
+  for (const auto &row : this->dataPtr->model.rows)
+  {
+    bytes += row.rtf.Capacity() * sizeof(float);
+    if (row.feed)
+      bytes += sizeof(WorldFeed);
+  }
+  return bytes;
+}
+
+// Register this plugin
+IGNITION_ADD_PLUGIN(ignition::gui::plugins::WorldDashboard,
+                    ignition::gui::Plugin)
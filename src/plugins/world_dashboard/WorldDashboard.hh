@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef IGNITION_GUI_PLUGINS_WORLDDASHBOARD_HH_
+#define IGNITION_GUI_PLUGINS_WORLDDASHBOARD_HH_
+
+#include <memory>
+
+#include "ignition/gui/Plugin.hh"
+
+namespace ignition
+{
+namespace gui
+{
+namespace plugins
+{
+  class WorldDashboardPrivate;
+
+  /// \brief Table of the statistics of many worlds at once, such as those
+  /// of a farm of parallel simulations. Each row shows a world's sim time,
+  /// real time factor, iteration rate and whether it's paused or stopped
+  /// publishing, with a sparkline of its recent real time factor.
+  ///
+  /// Worlds are those of the main window's "worldNames" property, those
+  /// given in the config, and, unless disabled, every topic publishing
+  /// ignition::msgs::WorldStatistics, as they show up.
+  ///
+  /// Each world's topic is subscribed to once, through the SubscriptionHub,
+  /// so it's shared with WorldStats cards of the same world. Messages only
+  /// replace the latest sample of their world. Rows are updated together
+  /// once per refresh period, when each world adds a single value to a
+  /// small ring of its history, and only the rows which changed are
+  /// announced. The table only creates the rows in view, so the cost stays
+  /// the same however many worlds there are.
+  ///
+  /// ## Configuration
+  ///
+  /// * \<topic\> : World statistics topic to show, may be given more than
+  ///               once.
+  /// * \<discover\> : False to only show the worlds of the window and the
+  ///                  config. Defaults to true.
+  /// * \<refresh_period\> : Milliseconds between updates of the table,
+  ///                        defaults to 500.
+  /// * \<history_size\> : Number of refreshes kept in the sparklines,
+  ///                      defaults to 120.
+  class WorldDashboard : public Plugin
+  {
+    Q_OBJECT
+
+    /// \brief Worlds and their statistics, filtered by the search and
+    /// sorted
+    Q_PROPERTY(
+      QObject *model
+      READ Model
+      CONSTANT
+    )
+
+    /// \brief Number of worlds
+    Q_PROPERTY(
+      int worldCount
+      READ WorldCount
+      NOTIFY WorldCountChanged
+    )
+
+    /// \brief Constructor
+    public: WorldDashboard();
+
+    /// \brief Destructor
+    public: ~WorldDashboard() override;
+
+    // Documentation inherited
+    public: void LoadConfig(const tinyxml2::XMLElement *_pluginElem) override;
+
+    /// \brief Get the model of the worlds shown, filtered by the search
+    /// and sorted. Its rows have the roles "name", "topic", "simTime",
+    /// "rtf", "iterationRate", "paused", "stale" and "history".
+    /// \return Pointer to the model
+    public: Q_INVOKABLE QObject *Model() const;
+
+    /// \brief Get the number of worlds, including those filtered out.
+    /// \return Count
+    public: Q_INVOKABLE int WorldCount() const;
+
+    /// \brief Notify that worlds were added
+    signals: void WorldCountChanged();
+
+    /// \brief Show only the worlds whose name contains all words of a
+    /// search.
+    /// \param[in] _search Words separated by spaces, empty for all worlds
+    public slots: void OnSearch(const QString &_search);
+
+    /// \brief Sort the worlds shown.
+    /// \param[in] _role Role sorted by, such as "name" or "rtf"
+    /// \param[in] _ascending True for ascending order
+    public slots: void OnSort(const QString &_role, const bool _ascending);
+
+    /// \brief Add the worlds which showed up.
+    private slots: void UpdateWorlds();
+
+    /// \brief Update the statistics, once per refresh period.
+    private slots: void Refresh();
+
+    // Documentation inherited
+    protected: void Suspend() override;
+
+    // Documentation inherited
+    protected: void Resume() override;
+
+    // Documentation inherited
+    public: std::size_t MemoryUsage() const override;
+
+    /// \internal
+    /// \brief Pointer to private data.
+    private: std::unique_ptr<WorldDashboardPrivate> dataPtr;
+  };
+}
+}
+}
+
+#endif
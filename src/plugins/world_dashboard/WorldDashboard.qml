@@ -0,0 +1,295 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+import QtQuick 2.9
+import QtQuick.Controls 2.2
+import QtQuick.Controls.Material 2.1
+import QtQuick.Layouts 1.3
+
+ColumnLayout {
+  id: worldDashboard
+  Layout.minimumWidth: 560
+  Layout.minimumHeight: 300
+  anchors.fill: parent
+  spacing: 0
+
+  /**
+   * Role the worlds are sorted by
+   */
+  property string sortRole: "name"
+
+  /**
+   * True to sort in ascending order
+   */
+  property bool ascending: true
+
+  property int rowHeight: 30
+
+  property color textColor: (Material.theme == Material.Light) ?
+      Material.color(Material.Grey, Material.Shade800) :
+      Material.color(Material.Grey, Material.Shade400)
+
+  property color oddColor: (Material.theme == Material.Light) ?
+      Material.color(Material.Grey, Material.Shade100) :
+      Material.color(Material.Grey, Material.Shade800)
+
+  property color evenColor: (Material.theme == Material.Light) ?
+      Material.color(Material.Grey, Material.Shade200) :
+      Material.color(Material.Grey, Material.Shade900)
+
+  property color lineColor: Material.accent
+
+  /**
+   * Columns, the first one takes the space left by the others. Columns
+   * without a role can't be sorted.
+   */
+  property var columns: [
+    {"role": "name", "title": "World", "width": 0},
+    {"role": "simTime", "title": "Sim time", "width": 90},
+    {"role": "rtf", "title": "RTF", "width": 70},
+    {"role": "", "title": "RTF history", "width": 120},
+    {"role": "iterationRate", "title": "Iter/s", "width": 80}
+  ]
+
+  function columnWidth(_index)
+  {
+    if (columns[_index].width > 0)
+      return columns[_index].width;
+
+    var others = 0;
+    for (var i = 0; i < columns.length; ++i)
+      others += columns[i].width;
+    return Math.max(worldDashboard.width - others, 100);
+  }
+
+  function formatTime(_seconds)
+  {
+    if (_seconds < 0)
+      return "-";
+
+    var total = Math.floor(_seconds);
+    var hours = Math.floor(total / 3600);
+    var minutes = Math.floor(total / 60) % 60;
+    var seconds = total % 60;
+    return hours + ":" + (minutes < 10 ? "0" : "") + minutes + ":" +
+        (seconds < 10 ? "0" : "") + seconds;
+  }
+
+  function cellText(_row, _index)
+  {
+    switch (columns[_index].role)
+    {
+      case "name":
+        return _row.name;
+      case "simTime":
+        return formatTime(_row.simTime);
+      case "rtf":
+        return _row.rtf < 0 ? "-" : _row.rtf.toFixed(1) + " %";
+      case "iterationRate":
+        return _row.rtf < 0 ? "-" : _row.iterationRate.toFixed(0);
+    }
+    return "";
+  }
+
+  function statusColor(_row)
+  {
+    if (_row.stale || _row.rtf < 0)
+      return Material.color(Material.Grey);
+    if (_row.paused)
+      return Material.color(Material.Amber);
+    return Material.color(Material.Green);
+  }
+
+  function statusText(_row)
+  {
+    if (_row.rtf < 0)
+      return "Waiting for statistics";
+    if (_row.stale)
+      return "No statistics lately";
+    if (_row.paused)
+      return "Paused";
+    return "Running";
+  }
+
+  function sortBy(_role)
+  {
+    if (_role === "")
+      return;
+
+    // statistics are more interesting from the highest
+    if (sortRole === _role)
+      ascending = !ascending;
+    else
+      ascending = (_role === "name");
+    sortRole = _role;
+    WorldDashboard.OnSort(sortRole, ascending);
+  }
+
+  RowLayout {
+    Layout.fillWidth: true
+    Layout.leftMargin: 5
+    Layout.rightMargin: 5
+
+    TextField {
+      id: searchField
+      Layout.fillWidth: true
+      placeholderText: "Search worlds"
+      selectByMouse: true
+      onTextChanged: WorldDashboard.OnSearch(text)
+    }
+
+    Label {
+      text: WorldDashboard.worldCount + " worlds"
+      color: textColor
+    }
+  }
+
+  Row {
+    id: header
+    Layout.fillWidth: true
+    Layout.preferredHeight: rowHeight
+
+    Repeater {
+      model: columns.length
+      delegate: ToolButton {
+        width: columnWidth(index)
+        height: rowHeight
+        enabled: columns[index].role !== ""
+        text: columns[index].title +
+              (sortRole === columns[index].role ?
+               (ascending ? " ▲" : " ▼") : "")
+        font.pointSize: 10
+        font.bold: sortRole === columns[index].role
+        onClicked: sortBy(columns[index].role)
+      }
+    }
+  }
+
+  // Only the visible rows have delegates, so thousands of worlds cost
+  // little more to show than a screenful
+  ListView {
+    id: list
+    Layout.fillWidth: true
+    Layout.fillHeight: true
+    clip: true
+    model: WorldDashboard.model
+    ScrollBar.vertical: ScrollBar {
+      policy: ScrollBar.AsNeeded
+    }
+
+    delegate: Rectangle {
+      width: list.width
+      height: rowHeight
+      color: (index % 2 == 0) ? evenColor : oddColor
+
+      property var row: model
+
+      Row {
+        anchors.fill: parent
+        Repeater {
+          model: columns.length
+          delegate: Item {
+            width: columnWidth(index)
+            height: rowHeight
+
+            Rectangle {
+              id: status
+              visible: index == 0
+              width: 10
+              height: 10
+              radius: 5
+              anchors.left: parent.left
+              anchors.leftMargin: 5
+              anchors.verticalCenter: parent.verticalCenter
+              color: statusColor(row)
+            }
+
+            Text {
+              visible: columns[index].role !== ""
+              anchors.fill: parent
+              leftPadding: index == 0 ? status.width + 10 : 5
+              rightPadding: 5
+              verticalAlignment: Text.AlignVCenter
+              horizontalAlignment: index == 0 ? Text.AlignLeft :
+                                                Text.AlignRight
+              elide: Text.ElideMiddle
+              color: textColor
+              opacity: row.stale ? 0.5 : 1.0
+              font.pointSize: 10
+              text: cellText(row, index)
+            }
+
+            Canvas {
+              id: sparkline
+              visible: columns[index].role === ""
+              anchors.fill: parent
+              anchors.margins: 4
+
+              property var history: visible ? row.history : []
+
+              onHistoryChanged: requestPaint()
+
+              onPaint: {
+                var ctx = getContext("2d");
+                ctx.reset();
+                if (history.length < 2)
+                  return;
+
+                var high = 100;
+                for (var i = 0; i < history.length; ++i)
+                  high = Math.max(high, history[i]);
+
+                // Real time
+                ctx.strokeStyle = textColor;
+                ctx.globalAlpha = 0.3;
+                ctx.beginPath();
+                ctx.moveTo(0, height * (1 - 100 / high));
+                ctx.lineTo(width, height * (1 - 100 / high));
+                ctx.stroke();
+
+                ctx.strokeStyle = lineColor;
+                ctx.globalAlpha = row.stale ? 0.5 : 1.0;
+                ctx.lineWidth = 1.5;
+                ctx.beginPath();
+                var step = width / (history.length - 1);
+                for (var j = 0; j < history.length; ++j)
+                {
+                  var y = height * (1 - history[j] / high);
+                  if (j == 0)
+                    ctx.moveTo(0, y);
+                  else
+                    ctx.lineTo(j * step, y);
+                }
+                ctx.stroke();
+              }
+            }
+          }
+        }
+      }
+
+      ToolTip.visible: hover.containsMouse
+      ToolTip.delay: 500
+      ToolTip.text: row.topic + "\n" + statusText(row)
+
+      MouseArea {
+        id: hover
+        anchors.fill: parent
+        hoverEnabled: true
+        acceptedButtons: Qt.NoButton
+      }
+    }
+  }
+}
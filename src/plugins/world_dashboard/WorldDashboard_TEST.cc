@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "StatsRing.hh"
+
+using namespace ignition;
+using namespace gui;
+using namespace plugins;
+
+/////////////////////////////////////////////////
+TEST(WorldDashboardTest, IterationRate)
+{
+  WorldSample prev;
+  prev.realTime = 1.0;
+  prev.iterations = 1000u;
+
+  WorldSample next;
+  next.realTime = 1.5;
+  next.iterations = 1500u;
+  EXPECT_DOUBLE_EQ(1000.0, IterationRate(prev, next));
+
+  // Paused
+  next.iterations = 1000u;
+  EXPECT_DOUBLE_EQ(0.0, IterationRate(prev, next));
+
+  // Reset in between
+  next.iterations = 10u;
+  EXPECT_GT(0.0, IterationRate(prev, next));
+
+  // Same or older msg
+  next.iterations = 1500u;
+  next.realTime = 1.0;
+  EXPECT_GT(0.0, IterationRate(prev, next));
+  next.realTime = 0.5;
+  EXPECT_GT(0.0, IterationRate(prev, next));
+}
+
+/////////////////////////////////////////////////
+TEST(WorldDashboardTest, StatsRing)
+{
+  StatsRing ring(4u);
+  EXPECT_EQ(4u, ring.Capacity());
+  EXPECT_EQ(0u, ring.Size());
+
+  ring.Push(7.0f);
+  ASSERT_EQ(1u, ring.Size());
+  EXPECT_FLOAT_EQ(7.0f, ring.At(0u));
+
+  // Oldest values are overwritten once full
+  ring.Clear();
+  EXPECT_EQ(0u, ring.Size());
+  for (int i = 0; i < 6; ++i)
+    ring.Push(static_cast<float>(i));
+  ASSERT_EQ(4u, ring.Size());
+  EXPECT_FLOAT_EQ(2.0f, ring.At(0u));
+  EXPECT_FLOAT_EQ(3.0f, ring.At(1u));
+  EXPECT_FLOAT_EQ(4.0f, ring.At(2u));
+  EXPECT_FLOAT_EQ(5.0f, ring.At(3u));
+
+  // Without capacity, nothing is kept
+  StatsRing empty;
+  empty.Push(1.0f);
+  EXPECT_EQ(0u, empty.Size());
+}
+
+/////////////////////////////////////////////////
+TEST(WorldDashboardTest, Downsample)
+{
+  StatsRing ring(6u);
+  std::vector<float> points{1.0f};
+  ring.Downsample(3u, points);
+  EXPECT_TRUE(points.empty());
+
+  for (auto value : {100.0f, 90.0f, 100.0f, 100.0f, 40.0f, 100.0f})
+    ring.Push(value);
+
+  // Lowest of each group, so dips stand out
+  ring.Downsample(3u, points);
+  ASSERT_EQ(3u, points.size());
+  EXPECT_FLOAT_EQ(90.0f, points[0]);
+  EXPECT_FLOAT_EQ(100.0f, points[1]);
+  EXPECT_FLOAT_EQ(40.0f, points[2]);
+
+  // Fewer values than points
+  ring.Downsample(10u, points);
+  EXPECT_EQ(6u, points.size());
+
+  ring.Downsample(4u, points);
+  ASSERT_EQ(3u, points.size());
+  EXPECT_FLOAT_EQ(40.0f, points[2]);
+
+  ring.Downsample(0u, points);
+  EXPECT_TRUE(points.empty());
+}
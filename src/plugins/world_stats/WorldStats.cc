@@ -17,13 +17,20 @@
 
 #include "WorldStats.hh"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include <ignition/common/Console.hh>
 #include <ignition/common/StringUtils.hh>
 #include <ignition/plugin/Register.hh>
 
 #include "ignition/gui/Helpers.hh"
+#include "ignition/gui/SubscriptionHub.hh"
 
 namespace ignition
 {
@@ -31,16 +38,41 @@ namespace gui
 {
 namespace plugins
 {
+  /// \brief What a single statistics message tells about performance
+  struct StatsSample
+  {
+    /// \brief Real time of the message, in seconds
+    double realTime;
+
+    /// \brief Real time factor, as a percentage
+    double rtf;
+
+    /// \brief Sim time per iteration since the previous message, in
+    /// milliseconds, negative if no iteration happened
+    double step;
+
+    /// \brief Iterations since the previous message
+    std::uint64_t iterations;
+  };
+
   class WorldStatsPrivate
   {
-    /// \brief Message holding latest world statistics
+    /// \brief Add a message to the history. Called on transport threads for
+    /// every message.
+    /// \param[in] _msg Message
+    public: void AddSample(const msgs::WorldStatistics &_msg);
+
+    /// \brief Summarize the history window, if the last summary is old
+    /// enough not to redo it every frame.
+    /// \return True if summarized
+    public: bool Summarize();
+
+    /// \brief Message holding latest world statistics, only used on the
+    /// GUI thread
     public: ignition::msgs::WorldStatistics msg;
 
-    /// \brief Mutex to protect msg
-    public: std::recursive_mutex mutex;
-
-    /// \brief Communication node
-    public: ignition::transport::Node node;
+    /// \brief Subscription to the stats topic, 0 if none
+    public: std::size_t subscription{0};
 
     /// \brief Holds real time factor
     public: QString realTimeFactor;
@@ -53,6 +85,44 @@ namespace plugins
 
     /// \brief Holds iterations
     public: QString iterations;
+
+    /// \brief Subscription receiving every message for the history, 0 if
+    /// none
+    public: std::size_t historySubscription{0};
+
+    /// \brief Ring of the latest samples
+    public: std::vector<StatsSample> history;
+
+    /// \brief Index in history where the next sample goes
+    public: std::size_t historyNext{0};
+
+    /// \brief Number of samples in history
+    public: std::size_t historyCount{0};
+
+    /// \brief Iterations of the previous message
+    public: std::uint64_t prevIterations{0};
+
+    /// \brief Sim time of the previous message, in seconds
+    public: double prevSimTime{0.0};
+
+    /// \brief Real time of the previous message, in seconds, negative
+    /// before the first message
+    public: double prevRealTime{-1.0};
+
+    /// \brief Protects the history and the previous values
+    public: std::mutex historyMutex;
+
+    /// \brief Seconds of history summarized
+    public: double historyWindow{10.0};
+
+    /// \brief Latest summary of the history window
+    public: QVariantMap historyStats;
+
+    /// \brief Latest real time factors of the history window
+    public: QVariantList rtfHistory;
+
+    /// \brief When the history was last summarized
+    public: std::chrono::steady_clock::time_point lastSummary;
   };
 }
 }
@@ -62,6 +132,145 @@ using namespace ignition;
 using namespace gui;
 using namespace plugins;
 
+/// \brief Approximate number of points of the real time factor sparkline
+static const std::size_t kSparklinePoints = 100;
+
+/// \brief Time between summaries of the history
+static const std::chrono::milliseconds kSummaryPeriod{250};
+
+/////////////////////////////////////////////////
+/// \brief Get a percentile of some values.
+/// \param[in] _values Values, reordered
+/// \param[in] _percentile Percentile, between 0 and 1
+/// \return Value at the percentile
+static double Percentile(std::vector<double> &_values, double _percentile)
+{
+  auto index = static_cast<std::size_t>(
+      std::ceil(_percentile * _values.size()));
+  index = std::min(std::max<std::size_t>(index, 1), _values.size()) - 1;
+  std::nth_element(_values.begin(), _values.begin() + index, _values.end());
+  return _values[index];
+}
+
+/////////////////////////////////////////////////
+void WorldStatsPrivate::AddSample(const msgs::WorldStatistics &_msg)
+{
+  double realTime = _msg.real_time().sec() + _msg.real_time().nsec() * 1e-9;
+  double simTime = _msg.sim_time().sec() + _msg.sim_time().nsec() * 1e-9;
+
+  std::lock_guard<std::mutex> lock(this->historyMutex);
+
+  // The world was reset, start over
+  if (realTime < this->prevRealTime || _msg.iterations() < this->prevIterations)
+  {
+    this->historyCount = 0;
+    this->prevRealTime = -1.0;
+  }
+
+  StatsSample sample{realTime, _msg.real_time_factor() * 100, -1.0, 0};
+  if (this->prevRealTime >= 0.0)
+  {
+    sample.iterations = _msg.iterations() - this->prevIterations;
+    if (sample.iterations > 0)
+    {
+      sample.step = (simTime - this->prevSimTime) * 1000 /
+          static_cast<double>(sample.iterations);
+    }
+  }
+  this->prevRealTime = realTime;
+  this->prevSimTime = simTime;
+  this->prevIterations = _msg.iterations();
+
+  if (this->history.empty())
+    return;
+
+  this->history[this->historyNext] = sample;
+  this->historyNext = (this->historyNext + 1) % this->history.size();
+  this->historyCount = std::min(this->historyCount + 1, this->history.size());
+}
+
+/////////////////////////////////////////////////
+bool WorldStatsPrivate::Summarize()
+{
+  auto now = std::chrono::steady_clock::now();
+  if (now - this->lastSummary < kSummaryPeriod)
+    return false;
+  this->lastSummary = now;
+
+  // Copy the samples of the window, oldest first
+  std::vector<StatsSample> samples;
+  {
+    std::lock_guard<std::mutex> lock(this->historyMutex);
+    auto size = this->history.size();
+    for (std::size_t i = 0; i < this->historyCount; ++i)
+    {
+      const auto &sample =
+          this->history[(this->historyNext + size - 1 - i) % size];
+      if (!samples.empty() &&
+          sample.realTime < samples.front().realTime - this->historyWindow)
+      {
+        break;
+      }
+      samples.push_back(sample);
+    }
+  }
+  std::reverse(samples.begin(), samples.end());
+
+  this->historyStats.clear();
+  this->rtfHistory.clear();
+  if (samples.empty())
+    return true;
+
+  std::vector<double> rtfs;
+  std::vector<double> steps;
+  std::uint64_t iterations{0};
+  for (std::size_t i = 0; i < samples.size(); ++i)
+  {
+    rtfs.push_back(samples[i].rtf);
+    if (samples[i].step >= 0.0)
+      steps.push_back(samples[i].step);
+
+    // Those of the first sample happened before the window
+    if (i > 0)
+      iterations += samples[i].iterations;
+  }
+
+  // Lowest factor of each group of samples
+  auto group = std::max<std::size_t>(1, rtfs.size() / kSparklinePoints);
+  for (std::size_t i = 0; i < rtfs.size(); i += group)
+  {
+    auto end = std::min(i + group, rtfs.size());
+    this->rtfHistory.push_back(
+        *std::min_element(rtfs.begin() + i, rtfs.begin() + end));
+  }
+
+  auto average = [](const std::vector<double> &_values)
+  {
+    double sum{0.0};
+    for (auto value : _values)
+      sum += value;
+    return sum / _values.size();
+  };
+
+  this->historyStats["rtfMin"] = *std::min_element(rtfs.begin(), rtfs.end());
+  this->historyStats["rtfAvg"] = average(rtfs);
+  this->historyStats["rtfP99"] = Percentile(rtfs, 0.99);
+
+  if (!steps.empty())
+  {
+    this->historyStats["stepMin"] =
+        *std::min_element(steps.begin(), steps.end());
+    this->historyStats["stepAvg"] = average(steps);
+    this->historyStats["stepP99"] = Percentile(steps, 0.99);
+  }
+
+  auto span = samples.back().realTime - samples.front().realTime;
+  if (span > 0.0)
+    this->historyStats["iterationRate"] = iterations / span;
+
+  return true;
+}
+
 /////////////////////////////////////////////////
 WorldStats::WorldStats()
   : Plugin(), dataPtr(new WorldStatsPrivate)
@@ -71,6 +280,9 @@ WorldStats::WorldStats()
 /////////////////////////////////////////////////
 WorldStats::~WorldStats()
 {
+  SubscriptionHub::Instance()->Unsubscribe(this->dataPtr->subscription);
+  SubscriptionHub::Instance()->Unsubscribe(
+      this->dataPtr->historySubscription);
 }
 
 /////////////////////////////////////////////////
@@ -127,12 +339,43 @@ void WorldStats::LoadConfig(const tinyxml2::XMLElement *_pluginElem)
     topic = "/world/" + worldName + "/stats";
   }
 
-  if (!this->dataPtr->node.Subscribe(topic, &WorldStats::OnWorldStatsMsg,
-      this))
+  // History, built from every message rather than only those displayed
+  auto historyElem = _pluginElem->FirstChildElement("history");
+  auto history = false;
+  if (historyElem)
+    historyElem->QueryBoolText(&history);
+  if (history)
+  {
+    unsigned int size{1200};
+    if (auto sizeElem = _pluginElem->FirstChildElement("history_size"))
+      sizeElem->QueryUnsignedText(&size);
+    this->dataPtr->history.resize(std::max(2u, size));
+
+    if (auto windowElem = _pluginElem->FirstChildElement("history_window"))
+      windowElem->QueryDoubleText(&this->dataPtr->historyWindow);
+
+    auto data = this->dataPtr.get();
+    this->dataPtr->historySubscription =
+        SubscriptionHub::Instance()->Subscribe<msgs::WorldStatistics>(topic,
+        [data](const std::shared_ptr<const msgs::WorldStatistics> &_msg)
+        {
+          data->AddSample(*_msg);
+        });
+    SubscriptionHub::Instance()->SetMsgsPerSec(
+        this->dataPtr->historySubscription, this->MsgsPerSec());
+  }
+  this->PluginItem()->setProperty("showHistory", history);
+
+  // Shared with other plugins following the same world
+  this->dataPtr->subscription = SubscriptionHub::Instance()->SubscribeLatest(
+      topic, &WorldStats::OnWorldStatsMsg, this);
+  if (!this->dataPtr->subscription)
   {
     ignerr << "Failed to subscribe to [" << topic << "]" << std::endl;
     return;
   }
+  SubscriptionHub::Instance()->SetMsgsPerSec(this->dataPtr->subscription,
+      this->MsgsPerSec());
 
   ignmsg << "Listening to stats on [" << topic << "]" << std::endl;
 
@@ -182,8 +425,6 @@ void WorldStats::LoadConfig(const tinyxml2::XMLElement *_pluginElem)
 /////////////////////////////////////////////////
 void WorldStats::ProcessMsg()
 {
-  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->mutex);
-
   std::chrono::steady_clock::time_point timePoint;
 
   if (this->dataPtr->msg.has_sim_time())
@@ -213,15 +454,16 @@ void WorldStats::ProcessMsg()
   {
     this->SetIterations(QString::number(this->dataPtr->msg.iterations()));
   }
+
+  if (this->dataPtr->historySubscription && this->dataPtr->Summarize())
+    this->HistoryChanged();
 }
 
 /////////////////////////////////////////////////
 void WorldStats::OnWorldStatsMsg(const ignition::msgs::WorldStatistics &_msg)
 {
-  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->mutex);
-
   this->dataPtr->msg.CopyFrom(_msg);
-  QMetaObject::invokeMethod(this, "ProcessMsg");
+  this->ProcessMsg();
 }
 
 /////////////////////////////////////////////////
@@ -233,6 +475,10 @@ QString WorldStats::RealTimeFactor() const
 /////////////////////////////////////////////////
 void WorldStats::SetRealTimeFactor(const QString &_realTimeFactor)
 {
+  // Stats arrive every frame, but the text often stays the same
+  if (this->dataPtr->realTimeFactor == _realTimeFactor)
+    return;
+
   this->dataPtr->realTimeFactor = _realTimeFactor;
   this->RealTimeFactorChanged();
 }
@@ -246,6 +492,9 @@ QString WorldStats::SimTime() const
 /////////////////////////////////////////////////
 void WorldStats::SetSimTime(const QString &_simTime)
 {
+  if (this->dataPtr->simTime == _simTime)
+    return;
+
   this->dataPtr->simTime = _simTime;
   this->SimTimeChanged();
 }
@@ -259,6 +508,9 @@ QString WorldStats::RealTime() const
 /////////////////////////////////////////////////
 void WorldStats::SetRealTime(const QString &_realTime)
 {
+  if (this->dataPtr->realTime == _realTime)
+    return;
+
   this->dataPtr->realTime = _realTime;
   this->RealTimeChanged();
 }
@@ -272,10 +524,49 @@ QString WorldStats::Iterations() const
 /////////////////////////////////////////////////
 void WorldStats::SetIterations(const QString &_iterations)
 {
+  if (this->dataPtr->iterations == _iterations)
+    return;
+
   this->dataPtr->iterations = _iterations;
   this->IterationsChanged();
 }
 
+/////////////////////////////////////////////////
+double WorldStats::HistoryWindow() const
+{
+  return this->dataPtr->historyWindow;
+}
+
+/////////////////////////////////////////////////
+void WorldStats::SetHistoryWindow(const double _historyWindow)
+{
+  if (_historyWindow <= 0.0 ||
+      std::abs(this->dataPtr->historyWindow - _historyWindow) < 1e-6)
+  {
+    return;
+  }
+
+  this->dataPtr->historyWindow = _historyWindow;
+  this->HistoryWindowChanged();
+
+  // Summarize right away
+  this->dataPtr->lastSummary = std::chrono::steady_clock::time_point();
+  if (this->dataPtr->historySubscription && this->dataPtr->Summarize())
+    this->HistoryChanged();
+}
+
+/////////////////////////////////////////////////
+QVariantList WorldStats::RtfHistory() const
+{
+  return this->dataPtr->rtfHistory;
+}
+
+/////////////////////////////////////////////////
+QVariantMap WorldStats::HistoryStats() const
+{
+  return this->dataPtr->historyStats;
+}
+
 // Register this plugin
 IGNITION_ADD_PLUGIN(ignition::gui::plugins::WorldStats,
                     ignition::gui::Plugin)
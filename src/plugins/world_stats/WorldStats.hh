@@ -62,6 +62,16 @@ namespace plugins
   /// * \<real_time\> : True to display a real time widget, false by default.
   /// * \<real_time_factor\> : True to display a real time factor widget,
   ///                          false by default.
+  /// * \<iterations\> : True to display an iterations widget, false by
+  ///                    default.
+  /// * \<history\> : True to keep a history of the real time factor, the
+  ///                 sim time step and the iteration rate, and display a
+  ///                 sparkline with their min, average and 99th percentile.
+  ///                 False by default.
+  /// * \<history_size\> : Number of messages kept in the history, 1200 by
+  ///                      default.
+  /// * \<history_window\> : Seconds of history the summary covers, 10 by
+  ///                        default.
   /// * \<topic\> : Topic to receive world statistics, optional. If not present,
   ///               the plugin will attempt to create a topic with the main
   ///               window's `worldName` property.
@@ -101,6 +111,28 @@ namespace plugins
       NOTIFY IterationsChanged
     )
 
+    /// \brief Seconds of history summarized
+    Q_PROPERTY(
+      double historyWindow
+      READ HistoryWindow
+      WRITE SetHistoryWindow
+      NOTIFY HistoryWindowChanged
+    )
+
+    /// \brief Real time factors over the history window, for a sparkline
+    Q_PROPERTY(
+      QVariantList rtfHistory
+      READ RtfHistory
+      NOTIFY HistoryChanged
+    )
+
+    /// \brief Summary of the history window
+    Q_PROPERTY(
+      QVariantMap historyStats
+      READ HistoryStats
+      NOTIFY HistoryChanged
+    )
+
     /// \brief Constructor
     public: WorldStats();
 
@@ -157,7 +189,37 @@ namespace plugins
     /// \brief Notify that message type has changed
     signals: void IterationsChanged();
 
-    /// \brief Subscriber callback when new world statistics are received
+    /// \brief Get the number of seconds of history summarized.
+    /// \return Seconds
+    public: Q_INVOKABLE double HistoryWindow() const;
+
+    /// \brief Set the number of seconds of history summarized.
+    /// \param[in] _historyWindow Seconds
+    public: Q_INVOKABLE void SetHistoryWindow(const double _historyWindow);
+
+    /// \brief Notify that the history window has changed
+    signals: void HistoryWindowChanged();
+
+    /// \brief Get the real time factors of the history window, as
+    /// percentages. Long histories are shortened to about a hundred points,
+    /// keeping the lowest factor of each group so slowdowns stand out.
+    /// \return Oldest first
+    public: Q_INVOKABLE QVariantList RtfHistory() const;
+
+    /// \brief Get a summary of the history window, with the keys
+    /// "rtfMin", "rtfAvg" and "rtfP99" for the real time factor in percent,
+    /// "stepMin", "stepAvg" and "stepP99" for the sim time per iteration in
+    /// milliseconds, and "iterationRate" for iterations per second of real
+    /// time.
+    /// \return Summary, empty if there's no history
+    public: Q_INVOKABLE QVariantMap HistoryStats() const;
+
+    /// \brief Notify that the history was summarized again
+    signals: void HistoryChanged();
+
+    /// \brief Subscriber callback with the latest world statistics, called
+    /// on the GUI thread at most once per frame however fast they're
+    /// published
     private: void OnWorldStatsMsg(const ignition::msgs::WorldStatistics &_msg);
 
     // Private data
@@ -47,6 +47,26 @@ Rectangle {
    */
   property bool showIterations: false
 
+  /**
+   * True to show the history of the real time factor
+   */
+  property bool showHistory: false
+
+  /**
+   * Min, average and 99th percentile of a history statistic.
+   * \param _key Statistic, such as "rtf"
+   * \param _unit Unit appended to the values
+   */
+  function summary(_key, _unit)
+  {
+    var stats = WorldStats.historyStats;
+    if (stats[_key + "Min"] === undefined)
+      return "N/A";
+    return stats[_key + "Min"].toFixed(2) + " / " +
+        stats[_key + "Avg"].toFixed(2) + " / " +
+        stats[_key + "P99"].toFixed(2) + _unit;
+  }
+
   property int tooltipDelay: 500
   property int tooltipTimeout: 1000
 
@@ -242,6 +262,109 @@ Rectangle {
         visible: showIterations
         Layout.alignment: Qt.AlignRight
       }
+
+      /**
+       * History
+       */
+      Label {
+        text: "History"
+        visible: showHistory
+        font.weight: Font.DemiBold
+        ToolTip.visible: historyMa.containsMouse
+        ToolTip.delay: tooltipDelay
+        ToolTip.timeout: tooltipTimeout
+        ToolTip.text: qsTr("Seconds of history summarized below")
+
+        MouseArea {
+          id: historyMa
+          anchors.fill: parent
+          hoverEnabled: true
+        }
+      }
+      ComboBox {
+        visible: showHistory
+        Layout.alignment: Qt.AlignRight
+        model: [10, 60, 300]
+        currentIndex: Math.max(0, model.indexOf(WorldStats.historyWindow))
+        displayText: currentText + " s"
+        onActivated: {
+          WorldStats.historyWindow = model[index]
+        }
+      }
+
+      Canvas {
+        id: sparkline
+        visible: showHistory
+        Layout.columnSpan: 2
+        Layout.fillWidth: true
+        Layout.preferredHeight: 40
+
+        onPaint: {
+          var ctx = getContext("2d");
+          ctx.reset();
+          var points = WorldStats.rtfHistory;
+          if (points.length < 2)
+            return;
+
+          // Scale to the highest factor, and at least 100 %
+          var top = 100;
+          for (var i = 0; i < points.length; ++i)
+            top = Math.max(top, points[i]);
+
+          ctx.strokeStyle = Material.accent;
+          ctx.lineWidth = 1;
+          ctx.beginPath();
+          for (i = 0; i < points.length; ++i)
+          {
+            var x = i * width / (points.length - 1);
+            var y = height - points[i] * height / top;
+            if (i === 0)
+              ctx.moveTo(x, y);
+            else
+              ctx.lineTo(x, y);
+          }
+          ctx.stroke();
+        }
+
+        Connections {
+          target: WorldStats
+          onHistoryChanged: sparkline.requestPaint()
+        }
+      }
+
+      Label {
+        text: "RTF min / avg / p99"
+        visible: showHistory
+        font.weight: Font.DemiBold
+      }
+      Label {
+        visible: showHistory
+        Layout.alignment: Qt.AlignRight
+        text: worldStats.summary("rtf", " %")
+      }
+
+      Label {
+        text: "Step min / avg / p99"
+        visible: showHistory
+        font.weight: Font.DemiBold
+      }
+      Label {
+        visible: showHistory
+        Layout.alignment: Qt.AlignRight
+        text: worldStats.summary("step", " ms")
+      }
+
+      Label {
+        text: "Iteration rate"
+        visible: showHistory
+        font.weight: Font.DemiBold
+      }
+      Label {
+        visible: showHistory
+        Layout.alignment: Qt.AlignRight
+        text: WorldStats.historyStats.iterationRate === undefined ? "N/A" :
+            WorldStats.historyStats.iterationRate.toFixed(1) + " Hz"
+      }
     }
   }
 }
@@ -171,6 +171,87 @@ TEST(WorldStatsTest, IGN_UTILS_TEST_ENABLED_ONLY_ON_LINUX(WorldStats))
   EXPECT_EQ(plugin->RealTimeFactor().toStdString(), "100.00 %");
 }
 
+/////////////////////////////////////////////////
+TEST(WorldStatsTest, IGN_UTILS_TEST_ENABLED_ONLY_ON_LINUX(History))
+{
+  common::Console::SetVerbosity(4);
+
+  Application app(g_argc, g_argv);
+  app.AddPluginPath(std::string(PROJECT_BINARY_PATH) + "/lib");
+
+  // Load plugin
+  const char *pluginStr =
+    "<plugin filename=\"WorldStats\">"
+      "<real_time_factor>true</real_time_factor>"
+      "<history>true</history>"
+      "<history_size>4</history_size>"
+      "<topic>/world_stats_history_test</topic>"
+    "</plugin>";
+
+  tinyxml2::XMLDocument pluginDoc;
+  pluginDoc.Parse(pluginStr);
+  EXPECT_TRUE(app.LoadPlugin("WorldStats",
+      pluginDoc.FirstChildElement("plugin")));
+
+  auto win = app.findChild<MainWindow *>();
+  ASSERT_NE(nullptr, win);
+  win->QuickWindow()->show();
+
+  auto plugin = win->findChild<plugins::WorldStats *>();
+  ASSERT_NE(nullptr, plugin);
+  EXPECT_TRUE(plugin->PluginItem()->property("showHistory").toBool());
+  EXPECT_DOUBLE_EQ(10.0, plugin->HistoryWindow());
+  EXPECT_TRUE(plugin->HistoryStats().empty());
+
+  transport::Node node;
+  auto pub = node.Advertise<msgs::WorldStatistics>(
+      "/world_stats_history_test");
+
+  // 1 ms steps, 100 iterations per second of real time. The first message
+  // leaves the ring, which only holds 4.
+  std::vector<double> rtfs{0.1, 0.5, 1.0, 0.8, 0.9};
+  for (std::size_t i = 0; i < rtfs.size(); ++i)
+  {
+    msgs::WorldStatistics msg;
+    msg.mutable_real_time()->set_sec(i);
+    msg.mutable_sim_time()->set_nsec(i * 100000000);
+    msg.set_iterations(i * 100);
+    msg.set_real_time_factor(rtfs[i]);
+    pub.Publish(msg);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+
+  // Summarized at most every 250 ms
+  int sleep = 0;
+  int maxSleep = 10;
+  QVariantMap stats;
+  while (sleep < maxSleep)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    QCoreApplication::processEvents();
+    stats = plugin->HistoryStats();
+    if (stats.contains("rtfMin") && stats["rtfMin"].toDouble() > 10.0)
+      break;
+    sleep++;
+  }
+  EXPECT_LT(sleep, maxSleep);
+
+  EXPECT_DOUBLE_EQ(50.0, stats["rtfMin"].toDouble());
+  EXPECT_DOUBLE_EQ(80.0, stats["rtfAvg"].toDouble());
+  EXPECT_DOUBLE_EQ(100.0, stats["rtfP99"].toDouble());
+  EXPECT_NEAR(1.0, stats["stepMin"].toDouble(), 1e-6);
+  EXPECT_NEAR(1.0, stats["stepAvg"].toDouble(), 1e-6);
+  EXPECT_NEAR(1.0, stats["stepP99"].toDouble(), 1e-6);
+  EXPECT_NEAR(100.0, stats["iterationRate"].toDouble(), 1e-6);
+  EXPECT_EQ(4, plugin->RtfHistory().size());
+
+  // A shorter window keeps fewer samples
+  plugin->SetHistoryWindow(1.0);
+  EXPECT_DOUBLE_EQ(1.0, plugin->HistoryWindow());
+  EXPECT_EQ(2, plugin->RtfHistory().size());
+  EXPECT_DOUBLE_EQ(80.0, plugin->HistoryStats()["rtfMin"].toDouble());
+}
+
 /////////////////////////////////////////////////
 TEST(WorldStatsTest, IGN_UTILS_TEST_ENABLED_ONLY_ON_LINUX(WorldNameNoTopic))
 {
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GUI_TEST_PERFORMANCE_BENCHMARK_HH_
+#define IGNITION_GUI_TEST_PERFORMANCE_BENCHMARK_HH_
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+/// \brief Print and record how long something took.
+///
+/// The result is a property of the running test, so it ends up in the
+/// test's XML results, and is also appended as a line of JSON to the file
+/// named by the IGN_GUI_BENCHMARK_OUTPUT environment variable, if set, so
+/// results can be compared across releases.
+/// \param[in] _name Benchmark name, such as "TopicCallback"
+/// \param[in] _total Time all iterations took
+/// \param[in] _iterations Number of iterations
+/// \return Nanoseconds per iteration
+inline double RecordBenchmark(const std::string &_name,
+    const std::chrono::steady_clock::duration &_total,
+    const std::size_t _iterations)
+{
+  auto ns = std::chrono::duration<double, std::nano>(_total).count() /
+      std::max<std::size_t>(_iterations, 1u);
+
+  std::cout << "[ BENCHMARK ] " << _name << ": " << ns << " ns x "
+            << _iterations << std::endl;
+  ::testing::Test::RecordProperty(_name + "_ns", std::to_string(ns));
+
+  if (auto path = std::getenv("IGN_GUI_BENCHMARK_OUTPUT"))
+  {
+    std::ofstream out(path, std::ios::out | std::ios::app);
+    out << "{\"name\":\"" << _name << "\",\"iterations\":" << _iterations
+        << ",\"ns_per_iteration\":" << ns << "}" << std::endl;
+  }
+  return ns;
+}
+
+/// \brief Time a function over some iterations, after a first call to warm
+/// up, then print and record the result.
+/// \param[in] _name Benchmark name
+/// \param[in] _iterations Number of timed calls
+/// \param[in] _function Function to time
+/// \return Nanoseconds per iteration
+/// \sa RecordBenchmark
+template <typename FunctionT>
+double Benchmark(const std::string &_name, const std::size_t _iterations,
+    FunctionT _function)
+{
+  _function();
+
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < _iterations; ++i)
+    _function();
+  return RecordBenchmark(_name, std::chrono::steady_clock::now() - start,
+      _iterations);
+}
+
+#endif
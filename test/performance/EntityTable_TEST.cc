@@ -0,0 +1,287 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <ignition/math/Pose3.hh>
+
+#include "scene3d/EntityTable.hh"
+
+#include "Benchmark.hh"
+
+using namespace ignition;
+using namespace gui;
+
+/// \brief Stand-in for a rendering node
+struct Node
+{
+  math::Pose3d pose;
+};
+
+using NodePtr = std::shared_ptr<Node>;
+using NodeWeakPtr = std::weak_ptr<Node>;
+
+static const unsigned int kEntityCount{10000u};
+static const unsigned int kFrameCount{200u};
+
+/////////////////////////////////////////////////
+/// \brief Create nodes with sparse entity ids, like the ones coming from a
+/// simulator.
+std::vector<std::pair<unsigned int, NodePtr>> makeNodes()
+{
+  std::vector<std::pair<unsigned int, NodePtr>> nodes;
+  for (unsigned int i = 0; i < kEntityCount; ++i)
+    nodes.push_back({i * 7u + 3u, std::make_shared<Node>()});
+  return nodes;
+}
+
+/////////////////////////////////////////////////
+/// \brief Poses received for one frame
+std::vector<std::pair<unsigned int, math::Pose3d>> makePoses(
+    const std::vector<std::pair<unsigned int, NodePtr>> &_nodes,
+    unsigned int _frame)
+{
+  std::vector<std::pair<unsigned int, math::Pose3d>> poses;
+  for (const auto &node : _nodes)
+    poses.push_back({node.first, math::Pose3d(_frame, 0, 0, 0, 0, 0)});
+  return poses;
+}
+
+/////////////////////////////////////////////////
+TEST(EntityTableTest, ApplyPoses)
+{
+  auto nodes = makeNodes();
+
+  std::vector<std::vector<std::pair<unsigned int, math::Pose3d>>> frames;
+  for (unsigned int f = 0; f < kFrameCount; ++f)
+    frames.push_back(makePoses(nodes, f));
+
+  // Node based maps, the way SceneManager used to store entities
+  std::map<unsigned int, NodeWeakPtr> visuals;
+  std::map<unsigned int, math::Pose3d> localPoses;
+  for (const auto &node : nodes)
+  {
+    visuals[node.first] = node.second;
+    localPoses[node.first] = math::Pose3d::Zero;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  for (const auto &frame : frames)
+  {
+    std::map<unsigned int, math::Pose3d> poses;
+    for (const auto &pose : frame)
+    {
+      auto pIt = localPoses.find(pose.first);
+      poses[pose.first] = pIt == localPoses.end() ?
+          pose.second : pose.second * pIt->second;
+    }
+
+    for (auto pIt = poses.begin(); pIt != poses.end();)
+    {
+      auto vIt = visuals.find(pIt->first);
+      if (vIt != visuals.end())
+      {
+        auto visual = vIt->second.lock();
+        if (visual)
+          visual->pose = pIt->second;
+        else
+          visuals.erase(vIt);
+        poses.erase(pIt++);
+      }
+      else
+      {
+        ++pIt;
+      }
+    }
+  }
+  auto mapTime = std::chrono::steady_clock::now() - start;
+
+  for (const auto &node : nodes)
+    EXPECT_EQ(math::Pose3d(kFrameCount - 1, 0, 0, 0, 0, 0), node.second->pose);
+
+  // Dense table
+  plugins::EntityTable<NodeWeakPtr> table;
+  for (const auto &node : nodes)
+    table.Set(node.first, node.second);
+  EXPECT_EQ(nodes.size(), table.Size());
+
+  start = std::chrono::steady_clock::now();
+  for (const auto &frame : frames)
+  {
+    for (const auto &pose : frame)
+      table.SetPose(pose.first, pose.second);
+
+    auto applied = table.Apply(
+        [](NodeWeakPtr &_node, const math::Pose3d &_pose)
+        {
+          auto node = _node.lock();
+          if (!node)
+            return false;
+          node->pose = _pose;
+          return true;
+        });
+    EXPECT_EQ(nodes.size(), applied);
+  }
+  auto tableTime = std::chrono::steady_clock::now() - start;
+
+  for (const auto &node : nodes)
+    EXPECT_EQ(math::Pose3d(kFrameCount - 1, 0, 0, 0, 0, 0), node.second->pose);
+
+  // Per frame
+  RecordBenchmark("EntityTable_ApplyPoses_map", mapTime, kFrameCount);
+  RecordBenchmark("EntityTable_ApplyPoses", tableTime, kFrameCount);
+}
+
+/////////////////////////////////////////////////
+TEST(EntityTableTest, EraseExpired)
+{
+  auto nodes = makeNodes();
+
+  plugins::EntityTable<NodeWeakPtr> table;
+  for (const auto &node : nodes)
+    table.Set(node.first, node.second);
+
+  // Drop every other node, their entries should be removed on the next sweep
+  for (unsigned int i = 0; i < nodes.size(); i += 2)
+    nodes[i].second.reset();
+
+  for (const auto &pose : makePoses(nodes, 1u))
+    EXPECT_TRUE(table.SetPose(pose.first, pose.second));
+  EXPECT_FALSE(table.SetPose(1u, math::Pose3d::Zero));
+
+  auto applied = table.Apply(
+      [](NodeWeakPtr &_node, const math::Pose3d &_pose)
+      {
+        auto node = _node.lock();
+        if (!node)
+          return false;
+        node->pose = _pose;
+        return true;
+      });
+  EXPECT_EQ(nodes.size() / 2u, applied);
+  EXPECT_EQ(nodes.size() / 2u, table.Size());
+
+  for (unsigned int i = 0; i < nodes.size(); ++i)
+  {
+    EXPECT_EQ(i % 2 == 1, table.Has(nodes[i].first));
+    if (nodes[i].second)
+    {
+      EXPECT_EQ(math::Pose3d(1, 0, 0, 0, 0, 0), nodes[i].second->pose);
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(EntityTableTest, DeferPoses)
+{
+  auto nodes = makeNodes();
+
+  plugins::EntityTable<NodeWeakPtr> table;
+  for (const auto &node : nodes)
+    table.Set(node.first, node.second);
+
+  auto apply = [](NodeWeakPtr &_node, const math::Pose3d &_pose)
+  {
+    auto node = _node.lock();
+    if (!node)
+      return false;
+    node->pose = _pose;
+    return true;
+  };
+
+  // Hold back the poses of entities with even ids
+  bool hold = true;
+  auto defer = [&hold](const unsigned int _id)
+  {
+    return hold && _id % 2u == 0u;
+  };
+
+  for (const auto &pose : makePoses(nodes, 1u))
+    table.SetPose(pose.first, pose.second);
+  EXPECT_EQ(nodes.size() / 2u, table.Apply(apply, defer));
+
+  for (const auto &node : nodes)
+  {
+    EXPECT_EQ(node.first % 2u == 0u ? math::Pose3d::Zero :
+        math::Pose3d(1, 0, 0, 0, 0, 0), node.second->pose);
+  }
+
+  // Deferred poses stay staged, and are only applied once no longer held
+  EXPECT_EQ(0u, table.Apply(apply, defer));
+  hold = false;
+  EXPECT_EQ(nodes.size() / 2u, table.Apply(apply, defer));
+  EXPECT_EQ(0u, table.Apply(apply, defer));
+
+  for (const auto &node : nodes)
+    EXPECT_EQ(math::Pose3d(1, 0, 0, 0, 0, 0), node.second->pose);
+}
+
+/////////////////////////////////////////////////
+TEST(EntityTableTest, EraseIf)
+{
+  auto nodes = makeNodes();
+
+  plugins::EntityTable<NodeWeakPtr> table;
+  for (const auto &node : nodes)
+    table.Set(node.first, node.second);
+
+  for (const auto &pose : makePoses(nodes, 1u))
+    table.SetPose(pose.first, pose.second);
+
+  // Remove a third of the entities at once
+  auto erased = table.EraseIf([](const unsigned int _id)
+      {
+        return _id % 3u == 0u;
+      });
+
+  std::size_t expected = 0u;
+  for (const auto &node : nodes)
+  {
+    EXPECT_EQ(node.first % 3u != 0u, table.Has(node.first));
+    if (node.first % 3u == 0u)
+      ++expected;
+  }
+  EXPECT_EQ(expected, erased);
+  EXPECT_EQ(nodes.size() - expected, table.Size());
+
+  // Only the remaining staged poses are applied, to the right nodes
+  auto applied = table.Apply(
+      [](NodeWeakPtr &_node, const math::Pose3d &_pose)
+      {
+        auto node = _node.lock();
+        if (!node)
+          return false;
+        node->pose = _pose;
+        return true;
+      });
+  EXPECT_EQ(nodes.size() - expected, applied);
+
+  for (const auto &node : nodes)
+  {
+    EXPECT_EQ(node.first % 3u == 0u ? math::Pose3d::Zero :
+        math::Pose3d(1, 0, 0, 0, 0, 0), node.second->pose);
+    if (table.Has(node.first))
+    {
+      EXPECT_EQ(node.second, table.Node(node.first).lock());
+    }
+  }
+}
@@ -0,0 +1,217 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "image_display/ImageConversion.hh"
+
+#include "Benchmark.hh"
+
+using namespace ignition;
+using namespace gui;
+using namespace plugins;
+
+static const unsigned int kWidth{1280u};
+static const unsigned int kHeight{720u};
+static const unsigned int kFrameCount{30u};
+
+/////////////////////////////////////////////////
+/// \brief Serialize values the way they're carried in an image msg.
+template <typename T>
+std::string makeData(const std::vector<T> &_values)
+{
+  return std::string(reinterpret_cast<const char *>(_values.data()),
+      _values.size() * sizeof(T));
+}
+
+/////////////////////////////////////////////////
+/// \brief Depths in a 10 m range, with some invalid ones.
+std::vector<float> makeDepths()
+{
+  std::srand(42);
+  std::vector<float> depths(kWidth * kHeight);
+  for (auto &d : depths)
+    d = 10.0f * std::rand() / RAND_MAX;
+
+  depths[5] = std::numeric_limits<float>::infinity();
+  depths[100] = -std::numeric_limits<float>::infinity();
+  depths[1001] = std::numeric_limits<float>::quiet_NaN();
+  depths[kWidth * kHeight - 1] = std::numeric_limits<float>::infinity();
+  return depths;
+}
+
+/////////////////////////////////////////////////
+TEST(ImageConversionTest, Float32)
+{
+  auto depths = makeDepths();
+  depths[7777] = 12.5f;
+
+  // Offset by one byte to check unaligned data
+  std::string data = " " + makeData(depths);
+  const char *src = data.data() + 1;
+  std::size_t count = depths.size();
+
+  EXPECT_FLOAT_EQ(12.5f, ImageConversion::ScalarMaxDepth(src, count));
+  EXPECT_FLOAT_EQ(12.5f, ImageConversion::MaxDepth(src, count));
+
+  // Odd counts go through the tail loops
+  EXPECT_FLOAT_EQ(ImageConversion::ScalarMaxDepth(src, 1003u),
+      ImageConversion::MaxDepth(src, 1003u));
+
+  float factor = 255.0f / 12.5f;
+  std::vector<std::uint8_t> expected(kWidth);
+  std::vector<std::uint8_t> actual(kWidth);
+  for (unsigned int j = 0; j < kHeight; ++j)
+  {
+    const char *row = src + j * kWidth * sizeof(float);
+    ImageConversion::ScalarDepthToGray(row, kWidth, factor, expected.data());
+    ImageConversion::DepthToGray(row, kWidth, factor, actual.data());
+    for (unsigned int i = 0; i < kWidth; ++i)
+      EXPECT_NEAR(expected[i], actual[i], 1) << i << ", " << j;
+  }
+
+  // Near is white, far and invalid are black
+  std::vector<float> edges{0.0f, 12.5f, depths[5], depths[1001]};
+  std::vector<std::uint8_t> gray(edges.size());
+  ImageConversion::DepthToGray(edges.data(), edges.size(), factor,
+      gray.data());
+  EXPECT_EQ(255u, gray[0]);
+  for (unsigned int i = 1; i < edges.size(); ++i)
+    EXPECT_EQ(0u, gray[i]);
+}
+
+/////////////////////////////////////////////////
+TEST(ImageConversionTest, LInt16)
+{
+  std::srand(42);
+  std::vector<std::uint16_t> values(kWidth * kHeight);
+  for (auto &v : values)
+    v = 1000u + std::rand() % 20000u;
+  values[321] = 500u;
+  values[kWidth * kHeight - 1] = 60000u;
+
+  std::string data = " " + makeData(values);
+  const char *src = data.data() + 1;
+  std::size_t count = values.size();
+
+  std::uint16_t min, max;
+  ImageConversion::ScalarMinMax(src, count, min, max);
+  EXPECT_EQ(500u, min);
+  EXPECT_EQ(60000u, max);
+
+  ImageConversion::MinMax(src, count, min, max);
+  EXPECT_EQ(500u, min);
+  EXPECT_EQ(60000u, max);
+
+  // Both ends of the unsigned range
+  std::vector<std::uint16_t> extremes(19u, 30000u);
+  extremes[3] = 0u;
+  extremes[11] = 65535u;
+  ImageConversion::MinMax(extremes.data(), extremes.size(), min, max);
+  EXPECT_EQ(0u, min);
+  EXPECT_EQ(65535u, max);
+
+  float scale = 255.0f / (60000.0f - 500.0f);
+  std::vector<std::uint8_t> expected(kWidth);
+  std::vector<std::uint8_t> actual(kWidth);
+  for (unsigned int j = 0; j < kHeight; ++j)
+  {
+    const char *row = src + j * kWidth * sizeof(std::uint16_t);
+    ImageConversion::ScalarRangeToGray(row, kWidth, 500u, scale,
+        expected.data());
+    ImageConversion::RangeToGray(row, kWidth, 500u, scale, actual.data());
+    for (unsigned int i = 0; i < kWidth; ++i)
+      EXPECT_NEAR(expected[i], actual[i], 1) << i << ", " << j;
+  }
+
+  std::vector<std::uint16_t> edges{500u, 60000u};
+  std::vector<std::uint8_t> gray(edges.size());
+  ImageConversion::RangeToGray(edges.data(), edges.size(), 500u, scale,
+      gray.data());
+  EXPECT_EQ(0u, gray[0]);
+  EXPECT_EQ(255u, gray[1]);
+}
+
+/////////////////////////////////////////////////
+TEST(ImageConversionTest, Benchmark)
+{
+  std::string depthData = makeData(makeDepths());
+  std::vector<std::uint8_t> gray(kWidth * kHeight);
+
+  auto convertDepth = [&](auto _max, auto _convert)
+  {
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int f = 0; f < kFrameCount; ++f)
+    {
+      float maxDepth = _max(depthData.data(), kWidth * kHeight);
+      for (unsigned int j = 0; j < kHeight; ++j)
+      {
+        _convert(depthData.data() + j * kWidth * sizeof(float), kWidth,
+            255.0f / maxDepth, gray.data() + j * kWidth);
+      }
+    }
+    return std::chrono::steady_clock::now() - start;
+  };
+
+  auto scalarDepthTime = convertDepth(ImageConversion::ScalarMaxDepth,
+      ImageConversion::ScalarDepthToGray);
+  auto depthTime = convertDepth(ImageConversion::MaxDepth,
+      ImageConversion::DepthToGray);
+
+  std::srand(42);
+  std::vector<std::uint16_t> values(kWidth * kHeight);
+  for (auto &v : values)
+    v = std::rand() % 65536u;
+  std::string valueData = makeData(values);
+
+  auto convertRange = [&](auto _minMax, auto _convert)
+  {
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int f = 0; f < kFrameCount; ++f)
+    {
+      std::uint16_t min, max;
+      _minMax(valueData.data(), kWidth * kHeight, min, max);
+      float scale = max > min ? 255.0f / (max - min) : 0.0f;
+      for (unsigned int j = 0; j < kHeight; ++j)
+      {
+        _convert(valueData.data() + j * kWidth * sizeof(std::uint16_t),
+            kWidth, min, scale, gray.data() + j * kWidth);
+      }
+    }
+    return std::chrono::steady_clock::now() - start;
+  };
+
+  auto scalarRangeTime = convertRange(ImageConversion::ScalarMinMax,
+      ImageConversion::ScalarRangeToGray);
+  auto rangeTime = convertRange(ImageConversion::MinMax,
+      ImageConversion::RangeToGray);
+
+  // Per frame
+  RecordBenchmark("ImageConversion_R_FLOAT32_scalar", scalarDepthTime,
+      kFrameCount);
+  RecordBenchmark("ImageConversion_R_FLOAT32", depthTime, kFrameCount);
+  RecordBenchmark("ImageConversion_L_INT16_scalar", scalarRangeTime,
+      kFrameCount);
+  RecordBenchmark("ImageConversion_L_INT16", rangeTime, kFrameCount);
+}
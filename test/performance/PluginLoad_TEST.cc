@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include <ignition/utilities/ExtraTestMacros.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+#include "ignition/gui/Application.hh"
+#include "ignition/gui/MainWindow.hh"
+#include "ignition/gui/Plugin.hh"
+
+#include "Benchmark.hh"
+
+int g_argc = 1;
+char **g_argv = new char *[g_argc];
+
+using namespace ignition;
+using namespace gui;
+
+static const unsigned int kPluginCount{20u};
+
+/////////////////////////////////////////////////
+TEST(PluginLoadTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(LoadPlugin))
+{
+  Application app(g_argc, g_argv);
+  app.AddPluginPath(std::string(PROJECT_BINARY_PATH) + "/lib");
+
+  // The first load finds and opens the library, later ones reuse it
+  auto start = std::chrono::steady_clock::now();
+  ASSERT_TRUE(app.LoadPlugin("TestPlugin"));
+  RecordBenchmark("PluginLoad_first", std::chrono::steady_clock::now() - start,
+      1u);
+
+  start = std::chrono::steady_clock::now();
+  for (unsigned int i = 0; i < kPluginCount; ++i)
+    EXPECT_TRUE(app.LoadPlugin("TestPlugin"));
+  RecordBenchmark("PluginLoad", std::chrono::steady_clock::now() - start,
+      kPluginCount);
+
+  auto win = app.findChild<MainWindow *>();
+  ASSERT_NE(nullptr, win);
+  EXPECT_EQ(static_cast<int>(kPluginCount) + 1,
+      win->findChildren<Plugin *>().size());
+}
@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+#include "laser_scan/ScanConversion.hh"
+
+#include "Benchmark.hh"
+
+using namespace ignition;
+using namespace gui;
+using namespace plugins;
+
+static const std::size_t kCount{1083u};
+static const std::size_t kVerticalCount{16u};
+static const unsigned int kScanCount{400u};
+
+/////////////////////////////////////////////////
+/// \brief Ranges between 0 and 30 m, with some invalid ones.
+std::vector<double> makeRanges(const std::size_t _count)
+{
+  std::srand(42);
+  std::vector<double> ranges(_count);
+  for (auto &r : ranges)
+    r = 30.0 * std::rand() / RAND_MAX;
+
+  ranges[5] = std::numeric_limits<double>::infinity();
+  ranges[6] = -std::numeric_limits<double>::infinity();
+  ranges[100] = std::numeric_limits<double>::quiet_NaN();
+  ranges[_count - 1] = std::numeric_limits<double>::infinity();
+  return ranges;
+}
+
+/////////////////////////////////////////////////
+TEST(ScanConversionTest, Directions)
+{
+  ScanConversion::Directions dirs;
+  EXPECT_TRUE(dirs.Update(-M_PI_2, M_PI_2, 3, 0.0, 0.0, 0));
+  ASSERT_EQ(3u, dirs.Size());
+  EXPECT_NEAR(0.0f, dirs.x[0], 1e-6);
+  EXPECT_NEAR(-1.0f, dirs.y[0], 1e-6);
+  EXPECT_NEAR(1.0f, dirs.x[1], 1e-6);
+  EXPECT_NEAR(1.0f, dirs.y[2], 1e-6);
+  EXPECT_FLOAT_EQ(0.0f, dirs.z[2]);
+
+  // Same angles are kept
+  EXPECT_FALSE(dirs.Update(-M_PI_2, M_PI_2, 3, 0.0, 0.0, 1));
+
+  // Vertical beams come one row after the other
+  EXPECT_TRUE(dirs.Update(0.0, M_PI_2, 2, -M_PI_4, M_PI_2, 2));
+  ASSERT_EQ(4u, dirs.Size());
+  EXPECT_NEAR(-std::sqrt(0.5f), dirs.z[1], 1e-6);
+  EXPECT_NEAR(std::sqrt(0.5f), dirs.z[2], 1e-6);
+  EXPECT_NEAR(std::sqrt(0.5f), dirs.y[3], 1e-6);
+}
+
+/////////////////////////////////////////////////
+TEST(ScanConversionTest, Project)
+{
+  auto ranges = makeRanges(kCount);
+  ranges[7] = 0.05;
+  ranges[8] = 29.99;
+
+  ScanConversion::Directions dirs;
+  dirs.Update(-2.0, 4.0 / kCount, kCount, 0.0, 0.0, 0);
+
+  std::vector<float> x(kCount), y(kCount), z(kCount);
+  std::vector<float> sx(kCount), sy(kCount), sz(kCount);
+  std::vector<std::uint8_t> valid(kCount), scalarValid(kCount);
+
+  auto expected = ScanConversion::ScalarProject(ranges.data(), dirs, kCount,
+      0.1, 25.0, sx.data(), sy.data(), sz.data(), scalarValid.data());
+  auto actual = ScanConversion::Project(ranges.data(), dirs, kCount, 0.1,
+      25.0, x.data(), y.data(), z.data(), valid.data());
+  EXPECT_EQ(expected, actual);
+  EXPECT_LT(actual, kCount);
+
+  for (std::size_t i = 0; i < kCount; ++i)
+  {
+    ASSERT_EQ(scalarValid[i], valid[i]) << i;
+    if (!valid[i])
+      continue;
+    EXPECT_FLOAT_EQ(sx[i], x[i]) << i;
+    EXPECT_FLOAT_EQ(sy[i], y[i]) << i;
+    EXPECT_FLOAT_EQ(sz[i], z[i]) << i;
+    EXPECT_NEAR(ranges[i], std::hypot(x[i], y[i]), 1e-4) << i;
+  }
+
+  // Out of range, infinite and NaN ranges are invalid
+  for (auto i : {5u, 6u, 7u, 8u, 100u})
+    EXPECT_EQ(0u, valid[i]) << i;
+  EXPECT_EQ(0u, valid[kCount - 1]);
+
+  // Without an upper limit, only infinite ones are
+  ScanConversion::Project(ranges.data(), dirs, kCount, 0.0, 0.0, x.data(),
+      y.data(), z.data(), valid.data());
+  EXPECT_EQ(1u, valid[8]);
+  EXPECT_EQ(0u, valid[5]);
+}
+
+/////////////////////////////////////////////////
+TEST(ScanConversionTest, Benchmark)
+{
+  const std::size_t count = kCount * kVerticalCount;
+  auto ranges = makeRanges(count);
+
+  ScanConversion::Directions dirs;
+  std::vector<float> x(count), y(count), z(count);
+  std::vector<std::uint8_t> valid(count);
+
+  // Beam directions computed for each scan, as if they weren't kept
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned int s = 0; s < kScanCount; ++s)
+  {
+    dirs.Update(-2.0 - s * 1e-9, 4.0 / kCount, kCount, -0.26, 0.035,
+        kVerticalCount);
+    ScanConversion::ScalarProject(ranges.data(), dirs, count, 0.1, 25.0,
+        x.data(), y.data(), z.data(), valid.data());
+  }
+  auto trigTime = std::chrono::steady_clock::now() - start;
+
+  auto project = [&](auto _kernel)
+  {
+    dirs.Update(-2.0, 4.0 / kCount, kCount, -0.26, 0.035, kVerticalCount);
+    auto begin = std::chrono::steady_clock::now();
+    for (unsigned int s = 0; s < kScanCount; ++s)
+    {
+      _kernel(ranges.data(), dirs, count, 0.1, 25.0, x.data(), y.data(),
+          z.data(), valid.data());
+    }
+    return std::chrono::steady_clock::now() - begin;
+  };
+
+  auto scalarTime = project(ScanConversion::ScalarProject);
+  auto kernelTime = project(ScanConversion::Project);
+
+  RecordBenchmark("ScanConversion_trig", trigTime, kScanCount);
+  RecordBenchmark("ScanConversion_scalar", scalarTime, kScanCount);
+  RecordBenchmark("ScanConversion", kernelTime, kScanCount);
+}
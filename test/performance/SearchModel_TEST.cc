@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include <QStandardItemModel>
+
+#include "ignition/gui/Enums.hh"
+#include "ignition/gui/SearchModel.hh"
+
+#include "Benchmark.hh"
+
+using namespace ignition;
+using namespace gui;
+
+/// \brief Rows under each row, for each level of the tree
+static const int kBranching[] = {10, 100, 10};
+
+/////////////////////////////////////////////////
+/// \brief Add rows under a parent, and their descendants, the way topics
+/// and their fields are listed.
+/// \param[in] _parent Parent row
+/// \param[in] _level Level of the rows to add
+void AddRows(QStandardItem *_parent, unsigned int _level)
+{
+  if (_level >= sizeof(kBranching) / sizeof(kBranching[0]))
+    return;
+
+  for (int i = 0; i < kBranching[_level]; ++i)
+  {
+    auto name = _parent->data(DataRole::DISPLAY_NAME).toString() + "/" +
+        (i % 3 == 0 ? "model_" : i % 3 == 1 ? "link_" : "joint_") +
+        QString::number(i);
+    auto item = new QStandardItem();
+    item->setData(name, DataRole::DISPLAY_NAME);
+    _parent->appendRow(item);
+    AddRows(item, _level + 1);
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(SearchModelTest, LargeTree)
+{
+  QStandardItemModel sourceModel;
+  AddRows(sourceModel.invisibleRootItem(), 0);
+
+  SearchModel searchModel;
+  searchModel.setFilterRole(DataRole::DISPLAY_NAME);
+  searchModel.setSourceModel(&sourceModel);
+
+  // Typing a search, then changing it
+  QStringList searches{"l", "li", "lin", "link", "link_4", "model joint",
+      "joint_7", ""};
+  int search{0};
+  Benchmark("SearchModel_11000_rows", 40, [&]()
+  {
+    searchModel.SetSearch(searches[search++ % searches.size()]);
+  });
+
+  searchModel.SetSearch("");
+  EXPECT_EQ(kBranching[0], searchModel.rowCount());
+  searchModel.SetSearch("nothing");
+  EXPECT_EQ(0, searchModel.rowCount());
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#ifdef _MSC_VER
+#pragma warning(push, 0)
+#endif
+#include <ignition/msgs/pose.pb.h>
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#include "ignition/gui/PlottingInterface.hh"
+
+#include "Benchmark.hh"
+
+using namespace ignition;
+using namespace gui;
+
+static const unsigned int kMsgCount{100000u};
+
+/////////////////////////////////////////////////
+TEST(TopicCallbackTest, Fields)
+{
+  Topic topic("");
+  topic.Register("position-x", 1);
+  topic.Register("position-z", 1);
+  topic.Register("orientation-w", 2);
+  topic.Register("header-stamp-sec", 3);
+
+  msgs::Pose msg;
+  msg.mutable_position()->set_x(1.0);
+  msg.mutable_position()->set_z(2.0);
+  msg.mutable_orientation()->set_w(1.0);
+
+  // A new time for each message, so none is skipped
+  unsigned int sec{0};
+  PlotPoints points;
+  Benchmark("TopicCallback_4_fields", kMsgCount, [&]()
+  {
+    msg.mutable_header()->mutable_stamp()->set_sec(++sec);
+    msg.mutable_position()->set_x(sec);
+    topic.Callback(msg);
+  });
+
+  EXPECT_DOUBLE_EQ(sec, topic.Fields()["position-x"]->Value());
+  EXPECT_DOUBLE_EQ(2.0, topic.Fields()["position-z"]->Value());
+  topic.TakePoints(points);
+  EXPECT_FALSE(points.empty());
+}
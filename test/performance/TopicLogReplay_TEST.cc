@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#ifdef _MSC_VER
+#pragma warning(push, 0)
+#endif
+#include <ignition/msgs/pose.pb.h>
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#include <ignition/common/Filesystem.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+#include "ignition/gui/SubscriptionHub.hh"
+#include "ignition/gui/TopicLog.hh"
+
+#include "Benchmark.hh"
+
+using namespace ignition;
+using namespace gui;
+
+static const int kMsgCount{100000};
+
+/////////////////////////////////////////////////
+/// \brief Replays a log as fast as possible to subscribers of all its
+/// topics. The log named by the IGN_GUI_BENCHMARK_LOG environment variable
+/// is replayed if set, such as one recorded from a session which was slow,
+/// otherwise one of pose messages is made up.
+TEST(TopicLogReplayTest, Replay)
+{
+  std::string path;
+  if (auto log = std::getenv("IGN_GUI_BENCHMARK_LOG"))
+  {
+    path = log;
+  }
+  else
+  {
+    path = common::joinPaths(PROJECT_BINARY_PATH, "replay_benchmark.tlog");
+    TopicLogWriter writer;
+    ASSERT_TRUE(writer.Open(path));
+
+    msgs::Pose msg;
+    std::string data;
+    for (int i = 0; i < kMsgCount; ++i)
+    {
+      msg.mutable_header()->mutable_stamp()->set_nsec(i);
+      msg.mutable_position()->set_x(i);
+      msg.SerializeToString(&data);
+      writer.Write(i * 1000, i % 2 ? "/pose" : "/pose_other",
+          "ignition.msgs.Pose", data.data(), data.size());
+    }
+  }
+
+  TopicLogReader reader;
+  ASSERT_TRUE(reader.Open(path));
+  ASSERT_GT(reader.Count(), 0u);
+
+  auto hub = SubscriptionHub::Instance();
+  std::atomic<uint64_t> received{0};
+  std::vector<std::size_t> ids;
+  for (const auto &topic : reader.Topics())
+  {
+    ids.push_back(hub->Subscribe(topic,
+        [&](const std::shared_ptr<const google::protobuf::Message> &)
+        {
+          ++received;
+        }));
+  }
+
+  TopicLogRecord record;
+  auto start = std::chrono::steady_clock::now();
+  while (reader.Next(record))
+    hub->Inject(*record.topic, *record.type, record.data, record.size);
+  RecordBenchmark("TopicLogReplay", std::chrono::steady_clock::now() - start,
+      reader.Count());
+
+  EXPECT_EQ(reader.Count(), received);
+
+  // Seeking through the index
+  int64_t span = reader.EndTime() - reader.StartTime();
+  int seek{0};
+  Benchmark("TopicLogSeek", 10000, [&]()
+  {
+    reader.Seek(reader.StartTime() + span * (++seek % 100) / 100);
+  });
+
+  for (auto id : ids)
+    hub->Unsubscribe(id);
+}
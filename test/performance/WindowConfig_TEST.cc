@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "ignition/gui/MainWindow.hh"
+
+#include "Benchmark.hh"
+
+using namespace ignition;
+using namespace gui;
+
+/////////////////////////////////////////////////
+TEST(WindowConfigTest, RoundTrip)
+{
+  WindowConfig config;
+  config.posX = 100;
+  config.posY = 200;
+  config.width = 1280;
+  config.height = 720;
+  config.state = QByteArray(2000, 'a');
+  config.materialTheme = "Dark";
+  config.materialPrimary = "#ff0000";
+  config.materialAccent = "#00ff00";
+  config.showDrawer = false;
+  config.showPluginMenu = false;
+
+  std::string xml;
+  Benchmark("WindowConfig_XMLString", 2000, [&]()
+  {
+    xml = config.XMLString();
+  });
+
+  WindowConfig loaded;
+  Benchmark("WindowConfig_MergeFromXML", 2000, [&]()
+  {
+    loaded.MergeFromXML(xml);
+  });
+
+  Benchmark("WindowConfig_RoundTrip", 2000, [&]()
+  {
+    WindowConfig copy;
+    copy.MergeFromXML(config.XMLString());
+  });
+
+  EXPECT_EQ(config.width, loaded.width);
+  EXPECT_EQ(config.materialTheme, loaded.materialTheme);
+  EXPECT_EQ(config.state, loaded.state);
+  EXPECT_EQ(config.showDrawer, loaded.showDrawer);
+}
@@ -0,0 +1,337 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
+#include <ignition/common/Util.hh>
+#include <ignition/msgs/image.pb.h>
+#include <ignition/msgs/pose_v.pb.h>
+#include <ignition/msgs/world_stats.pb.h>
+#include <ignition/utilities/ExtraTestMacros.hh>
+
+#include "test_config.h"  // NOLINT(build/include)
+#include "ignition/gui/Application.hh"
+#include "ignition/gui/MainWindow.hh"
+#include "ignition/gui/qt.h"
+
+#include "StreamReplay.hh"
+
+int g_argc = 1;
+char **g_argv = new char *[g_argc];
+
+using namespace ignition;
+using namespace gui;
+
+using Clock = std::chrono::steady_clock;
+
+/// \brief Limits a config must stay within. The IGN_GUI_BUDGET_SCALE
+/// environment variable scales all of them, for slower builds such as
+/// debug or sanitizer ones.
+struct Budget
+{
+  /// \brief From constructing the application to the first frame, or to
+  /// the config being loaded when nothing is drawn, in milliseconds
+  double startup;
+
+  /// \brief Longest the GUI thread may go without processing events while
+  /// streams are replayed, in milliseconds
+  double stall;
+
+  /// \brief 99th percentile of the time between frames, in milliseconds
+  double frameP99;
+
+  /// \brief Resident memory added by loading the config and replaying
+  /// streams, in megabytes
+  double rss;
+};
+
+/// \brief What a run measured
+struct Measurements
+{
+  /// \brief Startup time in milliseconds
+  double startup{0};
+
+  /// \brief Longest GUI thread stall in milliseconds
+  double stall{0};
+
+  /// \brief 99th percentile frame time in milliseconds, negative if too
+  /// few frames were drawn to tell
+  double frameP99{-1};
+
+  /// \brief Resident memory added, in megabytes
+  double rss{0};
+
+  /// \brief Frames drawn while replaying
+  unsigned int frames{0};
+
+  /// \brief Messages replayed
+  unsigned int messages{0};
+};
+
+/// \brief How long streams are replayed for
+static const std::chrono::milliseconds kReplayDuration{3000};
+
+/// \brief Interval of the timer used to detect stalls
+static const int kStallTimerInterval{10};
+
+/// \brief Fewest frames needed to check the frame time
+static const unsigned int kMinFrames{20u};
+
+/////////////////////////////////////////////////
+/// \brief Get the resident memory of this process.
+/// \return Megabytes, 0 if unknown
+static double ResidentMemory()
+{
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line))
+  {
+    if (line.find("VmRSS:") == 0)
+      return std::stod(line.substr(6)) / 1024.0;
+  }
+  return 0.0;
+}
+
+/////////////////////////////////////////////////
+/// \brief Get how much budgets are scaled by.
+/// \return Scale, 1 by default
+static double BudgetScale()
+{
+  std::string scale;
+  if (!common::env("IGN_GUI_BUDGET_SCALE", scale) || scale.empty())
+    return 1.0;
+  return std::max(std::stod(scale), 1.0);
+}
+
+/////////////////////////////////////////////////
+/// \brief Add the streams a running simulation sends the GUI, at the rates
+/// it sends them.
+/// \param[in] _replay Replay to add streams to
+static void AddSimulationStreams(StreamReplay &_replay)
+{
+  // World statistics at 5 Hz, with 1 ms steps in real time
+  _replay.Add<msgs::WorldStatistics>("/world_stats", 5.0,
+      [](msgs::WorldStatistics &_msg, unsigned int _count)
+  {
+    auto sec = _count / 5;
+    auto nsec = (_count % 5) * 200000000;
+    _msg.set_iterations(_count * 200u);
+    _msg.set_real_time_factor(1.0);
+    _msg.mutable_sim_time()->set_sec(sec);
+    _msg.mutable_sim_time()->set_nsec(nsec);
+    _msg.mutable_real_time()->set_sec(sec);
+    _msg.mutable_real_time()->set_nsec(nsec);
+    _msg.set_paused(false);
+  });
+
+  // Poses of 100 entities at 60 Hz
+  _replay.Add<msgs::Pose_V>("/world/default/pose/info", 60.0,
+      [](msgs::Pose_V &_msg, unsigned int _count)
+  {
+    if (_msg.pose_size() == 0)
+    {
+      for (int i = 0; i < 100; ++i)
+      {
+        auto pose = _msg.add_pose();
+        pose->set_id(i + 1);
+        pose->set_name("model_" + std::to_string(i));
+      }
+    }
+    _msg.mutable_header()->mutable_stamp()->set_sec(_count / 60);
+    _msg.mutable_header()->mutable_stamp()->set_nsec(
+        (_count % 60) * 16666666);
+    for (int i = 0; i < _msg.pose_size(); ++i)
+    {
+      auto position = _msg.mutable_pose(i)->mutable_position();
+      position->set_x(i + std::cos(_count * 0.05));
+      position->set_y(std::sin(_count * 0.05));
+    }
+  });
+
+  // VGA camera at 30 Hz
+  _replay.Add<msgs::Image>("/camera", 30.0,
+      [](msgs::Image &_msg, unsigned int _count)
+  {
+    const unsigned int width{640u};
+    const unsigned int height{480u};
+    _msg.set_width(width);
+    _msg.set_height(height);
+    _msg.set_step(width * 3);
+    _msg.set_pixel_format_type(msgs::PixelFormatType::RGB_INT8);
+    _msg.mutable_data()->assign(width * height * 3,
+        static_cast<char>(_count % 256));
+  });
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the 99th percentile of the time between frames.
+/// \param[in] _frames Times frames were swapped
+/// \return Milliseconds
+static double FrameP99(const std::vector<Clock::time_point> &_frames)
+{
+  std::vector<double> intervals;
+  for (std::size_t i = 1; i < _frames.size(); ++i)
+  {
+    intervals.push_back(std::chrono::duration<double, std::milli>(
+        _frames[i] - _frames[i - 1]).count());
+  }
+  std::sort(intervals.begin(), intervals.end());
+  auto index = static_cast<std::size_t>(
+      std::ceil(intervals.size() * 0.99)) - 1;
+  return intervals[index];
+}
+
+/////////////////////////////////////////////////
+/// \brief Load a config offscreen, replay simulation streams and measure
+/// how the GUI copes.
+/// \param[in] _config Config file name, in examples/config
+/// \return Measurements
+static Measurements Run(const std::string &_config)
+{
+  Measurements result;
+
+  setenv("QT_QPA_PLATFORM", "offscreen", 0);
+  auto rssBefore = ResidentMemory();
+  auto start = Clock::now();
+
+  Application app(g_argc, g_argv);
+  app.AddPluginPath(std::string(PROJECT_BINARY_PATH) + "/lib");
+
+  std::vector<Clock::time_point> frames;
+  auto win = app.findChild<MainWindow *>();
+  if (win && win->QuickWindow())
+  {
+    QObject::connect(win->QuickWindow(), &QQuickWindow::frameSwapped,
+        [&frames]()
+    {
+      frames.push_back(Clock::now());
+    });
+  }
+
+  EXPECT_TRUE(app.LoadConfig(common::joinPaths(
+      std::string(PROJECT_SOURCE_PATH), "examples", "config", _config)));
+  QCoreApplication::processEvents();
+
+  auto startupEnd = frames.empty() ? Clock::now() : frames.front();
+  result.startup = std::chrono::duration<double, std::milli>(
+      startupEnd - start).count();
+  frames.clear();
+
+  // Replay streams while watching for stalls
+  StreamReplay replay;
+  AddSimulationStreams(replay);
+
+  auto lastTick = Clock::now();
+  QTimer stallTimer;
+  QObject::connect(&stallTimer, &QTimer::timeout, [&result, &lastTick]()
+  {
+    auto now = Clock::now();
+    auto stall = std::chrono::duration<double, std::milli>(
+        now - lastTick).count() - kStallTimerInterval;
+    result.stall = std::max(result.stall, stall);
+    lastTick = now;
+  });
+
+  QEventLoop loop;
+  QTimer::singleShot(kReplayDuration.count(), &loop, &QEventLoop::quit);
+
+  replay.Start();
+  lastTick = Clock::now();
+  stallTimer.start(kStallTimerInterval);
+  loop.exec();
+  stallTimer.stop();
+  replay.Stop();
+
+  result.messages = replay.Published();
+  result.frames = static_cast<unsigned int>(frames.size());
+  if (result.frames >= kMinFrames)
+    result.frameP99 = FrameP99(frames);
+  result.rss = ResidentMemory() - rssBefore;
+
+  return result;
+}
+
+/////////////////////////////////////////////////
+/// \brief Check measurements against a budget, and record them in the
+/// test results.
+/// \param[in] _result Measurements
+/// \param[in] _budget Budget
+static void ExpectWithinBudget(const Measurements &_result,
+    const Budget &_budget)
+{
+  auto scale = BudgetScale();
+
+  ::testing::Test::RecordProperty("startup_ms",
+      std::to_string(_result.startup));
+  ::testing::Test::RecordProperty("stall_ms", std::to_string(_result.stall));
+  ::testing::Test::RecordProperty("frame_p99_ms",
+      std::to_string(_result.frameP99));
+  ::testing::Test::RecordProperty("rss_mb", std::to_string(_result.rss));
+  ::testing::Test::RecordProperty("frames", std::to_string(_result.frames));
+
+  EXPECT_GT(_result.messages, 0u);
+  EXPECT_LT(_result.startup, _budget.startup * scale);
+  EXPECT_LT(_result.stall, _budget.stall * scale);
+  EXPECT_LT(_result.rss, _budget.rss * scale);
+
+  if (_result.frameP99 < 0)
+  {
+    igndbg << "Only [" << _result.frames << "] frames drawn, not checking "
+           << "frame time" << std::endl;
+  }
+  else
+  {
+    EXPECT_LT(_result.frameP99, _budget.frameP99 * scale);
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(ConfigBudgetTest, IGN_UTILS_TEST_ENABLED_ONLY_ON_LINUX(PubSub))
+{
+  common::Console::SetVerbosity(4);
+  ExpectWithinBudget(Run("pubsub.config"), {3000, 100, 50, 150});
+}
+
+/////////////////////////////////////////////////
+TEST(ConfigBudgetTest, IGN_UTILS_TEST_ENABLED_ONLY_ON_LINUX(Image))
+{
+  common::Console::SetVerbosity(4);
+  ExpectWithinBudget(Run("image.config"), {3000, 100, 50, 150});
+}
+
+/////////////////////////////////////////////////
+TEST(ConfigBudgetTest, IGN_UTILS_TEST_ENABLED_ONLY_ON_LINUX(Time))
+{
+  common::Console::SetVerbosity(4);
+  ExpectWithinBudget(Run("time.config"), {3000, 100, 50, 150});
+}
+
+/////////////////////////////////////////////////
+TEST(ConfigBudgetTest, IGN_UTILS_TEST_ENABLED_ONLY_ON_LINUX(Scene3D))
+{
+  common::Console::SetVerbosity(4);
+  ExpectWithinBudget(Run("scene3d.config"), {5000, 200, 50, 400});
+}
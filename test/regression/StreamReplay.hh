@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GUI_TEST_REGRESSION_STREAMREPLAY_HH_
+#define IGNITION_GUI_TEST_REGRESSION_STREAMREPLAY_HH_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ignition/transport/Node.hh>
+
+/// \brief Publishes a set of topics at given rates from a background
+/// thread, standing in for the streams a simulation sends to the GUI.
+class StreamReplay
+{
+  /// \brief Destructor, stops publishing
+  public: ~StreamReplay()
+  {
+    this->Stop();
+  }
+
+  /// \brief Add a stream. Must be called before Start.
+  /// \param[in] _topic Topic to publish on
+  /// \param[in] _rate Messages per second
+  /// \param[in] _fill Called to update the message before each
+  /// publication, with the number of messages published on the stream so
+  /// far.
+  public: template<typename MsgT>
+  void Add(const std::string &_topic, double _rate,
+           std::function<void(MsgT &, unsigned int)> _fill)
+  {
+    auto stream = std::make_shared<Stream>();
+    stream->period = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(1.0 / _rate));
+    auto pub = this->node.Advertise<MsgT>(_topic);
+    auto msg = std::make_shared<MsgT>();
+    stream->publish = [pub, msg, _fill](unsigned int _count) mutable
+    {
+      _fill(*msg, _count);
+      pub.Publish(*msg);
+    };
+    this->streams.push_back(stream);
+  }
+
+  /// \brief Start publishing all streams.
+  public: void Start()
+  {
+    this->running = true;
+    this->thread = std::thread([this]()
+    {
+      auto start = Clock::now();
+      for (auto &stream : this->streams)
+        stream->next = start;
+
+      std::unique_lock<std::mutex> lock(this->mutex);
+      while (this->running)
+      {
+        // Publish whatever is due, then sleep until the next one is
+        auto now = Clock::now();
+        auto next = now + std::chrono::seconds(1);
+        for (auto &stream : this->streams)
+        {
+          if (stream->next <= now)
+          {
+            stream->publish(stream->count++);
+            ++this->published;
+            stream->next += stream->period;
+
+            // Drop messages which are late, like a real stream would
+            if (stream->next < now)
+              stream->next = now + stream->period;
+          }
+          next = std::min(next, stream->next);
+        }
+        this->cv.wait_until(lock, next, [this] {return !this->running;});
+      }
+    });
+  }
+
+  /// \brief Stop publishing.
+  public: void Stop()
+  {
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      this->running = false;
+    }
+    this->cv.notify_all();
+    if (this->thread.joinable())
+      this->thread.join();
+  }
+
+  /// \brief Get the number of messages published so far.
+  /// \return Messages on all streams
+  public: unsigned int Published() const
+  {
+    return this->published;
+  }
+
+  /// \brief Clock used to schedule publications
+  private: using Clock = std::chrono::steady_clock;
+
+  /// \brief A topic published at a fixed rate
+  private: struct Stream
+  {
+    /// \brief Update and publish the message
+    std::function<void(unsigned int)> publish;
+
+    /// \brief Time between messages
+    Clock::duration period;
+
+    /// \brief Time the next message is due
+    Clock::time_point next;
+
+    /// \brief Messages published so far
+    unsigned int count{0};
+  };
+
+  /// \brief Node streams are published from
+  private: ignition::transport::Node node;
+
+  /// \brief All streams
+  private: std::vector<std::shared_ptr<Stream>> streams;
+
+  /// \brief Thread publishing the streams
+  private: std::thread thread;
+
+  /// \brief Whether the thread should keep publishing
+  private: bool running{false};
+
+  /// \brief Protects running
+  private: std::mutex mutex;
+
+  /// \brief Wakes the thread up when stopping
+  private: std::condition_variable cv;
+
+  /// \brief Messages published on all streams
+  private: std::atomic<unsigned int> published{0};
+};
+
+#endif